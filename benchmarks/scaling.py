@@ -0,0 +1,311 @@
+"""Strong and weak scaling of the freud analyses, with machine readable output and baseline comparison
+
+Each analysis is run for every number of threads, set with freud.parallel.setNumThreads. Strong scaling keeps the
+number of points fixed, and weak scaling grows it with the number of threads. The throughput is reported in pairs,
+particles or K points times particles per second. The parallel efficiency is relative to the smallest number of
+threads, usually 1: t(p0) p0 / (t(p) p) for strong scaling and t(p0) / t(p) for weak scaling.
+
+Examples::
+
+    python scaling.py --threads 1,2,4,8 --json results.json
+    python scaling.py --benchmarks rdf,pmftxyz --mode strong --sizes 100000 --csv rdf.csv
+    python scaling.py --json new.json --baseline results.json --tolerance 0.1
+
+With --baseline, every result is compared with the result of the same benchmark, mode, number of threads and number
+of points in an earlier JSON output, and the script exits with status 1 if the throughput of any of them dropped by
+more than the tolerance.
+"""
+
+from __future__ import print_function
+from __future__ import division
+
+import argparse
+import csv
+import json
+import math
+import multiprocessing
+import platform
+import sys
+import time
+
+import numpy
+
+import freud
+from freud import box, cluster, density, kspace, locality, order, parallel, pmft
+
+from benchmark import benchmark
+
+## Number density of the systems of the benchmarks
+DENSITY = 1.0
+
+## Make an ideal gas of N points, the same for the same seed on every run
+def make_system(N, seed=0):
+    rng = numpy.random.RandomState(seed)
+    L = (N / DENSITY)**(1.0/3.0)
+    points = ((rng.random_sample((N, 3)) - 0.5)*L).astype(numpy.float32)
+    orientations = rng.standard_normal((N, 4)).astype(numpy.float32)
+    orientations /= numpy.linalg.norm(orientations, axis=1)[:, numpy.newaxis]
+    return box.Box.cube(L), points, orientations
+
+## Base class of the scaling benchmarks
+#
+# Derived classes set the name and the unit of their throughput, and return the number of items of one run of size N
+# from items().
+#
+class scaling_benchmark(benchmark):
+    name = None
+    unit = 'particles'
+
+    def items(self, N):
+        return N
+
+## Pairs within a distance of r of N points
+def num_pairs(N, r):
+    return N * DENSITY * 4.0/3.0*math.pi*r**3
+
+class rdf_benchmark(scaling_benchmark):
+    name = 'rdf'
+    unit = 'pairs'
+    rmax = 3.0
+
+    def setup(self, N):
+        self.box, self.points, _ = make_system(N)
+        self.rdf = density.RDF(self.rmax, 0.05)
+
+    def run(self, N):
+        self.rdf.accumulate(self.box, self.points, self.points)
+
+    def items(self, N):
+        return num_pairs(N, self.rmax)
+
+class linkcell_benchmark(scaling_benchmark):
+    name = 'linkcell'
+
+    def setup(self, N):
+        self.box, self.points, _ = make_system(N)
+        self.lc = locality.LinkCell(self.box, 1.0)
+
+    def run(self, N):
+        self.lc.computeCellList(self.box, self.points)
+
+class nearest_benchmark(scaling_benchmark):
+    name = 'nearest_neighbors'
+
+    def setup(self, N):
+        self.box, self.points, _ = make_system(N)
+        self.nn = locality.NearestNeighbors(1.5, 12)
+
+    def run(self, N):
+        self.nn.compute(self.box, self.points, self.points)
+
+class pmftxyz_benchmark(scaling_benchmark):
+    name = 'pmftxyz'
+    unit = 'pairs'
+
+    def setup(self, N):
+        self.box, self.points, self.orientations = make_system(N)
+        self.pmft = pmft.PMFTXYZ(2.0, 2.0, 2.0, 40, 40, 40)
+
+    def run(self, N):
+        self.pmft.accumulate(self.box, self.points, self.orientations, self.points, self.orientations)
+
+    def items(self, N):
+        # the pairs of the cube of the grid
+        return N * DENSITY * 4.0**3
+
+class localql_benchmark(scaling_benchmark):
+    name = 'localql'
+
+    def setup(self, N):
+        self.box, self.points, _ = make_system(N)
+        self.ql = order.LocalQl(self.box, 1.5, 6)
+
+    def run(self, N):
+        self.ql.compute(self.points)
+
+class cluster_benchmark(scaling_benchmark):
+    name = 'cluster'
+
+    def setup(self, N):
+        self.box, self.points, _ = make_system(N)
+        self.cluster = cluster.Cluster(self.box, 1.0)
+
+    def run(self, N):
+        self.cluster.computeClusters(self.points)
+
+class gaussian_benchmark(scaling_benchmark):
+    name = 'gaussian_density'
+
+    def setup(self, N):
+        self.box, self.points, _ = make_system(N)
+        self.gd = density.GaussianDensity(64, 2.0, 0.5)
+
+    def run(self, N):
+        self.gd.compute(self.box, self.points)
+        self.gd.getGaussianDensity()
+
+class ftdelta_benchmark(scaling_benchmark):
+    name = 'ftdelta'
+    unit = 'K points x particles'
+    NK = 2000
+
+    def setup(self, N):
+        _, points, orientations = make_system(N)
+        K = ((numpy.random.RandomState(1).random_sample((self.NK, 3)) - 0.5)*10).astype(numpy.float32)
+        self.ft = kspace._FTdelta()
+        self.ft.set_K(K)
+        self.ft.set_rq(points, orientations)
+
+    def run(self, N):
+        self.ft.compute()
+
+    def items(self, N):
+        return N * self.NK
+
+## All the benchmarks, by name; the sizes of ftdelta are scaled down, its cost being N times NK
+BENCHMARKS = [rdf_benchmark, linkcell_benchmark, nearest_benchmark, pmftxyz_benchmark, localql_benchmark,
+              cluster_benchmark, gaussian_benchmark, ftdelta_benchmark]
+SIZE_SCALE = {'ftdelta': 0.1}
+
+## Time one run of size N with enough calls to take at least min_time
+def time_run(bench, N, min_time):
+    # calibrate the number of calls with a single one
+    once = bench.run_benchmark(N, number=1)
+    number = int(min_time / max(once, 1e-9))
+    if number <= 1:
+        return once
+    return bench.run_benchmark(N, number=number)
+
+## Run the strong or weak scaling of one benchmark
+#
+# \returns a list of result dictionaries, one per size and number of threads
+#
+def run_scaling(bench_class, mode, sizes, weak_size, thread_list, min_time):
+    bench = bench_class()
+    scale = SIZE_SCALE.get(bench.name, 1.0)
+    results = []
+    if mode == 'strong':
+        runs = [(max(int(N * scale), 1), p) for N in sizes for p in thread_list]
+    else:
+        runs = [(max(int(weak_size * scale), 1) * p, p) for p in thread_list]
+    reference = {}
+    for N, p in runs:
+        parallel.setNumThreads(p)
+        t = time_run(bench, N, min_time)
+        items = bench.items(N)
+        # efficiency relative to the first (smallest) number of threads of the size, or of the weak series
+        key = N if mode == 'strong' else None
+        if key not in reference:
+            reference[key] = (t, p)
+        t0, p0 = reference[key]
+        if mode == 'strong':
+            efficiency = t0 * p0 / (t * p)
+        else:
+            efficiency = t0 / t
+        results.append(dict(benchmark=bench.name, mode=mode, threads=p, N=N, seconds=t,
+                            throughput=items / t, unit=bench.unit, efficiency=efficiency))
+    parallel.setNumThreads()
+    return results
+
+## Compare results with a baseline
+#
+# \returns the list of (result, baseline result, ratio of throughputs) of the results found in the baseline
+#
+def compare(results, baseline):
+    def key(r):
+        return (r['benchmark'], r['mode'], r['threads'], r['N'])
+    previous = dict((key(r), r) for r in baseline['results'])
+    comparisons = []
+    for r in results:
+        if key(r) in previous:
+            b = previous[key(r)]
+            comparisons.append((r, b, r['throughput'] / b['throughput']))
+    return comparisons
+
+def default_threads():
+    ncores = multiprocessing.cpu_count()
+    threads = []
+    p = 1
+    while p < ncores:
+        threads.append(p)
+        p *= 2
+    threads.append(ncores)
+    return threads
+
+def parse_list(text, convert=str):
+    return [convert(x) for x in text.split(',') if x]
+
+def main(argv):
+    names = [b.name for b in BENCHMARKS]
+    parser = argparse.ArgumentParser(description='Strong and weak scaling of the freud analyses')
+    parser.add_argument('--benchmarks', default=','.join(names),
+                        help='comma separated benchmarks to run, of: ' + ', '.join(names))
+    parser.add_argument('--mode', default='strong,weak', help='strong, weak or strong,weak')
+    parser.add_argument('--threads', default=','.join(str(p) for p in default_threads()),
+                        help='comma separated numbers of threads (default: powers of 2 and all the cores)')
+    parser.add_argument('--sizes', default='10000,100000', help='comma separated numbers of points of strong scaling')
+    parser.add_argument('--weak-size', type=int, default=10000, help='number of points per thread of weak scaling')
+    parser.add_argument('--min-time', type=float, default=1.0, help='minimum time in seconds of each measurement')
+    parser.add_argument('--json', help='write the results to this JSON file')
+    parser.add_argument('--csv', help='write the results to this CSV file')
+    parser.add_argument('--baseline', help='JSON output of an earlier run to compare with')
+    parser.add_argument('--tolerance', type=float, default=0.1,
+                        help='relative drop of throughput from the baseline reported as a regression')
+    args = parser.parse_args(argv)
+
+    selected = parse_list(args.benchmarks)
+    unknown = [name for name in selected if name not in names]
+    if unknown:
+        parser.error('unknown benchmarks: ' + ', '.join(unknown))
+    modes = parse_list(args.mode)
+    if any(mode not in ('strong', 'weak') for mode in modes):
+        parser.error('mode must be strong, weak or strong,weak')
+    thread_list = sorted(parse_list(args.threads, int))
+    sizes = parse_list(args.sizes, int)
+
+    results = []
+    print('{0:18s} {1:6s} {2:>7s} {3:>10s} {4:>12s} {5:>14s} {6:>10s}'.format(
+        'benchmark', 'mode', 'threads', 'N', 'time (ms)', 'throughput/s', 'efficiency'))
+    for bench_class in BENCHMARKS:
+        if bench_class.name not in selected:
+            continue
+        for mode in modes:
+            for r in run_scaling(bench_class, mode, sizes, args.weak_size, thread_list, args.min_time):
+                print('{0:18s} {1:6s} {2:7d} {3:10d} {4:12.3f} {5:14.4g} {6:10.2f}'.format(
+                    r['benchmark'], r['mode'], r['threads'], r['N'], r['seconds']*1e3, r['throughput'],
+                    r['efficiency']))
+                sys.stdout.flush()
+                results.append(r)
+
+    output = dict(freud_version=freud.__version__, machine=platform.node(), processor=platform.processor(),
+                  cpu_count=multiprocessing.cpu_count(), timestamp=time.strftime('%Y-%m-%dT%H:%M:%S'),
+                  results=results)
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(output, f, indent=2)
+    if args.csv:
+        fields = ['benchmark', 'mode', 'threads', 'N', 'seconds', 'throughput', 'unit', 'efficiency']
+        with open(args.csv, 'w') as f:
+            writer = csv.DictWriter(f, fieldnames=fields)
+            writer.writeheader()
+            writer.writerows(results)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = 0
+        print()
+        print('compared with {0} (freud {1}, {2})'.format(args.baseline, baseline.get('freud_version'),
+                                                          baseline.get('timestamp')))
+        for r, b, ratio in compare(results, baseline):
+            regressed = ratio < 1.0 - args.tolerance
+            regressions += regressed
+            print('{0:18s} {1:6s} {2:7d} {3:10d} {4:8.2f}x{5}'.format(
+                r['benchmark'], r['mode'], r['threads'], r['N'], ratio, '  REGRESSION' if regressed else ''))
+        if regressions:
+            print('{0} regressions of more than {1:.0%}'.format(regressions, args.tolerance))
+            return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
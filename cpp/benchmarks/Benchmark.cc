@@ -0,0 +1,230 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include "Benchmark.h"
+#include "tbb_config.h"
+
+using namespace std;
+
+/*! \file Benchmark.cc
+    \brief Minimal harness timing the analyses from C++, in the style of Google Benchmark
+*/
+
+namespace freud { namespace benchmark {
+
+//! Largest number of iterations of a run
+static const size_t MAX_ITERATIONS = 1000000000;
+
+State::State(const std::vector<int>& args, unsigned int num_threads, double min_time)
+    : m_args(args), m_num_threads(num_threads), m_min_time(min_time), m_batch_size(0), m_batch_remaining(0),
+      m_iterations(0), m_seconds(0), m_batch_seconds(0), m_running(false), m_items_per_iteration(0)
+    {
+    }
+
+/*! The iterations are run in batches, starting from one iteration and grown from the time of the last batch until a
+    batch takes at least the minimum time, as Google Benchmark does; the timing of the last batch is reported.
+*/
+bool State::keepRunning()
+    {
+    if (m_running)
+        {
+        pauseTiming();
+        m_batch_remaining--;
+        }
+    if (m_batch_remaining == 0)
+        {
+        if (m_batch_size > 0)
+            {
+            // the batch is done
+            if (m_batch_seconds >= m_min_time || m_batch_size >= MAX_ITERATIONS)
+                {
+                m_iterations = m_batch_size;
+                m_seconds = m_batch_seconds;
+                return false;
+                }
+            // enough iterations for the minimum time, with a margin, but at most 10 times more
+            double predicted = m_batch_seconds > 0 ? 1.4 * m_min_time * m_batch_size / m_batch_seconds
+                                                   : 10.0 * m_batch_size;
+            m_batch_size = size_t(std::min(std::max(predicted, double(m_batch_size + 1)), 10.0 * m_batch_size));
+            m_batch_size = std::min(m_batch_size, MAX_ITERATIONS);
+            }
+        else
+            m_batch_size = 1;
+        m_batch_remaining = m_batch_size;
+        m_batch_seconds = 0;
+        }
+    resumeTiming();
+    return true;
+    }
+
+void State::pauseTiming()
+    {
+    if (!m_running)
+        return;
+    m_batch_seconds += std::chrono::duration<double>(clock::now() - m_start).count();
+    m_running = false;
+    }
+
+void State::resumeTiming()
+    {
+    m_running = true;
+    m_start = clock::now();
+    }
+
+Benchmark *Benchmark::argsProduct(std::initializer_list< std::vector<int> > values)
+    {
+    vector< vector<int> > product(1);
+    for (const vector<int>& choices : values)
+        {
+        vector< vector<int> > next;
+        for (const vector<int>& prefix : product)
+            for (int value : choices)
+                {
+                next.push_back(prefix);
+                next.back().push_back(value);
+                }
+        product.swap(next);
+        }
+    m_args.insert(m_args.end(), product.begin(), product.end());
+    return this;
+    }
+
+std::string Benchmark::runName(const std::vector<int>& args, unsigned int num_threads) const
+    {
+    ostringstream name;
+    name << m_name;
+    for (size_t i = 0; i < args.size(); i++)
+        {
+        name << "/";
+        if (i < m_arg_names.size())
+            name << m_arg_names[i] << ":";
+        name << args[i];
+        }
+    name << "/threads:" << num_threads;
+    return name.str();
+    }
+
+//! \internal
+//! Get the registered benchmarks, constructed on first use so that registration does not depend on the link order
+static vector<Benchmark*>& registry()
+    {
+    static vector<Benchmark*> benchmarks;
+    return benchmarks;
+    }
+
+Benchmark *registerBenchmark(const char *name, BenchmarkFunction function)
+    {
+    registry().push_back(new Benchmark(name, function));
+    return registry().back();
+    }
+
+//! \internal
+//! Get the value of a --name=value command line option, if arg is that option
+static bool parseOption(const char *arg, const char *name, string& value)
+    {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=')
+        return false;
+    value = string(arg + length + 1);
+    return true;
+    }
+
+//! \internal
+//! Format a time in seconds with the most readable unit
+static string formatTime(double seconds)
+    {
+    char buffer[32];
+    if (seconds < 1e-6)
+        snprintf(buffer, sizeof(buffer), "%.1f ns", seconds*1e9);
+    else if (seconds < 1e-3)
+        snprintf(buffer, sizeof(buffer), "%.2f us", seconds*1e6);
+    else if (seconds < 1.0)
+        snprintf(buffer, sizeof(buffer), "%.2f ms", seconds*1e3);
+    else
+        snprintf(buffer, sizeof(buffer), "%.3f s", seconds);
+    return string(buffer);
+    }
+
+int runBenchmarks(int argc, char **argv)
+    {
+    regex filter(".*");
+    vector<unsigned int> thread_counts;
+    double min_time = 0.5;
+    bool csv = false;
+    for (int i = 1; i < argc; i++)
+        {
+        string value;
+        if (parseOption(argv[i], "--filter", value))
+            filter = regex(value);
+        else if (parseOption(argv[i], "--threads", value))
+            {
+            istringstream list(value);
+            string count;
+            while (getline(list, count, ','))
+                thread_counts.push_back(strtoul(count.c_str(), NULL, 10));
+            }
+        else if (parseOption(argv[i], "--min_time", value))
+            min_time = strtod(value.c_str(), NULL);
+        else if (parseOption(argv[i], "--format", value) && (value == "console" || value == "csv"))
+            csv = (value == "csv");
+        else
+            {
+            fprintf(stderr, "usage: %s [--filter=REGEX] [--threads=N,...] [--min_time=SECONDS] "
+                    "[--format=console|csv]\n", argv[0]);
+            return 1;
+            }
+        }
+    if (thread_counts.empty())
+        {
+        // serial, and all the cores
+        thread_counts.push_back(1);
+        unsigned int num_cores = parallel::ThreadArena().getNumThreads();
+        if (num_cores > 1)
+            thread_counts.push_back(num_cores);
+        }
+
+    if (csv)
+        printf("name,iterations,seconds_per_iteration,items_per_second\n");
+    else
+        printf("%-60s %14s %12s %14s\n", "Benchmark", "Time", "Iterations", "Items/s");
+    for (const Benchmark *benchmark : registry())
+        {
+        vector< vector<int> > arg_sets = benchmark->getArgs();
+        if (arg_sets.empty())
+            arg_sets.push_back(vector<int>());
+        for (const vector<int>& args : arg_sets)
+            for (unsigned int num_threads : thread_counts)
+                {
+                const string name = benchmark->runName(args, num_threads);
+                if (!regex_search(name, filter))
+                    continue;
+                State state(args, num_threads, min_time);
+                // every parallel loop of the run is confined to the threads of the arena
+                parallel::ThreadArena arena(num_threads);
+                BenchmarkFunction function = benchmark->getFunction();
+                arena.execute([&] () { function(state); });
+
+                double per_iteration = state.getIterations() ? state.getSeconds() / state.getIterations() : 0.0;
+                double items_per_second = (state.getItemsPerIteration() > 0 && per_iteration > 0) ?
+                    state.getItemsPerIteration() / per_iteration : 0.0;
+                if (csv)
+                    printf("%s,%zu,%g,%g\n", name.c_str(), state.getIterations(), per_iteration, items_per_second);
+                else
+                    printf("%-60s %14s %12zu %14.4g\n", name.c_str(), formatTime(per_iteration).c_str(),
+                           state.getIterations(), items_per_second);
+                fflush(stdout);
+                }
+        }
+    return 0;
+    }
+
+}; }; // end namespace freud::benchmark
@@ -0,0 +1,175 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <chrono>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#ifndef _BENCHMARK_H__
+#define _BENCHMARK_H__
+
+/*! \file Benchmark.h
+    \brief Minimal harness timing the analyses from C++, in the style of Google Benchmark
+*/
+
+namespace freud { namespace benchmark {
+
+//! Run state of one benchmark for one set of arguments and number of threads
+/*! The benchmark function sets up its system and then times its kernel in the loop
+
+    \code
+    while (state.keepRunning())
+        rdf.accumulate(...);
+    \endcode
+
+    which runs the kernel more and more times until they take the minimum time of the run. Setting up between
+    iterations can be left out of the timing with pauseTiming() and resumeTiming().
+*/
+class State
+    {
+    public:
+        //! Constructor
+        State(const std::vector<int>& args, unsigned int num_threads, double min_time);
+
+        //! Get argument i of the run
+        int range(unsigned int i) const
+            {
+            return m_args.at(i);
+            }
+
+        //! Get the number of threads the run is limited to
+        unsigned int threads() const
+            {
+            return m_num_threads;
+            }
+
+        //! Whether to run the kernel once more, starting the timing on the first call
+        bool keepRunning();
+
+        //! Stop the timing of the current iteration, for setup that should not be timed
+        void pauseTiming();
+
+        //! Restart the timing after pauseTiming()
+        void resumeTiming();
+
+        //! Set the number of items (points, pairs, ...) processed by each iteration, to report a throughput
+        void setItemsPerIteration(double items)
+            {
+            m_items_per_iteration = items;
+            }
+
+        //! Get the number of iterations timed
+        size_t getIterations() const
+            {
+            return m_iterations;
+            }
+
+        //! Get the time of the timed iterations in seconds
+        double getSeconds() const
+            {
+            return m_seconds;
+            }
+
+        //! Get the number of items of each iteration, zero if it was not set
+        double getItemsPerIteration() const
+            {
+            return m_items_per_iteration;
+            }
+
+    private:
+        typedef std::chrono::steady_clock clock;
+
+        std::vector<int> m_args;            //!< Arguments of the run
+        unsigned int m_num_threads;         //!< Number of threads of the run
+        double m_min_time;                  //!< Time in seconds the batches of iterations are grown to
+        size_t m_batch_size;                //!< Number of iterations of the current batch
+        size_t m_batch_remaining;           //!< Iterations left in the current batch
+        size_t m_iterations;                //!< Number of iterations of the last finished batch
+        double m_seconds;                   //!< Time of the last finished batch
+        double m_batch_seconds;             //!< Time of the current batch so far
+        bool m_running;                     //!< True while an iteration is being timed
+        clock::time_point m_start;          //!< Start of the timing of the current iteration
+        double m_items_per_iteration;       //!< Items processed per iteration
+    };
+
+//! Benchmark function, run once per set of arguments and number of threads
+typedef void (*BenchmarkFunction)(State& state);
+
+//! A registered benchmark and the arguments and numbers of threads it is run with
+class Benchmark
+    {
+    public:
+        //! Constructor
+        Benchmark(const std::string& name, BenchmarkFunction function)
+            : m_name(name), m_function(function)
+            {
+            }
+
+        //! Add a set of arguments to run the benchmark with
+        Benchmark *args(std::initializer_list<int> args)
+            {
+            m_args.push_back(std::vector<int>(args));
+            return this;
+            }
+
+        //! Add the sets of arguments of every combination of the given values of each argument
+        Benchmark *argsProduct(std::initializer_list< std::vector<int> > values);
+
+        //! Name the arguments in the reports
+        Benchmark *argNames(std::initializer_list<std::string> names)
+            {
+            m_arg_names = std::vector<std::string>(names);
+            return this;
+            }
+
+        //! Get the name of the run with the given arguments and number of threads
+        std::string runName(const std::vector<int>& args, unsigned int num_threads) const;
+
+        const std::string& getName() const
+            {
+            return m_name;
+            }
+
+        BenchmarkFunction getFunction() const
+            {
+            return m_function;
+            }
+
+        const std::vector< std::vector<int> >& getArgs() const
+            {
+            return m_args;
+            }
+
+    private:
+        std::string m_name;                         //!< Name of the benchmark
+        BenchmarkFunction m_function;               //!< Function run
+        std::vector< std::vector<int> > m_args;     //!< Sets of arguments of the runs
+        std::vector<std::string> m_arg_names;       //!< Names of the arguments in the reports
+    };
+
+//! Register a benchmark function, run by runBenchmarks()
+Benchmark *registerBenchmark(const char *name, BenchmarkFunction function);
+
+//! Run the registered benchmarks selected by the command line and report their timings
+/*! Options: --filter=REGEX to run the benchmarks whose run names match, --threads=1,2,4 for the numbers of threads
+    (default 1 and all the cores), --min_time=SECONDS for the time each run is grown to (default 0.5) and
+    --format=console|csv.
+*/
+int runBenchmarks(int argc, char **argv);
+
+//! Keep the compiler from optimizing a result away
+template<class T>
+inline void doNotOptimize(const T& value)
+    {
+    asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+}; }; // end namespace freud::benchmark
+
+//! Register a benchmark function at static initialization, chaining its arguments
+#define FREUD_BENCHMARK(function) \
+    static freud::benchmark::Benchmark *_freud_benchmark_##function = \
+        freud::benchmark::registerBenchmark(#function, function)
+
+#endif // _BENCHMARK_H__
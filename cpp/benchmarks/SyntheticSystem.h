@@ -0,0 +1,70 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+#include "box.h"
+#include "saruprng.h"
+
+#ifndef _SYNTHETIC_SYSTEM_H__
+#define _SYNTHETIC_SYSTEM_H__
+
+/*! \file SyntheticSystem.h
+    \brief Reproducible random systems of the benchmarks
+*/
+
+namespace freud { namespace benchmark {
+
+//! Points and orientations in a periodic box
+struct SyntheticSystem
+    {
+    box::Box box;                                   //!< Cubic (square in 2D) periodic box
+    std::vector< vec3<float> > points;              //!< Positions, uniform in the box
+    std::vector< quat<float> > orientations;        //!< Uniform random unit quaternions
+    std::vector<float> angles;                      //!< Uniform random angles in [0, 2 pi)
+    };
+
+//! Make an ideal gas of N points at a number density, the same for the same seed on every machine
+/*! The points are drawn from a Saru generator seeded by seed and the index of the point, so a system does not
+    depend on the number of threads or on the sizes of the other systems of a run.
+*/
+inline SyntheticSystem makeSystem(unsigned int N, float density, bool is2D=false, unsigned int seed=12345)
+    {
+    SyntheticSystem system;
+    float L = is2D ? sqrtf(N / density) : cbrtf(N / density);
+    system.box = box::Box(L, is2D);
+    system.points.resize(N);
+    system.orientations.resize(N);
+    system.angles.resize(N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Saru saru(seed, i, 0xbe4c4);
+        float x = saru.s<float>(-L/2.0f, L/2.0f);
+        float y = saru.s<float>(-L/2.0f, L/2.0f);
+        float z = saru.s<float>(-L/2.0f, L/2.0f);
+        system.points[i] = vec3<float>(x, y, is2D ? 0.0f : z);
+
+        // uniform rotations from three uniform numbers (Shoemake)
+        float u1 = saru.s<float>(0.0f, 1.0f);
+        float u2 = saru.s<float>(0.0f, 2.0f*float(M_PI));
+        float u3 = saru.s<float>(0.0f, 2.0f*float(M_PI));
+        float a = sqrtf(1.0f - u1);
+        float b = sqrtf(u1);
+        system.orientations[i] = quat<float>(b*cosf(u3), vec3<float>(a*sinf(u2), a*cosf(u2), b*sinf(u3)));
+        system.angles[i] = saru.s<float>(0.0f, 2.0f*float(M_PI));
+        }
+    return system;
+    }
+
+//! Get a number density given in hundredths, as the integer arguments of the benchmarks give it
+inline float densityArg(int hundredths)
+    {
+    return hundredths / 100.0f;
+    }
+
+}; }; // end namespace freud::benchmark
+
+#endif // _SYNTHETIC_SYSTEM_H__
@@ -0,0 +1,25 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Benchmark.h"
+#include "SyntheticSystem.h"
+#include "Cluster.h"
+
+/*! \file bench_cluster.cc
+    \brief Benchmarks of the clusters
+*/
+
+using namespace freud;
+using namespace freud::benchmark;
+
+//! Find the clusters of N points bonded within 1, below and above the percolation density
+static void ClusterCompute(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), densityArg(state.range(1)));
+    cluster::Cluster cluster(system.box, 1.0f);
+    while (state.keepRunning())
+        cluster.computeClusters(system.points.data(), system.points.size());
+    state.setItemsPerIteration(system.points.size());
+    }
+FREUD_BENCHMARK(ClusterCompute)->argNames({"N", "density_x100"})
+    ->argsProduct({{1000, 10000, 100000}, {10, 50}});
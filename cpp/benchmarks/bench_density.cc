@@ -0,0 +1,42 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Benchmark.h"
+#include "SyntheticSystem.h"
+#include "GaussianDensity.h"
+#include "RDF.h"
+
+/*! \file bench_density.cc
+    \brief Benchmarks of the RDF and the Gaussian density
+*/
+
+using namespace freud;
+using namespace freud::benchmark;
+
+//! Accumulate the RDF of N points with themselves up to a distance of 3
+static void RDFAccumulate(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), densityArg(state.range(1)));
+    density::RDF rdf(3.0f, 0.05f);
+    const unsigned int N = system.points.size();
+    while (state.keepRunning())
+        rdf.accumulate(system.box, system.points.data(), N, system.points.data(), N);
+    state.setItemsPerIteration(N);
+    }
+FREUD_BENCHMARK(RDFAccumulate)->argNames({"N", "density_x100"})
+    ->argsProduct({{1000, 10000, 100000}, {10, 50, 100}});
+
+//! Spread the Gaussians of N points onto a grid of 64 cells per side, and reduce it
+static void GaussianDensityCompute(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), densityArg(state.range(1)));
+    density::GaussianDensity gd(64, 2.0f, 0.5f);
+    while (state.keepRunning())
+        {
+        gd.compute(system.box, system.points.data(), system.points.size());
+        doNotOptimize(gd.getDensity().get()[0]);
+        }
+    state.setItemsPerIteration(system.points.size());
+    }
+FREUD_BENCHMARK(GaussianDensityCompute)->argNames({"N", "density_x100"})
+    ->argsProduct({{1000, 10000, 100000}, {10, 100}});
@@ -0,0 +1,49 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Benchmark.h"
+#include "SyntheticSystem.h"
+#include "kspace.h"
+
+/*! \file bench_kspace.cc
+    \brief Benchmarks of the Fourier transforms
+*/
+
+using namespace freud;
+using namespace freud::benchmark;
+
+//! Compute the transform of N delta peaks at NK K points
+static void FTdeltaCompute(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), 1.0f);
+    // random K points, drawn as the points of another system
+    SyntheticSystem K_system = makeSystem(state.range(1), 1.0f, false, 54321);
+    kspace::FTdelta ft;
+    ft.set_K(K_system.points.data(), K_system.points.size());
+    ft.set_rq(system.points.size(), system.points.data(), system.orientations.data());
+    while (state.keepRunning())
+        ft.compute();
+    state.setItemsPerIteration(double(system.points.size())*K_system.points.size());
+    }
+FREUD_BENCHMARK(FTdeltaCompute)->argNames({"N", "NK"})
+    ->argsProduct({{1000, 10000}, {1000, 10000, 100000}});
+
+//! Compute the transform of N delta peaks at NK K points within |K_i| < 4 with the non uniform FFT of the given
+//! tolerance, or the direct sum for a tolerance of 0
+static void FTdeltaComputeNUFFT(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), 1.0f);
+    SyntheticSystem K_system = makeSystem(state.range(1), 1.0f, false, 54321);
+    const float K_scale = 8.0f / K_system.box.getL().x;
+    for (unsigned int i = 0; i < K_system.points.size(); i++)
+        K_system.points[i] *= K_scale;
+    kspace::FTdelta ft;
+    ft.setNUFFTTolerance(float(state.range(2)) * 1e-6f);
+    ft.set_K(K_system.points.data(), K_system.points.size());
+    ft.set_rq(system.points.size(), system.points.data(), system.orientations.data());
+    while (state.keepRunning())
+        ft.compute();
+    state.setItemsPerIteration(double(system.points.size())*K_system.points.size());
+    }
+FREUD_BENCHMARK(FTdeltaComputeNUFFT)->argNames({"N", "NK", "tolerance_ppm"})
+    ->argsProduct({{10000, 100000}, {10000}, {0, 1, 1000}});
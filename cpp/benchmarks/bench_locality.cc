@@ -0,0 +1,39 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Benchmark.h"
+#include "SyntheticSystem.h"
+#include "LinkCell.h"
+#include "NearestNeighbors.h"
+
+/*! \file bench_locality.cc
+    \brief Benchmarks of the cell list and the nearest neighbors
+*/
+
+using namespace freud;
+using namespace freud::benchmark;
+
+//! Build the cell list of N points, of cells of width 1
+static void LinkCellBuild(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), densityArg(state.range(1)));
+    locality::LinkCell lc(system.box, 1.0f);
+    while (state.keepRunning())
+        lc.computeCellList(system.box, system.points.data(), system.points.size());
+    state.setItemsPerIteration(system.points.size());
+    }
+FREUD_BENCHMARK(LinkCellBuild)->argNames({"N", "density_x100"})
+    ->argsProduct({{1000, 10000, 100000, 1000000}, {10, 100}});
+
+//! Build the neighbor list of the 12 nearest neighbors of each of N points
+static void NearestNeighborsCompute(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), densityArg(state.range(1)));
+    locality::NearestNeighbors nn(1.5f, 12);
+    const unsigned int N = system.points.size();
+    while (state.keepRunning())
+        nn.compute(system.box, system.points.data(), N, system.points.data(), N);
+    state.setItemsPerIteration(N);
+    }
+FREUD_BENCHMARK(NearestNeighborsCompute)->argNames({"N", "density_x100"})
+    ->argsProduct({{1000, 10000, 100000}, {10, 100}});
@@ -0,0 +1,25 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Benchmark.h"
+#include "SyntheticSystem.h"
+#include "LocalQl.h"
+
+/*! \file bench_order.cc
+    \brief Benchmarks of the order parameters
+*/
+
+using namespace freud;
+using namespace freud::benchmark;
+
+//! Compute the Q6 of N points, of the neighbors within 1.5
+static void LocalQlCompute(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), densityArg(state.range(1)));
+    order::LocalQl ql(system.box, 1.5f, 6);
+    while (state.keepRunning())
+        ql.compute(system.points.data(), system.points.size());
+    state.setItemsPerIteration(system.points.size());
+    }
+FREUD_BENCHMARK(LocalQlCompute)->argNames({"N", "density_x100"})
+    ->argsProduct({{1000, 10000, 100000}, {10, 100}});
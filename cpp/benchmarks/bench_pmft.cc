@@ -0,0 +1,31 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <vector>
+
+#include "Benchmark.h"
+#include "SyntheticSystem.h"
+#include "PMFTXYZ.h"
+
+/*! \file bench_pmft.cc
+    \brief Benchmarks of the PMFTs
+*/
+
+using namespace freud;
+using namespace freud::benchmark;
+
+//! Accumulate the PMFTXYZ of N oriented points with themselves on a grid of 40^3 bins of half width 2
+static void PMFTXYZAccumulate(State& state)
+    {
+    SyntheticSystem system = makeSystem(state.range(0), densityArg(state.range(1)));
+    pmft::PMFTXYZ pmft(2.0f, 2.0f, 2.0f, 40, 40, 40, vec3<float>(0.0f, 0.0f, 0.0f));
+    const unsigned int N = system.points.size();
+    // one face per reference point, in the frame of the point
+    std::vector< quat<float> > faces(N, quat<float>(1.0f, vec3<float>(0.0f, 0.0f, 0.0f)));
+    while (state.keepRunning())
+        pmft.accumulate(system.box, system.points.data(), system.orientations.data(), N, system.points.data(),
+                        system.orientations.data(), N, faces.data(), 1);
+    state.setItemsPerIteration(N);
+    }
+FREUD_BENCHMARK(PMFTXYZAccumulate)->argNames({"N", "density_x100"})
+    ->argsProduct({{1000, 10000, 100000}, {10, 100}});
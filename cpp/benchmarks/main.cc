@@ -0,0 +1,13 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Benchmark.h"
+
+/*! \file main.cc
+    \brief Entry point of the benchmarks, see freud::benchmark::runBenchmarks() for the options
+*/
+
+int main(int argc, char **argv)
+    {
+    return freud::benchmark::runBenchmarks(argc, argv);
+    }
@@ -2,51 +2,17 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "BondingAnalysis.h"
+#include "HistogramReduction.h"
 #include "ScopedGILRelease.h"
 
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
-
-#include <complex>
-#include <map>
+#include <string.h>
 
 using namespace std;
 using namespace tbb;
 
 namespace freud { namespace bond {
 
-struct FindParticleIndex
-    {
-    FindParticleIndex(unsigned int pjdx)
-    : m_pjdx(pjdx)
-    {
-    }
-
-    unsigned int m_pjdx;
-    bool operator()
-    ( const std::pair<unsigned int, unsigned int> &p )
-        {
-        return (m_pjdx == p.first);
-        }
-    };
-
-struct FindBondIndex
-    {
-    FindBondIndex(unsigned int pjdx)
-    : m_pjdx(pjdx)
-    {
-    }
-
-    unsigned int m_pjdx;
-    bool operator()
-    ( const unsigned int &p )
-        {
-        return (m_pjdx == p);
-        }
-    };
-
 BondingAnalysis::BondingAnalysis(unsigned int num_particles,
                                  unsigned int num_bonds)
     : m_num_particles(num_particles), m_num_bonds(num_bonds), m_frame_counter(0), m_reduce(true)
@@ -57,113 +23,92 @@ BondingAnalysis::BondingAnalysis(unsigned int num_particles,
         throw invalid_argument("must be at least 1 bond to track");
     // create arrays to store transition information
     m_transition_matrix = std::shared_ptr<unsigned int>(new unsigned int[(m_num_bonds+1) * (m_num_bonds+1)], std::default_delete<unsigned int[]>());
-    m_bond_increment_array = new std::pair<unsigned int, unsigned int> [m_num_bonds*m_num_particles];
-    for (unsigned int i = 0; i < (m_num_bonds*m_num_particles); i++)
-        {
-        m_bond_increment_array[i] = std::pair<unsigned int, unsigned int>(UINT_MAX, UINT_MAX);
-        }
-    m_overall_increment_array.resize(m_num_particles);
-    m_bond_lifetime_array.resize(m_num_bonds);
-    m_overall_lifetime_array.resize(0);
     memset((void*)m_transition_matrix.get(), 0, sizeof(unsigned int)*(m_num_bonds+1)*(m_num_bonds+1));
+    m_bond_count.resize(m_num_bonds*m_num_particles, 0);
+    m_overall_count.resize(m_num_bonds*m_num_particles, 0);
+    m_keys.resize(m_num_bonds*m_num_particles);
+    m_next_keys.resize(m_num_bonds*m_num_particles);
+    m_num_keys.resize(m_num_particles, 0);
+    m_next_num_keys.resize(m_num_particles, 0);
     }
 
 BondingAnalysis::~BondingAnalysis()
     {
-    delete m_bond_increment_array;
+    util::freeLocalHistograms(m_local_transition_matrix);
     }
 
-// void BondingAnalysis::reduceArrays()
-//     {
-//     Index2D transition_indexer = Index2D((m_num_bonds+1), (m_num_bonds+1));
-//     // set all values in the transition matrix to 0
-//     memset((void*)m_transition_matrix.get(), 0, sizeof(unsigned int)*(m_num_bonds+1)*(m_num_bonds+1));
-//     // clear out bond lifetime arrays; don't need to resize cause they are already appropriately sized
-//     for (std::vector< std::vector<unsigned int> >::iterator it = m_bond_lifetime_array.begin();
-//         it != m_bond_lifetime_array.end(); ++it)
-//         {
-//         (*it).clear();
-//         }
-//     for (std::vector< std::vector<unsigned int> >::iterator it = m_overall_lifetime_array.begin();
-//         it != m_overall_lifetime_array.end(); ++it)
-//         {
-//         (*it).clear();
-//         }
-//     // I do not use parallel reduction in this case due to data structures not being thread safe...
-//     // transfer data into bond_lifetime array
-//     // for each pidx
-//     for (unsigned int i = 0; i < m_num_bonds; i++)
-//         {
-//         // for each thread local memory
-//         for (tbb::enumerable_thread_specific< std::vector< std::vector< unsigned int > > >::const_iterator local_lifetime = m_local_bond_lifetime_array.begin();
-//             local_lifetime != m_local_bond_lifetime_array.end(); ++local_lifetime)
-//             {
-//             for (std::vector< std::vector< unsigned int > >::const_iterator outer_it = (*local_lifetime).begin();
-//                 outer_it != (*local_lifetime).end(); ++outer_it)
-//                 {
-//                 for (std::vector< unsigned int >::const_iterator inner_it = (*outer_it).begin();
-//                     inner_it != (*outer_it).end(); ++inner_it)
-//                     {
-//                     printf("%u ", (*inner_it));
-//                     m_bond_lifetime_array[i].push_back((*inner_it));
-//                     }
-//                 }
-//             }
-//         }
-//     for (unsigned int i = 0; i < m_num_bonds; i++)
-//         {
-//         std::vector< unsigned int >::iterator it;
-//         for (it = m_bond_lifetime_array[i].begin(); it != m_bond_lifetime_array[i].end(); ++it)
-//             {
-//             printf("%u ", (*it));
-//             }
-//         printf("\n");
-//         }
-//     // transfer data into overall_lifetime array
-//     // for each pidx
-//     for (unsigned int i = 0; i < m_num_bonds; i++)
-//         {
-//         // for each thread local memory
-//         for (tbb::enumerable_thread_specific< std::vector< std::vector< unsigned int > > >::const_iterator local_lifetime = m_local_overall_lifetime_array.begin();
-//             local_lifetime != m_local_overall_lifetime_array.end(); ++local_lifetime)
-//             {
-//             for (std::vector< std::vector< unsigned int > >::const_iterator outer_it = (*local_lifetime).begin();
-//                 outer_it != (*local_lifetime).end(); ++outer_it)
-//                 {
-//                 for (std::vector< unsigned int >::const_iterator inner_it = (*outer_it).begin();
-//                     inner_it != (*outer_it).end(); ++inner_it)
-//                     {
-//                     m_overall_lifetime_array[i].push_back((*inner_it));
-//                     }
-//                 }
-//             }
-//         }
-//     // transfer into transition matrix
-//     for (unsigned int i = 0; i < (m_num_bonds+1); i++)
-//         {
-//         for (unsigned int j = 0; j < (m_num_bonds+1); j++)
-//             {
-//             for (tbb::enumerable_thread_specific< unsigned int *>::const_iterator local_transition = m_local_transition_matrix.begin();
-//             local_transition != m_local_transition_matrix.end(); ++local_transition)
-//                 {
-//                 m_transition_matrix.get()[transition_indexer(i, j)] += (*local_transition)[transition_indexer(i, j)];
-//                 }
-//             }
-//         }
-//     }
+void BondingAnalysis::reduceArrays()
+    {
+    const unsigned int num_states = m_num_bonds+1;
+    util::reduceLocalHistograms(m_local_transition_matrix, m_transition_matrix.get(), num_states*num_states);
+
+    // a thread only grows its histograms to the last frame in which it ran
+    m_bond_lifetime_hist.assign(m_frame_counter*m_num_bonds, 0);
+    m_overall_lifetime_hist.assign(m_frame_counter, 0);
+    for (tbb::enumerable_thread_specific< std::vector<unsigned int> >::const_iterator local_hist = m_local_bond_lifetime_hist.begin();
+        local_hist != m_local_bond_lifetime_hist.end(); ++local_hist)
+        for (size_t i = 0; i < local_hist->size(); i++)
+            m_bond_lifetime_hist[i] += (*local_hist)[i];
+    for (tbb::enumerable_thread_specific< std::vector<unsigned int> >::const_iterator local_hist = m_local_overall_lifetime_hist.begin();
+        local_hist != m_local_overall_lifetime_hist.end(); ++local_hist)
+        for (size_t i = 0; i < local_hist->size(); i++)
+            m_overall_lifetime_hist[i] += (*local_hist)[i];
+    m_reduce = false;
+    }
 
 std::vector< std::vector< unsigned int> > BondingAnalysis::getBondLifetimes()
     {
-    return m_bond_lifetime_array;
+    if (m_reduce)
+        reduceArrays();
+    std::vector< std::vector<unsigned int> > lifetimes(m_num_bonds);
+    for (unsigned int bidx = 0; bidx < m_num_bonds; bidx++)
+        for (unsigned int lifetime = 0; lifetime < getNumLifetimes(); lifetime++)
+            lifetimes[bidx].insert(lifetimes[bidx].end(), m_bond_lifetime_hist[lifetime*m_num_bonds + bidx], lifetime);
+    return lifetimes;
     }
 
 std::vector<unsigned int> BondingAnalysis::getOverallLifetimes()
     {
-    return m_overall_lifetime_array;
+    if (m_reduce)
+        reduceArrays();
+    std::vector<unsigned int> lifetimes;
+    for (unsigned int lifetime = 0; lifetime < getNumLifetimes(); lifetime++)
+        lifetimes.insert(lifetimes.end(), m_overall_lifetime_hist[lifetime], lifetime);
+    return lifetimes;
+    }
+
+std::shared_ptr< unsigned int> BondingAnalysis::getBondLifetimeHistogram()
+    {
+    if (m_reduce)
+        reduceArrays();
+    // stored by lifetime so that each frame appends its bin, returned by bond index
+    const unsigned int num_lifetimes = getNumLifetimes();
+    std::shared_ptr<unsigned int> hist = std::shared_ptr<unsigned int>(new unsigned int[std::max(m_num_bonds*num_lifetimes, 1u)], std::default_delete<unsigned int[]>());
+    for (unsigned int bidx = 0; bidx < m_num_bonds; bidx++)
+        for (unsigned int lifetime = 0; lifetime < num_lifetimes; lifetime++)
+            hist.get()[bidx*num_lifetimes + lifetime] = m_bond_lifetime_hist[lifetime*m_num_bonds + bidx];
+    return hist;
+    }
+
+std::shared_ptr< unsigned int> BondingAnalysis::getOverallLifetimeHistogram()
+    {
+    if (m_reduce)
+        reduceArrays();
+    const unsigned int num_lifetimes = getNumLifetimes();
+    std::shared_ptr<unsigned int> hist = std::shared_ptr<unsigned int>(new unsigned int[std::max(num_lifetimes, 1u)], std::default_delete<unsigned int[]>());
+    std::copy(m_overall_lifetime_hist.begin(), m_overall_lifetime_hist.end(), hist.get());
+    return hist;
+    }
+
+unsigned int BondingAnalysis::getNumLifetimes()
+    {
+    return m_frame_counter;
     }
 
 std::shared_ptr< unsigned int> BondingAnalysis::getTransitionMatrix()
     {
+    if (m_reduce)
+        reduceArrays();
     return m_transition_matrix;
     }
 
@@ -179,242 +124,152 @@ unsigned int BondingAnalysis::getNumParticles()
 
 unsigned int BondingAnalysis::getNumBonds()
     {
-    return m_num_particles;
+    return m_num_bonds;
     }
 
-void BondingAnalysis::initialize(unsigned int* frame0)
+//! \internal
+//! Key of a bound slot in the encoding of a frame, which sorts by partner, then by bond
+inline uint64_t bondKey(unsigned int pjdx, unsigned int bidx)
     {
-    Index2D m_frame_indexer = Index2D(m_num_bonds, m_num_particles);
+    return (uint64_t(pjdx) << 32) | bidx;
+    }
 
-    // reset all values
-    for (std::vector< std::vector< std::pair<unsigned int, unsigned int> > >::iterator it = m_overall_increment_array.begin();
-        it != m_overall_increment_array.end(); ++it)
-        {
-        (*it).clear();
-        }
-    for (unsigned int i = 0; i < (m_num_bonds*m_num_particles); i++)
-        {
-        m_bond_increment_array[i] = std::pair<unsigned int, unsigned int>(UINT_MAX, UINT_MAX);
-        }
+//! \internal
+//! Sort the bound slots of particle pidx of a frame into its num_bonds keys, and return how many there are
+inline unsigned int encodeBonds(const unsigned int *frame, size_t pidx, unsigned int num_bonds, uint64_t *keys)
+    {
+    const unsigned int *bonds = frame + pidx*num_bonds;
+    unsigned int n = 0;
+    for (unsigned int bidx = 0; bidx < num_bonds; bidx++)
+        if (bonds[bidx] != UINT_MAX)
+            keys[n++] = bondKey(bonds[bidx], bidx);
+    std::sort(keys, keys + n);
+    return n;
+    }
+
+void BondingAnalysis::initialize(unsigned int* frame0)
+    {
+    // every bond of frame0 starts with a lifetime of 0
+    std::fill(m_bond_count.begin(), m_bond_count.end(), 0);
+    std::fill(m_overall_count.begin(), m_overall_count.end(), 0);
+    encodeFrame(frame0);
+    }
 
-    for(unsigned int pidx=0; pidx<m_num_particles; pidx++)
+void BondingAnalysis::encodeFrame(unsigned int* frame)
+    {
+    const unsigned int num_bonds = m_num_bonds;
+    uint64_t *keys = &m_keys[0];
+    unsigned int *num_keys = &m_num_keys[0];
+    parallel_for(blocked_range<size_t>(0, m_num_particles),
+        [=] (const blocked_range<size_t>& r)
         {
-        // for each particle
-        std::vector<unsigned int> l_bonds_0;
-        l_bonds_0.resize(m_num_bonds);
-        std::vector<unsigned int> s_bonds_0;
-        s_bonds_0.resize(0);
-        // populate bond vectors
-        for(unsigned int bidx=0; bidx<m_num_bonds; bidx++)
-            {
-            // put all bonds in either the full list, or the bond-only list
-            unsigned int pjdx0 = frame0[m_frame_indexer(bidx, pidx)];
-            l_bonds_0[bidx] = pjdx0;
-            if (pjdx0 != UINT_MAX)
-                s_bonds_0.push_back(frame0[m_frame_indexer(bidx, pidx)]);
-            }
-        for (std::vector<unsigned int>::iterator it_pjdx=s_bonds_0.begin(); it_pjdx!=s_bonds_0.end(); ++it_pjdx)
-            {
-            // for each bound particle
-            std::vector<unsigned int>::iterator it_bond;
-            it_bond = std::find_if(l_bonds_0.begin(), l_bonds_0.end(), FindBondIndex(*it_pjdx));
-            if (it_bond != l_bonds_0.end())
-                {
-                // if the bond is found
-                unsigned int bidx = it_bond - l_bonds_0.begin();
-                // add bond to the overall array
-                m_overall_increment_array[pidx].push_back(std::pair<unsigned int, unsigned int>((*it_pjdx), 0));
-                // add bond to the bond array
-                m_bond_increment_array[m_frame_indexer(bidx, pidx)] = std::pair<unsigned int, unsigned int>((*it_pjdx), 0);
-                }
-            else
-                {
-                // this should not be reached
-                printf("unknown bond found during initialization\n");
-                }
-            }
-        }
+        for (size_t pidx = r.begin(); pidx != r.end(); pidx++)
+            num_keys[pidx] = encodeBonds(frame, pidx, num_bonds, keys + pidx*num_bonds);
+        });
     }
 
 void BondingAnalysis::compute(unsigned int* frame0,
                               unsigned int* frame1)
     {
+    encodeFrame(frame0);
+    update(frame1);
+    }
+
+/*! For each particle, the sorted (partner, bond) keys of the last frame and of frame1 are merged, so that each
+    partner is either kept (bound to bound, in the same or another bond), lost (bound to unbound) or gained (unbound
+    to bound). A partner that leaves its bond ends its lifetime in that bond, and a partner that is lost also ends its
+    overall lifetime; both are counted in the histograms of the thread. Bond lifetimes of 0 frames are not counted,
+    as before.
+
+    The keys of frame1 replace those of the last frame, so that each frame is only sorted once.
+*/
+void BondingAnalysis::update(unsigned int* frame1)
+    {
     // track bonds throgh the system
-    Index2D transition_indexer = Index2D((m_num_bonds+1), (m_num_bonds+1));
-    Index2D m_frame_indexer = Index2D(m_num_bonds, m_num_particles);
+    const unsigned int num_bonds = m_num_bonds;
+    const unsigned int num_states = m_num_bonds+1;
+    unsigned int *bond_count = &m_bond_count[0];
+    unsigned int *overall_count = &m_overall_count[0];
+    const uint64_t *keys_0 = &m_keys[0];
+    const unsigned int *num_keys_0 = &m_num_keys[0];
+    uint64_t *keys_1 = &m_next_keys[0];
+    unsigned int *num_keys_1 = &m_next_num_keys[0];
+    // a lifetime ended by the n-th frame is at most n - 1 frames
+    const unsigned int num_lifetimes = m_frame_counter+1;
+    tbb::enumerable_thread_specific<unsigned int *>& local_transition_matrix = m_local_transition_matrix;
+    tbb::enumerable_thread_specific< std::vector<unsigned int> >& local_bond_lifetime_hist = m_local_bond_lifetime_hist;
+    tbb::enumerable_thread_specific< std::vector<unsigned int> >& local_overall_lifetime_hist = m_local_overall_lifetime_hist;
 
-    for(unsigned int pidx=0; pidx<m_num_particles; pidx++)
+    parallel_for(blocked_range<size_t>(0, m_num_particles),
+        [=, &local_transition_matrix, &local_bond_lifetime_hist, &local_overall_lifetime_hist] (const blocked_range<size_t>& r)
         {
-        // for each particle pidx, look at each particle pjdx in a bond pair
-        // create local vectors to store bonding information
-        // specifically which particles pjdx are in which bonds with particles pidx
-        std::vector<unsigned int> l_bonds_0;
-        std::vector<unsigned int> l_bonds_1;
-        l_bonds_0.resize(m_num_bonds);
-        l_bonds_1.resize(m_num_bonds);
-        std::vector<unsigned int> s_bonds_0;
-        std::vector<unsigned int> s_bonds_1;
-        s_bonds_0.resize(0);
-        s_bonds_1.resize(0);
-        // populate bond vectors
-        for(unsigned int bidx=0; bidx<m_num_bonds; bidx++)
+        bool exists;
+        local_transition_matrix.local(exists);
+        if (!exists)
+            local_transition_matrix.local() = util::allocateLocalHistogram<unsigned int>(num_states*num_states);
+        unsigned int *transitions = local_transition_matrix.local();
+        std::vector<unsigned int>& bond_hist = local_bond_lifetime_hist.local();
+        std::vector<unsigned int>& overall_hist = local_overall_lifetime_hist.local();
+        if (overall_hist.size() < num_lifetimes)
             {
-            unsigned int pjdx0 = frame0[m_frame_indexer(bidx, pidx)];
-            unsigned int pjdx1 = frame1[m_frame_indexer(bidx, pidx)];
-            l_bonds_0[bidx] = pjdx0;
-            l_bonds_1[bidx] = pjdx1;
-            if (pjdx0 != UINT_MAX)
-                s_bonds_0.push_back(frame0[m_frame_indexer(bidx, pidx)]);
-            if (pjdx1 != UINT_MAX)
-                s_bonds_1.push_back(frame1[m_frame_indexer(bidx, pidx)]);
+            bond_hist.resize(num_lifetimes*num_bonds, 0);
+            overall_hist.resize(num_lifetimes, 0);
             }
-        // sort bonds for later
-        std::sort(s_bonds_0.begin(), s_bonds_0.end());
-        std::sort(s_bonds_1.begin(), s_bonds_1.end());
-        // create vectors to track bound to bound, bound to unbound, and unbound to bound particles
-        std::vector<unsigned int> b2b;
-        std::vector<unsigned int> b2u;
-        std::vector<unsigned int> u2b;
-        b2b.resize(0);
-        b2u.resize(0);
-        u2b.resize(0);
-        // use intersections and differences to determine these
-        std::set_intersection(s_bonds_0.begin(), s_bonds_0.end(), s_bonds_1.begin(), s_bonds_1.end(), std::back_inserter(b2b));
-        std::set_difference(s_bonds_0.begin(), s_bonds_0.end(), s_bonds_1.begin(), s_bonds_1.end(), std::back_inserter(b2u));
-        std::set_difference(s_bonds_1.begin(), s_bonds_1.end(), s_bonds_0.begin(), s_bonds_0.end(), std::back_inserter(u2b));
-        // bound to unbound transition
-        if (b2u.size() > 0)
+
+        // the new counts, reused for every particle
+        std::vector<unsigned int> new_bond_count(num_bonds);
+        std::vector<unsigned int> new_overall_count(num_bonds);
+
+        for (size_t pidx = r.begin(); pidx != r.end(); pidx++)
             {
-            for (std::vector<unsigned int>::iterator it_pjdx = b2u.begin(); it_pjdx != b2u.end(); ++it_pjdx)
+            const size_t slot0 = pidx*num_bonds;
+            const uint64_t *bonds_0 = keys_0 + slot0;
+            const uint64_t *bonds_1 = keys_1 + slot0;
+            const unsigned int n_0 = num_keys_0[pidx];
+            const unsigned int n_1 = num_keys_1[pidx] = encodeBonds(frame1, pidx, num_bonds, keys_1 + slot0);
+            std::fill(new_bond_count.begin(), new_bond_count.end(), 0);
+            std::fill(new_overall_count.begin(), new_overall_count.end(), 0);
+
+            unsigned int i_0 = 0;
+            unsigned int i_1 = 0;
+            while (i_0 < n_0 || i_1 < n_1)
                 {
-                unsigned int bond_0 = UINT_MAX;
-                unsigned int bond_1 = m_num_bonds;
-                unsigned int current_count;
-                // find, increment, delete
-                std::vector<std::pair< unsigned int, unsigned int> >::iterator it_pair;
-                it_pair = std::find_if(m_overall_increment_array[pidx].begin(),
-                    m_overall_increment_array[pidx].end(), FindParticleIndex(*it_pjdx));
-                if (it_pair != m_overall_increment_array[pidx].end())
+                if (i_1 == n_1 || (i_0 < n_0 && (bonds_0[i_0] >> 32) < (bonds_1[i_1] >> 32)))
                     {
-                    // bond found
-                    std::vector<unsigned int>::iterator it_bond;
-                    // found it, exists, get value
-                    current_count = (*it_pair).second;
-                    // delete old pjdx
-                    m_overall_increment_array[pidx].erase(it_pair);
-                    // increment
-                    m_overall_lifetime_array.push_back(current_count);
-                    // find increment the transition matrix
-                    it_bond = std::find_if(l_bonds_0.begin(), l_bonds_0.end(), FindBondIndex(*it_pjdx));
-                    if (it_bond != l_bonds_0.end())
-                        bond_0 = it_bond-l_bonds_0.begin();
-                    m_transition_matrix.get()[transition_indexer(bond_0, bond_1)]++;
-                    // the bond changed; extract count and stop tracking
-                    unsigned int current_count = m_bond_increment_array[m_frame_indexer(bond_0,pidx)].second;
-                    if ((current_count != 0) && (current_count != UINT_MAX))
-                        m_bond_lifetime_array[bond_0].push_back(current_count);
-                    // let's check to make sure the increment array matches
-                    if (m_bond_increment_array[m_frame_indexer(bond_0,pidx)].first == (*it_bond))
-                        m_bond_increment_array[m_frame_indexer(bond_0,pidx)] = std::pair<unsigned int, unsigned int>(UINT_MAX, UINT_MAX);
+                    // bound to unbound: both lifetimes end
+                    unsigned int bond_0 = (uint32_t) bonds_0[i_0++];
+                    transitions[num_bonds*num_states + bond_0]++;
+                    if (bond_count[slot0 + bond_0] != 0)
+                        bond_hist[bond_count[slot0 + bond_0]*num_bonds + bond_0]++;
+                    overall_hist[overall_count[slot0 + bond_0]]++;
                     }
-                }
-            }
-        if (b2b.size() > 0)
-            {
-            // for each bound to bound transition
-            for (std::vector<unsigned int>::iterator it_pjdx=b2b.begin(); it_pjdx!=b2b.end(); ++it_pjdx)
-                {
-                unsigned int bond_0 = UINT_MAX;
-                unsigned int bond_1 = UINT_MAX;
-                // find, increment, delete
-                std::vector<std::pair< unsigned int, unsigned int> >::iterator it_pair;
-                // first increment in the overall bond lifetime array
-                it_pair = std::find_if(m_overall_increment_array[pidx].begin(),
-                    m_overall_increment_array[pidx].end(), FindParticleIndex(*it_pjdx));
-                if (it_pair != m_overall_increment_array[pidx].end())
-                    (*it_pair).second++;
-                // now increment the transition array
-                std::vector<unsigned int>::iterator it_bond;
-                it_bond = std::find_if(l_bonds_0.begin(), l_bonds_0.end(), FindBondIndex(*it_pjdx));
-                if (it_bond != l_bonds_0.end())
-                    bond_0 = it_bond-l_bonds_0.begin();
-                it_bond = std::find_if(l_bonds_1.begin(), l_bonds_1.end(), FindBondIndex(*it_pjdx));
-                if (it_bond != l_bonds_1.end())
-                    bond_1 = it_bond-l_bonds_1.begin();
-                if ((bond_0 != UINT_MAX) && (bond_1 != UINT_MAX))
-                    m_transition_matrix.get()[transition_indexer(bond_0, bond_1)]++;
-                // use these bonds to increment bond-specific increment array
-                if ((bond_0 != UINT_MAX) && (bond_1 != UINT_MAX))
+                else if (i_0 == n_0 || (bonds_1[i_1] >> 32) < (bonds_0[i_0] >> 32))
                     {
-                    if (bond_0 == bond_1)
-                        {
-                        // increment the bond-to-bond array
-                        // check to make sure that the values are correct
-                        if ((m_bond_increment_array[m_frame_indexer(bond_0,pidx)].first != (*it_pjdx)) || (m_bond_increment_array[m_frame_indexer(bond_1,pidx)].first != (*it_pjdx)))
-                            {
-                            // looks like this line is never reached, leaving in for now
-                            printf("huh?\n");
-                            // sounds like a first frame kind of thing
-                            if ((m_bond_increment_array[m_frame_indexer(bond_0,pidx)].first == UINT_MAX) &&
-                                (m_bond_increment_array[m_frame_indexer(bond_1,pidx)].first == UINT_MAX))
-                                {
-                                // this line is being reached
-                                printf("uninitialized memory detected\n");
-                                m_bond_increment_array[m_frame_indexer(bond_1,pidx)] = std::pair<unsigned int, unsigned int>((*it_pjdx), 1);
-                                }
-                            }
-                        else
-                            m_bond_increment_array[m_frame_indexer(bond_1,pidx)].second++;
-                        }
-                    else
-                        {
-                        // the bond changed; extract count
-                        unsigned int current_count = m_bond_increment_array[m_frame_indexer(bond_0,pidx)].second;
-                        // add count to the lifetime array
-                        if ((current_count != 0) && (current_count != UINT_MAX))
-                            m_bond_lifetime_array[bond_0].push_back(current_count);
-                        // delete from array only if pjdx matches
-                        if (m_bond_increment_array[m_frame_indexer(bond_0,pidx)].first == (*it_pjdx))
-                            m_bond_increment_array[m_frame_indexer(bond_0,pidx)] = std::pair<unsigned int, unsigned int>(UINT_MAX, UINT_MAX);
-                        // ensure we do not overwrite other data
-                        if (m_bond_increment_array[m_frame_indexer(bond_1,pidx)].first != (*it_pjdx))
-                            {
-                            // there is particle data that needs to be saved
-                            current_count = m_bond_increment_array[m_frame_indexer(bond_1,pidx)].second;
-                            if ((current_count != 0) && (current_count != UINT_MAX))
-                                m_bond_lifetime_array[bond_1].push_back(current_count);
-                            }
-                        m_bond_increment_array[m_frame_indexer(bond_1,pidx)] = std::pair<unsigned int, unsigned int>((*it_pjdx), 0);
-                        }
+                    // unbound to bound: start tracking
+                    unsigned int bond_1 = (uint32_t) bonds_1[i_1++];
+                    transitions[bond_1*num_states + num_bonds]++;
                     }
-                }
-            }
-        if (u2b.size() > 0)
-            {
-            for (std::vector<unsigned int>::iterator it_pjdx = u2b.begin(); it_pjdx != u2b.end(); ++it_pjdx)
-                {
-                unsigned int bond_0 = m_num_bonds;
-                unsigned int bond_1 = UINT_MAX;
-                // add to the tracking array
-                m_overall_increment_array[pidx].push_back(std::pair<unsigned int, unsigned int>((*it_pjdx), 0));
-                // increment the transition array
-                std::vector<unsigned int>::iterator it_bond;
-                it_bond = std::find_if(l_bonds_1.begin(), l_bonds_1.end(), FindBondIndex(*it_pjdx));
-                if (it_bond != l_bonds_1.end())
+                else
                     {
-                    // the position of pjdx is the bond idx
-                    bond_1 = it_bond-l_bonds_1.begin();
-                    m_transition_matrix.get()[transition_indexer(bond_0, bond_1)]++;
-                    // bond formed; create start tracking
-                    m_bond_increment_array[m_frame_indexer(bond_1,pidx)] = std::pair<unsigned int, unsigned int>((*it_pjdx), 0);
+                    // bound to bound, in the same bond or another one
+                    unsigned int bond_0 = (uint32_t) bonds_0[i_0++];
+                    unsigned int bond_1 = (uint32_t) bonds_1[i_1++];
+                    transitions[bond_1*num_states + bond_0]++;
+                    new_overall_count[bond_1] = overall_count[slot0 + bond_0] + 1;
+                    if (bond_0 == bond_1)
+                        new_bond_count[bond_1] = bond_count[slot0 + bond_0] + 1;
+                    else if (bond_count[slot0 + bond_0] != 0)
+                        bond_hist[bond_count[slot0 + bond_0]*num_bonds + bond_0]++;
                     }
                 }
+            std::copy(new_bond_count.begin(), new_bond_count.end(), bond_count + slot0);
+            std::copy(new_overall_count.begin(), new_overall_count.end(), overall_count + slot0);
             }
-        }
+        });
+    m_keys.swap(m_next_keys);
+    m_num_keys.swap(m_next_num_keys);
     m_frame_counter++;
     m_reduce = true;
     }
 
 }; }; // end namespace freud::bond
-
-
@@ -12,6 +12,7 @@
 #include <memory>
 #include <algorithm>
 #include <vector>
+#include <stdint.h>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
@@ -20,17 +21,29 @@
 #include "box.h"
 #include "Index1D.h"
 
-#include <map>
-
 #ifndef _BONDING_ANALYSIS_H__
 #define _BONDING_ANALYSIS_H__
 
 /*! \file BondingAnalysis.h
-    \brief Compute the hexatic order parameter for each particle
+    \brief Bond lifetimes and transitions between the bonding frames of the Bonding classes
 */
 
 namespace freud { namespace bond {
 
+//! Follow the bonds of each particle from frame to frame
+/*! The frames are the (particle, bond) arrays of the Bonding classes, as getBonds returns them: the partner of each
+    particle in each tracked bond, or UINT_MAX. Each frame is encoded as the (partner, bond) pairs of the bound slots of
+    each particle, packed in 64 bit keys that sort by partner. The keys of the last frame are kept, so that update
+    only reads and sorts the new frame; compute encodes its frame0 again, which must be the frame at which the
+    lifetimes are, the frame1 of the previous call or the frame given to initialize.
+
+    The state is dense: for each (particle, bond) slot, the number of frames its partner has spent in the slot and the
+    number of frames it has been bound to the particle in any slot. update pairs the partners of the two frames of
+    each particle by merging their sorted keys, in parallel over the particles, and counts the transitions in
+    per-thread matrices. The lifetimes that end are counted in per-thread histograms by number of frames, which grow
+    by one bin per frame instead of by one entry per broken bond. The per-thread counts persist over frames and are
+    only reduced when a getter needs them.
+*/
 class BondingAnalysis
     {
     public:
@@ -41,46 +54,62 @@ class BondingAnalysis
         //! Destructor
         ~BondingAnalysis();
 
+        //! Start tracking the bonds of frame0, each with a lifetime of 0
         void initialize(unsigned int* frame0);
 
-        //! Reduce the arrays for export to python
-        void reduceArrays();
-        //! Compute the bond order
+        //! Compute the bond transitions and the lifetimes that end from frame0 to frame1
         void compute(unsigned int* frame0,
                      unsigned int* frame1);
 
+        //! Compute the bond transitions and the lifetimes that end from the last frame to frame1
+        /*! The last frame is the frame1 of the previous update or compute, or the frame given to initialize. It is
+            kept sorted, so only frame1 is read and sorted.
+        */
+        void update(unsigned int* frame1);
+
+        //! Reduce the per-thread transitions and lifetimes for export to python
+        void reduceArrays();
+
+        //! Get the lifetimes of the broken bonds of each bond index, in increasing order
         std::vector< std::vector< unsigned int> > getBondLifetimes();
+        //! Get the lifetimes of the broken bonds, whatever their bond index, in increasing order
         std::vector< unsigned int> getOverallLifetimes();
+        //! Get the number of broken bonds of each (bond index, lifetime), getNumLifetimes() lifetimes per bond index
+        std::shared_ptr< unsigned int> getBondLifetimeHistogram();
+        //! Get the number of broken bonds of each lifetime
+        std::shared_ptr< unsigned int> getOverallLifetimeHistogram();
+        //! Get the number of bins of the lifetime histograms, one more than the longest possible lifetime
+        unsigned int getNumLifetimes();
+        //! Get the (num_bonds + 1) x (num_bonds + 1) transition counts by (bond in frame1, bond in frame0)
+        /*! The last index means unbound.
+        */
         std::shared_ptr< unsigned int> getTransitionMatrix();
         unsigned int getNumFrames();
         unsigned int getNumParticles();
         unsigned int getNumBonds();
 
     private:
-        unsigned int m_num_particles;       //!< number of frames calc'd
-        unsigned int m_num_bonds;           //!< number of frames calc'd
+        //! Sort the bonds of each particle of frame into m_keys
+        void encodeFrame(unsigned int* frame);
+
+        unsigned int m_num_particles;       //!< number of particles tracked
+        unsigned int m_num_bonds;           //!< number of bonds tracked
         unsigned int m_frame_counter;       //!< number of frames calc'd
+
         bool m_reduce;                      //!< boolean to trigger reduction as needed
-        // Index2D m_transition_indexer;       //!< Indexer to access transition matrix
-        // Index2D m_frame_indexer;            //!< Indexer to access frame matrix
-
-        // tbb::atomic< std::vector< std::vector<unsigned int> > > m_bond_lifetime_array;
-        // tbb::atomic< std::vector< std::vector<unsigned int> > > m_overall_lifetime_array;
-        // tbb::atomic< std::vector< std::pair<unsigned int, unsigned int> > > m_bond_increment_array;
-        // tbb::atomic< std::vector< std::pair<unsigned int, unsigned int> > > m_overall_increment_array;
-        std::vector< std::vector<unsigned int> > m_bond_lifetime_array;
-        std::vector<unsigned int> m_overall_lifetime_array;
-        std::shared_ptr<unsigned int> m_transition_matrix;
-
-        // tbb::enumerable_thread_specific< std::vector< std::vector< unsigned int > > > m_local_bond_lifetime_array;
-        // tbb::enumerable_thread_specific< std::vector< std::vector< unsigned int > > > m_local_overall_lifetime_array;
-        // tbb::enumerable_thread_specific< std::vector< std::vector< std::pair< unsigned int, unsigned int > > > > m_local_bond_increment_array;
-        std::pair<unsigned int, unsigned int> *m_bond_increment_array;
-        std::vector< std::vector< std::pair< unsigned int, unsigned int > > > m_overall_increment_array;
-        // tbb::enumerable_thread_specific< std::vector< std::vector< std::pair< unsigned int, unsigned int > > > > m_local_overall_increment_array;
-        // tbb::enumerable_thread_specific< std::pair< unsigned int, unsigned int > *> m_local_bond_increment_array;
-        // tbb::enumerable_thread_specific< std::pair< unsigned int, unsigned int > *> m_local_overall_increment_array;
+
+        std::vector<unsigned int> m_bond_count;         //!< frames spent by the partner of each slot in that slot
+        std::vector<unsigned int> m_overall_count;      //!< frames spent bound by the partner of each slot
+        std::vector<uint64_t> m_keys;                   //!< (partner, bond) keys of the last frame, sorted by particle
+        std::vector<unsigned int> m_num_keys;           //!< number of keys of each particle in the last frame
+        std::vector<uint64_t> m_next_keys;              //!< keys of the frame being compared
+        std::vector<unsigned int> m_next_num_keys;      //!< number of keys of each particle of the frame being compared
+        std::vector<unsigned int> m_bond_lifetime_hist;     //!< broken bonds by (lifetime, bond index)
+        std::vector<unsigned int> m_overall_lifetime_hist;  //!< broken bonds by lifetime
+        std::shared_ptr<unsigned int> m_transition_matrix;  //!< transitions summed over the threads
         tbb::enumerable_thread_specific<unsigned int *> m_local_transition_matrix;
+        tbb::enumerable_thread_specific< std::vector<unsigned int> > m_local_bond_lifetime_hist;
+        tbb::enumerable_thread_specific< std::vector<unsigned int> > m_local_overall_lifetime_hist;
     };
 
 }; }; // end namespace freud::bond
@@ -25,7 +25,7 @@ BondingR12::BondingR12(float r_max,
                        unsigned int *bond_map,
                        unsigned int *bond_list)
     : m_box(box::Box()), m_r_max(r_max), m_t_max(2.0*M_PI), m_nbins_r(n_r), m_nbins_t2(n_t2), m_nbins_t1(n_t1),
-      m_n_bonds(n_bonds), m_bond_map(bond_map), m_bond_list(bond_list), m_n_ref(0), m_n_p(0)
+      m_n_bonds(n_bonds), m_n_ref(0), m_n_p(0), m_cell_order(true)
     {
     // create the unsigned int array to store whether or not a particle is paired
     m_bonds = std::shared_ptr<unsigned int>(new unsigned int[m_n_ref*m_n_bonds], std::default_delete<unsigned int[]>());
@@ -53,22 +53,29 @@ BondingR12::BondingR12(float r_max,
     // create mapping between bond index and list index
     for (unsigned int i = 0; i < m_n_bonds; i++)
         {
-        m_list_map[m_bond_list[i]] = i;
+        m_list_map[bond_list[i]] = i;
         }
 
     // create mapping between list index and bond index
     for (unsigned int i = 0; i < m_n_bonds; i++)
         {
-        m_rev_list_map[i] = m_bond_list[i];
+        m_rev_list_map[i] = bond_list[i];
+        }
+
+    // list index of the bond of each bin, or UINT_MAX for the bins of the bonds that are not tracked
+    m_bin_list_idx.resize(size_t(m_nbins_r)*m_nbins_t2*m_nbins_t1);
+    for (size_t b = 0; b < m_bin_list_idx.size(); b++)
+        {
+        auto list_idx = m_list_map.find(bond_map[b]);
+        m_bin_list_idx[b] = (list_idx != m_list_map.end()) ? list_idx->second : UINT_MAX;
         }
 
     // create cell list
-    m_lc = new locality::LinkCell(m_box, m_r_max);
+    m_lc = locality::SharedLinkCell(m_box, m_r_max);
     }
 
 BondingR12::~BondingR12()
     {
-    delete m_lc;
     }
 
 std::shared_ptr<unsigned int> BondingR12::getBonds()
@@ -92,17 +99,25 @@ void BondingR12::compute(box::Box& box,
                          unsigned int n_ref,
                          vec3<float> *points,
                          float *orientations,
-                         unsigned int n_p)
+                         unsigned int n_p,
+                         const locality::NeighborList *nlist)
     {
     m_box = box;
     // compute the cell list
-    m_lc->computeCellList(m_box,points,n_p);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc.compute(m_box, points, n_p);
     if (n_ref != m_n_ref)
         {
         // make sure to clear this out at some point
         m_bonds = std::shared_ptr<unsigned int>(new unsigned int[n_ref*m_n_bonds], std::default_delete<unsigned int[]>());
         }
     std::fill(m_bonds.get(), m_bonds.get()+int(n_ref*m_n_bonds), UINT_MAX);
+    // consecutive reference points of a task share their neighbor cells
+    const unsigned int *order = NULL;
+    if (nlist == NULL && m_cell_order && n_ref >= locality::CELL_ORDER_MIN_POINTS)
+        order = m_work_partition.orderByCell(*m_lc, ref_points, n_ref, points, n_p);
     // compute the order parameter
     parallel_for(blocked_range<size_t>(0,n_ref),
         [=] (const blocked_range<size_t>& br)
@@ -116,18 +131,85 @@ void BondingR12::compute(box::Box& box,
             // indexer for bond map
             Index3D b_i = Index3D(m_nbins_t1, m_nbins_t2, m_nbins_r);
 
-            for(size_t i=br.begin(); i!=br.end(); ++i)
+            // log the bond between ref point i and point j, with delta pointing from i to j
+            auto logBond = [&] (size_t i, float ref_angle, unsigned int j, const vec3<float>& delta)
+                {
+                float rsq = dot(delta, delta);
+                // particle cannot pair with itself...i != j is probably better?
+                if ((rsq < 1e-6) || (rsq > rmaxsq))
+                    {
+                    return;
+                    }
+                // determine which histogram bin to look in
+                float r = sqrtf(rsq);
+                float d_theta1 = atan2(delta.y, delta.x);
+                float d_theta2 = atan2(-delta.y, -delta.x);
+                float t1 = ref_angle - d_theta1;
+                float t2 = orientations[j] - d_theta2;
+                // make sure that t1, t2 are bounded between 0 and 2PI
+                t1 = fmod(t1, 2*M_PI);
+                if (t1 < 0)
+                    {
+                    t1 += 2*M_PI;
+                    }
+                t2 = fmod(t2, 2*M_PI);
+                if (t2 < 0)
+                    {
+                    t2 += 2*M_PI;
+                    }
+                // bin that point
+                float bin_r = r * dr_inv;
+                float bin_t1 = floorf(t1 * dt1_inv);
+                float bin_t2 = floorf(t2 * dt2_inv);
+                // fast float to int conversion with truncation
+                #ifdef __SSE2__
+                unsigned int ibin_r = _mm_cvtt_ss2si(_mm_load_ss(&bin_r));
+                unsigned int ibin_t1 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t1));
+                unsigned int ibin_t2 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t2));
+                #else
+                unsigned int ibin_r = (unsigned int)(bin_r);
+                unsigned int ibin_t1 = (unsigned int)(bin_t1);
+                unsigned int ibin_t2 = (unsigned int)(bin_t2);
+                #endif
+
+                // log the bond
+                if ((ibin_r < m_nbins_r) && (ibin_t1 < m_nbins_t1) && (ibin_t2 < m_nbins_t2))
+                    {
+                    // find the list index of the bond that corresponds to this point
+                    unsigned int list_idx = m_bin_list_idx[b_i(ibin_t1, ibin_t2, ibin_r)];
+                    // bin if bond is tracked
+                    if (list_idx != UINT_MAX)
+                        {
+                        m_bonds.get()[a_i(list_idx, (unsigned int)i)] = j;
+                        }
+                    }
+                };
+
+            for(size_t pos=br.begin(); pos!=br.end(); ++pos)
                 {
-                // huh?
-                std::map<unsigned int, std::vector<unsigned int> > l_bonds;
+                size_t i = (order != NULL) ? order[pos] : pos;
                 // get position, orientation of particle i
                 vec3<float> ref_pos = ref_points[i];
                 float ref_angle = ref_orientations[i];
+
+                if (nlist != NULL)
+                    {
+                    const unsigned int *index_j = nlist->getIndexJ().get();
+                    const vec3<float> *vectors = nlist->getVectors().get();
+                    for (size_t nbond = nlist->getFirstBond(i); nbond < nlist->getLastBond(i); nbond++)
+                        {
+                        unsigned int j = index_j[nbond];
+                        vec3<float> delta = (vectors != NULL) ? vectors[nbond] : m_box.wrap(points[j] - ref_pos);
+                        logBond(i, ref_angle, j, delta);
+                        }
+                    continue;
+                    }
+
                 // get cell for particle i
                 unsigned int ref_cell = m_lc->getCell(ref_pos);
 
                 //loop over neighbor cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+                const locality::CellNeighbors& neigh_cells = m_lc->getCellNeighbors(ref_cell);
                 for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                     {
                     // get neighbor cell
@@ -139,58 +221,7 @@ void BondingR12::compute(box::Box& box,
                         {
                         //compute r between the two particles
                         vec3<float> delta = m_box.wrap(points[j] - ref_pos);
-
-                        float rsq = dot(delta, delta);
-                        // particle cannot pair with itself...i != j is probably better?
-                        if ((rsq < 1e-6) || (rsq > rmaxsq))
-                            {
-                            continue;
-                            }
-                        // determine which histogram bin to look in
-                        float r = sqrtf(rsq);
-                        float d_theta1 = atan2(delta.y, delta.x);
-                        float d_theta2 = atan2(-delta.y, -delta.x);
-                        float t1 = ref_angle - d_theta1;
-                        float t2 = orientations[j] - d_theta2;
-                        // make sure that t1, t2 are bounded between 0 and 2PI
-                        t1 = fmod(t1, 2*M_PI);
-                        if (t1 < 0)
-                            {
-                            t1 += 2*M_PI;
-                            }
-                        t2 = fmod(t2, 2*M_PI);
-                        if (t2 < 0)
-                            {
-                            t2 += 2*M_PI;
-                            }
-                        // bin that point
-                        float bin_r = r * dr_inv;
-                        float bin_t1 = floorf(t1 * dt1_inv);
-                        float bin_t2 = floorf(t2 * dt2_inv);
-                        // fast float to int conversion with truncation
-                        #ifdef __SSE2__
-                        unsigned int ibin_r = _mm_cvtt_ss2si(_mm_load_ss(&bin_r));
-                        unsigned int ibin_t1 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t1));
-                        unsigned int ibin_t2 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t2));
-                        #else
-                        unsigned int ibin_r = (unsigned int)(bin_r);
-                        unsigned int ibin_t1 = (unsigned int)(bin_t1);
-                        unsigned int ibin_t2 = (unsigned int)(bin_t2);
-                        #endif
-
-                        // log the bond
-                        if ((ibin_r < m_nbins_r) && (ibin_t1 < m_nbins_t1) && (ibin_t2 < m_nbins_t2))
-                            {
-                            // find the bond that corresponds to this point
-                            unsigned int bond = m_bond_map[b_i(ibin_t1, ibin_t2, ibin_r)];
-                            // get the index from the map
-                            auto list_idx = m_list_map.find(bond);
-                            // bin if bond is tracked
-                            if (list_idx != m_list_map.end())
-                                {
-                                m_bonds.get()[a_i((unsigned int)(list_idx->second), (unsigned int)i)] = j;
-                                }
-                            }
+                        logBond(i, ref_angle, j, delta);
                         }
                     }
                 }
@@ -11,11 +11,14 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "NearestNeighbors.h"
+#include "SharedLinkCell.h"
+#include "WorkPartition.h"
 #include "box.h"
 #include "Index1D.h"
 
@@ -54,11 +57,34 @@ class BondingR12
                      unsigned int n_ref,
                      vec3<float> *points,
                      float *orientations,
-                     unsigned int n_p);
+                     unsigned int n_p,
+                     const locality::NeighborList *nlist=NULL);
 
         //! Get a reference to the last computed bond list
         std::shared_ptr<unsigned int> getBonds();
 
+        //! Set whether the reference points are visited in the order of their cells, when there are at least
+        //! locality::CELL_ORDER_MIN_POINTS of them (the default) or never
+        void setCellOrder(bool cell_order)
+            {
+            m_cell_order = cell_order;
+            }
+
+        //! Get whether the reference points are visited in the order of their cells
+        bool getCellOrder() const
+            {
+            return m_cell_order;
+            }
+
+        //! Share a LinkCell with other analyses of the same points, or use an own one again if \a lc is NULL
+        /*! The cell width of \a lc must be at least the cutoff; its cell list is only computed when it is not
+            already that of the frame (see locality::SharedLinkCell).
+        */
+        void setLinkCell(std::shared_ptr<locality::LinkCell> lc)
+            {
+            m_lc.share(lc);
+            }
+
         std::map<unsigned int, unsigned int> getListMap();
 
         std::map<unsigned int, unsigned int> getRevListMap();
@@ -84,13 +110,14 @@ class BondingR12
         unsigned int m_nbins_t1;             //!< Number of y bins to compute bonds
         unsigned int m_nbins_t2;             //!< Number of y bins to compute bonds
         unsigned int m_n_bonds;                        //!< number of bonds to track
-        unsigned int *m_bond_map;                   //!< pointer to bonding map
-        unsigned int *m_bond_list;
         std::map<unsigned int, unsigned int> m_list_map; //! maps bond index to list index
         std::map<unsigned int, unsigned int> m_rev_list_map; //! maps list index to bond index
-        locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        std::vector<unsigned int> m_bin_list_idx;   //!< list index of the bond of each bin, UINT_MAX if untracked
+        locality::SharedLinkCell m_lc;              //!< LinkCell to bin particles for the computation
         unsigned int m_n_ref;                //!< Last number of points computed
         unsigned int m_n_p;                //!< Last number of points computed
+        bool m_cell_order;                 //!< true to visit the reference points in cell order
+        locality::WorkPartition m_work_partition;   //!< Cell order of the reference points
 
         std::shared_ptr<unsigned int> m_bonds;
     };
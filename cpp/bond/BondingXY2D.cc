@@ -25,7 +25,7 @@ BondingXY2D::BondingXY2D(float x_max,
                          unsigned int *bond_map,
                          unsigned int *bond_list)
     : m_box(box::Box()), m_x_max(x_max), m_y_max(y_max), m_nbins_x(n_bins_x), m_nbins_y(n_bins_y),
-      m_n_bonds(n_bonds), m_bond_map(bond_map), m_bond_list(bond_list), m_n_ref(0), m_n_p(0)
+      m_n_bonds(n_bonds), m_n_ref(0), m_n_p(0), m_cell_order(true)
     {
     // create the unsigned int array to store whether or not a particle is paired
     m_bonds = std::shared_ptr<unsigned int>(new unsigned int[m_n_ref*m_n_bonds], std::default_delete<unsigned int[]>());
@@ -49,24 +49,31 @@ BondingXY2D::BondingXY2D(float x_max,
     // create mapping between bond index and list index
     for (unsigned int i = 0; i < m_n_bonds; i++)
         {
-        m_list_map[m_bond_list[i]] = i;
+        m_list_map[bond_list[i]] = i;
         }
 
     // create mapping between list index and bond index
     for (unsigned int i = 0; i < m_n_bonds; i++)
         {
-        m_rev_list_map[i] = m_bond_list[i];
+        m_rev_list_map[i] = bond_list[i];
+        }
+
+    // list index of the bond of each bin, or UINT_MAX for the bins of the bonds that are not tracked
+    m_bin_list_idx.resize(size_t(m_nbins_x)*m_nbins_y);
+    for (size_t b = 0; b < m_bin_list_idx.size(); b++)
+        {
+        auto list_idx = m_list_map.find(bond_map[b]);
+        m_bin_list_idx[b] = (list_idx != m_list_map.end()) ? list_idx->second : UINT_MAX;
         }
 
     m_r_max = sqrtf(m_x_max*m_x_max + m_y_max*m_y_max);
 
     // create cell list
-    m_lc = new locality::LinkCell(m_box, m_r_max);
+    m_lc = locality::SharedLinkCell(m_box, m_r_max);
     }
 
 BondingXY2D::~BondingXY2D()
     {
-    delete m_lc;
     }
 
 std::shared_ptr<unsigned int> BondingXY2D::getBonds()
@@ -90,17 +97,25 @@ void BondingXY2D::compute(box::Box& box,
                           unsigned int n_ref,
                           vec3<float> *points,
                           float *orientations,
-                          unsigned int n_p)
+                          unsigned int n_p,
+                          const locality::NeighborList *nlist)
     {
     m_box = box;
     // compute the cell list
-    m_lc->computeCellList(m_box,points,n_p);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc.compute(m_box, points, n_p);
     if (n_ref != m_n_ref)
         {
         // make sure to clear this out at some point
         m_bonds = std::shared_ptr<unsigned int>(new unsigned int[n_ref*m_n_bonds], std::default_delete<unsigned int[]>());
         }
     std::fill(m_bonds.get(), m_bonds.get()+int(n_ref*m_n_bonds), UINT_MAX);
+    // consecutive reference points of a task share their neighbor cells
+    const unsigned int *order = NULL;
+    if (nlist == NULL && m_cell_order && n_ref >= locality::CELL_ORDER_MIN_POINTS)
+        order = m_work_partition.orderByCell(*m_lc, ref_points, n_ref, points, n_p);
     // compute the order parameter
     parallel_for(blocked_range<size_t>(0,n_ref),
         [=] (const blocked_range<size_t>& br)
@@ -112,15 +127,72 @@ void BondingXY2D::compute(box::Box& box,
             // indexer for bond map
             Index2D b_i = Index2D(m_nbins_x, m_nbins_y);
 
-            for(size_t i=br.begin(); i!=br.end(); ++i)
+            // log the bond between ref point i and point j, with delta pointing from i to j
+            auto logBond = [&] (size_t i, const rotmat2<float>& ref_rot, unsigned int j, const vec3<float>& delta)
+                {
+                float rsq = dot(delta, delta);
+                // particle cannot pair with itself...i != j is probably better?
+                // if particle is not outside of possible radius
+                if ((rsq < 1e-6) || (rsq >= m_r_max))
+                    {
+                    return;
+                    }
+                /// rotate interparticle vector
+                vec2<float> myVec(delta.x, delta.y);
+                vec2<float> rotVec = ref_rot * myVec;
+                float x = rotVec.x + m_x_max;
+                float y = rotVec.y + m_y_max;
+
+                // find the bin to increment
+                float binx = floorf(x * dx_inv);
+                float biny = floorf(y * dy_inv);
+                // fast float to int conversion with truncation
+                #ifdef __SSE2__
+                unsigned int ibinx = _mm_cvtt_ss2si(_mm_load_ss(&binx));
+                unsigned int ibiny = _mm_cvtt_ss2si(_mm_load_ss(&biny));
+                #else
+                unsigned int ibinx = (unsigned int)(binx);
+                unsigned int ibiny = (unsigned int)(biny);
+                #endif
+
+                // log the bond
+                if ((ibinx < m_nbins_x) && (ibiny < m_nbins_y))
+                    {
+                    // find the list index of the bond that corresponds to this point
+                    unsigned int list_idx = m_bin_list_idx[b_i(ibinx, ibiny)];
+                    // bin if bond is tracked
+                    if (list_idx != UINT_MAX)
+                        {
+                        m_bonds.get()[a_i(list_idx, (unsigned int)i)] = j;
+                        }
+                    }
+                };
+
+            for(size_t pos=br.begin(); pos!=br.end(); ++pos)
                 {
+                size_t i = (order != NULL) ? order[pos] : pos;
                 // get position, orientation of particle i
                 vec3<float> ref_pos = ref_points[i];
+                rotmat2<float> ref_rot = rotmat2<float>::fromAngle(-ref_orientations[i]);
+
+                if (nlist != NULL)
+                    {
+                    const unsigned int *index_j = nlist->getIndexJ().get();
+                    const vec3<float> *vectors = nlist->getVectors().get();
+                    for (size_t nbond = nlist->getFirstBond(i); nbond < nlist->getLastBond(i); nbond++)
+                        {
+                        unsigned int j = index_j[nbond];
+                        vec3<float> delta = (vectors != NULL) ? vectors[nbond] : m_box.wrap(points[j] - ref_pos);
+                        logBond(i, ref_rot, j, delta);
+                        }
+                    continue;
+                    }
+
                 // get cell for particle i
                 unsigned int ref_cell = m_lc->getCell(ref_pos);
 
                 //loop over neighbor cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+                const locality::CellNeighbors& neigh_cells = m_lc->getCellNeighbors(ref_cell);
                 for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                     {
                     // get neighbor cell
@@ -132,49 +204,7 @@ void BondingXY2D::compute(box::Box& box,
                         {
                         //compute r between the two particles
                         vec3<float> delta = m_box.wrap(points[j] - ref_pos);
-
-                        float rsq = dot(delta, delta);
-                        // particle cannot pair with itself...i != j is probably better?
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
-                        // if particle is not outside of possible radius
-                        if (rsq < m_r_max)
-                            {
-                            /// rotate interparticle vector
-                            vec2<float> myVec(delta.x, delta.y);
-                            rotmat2<float> myMat = rotmat2<float>::fromAngle(-ref_orientations[i]);
-                            vec2<float> rotVec = myMat * myVec;
-                            float x = rotVec.x + m_x_max;
-                            float y = rotVec.y + m_y_max;
-
-                            // find the bin to increment
-                            float binx = floorf(x * dx_inv);
-                            float biny = floorf(y * dy_inv);
-                            // fast float to int conversion with truncation
-                            #ifdef __SSE2__
-                            unsigned int ibinx = _mm_cvtt_ss2si(_mm_load_ss(&binx));
-                            unsigned int ibiny = _mm_cvtt_ss2si(_mm_load_ss(&biny));
-                            #else
-                            unsigned int ibinx = (unsigned int)(binx);
-                            unsigned int ibiny = (unsigned int)(biny);
-                            #endif
-
-                            // log the bond
-                            if ((ibinx < m_nbins_x) && (ibiny < m_nbins_y))
-                                {
-                                // find the bond that corresponds to this point
-                                unsigned int bond = m_bond_map[b_i(ibinx, ibiny)];
-                                // get the index from the map
-                                auto list_idx = m_list_map.find(bond);
-                                // bin if bond is tracked
-                                if (list_idx != m_list_map.end())
-                                    {
-                                    m_bonds.get()[a_i((unsigned int)(list_idx->second), (unsigned int)i)] = j;
-                                    }
-                                }
-                            }
+                        logBond(i, ref_rot, j, delta);
                         }
                     }
                 }
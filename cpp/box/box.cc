@@ -2,11 +2,83 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include <iostream>
+#include <tbb/tbb.h>
 
 #include "box.h"
 #include "Index1D.h"
 
 using namespace std;
+using namespace tbb;
+
+/*! \file box.cc
+    \brief Array versions of the Box coordinate transformations
+*/
+
 namespace freud { namespace box {
 
+void Box::wrap(vec3<float> *vecs, unsigned int Np) const
+    {
+    const WrapContext wrap_context = m_wrap;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            vecs[i] = wrap_context.wrap(vecs[i]);
+        });
+    }
+
+void Box::wrap(vec3<float> *vecs, vec3<int> *images, unsigned int Np) const
+    {
+    const WrapContext wrap_context = m_wrap;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            vecs[i] = wrap_context.wrap(vecs[i], images[i]);
+        });
+    }
+
+void Box::unwrap(vec3<float> *vecs, const vec3<int> *images, unsigned int Np) const
+    {
+    // same operations as the single vector unwrap, with the lattice vectors computed once
+    const vec3<float> a1 = getLatticeVector(0);
+    const vec3<float> a2 = getLatticeVector(1);
+    const vec3<float> a3 = m_2d ? vec3<float>(0.0f, 0.0f, 0.0f) : getLatticeVector(2);
+    const bool is_2d = m_2d;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            const vec3<int>& image = images[i];
+            vec3<float> p = vecs[i];
+            p += a1 * float(image.x);
+            p += a2 * float(image.y);
+            if (!is_2d)
+                p += a3 * float(image.z);
+            vecs[i] = p;
+            }
+        });
+    }
+
+void Box::makeFraction(vec3<float> *vecs, unsigned int Np) const
+    {
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            vecs[i] = makeFraction(vecs[i]);
+        });
+    }
+
+void Box::makeCoordinates(vec3<float> *vecs, unsigned int Np) const
+    {
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            vecs[i] = makeCoordinates(vecs[i]);
+        });
+    }
+
 }; };
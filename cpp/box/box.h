@@ -9,6 +9,10 @@
 #include "VectorMath.h"
 #include <math.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #ifndef _BOX_H__
 #define _BOX_H__
 
@@ -18,6 +22,105 @@
 
 namespace freud { namespace box {
 
+//! Quantities precomputed by a Box for the minimum image wrap
+/*! Wrapping a vector needs the box lengths, their inverses, and the products of the lengths with the tilt factors.
+    Box keeps them up to date in a WrapContext so that wrap() does not recompute them on every call. Along the
+    directions that are not periodic (and along z in 2D) the lengths and inverse lengths are stored as zero, which
+    turns the wrap along those directions into a no-op without testing the periodic flags.
+
+    wrap() computes the fractional coordinates of the vector relative to the center of the box, rounds them to the
+    nearest integer to find the image, and subtracts the corresponding lattice vectors. There are no branches, and
+    vectors any number of images away are wrapped correctly. As with the image tracking wrap, the result lies in
+    [lo, hi): vectors exactly on the upper boundary of the box are moved to the lower boundary.
+*/
+struct WrapContext
+    {
+    vec3<float> L;          //!< Box lengths, zero along non periodic directions
+    vec3<float> Linv;       //!< Inverse box lengths, zero along non periodic directions
+    float xy;               //!< xy tilt factor
+    float yz;               //!< yz tilt factor
+    float tilt_xz;          //!< xz - xy*yz, the z coefficient of the fractional x coordinate
+    float Ly_xy;            //!< Ly*xy, x component of the second lattice vector
+    float Lz_xz;            //!< Lz*xz, x component of the third lattice vector
+    float Lz_yz;            //!< Lz*yz, y component of the third lattice vector
+    bool tilted;            //!< True when any tilt factor is nonzero
+    bool is2D;              //!< True for 2D boxes
+
+    //! Round to the nearest integer, halfway cases up
+    static float roundNearest(float f)
+        {
+        float g = f + 0.5f;
+        #ifdef __SSE2__
+        // floor of g from the truncation, corrected for negative g
+        float t = float(_mm_cvtt_ss2si(_mm_load_ss(&g)));
+        return t - ((t > g) ? 1.0f : 0.0f);
+        #else
+        return floorf(g);
+        #endif
+        }
+
+    //! Get the number of lattice vectors of each kind between a vector and its minimum image
+    vec3<float> findImage(const vec3<float>& w) const
+        {
+        return vec3<float>(roundNearest((w.x - tilt_xz * w.z - xy * w.y) * Linv.x),
+                           roundNearest((w.y - yz * w.z) * Linv.y),
+                           roundNearest(w.z * Linv.z));
+        }
+
+    //! Get the minimum image of a vector in a box of any shape
+    vec3<float> wrap(const vec3<float>& w) const
+        {
+        return wrap<true, false>(w);
+        }
+
+    //! Get the minimum image of a vector, leaving out the arithmetic the shape of the box does not need
+    /*! \tparam tilted_box False when all tilt factors are zero (see \a tilted)
+        \tparam box_2d True for 2D boxes (see \a is2D), where the z component is left unchanged
+
+        The instantiation for a box must match its shape; the general one, wrap<true, false>, is valid for all boxes.
+        Hot loops select the instantiation once and call it for every pair, so that orthorhombic boxes do no tilt
+        arithmetic.
+    */
+    template<bool tilted_box, bool box_2d>
+    vec3<float> wrap(const vec3<float>& w) const
+        {
+        float fx = tilted_box ? (w.x - tilt_xz * w.z - xy * w.y) : w.x;
+        float fy = tilted_box ? (w.y - yz * w.z) : w.y;
+        float nx = roundNearest(fx * Linv.x);
+        float ny = roundNearest(fy * Linv.y);
+        float shift_x = nx * L.x;
+        float shift_y = ny * L.y;
+        if (tilted_box)
+            shift_x += ny * Ly_xy;
+        vec3<float> result(w.x, w.y, w.z);
+        if (!box_2d)
+            {
+            float nz = roundNearest(w.z * Linv.z);
+            if (tilted_box)
+                {
+                shift_x += nz * Lz_xz;
+                shift_y += nz * Lz_yz;
+                }
+            result.z -= nz * L.z;
+            }
+        result.x -= shift_x;
+        result.y -= shift_y;
+        return result;
+        }
+
+    //! Get the minimum image of a vector and add the lattice vectors removed from it to its image
+    vec3<float> wrap(const vec3<float>& w, vec3<int>& image) const
+        {
+        vec3<float> n = findImage(w);
+        image.x += int(n.x);
+        image.y += int(n.y);
+        image.z += int(n.z);
+        return vec3<float>(w.x - (n.x * L.x + n.y * Ly_xy + n.z * Lz_xz),
+                           w.y - (n.y * L.y + n.z * Lz_yz),
+                           w.z - n.z * L.z);
+        }
+    };
+
 //! Stores box dimensions and provides common routines for wrapping vectors back into the box
 /*! Box stores a standard hoomd simulation box that goes from -L/2 to L/2 in each dimension, allowing Lx, Ly, Lz, and triclinic tilt factors xy, xz, and yz to be specified independently.
  *
@@ -39,35 +142,35 @@ class Box
         Box() //Lest you think of removing this, it's needed by the DCDLoader. No touching.
             {
             m_2d = false; //Assign before calling setL!
-            setL(0,0,0);
             m_periodic = make_uchar3(1,1,1);
             m_xy = m_xz = m_yz = 0;
+            setL(0,0,0);
             }
 
         //! Construct a cubic box
         Box(float L, bool _2d=false)
             {
             m_2d = _2d; //Assign before calling setL!
-            setL(L,L,L);
             m_periodic = make_uchar3(1,1,1);
             m_xy = m_xz = m_yz = 0;
+            setL(L,L,L);
             }
         //! Construct an orthorhombic box
         Box(float Lx, float Ly, float Lz, bool _2d=false)
             {
             m_2d = _2d;  //Assign before calling setL!
-            setL(Lx,Ly,Lz);
             m_periodic = make_uchar3(1,1,1);
             m_xy = m_xz = m_yz = 0;
+            setL(Lx,Ly,Lz);
             }
 
         //! Construct a triclinic box
         Box(float Lx, float Ly, float Lz, float xy, float xz, float yz, bool _2d=false)
             {
             m_2d = _2d;  //Assign before calling setL!
-            setL(Lx,Ly,Lz);
             m_periodic = make_uchar3(1,1,1);
             m_xy = xy; m_xz = xz; m_yz = yz;
+            setL(Lx,Ly,Lz);
             }
 
         inline bool operator ==(const Box&b) const
@@ -108,6 +211,7 @@ class Box
                 {
                 m_Linv = vec3<float>(1/m_L.x, 1/m_L.y, 1/m_L.z);
                 }
+            updateWrapContext();
             }
 
         //! Set whether box is 2D
@@ -116,6 +220,7 @@ class Box
             m_2d = _2d;
             m_L.z = 0;
             m_Linv.z =0;
+            updateWrapContext();
             }
 
         //! Returns whether box is two dimensional
@@ -125,6 +230,18 @@ class Box
             }
 
 
+        //! Get the lower corner of the box
+        vec3<float> getLo() const
+            {
+            return m_lo;
+            }
+
+        //! Get the upper corner of the box
+        vec3<float> getHi() const
+            {
+            return m_hi;
+            }
+
         //! Get the value of Lx
         float getLx() const
             {
@@ -184,7 +301,23 @@ class Box
             alpha.x is 0 when \a x is on the far left side of the box and 1.0 when it is on the far right. If x is
             outside of the box in either direction, it will go larger than 1 or less than 0 keeping the same scaling.
         */
-        vec3<float> makeFraction(const vec3<float>& v, const vec3<float>& ghost_width=vec3<float>(0.0,0.0,0.0)) const
+        vec3<float> makeFraction(const vec3<float>& v) const
+            {
+            // multiply by the stored inverse lengths rather than dividing
+            vec3<float> delta = v - m_lo;
+            delta.x -= (m_xz-m_yz*m_xy)*v.z+m_xy*v.y;
+            delta.y -= m_yz * v.z;
+            delta = delta * m_Linv;
+
+            if (m_2d)
+                {
+                delta.z = 0.0f;
+                }
+            return delta;
+            }
+
+        //! Compute the position of the particle in box relative coordinates of a box extended by ghost_width
+        vec3<float> makeFraction(const vec3<float>& v, const vec3<float>& ghost_width) const
             {
             vec3<float> delta = v - m_lo;
             delta.x -= (m_xz-m_yz*m_xy)*v.z+m_xy*v.y;
@@ -358,54 +491,11 @@ class Box
 
 
 
+        //! Replace a vector by its minimum image, without tracking the image (see WrapContext::wrap)
         void minimalwrap(vec3<float>& w) const
             {
-            vec3<float> L = getL();
-
-            if (m_periodic.x)
-                {
-                float tilt_x = (m_xz - m_xy*m_yz) * w.z + m_xy * w.y;
-                if (w.x >= m_hi.x + tilt_x)
-                    {
-                    w.x -= L.x;
-                    }
-                else if (w.x < m_lo.x + tilt_x)
-                    {
-                    w.x += L.x;
-                    }
-                }
-
-            if (m_periodic.y)
-                {
-                float tilt_y = m_yz * w.z;
-                if (w.y >= m_hi.y + tilt_y)
-                    {
-                    w.y -= L.y;
-                    w.x -= L.y * m_xy;
-                    }
-                else if (w.y < m_lo.y + tilt_y)
-                    {
-                    w.y += L.y;
-                    w.x += L.y * m_xy;
-                    }
-                }
-
-            if (m_periodic.z)
-                {
-                if (w.z >= m_hi.z)
-                    {
-                    w.z -= L.z;
-                    w.y -= L.z * m_yz;
-                    w.x -= L.z * m_xz;
-                    }
-                else if (w.z < m_lo.z)
-                    {
-                    w.z += L.z;
-                    w.y += L.z * m_yz;
-                    w.x += L.z * m_xz;
-                    }
-                }
-           }
+            w = m_wrap.wrap(w);
+            }
 
 
         //! Wrap a vector back into the box
@@ -414,7 +504,7 @@ class Box
             \param flags Vector of flags to force wrapping along certain directions
             \returns w;
 
-            \note \a w must not extend more than 1 image beyond the box
+            Uses the precomputed WrapContext, so \a w may be any number of images away from the box.
         */
         //Is this even sane? I assume since we previously had image free version
         // that I can just use our new getImage to pass through and make as few as possible
@@ -429,6 +519,12 @@ class Box
             return tempcopy;
             }
 
+        //! Replace each vector of an array by its minimum image
+        void wrap(vec3<float> *vecs, unsigned int Np) const;
+
+        //! Replace each vector of an array by its minimum image and update its image
+        void wrap(vec3<float> *vecs, vec3<int> *images, unsigned int Np) const;
+
         float3 wrap(const float3& w, const char3 flags = make_char3(0,0,0)) const
             {
                vec3<float> tempcopy;
@@ -506,6 +602,15 @@ class Box
                 newp += getLatticeVector(2) * float(image.z);
             return newp;
             }
+
+        //! Unwrap each position of an array to its "real" location
+        void unwrap(vec3<float> *vecs, const vec3<int> *images, unsigned int Np) const;
+
+        //! Replace each vector of an array by its box relative coordinates
+        void makeFraction(vec3<float> *vecs, unsigned int Np) const;
+
+        //! Replace each vector of an array of fractional coordinates by its real coordinates
+        void makeCoordinates(vec3<float> *vecs, unsigned int Np) const;
         //! Get the shortest distance between opposite boundary planes of the box
         /*! The distance between two planes of the lattice is 2 Pi/|b_i|, where
          *   b_1 is the reciprocal lattice vector of the Bravais lattice normal to
@@ -569,10 +674,11 @@ class Box
         //     }
 
 
-        // uchar3 getPeriodic() const
-        //     {
-        //     return m_periodic;
-        //     }
+        //! Get the periodic flags
+        uchar3 getPeriodic() const
+            {
+            return m_periodic;
+            }
 
         //! Set the periodic flags
         /*! \param periodic Flags to set
@@ -582,6 +688,13 @@ class Box
         void setPeriodic(uchar3 periodic)
             {
             m_periodic = periodic;
+            updateWrapContext();
+            }
+
+        //! Get the quantities precomputed for the minimum image wrap
+        const WrapContext& getWrapContext() const
+            {
+            return m_wrap;
             }
 
     private:
@@ -594,6 +707,24 @@ class Box
         float m_yz;       //!< yz tilt factor
         uchar3 m_periodic;//!< 0/1 in each direction to tell if the box is periodic in that direction
         bool m_2d;        //!< Specify whether box is 2D.
+        WrapContext m_wrap; //!< Precomputed quantities for wrap()
+
+        //! Recompute the wrap context after the box or its periodic flags changed
+        void updateWrapContext()
+            {
+            m_wrap.L = vec3<float>(m_periodic.x ? m_L.x : 0.0f, m_periodic.y ? m_L.y : 0.0f,
+                                   (m_periodic.z && !m_2d) ? m_L.z : 0.0f);
+            m_wrap.Linv = vec3<float>(m_periodic.x ? m_Linv.x : 0.0f, m_periodic.y ? m_Linv.y : 0.0f,
+                                      (m_periodic.z && !m_2d) ? m_Linv.z : 0.0f);
+            m_wrap.xy = m_xy;
+            m_wrap.yz = m_yz;
+            m_wrap.tilt_xz = m_xz - m_xy*m_yz;
+            m_wrap.Ly_xy = m_L.y * m_xy;
+            m_wrap.Lz_xz = m_L.z * m_xz;
+            m_wrap.Lz_yz = m_L.z * m_yz;
+            m_wrap.tilted = (m_xy != 0.0f) || (m_xz != 0.0f) || (m_yz != 0.0f);
+            m_wrap.is2D = m_2d;
+            }
     };
 
 }; };
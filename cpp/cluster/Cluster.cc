@@ -2,12 +2,16 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "Cluster.h"
+#include "Annotation.h"
 
+#include <tbb/tbb.h>
+
+#include <cstring>
 #include <stdexcept>
 #include <vector>
-#include <map>
 
 using namespace std;
+using namespace tbb;
 
 /*! \file Cluster.cc
     \brief Routines for clustering points
@@ -71,8 +75,201 @@ uint32_t DisjointSet::find(const uint32_t c)
     return r;
     }
 
+/*! \param n Number of initial sets
+*/
+ConcurrentDisjointSet::ConcurrentDisjointSet(uint32_t n)
+    : s(n)
+    {
+    for (uint32_t i = 0; i < n; i++)
+        s[i].store(i, memory_order_relaxed);
+    }
+
+/*! The sets containing \a a and \a b are merged. Safe to call from several threads at once.
+*/
+void ConcurrentDisjointSet::unite(uint32_t a, uint32_t b)
+    {
+    assert(a < s.size() && b < s.size()); // sanity check
+
+    while (true)
+        {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+
+        // link the larger root below the smaller one, unless another thread linked it first
+        if (a < b)
+            std::swap(a, b);
+        uint32_t expected = a;
+        if (s[a].compare_exchange_strong(expected, b))
+            return;
+        }
+    }
+
+/*! \returns the set label that contains the element \c c
+*/
+uint32_t ConcurrentDisjointSet::find(uint32_t c)
+    {
+    while (true)
+        {
+        uint32_t parent = s[c].load(memory_order_relaxed);
+        if (parent == c)
+            return c;
+
+        // path halving: point c to its grandparent; losing the race to another thread is harmless
+        uint32_t grandparent = s[parent].load(memory_order_relaxed);
+        if (grandparent != parent)
+            s[c].compare_exchange_weak(parent, grandparent, memory_order_relaxed);
+        c = grandparent;
+        }
+    }
+
+//! \internal
+//! Parallel scan numbering the roots of a disjoint set in the order of their index
+class CountRoots
+    {
+    private:
+        uint32_t m_sum;
+        const uint32_t *m_roots;
+        uint32_t *m_set_index;
+    public:
+        CountRoots(const uint32_t *roots, uint32_t *set_index)
+            : m_sum(0), m_roots(roots), m_set_index(set_index)
+            {
+            }
+        uint32_t get_sum() const
+            {
+            return m_sum;
+            }
+        template<typename Tag>
+        void operator()(const blocked_range<uint32_t>& r, Tag)
+            {
+            uint32_t temp = m_sum;
+            for (uint32_t i = r.begin(); i < r.end(); i++)
+                {
+                if (m_roots[i] == i)
+                    {
+                    if (Tag::is_final_scan())
+                        m_set_index[i] = temp;
+                    temp++;
+                    }
+                }
+            m_sum = temp;
+            }
+        CountRoots(CountRoots& b, split)
+            : m_sum(0), m_roots(b.m_roots), m_set_index(b.m_set_index)
+            {
+            }
+        void reverse_join(CountRoots& a)
+            {
+            m_sum = a.m_sum + m_sum;
+            }
+        void assign(CountRoots& b)
+            {
+            m_sum = b.m_sum;
+            }
+    };
+
+/*! \param labels Set number of each element, from 0 to the number of sets - 1
+
+    The roots are numbered by a prefix sum over the elements that are their own root, and every element then takes
+    the number of its root.
+*/
+uint32_t ConcurrentDisjointSet::relabel(uint32_t *labels)
+    {
+    const uint32_t n = s.size();
+    parallel_for(blocked_range<uint32_t>(0, n),
+        [=] (const blocked_range<uint32_t>& r)
+        {
+        for (uint32_t i = r.begin(); i != r.end(); i++)
+            labels[i] = find(i);
+        });
+
+    std::vector<uint32_t> set_index(n);
+    uint32_t *l_set_index = n ? &set_index[0] : NULL;
+    CountRoots count(labels, l_set_index);
+    parallel_scan(blocked_range<uint32_t>(0, n), count);
+
+    parallel_for(blocked_range<uint32_t>(0, n),
+        [=] (const blocked_range<uint32_t>& r)
+        {
+        for (uint32_t i = r.begin(); i != r.end(); i++)
+            labels[i] = l_set_index[labels[i]];
+        });
+    return count.get_sum();
+    }
+
+/*! \param n Number of initial sets
+*/
+ImageDisjointSet::ImageDisjointSet(uint32_t n)
+    : s(n), image(n, vec3<int>(0, 0, 0))
+    {
+    for (uint32_t i = 0; i < n; i++)
+        s[i] = i;
+    }
+
+/*! The sets containing \a a and \a b are merged, placing the set of \a b so that its image is that of \a a plus
+    \a image_ab.
+*/
+vec3<int> ImageDisjointSet::unite(uint32_t a, uint32_t b, const vec3<int>& image_ab)
+    {
+    assert(a < s.size() && b < s.size()); // sanity check
+
+    vec3<int> image_a, image_b;
+    uint32_t root_a = find(a, image_a);
+    uint32_t root_b = find(b, image_b);
+    // image of root_b minus image of root_a
+    vec3<int> image_roots = image_a + image_ab - image_b;
+    if (root_a == root_b)
+        return image_roots;
+
+    // link the larger root below the smaller one
+    if (root_a < root_b)
+        {
+        s[root_b] = root_a;
+        image[root_b] = image_roots;
+        }
+    else
+        {
+        s[root_a] = root_b;
+        image[root_a] = -image_roots;
+        }
+    return vec3<int>(0, 0, 0);
+    }
+
+/*! \param c Element to look up
+    \param image_c Set to the image of \a c minus that of the root of its set
+    \returns the set label that contains the element \c c
+*/
+uint32_t ImageDisjointSet::find(uint32_t c, vec3<int>& image_c)
+    {
+    // follow up to the root of the tree, summing the images
+    uint32_t r = c;
+    image_c = vec3<int>(0, 0, 0);
+    while (s[r] != r)
+        {
+        image_c += image[r];
+        r = s[r];
+        }
+
+    // path compression: each element on the path takes its image relative to the root
+    uint32_t i = c;
+    vec3<int> image_i = image_c;
+    while (i != r)
+        {
+        uint32_t j = s[i];
+        vec3<int> image_ij = image[i];
+        s[i] = r;
+        image[i] = image_i;
+        image_i -= image_ij;
+        i = j;
+        }
+    return r;
+    }
+
 Cluster::Cluster(const box::Box& box, float rcut)
-    : m_box(box), m_rcut(rcut), m_lc(box, rcut), m_num_particles(0)
+    : m_box(box), m_rcut(rcut), m_lc(box, rcut), m_num_particles(0), m_num_clusters(0), m_track_images(false),
+      m_num_cluster_keys(0)
     {
     if (m_rcut < 0.0f)
         throw invalid_argument("rcut must be positive");
@@ -81,85 +278,242 @@ Cluster::Cluster(const box::Box& box, float rcut)
 // void Cluster::computeClusters(const float3 *points,
 //                               unsigned int Np)
 void Cluster::computeClusters(const vec3<float> *points,
-                              unsigned int Np)
+                              unsigned int Np,
+                              const locality::NeighborList *nlist,
+                              bool track_images)
     {
+    util::ScopedRange annotation("freud::Cluster::computeClusters");
     assert(points);
     assert(Np > 0);
 
-    // reallocate the cluster_idx array if the size doesn't match the last one
-    if (Np != m_num_particles)
-        m_cluster_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+    resizeClusterIdx(Np);
+    m_track_images = track_images;
+    if (nlist != NULL)
+        nlist->validate(m_num_particles, m_num_particles);
+    if (track_images)
+        {
+        computeClustersImages(points, nlist);
+        return;
+        }
 
-    m_num_particles = Np;
     float rmaxsq = m_rcut * m_rcut;
-    DisjointSet dj(m_num_particles);
-
-    // bin the particles
-    m_lc.computeCellList(m_box, points, m_num_particles);
+    ConcurrentDisjointSet dj(m_num_particles);
+    ConcurrentDisjointSet *l_dj = &dj;
 
-    // for each point
-    for (unsigned int i = 0; i < m_num_particles; i++)
+    if (nlist != NULL)
         {
-        // get the cell the point is in
-        vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
+        const unsigned int *index_j = nlist->getIndexJ().get();
+        const float *distances = nlist->getDistances().get();
+        const float rcut = m_rcut;
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        // merge every bond within the cutoff
+        parallel_for(blocked_range<size_t>(0, m_num_particles),
+            [=] (const blocked_range<size_t>& r)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            for (size_t i = r.begin(); i != r.end(); i++)
                 {
-                if (i != j)
+                size_t last_bond = nlist->getLastBondWithin(i, rcut);
+                for (size_t bond = nlist->getFirstBond(i); bond < last_bond; bond++)
                     {
-                    // compute r between the two particles
-                    vec3<float> delta = p - points[j];
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    delta = m_box.wrap(delta);
-
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
-                    if (rsq < rmaxsq)
-                        {
-                        // merge the two sets using the disjoint set
-                        uint32_t a = dj.find(i);
-                        uint32_t b = dj.find(j);
-                        if (a != b)
-                            dj.merge(a,b);
-                        }
+                    if (distances[bond] < rcut)
+                        l_dj->unite(i, index_j[bond]);
                     }
                 }
-            }
+            });
+        }
+    else
+        {
+        // bin the particles
+        m_lc.computeCellList(m_box, points, m_num_particles, true);
+
+        // merging is symmetric, so each unordered pair only needs to be visited once; distinct cells own
+        // distinct pairs and the disjoint set takes concurrent merges
+        const locality::LinkCell *lc = &m_lc;
+        parallel_for(blocked_range<unsigned int>(0, m_lc.getNumCells()),
+            [=] (const blocked_range<unsigned int>& r)
+            {
+            for (unsigned int cell = r.begin(); cell != r.end(); cell++)
+                {
+                lc->forEachHalfPair(cell, points, rmaxsq,
+                    [l_dj] (unsigned int i, unsigned int j, const vec3<float>& delta, float rsq)
+                    {
+                    l_dj->unite(i, j);
+                    });
+                }
+            });
         }
 
-    // done looping over points. All clusters are now determined. Renumber them from zero to num_clusters-1.
-    map<uint32_t, uint32_t> label_map;
+    // All clusters are now determined. Renumber them from zero to num_clusters-1, in the order of their
+    // first particle.
+    m_num_clusters = dj.relabel(m_cluster_idx.get());
+    }
+
+//! \internal
+//! Reallocate the cluster_idx array if the size doesn't match the last one
+void Cluster::resizeClusterIdx(unsigned int Np)
+    {
+    if (Np != m_num_particles || !m_cluster_idx)
+        m_cluster_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+    m_num_particles = Np;
+    }
 
-    // go over every point
-    uint32_t cur_set = 0;
-    for (uint32_t i = 0; i < m_num_particles; i++)
+void Cluster::computeClustersFromBonds(unsigned int Np,
+                                       const unsigned int *bond_i,
+                                       const unsigned int *bond_j,
+                                       size_t n_bonds)
+    {
+    util::ScopedRange annotation("freud::Cluster::computeClustersFromBonds");
+    // check the bonds first, as unite() does not
+    bool valid = parallel_reduce(blocked_range<size_t>(0, n_bonds), true,
+        [=] (const blocked_range<size_t>& r, bool valid)
+        {
+        for (size_t b = r.begin(); b != r.end() && valid; b++)
+            valid = bond_i[b] < Np && bond_j[b] < Np;
+        return valid;
+        },
+        [] (bool a, bool b) { return a && b; });
+    if (!valid)
+        throw invalid_argument("The bonds must be between points of index smaller than the number of points");
+
+    resizeClusterIdx(Np);
+    m_track_images = false;
+    ConcurrentDisjointSet dj(Np);
+    ConcurrentDisjointSet *l_dj = &dj;
+    parallel_for(blocked_range<size_t>(0, n_bonds),
+        [=] (const blocked_range<size_t>& r)
         {
-        uint32_t s = dj.find(i);
+        for (size_t b = r.begin(); b != r.end(); b++)
+            l_dj->unite(bond_i[b], bond_j[b]);
+        });
+    m_num_clusters = dj.relabel(m_cluster_idx.get());
+    }
+
+void Cluster::computeClustersFromNeighborList(unsigned int Np, const locality::NeighborList *nlist)
+    {
+    if (nlist == NULL)
+        throw invalid_argument("computeClustersFromNeighborList needs a neighbor list");
+    nlist->validate(Np, Np);
+    computeClustersFromBonds(Np, nlist->getIndexI().get(), nlist->getIndexJ().get(), nlist->getNumBonds());
+    }
 
-        // insert it into the mapping if we haven't seen this one yet
-        if (label_map.count(s) == 0)
+void Cluster::beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                         const vec3<float> *points, unsigned int n_p)
+    {
+    if (ref_points != points || n_ref != n_p)
+        throw invalid_argument("Cluster needs the reference points of a FrameAnalysis to be its points");
+    resizeClusterIdx(n_p);
+    m_box = box;
+    m_track_images = false;
+    m_frame_sets.reset(new ConcurrentDisjointSet(n_p));
+    }
+
+void Cluster::processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors)
+    {
+    const float rmaxsq = m_rcut*m_rcut;
+    for (unsigned int k = 0; k < neighbors.num; k++)
+        if (neighbors.rsq[k] < rmaxsq)
+            m_frame_sets->unite(i, neighbors.j[k]);
+    }
+
+void Cluster::endFrame()
+    {
+    m_num_clusters = m_frame_sets->relabel(m_cluster_idx.get());
+    m_frame_sets.reset();
+    }
+
+//! \internal
+//! Add a winding to the independent windings of a cluster, and return whether it was independent of them
+static bool addWinding(vec3<int> *basis, unsigned int& dim, const vec3<int>& w)
+    {
+    bool independent;
+    if (dim == 0)
+        independent = (w.x != 0 || w.y != 0 || w.z != 0);
+    else if (dim == 1)
+        {
+        vec3<int> c = cross(basis[0], w);
+        independent = (c.x != 0 || c.y != 0 || c.z != 0);
+        }
+    else if (dim == 2)
+        independent = (dot(cross(basis[0], basis[1]), w) != 0);
+    else
+        independent = false;
+
+    if (independent)
+        basis[dim++] = w;
+    return independent;
+    }
+
+/*! The bonds are the same as in the parallel merge of computeClusters, merged one after the other into an
+    ImageDisjointSet. The image of the second particle of a bond relative to the first is minus the number of
+    lattice vectors between their separation and its minimum image.
+*/
+void Cluster::computeClustersImages(const vec3<float> *points, const locality::NeighborList *nlist)
+    {
+    const box::WrapContext& wrap_ctx = m_box.getWrapContext();
+    ImageDisjointSet dj(m_num_particles);
+    // loops closed through the periodic boundaries, as (particle, winding)
+    std::vector< std::pair<uint32_t, vec3<int> > > windings;
+    auto merge = [&] (unsigned int i, unsigned int j)
+        {
+        vec3<float> n = wrap_ctx.findImage(points[j] - points[i]);
+        vec3<int> winding = dj.unite(i, j, vec3<int>(-int(n.x), -int(n.y), -int(n.z)));
+        if (winding.x != 0 || winding.y != 0 || winding.z != 0)
+            windings.push_back(std::make_pair(uint32_t(i), winding));
+        };
+
+    if (nlist != NULL)
+        {
+        const unsigned int *index_j = nlist->getIndexJ().get();
+        const float *distances = nlist->getDistances().get();
+        for (unsigned int i = 0; i < m_num_particles; i++)
             {
-            label_map[s] = cur_set;
-            cur_set++;
+            size_t last_bond = nlist->getLastBondWithin(i, m_rcut);
+            for (size_t bond = nlist->getFirstBond(i); bond < last_bond; bond++)
+                {
+                if (distances[bond] < m_rcut)
+                    merge(i, index_j[bond]);
+                }
             }
+        }
+    else
+        {
+        m_lc.computeCellList(m_box, points, m_num_particles, true);
+        for (unsigned int cell = 0; cell < m_lc.getNumCells(); cell++)
+            {
+            m_lc.forEachHalfPair(cell, points, m_rcut * m_rcut,
+                [&merge] (unsigned int i, unsigned int j, const vec3<float>& delta, float rsq)
+                {
+                merge(i, j);
+                });
+            }
+        }
 
-        // label this point in cluster_idx
-        m_cluster_idx.get()[i] = label_map[s];
+    // the roots are the first particle of each cluster, numbered in order as in computeClusters
+    m_cluster_images = std::shared_ptr< vec3<int> >(new vec3<int>[m_num_particles], std::default_delete< vec3<int>[]>());
+    unsigned int *cluster_idx = m_cluster_idx.get();
+    vec3<int> *images = m_cluster_images.get();
+    m_num_clusters = 0;
+    for (unsigned int i = 0; i < m_num_particles; i++)
+        {
+        uint32_t root = dj.find(i, images[i]);
+        cluster_idx[i] = (root == i) ? m_num_clusters++ : cluster_idx[root];
         }
 
-    // cur_set is now the number of clusters
-    m_num_clusters = cur_set;
+    // the independent windings of each cluster
+    m_cluster_percolation_dim = std::shared_ptr<unsigned int>(new unsigned int[m_num_clusters], std::default_delete<unsigned int[]>());
+    m_cluster_percolation_axes = std::shared_ptr<unsigned int>(new unsigned int[m_num_clusters], std::default_delete<unsigned int[]>());
+    unsigned int *dim = m_cluster_percolation_dim.get();
+    unsigned int *axes = m_cluster_percolation_axes.get();
+    memset((void*)dim, 0, sizeof(unsigned int)*m_num_clusters);
+    memset((void*)axes, 0, sizeof(unsigned int)*m_num_clusters);
+    std::vector< vec3<int> > basis(3*m_num_clusters);
+    for (size_t k = 0; k < windings.size(); k++)
+        {
+        unsigned int c = cluster_idx[windings[k].first];
+        const vec3<int>& w = windings[k].second;
+        if (addWinding(&basis[3*c], dim[c], w))
+            axes[c] |= (w.x != 0 ? 1 : 0) | (w.y != 0 ? 2 : 0) | (w.z != 0 ? 4 : 0);
+        }
     }
 
 // void Cluster::computeClustersPy(boost::python::numeric::array points)
@@ -179,30 +533,87 @@ void Cluster::computeClusters(const vec3<float> *points,
 //     computeClusters(points_raw, Np);
 //     }
 
-/*! \param keys Array of keys (1 per particle)
+//! \internal
+//! Parallel scan over the sorted (cluster, key) pairs writing the unique keys and the first key of each cluster
+class ClusterKeyScan
+    {
+    private:
+        unsigned int m_sum;
+        const uint64_t *m_pairs;
+        unsigned int *m_keys;
+        unsigned int *m_key_start;
+    public:
+        ClusterKeyScan(const uint64_t *pairs, unsigned int *keys, unsigned int *key_start)
+            : m_sum(0), m_pairs(pairs), m_keys(keys), m_key_start(key_start)
+            {
+            }
+        unsigned int get_sum() const
+            {
+            return m_sum;
+            }
+        template<typename Tag>
+        void operator()(const blocked_range<size_t>& r, Tag)
+            {
+            unsigned int temp = m_sum;
+            for (size_t i = r.begin(); i < r.end(); i++)
+                {
+                uint64_t pair = m_pairs[i];
+                if (i > 0 && m_pairs[i-1] == pair)
+                    continue;
+                if (Tag::is_final_scan())
+                    {
+                    // the first pair of a cluster starts its keys
+                    uint32_t cluster = pair >> 32;
+                    if (i == 0 || (m_pairs[i-1] >> 32) != cluster)
+                        m_key_start[cluster] = temp;
+                    m_keys[temp] = (uint32_t) pair;
+                    }
+                temp++;
+                }
+            m_sum = temp;
+            }
+        ClusterKeyScan(ClusterKeyScan& b, split)
+            : m_sum(0), m_pairs(b.m_pairs), m_keys(b.m_keys), m_key_start(b.m_key_start)
+            {
+            }
+        void reverse_join(ClusterKeyScan& a)
+            {
+            m_sum = a.m_sum + m_sum;
+            }
+        void assign(ClusterKeyScan& b)
+            {
+            m_sum = b.m_sum;
+            }
+    };
 
-    Loops overa all particles and adds them to a list of sets. Each set contains all the keys that are part of that
-    cluster.
+/*! \param keys Array of keys (1 per particle)
 
-    Get the computed list with getClusterKeys().
+    Finds the keys present in each cluster. The (cluster, key) pair of every particle is sorted in parallel, and
+    a parallel scan over the sorted pairs keeps one copy of each, so the keys of cluster c end up sorted and unique
+    in getClusterKeys()[getClusterKeyOffsets()[c]] to getClusterKeys()[getClusterKeyOffsets()[c+1] - 1].
 
     \note The length of keys is assumed to be the same length as the particles in the last call to computeClusters().
 */
 void Cluster::computeClusterMembership(const unsigned int *keys)
     {
-    // clear the membership
-    m_cluster_keys.resize(m_num_clusters);
-
-    for (unsigned int i = 0; i < m_num_clusters; i++)
-        m_cluster_keys[i].clear();
-
-    // add members to the sets
-    for (unsigned int i = 0; i < m_num_particles; i++)
+    std::vector<uint64_t> pairs(m_num_particles);
+    uint64_t *l_pairs = m_num_particles ? &pairs[0] : NULL;
+    const unsigned int *cluster_idx = m_cluster_idx.get();
+    parallel_for(blocked_range<size_t>(0, m_num_particles),
+        [=] (const blocked_range<size_t>& r)
         {
-        unsigned int key = keys[i];
-        unsigned int cluster = m_cluster_idx.get()[i];
-        m_cluster_keys[cluster].insert(key);
-        }
+        for (size_t i = r.begin(); i != r.end(); i++)
+            l_pairs[i] = (uint64_t(cluster_idx[i]) << 32) | keys[i];
+        });
+    parallel_sort(pairs.begin(), pairs.end());
+
+    // at most one key per particle
+    m_cluster_keys = std::shared_ptr<unsigned int>(new unsigned int[m_num_particles], std::default_delete<unsigned int[]>());
+    m_cluster_key_offsets = std::shared_ptr<unsigned int>(new unsigned int[m_num_clusters + 1], std::default_delete<unsigned int[]>());
+    ClusterKeyScan scan(l_pairs, m_cluster_keys.get(), m_cluster_key_offsets.get());
+    parallel_scan(blocked_range<size_t>(0, m_num_particles), scan);
+    m_num_cluster_keys = scan.get_sum();
+    m_cluster_key_offsets.get()[m_num_clusters] = m_num_cluster_keys;
     }
 
 // /*! \param keys numpy array of uints, one for each particle.
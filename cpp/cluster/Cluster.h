@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <set>
@@ -10,6 +11,7 @@
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "FrameAnalysis.h"
 #include "box.h"
 
 #ifndef _CLUSTER_H__
@@ -39,6 +41,57 @@ class DisjointSet
         uint32_t find(const uint32_t c);
     };
 
+//! A disjoint set that many threads can merge into at once
+/*! Each element points to an element of smaller or equal index, and merging always links the root of larger index
+    below the root of smaller index with a compare and swap, so no locks are needed and the forest never has cycles.
+    find halves the paths it follows as it goes.
+
+    The root of each set is its smallest element once all merges are done, independently of the order in which
+    they happened, so relabel numbers the sets the same way whatever the number of threads.
+*/
+class ConcurrentDisjointSet
+    {
+    private:
+        std::vector< std::atomic<uint32_t> > s;  //!< The parent of each element
+    public:
+        //! Constructor
+        ConcurrentDisjointSet(uint32_t n = 0);
+        //! Merge the sets containing \a a and \a b, which need not be set labels
+        void unite(uint32_t a, uint32_t b);
+        //! Find the set with a given element
+        uint32_t find(uint32_t c);
+        //! Number the sets from 0 in the order of their smallest element, and return the number of sets
+        /*! \note Must not run concurrently with unite
+        */
+        uint32_t relabel(uint32_t *labels);
+    };
+
+//! A disjoint set that also tracks the periodic image of each element relative to the root of its set
+/*! Each element stores the image of itself minus the image of its parent, so the image of an element relative to
+    its root is the sum of these along the path to the root. Merging along a bond between two elements of the same
+    set whose images disagree closes a loop through the periodic boundaries, and the difference of the images is
+    the winding of that loop.
+
+    As in ConcurrentDisjointSet, the root of larger index is linked below the root of smaller index, so the root of
+    each set is its smallest element.
+*/
+class ImageDisjointSet
+    {
+    private:
+        std::vector<uint32_t> s;                //!< The parent of each element
+        std::vector< vec3<int> > image;         //!< The image of each element minus that of its parent
+    public:
+        //! Constructor
+        ImageDisjointSet(uint32_t n = 0);
+        //! Merge the sets containing \a a and \a b, the image of \a b being that of \a a plus \a image_ab
+        /*! \returns the winding of the loop closed by the bond, zero when \a a and \a b were in different sets or
+                     in the same image
+        */
+        vec3<int> unite(uint32_t a, uint32_t b, const vec3<int>& image_ab);
+        //! Find the set with a given element, and the image of the element relative to the root of the set
+        uint32_t find(uint32_t c, vec3<int>& image_c);
+    };
+
 //! Find clusters in a set of points
 /*! Given a set of coordinates and a cutoff, Cluster will determine all of the clusters of points that are made
     up of points that are closer than the cutoff. Clusters are labelled from 0 to the number of clusters-1
@@ -53,11 +106,19 @@ class DisjointSet
     (i.e. the polymer id), the computeClusterMembership function will process cluster_idx with the key values in mind
     and provide a list of keys that are present in each cluster.
 
+    <b>Periodic images:</b><br>
+    When computeClusters is asked to track images, it also finds the periodic image of every particle relative to
+    the first particle of its cluster, so that a cluster is made whole by unwrapping its particles with these images,
+    and whether each cluster percolates: a cluster that wraps around the periodic box has a loop of bonds whose
+    images do not add up to zero. The windings of these loops give the number of independent directions along
+    which the cluster spans the box (1 for a rod, 2 for a sheet, 3 for a network spanning the whole box), and the
+    box axes they involve. The images are found during the merge itself, which is then serial.
+
     <b>2D:</b><br>
     Cluster properly handles 2D boxes. As with everything else in freud, 2D points must be passed in as
     3 component vectors x,y,0. Failing to set 0 in the third component will lead to undefined behavior.
 */
-class Cluster
+class Cluster : public locality::PairAnalysis
     {
     public:
         //! Constructor
@@ -72,12 +133,51 @@ class Cluster
         //! Compute the point clusters
         // void computeClusters(const float3 *points,
         //                      unsigned int Np);
+        /*! If \a nlist is given, its bonds are used instead of building the internal cell list. If \a track_images
+            is true, the images and percolation of the clusters are found as well.
+        */
         void computeClusters(const vec3<float> *points,
-                             unsigned int Np);
+                             unsigned int Np,
+                             const locality::NeighborList *nlist=NULL,
+                             bool track_images=false);
 
         // //! Python wrapper for computePointClusters
         // void computeClustersPy(boost::python::numeric::array points);
 
+        //! Compute the clusters of the graph of Np points whose edges are the bonds (bond_i[b], bond_j[b])
+        /*! The bonds are merged in parallel into a ConcurrentDisjointSet whatever criterion chose them, such as
+            the bonds of a BondingXYZ, the faces of a Voronoi tessellation or a threshold on a dot product of Ql. The
+            direction of a bond does not matter and bonds may repeat. The images of the particles are not tracked.
+        */
+        void computeClustersFromBonds(unsigned int Np,
+                                      const unsigned int *bond_i,
+                                      const unsigned int *bond_j,
+                                      size_t n_bonds);
+
+        //! Compute the clusters of the graph of Np points whose edges are all the bonds of a neighbor list
+        /*! Unlike computeClusters() with a neighbor list, the bonds are merged whatever their distances, so that
+            a list filtered by any criterion (see locality::NeighborList) gives its connected components.
+        */
+        void computeClustersFromNeighborList(unsigned int Np, const locality::NeighborList *nlist);
+
+        //! Get the cutoff of the neighbors of a FrameAnalysis
+        virtual float getPairRMax() const
+            {
+            return m_rcut;
+            }
+
+        //! Prepare computeClusters() from the neighbors of a FrameAnalysis, whose reference points must be the points
+        /*! The images of the particles are not tracked.
+        */
+        virtual void beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                                const vec3<float> *points, unsigned int n_p);
+
+        //! Merge particle i with its neighbors within the cutoff found by a FrameAnalysis
+        virtual void processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors);
+
+        //! Number the clusters once a FrameAnalysis has processed every particle
+        virtual void endFrame();
+
         //! Compute clusters with key membership
         void computeClusterMembership(const unsigned int *keys);
 
@@ -112,12 +212,56 @@ class Cluster
         // //!  Returns the cluster keys last determined by computeClusterKeys, in python format
         // boost::python::object getClusterKeysPy();
 
-        //! Returns the cluster keys last determined by computeClusterKeys
-        const std::vector< std::set<unsigned int> >& getClusterKeys()
+        //! Return whether the last call to computeClusters() tracked the images of the particles
+        bool getTrackImages()
+            {
+            return m_track_images;
+            }
+
+        //! Get the image of each particle relative to the first particle of its cluster
+        std::shared_ptr< vec3<int> > getClusterImages()
+            {
+            return m_cluster_images;
+            }
+
+        //! Get the number of independent directions along which each cluster wraps around the box, 0 to 3
+        std::shared_ptr<unsigned int> getClusterPercolationDim()
+            {
+            return m_cluster_percolation_dim;
+            }
+
+        //! Get the box axes along which each cluster wraps around the box, as bits 1 (x), 2 (y) and 4 (z)
+        std::shared_ptr<unsigned int> getClusterPercolationAxes()
+            {
+            return m_cluster_percolation_axes;
+            }
+
+        //! Get the keys of all the clusters last determined by computeClusterMembership, sorted within each cluster
+        std::shared_ptr<unsigned int> getClusterKeys()
             {
             return m_cluster_keys;
             }
+
+        //! Get the index of the first key of each cluster in getClusterKeys(), followed by getNumClusterKeys()
+        std::shared_ptr<unsigned int> getClusterKeyOffsets()
+            {
+            return m_cluster_key_offsets;
+            }
+
+        //! Get the total number of keys of all the clusters
+        unsigned int getNumClusterKeys()
+            {
+            return m_num_cluster_keys;
+            }
     private:
+        //! \internal
+        //! Size the cluster index array for Np particles
+        void resizeClusterIdx(unsigned int Np);
+
+        //! \internal
+        //! Merge the bonds serially, tracking the images of the particles
+        void computeClustersImages(const vec3<float> *points, const locality::NeighborList *nlist);
+
         box::Box m_box;                    //!< Simulation box the particles belong in
         float m_rcut;                             //!< Maximum r at which points will be counted in the same cluster
         locality::LinkCell m_lc;                  //!< LinkCell to bin particles for the computation
@@ -125,7 +269,14 @@ class Cluster
         unsigned int m_num_clusters;              //!< Number of clusters found inthe last call to compute()
 
         std::shared_ptr<unsigned int> m_cluster_idx;         //!< Cluster index determined for each particle
-        std::vector< std::set<unsigned int> > m_cluster_keys;    //!< List of keys in each cluster
+        bool m_track_images;                                 //!< True if the last compute tracked the images
+        std::shared_ptr< vec3<int> > m_cluster_images;       //!< Image of each particle relative to its cluster
+        std::shared_ptr<unsigned int> m_cluster_percolation_dim;     //!< Number of wrapping directions of each cluster
+        std::shared_ptr<unsigned int> m_cluster_percolation_axes;    //!< Box axes each cluster wraps along
+        std::shared_ptr<unsigned int> m_cluster_keys;        //!< Unique keys of each cluster, one cluster after the other
+        std::shared_ptr<unsigned int> m_cluster_key_offsets; //!< First key of each cluster in m_cluster_keys
+        unsigned int m_num_cluster_keys;                     //!< Number of keys in m_cluster_keys
+        std::unique_ptr<ConcurrentDisjointSet> m_frame_sets; //!< Clusters merged by a FrameAnalysis
 
     };
 
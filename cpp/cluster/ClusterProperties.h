@@ -1,10 +1,12 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <tbb/tbb.h>
 #include <memory>
 
 #include "HOOMDMath.h"
 #include "box.h"
+#include "ClusterSegments.h"
 
 #ifndef _CLUSTER_PROPERTIES_H__
 #define _CLUSTER_PROPERTIES_H__
@@ -20,6 +22,7 @@ namespace freud { namespace cluster {
     the following properties for each cluster:
      - Center of mass
      - Gyration radius tensor
+     - Size, radius of gyration and asphericity
 
     m_cluster_com stores the computed center of mass for each cluster (properly handling periodic boundary conditions,
     of course). It is an array of float3's in c++. It is passed to python from getClusterCOMPy as an num_clusters x 3
@@ -28,6 +31,10 @@ namespace freud { namespace cluster {
     m_cluster_G stores a 3x3 G tensor for each cluster. Index cluster \a c, element \a j, \a i with the following:
     m_cluster_G[c*9 + j*3 + i]. The tensor is symmetric, so the choice of i and j are irrelevant. This is passed
     back to python as a num_clusters x 3 x 3 numpy array.
+
+    m_cluster_Rg stores the radius of gyration \f$ \sqrt{\mathrm{tr}\,G} \f$ and m_cluster_asphericity stores
+    \f$ \lambda_3 - (\lambda_1 + \lambda_2)/2 \f$ from the eigenvalues \f$ \lambda_1 \le \lambda_2 \le \lambda_3 \f$
+    of G, which is zero for clusters of cubic symmetry.
 */
 class ClusterProperties
     {
@@ -99,6 +106,18 @@ class ClusterProperties
             return m_cluster_size;
             }
 
+        //! Get a reference to the last computed radius of gyration of each cluster
+        std::shared_ptr<float> getClusterRg()
+            {
+            return m_cluster_Rg;
+            }
+
+        //! Get a reference to the last computed asphericity of each cluster
+        std::shared_ptr<float> getClusterAsphericity()
+            {
+            return m_cluster_asphericity;
+            }
+
         // //!  Returns the cluster sizes computed by the last call to computeProperties
         // boost::python::object getClusterSizePy()
         //     {
@@ -111,11 +130,14 @@ class ClusterProperties
 
     private:
         box::Box m_box;                       //!< Simulation box the particles belong in
+        ClusterSegments m_segments;           //!< Particles sorted by cluster
         unsigned int m_num_clusters;                 //!< Number of clusters found in the last call to computeProperties()
 
         std::shared_ptr< vec3<float> > m_cluster_com;   //!< Center of mass computed for each cluster (length: m_num_clusters)
         std::shared_ptr<float> m_cluster_G;      //!< Gyration tensor computed for each cluster (m_num_clusters x 3 x 3 array)
         std::shared_ptr<unsigned int> m_cluster_size;    //!< Size per cluster
+        std::shared_ptr<float> m_cluster_Rg;             //!< Radius of gyration per cluster
+        std::shared_ptr<float> m_cluster_asphericity;    //!< Asphericity per cluster
     };
 
 }; }; // end namespace freud::cluster
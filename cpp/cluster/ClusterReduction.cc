@@ -0,0 +1,170 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "ClusterReduction.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file ClusterReduction.cc
+    \brief Reductions of per particle values over the particles of each cluster
+*/
+
+namespace freud { namespace cluster {
+
+ClusterReduction::ClusterReduction()
+    : m_num_clusters(0), m_num_values(0)
+    {
+    }
+
+/*! Clusters are processed in parallel, and the particles of large clusters are reduced in parallel as well. The
+    sums, minima and maxima of a cluster are reduced in one pass; the covariances take a second pass over the
+    separations from the mean, which is more accurate than the difference of the second moment and the squared mean.
+*/
+void ClusterReduction::compute(const unsigned int *cluster_idx,
+                               unsigned int Np,
+                               const float *values,
+                               unsigned int num_values,
+                               unsigned int num_clusters,
+                               bool covariance)
+    {
+    assert(cluster_idx);
+    assert(values);
+    if (Np == 0)
+        throw invalid_argument("at least one particle is needed");
+    if (num_values == 0)
+        throw invalid_argument("at least one value per particle is needed");
+
+    m_segments.build(cluster_idx, Np, num_clusters);
+    m_num_clusters = m_segments.getNumClusters();
+    m_num_values = num_values;
+
+    const size_t n = size_t(m_num_clusters)*num_values;
+    m_cluster_size = std::shared_ptr<unsigned int>(new unsigned int[m_num_clusters], std::default_delete<unsigned int[]>());
+    m_sum = std::shared_ptr<float>(new float[n], std::default_delete<float[]>());
+    m_mean = std::shared_ptr<float>(new float[n], std::default_delete<float[]>());
+    m_min = std::shared_ptr<float>(new float[n], std::default_delete<float[]>());
+    m_max = std::shared_ptr<float>(new float[n], std::default_delete<float[]>());
+    if (covariance)
+        m_covariance = std::shared_ptr<float>(new float[n*num_values], std::default_delete<float[]>());
+    else
+        m_covariance.reset();
+
+    unsigned int *cluster_size = m_cluster_size.get();
+    float *sum_array = m_sum.get();
+    float *mean_array = m_mean.get();
+    float *min_array = m_min.get();
+    float *max_array = m_max.get();
+    float *covariance_array = m_covariance.get();
+    const ClusterSegments& segments = m_segments;
+    const float nan = numeric_limits<float>::quiet_NaN();
+    const double inf = numeric_limits<double>::infinity();
+
+    parallel_for(blocked_range<size_t>(0, m_num_clusters),
+        [=, &segments] (const blocked_range<size_t>& r)
+        {
+        // the sums, then the minima, then the maxima of the values
+        std::vector<double> identity(3*num_values);
+        for (unsigned int v = 0; v < num_values; v++)
+            {
+            identity[v] = 0.0;
+            identity[num_values + v] = inf;
+            identity[2*num_values + v] = -inf;
+            }
+        // the upper triangle of the sum of the outer products of the separations from the mean
+        const unsigned int num_pairs = num_values*(num_values + 1)/2;
+        std::vector<double> mean(num_values);
+
+        for (size_t c = r.begin(); c != r.end(); c++)
+            {
+            size_t begin = segments.begin(c);
+            size_t end = segments.end(c);
+            cluster_size[c] = end - begin;
+            const double s = double(end - begin);
+
+            std::vector<double> moments = ClusterSegments::reduce(begin, end, identity,
+                [=, &segments] (const blocked_range<size_t>& r, std::vector<double> m)
+                {
+                for (size_t k = r.begin(); k != r.end(); k++)
+                    {
+                    const float *value = values + size_t(segments.member(k))*num_values;
+                    for (unsigned int v = 0; v < num_values; v++)
+                        {
+                        m[v] += value[v];
+                        m[num_values + v] = std::min(m[num_values + v], double(value[v]));
+                        m[2*num_values + v] = std::max(m[2*num_values + v], double(value[v]));
+                        }
+                    }
+                return m;
+                },
+                [=] (const std::vector<double>& a, const std::vector<double>& b)
+                {
+                std::vector<double> m(a);
+                for (unsigned int v = 0; v < num_values; v++)
+                    {
+                    m[v] += b[v];
+                    m[num_values + v] = std::min(m[num_values + v], b[num_values + v]);
+                    m[2*num_values + v] = std::max(m[2*num_values + v], b[2*num_values + v]);
+                    }
+                return m;
+                });
+
+            const size_t offset = c*num_values;
+            for (unsigned int v = 0; v < num_values; v++)
+                {
+                mean[v] = moments[v]/s;
+                sum_array[offset + v] = float(moments[v]);
+                mean_array[offset + v] = (begin < end) ? float(mean[v]) : nan;
+                min_array[offset + v] = (begin < end) ? float(moments[num_values + v]) : nan;
+                max_array[offset + v] = (begin < end) ? float(moments[2*num_values + v]) : nan;
+                }
+
+            if (covariance_array == NULL)
+                continue;
+            float *cov = covariance_array + offset*num_values;
+            if (begin == end)
+                {
+                std::fill(cov, cov + num_values*num_values, nan);
+                continue;
+                }
+            std::vector<double> outer = ClusterSegments::reduce(begin, end, std::vector<double>(num_pairs, 0.0),
+                [=, &segments, &mean] (const blocked_range<size_t>& r, std::vector<double> o)
+                {
+                for (size_t k = r.begin(); k != r.end(); k++)
+                    {
+                    const float *value = values + size_t(segments.member(k))*num_values;
+                    unsigned int pair = 0;
+                    for (unsigned int a = 0; a < num_values; a++)
+                        {
+                        double da = value[a] - mean[a];
+                        for (unsigned int b = a; b < num_values; b++)
+                            o[pair++] += da*(value[b] - mean[b]);
+                        }
+                    }
+                return o;
+                },
+                [] (const std::vector<double>& a, const std::vector<double>& b)
+                {
+                std::vector<double> o(a);
+                for (unsigned int pair = 0; pair < o.size(); pair++)
+                    o[pair] += b[pair];
+                return o;
+                });
+            unsigned int pair = 0;
+            for (unsigned int a = 0; a < num_values; a++)
+                for (unsigned int b = a; b < num_values; b++)
+                    {
+                    cov[a*num_values + b] = cov[b*num_values + a] = float(outer[pair++]/s);
+                    }
+            }
+        });
+    }
+
+}; }; // end namespace freud::cluster
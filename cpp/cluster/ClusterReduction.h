@@ -0,0 +1,112 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+
+#include "ClusterSegments.h"
+
+#ifndef _CLUSTER_REDUCTION_H__
+#define _CLUSTER_REDUCTION_H__
+
+/*! \file ClusterReduction.h
+    \brief Reductions of per particle values over the particles of each cluster
+*/
+
+namespace freud { namespace cluster {
+
+//! Computes the sum, mean, minimum, maximum and covariance of per particle values over each cluster
+/*! Given \a cluster_idx (from Cluster, or some other source) and Np x num_values per particle values (an order
+    parameter, a position, ...), ClusterReduction reduces each column of the values over the particles of each
+    cluster, as a group by of the particle arrays on the cluster index would, in one parallel pass over the particles
+    sorted by ClusterSegments. The sums are accumulated in double precision.
+
+    The results are num_clusters x num_values arrays, and the covariances num_clusters x num_values x num_values; the
+    covariance is that of the population, normalized by the size of the cluster, and is only computed on request.
+    The mean, minimum, maximum and covariance of a cluster without particles are NaN.
+*/
+class ClusterReduction
+    {
+    public:
+        //! Constructor
+        ClusterReduction();
+
+        //! Reduce the values of the particles over each cluster
+        /*! \param cluster_idx Index of the cluster of each particle
+            \param Np Number of particles
+            \param values Np x num_values values of the particles
+            \param num_values Number of values of each particle
+            \param num_clusters Number of clusters, or 0 for the largest index in \a cluster_idx plus one
+            \param covariance true to compute the covariances of the values
+        */
+        void compute(const unsigned int *cluster_idx,
+                     unsigned int Np,
+                     const float *values,
+                     unsigned int num_values,
+                     unsigned int num_clusters=0,
+                     bool covariance=false);
+
+        //! Get the number of clusters of the last computation
+        unsigned int getNumClusters() const
+            {
+            return m_num_clusters;
+            }
+
+        //! Get the number of values of each particle of the last computation
+        unsigned int getNumValues() const
+            {
+            return m_num_values;
+            }
+
+        //! Get the number of particles of each cluster
+        std::shared_ptr<unsigned int> getClusterSize()
+            {
+            return m_cluster_size;
+            }
+
+        //! Get the sum of each value over each cluster
+        std::shared_ptr<float> getSum()
+            {
+            return m_sum;
+            }
+
+        //! Get the mean of each value over each cluster
+        std::shared_ptr<float> getMean()
+            {
+            return m_mean;
+            }
+
+        //! Get the minimum of each value over each cluster
+        std::shared_ptr<float> getMin()
+            {
+            return m_min;
+            }
+
+        //! Get the maximum of each value over each cluster
+        std::shared_ptr<float> getMax()
+            {
+            return m_max;
+            }
+
+        //! Get the covariance of the values over each cluster, or NULL if it was not computed
+        std::shared_ptr<float> getCovariance()
+            {
+            return m_covariance;
+            }
+
+    private:
+        ClusterSegments m_segments;             //!< Particles sorted by cluster
+        unsigned int m_num_clusters;            //!< Number of clusters of the last computation
+        unsigned int m_num_values;              //!< Number of values of each particle of the last computation
+
+        std::shared_ptr<unsigned int> m_cluster_size;   //!< Size of each cluster
+        std::shared_ptr<float> m_sum;                   //!< Sum of each value over each cluster
+        std::shared_ptr<float> m_mean;                  //!< Mean of each value over each cluster
+        std::shared_ptr<float> m_min;                   //!< Minimum of each value over each cluster
+        std::shared_ptr<float> m_max;                   //!< Maximum of each value over each cluster
+        std::shared_ptr<float> m_covariance;            //!< Covariance of the values over each cluster
+    };
+
+}; }; // end namespace freud::cluster
+
+#endif // _CLUSTER_REDUCTION_H__
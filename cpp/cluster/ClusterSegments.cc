@@ -0,0 +1,65 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "ClusterSegments.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file ClusterSegments.cc
+    \brief The particles of each cluster as contiguous segments, for per cluster reductions
+*/
+
+namespace freud { namespace cluster {
+
+void ClusterSegments::build(const unsigned int *cluster_idx, unsigned int Np, unsigned int num_clusters)
+    {
+    unsigned int max_cluster_id = parallel_reduce(blocked_range<size_t>(0, Np), 0u,
+        [=] (const blocked_range<size_t>& r, unsigned int max_id)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            max_id = max(max_id, cluster_idx[i]);
+        return max_id;
+        },
+        [] (unsigned int a, unsigned int b)
+        {
+        return max(a, b);
+        });
+    if (num_clusters == 0)
+        num_clusters = max_cluster_id+1;
+    else if (Np > 0 && max_cluster_id >= num_clusters)
+        throw invalid_argument("cluster_idx must be smaller than the number of clusters");
+    m_num_clusters = num_clusters;
+
+    // sort the particles by cluster, then by index
+    m_members.resize(Np);
+    uint64_t *l_members = m_members.data();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            l_members[i] = (uint64_t(cluster_idx[i]) << 32) | i;
+        });
+    parallel_sort(m_members.begin(), m_members.end());
+
+    // first member of each cluster; clusters without particles start where the next one does
+    m_cluster_start.assign(m_num_clusters+1, Np);
+    size_t *l_cluster_start = m_cluster_start.data();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t k = r.begin(); k != r.end(); k++)
+            {
+            uint32_t c = l_members[k] >> 32;
+            if (k == 0 || (l_members[k-1] >> 32) != c)
+                l_cluster_start[c] = k;
+            }
+        });
+    for (unsigned int c = m_num_clusters; c > 0; c--)
+        m_cluster_start[c-1] = min(m_cluster_start[c-1], m_cluster_start[c]);
+    }
+
+}; }; // end namespace freud::cluster
@@ -0,0 +1,87 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <stdint.h>
+#include <vector>
+
+#ifndef _CLUSTER_SEGMENTS_H__
+#define _CLUSTER_SEGMENTS_H__
+
+/*! \file ClusterSegments.h
+    \brief The particles of each cluster as contiguous segments, for per cluster reductions
+*/
+
+namespace freud { namespace cluster {
+
+//! Clusters with more particles than this are reduced in parallel, the others by one thread in particle order
+const size_t PARALLEL_CLUSTER_SIZE = 4096;
+
+//! The particles sorted by cluster, so that the members of each cluster are a contiguous segment
+/*! The particles are sorted by cluster first, keeping their order within each cluster. The segments are then reduced
+    independently of each other: reduce() reduces the particles of one cluster in particle order, in parallel only
+    when the cluster is large, so that clusters can be processed in parallel and one cluster spanning the system still
+    scales. ClusterProperties and ClusterReduction share it.
+*/
+class ClusterSegments
+    {
+    public:
+        //! Constructor
+        ClusterSegments() : m_num_clusters(0)
+            {
+            }
+
+        //! Sort the particles by cluster
+        /*! \param cluster_idx Index of the cluster of each particle
+            \param Np Number of particles
+            \param num_clusters Number of clusters, or 0 for the largest index in \a cluster_idx plus one
+        */
+        void build(const unsigned int *cluster_idx, unsigned int Np, unsigned int num_clusters=0);
+
+        //! Get the number of clusters
+        unsigned int getNumClusters() const
+            {
+            return m_num_clusters;
+            }
+
+        //! Get the position of the first member of cluster c in the sorted particles
+        size_t begin(unsigned int c) const
+            {
+            return m_cluster_start[c];
+            }
+
+        //! Get the position past the last member of cluster c in the sorted particles
+        size_t end(unsigned int c) const
+            {
+            return m_cluster_start[c+1];
+            }
+
+        //! Get the index of the particle at position k of the sorted particles
+        unsigned int member(size_t k) const
+            {
+            return uint32_t(m_members[k]);
+            }
+
+        //! Reduce the positions [begin, end) of the sorted particles, in parallel only when there are many
+        /*! \a func and \a join are those of tbb::parallel_reduce. Up to PARALLEL_CLUSTER_SIZE positions are summed
+            in order by one thread; above that the partial sums are joined in an order that depends on the scheduling,
+            so floating-point results may differ in the last bits from run to run.
+        */
+        template<typename T, typename Func, typename Join>
+        static T reduce(size_t begin, size_t end, const T& identity, Func func, Join join)
+            {
+            if (end - begin <= PARALLEL_CLUSTER_SIZE)
+                return func(tbb::blocked_range<size_t>(begin, end), identity);
+            return tbb::parallel_reduce(tbb::blocked_range<size_t>(begin, end, PARALLEL_CLUSTER_SIZE/4), identity,
+                                        func, join);
+            }
+
+    private:
+        unsigned int m_num_clusters;            //!< Number of clusters
+        std::vector<uint64_t> m_members;        //!< Cluster index in the high bits and particle index in the low bits
+        std::vector<size_t> m_cluster_start;    //!< Position of the first member of each cluster, then Np
+    };
+
+}; }; // end namespace freud::cluster
+
+#endif // _CLUSTER_SEGMENTS_H__
@@ -0,0 +1,276 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "ClusterTracker.h"
+#include "HistogramReduction.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file ClusterTracker.cc
+    \brief Routines for following clusters from frame to frame
+*/
+
+namespace freud { namespace cluster {
+
+const unsigned int ClusterTracker::untracked;
+
+ClusterTracker::ClusterTracker(unsigned int min_size)
+    : m_min_size(min_size), m_num_frames(0), m_next_id(0), m_prev_num_clusters(0), m_num_clusters(0),
+      m_num_overlaps(0), m_num_events(0)
+    {
+    }
+
+void ClusterTracker::reset()
+    {
+    m_num_frames = 0;
+    m_next_id = 0;
+    m_prev_idx.clear();
+    m_prev_size.clear();
+    m_prev_ids.clear();
+    m_prev_num_clusters = 0;
+    m_num_clusters = 0;
+    m_cluster_size.reset();
+    m_cluster_ids.reset();
+    m_num_overlaps = 0;
+    m_overlap_prev.reset();
+    m_overlap_next.reset();
+    m_overlap_count.reset();
+    m_num_events = 0;
+    m_events.reset();
+    }
+
+//! \internal
+/*! \brief Parallel scan body that reduces the sorted (previous, current) pairs of the particles to the overlaps
+
+    Each run of equal pairs becomes one overlap, written at its rank among the runs, with the length of the run
+    as its count.
+*/
+class OverlapScan
+    {
+    private:
+        unsigned int m_sum;
+        const uint64_t *m_pairs;
+        size_t m_num_pairs;
+        unsigned int *m_prev;
+        unsigned int *m_next;
+        unsigned int *m_count;
+    public:
+        OverlapScan(const uint64_t *pairs, size_t num_pairs, unsigned int *prev, unsigned int *next,
+                    unsigned int *count)
+            : m_sum(0), m_pairs(pairs), m_num_pairs(num_pairs), m_prev(prev), m_next(next), m_count(count)
+            {
+            }
+        unsigned int get_sum() const
+            {
+            return m_sum;
+            }
+        template<typename Tag>
+        void operator()(const blocked_range<size_t>& r, Tag)
+            {
+            unsigned int temp = m_sum;
+            for (size_t i = r.begin(); i < r.end(); i++)
+                {
+                uint64_t pair = m_pairs[i];
+                if (i > 0 && m_pairs[i-1] == pair)
+                    continue;
+                if (Tag::is_final_scan())
+                    {
+                    // the run of pair ends at the next different pair
+                    size_t end = i + 1;
+                    while (end < m_num_pairs && m_pairs[end] == pair)
+                        end++;
+                    m_prev[temp] = pair >> 32;
+                    m_next[temp] = (uint32_t) pair;
+                    m_count[temp] = end - i;
+                    }
+                temp++;
+                }
+            m_sum = temp;
+            }
+        OverlapScan(OverlapScan& b, split)
+            : m_sum(0), m_pairs(b.m_pairs), m_num_pairs(b.m_num_pairs), m_prev(b.m_prev), m_next(b.m_next),
+              m_count(b.m_count)
+            {
+            }
+        void reverse_join(OverlapScan& a)
+            {
+            m_sum = a.m_sum + m_sum;
+            }
+        void assign(OverlapScan& b)
+            {
+            m_sum = b.m_sum;
+            }
+    };
+
+/*! \param cluster_idx Index of the cluster of each particle in the new frame
+    \param Np Number of particles, the same in every frame
+
+    The sizes of the new clusters are histogrammed per thread, and the overlaps with the previous frame are found by
+    a parallel sort of the (previous, current) pairs of the particles; only the events and ids are found in a serial
+    pass, over the overlaps. An update thus costs O(Np log Np) in parallel plus the number of clusters of both frames,
+    never their product.
+*/
+void ClusterTracker::update(const unsigned int *cluster_idx, unsigned int Np)
+    {
+    if (m_num_frames > 0 && Np != m_prev_idx.size())
+        throw invalid_argument("The number of particles must be the same in every frame");
+
+    unsigned int max_cluster_id = parallel_reduce(blocked_range<size_t>(0, Np), 0u,
+        [=] (const blocked_range<size_t>& r, unsigned int max_id)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            max_id = max(max_id, cluster_idx[i]);
+        return max_id;
+        },
+        [] (unsigned int a, unsigned int b)
+        {
+        return max(a, b);
+        });
+    const unsigned int num_clusters = Np ? max_cluster_id + 1 : 0;
+
+    // count the particles of each cluster in per-thread histograms
+    m_cluster_size = std::shared_ptr<unsigned int>(new unsigned int[num_clusters], std::default_delete<unsigned int[]>());
+    tbb::enumerable_thread_specific<unsigned int *> local_sizes;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=, &local_sizes] (const blocked_range<size_t>& r)
+        {
+        bool exists;
+        local_sizes.local(exists);
+        if (!exists)
+            local_sizes.local() = util::allocateLocalHistogram<unsigned int>(num_clusters);
+        unsigned int *sizes = local_sizes.local();
+        for (size_t i = r.begin(); i != r.end(); i++)
+            sizes[cluster_idx[i]]++;
+        });
+    util::reduceLocalHistograms(local_sizes, m_cluster_size.get(), num_clusters);
+    util::freeLocalHistograms(local_sizes);
+    const unsigned int *size = m_cluster_size.get();
+    const unsigned int min_size = m_min_size;
+
+    // the non-zero overlaps, from the sorted (previous, current) pairs of the particles
+    std::vector<uint64_t> pairs;
+    if (m_num_frames > 0)
+        {
+        pairs.resize(Np);
+        uint64_t *l_pairs = Np ? &pairs[0] : NULL;
+        const unsigned int *prev_idx = Np ? &m_prev_idx[0] : NULL;
+        parallel_for(blocked_range<size_t>(0, Np),
+            [=] (const blocked_range<size_t>& r)
+            {
+            for (size_t i = r.begin(); i != r.end(); i++)
+                l_pairs[i] = (uint64_t(prev_idx[i]) << 32) | cluster_idx[i];
+            });
+        parallel_sort(pairs.begin(), pairs.end());
+        }
+
+    // at most one overlap per particle
+    m_overlap_prev = std::shared_ptr<unsigned int>(new unsigned int[pairs.size()], std::default_delete<unsigned int[]>());
+    m_overlap_next = std::shared_ptr<unsigned int>(new unsigned int[pairs.size()], std::default_delete<unsigned int[]>());
+    m_overlap_count = std::shared_ptr<unsigned int>(new unsigned int[pairs.size()], std::default_delete<unsigned int[]>());
+    OverlapScan scan(pairs.size() ? &pairs[0] : NULL, pairs.size(), m_overlap_prev.get(), m_overlap_next.get(),
+                     m_overlap_count.get());
+    parallel_scan(blocked_range<size_t>(0, pairs.size()), scan);
+    m_num_overlaps = scan.get_sum();
+    const unsigned int *overlap_prev = m_overlap_prev.get();
+    const unsigned int *overlap_next = m_overlap_next.get();
+    const unsigned int *overlap_count = m_overlap_count.get();
+
+    // degrees and best matches between the tracked clusters
+    const unsigned int prev_num_clusters = m_prev_num_clusters;
+    std::vector<unsigned int> out_degree(prev_num_clusters, 0);
+    std::vector<unsigned int> best_next(prev_num_clusters, untracked);
+    std::vector<unsigned int> best_next_count(prev_num_clusters, 0);
+    std::vector<unsigned int> in_degree(num_clusters, 0);
+    std::vector<unsigned int> best_prev(num_clusters, untracked);
+    std::vector<unsigned int> best_prev_count(num_clusters, 0);
+    for (unsigned int k = 0; k < m_num_overlaps; k++)
+        {
+        unsigned int c = overlap_prev[k];
+        unsigned int d = overlap_next[k];
+        unsigned int count = overlap_count[k];
+        if (m_prev_size[c] < min_size || size[d] < min_size)
+            continue;
+        out_degree[c]++;
+        in_degree[d]++;
+        // the overlaps come by increasing c, and by increasing d for each c, so strict comparisons keep the
+        // smallest index on ties
+        if (count > best_next_count[c])
+            {
+            best_next_count[c] = count;
+            best_next[c] = d;
+            }
+        if (count > best_prev_count[d])
+            {
+            best_prev_count[d] = count;
+            best_prev[d] = c;
+            }
+        }
+
+    // splits and merges in the order of the overlaps
+    std::vector<unsigned int> events;
+    for (unsigned int k = 0; k < m_num_overlaps; k++)
+        {
+        unsigned int c = overlap_prev[k];
+        unsigned int d = overlap_next[k];
+        if (m_prev_size[c] < min_size || size[d] < min_size)
+            continue;
+        if (out_degree[c] >= 2)
+            {
+            events.push_back(SPLIT);
+            events.push_back(c);
+            events.push_back(d);
+            }
+        if (in_degree[d] >= 2)
+            {
+            events.push_back(MERGE);
+            events.push_back(c);
+            events.push_back(d);
+            }
+        }
+
+    // then the deaths and the births
+    for (unsigned int c = 0; c < prev_num_clusters; c++)
+        if (m_prev_size[c] >= min_size && out_degree[c] == 0)
+            {
+            events.push_back(DEATH);
+            events.push_back(c);
+            events.push_back(untracked);
+            }
+    for (unsigned int d = 0; d < num_clusters; d++)
+        if (size[d] >= min_size && in_degree[d] == 0)
+            {
+            events.push_back(BIRTH);
+            events.push_back(untracked);
+            events.push_back(d);
+            }
+    m_num_events = events.size()/3;
+    m_events = std::shared_ptr<unsigned int>(new unsigned int[events.size()], std::default_delete<unsigned int[]>());
+    std::copy(events.begin(), events.end(), m_events.get());
+
+    // a cluster keeps the id of its previous cluster when each is the other's best match
+    m_cluster_ids = std::shared_ptr<unsigned int>(new unsigned int[num_clusters], std::default_delete<unsigned int[]>());
+    unsigned int *ids = m_cluster_ids.get();
+    for (unsigned int d = 0; d < num_clusters; d++)
+        {
+        unsigned int c = best_prev[d];
+        if (size[d] < min_size)
+            ids[d] = untracked;
+        else if (c != untracked && best_next[c] == d)
+            ids[d] = m_prev_ids[c];
+        else
+            ids[d] = m_next_id++;
+        }
+
+    // the current frame becomes the previous one
+    m_prev_idx.assign(cluster_idx, cluster_idx + Np);
+    m_prev_size.assign(size, size + num_clusters);
+    m_prev_ids.assign(ids, ids + num_clusters);
+    m_prev_num_clusters = m_num_clusters = num_clusters;
+    m_num_frames++;
+    }
+
+}; }; // end namespace freud::cluster
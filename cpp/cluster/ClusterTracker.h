@@ -0,0 +1,152 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#ifndef _CLUSTER_TRACKER_H__
+#define _CLUSTER_TRACKER_H__
+
+/*! \file ClusterTracker.h
+    \brief Routines for following clusters from frame to frame
+*/
+
+namespace freud { namespace cluster {
+
+//! Follow the clusters of successive frames
+/*! Given the \a cluster_idx of each frame (from Cluster, or some other source) for the same particles in the same
+    order, ClusterTracker finds which clusters of the current frame come from which clusters of the previous one.
+
+    The overlap of previous cluster \a c and current cluster \a d is the number of particles in both. Only the
+    non-zero overlaps are kept, so the overlap matrix has at most one entry per particle. It is found by sorting the
+    (c, d) pairs of the particles in parallel and counting the runs of equal pairs, and is stored sorted by c, then
+    by d.
+
+    Clusters with fewer than \a min_size particles are not tracked: they are treated as free particles, which makes
+    births and deaths possible. Between the tracked clusters of two frames, the events are:
+     - Split: a previous cluster overlaps two or more current clusters, one event per current cluster
+     - Merge: a current cluster overlaps two or more previous clusters, one event per previous cluster
+     - Death: a previous cluster overlaps no current cluster
+     - Birth: a current cluster overlaps no previous cluster (every tracked cluster of the first frame is born)
+
+    Each tracked cluster carries an id that persists over frames. A current cluster keeps the id of a previous
+    cluster when each is the other's largest overlap (ties going to the smaller cluster index); every other tracked
+    cluster gets a new id, and untracked clusters get \c untracked.
+*/
+class ClusterTracker
+    {
+    public:
+        //! Event types, the first column of getEvents()
+        enum EventType
+            {
+            BIRTH = 0,
+            DEATH = 1,
+            MERGE = 2,
+            SPLIT = 3
+            };
+
+        //! Id of the clusters that are not tracked, and cluster index of the missing side of births and deaths
+        static const unsigned int untracked = 0xffffffff;
+
+        //! Constructor
+        /*! \param min_size Smallest number of particles of a tracked cluster
+        */
+        ClusterTracker(unsigned int min_size=1);
+
+        //! Forget the previous frames
+        void reset();
+
+        //! Compare the clusters of a new frame with those of the previous one
+        void update(const unsigned int *cluster_idx, unsigned int Np);
+
+        //! Get the number of frames given to update since the last reset
+        unsigned int getNumFrames()
+            {
+            return m_num_frames;
+            }
+
+        //! Get the number of clusters of the current frame
+        unsigned int getNumClusters()
+            {
+            return m_num_clusters;
+            }
+
+        //! Get the number of particles of each cluster of the current frame
+        std::shared_ptr<unsigned int> getClusterSize()
+            {
+            return m_cluster_size;
+            }
+
+        //! Get the persistent id of each cluster of the current frame
+        std::shared_ptr<unsigned int> getClusterIds()
+            {
+            return m_cluster_ids;
+            }
+
+        //! Get the number of non-zero entries of the overlap matrix
+        unsigned int getNumOverlaps()
+            {
+            return m_num_overlaps;
+            }
+
+        //! Get the previous cluster of each overlap
+        std::shared_ptr<unsigned int> getOverlapPrev()
+            {
+            return m_overlap_prev;
+            }
+
+        //! Get the current cluster of each overlap
+        std::shared_ptr<unsigned int> getOverlapNext()
+            {
+            return m_overlap_next;
+            }
+
+        //! Get the number of particles of each overlap
+        std::shared_ptr<unsigned int> getOverlapCount()
+            {
+            return m_overlap_count;
+            }
+
+        //! Get the number of events between the previous and the current frame
+        unsigned int getNumEvents()
+            {
+            return m_num_events;
+            }
+
+        //! Get the events as (type, previous cluster, current cluster) triplets
+        /*! Splits and merges come first, in the order of the overlaps, then deaths by previous cluster, then births
+            by current cluster.
+        */
+        std::shared_ptr<unsigned int> getEvents()
+            {
+            return m_events;
+            }
+
+    private:
+        unsigned int m_min_size;                        //!< Smallest number of particles of a tracked cluster
+        unsigned int m_num_frames;                      //!< Number of frames since the last reset
+        unsigned int m_next_id;                         //!< Next unused persistent id
+
+        std::vector<unsigned int> m_prev_idx;           //!< Cluster of each particle in the previous frame
+        std::vector<unsigned int> m_prev_size;          //!< Number of particles of each previous cluster
+        std::vector<unsigned int> m_prev_ids;           //!< Persistent id of each previous cluster
+        unsigned int m_prev_num_clusters;               //!< Number of clusters of the previous frame
+
+        unsigned int m_num_clusters;                    //!< Number of clusters of the current frame
+        std::shared_ptr<unsigned int> m_cluster_size;   //!< Number of particles of each current cluster
+        std::shared_ptr<unsigned int> m_cluster_ids;    //!< Persistent id of each current cluster
+
+        unsigned int m_num_overlaps;                    //!< Number of non-zero overlaps
+        std::shared_ptr<unsigned int> m_overlap_prev;   //!< Previous cluster of each overlap
+        std::shared_ptr<unsigned int> m_overlap_next;   //!< Current cluster of each overlap
+        std::shared_ptr<unsigned int> m_overlap_count;  //!< Number of particles of each overlap
+
+        unsigned int m_num_events;                      //!< Number of events
+        std::shared_ptr<unsigned int> m_events;         //!< (type, previous cluster, current cluster) of each event
+    };
+
+}; }; // end namespace freud::cluster
+
+#endif // _CLUSTER_TRACKER_H__
@@ -0,0 +1,244 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "AngularRDF.h"
+#include "PeriodicImages.h"
+#include "DistanceKernel.h"
+#include "Annotation.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file AngularRDF.cc
+    \brief Routines for computing the radial density function resolved by the angle to the orientation of the
+           reference points
+*/
+
+namespace freud { namespace density {
+
+AngularRDF::AngularRDF(float rmax, float dr, unsigned int nbins_cos, const vec3<float>& axis)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_nbins_cos(nbins_cos), m_n_ref(0), m_Np(0), m_frame_counter(0),
+      m_reduce(true)
+    {
+    if (dr <= 0.0f)
+        throw invalid_argument("dr must be positive");
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    if (dr > rmax)
+        throw invalid_argument("rmax must be greater than dr");
+    if (nbins_cos < 1)
+        throw invalid_argument("must be at least 1 cos theta bin");
+    float axis_norm = sqrtf(dot(axis, axis));
+    if (axis_norm == 0.0f)
+        throw invalid_argument("axis must not be zero");
+    m_axis = axis / axis_norm;
+
+    m_dr_inv = 1.0f / m_dr;
+    m_nbins_r = int(floorf(m_rmax / m_dr));
+    assert(m_nbins_r > 0);
+    unsigned int n_bins = m_nbins_r*m_nbins_cos;
+    m_rdf_array = std::shared_ptr<float>(new float[n_bins], std::default_delete<float[]>());
+    memset((void*)m_rdf_array.get(), 0, sizeof(float)*n_bins);
+    m_bin_counts = std::shared_ptr<util::BinCount>(new util::BinCount[n_bins],
+                                                   std::default_delete<util::BinCount[]>());
+    memset((void*)m_bin_counts.get(), 0, sizeof(util::BinCount)*n_bins);
+
+    // precompute the bin center positions
+    m_r_array = std::shared_ptr<float>(new float[m_nbins_r], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins_r; i++)
+        {
+        float r = float(i) * m_dr;
+        float nextr = float(i+1) * m_dr;
+        m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
+        }
+    m_cos_array = std::shared_ptr<float>(new float[m_nbins_cos], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins_cos; i++)
+        m_cos_array.get()[i] = -1.0f + (2.0f*i + 1.0f) / m_nbins_cos;
+
+    m_lc = new locality::LinkCell(m_box, m_rmax);
+    }
+
+AngularRDF::~AngularRDF()
+    {
+    util::freeLocalHistograms(m_local_bin_counts);
+    delete m_lc;
+    }
+
+//! \internal
+//! reduce the thread local histograms into the bin counts and normalize them into g(r, cos theta)
+void AngularRDF::reduceAngularRDF()
+    {
+    util::ScopedRange annotation("freud::AngularRDF::reduce");
+    unsigned int n_bins = m_nbins_r*m_nbins_cos;
+    util::reduceLocalHistograms(m_local_bin_counts, m_bin_counts.get(), n_bins);
+    if (m_frame_counter == 0 || m_n_ref == 0)
+        {
+        memset((void*)m_rdf_array.get(), 0, sizeof(float)*n_bins);
+        return;
+        }
+    float ndens = float(m_Np) / m_box.getVolume();
+    float norm = 1.0f / (float(m_n_ref) * ndens * m_frame_counter);
+    bool is2D = m_box.is2D();
+
+    parallel_for(blocked_range<size_t>(0, m_nbins_r),
+      [=] (const blocked_range<size_t>& r)
+      {
+      for (size_t i = r.begin(); i != r.end(); i++)
+          {
+          double r_lo = double(i) * m_dr;
+          double r_hi = double(i+1) * m_dr;
+          for (unsigned int k = 0; k < m_nbins_cos; k++)
+              {
+              double cos_lo = -1.0 + 2.0*k / m_nbins_cos;
+              double cos_hi = -1.0 + 2.0*(k+1) / m_nbins_cos;
+              // the volume of the bin: theta is uniform in 2D and cos theta in 3D
+              double volume;
+              if (is2D)
+                  volume = (r_hi*r_hi - r_lo*r_lo) * (acos(cos_lo) - acos(cos_hi));
+              else
+                  volume = 2.0 * M_PI / 3.0 * (r_hi*r_hi*r_hi - r_lo*r_lo*r_lo) * (cos_hi - cos_lo);
+              size_t bin = i*m_nbins_cos + k;
+              m_rdf_array.get()[bin] = float(m_bin_counts.get()[bin] / volume) * norm;
+              }
+          }
+      });
+    }
+
+//! Get a reference to g(r, cos theta)
+std::shared_ptr<float> AngularRDF::getRDF()
+    {
+    if (m_reduce == true)
+        {
+        reduceAngularRDF();
+        }
+    m_reduce = false;
+    return m_rdf_array;
+    }
+
+//! Get a reference to the histogram of the pairs
+std::shared_ptr<util::BinCount> AngularRDF::getBinCounts()
+    {
+    if (m_reduce == true)
+        {
+        reduceAngularRDF();
+        }
+    m_reduce = false;
+    return m_bin_counts;
+    }
+
+//! \internal
+/*! \brief Function to reset the histograms if needed e.g. calculating a new set of frames
+*/
+void AngularRDF::resetAngularRDF()
+    {
+    for (tbb::enumerable_thread_specific<util::BinCount *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(util::BinCount)*m_nbins_r*m_nbins_cos);
+        }
+    // reset the frame counter
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Function to accumulate the pairs of a frame to the histograms in memory
+
+    The loops are those of RDF, over the reference points with the full stencil of the cell list, over the bonds of
+    a neighbor list or over the periodic images, with the axis of each reference point rotated once.
+*/
+void AngularRDF::accumulate(box::Box& box,
+                            const vec3<float> *ref_points,
+                            const quat<float> *ref_orientations,
+                            unsigned int Nref,
+                            const vec3<float> *points,
+                            unsigned int Np,
+                            const locality::NeighborList *nlist)
+    {
+    util::ScopedRange annotation("freud::AngularRDF::accumulate");
+    m_box = box;
+    m_n_ref = Nref;
+    m_Np = Np;
+    const float rmaxsq = m_rmax*m_rmax;
+    const unsigned int n_bins = m_nbins_r*m_nbins_cos;
+    const vec3<float> body_axis = m_axis;
+
+    const locality::LinkCell *lc = NULL;
+    const unsigned int *order = NULL;
+    std::shared_ptr<locality::PeriodicImages> images;
+    if (nlist != NULL)
+        nlist->validate(Nref, Np);
+    else if (locality::PeriodicImages::needed(m_box, m_rmax))
+        images = std::shared_ptr<locality::PeriodicImages>(new locality::PeriodicImages(m_box, m_rmax));
+    else
+        {
+        m_lc->computeCellList(m_box, points, Np, true);
+        lc = m_lc;
+        // consecutive reference points of a task share their neighbor cells
+        if (Nref >= locality::CELL_ORDER_MIN_POINTS)
+            order = m_work_partition.orderByCell(*lc, ref_points, Nref, points, Np);
+        }
+
+    parallel_for(blocked_range<size_t>(0, Nref),
+      [=, &box] (const blocked_range<size_t>& r)
+      {
+      util::ScopedRange task_annotation("freud::AngularRDF::accumulate::points");
+      bool exists;
+      m_local_bin_counts.local(exists);
+      if (! exists)
+          {
+          m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(n_bins);
+          }
+      util::BinCount *local_bins = m_local_bin_counts.local();
+      locality::DistanceKernel kernel(box);
+
+      for (size_t pos = r.begin(); pos != r.end(); pos++)
+          {
+          size_t i = (order != NULL) ? order[pos] : pos;
+          vec3<float> ref = ref_points[i];
+          vec3<float> axis = rotate(ref_orientations[i], body_axis);
+
+          if (nlist != NULL)
+              {
+              const unsigned int *index_j = nlist->getIndexJ().get();
+              const vec3<float> *vectors = nlist->getVectors().get();
+              size_t last_bond = nlist->getLastBondWithin(i, m_rmax);
+              for (size_t bond = nlist->getFirstBond(i); bond < last_bond; bond++)
+                  {
+                  vec3<float> delta = (vectors != NULL) ? vectors[bond] : box.wrap(points[index_j[bond]] - ref);
+                  binPair(local_bins, axis, delta, dot(delta, delta));
+                  }
+              }
+          else if (images)
+              {
+              images->forEachNeighbor(ref, points, Np,
+                  [&] (unsigned int j, const vec3<float>& delta, float rsq, bool zero_image)
+                  {
+                  binPair(local_bins, axis, delta, rsq);
+                  });
+              }
+          else
+              {
+              const vec3<float> *sorted_points = lc->getSortedPoints().get();
+              const unsigned int *cell_start = lc->getCellStart().get();
+              const locality::CellNeighbors& neigh_cells = lc->getCellNeighbors(lc->getCell(ref));
+              for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                  {
+                  unsigned int begin = cell_start[neigh_cells[neigh_idx]];
+                  kernel.forEachWithin(ref, sorted_points + begin, cell_start[neigh_cells[neigh_idx]+1] - begin,
+                      rmaxsq,
+                      [&] (unsigned int k, const vec3<float>& delta, float rsq)
+                      {
+                      binPair(local_bins, axis, delta, rsq);
+                      });
+                  }
+              }
+          }
+      });
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::density
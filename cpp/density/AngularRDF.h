@@ -0,0 +1,151 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <ostream>
+
+// work around nasty issue where python #defines isalpha, toupper, etc....
+#undef __APPLE__
+#include <Python.h>
+#define __APPLE__
+
+#include <memory>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "LinkCell.h"
+#include "NeighborList.h"
+#include "WorkPartition.h"
+#include "box.h"
+#include "BinCount.h"
+#include "HistogramReduction.h"
+
+#ifndef _ANGULAR_RDF_H__
+#define _ANGULAR_RDF_H__
+
+/*! \file AngularRDF.h
+    \brief Routines for computing the radial density function resolved by the angle to the orientation of the
+           reference points
+*/
+
+namespace freud { namespace density {
+
+//! Computes g(r, cos theta), theta being the angle between a bond and the axis of its oriented reference point
+/*! The axis of a reference point is a fixed axis of its body frame rotated by its orientation. The pairs are found
+    as by RDF and binned directly into nbins_r x nbins_cos histograms, instead of the 3D histograms of PMFTR12 or
+    BondOrder that would then be marginalized. The pair of a point with itself has no angle and is not counted.
+
+    g(r, cos theta) is normalized by the volume of its bin, so that it is 1 for uncorrelated points: the bins are
+    uniform in cos theta in 3D, but in 2D, where theta is uniform instead, the bins near cos theta = +-1 are larger.
+*/
+class AngularRDF
+    {
+    public:
+        //! Constructor
+        /*! \param rmax largest distance of the pairs
+            \param dr width of the r bins
+            \param nbins_cos number of bins of cos theta between -1 and 1
+            \param axis axis of the reference points in their body frame
+        */
+        AngularRDF(float rmax, float dr, unsigned int nbins_cos, const vec3<float>& axis);
+
+        //! Destructor
+        ~AngularRDF();
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the histograms to all zeros
+        void resetAngularRDF();
+
+        //! Accumulate the pairs of a frame
+        /*! If \a nlist is given, its bonds are binned instead of building the internal cell list. When rmax exceeds
+            half of the box along a periodic direction, the pairs are found among the explicit periodic images of the
+            points, as by RDF.
+        */
+        void accumulate(box::Box& box,
+                        const vec3<float> *ref_points,
+                        const quat<float> *ref_orientations,
+                        unsigned int n_ref,
+                        const vec3<float> *points,
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
+
+        //! \internal
+        //! reduce the thread local histograms into the bin counts and normalize them into g(r, cos theta)
+        void reduceAngularRDF();
+
+        //! Get a reference to g(r, cos theta), nbins_r x nbins_cos
+        std::shared_ptr<float> getRDF();
+
+        //! Get a reference to the histogram of the pairs, nbins_r x nbins_cos
+        std::shared_ptr<util::BinCount> getBinCounts();
+
+        //! Get a reference to the r array
+        std::shared_ptr<float> getR()
+            {
+            return m_r_array;
+            }
+
+        //! Get a reference to the array of the centers of the cos theta bins
+        std::shared_ptr<float> getCosTheta()
+            {
+            return m_cos_array;
+            }
+
+        //! Get the number of r bins
+        unsigned int getNBinsR() const
+            {
+            return m_nbins_r;
+            }
+
+        //! Get the number of cos theta bins
+        unsigned int getNBinsCosTheta() const
+            {
+            return m_nbins_cos;
+            }
+
+    private:
+        //! Bin one pair of a reference point of the given axis into a thread specific histogram
+        void binPair(util::BinCount *local_bins, const vec3<float>& axis, const vec3<float>& delta, float rsq) const
+            {
+            if (rsq == 0.0f || rsq >= m_rmax*m_rmax)
+                return;
+            float r = sqrtf(rsq);
+            unsigned int bin_r = (unsigned int)(r * m_dr_inv);
+            if (bin_r >= m_nbins_r)
+                return;
+            float cos_theta = dot(axis, delta) / r;
+            int bin_cos = int((cos_theta + 1.0f) * 0.5f * m_nbins_cos);
+            bin_cos = std::min(std::max(bin_cos, 0), int(m_nbins_cos) - 1);
+            ++local_bins[bin_r*m_nbins_cos + bin_cos];
+            }
+
+        box::Box m_box;                     //!< Simulation box the particles belong in
+        float m_rmax;                       //!< Maximum r of the pairs
+        float m_dr;                         //!< Width of the r bins
+        float m_dr_inv;                     //!< Inverse of the width of the r bins
+        unsigned int m_nbins_r;             //!< Number of r bins
+        unsigned int m_nbins_cos;           //!< Number of cos theta bins
+        vec3<float> m_axis;                 //!< Axis of the reference points in their body frame
+        locality::LinkCell* m_lc;           //!< LinkCell to bin particles for the computation
+        locality::WorkPartition m_work_partition;   //!< Cell order of the reference points
+        unsigned int m_n_ref;               //!< number of reference particles of the last frame
+        unsigned int m_Np;                  //!< number of particles of the last frame
+        unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
+
+        std::shared_ptr<float> m_rdf_array;           //!< g(r, cos theta) computed
+        std::shared_ptr<util::BinCount> m_bin_counts; //!< bin counts that go into computing g(r, cos theta)
+        std::shared_ptr<float> m_r_array;             //!< array of r values that g is computed at
+        std::shared_ptr<float> m_cos_array;           //!< array of cos theta values that g is computed at
+        tbb::enumerable_thread_specific<util::BinCount *> m_local_bin_counts;
+    };
+
+}; }; // end namespace freud::density
+
+#endif // _ANGULAR_RDF_H__
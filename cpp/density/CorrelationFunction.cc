@@ -3,14 +3,13 @@
 
 #include "ScopedGILRelease.h"
 
+#include <algorithm>
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
 
 #include <tbb/tbb.h>
 #include <complex>
 #include "CorrelationFunction.h"
+#include "Checkpoint.h"
 
 using namespace std;
 // using namespace freud;
@@ -24,7 +23,7 @@ namespace freud { namespace density {
 
 template<typename T>
 CorrelationFunction<T>::CorrelationFunction(float rmax, float dr)
-    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0), m_reduce(true)
     {
     if (dr <= 0.0f)
         throw invalid_argument("dr must be positive");
@@ -33,7 +32,26 @@ CorrelationFunction<T>::CorrelationFunction(float rmax, float dr)
     if (dr > rmax)
         throw invalid_argument("rmax must be greater than dr");
 
-    m_nbins = int(floorf(m_rmax / m_dr));
+    initialize(util::BinEdges(m_rmax, m_dr));
+    }
+
+/*! \param bin_edges Strictly increasing edges of the r bins, bin i covering [bin_edges[i], bin_edges[i+1])
+*/
+template<typename T>
+CorrelationFunction<T>::CorrelationFunction(const std::vector<float>& bin_edges)
+    : m_box(box::Box()), m_dr(0.0f), m_frame_counter(0), m_reduce(true)
+    {
+    initialize(util::BinEdges(bin_edges));
+    m_rmax = m_bin_edges.getMax();
+    }
+
+//! \internal
+//! Allocate the histograms and precompute the r values of the bins
+template<typename T>
+void CorrelationFunction<T>::initialize(const util::BinEdges& bin_edges)
+    {
+    m_bin_edges = bin_edges;
+    m_nbins = m_bin_edges.getNBins();
     assert(m_nbins > 0);
     m_rdf_array = std::shared_ptr<T>(new T[m_nbins], std::default_delete<T[]>());
     // Less efficient: initialize each bin sequentially using default ctor
@@ -43,27 +61,22 @@ CorrelationFunction<T>::CorrelationFunction(float rmax, float dr)
     memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
 
     // precompute the bin center positions
+    const std::vector<float>& edges = m_bin_edges.getEdges();
     m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
     for (unsigned int i = 0; i < m_nbins; i++)
         {
-        float r = float(i) * m_dr;
-        float nextr = float(i+1) * m_dr;
+        float r = edges[i];
+        float nextr = edges[i+1];
         m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
         }
-    m_lc = new locality::LinkCell(m_box, m_rmax);
+    m_lc = new locality::LinkCell(m_box, m_bin_edges.getMax());
     }
 
 template<typename T>
 CorrelationFunction<T>::~CorrelationFunction()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
-    for (typename tbb::enumerable_thread_specific<T *>::iterator i = m_local_rdf_array.begin(); i != m_local_rdf_array.end(); ++i)
-        {
-        delete[] (*i);
-        }
+    util::freeLocalHistograms(m_local_bin_counts);
+    util::freeLocalHistograms(m_local_components);
     delete m_lc;
     }
 
@@ -72,23 +85,31 @@ CorrelationFunction<T>::~CorrelationFunction()
 template<typename T>
 void CorrelationFunction<T>::reduceCorrelationFunction()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
-    for(size_t i(0); i < m_nbins; ++i)
-        m_rdf_array.get()[i] = T();
+    const unsigned int num_components = CorrelationValue<T>::num_components;
+    util::reduceLocalHistograms(m_local_bin_counts, m_bin_counts.get(), m_nbins);
+    std::vector<double> components(num_components*m_nbins);
+    util::reduceLocalHistograms(m_local_components, &components[0], num_components*m_nbins);
+
     // now compute the rdf
-    parallel_for(tbb::blocked_range<size_t>(0,m_nbins), CombineOCF<T>(m_nbins,
-                                                              m_bin_counts.get(),
-                                                              m_local_bin_counts,
-                                                              m_rdf_array.get(),
-                                                              m_local_rdf_array,
-                                                              (float)m_n_ref));
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        m_rdf_array.get()[i] = CorrelationValue<T>::combine(&components[i], m_nbins);
+        if (m_bin_counts.get()[i])
+            {
+            m_rdf_array.get()[i] /= m_bin_counts.get()[i];
+            }
+        }
     }
 
 //! Get a reference to the RDF array
 template<typename T>
 std::shared_ptr<T> CorrelationFunction<T>::getRDF()
     {
-    reduceCorrelationFunction();
+    if (m_reduce == true)
+        {
+        reduceCorrelationFunction();
+        }
+    m_reduce = false;
     return m_rdf_array;
     }
 
@@ -103,12 +124,88 @@ void CorrelationFunction<T>::resetCorrelationFunction()
         {
         memset((void*)(*i), 0, sizeof(unsigned int)*m_nbins);
         }
-    for (typename tbb::enumerable_thread_specific<T *>::iterator i = m_local_rdf_array.begin(); i != m_local_rdf_array.end(); ++i)
+    for (tbb::enumerable_thread_specific<double *>::iterator i = m_local_components.begin(); i != m_local_components.end(); ++i)
         {
-        memset((void*)(*i), 0, sizeof(T)*m_nbins);
+        memset((void*)(*i), 0, sizeof(double)*CorrelationValue<T>::num_components*m_nbins);
         }
     // reset the frame counter
     m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+template<typename T>
+void CorrelationFunction<T>::saveState(const std::string& filename)
+    {
+    const unsigned int num_components = CorrelationValue<T>::num_components;
+    std::vector<unsigned int> counts(m_nbins);
+    util::reduceLocalHistograms(m_local_bin_counts, counts.data(), m_nbins);
+    std::vector<double> components(num_components*m_nbins);
+    util::reduceLocalHistograms(m_local_components, components.data(), num_components*m_nbins);
+
+    util::CheckpointWriter writer(filename, "CorrelationFunction");
+    writer.write(num_components);
+    writer.writeArray(m_bin_edges.getEdges().data(), m_nbins + 1);
+    writer.write(m_frame_counter);
+    writer.write(m_n_ref);
+    writer.write(m_Np);
+    writer.writeBox(m_box);
+    writer.writeHistogram(counts.data(), m_nbins);
+    writer.writeHistogram(components.data(), num_components*m_nbins);
+    writer.close();
+    }
+
+template<typename T>
+void CorrelationFunction<T>::loadState(const std::string& filename, bool merge)
+    {
+    const unsigned int num_components = CorrelationValue<T>::num_components;
+    // read the whole file before changing anything
+    util::CheckpointReader reader(filename, "CorrelationFunction");
+    reader.expect(num_components, "type of values");
+    reader.expectArray(m_bin_edges.getEdges(), "bins");
+    unsigned int frame_counter = reader.read<unsigned int>();
+    unsigned int n_ref = reader.read<unsigned int>();
+    unsigned int Np = reader.read<unsigned int>();
+    box::Box box = reader.readBox();
+    std::vector<unsigned int> counts;
+    reader.readHistogram(counts, m_nbins);
+    std::vector<double> components;
+    reader.readHistogram(components, num_components*m_nbins);
+
+    if (!merge)
+        resetCorrelationFunction();
+    addState(counts.data(), components.data(), frame_counter, box, n_ref, Np);
+    }
+
+template<typename T>
+void CorrelationFunction<T>::merge(const CorrelationFunction<T>& other)
+    {
+    if (other.m_bin_edges.getEdges() != m_bin_edges.getEdges())
+        throw invalid_argument("Only correlation functions of the same bins can be merged");
+    const unsigned int num_components = CorrelationValue<T>::num_components;
+    std::vector<unsigned int> counts(m_nbins);
+    util::reduceLocalHistograms(other.m_local_bin_counts, counts.data(), m_nbins);
+    std::vector<double> components(num_components*m_nbins);
+    util::reduceLocalHistograms(other.m_local_components, components.data(), num_components*m_nbins);
+    addState(counts.data(), components.data(), other.m_frame_counter, other.m_box, other.m_n_ref, other.m_Np);
+    }
+
+//! \internal
+//! Add the bin counts and sums of products of frame_counter frames, the last of them of the box and numbers of points
+//! given
+template<typename T>
+void CorrelationFunction<T>::addState(const unsigned int *counts, const double *components, unsigned int frame_counter,
+                                      const box::Box& box, unsigned int n_ref, unsigned int Np)
+    {
+    if (m_frame_counter == 0)
+        {
+        m_box = box;
+        m_n_ref = n_ref;
+        m_Np = Np;
+        }
+    util::addToLocalHistogram(m_local_bin_counts, counts, m_nbins);
+    util::addToLocalHistogram(m_local_components, components, CorrelationValue<T>::num_components*m_nbins);
+    m_frame_counter += frame_counter;
+    m_reduce = true;
     }
 
 template<typename T>
@@ -118,120 +215,148 @@ void CorrelationFunction<T>::accumulate(const box::Box &box,
                              unsigned int n_ref,
                              const vec3<float> *points,
                              const T *point_values,
-                             unsigned int Np)
+                             unsigned int Np,
+                             const locality::NeighborList *nlist)
     {
     m_box = box;
-    m_lc->computeCellList(m_box, points, Np);
+    if (nlist != NULL)
+        nlist->validate(n_ref, Np);
+    else
+        m_lc->computeCellList(m_box, points, Np, true);
+
+    // the components of the point values, in the order the pairs visit them: by cell when the sorted points of the
+    // cell list are used, so that they are read from contiguous memory
+    const unsigned int *cell_particles = (nlist == NULL) ? m_lc->getCellParticles().get() : NULL;
+    std::vector<double> point_components(CorrelationValue<T>::num_components*std::max(Np, 1u));
+    for (unsigned int k = 0; k < Np; k++)
+        {
+        unsigned int j = (nlist == NULL) ? cell_particles[k] : k;
+        CorrelationValue<T>::split(point_values[j], &point_components[k], Np);
+        }
+
     parallel_for(tbb::blocked_range<size_t>(0, n_ref), ComputeOCF<T>(m_nbins,
                                                                     m_local_bin_counts,
-                                                                    m_local_rdf_array,
+                                                                    m_local_components,
                                                                     m_box,
                                                                     m_rmax,
-                                                                    m_dr,
+                                                                    m_bin_edges,
                                                                     m_lc,
+                                                                    nlist,
                                                                     ref_points,
                                                                     ref_values,
                                                                     n_ref,
                                                                     points,
-                                                                    point_values,
-                                                                    Np));
+                                                                    &point_components[0],
+                                                                    Np,
+                                                                    points == ref_points));
     m_frame_counter += 1;
+    m_reduce = true;
     }
 
-template<typename T>
-void CombineOCF<T>::operator()( const tbb::blocked_range<size_t> &myBin ) const
-        {
-        for (size_t i = myBin.begin(); i != myBin.end(); i++)
-            {
-            for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                 local_bins != m_local_bin_counts.end(); ++local_bins)
-                {
-                m_bin_counts[i] += (*local_bins)[i];
-                }
-            for (typename tbb::enumerable_thread_specific<T *>::const_iterator local_rdf = m_local_rdf_array.begin();
-                 local_rdf != m_local_rdf_array.end(); ++local_rdf)
-                {
-                m_rdf_array[i] += (*local_rdf)[i];
-                }
-            if (m_bin_counts[i])
-                {
-                m_rdf_array[i] /= m_bin_counts[i];
-                }
-            }
-        }
-
 template<typename T>
 void ComputeOCF<T>::operator()( const blocked_range<size_t> &myR ) const
     {
     assert(m_ref_points);
     assert(m_ref_values);
     assert(m_points);
-    assert(m_point_values);
+    assert(m_point_components);
     assert(m_n_ref > 0);
     assert(m_Np > 0);
 
-    float dr_inv = 1.0f / m_dr;
+    const unsigned int num_components = CorrelationValue<T>::num_components;
     float rmaxsq = m_rmax * m_rmax;
 
     bool bin_exists;
     m_bin_counts.local(bin_exists);
     if (! bin_exists)
         {
-        m_bin_counts.local() = new unsigned int [m_nbins];
-        memset((void*)m_bin_counts.local(), 0, sizeof(unsigned int)*m_nbins);
+        m_bin_counts.local() = util::allocateLocalHistogram<unsigned int>(m_nbins);
         }
 
     bool rdf_exists;
-    m_rdf_array.local(rdf_exists);
+    m_components.local(rdf_exists);
     if (! rdf_exists)
         {
-        m_rdf_array.local() = new T [m_nbins];
-        memset((void*)m_rdf_array.local(), 0, sizeof(T)*m_nbins);
+        m_components.local() = util::allocateLocalHistogram<double>(num_components*m_nbins);
         }
+    unsigned int *counts = m_bin_counts.local();
+    double *components = m_components.local();
+    const double *point_components = m_point_components;
+    const size_t Np = m_Np;
+    const size_t nbins = m_nbins;
+
+    if (m_nlist != NULL)
+        {
+        const unsigned int *neighbors = m_nlist->getIndexJ().get();
+        const float *distances = m_nlist->getDistances().get();
+        for (size_t i = myR.begin(); i != myR.end(); i++)
+            {
+            double ref_components[num_components];
+            CorrelationValue<T>::split(m_ref_values[i], ref_components, 1);
+
+            size_t last_bond = m_nlist->getLastBondWithin(i, m_rmax);
+            for (size_t bond = m_nlist->getFirstBond(i); bond < last_bond; bond++)
+                {
+                unsigned int j = neighbors[bond];
+                float r = distances[bond];
+                // check that the particle is not checking itself, if it is the same list
+                if ((i != j || !m_same_points) && r < m_rmax)
+                    {
+                    unsigned int bin = m_bin_edges.getBin(r);
+                    if (bin < m_nbins)
+                        {
+                        ++counts[bin];
+                        CorrelationValue<T>::addProduct(ref_components, point_components, Np, j,
+                                                        components, nbins, bin);
+                        }
+                    }
+                }
+            }
+        return;
+        }
+
+    // the points sorted by cell, so that the distances to a cell are computed from contiguous memory
+    const vec3<float> *sorted_points = m_lc->getSortedPoints().get();
+    const unsigned int *cell_start = m_lc->getCellStart().get();
+    const unsigned int *cell_particles = m_lc->getCellParticles().get();
+    locality::DistanceKernel kernel(m_box);
 
     // for each reference point
     for (size_t i = myR.begin(); i != myR.end(); i++)
         {
+        double ref_components[num_components];
+        CorrelationValue<T>::split(m_ref_values[i], ref_components, 1);
+
         // get the cell the point is in
         vec3<float> ref = m_ref_points[i];
         unsigned int ref_cell = m_lc->getCell(ref);
 
         // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+        const locality::CellNeighbors& neigh_cells = m_lc->getCellNeighbors(ref_cell);
         for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
             {
             unsigned int neigh_cell = neigh_cells[neigh_idx];
 
             // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            unsigned int begin = cell_start[neigh_cell];
+            kernel.forEachWithin(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin, rmaxsq,
+                [&] (unsigned int k, const vec3<float>& delta, float rsq)
                 {
-                // compute r between the two particles
-                vec3<float> delta = m_box.wrap(m_points[j] - ref);
-
-                float rsq = dot(delta, delta);
-
+                unsigned int sorted_j = begin + k;
                 // check that the particle is not checking itself, if it is the same list
-                if ((i != j || m_points != m_ref_points) && rsq < rmaxsq)
-                    {
-                    float r = sqrtf(rsq);
+                if (m_same_points && cell_particles[sorted_j] == i)
+                    return;
 
-                    // bin that r
-                    float binr = r * dr_inv;
-                    // fast float to int conversion with truncation
-                    #ifdef __SSE2__
-                    unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
-                    #else
-                    unsigned int bin = (unsigned int)(binr);
-                    #endif
+                // bin that r
+                unsigned int bin = m_bin_edges.getBin(sqrtf(rsq));
 
-                    if (bin < m_nbins)
-                        {
-                        ++m_bin_counts.local()[bin];
-                        m_rdf_array.local()[bin] += m_ref_values[i]*m_point_values[j];
-                        }
+                if (bin < m_nbins)
+                    {
+                    ++counts[bin];
+                    CorrelationValue<T>::addProduct(ref_components, point_components, Np, sorted_j,
+                                                    components, nbins, bin);
                     }
-                }
+                });
             }
         } // done looping over reference points
     }
@@ -1,13 +1,19 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <complex>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
+#include "BinEdges.h"
+#include "HistogramReduction.h"
 
 #include <tbb/tbb.h>
 
@@ -20,6 +26,68 @@
 
 namespace freud { namespace density {
 
+//! Real components of the values of a CorrelationFunction
+/*! The values are accumulated as separate arrays of real components (structure of arrays), so that the products
+    of complex values are plain double arithmetic on contiguous arrays instead of calls to the complex
+    multiplication of the standard library, which checks for infinities and NaNs.
+*/
+template<typename T>
+struct CorrelationValue;
+
+template<>
+struct CorrelationValue<double>
+    {
+    static const unsigned int num_components = 1;
+
+    //! Store the components of v
+    static void split(const double& v, double *components, size_t stride)
+        {
+        components[0] = v;
+        }
+
+    //! Get the value of the components
+    static double combine(const double *components, size_t stride)
+        {
+        return components[0];
+        }
+
+    //! Add the product of a and the value j of the component arrays b to bin of the component arrays acc
+    static void addProduct(const double *a, const double *b, size_t b_stride, size_t j,
+                           double *acc, size_t acc_stride, unsigned int bin)
+        {
+        acc[bin] += a[0]*b[j];
+        }
+    };
+
+template<>
+struct CorrelationValue< std::complex<double> >
+    {
+    static const unsigned int num_components = 2;
+
+    //! Store the components of v
+    static void split(const std::complex<double>& v, double *components, size_t stride)
+        {
+        components[0] = v.real();
+        components[stride] = v.imag();
+        }
+
+    //! Get the value of the components
+    static std::complex<double> combine(const double *components, size_t stride)
+        {
+        return std::complex<double>(components[0], components[stride]);
+        }
+
+    //! Add the product of a and the value j of the component arrays b to bin of the component arrays acc
+    static void addProduct(const double *a, const double *b, size_t b_stride, size_t j,
+                           double *acc, size_t acc_stride, unsigned int bin)
+        {
+        const double b_re = b[j];
+        const double b_im = b[b_stride + j];
+        acc[bin] += a[0]*b_re - a[1]*b_im;
+        acc[acc_stride + bin] += a[0]*b_im + a[1]*b_re;
+        }
+    };
+
 //! Computes the pairwise correlation function <p*q>(r) between two sets of points with associated values p and q.
 /*! Two sets of points and two sets of values associated with those
     points are given. Computing the correlation function results in an
@@ -43,6 +111,10 @@ namespace freud { namespace density {
     for both points and ref_points, we omit accumulating the
     self-correlation value in the first bin.
 
+    <b>Neighbor lists:</b><br>
+    accumulate() takes an optional precomputed NeighborList, whose bonds
+    no longer than rmax are used instead of building the cell list.
+
 */
 template<typename T>
 class CorrelationFunction
@@ -51,6 +123,9 @@ class CorrelationFunction
         //! Constructor
         CorrelationFunction(float rmax, float dr);
 
+        //! Constructor with arbitrary increasing bin edges
+        CorrelationFunction(const std::vector<float>& bin_edges);
+
         //! Destructor
         ~CorrelationFunction();
 
@@ -76,18 +151,36 @@ class CorrelationFunction
                         unsigned int n_ref,
                         const vec3<float> *points,
                         const T *point_values,
-                        unsigned int Np);
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
         void reduceCorrelationFunction();
 
+        //! Save the accumulated bin counts and sums of products, the number of frames and the box and numbers of
+        //! points of the last frame to a checkpoint file
+        void saveState(const std::string& filename);
+
+        //! Restore the state of a checkpoint file, or add it to the accumulated state if merge
+        /*! The bins and the type of the values must be the same.
+        */
+        void loadState(const std::string& filename, bool merge=false);
+
+        //! Add the accumulated state of another correlation function of the same bins
+        void merge(const CorrelationFunction<T>& other);
+
         //! Get a reference to the last computed rdf
         std::shared_ptr<T> getRDF();
 
         //! Get a reference to the bin counts array
         std::shared_ptr<unsigned int> getCounts()
             {
+            if (m_reduce == true)
+                {
+                reduceCorrelationFunction();
+                }
+            m_reduce = false;
             return m_bin_counts;
             }
 
@@ -102,45 +195,36 @@ class CorrelationFunction
             return m_nbins;
             }
 
+        //! Get the nbins + 1 edges of the r bins
+        const std::vector<float>& getBinEdges() const
+            {
+            return m_bin_edges.getEdges();
+            }
+
     private:
+        //! Add the bin counts and sums of products of some frames to the accumulated ones
+        void addState(const unsigned int *counts, const double *components, unsigned int frame_counter,
+                      const box::Box& box, unsigned int n_ref, unsigned int Np);
+
+        //! Allocate the arrays for the bins
+        void initialize(const util::BinEdges& bin_edges);
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_rmax;                     //!< Maximum r at which to compute g(r)
         float m_dr;                       //!< Step size for r in the computation
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
         unsigned int m_nbins;             //!< Number of r bins to compute g(r) over
+        util::BinEdges m_bin_edges;       //!< Edges of the r bins
         unsigned int m_n_ref;                  //!< number of reference particles
         unsigned int m_Np;                  //!< number of check particles
         unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
 
         std::shared_ptr<T> m_rdf_array;         //!< rdf array computed
         std::shared_ptr<unsigned int> m_bin_counts; //!< bin counts that go into computing the rdf array
         std::shared_ptr<float> m_r_array;           //!< array of r values that the rdf is computed at
         tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
-        tbb::enumerable_thread_specific<T *> m_local_rdf_array;
-    };
-
-template<typename T>
-class CombineOCF
-    {
-    private:
-        unsigned int m_nbins;
-        unsigned int *m_bin_counts;
-        tbb::enumerable_thread_specific<unsigned int *>& m_local_bin_counts;
-        T *m_rdf_array;
-        tbb::enumerable_thread_specific<T *>& m_local_rdf_array;
-        float m_n_ref;
-    public:
-        CombineOCF(unsigned int nbins,
-                   unsigned int *bin_counts,
-                   tbb::enumerable_thread_specific<unsigned int *>& local_bin_counts,
-                   T *rdf_array,
-                   tbb::enumerable_thread_specific<T *>& local_rdf_array,
-                   float n_ref)
-            : m_nbins(nbins), m_bin_counts(bin_counts), m_local_bin_counts(local_bin_counts), m_rdf_array(rdf_array),
-              m_local_rdf_array(local_rdf_array), m_n_ref(n_ref)
-        {
-        }
-        void operator()( const tbb::blocked_range<size_t> &myBin ) const;
+        tbb::enumerable_thread_specific<double *> m_local_components;  //!< per-thread sums of the products, by component
     };
 
 template<typename T>
@@ -149,34 +233,42 @@ class ComputeOCF
     private:
         const unsigned int m_nbins;
         tbb::enumerable_thread_specific<unsigned int *>& m_bin_counts;
-        tbb::enumerable_thread_specific<T *>& m_rdf_array;
+        tbb::enumerable_thread_specific<double *>& m_components;
         const box::Box m_box;
         const float m_rmax;
-        const float m_dr;
+        const util::BinEdges& m_bin_edges;
         const locality::LinkCell *m_lc;
+        const locality::NeighborList *m_nlist;
         const vec3<float> *m_ref_points;
         const T *m_ref_values;
         const unsigned int m_n_ref;
         const vec3<float> *m_points;
-        const T *m_point_values;
+        const double *m_point_components;
         unsigned int m_Np;
+        bool m_same_points;
     public:
+        /*! \param point_components components of the point values, in cell order without \a nlist and in point order
+                with it, each component an array of Np values
+        */
         ComputeOCF(const unsigned int nbins,
                    tbb::enumerable_thread_specific<unsigned int *>& bin_counts,
-                   tbb::enumerable_thread_specific<T *>& rdf_array,
+                   tbb::enumerable_thread_specific<double *>& components,
                    const box::Box &box,
                    const float rmax,
-                   const float dr,
+                   const util::BinEdges& bin_edges,
                    const locality::LinkCell *lc,
+                   const locality::NeighborList *nlist,
                    const vec3<float> *ref_points,
                    const T *ref_values,
                    unsigned int n_ref,
                    const vec3<float> *points,
-                   const T *point_values,
-                   unsigned int Np)
-            : m_nbins(nbins), m_bin_counts(bin_counts), m_rdf_array(rdf_array), m_box(box), m_rmax(rmax), m_dr(dr),
-              m_lc(lc), m_ref_points(ref_points), m_ref_values(ref_values), m_n_ref(n_ref), m_points(points),
-              m_point_values(point_values), m_Np(Np)
+                   const double *point_components,
+                   unsigned int Np,
+                   bool same_points)
+            : m_nbins(nbins), m_bin_counts(bin_counts), m_components(components), m_box(box), m_rmax(rmax),
+              m_bin_edges(bin_edges), m_lc(lc), m_nlist(nlist), m_ref_points(ref_points), m_ref_values(ref_values),
+              m_n_ref(n_ref), m_points(points), m_point_components(point_components), m_Np(Np),
+              m_same_points(same_points)
         {
         }
         void operator()( const tbb::blocked_range<size_t> &myR ) const;
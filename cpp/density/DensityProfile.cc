@@ -0,0 +1,203 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "DensityProfile.h"
+#include "Annotation.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file DensityProfile.cc
+    \brief Routines for computing the number density profiles of the types of points along an axis of the box
+*/
+
+namespace freud { namespace density {
+
+//! The component of v along axis 0, 1 or 2
+static inline float axisComponent(const vec3<float>& v, unsigned int axis)
+    {
+    return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+    }
+
+DensityProfile::DensityProfile(unsigned int axis, unsigned int nbins, unsigned int n_types, float sigma,
+                               bool recenter)
+    : m_box(box::Box()), m_axis(axis), m_nbins(nbins), m_n_types(n_types), m_sigma(sigma), m_recenter(recenter),
+      m_frame_counter(0), m_reduce(true)
+    {
+    if (axis > 2)
+        throw invalid_argument("axis must be 0, 1 or 2");
+    if (nbins < 1)
+        throw invalid_argument("must be at least 1 bin");
+    if (n_types < 1)
+        throw invalid_argument("must be at least 1 type");
+    if (sigma < 0.0f)
+        throw invalid_argument("sigma must not be negative");
+
+    const unsigned int n = m_n_types*m_nbins;
+    m_sum_array = std::shared_ptr<double>(new double[n], std::default_delete<double[]>());
+    memset((void*)m_sum_array.get(), 0, sizeof(double)*n);
+    m_density_array = std::shared_ptr<float>(new float[n], std::default_delete<float[]>());
+    memset((void*)m_density_array.get(), 0, sizeof(float)*n);
+    m_position_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    memset((void*)m_position_array.get(), 0, sizeof(float)*m_nbins);
+    }
+
+DensityProfile::~DensityProfile()
+    {
+    util::freeLocalHistograms(m_local_sums);
+    }
+
+//! \internal
+//! reduce the thread local sums into the per type density profiles
+void DensityProfile::reduceProfile()
+    {
+    util::ScopedRange annotation("freud::DensityProfile::reduce");
+    double *sums = m_sum_array.get();
+    float *density = m_density_array.get();
+    const double norm = (m_frame_counter > 0) ? 1.0/m_frame_counter : 0.0;
+    util::reduceLocalHistograms(m_local_sums, sums, m_n_types*m_nbins,
+        [=] (size_t begin, size_t end)
+        {
+        for (size_t i = begin; i != end; i++)
+            density[i] = float(sums[i]*norm);
+        });
+
+    float L = axisComponent(m_box.getL(), m_axis);
+    for (unsigned int i = 0; i < m_nbins; i++)
+        m_position_array.get()[i] = L*((float(i) + 0.5f)/m_nbins - 0.5f);
+    }
+
+//! Get a reference to the profiles
+std::shared_ptr<float> DensityProfile::getDensity()
+    {
+    if (m_reduce == true)
+        {
+        reduceProfile();
+        }
+    m_reduce = false;
+    return m_density_array;
+    }
+
+//! Get a reference to the centers of the slabs
+std::shared_ptr<float> DensityProfile::getPositions()
+    {
+    if (m_reduce == true)
+        {
+        reduceProfile();
+        }
+    m_reduce = false;
+    return m_position_array;
+    }
+
+//! \internal
+/*! \brief Function to reset the profiles if needed e.g. calculating a new set of frames
+*/
+void DensityProfile::resetProfile()
+    {
+    for (tbb::enumerable_thread_specific<double *>::iterator i = m_local_sums.begin(); i != m_local_sums.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(double)*m_n_types*m_nbins);
+        }
+    // reset the frame counter
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief The center of mass along the axis, in fractional coordinates
+
+    The fractional coordinates are angles on a circle, whose mean does not depend on where the box is cut.
+*/
+float DensityProfile::centerOfMass(const vec3<float> *points, unsigned int Np) const
+    {
+    const box::Box& box = m_box;
+    const unsigned int axis = m_axis;
+    vec2<double> sum = parallel_reduce(blocked_range<size_t>(0, Np), vec2<double>(0, 0),
+      [=, &box] (const blocked_range<size_t>& r, vec2<double> partial)
+      {
+      for (size_t i = r.begin(); i != r.end(); i++)
+          {
+          double theta = 2.0*M_PI*axisComponent(box.makeFraction(points[i]), axis);
+          partial.x += cos(theta);
+          partial.y += sin(theta);
+          }
+      return partial;
+      },
+      [] (const vec2<double>& a, const vec2<double>& b)
+      {
+      return a + b;
+      });
+    // the mean angle is that of the mean of the points on the circle, in [0, 2 pi)
+    return float((atan2(-sum.y, -sum.x) + M_PI)/(2.0*M_PI));
+    }
+
+//! \internal
+/*! \brief Function to accumulate the profiles of a frame
+*/
+void DensityProfile::accumulate(const box::Box& box, const vec3<float> *points, const unsigned int *types,
+                                unsigned int Np)
+    {
+    util::ScopedRange annotation("freud::DensityProfile::accumulate");
+    if (box.is2D() && m_axis == 2)
+        throw invalid_argument("A 2D box has no profile along z");
+    if (types != NULL)
+        for (unsigned int i = 0; i < Np; i++)
+            if (types[i] >= m_n_types)
+                throw invalid_argument("The types must be smaller than the number of types");
+    m_box = box;
+
+    // the center of mass is moved to the fractional coordinate 0.5
+    const float shift = (m_recenter && Np > 0) ? 0.5f - centerOfMass(points, Np) : 0.0f;
+    const double weight = double(m_nbins)/box.getVolume();
+    // the width of the Gaussian in slabs
+    const float sigma_bins = m_sigma/axisComponent(box.getL(), m_axis)*m_nbins;
+    const float erf_scale = (sigma_bins > 0.0f) ? 1.0f/(sigma_bins*sqrtf(2.0f)) : 0.0f;
+    const int bin_cut = int(ceilf(4.0f*sigma_bins));
+    const unsigned int n_bins = m_n_types*m_nbins;
+    const box::Box& l_box = m_box;
+
+    parallel_for(blocked_range<size_t>(0, Np),
+      [=, &l_box] (const blocked_range<size_t>& r)
+      {
+      bool exists;
+      m_local_sums.local(exists);
+      if (! exists)
+          {
+          m_local_sums.local() = util::allocateLocalHistogram<double>(n_bins);
+          }
+      double *local_sums = m_local_sums.local();
+
+      for (size_t i = r.begin(); i != r.end(); i++)
+          {
+          float f = axisComponent(l_box.makeFraction(points[i]), m_axis) + shift;
+          f -= floorf(f);
+          double *profile = local_sums + ((types != NULL) ? types[i] : 0)*m_nbins;
+          float u = f*m_nbins;
+          if (sigma_bins == 0.0f)
+              {
+              // f rounded up to 1 belongs in the last slab
+              unsigned int bin = std::min((unsigned int)(u), m_nbins - 1);
+              profile[bin] += weight;
+              continue;
+              }
+          // the integral of the Gaussian over each slab, from the difference of its cumulative distribution at the
+          // edges of the slab
+          int first = int(floorf(u)) - bin_cut;
+          float lower = erff((float(first) - u)*erf_scale);
+          for (int k = first; k <= first + 2*bin_cut; k++)
+              {
+              float upper = erff((float(k + 1) - u)*erf_scale);
+              int bin = ((k % int(m_nbins)) + int(m_nbins)) % int(m_nbins);
+              profile[bin] += weight*0.5*(upper - lower);
+              lower = upper;
+              }
+          }
+      });
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::density
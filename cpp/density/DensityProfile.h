@@ -0,0 +1,121 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <ostream>
+
+// work around nasty issue where python #defines isalpha, toupper, etc....
+#undef __APPLE__
+#include <Python.h>
+#define __APPLE__
+
+#include <memory>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "HistogramReduction.h"
+
+#ifndef _DENSITY_PROFILE_H__
+#define _DENSITY_PROFILE_H__
+
+/*! \file DensityProfile.h
+    \brief Routines for computing the number density profiles of the types of points along an axis of the box
+*/
+
+namespace freud { namespace density {
+
+//! Computes the average number density of each type of points in slabs along an axis of the box
+/*! The box is cut into nbins slabs of equal thickness across the axis, in fractional coordinates, so that the
+    profiles of frames of fluctuating boxes add up bin by bin. Each point adds the inverse of the volume of a slab of
+    its frame to the bin of its type, in per-thread histograms reduced once, as RDF does, and the profiles are the
+    averages over the frames.
+
+    With a positive sigma, each point is smeared by a Gaussian of that width along the axis instead, integrated over
+    each slab within 4 sigma, so that its weight is kept. With recentering, the positions are taken relative to the
+    center of mass of the points of the frame along the axis, found as the circular mean of the periodic coordinate,
+    so that an interface or a slab that drifts stays at the center of the profile.
+*/
+class DensityProfile
+    {
+    public:
+        //! Constructor
+        /*! \param axis 0, 1 or 2 for the profile along x, y or z
+            \param nbins number of slabs across the box
+            \param n_types number of types of the points
+            \param sigma width of the Gaussian smearing along the axis, 0 to bin the points
+            \param recenter whether to put the center of mass of each frame at the center of the profile
+        */
+        DensityProfile(unsigned int axis, unsigned int nbins, unsigned int n_types, float sigma=0.0f,
+                       bool recenter=false);
+
+        //! Destructor
+        ~DensityProfile();
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the profiles to all zeros
+        void resetProfile();
+
+        //! Accumulate the profiles of a frame
+        /*! \param types type of each point, in [0, n_types), or NULL if all the points are of type 0
+        */
+        void accumulate(const box::Box& box, const vec3<float> *points, const unsigned int *types, unsigned int Np);
+
+        //! \internal
+        //! reduce the thread local sums into the per type density profiles
+        void reduceProfile();
+
+        //! Get a reference to the profiles, n_types x nbins
+        std::shared_ptr<float> getDensity();
+
+        //! Get the positions of the centers of the slabs along the axis in the box of the last frame
+        /*! They are relative to the center of the box, or to the center of mass when recentering.
+        */
+        std::shared_ptr<float> getPositions();
+
+        //! Get the number of slabs
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Get the number of types
+        unsigned int getNTypes() const
+            {
+            return m_n_types;
+            }
+
+        //! Get the number of frames accumulated
+        unsigned int getFrameCounter() const
+            {
+            return m_frame_counter;
+            }
+
+    private:
+        //! Fractional coordinate along the axis of the center of mass of the points, by their circular mean
+        float centerOfMass(const vec3<float> *points, unsigned int Np) const;
+
+        box::Box m_box;                     //!< Simulation box of the last frame
+        unsigned int m_axis;                //!< Axis of the profile
+        unsigned int m_nbins;               //!< Number of slabs
+        unsigned int m_n_types;             //!< Number of types
+        float m_sigma;                      //!< Width of the Gaussian smearing, 0 to bin
+        bool m_recenter;                    //!< Whether to recenter each frame on its center of mass
+        unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
+
+        std::shared_ptr<double> m_sum_array;        //!< Sum over the frames of the number densities, by type and bin
+        std::shared_ptr<float> m_density_array;     //!< Average number density, by type and bin
+        std::shared_ptr<float> m_position_array;    //!< Centers of the slabs
+        tbb::enumerable_thread_specific<double *> m_local_sums;
+    };
+
+}; }; // end namespace freud::density
+
+#endif // _DENSITY_PROFILE_H__
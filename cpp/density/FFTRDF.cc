@@ -0,0 +1,274 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "FFTRDF.h"
+#include "FFT.h"
+#include "Checkpoint.h"
+
+#include <complex>
+#include <stdexcept>
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file FFTRDF.cc
+    \brief Routines for computing radial density functions from the autocorrelation of a density grid
+*/
+
+namespace freud { namespace density {
+
+FFTRDF::FFTRDF(float rmax, float dr, unsigned int width)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_width(width), m_frame_counter(0), m_reduce(true)
+    {
+    if (dr <= 0.0f)
+        throw invalid_argument("dr must be positive");
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    if (dr > rmax)
+        throw invalid_argument("rmax must be greater than dr");
+    if (!util::isPowerOfTwo(width))
+        throw invalid_argument("width must be a power of two");
+
+    m_bin_edges = util::BinEdges(m_rmax, m_dr);
+    m_nbins = m_bin_edges.getNBins();
+    assert(m_nbins > 0);
+    m_rdf_sum.resize(m_nbins, 0.0);
+    m_N_r_sum.resize(m_nbins, 0.0);
+    m_rdf_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    memset((void*)m_rdf_array.get(), 0, sizeof(float)*m_nbins);
+    m_N_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    memset((void*)m_N_r_array.get(), 0, sizeof(float)*m_nbins);
+
+    // precompute the bin center positions
+    const std::vector<float>& edges = m_bin_edges.getEdges();
+    m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float r = edges[i];
+        float nextr = edges[i+1];
+        m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
+        }
+    }
+
+//! \internal
+//! Add one to the grid cell of each point
+static void fillDensityGrid(const box::Box& box,
+                            const Index3D& grid,
+                            const vec3<float> *points,
+                            unsigned int Np,
+                            std::complex<double> *density)
+    {
+    const int w = grid.getW();
+    const int h = grid.getH();
+    const int d = grid.getD();
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        vec3<float> f = box.makeFraction(points[i]);
+        // points on the upper faces or slightly outside of the box belong to the periodic image of their cell
+        int x = ((int(floorf(f.x * w)) % w) + w) % w;
+        int y = ((int(floorf(f.y * h)) % h) + h) % h;
+        int z = ((int(floorf(f.z * d)) % d) + d) % d;
+        density[grid(x, y, z)] += 1.0;
+        }
+    }
+
+//! \internal
+//! Average the accumulated frames
+void FFTRDF::reduceRDF()
+    {
+    float sum = 0.0f;
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float frames = (m_frame_counter > 0) ? float(m_frame_counter) : 1.0f;
+        m_rdf_array.get()[i] = float(m_rdf_sum[i]) / frames;
+        sum += float(m_N_r_sum[i]) / frames;
+        m_N_r_array.get()[i] = sum;
+        }
+    }
+
+//! Get a reference to the last computed rdf
+std::shared_ptr<float> FFTRDF::getRDF()
+    {
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
+    return m_rdf_array;
+    }
+
+//! Get a reference to the N_r array
+std::shared_ptr<float> FFTRDF::getNr()
+    {
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
+    return m_N_r_array;
+    }
+
+//! \internal
+/*! \brief Function to reset the rdf array if needed e.g. calculating between new particle types
+*/
+void FFTRDF::resetRDF()
+    {
+    std::fill(m_rdf_sum.begin(), m_rdf_sum.end(), 0.0);
+    std::fill(m_N_r_sum.begin(), m_N_r_sum.end(), 0.0);
+    // reset the frame counter
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void FFTRDF::saveState(const std::string& filename)
+    {
+    util::CheckpointWriter writer(filename, "FFTRDF");
+    writer.write(m_rmax);
+    writer.write(m_dr);
+    writer.write(m_width);
+    writer.write(m_frame_counter);
+    writer.writeBox(m_box);
+    writer.writeArray(m_rdf_sum.data(), m_nbins);
+    writer.writeArray(m_N_r_sum.data(), m_nbins);
+    writer.close();
+    }
+
+void FFTRDF::loadState(const std::string& filename, bool merge)
+    {
+    // read the whole file before changing anything
+    util::CheckpointReader reader(filename, "FFTRDF");
+    reader.expect(m_rmax, "rmax");
+    reader.expect(m_dr, "dr");
+    reader.expect(m_width, "width");
+    unsigned int frame_counter = reader.read<unsigned int>();
+    box::Box box = reader.readBox();
+    std::vector<double> rdf_sum, N_r_sum;
+    reader.readArray(rdf_sum);
+    reader.readArray(N_r_sum);
+    if (rdf_sum.size() != m_nbins || N_r_sum.size() != m_nbins)
+        throw invalid_argument("The checkpoint file is corrupted");
+
+    if (!merge)
+        resetRDF();
+    addState(rdf_sum.data(), N_r_sum.data(), frame_counter, box);
+    }
+
+void FFTRDF::merge(const FFTRDF& other)
+    {
+    if (other.m_rmax != m_rmax || other.m_dr != m_dr || other.m_width != m_width)
+        throw invalid_argument("Only FFTRDFs of the same bins and grid can be merged");
+    addState(other.m_rdf_sum.data(), other.m_N_r_sum.data(), other.m_frame_counter, other.m_box);
+    }
+
+//! \internal
+//! Add the sums of frame_counter frames, the last of them of the box given
+void FFTRDF::addState(const double *rdf_sum, const double *N_r_sum, unsigned int frame_counter, const box::Box& box)
+    {
+    if (m_frame_counter == 0)
+        m_box = box;
+    for (unsigned int bin = 0; bin < m_nbins; bin++)
+        {
+        m_rdf_sum[bin] += rdf_sum[bin];
+        m_N_r_sum[bin] += N_r_sum[bin];
+        }
+    m_frame_counter += frame_counter;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Function to accumulate the given points to the histogram in memory
+*/
+void FFTRDF::accumulate(box::Box& box,
+                        const vec3<float> *ref_points,
+                        unsigned int n_ref,
+                        const vec3<float> *points,
+                        unsigned int Np)
+    {
+    m_box = box;
+    Index3D grid(m_width, m_width, m_box.is2D() ? 1 : m_width);
+    const unsigned int num_cells = grid.getNumElements();
+    const bool same_points = (ref_points == points) && (n_ref == Np);
+
+    // correlation of the two density grids, sum_c n_ref(c) n(c + d), through their transforms
+    std::vector<std::complex<double> > correlation(num_cells, 0.0);
+    fillDensityGrid(m_box, grid, ref_points, n_ref, &correlation[0]);
+    util::fft3D(&correlation[0], grid.getW(), grid.getH(), grid.getD(), false);
+    if (same_points)
+        {
+        for (unsigned int c = 0; c < num_cells; c++)
+            correlation[c] = std::norm(correlation[c]);
+        }
+    else
+        {
+        std::vector<std::complex<double> > density(num_cells, 0.0);
+        fillDensityGrid(m_box, grid, points, Np, &density[0]);
+        util::fft3D(&density[0], grid.getW(), grid.getH(), grid.getD(), false);
+        for (unsigned int c = 0; c < num_cells; c++)
+            correlation[c] = std::conj(correlation[c]) * density[c];
+        }
+    util::fft3D(&correlation[0], grid.getW(), grid.getH(), grid.getD(), true);
+
+    // bin the pair counts and the number of grid displacements by the length of the displacements
+    const std::complex<double> *corr = &correlation[0];
+    enumerable_thread_specific<std::vector<double> > local_bins(std::vector<double>(2*m_nbins, 0.0));
+    parallel_for(blocked_range<size_t>(0, num_cells),
+      [=, &local_bins] (const blocked_range<size_t>& r)
+      {
+      std::vector<double>& bins = local_bins.local();
+      const int w = grid.getW();
+      const int h = grid.getH();
+      const int d = grid.getD();
+      for (size_t c = r.begin(); c != r.end(); c++)
+          {
+          vec3<unsigned int> idx = grid(c);
+          // displacements of more than half of the grid are those of the nearest image
+          int x = int(idx.x) > w/2 ? int(idx.x) - w : int(idx.x);
+          int y = int(idx.y) > h/2 ? int(idx.y) - h : int(idx.y);
+          int z = int(idx.z) > d/2 ? int(idx.z) - d : int(idx.z);
+          vec3<float> f(float(x) / w + 0.5f, float(y) / h + 0.5f, float(z) / d + 0.5f);
+          vec3<float> delta = m_box.makeCoordinates(f);
+          unsigned int bin = m_bin_edges.getBin(sqrtf(dot(delta, delta)));
+          if (bin < m_nbins)
+              {
+              double pairs = corr[c].real() / double(num_cells);
+              // leave out the pairs of each point with itself
+              if (same_points && c == 0)
+                  pairs -= double(n_ref);
+              bins[bin] += pairs;
+              bins[m_nbins + bin] += 1.0;
+              }
+          }
+      });
+
+    std::vector<double> counts(2*m_nbins, 0.0);
+    for (enumerable_thread_specific<std::vector<double> >::iterator i = local_bins.begin(); i != local_bins.end(); ++i)
+        {
+        for (unsigned int bin = 0; bin < 2*m_nbins; bin++)
+            counts[bin] += (*i)[bin];
+        }
+
+    // an uncorrelated system has n_ref*Np/num_cells pairs at every grid displacement; the first bin, which holds
+    // the pairs of identical points, is left out as in RDF
+    const std::vector<float>& edges = m_bin_edges.getEdges();
+    double ndens = double(Np) / double(m_box.getVolume());
+    for (unsigned int bin = 1; bin < m_nbins; bin++)
+        {
+        double num_displacements = counts[m_nbins + bin];
+        if (num_displacements > 0.0 && n_ref > 0 && Np > 0)
+            {
+            double rdf = counts[bin] * double(num_cells) / (double(n_ref) * double(Np) * num_displacements);
+            m_rdf_sum[bin] += rdf;
+            // the mean number of points in the shell follows from g(r) and the exact volume of the shell, which
+            // the grid displacements of the bin only approximate
+            double r = edges[bin];
+            double nextr = edges[bin+1];
+            double vol = m_box.is2D() ? M_PI * (nextr*nextr - r*r) : 4.0 / 3.0 * M_PI * (nextr*nextr*nextr - r*r*r);
+            m_N_r_sum[bin] += rdf * ndens * vol;
+            }
+        }
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::density
@@ -0,0 +1,128 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <ostream>
+
+// work around nasty issue where python #defines isalpha, toupper, etc....
+#undef __APPLE__
+#include <Python.h>
+#define __APPLE__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "Index1D.h"
+#include "BinEdges.h"
+
+#ifndef _FFT_RDF_H__
+#define _FFT_RDF_H__
+
+/*! \file FFTRDF.h
+    \brief Routines for computing radial density functions from the autocorrelation of a density grid
+*/
+
+namespace freud { namespace density {
+
+//! Computes the RDF (g(r)) from the correlation of the densities of two sets of points on a periodic grid
+/*! The points are binned on a grid of width^3 cells (width^2 in 2D) over the fractional coordinates of the box. The
+    correlation of the two density grids, computed with fast Fourier transforms, counts the pairs of points at each
+    displacement of the grid, which is then binned by length. This costs O(N + M log M) for M grid cells whatever
+    rmax is, while a cell list degenerates to all pairs as rmax approaches half of the box.
+
+    The distances are resolved to about the size of a grid cell, so the grid cells should be a fraction of dr. Each bin
+    is normalized by the number of grid displacements it holds rather than by the volume of its shell, so that the
+    discretization of the shells does not bias g(r), including for r beyond half of the box.
+*/
+class FFTRDF
+    {
+    public:
+        //! Constructor
+        FFTRDF(float rmax, float dr, unsigned int width);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the RDF array to all zeros
+        void resetRDF();
+
+        //! Accumulate the RDF of a frame
+        void accumulate(box::Box& box,
+                        const vec3<float> *ref_points,
+                        unsigned int n_ref,
+                        const vec3<float> *points,
+                        unsigned int Np);
+
+        //! \internal
+        //! helper function to average the accumulated frames
+        void reduceRDF();
+
+        //! Save the sums of g(r) and N(r) over the accumulated frames, the number of frames and the box of the last
+        //! frame to a checkpoint file
+        void saveState(const std::string& filename);
+
+        //! Restore the state of a checkpoint file, or add it to the accumulated state if merge
+        /*! The parameters must be the same. When merging, the box stays that of this object, unless it has no frame
+            yet.
+        */
+        void loadState(const std::string& filename, bool merge=false);
+
+        //! Add the accumulated state of another FFTRDF of the same parameters, such as one of another chunk of a
+        //! trajectory
+        void merge(const FFTRDF& other);
+
+        //! Get a reference to the last computed rdf
+        std::shared_ptr<float> getRDF();
+
+        //! Get a reference to the r array
+        std::shared_ptr<float> getR()
+            {
+            return m_r_array;
+            }
+
+        //! Get a reference to the N_r array
+        std::shared_ptr<float> getNr();
+
+        //! Get the number of bins
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Get the number of grid cells along each side of the box
+        unsigned int getWidth() const
+            {
+            return m_width;
+            }
+
+    private:
+        //! Add the sums of some frames to the accumulated ones
+        void addState(const double *rdf_sum, const double *N_r_sum, unsigned int frame_counter, const box::Box& box);
+
+        box::Box m_box;                     //!< Simulation box the particles belong in
+        float m_rmax;                       //!< Maximum r at which to compute g(r)
+        float m_dr;                         //!< Step size for r in the computation
+        unsigned int m_width;               //!< Number of grid cells along each side of the box
+        util::BinEdges m_bin_edges;         //!< Edges of the r bins
+        unsigned int m_nbins;               //!< Number of r bins to compute g(r) over
+        unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
+
+        std::vector<double> m_rdf_sum;      //!< g(r) summed over the frames
+        std::vector<double> m_N_r_sum;      //!< mean number of points in each shell summed over the frames
+        std::shared_ptr<float> m_rdf_array;         //!< rdf array computed
+        std::shared_ptr<float> m_N_r_array;         //!< Cumulative bin sum N(r)
+        std::shared_ptr<float> m_r_array;           //!< array of r values that the rdf is computed at
+    };
+
+}; }; // end namespace freud::density
+
+#endif // _FFT_RDF_H__
@@ -2,9 +2,16 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "GaussianDensity.h"
+#include "Checkpoint.h"
 #include "ScopedGILRelease.h"
+#include "FFT.h"
+#include "Annotation.h"
+#include "AlignedArray.h"
 
+#include <algorithm>
+#include <complex>
 #include <stdexcept>
+#include <vector>
 
 using namespace std;
 
@@ -18,7 +25,9 @@ namespace freud { namespace density {
 
 
 GaussianDensity::GaussianDensity(unsigned int width, float r_cut, float sigma)
-    : m_box(box::Box()), m_width_x(width), m_width_y(width), m_width_z(width), m_rcut(r_cut), m_sigma(sigma)
+    : m_box(box::Box()), m_width_x(width), m_width_y(width), m_width_z(width),
+      m_rcut(r_cut), m_sigma(sigma), m_reduce(true), m_direct(false), m_gathered(false),
+      m_spread_mode(SPREAD_AUTO), m_memory_limit(0), m_lc(box::Box(), r_cut), m_gpu_pending(false)
     {
     if (width <= 0)
             throw invalid_argument("width must be a positive integer");
@@ -28,7 +37,9 @@ GaussianDensity::GaussianDensity(unsigned int width, float r_cut, float sigma)
 
 GaussianDensity::GaussianDensity(unsigned int width_x, unsigned int width_y,
                                  unsigned int width_z, float r_cut, float sigma)
-    : m_box(box::Box()), m_width_x(width_x), m_width_y(width_y), m_width_z(width_z), m_rcut(r_cut), m_sigma(sigma)
+    : m_box(box::Box()), m_width_x(width_x), m_width_y(width_y), m_width_z(width_z),
+      m_rcut(r_cut), m_sigma(sigma), m_reduce(true), m_direct(false), m_gathered(false),
+      m_spread_mode(SPREAD_AUTO), m_memory_limit(0), m_lc(box::Box(), r_cut), m_gpu_pending(false)
     {
     if (width_x <= 0 || width_y <=0 || width_z <=0)
             throw invalid_argument("width must be a positive integer");
@@ -38,35 +49,199 @@ GaussianDensity::GaussianDensity(unsigned int width_x, unsigned int width_y,
 
 GaussianDensity::~GaussianDensity()
     {
-    for (tbb::enumerable_thread_specific<float *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
+    util::freeLocalHistograms(m_local_bin_counts);
+    util::freeLocalHistograms(m_local_projection);
+    }
+
+util::MemoryUsage GaussianDensity::getMemoryUsage() const
+    {
+    util::MemoryUsage usage;
+    const size_t num_cells = m_Density_array ? m_bi.getNumElements() : 0;
+    size_t density_bytes = num_cells*sizeof(float);
+    for (std::map<unsigned int, std::shared_ptr<float> >::const_iterator i = m_coarse_density.begin();
+         i != m_coarse_density.end(); ++i)
+        density_bytes += num_cells / (m_box.is2D() ? i->first*i->first : i->first*i->first*i->first)*sizeof(float);
+    if (m_projection_array)
+        density_bytes += size_t(m_width_x)*m_width_y*sizeof(float);
+    usage.add("density", density_bytes);
+    usage.add("local_grids", util::localHistogramBytes(m_local_bin_counts, num_cells) +
+                             util::localHistogramBytes(m_local_projection, size_t(m_width_x)*m_width_y));
+    usage.add("cell_list", m_lc.getMemoryBytes());
+    return usage;
+    }
+
+util::MemoryUsage GaussianDensity::estimateMemory(unsigned int N, unsigned int num_threads) const
+    {
+    util::MemoryUsage usage;
+    if (num_threads == 0)
+        num_threads = this_task_arena::max_concurrency();
+    const size_t num_cells = size_t(m_width_x)*m_width_y*m_width_z;
+    const size_t grid_bytes = num_cells*sizeof(float);
+    bool direct = num_cells >= TILED_GRID_SIZE || util::exceedsMemoryLimit(grid_bytes, num_threads, m_memory_limit);
+    bool gather = m_spread_mode == SPREAD_GATHER;
+    usage.add("density", grid_bytes);
+    usage.add("local_grids", (direct || gather) ? 0 : size_t(num_threads)*grid_bytes);
+    usage.add("cell_list", gather ? locality::LinkCell::estimateMemoryBytes(N, false) : 0);
+    return usage;
     }
 
 void GaussianDensity::reduceDensity()
     {
-    memset((void*)m_Density_array.get(), 0, sizeof(float)*m_bi.getNumElements());
+    // the density of the GPU only needs to be copied back
+    if (m_gpu_pending)
+        {
+        m_gpu->getDensity(m_Density_array.get());
+        m_gpu_pending = false;
+        return;
+        }
+    // tiled and gathered grids are written straight into the density array
+    if (m_direct)
+        return;
     // combine arrays
-    parallel_for(blocked_range<size_t>(0,m_bi.getNumElements()),
+    util::reduceLocalHistograms(m_local_bin_counts, m_Density_array.get(), m_bi.getNumElements());
+    }
+
+void GaussianDensity::setUseGPU(bool use_gpu)
+    {
+    if (!use_gpu)
+        {
+        // the density of the last compute is fetched before the GPU is released
+        if (m_gpu_pending)
+            getDensity();
+        m_gpu.reset();
+        }
+    else if (!m_gpu)
+        m_gpu = std::shared_ptr<gpu::DensityGPU>(new gpu::DensityGPU());
+    }
+
+//!Get a reference to the last computed Density
+std::shared_ptr<float> GaussianDensity::getDensity()
+    {
+    if (m_reduce == true)
+        {
+        reduceDensity();
+        }
+    m_reduce = false;
+    return m_Density_array;
+    }
+
+std::shared_ptr<float> GaussianDensity::getCoarseDensity(unsigned int factor)
+    {
+    if (!m_Density_array)
+        throw invalid_argument("There is no density before the first compute");
+    const bool is2D = m_box.is2D();
+    if (factor == 0 || m_width_x % factor || m_width_y % factor || (!is2D && m_width_z % factor))
+        throw invalid_argument("The widths of the grid must be multiples of the factor");
+    if (factor == 1)
+        return getDensity();
+    std::map<unsigned int, std::shared_ptr<float> >::iterator cached = m_coarse_density.find(factor);
+    if (cached != m_coarse_density.end())
+        return cached->second;
+
+    // the coarsest grid already derived from which this one can be restricted
+    unsigned int fine_factor = 1;
+    const float *fine = getDensity().get();
+    for (cached = m_coarse_density.begin(); cached != m_coarse_density.end(); ++cached)
+        if (factor % cached->first == 0 && cached->first > fine_factor)
+            {
+            fine_factor = cached->first;
+            fine = cached->second.get();
+            }
+    const unsigned int f = factor/fine_factor;
+    const Index3D fine_bi(m_width_x/fine_factor, m_width_y/fine_factor, is2D ? 1 : m_width_z/fine_factor);
+    const Index3D coarse_bi(m_width_x/factor, m_width_y/factor, is2D ? 1 : m_width_z/factor);
+    const unsigned int f_z = is2D ? 1 : f;
+    const float norm = 1.0f/float(f*f*f_z);
+    std::shared_ptr<float> coarse_array = util::makeLargeArray<float>(coarse_bi.getNumElements());
+    float *coarse = coarse_array.get();
+
+    // each row of the coarse grid sums f x f_z rows of the fine grid
+    parallel_for(blocked_range<size_t>(0, coarse_bi.getH()*coarse_bi.getD()),
       [=] (const blocked_range<size_t>& r)
       {
-      for (size_t i = r.begin(); i != r.end(); i++)
+      for (size_t row = r.begin(); row != r.end(); row++)
           {
-          for (tbb::enumerable_thread_specific<float *>::const_iterator local_bins = m_local_bin_counts.begin();
-               local_bins != m_local_bin_counts.end(); ++local_bins)
-              {
-              m_Density_array.get()[i] += (*local_bins)[i];
-              }
+          unsigned int j = row % coarse_bi.getH();
+          unsigned int k = row / coarse_bi.getH();
+          float *line = coarse + coarse_bi(0, j, k);
+          std::fill(line, line + coarse_bi.getW(), 0.0f);
+          for (unsigned int kk = 0; kk < f_z; kk++)
+              for (unsigned int jj = 0; jj < f; jj++)
+                  {
+                  const float *fine_line = fine + fine_bi(0, j*f + jj, k*f_z + kk);
+                  for (unsigned int i = 0; i < coarse_bi.getW(); i++)
+                      for (unsigned int ii = 0; ii < f; ii++)
+                          line[i] += fine_line[i*f + ii];
+                  }
+          for (unsigned int i = 0; i < coarse_bi.getW(); i++)
+              line[i] *= norm;
           }
       });
+    m_coarse_density[factor] = coarse_array;
+    return coarse_array;
     }
 
-//!Get a reference to the last computed Density
-std::shared_ptr<float> GaussianDensity::getDensity()
+void GaussianDensity::saveState(const std::string& filename)
     {
-    reduceDensity();
-    return m_Density_array;
+    util::CheckpointWriter writer(filename, "GaussianDensity");
+    writer.write(m_width_x);
+    writer.write(m_width_y);
+    writer.write(m_width_z);
+    writer.write(m_rcut);
+    writer.write(m_sigma);
+    writer.writeBox(m_box);
+    // there is no density before the first compute
+    writer.write(uint8_t(bool(m_Density_array)));
+    if (m_Density_array)
+        writer.writeHistogram(getDensity().get(), m_bi.getNumElements());
+    writer.close();
+    }
+
+void GaussianDensity::loadState(const std::string& filename, bool merge)
+    {
+    // read the whole file before changing anything
+    util::CheckpointReader reader(filename, "GaussianDensity");
+    reader.expect(m_width_x, "width in x");
+    reader.expect(m_width_y, "width in y");
+    reader.expect(m_width_z, "width in z");
+    reader.expect(m_rcut, "r_cut");
+    reader.expect(m_sigma, "sigma");
+    box::Box box = reader.readBox();
+    const bool computed = reader.read<uint8_t>() != 0;
+    if (!computed)
+        {
+        // an empty density adds nothing, and replaces the current one
+        if (!merge)
+            {
+            m_box = box;
+            m_Density_array.reset();
+            m_coarse_density.clear();
+            m_gpu_pending = false;
+            }
+        return;
+        }
+    const size_t n = size_t(m_width_x)*m_width_y*(box.is2D() ? 1 : m_width_z);
+    std::vector<float> density;
+    reader.readHistogram(density, n);
+    m_coarse_density.clear();
+
+    if (merge && m_Density_array)
+        {
+        if (m_bi.getNumElements() != n)
+            throw invalid_argument("The checkpoint file does not match the dimension of the box of this object");
+        float *current = getDensity().get();
+        for (size_t i = 0; i < n; i++)
+            current[i] += density[i];
+        return;
+        }
+    m_box = box;
+    m_bi = box.is2D() ? Index3D(m_width_x, m_width_y, 1) : Index3D(m_width_x, m_width_y, m_width_z);
+    m_Density_array = util::makeLargeArray<float>(n);
+    std::copy(density.begin(), density.end(), m_Density_array.get());
+    // the per-thread grids are of the last compute
+    util::freeLocalHistograms(m_local_bin_counts);
+    m_gpu_pending = false;
+    m_reduce = false;
     }
 
 //! Get x width
@@ -105,12 +280,388 @@ void GaussianDensity::resetDensity()
         }
     }
 
+//! \internal
+/*! \brief Compute the weights of the grid cells along one axis of an orthorhombic box for a particle
+
+    Fills the 1D Gaussian weight, the squared minimum image distance and the wrapped grid index of the cells from
+    bin - bin_cut to bin + bin_cut along the axis, with the same arithmetic as the 3D loop of compute().
+
+    \param pos coordinate of the particle along the axis
+    \param half_L half of the box length along the axis
+    \param L box length along the axis for the minimum image, zero when it is not periodic
+    \param Linv inverse of L, zero when it is not periodic
+*/
+static void fillAxisWeights(int bin, int bin_cut, float grid_size, float pos, float half_L, float L, float Linv,
+                            unsigned int width, float A, float sigmasq,
+                            std::vector<float>& weights, std::vector<float>& dsq, std::vector<unsigned int>& index)
+    {
+    unsigned int n = 2*bin_cut + 1;
+    weights.resize(n);
+    dsq.resize(n);
+    index.resize(n);
+    for (unsigned int c = 0; c < n; c++)
+        {
+        int i = bin - bin_cut + int(c);
+        float delta = float((grid_size*i + grid_size/2.0f) - pos - half_L);
+        // minimum image along the axis, as in Box::wrap
+        delta -= box::WrapContext::roundNearest(delta*Linv)*L;
+        weights[c] = A*exp((-1.0f)*(delta*delta)/(2.0f*sigmasq));
+        dsq[c] = delta*delta;
+        // Assure that out of range indices are corrected for storage in the array
+        index[c] = (i + width) % width;
+        }
+    }
+
+//! \internal
+/*! \brief Spread the Gaussians of some of the points onto the grid
+
+    Only the grid planes belonging to the tile [plane_begin, plane_end) along the tiled axis (z in 3D, y in 2D) are
+    written, so that tasks spreading to different tiles of the same grid never write the same bins.
+
+    \param points all the points
+    \param point_list indices of the points to spread, or NULL to spread the points begin to end
+    \param begin first entry of point_list (or first point) to spread
+    \param end one past the last entry of point_list (or last point) to spread
+    \param bins grid to add the Gaussians to
+    \param plane_begin first plane of the tile to write
+    \param plane_end one past the last plane of the tile to write
+*/
+void GaussianDensity::spreadPoints(const vec3<float> *points, const unsigned int *point_list, size_t begin,
+                                   size_t end, float *bins, unsigned int plane_begin, unsigned int plane_end) const
+    {
+    // set up some constants first
+    float lx = m_box.getLx();
+    float ly = m_box.getLy();
+    float lz = m_box.getLz();
+
+    float grid_size_x = lx/m_width_x;
+    float grid_size_y = ly/m_width_y;
+    float grid_size_z = lz/m_width_z;
+
+    float sigmasq = m_sigma*m_sigma;
+    float A = sqrt(1.0f/(2.0f*M_PI*sigmasq));
+
+    const bool is2D = m_box.is2D();
+    const box::WrapContext& wrap_ctx = m_box.getWrapContext();
+
+    if (!wrap_ctx.tilted)
+        {
+        // the Gaussian and the minimum image of an orthorhombic box factorize along x, y and z, so the weights of
+        // the grid lines along each axis are computed once per particle and combined by an outer product
+        std::vector<float> weight_x, weight_y, weight_z;
+        std::vector<float> dsq_x, dsq_y, dsq_z;
+        std::vector<unsigned int> index_x, index_y, index_z;
+
+        for (size_t n = begin; n != end; n++)
+            {
+            size_t idx = point_list ? point_list[n] : n;
+            int bin_x = int((points[idx].x+lx/2.0f)/grid_size_x);
+            int bin_y = int((points[idx].y+ly/2.0f)/grid_size_y);
+            int bin_z = int((points[idx].z+lz/2.0f)/grid_size_z);
+
+            int bin_cut_x = int(m_rcut/grid_size_x);
+            int bin_cut_y = int(m_rcut/grid_size_y);
+            int bin_cut_z = int(m_rcut/grid_size_z);
+
+            // in 2D, only the 0 z plane
+            if (is2D)
+                {
+                bin_z = 0;
+                bin_cut_z = 0;
+                grid_size_z = 0;
+                }
+
+            fillAxisWeights(bin_x, bin_cut_x, grid_size_x, points[idx].x, lx/2.0f, wrap_ctx.L.x, wrap_ctx.Linv.x,
+                            m_width_x, A, sigmasq, weight_x, dsq_x, index_x);
+            fillAxisWeights(bin_y, bin_cut_y, grid_size_y, points[idx].y, ly/2.0f, wrap_ctx.L.y, wrap_ctx.Linv.y,
+                            m_width_y, A, sigmasq, weight_y, dsq_y, index_y);
+            fillAxisWeights(bin_z, bin_cut_z, grid_size_z, points[idx].z, lz/2.0f, wrap_ctx.L.z, wrap_ctx.Linv.z,
+                            m_width_z, A, sigmasq, weight_z, dsq_z, index_z);
+
+            const unsigned int n_x = weight_x.size();
+            const float *w_x = &weight_x[0];
+            const float *d_x = &dsq_x[0];
+            const unsigned int *i_x = &index_x[0];
+            for (unsigned int k = 0; k < weight_z.size(); k++)
+                {
+                if (!is2D && (index_z[k] < plane_begin || index_z[k] >= plane_end))
+                    continue;
+                for (unsigned int j = 0; j < weight_y.size(); j++)
+                    {
+                    if (is2D && (index_y[j] < plane_begin || index_y[j] >= plane_end))
+                        continue;
+                    // the rows entirely out of r_cut are skipped
+                    if (!(sqrtf(dsq_y[j] + dsq_z[k]) < m_rcut))
+                        continue;
+                    float w_y = weight_y[j];
+                    float w_z = weight_z[k];
+                    float dsq_y_j = dsq_y[j];
+                    float dsq_z_k = dsq_z[k];
+                    float *row = bins + m_bi(0, index_y[j], index_z[k]);
+                    for (unsigned int i = 0; i < n_x; i++)
+                        {
+                        // without branches, so that the weights of a row are computed with SIMD instructions
+                        float rsqrt = sqrtf(d_x[i] + dsq_y_j + dsq_z_k);
+                        row[i_x[i]] += (rsqrt < m_rcut) ? w_x[i]*w_y*w_z : 0.0f;
+                        }
+                    }
+                }
+            }
+        return;
+        }
+
+    // for each reference point
+    for (size_t n = begin; n != end; n++)
+        {
+        size_t idx = point_list ? point_list[n] : n;
+        // find the distance of that particle to bins
+        // will use this information to evaluate the Gaussian
+        // Find the which bin the particle is in
+        int bin_x = int((points[idx].x+lx/2.0f)/grid_size_x);
+        int bin_y = int((points[idx].y+ly/2.0f)/grid_size_y);
+        int bin_z = int((points[idx].z+lz/2.0f)/grid_size_z);
+
+        // Find the number of bins within r_cut
+        int bin_cut_x = int(m_rcut/grid_size_x);
+        int bin_cut_y = int(m_rcut/grid_size_y);
+        int bin_cut_z = int(m_rcut/grid_size_z);
+
+        // in 2D, only loop over the 0 z plane
+        if (is2D)
+            {
+            bin_z = 0;
+            bin_cut_z = 0;
+            grid_size_z = 0;
+            }
+        // Only evaluate over bins that are within the cut off to reduce the number of computations
+        for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+            {
+            float dz = float((grid_size_z*k + grid_size_z/2.0f) - points[idx].z - lz/2.0f);
+            unsigned int nk = (k + m_width_z) % m_width_z;
+            if (!is2D && (nk < plane_begin || nk >= plane_end))
+                continue;
+
+            for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
+                {
+                float dy = float((grid_size_y*j + grid_size_y/2.0f) - points[idx].y - ly/2.0f);
+                unsigned int nj = (j + m_width_y) % m_width_y;
+                if (is2D && (nj < plane_begin || nj >= plane_end))
+                    continue;
+
+                for (int i = bin_x - bin_cut_x; i<= bin_x + bin_cut_x; i++)
+                    {
+                    // calculate the distance from the grid cell to particular particle
+                    float dx = float((grid_size_x*i + grid_size_x/2.0f) - points[idx].x - lx/2.0f);
+                    vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
+
+                    float rsq = dot(delta, delta);
+                    float rsqrt = sqrtf(rsq);
+
+                    // check to see if this distance is within the specified r_cut
+                    if (rsqrt < m_rcut)
+                        {
+                        // evaluate the gaussian ...
+
+                        float x_gaussian = A*exp((-1.0f)*(delta.x*delta.x)/(2.0f*sigmasq));
+                        float y_gaussian = A*exp((-1.0f)*(delta.y*delta.y)/(2.0f*sigmasq));
+                        float z_gaussian = A*exp((-1.0f)*(delta.z*delta.z)/(2.0f*sigmasq));
+
+                        // Assure that out of range indices are corrected for storage in the array
+                        // i.e. bin -1 is actually bin 29 for nbins = 30
+                        unsigned int ni = (i + m_width_x) % m_width_x;
+
+                        // store the product of these values in an array - n[i, j, k] = gx*gy*gz
+                        bins[m_bi(ni, nj, nk)] += x_gaussian*y_gaussian*z_gaussian;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+//! \internal
+/*! \brief Compute the weight of one grid cell along one axis of an orthorhombic box for a particle
+
+    The cell \a target is reached if one of the cells bin - bin_cut to bin + bin_cut wraps around to it, which is
+    then unique as the grid is wider than 2 bin_cut + 1 cells; its weight and squared distance are those computed by
+    fillAxisWeights() for that cell.
+
+    \returns false if the particle does not reach the cell
+*/
+static bool cellAxisWeight(int bin, int bin_cut, int target, int width, float grid_size, float pos, float half_L,
+                           float L, float Linv, float A, float sigmasq, float& weight, float& dsq)
+    {
+    int offset = ((target - bin) % width + width) % width;
+    int i;
+    if (offset <= bin_cut)
+        i = bin + offset;
+    else if (width - offset <= bin_cut)
+        i = bin + offset - width;
+    else
+        return false;
+    float delta = float((grid_size*i + grid_size/2.0f) - pos - half_L);
+    delta -= box::WrapContext::roundNearest(delta*Linv)*L;
+    weight = A*exp((-1.0f)*(delta*delta)/(2.0f*sigmasq));
+    dsq = delta*delta;
+    return true;
+    }
+
+bool GaussianDensity::useGather(unsigned int Np) const
+    {
+    if (m_spread_mode == SPREAD_SCATTER || Np == 0)
+        return false;
+
+    const bool is2D = m_box.is2D();
+    const vec3<float> L = m_box.getL();
+    const uchar3 periodic = m_box.getPeriodic();
+    const int cut_x = int(m_rcut/(L.x/m_width_x));
+    const int cut_y = int(m_rcut/(L.y/m_width_y));
+    const int cut_z = is2D ? 0 : int(m_rcut/(L.z/m_width_z));
+    bool possible = !m_box.getWrapContext().tilted && periodic.x && periodic.y && (is2D || periodic.z) &&
+                    2.0f*m_rcut <= L.x && 2.0f*m_rcut <= L.y && (is2D || 2.0f*m_rcut <= L.z) &&
+                    2*cut_x + 1 < int(m_width_x) && 2*cut_y + 1 < int(m_width_y) &&
+                    (is2D || 2*cut_z + 1 < int(m_width_z));
+    if (m_spread_mode == SPREAD_GATHER)
+        {
+        if (!possible)
+            throw invalid_argument("Gathering needs a periodic orthorhombic box of at least 2 r_cut along each "
+                                   "axis, and a grid wider than the cells reached by a Gaussian");
+        return true;
+        }
+    // the scatter visits the stencil of every point, but also clears and reduces a copy of the grid per thread
+    // unless the grid is tiled; the gather writes the grid once
+    double stencil = double(2*cut_x + 1)*double(2*cut_y + 1)*double(2*cut_z + 1);
+    return possible && m_bi.getNumElements() < TILED_GRID_SIZE && this_task_arena::max_concurrency() > 1 &&
+           double(Np)*stencil < double(m_bi.getNumElements());
+    }
+
+/*! A task owns rows of the grid along x. The points whose Gaussians may reach a row are those of the cells of the
+    LinkCell within one cell of the row along y and z, over all the cells along x, which are consecutive ranges of
+    its sorted particles; their weights along y and z are tested once per row, and those reaching it are spread along
+    x as in spreadPoints(), with weights along x computed once per point.
+*/
+void GaussianDensity::gatherPoints(const vec3<float> *points, unsigned int Np)
+    {
+    m_lc.computeCellList(m_box, points, Np);
+    const Index3D& cell_index = m_lc.getCellIndexer();
+    const unsigned int *cell_start = m_lc.getCellStart().get();
+    const unsigned int *cell_particles = m_lc.getCellParticles().get();
+    const locality::LinkCell& lc = m_lc;
+
+    const bool is2D = m_box.is2D();
+    const float lx = m_box.getLx();
+    const float ly = m_box.getLy();
+    const float lz = m_box.getLz();
+    const float grid_size_x = lx/m_width_x;
+    const float grid_size_y = ly/m_width_y;
+    const float grid_size_z = is2D ? 0.0f : lz/m_width_z;
+    const int bin_cut_x = int(m_rcut/grid_size_x);
+    const int bin_cut_y = int(m_rcut/grid_size_y);
+    const int bin_cut_z = is2D ? 0 : int(m_rcut/grid_size_z);
+    const float sigmasq = m_sigma*m_sigma;
+    const float A = sqrt(1.0f/(2.0f*M_PI*sigmasq));
+    const box::WrapContext& wrap_ctx = m_box.getWrapContext();
+    const unsigned int num_rows = m_width_y*(is2D ? 1 : m_width_z);
+    float *density = m_Density_array.get();
+
+    // the weights along x of each point are the same on every row it reaches
+    const unsigned int n_x = 2*bin_cut_x + 1;
+    std::vector<float> all_weight_x(size_t(Np)*n_x), all_dsq_x(size_t(Np)*n_x);
+    std::vector<unsigned int> all_index_x(size_t(Np)*n_x);
+    float *l_weight_x = &all_weight_x[0];
+    float *l_dsq_x = &all_dsq_x[0];
+    unsigned int *l_index_x = &all_index_x[0];
+    parallel_for(blocked_range<size_t>(0, Np),
+      [=, &wrap_ctx] (const blocked_range<size_t>& r)
+      {
+      std::vector<float> weight_x, dsq_x;
+      std::vector<unsigned int> index_x;
+      for (size_t idx = r.begin(); idx != r.end(); idx++)
+          {
+          int bin_x = int((points[idx].x + lx/2.0f)/grid_size_x);
+          fillAxisWeights(bin_x, bin_cut_x, grid_size_x, points[idx].x, lx/2.0f, wrap_ctx.L.x, wrap_ctx.Linv.x,
+                          m_width_x, A, sigmasq, weight_x, dsq_x, index_x);
+          std::copy(weight_x.begin(), weight_x.end(), l_weight_x + idx*n_x);
+          std::copy(dsq_x.begin(), dsq_x.end(), l_dsq_x + idx*n_x);
+          std::copy(index_x.begin(), index_x.end(), l_index_x + idx*n_x);
+          }
+      });
+
+    parallel_for(blocked_range<size_t>(0, num_rows),
+      [=, &cell_index, &lc, &wrap_ctx] (const blocked_range<size_t>& r)
+      {
+      std::vector<unsigned int> cells_y, cells_z;
+      for (size_t row_idx = r.begin(); row_idx != r.end(); row_idx++)
+          {
+          const int j = row_idx % m_width_y;
+          const int k = row_idx / m_width_y;
+          float *row = density + m_bi(0, j, k);
+          std::fill(row, row + m_width_x, 0.0f);
+
+          // the cells along y and z within one cell of the row
+          vec3<float> center(0.0f, grid_size_y*j + grid_size_y/2.0f - ly/2.0f,
+                             is2D ? 0.0f : grid_size_z*k + grid_size_z/2.0f - lz/2.0f);
+          vec3<unsigned int> c = lc.getCellCoord(center);
+          cells_y.clear();
+          cells_z.clear();
+          for (int d = -1; d <= 1; d++)
+              {
+              cells_y.push_back((c.y + d + cell_index.getH()) % cell_index.getH());
+              if (!is2D)
+                  cells_z.push_back((c.z + d + cell_index.getD()) % cell_index.getD());
+              }
+          if (is2D)
+              cells_z.push_back(0);
+          std::sort(cells_y.begin(), cells_y.end());
+          cells_y.erase(std::unique(cells_y.begin(), cells_y.end()), cells_y.end());
+          std::sort(cells_z.begin(), cells_z.end());
+          cells_z.erase(std::unique(cells_z.begin(), cells_z.end()), cells_z.end());
+
+          for (unsigned int cz = 0; cz < cells_z.size(); cz++)
+              for (unsigned int cy = 0; cy < cells_y.size(); cy++)
+                  {
+                  // the cells along x are consecutive, so that their points are a range of the sorted indices
+                  unsigned int first_cell = cell_index(0, cells_y[cy], cells_z[cz]);
+                  unsigned int end = cell_start[first_cell + cell_index.getW()];
+                  for (unsigned int n = cell_start[first_cell]; n < end; n++)
+                      {
+                      const unsigned int idx = cell_particles[n];
+                      const vec3<float> p = points[idx];
+                      int bin_y = int((p.y + ly/2.0f)/grid_size_y);
+                      int bin_z = is2D ? 0 : int((p.z + lz/2.0f)/grid_size_z);
+                      float w_y, w_z, dsq_y, dsq_z;
+                      if (!cellAxisWeight(bin_y, bin_cut_y, j, m_width_y, grid_size_y, p.y, ly/2.0f,
+                                          wrap_ctx.L.y, wrap_ctx.Linv.y, A, sigmasq, w_y, dsq_y) ||
+                          !cellAxisWeight(bin_z, bin_cut_z, k, is2D ? 1 : m_width_z, grid_size_z, p.z, lz/2.0f,
+                                          wrap_ctx.L.z, wrap_ctx.Linv.z, A, sigmasq, w_z, dsq_z))
+                          continue;
+                      // the rows entirely out of r_cut are skipped
+                      if (!(sqrtf(dsq_y + dsq_z) < m_rcut))
+                          continue;
+
+                      const float *w_x = l_weight_x + size_t(idx)*n_x;
+                      const float *d_x = l_dsq_x + size_t(idx)*n_x;
+                      const unsigned int *i_x = l_index_x + size_t(idx)*n_x;
+                      for (unsigned int i = 0; i < n_x; i++)
+                          {
+                          float rsqrt = sqrtf(d_x[i] + dsq_y + dsq_z);
+                          row[i_x[i]] += (rsqrt < m_rcut) ? w_x[i]*w_y*w_z : 0.0f;
+                          }
+                      }
+                  }
+          }
+      });
+    }
+
 //! internal
 /*! \brief Function to compute the density array
 */
 void GaussianDensity::compute(const box::Box &box, const vec3<float> *points, unsigned int Np)
     {
+    util::ScopedRange annotation("freud::GaussianDensity::compute");
     resetDensity();
+    // a density of a previous compute still on the GPU is replaced
+    m_gpu_pending = false;
     m_box = box;
     if (m_box.is2D())
         {
@@ -121,95 +672,356 @@ void GaussianDensity::compute(const box::Box &box, const vec3<float> *points, un
         m_bi = Index3D(m_width_x, m_width_y, m_width_z);
         }
     // this does not agree with rest of freud
-    m_Density_array = std::shared_ptr<float>(new float[m_bi.getNumElements()], std::default_delete<float[]>());
-    parallel_for(blocked_range<size_t>(0,Np),
+    m_Density_array = util::makeLargeArray<float>(m_bi.getNumElements());
+    m_coarse_density.clear();
+    const unsigned int num_planes = m_box.is2D() ? m_width_y : m_width_z;
+
+    if (m_gpu)
+        {
+        // the grid is copied back by getDensity()
+        m_gpu->spreadGaussians(m_box, points, Np, m_width_x, m_width_y, m_width_z, m_rcut, m_sigma);
+        m_gpu_pending = true;
+        m_direct = false;
+        m_gathered = false;
+        m_reduce = true;
+        return;
+        }
+
+    m_gathered = useGather(Np);
+    if (m_gathered)
+        {
+        gatherPoints(points, Np);
+        m_direct = true;
+        m_reduce = false;
+        return;
+        }
+
+    const size_t grid_bytes = size_t(m_bi.getNumElements())*sizeof(float);
+    m_direct = m_bi.getNumElements() >= TILED_GRID_SIZE || util::exceedsMemoryLimit(grid_bytes, m_memory_limit);
+    if (!m_direct)
+        {
+        parallel_for(blocked_range<size_t>(0,Np),
+          [=] (const blocked_range<size_t>& r)
+          {
+          assert(points);
+          assert(Np > 0);
+
+          bool exists;
+          m_local_bin_counts.local(exists);
+          if (! exists)
+              {
+              m_local_bin_counts.local() = util::allocateLocalHistogram<float>(m_bi.getNumElements());
+              }
+          spreadPoints(points, NULL, r.begin(), r.end(), m_local_bin_counts.local(), 0, num_planes);
+          });
+        // flag to reduce
+        m_reduce = true;
+        return;
+        }
+
+    // large grids are not copied per thread: each task owns a tile of planes along the slowest axis of the grid
+    // and spreads onto it, straight in the density array, every point whose Gaussian reaches the tile
+    util::freeLocalHistograms(m_local_bin_counts);
+    memset((void*)m_Density_array.get(), 0, sizeof(float)*m_bi.getNumElements());
+
+    float plane_size = m_box.is2D() ? m_box.getLy()/m_width_y : m_box.getLz()/m_width_z;
+    float plane_offset = m_box.is2D() ? m_box.getLy()/2.0f : m_box.getLz()/2.0f;
+    int bin_cut = int(m_rcut/plane_size);
+    // tiles at least as thick as the range of planes of a Gaussian, so that a point reaches at most two of them
+    unsigned int tile_size = std::min(std::max(num_planes / MAX_NUM_TILES, unsigned(2*bin_cut + 1)), num_planes);
+    unsigned int num_tiles = (num_planes + tile_size - 1) / tile_size;
+
+    std::vector<std::vector<unsigned int> > tile_points(num_tiles);
+    std::vector<unsigned int> tiles;
+    for (unsigned int idx = 0; idx < Np; idx++)
+        {
+        float pos = m_box.is2D() ? points[idx].y : points[idx].z;
+        int bin = int((pos + plane_offset)/plane_size);
+        tiles.clear();
+        if (2*bin_cut + 1 >= int(num_planes))
+            {
+            for (unsigned int t = 0; t < num_tiles; t++)
+                tiles.push_back(t);
+            }
+        else
+            {
+            for (int k = bin - bin_cut; k <= bin + bin_cut; k++)
+                tiles.push_back(((k + num_planes) % num_planes) / tile_size);
+            std::sort(tiles.begin(), tiles.end());
+            tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+            }
+        for (unsigned int t = 0; t < tiles.size(); t++)
+            tile_points[tiles[t]].push_back(idx);
+        }
+
+    float *density = m_Density_array.get();
+    const std::vector<unsigned int> *l_tile_points = &tile_points[0];
+    parallel_for(blocked_range<size_t>(0, num_tiles, 1),
       [=] (const blocked_range<size_t>& r)
       {
-      assert(points);
-      assert(Np > 0);
-
-      bool exists;
-      m_local_bin_counts.local(exists);
-      if (! exists)
+      for (size_t t = r.begin(); t != r.end(); t++)
           {
-          m_local_bin_counts.local() = new float [m_bi.getNumElements()];
-          memset((void*)m_local_bin_counts.local(), 0, sizeof(float)*m_bi.getNumElements());
+          const std::vector<unsigned int>& list = l_tile_points[t];
+          if (list.empty())
+              continue;
+          unsigned int plane_begin = t*tile_size;
+          unsigned int plane_end = std::min(plane_begin + tile_size, num_planes);
+          spreadPoints(points, &list[0], 0, list.size(), density, plane_begin, plane_end);
           }
+      });
+    m_reduce = false;
+  }
 
-      // set up some constants first
-      float lx = m_box.getLx();
-      float ly = m_box.getLy();
-      float lz = m_box.getLz();
+//! internal
+/*! \brief Function to compute the density integrated along z over a slab
+*/
+void GaussianDensity::computeProjection(const box::Box &box, const vec3<float> *points, unsigned int Np,
+                                        float z_min, float z_max)
+    {
+    util::ScopedRange annotation("freud::GaussianDensity::computeProjection");
+    if (box.is2D())
+        throw invalid_argument("computeProjection needs a 3D box");
+    if (box.getWrapContext().tilted)
+        throw invalid_argument("computeProjection needs a box without tilt");
+    if (!(z_min < z_max))
+        throw invalid_argument("z_max must be greater than z_min");
 
-      float grid_size_x = lx/m_width_x;
-      float grid_size_y = ly/m_width_y;
-      float grid_size_z = lz/m_width_z;
+    const unsigned int num_cells = m_width_x*m_width_y;
+    for (tbb::enumerable_thread_specific<float *>::iterator i = m_local_projection.begin();
+         i != m_local_projection.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(float)*num_cells);
+        }
+
+    const float lx = box.getLx();
+    const float ly = box.getLy();
+    const float lz = box.getLz();
+    const float grid_size_x = lx/m_width_x;
+    const float grid_size_y = ly/m_width_y;
+    const int bin_cut_x = int(m_rcut/grid_size_x);
+    const int bin_cut_y = int(m_rcut/grid_size_y);
+    const float sigmasq = m_sigma*m_sigma;
+    const float A = sqrt(1.0f/(2.0f*M_PI*sigmasq));
+    const float rcutsq = m_rcut*m_rcut;
+    const float erf_scale = 1.0f/(m_sigma*sqrtf(2.0f));
+    const box::WrapContext wrap_ctx = box.getWrapContext();
+    // a slab of the whole periodic box integrates the whole Gaussian, cut off at r_cut
+    const bool whole = wrap_ctx.L.z != 0.0f && z_max - z_min >= lz;
+    // the images of a point along z, from the nearest one above z_min, that can reach the slab
+    const int first_image = (wrap_ctx.L.z != 0.0f) ? -int(ceilf(m_rcut/lz)) : 0;
+    const int last_image = (wrap_ctx.L.z != 0.0f) ? int(ceilf((z_max - z_min + m_rcut)/lz)) : 0;
 
-      float sigmasq = m_sigma*m_sigma;
-      float A = sqrt(1.0f/(2.0f*M_PI*sigmasq));
+    parallel_for(blocked_range<size_t>(0,Np),
+      [=] (const blocked_range<size_t>& r)
+      {
+      bool exists;
+      m_local_projection.local(exists);
+      if (! exists)
+          {
+          m_local_projection.local() = util::allocateLocalHistogram<float>(num_cells);
+          }
+      float *local_bins = m_local_projection.local();
+      std::vector<float> weight_x, weight_y, dsq_x, dsq_y;
+      std::vector<unsigned int> index_x, index_y;
 
-      // for each reference point
       for (size_t idx = r.begin(); idx != r.end(); idx++)
           {
-          // find the distance of that particle to bins
-          // will use this information to evaluate the Gaussian
-          // Find the which bin the particle is in
           int bin_x = int((points[idx].x+lx/2.0f)/grid_size_x);
           int bin_y = int((points[idx].y+ly/2.0f)/grid_size_y);
-          int bin_z = int((points[idx].z+lz/2.0f)/grid_size_z);
-
-          // Find the number of bins within r_cut
-          int bin_cut_x = int(m_rcut/grid_size_x);
-          int bin_cut_y = int(m_rcut/grid_size_y);
-          int bin_cut_z = int(m_rcut/grid_size_z);
+          fillAxisWeights(bin_x, bin_cut_x, grid_size_x, points[idx].x, lx/2.0f, wrap_ctx.L.x, wrap_ctx.Linv.x,
+                          m_width_x, A, sigmasq, weight_x, dsq_x, index_x);
+          fillAxisWeights(bin_y, bin_cut_y, grid_size_y, points[idx].y, ly/2.0f, wrap_ctx.L.y, wrap_ctx.Linv.y,
+                          m_width_y, A, sigmasq, weight_y, dsq_y, index_y);
+          // the nearest image of the point above z_min
+          float z = points[idx].z;
+          if (wrap_ctx.L.z != 0.0f)
+              z -= lz*floorf((z - z_min)/lz);
 
-          // in 2D, only loop over the 0 z plane
-          if (m_box.is2D())
+          for (unsigned int j = 0; j < weight_y.size(); j++)
               {
-              bin_z = 0;
-              bin_cut_z = 0;
-              grid_size_z = 0;
-              }
-          // Only evaluate over bins that are within the cut off to reduce the number of computations
-          for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
-              {
-              float dz = float((grid_size_z*k + grid_size_z/2.0f) - points[idx].z - lz/2.0f);
-
-              for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
+              if (!(dsq_y[j] < rcutsq))
+                  continue;
+              float *row = local_bins + index_y[j]*m_width_x;
+              for (unsigned int i = 0; i < weight_x.size(); i++)
                   {
-                  float dy = float((grid_size_y*j + grid_size_y/2.0f) - points[idx].y - ly/2.0f);
-
-                  for (int i = bin_x - bin_cut_x; i<= bin_x + bin_cut_x; i++)
+                  float dsq = dsq_x[i] + dsq_y[j];
+                  if (!(dsq < rcutsq))
+                      continue;
+                  // the Gaussian along the line of the cell is cut off at |dz| < h
+                  float h = sqrtf(rcutsq - dsq);
+                  float integral;
+                  if (whole)
+                      integral = erff(h*erf_scale);
+                  else
                       {
-                      // calculate the distance from the grid cell to particular particle
-                      float dx = float((grid_size_x*i + grid_size_x/2.0f) - points[idx].x - lx/2.0f);
-                      vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
+                      integral = 0.0f;
+                      for (int n = first_image; n <= last_image; n++)
+                          {
+                          float z_n = z + float(n)*lz;
+                          float a = std::max(z_min - z_n, -h);
+                          float b = std::min(z_max - z_n, h);
+                          if (a < b)
+                              integral += 0.5f*(erff(b*erf_scale) - erff(a*erf_scale));
+                          }
+                      }
+                  row[index_x[i]] += weight_x[i]*weight_y[j]*integral;
+                  }
+              }
+          }
+      });
 
-                      float rsq = dot(delta, delta);
-                      float rsqrt = sqrtf(rsq);
+    m_projection_array = util::makeLargeArray<float>(num_cells);
+    util::reduceLocalHistograms(m_local_projection, m_projection_array.get(), num_cells);
+    }
 
-                      // check to see if this distance is within the specified r_cut
-                      if (rsqrt < m_rcut)
-                          {
-                          // evaluate the gaussian ...
+//! \internal
+/*! \brief Fourier transform of the periodic 1D Gaussian on the grid along one axis, over that of the cloud in cell
+    assignment
 
-                          float x_gaussian = A*exp((-1.0f)*(delta.x*delta.x)/(2.0f*sigmasq));
-                          float y_gaussian = A*exp((-1.0f)*(delta.y*delta.y)/(2.0f*sigmasq));
-                          float z_gaussian = A*exp((-1.0f)*(delta.z*delta.z)/(2.0f*sigmasq));
+    \param width number of grid cells along the axis, 1 for the 2D z axis
+    \param grid_size width of a grid cell along the axis
+    \param A normalization of the 1D Gaussian
+    \param sigmasq variance of the Gaussian
+    \param dz for the 2D z axis, the distance of the particles to the grid plane, as in compute()
+*/
+static std::vector<std::complex<double> > axisKernel(unsigned int width, float grid_size, float A, float sigmasq,
+                                                     float dz)
+    {
+    std::vector<std::complex<double> > kernel(width);
+    if (width == 1)
+        {
+        kernel[0] = A*exp((-1.0f)*(dz*dz)/(2.0f*sigmasq));
+        return kernel;
+        }
+    for (unsigned int i = 0; i < width; i++)
+        {
+        // minimum image of the displacement of i cells
+        int n = (i <= width/2) ? int(i) : int(i) - int(width);
+        double d = double(n)*grid_size;
+        kernel[i] = A*exp((-1.0)*(d*d)/(2.0*sigmasq));
+        }
+    util::fft1D(&kernel[0], width, false);
+    for (unsigned int i = 0; i < width; i++)
+        {
+        int n = (i <= width/2) ? int(i) : int(i) - int(width);
+        // the cloud in cell assignment is the convolution with a triangle of one cell on each side
+        double x = M_PI*double(n)/double(width);
+        double window = (n == 0) ? 1.0 : (sin(x)/x)*(sin(x)/x);
+        kernel[i] /= window;
+        }
+    return kernel;
+    }
 
-                          // Assure that out of range indices are corrected for storage in the array
-                          // i.e. bin -1 is actually bin 29 for nbins = 30
-                          unsigned int ni = (i + m_width_x) % m_width_x;
-                          unsigned int nj = (j + m_width_y) % m_width_y;
-                          unsigned int nk = (k + m_width_z) % m_width_z;
+//! internal
+/*! \brief Function to compute the density array by particle-mesh convolution
+*/
+void GaussianDensity::computeFFT(const box::Box &box, const vec3<float> *points, unsigned int Np)
+    {
+    util::ScopedRange annotation("freud::GaussianDensity::computeFFT");
+    if (box.getWrapContext().tilted)
+        throw invalid_argument("computeFFT needs a box without tilt");
+    if (!util::isPowerOfTwo(m_width_x) || !util::isPowerOfTwo(m_width_y) ||
+        (!box.is2D() && !util::isPowerOfTwo(m_width_z)))
+        throw invalid_argument("computeFFT needs widths that are powers of two");
 
-                          // store the product of these values in an array - n[i, j, k] = gx*gy*gz
-                          m_local_bin_counts.local()[m_bi(ni, nj, nk)] += x_gaussian*y_gaussian*z_gaussian;
-                          }
+    // deposit the particles with cloud in cell weights on the grid cell centers
+    resetDensity();
+    m_gpu_pending = false;
+    m_direct = false;
+    m_gathered = false;
+    m_box = box;
+    const bool is2D = m_box.is2D();
+    m_bi = Index3D(m_width_x, m_width_y, is2D ? 1 : m_width_z);
+    m_Density_array = util::makeLargeArray<float>(m_bi.getNumElements());
+    m_coarse_density.clear();
+    float lx = m_box.getLx();
+    float ly = m_box.getLy();
+    float lz = m_box.getLz();
+    float grid_size_x = lx/m_width_x;
+    float grid_size_y = ly/m_width_y;
+    float grid_size_z = lz/m_width_z;
+    parallel_for(blocked_range<size_t>(0,Np),
+      [=] (const blocked_range<size_t>& r)
+      {
+      bool exists;
+      m_local_bin_counts.local(exists);
+      if (! exists)
+          {
+          m_local_bin_counts.local() = util::allocateLocalHistogram<float>(m_bi.getNumElements());
+          }
+      float *local_bins = m_local_bin_counts.local();
+      const int w = m_bi.getW();
+      const int h = m_bi.getH();
+      const int d = m_bi.getD();
+
+      for (size_t idx = r.begin(); idx != r.end(); idx++)
+          {
+          // position in units of grid cells relative to the center of the first cell
+          float ux = (points[idx].x+lx/2.0f)/grid_size_x - 0.5f;
+          float uy = (points[idx].y+ly/2.0f)/grid_size_y - 0.5f;
+          float uz = is2D ? 0.0f : (points[idx].z+lz/2.0f)/grid_size_z - 0.5f;
+          int ix = int(floorf(ux));
+          int iy = int(floorf(uy));
+          int iz = int(floorf(uz));
+          float tx = ux - ix;
+          float ty = uy - iy;
+          float tz = uz - iz;
+          const float wx[2] = {1.0f - tx, tx};
+          const float wy[2] = {1.0f - ty, ty};
+          const float wz[2] = {1.0f - tz, tz};
+          for (int k = 0; k < (is2D ? 1 : 2); k++)
+              {
+              unsigned int nk = (((iz + k) % d) + d) % d;
+              for (int j = 0; j < 2; j++)
+                  {
+                  unsigned int nj = (((iy + j) % h) + h) % h;
+                  for (int i = 0; i < 2; i++)
+                      {
+                      unsigned int ni = (((ix + i) % w) + w) % w;
+                      local_bins[m_bi(ni, nj, nk)] += wx[i]*wy[j]*(is2D ? 1.0f : wz[k]);
                       }
                   }
               }
           }
       });
-  }
+    reduceDensity();
+
+    // convolve with the Gaussian, which factorizes along x, y and z in Fourier space too
+    const unsigned int num_cells = m_bi.getNumElements();
+    std::vector<std::complex<double> > grid(m_Density_array.get(), m_Density_array.get() + num_cells);
+    util::fft3D(&grid[0], m_bi.getW(), m_bi.getH(), m_bi.getD(), false);
+
+    float sigmasq = m_sigma*m_sigma;
+    float A = sqrt(1.0f/(2.0f*M_PI*sigmasq));
+    std::vector<std::complex<double> > kernel_x = axisKernel(m_bi.getW(), grid_size_x, A, sigmasq, 0.0f);
+    std::vector<std::complex<double> > kernel_y = axisKernel(m_bi.getH(), grid_size_y, A, sigmasq, 0.0f);
+    // in 2D the points are a distance lz/2 from the 0 z plane of the grid, as in compute()
+    std::vector<std::complex<double> > kernel_z = axisKernel(m_bi.getD(), grid_size_z, A, sigmasq,
+                                                             is2D ? lz/2.0f : 0.0f);
+    std::complex<double> *l_grid = &grid[0];
+    const std::complex<double> *k_x = &kernel_x[0];
+    const std::complex<double> *k_y = &kernel_y[0];
+    const std::complex<double> *k_z = &kernel_z[0];
+    const Index3D bi = m_bi;
+    parallel_for(blocked_range<size_t>(0, bi.getH()*bi.getD()),
+      [=] (const blocked_range<size_t>& r)
+      {
+      for (size_t row = r.begin(); row != r.end(); row++)
+          {
+          unsigned int j = row % bi.getH();
+          unsigned int k = row / bi.getH();
+          std::complex<double> k_yz = k_y[j]*k_z[k]/double(num_cells);
+          std::complex<double> *line = l_grid + bi(0, j, k);
+          for (unsigned int i = 0; i < bi.getW(); i++)
+              line[i] *= k_x[i]*k_yz;
+          }
+      });
+    util::fft3D(&grid[0], m_bi.getW(), m_bi.getH(), m_bi.getD(), true);
+
+    float *density = m_Density_array.get();
+    for (unsigned int c = 0; c < num_cells; c++)
+        density[c] = float(grid[c].real());
+    m_reduce = false;
+    }
+
 }; }; // end namespace freud::density
@@ -8,13 +8,19 @@
 #include <Python.h>
 #define __APPLE__
 
+#include <map>
 #include <memory>
+#include <string>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "box.h"
 #include "Index1D.h"
+#include "HistogramReduction.h"
+#include "MemoryUsage.h"
+#include "DensityGPU.h"
+#include "LinkCell.h"
 
 #ifndef _GaussianDensity_H__
 #define _GaussianDensity_H__
@@ -25,14 +31,46 @@
 
 namespace freud { namespace density {
 
+//! How GaussianDensity::compute() evaluates the Gaussians on the grid
+enum SpreadMode
+    {
+    SPREAD_AUTO,        //!< Gather sparse points onto grids that would be copied per thread, scatter otherwise
+    SPREAD_SCATTER,     //!< Spread the Gaussian of each point onto the grid
+    SPREAD_GATHER       //!< Gather the points reaching each row of the grid from a cell list
+    };
+
 //! Computes the the density of a system on a grid.
 /*! Replaces particle positions with a gaussian and calculates the
         contribution from the grid based upon the the distance of the grid cell
         from the center of the Gaussian.
+
+    computeFFT() gives the same density for a cost of O(N + M log M) on M grid cells whatever sigma is: the
+    particles are deposited on the grid with cloud in cell weights, and the grid is convolved with the periodic
+    Gaussian, divided by the transform of the cloud in cell assignment, in Fourier space. The Gaussian is not cut off
+    at r_cut there, and the widths must be powers of two.
+
+    A per-thread copy of a large grid would need more memory than the grid itself times the number of threads.
+    compute() therefore splits grids of TILED_GRID_SIZE cells or more into tiles of planes along z (y in 2D), and
+    bins the points by the tiles their Gaussians reach. Each tile is then spread by a single task straight into the
+    density array.
+
+    Sparse systems, whose Gaussians cover fewer cells than the grid has, are gathered instead when the grid would be
+    copied per thread: each task owns rows of the grid along x, finds the points whose Gaussians reach them from a
+    LinkCell of width r_cut, and writes the rows straight into the density array, so that the per-thread copies are
+    neither cleared nor reduced (see setSpreadMode). The same weights are added as by the scatter, in another order.
+
+    Smaller grids are also spread onto tiles when their per-thread copies would exceed the memory limit (see
+    setMemoryLimit).
 */
 class GaussianDensity
     {
     public:
+        //! Number of grid cells from which compute() spreads onto tiles of the grid instead of per-thread copies
+        static const unsigned int TILED_GRID_SIZE = 1 << 22;
+
+        //! Largest number of tiles of a tiled grid
+        static const unsigned int MAX_NUM_TILES = 256;
+
         //! Constructor
         GaussianDensity(unsigned int width,
                         float r_cut,
@@ -62,9 +100,112 @@ class GaussianDensity
         //! Compute the Density
         void compute(const box::Box& box, const vec3<float> *points, unsigned int Np);
 
+        //! Set whether compute() spreads the Gaussians on a CUDA GPU
+        /*! The density is then copied back to the host in the background, and getDensity() waits for it, so the
+            next frame can be read while the GPU works. computeFFT() is always run on the CPU.
+
+            Throws std::runtime_error if freud was built without CUDA or no device is found.
+        */
+        void setUseGPU(bool use_gpu);
+
+        //! Get whether compute() spreads the Gaussians on the GPU
+        bool getUseGPU() const
+            {
+            return bool(m_gpu);
+            }
+
+        //! Set how compute() evaluates the Gaussians on the grid
+        /*! Gathering needs a periodic orthorhombic box of at least 2 r_cut along each axis, and a grid in which the
+            cells reached by a Gaussian along each axis are fewer than the width of the grid; compute() throws
+            std::invalid_argument otherwise when SPREAD_GATHER is asked for, and SPREAD_AUTO scatters then.
+        */
+        void setSpreadMode(SpreadMode mode)
+            {
+            m_spread_mode = mode;
+            }
+
+        //! Get how compute() evaluates the Gaussians on the grid
+        SpreadMode getSpreadMode() const
+            {
+            return m_spread_mode;
+            }
+
+        //! Get whether the last compute() gathered the points from a cell list
+        bool getGathered() const
+            {
+            return m_gathered;
+            }
+
+        //! Set the most bytes the per-thread copies of the grid of compute() may take together, 0 for no limit
+        //! (the default)
+        /*! A grid whose copies would exceed the limit, with the number of threads of the frame, is spread onto
+            tiles of planes straight in the density array instead, as grids of TILED_GRID_SIZE cells or more are.
+        */
+        void setMemoryLimit(size_t bytes)
+            {
+            m_memory_limit = bytes;
+            }
+
+        //! Get the most bytes the per-thread copies of the grid may take together
+        size_t getMemoryLimit() const
+            {
+            return m_memory_limit;
+            }
+
+        //! Get the bytes allocated by each component: density (the density, its coarse grids and the projection),
+        //! local_grids (the copies of the threads) and cell_list (of the gathered points)
+        util::MemoryUsage getMemoryUsage() const;
+
+        //! Estimate the bytes of each component after compute() of N points of a 3D box on num_threads threads, 0 for
+        //! those of the current task arena
+        /*! The cell list is counted when the spread mode is SPREAD_GATHER, since SPREAD_AUTO only gathers some
+            systems.
+        */
+        util::MemoryUsage estimateMemory(unsigned int N, unsigned int num_threads) const;
+
+        //! Compute the Density by particle-mesh convolution with fast Fourier transforms
+        void computeFFT(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Compute the density integrated along z over the slab [z_min, z_max), on a width_x x width_y grid
+        /*! The Gaussians are integrated analytically along z, with the error function, so no 3D grid is built: the
+            cost and memory are those of a 2D density. The projection of a cell is the integral of the density
+            along the z line through its center, which the sum of the planes of compute() times their spacing
+            approaches for fine planes. A slab of the whole box or more projects all of it; otherwise the periodic
+            images of the points along z are integrated over the slab. The Gaussians are cut off at r_cut in 3D
+            as in compute().
+
+            Needs a 3D box without tilt. The density of compute() is left as it is.
+        */
+        void computeProjection(const box::Box& box, const vec3<float> *points, unsigned int Np,
+                               float z_min, float z_max);
+
+        //! Get a reference to the last computed projection, width_x x width_y
+        std::shared_ptr<float> getProjection()
+            {
+            return m_projection_array;
+            }
+
         //!Get a reference to the last computed Density
         std::shared_ptr<float> getDensity();
 
+        //! Get the last computed density averaged over blocks of factor cells along each axis of the grid
+        /*! The widths of the grid must be multiples of \a factor, along x and y only in 2D. A coarse grid is derived
+            once per density, by restriction in parallel over its planes, from the coarsest grid already derived whose
+            factor divides \a factor, or else from the density itself. Asking for the factors 2, 4, 8... in turn
+            thus builds a pyramid in which each level reads only the level below it, instead of spreading the
+            Gaussians again on each grid.
+        */
+        std::shared_ptr<float> getCoarseDensity(unsigned int factor);
+
+        //! Save the last computed density and its box to a checkpoint file
+        void saveState(const std::string& filename);
+
+        //! Restore the density of a checkpoint file, or add it to the current density if merge
+        /*! The grid and the Gaussian must be the same. Merging sums the densities of grids of the same size, such as
+            those of the chunks of a trajectory, and keeps the box of this object.
+        */
+        void loadState(const std::string& filename, bool merge=false);
+
         unsigned int getWidthX();
 
         unsigned int getWidthY();
@@ -72,15 +213,36 @@ class GaussianDensity
         unsigned int getWidthZ();
 
     private:
+        //! Spread the Gaussians of some of the points onto a tile of planes of the grid
+        void spreadPoints(const vec3<float> *points, const unsigned int *point_list, size_t begin, size_t end,
+                          float *bins, unsigned int plane_begin, unsigned int plane_end) const;
+
+        //! Whether compute() may gather Np points, and whether it should for the spread mode
+        bool useGather(unsigned int Np) const;
+
+        //! Write the rows of the density array from the points whose Gaussians reach them
+        void gatherPoints(const vec3<float> *points, unsigned int Np);
+
         box::Box m_box;    //!< Simulation box the particles belong in
         unsigned int m_width_x,m_width_y,m_width_z;           //!< Num of bins on one side of the cube
         float m_rcut;                  //!< Max r at which to compute density
         float m_sigma;                  //!< Variance
         Index3D m_bi;                   //!< Bin indexer
         unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
+        bool m_direct;                      //!< true when the last compute wrote straight into the density array
+        bool m_gathered;                    //!< true when the last compute gathered the points
+        SpreadMode m_spread_mode;           //!< How compute() evaluates the Gaussians on the grid
+        size_t m_memory_limit;              //!< Most bytes of the per-thread copies of the grid, or 0
+        locality::LinkCell m_lc;            //!< Cell list of the points gathered
+        bool m_gpu_pending;                 //!< true when the density of the last compute is still on the GPU
+        std::shared_ptr<gpu::DensityGPU> m_gpu;     //!< Spreader of the Gaussians on the GPU, when it is used
 
         std::shared_ptr<float> m_Density_array;            //! computed density array
+        std::map<unsigned int, std::shared_ptr<float> > m_coarse_density;  //!< Coarse grids of the density, by factor
+        std::shared_ptr<float> m_projection_array;         //!< computed projection along z
         tbb::enumerable_thread_specific<float *> m_local_bin_counts;
+        tbb::enumerable_thread_specific<float *> m_local_projection;   //!< Per-thread grids of the projection
     };
 
 }; }; // end namespace freud::density
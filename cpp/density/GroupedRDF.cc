@@ -0,0 +1,224 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "GroupedRDF.h"
+#include "Annotation.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file GroupedRDF.cc
+    \brief Routines for computing the radial density functions of groups of reference points
+*/
+
+namespace freud { namespace density {
+
+GroupedRDF::GroupedRDF(float rmax, float dr, unsigned int n_groups)
+    : m_box(box::Box()), m_rmax(rmax), m_n_groups(n_groups), m_lc(box::Box(), rmax), m_frame_counter(0),
+      m_reduce(true), m_bi(0)
+    {
+    if (dr <= 0.0f)
+        throw invalid_argument("dr must be positive");
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    if (dr > rmax)
+        throw invalid_argument("rmax must be greater than dr");
+    if (n_groups < 1)
+        throw invalid_argument("must be at least 1 group");
+
+    m_bin_edges = util::BinEdges(rmax, dr);
+    m_nbins = m_bin_edges.getNBins();
+    assert(m_nbins > 0);
+    m_bi = Index2D(m_nbins, m_n_groups);
+    m_group_refs.resize(m_n_groups, 0.0);
+    m_group_norm.resize(m_n_groups, 0.0);
+
+    m_rdf_array = std::shared_ptr<float>(new float[m_bi.getNumElements()], std::default_delete<float[]>());
+    memset((void*)m_rdf_array.get(), 0, sizeof(float)*m_bi.getNumElements());
+    m_bin_counts = std::shared_ptr<util::BinCount>(new util::BinCount[m_bi.getNumElements()],
+                                                   std::default_delete<util::BinCount[]>());
+    memset((void*)m_bin_counts.get(), 0, sizeof(util::BinCount)*m_bi.getNumElements());
+    m_N_r_array = std::shared_ptr<float>(new float[m_bi.getNumElements()], std::default_delete<float[]>());
+    memset((void*)m_N_r_array.get(), 0, sizeof(float)*m_bi.getNumElements());
+
+    // precompute the bin center positions
+    m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float r = float(i) * dr;
+        float nextr = float(i+1) * dr;
+        m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
+        }
+
+    // precompute cell volumes
+    m_vol_array2D = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    m_vol_array3D = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float r = float(i) * dr;
+        float nextr = float(i+1) * dr;
+        m_vol_array2D.get()[i] = M_PI * (nextr*nextr - r*r);
+        m_vol_array3D.get()[i] = 4.0f / 3.0f * M_PI * (nextr*nextr*nextr - r*r*r);
+        }
+    }
+
+GroupedRDF::~GroupedRDF()
+    {
+    util::freeLocalHistograms(m_local_bin_counts);
+    }
+
+//! \internal
+//! reduce the thread local histograms into the per group bin counts, rdfs and N(r)
+void GroupedRDF::reduceGroupedRDF()
+    {
+    util::reduceLocalHistograms(m_local_bin_counts, m_bin_counts.get(), m_bi.getNumElements());
+    const float *vol_array = m_box.is2D() ? m_vol_array2D.get() : m_vol_array3D.get();
+
+    parallel_for(blocked_range<size_t>(0, m_n_groups),
+      [=] (const blocked_range<size_t>& r)
+      {
+      for (size_t g = r.begin(); g != r.end(); g++)
+          {
+          double refs = m_group_refs[g];
+          double norm = m_group_norm[g];
+          float *rdf = m_rdf_array.get() + g*m_nbins;
+          float *N_r = m_N_r_array.get() + g*m_nbins;
+          const util::BinCount *counts = m_bin_counts.get() + g*m_nbins;
+
+          // the first bin holds the distance of each point to itself when the reference points are points
+          rdf[0] = 0.0f;
+          N_r[0] = 0.0f;
+          double sum = 0.0;
+          for (unsigned int i = 1; i < m_nbins; i++)
+              {
+              rdf[i] = (norm > 0.0) ? float(double(counts[i]) / norm / vol_array[i]) : 0.0f;
+              sum += (refs > 0.0) ? double(counts[i]) / refs : 0.0;
+              N_r[i] = float(sum);
+              }
+          }
+      });
+    }
+
+//! Get a reference to the rdf array
+std::shared_ptr<float> GroupedRDF::getRDF()
+    {
+    if (m_reduce == true)
+        {
+        reduceGroupedRDF();
+        }
+    m_reduce = false;
+    return m_rdf_array;
+    }
+
+//! Get a reference to the cumulative counts array
+std::shared_ptr<float> GroupedRDF::getNr()
+    {
+    if (m_reduce == true)
+        {
+        reduceGroupedRDF();
+        }
+    m_reduce = false;
+    return m_N_r_array;
+    }
+
+//! \internal
+/*! \brief Function to reset the histograms if needed e.g. calculating a new set of frames
+*/
+void GroupedRDF::resetGroupedRDF()
+    {
+    for (tbb::enumerable_thread_specific<util::BinCount *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(util::BinCount)*m_bi.getNumElements());
+        }
+    std::fill(m_group_refs.begin(), m_group_refs.end(), 0.0);
+    std::fill(m_group_norm.begin(), m_group_norm.end(), 0.0);
+    // reset the frame counter
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Function to accumulate the pairs of a frame to the histograms in memory
+
+    The reference points are visited in the order of their cells, so that consecutive reference points of a task
+    share their neighbor cells whatever their groups, and the pairs are binned in the histogram of the group of the
+    reference point.
+*/
+void GroupedRDF::accumulate(box::Box& box,
+                            const vec3<float> *ref_points,
+                            const unsigned int *ref_groups,
+                            unsigned int n_ref,
+                            const vec3<float> *points,
+                            unsigned int Np)
+    {
+    util::ScopedRange annotation("freud::GroupedRDF::accumulate");
+    // count the reference points of each group
+    std::vector<unsigned int> group_counts(m_n_groups, 0);
+    for (unsigned int i = 0; i < n_ref; i++)
+        {
+        if (ref_groups[i] >= m_n_groups)
+            throw invalid_argument("groups must be smaller than n_groups");
+        group_counts[ref_groups[i]]++;
+        }
+
+    m_box = box;
+    m_lc.compute(m_box, points, Np, true);
+    const locality::LinkCell *lc = m_lc.get();
+    const vec3<float> *sorted_points = lc->getSortedPoints().get();
+    const unsigned int *cell_start = lc->getCellStart().get();
+    const unsigned int *order = NULL;
+    if (n_ref >= locality::CELL_ORDER_MIN_POINTS)
+        order = m_work_partition.orderByCell(*lc, ref_points, n_ref, points, Np);
+
+    parallel_for(blocked_range<size_t>(0, n_ref),
+      [=] (const blocked_range<size_t>& r)
+      {
+      float rmaxsq = m_rmax * m_rmax;
+
+      bool exists;
+      m_local_bin_counts.local(exists);
+      if (! exists)
+          {
+          m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_bi.getNumElements());
+          }
+      util::BinCount *local_bins = m_local_bin_counts.local();
+      Index2D b_i = m_bi;
+      locality::DistanceKernel kernel(box);
+
+      for (size_t pos = r.begin(); pos != r.end(); pos++)
+          {
+          size_t i = (order != NULL) ? order[pos] : pos;
+          util::BinCount *group_bins = local_bins + b_i(0, ref_groups[i]);
+          vec3<float> ref = ref_points[i];
+
+          // loop over all neighboring cells
+          const locality::CellNeighbors& neigh_cells = lc->getCellNeighbors(lc->getCell(ref));
+          for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+              {
+              unsigned int neigh_cell = neigh_cells[neigh_idx];
+              unsigned int begin = cell_start[neigh_cell];
+              kernel.forEachWithin(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin, rmaxsq,
+                  [&] (unsigned int, const vec3<float>&, float rsq)
+                  {
+                  unsigned int bin = m_bin_edges.getBin(sqrtf(rsq));
+                  if (bin < m_nbins)
+                      ++group_bins[bin];
+                  });
+              }
+          }
+      });
+
+    const double ndens = double(Np) / m_box.getVolume();
+    for (unsigned int g = 0; g < m_n_groups; g++)
+        {
+        m_group_refs[g] += group_counts[g];
+        m_group_norm[g] += group_counts[g] * ndens;
+        }
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::density
@@ -0,0 +1,142 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <ostream>
+
+// work around nasty issue where python #defines isalpha, toupper, etc....
+#undef __APPLE__
+#include <Python.h>
+#define __APPLE__
+
+#include <memory>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "LinkCell.h"
+#include "SharedLinkCell.h"
+#include "WorkPartition.h"
+#include "box.h"
+#include "Index1D.h"
+#include "BinCount.h"
+#include "BinEdges.h"
+#include "HistogramReduction.h"
+
+#ifndef _GROUPED_RDF_H__
+#define _GROUPED_RDF_H__
+
+/*! \file GroupedRDF.h
+    \brief Routines for computing the radial density functions of groups of reference points
+*/
+
+namespace freud { namespace density {
+
+//! Computes one RDF per group of reference points among the same points
+/*! Each reference point carries a group label in [0, n_groups), such as its cluster, layer or type. A single
+    traversal of the cell list of the points bins the pairs of every reference point in the histogram of its group,
+    instead of one RDF computation, and one cell list over the same points, per group.
+
+    g_g(r) is normalized like the RDF of the reference points of group g among the points. The groups may change
+    from frame to frame: the normalization sums the number of reference points of each group times the number
+    density of the points over the frames, so that the frames where a group is larger weigh more, as its pairs do.
+    As in RDF, the first bin is left out when it starts at r = 0. The arrays are indexed as [group][bin].
+*/
+class GroupedRDF
+    {
+    public:
+        //! Constructor
+        GroupedRDF(float rmax, float dr, unsigned int n_groups);
+
+        //! Destructor
+        ~GroupedRDF();
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the histograms to all zeros
+        void resetGroupedRDF();
+
+        //! Accumulate the RDFs of the groups of reference points of a frame
+        /*! Throws std::invalid_argument when a group label is not smaller than the number of groups.
+        */
+        void accumulate(box::Box& box,
+                        const vec3<float> *ref_points,
+                        const unsigned int *ref_groups,
+                        unsigned int n_ref,
+                        const vec3<float> *points,
+                        unsigned int Np);
+
+        //! \internal
+        //! reduce the thread local histograms into the per group bin counts, rdfs and N(r)
+        void reduceGroupedRDF();
+
+        //! Get a reference to the rdf array, n_groups x n_bins
+        std::shared_ptr<float> getRDF();
+
+        //! Get a reference to the cumulative counts array, n_groups x n_bins
+        std::shared_ptr<float> getNr();
+
+        //! Get a reference to the r array
+        std::shared_ptr<float> getR()
+            {
+            return m_r_array;
+            }
+
+        //! Get the number of reference points of each group, summed over the frames
+        const std::vector<double>& getGroupCounts() const
+            {
+            return m_group_refs;
+            }
+
+        //! Get the number of bins
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Get the number of groups
+        unsigned int getNGroups() const
+            {
+            return m_n_groups;
+            }
+
+        //! Share a LinkCell with other analyses of the same points, or use an own one again if \a lc is NULL
+        /*! The cell width of \a lc must be at least the cutoff; its cell list is only computed when it is not
+            already that of the frame (see locality::SharedLinkCell).
+        */
+        void setLinkCell(std::shared_ptr<locality::LinkCell> lc)
+            {
+            m_lc.share(lc);
+            }
+
+    private:
+        box::Box m_box;                     //!< Simulation box the particles belong in
+        float m_rmax;                       //!< Maximum r at which to compute g(r)
+        unsigned int m_n_groups;            //!< Number of groups
+        locality::SharedLinkCell m_lc;      //!< LinkCell to bin particles for the computation
+        util::BinEdges m_bin_edges;         //!< Edges of the r bins
+        unsigned int m_nbins;               //!< Number of r bins to compute g(r) over
+        unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
+        Index2D m_bi;                       //!< Indexer of the histograms, (bin, group)
+        std::vector<double> m_group_refs;   //!< Number of reference points of each group, summed over the frames
+        std::vector<double> m_group_norm;   //!< Reference points of each group times the density, over the frames
+        locality::WorkPartition m_work_partition;   //!< Cell order of the reference points
+
+        std::shared_ptr<float> m_rdf_array;         //!< rdf arrays computed
+        std::shared_ptr<util::BinCount> m_bin_counts; //!< bin counts that go into computing the rdf arrays
+        std::shared_ptr<float> m_N_r_array;         //!< Cumulative bin sums N_g(r)
+        std::shared_ptr<float> m_r_array;           //!< array of r values that the rdf is computed at
+        std::shared_ptr<float> m_vol_array2D;       //!< array of areas for each slice of r
+        std::shared_ptr<float> m_vol_array3D;       //!< array of volumes for each slice of r
+        tbb::enumerable_thread_specific<util::BinCount *> m_local_bin_counts;
+    };
+
+}; }; // end namespace freud::density
+
+#endif // _GROUPED_RDF_H__
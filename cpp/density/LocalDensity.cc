@@ -3,7 +3,10 @@
 
 #include "LocalDensity.h"
 #include "ScopedGILRelease.h"
+#include "Annotation.h"
+#include "ComputeArena.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <complex>
 
@@ -17,90 +20,150 @@ using namespace tbb;
 namespace freud { namespace density {
 
 LocalDensity::LocalDensity(float rcut, float volume, float diameter)
-    : m_box(box::Box()), m_rcut(rcut), m_volume(volume), m_diameter(diameter), m_n_ref(0)
+    : m_box(box::Box()), m_rcut(rcut), m_r_cuts(1, rcut), m_volume(volume), m_diameter(diameter), m_n_ref(0),
+      m_cell_order(true)
     {
-    m_lc = new locality::LinkCell(m_box, m_rcut);
+    m_lc = locality::SharedLinkCell(m_box, m_rcut + m_diameter/2.0f);
+    }
+
+/*! \param r_cuts cutoffs at which to compute the density, in any order
+*/
+LocalDensity::LocalDensity(const std::vector<float>& r_cuts, float volume, float diameter)
+    : m_box(box::Box()), m_r_cuts(r_cuts), m_volume(volume), m_diameter(diameter), m_n_ref(0),
+      m_cell_order(true)
+    {
+    if (r_cuts.empty())
+        throw invalid_argument("at least one r_cut is needed");
+    m_rcut = *std::max_element(r_cuts.begin(), r_cuts.end());
+    for (unsigned int c = 0; c < r_cuts.size(); c++)
+        {
+        if (r_cuts[c] <= 0.0f)
+            throw invalid_argument("r_cut must be positive");
+        }
+    m_lc = locality::SharedLinkCell(m_box, m_rcut + m_diameter/2.0f);
     }
 
 LocalDensity::~LocalDensity()
     {
-    delete m_lc;
     }
 
-void LocalDensity::compute(const box::Box &box, const vec3<float> *ref_points, unsigned int n_ref, const vec3<float> *points, unsigned int Np)
+void LocalDensity::compute(const box::Box &box, const vec3<float> *ref_points, unsigned int n_ref, const vec3<float> *points, unsigned int Np,
+                           const locality::NeighborList *nlist)
     {
+    util::ScopedRange annotation("freud::LocalDensity::compute");
     m_box = box;
     // compute the cell list
-    m_lc->computeCellList(m_box, points, Np);
+    if (nlist != NULL)
+        nlist->validate(n_ref, Np);
+    else
+        m_lc.compute(m_box, points, Np, true);
 
-    // reallocate the output array if it is not the right size
-    if (n_ref != m_n_ref)
-        {
-        m_density_array = std::shared_ptr<float>(new float[n_ref], std::default_delete<float[]>());
-        m_num_neighbors_array = std::shared_ptr<float>(new float[n_ref], std::default_delete<float[]>());
-        }
+    prepare(m_box, n_ref);
+    const unsigned int n_cuts = m_r_cuts.size();
+
+    // the points sorted by cell, so that the distances to a cell are computed from contiguous memory
+    const vec3<float> *sorted_points = m_lc->getSortedPoints().get();
+    const unsigned int *cell_start = m_lc->getCellStart().get();
+
+    // consecutive reference points of a task share their neighbor cells
+    const unsigned int *order = NULL;
+    if (nlist == NULL && m_cell_order && n_ref >= locality::CELL_ORDER_MIN_POINTS)
+        order = m_work_partition.orderByCell(*m_lc, ref_points, n_ref, points, Np);
 
     // compute the local density
     parallel_for(blocked_range<size_t>(0,n_ref),
       [=] (const blocked_range<size_t>& r)
       {
-      for(size_t i=r.begin(); i!=r.end(); ++i)
-          {
-          float num_neighbors = 0;
+      const float rmax = m_rcut + m_diameter/2.0f;
+      const float rmaxsq = rmax * rmax;
+      locality::DistanceKernel kernel(m_box);
 
-          // get cell point is in
-          vec3<float> ref = ref_points[i];
-          unsigned int ref_cell = m_lc->getCell(ref);
+      for(size_t pos=r.begin(); pos!=r.end(); ++pos)
+          {
+          size_t i = (order != NULL) ? order[pos] : pos;
+          float *num_neighbors = m_num_neighbors_array.get() + i*n_cuts;
+          for (unsigned int c = 0; c < n_cuts; c++)
+              num_neighbors[c] = 0.0f;
 
-          //loop over neighboring cells
-          const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-          for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+          if (nlist != NULL)
               {
-              unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-              //iterate over particles in cell
-              locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-              for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
+              const float *distances = nlist->getDistances().get();
+              size_t last_bond = nlist->getLastBondWithin(i, rmax);
+              for (size_t bond = nlist->getFirstBond(i); bond < last_bond; bond++)
                   {
-                  //compute r between the two particles
-                  vec3<float> delta = m_box.wrap(points[j] - ref);
+                  addNeighbor(distances[bond], num_neighbors);
+                  }
+              }
+          else
+              {
+              // get cell point is in
+              vec3<float> ref = ref_points[i];
+              unsigned int ref_cell = m_lc->getCell(ref);
 
-                  // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                  float rsq = dot(delta, delta);
-                  float r = sqrt(rsq);
+              //loop over neighboring cells
+              const locality::CellNeighbors& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+              for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                  {
+                  unsigned int neigh_cell = neigh_cells[neigh_idx];
 
-                  // count particles that are fully in the rcut sphere
-                  if (r < (m_rcut - m_diameter/2.0f))
-                      {
-                      num_neighbors += 1.0f;
-                      }
-                  else if (r < (m_rcut + m_diameter/2.0f))
+                  //only particles closer than rcut + diameter/2 have a nonzero weight
+                  unsigned int begin = cell_start[neigh_cell];
+                  kernel.forEachWithin(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin, rmaxsq,
+                      [&] (unsigned int k, const vec3<float>& delta, float rsq)
                       {
-                      // partially count particles that intersect the rcut sphere
-                      // this is not particularly accurate for a single particle, but works well on average for
-                      // lots of them. It smooths out the neighbor count distributions and avoids noisy spikes
-                      // that obscure data
-                      num_neighbors += 1.0f + (m_rcut - (r + m_diameter/2.0f)) / m_diameter;
-                      }
+                      addNeighbor(sqrt(rsq), num_neighbors);
+                      });
                   }
               }
 
-          m_num_neighbors_array.get()[i] = num_neighbors;
-          if (m_box.is2D())
-              {
-              // local density is area of particles divided by the area of the circle
-              m_density_array.get()[i] = (m_volume * m_num_neighbors_array.get()[i]) / (M_PI * m_rcut * m_rcut);
-              }
-          else
-              {
-              // local density is volume of particles divided by the volume of the sphere
-              m_density_array.get()[i] = (m_volume * m_num_neighbors_array.get()[i]) / (4.0f/3.0f * M_PI * m_rcut * m_rcut * m_rcut);
-              }
+          finishDensity(i);
           }
       });
+    }
 
-    // save the last computed number of particles
+//! \internal
+void LocalDensity::prepare(const box::Box& box, unsigned int n_ref)
+    {
+    // keep the output arrays of the previous call when they are large enough
+    const unsigned int n_cuts = m_r_cuts.size();
+    util::reuseArray(m_density_array, n_ref*n_cuts);
+    util::reuseArray(m_num_neighbors_array, n_ref*n_cuts);
     m_n_ref = n_ref;
+
+    // the bounds of the range of partial overlap of each cutoff and the volume (area in 2d) of its sphere
+    m_r_in.resize(n_cuts);
+    m_r_out.resize(n_cuts);
+    m_cut_volume.resize(n_cuts);
+    for (unsigned int c = 0; c < n_cuts; c++)
+        {
+        float rcut = m_r_cuts[c];
+        m_r_in[c] = rcut - m_diameter/2.0f;
+        m_r_out[c] = rcut + m_diameter/2.0f;
+        m_cut_volume[c] = box.is2D() ? M_PI * rcut * rcut : 4.0f/3.0f * M_PI * rcut * rcut * rcut;
+        }
+    }
+
+void LocalDensity::beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                              const vec3<float> *points, unsigned int Np)
+    {
+    m_box = box;
+    prepare(m_box, n_ref);
+    }
+
+void LocalDensity::processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors)
+    {
+    const unsigned int n_cuts = m_r_cuts.size();
+    const float rmax = m_rcut + m_diameter/2.0f;
+    const float rmaxsq = rmax * rmax;
+    float *num_neighbors = m_num_neighbors_array.get() + i*n_cuts;
+    for (unsigned int c = 0; c < n_cuts; c++)
+        num_neighbors[c] = 0.0f;
+    for (unsigned int k = 0; k < neighbors.num; k++)
+        {
+        if (neighbors.rsq[k] < rmaxsq)
+            addNeighbor(sqrtf(neighbors.rsq[k]), num_neighbors);
+        }
+    finishDensity(i);
     }
 
 unsigned int LocalDensity::getNRef()
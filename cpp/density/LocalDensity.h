@@ -10,11 +10,15 @@
 #define __APPLE__
 
 #include <memory>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "SharedLinkCell.h"
+#include "FrameAnalysis.h"
+#include "WorkPartition.h"
 #include "box.h"
 
 #ifndef _LOCAL_DENSITY_H__
@@ -27,14 +31,20 @@
 namespace freud { namespace density {
 
 //! Compute the local density at each point
-/*!
+/*! The densities at several cutoffs, e.g. to use them as features of each point at many radii, are all computed
+    from a single traversal of the neighbors within the largest cutoff: the distance of each neighbor is computed once
+    and its partial overlap weight is added for every cutoff. The arrays then hold n_r_cuts values per reference
+    point, ordered like the cutoffs given to the constructor.
 */
-class LocalDensity
+class LocalDensity : public locality::PairAnalysis
     {
     public:
         //! Constructor
         LocalDensity(float r_cut, float volume, float diameter);
 
+        //! Constructor for the densities at several cutoffs
+        LocalDensity(const std::vector<float>& r_cuts, float volume, float diameter);
+
        //! Destructor
        ~LocalDensity();
 
@@ -45,28 +55,119 @@ class LocalDensity
             }
 
         //! Compute the local density
+        /*! If \a nlist is given, only its bonds are counted instead of building the internal cell list
+        */
         void compute(const box::Box &box,
                      const vec3<float> *ref_points,
                      unsigned int n_ref,
                      const vec3<float> *points,
-                     unsigned int Np);
+                     unsigned int Np,
+                     const locality::NeighborList *nlist=NULL);
+
+        //! Get the cutoff of the neighbors counted as an analysis of a locality::FrameAnalysis
+        float getPairRMax() const
+            {
+            return m_rcut + m_diameter/2.0f;
+            }
+
+        //! Start computing the densities from the neighbors found by a locality::FrameAnalysis
+        void beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                        const vec3<float> *points, unsigned int Np);
+
+        //! Compute the densities of one reference point from its neighbors found by a locality::FrameAnalysis
+        void processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors);
+
+        //! Finish the densities computed from the neighbors found by a locality::FrameAnalysis
+        void endFrame()
+            {
+            }
 
         //! Get the number of reference particles
         unsigned int getNRef();
 
+        //! Get the number of cutoffs
+        unsigned int getNumRCuts() const
+            {
+            return m_r_cuts.size();
+            }
+
+        //! Get the cutoffs
+        const std::vector<float>& getRCuts() const
+            {
+            return m_r_cuts;
+            }
+
         //! Get a reference to the last computed density
         std::shared_ptr< float > getDensity();
 
         //! Get a reference to the last computed number of neighbors
         std::shared_ptr< float > getNumNeighbors();
 
+        //! Set whether the reference points are visited in the order of their cells, when there are at least
+        //! locality::CELL_ORDER_MIN_POINTS of them (the default) or never
+        void setCellOrder(bool cell_order)
+            {
+            m_cell_order = cell_order;
+            }
+
+        //! Get whether the reference points are visited in the order of their cells
+        bool getCellOrder() const
+            {
+            return m_cell_order;
+            }
+
+        //! Share a LinkCell with other analyses of the same points, or use an own one again if \a lc is NULL
+        /*! The cell width of \a lc must be at least the cutoff; its cell list is only computed when it is not
+            already that of the frame (see locality::SharedLinkCell).
+        */
+        void setLinkCell(std::shared_ptr<locality::LinkCell> lc)
+            {
+            m_lc.share(lc);
+            }
+
     private:
+        //! Allocate the arrays of n_ref reference points and the bounds of the cutoffs in box
+        void prepare(const box::Box& box, unsigned int n_ref);
+
+        //! Add the weights of a neighbor at distance r to the numbers of neighbors of every cutoff
+        void addNeighbor(float r, float *num_neighbors) const
+            {
+            const unsigned int n_cuts = m_r_cuts.size();
+            for (unsigned int c = 0; c < n_cuts; c++)
+                {
+                // count particles that are fully in the rcut sphere, and partially count particles that
+                // intersect the rcut sphere. this is not particularly accurate for a single particle, but works
+                // well on average for lots of them. It smooths out the neighbor count distributions and avoids
+                // noisy spikes that obscure data
+                float weight = (r < m_r_in[c]) ? 1.0f :
+                    ((r < m_r_out[c]) ? 1.0f + (m_r_cuts[c] - (r + m_diameter/2.0f)) / m_diameter : 0.0f);
+                num_neighbors[c] += weight;
+                }
+            }
+
+        //! Turn the numbers of neighbors of reference point i into densities
+        void finishDensity(size_t i) const
+            {
+            // local density is volume (area in 2d) of particles divided by the volume (area) of the sphere (circle)
+            const unsigned int n_cuts = m_r_cuts.size();
+            const float *num_neighbors = m_num_neighbors_array.get() + i*n_cuts;
+            float *density = m_density_array.get() + i*n_cuts;
+            for (unsigned int c = 0; c < n_cuts; c++)
+                density[c] = (m_volume * num_neighbors[c]) / m_cut_volume[c];
+            }
+
         box::Box m_box;            //!< Simulation box the particles belong in
-        float m_rcut;                     //!< Maximum neighbor distance
+        float m_rcut;                     //!< Largest cutoff
+        std::vector<float> m_r_cuts;      //!< Cutoffs at which to compute the density
+        std::vector<float> m_r_in;        //!< Distance below which a neighbor is fully within each cutoff
+        std::vector<float> m_r_out;       //!< Distance from which a neighbor is fully outside each cutoff
+        std::vector<double> m_cut_volume; //!< Volume (area in 2d) of the sphere of each cutoff
         float m_volume;                   //!< Volume (area in 2d) of a single particle
         float m_diameter;                 //!< Diameter of the particles
-        locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        locality::SharedLinkCell m_lc;    //!< LinkCell to bin particles for the computation
         unsigned int m_n_ref;                //!< Last number of points computed
+        bool m_cell_order;                   //!< true to visit the reference points in cell order
+        locality::WorkPartition m_work_partition;   //!< Cell order of the reference points
 
         std::shared_ptr< float > m_density_array;         //!< density array computed
         std::shared_ptr< float > m_num_neighbors_array;   //!< number of neighbors array computed
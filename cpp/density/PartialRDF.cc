@@ -0,0 +1,273 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "PartialRDF.h"
+#include "Checkpoint.h"
+#include "Annotation.h"
+
+#include <stdexcept>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file PartialRDF.cc
+    \brief Routines for computing the partial radial density functions of a mixture
+*/
+
+namespace freud { namespace density {
+
+PartialRDF::PartialRDF(float rmax, float dr, unsigned int n_types)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_n_types(n_types), m_frame_counter(0), m_reduce(true)
+    {
+    if (dr <= 0.0f)
+        throw invalid_argument("dr must be positive");
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    if (dr > rmax)
+        throw invalid_argument("rmax must be greater than dr");
+    if (n_types < 1)
+        throw invalid_argument("must be at least 1 type");
+
+    m_nbins = int(floorf(m_rmax / m_dr));
+    assert(m_nbins > 0);
+    m_bi = Index3D(m_nbins, m_n_types, m_n_types);
+    m_type_counts.resize(m_n_types, 0);
+
+    m_rdf_array = std::shared_ptr<float>(new float[m_bi.getNumElements()], std::default_delete<float[]>());
+    memset((void*)m_rdf_array.get(), 0, sizeof(float)*m_bi.getNumElements());
+    m_bin_counts = std::shared_ptr<util::BinCount>(new util::BinCount[m_bi.getNumElements()],
+                                                   std::default_delete<util::BinCount[]>());
+    memset((void*)m_bin_counts.get(), 0, sizeof(util::BinCount)*m_bi.getNumElements());
+    m_N_r_array = std::shared_ptr<float>(new float[m_bi.getNumElements()], std::default_delete<float[]>());
+    memset((void*)m_N_r_array.get(), 0, sizeof(float)*m_bi.getNumElements());
+
+    // precompute the bin center positions
+    m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float r = float(i) * m_dr;
+        float nextr = float(i+1) * m_dr;
+        m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
+        }
+
+    // precompute cell volumes
+    m_vol_array2D = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    m_vol_array3D = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float r = float(i) * m_dr;
+        float nextr = float(i+1) * m_dr;
+        m_vol_array2D.get()[i] = M_PI * (nextr*nextr - r*r);
+        m_vol_array3D.get()[i] = 4.0f / 3.0f * M_PI * (nextr*nextr*nextr - r*r*r);
+        }
+
+    m_lc = new locality::LinkCell(m_box, m_rmax);
+    }
+
+PartialRDF::~PartialRDF()
+    {
+    util::freeLocalHistograms(m_local_bin_counts);
+    delete m_lc;
+    }
+
+//! \internal
+//! reduce the thread local histograms into the bin counts of each pair of types and normalize them
+void PartialRDF::reducePartialRDF()
+    {
+    util::reduceLocalHistograms(m_local_bin_counts, m_bin_counts.get(), m_bi.getNumElements());
+    const float *vol_array = m_box.is2D() ? m_vol_array2D.get() : m_vol_array3D.get();
+    float volume = m_box.getVolume();
+
+    // normalize the histogram of each pair of types like the rdf of the points of type a among those of type b
+    parallel_for(blocked_range<size_t>(0, m_n_types*m_n_types),
+      [=] (const blocked_range<size_t>& r)
+      {
+      for (size_t pair = r.begin(); pair != r.end(); pair++)
+          {
+          unsigned int a = pair / m_n_types;
+          unsigned int b = pair % m_n_types;
+          float n_a = float(m_type_counts[a]);
+          float ndens = float(m_type_counts[b]) / volume;
+          float *rdf = m_rdf_array.get() + m_bi(0, b, a);
+          float *N_r = m_N_r_array.get() + m_bi(0, b, a);
+          const util::BinCount *counts = m_bin_counts.get() + m_bi(0, b, a);
+
+          rdf[0] = 0.0f;
+          N_r[0] = 0.0f;
+          float sum = 0.0f;
+          for (unsigned int i = 1; i < m_nbins; i++)
+              {
+              float avg_counts = (n_a > 0.0f) ? (float)counts[i] / n_a : 0.0f;
+              rdf[i] = (ndens > 0.0f) ? avg_counts / vol_array[i] / ndens / m_frame_counter : 0.0f;
+              sum += avg_counts;
+              N_r[i] = sum / m_frame_counter;
+              }
+          }
+      });
+    }
+
+//! Get a reference to the partial rdf array
+std::shared_ptr<float> PartialRDF::getRDF()
+    {
+    if (m_reduce == true)
+        {
+        reducePartialRDF();
+        }
+    m_reduce = false;
+    return m_rdf_array;
+    }
+
+//! Get a reference to the cumulative counts array
+std::shared_ptr<float> PartialRDF::getNr()
+    {
+    if (m_reduce == true)
+        {
+        reducePartialRDF();
+        }
+    m_reduce = false;
+    return m_N_r_array;
+    }
+
+//! \internal
+/*! \brief Function to reset the histograms if needed e.g. calculating a new set of frames
+*/
+void PartialRDF::resetPartialRDF()
+    {
+    for (tbb::enumerable_thread_specific<util::BinCount *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(util::BinCount)*m_bi.getNumElements());
+        }
+    // reset the frame counter
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void PartialRDF::saveState(const std::string& filename)
+    {
+    std::vector<util::BinCount> counts(m_bi.getNumElements());
+    util::reduceLocalHistograms(m_local_bin_counts, counts.data(), counts.size());
+
+    util::CheckpointWriter writer(filename, "PartialRDF");
+    writer.write(m_rmax);
+    writer.write(m_dr);
+    writer.write(m_n_types);
+    writer.write(m_frame_counter);
+    writer.writeArray(m_type_counts.data(), m_n_types);
+    writer.writeBox(m_box);
+    writer.writeHistogram(counts.data(), counts.size());
+    writer.close();
+    }
+
+void PartialRDF::loadState(const std::string& filename, bool merge)
+    {
+    // read the whole file before changing anything
+    util::CheckpointReader reader(filename, "PartialRDF");
+    reader.expect(m_rmax, "rmax");
+    reader.expect(m_dr, "dr");
+    reader.expect(m_n_types, "number of types");
+    unsigned int frame_counter = reader.read<unsigned int>();
+    std::vector<unsigned int> type_counts;
+    reader.readArray(type_counts);
+    if (type_counts.size() != m_n_types)
+        throw invalid_argument("The checkpoint file is corrupted");
+    box::Box box = reader.readBox();
+    std::vector<util::BinCount> counts;
+    reader.readHistogram(counts, m_bi.getNumElements());
+
+    if (!merge)
+        resetPartialRDF();
+    addState(counts.data(), frame_counter, box, type_counts);
+    }
+
+void PartialRDF::merge(const PartialRDF& other)
+    {
+    if (other.m_rmax != m_rmax || other.m_dr != m_dr || other.m_n_types != m_n_types)
+        throw invalid_argument("Only partial RDFs of the same bins and types can be merged");
+    std::vector<util::BinCount> counts(m_bi.getNumElements());
+    util::reduceLocalHistograms(other.m_local_bin_counts, counts.data(), counts.size());
+    addState(counts.data(), other.m_frame_counter, other.m_box, other.m_type_counts);
+    }
+
+//! \internal
+//! Add the histograms of frame_counter frames, the last of them of the box and numbers of points of each type given
+void PartialRDF::addState(const util::BinCount *counts, unsigned int frame_counter, const box::Box& box,
+                          const std::vector<unsigned int>& type_counts)
+    {
+    if (m_frame_counter == 0)
+        {
+        m_box = box;
+        m_type_counts = type_counts;
+        }
+    util::addToLocalHistogram(m_local_bin_counts, counts, m_bi.getNumElements());
+    m_frame_counter += frame_counter;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Function to accumulate the pairs of a frame to the histograms in memory
+*/
+void PartialRDF::accumulate(box::Box& box,
+                            const vec3<float> *points,
+                            const unsigned int *types,
+                            unsigned int Np)
+    {
+    util::ScopedRange annotation("freud::PartialRDF::accumulate");
+    // count the points of each type
+    std::vector<unsigned int> type_counts(m_n_types, 0);
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        if (types[i] >= m_n_types)
+            throw invalid_argument("types must be smaller than n_types");
+        type_counts[types[i]]++;
+        }
+
+    m_box = box;
+    m_type_counts = type_counts;
+    m_lc->computeCellList(m_box, points, Np, true);
+
+    // every pair of the whole system is visited once with the half stencil and counted for both of its types
+    parallel_for(blocked_range<size_t>(0,m_lc->getNumCells()),
+      [=] (const blocked_range<size_t>& r)
+      {
+      float dr_inv = 1.0f / m_dr;
+      float rmaxsq = m_rmax * m_rmax;
+
+      bool exists;
+      m_local_bin_counts.local(exists);
+      if (! exists)
+          {
+          m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_bi.getNumElements());
+          }
+      util::BinCount *local_bins = m_local_bin_counts.local();
+      Index3D b_i = m_bi;
+
+      for (size_t cell = r.begin(); cell != r.end(); cell++)
+          {
+          m_lc->forEachHalfPair(cell, points, rmaxsq,
+              [=] (unsigned int i, unsigned int j, const vec3<float>& delta, float rsq)
+              {
+              float binr = sqrtf(rsq) * dr_inv;
+              // fast float to int conversion with truncation
+              #ifdef __SSE2__
+              unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
+              #else
+              unsigned int bin = (unsigned int)(binr);
+              #endif
+
+              if (bin < m_nbins)
+                  {
+                  ++local_bins[b_i(bin, types[j], types[i])];
+                  ++local_bins[b_i(bin, types[i], types[j])];
+                  }
+              });
+          }
+      });
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::density
@@ -0,0 +1,137 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <ostream>
+
+// work around nasty issue where python #defines isalpha, toupper, etc....
+#undef __APPLE__
+#include <Python.h>
+#define __APPLE__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "LinkCell.h"
+#include "box.h"
+#include "Index1D.h"
+#include "BinCount.h"
+#include "HistogramReduction.h"
+
+#ifndef _PARTIAL_RDF_H__
+#define _PARTIAL_RDF_H__
+
+/*! \file PartialRDF.h
+    \brief Routines for computing the partial radial density functions of a mixture
+*/
+
+namespace freud { namespace density {
+
+//! Computes the partial RDFs g_ab(r) between all pairs of types of a mixture
+/*! Each point carries a type in [0, n_types). A single traversal of the half stencil of one cell list over all the
+    points visits every pair once and bins it in the histogram of its pair of types, instead of one RDF computation
+    per pair of types with a cell list over the second type each.
+
+    g_ab(r) is normalized like the RDF of the points of type a among the points of type b: the average number of
+    points of type b in a shell around a point of type a, divided by the volume of the shell and the number density
+    of type b. The arrays are indexed as [a][b][bin]. g_ab = g_ba exactly, while the cumulative counts differ:
+    N_ab(r) = N_ba(r) N_b / N_a.
+*/
+class PartialRDF
+    {
+    public:
+        //! Constructor
+        PartialRDF(float rmax, float dr, unsigned int n_types);
+
+        //! Destructor
+        ~PartialRDF();
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the histograms to all zeros
+        void resetPartialRDF();
+
+        //! Accumulate the partial RDFs of a frame
+        void accumulate(box::Box& box,
+                        const vec3<float> *points,
+                        const unsigned int *types,
+                        unsigned int Np);
+
+        //! \internal
+        //! reduce the thread local histograms into the bin counts of each pair of types and normalize them
+        void reducePartialRDF();
+
+        //! Save the accumulated histograms, the number of frames and the box and numbers of points of each type of the
+        //! last frame to a checkpoint file
+        void saveState(const std::string& filename);
+
+        //! Restore the state of a checkpoint file, or add it to the accumulated state if merge
+        /*! The parameters must be the same. When merging, the box and numbers of points that normalize the partial
+            rdfs stay those of this object, unless it has no frame yet.
+        */
+        void loadState(const std::string& filename, bool merge=false);
+
+        //! Add the accumulated state of another PartialRDF of the same parameters, such as one of another chunk of a
+        //! trajectory
+        void merge(const PartialRDF& other);
+
+        //! Get a reference to the partial rdf array, n_types x n_types x n_bins
+        std::shared_ptr<float> getRDF();
+
+        //! Get a reference to the cumulative counts array, n_types x n_types x n_bins
+        std::shared_ptr<float> getNr();
+
+        //! Get a reference to the r array
+        std::shared_ptr<float> getR()
+            {
+            return m_r_array;
+            }
+
+        //! Get the number of bins
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Get the number of types
+        unsigned int getNTypes() const
+            {
+            return m_n_types;
+            }
+
+    private:
+        //! Add the histograms of some frames to the accumulated ones
+        void addState(const util::BinCount *counts, unsigned int frame_counter, const box::Box& box,
+                      const std::vector<unsigned int>& type_counts);
+
+        box::Box m_box;                     //!< Simulation box the particles belong in
+        float m_rmax;                       //!< Maximum r at which to compute g(r)
+        float m_dr;                         //!< Step size for r in the computation
+        unsigned int m_n_types;             //!< Number of types
+        locality::LinkCell* m_lc;           //!< LinkCell to bin particles for the computation
+        unsigned int m_nbins;               //!< Number of r bins to compute g(r) over
+        unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
+        Index3D m_bi;                       //!< Indexer of the histograms, (bin, b, a)
+        std::vector<unsigned int> m_type_counts;    //!< number of points of each type in the last frame
+
+        std::shared_ptr<float> m_rdf_array;         //!< partial rdf arrays computed
+        std::shared_ptr<util::BinCount> m_bin_counts; //!< bin counts that go into computing the rdf arrays
+        std::shared_ptr<float> m_N_r_array;         //!< Cumulative bin sums N_ab(r)
+        std::shared_ptr<float> m_r_array;           //!< array of r values that the rdf is computed at
+        std::shared_ptr<float> m_vol_array2D;       //!< array of areas for each slice of r
+        std::shared_ptr<float> m_vol_array3D;       //!< array of volumes for each slice of r
+        tbb::enumerable_thread_specific<util::BinCount *> m_local_bin_counts;
+    };
+
+}; }; // end namespace freud::density
+
+#endif // _PARTIAL_RDF_H__
@@ -2,12 +2,12 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "RDF.h"
+#include "Checkpoint.h"
 #include "ScopedGILRelease.h"
+#include "Annotation.h"
+#include "ComputeArena.h"
 
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
 
 using namespace std;
 
@@ -20,7 +20,10 @@ using namespace tbb;
 namespace freud { namespace density {
 
 RDF::RDF(float rmax, float dr)
-    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0), m_reduce(true),
+      m_partition_mode(locality::PARTITION_AUTO), m_cell_order(true), m_kernel_width(0.0f), m_kernel_inv_dr(0.0f),
+      m_kernel_half(0), m_kernel_size(0), m_weighted(false), m_point_histograms(false), m_point_compact(false),
+      m_n_point_histograms(0)
     {
     if (dr <= 0.0f)
         throw invalid_argument("dr must be positive");
@@ -29,23 +32,46 @@ RDF::RDF(float rmax, float dr)
     if (dr > rmax)
         throw invalid_argument("rmax must be greater than dr");
 
-    m_nbins = int(floorf(m_rmax / m_dr));
+    initialize(util::BinEdges(m_rmax, m_dr));
+    }
+
+/*! \param bin_edges Strictly increasing edges of the r bins, bin i covering [bin_edges[i], bin_edges[i+1])
+*/
+RDF::RDF(const std::vector<float>& bin_edges)
+    : m_box(box::Box()), m_dr(0.0f), m_frame_counter(0), m_reduce(true),
+      m_partition_mode(locality::PARTITION_AUTO), m_cell_order(true), m_kernel_width(0.0f), m_kernel_inv_dr(0.0f),
+      m_kernel_half(0), m_kernel_size(0), m_weighted(false), m_point_histograms(false), m_point_compact(false),
+      m_n_point_histograms(0)
+    {
+    initialize(util::BinEdges(bin_edges));
+    m_rmax = m_bin_edges.getMax();
+    }
+
+//! \internal
+//! Allocate the histograms and precompute the r values and shell volumes of the bins
+void RDF::initialize(const util::BinEdges& bin_edges)
+    {
+    m_bin_edges = bin_edges;
+    m_nbins = m_bin_edges.getNBins();
     assert(m_nbins > 0);
     m_rdf_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
     memset((void*)m_rdf_array.get(), 0, sizeof(float)*m_nbins);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_nbins], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
+    m_bin_counts = std::shared_ptr<util::BinCount>(new util::BinCount[m_nbins], std::default_delete<util::BinCount[]>());
+    memset((void*)m_bin_counts.get(), 0, sizeof(util::BinCount)*m_nbins);
     m_avg_counts = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
     memset((void*)m_avg_counts.get(), 0, sizeof(float)*m_nbins);
     m_N_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
     memset((void*)m_N_r_array.get(), 0, sizeof(unsigned int)*m_nbins);
+    m_weighted_rdf_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    memset((void*)m_weighted_rdf_array.get(), 0, sizeof(float)*m_nbins);
 
     // precompute the bin center positions
+    const std::vector<float>& edges = m_bin_edges.getEdges();
     m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
     for (unsigned int i = 0; i < m_nbins; i++)
         {
-        float r = float(i) * m_dr;
-        float nextr = float(i+1) * m_dr;
+        float r = edges[i];
+        float nextr = edges[i+1];
         m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
         }
 
@@ -58,24 +84,155 @@ RDF::RDF(float rmax, float dr)
     memset((void*)m_vol_array3D.get(), 0, sizeof(float)*m_nbins);
     for (unsigned int i = 0; i < m_nbins; i++)
         {
-        float r = float(i) * m_dr;
-        float nextr = float(i+1) * m_dr;
+        float r = edges[i];
+        float nextr = edges[i+1];
         m_vol_array2D.get()[i] = M_PI * (nextr*nextr - r*r);
         m_vol_array3D.get()[i] = 4.0f / 3.0f * M_PI * (nextr*nextr*nextr - r*r*r);
         }
 
-    m_lc = new locality::LinkCell(m_box, m_rmax);
+    m_lc = locality::SharedLinkCell(m_box, m_bin_edges.getMax());
     }
 
 RDF::~RDF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+    util::freeLocalHistograms(m_local_bin_counts);
+    util::freeLocalHistograms(m_local_smooth_counts);
+    util::freeLocalHistograms(m_local_weighted_counts);
+    }
+
+void RDF::setUseGPU(bool use_gpu)
+    {
+    if (!use_gpu)
+        m_gpu.reset();
+    else if (!m_gpu)
+        m_gpu = std::shared_ptr<gpu::PairBinnerGPU>(new gpu::PairBinnerGPU());
+    }
+
+/*! The weight of the bin k bins away from that of a pair at x bins is the integral of the Gaussian over
+    [k, k+1) - x, tabulated for the KERNEL_TABLE_STEPS centers of the positions x within the bin and normalized so
+    that every pair adds 1 in total.
+*/
+void RDF::setKernelWidth(float sigma)
+    {
+    if (sigma < 0.0f)
+        throw invalid_argument("The kernel width must not be negative");
+    if (sigma > 0.0f && m_dr == 0.0f)
+        throw invalid_argument("Smoothing with a kernel needs bins of equal widths");
+    util::freeLocalHistograms(m_local_smooth_counts);
+    m_kernel_width = sigma;
+    m_reduce = true;
+    if (sigma == 0.0f)
         {
-        delete[] (*i);
+        m_kernel_table.clear();
+        return;
         }
-    delete m_lc;
+
+    double s = double(sigma) / m_dr;
+    m_kernel_inv_dr = 1.0f / m_dr;
+    m_kernel_half = (unsigned int) ceil(4.0 * s);
+    m_kernel_size = 2*m_kernel_half + 1;
+    m_kernel_table.resize(KERNEL_TABLE_STEPS * m_kernel_size);
+    for (unsigned int step = 0; step < KERNEL_TABLE_STEPS; step++)
+        {
+        double x = (step + 0.5) / KERNEL_TABLE_STEPS;
+        double *weights = &m_kernel_table[step * m_kernel_size];
+        double sum = 0.0;
+        for (unsigned int k = 0; k < m_kernel_size; k++)
+            {
+            double lo = double(k) - double(m_kernel_half) - x;
+            weights[k] = 0.5 * (erf((lo + 1.0) / (M_SQRT2 * s)) - erf(lo / (M_SQRT2 * s)));
+            sum += weights[k];
+            }
+        for (unsigned int k = 0; k < m_kernel_size; k++)
+            weights[k] /= sum;
+        }
+    }
+
+double *RDF::localSmoothCounts()
+    {
+    bool exists;
+    m_local_smooth_counts.local(exists);
+    if (! exists)
+        m_local_smooth_counts.local() = util::allocateLocalHistogram<double>(m_nbins);
+    return m_local_smooth_counts.local();
+    }
+
+double *RDF::localWeightedCounts()
+    {
+    bool exists;
+    m_local_weighted_counts.local(exists);
+    if (! exists)
+        m_local_weighted_counts.local() = util::allocateLocalHistogram<double>(m_nbins);
+    return m_local_weighted_counts.local();
+    }
+
+void RDF::setPointHistograms(bool enable, bool compact)
+    {
+    m_point_histograms = enable;
+    m_point_compact = enable && compact;
+    m_n_point_histograms = 0;
+    if (!enable || compact)
+        m_point_counts.reset();
+    if (!enable || !compact)
+        m_point_counts_compact.reset();
     }
 
+//! \internal
+//! The rows are zeroed by the threads that fill them
+void RDF::preparePointHistograms(unsigned int n_ref)
+    {
+    if (!m_point_histograms)
+        return;
+    if (m_point_compact)
+        util::reuseArray(m_point_counts_compact, size_t(n_ref)*m_nbins);
+    else
+        util::reuseArray(m_point_counts, size_t(n_ref)*m_nbins);
+    m_n_point_histograms = n_ref;
+    }
+
+util::MemoryUsage RDF::getMemoryUsage() const
+    {
+    util::MemoryUsage usage;
+    // the bin counts, the seven arrays of floats of the bins and the reduced weighted and smoothed counts
+    usage.add("histogram", m_nbins*(sizeof(util::BinCount) + 7*sizeof(float)) +
+                           (m_weighted_counts.capacity() + m_smooth_counts.capacity() + m_kernel_table.capacity())*
+                           sizeof(double));
+    usage.add("local_histograms", util::localHistogramBytes(m_local_bin_counts, m_nbins) +
+                                  util::localHistogramBytes(m_local_smooth_counts, m_nbins) +
+                                  util::localHistogramBytes(m_local_weighted_counts, m_nbins));
+    size_t point_bins = size_t(m_n_point_histograms)*m_nbins;
+    usage.add("point_histograms", m_point_counts_compact ? point_bins*sizeof(uint16_t) :
+                                  (m_point_counts ? point_bins*sizeof(unsigned int) : 0));
+    usage.add("cell_list", m_lc.isShared() ? 0 : m_lc->getMemoryBytes());
+    usage.add("points", (m_soa_ref_points.capacity() + m_soa_points.capacity())*sizeof(vec3<float>));
+    return usage;
+    }
+
+/*! The weighted counts, which depend on the frames accumulated, are left out, and the cell list is counted unless it
+    is shared.
+*/
+util::MemoryUsage RDF::estimateMemory(unsigned int N, unsigned int num_threads) const
+    {
+    util::MemoryUsage usage;
+    if (num_threads == 0)
+        num_threads = this_task_arena::max_concurrency();
+    const bool smooth = m_kernel_width > 0.0f;
+    usage.add("histogram", m_nbins*(sizeof(util::BinCount) + 7*sizeof(float)) +
+                           (smooth ? m_nbins + m_kernel_table.size() : 0)*sizeof(double));
+    usage.add("local_histograms", size_t(num_threads)*m_nbins*
+                                  (smooth ? sizeof(double) : sizeof(util::BinCount)));
+    size_t point_bins = m_point_histograms ? size_t(N)*m_nbins : 0;
+    usage.add("point_histograms", point_bins*(m_point_compact ? sizeof(uint16_t) : sizeof(unsigned int)));
+    usage.add("cell_list", m_lc.isShared() ? 0 : locality::LinkCell::estimateMemoryBytes(N, true));
+    usage.add("points", 0);
+    return usage;
+    }
+
+//! \internal
+//! Largest number of bins normalized and summed serially by reduceRDF(), below which the tasks cost more than they
+//! save
+const unsigned int SERIAL_REDUCTION_MAX_BINS = 4096;
+
 //! \internal
 //! CumulativeCount class to perform a parallel reduce to get the cumulative count for each histogram bin
 class CumulativeCount
@@ -126,40 +283,162 @@ class CumulativeCount
 //! helper function to reduce the thread specific arrays into the boost array
 void RDF::reduceRDF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
-    memset((void*)m_avg_counts.get(), 0, sizeof(float)*m_nbins);
+    util::ScopedRange annotation("freud::RDF::reduce");
+    util::ProfilePhase profile_phase(m_profiler, "reduce");
+    util::reduceLocalHistograms(m_local_bin_counts, m_bin_counts.get(), m_nbins);
+    if (m_kernel_width > 0.0f)
+        {
+        m_smooth_counts.resize(m_nbins);
+        util::reduceLocalHistograms(m_local_smooth_counts, m_smooth_counts.data(), m_nbins);
+        }
+    if (m_weighted)
+        {
+        m_weighted_counts.resize(m_nbins);
+        util::reduceLocalHistograms(m_local_weighted_counts, m_weighted_counts.data(), m_nbins);
+        }
     // now compute the rdf
     float ndens = float(m_Np) / m_box.getVolume();
-    m_rdf_array.get()[0] = 0.0f;
-    m_N_r_array.get()[0] = 0.0f;
-    m_N_r_array.get()[1] = 0.0f;
     if (m_box.is2D())
         m_vol_array = m_vol_array2D;
     else
         m_vol_array = m_vol_array3D;
-    // now compute the rdf
-    parallel_for(blocked_range<size_t>(1,m_nbins),
-      [=] (const blocked_range<size_t>& r)
+    // the first of bins starting at r = 0 holds the distance of each point to itself and is left out, unless the
+    // pairs are smoothed, which leaves those out
+    const bool smooth = m_kernel_width > 0.0f;
+    size_t first_bin = (m_bin_edges.getEdges()[0] == 0.0f && !smooth) ? 1 : 0;
+    // the weighted counts are always binned
+    const size_t weighted_first_bin = (m_bin_edges.getEdges()[0] == 0.0f) ? 1 : 0;
+    const bool weighted = m_weighted;
+    const double sphere = m_box.is2D() ? 2.0*M_PI : 4.0*M_PI;
+    for (size_t i = 0; i < first_bin; i++)
+        {
+        m_rdf_array.get()[i] = 0.0f;
+        m_avg_counts.get()[i] = 0.0f;
+        m_weighted_rdf_array.get()[i] = 0.0f;
+        }
+
+    // the average counts are normalized by the number of frames here, so that their cumulative sum is N(r)
+    const float frame_norm = 1.0f / m_frame_counter;
+    auto normalize = [=] (const blocked_range<size_t>& r)
       {
       for (size_t i = r.begin(); i != r.end(); i++)
           {
-          for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-               local_bins != m_local_bin_counts.end(); ++local_bins)
+          if (smooth)
+              {
+              // the smoothed counts are weighted by the inverse measure of the sphere of each pair
+              m_rdf_array.get()[i] = float(m_smooth_counts[i] / (sphere * m_dr * m_n_ref * ndens)) * frame_norm;
+              m_avg_counts.get()[i] = m_rdf_array.get()[i] * m_vol_array.get()[i] * ndens;
+              }
+          else
+              {
+              m_avg_counts.get()[i] = (float)m_bin_counts.get()[i] / m_n_ref * frame_norm;
+              m_rdf_array.get()[i] = m_avg_counts.get()[i] / m_vol_array.get()[i] / ndens;
+              }
+          if (weighted)
               {
-              m_bin_counts.get()[i] += (*local_bins)[i];
+              float weighted_counts = (i < weighted_first_bin) ? 0.0f :
+                                      float(m_weighted_counts[i] / m_n_ref) * frame_norm;
+              m_weighted_rdf_array.get()[i] = weighted_counts / m_vol_array.get()[i] / ndens;
               }
-          m_avg_counts.get()[i] = (float)m_bin_counts.get()[i] / m_n_ref;
-          m_rdf_array.get()[i] = m_avg_counts.get()[i] / m_vol_array.get()[i] / ndens;
           }
-      });
+      };
+    if (m_nbins <= SERIAL_REDUCTION_MAX_BINS)
+        {
+        normalize(blocked_range<size_t>(first_bin, m_nbins));
+        double sum = 0.0;
+        for (unsigned int i = 0; i < m_nbins; i++)
+            {
+            sum += m_avg_counts.get()[i];
+            m_N_r_array.get()[i] = float(sum);
+            }
+        }
+    else
+        {
+        parallel_for(blocked_range<size_t>(first_bin, m_nbins), normalize);
+        CumulativeCount myN_r(m_N_r_array.get(), m_avg_counts.get());
+        parallel_scan(blocked_range<size_t>(0, m_nbins), myN_r);
+        }
+    }
 
-    CumulativeCount myN_r(m_N_r_array.get(), m_avg_counts.get());
-    parallel_scan( blocked_range<size_t>(0, m_nbins), myN_r);
-    for (unsigned int i=0; i<m_nbins; i++)
+void RDF::saveState(const std::string& filename)
+    {
+    if (m_kernel_width > 0.0f)
+        throw invalid_argument("The smoothed counts of an RDF are not saved to checkpoints");
+    if (m_weighted)
+        throw invalid_argument("The weighted counts of an RDF are not saved to checkpoints");
+    std::vector<util::BinCount> counts(m_nbins);
+    util::reduceLocalHistograms(m_local_bin_counts, counts.data(), m_nbins);
+
+    util::CheckpointWriter writer(filename, "RDF");
+    writer.writeArray(m_bin_edges.getEdges().data(), m_nbins + 1);
+    writer.write(m_frame_counter);
+    writer.write(m_n_ref);
+    writer.write(m_Np);
+    writer.writeBox(m_box);
+    writer.writeHistogram(counts.data(), m_nbins);
+    writer.close();
+    }
+
+void RDF::loadState(const std::string& filename, bool merge)
+    {
+    if (m_kernel_width > 0.0f)
+        throw invalid_argument("The smoothed counts of an RDF are not saved to checkpoints");
+    // read the whole file before changing anything
+    util::CheckpointReader reader(filename, "RDF");
+    reader.expectArray(m_bin_edges.getEdges(), "bins");
+    unsigned int frame_counter = reader.read<unsigned int>();
+    unsigned int n_ref = reader.read<unsigned int>();
+    unsigned int Np = reader.read<unsigned int>();
+    box::Box box = reader.readBox();
+    std::vector<util::BinCount> counts;
+    reader.readHistogram(counts, m_nbins);
+
+    if (!merge)
+        resetRDF();
+    addState(counts.data(), frame_counter, box, n_ref, Np);
+    }
+
+/*! The histogram of other is added to the one of this object; the box and numbers of points that normalize the rdf
+    stay those of this object, unless it has no frame yet.
+*/
+void RDF::merge(const RDF& other)
+    {
+    if (other.m_bin_edges.getEdges() != m_bin_edges.getEdges())
+        throw invalid_argument("Only RDFs of the same bins can be merged");
+    if (other.m_kernel_width != m_kernel_width)
+        throw invalid_argument("Only RDFs of the same kernel width can be merged");
+    if (m_kernel_width > 0.0f)
+        {
+        std::vector<double> smooth_counts(m_nbins);
+        util::reduceLocalHistograms(other.m_local_smooth_counts, smooth_counts.data(), m_nbins);
+        util::addToLocalHistogram(m_local_smooth_counts, smooth_counts.data(), m_nbins);
+        }
+    if (other.m_weighted)
         {
-        m_rdf_array.get()[i] /= m_frame_counter;
-        m_N_r_array.get()[i] /= m_frame_counter;
+        std::vector<double> weighted_counts(m_nbins);
+        util::reduceLocalHistograms(other.m_local_weighted_counts, weighted_counts.data(), m_nbins);
+        util::addToLocalHistogram(m_local_weighted_counts, weighted_counts.data(), m_nbins);
+        m_weighted = true;
         }
+    std::vector<util::BinCount> counts(m_nbins);
+    util::reduceLocalHistograms(other.m_local_bin_counts, counts.data(), m_nbins);
+    addState(counts.data(), other.m_frame_counter, other.m_box, other.m_n_ref, other.m_Np);
+    }
+
+//! \internal
+//! Add the histogram of frame_counter frames, the last of them of the box and numbers of points given
+void RDF::addState(const util::BinCount *counts, unsigned int frame_counter, const box::Box& box, unsigned int n_ref,
+                   unsigned int Np)
+    {
+    if (m_frame_counter == 0)
+        {
+        m_box = box;
+        m_n_ref = n_ref;
+        m_Np = Np;
+        }
+    util::addToLocalHistogram(m_local_bin_counts, counts, m_nbins);
+    m_frame_counter += frame_counter;
+    m_reduce = true;
     }
 
 //! get a reference to the histogram bin centers array
@@ -171,14 +450,33 @@ std::shared_ptr<float> RDF::getR()
 //! Get a reference to the RDF histogram array
 std::shared_ptr<float> RDF::getRDF()
     {
-    reduceRDF();
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
     return m_rdf_array;
     }
 
+//! Get a reference to the rdf of the weighted counts
+std::shared_ptr<float> RDF::getWeightedRDF()
+    {
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
+    return m_weighted_rdf_array;
+    }
+
 //! Get a reference to the cumulative RDF histogram array
 std::shared_ptr<float> RDF::getNr()
     {
-    reduceRDF();
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
     return m_N_r_array;
     }
 
@@ -193,12 +491,22 @@ unsigned int RDF::getNBins()
 */
 void RDF::resetRDF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+    for (tbb::enumerable_thread_specific<util::BinCount *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(util::BinCount)*m_nbins);
+        }
+    for (tbb::enumerable_thread_specific<double *>::iterator i = m_local_smooth_counts.begin(); i != m_local_smooth_counts.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(double)*m_nbins);
+        }
+    for (tbb::enumerable_thread_specific<double *>::iterator i = m_local_weighted_counts.begin(); i != m_local_weighted_counts.end(); ++i)
         {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_nbins);
+        memset((void*)(*i), 0, sizeof(double)*m_nbins);
         }
+    m_weighted = false;
     // reset the frame counter
     m_frame_counter = 0;
+    m_reduce = true;
     }
 
 //! \internal
@@ -208,76 +516,574 @@ void RDF::accumulate(box::Box& box,
                      const vec3<float> *ref_points,
                      unsigned int Nref,
                      const vec3<float> *points,
-                     unsigned int Np)
+                     unsigned int Np,
+                     const locality::NeighborList *nlist,
+                     const float *ref_weights,
+                     const float *weights)
     {
+    util::ScopedRange annotation("freud::RDF::accumulate");
+    if ((ref_weights == NULL) != (weights == NULL))
+        throw invalid_argument("The weights of the reference points and of the points must be given together");
     m_box = box;
     m_Np = Np;
     m_n_ref = Nref;
-    m_lc->computeCellList(m_box, points, Np);
-    parallel_for(blocked_range<size_t>(0,Nref),
+    m_profiler.reset();
+    preparePointHistograms(Nref);
+    if (nlist == NULL && locality::PeriodicImages::needed(m_box, m_rmax))
+        {
+        // no cell list reaches beyond half the box
+        util::ProfilePhase profile_phase(m_profiler, "images");
+        binImages(m_box, ref_points, Nref, points, Np, ref_weights, weights);
+        }
+    else if (nlist == NULL && m_gpu && !m_point_histograms && m_kernel_width == 0.0f && weights == NULL)
+        {
+        util::ProfilePhase profile_phase(m_profiler, "gpu");
+        m_gpu_counts.resize(m_nbins);
+        m_gpu->binRDF(m_box, ref_points, Nref, points, Np, m_rmax, m_bin_edges, m_gpu_counts.data());
+        util::addToLocalHistogram(m_local_bin_counts, m_gpu_counts.data(), m_nbins);
+        }
+    else
+        {
+        if (nlist != NULL)
+            {
+            nlist->validate(Nref, Np);
+            m_profiler.addCount("bonds", nlist->getNumBonds());
+            }
+        else
+            {
+            util::ProfilePhase profile_phase(m_profiler, "cell_list");
+            m_lc.compute(m_box, points, Np, true);
+            m_profiler.addCount("cells", m_lc->getNumCells());
+            }
+        util::ProfilePhase profile_phase(m_profiler, "pairs");
+        binFrame(m_box, m_lc.get(), ref_points, Nref, points, Np, ref_weights, weights, nlist, m_partition_mode,
+                 &m_work_partition);
+        }
+    if (weights != NULL)
+        m_weighted = true;
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+void RDF::beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                     const vec3<float> *points, unsigned int Np)
+    {
+    m_box = box;
+    m_Np = Np;
+    m_n_ref = n_ref;
+    m_profiler.reset();
+    preparePointHistograms(n_ref);
+    }
+
+/*! The pairs are those of accumulate(): every neighbor within rmax, including a point itself at distance zero.
+*/
+void RDF::processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors)
+    {
+    bool exists;
+    m_local_bin_counts.local(exists);
+    if (! exists)
+        m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_nbins);
+    util::BinCount *local_bins = m_local_bin_counts.local();
+    double *local_smooth = (m_kernel_width > 0.0f) ? localSmoothCounts() : NULL;
+    const bool is2D = m_box.is2D();
+    if (m_point_histograms)
+        clearPointHistogram(i);
+
+    const float rmaxsq = m_rmax * m_rmax;
+    for (unsigned int k = 0; k < neighbors.num; k++)
+        {
+        float rsq = neighbors.rsq[k];
+        if (rsq < rmaxsq)
+            {
+            if (local_smooth != NULL)
+                addSmoothPair(local_smooth, sqrtf(rsq), 1.0, is2D);
+            unsigned int bin = m_bin_edges.getBin(sqrtf(rsq));
+            if (bin < m_nbins)
+                {
+                local_bins[bin]++;
+                if (m_point_histograms)
+                    countPointPair(i, bin);
+                }
+            }
+        }
+    }
+
+void RDF::endFrame()
+    {
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+void RDF::accumulateDomain(box::Box& box,
+                           const vec3<float> *points,
+                           unsigned int n_owned,
+                           unsigned int Np,
+                           const box::Box& frame_box,
+                           unsigned int frame_Np,
+                           bool count_frame)
+    {
+    if (n_owned > Np)
+        throw invalid_argument("A domain cannot own more points than it has");
+    accumulate(box, points, n_owned, points, Np);
+    // normalize as the whole frame
+    m_box = frame_box;
+    m_n_ref = frame_Np;
+    m_Np = frame_Np;
+    if (!count_frame)
+        m_frame_counter -= 1;
+    }
+
+//! \internal
+/*! \brief Function to accumulate the given points, stored as separate x, y and z arrays, to the histogram in memory
+
+    The pairs are found in the sorted copy of the points the cell list gathers from the arrays, so the points are
+    never interleaved; the reference points are looked up by index, and are interleaved into m_soa_ref_points unless
+    they are the points themselves. The bonds of a neighbor list are binned from the interleaved arrays as usual.
+*/
+void RDF::accumulate(box::Box& box,
+                     const float *ref_x,
+                     const float *ref_y,
+                     const float *ref_z,
+                     unsigned int Nref,
+                     const float *x,
+                     const float *y,
+                     const float *z,
+                     unsigned int Np,
+                     const locality::NeighborList *nlist)
+    {
+    util::ScopedRange annotation("freud::RDF::accumulateSoA");
+    util::SoAPoints ref_points(ref_x, ref_y, ref_z);
+    util::SoAPoints points(x, y, z);
+    if (nlist != NULL || m_gpu || locality::PeriodicImages::needed(box, m_rmax))
+        {
+        // the GPU and the search over the periodic images take interleaved points
+        m_soa_ref_points.resize(Nref);
+        m_soa_points.resize(Np);
+        util::interleavePoints(ref_points, Nref, m_soa_ref_points.data());
+        util::interleavePoints(points, Np, m_soa_points.data());
+        accumulate(box, m_soa_ref_points.data(), Nref, m_soa_points.data(), Np, nlist);
+        return;
+        }
+
+    m_box = box;
+    m_Np = Np;
+    m_n_ref = Nref;
+    m_profiler.reset();
+    preparePointHistograms(Nref);
+    util::ProfilePhase cell_list_phase(m_profiler, "cell_list");
+    m_lc->computeCellList(m_box, x, y, z, Np, true);
+    m_profiler.addCount("cells", m_lc->getNumCells());
+    cell_list_phase.stop();
+    const vec3<float> *sorted_points = m_lc->getSortedPoints().get();
+    util::ProfilePhase pairs_phase(m_profiler, "pairs");
+    if (ref_points == points && Nref == Np && !m_point_histograms)
+        {
+        // the self rdf only reads the sorted points, which are not in the order of the histograms of the points
+        binFrame(m_box, m_lc.get(), sorted_points, Np, sorted_points, Np, NULL, NULL, NULL, m_partition_mode,
+                 &m_work_partition);
+        }
+    else
+        {
+        m_soa_ref_points.resize(Nref);
+        util::interleavePoints(ref_points, Nref, m_soa_ref_points.data());
+        binFrame(m_box, m_lc.get(), m_soa_ref_points.data(), Nref, sorted_points, Np, NULL, NULL, NULL, m_partition_mode,
+                 &m_work_partition);
+        }
+    m_frame_counter += 1;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Function to accumulate a stack of frames to the histogram in memory
+
+    Frame f has the box boxes[f], the reference points ref_points[f*Nref, (f+1)*Nref) and the points
+    points[f*Np, (f+1)*Np). The result is the same as calling accumulate() on every frame in turn; as there, the
+    normalization uses the box and the numbers of points of the last frame.
+*/
+void RDF::accumulateFrames(const box::Box *boxes,
+                           const vec3<float> *ref_points,
+                           unsigned int Nref,
+                           const vec3<float> *points,
+                           unsigned int Np,
+                           unsigned int n_frames)
+    {
+    util::ScopedRange annotation("freud::RDF::accumulateFrames");
+    if (m_point_histograms)
+        throw invalid_argument("The histograms of the reference points are only kept by accumulate()");
+    if (n_frames == 0)
+        return;
+    m_profiler.reset();
+
+    // the frames are independent: each task bins its frames with a cell list of its own, and binFrame splits the
+    // reference points of a frame further, so that the scheduler balances many small frames as well as few large ones
+    util::ProfilePhase profile_phase(m_profiler, "pairs");
+    parallel_for(blocked_range<size_t>(0,n_frames),
       [=] (const blocked_range<size_t>& r)
       {
+      util::ScopedRange task_annotation("freud::RDF::accumulateFrames::frames");
+      for (size_t f = r.begin(); f != r.end(); f++)
+          {
+          box::Box box = boxes[f];
+          const vec3<float> *frame_points = points + f*Np;
+          if (locality::PeriodicImages::needed(box, m_rmax))
+              {
+              binImages(box, ref_points + f*Nref, Nref, frame_points, Np, NULL, NULL);
+              continue;
+              }
+          locality::LinkCell lc(box, m_rmax);
+          locality::WorkPartition partition;
+          lc.computeCellList(box, frame_points, Np, true);
+          binFrame(box, &lc, ref_points + f*Nref, Nref, frame_points, Np, NULL, NULL, NULL, locality::PARTITION_AUTO,
+                   &partition);
+          }
+      });
+
+    m_box = boxes[n_frames-1];
+    m_Np = Np;
+    m_n_ref = Nref;
+    m_frame_counter += n_frames;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Bin the pairs of one frame among the explicit periodic images of the points
+
+    Every pair is tested against all of its images within rmax, so this is only used when rmax exceeds half the box
+    and a reference point has a sizable fraction of all points as neighbors anyway. As with the cell list, the pair
+    of a point with itself is binned at r = 0; its other images are binned at their distance.
+*/
+void RDF::binImages(const box::Box& box,
+                    const vec3<float> *ref_points,
+                    unsigned int Nref,
+                    const vec3<float> *points,
+                    unsigned int Np,
+                    const float *ref_weights,
+                    const float *weights)
+    {
+    util::ScopedRange annotation("freud::RDF::binImages");
+    locality::PeriodicImages images(box, m_rmax);
+    parallel_for(blocked_range<size_t>(0,Nref),
+      [=, &images] (const blocked_range<size_t>& r)
+      {
+      util::ScopedRange task_annotation("freud::RDF::binImages::points");
+      bool exists;
+      m_local_bin_counts.local(exists);
+      if (! exists)
+          {
+          m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_nbins);
+          }
+      util::BinCount *local_bins = m_local_bin_counts.local();
+      double *local_smooth = (m_kernel_width > 0.0f) ? localSmoothCounts() : NULL;
+      double *local_weighted = (weights != NULL) ? localWeightedCounts() : NULL;
+      const bool is2D = box.is2D();
+      util::ProfileCount tested, accepted;
+
+      for (size_t i = r.begin(); i != r.end(); i++)
+          {
+          tested.add(Np);
+          if (m_point_histograms)
+              clearPointHistogram(i);
+          images.forEachNeighbor(ref_points[i], points, Np,
+              [&] (unsigned int j, const vec3<float>& delta, float rsq, bool zero_image)
+              {
+              accepted.add(1);
+              if (local_smooth != NULL)
+                  addSmoothPair(local_smooth, sqrtf(rsq), 1.0, is2D);
+              unsigned int bin = m_bin_edges.getBin(sqrtf(rsq));
+              if (bin < m_nbins)
+                  {
+                  ++local_bins[bin];
+                  if (local_weighted != NULL)
+                      local_weighted[bin] += double(ref_weights[i]) * weights[j];
+                  if (m_point_histograms)
+                      countPointPair(i, bin);
+                  }
+              });
+          }
+      tested.addTo(m_profiler, "pairs_tested");
+      accepted.addTo(m_profiler, "pairs_accepted");
+      });
+    }
+
+//! \internal
+/*! \brief Bin the pairs of one frame into the thread specific histograms
+
+    \param lc Cell list of \a points computed with sorted points, unused when \a nlist is given
+    \param mode How the loop is split; PARTITION_AFFINITY uses the partitioner of this object, so binFrame must
+                 then not be called concurrently
+    \param partition Storage of the cell order and of the ranges of PARTITION_COST, one per concurrent call
+*/
+void RDF::binFrame(const box::Box& box,
+                   const locality::LinkCell *lc,
+                   const vec3<float> *ref_points,
+                   unsigned int Nref,
+                   const vec3<float> *points,
+                   unsigned int Np,
+                   const float *ref_weights,
+                   const float *weights,
+                   const locality::NeighborList *nlist,
+                   locality::PartitionMode mode,
+                   locality::WorkPartition *partition)
+    {
+    // the pairs of a reference point may be split between the pair blocks, so its histogram, and the bonds of a
+    // neighbor list, are only visited by reference point
+    if (mode == locality::PARTITION_PAIR_BLOCKS && (nlist != NULL || m_point_histograms))
+        mode = locality::PARTITION_COST;
+
+    if (nlist == NULL && ref_points == points && ref_weights == weights && Nref == Np && !m_point_histograms &&
+        mode != locality::PARTITION_PAIR_BLOCKS)
+        {
+        // the rdf of a set of points with itself is symmetric: visit each unordered pair once with the half
+        // stencil and count it for both of its points; the histograms of the points would then be written by two
+        // threads, so they are filled by the loop below instead
+        unsigned int self_bin = m_bin_edges.getBin(0.0f);
+        const unsigned int *cell_start = lc->getCellStart().get();
+        const unsigned int *cell_particles = lc->getCellParticles().get();
+        if (mode == locality::PARTITION_COST)
+            {
+            // a cell costs its number of points times those of its half stencil
+            partition->split(lc->getNumCells(),
+                [=] (size_t cell)
+                {
+                const locality::CellNeighbors& neigh_cells = lc->getCellNeighborsHalf(cell);
+                unsigned int neighbors = 0;
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                    neighbors += cell_start[neigh_cells[neigh_idx]+1] - cell_start[neigh_cells[neigh_idx]];
+                return double(cell_start[cell+1] - cell_start[cell])*(1.0 + neighbors);
+                }, locality::defaultNumChunks());
+            }
+        locality::parallelForPartitioned(mode, lc->getNumCells(), NULL, partition, &m_affinity,
+          "freud::RDF::binFrame::halfPairs",
+          [=] (const blocked_range<size_t>& r, const unsigned int *order)
+          {
+          float rmaxsq = m_rmax * m_rmax;
+
+          bool exists;
+          m_local_bin_counts.local(exists);
+          if (! exists)
+              {
+              m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_nbins);
+              }
+          util::BinCount *local_bins = m_local_bin_counts.local();
+          double *local_smooth = (m_kernel_width > 0.0f) ? localSmoothCounts() : NULL;
+          double *local_weighted = (weights != NULL) ? localWeightedCounts() : NULL;
+          const bool is2D = box.is2D();
+          util::ProfileCount tested, accepted;
+
+          for (size_t pos = r.begin(); pos != r.end(); pos++)
+              {
+              size_t cell = (order != NULL) ? order[pos] : pos;
+              unsigned int num_cell = cell_start[cell+1] - cell_start[cell];
+
+              // every point is at distance zero from itself
+              if (self_bin < m_nbins)
+                  {
+                  local_bins[self_bin] += num_cell;
+                  if (local_weighted != NULL)
+                      for (unsigned int k = cell_start[cell]; k != cell_start[cell+1]; k++)
+                          {
+                          double w = weights[cell_particles[k]];
+                          local_weighted[self_bin] += w*w;
+                          }
+                  }
+
+#ifdef FREUD_PROFILING
+              // the pairs of the cell, and those with the cells of its half stencil
+              const locality::CellNeighbors& neigh_cells = lc->getCellNeighborsHalf(cell);
+              unsigned long long num_neighbors = 0;
+              for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                  num_neighbors += cell_start[neigh_cells[neigh_idx]+1] - cell_start[neigh_cells[neigh_idx]];
+              tested.add((unsigned long long) num_cell*(num_cell - (num_cell > 0)) / 2 + num_cell*num_neighbors);
+#endif
+
+              lc->forEachHalfPair(cell, points, rmaxsq,
+                  [=, &accepted] (unsigned int i, unsigned int j, const vec3<float>& delta, float rsq)
+                  {
+                  accepted.add(1);
+                  float r = sqrtf(rsq);
+                  if (local_smooth != NULL)
+                      addSmoothPair(local_smooth, r, 2.0, is2D);
+                  unsigned int bin = m_bin_edges.getBin(r);
+
+                  if (bin < m_nbins)
+                      {
+                      local_bins[bin] += 2;
+                      if (local_weighted != NULL)
+                          local_weighted[bin] += 2.0 * weights[i] * weights[j];
+                      }
+                  });
+              }
+          tested.addTo(m_profiler, "pairs_tested");
+          accepted.addTo(m_profiler, "pairs_accepted");
+          });
+        return;
+        }
+
+    // the points sorted by cell, so that the pair loop streams through contiguous memory
+    const vec3<float> *sorted_points = lc->getSortedPoints().get();
+    const unsigned int *cell_start = lc->getCellStart().get();
+    const unsigned int *cell_particles = lc->getCellParticles().get();
+    const unsigned int *order = NULL;
+    if (mode == locality::PARTITION_PAIR_BLOCKS)
+        {
+        // the pairs of the dense cells of clustered systems are split between several tasks, which the idle
+        // threads steal
+        partition->splitPairBlocks(*lc, ref_points, Nref, locality::defaultNumChunks());
+        partition->parallelForPairBlocks(
+          [=] (const locality::PairBlock *first, const locality::PairBlock *last, const unsigned int *order)
+          {
+          util::ScopedRange annotation("freud::RDF::binFrame::pairBlocks");
+          float rmaxsq = m_rmax * m_rmax;
+
+          bool exists;
+          m_local_bin_counts.local(exists);
+          if (! exists)
+              {
+              m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_nbins);
+              }
+          util::BinCount *local_bins = m_local_bin_counts.local();
+          double *local_smooth = (m_kernel_width > 0.0f) ? localSmoothCounts() : NULL;
+          double *local_weighted = (weights != NULL) ? localWeightedCounts() : NULL;
+          const bool is2D = box.is2D();
+          locality::DistanceKernel kernel(box);
+          util::ProfileCount tested, accepted;
+
+          locality::forEachPairBlockRange(*lc, first, last, order,
+              [&] (unsigned int i, unsigned int begin, unsigned int end)
+              {
+              tested.add(end - begin);
+              kernel.forEachWithin(ref_points[i], sorted_points + begin, end - begin, rmaxsq,
+                  [&] (unsigned int k, const vec3<float>& delta, float rsq)
+                  {
+                  accepted.add(1);
+                  float r = sqrtf(rsq);
+                  if (local_smooth != NULL)
+                      addSmoothPair(local_smooth, r, 1.0, is2D);
+                  unsigned int bin = m_bin_edges.getBin(r);
+
+                  if (bin < m_nbins)
+                      {
+                      ++local_bins[bin];
+                      if (local_weighted != NULL)
+                          local_weighted[bin] += double(ref_weights[i]) * weights[cell_particles[begin + k]];
+                      }
+                  });
+              });
+          tested.addTo(m_profiler, "pairs_tested");
+          accepted.addTo(m_profiler, "pairs_accepted");
+          });
+        return;
+        }
+    if (mode == locality::PARTITION_COST)
+        {
+        // by the number of bonds with a neighbor list, or by cell
+        if (nlist != NULL)
+            partition->split(Nref,
+                [=] (size_t i) { return 1.0 + nlist->getLastBond(i) - nlist->getFirstBond(i); },
+                locality::defaultNumChunks());
+        else
+            partition->splitByCell(*lc, ref_points, Nref, locality::defaultNumChunks());
+        }
+    else if (nlist == NULL && m_cell_order && Nref >= locality::CELL_ORDER_MIN_POINTS)
+        {
+        // consecutive reference points of a task share their neighbor cells
+        order = partition->orderByCell(*lc, ref_points, Nref, points, Np);
+        }
+    locality::parallelForPartitioned(mode, Nref, order, partition, &m_affinity, "freud::RDF::binFrame",
+      [=] (const blocked_range<size_t>& r, const unsigned int *order)
+      {
       assert(ref_points);
       assert(points);
-      assert(m_n_ref > 0);
+      assert(Nref > 0);
       assert(Np > 0);
 
-      float dr_inv = 1.0f / m_dr;
       float rmaxsq = m_rmax * m_rmax;
 
       bool exists;
       m_local_bin_counts.local(exists);
       if (! exists)
           {
-          m_local_bin_counts.local() = new unsigned int [m_nbins];
-          memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_nbins);
+          m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_nbins);
           }
+      util::BinCount *local_bins = m_local_bin_counts.local();
+      double *local_smooth = (m_kernel_width > 0.0f) ? localSmoothCounts() : NULL;
+      double *local_weighted = (weights != NULL) ? localWeightedCounts() : NULL;
+      const bool is2D = box.is2D();
+      locality::DistanceKernel kernel(box);
+      util::ProfileCount tested, accepted;
 
       // for each reference point
-      for (size_t i = r.begin(); i != r.end(); i++)
+      for (size_t pos = r.begin(); pos != r.end(); pos++)
           {
+          size_t i = (order != NULL) ? order[pos] : pos;
+          if (m_point_histograms)
+              clearPointHistogram(i);
+          if (nlist != NULL)
+              {
+              // bin the precomputed bond distances
+              const float *distances = nlist->getDistances().get();
+              const unsigned int *index_j = nlist->getIndexJ().get();
+              size_t last_bond = nlist->getLastBondWithin(i, m_rmax);
+              for (size_t bond = nlist->getFirstBond(i); bond < last_bond; bond++)
+                  {
+                  float r = distances[bond];
+                  if (r < m_rmax)
+                      {
+                      if (local_smooth != NULL)
+                          addSmoothPair(local_smooth, r, 1.0, is2D);
+                      unsigned int bin = m_bin_edges.getBin(r);
+
+                      if (bin < m_nbins)
+                          {
+                          ++m_local_bin_counts.local()[bin];
+                          if (local_weighted != NULL)
+                              local_weighted[bin] += double(ref_weights[i]) * weights[index_j[bond]];
+                          if (m_point_histograms)
+                              countPointPair(i, bin);
+                          }
+                      }
+                  }
+              continue;
+              }
+
           // get the cell the point is in
           vec3<float> ref = ref_points[i];
-          unsigned int ref_cell = m_lc->getCell(ref);
+          unsigned int ref_cell = lc->getCell(ref);
 
           // loop over all neighboring cells
-          const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+          const locality::CellNeighbors& neigh_cells = lc->getCellNeighbors(ref_cell);
           for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
               {
               unsigned int neigh_cell = neigh_cells[neigh_idx];
 
               // iterate over the particles in that cell
-              locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-              for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+              unsigned int begin = cell_start[neigh_cell];
+              tested.add(cell_start[neigh_cell+1] - begin);
+              kernel.forEachWithin(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin, rmaxsq,
+                  [&] (unsigned int k, const vec3<float>& delta, float rsq)
                   {
-                  // compute r between the two particles
-                  vec3<float> delta = m_box.wrap(points[j] - ref);
+                  accepted.add(1);
+                  float r = sqrtf(rsq);
+                  if (local_smooth != NULL)
+                      addSmoothPair(local_smooth, r, 1.0, is2D);
 
-                  float rsq = dot(delta, delta);
+                  // bin that r
+                  unsigned int bin = m_bin_edges.getBin(r);
 
-                  if (rsq < rmaxsq)
+                  if (bin < m_nbins)
                       {
-                      float r = sqrtf(rsq);
-
-                      // bin that r
-                      float binr = r * dr_inv;
-                      // fast float to int conversion with truncation
-                      #ifdef __SSE2__
-                      unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
-                      #else
-                      unsigned int bin = (unsigned int)(binr);
-                      #endif
-
-                      if (bin < m_nbins)
-                          {
-                          ++m_local_bin_counts.local()[bin];
-                          }
+                      ++local_bins[bin];
+                      if (local_weighted != NULL)
+                          local_weighted[bin] += double(ref_weights[i]) * weights[cell_particles[begin + k]];
+                      if (m_point_histograms)
+                          countPointPair(i, bin);
                       }
-                  }
+                  });
               }
           } // done looping over reference points
+      tested.addTo(m_profiler, "pairs_tested");
+      accepted.addTo(m_profiler, "pairs_accepted");
       });
-    m_frame_counter += 1;
     }
 
 }; }; // end namespace freud::density
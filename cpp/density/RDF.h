@@ -3,6 +3,8 @@
 
 #include <tbb/tbb.h>
 #include <ostream>
+#include <cstring>
+#include <stdint.h>
 
 // work around nasty issue where python #defines isalpha, toupper, etc....
 #undef __APPLE__
@@ -10,13 +12,25 @@
 #define __APPLE__
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "SharedLinkCell.h"
+#include "FrameAnalysis.h"
+#include "PeriodicImages.h"
+#include "WorkPartition.h"
 #include "box.h"
 #include "Index1D.h"
+#include "BinCount.h"
+#include "HistogramReduction.h"
+#include "MemoryUsage.h"
+#include "BinEdges.h"
+#include "PairBinnerGPU.h"
+#include "Profiler.h"
 
 #ifndef _RDF_H__
 #define _RDF_H__
@@ -26,12 +40,15 @@
 */
 
 namespace freud { namespace density {
-class RDF
+class RDF : public locality::PairAnalysis
     {
     public:
         //! Constructor
         RDF(float rmax, float dr);
 
+        //! Constructor with arbitrary increasing bin edges
+        RDF(const std::vector<float>& bin_edges);
+
         //! Destructor
         ~RDF();
 
@@ -45,19 +62,114 @@ class RDF
         void resetRDF();
 
         //! Compute the RDF
+        /*! If \a nlist is given, its bonds are binned instead of building the internal cell list. When rmax exceeds
+            half of the box along a periodic direction, the pairs are found among the explicit periodic images of the
+            points (see locality::PeriodicImages) instead, so that g(r) is defined beyond half the box.
+
+            When \a ref_weights and \a weights are given, one per reference point and per point, each pair also adds
+            the product of the weights of its points to weighted counts of the thread, in the same traversal; see
+            getWeightedRDF(). Weighted frames are binned on the CPU.
+        */
         void accumulate(box::Box& box,
                         const vec3<float> *ref_points,
                         unsigned int n_ref,
                         const vec3<float> *points,
-                        unsigned int Np);
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL,
+                        const float *ref_weights=NULL,
+                        const float *weights=NULL);
+
+        //! Compute the RDF of points given as separate x, y and z arrays
+        /*! The cell list and its sorted copy of the points are built from the arrays directly; only the reference
+            points are interleaved, into a buffer kept across frames, and not even they when they are the points.
+        */
+        void accumulate(box::Box& box,
+                        const float *ref_x,
+                        const float *ref_y,
+                        const float *ref_z,
+                        unsigned int n_ref,
+                        const float *x,
+                        const float *y,
+                        const float *z,
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
+
+        //! Get the cutoff of the pairs binned as an analysis of a locality::FrameAnalysis
+        float getPairRMax() const
+            {
+            return m_rmax;
+            }
+
+        //! Start accumulating a frame from the neighbors found by a locality::FrameAnalysis
+        void beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                        const vec3<float> *points, unsigned int Np);
+
+        //! Bin the neighbors of one reference point found by a locality::FrameAnalysis
+        void processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors);
+
+        //! Count the frame accumulated from the neighbors found by a locality::FrameAnalysis
+        void endFrame();
+
+        //! Compute the RDF of the points of one domain of a frame split by a locality::DomainDecomposition
+        /*! The reference points are the n_owned first points, those the domain owns, and the points are those and
+            the ghosts of the domain, in the coordinates of the box of the domain, so that the histograms of all the
+            domains of the frame add up to that of the frame. The rdf is normalized by frame_box and the frame_Np
+            points of the whole frame, and the frame is counted only if count_frame, by one domain, so that merging
+            the rdfs of all the domains (see merge() and loadState()) gives that of the frames.
+        */
+        void accumulateDomain(box::Box& box,
+                              const vec3<float> *points,
+                              unsigned int n_owned,
+                              unsigned int Np,
+                              const box::Box& frame_box,
+                              unsigned int frame_Np,
+                              bool count_frame);
+
+        //! Compute the RDF of a stack of frames in one call
+        /*! Frame f is made of boxes[f], ref_points[f*n_ref, (f+1)*n_ref) and points[f*Np, (f+1)*Np). Frames and
+            reference points are processed in parallel together, which balances the work also when there are many
+            frames of few points.
+        */
+        void accumulateFrames(const box::Box *boxes,
+                              const vec3<float> *ref_points,
+                              unsigned int n_ref,
+                              const vec3<float> *points,
+                              unsigned int Np,
+                              unsigned int n_frames);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
         void reduceRDF();
 
+        //! Save the accumulated histogram, the number of frames and the box and numbers of points of the last frame
+        //! to a checkpoint file
+        void saveState(const std::string& filename);
+
+        //! Restore the state of a checkpoint file, or add it to the accumulated state if merge
+        /*! The bins must be the same. When merging, the box and numbers of points that normalize the rdf stay those
+            of this object, unless it has no frame yet.
+        */
+        void loadState(const std::string& filename, bool merge=false);
+
+        //! Add the accumulated state of another RDF of the same bins, such as one of another chunk of a trajectory
+        void merge(const RDF& other);
+
         //! Get a reference to the last computed rdf
         std::shared_ptr<float> getRDF();
 
+        //! Get a reference to the rdf of the weighted counts
+        /*! The weighted counts are normalized as the counts of the rdf, so that weights of 1 give the rdf, and are
+            binned even while the pairs are smoothed; their first bin is left out when it starts at r = 0. The frames
+            accumulated without weights add nothing to them, and they are not saved to checkpoints.
+        */
+        std::shared_ptr<float> getWeightedRDF();
+
+        //! Get whether a weighted frame was accumulated since the last reset
+        bool getWeighted() const
+            {
+            return m_weighted;
+            }
+
         //! Get a reference to the r array
         std::shared_ptr<float> getR();
 
@@ -66,25 +178,278 @@ class RDF
 
         unsigned int getNBins();
 
+        //! Set how the loops over the reference points (or cells) of accumulate() are split between the threads
+        /*! PARTITION_COST balances inhomogeneous systems by the estimated number of pairs, and
+            PARTITION_AFFINITY keeps the same points on the same threads from one frame to the next.
+            PARTITION_PAIR_BLOCKS also splits the pairs of the densest cells, for strongly clustered systems; it
+            visits the pairs of a set of points with itself twice, and falls back to PARTITION_COST with a neighbor
+            list or the histograms of the points. The frames of accumulateFrames() are always split with the
+            auto_partitioner, as they are binned concurrently.
+        */
+        void setPartitionMode(locality::PartitionMode mode)
+            {
+            m_partition_mode = mode;
+            }
+
+        //! Get how the loops of accumulate() are split between the threads
+        locality::PartitionMode getPartitionMode() const
+            {
+            return m_partition_mode;
+            }
+
+        //! Set whether the reference points are visited in the order of their cells, when there are at least
+        //! locality::CELL_ORDER_MIN_POINTS of them (the default) or never
+        void setCellOrder(bool cell_order)
+            {
+            m_cell_order = cell_order;
+            }
+
+        //! Get whether the reference points are visited in the order of their cells
+        bool getCellOrder() const
+            {
+            return m_cell_order;
+            }
+
+        //! Share a LinkCell with other analyses of the same points, or use an own one again if \a lc is NULL
+        /*! The cell width of \a lc must be at least the cutoff; its cell list is only computed when it is not
+            already that of the frame (see locality::SharedLinkCell).
+        */
+        void setLinkCell(std::shared_ptr<locality::LinkCell> lc)
+            {
+            m_lc.share(lc);
+            }
+
+        //! Set whether accumulate() bins the pairs on a CUDA GPU when no neighbor list is given
+        /*! Throws std::runtime_error when freud was built without CUDA or no device is found. The histogram of each
+            frame is added to the accumulated one on the host, so the GPU and the CPU can be switched between frames;
+            accumulateFrames() always runs on the CPU.
+        */
+        void setUseGPU(bool use_gpu);
+
+        //! Get whether accumulate() bins the pairs on the GPU
+        bool getUseGPU() const
+            {
+            return bool(m_gpu);
+            }
+
+        //! Set the width of the Gaussian kernel that smooths the distance of each pair over the bins, 0 to bin them
+        /*! Each pair at distance r > 0 adds to the bins the integrals over them of a normalized Gaussian of standard
+            deviation sigma centered on r, divided by the measure of the sphere of radius r, read from a table of the
+            weights of the bins within 4 sigma of r at 64 positions of r within its bin. The rdf is this kernel
+            density estimate of g(r), which has no bias from the growth of the shells with r and converges in fewer
+            frames, and N(r) its integral. The pairs are only found up to rmax, so the bins within 4 sigma of rmax
+            are biased low. Needs bins of equal widths and resets the smoothed counts; checkpoints are not supported and
+            the GPU is not used while smoothing.
+        */
+        void setKernelWidth(float sigma);
+
+        //! Get the width of the Gaussian kernel, 0 when the pairs are binned
+        float getKernelWidth() const
+            {
+            return m_kernel_width;
+            }
+
+        //! Set whether accumulate() also fills a histogram of the pairs of each reference point of the frame
+        /*! The histogram of a reference point is filled by the thread that visits it in the same traversal as the
+            rdf, so the histograms need no reduction; they are those of the last frame, n_ref rows of nbins counts.
+            With compact, the counts are 16 bit and saturate at 65535. While they are kept, the pairs of a set of
+            points with itself are visited once per point instead of once per pair, the GPU is not used, and
+            accumulateFrames() throws std::invalid_argument.
+        */
+        void setPointHistograms(bool enable, bool compact=false);
+
+        //! Get whether accumulate() fills the histograms of the reference points
+        bool getPointHistograms() const
+            {
+            return m_point_histograms;
+            }
+
+        //! Get whether the histograms of the reference points are counted in 16 bits
+        bool getPointHistogramsCompact() const
+            {
+            return m_point_compact;
+            }
+
+        //! Get the number of reference points of the histograms of the last frame
+        unsigned int getNumPointHistograms() const
+            {
+            return m_n_point_histograms;
+            }
+
+        //! Get the histograms of the reference points of the last frame, when they are not compact
+        std::shared_ptr<unsigned int> getPointCounts()
+            {
+            return m_point_counts;
+            }
+
+        //! Get the histograms of the reference points of the last frame, when they are compact
+        std::shared_ptr<uint16_t> getPointCountsCompact()
+            {
+            return m_point_counts_compact;
+            }
+
+        //! Get the nbins + 1 edges of the r bins
+        const std::vector<float>& getBinEdges() const
+            {
+            return m_bin_edges.getEdges();
+            }
+
+        //! Get the wall times of the phases and the counters of the last accumulate call and of the reduction after
+        //! it, which are only recorded when freud is built with ENABLE_PROFILING
+        /*! The phases are cell_list, pairs (the binning on the CPU), gpu and reduce, the counters pairs_tested (the
+            distances computed), pairs_accepted (those within rmax), bonds (those of a neighbor list) and cells.
+        */
+        const util::Profiler& getProfiler() const
+            {
+            return m_profiler;
+            }
+
+        //! Get the bytes allocated by each component: histogram (the arrays shared by the threads), local_histograms
+        //! (the copies of the threads), point_histograms, cell_list (unless it is shared) and points (the buffers of
+        //! the interleaved points)
+        util::MemoryUsage getMemoryUsage() const;
+
+        //! Estimate the bytes of each component after accumulate() of N reference points and N points on
+        //! num_threads threads, 0 for those of the current task arena, with the current options
+        util::MemoryUsage estimateMemory(unsigned int N, unsigned int num_threads) const;
+
     private:
+        //! Add the histogram of some frames to the accumulated one
+        void addState(const util::BinCount *counts, unsigned int frame_counter, const box::Box& box,
+                      unsigned int n_ref, unsigned int Np);
+
+        //! Allocate the arrays for the bins
+        void initialize(const util::BinEdges& bin_edges);
+
+        //! Bin the pairs of one frame into the thread specific histograms
+        void binFrame(const box::Box& box,
+                      const locality::LinkCell *lc,
+                      const vec3<float> *ref_points,
+                      unsigned int n_ref,
+                      const vec3<float> *points,
+                      unsigned int Np,
+                      const float *ref_weights,
+                      const float *weights,
+                      const locality::NeighborList *nlist,
+                      locality::PartitionMode mode,
+                      locality::WorkPartition *partition);
+
+        //! Bin the pairs of one frame among the explicit periodic images of the points
+        void binImages(const box::Box& box,
+                       const vec3<float> *ref_points,
+                       unsigned int n_ref,
+                       const vec3<float> *points,
+                       unsigned int Np,
+                       const float *ref_weights,
+                       const float *weights);
+
+        //! Get the smoothed counts of the calling thread, allocating them on first use
+        double *localSmoothCounts();
+
+        //! Get the weighted counts of the calling thread, allocating them on first use
+        double *localWeightedCounts();
+
+        //! Add a pair at distance r > 0 with the given weight, divided by the measure r^(d-1) of its sphere, to
+        //! smoothed counts
+        void addSmoothPair(double *smooth_counts, float r, double weight, bool is2D) const
+            {
+            if (r == 0.0f)
+                return;
+            weight /= is2D ? double(r) : double(r)*r;
+            float x = r * m_kernel_inv_dr;
+            int bin = int(x);
+            unsigned int step = std::min((unsigned int)((x - bin) * KERNEL_TABLE_STEPS), KERNEL_TABLE_STEPS - 1);
+            const double *weights = &m_kernel_table[step * m_kernel_size];
+            int first = bin - int(m_kernel_half);
+            if (first >= 0 && first + m_kernel_size <= m_nbins)
+                {
+                double *counts = smooth_counts + first;
+                for (unsigned int k = 0; k < m_kernel_size; k++)
+                    counts[k] += weight * weights[k];
+                }
+            else
+                {
+                for (unsigned int k = 0; k < m_kernel_size; k++)
+                    {
+                    int b = first + int(k);
+                    if (b >= 0 && b < int(m_nbins))
+                        smooth_counts[b] += weight * weights[k];
+                    }
+                }
+            }
+
+        static const unsigned int KERNEL_TABLE_STEPS = 64;    //!< Positions of r within its bin in the kernel table
+
+        //! Size the histograms of the reference points of a frame, when they are kept
+        void preparePointHistograms(unsigned int n_ref);
+
+        //! Zero the histogram of reference point i
+        void clearPointHistogram(size_t i)
+            {
+            if (m_point_compact)
+                memset((void*)(m_point_counts_compact.get() + i*m_nbins), 0, sizeof(uint16_t)*m_nbins);
+            else
+                memset((void*)(m_point_counts.get() + i*m_nbins), 0, sizeof(unsigned int)*m_nbins);
+            }
+
+        //! Count a pair of reference point i in a bin of its histogram
+        void countPointPair(size_t i, unsigned int bin)
+            {
+            if (m_point_compact)
+                {
+                uint16_t& count = m_point_counts_compact.get()[i*m_nbins + bin];
+                if (count != UINT16_MAX)
+                    ++count;
+                }
+            else
+                ++m_point_counts.get()[i*m_nbins + bin];
+            }
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_rmax;                     //!< Maximum r at which to compute g(r)
         float m_dr;                       //!< Step size for r in the computation
-        locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        locality::SharedLinkCell m_lc;    //!< LinkCell to bin particles for the computation
         unsigned int m_nbins;             //!< Number of r bins to compute g(r) over
+        util::BinEdges m_bin_edges;       //!< Edges of the r bins
         unsigned int m_n_ref;                  //!< number of reference particles
         unsigned int m_Np;                  //!< number of check particles
         unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
 
         std::shared_ptr<float> m_rdf_array;         //!< rdf array computed
-        std::shared_ptr<unsigned int> m_bin_counts; //!< bin counts that go into computing the rdf array
+        std::shared_ptr<util::BinCount> m_bin_counts; //!< bin counts that go into computing the rdf array
         std::shared_ptr<float> m_avg_counts; //!< bin counts that go into computing the rdf array
         std::shared_ptr<float> m_N_r_array;         //!< Cumulative bin sum N(r)
         std::shared_ptr<float> m_r_array;           //!< array of r values that the rdf is computed at
         std::shared_ptr<float> m_vol_array;         //!< array of volumes for each slice of r
         std::shared_ptr<float> m_vol_array2D;         //!< array of volumes for each slice of r
         std::shared_ptr<float> m_vol_array3D;         //!< array of volumes for each slice of r
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
+        tbb::enumerable_thread_specific<util::BinCount *> m_local_bin_counts;
+        locality::PartitionMode m_partition_mode;   //!< How the loops of accumulate() are split
+        bool m_cell_order;                          //!< true to visit the reference points in cell order
+        locality::WorkPartition m_work_partition;   //!< Cell order and ranges of equal work of accumulate()
+        tbb::affinity_partitioner m_affinity;       //!< Partitioner kept across frames for PARTITION_AFFINITY
+        std::vector< vec3<float> > m_soa_ref_points;  //!< Interleaved reference points of the SoA accumulate()
+        std::vector< vec3<float> > m_soa_points;      //!< Interleaved points of SoA accumulate(), nlist or GPU
+        std::shared_ptr<gpu::PairBinnerGPU> m_gpu;    //!< Binner of the pairs on the GPU, when it is used
+        std::vector<util::BinCount> m_gpu_counts;     //!< Histogram of the frame binned on the GPU
+        util::Profiler m_profiler;                    //!< Timings and counters of the last accumulate call
+        float m_kernel_width;                         //!< Standard deviation of the Gaussian kernel, 0 to bin
+        float m_kernel_inv_dr;                        //!< Inverse of the width of the bins
+        unsigned int m_kernel_half;                   //!< Number of bins on each side of a pair weighted
+        unsigned int m_kernel_size;                   //!< Number of bins weighted per pair, 2 m_kernel_half + 1
+        std::vector<double> m_kernel_table;           //!< Weights of the bins by position of r within its bin
+        tbb::enumerable_thread_specific<double *> m_local_smooth_counts;  //!< Smoothed counts of each thread
+        std::vector<double> m_smooth_counts;          //!< Reduced smoothed counts
+        tbb::enumerable_thread_specific<double *> m_local_weighted_counts;  //!< Weighted counts of each thread
+        std::vector<double> m_weighted_counts;        //!< Reduced weighted counts
+        std::shared_ptr<float> m_weighted_rdf_array;  //!< rdf of the weighted counts
+        bool m_weighted;                              //!< true if a weighted frame was accumulated
+        bool m_point_histograms;                      //!< true to fill the histograms of the reference points
+        bool m_point_compact;                         //!< true to count them in 16 bits
+        unsigned int m_n_point_histograms;            //!< Number of reference points of the histograms
+        std::shared_ptr<unsigned int> m_point_counts;         //!< Histograms of the reference points
+        std::shared_ptr<uint16_t> m_point_counts_compact;     //!< Compact histograms of the reference points
     };
 
 }; }; // end namespace freud::density
@@ -0,0 +1,88 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Displacement.h"
+#include "Annotation.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file Displacement.cc
+    \brief Minimum image displacements and image flags of the particles of a stream of trajectory frames
+*/
+
+namespace freud { namespace dynamics {
+
+Displacement::Displacement()
+    : m_box(box::Box()), m_Np(0), m_frame_counter(0), m_max_displacement(0.0f)
+    {
+    }
+
+float Displacement::compute(const box::Box& box, const vec3<float> *last, const vec3<float> *current,
+                            unsigned int Np, vec3<float> *displacements, vec3<int> *images)
+    {
+    util::ScopedRange annotation("freud::Displacement::compute");
+    const box::WrapContext& wrap_ctx = box.getWrapContext();
+    float max_rsq = parallel_reduce(blocked_range<size_t>(0, Np), 0.0f,
+        [=, &wrap_ctx] (const blocked_range<size_t>& r, float max_rsq)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            // wrap adds the lattice vectors it removes from current - last, which current must add to stay
+            // unwrapped like last
+            vec3<int> removed(0, 0, 0);
+            vec3<float> delta = wrap_ctx.wrap(current[i] - last[i], removed);
+            if (displacements != NULL)
+                displacements[i] = delta;
+            if (images != NULL)
+                {
+                images[i].x -= removed.x;
+                images[i].y -= removed.y;
+                images[i].z -= removed.z;
+                }
+            max_rsq = max(max_rsq, dot(delta, delta));
+            }
+        return max_rsq;
+        },
+        [] (float a, float b)
+        {
+        return max(a, b);
+        });
+    return sqrtf(max_rsq);
+    }
+
+void Displacement::reset()
+    {
+    m_Np = 0;
+    m_frame_counter = 0;
+    m_max_displacement = 0.0f;
+    m_last.clear();
+    m_displacement_array.reset();
+    m_image_array.reset();
+    }
+
+void Displacement::update(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    m_box = box;
+    if (m_frame_counter == 0 || Np != m_Np)
+        {
+        m_Np = Np;
+        m_frame_counter = 0;
+        m_max_displacement = 0.0f;
+        m_displacement_array = std::shared_ptr< vec3<float> >(new vec3<float>[Np],
+                                                              std::default_delete< vec3<float>[]>());
+        m_image_array = std::shared_ptr< vec3<int> >(new vec3<int>[Np], std::default_delete< vec3<int>[]>());
+        memset((void*)m_displacement_array.get(), 0, sizeof(vec3<float>)*Np);
+        memset((void*)m_image_array.get(), 0, sizeof(vec3<int>)*Np);
+        }
+    else
+        m_max_displacement = compute(m_box, m_last.data(), points, Np, m_displacement_array.get(),
+                                     m_image_array.get());
+    m_last.assign(points, points + Np);
+    m_frame_counter++;
+    }
+
+}; }; // end namespace freud::dynamics
@@ -0,0 +1,104 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+
+#ifndef _DISPLACEMENT_H__
+#define _DISPLACEMENT_H__
+
+/*! \file Displacement.h
+    \brief Minimum image displacements and image flags of the particles of a stream of trajectory frames
+*/
+
+namespace freud { namespace dynamics {
+
+//! Follows the particles of a stream of frames of wrapped positions
+/*! Each frame given to update() is compared with the previous one, in a single parallel pass over the particles
+    that computes the minimum image displacement of each particle, adds the lattice vectors the wrap removed to its
+    image flags, and finds the largest displacement. The image flags count from the first frame, so the unwrapped
+    positions, as in Box::unwrap(), are continuous as long as no particle moves by more than half the box between two
+    frames, and they and the positions can be given to MSD directly.
+
+    The box of the frames should stay the same: the displacements and image flags are those of the box of each
+    update.
+*/
+class Displacement
+    {
+    public:
+        //! Constructor
+        Displacement();
+
+        //! Compute the minimum image displacements from the positions last to current in box, in parallel
+        /*! \param displacements minimum image displacement of each particle, or NULL
+            \param images image flags of each particle, to which the lattice vectors the wrap removed are added so
+                   that current stays unwrapped like last, or NULL
+            \returns the largest displacement
+        */
+        static float compute(const box::Box& box, const vec3<float> *last, const vec3<float> *current,
+                             unsigned int Np, vec3<float> *displacements, vec3<int> *images);
+
+        //! Forget the previous frame and the image flags
+        void reset();
+
+        //! Compare a frame with the previous one, or start the stream from it
+        /*! The first frame, and any frame of a different number of particles, restarts the stream: the
+            displacements and the image flags are zero.
+        */
+        void update(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Get the box of the last frame
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the minimum image displacement of each particle since the previous frame
+        std::shared_ptr< vec3<float> > getDisplacements()
+            {
+            return m_displacement_array;
+            }
+
+        //! Get the image flags of each particle since the first frame
+        std::shared_ptr< vec3<int> > getImages()
+            {
+            return m_image_array;
+            }
+
+        //! Get the largest displacement since the previous frame
+        float getMaxDisplacement() const
+            {
+            return m_max_displacement;
+            }
+
+        //! Get the number of frames since the stream started
+        unsigned int getFrameCounter() const
+            {
+            return m_frame_counter;
+            }
+
+        //! Get the number of particles
+        unsigned int getNP() const
+            {
+            return m_Np;
+            }
+
+    private:
+        box::Box m_box;                                     //!< Box of the last frame
+        unsigned int m_Np;                                  //!< Number of particles
+        unsigned int m_frame_counter;                       //!< Number of frames since the stream started
+        float m_max_displacement;                           //!< Largest displacement since the previous frame
+        std::vector< vec3<float> > m_last;                  //!< Positions of the previous frame
+        std::shared_ptr< vec3<float> > m_displacement_array;    //!< Displacements since the previous frame
+        std::shared_ptr< vec3<int> > m_image_array;         //!< Image flags since the first frame
+    };
+
+}; }; // end namespace freud::dynamics
+
+#endif // _DISPLACEMENT_H__
@@ -0,0 +1,122 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "MSD.h"
+#include "FFT.h"
+
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file MSD.cc
+    \brief Mean squared displacement of trajectories over all time origins
+*/
+
+namespace freud { namespace dynamics {
+
+MSD::MSD()
+    : m_num_frames(0), m_Np(0)
+    {
+    m_msd_array = std::shared_ptr<double>(new double[1], std::default_delete<double[]>());
+    m_msd_array.get()[0] = 0.0;
+    }
+
+//! \internal
+//! Add the autocorrelation sum_t Re(conj(s(t)) s(t + m)) of the first n values of signal to acf, for m < n
+/*! The signal holds n values followed by zeros up to its power of two length, at least 2n, so that the circular
+    correlation computed through the transform does not wrap around.
+*/
+static void addAutocorrelation(std::vector<std::complex<double> >& signal, unsigned int n, double *acf)
+    {
+    const unsigned int m = signal.size();
+    util::fft1D(&signal[0], m, false);
+    for (unsigned int k = 0; k < m; k++)
+        signal[k] = std::norm(signal[k]);
+    util::fft1D(&signal[0], m, true);
+    for (unsigned int lag = 0; lag < n; lag++)
+        acf[lag] += signal[lag].real() / double(m);
+    }
+
+void MSD::compute(const box::Box& box, const vec3<float> *positions, const vec3<int> *images,
+                  unsigned int num_frames, unsigned int Np)
+    {
+    m_num_frames = num_frames;
+    m_Np = Np;
+    m_msd_array = std::shared_ptr<double>(new double[std::max(num_frames, 1u)], std::default_delete<double[]>());
+    memset((void*)m_msd_array.get(), 0, sizeof(double)*std::max(num_frames, 1u));
+    if (num_frames == 0 || Np == 0)
+        return;
+
+    // zero padding to at least twice the length of the trajectory
+    unsigned int fft_size = 1;
+    while (fft_size < 2*num_frames)
+        fft_size <<= 1;
+    const bool is2D = box.is2D();
+
+    enumerable_thread_specific< std::vector<double> > local_msd(std::vector<double>(num_frames, 0.0));
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=, &box, &local_msd] (const blocked_range<size_t>& r)
+        {
+        std::vector<double>& msd = local_msd.local();
+        std::vector< vec3<double> > traj(num_frames);
+        std::vector<double> acf(num_frames);
+        std::vector<std::complex<double> > signal(fft_size);
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            // positions relative to the first frame, which leaves the displacements unchanged
+            vec3<double> origin;
+            for (unsigned int t = 0; t < num_frames; t++)
+                {
+                vec3<float> p = positions[size_t(t)*Np + i];
+                if (images != NULL)
+                    p = box.unwrap(p, images[size_t(t)*Np + i]);
+                vec3<double> pd(p.x, p.y, p.z);
+                if (t == 0)
+                    origin = pd;
+                traj[t] = pd - origin;
+                }
+
+            // S2, the autocorrelation of the positions
+            std::fill(acf.begin(), acf.end(), 0.0);
+            std::fill(signal.begin(), signal.end(), 0.0);
+            for (unsigned int t = 0; t < num_frames; t++)
+                signal[t] = std::complex<double>(traj[t].x, traj[t].y);
+            addAutocorrelation(signal, num_frames, &acf[0]);
+            if (!is2D)
+                {
+                std::fill(signal.begin(), signal.end(), 0.0);
+                for (unsigned int t = 0; t < num_frames; t++)
+                    signal[t] = traj[t].z;
+                addAutocorrelation(signal, num_frames, &acf[0]);
+                }
+
+            // S1 from the sum of |r(t)|^2 + |r(t + m)|^2 over the time origins, dropping the two end frames
+            // leaving the window at each lag
+            double q = 0.0;
+            for (unsigned int t = 0; t < num_frames; t++)
+                q += 2.0 * dot(traj[t], traj[t]);
+            for (unsigned int lag = 0; lag < num_frames; lag++)
+                {
+                if (lag > 0)
+                    q -= dot(traj[lag-1], traj[lag-1]) + dot(traj[num_frames-lag], traj[num_frames-lag]);
+                double origins = double(num_frames - lag);
+                msd[lag] += (q - 2.0 * acf[lag]) / origins;
+                }
+            }
+        });
+
+    double *result = m_msd_array.get();
+    for (enumerable_thread_specific< std::vector<double> >::iterator i = local_msd.begin(); i != local_msd.end(); ++i)
+        {
+        for (unsigned int lag = 0; lag < num_frames; lag++)
+            result[lag] += (*i)[lag];
+        }
+    for (unsigned int lag = 0; lag < num_frames; lag++)
+        result[lag] /= double(Np);
+    }
+
+}; }; // end namespace freud::dynamics
@@ -0,0 +1,73 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+
+#ifndef _MSD_H__
+#define _MSD_H__
+
+/*! \file MSD.h
+    \brief Mean squared displacement of trajectories over all time origins
+*/
+
+namespace freud { namespace dynamics {
+
+//! Computes the mean squared displacement of a trajectory, averaged over all time origins
+/*! The windowed MSD(m) = < |r(t + m) - r(t)|^2 > over the T - m time origins t of each lag m is split as
+    S1(m) - 2 S2(m) (Kneller, Keiner, Kneller and Schiller, Comput. Phys. Commun. 91, 191 (1995)). S1 only needs
+    sums of |r(t)|^2, updated from one lag to the next, and S2(m) is the autocorrelation of the positions, computed
+    from the Fourier transform of each trajectory padded to twice its length. This costs O(T log T) per particle
+    instead of the O(T^2) of a direct sum over the time origins, in parallel over the particles.
+
+    Two components of the positions are transformed at once as the real and imaginary parts of a complex signal,
+    since the real part of the autocorrelation of x + i y is the sum of the autocorrelations of x and y.
+*/
+class MSD
+    {
+    public:
+        //! Constructor
+        MSD();
+
+        //! Compute the MSD of a trajectory
+        /*! \param box simulation box the image flags refer to
+            \param positions num_frames frames of Np positions, by frame and then by particle
+            \param images image flags of each position unwrapped with box, or NULL for unwrapped positions
+            \param num_frames number of frames
+            \param Np number of particles
+        */
+        void compute(const box::Box& box, const vec3<float> *positions, const vec3<int> *images,
+                     unsigned int num_frames, unsigned int Np);
+
+        //! Get the MSD at each lag of 0 to num_frames - 1 frames
+        std::shared_ptr<double> getMSD()
+            {
+            return m_msd_array;
+            }
+
+        //! Get the number of frames of the last trajectory
+        unsigned int getNumFrames() const
+            {
+            return m_num_frames;
+            }
+
+        //! Get the number of particles of the last trajectory
+        unsigned int getNP() const
+            {
+            return m_Np;
+            }
+
+    private:
+        unsigned int m_num_frames;              //!< Number of frames of the last trajectory
+        unsigned int m_Np;                      //!< Number of particles of the last trajectory
+        std::shared_ptr<double> m_msd_array;    //!< MSD at each lag
+    };
+
+}; }; // end namespace freud::dynamics
+
+#endif // _MSD_H__
@@ -0,0 +1,217 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "MultipleTau.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file MultipleTau.cc
+    \brief Streaming multiple-tau time correlation of per-particle values
+*/
+
+namespace freud { namespace dynamics {
+
+MultipleTau::MultipleTau(unsigned int num_values, unsigned int dimensions, unsigned int block_size,
+                         unsigned int averaging)
+    : m_num_values(num_values), m_dimensions(dimensions), m_block_size(block_size), m_averaging(averaging),
+      m_frame_counter(0), m_reduce(true), m_num_lags(0)
+    {
+    if (dimensions == 0)
+        throw invalid_argument("dimensions must be positive");
+    if (averaging < 2)
+        throw invalid_argument("averaging must be at least 2");
+    if (block_size < averaging || block_size % averaging != 0)
+        throw invalid_argument("block_size must be a multiple of averaging");
+
+    // one buffer is read by a level while the next level writes the other
+    m_average.resize(2*m_num_values*m_dimensions, 0.0f);
+    m_lags = std::shared_ptr<unsigned int>(new unsigned int[1], std::default_delete<unsigned int[]>());
+    m_correlation_array = std::shared_ptr<double>(new double[1], std::default_delete<double[]>());
+    m_counts_array = std::shared_ptr<unsigned int>(new unsigned int[1], std::default_delete<unsigned int[]>());
+    }
+
+void MultipleTau::reset()
+    {
+    m_levels.clear();
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void MultipleTau::accumulate(const float *values, unsigned int num_values)
+    {
+    if (num_values != m_num_values)
+        throw invalid_argument("the number of values must be the same in every frame");
+    addToLevel(0, values);
+    m_frame_counter++;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! The frame is written in the ring buffer of level k and correlated with the previous frames of the level, in
+    parallel over the values. When the accumulator of the level is full, the same pass writes the average in a
+    buffer, which is then added to level k + 1.
+*/
+void MultipleTau::addToLevel(unsigned int k, const float *values)
+    {
+    const unsigned int p = m_block_size;
+    const unsigned int d = m_dimensions;
+    while (true)
+        {
+        if (k == m_levels.size())
+            {
+            Level level;
+            level.shift.resize(size_t(m_num_values)*p*d, 0.0f);
+            level.accumulator.resize(size_t(m_num_values)*d, 0.0);
+            level.correlation.resize(p, 0.0);
+            level.counts.resize(p, 0);
+            level.num_accumulated = 0;
+            level.num_inserted = 0;
+            level.insert_index = 0;
+            m_levels.push_back(level);
+            }
+        Level& level = m_levels[k];
+
+        // the shorter lags of the coarser levels are already covered by the previous level
+        const unsigned int lag_min = (k == 0) ? 0 : p / m_averaging;
+        const unsigned int lag_end = std::min(p, level.num_inserted + 1);
+        const unsigned int slot = level.insert_index;
+        const bool pass_on = (level.num_accumulated + 1 == m_averaging);
+        const double inv_averaging = 1.0 / double(m_averaging);
+
+        float *shift = &level.shift[0];
+        double *accumulator = &level.accumulator[0];
+        float *average = &m_average[(k % 2)*size_t(m_num_values)*d];
+        enumerable_thread_specific< std::vector<double> > local_sums(std::vector<double>(p, 0.0));
+        parallel_for(blocked_range<size_t>(0, m_num_values),
+            [=, &local_sums] (const blocked_range<size_t>& r)
+            {
+            std::vector<double>& sums = local_sums.local();
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                float *reg = shift + i*p*d;
+                double *acc = accumulator + i*d;
+                for (unsigned int c = 0; c < d; c++)
+                    {
+                    float v = values[i*d + c];
+                    reg[slot*d + c] = v;
+                    acc[c] += v;
+                    }
+                if (pass_on)
+                    {
+                    for (unsigned int c = 0; c < d; c++)
+                        {
+                        average[i*d + c] = float(acc[c] * inv_averaging);
+                        acc[c] = 0.0;
+                        }
+                    }
+
+                const float *current = reg + slot*d;
+                for (unsigned int lag = lag_min; lag < lag_end; lag++)
+                    {
+                    unsigned int j = (slot >= lag) ? slot - lag : slot + p - lag;
+                    const float *previous = reg + j*d;
+                    double product = 0.0;
+                    for (unsigned int c = 0; c < d; c++)
+                        product += double(current[c]) * double(previous[c]);
+                    sums[lag] += product;
+                    }
+                }
+            });
+
+        for (enumerable_thread_specific< std::vector<double> >::iterator i = local_sums.begin();
+             i != local_sums.end(); ++i)
+            {
+            for (unsigned int lag = lag_min; lag < lag_end; lag++)
+                level.correlation[lag] += (*i)[lag];
+            }
+        for (unsigned int lag = lag_min; lag < lag_end; lag++)
+            level.counts[lag]++;
+
+        level.num_inserted++;
+        level.insert_index = (slot + 1) % p;
+        level.num_accumulated = pass_on ? 0 : level.num_accumulated + 1;
+        if (!pass_on)
+            break;
+        values = average;
+        k++;
+        }
+    }
+
+//! \internal
+//! Gather the lags of all the levels into the output arrays
+void MultipleTau::reduceCorrelation()
+    {
+    const unsigned int p = m_block_size;
+    std::vector<unsigned int> lags;
+    std::vector<double> correlation;
+    std::vector<unsigned int> counts;
+    unsigned int scale = 1;
+    for (unsigned int k = 0; k < m_levels.size(); k++)
+        {
+        const Level& level = m_levels[k];
+        for (unsigned int lag = (k == 0) ? 0 : p / m_averaging; lag < p; lag++)
+            {
+            if (level.counts[lag] == 0)
+                continue;
+            lags.push_back(lag*scale);
+            correlation.push_back(level.correlation[lag] / (double(level.counts[lag]) * double(m_num_values)));
+            counts.push_back(level.counts[lag]);
+            }
+        scale *= m_averaging;
+        }
+
+    m_num_lags = lags.size();
+    size_t n = std::max(m_num_lags, 1u);
+    m_lags = std::shared_ptr<unsigned int>(new unsigned int[n], std::default_delete<unsigned int[]>());
+    m_correlation_array = std::shared_ptr<double>(new double[n], std::default_delete<double[]>());
+    m_counts_array = std::shared_ptr<unsigned int>(new unsigned int[n], std::default_delete<unsigned int[]>());
+    std::copy(lags.begin(), lags.end(), m_lags.get());
+    std::copy(correlation.begin(), correlation.end(), m_correlation_array.get());
+    std::copy(counts.begin(), counts.end(), m_counts_array.get());
+    }
+
+unsigned int MultipleTau::getNumLags()
+    {
+    if (m_reduce == true)
+        {
+        reduceCorrelation();
+        }
+    m_reduce = false;
+    return m_num_lags;
+    }
+
+std::shared_ptr<unsigned int> MultipleTau::getLags()
+    {
+    if (m_reduce == true)
+        {
+        reduceCorrelation();
+        }
+    m_reduce = false;
+    return m_lags;
+    }
+
+std::shared_ptr<double> MultipleTau::getCorrelation()
+    {
+    if (m_reduce == true)
+        {
+        reduceCorrelation();
+        }
+    m_reduce = false;
+    return m_correlation_array;
+    }
+
+std::shared_ptr<unsigned int> MultipleTau::getCounts()
+    {
+    if (m_reduce == true)
+        {
+        reduceCorrelation();
+        }
+    m_reduce = false;
+    return m_counts_array;
+    }
+
+}; }; // end namespace freud::dynamics
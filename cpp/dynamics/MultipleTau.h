@@ -0,0 +1,117 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <vector>
+
+#ifndef _MULTIPLE_TAU_H__
+#define _MULTIPLE_TAU_H__
+
+/*! \file MultipleTau.h
+    \brief Streaming multiple-tau time correlation of per-particle values
+*/
+
+namespace freud { namespace dynamics {
+
+//! Computes the time autocorrelation <A(t) . A(t + tau)> of per-particle values fed one frame at a time
+/*! The multiple-tau correlator (Ramirez, Sukumaran, Vorselaars and Likhtman, J. Chem. Phys. 133, 154103 (2010))
+    keeps a hierarchy of levels. Level 0 holds the last block_size frames in a ring buffer and correlates each new
+    frame with all of them, for the lags 0 to block_size - 1. Every averaging frames, the average of the frames
+    added to a level is passed on to the next level, which thus sees a trajectory coarsened by averaging^k and
+    correlates the lags block_size / averaging to block_size - 1 of its frames, i.e. lags that are averaging^k times
+    longer than those of level 0. Levels are added as the trajectory grows, so that the lags span the whole
+    trajectory on a logarithmic scale with O(block_size * log T) memory per particle, instead of all T frames.
+
+    Each value has a fixed number of components (1 for scalars, 3 for vectors) and the product of two values is the
+    dot product of their components; the real part of the correlation of complex values a conj(b) is found by
+    feeding their real and imaginary parts as two components. The correlation is averaged over the particles and
+    over all time origins of each lag.
+*/
+class MultipleTau
+    {
+    public:
+        //! Constructor
+        /*! \param num_values number of values (particles) of each frame
+            \param dimensions number of components of each value
+            \param block_size number of lags correlated by each level
+            \param averaging number of frames of a level averaged into one frame of the next level
+        */
+        MultipleTau(unsigned int num_values, unsigned int dimensions, unsigned int block_size=16,
+                    unsigned int averaging=2);
+
+        //! Forget all the frames that were added
+        void reset();
+
+        //! Add a frame of num_values * dimensions values, ordered by value and then by component
+        void accumulate(const float *values, unsigned int num_values);
+
+        //! Get the number of values of each frame
+        unsigned int getNumValues() const
+            {
+            return m_num_values;
+            }
+
+        //! Get the number of components of each value
+        unsigned int getDimensions() const
+            {
+            return m_dimensions;
+            }
+
+        //! Get the number of frames that were added
+        unsigned int getFrameCounter() const
+            {
+            return m_frame_counter;
+            }
+
+        //! Get the number of lags for which the correlation was computed
+        unsigned int getNumLags();
+
+        //! Get the lags, in frames
+        std::shared_ptr<unsigned int> getLags();
+
+        //! Get the correlation at each lag
+        std::shared_ptr<double> getCorrelation();
+
+        //! Get the number of time origins of each lag
+        std::shared_ptr<unsigned int> getCounts();
+
+    private:
+        //! One level of the hierarchy, correlating the frames coarsened by averaging^k
+        struct Level
+            {
+            std::vector<float> shift;           //!< Last block_size frames, by value, then slot, then component
+            std::vector<double> accumulator;    //!< Sum of the frames to average for the next level
+            std::vector<double> correlation;    //!< Sum over the values and time origins of each lag
+            std::vector<unsigned int> counts;   //!< Number of time origins of each lag
+            unsigned int num_accumulated;       //!< Number of frames in the accumulator
+            unsigned int num_inserted;          //!< Number of frames added to the level
+            unsigned int insert_index;          //!< Slot of the next frame in the ring buffer
+            };
+
+        //! \internal
+        //! Add a frame to level k, and its averages to the next levels
+        void addToLevel(unsigned int k, const float *values);
+
+        //! \internal
+        //! Gather the lags of all the levels into the output arrays
+        void reduceCorrelation();
+
+        unsigned int m_num_values;          //!< Number of values of each frame
+        unsigned int m_dimensions;          //!< Number of components of each value
+        unsigned int m_block_size;          //!< Number of lags of each level
+        unsigned int m_averaging;           //!< Number of frames averaged into one frame of the next level
+        unsigned int m_frame_counter;       //!< Number of frames added
+        bool m_reduce;                      //!< True when the output arrays need to be gathered again
+        std::vector<Level> m_levels;        //!< Levels of the hierarchy
+        std::vector<float> m_average;       //!< Buffer of the average passed on to the next level
+
+        unsigned int m_num_lags;                        //!< Number of lags in the output arrays
+        std::shared_ptr<unsigned int> m_lags;           //!< Lag of each output, in frames
+        std::shared_ptr<double> m_correlation_array;    //!< Correlation at each lag
+        std::shared_ptr<unsigned int> m_counts_array;   //!< Number of time origins of each lag
+    };
+
+}; }; // end namespace freud::dynamics
+
+#endif // _MULTIPLE_TAU_H__
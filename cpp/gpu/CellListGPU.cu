@@ -0,0 +1,74 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <thrust/binary_search.h>
+#include <thrust/device_ptr.h>
+#include <thrust/execution_policy.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/sort.h>
+
+#include "CellListGPU.cuh"
+
+/*! \file CellListGPU.cu
+    \brief Builds the cell list of points on the GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Number of threads of a block of the cell list kernels
+const unsigned int CELL_LIST_BLOCK_SIZE = 256;
+
+//! \internal
+//! Compute the cell of each point
+__global__ void gpu_compute_cells_kernel(const float4 *d_points, unsigned int N, GPUBox box, uint3 dim,
+                                         unsigned int *d_cells, unsigned int *d_order)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= N)
+        return;
+    float4 p = d_points[i];
+    d_cells[i] = getCell(box, dim, make_float3(p.x, p.y, p.z));
+    d_order[i] = i;
+    }
+
+//! \internal
+//! Gather the points in the order of their cells
+__global__ void gpu_gather_points_kernel(const float4 *d_points, unsigned int N, const unsigned int *d_order,
+                                         float4 *d_sorted_points)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= N)
+        return;
+    d_sorted_points[i] = d_points[d_order[i]];
+    }
+
+/*! The points are sorted by cell with a radix sort of their cells, keeping points of the same cell in order, and
+    the start of each cell is the first sorted point of a cell at least as large.
+*/
+cudaError_t gpu_compute_cell_list(const float4 *d_points,
+                                  unsigned int N,
+                                  const GPUBox& box,
+                                  uint3 dim,
+                                  unsigned int *d_cells,
+                                  unsigned int *d_order,
+                                  float4 *d_sorted_points,
+                                  unsigned int *d_cell_start)
+    {
+    unsigned int num_cells = dim.x * dim.y * dim.z;
+    unsigned int num_blocks = (N + CELL_LIST_BLOCK_SIZE - 1) / CELL_LIST_BLOCK_SIZE;
+    if (N > 0)
+        {
+        gpu_compute_cells_kernel<<<num_blocks, CELL_LIST_BLOCK_SIZE>>>(d_points, N, box, dim, d_cells, d_order);
+        thrust::device_ptr<unsigned int> cells(d_cells);
+        thrust::device_ptr<unsigned int> order(d_order);
+        thrust::stable_sort_by_key(thrust::device, cells, cells + N, order);
+        gpu_gather_points_kernel<<<num_blocks, CELL_LIST_BLOCK_SIZE>>>(d_points, N, d_order, d_sorted_points);
+        }
+    thrust::device_ptr<unsigned int> cells(d_cells);
+    thrust::device_ptr<unsigned int> cell_start(d_cell_start);
+    thrust::lower_bound(thrust::device, cells, cells + N, thrust::counting_iterator<unsigned int>(0),
+                        thrust::counting_iterator<unsigned int>(num_cells + 1), cell_start);
+    return cudaGetLastError();
+    }
+
+}; }; // end namespace freud::gpu
@@ -0,0 +1,54 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cuda_runtime.h>
+
+#include "GPUBox.h"
+
+#ifndef _CELL_LIST_GPU_CUH__
+#define _CELL_LIST_GPU_CUH__
+
+/*! \file CellListGPU.cuh
+    \brief Declares the driver of the cell list built on the GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Get the cell of a point in a grid of dim cells over the box, as locality::LinkCell::getCell() orders them
+HOSTDEVICE inline unsigned int getCell(const GPUBox& box, uint3 dim, float3 p)
+    {
+    float3 f = box.makeWrappedFraction(p);
+    unsigned int x = (unsigned int) (f.x * dim.x);
+    x = (x < dim.x) ? x : dim.x - 1;
+    unsigned int y = (unsigned int) (f.y * dim.y);
+    y = (y < dim.y) ? y : dim.y - 1;
+    unsigned int z = (unsigned int) (f.z * dim.z);
+    z = (z < dim.z) ? z : dim.z - 1;
+    return x + dim.x * (y + dim.y * z);
+    }
+
+//! Sort points by cell on the GPU
+/*! \param d_points Points, w unused
+    \param N Number of points
+    \param box Box of the points
+    \param dim Number of cells along each lattice vector, 1 along z in 2D
+    \param d_cells Scratch of N cells
+    \param d_order Scratch of N indices
+    \param d_sorted_points Output: the points sorted by cell
+    \param d_cell_start Output: the first sorted point of each cell, and N, dim.x*dim.y*dim.z + 1 values
+
+    The cells are wide enough that the pairs within the cutoff are those of neighboring cells, see
+    gpu_bin_rdf().
+*/
+cudaError_t gpu_compute_cell_list(const float4 *d_points,
+                                  unsigned int N,
+                                  const GPUBox& box,
+                                  uint3 dim,
+                                  unsigned int *d_cells,
+                                  unsigned int *d_order,
+                                  float4 *d_sorted_points,
+                                  unsigned int *d_cell_start);
+
+}; }; // end namespace freud::gpu
+
+#endif // _CELL_LIST_GPU_CUH__
@@ -0,0 +1,198 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "DensityGPU.h"
+#include "Annotation.h"
+
+#ifdef ENABLE_CUDA
+#include <cuda_runtime.h>
+
+#include "DeviceArray.h"
+#include "GaussianDensityGPU.cuh"
+#include "PhaseSumGPU.cuh"
+#endif
+
+using namespace std;
+
+/*! \file DensityGPU.cc
+    \brief Gaussian densities on a grid and phase sums of Fourier transforms on a CUDA GPU
+*/
+
+namespace freud { namespace gpu {
+
+#ifdef ENABLE_CUDA
+
+//! \internal
+//! Stream and device buffers of the densities and the phase sums, and their page-locked host copies
+struct DensityGPU::DeviceData
+    {
+    cudaStream_t stream;                    //!< Stream the work is queued on
+    PinnedArray<float4> staging;            //!< Host copy of the points being uploaded
+    DeviceArray<float4> points;             //!< Points of the density, or positions of the phase sums
+    DeviceArray<float> density;             //!< Grid of the density
+    PinnedArray<float> host_density;        //!< Host copy of the grid
+    size_t num_cells;                       //!< Number of grid cells of the last spreadGaussians()
+    DeviceArray<float4> K;                  //!< K points of the phase sums
+    unsigned int NK;                        //!< Number of K points
+    DeviceArray<float> cos_sum;             //!< Sums of cos(K . r)
+    DeviceArray<float> sin_sum;             //!< Sums of sin(K . r)
+    PinnedArray<float> host_sums;           //!< Host copy of the sums of cos and then sin
+
+    DeviceData() : num_cells(0), NK(0)
+        {
+        checkCUDA(cudaStreamCreate(&stream), "creating a stream");
+        }
+
+    ~DeviceData()
+        {
+        cudaStreamSynchronize(stream);
+        cudaStreamDestroy(stream);
+        }
+
+    //! Wait for the work queued on the stream
+    void synchronize()
+        {
+        util::ScopedRange annotation("freud::DensityGPU::synchronize");
+        checkCUDA(cudaStreamSynchronize(stream), "waiting for the GPU");
+        }
+
+    //! Queue the copy of points to the device as float4, once the previous uploads are done
+    float4 *uploadPoints(DeviceArray<float4>& array, const vec3<float> *values, unsigned int n)
+        {
+        synchronize();
+        float4 *host = staging.resize(n);
+        for (unsigned int i = 0; i < n; i++)
+            host[i] = make_float4(values[i].x, values[i].y, values[i].z, 0.0f);
+        return array.uploadAsync(host, n, stream);
+        }
+    };
+
+DensityGPU::DensityGPU()
+    {
+    if (!isAvailable())
+        throw runtime_error("No CUDA device is available");
+    m_data.reset(new DeviceData());
+    }
+
+DensityGPU::~DensityGPU()
+    {
+    }
+
+bool DensityGPU::isAvailable()
+    {
+    return isDeviceAvailable();
+    }
+
+void DensityGPU::spreadGaussians(const box::Box& box, const vec3<float> *points, unsigned int Np,
+                                 unsigned int width_x, unsigned int width_y, unsigned int width_z, float r_cut,
+                                 float sigma)
+    {
+    util::ScopedRange annotation("freud::DensityGPU::spreadGaussians");
+    // the constants of GaussianDensity::compute()
+    const bool is2D = box.is2D();
+    GaussianGrid grid;
+    grid.width = make_uint3(width_x, width_y, is2D ? 1 : width_z);
+    grid.grid_size = make_float3(box.getLx()/width_x, box.getLy()/width_y, is2D ? 0.0f : box.getLz()/width_z);
+    grid.half_L = make_float3(box.getLx()/2.0f, box.getLy()/2.0f, box.getLz()/2.0f);
+    grid.bin_cut.x = int(r_cut/grid.grid_size.x);
+    grid.bin_cut.y = int(r_cut/grid.grid_size.y);
+    grid.bin_cut.z = is2D ? 0 : int(r_cut/grid.grid_size.z);
+    grid.rcut = r_cut;
+    grid.sigmasq = sigma*sigma;
+    grid.A = sqrt(1.0f/(2.0f*M_PI*grid.sigmasq));
+
+    // waits for the previous frame, whose grid is dropped if it was not read
+    const float4 *d_points = m_data->uploadPoints(m_data->points, points, Np);
+    const size_t num_cells = size_t(grid.width.x)*grid.width.y*grid.width.z;
+    float *d_density = m_data->density.resize(num_cells);
+    float *host_density = m_data->host_density.resize(num_cells);
+    m_data->num_cells = num_cells;
+    checkCUDA(cudaMemsetAsync(d_density, 0, num_cells*sizeof(float), m_data->stream), "clearing the grid");
+    checkCUDA(gpu_spread_gaussians(d_points, Np, makeGPUBox(box), grid, d_density, m_data->stream),
+              "spreading the Gaussians");
+    checkCUDA(cudaMemcpyAsync(host_density, d_density, num_cells*sizeof(float), cudaMemcpyDeviceToHost,
+                              m_data->stream), "copying the grid from the device");
+    }
+
+void DensityGPU::getDensity(float *density)
+    {
+    m_data->synchronize();
+    const float *host_density = m_data->host_density.get();
+    std::copy(host_density, host_density + m_data->num_cells, density);
+    }
+
+void DensityGPU::setK(const vec3<float> *K, unsigned int NK)
+    {
+    m_data->uploadPoints(m_data->K, K, NK);
+    m_data->NK = NK;
+    }
+
+void DensityGPU::sumPhases(const vec3<float> *r, unsigned int Np, float *cos_sum, float *sin_sum)
+    {
+    util::ScopedRange annotation("freud::DensityGPU::sumPhases");
+    const unsigned int NK = m_data->NK;
+    const float4 *d_r = m_data->uploadPoints(m_data->points, r, Np);
+    float *d_cos_sum = m_data->cos_sum.resize(NK);
+    float *d_sin_sum = m_data->sin_sum.resize(NK);
+    float *host_sums = m_data->host_sums.resize(2*size_t(NK));
+    checkCUDA(gpu_sum_phases(m_data->K.resize(NK), NK, d_r, Np, d_cos_sum, d_sin_sum, m_data->stream),
+              "summing the phases");
+    checkCUDA(cudaMemcpyAsync(host_sums, d_cos_sum, NK*sizeof(float), cudaMemcpyDeviceToHost, m_data->stream),
+              "copying the phase sums from the device");
+    checkCUDA(cudaMemcpyAsync(host_sums + NK, d_sin_sum, NK*sizeof(float), cudaMemcpyDeviceToHost,
+                              m_data->stream), "copying the phase sums from the device");
+    m_data->synchronize();
+    std::copy(host_sums, host_sums + NK, cos_sum);
+    std::copy(host_sums + NK, host_sums + 2*size_t(NK), sin_sum);
+    }
+
+#else // ENABLE_CUDA
+
+//! \internal
+//! Nothing is kept without CUDA
+struct DensityGPU::DeviceData
+    {
+    };
+
+DensityGPU::DensityGPU()
+    {
+    throw runtime_error("freud was built without CUDA; configure it with ENABLE_CUDA=ON to compute on the GPU");
+    }
+
+DensityGPU::~DensityGPU()
+    {
+    }
+
+bool DensityGPU::isAvailable()
+    {
+    return false;
+    }
+
+void DensityGPU::spreadGaussians(const box::Box& box, const vec3<float> *points, unsigned int Np,
+                                 unsigned int width_x, unsigned int width_y, unsigned int width_z, float r_cut,
+                                 float sigma)
+    {
+    throw runtime_error("freud was built without CUDA");
+    }
+
+void DensityGPU::getDensity(float *density)
+    {
+    throw runtime_error("freud was built without CUDA");
+    }
+
+void DensityGPU::setK(const vec3<float> *K, unsigned int NK)
+    {
+    throw runtime_error("freud was built without CUDA");
+    }
+
+void DensityGPU::sumPhases(const vec3<float> *r, unsigned int Np, float *cos_sum, float *sin_sum)
+    {
+    throw runtime_error("freud was built without CUDA");
+    }
+
+#endif // ENABLE_CUDA
+
+}; }; // end namespace freud::gpu
@@ -0,0 +1,75 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+
+#ifndef _DENSITY_GPU_H__
+#define _DENSITY_GPU_H__
+
+/*! \file DensityGPU.h
+    \brief Gaussian densities on a grid and phase sums of Fourier transforms on a CUDA GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Compute the densities of density::GaussianDensity and the phase sums of kspace::FTdelta on the GPU
+/*! The work is queued on a CUDA stream of this object, from page-locked copies of the input on the host, so that
+    the copies run asynchronously with the host. spreadGaussians() returns once the points of a frame are copied
+    and the spreading and the copy of the grid back to the host are queued: the caller reads the next frame while
+    the GPU works, and getDensity() waits for the grid when it is needed. The device buffers are kept and grown
+    across frames.
+
+    The sums are those of the CPU code in a different order, so the results differ from the CPU within rounding.
+
+    Without a build with ENABLE_CUDA, or without a CUDA device, the constructor throws std::runtime_error, so the
+    analyses can offer the GPU unconditionally.
+*/
+class DensityGPU
+    {
+    public:
+        //! Constructor, on the current CUDA device
+        DensityGPU();
+
+        //! Destructor, waiting for the queued work
+        ~DensityGPU();
+
+        //! Whether this build of freud supports CUDA and finds a device
+        static bool isAvailable();
+
+        //! Queue the spreading of the Gaussians of the points onto a grid, as GaussianDensity::compute() does
+        /*! \param width_x Number of grid cells along x
+            \param width_y Number of grid cells along y
+            \param width_z Number of grid cells along z, unused in 2D
+            \param r_cut Distance beyond which the Gaussians are cut off
+            \param sigma Standard deviation of the Gaussians
+
+            The points may be changed once it returns. The grid of a previous call that was not read is dropped.
+        */
+        void spreadGaussians(const box::Box& box, const vec3<float> *points, unsigned int Np, unsigned int width_x,
+                             unsigned int width_y, unsigned int width_z, float r_cut, float sigma);
+
+        //! Wait for the grid of the last spreadGaussians() and copy it to density, as indexed by Index3D
+        void getDensity(float *density);
+
+        //! Copy the K points of sumPhases() to the device
+        void setK(const vec3<float> *K, unsigned int NK);
+
+        //! Sum cos(K . r) and sin(K . r) over the particles at each K point of setK()
+        /*! \param cos_sum Output: NK sums of cos(K . r)
+            \param sin_sum Output: NK sums of sin(K . r)
+        */
+        void sumPhases(const vec3<float> *r, unsigned int Np, float *cos_sum, float *sin_sum);
+
+    private:
+        struct DeviceData;
+        std::unique_ptr<DeviceData> m_data;     //!< Stream and buffers, reused across frames
+    };
+
+}; }; // end namespace freud::gpu
+
+#endif // _DENSITY_GPU_H__
@@ -0,0 +1,164 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <cuda_runtime.h>
+
+#include "box.h"
+#include "GPUBox.h"
+
+#ifndef _DEVICE_ARRAY_H__
+#define _DEVICE_ARRAY_H__
+
+/*! \file DeviceArray.h
+    \brief Host side helpers of the CUDA backends: device and page-locked arrays, errors and boxes
+*/
+
+namespace freud { namespace gpu {
+
+//! Throw std::runtime_error on a CUDA error
+inline void checkCUDA(cudaError_t error, const char *what)
+    {
+    if (error != cudaSuccess)
+        throw std::runtime_error(std::string("CUDA error while ") + what + ": " + cudaGetErrorString(error));
+    }
+
+//! Whether a CUDA device is found
+inline bool isDeviceAvailable()
+    {
+    int num_devices = 0;
+    return cudaGetDeviceCount(&num_devices) == cudaSuccess && num_devices > 0;
+    }
+
+//! Device array grown to the largest size requested
+template<typename T>
+class DeviceArray
+    {
+    public:
+        DeviceArray() : m_data(NULL), m_size(0)
+            {
+            }
+
+        ~DeviceArray()
+            {
+            if (m_data != NULL)
+                cudaFree(m_data);
+            }
+
+        //! Get storage for at least n values, the previous values being lost when it grows
+        T *resize(size_t n)
+            {
+            n = std::max(n, size_t(1));
+            if (n > m_size)
+                {
+                if (m_data != NULL)
+                    cudaFree(m_data);
+                m_data = NULL;
+                m_size = 0;
+                checkCUDA(cudaMalloc((void**) &m_data, n*sizeof(T)), "allocating device memory");
+                m_size = n;
+                }
+            return m_data;
+            }
+
+        //! Copy n values to the device
+        T *upload(const T *values, size_t n)
+            {
+            resize(n);
+            if (n > 0)
+                checkCUDA(cudaMemcpy(m_data, values, n*sizeof(T), cudaMemcpyHostToDevice), "copying to the device");
+            return m_data;
+            }
+
+        //! Queue the copy of n values of page-locked memory to the device on a stream
+        T *uploadAsync(const T *values, size_t n, cudaStream_t stream)
+            {
+            resize(n);
+            if (n > 0)
+                checkCUDA(cudaMemcpyAsync(m_data, values, n*sizeof(T), cudaMemcpyHostToDevice, stream),
+                          "copying to the device");
+            return m_data;
+            }
+
+    private:
+        DeviceArray(const DeviceArray&);
+        DeviceArray& operator=(const DeviceArray&);
+
+        T *m_data;          //!< Device storage
+        size_t m_size;      //!< Number of values of the storage
+    };
+
+//! Page-locked host array grown to the largest size requested
+/*! Copies between page-locked memory and the device run asynchronously with the host, which ordinary memory
+    does not allow.
+*/
+template<typename T>
+class PinnedArray
+    {
+    public:
+        PinnedArray() : m_data(NULL), m_size(0)
+            {
+            }
+
+        ~PinnedArray()
+            {
+            if (m_data != NULL)
+                cudaFreeHost(m_data);
+            }
+
+        //! Get storage for at least n values, the previous values being lost when it grows
+        T *resize(size_t n)
+            {
+            n = std::max(n, size_t(1));
+            if (n > m_size)
+                {
+                if (m_data != NULL)
+                    cudaFreeHost(m_data);
+                m_data = NULL;
+                m_size = 0;
+                checkCUDA(cudaMallocHost((void**) &m_data, n*sizeof(T)), "allocating page-locked memory");
+                m_size = n;
+                }
+            return m_data;
+            }
+
+        T *get()
+            {
+            return m_data;
+            }
+
+    private:
+        PinnedArray(const PinnedArray&);
+        PinnedArray& operator=(const PinnedArray&);
+
+        T *m_data;          //!< Host storage
+        size_t m_size;      //!< Number of values of the storage
+    };
+
+//! Copy the box for the kernels
+inline GPUBox makeGPUBox(const box::Box& box)
+    {
+    const box::WrapContext& wrap = box.getWrapContext();
+    GPUBox gpu_box;
+    gpu_box.L = make_float3(wrap.L.x, wrap.L.y, wrap.L.z);
+    gpu_box.Linv = make_float3(wrap.Linv.x, wrap.Linv.y, wrap.Linv.z);
+    gpu_box.xy = wrap.xy;
+    gpu_box.yz = wrap.yz;
+    gpu_box.tilt_xz = wrap.tilt_xz;
+    gpu_box.Ly_xy = wrap.Ly_xy;
+    gpu_box.Lz_xz = wrap.Lz_xz;
+    gpu_box.Lz_yz = wrap.Lz_yz;
+    const vec3<float> lo = box.getLo();
+    const vec3<float> Linv = box.getLinv();
+    gpu_box.lo = make_float3(lo.x, lo.y, lo.z);
+    gpu_box.frac_Linv = make_float3(Linv.x, Linv.y, Linv.z);
+    gpu_box.is2D = box.is2D();
+    return gpu_box;
+    }
+
+}; }; // end namespace freud::gpu
+
+#endif // _DEVICE_ARRAY_H__
@@ -0,0 +1,75 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "HOOMDMath.h"
+
+#ifndef _GPU_BOX_H__
+#define _GPU_BOX_H__
+
+/*! \file GPUBox.h
+    \brief Box of the GPU kernels
+*/
+
+namespace freud { namespace gpu {
+
+//! Plain copy of a box::Box that the GPU kernels wrap vectors and compute fractional coordinates with
+/*! The fields are those of box::WrapContext, lengths and inverse lengths being zero along the directions that are
+    not periodic, so wrap() gives the same image as box::Box::wrap(); the box is filled in by the host code from the
+    box::Box, so that the kernels do not include box.h.
+*/
+struct GPUBox
+    {
+    float3 L;               //!< Box lengths, zero along non periodic directions
+    float3 Linv;            //!< Inverse box lengths, zero along non periodic directions
+    float xy;               //!< xy tilt factor
+    float yz;               //!< yz tilt factor
+    float tilt_xz;          //!< xz - xy*yz, the z coefficient of the fractional x coordinate
+    float Ly_xy;            //!< Ly*xy, x component of the second lattice vector
+    float Lz_xz;            //!< Lz*xz, x component of the third lattice vector
+    float Lz_yz;            //!< Lz*yz, y component of the third lattice vector
+    float3 lo;              //!< Lower corner of the box
+    float3 frac_Linv;       //!< Inverse box lengths of the fractional coordinates
+    bool is2D;              //!< True for 2D boxes
+
+    //! Round to the nearest integer, halfway cases up
+    HOSTDEVICE static float roundNearest(float f)
+        {
+        return floorf(f + 0.5f);
+        }
+
+    //! Get the minimum image of a vector
+    HOSTDEVICE float3 wrap(float3 w) const
+        {
+        float nx = roundNearest((w.x - tilt_xz * w.z - xy * w.y) * Linv.x);
+        float ny = roundNearest((w.y - yz * w.z) * Linv.y);
+        float shift_x = nx * L.x + ny * Ly_xy;
+        float shift_y = ny * L.y;
+        if (!is2D)
+            {
+            float nz = roundNearest(w.z * Linv.z);
+            shift_x += nz * Lz_xz;
+            shift_y += nz * Lz_yz;
+            w.z -= nz * L.z;
+            }
+        w.x -= shift_x;
+        w.y -= shift_y;
+        return w;
+        }
+
+    //! Get the fractional coordinates of a point, wrapped into [0, 1)
+    HOSTDEVICE float3 makeWrappedFraction(float3 v) const
+        {
+        float3 f;
+        f.x = (v.x - lo.x - tilt_xz * v.z - xy * v.y) * frac_Linv.x;
+        f.y = (v.y - lo.y - yz * v.z) * frac_Linv.y;
+        f.z = is2D ? 0.0f : (v.z - lo.z) * frac_Linv.z;
+        f.x -= floorf(f.x);
+        f.y -= floorf(f.y);
+        f.z -= floorf(f.z);
+        return f;
+        }
+    };
+
+}; }; // end namespace freud::gpu
+
+#endif // _GPU_BOX_H__
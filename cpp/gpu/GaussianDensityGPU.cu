@@ -0,0 +1,70 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "GaussianDensityGPU.cuh"
+
+/*! \file GaussianDensityGPU.cu
+    \brief Kernel spreading Gaussians onto a grid on the GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Number of threads of a block of the spreading kernel
+const unsigned int GAUSSIAN_DENSITY_BLOCK_SIZE = 128;
+
+//! \internal
+//! Spread the Gaussian of each point onto the grid cells within r_cut, with the arithmetic of the CPU code
+__global__ void gpu_spread_gaussians_kernel(const float4 *d_points, unsigned int N, GPUBox box, GaussianGrid grid,
+                                            float *d_density)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N)
+        return;
+    float4 p = d_points[idx];
+
+    // the cell of the point, in 2D only the 0 z plane
+    int bin_x = int((p.x + grid.half_L.x)/grid.grid_size.x);
+    int bin_y = int((p.y + grid.half_L.y)/grid.grid_size.y);
+    int bin_z = box.is2D ? 0 : int((p.z + grid.half_L.z)/grid.grid_size.z);
+
+    for (int k = bin_z - grid.bin_cut.z; k <= bin_z + grid.bin_cut.z; k++)
+        {
+        float dz = float((grid.grid_size.z*k + grid.grid_size.z/2.0f) - p.z - grid.half_L.z);
+        unsigned int nk = (k + grid.width.z) % grid.width.z;
+        for (int j = bin_y - grid.bin_cut.y; j <= bin_y + grid.bin_cut.y; j++)
+            {
+            float dy = float((grid.grid_size.y*j + grid.grid_size.y/2.0f) - p.y - grid.half_L.y);
+            unsigned int nj = (j + grid.width.y) % grid.width.y;
+            for (int i = bin_x - grid.bin_cut.x; i <= bin_x + grid.bin_cut.x; i++)
+                {
+                float dx = float((grid.grid_size.x*i + grid.grid_size.x/2.0f) - p.x - grid.half_L.x);
+                float3 delta = box.wrap(make_float3(dx, dy, dz));
+                float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+                if (!(sqrtf(rsq) < grid.rcut))
+                    continue;
+                float x_gaussian = grid.A*expf((-1.0f)*(delta.x*delta.x)/(2.0f*grid.sigmasq));
+                float y_gaussian = grid.A*expf((-1.0f)*(delta.y*delta.y)/(2.0f*grid.sigmasq));
+                float z_gaussian = grid.A*expf((-1.0f)*(delta.z*delta.z)/(2.0f*grid.sigmasq));
+                unsigned int ni = (i + grid.width.x) % grid.width.x;
+                atomicAdd(&d_density[(nk*grid.width.y + nj)*grid.width.x + ni], x_gaussian*y_gaussian*z_gaussian);
+                }
+            }
+        }
+    }
+
+cudaError_t gpu_spread_gaussians(const float4 *d_points,
+                                 unsigned int N,
+                                 const GPUBox& box,
+                                 const GaussianGrid& grid,
+                                 float *d_density,
+                                 cudaStream_t stream)
+    {
+    if (N == 0)
+        return cudaSuccess;
+    unsigned int num_blocks = (N + GAUSSIAN_DENSITY_BLOCK_SIZE - 1) / GAUSSIAN_DENSITY_BLOCK_SIZE;
+    gpu_spread_gaussians_kernel<<<num_blocks, GAUSSIAN_DENSITY_BLOCK_SIZE, 0, stream>>>(
+        d_points, N, box, grid, d_density);
+    return cudaGetLastError();
+    }
+
+}; }; // end namespace freud::gpu
@@ -0,0 +1,49 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cuda_runtime.h>
+
+#include "GPUBox.h"
+
+#ifndef _GAUSSIAN_DENSITY_GPU_CUH__
+#define _GAUSSIAN_DENSITY_GPU_CUH__
+
+/*! \file GaussianDensityGPU.cuh
+    \brief Declares the driver of the kernel spreading Gaussians onto a grid on the GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Grid and Gaussian of density::GaussianDensity::compute()
+struct GaussianGrid
+    {
+    uint3 width;            //!< Number of grid cells along x, y and z, 1 along z in 2D
+    float3 grid_size;       //!< Width of a grid cell along x, y and z, 0 along z in 2D
+    float3 half_L;          //!< Half of the box lengths
+    int3 bin_cut;           //!< Number of grid cells within r_cut along x, y and z, 0 along z in 2D
+    float rcut;             //!< Distance beyond which the Gaussians are cut off
+    float A;                //!< Normalization of the 1D Gaussian
+    float sigmasq;          //!< Variance of the Gaussian
+    };
+
+//! Add the Gaussians of the points to a grid on the GPU
+/*! \param d_points Points, w unused
+    \param N Number of points
+    \param box Box of the points
+    \param grid Grid and Gaussian
+    \param d_density Grid the Gaussians are added to, of width.x*width.y*width.z values indexed as Index3D
+    \param stream Stream the kernel is queued on
+
+    Each thread spreads one point over the grid cells within r_cut of it, as GaussianDensity::compute() does, with
+    atomic additions, so the densities only differ from the CPU in the order of the sums.
+*/
+cudaError_t gpu_spread_gaussians(const float4 *d_points,
+                                 unsigned int N,
+                                 const GPUBox& box,
+                                 const GaussianGrid& grid,
+                                 float *d_density,
+                                 cudaStream_t stream);
+
+}; }; // end namespace freud::gpu
+
+#endif // _GAUSSIAN_DENSITY_GPU_CUH__
@@ -0,0 +1,271 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "PairBinnerGPU.h"
+#include "Annotation.h"
+
+#ifdef ENABLE_CUDA
+#include <cuda_runtime.h>
+
+#include "DeviceArray.h"
+#include "CellListGPU.cuh"
+#include "PairHistogramGPU.cuh"
+#endif
+
+using namespace std;
+
+/*! \file PairBinnerGPU.cc
+    \brief Binning of the pairs of the RDF and the PMFTs on a CUDA GPU
+*/
+
+namespace freud { namespace gpu {
+
+#ifdef ENABLE_CUDA
+
+//! \internal
+//! Device buffers of the points, the cell list and the histogram, and their host staging
+struct PairBinnerGPU::DeviceData
+    {
+    DeviceArray<float4> ref_points;             //!< Reference points
+    DeviceArray<float4> points;                 //!< Points
+    DeviceArray<float4> sorted_points;          //!< Points sorted by cell
+    DeviceArray<unsigned int> cells;            //!< Cell of each point
+    DeviceArray<unsigned int> order;            //!< Point of each sorted point
+    DeviceArray<unsigned int> cell_start;       //!< First sorted point of each cell
+    DeviceArray<float> angles;                  //!< Orientations of the reference points of PMFTXY2D
+    DeviceArray<float4> ref_orientations;       //!< Orientations of the reference points of PMFTXYZ
+    DeviceArray<float4> face_orientations;      //!< Orientations of the faces of PMFTXYZ
+    DeviceArray<float> edges;                   //!< Edges of non-uniform RDF bins
+    DeviceArray<unsigned long long> counts;     //!< Histogram of the frame
+    std::vector<float4> staging;                //!< Host copy of points or quaternions being uploaded
+    std::vector<unsigned long long> host_counts;    //!< Host copy of the histogram of the frame
+
+    //! Copy points to the device as float4
+    float4 *uploadPoints(DeviceArray<float4>& array, const vec3<float> *values, unsigned int n)
+        {
+        util::ScopedRange annotation("freud::PairBinnerGPU::uploadPoints");
+        staging.resize(n);
+        for (unsigned int i = 0; i < n; i++)
+            staging[i] = make_float4(values[i].x, values[i].y, values[i].z, 0.0f);
+        return array.upload(staging.data(), n);
+        }
+
+    //! Copy quaternions to the device as float4, the real part in w
+    float4 *uploadQuats(DeviceArray<float4>& array, const quat<float> *values, size_t n)
+        {
+        util::ScopedRange annotation("freud::PairBinnerGPU::uploadQuats");
+        staging.resize(n);
+        for (size_t i = 0; i < n; i++)
+            staging[i] = make_float4(values[i].v.x, values[i].v.y, values[i].v.z, values[i].s);
+        return array.upload(staging.data(), n);
+        }
+
+    //! Sort the points on the device into cells at least r_cut wide
+    CellListData computeCellList(const box::Box& box, const GPUBox& gpu_box, const float4 *d_points,
+                                 unsigned int n_p, float r_cut)
+        {
+        util::ScopedRange annotation("freud::PairBinnerGPU::computeCellList");
+        // as many cells as fit between the faces of the box, so that the pairs within r_cut are in neighbor cells
+        vec3<float> L = box.getNearestPlaneDistance();
+        if (r_cut > L.x/2.0f || r_cut > L.y/2.0f || (!box.is2D() && r_cut > L.z/2.0f))
+            throw runtime_error("Cannot generate a cell list where cell_width is larger than half the box.");
+        uint3 dim;
+        dim.x = std::max((unsigned int) floorf(L.x/r_cut), 1u);
+        dim.y = std::max((unsigned int) floorf(L.y/r_cut), 1u);
+        dim.z = box.is2D() ? 1u : std::max((unsigned int) floorf(L.z/r_cut), 1u);
+        unsigned int num_cells = dim.x*dim.y*dim.z;
+        float4 *d_sorted_points = sorted_points.resize(n_p);
+        unsigned int *d_cell_start = cell_start.resize(num_cells + 1);
+        checkCUDA(gpu_compute_cell_list(d_points, n_p, gpu_box, dim, cells.resize(n_p), order.resize(n_p),
+                                        d_sorted_points, d_cell_start), "computing the cell list");
+        CellListData cell_list;
+        cell_list.d_sorted_points = d_sorted_points;
+        cell_list.d_cell_start = d_cell_start;
+        cell_list.dim = dim;
+        return cell_list;
+        }
+
+    //! Clear the histogram of the frame on the device
+    unsigned long long *clearCounts(size_t n_bins)
+        {
+        unsigned long long *d_counts = counts.resize(n_bins);
+        checkCUDA(cudaMemset(d_counts, 0, n_bins*sizeof(unsigned long long)), "clearing the histogram");
+        return d_counts;
+        }
+
+    //! Copy the histogram of the frame back to the host
+    void downloadCounts(size_t n_bins, util::BinCount *out)
+        {
+        util::ScopedRange annotation("freud::PairBinnerGPU::downloadCounts");
+        host_counts.resize(n_bins);
+        checkCUDA(cudaMemcpy(host_counts.data(), counts.resize(n_bins), n_bins*sizeof(unsigned long long),
+                             cudaMemcpyDeviceToHost), "copying the histogram from the device");
+        for (size_t bin = 0; bin < n_bins; bin++)
+            out[bin] = util::BinCount(host_counts[bin]);
+        }
+    };
+
+PairBinnerGPU::PairBinnerGPU()
+    {
+    if (!isAvailable())
+        throw runtime_error("No CUDA device is available");
+    m_data.reset(new DeviceData());
+    }
+
+PairBinnerGPU::~PairBinnerGPU()
+    {
+    }
+
+bool PairBinnerGPU::isAvailable()
+    {
+    return isDeviceAvailable();
+    }
+
+void PairBinnerGPU::binRDF(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                           const vec3<float> *points, unsigned int n_p, float rmax, const util::BinEdges& bin_edges,
+                           util::BinCount *counts)
+    {
+    util::ScopedRange annotation("freud::PairBinnerGPU::binRDF");
+    const GPUBox gpu_box = makeGPUBox(box);
+    const float4 *d_points = m_data->uploadPoints(m_data->points, points, n_p);
+    CellListData cell_list = m_data->computeCellList(box, gpu_box, d_points, n_p, rmax);
+    const float4 *d_ref_points = (ref_points == points && n_ref == n_p) ? d_points :
+        m_data->uploadPoints(m_data->ref_points, ref_points, n_ref);
+
+    RDFBins bins;
+    bins.rmaxsq = rmax*rmax;
+    bins.n_bins = bin_edges.getNBins();
+    const std::vector<float>& edges = bin_edges.getEdges();
+    if (bin_edges.isUniform())
+        {
+        // uniform edges are multiples of the width
+        bins.inv_width = 1.0f / edges[1];
+        bins.d_edges = NULL;
+        }
+    else
+        {
+        bins.inv_width = 0.0f;
+        bins.d_edges = m_data->edges.upload(edges.data(), edges.size());
+        }
+
+    unsigned long long *d_counts = m_data->clearCounts(bins.n_bins);
+    checkCUDA(gpu_bin_rdf(d_ref_points, n_ref, cell_list, gpu_box, bins, d_counts), "binning the RDF");
+    m_data->downloadCounts(bins.n_bins, counts);
+    }
+
+void PairBinnerGPU::binPMFTXY2D(const box::Box& box, const vec3<float> *ref_points, const float *ref_orientations,
+                                unsigned int n_ref, const vec3<float> *points, unsigned int n_p, float r_cut,
+                                float max_x, float max_y, float dx, float dy, unsigned int n_bins_x,
+                                unsigned int n_bins_y, util::BinCount *counts)
+    {
+    util::ScopedRange annotation("freud::PairBinnerGPU::binPMFTXY2D");
+    const GPUBox gpu_box = makeGPUBox(box);
+    const float4 *d_points = m_data->uploadPoints(m_data->points, points, n_p);
+    CellListData cell_list = m_data->computeCellList(box, gpu_box, d_points, n_p, r_cut);
+    const float4 *d_ref_points = m_data->uploadPoints(m_data->ref_points, ref_points, n_ref);
+    const float *d_angles = m_data->angles.upload(ref_orientations, n_ref);
+
+    XY2DBins bins;
+    bins.max_x = max_x;
+    bins.max_y = max_y;
+    bins.dx_inv = 1.0f / dx;
+    bins.dy_inv = 1.0f / dy;
+    bins.n_bins_x = n_bins_x;
+    bins.n_bins_y = n_bins_y;
+
+    const size_t n_bins = size_t(n_bins_x)*n_bins_y;
+    unsigned long long *d_counts = m_data->clearCounts(n_bins);
+    checkCUDA(gpu_bin_pmft_xy2d(d_ref_points, d_angles, n_ref, cell_list, gpu_box, bins, d_counts),
+              "binning the PMFT");
+    m_data->downloadCounts(n_bins, counts);
+    }
+
+void PairBinnerGPU::binPMFTXYZ(const box::Box& box, const vec3<float> *ref_points,
+                               const quat<float> *ref_orientations, unsigned int n_ref, const vec3<float> *points,
+                               unsigned int n_p, const quat<float> *face_orientations, unsigned int n_faces,
+                               unsigned int face_stride, const vec3<float>& shiftvec, float r_cut, float max_x,
+                               float max_y, float max_z, float dx, float dy, float dz, unsigned int n_bins_x,
+                               unsigned int n_bins_y, unsigned int n_bins_z, util::BinCount *counts)
+    {
+    util::ScopedRange annotation("freud::PairBinnerGPU::binPMFTXYZ");
+    const GPUBox gpu_box = makeGPUBox(box);
+    const float4 *d_points = m_data->uploadPoints(m_data->points, points, n_p);
+    CellListData cell_list = m_data->computeCellList(box, gpu_box, d_points, n_p, r_cut);
+    const float4 *d_ref_points = m_data->uploadPoints(m_data->ref_points, ref_points, n_ref);
+    const float4 *d_ref_orientations = m_data->uploadQuats(m_data->ref_orientations, ref_orientations, n_ref);
+    const float4 *d_face_orientations = m_data->uploadQuats(m_data->face_orientations, face_orientations,
+                                                            (face_stride == 0) ? n_faces : size_t(n_ref)*n_faces);
+
+    XYZBins bins;
+    bins.max_x = max_x;
+    bins.max_y = max_y;
+    bins.max_z = max_z;
+    bins.dx_inv = 1.0f / dx;
+    bins.dy_inv = 1.0f / dy;
+    bins.dz_inv = 1.0f / dz;
+    bins.n_bins_x = n_bins_x;
+    bins.n_bins_y = n_bins_y;
+    bins.n_bins_z = n_bins_z;
+    bins.shiftvec = make_float3(shiftvec.x, shiftvec.y, shiftvec.z);
+
+    const size_t n_bins = size_t(n_bins_x)*n_bins_y*n_bins_z;
+    unsigned long long *d_counts = m_data->clearCounts(n_bins);
+    checkCUDA(gpu_bin_pmft_xyz(d_ref_points, d_ref_orientations, d_face_orientations, n_faces, face_stride, n_ref,
+                               cell_list, gpu_box, bins, d_counts), "binning the PMFT");
+    m_data->downloadCounts(n_bins, counts);
+    }
+
+#else // ENABLE_CUDA
+
+//! \internal
+//! Nothing is kept without CUDA
+struct PairBinnerGPU::DeviceData
+    {
+    };
+
+PairBinnerGPU::PairBinnerGPU()
+    {
+    throw runtime_error("freud was built without CUDA; configure it with ENABLE_CUDA=ON to bin on the GPU");
+    }
+
+PairBinnerGPU::~PairBinnerGPU()
+    {
+    }
+
+bool PairBinnerGPU::isAvailable()
+    {
+    return false;
+    }
+
+void PairBinnerGPU::binRDF(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                           const vec3<float> *points, unsigned int n_p, float rmax, const util::BinEdges& bin_edges,
+                           util::BinCount *counts)
+    {
+    throw runtime_error("freud was built without CUDA");
+    }
+
+void PairBinnerGPU::binPMFTXY2D(const box::Box& box, const vec3<float> *ref_points, const float *ref_orientations,
+                                unsigned int n_ref, const vec3<float> *points, unsigned int n_p, float r_cut,
+                                float max_x, float max_y, float dx, float dy, unsigned int n_bins_x,
+                                unsigned int n_bins_y, util::BinCount *counts)
+    {
+    throw runtime_error("freud was built without CUDA");
+    }
+
+void PairBinnerGPU::binPMFTXYZ(const box::Box& box, const vec3<float> *ref_points,
+                               const quat<float> *ref_orientations, unsigned int n_ref, const vec3<float> *points,
+                               unsigned int n_p, const quat<float> *face_orientations, unsigned int n_faces,
+                               unsigned int face_stride, const vec3<float>& shiftvec, float r_cut, float max_x,
+                               float max_y, float max_z, float dx, float dy, float dz, unsigned int n_bins_x,
+                               unsigned int n_bins_y, unsigned int n_bins_z, util::BinCount *counts)
+    {
+    throw runtime_error("freud was built without CUDA");
+    }
+
+#endif // ENABLE_CUDA
+
+}; }; // end namespace freud::gpu
@@ -0,0 +1,89 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "BinCount.h"
+#include "BinEdges.h"
+
+#ifndef _PAIR_BINNER_GPU_H__
+#define _PAIR_BINNER_GPU_H__
+
+/*! \file PairBinnerGPU.h
+    \brief Binning of the pairs of the RDF and the PMFTs on a CUDA GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Bin the pairs of one frame of the RDF, PMFTXY2D or PMFTXYZ on the GPU
+/*! The points are copied to the device, sorted into a cell list there, and the pairs of neighboring cells binned by
+    the kernels of PairHistogramGPU.cuh, one thread per reference point, into a histogram of the frame that is copied
+    back; the analyses add it to their accumulated histogram, so that the reduction, the normalization and the
+    checkpoints are the same as on the CPU. The device buffers are kept and grown across frames.
+
+    The kernels bin a pair as the CPU code does, but in a different order of operations, so a count may move to the
+    neighboring bin for pairs within rounding of a bin edge.
+
+    Without a build with ENABLE_CUDA, or without a CUDA device, the constructor throws std::runtime_error, so the
+    analyses can offer the GPU unconditionally.
+*/
+class PairBinnerGPU
+    {
+    public:
+        //! Constructor, on the current CUDA device
+        PairBinnerGPU();
+
+        //! Destructor
+        ~PairBinnerGPU();
+
+        //! Whether this build of freud supports CUDA and finds a device
+        static bool isAvailable();
+
+        //! Bin the distances of the pairs of the RDF
+        /*! \param rmax Largest distance binned, and the cutoff of the cell list
+            \param bin_edges Bins of the distances
+            \param counts Output: histogram of the frame, of bin_edges.getNBins() values
+
+            \a ref_points may be \a points, for the RDF of the points with themselves.
+        */
+        void binRDF(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                    const vec3<float> *points, unsigned int n_p, float rmax, const util::BinEdges& bin_edges,
+                    util::BinCount *counts);
+
+        //! Bin the pairs of PMFTXY2D by their vector in the frame of the reference point
+        /*! \param r_cut Cutoff of the cell list, the diagonal of the grid
+            \param counts Output: histogram of the frame, of n_bins_x*n_bins_y values
+        */
+        void binPMFTXY2D(const box::Box& box, const vec3<float> *ref_points, const float *ref_orientations,
+                         unsigned int n_ref, const vec3<float> *points, unsigned int n_p, float r_cut,
+                         float max_x, float max_y, float dx, float dy, unsigned int n_bins_x,
+                         unsigned int n_bins_y, util::BinCount *counts);
+
+        //! Bin the pairs of PMFTXYZ by their vector in the frame of each face of the reference point
+        /*! \param face_orientations n_faces orientations of the faces of each reference point, those of reference i
+                   starting at i*face_stride
+            \param face_stride n_faces, or 0 when all the reference points share the same faces
+            \param r_cut Cutoff of the cell list, the diagonal of the grid
+            \param counts Output: histogram of the frame, of n_bins_x*n_bins_y*n_bins_z values
+        */
+        void binPMFTXYZ(const box::Box& box, const vec3<float> *ref_points, const quat<float> *ref_orientations,
+                        unsigned int n_ref, const vec3<float> *points, unsigned int n_p,
+                        const quat<float> *face_orientations, unsigned int n_faces, unsigned int face_stride,
+                        const vec3<float>& shiftvec,
+                        float r_cut, float max_x, float max_y, float max_z, float dx, float dy, float dz,
+                        unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_z,
+                        util::BinCount *counts);
+
+    private:
+        struct DeviceData;
+        std::unique_ptr<DeviceData> m_data;     //!< Device buffers, reused across frames
+    };
+
+}; }; // end namespace freud::gpu
+
+#endif // _PAIR_BINNER_GPU_H__
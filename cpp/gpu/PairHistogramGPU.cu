@@ -0,0 +1,364 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "CellListGPU.cuh"
+#include "PairHistogramGPU.cuh"
+
+/*! \file PairHistogramGPU.cu
+    \brief Kernels binning the pairs of the RDF and the PMFTs on the GPU
+
+    One thread bins the pairs of one reference point, visiting the points of its neighboring cells. The binning of a
+    pair is that of the CPU code (RDF::binFrame, XY2DMapping and XYZMapping), so the histograms only differ where a
+    pair falls within rounding of a bin edge.
+*/
+
+namespace freud { namespace gpu {
+
+//! Number of threads of a block of the binning kernels
+const unsigned int PAIR_HISTOGRAM_BLOCK_SIZE = 256;
+
+//! \internal
+//! Histogram of a block, in shared memory when it fits and in global memory otherwise
+class BlockHistogram
+    {
+    public:
+        //! Clear the shared histogram of the block, called by all its threads
+        __device__ BlockHistogram(unsigned int *s_counts, unsigned long long *d_counts, unsigned int n_bins,
+                                  bool shared)
+            : m_s_counts(s_counts), m_d_counts(d_counts), m_n_bins(n_bins), m_shared(shared)
+            {
+            if (m_shared)
+                {
+                for (unsigned int bin = threadIdx.x; bin < m_n_bins; bin += blockDim.x)
+                    m_s_counts[bin] = 0;
+                __syncthreads();
+                }
+            }
+
+        //! Count a pair in a bin
+        __device__ void increment(unsigned int bin)
+            {
+            if (m_shared)
+                atomicAdd(&m_s_counts[bin], 1u);
+            else
+                atomicAdd(&m_d_counts[bin], 1ull);
+            }
+
+        //! Add the shared histogram to the global one, called by all the threads of the block
+        __device__ void flush()
+            {
+            if (!m_shared)
+                return;
+            __syncthreads();
+            for (unsigned int bin = threadIdx.x; bin < m_n_bins; bin += blockDim.x)
+                if (m_s_counts[bin] != 0)
+                    atomicAdd(&m_d_counts[bin], (unsigned long long) m_s_counts[bin]);
+            }
+
+    private:
+        unsigned int *m_s_counts;           //!< Histogram of the block in shared memory
+        unsigned long long *m_d_counts;     //!< Histogram in global memory
+        unsigned int m_n_bins;              //!< Number of bins
+        bool m_shared;                      //!< True when the block bins in shared memory
+    };
+
+//! \internal
+//! Call visit(delta) for the wrapped vector from ref to every point of the cells neighboring the cell of ref
+/*! Along axes of fewer than three cells every cell is visited once, as locality::LinkCell does.
+*/
+template<class Visitor>
+__device__ void forEachNeighbor(const CellListData& cells, const GPUBox& box, float3 ref, Visitor& visit)
+    {
+    const uint3 dim = cells.dim;
+    unsigned int ref_cell = getCell(box, dim, ref);
+    int cx = ref_cell % dim.x;
+    int cy = (ref_cell / dim.x) % dim.y;
+    int cz = ref_cell / (dim.x * dim.y);
+    int nx = (dim.x < 3) ? dim.x : 3;
+    int ny = (dim.y < 3) ? dim.y : 3;
+    int nz = (dim.z < 3) ? dim.z : 3;
+    for (int a = 0; a < nz; a++)
+        {
+        unsigned int z = (dim.z < 3) ? a : (cz + a - 1 + dim.z) % dim.z;
+        for (int b = 0; b < ny; b++)
+            {
+            unsigned int y = (dim.y < 3) ? b : (cy + b - 1 + dim.y) % dim.y;
+            for (int c = 0; c < nx; c++)
+                {
+                unsigned int x = (dim.x < 3) ? c : (cx + c - 1 + dim.x) % dim.x;
+                unsigned int cell = x + dim.x * (y + dim.y * z);
+                unsigned int end = cells.d_cell_start[cell + 1];
+                for (unsigned int j = cells.d_cell_start[cell]; j < end; j++)
+                    {
+                    float4 p = cells.d_sorted_points[j];
+                    visit(box.wrap(make_float3(p.x - ref.x, p.y - ref.y, p.z - ref.z)));
+                    }
+                }
+            }
+        }
+    }
+
+//! \internal
+//! Convert a floored bin coordinate to an index, negative coordinates becoming indices past the last bin
+__device__ inline unsigned int binIndex(float bin)
+    {
+    return (unsigned int) (int) bin;
+    }
+
+//! \internal
+//! Bin the distance of a pair of the RDF, as util::BinEdges::getBin()
+struct RDFVisitor
+    {
+    __device__ RDFVisitor(const RDFBins& bins, BlockHistogram& histogram)
+        : m_bins(bins), m_histogram(histogram)
+        {
+        }
+
+    __device__ void operator()(float3 delta)
+        {
+        float rsq = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+        if (rsq >= m_bins.rmaxsq)
+            return;
+        float r = sqrtf(rsq);
+        unsigned int bin;
+        if (m_bins.d_edges == NULL)
+            {
+            bin = (unsigned int) (r * m_bins.inv_width);
+            }
+        else
+            {
+            const float *edges = m_bins.d_edges;
+            if (r < edges[0] || r >= edges[m_bins.n_bins])
+                return;
+            // edges[lo] <= r < edges[hi]
+            unsigned int lo = 0, hi = m_bins.n_bins;
+            while (hi - lo > 1)
+                {
+                unsigned int mid = (lo + hi) / 2;
+                if (r >= edges[mid])
+                    lo = mid;
+                else
+                    hi = mid;
+                }
+            bin = lo;
+            }
+        if (bin < m_bins.n_bins)
+            m_histogram.increment(bin);
+        }
+
+    const RDFBins& m_bins;
+    BlockHistogram& m_histogram;
+    };
+
+//! \internal
+//! Bin a pair of PMFTXY2D by its vector in the frame of the reference point, as XY2DMapping
+struct XY2DVisitor
+    {
+    __device__ XY2DVisitor(const XY2DBins& bins, float angle, BlockHistogram& histogram)
+        : m_bins(bins), m_histogram(histogram)
+        {
+        // rotation by minus the angle of the reference point
+        sincosf(-angle, &m_sin, &m_cos);
+        }
+
+    __device__ void operator()(float3 delta)
+        {
+        float rsq = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+        // the point itself
+        if (rsq < 1e-6f)
+            return;
+        float x = m_cos * delta.x - m_sin * delta.y + m_bins.max_x;
+        float y = m_sin * delta.x + m_cos * delta.y + m_bins.max_y;
+        unsigned int ibinx = binIndex(floorf(x * m_bins.dx_inv));
+        unsigned int ibiny = binIndex(floorf(y * m_bins.dy_inv));
+        if ((ibinx < m_bins.n_bins_x) && (ibiny < m_bins.n_bins_y))
+            m_histogram.increment(ibinx + m_bins.n_bins_x * ibiny);
+        }
+
+    const XY2DBins& m_bins;
+    BlockHistogram& m_histogram;
+    float m_sin, m_cos;
+    };
+
+//! \internal
+//! Rows of the rotation matrix of a quaternion, the real part in w, as rotmat3
+__device__ inline void quatToRows(float4 q, float3 *rows)
+    {
+    float a = q.w, b = q.x, c = q.y, d = q.z;
+    rows[0] = make_float3(a*a + b*b - c*c - d*d, 2*b*c - 2*a*d, 2*b*d + 2*a*c);
+    rows[1] = make_float3(2*b*c + 2*a*d, a*a - b*b + c*c - d*d, 2*c*d - 2*a*b);
+    rows[2] = make_float3(2*b*d - 2*a*c, 2*c*d + 2*a*b, a*a - b*b - c*c + d*d);
+    }
+
+//! \internal
+//! Dot product of two vectors
+__device__ inline float dot3(float3 a, float3 b)
+    {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+//! \internal
+//! Bin a pair of PMFTXYZ by its vector in the frame of one face of the reference point, as XYZMapping
+struct XYZVisitor
+    {
+    //! The rotation of the face, Rface transpose(Rref)
+    __device__ XYZVisitor(const XYZBins& bins, const float3 *face_rows, const float3 *ref_rows,
+                          BlockHistogram& histogram)
+        : m_bins(bins), m_histogram(histogram)
+        {
+        for (unsigned int a = 0; a < 3; a++)
+            m_rot[a] = make_float3(dot3(face_rows[a], ref_rows[0]), dot3(face_rows[a], ref_rows[1]),
+                                   dot3(face_rows[a], ref_rows[2]));
+        }
+
+    __device__ void operator()(float3 delta)
+        {
+        float3 shifted = make_float3(delta.x + m_bins.shiftvec.x, delta.y + m_bins.shiftvec.y,
+                                     delta.z + m_bins.shiftvec.z);
+        // the point itself
+        if (dot3(shifted, shifted) < 1e-6f)
+            return;
+        float x = dot3(m_rot[0], delta) + m_bins.max_x;
+        float y = dot3(m_rot[1], delta) + m_bins.max_y;
+        float z = dot3(m_rot[2], delta) + m_bins.max_z;
+        unsigned int ibinx = binIndex(floorf(x * m_bins.dx_inv));
+        unsigned int ibiny = binIndex(floorf(y * m_bins.dy_inv));
+        unsigned int ibinz = binIndex(floorf(z * m_bins.dz_inv));
+        if ((ibinx < m_bins.n_bins_x) && (ibiny < m_bins.n_bins_y) && (ibinz < m_bins.n_bins_z))
+            m_histogram.increment(ibinx + m_bins.n_bins_x * (ibiny + m_bins.n_bins_y * ibinz));
+        }
+
+    const XYZBins& m_bins;
+    BlockHistogram& m_histogram;
+    float3 m_rot[3];
+    };
+
+//! \internal
+//! Bin the pairs of the RDF of one reference point per thread
+__global__ void gpu_bin_rdf_kernel(const float4 *d_ref_points, unsigned int n_ref, CellListData cells, GPUBox box,
+                                   RDFBins bins, unsigned long long *d_counts, bool shared)
+    {
+    extern __shared__ unsigned int s_counts[];
+    BlockHistogram histogram(s_counts, d_counts, bins.n_bins, shared);
+
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < n_ref)
+        {
+        float4 ref = d_ref_points[i];
+        RDFVisitor visit(bins, histogram);
+        forEachNeighbor(cells, box, make_float3(ref.x, ref.y, ref.z), visit);
+        }
+    histogram.flush();
+    }
+
+//! \internal
+//! Bin the pairs of PMFTXY2D of one reference point per thread
+__global__ void gpu_bin_pmft_xy2d_kernel(const float4 *d_ref_points, const float *d_ref_orientations,
+                                         unsigned int n_ref, CellListData cells, GPUBox box, XY2DBins bins,
+                                         unsigned long long *d_counts, bool shared)
+    {
+    extern __shared__ unsigned int s_counts[];
+    BlockHistogram histogram(s_counts, d_counts, bins.n_bins_x * bins.n_bins_y, shared);
+
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < n_ref)
+        {
+        float4 ref = d_ref_points[i];
+        XY2DVisitor visit(bins, d_ref_orientations[i], histogram);
+        forEachNeighbor(cells, box, make_float3(ref.x, ref.y, ref.z), visit);
+        }
+    histogram.flush();
+    }
+
+//! \internal
+//! Bin the pairs of PMFTXYZ of one reference point per thread, one pass over the neighbors per face
+__global__ void gpu_bin_pmft_xyz_kernel(const float4 *d_ref_points, const float4 *d_ref_orientations,
+                                        const float4 *d_face_orientations, unsigned int n_faces,
+                                        unsigned int face_stride, unsigned int n_ref,
+                                        CellListData cells, GPUBox box, XYZBins bins, unsigned long long *d_counts,
+                                        bool shared)
+    {
+    extern __shared__ unsigned int s_counts[];
+    BlockHistogram histogram(s_counts, d_counts, bins.n_bins_x * bins.n_bins_y * bins.n_bins_z, shared);
+
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < n_ref)
+        {
+        float4 ref = d_ref_points[i];
+        float3 ref_rows[3];
+        quatToRows(d_ref_orientations[i], ref_rows);
+        for (unsigned int k = 0; k < n_faces; k++)
+            {
+            float3 face_rows[3];
+            quatToRows(d_face_orientations[i * face_stride + k], face_rows);
+            XYZVisitor visit(bins, face_rows, ref_rows, histogram);
+            forEachNeighbor(cells, box, make_float3(ref.x, ref.y, ref.z), visit);
+            }
+        }
+    histogram.flush();
+    }
+
+//! \internal
+//! Number of blocks of one thread per reference point
+static unsigned int numBlocks(unsigned int n_ref)
+    {
+    return (n_ref + PAIR_HISTOGRAM_BLOCK_SIZE - 1) / PAIR_HISTOGRAM_BLOCK_SIZE;
+    }
+
+cudaError_t gpu_bin_rdf(const float4 *d_ref_points,
+                        unsigned int n_ref,
+                        const CellListData& cells,
+                        const GPUBox& box,
+                        const RDFBins& bins,
+                        unsigned long long *d_counts)
+    {
+    if (n_ref == 0)
+        return cudaSuccess;
+    bool shared = bins.n_bins <= SHARED_HISTOGRAM_MAX_BINS;
+    size_t shared_bytes = shared ? bins.n_bins * sizeof(unsigned int) : 0;
+    gpu_bin_rdf_kernel<<<numBlocks(n_ref), PAIR_HISTOGRAM_BLOCK_SIZE, shared_bytes>>>(
+        d_ref_points, n_ref, cells, box, bins, d_counts, shared);
+    return cudaGetLastError();
+    }
+
+cudaError_t gpu_bin_pmft_xy2d(const float4 *d_ref_points,
+                              const float *d_ref_orientations,
+                              unsigned int n_ref,
+                              const CellListData& cells,
+                              const GPUBox& box,
+                              const XY2DBins& bins,
+                              unsigned long long *d_counts)
+    {
+    if (n_ref == 0)
+        return cudaSuccess;
+    unsigned int n_bins = bins.n_bins_x * bins.n_bins_y;
+    bool shared = n_bins <= SHARED_HISTOGRAM_MAX_BINS;
+    size_t shared_bytes = shared ? n_bins * sizeof(unsigned int) : 0;
+    gpu_bin_pmft_xy2d_kernel<<<numBlocks(n_ref), PAIR_HISTOGRAM_BLOCK_SIZE, shared_bytes>>>(
+        d_ref_points, d_ref_orientations, n_ref, cells, box, bins, d_counts, shared);
+    return cudaGetLastError();
+    }
+
+cudaError_t gpu_bin_pmft_xyz(const float4 *d_ref_points,
+                             const float4 *d_ref_orientations,
+                             const float4 *d_face_orientations,
+                             unsigned int n_faces,
+                             unsigned int face_stride,
+                             unsigned int n_ref,
+                             const CellListData& cells,
+                             const GPUBox& box,
+                             const XYZBins& bins,
+                             unsigned long long *d_counts)
+    {
+    if (n_ref == 0)
+        return cudaSuccess;
+    unsigned int n_bins = bins.n_bins_x * bins.n_bins_y * bins.n_bins_z;
+    bool shared = n_bins <= SHARED_HISTOGRAM_MAX_BINS;
+    size_t shared_bytes = shared ? n_bins * sizeof(unsigned int) : 0;
+    gpu_bin_pmft_xyz_kernel<<<numBlocks(n_ref), PAIR_HISTOGRAM_BLOCK_SIZE, shared_bytes>>>(
+        d_ref_points, d_ref_orientations, d_face_orientations, n_faces, face_stride, n_ref, cells, box, bins, d_counts,
+        shared);
+    return cudaGetLastError();
+    }
+
+}; }; // end namespace freud::gpu
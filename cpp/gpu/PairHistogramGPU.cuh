@@ -0,0 +1,108 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cuda_runtime.h>
+
+#include "GPUBox.h"
+
+#ifndef _PAIR_HISTOGRAM_GPU_CUH__
+#define _PAIR_HISTOGRAM_GPU_CUH__
+
+/*! \file PairHistogramGPU.cuh
+    \brief Declares the drivers of the kernels binning the pairs of the RDF and the PMFTs on the GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Largest number of bins of the histogram a block keeps in shared memory, 32 KiB of 32 bit counts
+/*! Each block bins the pairs of its reference points into a histogram of its own in shared memory and adds it to the
+    histogram in global memory at the end, so that the threads of a block contend on fast shared atomics and the
+    global histogram takes one atomic per bin and block. Larger histograms are binned directly in global memory, where
+    the pairs of the threads spread over the many bins.
+*/
+const unsigned int SHARED_HISTOGRAM_MAX_BINS = 8192;
+
+//! Points sorted by cell, as built by gpu_compute_cell_list()
+struct CellListData
+    {
+    const float4 *d_sorted_points;      //!< Points sorted by cell, w unused
+    const unsigned int *d_cell_start;   //!< First sorted point of each cell, and the number of points
+    uint3 dim;                          //!< Number of cells along each lattice vector
+    };
+
+//! Bins of the RDF
+struct RDFBins
+    {
+    float rmaxsq;           //!< Square of the largest distance binned
+    unsigned int n_bins;    //!< Number of bins
+    float inv_width;        //!< Inverse width of uniform bins starting at 0
+    const float *d_edges;   //!< n_bins + 1 edges of non-uniform bins, or NULL for uniform bins
+    };
+
+//! Bins of PMFTXY2D
+struct XY2DBins
+    {
+    float max_x, max_y;                 //!< Half extents of the grid
+    float dx_inv, dy_inv;               //!< Inverse widths of the bins
+    unsigned int n_bins_x, n_bins_y;    //!< Number of bins along each axis
+    };
+
+//! Bins of PMFTXYZ
+struct XYZBins
+    {
+    float max_x, max_y, max_z;                      //!< Half extents of the grid
+    float dx_inv, dy_inv, dz_inv;                   //!< Inverse widths of the bins
+    unsigned int n_bins_x, n_bins_y, n_bins_z;      //!< Number of bins along each axis
+    float3 shiftvec;                                //!< Shift of the pair vectors in the check of self pairs
+    };
+
+//! Bin the distances of the pairs of reference points and points on the GPU
+/*! \param d_ref_points Reference points, w unused
+    \param n_ref Number of reference points
+    \param cells Cell list of the points, of cells at least rmax wide
+    \param box Box of the points
+    \param bins Bins of the RDF
+    \param d_counts Histogram the counts are added to, of bins.n_bins values
+
+    Each thread visits the points of the cells neighboring one reference point, as RDF::accumulate() without a
+    neighbor list does.
+*/
+cudaError_t gpu_bin_rdf(const float4 *d_ref_points,
+                        unsigned int n_ref,
+                        const CellListData& cells,
+                        const GPUBox& box,
+                        const RDFBins& bins,
+                        unsigned long long *d_counts);
+
+//! Bin the pairs of PMFTXY2D on the GPU
+/*! \param d_ref_orientations Angle of each reference point
+    Other parameters as gpu_bin_rdf(), the cells being at least as wide as the diagonal of the grid.
+*/
+cudaError_t gpu_bin_pmft_xy2d(const float4 *d_ref_points,
+                              const float *d_ref_orientations,
+                              unsigned int n_ref,
+                              const CellListData& cells,
+                              const GPUBox& box,
+                              const XY2DBins& bins,
+                              unsigned long long *d_counts);
+
+//! Bin the pairs of PMFTXYZ on the GPU, once per face of the reference point
+/*! \param d_ref_orientations Quaternion of each reference point, the real part in w
+    \param d_face_orientations Quaternion of face k of reference point i at i*face_stride + k, the real part in w
+    \param face_stride n_faces, or 0 when all the reference points share the same faces
+    Other parameters as gpu_bin_rdf(), the cells being at least as wide as the diagonal of the grid.
+*/
+cudaError_t gpu_bin_pmft_xyz(const float4 *d_ref_points,
+                             const float4 *d_ref_orientations,
+                             const float4 *d_face_orientations,
+                             unsigned int n_faces,
+                             unsigned int face_stride,
+                             unsigned int n_ref,
+                             const CellListData& cells,
+                             const GPUBox& box,
+                             const XYZBins& bins,
+                             unsigned long long *d_counts);
+
+}; }; // end namespace freud::gpu
+
+#endif // _PAIR_HISTOGRAM_GPU_CUH__
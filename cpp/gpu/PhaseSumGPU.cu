@@ -0,0 +1,72 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "PhaseSumGPU.cuh"
+
+/*! \file PhaseSumGPU.cu
+    \brief Kernel summing the phases of the Fourier transforms on the GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Number of threads of a block of the phase sum kernel, and of particles of a tile
+const unsigned int PHASE_SUM_BLOCK_SIZE = 256;
+
+//! \internal
+//! Sum the phases of the particles at one K point per thread, the particles being read in tiles of blockDim.x
+__global__ void gpu_sum_phases_kernel(const float4 *d_K, unsigned int NK, const float4 *d_r, unsigned int Np,
+                                      float *d_cos_sum, float *d_sin_sum)
+    {
+    extern __shared__ float4 s_r[];
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+    // the threads past the last K point still load their share of the tiles
+    float4 K = (i < NK) ? d_K[i] : make_float4(0.0f, 0.0f, 0.0f, 0.0f);
+    double cos_sum = 0.0;
+    double sin_sum = 0.0;
+    for (unsigned int j_begin = 0; j_begin < Np; j_begin += blockDim.x)
+        {
+        unsigned int j = j_begin + threadIdx.x;
+        if (j < Np)
+            s_r[threadIdx.x] = d_r[j];
+        __syncthreads();
+
+        unsigned int tile_size = min(blockDim.x, Np - j_begin);
+        float cos_partial = 0.0f;
+        float sin_partial = 0.0f;
+        for (unsigned int t = 0; t < tile_size; t++)
+            {
+            float4 r = s_r[t];
+            float s, c;
+            sincosf(K.x*r.x + K.y*r.y + K.z*r.z, &s, &c);
+            cos_partial += c;
+            sin_partial += s;
+            }
+        cos_sum += cos_partial;
+        sin_sum += sin_partial;
+        __syncthreads();
+        }
+    if (i < NK)
+        {
+        d_cos_sum[i] = float(cos_sum);
+        d_sin_sum[i] = float(sin_sum);
+        }
+    }
+
+cudaError_t gpu_sum_phases(const float4 *d_K,
+                           unsigned int NK,
+                           const float4 *d_r,
+                           unsigned int Np,
+                           float *d_cos_sum,
+                           float *d_sin_sum,
+                           cudaStream_t stream)
+    {
+    if (NK == 0)
+        return cudaSuccess;
+    unsigned int num_blocks = (NK + PHASE_SUM_BLOCK_SIZE - 1) / PHASE_SUM_BLOCK_SIZE;
+    size_t shared_bytes = PHASE_SUM_BLOCK_SIZE * sizeof(float4);
+    gpu_sum_phases_kernel<<<num_blocks, PHASE_SUM_BLOCK_SIZE, shared_bytes, stream>>>(
+        d_K, NK, d_r, Np, d_cos_sum, d_sin_sum);
+    return cudaGetLastError();
+    }
+
+}; }; // end namespace freud::gpu
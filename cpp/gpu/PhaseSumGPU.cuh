@@ -0,0 +1,39 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cuda_runtime.h>
+
+#include "HOOMDMath.h"
+
+#ifndef _PHASE_SUM_GPU_CUH__
+#define _PHASE_SUM_GPU_CUH__
+
+/*! \file PhaseSumGPU.cuh
+    \brief Declares the driver of the kernel summing the phases of the Fourier transforms on the GPU
+*/
+
+namespace freud { namespace gpu {
+
+//! Sum cos(K . r) and sin(K . r) over the particles at each K point on the GPU
+/*! \param d_K K points, w unused
+    \param NK Number of K points
+    \param d_r Positions of the particles, w unused
+    \param Np Number of particles
+    \param d_cos_sum Output: sum of cos(K . r) at each K point
+    \param d_sin_sum Output: sum of sin(K . r) at each K point
+    \param stream Stream the kernel is queued on
+
+    Each thread sums the phases of one K point, as kspace::FTdelta::sumPhases() does: the positions are read by the
+    blocks in tiles of shared memory, and the sums of the tiles are added in double precision.
+*/
+cudaError_t gpu_sum_phases(const float4 *d_K,
+                           unsigned int NK,
+                           const float4 *d_r,
+                           unsigned int Np,
+                           float *d_cos_sum,
+                           float *d_sin_sum,
+                           cudaStream_t stream);
+
+}; }; // end namespace freud::gpu
+
+#endif // _PHASE_SUM_GPU_CUH__
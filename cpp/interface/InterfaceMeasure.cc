@@ -3,16 +3,21 @@
 
 #include "InterfaceMeasure.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+
 using namespace std;
+using namespace tbb;
 
-/*! \file InterfaceMeasure.h
+/*! \file InterfaceMeasure.cc
     \brief Compute the size of an interface between two point clouds
 */
 
 namespace freud { namespace interface {
 
 InterfaceMeasure::InterfaceMeasure(const box::Box& box, float r_cut)
-    : m_box(box), m_rcut(r_cut), m_lc(box, r_cut)
+    : m_box(box), m_rcut(r_cut), m_lc(box, r_cut), m_shape_lc(box, r_cut), m_n_ref(0), m_Np(0), m_num_types(0)
     {
         if (r_cut < 0.0f)
             throw invalid_argument("r_cut must be positive");
@@ -25,66 +30,234 @@ InterfaceMeasure::InterfaceMeasure(const box::Box& box, float r_cut)
 unsigned int InterfaceMeasure::compute(const vec3<float> *ref_points,
                                        unsigned int n_ref,
                                        const vec3<float> *points,
-                                       unsigned int Np)
+                                       unsigned int Np,
+                                       const locality::NeighborList *nlist)
 {
     assert(ref_points);
     assert(points);
     assert(n_ref > 0);
     assert(Np > 0);
 
-    // bin the second set of points
-    m_lc.computeCellList(m_box, points, Np);
-
-    unsigned int interfaceCount = 0;
-    float rcutsq = m_rcut * m_rcut;
+    if (n_ref != m_n_ref || !m_interface_mask)
+        m_interface_mask = std::shared_ptr<bool>(new bool[n_ref], std::default_delete<bool[]>());
+    m_n_ref = n_ref;
+    bool *mask = m_interface_mask.get();
+    const float rcut = m_rcut;
 
-    // for each reference point
-    for( unsigned int i = 0; i < n_ref; i++)
+    if (nlist != NULL)
     {
-        bool inInterface = false;
+        nlist->validate(n_ref, Np);
+        const float *distances = nlist->getDistances().get();
+
+        // a reference point is in the interface if any of its bonds is within the cutoff
+        return parallel_reduce(blocked_range<size_t>(0, n_ref), 0u,
+            [=] (const blocked_range<size_t>& r, unsigned int interfaceCount)
+            {
+                for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                    bool inInterface = false;
+                    size_t last_bond = nlist->getLastBondWithin(i, rcut);
+                    for (size_t bond = nlist->getFirstBond(i); bond < last_bond; bond++)
+                    {
+                        if (distances[bond] < rcut)
+                        {
+                            inInterface = true;
+                            break;
+                        }
+                    }
+                    mask[i] = inInterface;
+                    interfaceCount += inInterface;
+                }
+                return interfaceCount;
+            },
+            [] (unsigned int a, unsigned int b)
+            {
+                return a + b;
+            });
+    }
+
+    // each reference point stops at the first point within the cutoff, without computing any pair
+    return m_lc.findAnyNeighbor(m_box, ref_points, n_ref, points, Np, false, mask);
+}
+
+/*! The split points of two shapes are at most twice the largest distance of a split point to the center of its
+    shape further apart than the centers, so the cell list of the centers has cells of r_cut plus that margin. For
+    each reference shape, the neighbor shapes whose centers are within the enlarged cutoff are visited until every
+    split point of the reference shape is known to be in the interface. The split points are kept relative to the
+    centers, so that only the vector between the centers is wrapped, and those of a neighbor shape are only rotated
+    once a split point of the reference shape is within r_cut plus the margin of its center. The box must be at
+    least twice the enlarged cutoff, as for any cell list.
+*/
+unsigned int InterfaceMeasure::computeShapes(const vec3<float> *ref_points,
+                                             const quat<float> *ref_orientations,
+                                             unsigned int n_ref,
+                                             const vec3<float> *points,
+                                             const quat<float> *orientations,
+                                             unsigned int Np,
+                                             const vec3<float> *split_points,
+                                             unsigned int Nsplit)
+{
+    assert(ref_points);
+    assert(ref_orientations);
+    assert(points);
+    assert(orientations);
+    assert(split_points);
+    if (Nsplit == 0)
+        throw invalid_argument("computeShapes needs at least one split point");
+
+    const unsigned int n_split_ref = n_ref*Nsplit;
+    if (n_split_ref != m_n_ref || !m_interface_mask)
+        m_interface_mask = std::shared_ptr<bool>(new bool[n_split_ref], std::default_delete<bool[]>());
+    m_n_ref = n_split_ref;
+    bool *mask = m_interface_mask.get();
+    memset((void*)mask, 0, sizeof(bool)*n_split_ref);
+    if (n_ref == 0 || Np == 0)
+        return 0;
 
-        // get the cell the point is in
-        // float3 ref = ref_points[i];
-        vec3<float> ref = ref_points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
+    float radius = 0.0f;
+    for (unsigned int s = 0; s < Nsplit; s++)
+        radius = std::max(radius, sqrtf(dot(split_points[s], split_points[s])));
+    const float shape_cut = m_rcut + 2.0f*radius;
+    m_shape_lc.setCellWidth(shape_cut);
+    m_shape_lc.computeCellList(m_box, points, Np);
+    const locality::LinkCell *lc = &m_shape_lc;
+    const box::Box box = m_box;
+    const float rcutsq = m_rcut * m_rcut;
+    const float shape_cutsq = shape_cut * shape_cut;
+    const float split_cutsq = (m_rcut + radius) * (m_rcut + radius);
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+    return parallel_reduce(blocked_range<size_t>(0, n_ref), 0u,
+        [=] (const blocked_range<size_t>& r, unsigned int interfaceCount)
         {
-            if(inInterface)
-                break;
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
+            // the split points of the reference shape, then those of the neighbor shape, relative to their centers
+            std::vector< vec3<float> >& split = m_local_split.local();
+            split.resize(2*Nsplit);
+            vec3<float> *ref_split = &split[0];
+            vec3<float> *neigh_split = &split[Nsplit];
+            for (size_t i = r.begin(); i != r.end(); i++)
+            {
+                bool *near = mask + i*Nsplit;
+                const vec3<float> ref = ref_points[i];
+                for (unsigned int a = 0; a < Nsplit; a++)
+                    ref_split[a] = rotate(ref_orientations[i], split_points[a]);
+                unsigned int num_missing = Nsplit;
 
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+                const locality::CellNeighbors& neigh_cells = lc->getCellNeighbors(lc->getCell(ref));
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size() && num_missing; neigh_idx++)
+                {
+                    locality::LinkCell::iteratorcell it = lc->itercell(neigh_cells[neigh_idx]);
+                    for (unsigned int j = it.next(); !it.atEnd() && num_missing; j = it.next())
+                    {
+                        const vec3<float> center_delta = box.wrap(ref - points[j]);
+                        if (dot(center_delta, center_delta) >= shape_cutsq)
+                            continue;
+                        bool rotated = false;
+                        for (unsigned int a = 0; a < Nsplit; a++)
+                        {
+                            if (near[a])
+                                continue;
+                            // split point a of the reference shape relative to the center of shape j
+                            const vec3<float> ref_delta = center_delta + ref_split[a];
+                            if (dot(ref_delta, ref_delta) >= split_cutsq)
+                                continue;
+                            if (!rotated)
+                            {
+                                for (unsigned int b = 0; b < Nsplit; b++)
+                                    neigh_split[b] = rotate(orientations[j], split_points[b]);
+                                rotated = true;
+                            }
+                            for (unsigned int b = 0; b < Nsplit; b++)
+                            {
+                                const vec3<float> delta = ref_delta - neigh_split[b];
+                                if (dot(delta, delta) < rcutsq)
+                                {
+                                    near[a] = true;
+                                    num_missing--;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+                interfaceCount += Nsplit - num_missing;
+            }
+            return interfaceCount;
+        },
+        [] (unsigned int a, unsigned int b)
+        {
+            return a + b;
+        });
+}
+
+/*! \param points Positions of the points of all the types
+    \param types Type of each point, below num_types
+    \param Np Number of points
+    \param num_types Number of types
+
+    The points of all the types share one cell list, and each point stops searching once it has found a point of
+    every type within the cutoff, so all the interfaces cost about as much as the one between the largest types.
+*/
+void InterfaceMeasure::computeTypes(const vec3<float> *points,
+                                    const unsigned int *types,
+                                    unsigned int Np,
+                                    unsigned int num_types)
+{
+    assert(points);
+    assert(types);
+    if (num_types == 0)
+        throw invalid_argument("computeTypes needs at least one type");
+    for (unsigned int i = 0; i < Np; i++)
+        if (types[i] >= num_types)
+            throw invalid_argument("Every type must be below num_types");
+
+    if (Np != m_Np || num_types != m_num_types || !m_type_mask)
+        m_type_mask = std::shared_ptr<bool>(new bool[Np*num_types], std::default_delete<bool[]>());
+    if (num_types != m_num_types || !m_type_counts)
+        m_type_counts = std::shared_ptr<unsigned int>(new unsigned int[num_types*num_types],
+                                                      std::default_delete<unsigned int[]>());
+    m_Np = Np;
+    m_num_types = num_types;
+    bool *mask = m_type_mask.get();
+    memset((void*)mask, 0, sizeof(bool)*Np*num_types);
+
+    m_lc.computeCellList(m_box, points, Np);
+    const locality::LinkCell *lc = &m_lc;
+    const box::Box box = m_box;
+    const float rcutsq = m_rcut * m_rcut;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+            for (size_t i = r.begin(); i != r.end(); i++)
             {
-                if(inInterface)
-                    break;
-                vec3<float> delta = ref - points[j];
-                // compute the distance between the two particles
-                // float dx = float(ref.x - points[j].x);
-                // float dy = float(ref.y - points[j].y);
-                // float dz = float(ref.z - points[j].z);
-
-                delta = m_box.wrap(delta);
-
-                // Check if the distance is less than the cutoff
-                // float deltasq = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
-                float rsq = dot(delta, delta);
-                // if (deltasq < rcutsq)
-                if (rsq < rcutsq)
+                bool *near = mask + i*num_types;
+                unsigned int num_missing = num_types;
+                vec3<float> ref = points[i];
+                const locality::CellNeighbors& neigh_cells = lc->getCellNeighbors(lc->getCell(ref));
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size() && num_missing; neigh_idx++)
                 {
-                    inInterface = true;
-                    break;
+                    locality::LinkCell::iteratorcell it = lc->itercell(neigh_cells[neigh_idx]);
+                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+                    {
+                        if (j == i || near[types[j]])
+                            continue;
+                        vec3<float> delta = box.wrap(ref - points[j]);
+                        if (dot(delta, delta) < rcutsq)
+                        {
+                            near[types[j]] = true;
+                            if (--num_missing == 0)
+                                break;
+                        }
+                    }
                 }
             }
-        }
-        if(inInterface)
-            interfaceCount++;
-    }
-    return interfaceCount;
+        });
+
+    // the size of each interface, from the mask
+    unsigned int *counts = m_type_counts.get();
+    memset((void*)counts, 0, sizeof(unsigned int)*num_types*num_types);
+    for (unsigned int i = 0; i < Np; i++)
+        for (unsigned int b = 0; b < num_types; b++)
+            counts[types[i]*num_types + b] += mask[i*num_types + b];
 }
 
 // unsigned int InterfaceMeasure::computePy(boost::python::numeric::array ref_points,
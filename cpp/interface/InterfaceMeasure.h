@@ -2,12 +2,14 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include <memory>
+#include <tbb/tbb.h>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "box.h"
 #include "LinkCell.h"
+#include "ComputeArena.h"
 
 #ifndef _INTERFACEMEASURE_H_
 #define _INTERFACEMEASURE_H_
@@ -20,7 +22,16 @@ namespace freud { namespace interface {
 
 //! Computes the amount of interface for two given sets of points
 /*! Given two sets of points, calculates the amount of points in the first set (reference) that are within a
- *  cutoff distance from any point in the second set.
+ *  cutoff distance from any point in the second set, along with a mask of the reference points in the interface.
+ *  The reference points are tested in parallel, each stopping at the first point within the cutoff.
+ *
+ *  computeTypes() measures the interfaces between all the pairs of types of one set of typed points at once, with a
+ *  single cell list: for each point and each type, whether a point of that type (other than itself) is within the
+ *  cutoff, and for each pair of types (a, b) the number of points of type a within the cutoff of a point of type b.
+ *
+ *  computeShapes() measures the interface between the split points of two sets of shapes, as ShapeSplit would place
+ *  them, without storing them: the cell list holds the centers of the shapes, and the split points of a pair of
+ *  shapes are only built when the centers are close enough for any of them to be within the cutoff.
  *
  *  <b>2D:</b><br>
  *  InterfaceMeasure properly handles 2D boxes. As with everything else in freud, 2D points must be passed in
@@ -44,10 +55,71 @@ class InterfaceMeasure
         //                      const float3 *points,
         //                      unsigned int Np);
 
+        //! Compute the number of reference points within r_cut of any point
+        /*! If \a nlist is given, its bonds are used instead of building the internal cell list
+        */
         unsigned int compute(const vec3<float> *ref_points,
                              unsigned int n_ref,
                              const vec3<float> *points,
-                             unsigned int Np);
+                             unsigned int Np,
+                             const locality::NeighborList *nlist=NULL);
+
+        //! Get the number of reference points of the last compute, n_ref Nsplit after computeShapes
+        unsigned int getNRef() const
+        {
+            return m_n_ref;
+        }
+
+        //! Get whether each reference point of the last compute is within r_cut of any point
+        std::shared_ptr<bool> getInterfaceMask()
+        {
+            return m_interface_mask;
+        }
+
+        //! Compute the number of split points of the reference shapes within r_cut of any split point of the shapes
+        /*! Gives the result of compute() on the split points of ShapeSplit, with n_ref Nsplit reference points in
+            the order of the shapes then of the split points, without the Np Nsplit array nor its cell list.
+
+            \param split_points Nsplit split points in the frame of a shape, shared by both sets of shapes
+        */
+        unsigned int computeShapes(const vec3<float> *ref_points,
+                                   const quat<float> *ref_orientations,
+                                   unsigned int n_ref,
+                                   const vec3<float> *points,
+                                   const quat<float> *orientations,
+                                   unsigned int Np,
+                                   const vec3<float> *split_points,
+                                   unsigned int Nsplit);
+
+        //! Compute the interfaces between every pair of types of the points
+        void computeTypes(const vec3<float> *points,
+                          const unsigned int *types,
+                          unsigned int Np,
+                          unsigned int num_types);
+
+        //! Get the number of points of the last computeTypes
+        unsigned int getNP() const
+        {
+            return m_Np;
+        }
+
+        //! Get the number of types of the last computeTypes
+        unsigned int getNumTypes() const
+        {
+            return m_num_types;
+        }
+
+        //! Get whether each point is within r_cut of a point of each type, Np x num_types
+        std::shared_ptr<bool> getTypeMask()
+        {
+            return m_type_mask;
+        }
+
+        //! Get the number of points of each type a within r_cut of a point of each type b, num_types x num_types
+        std::shared_ptr<unsigned int> getTypeCounts()
+        {
+            return m_type_counts;
+        }
 
         // //! Python wrapper for compute
         // unsigned int computePy(boost::python::numeric::array ref_points,
@@ -56,6 +128,16 @@ class InterfaceMeasure
         box::Box m_box;          //!< Simulation box the particles belong in
         float m_rcut;                   //!< Maximum distance at which a particle is considered to be in an interface
         locality::LinkCell m_lc;        //!< LinkCell to bin particles for the computation
+        locality::LinkCell m_shape_lc;  //!< LinkCell of the centers of the shapes of computeShapes
+        util::ThreadScratch< std::vector< vec3<float> > > m_local_split;   //!< Split points of the pair of shapes
+                                                                            //!< of each thread of computeShapes,
+                                                                            //!< relative to their centers
+        unsigned int m_n_ref;           //!< Number of reference points of the last compute
+        std::shared_ptr<bool> m_interface_mask;     //!< Whether each reference point is in the interface
+        unsigned int m_Np;              //!< Number of points of the last computeTypes
+        unsigned int m_num_types;       //!< Number of types of the last computeTypes
+        std::shared_ptr<bool> m_type_mask;          //!< Whether each point is near each type
+        std::shared_ptr<unsigned int> m_type_counts;    //!< Number of points of each type near each type
 };
 
 }; }; // end namespace freud::interface
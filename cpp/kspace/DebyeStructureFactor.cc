@@ -0,0 +1,176 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "DebyeStructureFactor.h"
+#include "FFT.h"
+
+#include <complex>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file DebyeStructureFactor.cc
+    \brief Spherically averaged static structure factor from the histogram of pair distances
+*/
+
+namespace freud { namespace kspace {
+
+DebyeStructureFactor::DebyeStructureFactor(float rmax, float dr, float q_min, float q_max, unsigned int num_q,
+                                           bool window)
+    : m_rdf(rmax, dr), m_rmax(rmax), m_num_q(num_q), m_window(window), m_density(0.0f), m_reduce(true)
+    {
+    if (num_q == 0)
+        throw invalid_argument("num_q must be positive");
+    if (q_min < 0.0f || q_max < q_min)
+        throw invalid_argument("q values must satisfy 0 <= q_min <= q_max");
+
+    m_q_array = std::shared_ptr<float>(new float[m_num_q], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_num_q; i++)
+        m_q_array.get()[i] = (m_num_q > 1) ? q_min + (q_max - q_min) * float(i) / float(m_num_q - 1) : q_min;
+    m_S_array = std::shared_ptr<float>(new float[m_num_q], std::default_delete<float[]>());
+    memset((void*)m_S_array.get(), 0, sizeof(float)*m_num_q);
+    }
+
+void DebyeStructureFactor::reset()
+    {
+    m_rdf.resetRDF();
+    m_density = 0.0f;
+    m_reduce = true;
+    }
+
+void DebyeStructureFactor::accumulate(box::Box& box, const vec3<float> *points, unsigned int Np,
+                                      const locality::NeighborList *nlist)
+    {
+    if (box.is2D())
+        throw invalid_argument("DebyeStructureFactor does not support 2D boxes");
+    m_rdf.accumulate(box, points, Np, points, Np, nlist);
+    // the RDF is normalized with the density of the last frame
+    m_density = float(Np) / box.getVolume();
+    m_reduce = true;
+    }
+
+//! \internal
+//! Transform the RDF into S
+void DebyeStructureFactor::reduceS()
+    {
+    if (m_density == 0.0f)
+        {
+        memset((void*)m_S_array.get(), 0, sizeof(float)*m_num_q);
+        return;
+        }
+
+    // rho (g(r) - 1) times the volume of each shell, and the window, at the bin centers
+    const unsigned int nbins = m_rdf.getNBins();
+    const float *rdf = m_rdf.getRDF().get();
+    const float *r = m_rdf.getR().get();
+    const std::vector<float>& edges = m_rdf.getBinEdges();
+    std::vector<double> weights(nbins);
+    std::vector<double> radii(r, r + nbins);
+    for (unsigned int i = 0; i < nbins; i++)
+        {
+        double r_lo = edges[i];
+        double r_hi = edges[i+1];
+        double shell_volume = 4.0 * M_PI / 3.0 * (r_hi*r_hi*r_hi - r_lo*r_lo*r_lo);
+        double window = 1.0;
+        if (m_window)
+            {
+            double x = M_PI * radii[i] / m_rmax;
+            window = (x > 0.0) ? sin(x) / x : 1.0;
+            }
+        weights[i] = double(m_density) * (double(rdf[i]) - 1.0) * shell_volume * window;
+        }
+
+    const double *l_weights = &weights[0];
+    const double *l_radii = &radii[0];
+    const float *q = m_q_array.get();
+    float *S = m_S_array.get();
+    parallel_for(blocked_range<size_t>(0, m_num_q),
+        [=] (const blocked_range<size_t>& range)
+        {
+        for (size_t i = range.begin(); i != range.end(); i++)
+            {
+            double sum = 1.0;
+            for (unsigned int b = 0; b < nbins; b++)
+                {
+                double x = double(q[i]) * l_radii[b];
+                sum += l_weights[b] * ((x > 0.0) ? sin(x) / x : 1.0);
+                }
+            S[i] = float(sum);
+            }
+        });
+    }
+
+std::shared_ptr<float> DebyeStructureFactor::getS()
+    {
+    if (m_reduce == true)
+        {
+        reduceS();
+        }
+    m_reduce = false;
+    return m_S_array;
+    }
+
+unsigned int transformRDFNumQ(unsigned int nbins, unsigned int oversample)
+    {
+    unsigned int length = 1;
+    while (length < 2*nbins*oversample)
+        length <<= 1;
+    return length/2 + 1;
+    }
+
+void transformRDF(const float *rdf, unsigned int nbins, float rmin, float rmax, float density, bool window,
+                  unsigned int oversample, float *q, float *S)
+    {
+    if (nbins == 0)
+        throw invalid_argument("at least one bin is needed");
+    if (rmin < 0.0f || rmax <= rmin)
+        throw invalid_argument("the bins must satisfy 0 <= rmin < rmax");
+    if (oversample == 0)
+        throw invalid_argument("oversample must be positive");
+
+    const unsigned int num_q = transformRDFNumQ(nbins, oversample);
+    const unsigned int length = 2*(num_q - 1);
+    const double dr = (double(rmax) - double(rmin)) / nbins;
+
+    // the weights of DebyeStructureFactor divided by r, so that sin(q r) / (q r) is sin(q r) / q
+    std::vector< std::complex<double> > data(length, 0.0);
+    double S0 = 1.0;
+    for (unsigned int b = 0; b < nbins; b++)
+        {
+        double r_lo = rmin + b*dr;
+        double r_hi = r_lo + dr;
+        double r = r_lo + 0.5*dr;
+        double shell_volume = 4.0 * M_PI / 3.0 * (r_hi*r_hi*r_hi - r_lo*r_lo*r_lo);
+        double W = 1.0;
+        if (window)
+            {
+            double x = M_PI * r / rmax;
+            W = sin(x) / x;
+            }
+        double weight = double(density) * (double(rdf[b]) - 1.0) * shell_volume * W;
+        S0 += weight;
+        data[b] = weight / r;
+        }
+
+    // sum_b data_b e^(2 pi i k b / M), shifted by the center of the first bin, has sum_b data_b sin(q_k r_b) as its
+    // imaginary part
+    util::fft1D(&data[0], length, true);
+    for (unsigned int k = 0; k < num_q; k++)
+        {
+        double qk = 2.0 * M_PI * k / (length * dr);
+        q[k] = float(qk);
+        if (k == 0)
+            {
+            S[k] = float(S0);
+            continue;
+            }
+        double phase = qk * (rmin + 0.5*dr);
+        double sum = std::imag(std::complex<double>(cos(phase), sin(phase)) * data[k]);
+        S[k] = float(1.0 + sum / qk);
+        }
+    }
+
+}; }; // end namespace freud::kspace
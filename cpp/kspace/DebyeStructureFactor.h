@@ -0,0 +1,129 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "NeighborList.h"
+#include "RDF.h"
+
+#ifndef _DEBYE_STRUCTURE_FACTOR_H__
+#define _DEBYE_STRUCTURE_FACTOR_H__
+
+/*! \file DebyeStructureFactor.h
+    \brief Spherically averaged static structure factor from the histogram of pair distances
+*/
+
+namespace freud { namespace kspace {
+
+//! Computes the isotropic S(q) of a set of points with itself from its radial distribution function
+/*! The pairs are binned in a density::RDF up to rmax, and S is its sinc transform
+    S(q) = 1 + 4 pi rho int_0^rmax r^2 (g(r) - 1) sin(q r) / (q r) W(r) dr, summed over the bins of width dr. This
+    costs one pass over the pairs within rmax per frame and O(num_q x num_bins) per evaluation of S, instead of
+    transforms on 3D grids of q vectors that are then averaged over shells.
+
+    Cutting the integral at rmax adds ripples of period 2 pi / rmax to S. The Lorch window
+    W(r) = sin(pi r / rmax) / (pi r / rmax) damps them at the cost of a broadening of the peaks; without the window
+    W(r) = 1. rmax is bounded by half the box, as for the RDF itself.
+*/
+class DebyeStructureFactor
+    {
+    public:
+        //! Constructor
+        /*! \param rmax largest pair distance of the histogram
+            \param dr width of the bins of the histogram
+            \param q_min smallest q
+            \param q_max largest q
+            \param num_q number of q values, evenly spaced from q_min to q_max
+            \param window true to apply the Lorch window to the transform
+        */
+        DebyeStructureFactor(float rmax, float dr, float q_min, float q_max, unsigned int num_q, bool window);
+
+        //! Get the simulation box of the last frame
+        const box::Box& getBox() const
+            {
+            return m_rdf.getBox();
+            }
+
+        //! Forget all the frames that were added
+        void reset();
+
+        //! Add the pairs of a frame to the histogram
+        /*! If \a nlist is given, its bonds are binned instead of building a cell list
+        */
+        void accumulate(box::Box& box, const vec3<float> *points, unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
+
+        //! Get the number of q values
+        unsigned int getNumQ() const
+            {
+            return m_num_q;
+            }
+
+        //! Get the q values
+        std::shared_ptr<float> getQ()
+            {
+            return m_q_array;
+            }
+
+        //! Get S at each q value
+        std::shared_ptr<float> getS();
+
+        //! Get the RDF the structure factor is computed from
+        density::RDF& getRDF()
+            {
+            return m_rdf;
+            }
+
+    private:
+        //! \internal
+        //! Transform the RDF into S
+        void reduceS();
+
+        density::RDF m_rdf;                 //!< Histogram of the pair distances
+        float m_rmax;                       //!< Largest pair distance
+        unsigned int m_num_q;               //!< Number of q values
+        bool m_window;                      //!< True to apply the Lorch window
+        float m_density;                    //!< Number density of the last frame
+        bool m_reduce;                      //!< True when S needs to be computed again
+
+        std::shared_ptr<float> m_q_array;   //!< q values
+        std::shared_ptr<float> m_S_array;   //!< S at each q value
+    };
+
+//! Number of q values transformRDF() computes from nbins bins
+/*! \param nbins number of bins of the radial distribution function
+    \param oversample factor of the length of the transform over twice the number of bins
+*/
+unsigned int transformRDFNumQ(unsigned int nbins, unsigned int oversample);
+
+//! Transform a radial distribution function into the isotropic S(q) by a fast sine transform
+/*! The sum of DebyeStructureFactor over the bins of the radial distribution function, with the same shell volumes
+    and Lorch window, is the imaginary part of a discrete Fourier transform at the q values q_k = 2 pi k / (M dr),
+    0 <= k <= M / 2, M being the length of the transform, so that all of them take one FFT of O(M log M) instead of
+    O(num_q x nbins) sums. The bins are zero padded to M, the power of two at least 2 x oversample x nbins, which
+    spaces the q values finer than the 2 pi / (rmax - rmin) resolution of the data up to pi / dr.
+
+    This transforms the output of density::RDF, or any g(r) on evenly spaced bins, without another pass over the
+    particles.
+
+    \param rdf g(r) in each bin
+    \param nbins number of bins
+    \param rmin smallest distance of the bins
+    \param rmax largest distance of the bins
+    \param density number density of the points
+    \param window true to apply the Lorch window sin(pi r / rmax) / (pi r / rmax)
+    \param oversample factor of the length of the transform over twice the number of bins
+    \param q q values, transformRDFNumQ(nbins, oversample) of them
+    \param S S at each q value, transformRDFNumQ(nbins, oversample) of them
+*/
+void transformRDF(const float *rdf, unsigned int nbins, float rmin, float rmax, float density, bool window,
+                  unsigned int oversample, float *q, float *S);
+
+}; }; // end namespace freud::kspace
+
+#endif // _DEBYE_STRUCTURE_FACTOR_H__
@@ -0,0 +1,175 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "IntermediateScattering.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file IntermediateScattering.cc
+    \brief Coherent intermediate scattering function F(q, t) of a trajectory fed one frame at a time
+*/
+
+namespace freud { namespace kspace {
+
+IntermediateScattering::IntermediateScattering(const box::Box& box, float q_max, float dq, unsigned int num_lags,
+                                               unsigned int max_vectors)
+    : m_box(box), m_num_lags(num_lags), m_frame_counter(0), m_Np(0), m_reduce(true)
+    {
+    if (dq <= 0.0f)
+        throw invalid_argument("dq must be positive");
+    if (q_max < dq)
+        throw invalid_argument("q_max must be greater than dq");
+    if (num_lags == 0)
+        throw invalid_argument("num_lags must be positive");
+    if (max_vectors == 0)
+        throw invalid_argument("max_vectors must be positive");
+    m_num_shells = int(floorf(q_max / dq));
+
+    // reciprocal lattice vectors b_i, with a_i . b_j = 2 pi delta_ij
+    vec3<double> a[3];
+    for (unsigned int i = 0; i < 3; i++)
+        {
+        vec3<float> v = m_box.getLatticeVector(i);
+        a[i] = vec3<double>(v.x, v.y, v.z);
+        }
+    if (m_box.is2D())
+        a[2] = vec3<double>(0.0, 0.0, 1.0);
+    double volume = dot(a[0], cross(a[1], a[2]));
+    vec3<double> b[3];
+    for (unsigned int i = 0; i < 3; i++)
+        b[i] = cross(a[(i+1) % 3], a[(i+2) % 3]) * (2.0 * M_PI / volume);
+
+    // q . a_i = 2 pi n_i bounds the Miller indices of the vectors shorter than q_max
+    int n_max[3];
+    for (unsigned int i = 0; i < 3; i++)
+        n_max[i] = int(ceil(q_max * sqrt(dot(a[i], a[i])) / (2.0 * M_PI)));
+    if (m_box.is2D())
+        n_max[2] = 0;
+
+    std::vector< std::vector< vec3<float> > > candidates(m_num_shells);
+    for (int l = 0; l <= n_max[2]; l++)
+        {
+        for (int k = (l == 0) ? 0 : -n_max[1]; k <= n_max[1]; k++)
+            {
+            for (int h = (l == 0 && k == 0) ? 1 : -n_max[0]; h <= n_max[0]; h++)
+                {
+                vec3<double> q = b[0] * double(h) + b[1] * double(k) + b[2] * double(l);
+                double q_length = sqrt(dot(q, q));
+                unsigned int shell = (unsigned int)(q_length / dq);
+                if (q_length < q_max && shell < m_num_shells)
+                    candidates[shell].push_back(vec3<float>(q.x, q.y, q.z));
+                }
+            }
+        }
+
+    m_shell_counts = std::shared_ptr<unsigned int>(new unsigned int[m_num_shells], std::default_delete<unsigned int[]>());
+    m_q_array = std::shared_ptr<float>(new float[m_num_shells], std::default_delete<float[]>());
+    for (unsigned int shell = 0; shell < m_num_shells; shell++)
+        {
+        const std::vector< vec3<float> >& shell_vectors = candidates[shell];
+        unsigned int num_candidates = shell_vectors.size();
+        unsigned int num_kept = std::min(num_candidates, max_vectors);
+        double length_sum = 0.0;
+        for (unsigned int j = 0; j < num_kept; j++)
+            {
+            const vec3<float>& q = shell_vectors[(size_t(j) * num_candidates) / num_kept];
+            m_q_vectors.push_back(q);
+            m_q_shells.push_back(shell);
+            length_sum += sqrt(dot(q, q));
+            }
+        m_shell_counts.get()[shell] = num_kept;
+        m_q_array.get()[shell] = num_kept ? float(length_sum / num_kept) : (float(shell) + 0.5f) * dq;
+        }
+
+    m_rho.resize(2 * size_t(m_num_lags) * m_q_vectors.size(), 0.0);
+    m_sums.resize(size_t(m_num_lags) * m_num_shells, 0.0);
+    m_counts = std::shared_ptr<unsigned int>(new unsigned int[m_num_lags], std::default_delete<unsigned int[]>());
+    memset((void*)m_counts.get(), 0, sizeof(unsigned int)*m_num_lags);
+    m_F_array = std::shared_ptr<float>(new float[m_num_lags*m_num_shells], std::default_delete<float[]>());
+    memset((void*)m_F_array.get(), 0, sizeof(float)*m_num_lags*m_num_shells);
+    }
+
+void IntermediateScattering::reset()
+    {
+    std::fill(m_sums.begin(), m_sums.end(), 0.0);
+    memset((void*)m_counts.get(), 0, sizeof(unsigned int)*m_num_lags);
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void IntermediateScattering::accumulate(const vec3<float> *points, unsigned int Np)
+    {
+    if (m_frame_counter == 0)
+        m_Np = Np;
+    else if (Np != m_Np)
+        throw invalid_argument("the number of points must be the same in every frame");
+
+    // the density modes of the frame, in the slot of the ring buffer of the oldest frame
+    const unsigned int num_vectors = m_q_vectors.size();
+    const unsigned int slot = m_frame_counter % m_num_lags;
+    double *rho = &m_rho[2 * size_t(slot) * num_vectors];
+    const vec3<float> *q_vectors = m_q_vectors.size() ? &m_q_vectors[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, num_vectors),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t v = r.begin(); v != r.end(); v++)
+            {
+            const vec3<float> q = q_vectors[v];
+            double rho_re = 0.0;
+            double rho_im = 0.0;
+            for (unsigned int j = 0; j < Np; j++)
+                {
+                float phase = dot(q, points[j]);
+                rho_re += cosf(phase);
+                rho_im += sinf(phase);
+                }
+            rho[2*v] = rho_re;
+            rho[2*v + 1] = rho_im;
+            }
+        });
+
+    // correlate with the modes of the previous frames, Re(rho(q, t0 + t) conj(rho(q, t0)))
+    unsigned int lag_end = std::min(m_num_lags, m_frame_counter + 1);
+    for (unsigned int lag = 0; lag < lag_end; lag++)
+        {
+        const double *previous = &m_rho[2 * size_t((slot + m_num_lags - lag) % m_num_lags) * num_vectors];
+        double *sums = &m_sums[size_t(lag) * m_num_shells];
+        for (unsigned int v = 0; v < num_vectors; v++)
+            sums[m_q_shells[v]] += rho[2*v] * previous[2*v] + rho[2*v + 1] * previous[2*v + 1];
+        m_counts.get()[lag]++;
+        }
+    m_frame_counter++;
+    m_reduce = true;
+    }
+
+//! \internal
+//! Average the sums of the lags and vectors into F
+void IntermediateScattering::reduceF()
+    {
+    for (unsigned int lag = 0; lag < m_num_lags; lag++)
+        {
+        for (unsigned int shell = 0; shell < m_num_shells; shell++)
+            {
+            double norm = double(m_counts.get()[lag]) * double(m_shell_counts.get()[shell]) * double(m_Np);
+            m_F_array.get()[lag * m_num_shells + shell] = (norm > 0.0) ?
+                float(m_sums[size_t(lag) * m_num_shells + shell] / norm) : 0.0f;
+            }
+        }
+    }
+
+std::shared_ptr<float> IntermediateScattering::getF()
+    {
+    if (m_reduce == true)
+        {
+        reduceF();
+        }
+    m_reduce = false;
+    return m_F_array;
+    }
+
+}; }; // end namespace freud::kspace
@@ -0,0 +1,133 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+
+#ifndef _INTERMEDIATE_SCATTERING_H__
+#define _INTERMEDIATE_SCATTERING_H__
+
+/*! \file IntermediateScattering.h
+    \brief Coherent intermediate scattering function F(q, t) of a trajectory fed one frame at a time
+*/
+
+namespace freud { namespace kspace {
+
+//! Accumulates F(q, t) = < rho(q, t0 + t) rho(-q, t0) > / N, averaged over shells of q vectors and time origins
+/*! The wave vectors are the reciprocal lattice vectors of the box, the only ones compatible with its periodic
+    boundaries, with lengths in shells of width dq up to q_max. Only one of q and -q is kept, since rho(-q) is the
+    conjugate of rho(q), and at most max_vectors of them are kept in each shell, evenly picked in the order the
+    lattice is enumerated.
+
+    Each frame costs one pass computing rho(q) = sum_j exp(i q . r_j) for all the vectors, in parallel over the
+    vectors. The density modes of the last num_lags frames are kept in a ring buffer and the new frame is
+    correlated with each of them, which costs O(Nq) per lag instead of a pass over the particles.
+*/
+class IntermediateScattering
+    {
+    public:
+        //! Constructor
+        /*! \param box simulation box of the trajectory, which sets the wave vectors
+            \param q_max upper bound of the lengths of the wave vectors
+            \param dq width of the shells of wave vectors
+            \param num_lags number of lags, of 0 to num_lags - 1 frames
+            \param max_vectors largest number of wave vectors of each shell
+        */
+        IntermediateScattering(const box::Box& box, float q_max, float dq, unsigned int num_lags,
+                               unsigned int max_vectors);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Forget all the frames that were added
+        void reset();
+
+        //! Add a frame of Np points, the same number in every frame
+        void accumulate(const vec3<float> *points, unsigned int Np);
+
+        //! Get the number of shells
+        unsigned int getNumShells() const
+            {
+            return m_num_shells;
+            }
+
+        //! Get the number of lags
+        unsigned int getNumLags() const
+            {
+            return m_num_lags;
+            }
+
+        //! Get the number of frames that were added
+        unsigned int getFrameCounter() const
+            {
+            return m_frame_counter;
+            }
+
+        //! Get the number of wave vectors
+        unsigned int getNumVectors() const
+            {
+            return m_q_vectors.size();
+            }
+
+        //! Get the wave vectors
+        const std::vector< vec3<float> >& getVectors() const
+            {
+            return m_q_vectors;
+            }
+
+        //! Get the number of wave vectors of each shell
+        std::shared_ptr<unsigned int> getShellCounts()
+            {
+            return m_shell_counts;
+            }
+
+        //! Get the mean length of the wave vectors of each shell (its center when it is empty)
+        std::shared_ptr<float> getQ()
+            {
+            return m_q_array;
+            }
+
+        //! Get F(q, t), num_lags x num_shells
+        std::shared_ptr<float> getF();
+
+        //! Get the number of time origins of each lag
+        std::shared_ptr<unsigned int> getCounts()
+            {
+            return m_counts;
+            }
+
+    private:
+        //! \internal
+        //! Average the sums of the lags and vectors into F
+        void reduceF();
+
+        box::Box m_box;                     //!< Simulation box the wave vectors belong to
+        unsigned int m_num_shells;          //!< Number of shells of wave vectors
+        unsigned int m_num_lags;            //!< Number of lags
+        unsigned int m_frame_counter;       //!< Number of frames added
+        unsigned int m_Np;                  //!< Number of points of each frame
+        bool m_reduce;                      //!< True when F needs to be averaged again
+
+        std::vector< vec3<float> > m_q_vectors;     //!< Wave vectors
+        std::vector<unsigned int> m_q_shells;       //!< Shell of each wave vector
+        std::vector<double> m_rho;                  //!< Ring buffer of the real and imaginary parts of rho(q)
+        std::vector<double> m_sums;                 //!< Sum of the correlations of each lag and shell
+
+        std::shared_ptr<unsigned int> m_shell_counts;   //!< Number of wave vectors of each shell
+        std::shared_ptr<float> m_q_array;               //!< Mean length of the wave vectors of each shell
+        std::shared_ptr<float> m_F_array;               //!< F at each lag and shell
+        std::shared_ptr<unsigned int> m_counts;         //!< Number of time origins of each lag
+    };
+
+}; }; // end namespace freud::kspace
+
+#endif // _INTERMEDIATE_SCATTERING_H__
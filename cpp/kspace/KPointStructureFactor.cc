@@ -0,0 +1,125 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "KPointStructureFactor.h"
+#include "Annotation.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file KPointStructureFactor.cc
+    \brief Static structure factor at a list of K points averaged over the frames of a trajectory
+*/
+
+namespace freud { namespace kspace {
+
+KPointStructureFactor::KPointStructureFactor(const vec3<float> *K, unsigned int NK)
+    : m_K(K, K + NK), m_frame_counter(0), m_reduce(true), m_sums(NK, 0.0)
+    {
+    m_S_array = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
+    memset((void*)m_S_array.get(), 0, sizeof(float)*NK);
+    }
+
+void KPointStructureFactor::reset()
+    {
+    std::fill(m_sums.begin(), m_sums.end(), 0.0);
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void KPointStructureFactor::setNUFFTTolerance(float tolerance)
+    {
+    if (tolerance == 0.0f)
+        {
+        m_nufft.reset();
+        std::vector<float>().swap(m_cos_sum);
+        std::vector<float>().swap(m_sin_sum);
+        }
+    else if (!m_nufft || m_nufft->getTolerance() != tolerance)
+        {
+        m_nufft = std::shared_ptr<NonUniformFFT>(new NonUniformFFT(tolerance));
+        m_cos_sum.resize(m_K.size());
+        m_sin_sum.resize(m_K.size());
+        }
+    }
+
+void KPointStructureFactor::accumulate(const vec3<float> *points, unsigned int Np)
+    {
+    util::ScopedRange annotation("freud::KPointStructureFactor::accumulate");
+    const unsigned int NK = m_K.size();
+    const double norm = (Np > 0) ? 1.0 / double(Np) : 0.0;
+    double *sums = NK ? &m_sums[0] : NULL;
+
+    if (m_nufft)
+        {
+        m_nufft->compute(m_K.data(), NK, points, Np, m_cos_sum.data(), m_sin_sum.data());
+        for (unsigned int i = 0; i < NK; i++)
+            sums[i] += (double(m_cos_sum[i])*m_cos_sum[i] + double(m_sin_sum[i])*m_sin_sum[i]) * norm;
+        }
+    else
+        {
+        const vec3<float> *K = NK ? &m_K[0] : NULL;
+        // the K points are split between threads in blocks of K_BLOCK_SIZE
+        parallel_for(blocked_range<size_t>(0, NK, K_BLOCK_SIZE),
+            [=] (const blocked_range<size_t>& range)
+            {
+            double block_cos[K_BLOCK_SIZE];
+            double block_sin[K_BLOCK_SIZE];
+            for (size_t k_begin = range.begin(); k_begin < range.end(); k_begin += K_BLOCK_SIZE)
+                {
+                const size_t k_end = std::min(k_begin + K_BLOCK_SIZE, range.end());
+                std::fill(block_cos, block_cos + K_BLOCK_SIZE, 0.0);
+                std::fill(block_sin, block_sin + K_BLOCK_SIZE, 0.0);
+                for (unsigned int j_begin = 0; j_begin < Np; j_begin += PARTICLE_BLOCK_SIZE)
+                    {
+                    const unsigned int j_end = std::min(j_begin + PARTICLE_BLOCK_SIZE, Np);
+                    for (size_t i = k_begin; i < k_end; i++)
+                        {
+                        const vec3<float> Ki = K[i];
+                        float cos_partial = 0.0f;
+                        float sin_partial = 0.0f;
+                        for (unsigned int j = j_begin; j < j_end; j++)
+                            {
+                            float phase = dot(Ki, points[j]);
+                            cos_partial += cosf(phase);
+                            sin_partial += sinf(phase);
+                            }
+                        block_cos[i - k_begin] += cos_partial;
+                        block_sin[i - k_begin] += sin_partial;
+                        }
+                    }
+                for (size_t i = k_begin; i < k_end; i++)
+                    sums[i] += (block_cos[i - k_begin]*block_cos[i - k_begin] +
+                                block_sin[i - k_begin]*block_sin[i - k_begin]) * norm;
+                }
+            });
+        }
+    m_frame_counter++;
+    m_reduce = true;
+    }
+
+//! \internal
+//! Average the sums of the frames into S
+void KPointStructureFactor::reduceS()
+    {
+    const double norm = (m_frame_counter > 0) ? 1.0 / double(m_frame_counter) : 0.0;
+    float *S = m_S_array.get();
+    for (unsigned int i = 0; i < m_K.size(); i++)
+        S[i] = float(m_sums[i] * norm);
+    }
+
+std::shared_ptr<float> KPointStructureFactor::getS()
+    {
+    if (m_reduce == true)
+        {
+        reduceS();
+        }
+    m_reduce = false;
+    return m_S_array;
+    }
+
+}; }; // end namespace freud::kspace
@@ -0,0 +1,98 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "NonUniformFFT.h"
+
+#ifndef _K_POINT_STRUCTURE_FACTOR_H__
+#define _K_POINT_STRUCTURE_FACTOR_H__
+
+/*! \file KPointStructureFactor.h
+    \brief Static structure factor at a list of K points averaged over the frames of a trajectory
+*/
+
+namespace freud { namespace kspace {
+
+//! Accumulates S(K) = < |rho(K)|^2 / N > over frames at arbitrary K points, rho(K) = sum_j exp(i K . r_j)
+/*! Unlike the FTdelta family, which computes and returns new arrays of one frame per call, the sums of every K point
+    are kept in buffers allocated once, with the K points, and each frame only adds to them, so that averaging a
+    diffraction pattern over thousands of frames allocates nothing per frame. S is reduced from the sums when it is
+    read, as for the RDF.
+
+    The phases are summed in parallel over blocks of K points, each over blocks of particles that stay in cache, as
+    in FTdelta, or with a NonUniformFFT when a tolerance is set.
+*/
+class KPointStructureFactor
+    {
+    public:
+        //! Constructor
+        /*! \param K K points
+            \param NK number of K points
+        */
+        KPointStructureFactor(const vec3<float> *K, unsigned int NK);
+
+        //! Forget all the frames that were added
+        void reset();
+
+        //! Add a frame of Np points
+        void accumulate(const vec3<float> *points, unsigned int Np);
+
+        //! Set the tolerance of the non uniform FFT the phases are summed with, or 0 for the direct sum
+        void setNUFFTTolerance(float tolerance);
+
+        //! Get the tolerance of the non uniform FFT, 0 for the direct sum
+        float getNUFFTTolerance() const
+            {
+            return m_nufft ? m_nufft->getTolerance() : 0.0f;
+            }
+
+        //! Get the number of K points
+        unsigned int getNK() const
+            {
+            return m_K.size();
+            }
+
+        //! Get the K points
+        const std::vector< vec3<float> >& getK() const
+            {
+            return m_K;
+            }
+
+        //! Get the number of frames that were added
+        unsigned int getFrameCounter() const
+            {
+            return m_frame_counter;
+            }
+
+        //! Get S at each K point, averaged over the frames
+        std::shared_ptr<float> getS();
+
+    private:
+        //! Number of K points of the blocks of the parallel loop
+        static const unsigned int K_BLOCK_SIZE = 32;
+        //! Number of particles of the blocks of the parallel loop, whose positions stay in the L1 cache
+        static const unsigned int PARTICLE_BLOCK_SIZE = 2048;
+
+        //! \internal
+        //! Average the sums of the frames into S
+        void reduceS();
+
+        std::vector< vec3<float> > m_K;             //!< K points
+        unsigned int m_frame_counter;               //!< Number of frames added
+        bool m_reduce;                              //!< True when S needs to be averaged again
+        std::vector<double> m_sums;                 //!< Sum over the frames of |rho(K)|^2 / N
+        std::vector<float> m_cos_sum;               //!< Sums of cos(K . r) of the frame of the non uniform FFT
+        std::vector<float> m_sin_sum;               //!< Sums of sin(K . r) of the frame of the non uniform FFT
+        std::shared_ptr<NonUniformFFT> m_nufft;     //!< Phase sums by non uniform FFT, when it is used
+        std::shared_ptr<float> m_S_array;           //!< S at each K point
+    };
+
+}; }; // end namespace freud::kspace
+
+#endif // _K_POINT_STRUCTURE_FACTOR_H__
@@ -0,0 +1,283 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "NonUniformFFT.h"
+#include "FFT.h"
+#include "Annotation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <tbb/tbb.h>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file NonUniformFFT.cc
+    \brief Sums of the phases of a set of points at arbitrary K points by a non uniform FFT
+*/
+
+namespace freud { namespace kspace {
+
+//! Oversampling of the Fourier coefficients: the period P of the points is this many times their extent
+static const double NUFFT_OVERSAMPLING = 2.0;
+
+//! Largest number of nodes of the grid
+static const size_t NUFFT_MAX_NODES = size_t(1) << 30;
+
+NonUniformFFT::NonUniformFFT(float tolerance)
+    : m_tolerance(tolerance), m_grid_dims(0, 0, 0)
+    {
+    if (!(tolerance >= 1e-12f && tolerance <= 0.1f))
+        throw invalid_argument("The tolerance of the non uniform FFT must be between 1e-12 and 0.1");
+    }
+
+/*! The sum along the axis is e^{i K_c x_c} sum_j u_j e^{i k x_j} with x_j = r_j - r_c and k = K - K_c in [-k_max, k_max].
+    With P = 2 R a for points within [-a, a], the Poisson summation of the Gaussian exp(-k^2 / 4b) gives
+
+        e^{i k x} = dK / sqrt(4 pi b) e^{b x^2} sum_l exp(-(k - l dK)^2 / 4b) e^{i l dK x},    dK = 2 pi / P,
+
+    up to the images at x + n P, below e^{-b ((P - a)^2 - a^2)}, and the terms of the sum beyond m are below
+    e^{b a^2 - (m dK)^2 / 4b}. Both are set to a quarter of the tolerance. The coefficients
+    T_l = sum_j u_j e^{b x_j^2} e^{i l dK x_j} for |l| <= L are a type 1 transform, computed from the points spread
+    with exp(-x^2 / 4 tau) on n nodes covering [0, 2 pi) (Dutt and Rokhlin, Greengard and Lee).
+*/
+NonUniformFFT::Axis NonUniformFFT::makeAxis(double r_min, double r_max, double K_min, double K_max) const
+    {
+    Axis axis;
+    axis.r_center = 0.5*(r_min + r_max);
+    axis.K_center = 0.5*(K_min + K_max);
+    const double a = 0.5*(r_max - r_min);
+    axis.flat = !(a > 0.0);
+    if (axis.flat)
+        {
+        axis.dK = axis.b = axis.tau = 0.0;
+        axis.m = axis.L = axis.s = 0;
+        axis.n = 1;
+        return axis;
+        }
+
+    const double log_eps = -log(0.25*double(m_tolerance));
+    const double R = NUFFT_OVERSAMPLING;
+    const double beta = log_eps / (4.0*R*(R - 1.0));
+    axis.dK = M_PI / (R*a);
+    axis.b = beta / (a*a);
+    axis.m = int(ceil(2.0*R*sqrt(beta*(log_eps + beta)) / M_PI));
+    axis.L = int(ceil(0.5*(K_max - K_min) / axis.dK)) + axis.m;
+
+    const unsigned int num_coeffs = 2*axis.L + 1;
+    axis.n = 1;
+    while (axis.n < 2*num_coeffs)
+        axis.n <<= 1;
+    const double R_grid = double(axis.n) / double(num_coeffs);
+    axis.s = int(ceil(log_eps*(R_grid - 0.5) / (M_PI*(R_grid - 1.0))));
+    axis.tau = M_PI*axis.s / (double(num_coeffs)*num_coeffs*R_grid*(R_grid - 0.5));
+    return axis;
+    }
+
+void NonUniformFFT::compute(const vec3<float> *K, unsigned int NK, const vec3<float> *r, unsigned int Np,
+                            float *cos_sum, float *sin_sum)
+    {
+    util::ScopedRange annotation("freud::NonUniformFFT::compute");
+    if (NK == 0)
+        return;
+    if (Np == 0)
+        {
+        fill(cos_sum, cos_sum + NK, 0.0f);
+        fill(sin_sum, sin_sum + NK, 0.0f);
+        return;
+        }
+
+    // the bounding intervals of the points and the K points
+    vec3<float> r_min = r[0], r_max = r[0], K_min = K[0], K_max = K[0];
+    for (unsigned int j = 1; j < Np; j++)
+        {
+        r_min.x = min(r_min.x, r[j].x); r_max.x = max(r_max.x, r[j].x);
+        r_min.y = min(r_min.y, r[j].y); r_max.y = max(r_max.y, r[j].y);
+        r_min.z = min(r_min.z, r[j].z); r_max.z = max(r_max.z, r[j].z);
+        }
+    for (unsigned int i = 1; i < NK; i++)
+        {
+        K_min.x = min(K_min.x, K[i].x); K_max.x = max(K_max.x, K[i].x);
+        K_min.y = min(K_min.y, K[i].y); K_max.y = max(K_max.y, K[i].y);
+        K_min.z = min(K_min.z, K[i].z); K_max.z = max(K_max.z, K[i].z);
+        }
+    Axis axes[3] = {makeAxis(r_min.x, r_max.x, K_min.x, K_max.x),
+                    makeAxis(r_min.y, r_max.y, K_min.y, K_max.y),
+                    makeAxis(r_min.z, r_max.z, K_min.z, K_max.z)};
+    const size_t num_nodes = size_t(axes[0].n)*axes[1].n*axes[2].n;
+    if (num_nodes > NUFFT_MAX_NODES)
+        throw runtime_error("The grid of the non uniform FFT would exceed 2^30 nodes: loosen the tolerance or "
+                            "use the direct sum");
+    m_grid_dims = vec3<unsigned int>(axes[0].n, axes[1].n, axes[2].n);
+    m_grid.assign(num_nodes, std::complex<double>(0.0, 0.0));
+    std::complex<double> *grid = &m_grid[0];
+    const size_t strides[3] = {1, axes[0].n, size_t(axes[0].n)*axes[1].n};
+
+    // the spreading stencils of points in slabs of the widest axis two slabs apart do not overlap, so the slabs of
+    // each parity are spread in parallel; an odd last slab touches the first and is spread on its own
+    unsigned int c = 0;
+    for (unsigned int d = 1; d < 3; d++)
+        if (axes[d].n > axes[c].n)
+            c = d;
+    const unsigned int slab_width = 2*axes[c].s + 1;
+    const unsigned int num_slabs = (axes[c].n >= 3*slab_width) ? axes[c].n / slab_width : 1;
+    vector<unsigned int> slab_of(Np), slab_start(num_slabs + 1, 0), order(Np);
+    for (unsigned int j = 0; j < Np; j++)
+        {
+        const double coord = (c == 0) ? r[j].x : ((c == 1) ? r[j].y : r[j].z);
+        const double u = (coord - axes[c].r_center)*axes[c].dK*axes[c].n / (2.0*M_PI);
+        const int n = axes[c].n;
+        const unsigned int node = ((int(floor(u + 0.5)) % n) + n) % n;
+        slab_of[j] = min(node / slab_width, num_slabs - 1);
+        slab_start[slab_of[j] + 1]++;
+        }
+    for (unsigned int slab = 0; slab < num_slabs; slab++)
+        slab_start[slab + 1] += slab_start[slab];
+    vector<unsigned int> fill_pos(slab_start.begin(), slab_start.end() - 1);
+    for (unsigned int j = 0; j < Np; j++)
+        order[fill_pos[slab_of[j]]++] = j;
+
+    const Axis *ax = axes;
+    const vec3<double> K_center(axes[0].K_center, axes[1].K_center, axes[2].K_center);
+    auto spread_slab = [=, &order, &slab_start] (unsigned int slab)
+        {
+        vector<double> weights[3];
+        vector<size_t> offsets[3];
+        for (unsigned int d = 0; d < 3; d++)
+            {
+            weights[d].resize(2*ax[d].s + 1);
+            offsets[d].resize(2*ax[d].s + 1);
+            }
+        for (unsigned int idx = slab_start[slab]; idx < slab_start[slab + 1]; idx++)
+            {
+            const unsigned int j = order[idx];
+            const double coords[3] = {r[j].x, r[j].y, r[j].z};
+            double phase = 0.0, deconvolution = 0.0;
+            for (unsigned int d = 0; d < 3; d++)
+                {
+                const double x = coords[d] - ax[d].r_center;
+                phase += ((d == 0) ? K_center.x : ((d == 1) ? K_center.y : K_center.z))*x;
+                deconvolution += ax[d].b*x*x;
+                // the point at dK x in [0, 2 pi), in nodes of width 2 pi / n
+                const double h = 2.0*M_PI / ax[d].n;
+                const double u = ax[d].dK*x / h;
+                const int nearest = int(floor(u + 0.5));
+                const int n = ax[d].n;
+                for (int o = -ax[d].s; o <= ax[d].s; o++)
+                    {
+                    const double dist = (u - (nearest + o))*h;
+                    weights[d][o + ax[d].s] = ax[d].flat ? 1.0 : exp(-dist*dist / (4.0*ax[d].tau));
+                    offsets[d][o + ax[d].s] = size_t((((nearest + o) % n) + n) % n)*strides[d];
+                    }
+                }
+            const std::complex<double> u_j = std::polar(exp(deconvolution), phase);
+            for (unsigned int iz = 0; iz < weights[2].size(); iz++)
+                {
+                for (unsigned int iy = 0; iy < weights[1].size(); iy++)
+                    {
+                    const std::complex<double> u_yz = u_j*(weights[1][iy]*weights[2][iz]);
+                    std::complex<double> *line = grid + offsets[1][iy] + offsets[2][iz];
+                    for (unsigned int ix = 0; ix < weights[0].size(); ix++)
+                        line[offsets[0][ix]] += u_yz*weights[0][ix];
+                    }
+                }
+            }
+        };
+
+    if (num_slabs == 1)
+        spread_slab(0);
+    else
+        {
+        const unsigned int num_paired = num_slabs - (num_slabs % 2);
+        for (unsigned int parity = 0; parity < 2; parity++)
+            parallel_for(blocked_range<size_t>(0, num_paired/2, 1),
+                [=, &spread_slab] (const blocked_range<size_t>& range)
+                {
+                for (size_t pair = range.begin(); pair != range.end(); pair++)
+                    spread_slab(2*pair + parity);
+                });
+        if (num_slabs != num_paired)
+            spread_slab(num_slabs - 1);
+        }
+
+    // the transform of the grid with e^{+i l x} gives the coefficients up to the transform of the Gaussians
+    util::fft3D(grid, axes[0].n, axes[1].n, axes[2].n, true);
+
+    // T_l = sqrt(pi / tau) e^{tau l^2} / n times the transform, also times the dK / sqrt(4 pi b) of the interpolation
+    vector<double> corrections[3];
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        corrections[d].resize(2*axes[d].L + 1);
+        for (int l = -axes[d].L; l <= axes[d].L; l++)
+            corrections[d][l + axes[d].L] = axes[d].flat ? 1.0 :
+                sqrt(M_PI / axes[d].tau)*exp(axes[d].tau*l*l) / axes[d].n*axes[d].dK / sqrt(4.0*M_PI*axes[d].b);
+        }
+    const unsigned int widths[3] = {2u*axes[0].L + 1, 2u*axes[1].L + 1, 2u*axes[2].L + 1};
+    m_coeffs.resize(size_t(widths[0])*widths[1]*widths[2]);
+    std::complex<double> *coeffs = &m_coeffs[0];
+    for (int lz = -axes[2].L; lz <= axes[2].L; lz++)
+        for (int ly = -axes[1].L; ly <= axes[1].L; ly++)
+            for (int lx = -axes[0].L; lx <= axes[0].L; lx++)
+                {
+                const size_t node = ((lx + axes[0].n) % axes[0].n)*strides[0] +
+                                    ((ly + axes[1].n) % axes[1].n)*strides[1] +
+                                    ((lz + axes[2].n) % axes[2].n)*strides[2];
+                const double correction = corrections[0][lx + axes[0].L]*corrections[1][ly + axes[1].L]*
+                                          corrections[2][lz + axes[2].L];
+                coeffs[((lz + axes[2].L)*size_t(widths[1]) + (ly + axes[1].L))*widths[0] + (lx + axes[0].L)] =
+                    grid[node]*correction;
+                }
+
+    // interpolate the coefficients at each K point
+    parallel_for(blocked_range<size_t>(0, NK),
+        [=] (const blocked_range<size_t>& range)
+        {
+        vector<double> weights[3];
+        int first[3];
+        for (unsigned int d = 0; d < 3; d++)
+            weights[d].resize(2*ax[d].m + 1);
+        for (size_t i = range.begin(); i != range.end(); i++)
+            {
+            const double Ki[3] = {K[i].x, K[i].y, K[i].z};
+            double phase = 0.0;
+            for (unsigned int d = 0; d < 3; d++)
+                {
+                phase += Ki[d]*ax[d].r_center;
+                if (ax[d].flat)
+                    {
+                    weights[d][0] = 1.0;
+                    first[d] = 0;
+                    continue;
+                    }
+                const double k = Ki[d] - ax[d].K_center;
+                const int nearest = int(floor(k / ax[d].dK + 0.5));
+                first[d] = nearest - ax[d].m + ax[d].L;
+                for (int o = -ax[d].m; o <= ax[d].m; o++)
+                    {
+                    const double dist = k - (nearest + o)*ax[d].dK;
+                    weights[d][o + ax[d].m] = exp(-dist*dist / (4.0*ax[d].b));
+                    }
+                }
+            std::complex<double> sum(0.0, 0.0);
+            for (unsigned int iz = 0; iz < weights[2].size(); iz++)
+                {
+                for (unsigned int iy = 0; iy < weights[1].size(); iy++)
+                    {
+                    const std::complex<double> *line = coeffs +
+                        ((first[2] + iz)*size_t(widths[1]) + (first[1] + iy))*widths[0] + first[0];
+                    std::complex<double> line_sum(0.0, 0.0);
+                    for (unsigned int ix = 0; ix < weights[0].size(); ix++)
+                        line_sum += line[ix]*weights[0][ix];
+                    sum += line_sum*(weights[1][iy]*weights[2][iz]);
+                    }
+                }
+            sum *= std::polar(1.0, phase);
+            cos_sum[i] = float(sum.real());
+            sin_sum[i] = float(sum.imag());
+            }
+        });
+    }
+
+}; }; // end namespace freud::kspace
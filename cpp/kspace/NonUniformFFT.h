@@ -0,0 +1,83 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <complex>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#ifndef _NON_UNIFORM_FFT_H__
+#define _NON_UNIFORM_FFT_H__
+
+/*! \file NonUniformFFT.h
+    \brief Sums of the phases of a set of points at arbitrary K points by a non uniform FFT
+*/
+
+namespace freud { namespace kspace {
+
+//! Computes sum_j exp(i K . r_j) at arbitrary K points with a type 3 non uniform FFT
+/*! The direct sum costs O(NK x Np). Along each axis the points are centered on their bounding box and the K points
+    on theirs, and the sum is the interpolation, with a Gaussian of K, of its values at the multiples of
+    2 pi / P, P being twice the extent of the points. Those are the Fourier coefficients of the points spread with a
+    Gaussian on a grid oversampled twice and rounded up to powers of two, computed with util::fft3D. The cost is
+    O(Np s^3 + M log M + NK m^3), M being the number of nodes of the grid, s and m the half widths of the Gaussians in
+    nodes, all three set by the tolerance.
+
+    The tolerance bounds the error of each sum relative to the number of points, about sqrt(Np) times the typical
+    sum of uncorrelated points. The grid is kept between calls. An axis along which all the points share their
+    coordinate needs no grid, which makes 2D systems cost as little as the 2D transform.
+*/
+class NonUniformFFT
+    {
+    public:
+        //! Constructor
+        /*! \param tolerance relative error of the sums, between 1e-12 and 0.1
+        */
+        explicit NonUniformFFT(float tolerance);
+
+        //! Get the tolerance
+        float getTolerance() const
+            {
+            return m_tolerance;
+            }
+
+        //! Compute the sums of cos(K . r) and sin(K . r) over the points at each K point
+        void compute(const vec3<float> *K, unsigned int NK, const vec3<float> *r, unsigned int Np,
+                     float *cos_sum, float *sin_sum);
+
+        //! Get the number of nodes of the grid of the last compute call along each axis
+        vec3<unsigned int> getGridDims() const
+            {
+            return m_grid_dims;
+            }
+
+    private:
+        //! Parameters of the transform along one axis
+        struct Axis
+            {
+            bool flat;              //!< true when all the points share their coordinate along the axis
+            double r_center;        //!< center of the bounding interval of the points
+            double K_center;        //!< center of the bounding interval of the K points
+            double dK;              //!< spacing of the K of the Fourier coefficients, 2 pi / P
+            double b;               //!< exponent of the deconvolution Gaussian exp(b x^2) of the points
+            int m;                  //!< half width in coefficients of the interpolation Gaussian
+            int L;                  //!< largest index of the Fourier coefficients
+            unsigned int n;         //!< number of nodes of the spreading grid, a power of two
+            double tau;             //!< width of the spreading Gaussian exp(-x^2 / 4 tau) on [0, 2 pi)
+            int s;                  //!< half width in nodes of the spreading Gaussian
+            };
+
+        //! Choose the parameters of one axis from the bounding intervals of the points and the K points
+        Axis makeAxis(double r_min, double r_max, double K_min, double K_max) const;
+
+        float m_tolerance;                              //!< relative error of the sums
+        vec3<unsigned int> m_grid_dims;                 //!< number of nodes of the grid along each axis
+        std::vector< std::complex<double> > m_grid;     //!< spread points and their transform
+        std::vector< std::complex<double> > m_coeffs;   //!< Fourier coefficients at the multiples of dK
+    };
+
+}; }; // end namespace freud::kspace
+
+#endif // _NON_UNIFORM_FFT_H__
@@ -0,0 +1,219 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "StructureFactor.h"
+#include "FFT.h"
+#include "HistogramReduction.h"
+#include "Annotation.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file StructureFactor.cc
+    \brief Static structure factor of a set of points on a grid of q vectors
+*/
+
+namespace freud { namespace kspace {
+
+StructureFactor::StructureFactor(unsigned int g)
+    : m_g(g), m_bi(2*g + 1, 2*g + 1, 2*g + 1)
+    {
+    const unsigned int num_q = m_bi.getNumElements();
+    m_S_complex_array = std::shared_ptr< std::complex<float> >(new std::complex<float>[num_q],
+                                                               std::default_delete< std::complex<float>[] >());
+    memset((void*)m_S_complex_array.get(), 0, sizeof(std::complex<float>)*num_q);
+    m_S_array = std::shared_ptr<float>(new float[num_q], std::default_delete<float[]>());
+    memset((void*)m_S_array.get(), 0, sizeof(float)*num_q);
+    }
+
+//! \internal
+//! Throw when the grid of q vectors does not fit the box
+void StructureFactor::checkBox(const box::Box& box) const
+    {
+    if (box.is2D())
+        throw invalid_argument("StructureFactor does not support 2D boxes");
+    }
+
+//! \internal
+//! Normalize the sums and square them into S
+void StructureFactor::reduceS(const std::complex<double> *sums, unsigned int Np)
+    {
+    const unsigned int num_q = m_bi.getNumElements();
+    const double norm = (Np > 0) ? 1.0 / double(Np) : 0.0;
+    std::complex<float> *S_complex = m_S_complex_array.get();
+    float *S = m_S_array.get();
+    for (unsigned int i = 0; i < num_q; i++)
+        {
+        S_complex[i] = std::complex<float>(sums[i] * norm);
+        S[i] = float(std::norm(sums[i] * norm));
+        }
+    }
+
+void StructureFactor::computeDirect(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    util::ScopedRange annotation("freud::StructureFactor::computeDirect");
+    checkBox(box);
+    const int g = m_g;
+    const unsigned int width = m_bi.getW();
+    const unsigned int num_q = m_bi.getNumElements();
+    const vec3<float> L = box.getL();
+    const vec3<double> dq(2.0 * M_PI / L.x, 2.0 * M_PI / L.y, 2.0 * M_PI / L.z);
+    const Index3D bi = m_bi;
+
+    enumerable_thread_specific< std::complex<double>* > local_sums;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=, &local_sums] (const blocked_range<size_t>& r)
+        {
+        bool exists;
+        local_sums.local(exists);
+        if (! exists)
+            {
+            local_sums.local() = util::allocateLocalHistogram< std::complex<double> >(num_q);
+            }
+        std::complex<double> *sums = local_sums.local();
+
+        // the phase factors of each axis, exp(i h dq_x x) for h in [-g, g]
+        std::vector< std::complex<double> > ex(width), ey(width), ez(width);
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            const vec3<double> p(points[i].x, points[i].y, points[i].z);
+            for (int h = -g; h <= g; h++)
+                {
+                ex[h + g] = std::polar(1.0, h * dq.x * p.x);
+                ey[h + g] = std::polar(1.0, h * dq.y * p.y);
+                ez[h + g] = std::polar(1.0, h * dq.z * p.z);
+                }
+            for (unsigned int c = 0; c < width; c++)
+                {
+                for (unsigned int b = 0; b < width; b++)
+                    {
+                    const std::complex<double> eyz = ey[b] * ez[c];
+                    std::complex<double> *line = sums + bi(0, b, c);
+                    for (unsigned int a = 0; a < width; a++)
+                        line[a] += ex[a] * eyz;
+                    }
+                }
+            }
+        });
+
+    std::vector< std::complex<double> > sums(num_q);
+    util::reduceLocalHistograms(local_sums, &sums[0], num_q);
+    util::freeLocalHistograms(local_sums);
+    reduceS(&sums[0], Np);
+    }
+
+void StructureFactor::computeFFT(const box::Box& box, const vec3<float> *points, unsigned int Np, unsigned int width)
+    {
+    util::ScopedRange annotation("freud::StructureFactor::computeFFT");
+    checkBox(box);
+    if (box.getWrapContext().tilted)
+        throw invalid_argument("computeFFT needs a box without tilt");
+    if (!util::isPowerOfTwo(width))
+        throw invalid_argument("width must be a power of two");
+    if (width <= 2*m_g)
+        throw invalid_argument("width must be greater than 2g");
+
+    // deposit the points with cloud in cell weights on the nodes -L/2 + n L / width of the mesh
+    const Index3D mi(width, width, width);
+    const unsigned int num_nodes = mi.getNumElements();
+    const vec3<float> L = box.getL();
+    const vec3<float> spacing = L / float(width);
+    enumerable_thread_specific<double*> local_mesh;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=, &local_mesh] (const blocked_range<size_t>& r)
+        {
+        bool exists;
+        local_mesh.local(exists);
+        if (! exists)
+            {
+            local_mesh.local() = util::allocateLocalHistogram<double>(num_nodes);
+            }
+        double *mesh = local_mesh.local();
+        const int w = width;
+
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            float ux = (points[i].x + L.x/2.0f) / spacing.x;
+            float uy = (points[i].y + L.y/2.0f) / spacing.y;
+            float uz = (points[i].z + L.z/2.0f) / spacing.z;
+            int ix = int(floorf(ux));
+            int iy = int(floorf(uy));
+            int iz = int(floorf(uz));
+            const double wx[2] = {1.0 - (ux - ix), ux - ix};
+            const double wy[2] = {1.0 - (uy - iy), uy - iy};
+            const double wz[2] = {1.0 - (uz - iz), uz - iz};
+            for (int k = 0; k < 2; k++)
+                {
+                unsigned int nk = (((iz + k) % w) + w) % w;
+                for (int j = 0; j < 2; j++)
+                    {
+                    unsigned int nj = (((iy + j) % w) + w) % w;
+                    for (int l = 0; l < 2; l++)
+                        {
+                        unsigned int ni = (((ix + l) % w) + w) % w;
+                        mesh[mi(ni, nj, nk)] += wx[l] * wy[j] * wz[k];
+                        }
+                    }
+                }
+            }
+        });
+    std::vector<double> density(num_nodes);
+    util::reduceLocalHistograms(local_mesh, &density[0], num_nodes);
+    util::freeLocalHistograms(local_mesh);
+
+    // sum_n rho_n exp(i q . x_n) is the unscaled inverse transform of the mesh, times exp(-i q . L/2) = (-1)^(h+k+l)
+    std::vector<std::complex<double> > mesh(density.begin(), density.end());
+    util::fft3D(&mesh[0], width, width, width, true);
+
+    // the transform of the cloud in cell window along one axis, sinc^2(pi h / width)
+    const int g = m_g;
+    std::vector<double> window(2*g + 1);
+    for (int h = -g; h <= g; h++)
+        {
+        double x = M_PI * double(h) / double(width);
+        window[h + g] = (h == 0) ? 1.0 : (sin(x)/x)*(sin(x)/x);
+        }
+
+    std::vector< std::complex<double> > sums(m_bi.getNumElements());
+    for (int l = -g; l <= g; l++)
+        {
+        for (int k = -g; k <= g; k++)
+            {
+            for (int h = -g; h <= g; h++)
+                {
+                unsigned int n = mi((h + width) % width, (k + width) % width, (l + width) % width);
+                double sign = ((h + k + l) & 1) ? -1.0 : 1.0;
+                double norm = sign / (window[h + g] * window[k + g] * window[l + g]);
+                sums[m_bi(h + g, k + g, l + g)] = mesh[n] * norm;
+                }
+            }
+        }
+    reduceS(&sums[0], Np);
+    }
+
+void shellAverage(const float *S, unsigned int g, double *sums, unsigned int *counts)
+    {
+    const int n = g;
+    const unsigned int num_shells = 3*g*g + 1;
+    memset((void*)sums, 0, sizeof(double)*num_shells);
+    memset((void*)counts, 0, sizeof(unsigned int)*num_shells);
+    const Index3D bi(2*g + 1, 2*g + 1, 2*g + 1);
+    for (int l = -n; l <= n; l++)
+        {
+        for (int k = -n; k <= n; k++)
+            {
+            for (int h = -n; h <= n; h++)
+                {
+                unsigned int qsq = h*h + k*k + l*l;
+                sums[qsq] += S[bi(h + n, k + n, l + n)];
+                counts[qsq]++;
+                }
+            }
+        }
+    }
+
+}; }; // end namespace freud::kspace
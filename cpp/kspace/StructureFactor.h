@@ -0,0 +1,100 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <complex>
+#include <memory>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "Index1D.h"
+
+#ifndef _STRUCTURE_FACTOR_H__
+#define _STRUCTURE_FACTOR_H__
+
+/*! \file StructureFactor.h
+    \brief Static structure factor of a set of points on a grid of q vectors
+*/
+
+namespace freud { namespace kspace {
+
+//! Computes the static structure factor S(q) = |sum_j exp(i q . r_j)|^2 / N^2 on a grid of q vectors
+/*! The grid holds q = (h 2 pi / Lx, k 2 pi / Ly, l 2 pi / Lz) for the integers h, k, l in [-g, g], indexed like
+    Index3D with a = h + g, b = k + g and c = l + g, the layout of the arrays of SFactor3DPoints.
+
+    computeDirect() evaluates the sums exactly. The phase factors of a point factorize over the three axes, so each
+    point costs 3 (2g + 1) sines and cosines and (2g + 1)^3 complex products, in parallel over the points.
+
+    computeFFT() deposits the points on a periodic mesh of width^3 nodes with cloud in cell weights and transforms it,
+    which costs O(N + width^3 log width) instead of O(N g^3). The sums are recovered by dividing out the transform of
+    the cloud in cell window; the high wave vectors folded onto the grid by the mesh remain, and shrink as the width
+    grows with respect to 2g.
+*/
+class StructureFactor
+    {
+    public:
+        //! Constructor
+        /*! \param g largest index of the q vectors along each axis
+        */
+        StructureFactor(unsigned int g);
+
+        //! Get the largest index of the q vectors along each axis
+        unsigned int getG() const
+            {
+            return m_g;
+            }
+
+        //! Get the number of q vectors along each axis, 2g + 1
+        unsigned int getGridWidth() const
+            {
+            return m_bi.getW();
+            }
+
+        //! Compute the sums exactly
+        void computeDirect(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Compute the sums from the transform of the points deposited on a mesh of width^3 nodes
+        /*! \param width number of nodes of the mesh along each axis, a power of two greater than 2g
+        */
+        void computeFFT(const box::Box& box, const vec3<float> *points, unsigned int Np, unsigned int width);
+
+        //! Get the sums divided by N at each q vector
+        std::shared_ptr< std::complex<float> > getSComplex()
+            {
+            return m_S_complex_array;
+            }
+
+        //! Get S at each q vector
+        std::shared_ptr<float> getS()
+            {
+            return m_S_array;
+            }
+
+    private:
+        //! \internal
+        //! Throw when the grid of q vectors does not fit the box
+        void checkBox(const box::Box& box) const;
+
+        //! \internal
+        //! Normalize the sums and square them into S
+        void reduceS(const std::complex<double> *sums, unsigned int Np);
+
+        unsigned int m_g;                                           //!< Largest index of the q vectors
+        Index3D m_bi;                                               //!< Indexer of the grid of q vectors
+        std::shared_ptr< std::complex<float> > m_S_complex_array;   //!< Sums divided by N
+        std::shared_ptr<float> m_S_array;                           //!< S at each q vector
+    };
+
+//! Average a structure factor over the shells of equal h^2 + k^2 + l^2
+/*! \param S structure factor on a (2g + 1)^3 grid laid out like the one of StructureFactor
+    \param g largest index of the grid along each axis
+    \param sums sum of S over each shell, indexed by h^2 + k^2 + l^2, 3g^2 + 1 values
+    \param counts number of grid points of each shell, 3g^2 + 1 values
+*/
+void shellAverage(const float *S, unsigned int g, double *sums, unsigned int *counts);
+
+}; }; // end namespace freud::kspace
+
+#endif // _STRUCTURE_FACTOR_H__
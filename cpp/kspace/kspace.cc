@@ -3,13 +3,20 @@
 
 #include "kspace.h"
 #include "ScopedGILRelease.h"
+#include "ComputeArena.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
 #include <stdexcept>
 #include <cmath>
 #include <complex>
 
+#include <tbb/tbb.h>
 
 using namespace std;
+using namespace tbb;
 
 namespace freud { namespace kspace {
 
@@ -17,7 +24,10 @@ FTdelta::FTdelta()
     : m_NK(0),
       m_Np(0),
       m_density_Im(0),
-      m_density_Re(1)
+      m_density_Re(1),
+      m_gpu_K_current(false),
+      m_K_generation(0),
+      m_phases_summed(false)
     {
     }
 
@@ -27,39 +37,155 @@ FTdelta::~FTdelta()
     // m_K, m_r, and m_q should point to arrays managed by the calling code.
     }
 
-void FTdelta::compute()
+//! \internal
+//! Compute the sine and cosine of x in a single call where the C library provides it
+static inline void sinCos(float x, float *s, float *c)
+    {
+#if defined(__GLIBC__)
+    sincosf(x, s, c);
+#else
+    *s = sinf(x);
+    *c = cosf(x);
+#endif
+    }
+
+void FTdelta::setUseGPU(bool use_gpu)
+    {
+    if (!use_gpu)
+        {
+        m_gpu.reset();
+        m_phases_summed = false;
+        }
+    else if (!m_gpu)
+        {
+        m_gpu = std::shared_ptr<gpu::DensityGPU>(new gpu::DensityGPU());
+        m_gpu_K_current = false;
+        }
+    }
+
+void FTdelta::setNUFFTTolerance(float tolerance)
+    {
+    if (tolerance == 0.0f)
+        m_nufft.reset();
+    else if (!m_nufft || m_nufft->getTolerance() != tolerance)
+        m_nufft = std::shared_ptr<NonUniformFFT>(new NonUniformFFT(tolerance));
+    }
+
+void FTdelta::preparePhases()
+    {
+    m_phases_summed = false;
+    if (m_nufft)
+        {
+        m_phase_cos_sum.resize(m_NK);
+        m_phase_sin_sum.resize(m_NK);
+        m_nufft->compute(m_K.data(), m_NK, m_r.data(), m_Np, m_phase_cos_sum.data(), m_phase_sin_sum.data());
+        m_phases_summed = true;
+        return;
+        }
+    if (!m_gpu)
+        return;
+    if (!m_gpu_K_current)
+        {
+        m_gpu->setK(m_K.data(), m_NK);
+        m_gpu_K_current = true;
+        }
+    m_phase_cos_sum.resize(m_NK);
+    m_phase_sin_sum.resize(m_NK);
+    m_gpu->sumPhases(m_r.data(), m_Np, m_phase_cos_sum.data(), m_phase_sin_sum.data());
+    m_phases_summed = true;
+    }
+
+void FTdelta::sumPhases(size_t k_begin, size_t k_end, float *cos_sum, float *sin_sum) const
+    {
+    if (m_phases_summed)
+        {
+        std::copy(m_phase_cos_sum.begin() + k_begin, m_phase_cos_sum.begin() + k_end, cos_sum);
+        std::copy(m_phase_sin_sum.begin() + k_begin, m_phase_sin_sum.begin() + k_end, sin_sum);
+        return;
+        }
+    const unsigned int Np = m_Np;
+    const vec3<float> *K = &m_K.front();
+    const vec3<float> *r = Np ? &m_r.front() : NULL;
+    double block_cos[K_BLOCK_SIZE];
+    double block_sin[K_BLOCK_SIZE];
+    std::fill(block_cos, block_cos + K_BLOCK_SIZE, 0.0);
+    std::fill(block_sin, block_sin + K_BLOCK_SIZE, 0.0);
+    for (unsigned int j_begin = 0; j_begin < Np; j_begin += PARTICLE_BLOCK_SIZE)
+        {
+        const unsigned int j_end = std::min(j_begin + PARTICLE_BLOCK_SIZE, Np);
+        for (size_t i = k_begin; i < k_end; i++)
+            {
+            const vec3<float> Ki = K[i];
+            float cos_partial = 0.0f;
+            float sin_partial = 0.0f;
+            for (unsigned int j = j_begin; j < j_end; j++)
+                {
+                float CosKr, SinKr;
+                sinCos(dot(Ki, r[j]), &SinKr, &CosKr);
+                cos_partial += CosKr;
+                sin_partial += SinKr;
+                }
+            block_cos[i - k_begin] += cos_partial;
+            block_sin[i - k_begin] += sin_partial;
+            }
+        }
+    for (size_t i = k_begin; i < k_end; i++)
+        {
+        cos_sum[i - k_begin] = float(block_cos[i - k_begin]);
+        sin_sum[i - k_begin] = float(block_sin[i - k_begin]);
+        }
+    }
+
+void FTdelta::addBlock(size_t k_begin, size_t k_end, float weight, double *S_Re, double *S_Im) const
     {
     /* S += e**(-i * dot(K, r))
        -> S_Re += cos(dot(K, r))
        -> S_Im += - sin(dot(K, r))
     */
-    unsigned int NK = m_NK;
-    unsigned int Np = m_Np;
-    // float3* K = m_K;
-    // float3* r = m_r;
-    vec3<float>* K = &m_K.front();
-    vec3<float>* r = &m_r.front();
-    // float4* q = m_q;
     float density_Im = m_density_Im;
     float density_Re = m_density_Re;
-    m_S_Re = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    m_S_Im = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    memset((void*)m_S_Re.get(), 0, sizeof(float) * NK);
-    memset((void*)m_S_Im.get(), 0, sizeof(float) * NK);
-    for(unsigned int i=0; i < NK; i++)
+    // the scattering density is the same for all particles: S = rho * sum(exp(-i K r))
+    float cos_sum[K_BLOCK_SIZE];
+    float sin_sum[K_BLOCK_SIZE];
+    sumPhases(k_begin, k_end, cos_sum, sin_sum);
+    for (size_t i = 0; i < k_end - k_begin; i++)
+        {
+        float CosKr = cos_sum[i];
+        float negSinKr = sin_sum[i];
+        S_Re[i] += weight * (CosKr * density_Re + negSinKr * density_Im);
+        S_Im[i] += weight * (CosKr * density_Im - negSinKr * density_Re);
+        }
+    }
+
+void FTdelta::compute()
+    {
+    unsigned int NK = m_NK;
+    // the sums of the previous computation are overwritten
+    util::reuseArray(m_S_Re, NK);
+    util::reuseArray(m_S_Im, NK);
+    float *S_Re_array = m_S_Re.get();
+    float *S_Im_array = m_S_Im.get();
+    prepare();
+    preparePhases();
+    // the K points are split between threads in blocks of K_BLOCK_SIZE
+    parallel_for(blocked_range<size_t>(0, NK, K_BLOCK_SIZE),
+        [=] (const blocked_range<size_t>& range)
         {
-        for(unsigned int j=0; j < Np; j++)
+        double S_Re[K_BLOCK_SIZE];
+        double S_Im[K_BLOCK_SIZE];
+        for (size_t k_begin = range.begin(); k_begin < range.end(); k_begin += K_BLOCK_SIZE)
             {
-            float d = dot(K[i], r[j]); // dot product of K and r
-            // d = K[i].x * r[j].x + K[i].y * r[j].y + K[i].z * r[j].z;
-            float CosKr, negSinKr; // real and (negative) imaginary components of exp(-i K r)
-            CosKr = cos(d);
-            negSinKr = sin(d);
-            // S += rho * exp(-i K r)
-            m_S_Re.get()[i] += CosKr * density_Re + negSinKr * density_Im;
-            m_S_Im.get()[i] += CosKr * density_Im - negSinKr * density_Re;
+            const size_t k_end = std::min(k_begin + K_BLOCK_SIZE, range.end());
+            std::fill(S_Re, S_Re + K_BLOCK_SIZE, 0.0);
+            std::fill(S_Im, S_Im + K_BLOCK_SIZE, 0.0);
+            addBlock(k_begin, k_end, 1.0f, S_Re, S_Im);
+            for (size_t i = k_begin; i < k_end; i++)
+                {
+                S_Re_array[i] = float(S_Re[i - k_begin]);
+                S_Im_array[i] = float(S_Im[i - k_begin]);
+                }
             }
-        }
+        });
     }
 
 void FTdelta::computePy()
@@ -70,209 +196,330 @@ void FTdelta::computePy()
     }
 
 FTsphere::FTsphere()
-    : m_radius(0.5f), m_volume(4.0f * M_PI * 0.125f / 3.0f)
+    : m_radius(0.5f), m_volume(4.0f * M_PI * 0.125f / 3.0f), m_form_factor_current(false), m_form_factor_K(0)
     {
     }
 
+void FTsphere::prepare()
+    {
+    if (m_form_factor_current && m_form_factor_K == m_K_generation)
+        return;
+    m_form_factor.resize(m_NK);
+    const vec3<float> *K = m_NK ? &m_K.front() : NULL;
+    float *form_factor = m_NK ? &m_form_factor.front() : NULL;
+    const float radius = m_radius;
+    const float volume = m_volume;
+    parallel_for(blocked_range<size_t>(0, m_NK),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            // FT evaluated at K=0 is just the scattering volume
+            // f(0) = volume
+            // f(K) = (4.*pi*R) / K**2 * (sinc(K*R) - cos(K*R)))
+            float K2 = dot(K[i], K[i]);
+            if (K2 == 0.0f)
+                form_factor[i] = volume;
+            else
+                {
+                float KR = sqrtf(K2) * radius;
+                form_factor[i] = 4.0f * M_PI * radius / K2 * (sinf(KR)/KR - cosf(KR));
+                }
+            }
+        });
+    m_form_factor_current = true;
+    m_form_factor_K = m_K_generation;
+    }
+
 // Calculate complex FT value of a list of uniform spheres
 // Complex scattering amplitude S(K) = F(K) * f(K) for the structure factor F(K) and form factor f(K).
-void FTsphere::compute()
+void FTsphere::addBlock(size_t k_begin, size_t k_end, float weight, double *S_Re, double *S_Im) const
     {
-    unsigned int NK = m_NK;
-    unsigned int Np = m_Np;
-    // float3* K = m_K;
-    // float3* r = m_r;
-    vec3<float>* K = &m_K.front();
-    vec3<float>* r = &m_r.front();
-    // float4* q = m_q;
-    float radius = m_radius;
+    const float *form_factor = &m_form_factor.front();
 
     /* S += e**(-i * dot(K, r))
        -> S_Re += cos(dot(K, r))
        -> S_Im += - sin(dot(K, r))
     */
-    m_S_Re = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    m_S_Im = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    memset((void*)m_S_Re.get(), 0, sizeof(float) * NK);
-    memset((void*)m_S_Im.get(), 0, sizeof(float) * NK);
-    for(unsigned int i=0; i < NK; i++)
+    // the form factor only depends on K: S = rho * f(K) * sum(exp(-i K r))
+    float cos_sum[K_BLOCK_SIZE];
+    float sin_sum[K_BLOCK_SIZE];
+    sumPhases(k_begin, k_end, cos_sum, sin_sum);
+    for (size_t i = k_begin; i < k_end; i++)
         {
-        for(unsigned int j=0; j < Np; j++)
-            {
-            // Get form factor
-            // Initialize with scattering density
-            float f_Im(m_density_Im);
-            float f_Re(m_density_Re);
+        // scattering density times the form factor of prepare()
+        float f_Im = m_density_Im * form_factor[i];
+        float f_Re = m_density_Re * form_factor[i];
+
+        // S += rho * f * exp(-i K r)
+        float CosKr = cos_sum[i - k_begin];
+        float negSinKr = sin_sum[i - k_begin];
+        S_Re[i - k_begin] += weight * (CosKr * f_Re + negSinKr * f_Im);
+        S_Im[i - k_begin] += weight * (CosKr * f_Im - negSinKr * f_Re);
+        }
+    }
 
-            // float K2 = K[i].x * K[i].x + K[i].y * K[i].y + K[i].z * K[i].z;
-            float K2 = dot(K[i], K[i]);
-            // FT evaluated at K=0 is just the scattering volume
-            // f(0) = volume
-            // f(K) = (4.*pi*R) / K**2 * (sinc(K*R) - cos(K*R)))
-            if (K2 == 0.0f)
+FTpolyhedron::FTpolyhedron()
+    : m_orientation_tolerance(0.0f), m_num_orientations(0), m_form_factor_K(0)
+    {}
+
+void FTpolyhedron::formFactor(const vec3<float>& K, float& f_Re, float& f_Im) const
+    {
+    unsigned int N_facet = m_params.facet.size();
+
+    // Initialize with scattering density
+    f_Im = 0.0f;
+    f_Re = 0.0f;
+
+    float K2 = dot(K,K);
+    // FT evaluated at K=0 is just the scattering volume
+    // f(0) = volume
+    if (K2 == 0.0f)
+        {
+        f_Re = m_params.volume;
+        f_Im = 0;
+        }
+    else
+        {
+        // Use some calculus rules to rearrange into a loop over facets.
+
+        for(unsigned int facet_idx=0; facet_idx < N_facet; facet_idx++)
+            {
+            // Project K into plane of face
+            vec3<float> norm(m_params.norm[facet_idx]);
+            float dotKnorm(dot(K,norm));
+            vec3<float> K_proj = K - norm * dotKnorm;
+            float K_proj2 = dot(K_proj, K_proj);
+
+            // get polygon FT (may be accelerated in the future by converting to 2D)
+            float f2D_Im(0.0f);
+            float f2D_Re(0.0f);
+            // FT evaluated at K_proj==0 is the scattering volume (area)
+            if (K_proj2 == 0.0f)
                 {
-                f_Im *= m_volume;
-                f_Re *= m_volume;
+                f2D_Re = m_params.area[facet_idx];
+                f2D_Im = 0;
                 }
             else
                 {
-                float KR = sqrtf(K2) * radius;
-                float f = 4.0f * M_PI * radius / K2 * (sinf(KR)/KR - cosf(KR));
-                f_Im *= f;
-                f_Re *= f;
+                // f2D = -i/k^2 * \sum_0^{Nfacets - 1) \hat(z) \cdot (l_n \times k) \exp(-ik \cdot c_n) \sinc (k \cdot l/2)
+                // Noting that -i \exp(-i x) == \sin(x) - i \cos(x), we can get the real and imarginary parts as
+                // For each element in the sum,
+                // f_n = \hat(z) \cdot (l_n \times k) \sinc (k \cdot l/2) / k^2
+                // f_Re = \sin(k \cdot c_n) * f_n
+                // f_Im = - \cos(k \cdot c_n) * f_n
+                unsigned int N_vert = m_params.facet[facet_idx].size();
+                float f_n(0.0f);
+                float K2inv = 1.0f/K_proj2;
+                for(unsigned int edge_idx=0; edge_idx < N_vert; edge_idx++)
+                    {
+                    vec3<float> r0 = m_params.vert[m_params.facet[facet_idx][edge_idx]];
+                    unsigned int next_idx = edge_idx + 1;
+                    if (next_idx == N_vert) next_idx = 0;
+                    vec3<float> r1 = m_params.vert[m_params.facet[facet_idx][next_idx]];
+                    vec3<float> l_n = r1 - r0;
+                    vec3<float> c_n = (r1 + r0)*0.5f;
+                    float dotKc = dot(K_proj, c_n);
+                    float dotKl = dot(K_proj, l_n);
+                    vec3<float> crosslK = cross(l_n, K_proj);
+
+                    float x = dotKl*0.5f; // argument to sinc function
+//                            float x = dotKl; // argument to sinc function
+                    float sinc = 1.0;
+                    const float eps = 0.000001;
+                    if (fabs(x) > eps) sinc = sinf(x)/x;
+                    f_n = dot(norm, crosslK) * sinc * K2inv;
+                    f2D_Re -= sinf(dotKc) * f_n;
+                    f2D_Im -= cosf(dotKc) * f_n;
+                    } // end foreach edge
                 }
 
-            // Get structure factor
-            float CosKr, negSinKr; // real and (negative) imaginary components of exp(-i K r)
-            float d = dot(K[i], r[j]); // dot product of K and r
-            // d = K[i].x * r[j].x + K[i].y * r[j].y + K[i].z * r[j].z;
-            CosKr = cos(d);
-            negSinKr = sin(d);
+            float d = m_params.d[facet_idx];
 
-            // S += rho * f * exp(-i K r)
-            m_S_Re.get()[i] += CosKr * f_Re + negSinKr * f_Im;
-            m_S_Im.get()[i] += CosKr * f_Im - negSinKr * f_Re;
+            // accumulate
+            float re_exp = cosf(dotKnorm*d);
+            float im_exp = -sinf(dotKnorm*d);
+            f_Im += dotKnorm*(f2D_Re*re_exp-f2D_Im*im_exp);
+            f_Re -= dotKnorm*(f2D_Im*re_exp+f2D_Re*im_exp);
+            } // end for each facet
+
+        f_Re /= K2;
+        f_Im /= K2;
+        } // end if K != 0
+    }
+
+//! \internal
+//! Key of the orientation group of q, the rotation of q and -q being the same
+static std::array<int, 4> orientationKey(const quat<float>& q, float tolerance)
+    {
+    float sign = 1.0f;
+    float components[4] = {q.s, q.v.x, q.v.y, q.v.z};
+    for (unsigned int c = 0; c < 4; c++)
+        {
+        if (components[c] != 0.0f)
+            {
+            sign = (components[c] < 0.0f) ? -1.0f : 1.0f;
+            break;
             }
         }
+    std::array<int, 4> key;
+    for (unsigned int c = 0; c < 4; c++)
+        {
+        float x = sign * components[c] + 0.0f;
+        if (tolerance > 0.0f)
+            key[c] = int(floorf(x / tolerance + 0.5f));
+        else
+            memcpy(&key[c], &x, sizeof(float));
+        }
+    return key;
     }
 
-FTpolyhedron::FTpolyhedron()
-    {}
-
-void FTpolyhedron::compute()
+void FTpolyhedron::prepare()
     {
-    unsigned int NK = m_NK;
     unsigned int Np = m_Np;
-    float rho_Im(m_density_Im);
-    float rho_Re(m_density_Re);
 
-    //float3* K_array = m_K;
-    //float3* r = m_r;
-    //float4* q = m_q;
+    // group the particles by orientation, storing the positions of each group contiguously
+    std::map<std::array<int, 4>, unsigned int> groups;
+    std::vector<unsigned int> group_of(Np);
+    m_group_q.clear();
+    m_group_start.clear();
+    m_group_key.clear();
+    for(unsigned int p_idx=0; p_idx < Np; p_idx++)
+        {
+        std::array<int, 4> key = orientationKey(m_q[p_idx], m_orientation_tolerance);
+        std::map<std::array<int, 4>, unsigned int>::iterator group = groups.find(key);
+        if (group == groups.end())
+            {
+            group = groups.insert(std::make_pair(key, (unsigned int) m_group_q.size())).first;
+            m_group_q.push_back(m_q[p_idx]);
+            m_group_start.push_back(0);
+            m_group_key.push_back(key);
+            }
+        group_of[p_idx] = group->second;
+        m_group_start[group->second]++;
+        }
+    m_num_orientations = m_group_q.size();
+    unsigned int count = 0;
+    for (unsigned int g = 0; g < m_num_orientations; g++)
+        {
+        unsigned int group_size = m_group_start[g];
+        m_group_start[g] = count;
+        count += group_size;
+        }
+    m_group_start.push_back(count);
+    m_group_r.resize(Np);
+    std::vector<unsigned int> fill(m_group_start.begin(), m_group_start.end() - 1);
+    for(unsigned int p_idx=0; p_idx < Np; p_idx++)
+        m_group_r[fill[group_of[p_idx]]++] = m_r[p_idx];
+
+    // keep the form factors of the orientations of the frame, computing those of the new ones
+    if (m_form_factor_K != m_K_generation)
+        {
+        m_form_factors.clear();
+        m_form_factor_K = m_K_generation;
+        }
+    m_group_form_factor.assign(m_num_orientations, NULL);
+    if (size_t(m_num_orientations)*m_NK > FORM_FACTOR_CACHE_SIZE)
+        {
+        m_form_factors.clear();
+        return;
+        }
+    if ((m_form_factors.size() + m_num_orientations)*size_t(m_NK) > FORM_FACTOR_CACHE_SIZE)
+        {
+        // drop the orientations that are not in the frame
+        std::map<std::array<int, 4>, std::vector< std::complex<float> > > kept;
+        for (unsigned int g = 0; g < m_num_orientations; g++)
+            {
+            std::map<std::array<int, 4>, std::vector< std::complex<float> > >::iterator cached =
+                m_form_factors.find(m_group_key[g]);
+            if (cached != m_form_factors.end())
+                kept[cached->first].swap(cached->second);
+            }
+        m_form_factors.swap(kept);
+        }
+    if (m_NK == 0)
+        return;
+    std::vector< std::complex<float>* > targets;
+    std::vector< quat<float> > rotations;
+    for (unsigned int g = 0; g < m_num_orientations; g++)
+        {
+        std::vector< std::complex<float> >& form_factors = m_form_factors[m_group_key[g]];
+        if (form_factors.size() != m_NK)
+            {
+            form_factors.resize(m_NK);
+            targets.push_back(&form_factors.front());
+            rotations.push_back(conj(m_group_q[g]));
+            }
+        m_group_form_factor[g] = &form_factors.front();
+        }
+    const vec3<float> *K = &m_K.front();
+    parallel_for(blocked_range<size_t>(0, m_NK),
+        [=, &targets, &rotations] (const blocked_range<size_t>& r)
+        {
+        for (size_t K_idx = r.begin(); K_idx != r.end(); K_idx++)
+            for (unsigned int idx = 0; idx < targets.size(); idx++)
+                {
+                float f_Re, f_Im;
+                formFactor(rotate(rotations[idx], K[K_idx]), f_Re, f_Im);
+                targets[idx][K_idx] = std::complex<float>(f_Re, f_Im);
+                }
+        });
+    }
 
-    unsigned int N_facet = m_params.facet.size();
+void FTpolyhedron::addBlock(size_t k_begin, size_t k_end, float weight, double *S_Re_array, double *S_Im_array) const
+    {
+    float rho_Im(m_density_Im);
+    float rho_Re(m_density_Re);
 
     /* S += e**(-i * dot(K, r))
        -> S_Re += cos(dot(K, r))
        -> S_Im += - sin(dot(K, r))
     */
-    m_S_Re = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    m_S_Im = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    memset((void*)m_S_Re.get(), 0, sizeof(float) * NK);
-    memset((void*)m_S_Im.get(), 0, sizeof(float) * NK);
-    // For each K point
-    for(unsigned int K_idx=0; K_idx < NK; K_idx++)
+    const vec3<float> *K_array = &m_K.front();
+    const vec3<float> *r = m_group_r.size() ? &m_group_r.front() : NULL;
+    const quat<float> *q = m_num_orientations ? &m_group_q.front() : NULL;
+    const unsigned int *start = &m_group_start.front();
+    const std::complex<float> * const *cached = m_num_orientations ? &m_group_form_factor.front() : NULL;
+    const unsigned int num_orientations = m_num_orientations;
+    for (size_t K_idx = k_begin; K_idx != k_end; K_idx++)
         {
-        float S_Re(0.0f);
-        float S_Im(0.0f);
-        // For each particle
-        for(unsigned int p_idx=0; p_idx < Np; p_idx++)
+        vec3<float> K(K_array[K_idx]);
+        double S_Re(0.0);
+        double S_Im(0.0);
+        // For each orientation
+        for (unsigned int g = 0; g < num_orientations; g++)
             {
-            vec3<float> r(m_r[p_idx]);
             /* The FT of an object with orientation q at a given k-space point is the same as the FT
                of the unrotated object at a k-space point rotated the opposite way.
                The opposite of the rotation represented by a quaternion is the conjugate of the quaternion,
                found by inverting the sign of the imaginary components.
             */
-            quat<float> q(m_q[p_idx]);
-            vec3<float> K(m_K[K_idx]);
-            K = rotate(conj(q), K);
-
-            // Get form factor
-            // Initialize with scattering density
-            float f_Im(0.0f);
-            float f_Re(0.0f);
-
-            float K2 = dot(K,K);
-            // FT evaluated at K=0 is just the scattering volume
-            // f(0) = volume
-            if (K2 == 0.0f)
+            float f_Re, f_Im;
+            if (cached[g] != NULL)
                 {
-                f_Re = m_params.volume;
-                f_Im = 0;
+                f_Re = cached[g][K_idx].real();
+                f_Im = cached[g][K_idx].imag();
                 }
             else
-                {
-                // Use some calculus rules to rearrange into a loop over facets.
+                formFactor(rotate(conj(q[g]), K), f_Re, f_Im);
 
-                for(unsigned int facet_idx=0; facet_idx < N_facet; facet_idx++)
-                    {
-                    // Project K into plane of face
-                    vec3<float> norm(m_params.norm[facet_idx]);
-                    float dotKnorm(dot(K,norm));
-                    vec3<float> K_proj = K - norm * dotKnorm;
-                    float K_proj2 = dot(K_proj, K_proj);
-
-                    // get polygon FT (may be accelerated in the future by converting to 2D)
-                    float f2D_Im(0.0f);
-                    float f2D_Re(0.0f);
-                    // FT evaluated at K_proj==0 is the scattering volume (area)
-                    if (K_proj2 == 0.0f)
-                        {
-                        f2D_Re = m_params.area[facet_idx];
-                        f2D_Im = 0;
-                        }
-                    else
-                        {
-                        // f2D = -i/k^2 * \sum_0^{Nfacets - 1) \hat(z) \cdot (l_n \times k) \exp(-ik \cdot c_n) \sinc (k \cdot l/2)
-                        // Noting that -i \exp(-i x) == \sin(x) - i \cos(x), we can get the real and imarginary parts as
-                        // For each element in the sum,
-                        // f_n = \hat(z) \cdot (l_n \times k) \sinc (k \cdot l/2) / k^2
-                        // f_Re = \sin(k \cdot c_n) * f_n
-                        // f_Im = - \cos(k \cdot c_n) * f_n
-                        unsigned int N_vert = m_params.facet[facet_idx].size();
-                        float f_n(0.0f);
-                        float K2inv = 1.0f/K_proj2;
-                        for(unsigned int edge_idx=0; edge_idx < N_vert; edge_idx++)
-                            {
-                            vec3<float> r0 = m_params.vert[m_params.facet[facet_idx][edge_idx]];
-                            unsigned int next_idx = edge_idx + 1;
-                            if (next_idx == N_vert) next_idx = 0;
-                            vec3<float> r1 = m_params.vert[m_params.facet[facet_idx][next_idx]];
-                            vec3<float> l_n = r1 - r0;
-                            vec3<float> c_n = (r1 + r0)*0.5f;
-                            float dotKc = dot(K_proj, c_n);
-                            float dotKl = dot(K_proj, l_n);
-                            vec3<float> crosslK = cross(l_n, K_proj);
-
-                            float x = dotKl*0.5f; // argument to sinc function
-//                            float x = dotKl; // argument to sinc function
-                            float sinc = 1.0;
-                            const float eps = 0.000001;
-                            if (fabs(x) > eps) sinc = sinf(x)/x;
-                            f_n = dot(norm, crosslK) * sinc * K2inv;
-                            f2D_Re -= sinf(dotKc) * f_n;
-                            f2D_Im -= cosf(dotKc) * f_n;
-                            } // end foreach edge
-                        }
-
-                    float d = m_params.d[facet_idx];
-
-                    // accumulate
-                    float re_exp = cosf(dotKnorm*d);
-                    float im_exp = -sinf(dotKnorm*d);
-                    f_Im += dotKnorm*(f2D_Re*re_exp-f2D_Im*im_exp);
-                    f_Re -= dotKnorm*(f2D_Im*re_exp+f2D_Re*im_exp);
-                    } // end for each facet
-
-                f_Re /= K2;
-                f_Im /= K2;
-                } // end if K != 0
-
-            // Get structure factor
-            float CosKr, negSinKr; // real and (negative) imaginary components of exp(-i K r)
-            float d = dot(K, rotate(conj(q),r)); // dot product of K and r (rotated back)
-            // d = K.x * r.x + K.y * r.y + K.z * r.z;
-            CosKr = cosf(d);
-            negSinKr = sinf(d);
+            // Get structure factor of the particles of the orientation
+            float CosKr(0.0f), negSinKr(0.0f); // real and (negative) imaginary components of exp(-i K r)
+            for (unsigned int p_idx = start[g]; p_idx < start[g+1]; p_idx++)
+                {
+                float c, s;
+                sinCos(dot(K, r[p_idx]), &s, &c);
+                CosKr += c;
+                negSinKr += s;
+                }
 
             // S += rho * f * exp(-i K r)
             S_Re += CosKr * f_Re + negSinKr * f_Im;
             S_Im += CosKr * f_Im - negSinKr * f_Re;
-            } // end for each ptl
+            } // end for each orientation
 
-        m_S_Re.get()[K_idx] = S_Re * rho_Re - S_Im * rho_Im;
-        m_S_Im.get()[K_idx] = S_Re * rho_Im + S_Im * rho_Re;
+        S_Re_array[K_idx - k_begin] += weight * float(S_Re * rho_Re - S_Im * rho_Im);
+        S_Im_array[K_idx - k_begin] += weight * float(S_Re * rho_Im + S_Im * rho_Re);
         } // end foreach K
     }
 
@@ -324,6 +571,49 @@ void FTpolyhedron::set_params(unsigned int nvert,
         }
 
     m_params = params;
+    m_form_factors.clear();
+    }
+
+FTcomposite::FTcomposite()
+    : m_NK(0)
+    {
+    }
+
+void FTcomposite::compute()
+    {
+    unsigned int NK = m_types.size() ? m_types[0]->m_NK : 0;
+    for (unsigned int t = 0; t < m_types.size(); t++)
+        {
+        if (m_types[t]->m_NK != NK)
+            throw invalid_argument("all the types must have the same number of K points");
+        m_types[t]->prepare();
+        m_types[t]->preparePhases();
+        }
+    m_NK = NK;
+    m_arr = std::shared_ptr< std::complex<float> >(new std::complex<float>[NK],
+                                                   std::default_delete< std::complex<float>[] >());
+
+    std::complex<float> *S_array = m_arr.get();
+    const FTdelta * const *types = m_types.size() ? &m_types.front() : NULL;
+    const float *weights = m_weights.size() ? &m_weights.front() : NULL;
+    const unsigned int num_types = m_types.size();
+    const size_t block_size = FTdelta::K_BLOCK_SIZE;
+    parallel_for(blocked_range<size_t>(0, NK, block_size),
+        [=] (const blocked_range<size_t>& range)
+        {
+        double S_Re[FTdelta::K_BLOCK_SIZE];
+        double S_Im[FTdelta::K_BLOCK_SIZE];
+        for (size_t k_begin = range.begin(); k_begin < range.end(); k_begin += block_size)
+            {
+            const size_t k_end = std::min(k_begin + block_size, range.end());
+            std::fill(S_Re, S_Re + block_size, 0.0);
+            std::fill(S_Im, S_Im + block_size, 0.0);
+            for (unsigned int t = 0; t < num_types; t++)
+                types[t]->addBlock(k_begin, k_end, weights[t], S_Re, S_Im);
+            for (size_t i = k_begin; i < k_end; i++)
+                S_array[i] = std::complex<float>(S_Re[i - k_begin], S_Im[i - k_begin]);
+            }
+        });
     }
 
 }; }; // end namespace freud::kspace
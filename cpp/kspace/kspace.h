@@ -1,12 +1,16 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <array>
+#include <map>
 #include <memory>
 #include <complex>
 #include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
+#include "DensityGPU.h"
+#include "NonUniformFFT.h"
 #ifndef _KSPACE_H__
 #define _KSPACE_H__
 
@@ -32,6 +36,8 @@ class FTdelta
             m_NK = NK;
             m_K.resize(NK);
             std::copy(K, K+NK, m_K.begin());
+            m_gpu_K_current = false;
+            m_K_generation++;
 
             // initialize output array
             m_arr = std::shared_ptr< std::complex<float> >(new std::complex<float>[m_NK], std::default_delete<std::complex<float>[]>());
@@ -104,6 +110,38 @@ class FTdelta
             m_density_Im = density.imag();
             }
 
+        //! Set whether compute() sums the phases of the particles on a CUDA GPU
+        /*! The sums over the particles of all the K points are computed on the GPU at once, and the form factors
+            are applied on the CPU. The K points are copied to the device when they change. Polyhedra are always
+            summed on the CPU, per orientation.
+
+            Throws std::runtime_error if freud was built without CUDA or no device is found.
+        */
+        void setUseGPU(bool use_gpu);
+
+        //! Get whether compute() sums the phases on the GPU
+        bool getUseGPU() const
+            {
+            return bool(m_gpu);
+            }
+
+        //! Set the tolerance of the non uniform FFT that compute() sums the phases of the particles with, or 0 for the
+        //! direct sum
+        /*! The non uniform FFT (see NonUniformFFT) costs O(Np + M log M + NK) instead of O(NK x Np), M being the
+            size of its grid, which grows with the extent of the particles times that of the K points and with the
+            accuracy. It is used on the CPU instead of the GPU, when both are set. Polyhedra always use the direct
+            sum, per orientation.
+
+            Throws std::invalid_argument unless the tolerance is 0 or between 1e-12 and 0.1.
+        */
+        void setNUFFTTolerance(float tolerance);
+
+        //! Get the tolerance of the non uniform FFT, 0 when compute() sums the phases directly
+        float getNUFFTTolerance() const
+            {
+            return m_nufft ? m_nufft->getTolerance() : 0.0f;
+            }
+
         //! Perform transform and store result internally
         virtual void compute();
 
@@ -132,6 +170,38 @@ class FTdelta
         //     }
 
     protected:
+        friend class FTcomposite;
+
+        //! Number of K points of the blocks of the parallel loops
+        static const unsigned int K_BLOCK_SIZE = 32;
+        //! Number of particles of the blocks of the parallel loops, whose positions stay in the L1 cache
+        static const unsigned int PARTICLE_BLOCK_SIZE = 2048;
+
+        //! \internal
+        //! Set up what the K points share before the calls to addBlock() of a computation
+        virtual void prepare()
+            {
+            }
+
+        //! \internal
+        //! Sum the phases of all the K points with the non uniform FFT or on the GPU after prepare(), when either is
+        //! used, for sumPhases()
+        virtual void preparePhases();
+
+        //! \internal
+        //! Add the transform at the K points [k_begin, k_end), at most K_BLOCK_SIZE of them, times weight to S
+        /*! S_Re and S_Im hold k_end - k_begin values, and addBlock() may be called for different blocks at once.
+        */
+        virtual void addBlock(size_t k_begin, size_t k_end, float weight, double *S_Re, double *S_Im) const;
+
+        //! \internal
+        //! Compute the sums of cos(K . r) and sin(K . r) over the particles at the K points [k_begin, k_end)
+        /*! The block is summed over blocks of PARTICLE_BLOCK_SIZE particles, so that the positions of a particle
+            block are reused from the cache by all the K points of the block. The partial sums of each particle block
+            are added in double precision. The sums of preparePhases() are used when it computed them.
+        */
+        void sumPhases(size_t k_begin, size_t k_end, float *cos_sum, float *sin_sum) const;
+
         std::shared_ptr< std::complex<float> > m_arr;
         std::shared_ptr<float> m_S_Re;  //!< Real component of structure factor
         std::shared_ptr<float> m_S_Im;  //!< Imaginary component of structure factor
@@ -142,27 +212,48 @@ class FTdelta
         std::vector<quat<float> > m_q;      //!< array of particle orientations
         float m_density_Re;                 //!< real component of the scattering density
         float m_density_Im;                 //!< imaginary component of the scattering density
+        std::shared_ptr<gpu::DensityGPU> m_gpu;     //!< phase sums on the GPU, when it is used
+        bool m_gpu_K_current;               //!< true when the K points on the GPU are those of m_K
+        unsigned int m_K_generation;        //!< number of calls to set_K, which the caches of the K points check
+        std::shared_ptr<NonUniformFFT> m_nufft;     //!< phase sums by non uniform FFT, when it is used
+        bool m_phases_summed;               //!< true when preparePhases() computed the sums of the computation
+        std::vector<float> m_phase_cos_sum; //!< sums of cos(K . r) of preparePhases()
+        std::vector<float> m_phase_sin_sum; //!< sums of sin(K . r) of preparePhases()
     };
 
+//! Fourier transform of a list of uniform spheres
+/*! The form factor only depends on K and the radius, so it is computed once for all the frames with the same K
+    points and radius, each frame then only summing the phases of the particles.
+*/
 class FTsphere: public FTdelta
     {
     public:
         //! Constructor
         FTsphere();
 
-        //! Perform transform and store result internally
-        virtual void compute();
-
         //! Set particle volume according to radius
         void set_radius(const float radius)
             {
             m_radius = radius;
             m_volume = 4.0f * radius*radius*radius / 3.0f;
+            m_form_factor_current = false;
             }
 
+    protected:
+        //! \internal
+        //! Compute the form factor at the K points unless it is current
+        virtual void prepare();
+
+        //! \internal
+        //! Add the transform of the spheres at the K points [k_begin, k_end) times weight to S
+        virtual void addBlock(size_t k_begin, size_t k_end, float weight, double *S_Re, double *S_Im) const;
+
     private:
         float m_radius;                     //!< particle radius
         float m_volume;                     //!< particle volume
+        std::vector<float> m_form_factor;   //!< form factor at each K point
+        bool m_form_factor_current;         //!< true when m_form_factor is that of the radius
+        unsigned int m_form_factor_K;       //!< generation of the K points of m_form_factor
     };
 
 //! Data structure for polyhedron vertices
@@ -177,6 +268,21 @@ struct poly3d_param_t
     float volume;                                       //!< pre-computed polyhedron volume
     };
 
+//! Fourier transform of a list of oriented polyhedra
+/*! The form factor of a particle only depends on K rotated into its frame, so the particles are grouped by
+    orientation and the form factor is computed once per K point and distinct orientation, the phases of the
+    particles of each group being summed before they are multiplied by it. Orientations q and -q are the same
+    rotation. Crystals, whose particles take a few discrete orientations, thus cost little more than delta peaks.
+    A positive orientation tolerance also merges the orientations whose quaternion components round to the same
+    multiple of it, each group then using the first of its orientations.
+
+    The form factors of each orientation at all the K points are kept for the next frames, as long as the K points,
+    the shape and the tolerance do not change, up to FORM_FACTOR_CACHE_SIZE values; the orientations of a frame that
+    do not fit are computed per K point instead. A crystal whose particles keep their orientations then costs the
+    sums of the phases alone after its first frame.
+
+    The K points are split between threads.
+*/
 class FTpolyhedron: public FTdelta
     {
     public:
@@ -185,10 +291,19 @@ class FTpolyhedron: public FTdelta
         //! Constructor
         FTpolyhedron();
 
-        //! Perform transform and store result internally
-        //! Note that for a scale factor, lambda, affecting the size of the scatterer,
-        //! S_lambda(k) == lambda**3 * S(lambda * k)
-        virtual void compute();
+        //! Set the tolerance below which orientations share their form factor; 0 only merges identical rotations
+        void set_orientation_tolerance(float tolerance)
+            {
+            if (tolerance != m_orientation_tolerance)
+                m_form_factors.clear();
+            m_orientation_tolerance = tolerance;
+            }
+
+        //! Get the number of distinct orientations of the last computation
+        unsigned int getNumOrientations() const
+            {
+            return m_num_orientations;
+            }
 
         void set_params(unsigned int nvert,
                        vec3<float>* vert,
@@ -200,8 +315,102 @@ class FTpolyhedron: public FTdelta
                        float * area,
                        float volume);
 
+        //! Get the number of orientations whose form factors are kept
+        unsigned int getNumCachedOrientations() const
+            {
+            return m_form_factors.size();
+            }
+
+    protected:
+        //! Largest number of form factors kept, over all the orientations
+        static const size_t FORM_FACTOR_CACHE_SIZE = size_t(1) << 24;
+
+        //! \internal
+        //! Group the particles by orientation and compute the form factors of the new orientations
+        virtual void prepare();
+
+        //! \internal
+        //! The phases of the polyhedra are summed per orientation on the CPU
+        virtual void preparePhases()
+            {
+            }
+
+        //! \internal
+        //! Add the transform of the polyhedra at the K points [k_begin, k_end) times weight to S
+        //! Note that for a scale factor, lambda, affecting the size of the scatterer,
+        //! S_lambda(k) == lambda**3 * S(lambda * k)
+        virtual void addBlock(size_t k_begin, size_t k_end, float weight, double *S_Re, double *S_Im) const;
+
+    private:
+        //! \internal
+        //! Compute the form factor of the unrotated polyhedron at K
+        void formFactor(const vec3<float>& K, float& f_Re, float& f_Im) const;
+
+        param_type m_params;                //!< polyhedron data structure
+        float m_orientation_tolerance;      //!< tolerance below which orientations share their form factor
+        unsigned int m_num_orientations;    //!< number of distinct orientations of the last computation
+        std::vector< vec3<float> > m_group_r;       //!< positions of the particles, contiguous per orientation
+        std::vector< quat<float> > m_group_q;       //!< orientation of each group
+        std::vector<unsigned int> m_group_start;    //!< first particle of each group, and the number of particles
+        std::vector< std::array<int, 4> > m_group_key;  //!< orientation key of each group
+        std::vector< const std::complex<float>* > m_group_form_factor;  //!< cached form factors of each group, or NULL
+        std::map< std::array<int, 4>, std::vector< std::complex<float> > > m_form_factors;  //!< form factors by key
+        unsigned int m_form_factor_K;               //!< generation of the K points of m_form_factors
+    };
+
+//! Sum of the Fourier transforms of several particle types at the same list of K points
+/*! Each type is an FTdelta or derived calculator holding its particles, parameters and K points, which must number
+    the same for all the types. The K points are split between threads in blocks and every type adds its transform
+    to a block in turn, so the K loop is run once for all the types and their sum is accumulated in double precision.
+
+    The sum does not own the types, which must outlive it.
+*/
+class FTcomposite
+    {
+    public:
+        //! Constructor
+        FTcomposite();
+
+        //! Remove all the types
+        void clear()
+            {
+            m_types.clear();
+            m_weights.clear();
+            }
+
+        //! Add a type whose transform is multiplied by weight in the sum
+        void add(FTdelta *ft, float weight)
+            {
+            m_types.push_back(ft);
+            m_weights.push_back(weight);
+            }
+
+        //! Get the number of types
+        unsigned int getNumTypes() const
+            {
+            return m_types.size();
+            }
+
+        //! Get the number of K points of the last computation
+        unsigned int getNK() const
+            {
+            return m_NK;
+            }
+
+        //! Compute the sum of the transforms of the types
+        void compute();
+
+        //! Get the sum of the transforms at each K point
+        std::shared_ptr< std::complex<float> > getFT()
+            {
+            return m_arr;
+            }
+
     private:
-        param_type m_params;        //!< polyhedron data structure
+        std::vector<FTdelta*> m_types;      //!< calculator of each type
+        std::vector<float> m_weights;       //!< weight of each type in the sum
+        unsigned int m_NK;                  //!< number of K points of the last computation
+        std::shared_ptr< std::complex<float> > m_arr;   //!< sum of the transforms
     };
 
 }; }; // end namespace freud::kspace
@@ -0,0 +1,221 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <string.h>
+#include <tbb/tbb.h>
+
+#include "CompressedNeighborList.h"
+#include "HalfFloat.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace tbb;
+
+/*! \file CompressedNeighborList.cc
+    \brief A compact copy of a NeighborList, decoded one reference point at a time
+*/
+
+namespace freud { namespace locality {
+
+//! Number of bytes of the LEB128 encoding of v
+static inline unsigned int varintSize(unsigned int v)
+    {
+    unsigned int size = 1;
+    for (; v >= 0x80; v >>= 7)
+        size++;
+    return size;
+    }
+
+#ifdef __SSE2__
+//! Prefix sum of the eight 16 bit lanes of x
+static inline __m128i prefixSum16(__m128i x)
+    {
+    x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+    x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+    return _mm_add_epi16(x, _mm_slli_si128(x, 8));
+    }
+#endif
+
+CompressedNeighborList::CompressedNeighborList()
+    : m_num_bonds(0), m_num_i(0), m_num_j(0), m_max_neighbors(0), m_half_distances(false),
+      m_segments(1, 0), m_byte_offsets(1, 0)
+    {
+    }
+
+/*! The bonds of each reference point are ordered by point index in a first parallel pass, which also counts the
+    bytes of their deltas; a second pass writes them at the prefix sums of the counts.
+*/
+void CompressedNeighborList::compress(const NeighborList& nlist, bool half_distances)
+    {
+    m_num_bonds = nlist.getNumBonds();
+    m_num_i = nlist.getNumI();
+    m_num_j = nlist.getNumJ();
+    m_half_distances = half_distances;
+    const size_t *segments = nlist.getSegments().get();
+    m_segments.assign(segments, segments + m_num_i + 1);
+    m_max_neighbors = 0;
+    for (unsigned int i = 0; i < m_num_i; i++)
+        m_max_neighbors = max(m_max_neighbors, nlist.getNumNeighbors(i));
+
+    // order of the bonds of each reference point by point index, as offsets from its first bond
+    const unsigned int *source_j = nlist.getIndexJ().get();
+    vector<unsigned int> order(m_num_bonds);
+    unsigned int *l_order = order.data();
+    m_byte_offsets.assign(m_num_i + 1, 0);
+    size_t *l_byte_offsets = m_byte_offsets.data();
+    parallel_for(blocked_range<unsigned int>(0, m_num_i),
+        [=] (const blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            const size_t first = segments[i];
+            const unsigned int num = (unsigned int)(segments[i+1] - first);
+            unsigned int *bond_order = l_order + first;
+            for (unsigned int n = 0; n < num; n++)
+                bond_order[n] = n;
+            stable_sort(bond_order, bond_order + num,
+                [source_j, first] (unsigned int a, unsigned int b)
+                {
+                return source_j[first + a] < source_j[first + b];
+                });
+            size_t bytes = 0;
+            unsigned int last_j = 0;
+            for (unsigned int n = 0; n < num; n++)
+                {
+                unsigned int j = source_j[first + bond_order[n]];
+                bytes += varintSize(j - last_j);
+                last_j = j;
+                }
+            l_byte_offsets[i+1] = bytes;
+            }
+        });
+    for (unsigned int i = 0; i < m_num_i; i++)
+        m_byte_offsets[i+1] += m_byte_offsets[i];
+
+    m_index_bytes.resize(m_byte_offsets[m_num_i]);
+    if (half_distances)
+        {
+        m_half.resize(m_num_bonds);
+        m_distances = vector<float>();
+        }
+    else
+        {
+        m_distances.resize(m_num_bonds);
+        m_half = vector<uint16_t>();
+        }
+    const float *source_distances = nlist.getDistances().get();
+    uint8_t *index_bytes = m_index_bytes.data();
+    float *distances = m_distances.data();
+    uint16_t *half = m_half.data();
+    parallel_for(blocked_range<unsigned int>(0, m_num_i),
+        [=] (const blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            const size_t first = segments[i];
+            const unsigned int num = (unsigned int)(segments[i+1] - first);
+            const unsigned int *bond_order = l_order + first;
+            uint8_t *out = index_bytes + l_byte_offsets[i];
+            unsigned int last_j = 0;
+            for (unsigned int n = 0; n < num; n++)
+                {
+                const size_t bond = first + bond_order[n];
+                unsigned int delta = source_j[bond] - last_j;
+                last_j = source_j[bond];
+                for (; delta >= 0x80; delta >>= 7)
+                    *out++ = uint8_t(delta | 0x80);
+                *out++ = uint8_t(delta);
+                if (half_distances)
+                    half[first + n] = util::floatToHalf(source_distances[bond]);
+                else
+                    distances[first + n] = source_distances[bond];
+                }
+            }
+        });
+    }
+
+void CompressedNeighborList::decompress(NeighborList& nlist) const
+    {
+    nlist.resize(m_num_bonds, m_num_i, m_num_j, false);
+    copy(m_segments.begin(), m_segments.end(), nlist.getSegments().get());
+    unsigned int *index_i = nlist.getIndexI().get();
+    unsigned int *index_j = nlist.getIndexJ().get();
+    float *distances = nlist.getDistances().get();
+    const size_t *segments = m_segments.data();
+    parallel_for(blocked_range<unsigned int>(0, m_num_i),
+        [=] (const blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            decodeBonds(i, index_j + segments[i], distances + segments[i]);
+            fill(index_i + segments[i], index_i + segments[i+1], i);
+            }
+        });
+    }
+
+/*! Sixteen bytes without a continuation bit are sixteen one byte deltas, which SSE2 widens to 16 bits, prefix sums
+    and adds to the last index; other deltas are decoded one at a time. The 16 byte loads stay within the bytes of
+    reference point i, as at least 16 bonds, each of at least one byte, remain.
+*/
+unsigned int CompressedNeighborList::decodeBonds(unsigned int i, unsigned int *index_j, float *distances) const
+    {
+    const unsigned int num = getNumNeighbors(i);
+    const uint8_t *in = m_index_bytes.data() + m_byte_offsets[i];
+    unsigned int j = 0;
+    unsigned int n = 0;
+    while (n < num)
+        {
+        #ifdef __SSE2__
+        if (n + 16 <= num)
+            {
+            const __m128i bytes = _mm_loadu_si128((const __m128i *) in);
+            if (_mm_movemask_epi8(bytes) == 0)
+                {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i lo = prefixSum16(_mm_unpacklo_epi8(bytes, zero));
+                __m128i hi = prefixSum16(_mm_unpackhi_epi8(bytes, zero));
+                hi = _mm_add_epi16(hi, _mm_set1_epi16((short) _mm_extract_epi16(lo, 7)));
+                const __m128i base = _mm_set1_epi32((int) j);
+                _mm_storeu_si128((__m128i *) (index_j + n), _mm_add_epi32(base, _mm_unpacklo_epi16(lo, zero)));
+                _mm_storeu_si128((__m128i *) (index_j + n + 4), _mm_add_epi32(base, _mm_unpackhi_epi16(lo, zero)));
+                _mm_storeu_si128((__m128i *) (index_j + n + 8), _mm_add_epi32(base, _mm_unpacklo_epi16(hi, zero)));
+                _mm_storeu_si128((__m128i *) (index_j + n + 12), _mm_add_epi32(base, _mm_unpackhi_epi16(hi, zero)));
+                j = index_j[n + 15];
+                n += 16;
+                in += 16;
+                continue;
+                }
+            }
+        #endif
+        unsigned int delta = 0;
+        unsigned int shift = 0;
+        uint8_t byte;
+        do
+            {
+            byte = *in++;
+            delta |= (unsigned int)(byte & 0x7f) << shift;
+            shift += 7;
+            } while (byte & 0x80);
+        j += delta;
+        index_j[n++] = j;
+        }
+
+    if (distances != NULL)
+        {
+        const size_t first = m_segments[i];
+        if (m_half_distances)
+            {
+            for (unsigned int k = 0; k < num; k++)
+                distances[k] = util::halfToFloat(m_half[first + k]);
+            }
+        else if (num > 0)
+            memcpy(distances, m_distances.data() + first, sizeof(float)*num);
+        }
+    return num;
+    }
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,111 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+#include "NeighborList.h"
+
+#ifndef _COMPRESSED_NEIGHBORLIST_H__
+#define _COMPRESSED_NEIGHBORLIST_H__
+
+/*! \file CompressedNeighborList.h
+    \brief A compact copy of a NeighborList, decoded one reference point at a time
+*/
+
+namespace freud { namespace locality {
+
+//! The bonds of a NeighborList in a fraction of its memory
+/*! A NeighborList spends 12 bytes on the indices and distance of a bond, which makes the traversal of a large list
+    bound by memory bandwidth. A CompressedNeighborList stores the point indices of the bonds of each reference
+    point sorted, as variable length (LEB128) deltas from the previous index, and their distances as floats or,
+    optionally, IEEE 754 half floats. Once the points are ordered spatially (see SpaceFillingCurve), the neighbors of
+    a point have nearby indices and most deltas take one byte, so that a bond takes 3 bytes with half distances.
+
+    decodeBonds() decodes the bonds of one reference point into buffers of getMaxNeighbors() entries; runs of one byte
+    deltas are decoded 16 at a time with SSE2. The bonds of each reference point come out by increasing point index,
+    whatever their order in the source list. Bond vectors and weights are not kept.
+*/
+class CompressedNeighborList
+    {
+    public:
+        //! Null constructor
+        CompressedNeighborList();
+
+        //! Replace the contents of this list with the bonds of nlist
+        /*! \param nlist List to compress
+            \param half_distances true to store the distances as half floats, with a relative error below 2^-11
+        */
+        void compress(const NeighborList& nlist, bool half_distances=false);
+
+        //! Write the bonds into nlist, by increasing point index for each reference point
+        void decompress(NeighborList& nlist) const;
+
+        //! Decode the bonds of reference point i
+        /*! \param i Reference point
+            \param index_j Point index of each bond, getMaxNeighbors() entries
+            \param distances Distance of each bond, getMaxNeighbors() entries, or NULL to skip the distances
+            \returns The number of bonds of i
+        */
+        unsigned int decodeBonds(unsigned int i, unsigned int *index_j, float *distances) const;
+
+        //! Get the number of bonds
+        size_t getNumBonds() const
+            {
+            return m_num_bonds;
+            }
+
+        //! Get the number of reference points
+        unsigned int getNumI() const
+            {
+            return m_num_i;
+            }
+
+        //! Get the number of points
+        unsigned int getNumJ() const
+            {
+            return m_num_j;
+            }
+
+        //! Get the largest number of bonds of a reference point
+        unsigned int getMaxNeighbors() const
+            {
+            return m_max_neighbors;
+            }
+
+        //! Get the number of bonds of reference point i
+        unsigned int getNumNeighbors(unsigned int i) const
+            {
+            return (unsigned int)(m_segments[i+1] - m_segments[i]);
+            }
+
+        //! Test if the distances are stored as half floats
+        bool hasHalfDistances() const
+            {
+            return m_half_distances;
+            }
+
+        //! Get the number of bytes taken by the bonds
+        size_t getMemoryUsage() const
+            {
+            return m_index_bytes.size() + sizeof(float)*m_distances.size() + sizeof(uint16_t)*m_half.size() +
+                   sizeof(size_t)*(m_segments.size() + m_byte_offsets.size());
+            }
+
+    private:
+        size_t m_num_bonds;                     //!< Number of bonds
+        unsigned int m_num_i;                   //!< Number of reference points
+        unsigned int m_num_j;                   //!< Number of points
+        unsigned int m_max_neighbors;           //!< Largest number of bonds of a reference point
+        bool m_half_distances;                  //!< True if the distances are stored in m_half
+        std::vector<size_t> m_segments;         //!< First bond of each reference point
+        std::vector<size_t> m_byte_offsets;     //!< First byte of the point indices of each reference point
+        std::vector<uint8_t> m_index_bytes;     //!< Point index deltas of the bonds, as LEB128 varints
+        std::vector<float> m_distances;         //!< Distance of each bond, unless stored as half floats
+        std::vector<uint16_t> m_half;           //!< Half float distance of each bond
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _COMPRESSED_NEIGHBORLIST_H__
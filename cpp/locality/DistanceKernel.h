@@ -0,0 +1,264 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "../box/box.h"
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifndef _DISTANCE_KERNEL_H__
+#define _DISTANCE_KERNEL_H__
+
+/*! \file DistanceKernel.h
+    \brief Vectorized search for the points of a contiguous block within a cutoff of a reference point
+*/
+
+namespace freud { namespace locality {
+
+//! Finds the points of a contiguous block that are within a cutoff of a reference point
+/*! The inner loop of every radius-based analysis computes box.wrap(points[j] - ref) and its squared length one
+    pair at a time. DistanceKernel evaluates the same branch-free minimum image wrap (box::WrapContext::wrap) for
+    four candidates at once with SSE2 and only hands the hits to the caller. The vectorized wrap performs the same
+    operations in the same order as the scalar one, so the hits, vectors and squared distances agree with the scalar
+    loop; candidates left over after the last full group of four take the scalar path, as does the whole block
+    without SSE2. Each call selects an instantiation for the shape of the box (see box::WrapContext::wrap), so
+    that the common orthorhombic boxes do no tilt arithmetic and 2D boxes no z arithmetic.
+
+    countWithin() only counts the hits, for the analyses that need the number of neighbors or whether there is any,
+    and not the neighbors themselves.
+
+    The candidates must be contiguous in memory, such as the points of one cell of a LinkCell computed with
+    sorted points (LinkCell::getSortedPoints()).
+
+    Usage:
+    \code
+    DistanceKernel kernel(box);
+    kernel.forEachWithin(ref, sorted_points + cell_start[c], cell_start[c+1] - cell_start[c], rmaxsq,
+        [&] (unsigned int k, const vec3<float>& delta, float rsq)
+        {
+        // candidate k of the block is a hit
+        });
+    \endcode
+*/
+class DistanceKernel
+    {
+    public:
+        //! Keep the wrap context of the box
+        explicit DistanceKernel(const box::Box& box) : m_wrap(box.getWrapContext())
+            {
+            }
+
+        //! Call visit(k, delta, rsq) for every candidate k of points[0, n) closer than sqrt(rmaxsq) to ref
+        /*! \param ref Reference position
+            \param points Contiguous candidate positions
+            \param n Number of candidates
+            \param rmaxsq Squared cutoff distance
+            \param visit Callable invoked with the index of the hit in the block, the wrapped vector
+                   points[k] - ref and its squared length, in increasing order of k
+        */
+        template<typename Visitor>
+        void forEachWithin(const vec3<float>& ref, const vec3<float> *points, unsigned int n, float rmaxsq,
+                           Visitor visit) const
+            {
+            dispatch<true>(ref, points, n, rmaxsq, visit);
+            }
+
+        //! Call visit(k, delta, rsq) for every candidate k of points[0, n), whatever its distance to ref
+        template<typename Visitor>
+        void forEach(const vec3<float>& ref, const vec3<float> *points, unsigned int n, Visitor visit) const
+            {
+            dispatch<false>(ref, points, n, 0.0f, visit);
+            }
+
+        //! Count the candidates of points[0, n) closer than sqrt(rmaxsq) to ref, without computing their vectors
+        /*! The count stops at the end of the group of four candidates in which it reaches \a limit, so that a test
+            for any hit stops at the first one: the result is then at least \a limit, but not the full count.
+        */
+        unsigned int countWithin(const vec3<float>& ref, const vec3<float> *points, unsigned int n, float rmaxsq,
+                                 unsigned int limit=0xffffffff) const
+            {
+            if (m_wrap.tilted)
+                {
+                if (m_wrap.is2D)
+                    return countBlock<true, true>(ref, points, n, rmaxsq, limit);
+                return countBlock<true, false>(ref, points, n, rmaxsq, limit);
+                }
+            if (m_wrap.is2D)
+                return countBlock<false, true>(ref, points, n, rmaxsq, limit);
+            return countBlock<false, false>(ref, points, n, rmaxsq, limit);
+            }
+
+    private:
+        //! Select the instantiation that leaves out the tilt and z arithmetic the box does not need
+        template<bool use_cutoff, typename Visitor>
+        void dispatch(const vec3<float>& ref, const vec3<float> *points, unsigned int n, float rmaxsq,
+                      Visitor& visit) const
+            {
+            if (m_wrap.tilted)
+                {
+                if (m_wrap.is2D)
+                    visitBlock<true, true, use_cutoff>(ref, points, n, rmaxsq, visit);
+                else
+                    visitBlock<true, false, use_cutoff>(ref, points, n, rmaxsq, visit);
+                }
+            else
+                {
+                if (m_wrap.is2D)
+                    visitBlock<false, true, use_cutoff>(ref, points, n, rmaxsq, visit);
+                else
+                    visitBlock<false, false, use_cutoff>(ref, points, n, rmaxsq, visit);
+                }
+            }
+
+        //! Visit the candidates of a block, closer than sqrt(rmaxsq) to ref when use_cutoff is set
+        template<bool tilted_box, bool box_2d, bool use_cutoff, typename Visitor>
+        void visitBlock(const vec3<float>& ref, const vec3<float> *points, unsigned int n, float rmaxsq,
+                        Visitor& visit) const
+            {
+            unsigned int k = 0;
+            #ifdef __SSE2__
+            const __m128 ref_x = _mm_set1_ps(ref.x);
+            const __m128 ref_y = _mm_set1_ps(ref.y);
+            const __m128 ref_z = _mm_set1_ps(ref.z);
+            const __m128 cut = _mm_set1_ps(rmaxsq);
+            float out_x[4], out_y[4], out_z[4], out_rsq[4];
+            for (; k + 4 <= n; k += 4)
+                {
+                // load four packed vec3 and transpose them to x, y, z lanes
+                const float *block = (const float *) (points + k);
+                __m128 a = _mm_loadu_ps(block);
+                __m128 b = _mm_loadu_ps(block + 4);
+                __m128 c = _mm_loadu_ps(block + 8);
+                __m128 x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3,0,3,0)),
+                                          _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,1,0));
+                __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)),
+                                          _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+                __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)),
+                                          _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,3,0,0)), _MM_SHUFFLE(2,0,2,0));
+
+                __m128 dx = _mm_sub_ps(x, ref_x);
+                __m128 dy = _mm_sub_ps(y, ref_y);
+                __m128 dz = _mm_sub_ps(z, ref_z);
+                wrap4<tilted_box, box_2d>(dx, dy, dz);
+
+                __m128 rsq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                int hits = use_cutoff ? _mm_movemask_ps(_mm_cmplt_ps(rsq, cut)) : 0xf;
+                if (hits == 0)
+                    continue;
+
+                _mm_storeu_ps(out_x, dx);
+                _mm_storeu_ps(out_y, dy);
+                _mm_storeu_ps(out_z, dz);
+                _mm_storeu_ps(out_rsq, rsq);
+                for (unsigned int lane = 0; lane < 4; lane++)
+                    {
+                    if (hits & (1 << lane))
+                        visit(k + lane, vec3<float>(out_x[lane], out_y[lane], out_z[lane]), out_rsq[lane]);
+                    }
+                }
+            #endif
+            for (; k < n; k++)
+                {
+                vec3<float> delta = m_wrap.wrap<tilted_box, box_2d>(points[k] - ref);
+                float rsq = dot(delta, delta);
+                if (!use_cutoff || rsq < rmaxsq)
+                    visit(k, delta, rsq);
+                }
+            }
+
+        #ifdef __SSE2__
+        //! Count the candidates of a block closer than sqrt(rmaxsq) to ref, up to the group that reaches limit
+        template<bool tilted_box, bool box_2d>
+        unsigned int countBlock(const vec3<float>& ref, const vec3<float> *points, unsigned int n, float rmaxsq,
+                                unsigned int limit) const
+            {
+            unsigned int count = 0;
+            unsigned int k = 0;
+            #ifdef __SSE2__
+            const __m128 ref_x = _mm_set1_ps(ref.x);
+            const __m128 ref_y = _mm_set1_ps(ref.y);
+            const __m128 ref_z = _mm_set1_ps(ref.z);
+            const __m128 cut = _mm_set1_ps(rmaxsq);
+            for (; k + 4 <= n && count < limit; k += 4)
+                {
+                const float *block = (const float *) (points + k);
+                __m128 a = _mm_loadu_ps(block);
+                __m128 b = _mm_loadu_ps(block + 4);
+                __m128 c = _mm_loadu_ps(block + 8);
+                __m128 x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3,0,3,0)),
+                                          _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,1,0));
+                __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)),
+                                          _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+                __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)),
+                                          _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,3,0,0)), _MM_SHUFFLE(2,0,2,0));
+
+                __m128 dx = _mm_sub_ps(x, ref_x);
+                __m128 dy = _mm_sub_ps(y, ref_y);
+                __m128 dz = _mm_sub_ps(z, ref_z);
+                wrap4<tilted_box, box_2d>(dx, dy, dz);
+
+                // the hits are only counted, so nothing is stored
+                __m128 rsq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                int hits = _mm_movemask_ps(_mm_cmplt_ps(rsq, cut));
+                count += (hits & 1) + ((hits >> 1) & 1) + ((hits >> 2) & 1) + ((hits >> 3) & 1);
+                }
+            #endif
+            for (; k < n && count < limit; k++)
+                {
+                vec3<float> delta = m_wrap.wrap<tilted_box, box_2d>(points[k] - ref);
+                count += dot(delta, delta) < rmaxsq;
+                }
+            return count;
+            }
+
+        //! box::WrapContext::roundNearest of four values
+        static __m128 roundNearest4(__m128 f)
+            {
+            __m128 g = _mm_add_ps(f, _mm_set1_ps(0.5f));
+            __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(g));
+            return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, g), _mm_set1_ps(1.0f)));
+            }
+
+        //! Apply box::WrapContext::wrap to four vectors at once
+        template<bool tilted_box, bool box_2d>
+        void wrap4(__m128& dx, __m128& dy, __m128& dz) const
+            {
+            __m128 fx = dx;
+            __m128 fy = dy;
+            if (tilted_box)
+                {
+                fy = _mm_sub_ps(dy, _mm_mul_ps(_mm_set1_ps(m_wrap.yz), dz));
+                fx = _mm_sub_ps(_mm_sub_ps(dx, _mm_mul_ps(_mm_set1_ps(m_wrap.tilt_xz), dz)),
+                                _mm_mul_ps(_mm_set1_ps(m_wrap.xy), dy));
+                }
+            __m128 nx = roundNearest4(_mm_mul_ps(fx, _mm_set1_ps(m_wrap.Linv.x)));
+            __m128 ny = roundNearest4(_mm_mul_ps(fy, _mm_set1_ps(m_wrap.Linv.y)));
+
+            __m128 shift_x = _mm_mul_ps(nx, _mm_set1_ps(m_wrap.L.x));
+            __m128 shift_y = _mm_mul_ps(ny, _mm_set1_ps(m_wrap.L.y));
+            if (tilted_box)
+                shift_x = _mm_add_ps(shift_x, _mm_mul_ps(ny, _mm_set1_ps(m_wrap.Ly_xy)));
+            if (!box_2d)
+                {
+                __m128 nz = roundNearest4(_mm_mul_ps(dz, _mm_set1_ps(m_wrap.Linv.z)));
+                if (tilted_box)
+                    {
+                    shift_x = _mm_add_ps(shift_x, _mm_mul_ps(nz, _mm_set1_ps(m_wrap.Lz_xz)));
+                    shift_y = _mm_add_ps(shift_y, _mm_mul_ps(nz, _mm_set1_ps(m_wrap.Lz_yz)));
+                    }
+                dz = _mm_sub_ps(dz, _mm_mul_ps(nz, _mm_set1_ps(m_wrap.L.z)));
+                }
+            dx = _mm_sub_ps(dx, shift_x);
+            dy = _mm_sub_ps(dy, shift_y);
+            }
+        #endif
+
+        box::WrapContext m_wrap;    //!< Precomputed quantities of the box used for the wrap
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _DISTANCE_KERNEL_H__
@@ -0,0 +1,234 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "DomainDecomposition.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file DomainDecomposition.cc
+    \brief Decomposition of the box into a grid of domains with ghost layers
+*/
+
+namespace freud { namespace locality {
+
+//! Domain along one axis and image shift of a point
+typedef std::pair<unsigned int, int> AxisImage;
+
+//! \internal
+//! Wrap fractional coordinates into [0, 1)
+static float wrapFraction(float f)
+    {
+    f -= floorf(f);
+    // rounding can put f - floor(f) of a tiny negative f at 1
+    return (f < 1.0f) ? f : 0.0f;
+    }
+
+//! \internal
+//! Domains of n along one axis whose ghost layers of fractional width g hold an image f + shift of the wrapped
+//! coordinate f, with their shifts; the domain owning f itself, of shift 0, is one of them
+static void axisImages(float f, unsigned int n, float g, std::vector<AxisImage>& images)
+    {
+    images.clear();
+    if (n == 1)
+        {
+        images.push_back(AxisImage(0, 0));
+        return;
+        }
+    // g is below 1/2, so only the neighboring images can be within the ghost layer of a domain
+    for (int shift = -1; shift <= 1; shift++)
+        {
+        // j/n - g <= f + shift < (j + 1)/n + g
+        const float v = f + float(shift);
+        const int first = std::max(int(floorf((v - g)*n)), 0);
+        const int last = std::min(int(floorf((v + g)*n)), int(n) - 1);
+        for (int j = first; j <= last; j++)
+            images.push_back(AxisImage(j, shift));
+        }
+    }
+
+DomainDecomposition::DomainDecomposition(const box::Box& box, unsigned int nx, unsigned int ny, unsigned int nz,
+                                         float ghost_width)
+    : m_box(box), m_domain_indexer(nx, ny, nz), m_ghost_width(ghost_width), m_Np(0), m_num_entries(0)
+    {
+    if (nx == 0 || ny == 0 || nz == 0)
+        throw invalid_argument("There must be at least one domain along each axis");
+    if (box.is2D() && nz != 1)
+        throw invalid_argument("A 2D box has one domain along its third axis");
+    if (ghost_width < 0.0f)
+        throw invalid_argument("ghost_width must not be negative");
+
+    // the ghost layers along the axes of several domains, in fractional coordinates
+    const vec3<float> L = m_box.getNearestPlaneDistance();
+    const unsigned int n[3] = {nx, ny, nz};
+    const float plane_distance[3] = {L.x, L.y, L.z};
+    float g[3];
+    for (unsigned int axis = 0; axis < 3; axis++)
+        {
+        g[axis] = (n[axis] > 1) ? ghost_width/plane_distance[axis] : 0.0f;
+        if (g[axis] >= 0.5f)
+            throw invalid_argument("ghost_width must be less than half of the box along the axes decomposed");
+        }
+    m_frac_ghost_width = vec3<float>(g[0], g[1], g[2]);
+    m_offsets = std::shared_ptr<size_t>(new size_t[2*getNumDomains() + 1], std::default_delete<size_t[]>());
+    std::fill(m_offsets.get(), m_offsets.get() + 2*getNumDomains() + 1, 0);
+    }
+
+unsigned int DomainDecomposition::getDomain(const vec3<float>& point) const
+    {
+    const vec3<float> f = m_box.makeFraction(point);
+    const unsigned int i = std::min((unsigned int) (wrapFraction(f.x)*m_domain_indexer.getW()),
+                                    m_domain_indexer.getW() - 1);
+    const unsigned int j = std::min((unsigned int) (wrapFraction(f.y)*m_domain_indexer.getH()),
+                                    m_domain_indexer.getH() - 1);
+    const unsigned int k = std::min((unsigned int) (wrapFraction(f.z)*m_domain_indexer.getD()),
+                                    m_domain_indexer.getD() - 1);
+    return m_domain_indexer(i, j, k);
+    }
+
+vec3<float> DomainDecomposition::getDomainCenter(unsigned int domain) const
+    {
+    if (domain >= getNumDomains())
+        throw invalid_argument("There is no such domain");
+    const vec3<unsigned int> idx = m_domain_indexer(domain);
+    return vec3<float>((float(idx.x) + 0.5f)/m_domain_indexer.getW(), (float(idx.y) + 0.5f)/m_domain_indexer.getH(),
+                       m_box.is2D() ? 0.0f : (float(idx.z) + 0.5f)/m_domain_indexer.getD());
+    }
+
+/*! A decomposed axis of n domains is 1/n + 3 ghost widths of the box long: the owned points and the ghosts span
+    1/n + 2 ghost widths, so that points at its opposite ends are still a ghost width apart through the boundary.
+*/
+box::Box DomainDecomposition::getDomainBox(unsigned int domain) const
+    {
+    if (domain >= getNumDomains())
+        throw invalid_argument("There is no such domain");
+    const unsigned int n[3] = {m_domain_indexer.getW(), m_domain_indexer.getH(), m_domain_indexer.getD()};
+    const float g[3] = {m_frac_ghost_width.x, m_frac_ghost_width.y, m_frac_ghost_width.z};
+    float scale[3];
+    for (unsigned int axis = 0; axis < 3; axis++)
+        scale[axis] = (n[axis] > 1) ? 1.0f/n[axis] + 3.0f*g[axis] : 1.0f;
+    return box::Box(m_box.getLx()*scale[0], m_box.getLy()*scale[1], m_box.getLz()*scale[2],
+                    m_box.getTiltFactorXY(), m_box.getTiltFactorXZ(), m_box.getTiltFactorYZ(), m_box.is2D());
+    }
+
+/*! The images of each point are counted, then written in parallel in the order of the points, then sorted by
+    domain, owned points first.
+*/
+void DomainDecomposition::compute(const vec3<float> *points, unsigned int Np)
+    {
+    const unsigned int num_domains = getNumDomains();
+    if (Np != m_Np || !m_domains)
+        m_domains = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+    m_Np = Np;
+
+    const box::Box box = m_box;
+    const Index3D indexer = m_domain_indexer;
+    const vec3<float> g = m_frac_ghost_width;
+    const bool is2D = m_box.is2D();
+    const vec3<float> a0 = m_box.getLatticeVector(0);
+    const vec3<float> a1 = m_box.getLatticeVector(1);
+    const vec3<float> a2 = is2D ? vec3<float>(0, 0, 0) : m_box.getLatticeVector(2);
+    std::vector<vec3<float> > centers(num_domains);
+    for (unsigned int domain = 0; domain < num_domains; domain++)
+        centers[domain] = m_box.makeCoordinates(getDomainCenter(domain));
+    const vec3<float> *centers_ptr = centers.data();
+
+    // the wrapped fractional coordinates of each point give its domain and the images it has in the others
+    std::vector<size_t> counts(Np + 1, 0);
+    size_t *counts_ptr = counts.data();
+    unsigned int *domains_ptr = m_domains.get();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        std::vector<AxisImage> images[3];
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            const vec3<float> f = box.makeFraction(points[i]);
+            const vec3<float> w(wrapFraction(f.x), wrapFraction(f.y), is2D ? 0.0f : wrapFraction(f.z));
+            domains_ptr[i] = indexer(std::min((unsigned int) (w.x*indexer.getW()), indexer.getW() - 1),
+                                     std::min((unsigned int) (w.y*indexer.getH()), indexer.getH() - 1),
+                                     std::min((unsigned int) (w.z*indexer.getD()), indexer.getD() - 1));
+            axisImages(w.x, indexer.getW(), g.x, images[0]);
+            axisImages(w.y, indexer.getH(), g.y, images[1]);
+            axisImages(w.z, indexer.getD(), g.z, images[2]);
+            counts_ptr[i] = images[0].size()*images[1].size()*images[2].size();
+            }
+        });
+
+    size_t num_entries = 0;
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        const size_t count = counts_ptr[i];
+        counts_ptr[i] = num_entries;
+        num_entries += count;
+        }
+    counts_ptr[Np] = num_entries;
+
+    // each image, with the key 2*domain for the owned point and 2*domain + 1 for the ghosts
+    std::vector<unsigned int> keys(num_entries);
+    std::vector<unsigned int> unsorted_indices(num_entries);
+    std::vector<vec3<float> > unsorted_positions(num_entries);
+    unsigned int *keys_ptr = keys.data();
+    unsigned int *indices_ptr = unsorted_indices.data();
+    vec3<float> *positions_ptr = unsorted_positions.data();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        std::vector<AxisImage> images[3];
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            const vec3<float> f = box.makeFraction(points[i]);
+            const vec3<float> w(wrapFraction(f.x), wrapFraction(f.y), is2D ? 0.0f : wrapFraction(f.z));
+            // the point wrapped into the box
+            const vec3<float> p = points[i] - floorf(f.x)*a0 - floorf(f.y)*a1 - (is2D ? 0.0f : floorf(f.z))*a2;
+            axisImages(w.x, indexer.getW(), g.x, images[0]);
+            axisImages(w.y, indexer.getH(), g.y, images[1]);
+            axisImages(w.z, indexer.getD(), g.z, images[2]);
+            size_t entry = counts_ptr[i];
+            for (std::vector<AxisImage>::const_iterator x = images[0].begin(); x != images[0].end(); ++x)
+                for (std::vector<AxisImage>::const_iterator y = images[1].begin(); y != images[1].end(); ++y)
+                    for (std::vector<AxisImage>::const_iterator z = images[2].begin(); z != images[2].end(); ++z)
+                        {
+                        const unsigned int domain = indexer(x->first, y->first, z->first);
+                        const bool ghost = domain != domains_ptr[i] || x->second != 0 || y->second != 0 ||
+                                           z->second != 0;
+                        keys_ptr[entry] = 2*domain + (ghost ? 1 : 0);
+                        indices_ptr[entry] = (unsigned int) i;
+                        positions_ptr[entry] = p + float(x->second)*a0 + float(y->second)*a1 +
+                                               float(z->second)*a2 - centers_ptr[domain];
+                        entry++;
+                        }
+            }
+        });
+
+    // counting sort of the images by their key, keeping the order of the points within each
+    std::fill(m_offsets.get(), m_offsets.get() + 2*num_domains + 1, 0);
+    size_t *offsets = m_offsets.get();
+    for (size_t entry = 0; entry < num_entries; entry++)
+        offsets[keys[entry] + 1]++;
+    for (unsigned int key = 0; key < 2*num_domains; key++)
+        offsets[key + 1] += offsets[key];
+
+    if (num_entries != m_num_entries || !m_indices)
+        {
+        m_indices = std::shared_ptr<unsigned int>(new unsigned int[std::max(num_entries, size_t(1))],
+                                                  std::default_delete<unsigned int[]>());
+        m_positions = std::shared_ptr< vec3<float> >(new vec3<float>[std::max(num_entries, size_t(1))],
+                                                     std::default_delete< vec3<float>[]>());
+        }
+    m_num_entries = num_entries;
+    std::vector<size_t> next(offsets, offsets + 2*num_domains);
+    for (size_t entry = 0; entry < num_entries; entry++)
+        {
+        const size_t position = next[keys[entry]]++;
+        m_indices.get()[position] = unsorted_indices[entry];
+        m_positions.get()[position] = unsorted_positions[entry];
+        }
+    }
+
+}; }; // end namespace freud::locality
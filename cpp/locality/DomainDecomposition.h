@@ -0,0 +1,145 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <tbb/tbb.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "Index1D.h"
+
+#ifndef _DOMAIN_DECOMPOSITION_H__
+#define _DOMAIN_DECOMPOSITION_H__
+
+/*! \file DomainDecomposition.h
+    \brief Decomposition of the box into a grid of domains with ghost layers
+*/
+
+namespace freud { namespace locality {
+
+//! Split the box into a grid of domains, each with the points it owns and the ghosts within a width of it
+/*! The box is cut into nx x ny x nz domains along its lattice vectors, and each point is owned by the domain its
+    wrapped fractional coordinates fall in. The ghosts of a domain are the periodic images of the points of the other
+    domains, and of its own along axes of one or two domains, that are within ghost_width of it, the distance being
+    measured normal to the faces of the box as by VoronoiBuffer. An analysis of cutoff up to ghost_width run on the
+    owned points and the ghosts of a domain then sees all the neighbors of the owned points.
+
+    Each domain has its own box, getDomainBox(), of the tilts of the box and wide enough that the owned points and
+    the ghosts never wrap into neighbors of each other; along axes of a single domain it is the box itself, periodic
+    and without ghosts. The points given to the domains are in the coordinates of their box, translated from those of
+    the box, so that an analysis of a domain only needs cells for the domain.
+
+    compute() sorts the points of one process into the domains: getOffsets() gives, for each domain d, the range
+    [offsets[2d], offsets[2d+1]) of its owned points, then [offsets[2d+1], offsets[2d+2]) of its ghosts, in
+    getIndices() and getPositions(). The points of all the processes of a simulation are distributed by sending each
+    range to the process of its domain, see freud.parallel.exchangeDomains.
+*/
+class DomainDecomposition
+    {
+    public:
+        //! Constructor
+        /*! \param box Simulation box
+            \param nx Number of domains along the first lattice vector
+            \param ny Number of domains along the second lattice vector
+            \param nz Number of domains along the third lattice vector, 1 in 2D
+            \param ghost_width Width of the ghost layers, at least the cutoff of the analyses
+        */
+        DomainDecomposition(const box::Box& box, unsigned int nx, unsigned int ny, unsigned int nz,
+                            float ghost_width);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the grid of domains
+        const Index3D& getDomainIndexer() const
+            {
+            return m_domain_indexer;
+            }
+
+        //! Get the number of domains
+        unsigned int getNumDomains() const
+            {
+            return m_domain_indexer.getNumElements();
+            }
+
+        //! Get the width of the ghost layers
+        float getGhostWidth() const
+            {
+            return m_ghost_width;
+            }
+
+        //! Get the domain a point belongs to
+        unsigned int getDomain(const vec3<float>& point) const;
+
+        //! Get the box of a domain, whose coordinates the points given to the domain are in
+        box::Box getDomainBox(unsigned int domain) const;
+
+        //! Convert a point in the coordinates of the box to those of the box of a domain
+        vec3<float> makeDomainCoordinates(unsigned int domain, const vec3<float>& point) const
+            {
+            return point - m_box.makeCoordinates(getDomainCenter(domain));
+            }
+
+        //! Sort points into the domains
+        void compute(const vec3<float> *points, unsigned int Np);
+
+        //! Get the number of points of the last compute
+        unsigned int getNp() const
+            {
+            return m_Np;
+            }
+
+        //! Get the domain of each point of the last compute
+        std::shared_ptr<unsigned int> getDomains()
+            {
+            return m_domains;
+            }
+
+        //! Get the number of owned points and ghosts given to the domains
+        size_t getNumEntries() const
+            {
+            return m_num_entries;
+            }
+
+        //! Get the beginnings of the owned points and of the ghosts of each domain, 2*getNumDomains() + 1 values
+        std::shared_ptr<size_t> getOffsets()
+            {
+            return m_offsets;
+            }
+
+        //! Get the point of each owned point and ghost, grouped by domain
+        std::shared_ptr<unsigned int> getIndices()
+            {
+            return m_indices;
+            }
+
+        //! Get the position of each owned point and ghost, in the coordinates of the box of its domain
+        std::shared_ptr< vec3<float> > getPositions()
+            {
+            return m_positions;
+            }
+
+    private:
+        //! Get the fractional coordinates of the center of a domain
+        vec3<float> getDomainCenter(unsigned int domain) const;
+
+        box::Box m_box;                         //!< Simulation box
+        Index3D m_domain_indexer;               //!< Grid of the domains
+        float m_ghost_width;                    //!< Width of the ghost layers
+        vec3<float> m_frac_ghost_width;         //!< Width of the ghost layers in fractional coordinates
+        unsigned int m_Np;                      //!< Number of points of the last compute
+        size_t m_num_entries;                   //!< Number of owned points and ghosts of the last compute
+        std::shared_ptr<unsigned int> m_domains;        //!< Domain of each point
+        std::shared_ptr<size_t> m_offsets;              //!< Beginnings of the owned points and ghosts of each domain
+        std::shared_ptr<unsigned int> m_indices;        //!< Point of each owned point and ghost
+        std::shared_ptr< vec3<float> > m_positions;     //!< Positions of the owned points and ghosts in their domain
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _DOMAIN_DECOMPOSITION_H__
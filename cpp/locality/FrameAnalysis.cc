@@ -0,0 +1,197 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <tbb/tbb.h>
+
+#include "FrameAnalysis.h"
+#include "PeriodicImages.h"
+#include "DistanceKernel.h"
+#include "Annotation.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file FrameAnalysis.cc
+    \brief One traversal of the neighbors of a frame shared by several analyses
+*/
+
+namespace freud { namespace locality {
+
+FrameAnalysis::FrameAnalysis() : m_lc(NULL)
+    {
+    }
+
+FrameAnalysis::~FrameAnalysis()
+    {
+    delete m_lc;
+    }
+
+void FrameAnalysis::addAnalysis(PairAnalysis *analysis)
+    {
+    if (analysis == NULL)
+        throw invalid_argument("FrameAnalysis needs an analysis");
+    m_analyses.push_back(analysis);
+    }
+
+float FrameAnalysis::getRMax() const
+    {
+    float rmax = 0.0f;
+    for (unsigned int a = 0; a < m_analyses.size(); a++)
+        rmax = max(rmax, m_analyses[a]->getPairRMax());
+    return rmax;
+    }
+
+void FrameAnalysis::dispatch(unsigned int i, const std::vector<unsigned int>& j,
+                             const std::vector< vec3<float> >& delta, const std::vector<float>& rsq) const
+    {
+    NeighborBlock neighbors;
+    neighbors.num = j.size();
+    neighbors.j = j.empty() ? NULL : &j[0];
+    neighbors.delta = delta.empty() ? NULL : &delta[0];
+    neighbors.rsq = rsq.empty() ? NULL : &rsq[0];
+    for (unsigned int a = 0; a < m_analyses.size(); a++)
+        m_analyses[a]->processNeighbors(i, neighbors);
+    }
+
+void FrameAnalysis::compute(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                            const vec3<float> *points, unsigned int n_p, const NeighborList *nlist)
+    {
+    util::ScopedRange annotation("freud::FrameAnalysis::compute");
+    if (m_analyses.empty())
+        throw invalid_argument("FrameAnalysis has no analysis to compute");
+    m_profiler.reset();
+    const float rmax = getRMax();
+    const float rmaxsq = rmax*rmax;
+    if (rmax <= 0.0f)
+        throw invalid_argument("The analyses of a FrameAnalysis need a positive cutoff");
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+
+    for (unsigned int a = 0; a < m_analyses.size(); a++)
+        m_analyses[a]->beginFrame(box, ref_points, n_ref, points, n_p);
+
+    if (nlist != NULL)
+        {
+        util::ProfilePhase profile_phase(m_profiler, "pairs");
+        const unsigned int *index_j = nlist->getIndexJ().get();
+        const vec3<float> *vectors = nlist->getVectors().get();
+        parallel_for(blocked_range<size_t>(0, n_ref),
+            [=, &box] (const blocked_range<size_t>& r)
+            {
+            util::ScopedRange task_annotation("freud::FrameAnalysis::compute::bonds");
+            std::vector<unsigned int> neighbor_j;
+            std::vector< vec3<float> > neighbor_delta;
+            std::vector<float> neighbor_rsq;
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                neighbor_j.clear();
+                neighbor_delta.clear();
+                neighbor_rsq.clear();
+                for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                    {
+                    unsigned int j = index_j[bond];
+                    vec3<float> delta = (vectors != NULL) ? vectors[bond] : box.wrap(points[j] - ref_points[i]);
+                    neighbor_j.push_back(j);
+                    neighbor_delta.push_back(delta);
+                    neighbor_rsq.push_back(dot(delta, delta));
+                    }
+                dispatch(i, neighbor_j, neighbor_delta, neighbor_rsq);
+                }
+            });
+        }
+    else if (PeriodicImages::needed(box, rmax))
+        {
+        // no cell list reaches beyond half the box
+        util::ProfilePhase profile_phase(m_profiler, "images");
+        PeriodicImages images(box, rmax);
+        parallel_for(blocked_range<size_t>(0, n_ref),
+            [=, &images] (const blocked_range<size_t>& r)
+            {
+            util::ScopedRange task_annotation("freud::FrameAnalysis::compute::images");
+            std::vector<unsigned int> neighbor_j;
+            std::vector< vec3<float> > neighbor_delta;
+            std::vector<float> neighbor_rsq;
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                neighbor_j.clear();
+                neighbor_delta.clear();
+                neighbor_rsq.clear();
+                images.forEachNeighbor(ref_points[i], points, n_p,
+                    [&] (unsigned int j, const vec3<float>& delta, float rsq, bool zero_image)
+                    {
+                    neighbor_j.push_back(j);
+                    neighbor_delta.push_back(delta);
+                    neighbor_rsq.push_back(rsq);
+                    });
+                dispatch(i, neighbor_j, neighbor_delta, neighbor_rsq);
+                }
+            });
+        }
+    else
+        {
+        util::ProfilePhase cell_list_phase(m_profiler, "cell_list");
+        if (m_lc == NULL || m_lc->getCellWidth() != rmax)
+            {
+            delete m_lc;
+            m_lc = NULL;
+            m_lc = new LinkCell(box, rmax);
+            }
+        box::Box cell_box(box);
+        m_lc->computeCellList(cell_box, points, n_p, true);
+        cell_list_phase.stop();
+
+        util::ProfilePhase profile_phase(m_profiler, "pairs");
+        const LinkCell *lc = m_lc;
+        const vec3<float> *sorted_points = lc->getSortedPoints().get();
+        const unsigned int *cell_start = lc->getCellStart().get();
+        const unsigned int *cell_particles = lc->getCellParticles().get();
+
+        // consecutive reference points of a task share their neighbor cells
+        const unsigned int *order = NULL;
+        if (n_ref >= CELL_ORDER_MIN_POINTS)
+            order = m_work_partition.orderByCell(*lc, ref_points, n_ref, points, n_p);
+
+        parallel_for(blocked_range<size_t>(0, n_ref),
+            [=, &box] (const blocked_range<size_t>& r)
+            {
+            util::ScopedRange task_annotation("freud::FrameAnalysis::compute::cells");
+            DistanceKernel kernel(box);
+            util::ProfileCount tested, accepted;
+            std::vector<unsigned int> neighbor_j;
+            std::vector< vec3<float> > neighbor_delta;
+            std::vector<float> neighbor_rsq;
+            for (size_t pos = r.begin(); pos != r.end(); pos++)
+                {
+                size_t i = (order != NULL) ? order[pos] : pos;
+                neighbor_j.clear();
+                neighbor_delta.clear();
+                neighbor_rsq.clear();
+                vec3<float> ref = ref_points[i];
+                const CellNeighbors& neigh_cells = lc->getCellNeighbors(lc->getCell(ref));
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                    {
+                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+                    unsigned int begin = cell_start[neigh_cell];
+                    tested.add(cell_start[neigh_cell+1] - begin);
+                    kernel.forEachWithin(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin, rmaxsq,
+                        [&] (unsigned int k, const vec3<float>& delta, float rsq)
+                        {
+                        neighbor_j.push_back(cell_particles[begin + k]);
+                        neighbor_delta.push_back(delta);
+                        neighbor_rsq.push_back(rsq);
+                        });
+                    }
+                accepted.add(neighbor_j.size());
+                dispatch(i, neighbor_j, neighbor_delta, neighbor_rsq);
+                }
+            tested.addTo(m_profiler, "pairs_tested");
+            accepted.addTo(m_profiler, "pairs_accepted");
+            });
+        }
+
+    for (unsigned int a = 0; a < m_analyses.size(); a++)
+        m_analyses[a]->endFrame();
+    }
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,132 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <vector>
+#include <tbb/tbb.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "../box/box.h"
+#include "LinkCell.h"
+#include "NeighborList.h"
+#include "WorkPartition.h"
+#include "Profiler.h"
+
+#ifndef _FRAME_ANALYSIS_H__
+#define _FRAME_ANALYSIS_H__
+
+/*! \file FrameAnalysis.h
+    \brief One traversal of the neighbors of a frame shared by several analyses
+*/
+
+namespace freud { namespace locality {
+
+//! The neighbors of one reference point found by a FrameAnalysis
+/*! The three arrays hold num entries, in the order of the traversal: by cell of the cell list, or by bond of the
+    neighbor list. A reference point that is also a point is its own neighbor at distance zero, and with cutoffs
+    larger than half the box a point may appear once per periodic image.
+*/
+struct NeighborBlock
+    {
+    unsigned int num;               //!< Number of neighbors
+    const unsigned int *j;          //!< Index of each neighbor in the points
+    const vec3<float> *delta;       //!< Vector from the reference point to each neighbor
+    const float *rsq;               //!< Squared distance to each neighbor
+    };
+
+//! An analysis computed from the neighbors within a cutoff of each reference point
+/*! Each analysis of a FrameAnalysis states its cutoff, and gets the neighbors within the largest cutoff of all of
+    them, so it keeps those within its own cutoff. beginFrame() and endFrame() are called on the calling thread, and
+    processNeighbors() once per reference point, concurrently for distinct reference points: the state written by
+    processNeighbors() is either per reference point or per thread.
+*/
+class PairAnalysis
+    {
+    public:
+        virtual ~PairAnalysis()
+            {
+            }
+
+        //! Get the cutoff of the neighbors the analysis needs
+        virtual float getPairRMax() const = 0;
+
+        //! Prepare for the neighbors of a frame
+        virtual void beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                                const vec3<float> *points, unsigned int n_p) = 0;
+
+        //! Use the neighbors of reference point i
+        virtual void processNeighbors(unsigned int i, const NeighborBlock& neighbors) = 0;
+
+        //! Finish the frame once all the reference points are processed
+        virtual void endFrame() = 0;
+    };
+
+//! Computes several analyses of a frame from a single traversal of the neighbors
+/*! Running RDF, LocalDensity, LocalQl and Cluster one after the other builds a cell list and computes the distance
+    of every candidate pair once per analysis. A FrameAnalysis builds one cell list at the largest cutoff of its
+    analyses, finds the neighbors of each reference point once, and hands them to every analysis while they are in
+    cache. The analyses are not owned, and must outlive their use.
+
+    With a neighbor list, its bonds are the neighbors instead. Cutoffs larger than half the box are searched among
+    the explicit periodic images of the points (see PeriodicImages).
+*/
+class FrameAnalysis
+    {
+    public:
+        //! Constructor
+        FrameAnalysis();
+
+        //! Destructor
+        ~FrameAnalysis();
+
+        //! Add an analysis to compute on every frame
+        void addAnalysis(PairAnalysis *analysis);
+
+        //! Remove all the analyses
+        void clearAnalyses()
+            {
+            m_analyses.clear();
+            }
+
+        //! Get the number of analyses
+        unsigned int getNumAnalyses() const
+            {
+            return m_analyses.size();
+            }
+
+        //! Get the largest cutoff of the analyses
+        float getRMax() const;
+
+        //! Compute all the analyses of a frame
+        /*! If \a nlist is given, its bonds are used instead of building the internal cell list
+        */
+        void compute(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                     const vec3<float> *points, unsigned int n_p, const NeighborList *nlist=NULL);
+
+        //! Get the wall times of the phases and the counters of the last compute call, which are only recorded when
+        //! freud is built with ENABLE_PROFILING
+        /*! The phases are cell_list, pairs and images, the counters pairs_tested and pairs_accepted.
+        */
+        const util::Profiler& getProfiler() const
+            {
+            return m_profiler;
+            }
+
+    private:
+        FrameAnalysis(const FrameAnalysis&);
+        FrameAnalysis& operator=(const FrameAnalysis&);
+
+        //! Hand the neighbors of one reference point to every analysis
+        void dispatch(unsigned int i, const std::vector<unsigned int>& j, const std::vector< vec3<float> >& delta,
+                      const std::vector<float>& rsq) const;
+
+        std::vector<PairAnalysis*> m_analyses;      //!< Analyses computed on every frame
+        LinkCell *m_lc;                             //!< Cell list at the largest cutoff
+        WorkPartition m_work_partition;             //!< Cell order of the reference points
+        util::Profiler m_profiler;                  //!< Timings and counters of the last compute call
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _FRAME_ANALYSIS_H__
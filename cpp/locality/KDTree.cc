@@ -0,0 +1,268 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <string.h>
+#include <tbb/tbb.h>
+
+#include "KDTree.h"
+#include "PeriodicImages.h"
+#include "Annotation.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file KDTree.cc
+    \brief Build a k-d tree from a set of points
+*/
+
+namespace freud { namespace locality {
+
+KDTree::KDTree() : m_box(box::Box()), m_Np(0), m_max_radius(0)
+    {
+    }
+
+void KDTree::build(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    m_box = box;
+    m_Np = Np;
+
+    // periodic images of the query point to search, and the cutoff that keeps them from finding a point twice
+    uchar3 periodic = m_box.getPeriodic();
+    vec3<float> L = m_box.getNearestPlaneDistance();
+    int images_x = periodic.x ? 1 : 0;
+    int images_y = periodic.y ? 1 : 0;
+    int images_z = (periodic.z && !m_box.is2D()) ? 1 : 0;
+    m_max_radius = numeric_limits<float>::max();
+    if (images_x)
+        m_max_radius = min(m_max_radius, L.x/2.0f);
+    if (images_y)
+        m_max_radius = min(m_max_radius, L.y/2.0f);
+    if (images_z)
+        m_max_radius = min(m_max_radius, L.z/2.0f);
+
+    m_images.clear();
+    for (int k = -images_z; k <= images_z; k++)
+        for (int j = -images_y; j <= images_y; j++)
+            for (int i = -images_x; i <= images_x; i++)
+                {
+                vec3<float> shift = float(i)*m_box.getLatticeVector(0) + float(j)*m_box.getLatticeVector(1);
+                if (images_z)
+                    shift += float(k)*m_box.getLatticeVector(2);
+                m_images.push_back(shift);
+                }
+
+    m_indices.resize(Np);
+    m_sorted_points.resize(Np);
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        m_indices[i] = i;
+        m_sorted_points[i] = m_box.wrap(points[i]);
+        }
+
+    m_nodes.clear();
+    if (Np == 0)
+        return;
+    m_nodes.reserve(2*(Np/KDTREE_LEAF_SIZE + 1));
+    buildNode(0, Np);
+
+    // store the positions in tree order so that the points of a leaf are contiguous
+    vector< vec3<float> > wrapped(m_sorted_points);
+    for (unsigned int pos = 0; pos < Np; pos++)
+        {
+        m_sorted_points[pos] = wrapped[m_indices[pos]];
+        }
+    }
+
+unsigned int KDTree::buildNode(unsigned int begin, unsigned int end)
+    {
+    // m_sorted_points is still in the original order here and is indexed through m_indices
+    unsigned int node_idx = (unsigned int) m_nodes.size();
+    m_nodes.push_back(Node());
+
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    node.left = 0;
+    node.right = 0;
+    node.lo = node.hi = m_sorted_points[m_indices[begin]];
+    for (unsigned int pos = begin + 1; pos < end; pos++)
+        {
+        const vec3<float>& p = m_sorted_points[m_indices[pos]];
+        node.lo.x = min(node.lo.x, p.x); node.hi.x = max(node.hi.x, p.x);
+        node.lo.y = min(node.lo.y, p.y); node.hi.y = max(node.hi.y, p.y);
+        node.lo.z = min(node.lo.z, p.z); node.hi.z = max(node.hi.z, p.z);
+        }
+
+    if (end - begin > KDTREE_LEAF_SIZE)
+        {
+        // split at the median of the widest dimension
+        vec3<float> extent = node.hi - node.lo;
+        unsigned int axis = 0;
+        if (extent.y > extent.x)
+            axis = 1;
+        if (extent.z > ((axis == 0) ? extent.x : extent.y))
+            axis = 2;
+
+        const vec3<float> *points = &m_sorted_points[0];
+        unsigned int mid = begin + (end - begin)/2;
+        nth_element(m_indices.begin() + begin, m_indices.begin() + mid, m_indices.begin() + end,
+            [points, axis] (unsigned int a, unsigned int b)
+            {
+            if (axis == 0)
+                return points[a].x < points[b].x;
+            else if (axis == 1)
+                return points[a].y < points[b].y;
+            else
+                return points[a].z < points[b].z;
+            });
+
+        node.left = buildNode(begin, mid);
+        node.right = buildNode(mid, end);
+        }
+
+    m_nodes[node_idx] = node;
+    return node_idx;
+    }
+
+void KDTree::findNearest(const vec3<float>& p, unsigned int k, float rmax, unsigned int exclude,
+                         vector< pair<float, unsigned int> >& neighbors, float epsilon) const
+    {
+    // max-heap of the closest points found so far, ordered by distance and then by index
+    neighbors.clear();
+    if (m_Np == 0 || k == 0)
+        return;
+    const float rmaxsq = rmax * rmax;
+    // the bound of the nodes is shrunk by (1 + epsilon)^2 in the approximate search
+    const float shrink = 1.0f / ((1.0f + epsilon) * (1.0f + epsilon));
+    const vec3<float> q = m_box.wrap(p);
+    unsigned int stack[64];
+    for (unsigned int image = 0; image < m_images.size(); image++)
+        {
+        vec3<float> q_image = q + m_images[image];
+        unsigned int stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size > 0)
+            {
+            const Node& node = m_nodes[stack[--stack_size]];
+            float boundsq = (neighbors.size() == k) ? neighbors.front().first * shrink : rmaxsq;
+            if (distanceSquared(node, q_image) > boundsq)
+                continue;
+            if (node.left == 0)
+                {
+                for (unsigned int pos = node.begin; pos < node.end; pos++)
+                    {
+                    unsigned int j = m_indices[pos];
+                    if (j == exclude)
+                        continue;
+                    vec3<float> delta = m_sorted_points[pos] - q_image;
+                    pair<float, unsigned int> candidate(dot(delta, delta), j);
+                    if (candidate.first >= rmaxsq)
+                        continue;
+                    if (neighbors.size() < k)
+                        {
+                        neighbors.push_back(candidate);
+                        push_heap(neighbors.begin(), neighbors.end());
+                        }
+                    else if (candidate < neighbors.front())
+                        {
+                        pop_heap(neighbors.begin(), neighbors.end());
+                        neighbors.back() = candidate;
+                        push_heap(neighbors.begin(), neighbors.end());
+                        }
+                    }
+                }
+            else
+                {
+                // descend into the closer child first so that the bound shrinks early
+                unsigned int first = node.left;
+                unsigned int second = node.right;
+                if (distanceSquared(m_nodes[second], q_image) < distanceSquared(m_nodes[first], q_image))
+                    swap(first, second);
+                stack[stack_size++] = second;
+                stack[stack_size++] = first;
+                }
+            }
+        }
+    sort_heap(neighbors.begin(), neighbors.end());
+    }
+
+void KDTree::computeNlist(const box::Box& box,
+                          const vec3<float> *ref_points,
+                          unsigned int n_ref,
+                          const vec3<float> *points,
+                          unsigned int Np,
+                          float rmax,
+                          bool exclude_ii,
+                          bool store_vectors)
+    {
+    util::ScopedRange annotation("freud::KDTree::computeNlist");
+    build(box, points, Np);
+    if (rmax > m_max_radius)
+        {
+        // the cutoff reaches several images of the points, which the tree cannot tell apart
+        PeriodicImages images(box, rmax);
+        images.computeNlist(ref_points, n_ref, points, Np, exclude_ii, store_vectors, m_nlist);
+        return;
+        }
+
+    // count the bonds of each reference point first so that the list can be filled in parallel and in a
+    // deterministic order
+    std::shared_ptr<size_t> counts = std::shared_ptr<size_t>(new size_t[n_ref + 1], std::default_delete<size_t[]>());
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t num_neighbors = 0;
+            forEachInRadius(ref_points[i], rmax,
+                [&] (unsigned int j, const vec3<float>& delta, float rsq)
+                {
+                if (!(exclude_ii && i == j))
+                    num_neighbors++;
+                });
+            counts.get()[i] = num_neighbors;
+            }
+        });
+
+    size_t num_bonds = 0;
+    for (unsigned int i = 0; i < n_ref; i++)
+        {
+        size_t num_neighbors = counts.get()[i];
+        counts.get()[i] = num_bonds;
+        num_bonds += num_neighbors;
+        }
+    counts.get()[n_ref] = num_bonds;
+
+    m_nlist.resize(num_bonds, n_ref, Np, store_vectors);
+    memcpy((void*)m_nlist.getSegments().get(), (void*)counts.get(), sizeof(size_t)*(n_ref + 1));
+
+    unsigned int *index_i = m_nlist.getIndexI().get();
+    unsigned int *index_j = m_nlist.getIndexJ().get();
+    float *distances = m_nlist.getDistances().get();
+    vec3<float> *vectors = m_nlist.getVectors().get();
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t bond = counts.get()[i];
+            forEachInRadius(ref_points[i], rmax,
+                [&] (unsigned int j, const vec3<float>& delta, float rsq)
+                {
+                if (exclude_ii && i == j)
+                    return;
+                index_i[bond] = i;
+                index_j[bond] = j;
+                distances[bond] = sqrtf(rsq);
+                if (vectors != NULL)
+                    vectors[bond] = delta;
+                bond++;
+                });
+            }
+        });
+    }
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,169 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <utility>
+
+#include "../box/box.h"
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+#include "NeighborList.h"
+
+#ifndef _KDTREE_H__
+#define _KDTREE_H__
+
+/*! \file KDTree.h
+    \brief Build a k-d tree from a set of points
+*/
+
+namespace freud { namespace locality {
+
+//! Maximum number of points stored in a leaf of a KDTree
+const unsigned int KDTREE_LEAF_SIZE = 8;
+
+//! Spatial index over a set of points built as a k-d tree
+/*! A LinkCell splits the whole box into uniform cells, which works well for homogeneous systems but wastes time and
+    memory on empty cells for clustered systems, droplets in vacuum, or boxes that are nearly empty along one
+    direction. A KDTree instead recursively splits the points at the median of their widest dimension until at most
+    KDTREE_LEAF_SIZE points remain in a node, and every node stores the bounding box of its points. Queries descend
+    only into nodes whose bounding box intersects the search sphere, so their cost does not depend on the empty
+    regions of the box.
+
+    <b>Periodic boundaries:</b><br>
+    The points are wrapped into the box when the tree is built. A query searches the tree around every periodic image
+    of the query point that lies in the box or its direct neighbors (only along the periodic directions of the box,
+    and only in the plane for 2D boxes); images far from the points are rejected at the root. As with LinkCell, the
+    cutoff radius of the queries may not exceed half of the nearest plane distance along a periodic direction (see
+    getMaxRadius()), which guarantees that each point is found through at most one image and that the reported
+    vector is the minimum image vector. Non-periodic directions (see box::Box::setPeriodic) have no limit on the
+    cutoff. computeNlist() with a larger cutoff falls back to the search over explicit images of PeriodicImages.
+*/
+class KDTree
+    {
+    public:
+        //! Null constructor
+        KDTree();
+
+        //! Build the tree over a set of points
+        void build(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the number of points in the tree
+        unsigned int getNp() const
+            {
+            return m_Np;
+            }
+
+        //! Get the largest cutoff radius queries support in the current box
+        float getMaxRadius() const
+            {
+            return m_max_radius;
+            }
+
+        //! Visit every point closer than rmax to p
+        /*! \param p Query position
+            \param rmax Cutoff radius, no larger than getMaxRadius()
+            \param visit Callable invoked as visit(j, delta, rsq), where delta is the minimum image vector from p to
+                   point j and rsq its squared length
+        */
+        template<typename Visitor>
+        void forEachInRadius(const vec3<float>& p, float rmax, Visitor visit) const
+            {
+            if (m_Np == 0)
+                return;
+            const float rmaxsq = rmax * rmax;
+            const vec3<float> q = m_box.wrap(p);
+            unsigned int stack[64];
+            for (unsigned int image = 0; image < m_images.size(); image++)
+                {
+                vec3<float> q_image = q + m_images[image];
+                unsigned int stack_size = 0;
+                stack[stack_size++] = 0;
+                while (stack_size > 0)
+                    {
+                    const Node& node = m_nodes[stack[--stack_size]];
+                    if (distanceSquared(node, q_image) >= rmaxsq)
+                        continue;
+                    if (node.left == 0)
+                        {
+                        for (unsigned int pos = node.begin; pos < node.end; pos++)
+                            {
+                            vec3<float> delta = m_sorted_points[pos] - q_image;
+                            float rsq = dot(delta, delta);
+                            if (rsq < rmaxsq)
+                                visit(m_indices[pos], delta, rsq);
+                            }
+                        }
+                    else
+                        {
+                        stack[stack_size++] = node.right;
+                        stack[stack_size++] = node.left;
+                        }
+                    }
+                }
+            }
+
+        //! Find the k points closest to p that are closer than rmax
+        /*! With a positive epsilon the search is approximate: the nodes farther than the k-th point found so far
+            divided by 1 + epsilon are skipped, so that the n-th point returned is at most 1 + epsilon times as far
+            as the true n-th nearest point, for fewer nodes visited.
+        */
+        void findNearest(const vec3<float>& p, unsigned int k, float rmax, unsigned int exclude,
+                         std::vector< std::pair<float, unsigned int> >& neighbors, float epsilon=0.0f) const;
+
+        //! Compute the neighbor list of ref_points among points within the cutoff radius rmax
+        void computeNlist(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                          const vec3<float> *points, unsigned int Np, float rmax, bool exclude_ii,
+                          bool store_vectors);
+
+        //! Get the neighbor list last computed by computeNlist
+        NeighborList *getNlist()
+            {
+            return &m_nlist;
+            }
+
+    private:
+        //! A node of the tree covering the points [begin, end) of m_sorted_points
+        struct Node
+            {
+            vec3<float> lo;         //!< Lower corner of the bounding box of the points
+            vec3<float> hi;         //!< Upper corner of the bounding box of the points
+            unsigned int begin;     //!< First point of the node
+            unsigned int end;       //!< One past the last point of the node
+            unsigned int left;      //!< Index of the first child, 0 for a leaf
+            unsigned int right;     //!< Index of the second child, 0 for a leaf
+            };
+
+        //! Squared distance from q to the bounding box of a node (0 inside the box)
+        static float distanceSquared(const Node& node, const vec3<float>& q)
+            {
+            float dx = std::max(std::max(node.lo.x - q.x, q.x - node.hi.x), 0.0f);
+            float dy = std::max(std::max(node.lo.y - q.y, q.y - node.hi.y), 0.0f);
+            float dz = std::max(std::max(node.lo.z - q.z, q.z - node.hi.z), 0.0f);
+            return dx*dx + dy*dy + dz*dz;
+            }
+
+        //! Recursively build the node covering points [begin, end) and return its index
+        unsigned int buildNode(unsigned int begin, unsigned int end);
+
+        box::Box m_box;                                 //!< Simulation box the points belong in
+        unsigned int m_Np;                              //!< Number of points in the tree
+        float m_max_radius;                             //!< Largest supported cutoff radius
+        std::vector<Node> m_nodes;                      //!< Nodes of the tree, the root first
+        std::vector<unsigned int> m_indices;            //!< Point indices in tree order
+        std::vector< vec3<float> > m_sorted_points;     //!< Wrapped positions in tree order
+        std::vector< vec3<float> > m_images;            //!< Periodic image shifts searched by queries
+
+        NeighborList m_nlist;                           //!< Neighbor list last computed
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _KDTREE_H__
@@ -3,12 +3,22 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <string.h>
+#include <tbb/tbb.h>
 
 #include "LinkCell.h"
+#include "SpaceFillingCurve.h"
 #include "../box/box.h"
 #include "ScopedGILRelease.h"
+#include "Annotation.h"
+#include "AlignedArray.h"
 
 using namespace std;
+using namespace tbb;
 
 /*! \file LinkCell.cc
     \brief Build a cell list from a set of points
@@ -16,15 +26,72 @@ using namespace std;
 
 namespace freud { namespace locality {
 
+//! Below this number of particles the cell list is built serially, as the parallel build does not pay off
+const unsigned int PARALLEL_BUILD_MIN_PARTICLES = 32768;
+
+//! Number of cell dimensions whose neighbor stencils are kept around for reuse
+const unsigned int MAX_CACHED_STENCILS = 4;
+
+//! Cost of visiting one cell of a stencil, in distance computations, for chooseSubdivision
+const double CELL_VISIT_COST = 3.0;
+
+//! Largest number of entries of the full stencils of all cells for which a subdivision may be chosen
+const double MAX_STENCIL_ENTRIES = double(1 << 23);
+
+//! Largest number of entries of the full stencils of all cells that are stored rather than generated on each call
+const double MAX_STORED_STENCIL_ENTRIES = double(1 << 26);
+
+//! Number of cells of the stencil along a dimension of dim cells, subdivided n times
+static unsigned int stencilWidth(unsigned int dim, unsigned int n)
+    {
+    return std::min(dim, 2*n + 1);
+    }
+
+//! Throw if the cell width is larger than half the box along a periodic direction
+/*! Along the other directions the neighbor cells do not wrap around, so that any width works.
+*/
+//! Whether the cell at offset from cell c, of dim cells, exists without wrapping around a non periodic dimension
+static bool inOpenRange(int c, int offset, int dim, bool periodic)
+    {
+    return periodic || (c + offset >= 0 && c + offset < dim);
+    }
+
+static void checkCellWidth(const box::Box& box, float cell_width)
+    {
+    vec3<float> L = box.getNearestPlaneDistance();
+    uchar3 periodic = box.getPeriodic();
+    bool too_wide = (periodic.x && cell_width > L.x/2.0) || (periodic.y && cell_width > L.y/2.0);
+    if (!box.is2D())
+        {
+        too_wide |= periodic.z && cell_width > L.z/2.0;
+        }
+    if (too_wide)
+        {
+        throw runtime_error("Cannot generate a cell list where cell_width is larger than half the box.");
+        }
+    }
+
 // This is only used to initialize a pointer for the new triclinic setup
 // this shouldn't be needed any longer, but will be left for now
 // but until then, enjoy this mediocre hack
-LinkCell::LinkCell() : m_box(box::Box()), m_Np(0), m_cell_width(0)
+LinkCell::LinkCell() : m_box(box::Box()), m_Np(0), m_Nc(0), m_cell_capacity(0), m_cell_width(0), m_subdivision(1),
+    m_auto_subdivision(false), m_lazy_stencils(false), m_fit_open_boundaries(false), m_pow2_cells(false),
+    m_morton_cells(false), m_has_extent(false), m_frame_valid(false), m_frame_sorted(false), m_frame_key(0),
+    m_cell_rank(NULL)
     {
     m_celldim = vec3<unsigned int>(0,0,0);
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        m_frac_origin[d] = 0;
+        m_frac_scale[d] = 0;
+        }
     }
 
-LinkCell::LinkCell(const box::Box& box, float cell_width) : m_box(box), m_Np(0), m_cell_width(cell_width)
+LinkCell::LinkCell(const box::Box& box, float cell_width)
+    : m_box(box), m_Np(0), m_Nc(0), m_cell_capacity(0), m_cell_width(cell_width), m_subdivision(1),
+      m_auto_subdivision(false), m_lazy_stencils(false), m_fit_open_boundaries(false), m_pow2_cells(false),
+      m_morton_cells(false), m_has_extent(false), m_frame_valid(false), m_frame_sorted(false), m_frame_key(0),
+      m_cell_rank(NULL)
     {
     // check if the cell width is too wide for the box
     m_celldim  = computeDimensions(m_box, m_cell_width);
@@ -32,22 +99,14 @@ LinkCell::LinkCell(const box::Box& box, float cell_width) : m_box(box), m_Np(0),
     // will only check if the box is not null
     if (box != box::Box())
         {
-        vec3<float> L = m_box.getNearestPlaneDistance();
-        bool too_wide =  m_cell_width > L.x/2.0 || m_cell_width > L.y/2.0;
-        if (!m_box.is2D())
-            {
-            too_wide |=  m_cell_width > L.z/2.0;
-            }
-        if (too_wide)
-            {
-            throw runtime_error("Cannot generate a cell list where cell_width is larger than half the box.");
-            }
+        checkCellWidth(m_box, m_cell_width);
         //only 1 cell deep in 2D
         if (m_box.is2D())
             {
             m_celldim.z = 1;
             }
         }
+    updateOpenCells(m_box, m_cell_width, m_celldim);
     m_cell_index = Index3D(m_celldim.x, m_celldim.y, m_celldim.z);
     computeCellNeighbors();
     }
@@ -56,23 +115,16 @@ void LinkCell::setCellWidth(float cell_width)
     {
     if (cell_width != m_cell_width)
         {
-        vec3<float> L = m_box.getNearestPlaneDistance();
-        vec3<unsigned int> celldim  = computeDimensions(m_box, cell_width);
+        m_frame_valid = false;
+        vec3<unsigned int> celldim  = computeDimensions(m_box, cell_width / m_subdivision);
         //Check if box is too small!
-        bool too_wide =  cell_width > L.x/2.0 || cell_width > L.y/2.0;
-        if (!m_box.is2D())
-            {
-            too_wide |=  cell_width > L.z/2.0;
-            }
-        if (too_wide)
-            {
-            throw runtime_error("Cannot generate a cell list where cell_width is larger than half the box.");
-            }
+        checkCellWidth(m_box, cell_width);
         //only 1 cell deep in 2D
         if (m_box.is2D())
             {
             celldim.z = 1;
             }
+        updateOpenCells(m_box, cell_width / m_subdivision, celldim);
         // check if the dims changed
         if (!((celldim.x == m_celldim.x) && (celldim.y == m_celldim.y) && (celldim.z == m_celldim.z)))
             {
@@ -90,27 +142,25 @@ void LinkCell::setCellWidth(float cell_width)
 
 void LinkCell::updateBox(const box::Box& box)
     {
+    // the cells may change, so the cell list is that of no frame until it is computed again
+    m_frame_valid = false;
     // check if the cell width is too wide for the box
-    vec3<float> L = box.getNearestPlaneDistance();
-    vec3<unsigned int> celldim  = computeDimensions(box, m_cell_width);
+    vec3<unsigned int> celldim  = computeDimensions(box, m_cell_width / m_subdivision);
     //Check if box is too small!
-    bool too_wide =  m_cell_width > L.x/2.0 || m_cell_width > L.y/2.0;
-    if (!box.is2D())
-        {
-        too_wide |=  m_cell_width > L.z/2.0;
-        }
-    if (too_wide)
-        {
-        throw runtime_error("Cannot generate a cell list where cell_width is larger than half the box.");
-        }
+    checkCellWidth(box, m_cell_width);
     //only 1 cell deep in 2D
     if (box.is2D())
         {
         celldim.z = 1;
         }
+    updateOpenCells(box, m_cell_width / m_subdivision, celldim);
     // check if the box is changed
     m_box = box;
-    if (!((celldim.x == m_celldim.x) && (celldim.y == m_celldim.y) && (celldim.z == m_celldim.z)))
+    uchar3 periodic = box.getPeriodic();
+    if (!((celldim.x == m_celldim.x) && (celldim.y == m_celldim.y) && (celldim.z == m_celldim.z)) ||
+        !m_stencils || m_stencils->subdivision != m_subdivision || m_stencils->periodic[0] != bool(periodic.x) ||
+        m_stencils->periodic[1] != bool(periodic.y) || m_stencils->periodic[2] != (periodic.z || box.is2D()) ||
+        m_stencils->morton != m_morton_cells)
         {
         m_cell_index = Index3D(celldim.x, celldim.y, celldim.z);
         if (m_cell_index.getNumElements() < 1)
@@ -122,6 +172,196 @@ void LinkCell::updateBox(const box::Box& box)
         }
     }
 
+//! \internal
+//! Hash of point i at p; their sum over the points is the fingerprint of a frame, whatever the order of the sum
+static inline uint64_t pointKey(size_t i, const vec3<float>& p)
+    {
+    uint32_t bits[3];
+    memcpy(bits, &p.x, sizeof(float));
+    memcpy(bits + 1, &p.y, sizeof(float));
+    memcpy(bits + 2, &p.z, sizeof(float));
+    uint64_t h = uint64_t(i);
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        // splitmix64 finalizer
+        h ^= bits[d];
+        h += 0x9e3779b97f4a7c15ULL;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        }
+    return h;
+    }
+
+bool LinkCell::isComputedFor(const box::Box& box, const vec3<float> *points, unsigned int Np, bool sort_points) const
+    {
+    uchar3 periodic = box.getPeriodic(), last_periodic = m_box.getPeriodic();
+    if (!m_frame_valid || m_Np != Np || (sort_points && !m_frame_sorted) || m_box != box ||
+        m_box.is2D() != box.is2D() || periodic.x != last_periodic.x || periodic.y != last_periodic.y ||
+        periodic.z != last_periodic.z)
+        return false;
+    uint64_t key = parallel_reduce(blocked_range<size_t>(0, Np), uint64_t(0),
+        [=] (const blocked_range<size_t>& r, uint64_t key) -> uint64_t
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            key += pointKey(i, points[i]);
+        return key;
+        },
+        std::plus<uint64_t>());
+    return key == m_frame_key;
+    }
+
+void LinkCell::setSubdivision(unsigned int n)
+    {
+    if (n < 1 || n > MAX_CELL_SUBDIVISION)
+        throw invalid_argument("The subdivision of the cells must be between 1 and " +
+                               std::to_string(MAX_CELL_SUBDIVISION));
+    if (n != m_subdivision)
+        {
+        m_subdivision = n;
+        updateBox(m_box);
+        }
+    }
+
+void LinkCell::setPowerOfTwoCells(bool pow2)
+    {
+    if (pow2 != m_pow2_cells)
+        {
+        m_pow2_cells = pow2;
+        if (m_box != box::Box())
+            updateBox(m_box);
+        }
+    }
+
+void LinkCell::setMortonCells(bool morton)
+    {
+    if (morton != m_morton_cells)
+        {
+        // the particles of a computed cell list are sorted by the previous cell indices
+        m_frame_valid = false;
+        m_morton_cells = morton;
+        if (m_stencils)
+            computeCellNeighbors();
+        }
+    }
+
+void LinkCell::setLazyStencils(bool lazy)
+    {
+    if (lazy != m_lazy_stencils)
+        {
+        m_lazy_stencils = lazy;
+        if (m_stencils)
+            computeCellNeighbors();
+        }
+    }
+
+unsigned int LinkCell::chooseSubdivision(const box::Box& box, unsigned int Np) const
+    {
+    unsigned int best = 1;
+    double best_cost = 0.0;
+    for (unsigned int n = 1; n <= MAX_CELL_SUBDIVISION; n++)
+        {
+        vec3<unsigned int> dim = computeDimensions(box, m_cell_width / n);
+        if (box.is2D())
+            dim.z = 1;
+        double num_cells = double(dim.x)*dim.y*dim.z;
+        double stencil = double(stencilWidth(dim.x, n))*stencilWidth(dim.y, n)*stencilWidth(dim.z, n);
+        if (n > 1 && num_cells*stencil > MAX_STENCIL_ENTRIES)
+            break;
+        // per point: the points of the stencil cells, and the overhead of each of them
+        double cost = stencil*(double(Np)/num_cells + CELL_VISIT_COST);
+        if (n == 1 || cost < best_cost)
+            {
+            best = n;
+            best_cost = cost;
+            }
+        }
+    return best;
+    }
+
+unsigned int LinkCell::tuneSubdivision(box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    typedef std::chrono::steady_clock clock;
+    m_auto_subdivision = false;
+    const float rmaxsq = m_cell_width * m_cell_width;
+    unsigned int best = 1;
+    double best_time = 0.0;
+    for (unsigned int n = 1; n <= MAX_CELL_SUBDIVISION; n++)
+        {
+        vec3<unsigned int> dim = computeDimensions(box, m_cell_width / n);
+        if (box.is2D())
+            dim.z = 1;
+        double stencil = double(stencilWidth(dim.x, n))*stencilWidth(dim.y, n)*stencilWidth(dim.z, n);
+        if (n > 1 && double(dim.x)*dim.y*dim.z*stencil > MAX_STENCIL_ENTRIES)
+            break;
+        setSubdivision(n);
+        // the best of two trials, the first also building the stencils
+        double time = 0.0;
+        for (unsigned int trial = 0; trial < 2; trial++)
+            {
+            clock::time_point start = clock::now();
+            computeCellList(box, points, Np, true);
+            parallel_for(blocked_range<size_t>(0, getNumCells()),
+                [=] (const blocked_range<size_t>& r)
+                {
+                size_t num_pairs = 0;
+                for (size_t cell = r.begin(); cell != r.end(); cell++)
+                    forEachHalfPair(cell, points, rmaxsq,
+                        [&num_pairs] (unsigned int, unsigned int, const vec3<float>&, float) { num_pairs++; });
+                // keep the sweep from being optimized away
+                volatile size_t sink = num_pairs;
+                (void) sink;
+                });
+            double seconds = std::chrono::duration<double>(clock::now() - start).count();
+            if (trial == 0 || seconds < time)
+                time = seconds;
+            }
+        if (n == 1 || time < best_time)
+            {
+            best = n;
+            best_time = time;
+            }
+        }
+    setSubdivision(best);
+    computeCellList(box, points, Np, true);
+    return best;
+    }
+
+//! \internal
+/*! Along the non periodic directions, the cells span the extent of the last points when fitting to them, and the
+    box otherwise; celldim is changed to the number of cells of cell_width that fit in the extent.
+*/
+void LinkCell::updateOpenCells(const box::Box& box, float cell_width, vec3<unsigned int>& celldim)
+    {
+    uchar3 periodic = box.getPeriodic();
+    vec3<float> L = box.getNearestPlaneDistance();
+    const bool is_periodic[3] = {periodic.x != 0, periodic.y != 0, periodic.z != 0 || box.is2D()};
+    const float lengths[3] = {L.x, L.y, L.z};
+    const float lo[3] = {m_frac_lo.x, m_frac_lo.y, m_frac_lo.z};
+    const float hi[3] = {m_frac_hi.x, m_frac_hi.y, m_frac_hi.z};
+    unsigned int *dims[3] = {&celldim.x, &celldim.y, &celldim.z};
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        m_frac_origin[d] = 0;
+        m_frac_scale[d] = float(*dims[d]);
+        if (is_periodic[d] || !m_fit_open_boundaries || !m_has_extent)
+            continue;
+        float span = hi[d] - lo[d];
+        *dims[d] = std::max((unsigned int)(span*lengths[d]/cell_width), 1u);
+        m_frac_origin[d] = lo[d];
+        m_frac_scale[d] = (span > 0) ? float(*dims[d])/span : 0.0f;
+        }
+    }
+
+//! The largest power of two no larger than v, or 1
+static unsigned int roundDownPowerOfTwo(unsigned int v)
+    {
+    unsigned int p = 1;
+    while (p <= v/2)
+        p *= 2;
+    return p;
+    }
+
 unsigned int LinkCell::roundDown(unsigned int v, unsigned int m)
     {
     // use integer floor division
@@ -158,6 +398,12 @@ const vec3<unsigned int> LinkCell::computeDimensions(const box::Box& box, float
         dim.y = 1;
     if (dim.z == 0)
         dim.z = 1;
+    if (m_pow2_cells)
+        {
+        dim.x = roundDownPowerOfTwo(dim.x);
+        dim.y = roundDownPowerOfTwo(dim.y);
+        dim.z = roundDownPowerOfTwo(dim.z);
+        }
     return dim;
     }
 
@@ -187,21 +433,75 @@ void LinkCell::computeCellList(box::Box& box,
                                const float3 *points,
                                unsigned int Np)
     {
-        //Copy into appropriate vec3<float>;
-        vec3<float>* pointscopy = new vec3<float>[Np];
-        for(unsigned int i = 0; i < Np; i++) {
-            pointscopy[i].x=points[i].x;
-            pointscopy[i].y=points[i].y;
-            pointscopy[i].z=points[i].z;
-        }
-        computeCellList(box, pointscopy, Np);
-        delete[] pointscopy;
+    // float3 and vec3<float> are both three packed floats, so the points are read in place instead of copied
+    static_assert(sizeof(float3) == sizeof(vec3<float>), "float3 and vec3<float> must have the same layout");
+    computeCellList(box, reinterpret_cast<const vec3<float>*>(points), Np);
     }
 
 void LinkCell::computeCellList(box::Box& box,
                                const vec3<float> *points,
-                               unsigned int Np)
+                               unsigned int Np,
+                               bool sort_points)
+    {
+    assert(points);
+    buildCellList(box, points, Np, sort_points);
+    }
+
+/*! The cell list is the same as that of the interleaved points, and so is the sorted copy of the points, which is
+    gathered from the three arrays directly.
+*/
+void LinkCell::computeCellList(box::Box& box,
+                               const float *x,
+                               const float *y,
+                               const float *z,
+                               unsigned int Np,
+                               bool sort_points)
+    {
+    assert(x && y && z);
+    buildCellList(box, util::SoAPoints(x, y, z), Np, sort_points);
+    }
+
+//! \internal
+/*! Points is an array of vec3<float> or util::SoAPoints: all that is used is points[i]
+*/
+template<class Points>
+void LinkCell::buildCellList(box::Box& box, const Points& points, unsigned int Np, bool sort_points)
     {
+    util::ScopedRange annotation("freud::LinkCell::computeCellList");
+    if (m_auto_subdivision)
+        m_subdivision = chooseSubdivision(box, Np);
+    uchar3 periodic = box.getPeriodic();
+    m_has_extent = false;
+    if (m_fit_open_boundaries && Np > 0 && !(periodic.x && periodic.y && (periodic.z || box.is2D())))
+        {
+        // the extent of the points in fractional coordinates, which the cells span along the open directions
+        typedef std::pair< vec3<float>, vec3<float> > Extent;
+        const float inf = std::numeric_limits<float>::infinity();
+        Extent empty(vec3<float>(inf, inf, inf), vec3<float>(-inf, -inf, -inf));
+        Extent extent = parallel_reduce(blocked_range<size_t>(0, Np), empty,
+            [&] (const blocked_range<size_t>& r, Extent e) -> Extent
+            {
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                vec3<float> alpha = box.makeFraction(points[i]);
+                e.first = vec3<float>(std::min(e.first.x, alpha.x), std::min(e.first.y, alpha.y),
+                                      std::min(e.first.z, alpha.z));
+                e.second = vec3<float>(std::max(e.second.x, alpha.x), std::max(e.second.y, alpha.y),
+                                       std::max(e.second.z, alpha.z));
+                }
+            return e;
+            },
+            [] (const Extent& a, const Extent& b) -> Extent
+            {
+            return Extent(vec3<float>(std::min(a.first.x, b.first.x), std::min(a.first.y, b.first.y),
+                                      std::min(a.first.z, b.first.z)),
+                          vec3<float>(std::max(a.second.x, b.second.x), std::max(a.second.y, b.second.y),
+                                      std::max(a.second.z, b.second.z)));
+            });
+        m_frac_lo = extent.first;
+        m_frac_hi = extent.second;
+        m_has_extent = true;
+        }
     updateBox(box);
     if (Np == 0)
         {
@@ -211,117 +511,484 @@ void LinkCell::computeCellList(box::Box& box,
     // determine the number of cells and allocate memory
     unsigned int Nc = getNumCells();
     assert(Nc > 0);
-    if ((m_Np != Np) || (m_Nc != Nc))
+    // the cell starts only grow, so that a box fluctuating around a cell count boundary does not reallocate
+    if ((Nc > m_cell_capacity) || !m_cell_start)
         {
-        m_cell_list = std::shared_ptr<unsigned int>(new unsigned int[Np + Nc], std::default_delete<unsigned int[]>());
+        m_cell_start = util::makeLargeArray<unsigned int>(Nc + 1);
+        m_cell_capacity = Nc;
+        }
+    if ((m_Np != Np) || !m_cell_particles)
+        {
+        m_cell_particles = util::makeLargeArray<unsigned int>(Np);
+        m_particle_cells = util::makeLargeArray<unsigned int>(Np);
+        m_sorted_points.reset();
+        }
+    if (sort_points && (!m_sorted_points || m_Np != Np))
+        {
+        m_sorted_points = util::makeLargeArray< vec3<float> >(Np);
+        }
+    else if (!sort_points)
+        {
+        m_sorted_points.reset();
         }
     m_Np = Np;
     m_Nc = Nc;
+    m_profiler.reset();
+    m_profiler.addCount("points", Np);
+    m_profiler.addCount("cells", Nc);
 
-    // initialize memory
-    for (unsigned int cell = 0; cell < Nc; cell++)
+    // generate the cell list
+    // find the cell of each particle
+    util::ProfilePhase find_phase(m_profiler, "find_cells");
+    unsigned int *particle_cells = m_particle_cells.get();
+    // the fingerprint of the points is taken in the same pass, while they are loaded anyway
+    m_frame_key = parallel_reduce(blocked_range<size_t>(0, Np), uint64_t(0),
+        [=] (const blocked_range<size_t>& r, uint64_t key) -> uint64_t
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            vec3<float> p = points[i];
+            particle_cells[i] = getCell(p);
+            key += pointKey(i, p);
+            }
+        return key;
+        },
+        std::plus<uint64_t>());
+    m_frame_valid = true;
+    m_frame_sorted = sort_points;
+    find_phase.stop();
+    util::ProfilePhase sort_phase(m_profiler, "sort");
+
+    unsigned int *cell_start = m_cell_start.get();
+    unsigned int *cell_particles = m_cell_particles.get();
+    vec3<float> *sorted_points = sort_points ? m_sorted_points.get() : NULL;
+
+    if (Np < PARALLEL_BUILD_MIN_PARTICLES)
         {
-        m_cell_list.get()[Np + cell] = LINK_CELL_TERMINATOR;
+        // counting sort: histogram the cells, prefix sum into the cell starts, then scatter the particles in index
+        // order so that the particles of each cell remain sorted by index
+        memset((void*)cell_start, 0, sizeof(unsigned int)*(Nc + 1));
+        for (unsigned int i = 0; i < Np; i++)
+            {
+            cell_start[particle_cells[i] + 1]++;
+            }
+        for (unsigned int cell = 0; cell < Nc; cell++)
+            {
+            cell_start[cell + 1] += cell_start[cell];
+            }
+
+        std::vector<unsigned int> fill(cell_start, cell_start + Nc);
+        for (unsigned int i = 0; i < Np; i++)
+            {
+            unsigned int pos = fill[particle_cells[i]]++;
+            cell_particles[pos] = i;
+            if (sorted_points != NULL)
+                sorted_points[pos] = points[i];
+            }
+        return;
         }
 
-    // generate the cell list
-    assert(points);
+    // parallel counting sort: histogram the cells with atomic counters, prefix sum into the cell starts and scatter
+    // the particles in parallel. The scatter order within a cell is arbitrary, so each cell is sorted afterwards to
+    // give exactly the same result as the serial build.
+    std::vector< tbb::atomic<unsigned int> > fill(Nc);
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=, &fill] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            fill[particle_cells[i]].fetch_and_increment();
+        });
 
-    for (int i = Np-1; i >= 0; i--)
+    cell_start[0] = 0;
+    for (unsigned int cell = 0; cell < Nc; cell++)
         {
-        unsigned int cell = getCell(points[i]);
-        m_cell_list.get()[i] = m_cell_list.get()[Np+cell];
-        m_cell_list.get()[Np+cell] = i;
+        cell_start[cell + 1] = cell_start[cell] + fill[cell];
+        fill[cell] = cell_start[cell];
         }
+
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=, &fill] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            cell_particles[fill[particle_cells[i]].fetch_and_increment()] = i;
+        });
+
+    parallel_for(blocked_range<size_t>(0, Nc),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t cell = r.begin(); cell != r.end(); cell++)
+            {
+            std::sort(cell_particles + cell_start[cell], cell_particles + cell_start[cell + 1]);
+            if (sorted_points != NULL)
+                {
+                for (unsigned int pos = cell_start[cell]; pos < cell_start[cell + 1]; pos++)
+                    sorted_points[pos] = points[cell_particles[pos]];
+                }
+            }
+        });
     }
 
-void LinkCell::computeCellNeighbors()
+void LinkCell::computeNlist(box::Box& box,
+                            const vec3<float> *ref_points,
+                            unsigned int n_ref,
+                            const vec3<float> *points,
+                            unsigned int Np,
+                            bool exclude_ii,
+                            bool store_vectors)
     {
-    // clear the list
-    m_cell_neighbors.clear();
-    m_cell_neighbors.resize(getNumCells());
-
-    // for each cell
-    for (unsigned int k = 0; k < m_cell_index.getD(); k++)
-        for (unsigned int j = 0; j < m_cell_index.getH(); j++)
-            for (unsigned int i = 0; i < m_cell_index.getW(); i++)
+    util::ScopedRange annotation("freud::LinkCell::computeNlist");
+    computeCellList(box, points, Np);
+    util::ProfilePhase nlist_phase(m_profiler, "nlist");
+
+    const float rmaxsq = m_cell_width * m_cell_width;
+
+    // count the bonds of each reference point first so that the list can be filled in parallel and in a
+    // deterministic order: bonds are sorted by i, then by neighbor cell, then by j within a cell
+    util::ScratchArena::Frame scratch(m_scratch);
+    size_t *counts = scratch.allocate<size_t>(n_ref + 1);
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        util::ProfileCount tested;
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t num_neighbors = 0;
+            vec3<float> ref = ref_points[i];
+            const CellNeighbors& neigh_cells = getCellNeighbors(getCell(ref));
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                 {
-                // clear the list
-                unsigned int cur_cell = m_cell_index(i,j,k);
-                m_cell_neighbors[cur_cell].clear();
-
-                // loop over the neighbor cells
-                int starti, startj, startk;
-                int endi, endj, endk;
-                if (m_celldim.x < 3)
+                iteratorcell it = itercell(neigh_cells[neigh_idx]);
+                for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
                     {
-                    starti = (int)i;
-                    }
-                else
-                    {
-                    starti = (int)i - 1;
-                    }
-                if (m_celldim.y < 3)
-                    {
-                    startj = (int)j;
-                    }
-                else
-                    {
-                    startj = (int)j - 1;
-                    }
-                if (m_celldim.z < 3)
-                    {
-                    startk = (int)k;
-                    }
-                else
-                    {
-                    startk = (int)k - 1;
+                    if (exclude_ii && i == j)
+                        continue;
+                    tested.add(1);
+                    vec3<float> delta = m_box.wrap(points[j] - ref);
+                    if (dot(delta, delta) < rmaxsq)
+                        num_neighbors++;
                     }
+                }
+            counts[i] = num_neighbors;
+            }
+        tested.addTo(m_profiler, "pairs_tested");
+        });
 
-                if (m_celldim.x < 2)
-                    {
-                    endi = (int)i;
-                    }
-                else
-                    {
-                    endi = (int)i + 1;
-                    }
-                if (m_celldim.y < 2)
-                    {
-                    endj = (int)j;
-                    }
-                else
-                    {
-                    endj = (int)j + 1;
-                    }
-                if (m_celldim.z < 2)
+    size_t num_bonds = 0;
+    for (unsigned int i = 0; i < n_ref; i++)
+        {
+        size_t num_neighbors = counts[i];
+        counts[i] = num_bonds;
+        num_bonds += num_neighbors;
+        }
+    counts[n_ref] = num_bonds;
+    m_profiler.addCount("bonds", num_bonds);
+
+    m_nlist.resize(num_bonds, n_ref, Np, store_vectors);
+    memcpy((void*)m_nlist.getSegments().get(), (void*)counts, sizeof(size_t)*(n_ref + 1));
+
+    unsigned int *index_i = m_nlist.getIndexI().get();
+    unsigned int *index_j = m_nlist.getIndexJ().get();
+    float *distances = m_nlist.getDistances().get();
+    vec3<float> *vectors = m_nlist.getVectors().get();
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t bond = counts[i];
+            vec3<float> ref = ref_points[i];
+            const CellNeighbors& neigh_cells = getCellNeighbors(getCell(ref));
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                {
+                iteratorcell it = itercell(neigh_cells[neigh_idx]);
+                for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
                     {
-                    endk = (int)k;
+                    if (exclude_ii && i == j)
+                        continue;
+                    vec3<float> delta = m_box.wrap(points[j] - ref);
+                    float rsq = dot(delta, delta);
+                    if (rsq < rmaxsq)
+                        {
+                        index_i[bond] = i;
+                        index_j[bond] = j;
+                        distances[bond] = sqrtf(rsq);
+                        if (vectors != NULL)
+                            vectors[bond] = delta;
+                        bond++;
+                        }
                     }
-                else
+                }
+            }
+        });
+    }
+
+unsigned int LinkCell::countNeighborsOf(const DistanceKernel& kernel, const vec3<float>& ref, unsigned int i,
+                                        const vec3<float> *points, unsigned int Np, bool exclude_ii,
+                                        unsigned int limit) const
+    {
+    const float rmaxsq = m_cell_width * m_cell_width;
+    const unsigned int *cell_start = m_cell_start.get();
+    const vec3<float> *sorted_points = m_sorted_points.get();
+
+    // point i is among the hits when it is within the cutoff, and is then taken off the count
+    unsigned int self = 0;
+    if (exclude_ii && i < Np)
+        {
+        vec3<float> delta = m_box.wrap(points[i] - ref);
+        self = dot(delta, delta) < rmaxsq;
+        }
+    limit = (limit > 0xffffffff - self) ? limit : limit + self;
+
+    unsigned int count = 0;
+    const CellNeighbors& neigh_cells = getCellNeighbors(getCell(ref));
+    for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size() && count < limit; neigh_idx++)
+        {
+        unsigned int neigh_cell = neigh_cells[neigh_idx];
+        unsigned int begin = cell_start[neigh_cell];
+        count += kernel.countWithin(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin, rmaxsq,
+                                    limit - count);
+        }
+    return count - self;
+    }
+
+void LinkCell::countNeighbors(box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                              const vec3<float> *points, unsigned int Np, bool exclude_ii, unsigned int *counts)
+    {
+    util::ScopedRange annotation("freud::LinkCell::countNeighbors");
+    computeCellList(box, points, Np, true);
+    util::ProfilePhase count_phase(m_profiler, "count");
+    DistanceKernel kernel(m_box);
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=, &kernel] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            counts[i] = countNeighborsOf(kernel, ref_points[i], i, points, Np, exclude_ii, 0xffffffff);
+        });
+    }
+
+unsigned int LinkCell::findAnyNeighbor(box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                                       const vec3<float> *points, unsigned int Np, bool exclude_ii, bool *mask)
+    {
+    util::ScopedRange annotation("freud::LinkCell::findAnyNeighbor");
+    computeCellList(box, points, Np, true);
+    util::ProfilePhase count_phase(m_profiler, "count");
+    DistanceKernel kernel(m_box);
+    return parallel_reduce(blocked_range<size_t>(0, n_ref), 0u,
+        [=, &kernel] (const blocked_range<size_t>& r, unsigned int num_found)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            mask[i] = countNeighborsOf(kernel, ref_points[i], i, points, Np, exclude_ii, 1) > 0;
+            num_found += mask[i];
+            }
+        return num_found;
+        },
+        [] (unsigned int a, unsigned int b)
+        {
+        return a + b;
+        });
+    }
+
+void LinkCell::computeCellNeighbors()
+    {
+    // the offsets of the neighbor cells along each dimension: up to n cells each way, or every cell when there are
+    // no more than 2n of them, so that no cell is listed twice; along the non periodic dimensions the offsets do not
+    // wrap around, and those that leave the cells are skipped instead
+    const int n = (int) m_subdivision;
+    const unsigned int dims[3] = {m_cell_index.getW(), m_cell_index.getH(), m_cell_index.getD()};
+    uchar3 box_periodic = m_box.getPeriodic();
+    const bool periodic[3] = {box_periodic.x != 0, box_periodic.y != 0, box_periodic.z != 0 || m_box.is2D()};
+    std::vector<int> offsets[3];
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        if (d == 2 && m_box.is2D())
+            offsets[d].push_back(0);
+        else if (periodic[d] && dims[d] <= 2*m_subdivision)
+            for (int offset = 0; offset < (int) dims[d]; offset++)
+                offsets[d].push_back(offset);
+        else
+            for (int offset = -n; offset <= n; offset++)
+                offsets[d].push_back(offset);
+        }
+    const unsigned int stencil_size = offsets[0].size()*offsets[1].size()*offsets[2].size();
+    const bool lazy = m_lazy_stencils || double(getNumCells())*stencil_size > MAX_STORED_STENCIL_ENTRIES;
+
+    // the stencils only depend on the cell dimensions, the periodicity and the subdivision, so reuse them when they
+    // were seen before; in NPT trajectories the box breathes and the number of cells flips between a few neighboring
+    // values
+    for (unsigned int idx = 0; idx < m_stencil_cache.size(); idx++)
+        {
+        const vec3<unsigned int>& dim = m_stencil_cache[idx]->dim;
+        const bool *cached_periodic = m_stencil_cache[idx]->periodic;
+        if (dim.x == m_celldim.x && dim.y == m_celldim.y && dim.z == m_celldim.z &&
+            m_stencil_cache[idx]->subdivision == m_subdivision && m_stencil_cache[idx]->lazy == lazy &&
+            m_stencil_cache[idx]->morton == m_morton_cells && cached_periodic[0] == periodic[0] &&
+            cached_periodic[1] == periodic[1] && cached_periodic[2] == periodic[2])
+            {
+            m_stencils = m_stencil_cache[idx];
+            m_cell_rank = m_stencils->morton ? m_stencils->rank.data() : NULL;
+            return;
+            }
+        }
+
+    std::shared_ptr<CellStencils> stencils(new CellStencils());
+    stencils->dim = m_celldim;
+    stencils->subdivision = m_subdivision;
+    stencils->lazy = lazy;
+    stencils->morton = m_morton_cells;
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        stencils->periodic[d] = periodic[d];
+        stencils->offsets[d] = offsets[d];
+        }
+
+    // in Morton order, the cells are the ranks of the Morton keys of their coordinates, so that the indices are
+    // dense whatever the number of cells along each dimension
+    if (m_morton_cells)
+        {
+        const unsigned int num_cells = getNumCells();
+        std::vector<uint64_t> keys(num_cells);
+        for (unsigned int c = 0; c < num_cells; c++)
+            {
+            vec3<unsigned int> coord = m_cell_index(c);
+            keys[c] = mortonKey3(coord.x, coord.y, coord.z);
+            }
+        stencils->order.resize(num_cells);
+        for (unsigned int c = 0; c < num_cells; c++)
+            stencils->order[c] = c;
+        sort(stencils->order.begin(), stencils->order.end(),
+             [&keys] (unsigned int a, unsigned int b) { return keys[a] < keys[b]; });
+        stencils->rank.resize(num_cells);
+        for (unsigned int c = 0; c < num_cells; c++)
+            stencils->rank[stencils->order[c]] = c;
+        }
+    const unsigned int *rank = stencils->morton ? stencils->rank.data() : NULL;
+
+    // lazy stencils are generated from the offsets by getCellNeighbors
+    if (!lazy)
+        {
+        std::vector< std::vector<unsigned int> >& cell_neighbors = stencils->full;
+        std::vector< std::vector<unsigned int> >& cell_neighbors_half = stencils->half;
+        cell_neighbors.resize(getNumCells());
+
+        // for each cell
+        for (unsigned int k = 0; k < m_cell_index.getD(); k++)
+            for (unsigned int j = 0; j < m_cell_index.getH(); j++)
+                for (unsigned int i = 0; i < m_cell_index.getW(); i++)
                     {
-                    endk = (int)k + 1;
+                    unsigned int cur_cell = m_cell_index(i,j,k);
+                    if (rank != NULL)
+                        cur_cell = rank[cur_cell];
+                    cell_neighbors[cur_cell].reserve(stencil_size);
+
+                    // loop over the neighbor cells
+                    for (unsigned int ok = 0; ok < offsets[2].size(); ok++)
+                        for (unsigned int oj = 0; oj < offsets[1].size(); oj++)
+                            for (unsigned int oi = 0; oi < offsets[0].size(); oi++)
+                                {
+                                // wrap back into the box
+                                int wrapi = ((int)i + offsets[0][oi] + (int)dims[0]) % (int)dims[0];
+                                int wrapj = ((int)j + offsets[1][oj] + (int)dims[1]) % (int)dims[1];
+                                int wrapk = ((int)k + offsets[2][ok] + (int)dims[2]) % (int)dims[2];
+                                if (!inOpenRange(i, offsets[0][oi], dims[0], periodic[0]) ||
+                                    !inOpenRange(j, offsets[1][oj], dims[1], periodic[1]) ||
+                                    !inOpenRange(k, offsets[2][ok], dims[2], periodic[2]))
+                                    continue;
+
+                                unsigned int neigh_cell = m_cell_index(wrapi, wrapj, wrapk);
+                                if (rank != NULL)
+                                    neigh_cell = rank[neigh_cell];
+                                // add to the list
+                                cell_neighbors[cur_cell].push_back(neigh_cell);
+                                }
+
+                    // sort the list
+                    sort(cell_neighbors[cur_cell].begin(), cell_neighbors[cur_cell].end());
                     }
-                if (m_box.is2D())
-                    startk = endk = k;
-
-                for (int neighk = startk; neighk <= endk; neighk++)
-                    for (int neighj = startj; neighj <= endj; neighj++)
-                        for (int neighi = starti; neighi <= endi; neighi++)
-                            {
-                            // wrap back into the box
-                            int wrapi = (m_cell_index.getW()+neighi) % m_cell_index.getW();
-                            int wrapj = (m_cell_index.getH()+neighj) % m_cell_index.getH();
-                            int wrapk = (m_cell_index.getD()+neighk) % m_cell_index.getD();
-
-                            unsigned int neigh_cell = m_cell_index(wrapi, wrapj, wrapk);
-                            // add to the list
-                            m_cell_neighbors[cur_cell].push_back(neigh_cell);
-                            }
-
-                // sort the list
-                sort(m_cell_neighbors[cur_cell].begin(), m_cell_neighbors[cur_cell].end());
+
+        // the half stencil of each cell keeps only the neighbors with a larger index, so that every unordered pair
+        // of neighboring cells appears in exactly one of the two lists; selecting on the wrapped index rather than on
+        // the (i,j,k) offsets stays correct when fewer than 3 cells along a dimension make +1 and -1 the same cell
+        cell_neighbors_half.resize(getNumCells());
+        for (unsigned int cell = 0; cell < getNumCells(); cell++)
+            {
+            const std::vector<unsigned int>& neigh_cells = cell_neighbors[cell];
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                {
+                if (neigh_cells[neigh_idx] > cell)
+                    cell_neighbors_half[cell].push_back(neigh_cells[neigh_idx]);
+                }
+            }
+        }
+
+    if (m_stencil_cache.size() >= MAX_CACHED_STENCILS)
+        m_stencil_cache.erase(m_stencil_cache.begin());
+    m_stencil_cache.push_back(stencils);
+    m_stencils = stencils;
+    m_cell_rank = rank;
+    }
+
+//! \internal
+/*! \brief The stencil computeCellNeighbors() stores for a cell, computed from the coordinates of the cell
+*/
+template<bool pow2>
+void LinkCell::generateCellNeighborsWith(unsigned int cell, bool half, CellNeighbors& neighbors) const
+    {
+    const std::vector<int> *offsets = m_stencils->offsets;
+    const bool *periodic = m_stencils->periodic;
+    const int dims[3] = {(int) m_cell_index.getW(), (int) m_cell_index.getH(), (int) m_cell_index.getD()};
+    // in Morton order, the cells are mapped to and from their row major indices by the tables of the stencils
+    const unsigned int *rank = m_cell_rank;
+    const unsigned int flat = (rank != NULL) ? m_stencils->order[cell] : cell;
+    const vec3<unsigned int> c = pow2 ? m_cell_index.unravelPow2(flat) : m_cell_index(flat);
+    const int i = c.x;
+    const int j = c.y;
+    const int k = c.z;
+    // the offsets are at least -dims, so that adding dims keeps the modulo of non negative values
+    auto wrap = [] (int v, int dim) -> unsigned int
+        {
+        return pow2 ? (unsigned int)(v & (dim - 1)) : (unsigned int)((v + dim) % dim);
+        };
+
+    unsigned int *cells = neighbors.m_local;
+    unsigned int size = 0;
+    for (unsigned int ok = 0; ok < offsets[2].size(); ok++)
+        {
+        if (!inOpenRange(k, offsets[2][ok], dims[2], periodic[2]))
+            continue;
+        unsigned int wrapk = wrap(k + offsets[2][ok], dims[2]);
+        for (unsigned int oj = 0; oj < offsets[1].size(); oj++)
+            {
+            if (!inOpenRange(j, offsets[1][oj], dims[1], periodic[1]))
+                continue;
+            unsigned int wrapj = wrap(j + offsets[1][oj], dims[1]);
+            for (unsigned int oi = 0; oi < offsets[0].size(); oi++)
+                {
+                if (!inOpenRange(i, offsets[0][oi], dims[0], periodic[0]))
+                    continue;
+                unsigned int wrapi = wrap(i + offsets[0][oi], dims[0]);
+                unsigned int neigh_cell = pow2 ? m_cell_index.indexPow2(wrapi, wrapj, wrapk) :
+                                                 m_cell_index(wrapi, wrapj, wrapk);
+                if (rank != NULL)
+                    neigh_cell = rank[neigh_cell];
+                if (!half || neigh_cell > cell)
+                    cells[size++] = neigh_cell;
                 }
+            }
+        }
+    std::sort(cells, cells + size);
+    neighbors.m_cells = NULL;
+    neighbors.m_size = size;
+    }
+
+void LinkCell::generateCellNeighbors(unsigned int cell, bool half, CellNeighbors& neighbors) const
+    {
+    // with power of two dimensions, the cell is unraveled and its neighbors wrapped with shifts and masks
+    const unsigned int depth = m_cell_index.getD();
+    if (m_cell_index.isPowerOfTwo() && (depth & (depth - 1)) == 0)
+        generateCellNeighborsWith<true>(cell, half, neighbors);
+    else
+        generateCellNeighborsWith<false>(cell, half, neighbors);
     }
 
 // void export_LinkCell()
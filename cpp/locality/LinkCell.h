@@ -1,12 +1,19 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <memory>
+#include <stdint.h>
 #include <vector>
 
 #include "../box/box.h"
 #include "HOOMDMath.h"
 #include "Index1D.h"
+#include "NeighborList.h"
+#include "DistanceKernel.h"
+#include "SoAPoints.h"
+#include "Profiler.h"
+#include "ComputeArena.h"
 
 #ifndef _LINKCELL_H__
 #define _LINKCELL_H__
@@ -18,17 +25,59 @@
 namespace freud { namespace locality {
 
 /*! \internal
-    \brief Signfies the end of the linked list
+    \brief Signfies the end of the particles in a cell
 */
 const unsigned int LINK_CELL_TERMINATOR = 0xffffffff;
 
+//! Largest number of cells per cell width along each dimension of a LinkCell (see LinkCell::setSubdivision)
+const unsigned int MAX_CELL_SUBDIVISION = 3;
+
+//! Largest number of cells in the stencil of a cell
+const unsigned int MAX_STENCIL_SIZE = (2*MAX_CELL_SUBDIVISION + 1)*(2*MAX_CELL_SUBDIVISION + 1)*
+                                      (2*MAX_CELL_SUBDIVISION + 1);
+
+//! The neighbor cells of one cell, as returned by LinkCell::getCellNeighbors
+/*! Either a view of a stencil stored by the LinkCell, or a stencil generated for the call in the object itself, so
+    that the loops over the neighbor cells are the same whether the LinkCell stores its stencils or not. The cells
+    are sorted by index. A copy is independent of the LinkCell only for generated stencils.
+*/
+class CellNeighbors
+    {
+    public:
+        //! Constructor of an empty list
+        CellNeighbors() : m_cells(NULL), m_size(0) {}
+
+        //! Constructor of a view of a stored stencil
+        explicit CellNeighbors(const std::vector<unsigned int>& cells)
+            : m_cells(cells.empty() ? NULL : &cells[0]), m_size(cells.size()) {}
+
+        //! Get the number of neighbor cells
+        unsigned int size() const
+            {
+            return m_size;
+            }
+
+        //! Get a neighbor cell
+        unsigned int operator[](unsigned int idx) const
+            {
+            return m_cells ? m_cells[idx] : m_local[idx];
+            }
+
+    private:
+        friend class LinkCell;
+        const unsigned int *m_cells;            //!< Stored stencil, or NULL for the generated one
+        unsigned int m_size;                    //!< Number of neighbor cells
+        unsigned int m_local[MAX_STENCIL_SIZE]; //!< Generated stencil
+    };
+
 //! Iterates over particles in a link cell list generated by LinkCell
-/*! The link-cell structure is not trivial to iterate over. This helper class makes that easier both in c++ and
-    provides a python compatibile interface for direct usage there.
+/*! The cell list is stored as a permutation of the particle indices sorted by cell. This helper class makes
+    iterating over the particles of one cell easy both in c++ and provides a python compatibile interface for direct
+    usage there.
 
-    An IteratorLinkCell is given the bare essentials it needs to iterate over a given cell, the cell list,
-    the number of particles, number of cells and the cell to iterate over. Call next() to get the index of the next
-    particle in the cell, atEnd() will return true if you are at the end. In C++, next() will crash the code if you
+    An IteratorLinkCell is given the bare essentials it needs to iterate over a given cell, the sorted particle
+    indices, the start of each cell in that array and the cell to iterate over. Call next() to get the index of the
+    next particle in the cell, atEnd() will return true if you are at the end. In C++, next() will crash the code if you
     attempt to iterate past the end (no bounds checking for performance). When called from python, a different version
     of next is used that will throw StopIteration at the end.
 
@@ -47,27 +96,29 @@ class IteratorLinkCell
     {
     public:
         IteratorLinkCell():
-            m_cell_list(NULL), m_Np(0), m_Nc(0), m_cur_idx(LINK_CELL_TERMINATOR), m_cell(0) {}
+            m_cell_particles(NULL), m_cell_start(NULL), m_pos(0), m_end(0), m_cur_idx(LINK_CELL_TERMINATOR),
+            m_cell(0) {}
 
-        IteratorLinkCell(const std::shared_ptr<unsigned int>& cell_list,
-                         unsigned int Np,
+        IteratorLinkCell(const std::shared_ptr<unsigned int>& cell_particles,
+                         const std::shared_ptr<unsigned int>& cell_start,
                          unsigned int Nc,
                          unsigned int cell)
-                         : m_cell_list(cell_list.get()), m_Np(Np), m_Nc(Nc)
+                         : m_cell_particles(cell_particles.get()), m_cell_start(cell_start.get()), m_cur_idx(0)
             {
             assert(cell < Nc);
-            assert(Np > 0);
             assert(Nc > 0);
             m_cell = cell;
-            m_cur_idx = m_Np + cell;
+            m_pos = m_cell_start[cell];
+            m_end = m_cell_start[cell+1];
             }
 
         //! Copy the position of rhs into this object
         void copy(const IteratorLinkCell &rhs)
         {
-            m_cell_list = rhs.m_cell_list;
-            m_Np = rhs.m_Np;
-            m_Nc = rhs.m_Nc;
+            m_cell_particles = rhs.m_cell_particles;
+            m_cell_start = rhs.m_cell_start;
+            m_pos = rhs.m_pos;
+            m_end = rhs.m_end;
             m_cur_idx = rhs.m_cur_idx;
             m_cell = rhs.m_cell;
         }
@@ -81,36 +132,25 @@ class IteratorLinkCell
         //! Get the next particle index in the list
         unsigned int next()
             {
-            m_cur_idx = m_cell_list[m_cur_idx];
+            if (m_pos == m_end)
+                m_cur_idx = LINK_CELL_TERMINATOR;
+            else
+                m_cur_idx = m_cell_particles[m_pos++];
             return m_cur_idx;
             }
 
         //! Get the first particle index in the list
         unsigned int begin()
             {
-            m_cur_idx = m_Np + m_cell;
-            m_cur_idx = m_cell_list[m_cur_idx];
-            return m_cur_idx;
+            m_pos = m_cell_start[m_cell];
+            return next();
             }
 
-//         //! Get the next particle index in the list with python StopIteration
-//         unsigned int nextPy()
-//             {
-//             m_cur_idx = m_cell_list[m_cur_idx];
-
-//             if (atEnd())
-//                 {
-//                 PyErr_SetNone(PyExc_StopIteration);
-//                 boost::python::throw_error_already_set();
-//                 }
-
-//             return m_cur_idx;
-//             }
-
     private:
-        const unsigned int *m_cell_list;                  //!< The cell list
-        unsigned int m_Np;                                //!< Number of particles in the cell list
-        unsigned int m_Nc;                                //!< Number of cells in the cell list
+        const unsigned int *m_cell_particles;             //!< Particle indices sorted by cell
+        const unsigned int *m_cell_start;                 //!< Index of the first particle of each cell
+        unsigned int m_pos;                               //!< Position of the next particle in m_cell_particles
+        unsigned int m_end;                               //!< One past the last particle of the cell
         unsigned int m_cur_idx;                           //!< Current index
         unsigned int m_cell;                              //!< Cell being considered
     };
@@ -121,7 +161,8 @@ class IteratorLinkCell
 
     Cells are given a nominal minimum width \a cell_width. Each dimension of the box is split into an integer number of
     cells no smaller than \a cell_width wide in that dimension. The actual number of cells along each dimension is
-    stored in an Index3D which is also used to compute the cell index from (i,j,k).
+    stored in an Index3D which is also used to compute the cell index from (i,j,k), unless the cells are in Morton
+    order; getCellIndex() computes it either way.
 
     The cell coordinate (i,j,k) itself is computed like so:
     \code
@@ -130,8 +171,48 @@ class IteratorLinkCell
     and so on for j,k (y,z). Call getCellCoord to do this computation for an arbitrary point.
 
     <b>Data structures:</b><br>
-    The internal data structure used in LinkCell is a linked list of particle indices. See IteratorLinkCell
-    for information on how to iterate through these.
+    The particles are counting sorted by cell: getCellParticles() holds the particle indices ordered by cell (and by
+    index within a cell) and the particles of cell c are entries [getCellStart()[c], getCellStart()[c+1]) of that
+    array. When computeCellList is asked to sort the points, getSortedPoints() holds a copy of the positions in the
+    same order, so that inner loops can stream through contiguous memory. See IteratorLinkCell for information on
+    how to iterate through one cell.
+
+    <b>Subdivision:</b><br>
+    With setSubdivision(n), the cells are \a cell_width / n wide and the neighbor cells of a cell are those up to n
+    cells away along each dimension, which still hold every point within \a cell_width. The stencil then covers
+    (2n+1)^3 / n^3 cell widths cubed instead of 27, so about 0.58 (n = 2) or 0.47 (n = 3) as many candidate pairs, at
+    the cost of visiting more, smaller cells; chooseSubdivision() estimates which n is the fastest from the density,
+    setAutoSubdivision() applies it to every computeCellList, and tuneSubdivision() times trial builds instead.
+    getCellWidth() remains \a cell_width, the cutoff.
+
+    <b>Stencils:</b><br>
+    The neighbor cells of every cell are stored once per set of cell dimensions, which takes up to 27 entries and a
+    vector per cell (more when subdivided). On fine cells of a huge box this outgrows the points themselves, so with
+    setLazyStencils(true), or whenever the stencils would hold more than MAX_STORED_STENCIL_ENTRIES entries, nothing
+    is stored and getCellNeighbors() generates the stencil of a cell from its coordinates on each call, keeping the
+    memory O(Np + Nc). The cells and their order are the same either way.
+
+    <b>Open boundaries:</b><br>
+    Along the directions the box is not periodic in, the stencils do not wrap around, so that the cells at the two
+    walls of a slab are not neighbors, and the points beyond the box fall in the outermost cells instead of wrapping
+    to the other side. With setFitOpenBoundaries(true), the cells along those directions span the extent of the
+    points of each computeCellList instead of the box, and the cell width need not be smaller than half the box
+    along them.
+
+    <b>Power of two cells:</b><br>
+    With setPowerOfTwoCells(true), the number of cells along each dimension is rounded down to a power of two, the
+    cells growing wider accordingly. The cell of a point is then found with a shift of the fractional coordinates and
+    a mask instead of a floor and a modulo, and the cell index and the wrapped neighbor cells of the generated
+    stencils with shifts and masks (see Index3D::indexPow2()). This speeds up the build and the traversal of huge
+    grids, at the cost of up to twice as wide cells, and so more candidate pairs, along each dimension.
+
+    <b>Morton order:</b><br>
+    Cells are numbered in row major order by default, so that the cells of a stencil one step along z are a whole
+    layer of the grid apart, as are the points sorted by cell. With setMortonCells(true), the cells are numbered by
+    the rank of the Morton (Z order) key of their coordinates instead, so that nearby cells, and the points sorted into
+    them, are close in memory along every dimension and the stencil of a cell touches fewer cache lines and pages. The
+    cell of (i,j,k) and its coordinates are then looked up in two tables of one entry per cell, built once per set of
+    cell dimensions along with the stencils.
 
     <b>2D:</b><br>
     LinkCell properly handles 2D boxes. When a 2D box is handed to LinkCell, it creates an m x n x 1 cell list and
@@ -156,6 +237,89 @@ class LinkCell
         //! Update box used in linkCell
         void updateBox(const box::Box& box);
 
+        //! Split each cell width in n cells along each dimension, the stencil growing to n cells each way
+        /*! Throws std::invalid_argument unless 1 <= n <= MAX_CELL_SUBDIVISION. The stencils of all the cells take
+            n^3 (2n+1)^3 / 27 times the memory of n = 1, which chooseSubdivision() bounds but this does not.
+        */
+        void setSubdivision(unsigned int n);
+
+        //! Get the number of cells per cell width
+        unsigned int getSubdivision() const
+            {
+            return m_subdivision;
+            }
+
+        //! Set whether the cells along the non periodic directions span the points of each computeCellList instead
+        //! of the box
+        void setFitOpenBoundaries(bool fit)
+            {
+            if (fit != m_fit_open_boundaries)
+                m_frame_valid = false;
+            m_fit_open_boundaries = fit;
+            }
+
+        //! Get whether the cells along the non periodic directions span the points
+        bool getFitOpenBoundaries() const
+            {
+            return m_fit_open_boundaries;
+            }
+
+        //! Set whether the number of cells along each dimension is rounded down to a power of two
+        void setPowerOfTwoCells(bool pow2);
+
+        //! Get whether the number of cells along each dimension is rounded down to a power of two
+        bool getPowerOfTwoCells() const
+            {
+            return m_pow2_cells;
+            }
+
+        //! Set whether the cells are numbered in Morton order instead of row major order
+        void setMortonCells(bool morton);
+
+        //! Get whether the cells are numbered in Morton order
+        bool getMortonCells() const
+            {
+            return m_morton_cells;
+            }
+
+        //! Set whether the neighbor cells are generated on each getCellNeighbors() call instead of stored
+        void setLazyStencils(bool lazy);
+
+        //! Get whether the neighbor cells are generated on each call, as set or because the stored stencils of the
+        //! current cells would be too large
+        bool getLazyStencils() const
+            {
+            return m_lazy_stencils || (m_stencils && m_stencils->lazy);
+            }
+
+        //! Set whether computeCellList picks the subdivision of each frame with chooseSubdivision()
+        void setAutoSubdivision(bool auto_subdivision)
+            {
+            if (auto_subdivision != m_auto_subdivision)
+                m_frame_valid = false;
+            m_auto_subdivision = auto_subdivision;
+            }
+
+        //! Get whether computeCellList picks the subdivision of each frame
+        bool getAutoSubdivision() const
+            {
+            return m_auto_subdivision;
+            }
+
+        //! Estimate the fastest subdivision for Np points in box
+        /*! The cost of a pair search is modeled as the points of the stencil cells, each distance counting as one,
+            plus CELL_VISIT_COST per stencil cell for the loop over a cell and its partly filled vector. Finer cells
+            only pay off when the cells of width \a cell_width hold many points; subdivisions whose stencils would
+            take more than MAX_STENCIL_ENTRIES entries are never chosen.
+        */
+        unsigned int chooseSubdivision(const box::Box& box, unsigned int Np) const;
+
+        //! Time the build of the cell list and a sweep of its half pairs for every subdivision, and keep the fastest
+        /*! Auto subdivision is turned off, and the cell list is left computed, with sorted points, at the subdivision
+            returned.
+        */
+        unsigned int tuneSubdivision(box::Box& box, const vec3<float> *points, unsigned int Np);
+
         //! Compute LinkCell dimensions
         const vec3<unsigned int> computeDimensions(const box::Box& box, float cell_width) const;
 
@@ -165,7 +329,10 @@ class LinkCell
             return m_box;
             }
 
-        //! Get the cell indexer
+        //! Get the cell indexer, which holds the number of cells along each dimension
+        /*! Its mapping of (i,j,k) to the cell index is that of the cells unless they are in Morton order, see
+            getCellIndex().
+        */
         const Index3D& getCellIndexer() const
             {
             return m_cell_index;
@@ -177,6 +344,15 @@ class LinkCell
             return m_cell_index.getNumElements();
             }
 
+        //! Whether the cell list is that last computed for these points in this box
+        /*! The points are compared by a fingerprint of their positions, which computeCellList() records in the pass
+            that finds their cells, so that analyses sharing a cell list (see SharedLinkCell) only compute it once per
+            frame, however the arrays of the points are allocated. With \a sort_points, the sorted copy of the points
+            must have been stored as well.
+        */
+        bool isComputedFor(const box::Box& box, const vec3<float> *points, unsigned int Np,
+                           bool sort_points=false) const;
+
         //! Get the cell width
         float getCellWidth() const
             {
@@ -187,14 +363,21 @@ class LinkCell
         unsigned int getCell(const vec3<float>& p) const
             {
             vec3<unsigned int> c = getCellCoord(p);
-            return m_cell_index(c.x, c.y, c.z);
+            return getCellIndex(c.x, c.y, c.z);
             }
 
         //! Compute the cell id for a given position
         unsigned int getCell(const float3 p) const
             {
             vec3<unsigned int> c = getCellCoord(p);
-            return m_cell_index(c.x, c.y, c.z);
+            return getCellIndex(c.x, c.y, c.z);
+            }
+
+        //! The index of the cell (i, j, k), with shifts when the cell dimensions are powers of two
+        unsigned int getCellIndex(unsigned int i, unsigned int j, unsigned int k) const
+            {
+            unsigned int c = m_cell_index.isPowerOfTwo() ? m_cell_index.indexPow2(i, j, k) : m_cell_index(i, j, k);
+            return (m_cell_rank != NULL) ? m_cell_rank[c] : c;
             }
 
 
@@ -214,16 +397,16 @@ class LinkCell
         //     }
 
         //! Compute cell coordinates for a given position
+        /*! Positions beyond the box along a non periodic direction are in the outermost cells.
+        */
         vec3<unsigned int> getCellCoord(const vec3<float> p) const
             {
             vec3<float> alpha = m_box.makeFraction(p);
+            uchar3 periodic = m_box.getPeriodic();
             vec3<unsigned int> c;
-            c.x = floorf(alpha.x * float(m_cell_index.getW()));
-            c.x %= m_cell_index.getW();
-            c.y = floorf(alpha.y * float(m_cell_index.getH()));
-            c.y %= m_cell_index.getH();
-            c.z = floorf(alpha.z * float(m_cell_index.getD()));
-            c.z %= m_cell_index.getD();
+            c.x = axisCellCoord(alpha.x, 0, m_cell_index.getW(), periodic.x);
+            c.y = axisCellCoord(alpha.y, 1, m_cell_index.getH(), periodic.y);
+            c.z = axisCellCoord(alpha.z, 2, m_cell_index.getD(), periodic.z || m_box.is2D());
             return c;
             }
 
@@ -257,14 +440,139 @@ class LinkCell
         //! Iterate over particles in a cell
         iteratorcell itercell(unsigned int cell) const
             {
-            assert(m_cell_list.get() != NULL);
-            return iteratorcell(m_cell_list, m_Np, getNumCells(), cell);
+            assert(m_cell_particles.get() != NULL);
+            return iteratorcell(m_cell_particles, m_cell_start, getNumCells(), cell);
+            }
+
+        //! Get the index of the first particle of each cell in getCellParticles() (getNumCells() + 1 entries)
+        std::shared_ptr<unsigned int> getCellStart() const
+            {
+            return m_cell_start;
+            }
+
+        //! Get the particle indices sorted by cell
+        std::shared_ptr<unsigned int> getCellParticles() const
+            {
+            return m_cell_particles;
+            }
+
+        //! Get the positions sorted by cell (only filled when computeCellList is asked to sort the points)
+        std::shared_ptr< vec3<float> > getSortedPoints() const
+            {
+            return m_sorted_points;
             }
 
         //! Get a list of neighbors to a cell
-        const std::vector<unsigned int>& getCellNeighbors(unsigned int cell) const
+        CellNeighbors getCellNeighbors(unsigned int cell) const
+            {
+            CellNeighbors neighbors;
+            if (m_stencils->lazy)
+                generateCellNeighbors(cell, false, neighbors);
+            else
+                neighbors = CellNeighbors(m_stencils->full[cell]);
+            return neighbors;
+            }
+
+        //! Get the neighbors of a cell with a larger cell index than \a cell (the half stencil)
+        /*! In a full 3D cell list this is 13 of the 26 neighbor cells, and 4 of the 8 in 2D (62 of the 124 and 12 of
+            the 24 when the cells are subdivided in two). Together with the
+            pairs inside the cell itself, the half stencils of all cells cover every unordered pair of neighboring
+            particles exactly once.
+        */
+        CellNeighbors getCellNeighborsHalf(unsigned int cell) const
+            {
+            CellNeighbors neighbors;
+            if (m_stencils->lazy)
+                generateCellNeighbors(cell, true, neighbors);
+            else
+                neighbors = CellNeighbors(m_stencils->half[cell]);
+            return neighbors;
+            }
+
+        //! Visit each unordered pair of points closer than sqrt(rmaxsq) that is owned by \a cell
+        /*! \param cell Cell owning the pairs
+            \param points Points the cell list was computed from
+            \param rmaxsq Squared cutoff distance
+            \param visit Callable invoked as visit(i, j, delta, rsq), where delta is the wrapped vector
+                   points[j] - points[i] and rsq its squared length
+
+            A cell owns the pairs between two of its own particles and the pairs between one of its particles and a
+            particle in its half stencil (getCellNeighborsHalf). Calling forEachHalfPair for every cell therefore
+            visits each unordered pair i != j exactly once, which halves the distance computations of symmetric
+            analyses compared to looping over the full stencil of every point. Distinct cells own disjoint pairs, so
+            different cells may be visited concurrently. The cell list must have been computed from \a points; the
+            sorted copy of the positions is used when it is available, and the distances are then computed four at a
+            time by DistanceKernel.
+        */
+        template<typename Visitor>
+        void forEachHalfPair(unsigned int cell, const vec3<float> *points, float rmaxsq, Visitor visit) const
             {
-            return m_cell_neighbors[cell];
+            const unsigned int *cell_start = m_cell_start.get();
+            const unsigned int *cell_particles = m_cell_particles.get();
+            const vec3<float> *sorted_points = m_sorted_points.get();
+            const CellNeighbors& neigh_cells = getCellNeighborsHalf(cell);
+
+            if (sorted_points != NULL)
+                {
+                // the candidates of every cell are contiguous, so the distances are computed by the vectorized kernel
+                DistanceKernel kernel(m_box);
+                for (unsigned int pos_i = cell_start[cell]; pos_i < cell_start[cell+1]; pos_i++)
+                    {
+                    unsigned int i = cell_particles[pos_i];
+                    const vec3<float>& ref = sorted_points[pos_i];
+
+                    // particles later in the same cell
+                    unsigned int first = pos_i + 1;
+                    kernel.forEachWithin(ref, sorted_points + first, cell_start[cell+1] - first, rmaxsq,
+                        [&] (unsigned int k, const vec3<float>& delta, float rsq)
+                        {
+                        visit(i, cell_particles[first + k], delta, rsq);
+                        });
+
+                    // all particles of the forward neighbor cells
+                    for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                        {
+                        unsigned int neigh_cell = neigh_cells[neigh_idx];
+                        unsigned int begin = cell_start[neigh_cell];
+                        kernel.forEachWithin(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin, rmaxsq,
+                            [&] (unsigned int k, const vec3<float>& delta, float rsq)
+                            {
+                            visit(i, cell_particles[begin + k], delta, rsq);
+                            });
+                        }
+                    }
+                return;
+                }
+
+            for (unsigned int pos_i = cell_start[cell]; pos_i < cell_start[cell+1]; pos_i++)
+                {
+                unsigned int i = cell_particles[pos_i];
+                vec3<float> ref = points[i];
+
+                // particles later in the same cell
+                for (unsigned int pos_j = pos_i + 1; pos_j < cell_start[cell+1]; pos_j++)
+                    {
+                    unsigned int j = cell_particles[pos_j];
+                    vec3<float> delta = m_box.wrap(points[j] - ref);
+                    float rsq = dot(delta, delta);
+                    if (rsq < rmaxsq)
+                        visit(i, j, delta, rsq);
+                    }
+
+                // all particles of the forward neighbor cells
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                    {
+                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+                    for (unsigned int pos_j = cell_start[neigh_cell]; pos_j < cell_start[neigh_cell+1]; pos_j++)
+                        {
+                        unsigned int j = cell_particles[pos_j];
+                        vec3<float> delta = m_box.wrap(points[j] - ref);
+                        float rsq = dot(delta, delta);
+                        if (rsq < rmaxsq)
+                            visit(i, j, delta, rsq);
+                        }
+                    }
+                }
             }
 
         // //! Python wrapper for getCellNeighbors
@@ -276,8 +584,63 @@ class LinkCell
 
         //! Compute the cell list (deprecated float3 interface)
         void computeCellList(box::Box& box, const float3 *points, unsigned int Np);
-        //! Compute the cell list
-        void computeCellList(box::Box& box, const vec3<float> *points, unsigned int Np);
+        //! Compute the cell list, optionally storing a copy of the points sorted by cell
+        void computeCellList(box::Box& box, const vec3<float> *points, unsigned int Np, bool sort_points=false);
+        //! Compute the cell list of points given as separate x, y and z arrays, optionally storing a copy of the points
+        //! sorted by cell
+        void computeCellList(box::Box& box, const float *x, const float *y, const float *z, unsigned int Np,
+                             bool sort_points=false);
+
+        //! Compute the neighbor list of ref_points among points, using the cell width as the cutoff
+        void computeNlist(box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                          const vec3<float> *points, unsigned int Np, bool exclude_ii, bool store_vectors);
+
+        //! Count the points within the cell width of each reference point, without storing the pairs
+        /*! With exclude_ii, point i is not counted as a neighbor of reference point i. Only the n_ref counts are
+            written, so the memory is O(N) whatever the number of pairs.
+        */
+        void countNeighbors(box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                            const vec3<float> *points, unsigned int Np, bool exclude_ii, unsigned int *counts);
+
+        //! Find whether each reference point has a point within the cell width, and return how many do
+        /*! The search of a reference point stops at its first neighbor. With exclude_ii, point i is not a neighbor
+            of reference point i.
+        */
+        unsigned int findAnyNeighbor(box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                                     const vec3<float> *points, unsigned int Np, bool exclude_ii, bool *mask);
+
+        //! Get the neighbor list last computed by computeNlist
+        NeighborList *getNlist()
+            {
+            return &m_nlist;
+            }
+
+        //! Get the bytes of the arrays of the cell list, without those of the neighbor list and of the stencils
+        size_t getMemoryBytes() const
+            {
+            size_t bytes = m_cell_start ? (size_t(m_cell_capacity) + 1)*sizeof(unsigned int) : 0;
+            if (m_cell_particles)
+                bytes += 2*size_t(m_Np)*sizeof(unsigned int);
+            if (m_sorted_points)
+                bytes += size_t(m_Np)*sizeof(vec3<float>);
+            return bytes;
+            }
+
+        //! Estimate the bytes of the arrays of the cell list of Np points, without the starts of the cells, which
+        //! depend on the box
+        static size_t estimateMemoryBytes(unsigned int Np, bool sort_points)
+            {
+            return size_t(Np)*(2*sizeof(unsigned int) + (sort_points ? sizeof(vec3<float>) : 0));
+            }
+
+        //! Get the wall times of the phases and the counters of the last computeCellList or computeNlist call, which
+        //! are only recorded when freud is built with ENABLE_PROFILING
+        /*! The phases are find_cells, sort and nlist, the counters points, cells, pairs_tested and bonds.
+        */
+        const util::Profiler& getProfiler() const
+            {
+            return m_profiler;
+            }
 
         // //! Python wrapper for computeCellList
         // void computeCellListPy(box::Box& box, boost::python::numeric::array points);
@@ -286,19 +649,96 @@ class LinkCell
         //! Rounding helper function.
         static unsigned int roundDown(unsigned int v, unsigned int m);
 
+        //! The cell coordinate along one axis of the fractional coordinate alpha
+        unsigned int axisCellCoord(float alpha, unsigned int axis, unsigned int dim, bool periodic) const
+            {
+            if (periodic && (dim & (dim - 1)) == 0)
+                {
+                // adding dim truncates to the floor for alpha >= -1, and leaves the cell the same modulo dim
+                float x = alpha * float(dim);
+                int c = (x >= -float(dim)) ? int(x + float(dim)) : int(floorf(x));
+                return (unsigned int) c & (dim - 1);
+                }
+            if (periodic)
+                {
+                unsigned int c = floorf(alpha * float(dim));
+                return c % dim;
+                }
+            int c = int(floorf((alpha - m_frac_origin[axis]) * m_frac_scale[axis]));
+            return (unsigned int) std::min(std::max(c, 0), int(dim) - 1);
+            }
+
+        //! Set the mapping of the fractional coordinates to the cells along the non periodic directions
+        void updateOpenCells(const box::Box& box, float cell_width, vec3<unsigned int>& celldim);
+
+        //! Count the points within the cell width of reference point i, stopping once the count reaches limit
+        unsigned int countNeighborsOf(const DistanceKernel& kernel, const vec3<float>& ref, unsigned int i,
+                                      const vec3<float> *points, unsigned int Np, bool exclude_ii,
+                                      unsigned int limit) const;
+
+        //! Compute the cell list of points given as an array of vec3<float> or as util::SoAPoints
+        template<class Points>
+        void buildCellList(box::Box& box, const Points& points, unsigned int Np, bool sort_points);
+
         box::Box m_box;      //!< Simulation box the particles belong in
         Index3D m_cell_index;       //!< Indexer to compute cell indices
         unsigned int m_Np;          //!< Number of particles last placed into the cell list
         unsigned int m_Nc;          //!< Number of cells last used
+        unsigned int m_cell_capacity; //!< Number of cells m_cell_start is allocated for
         float m_cell_width;         //!< Minimum necessary cell width cutoff
+        unsigned int m_subdivision; //!< Number of cells per cell width along each dimension
+        bool m_auto_subdivision;    //!< true to choose the subdivision of each computeCellList
+        bool m_lazy_stencils;       //!< true to generate the neighbor cells on each call
+        bool m_fit_open_boundaries; //!< true for cells spanning the points along the non periodic directions
+        bool m_pow2_cells;          //!< true to round the number of cells along each dimension to a power of two
+        bool m_morton_cells;        //!< true to number the cells in Morton order
+        bool m_has_extent;          //!< true when m_frac_lo and m_frac_hi hold the extent of the last points
+        vec3<float> m_frac_lo;      //!< Smallest fractional coordinates of the last points
+        vec3<float> m_frac_hi;      //!< Largest fractional coordinates of the last points
+        float m_frac_origin[3];     //!< Fractional coordinate of the first cell along each non periodic direction
+        float m_frac_scale[3];      //!< Number of cells per unit fractional coordinate along each non periodic direction
         vec3<unsigned int> m_celldim; //!< Cell dimensions
+        bool m_frame_valid;         //!< true if the cells are those of the last computeCellList
+        bool m_frame_sorted;        //!< true if the last computeCellList stored the sorted points
+        uint64_t m_frame_key;       //!< Fingerprint of the points of the last computeCellList
 
-        std::shared_ptr<unsigned int> m_cell_list;    //!< The cell list last computed
+        std::shared_ptr<unsigned int> m_cell_start;       //!< First particle of each cell in m_cell_particles
+        std::shared_ptr<unsigned int> m_cell_particles;   //!< Particle indices sorted by cell
+        std::shared_ptr<unsigned int> m_particle_cells;   //!< Scratch array holding the cell of each particle
+        std::shared_ptr< vec3<float> > m_sorted_points;   //!< Positions sorted by cell, only filled on request
 
-        std::vector< std::vector<unsigned int> > m_cell_neighbors;    //!< List of cell neighborts to each cell
+        //! Neighbor cell lists of every cell for one set of cell dimensions
+        struct CellStencils
+            {
+            vec3<unsigned int> dim;                           //!< Cell dimensions the stencils were built for
+            unsigned int subdivision;                         //!< Subdivision the stencils were built for
+            bool lazy;                                        //!< true when full and half are generated on demand
+            bool periodic[3];                                 //!< Whether the stencils wrap along each dimension
+            bool morton;                                      //!< true when the cells are in Morton order
+            std::vector<unsigned int> rank;                   //!< Cell of each row major index, in Morton order
+            std::vector<unsigned int> order;                  //!< Row major index of each cell, in Morton order
+            std::vector<int> offsets[3];                      //!< Offsets of the neighbor cells along each dimension
+            std::vector< std::vector<unsigned int> > full;    //!< List of cell neighbors to each cell
+            std::vector< std::vector<unsigned int> > half;    //!< Neighbors of each cell with a larger index
+            };
+
+        std::shared_ptr<const CellStencils> m_stencils;                     //!< Stencils of the current dimensions
+        std::vector< std::shared_ptr<const CellStencils> > m_stencil_cache; //!< Recently used stencils
+        const unsigned int *m_cell_rank;    //!< Cell of each row major index, or NULL in row major order
+
+        NeighborList m_nlist;       //!< Neighbor list last computed
+        util::Profiler m_profiler;  //!< Timings and counters of the last call
+        util::ScratchArena m_scratch;   //!< Temporary arrays of the calls
 
         //! Helper function to compute cell neighbors
         void computeCellNeighbors();
+
+        //! Generate the full or half stencil of a cell from its coordinates
+        void generateCellNeighbors(unsigned int cell, bool half, CellNeighbors& neighbors) const;
+
+        //! generateCellNeighbors() with the cell unraveled and wrapped by divisions, or by shifts and masks
+        template<bool pow2>
+        void generateCellNeighborsWith(unsigned int cell, bool half, CellNeighbors& neighbors) const;
     };
 
 }; }; // end namespace freud::locality
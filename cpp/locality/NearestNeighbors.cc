@@ -10,8 +10,11 @@
 #include <boost/math/special_functions/spherical_harmonic.hpp>
 
 #include "NearestNeighbors.h"
+#include "PeriodicImages.h"
 #include "ScopedGILRelease.h"
 #include "HOOMDMatrix.h"
+#include "Annotation.h"
+#include "ComputeArena.h"
 
 using namespace std;
 using namespace tbb;
@@ -24,7 +27,9 @@ namespace freud { namespace locality {
 
 // stop using
 NearestNeighbors::NearestNeighbors():
-    m_box(box::Box()), m_rmax(0), m_num_neighbors(0), m_scale(0), m_strict_cut(false), m_num_points(0), m_num_ref(0),
+    m_box(box::Box()), m_rmax(0), m_num_neighbors(0), m_scale(0), m_strict_cut(false), m_use_tree(false),
+    m_store_rsq(true), m_store_vectors(true), m_epsilon(0.0f), m_recall_samples(1000), m_recall(1.0f),
+    m_exact_fraction(1.0f), m_max_distance_ratio(1.0f), m_recall_queries(0), m_num_points(0), m_num_ref(0),
     m_deficits()
     {
     m_lc = new locality::LinkCell();
@@ -35,7 +40,9 @@ NearestNeighbors::NearestNeighbors(float rmax,
                                    unsigned int num_neighbors,
                                    float scale,
                                    bool strict_cut):
-    m_box(box::Box()), m_rmax(rmax), m_num_neighbors(num_neighbors), m_scale(scale), m_strict_cut(strict_cut), m_num_points(0),
+    m_box(box::Box()), m_rmax(rmax), m_num_neighbors(num_neighbors), m_scale(scale), m_strict_cut(strict_cut),
+    m_use_tree(false), m_store_rsq(true), m_store_vectors(true), m_epsilon(0.0f), m_recall_samples(1000),
+    m_recall(1.0f), m_exact_fraction(1.0f), m_max_distance_ratio(1.0f), m_recall_queries(0), m_num_points(0),
     m_num_ref(0), m_deficits()
     {
     m_lc = new locality::LinkCell(m_box, m_rmax);
@@ -47,12 +54,50 @@ NearestNeighbors::~NearestNeighbors()
     delete m_lc;
     }
 
-//! Utility function to sort a pair<float, unsigned int> on the first
-//! element of the pair
-bool compareRsqVectors(const pair<float, pair<unsigned int, vec3<float> > > &left,
-                       const pair<float, pair<unsigned int, vec3<float> > > &right)
+//! \internal
+//! Collect the neighbors of p among the explicit periodic images of the points within rmax, expanding the radius by
+//! scale until there are k of them unless strict_cut is set, and return the radius searched. The zero image of the
+//! point exclude is skipped.
+static float findImageNeighbors(const box::Box& box, const vec3<float>& p, unsigned int exclude,
+                                const vec3<float> *pos, unsigned int num_points, float rmax, float scale,
+                                bool strict_cut, unsigned int k, NeighborCandidates& neighbors,
+                                util::ProfileCount& tested)
     {
-    return left.first < right.first;
+    float rcut = rmax;
+    while (true)
+        {
+        neighbors.clear();
+        PeriodicImages images(box, rcut);
+        images.forEachNeighbor(p, pos, num_points,
+            [&] (unsigned int j, const vec3<float>& rij, float rsq, bool zero_image)
+            {
+            if (zero_image && exclude == j)
+                return;
+            neighbors.rsq.push_back(rsq);
+            neighbors.idx.push_back(j);
+            neighbors.wvec.push_back(rij);
+            });
+        tested.add(num_points);
+        // the images of a periodic box always provide enough neighbors eventually
+        if (strict_cut || neighbors.rsq.size() >= k)
+            return rcut;
+        rcut *= scale;
+        }
+    }
+
+//! \internal
+//! Fill count entries of the output arrays with the padding, in parallel; rsq and wvec may be NULL
+static void fillPadding(unsigned int *neighbors, float *rsq, vec3<float> *wvec, size_t count)
+    {
+    parallel_for(blocked_range<size_t>(0, count),
+        [=] (const blocked_range<size_t>& r)
+        {
+        std::fill(neighbors + r.begin(), neighbors + r.end(), UINT_MAX);
+        if (rsq)
+            std::fill(rsq + r.begin(), rsq + r.end(), -1.0f);
+        if (wvec)
+            std::fill(wvec + r.begin(), wvec + r.end(), vec3<float>(-1,-1,-1));
+        });
     }
 
 void NearestNeighbors::setCutMode(const bool strict_cut)
@@ -60,60 +105,67 @@ void NearestNeighbors::setCutMode(const bool strict_cut)
     m_strict_cut = strict_cut;
     }
 
-void NearestNeighbors::compute(const box::Box& box,
-                               const vec3<float> *ref_pos,
-                               unsigned int num_ref,
-                               const vec3<float> *pos,
-                               unsigned int num_points)
+void NearestNeighbors::computeCells(const vec3<float> *ref_pos,
+                                    unsigned int num_ref,
+                                    const vec3<float> *pos,
+                                    unsigned int num_points)
     {
-    m_box = box;
-    // reallocate the output array if it is not the right size
-    if (num_ref != m_num_ref)
+    // will be set to true for the last loop if we are recomputing
+    // with the maximum possible cutoff radius
+    bool force_last_recompute(false);
+    // reference particles whose neighbors have not been found yet. A particle with at least m_num_neighbors
+    // neighbors inside m_rmax already has its final nearest neighbors, so only the particles with a deficit are
+    // queried again after m_rmax is increased, instead of restarting the search for every particle.
+    std::vector<unsigned int> pending(num_ref);
+    for (unsigned int i = 0; i < num_ref; i++)
+        pending[i] = i;
+    std::vector<char> deficient(num_ref, 0);
+    if (num_points > 0 && PeriodicImages::isPeriodic(m_box) && PeriodicImages::needed(m_box, m_rmax))
         {
-        m_rsq_array = std::shared_ptr<float>(new float[num_ref * m_num_neighbors], std::default_delete<float[]>());
-        m_neighbor_array = std::shared_ptr<unsigned int>(new unsigned int[num_ref * m_num_neighbors], std::default_delete<unsigned int[]>());
-        m_wvec_array = std::shared_ptr<vec3<float> >(new vec3<float> [num_ref * m_num_neighbors], std::default_delete<vec3<float> []>());
+        // no cell list reaches beyond half the box
+        computeImages(ref_pos, num_ref, pos, num_points, pending, m_rmax);
+        return;
         }
-    // fill with padded values; rsq set to -1, neighbors set to UINT_MAX
-    std::fill(m_rsq_array.get(), m_rsq_array.get()+int(num_ref*m_num_neighbors), -1);
-    std::fill(m_neighbor_array.get(), m_neighbor_array.get()+int(num_ref*m_num_neighbors), UINT_MAX);
-    for (unsigned int i=0; i<(num_ref*m_num_neighbors); i++)
+    if (m_lc->getCellWidth() != m_rmax)
         {
-        m_wvec_array.get()[i] = vec3<float>(-1,-1,-1);
+        // setRMax left the cell width alone as rmax was too large for the previous box
+        delete m_lc;
+        m_lc = new locality::LinkCell(m_box, m_rmax);
         }
-    // will be set to true for the last loop if we are recomputing
-    // with the maximum possible cutoff radius
-    bool force_last_recompute(false);
     // find the nearest neighbors
     do
         {
         // compute the cell list
+        util::ProfilePhase cell_list_phase(m_profiler, "cell_list");
         m_lc->computeCellList(m_box, pos, num_points);
+        cell_list_phase.stop();
+        m_profiler.addCount("iterations", 1);
+        m_profiler.addCount("queries", pending.size());
 
+        util::ProfilePhase search_phase(m_profiler, "search");
         m_deficits = 0;
-        parallel_for(blocked_range<size_t>(0,num_ref),
+        const unsigned int *pending_idx = pending.data();
+        char *is_deficient = deficient.data();
+        float *l_rsq = m_rsq_array.get();
+        vec3<float> *l_wvec = m_wvec_array.get();
+        parallel_for(blocked_range<size_t>(0,pending.size()),
             [=] (const blocked_range<size_t>& r)
             {
             float rmaxsq = m_rmax * m_rmax;
-            // tuple<> is c++11, so for now just make a pair with pairs inside
-            // this data structure holds rsq, idx
-            // vector< pair<float, unsigned int> > neighbors;
-            vector< pair<float, pair<unsigned int, vec3<float> > > > neighbors;
+            NeighborCandidates& neighbors = m_local_candidates.local();
             Index2D b_i = Index2D(m_num_neighbors, num_ref);
-            for(size_t i=r.begin(); i!=r.end(); ++i)
+            util::ProfileCount tested;
+            for(size_t idx=r.begin(); idx!=r.end(); ++idx)
                 {
-                // If we have found an incomplete set of neighbors, end now and rebuild
-                if(!force_last_recompute && (m_deficits > 0) && !(m_strict_cut))
-                    break;
+                size_t i = pending_idx[idx];
                 neighbors.clear();
-
                 //get cell point is in
                 vec3<float> posi = ref_pos[i];
                 unsigned int ref_cell = m_lc->getCell(posi);
                 unsigned int num_adjacent = 0;
 
                 //loop over neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+                const CellNeighbors& neigh_cells = m_lc->getCellNeighbors(ref_cell);
                 for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                     {
                     unsigned int neigh_cell = neigh_cells[neigh_idx];
@@ -122,6 +174,7 @@ void NearestNeighbors::compute(const box::Box& box,
                     locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
                     for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
                         {
+                        tested.add(1);
 
                         //compute r between the two particles
                         vec3<float>rij = m_box.wrap(pos[j] - posi);
@@ -130,10 +183,9 @@ void NearestNeighbors::compute(const box::Box& box,
                         // adds all neighbors within rsq to list of possible neighbors
                         if ((rsq < rmaxsq) && (i != j))
                             {
-                            pair<float, pair<unsigned int, vec3<float> > > l_neighbor;
-                            l_neighbor.first = rsq;
-                            l_neighbor.second = pair<unsigned int, vec3<float> > (j, rij);
-                            neighbors.push_back(l_neighbor);
+                            neighbors.rsq.push_back(rsq);
+                            neighbors.idx.push_back(j);
+                            neighbors.wvec.push_back(rij);
                             num_adjacent++;
                             }
                         }
@@ -141,22 +193,40 @@ void NearestNeighbors::compute(const box::Box& box,
 
                 // Add to the deficit count if necessary
                 if(!force_last_recompute && (num_adjacent < m_num_neighbors) && !(m_strict_cut))
+                    {
                     m_deficits += (m_num_neighbors - num_adjacent);
+                    is_deficient[i] = 1;
+                    }
                 else
                     {
-                    // sort based on rsq
-                    sort(neighbors.begin(), neighbors.end(), compareRsqVectors);
-                    unsigned int k_max = (neighbors.size() < m_num_neighbors) ? neighbors.size() : m_num_neighbors;
+                    is_deficient[i] = 0;
+                    // only the closest m_num_neighbors candidates need to be ordered
+                    neighbors.selectClosest(m_num_neighbors);
+                    unsigned int k_max = (num_adjacent < m_num_neighbors) ? num_adjacent : m_num_neighbors;
                     for (unsigned int k = 0; k < k_max; k++)
                         {
                         // put the idx into the neighbor array
-                        m_rsq_array.get()[b_i(k, i)] = neighbors[k].first;
-                        m_neighbor_array.get()[b_i(k, i)] = (neighbors[k].second).first;
-                        m_wvec_array.get()[b_i(k, i)] = (neighbors[k].second).second;
+                        unsigned int c = neighbors.order[k];
+                        m_neighbor_array.get()[b_i(k, i)] = neighbors.idx[c];
+                        if (l_rsq)
+                            l_rsq[b_i(k, i)] = neighbors.rsq[c];
+                        if (l_wvec)
+                            l_wvec[b_i(k, i)] = neighbors.wvec[c];
                         }
                     }
                 }
+            tested.addTo(m_profiler, "pairs_tested");
             });
+        search_phase.stop();
+
+        // only the particles with a deficit are queried again
+        unsigned int num_pending = 0;
+        for (unsigned int idx = 0; idx < pending.size(); idx++)
+            {
+            if (deficient[pending[idx]])
+                pending[num_pending++] = pending[idx];
+            }
+        pending.resize(num_pending);
 
         // Increase m_rmax
         if(!force_last_recompute && (m_deficits > 0) && !(m_strict_cut))
@@ -169,7 +239,13 @@ void NearestNeighbors::compute(const box::Box& box,
                 {
                 too_wide |=  m_rmax > L.z/2.0;
                 }
-            if (too_wide)
+            if (too_wide && num_points > 0 && PeriodicImages::isPeriodic(m_box))
+                {
+                // continue the search of the particles with a deficit among the explicit periodic images
+                computeImages(ref_pos, num_ref, pos, num_points, pending, m_rmax);
+                break;
+                }
+            else if (too_wide)
                 {
                 // throw runtime_warning("r_max has become too large to create a viable cell.");
                 // for now print
@@ -185,9 +261,367 @@ void NearestNeighbors::compute(const box::Box& box,
             // exit the while loop even if there are deficits
             break;
         } while((m_deficits > 0) && !(m_strict_cut));
+    }
+
+void NearestNeighbors::computeTree(const vec3<float> *ref_pos,
+                                   unsigned int num_ref,
+                                   const vec3<float> *pos,
+                                   unsigned int num_points)
+    {
+    util::ProfilePhase build_phase(m_profiler, "build_tree");
+    m_tree.build(m_box, pos, num_points);
+    build_phase.stop();
+    m_profiler.addCount("iterations", 1);
+    m_profiler.addCount("queries", num_ref);
+    util::ProfilePhase search_phase(m_profiler, "search");
+    // without a strict cutoff the search is only limited by the periodic images
+    float rmax = m_strict_cut ? min(m_rmax, m_tree.getMaxRadius()) : m_tree.getMaxRadius();
+    m_deficits = 0;
+
+    std::vector<char> deficient(num_ref, 0);
+    char *is_deficient = deficient.data();
+    float *l_rsq = m_rsq_array.get();
+    vec3<float> *l_wvec = m_wvec_array.get();
+
+    parallel_for(blocked_range<size_t>(0,num_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        vector< pair<float, unsigned int> >& neighbors = m_local_nearest.local();
+        Index2D b_i = Index2D(m_num_neighbors, num_ref);
+        for(size_t i=r.begin(); i!=r.end(); ++i)
+            {
+            m_tree.findNearest(ref_pos[i], m_num_neighbors, rmax, i, neighbors, m_epsilon);
+            if (neighbors.size() < m_num_neighbors)
+                {
+                m_deficits += (m_num_neighbors - neighbors.size());
+                is_deficient[i] = 1;
+                }
+            for (unsigned int k = 0; k < neighbors.size(); k++)
+                {
+                unsigned int j = neighbors[k].second;
+                m_neighbor_array.get()[b_i(k, i)] = j;
+                if (l_rsq)
+                    l_rsq[b_i(k, i)] = neighbors[k].first;
+                if (l_wvec)
+                    l_wvec[b_i(k, i)] = m_box.wrap(pos[j] - ref_pos[i]);
+                }
+            }
+        });
+    search_phase.stop();
+
+    // the tree only reaches the minimum images; the particles still short of neighbors within the cutoff are
+    // searched again among the explicit periodic images
+    if (m_deficits == 0 || num_points == 0 || !PeriodicImages::isPeriodic(m_box) ||
+        (m_strict_cut && m_rmax <= m_tree.getMaxRadius()))
+        return;
+    std::vector<unsigned int> pending;
+    for (unsigned int i = 0; i < num_ref; i++)
+        {
+        if (deficient[i])
+            pending.push_back(i);
+        }
+    computeImages(ref_pos, num_ref, pos, num_points, pending, m_strict_cut ? m_rmax : max(m_rmax, rmax));
+    }
+
+/*! The samples are searched again exactly in the tree of computeTree. Those short of neighbors in the tree were
+    completed among the periodic images, whose search is exact, so they are not counted.
+*/
+void NearestNeighbors::measureRecall(const vec3<float> *ref_pos, unsigned int num_ref, const vec3<float> *pos)
+    {
+    util::ProfilePhase recall_phase(m_profiler, "recall");
+    const unsigned int num_samples = min(m_recall_samples, num_ref);
+    if (num_samples == 0 || m_num_neighbors == 0)
+        return;
+    const unsigned int k = m_num_neighbors;
+    const float rmax = m_strict_cut ? min(m_rmax, m_tree.getMaxRadius()) : m_tree.getMaxRadius();
+    // the number of exact neighbors found and the distance ratio of each sample, negative when it is not counted
+    std::vector<unsigned int> matched(num_samples, 0);
+    std::vector<float> ratio(num_samples, -1.0f);
+    unsigned int *l_matched = matched.data();
+    float *l_ratio = ratio.data();
+    const unsigned int *found_j = m_neighbor_array.get();
+    parallel_for(blocked_range<size_t>(0, num_samples),
+        [=] (const blocked_range<size_t>& r)
+        {
+        vector< pair<float, unsigned int> >& exact = m_local_nearest.local();
+        vector<unsigned int> exact_j, approximate_j, common;
+        for (size_t s = r.begin(); s != r.end(); ++s)
+            {
+            size_t i = s * num_ref / num_samples;
+            m_tree.findNearest(ref_pos[i], k, rmax, i, exact);
+            if (exact.size() < k)
+                continue;
+            exact_j.clear();
+            for (unsigned int n = 0; n < k; n++)
+                exact_j.push_back(exact[n].second);
+            approximate_j.assign(found_j + i*k, found_j + (i+1)*k);
+            sort(exact_j.begin(), exact_j.end());
+            sort(approximate_j.begin(), approximate_j.end());
+            common.clear();
+            set_intersection(exact_j.begin(), exact_j.end(), approximate_j.begin(), approximate_j.end(),
+                             back_inserter(common));
+            l_matched[s] = (unsigned int) common.size();
+            vec3<float> farthest = m_box.wrap(pos[found_j[i*k + k - 1]] - ref_pos[i]);
+            l_ratio[s] = (exact[k-1].first > 0.0f) ? sqrtf(dot(farthest, farthest) / exact[k-1].first) : 1.0f;
+            }
+        });
+
+    size_t total_matched = 0;
+    unsigned int num_exact = 0;
+    for (unsigned int s = 0; s < num_samples; s++)
+        {
+        if (l_ratio[s] < 0.0f)
+            continue;
+        m_recall_queries++;
+        total_matched += matched[s];
+        num_exact += (matched[s] == k);
+        m_max_distance_ratio = max(m_max_distance_ratio, ratio[s]);
+        }
+    if (m_recall_queries > 0)
+        {
+        m_recall = float(double(total_matched) / (double(m_recall_queries) * k));
+        m_exact_fraction = float(num_exact) / float(m_recall_queries);
+        }
+    }
+
+/*! Every point is tested against every pending particle, so this is only used once rmax exceeds half the box, where
+    the neighbors are a sizable fraction of all points anyway. Without a strict cutoff, the search radius of each
+    particle is expanded by m_scale until it has enough neighbors; m_rmax is then the largest radius searched.
+    A particle is not its own neighbor, but its periodic images are.
+*/
+void NearestNeighbors::computeImages(const vec3<float> *ref_pos,
+                                     unsigned int num_ref,
+                                     const vec3<float> *pos,
+                                     unsigned int num_points,
+                                     const std::vector<unsigned int>& pending,
+                                     float rmax)
+    {
+    util::ProfilePhase images_phase(m_profiler, "images");
+    m_profiler.addCount("image_queries", pending.size());
+    m_deficits = 0;
+    tbb::enumerable_thread_specific<float> thread_rmax(rmax);
+    const unsigned int *pending_idx = pending.data();
+    float *l_rsq = m_rsq_array.get();
+    vec3<float> *l_wvec = m_wvec_array.get();
+    parallel_for(blocked_range<size_t>(0,pending.size()),
+        [=, &thread_rmax] (const blocked_range<size_t>& r)
+        {
+        NeighborCandidates& neighbors = m_local_candidates.local();
+        float& searched_rmax = thread_rmax.local();
+        Index2D b_i = Index2D(m_num_neighbors, num_ref);
+        util::ProfileCount tested;
+        for(size_t idx=r.begin(); idx!=r.end(); ++idx)
+            {
+            size_t i = pending_idx[idx];
+            float rcut = findImageNeighbors(m_box, ref_pos[i], i, pos, num_points, rmax, m_scale, m_strict_cut,
+                                            m_num_neighbors, neighbors, tested);
+            searched_rmax = max(searched_rmax, rcut);
+
+            unsigned int num_adjacent = (unsigned int) neighbors.rsq.size();
+            if (num_adjacent < m_num_neighbors)
+                m_deficits += (m_num_neighbors - num_adjacent);
+            neighbors.selectClosest(m_num_neighbors);
+            unsigned int k_max = (num_adjacent < m_num_neighbors) ? num_adjacent : m_num_neighbors;
+            for (unsigned int k = 0; k < k_max; k++)
+                {
+                unsigned int c = neighbors.order[k];
+                m_neighbor_array.get()[b_i(k, i)] = neighbors.idx[c];
+                if (l_rsq)
+                    l_rsq[b_i(k, i)] = neighbors.rsq[c];
+                if (l_wvec)
+                    l_wvec[b_i(k, i)] = neighbors.wvec[c];
+                }
+            }
+        tested.addTo(m_profiler, "pairs_tested");
+        });
+    for (tbb::enumerable_thread_specific<float>::const_iterator it = thread_rmax.begin(); it != thread_rmax.end(); ++it)
+        m_rmax = max(m_rmax, *it);
+    }
+
+void NearestNeighbors::compute(const box::Box& box,
+                               const vec3<float> *ref_pos,
+                               unsigned int num_ref,
+                               const vec3<float> *pos,
+                               unsigned int num_points)
+    {
+    util::ScopedRange annotation("freud::NearestNeighbors::compute");
+    m_box = box;
+    m_profiler.reset();
+    // keep the output arrays of the previous call when they are large enough
+    util::reuseArray(m_neighbor_array, num_ref*m_num_neighbors);
+    // the distances and vectors are only kept on request
+    if (m_store_rsq)
+        util::reuseArray(m_rsq_array, num_ref*m_num_neighbors);
+    else
+        m_rsq_array.reset();
+    if (m_store_vectors)
+        util::reuseArray(m_wvec_array, num_ref*m_num_neighbors);
+    else
+        m_wvec_array.reset();
+    // fill with padded values; rsq set to -1, neighbors set to UINT_MAX
+    fillPadding(m_neighbor_array.get(), m_rsq_array.get(), m_wvec_array.get(), size_t(num_ref)*m_num_neighbors);
+    m_recall = m_exact_fraction = m_max_distance_ratio = 1.0f;
+    m_recall_queries = 0;
+    if (m_use_tree || m_epsilon > 0.0f)
+        {
+        computeTree(ref_pos, num_ref, pos, num_points);
+        if (m_epsilon > 0.0f)
+            measureRecall(ref_pos, num_ref, pos);
+        }
+    else
+        {
+        computeCells(ref_pos, num_ref, pos, num_points);
+        }
     // save the last computed number of particles
     m_num_ref = num_ref;
     m_num_points = num_points;
+
+    // export the neighbors found (skipping the padding) as a NeighborList, already sorted by distance for each i
+    util::ProfilePhase nlist_phase(m_profiler, "nlist");
+    Index2D b_i = Index2D(m_num_neighbors, num_ref);
+    size_t num_bonds = 0;
+    for (unsigned int idx = 0; idx < num_ref*m_num_neighbors; idx++)
+        {
+        if (m_neighbor_array.get()[idx] != UINT_MAX)
+            num_bonds++;
+        }
+    m_nlist.resize(num_bonds, num_ref, num_points, m_store_vectors);
+    m_profiler.addCount("bonds", num_bonds);
+    const float *l_rsq = m_rsq_array.get();
+    const vec3<float> *l_wvec = m_wvec_array.get();
+    size_t bond = 0;
+    for (unsigned int i = 0; i < num_ref; i++)
+        {
+        for (unsigned int k = 0; k < m_num_neighbors; k++)
+            {
+            unsigned int j = m_neighbor_array.get()[b_i(k, i)];
+            if (j == UINT_MAX)
+                continue;
+            m_nlist.getIndexI().get()[bond] = i;
+            m_nlist.getIndexJ().get()[bond] = j;
+            if (l_rsq)
+                m_nlist.getDistances().get()[bond] = sqrtf(l_rsq[b_i(k, i)]);
+            else
+                {
+                // the distances were not kept, so they are recomputed from the (minimum image) vectors
+                vec3<float> rij = l_wvec ? l_wvec[b_i(k, i)] : m_box.wrap(pos[j] - ref_pos[i]);
+                m_nlist.getDistances().get()[bond] = sqrtf(dot(rij, rij));
+                }
+            if (l_wvec)
+                m_nlist.getVectors().get()[bond] = l_wvec[b_i(k, i)];
+            bond++;
+            }
+        m_nlist.getSegments().get()[i+1] = bond;
+        }
+    }
+
+void NearestNeighbors::buildIndex(const box::Box& box, const vec3<float> *pos, unsigned int Np)
+    {
+    util::ScopedRange annotation("freud::NearestNeighbors::buildIndex");
+    m_index_points.assign(pos, pos + Np);
+    m_index.build(box, m_index_points.data(), Np);
+    }
+
+void NearestNeighbors::query(const vec3<float> *query_pos,
+                             unsigned int n_query,
+                             unsigned int *neighbors,
+                             float *rsq,
+                             vec3<float> *wvec) const
+    {
+    util::ScopedRange annotation("freud::NearestNeighbors::query");
+    searchTree(m_index, m_index_points.data(), query_pos, n_query, false, neighbors, rsq, wvec);
+    }
+
+void NearestNeighbors::compute(const box::Box& box,
+                               const vec3<float> *ref_pos,
+                               unsigned int num_ref,
+                               const vec3<float> *pos,
+                               unsigned int num_points,
+                               KDTree& workspace,
+                               unsigned int *neighbors,
+                               float *rsq,
+                               vec3<float> *wvec) const
+    {
+    util::ScopedRange annotation("freud::NearestNeighbors::compute");
+    workspace.build(box, pos, num_points);
+    searchTree(workspace, pos, ref_pos, num_ref, true, neighbors, rsq, wvec);
+    }
+
+/*! The query points are searched in parallel, each writing its own rows of the output arrays, padding included, so
+    that no pass over the whole arrays precedes the search. A query point short of neighbors in the tree is searched
+    again among the explicit periodic images, as in compute().
+*/
+void NearestNeighbors::searchTree(const KDTree& tree,
+                                  const vec3<float> *pos,
+                                  const vec3<float> *query_pos,
+                                  unsigned int n_query,
+                                  bool exclude_ii,
+                                  unsigned int *neighbors,
+                                  float *rsq,
+                                  vec3<float> *wvec) const
+    {
+    assert(query_pos);
+    assert(neighbors);
+    const box::Box& box = tree.getBox();
+    const unsigned int num_points = tree.getNp();
+    const unsigned int k_req = m_num_neighbors;
+    // without a strict cutoff the search is only limited by the periodic images
+    const float rmax = m_strict_cut ? min(m_rmax, tree.getMaxRadius()) : tree.getMaxRadius();
+    const bool search_images = num_points > 0 && PeriodicImages::isPeriodic(box) &&
+        !(m_strict_cut && m_rmax <= tree.getMaxRadius());
+
+    tbb::enumerable_thread_specific< vector< pair<float, unsigned int> > > thread_neighbors;
+    tbb::enumerable_thread_specific<NeighborCandidates> thread_candidates;
+    parallel_for(blocked_range<size_t>(0, n_query),
+        [=, &thread_neighbors, &thread_candidates] (const blocked_range<size_t>& r)
+        {
+        vector< pair<float, unsigned int> >& found = thread_neighbors.local();
+        util::ProfileCount tested;
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            unsigned int *l_neighbors = neighbors + i*k_req;
+            float *l_rsq = rsq + i*k_req;
+            vec3<float> *l_wvec = wvec + i*k_req;
+            unsigned int num_found;
+            const unsigned int exclude = exclude_ii ? (unsigned int) i : UINT_MAX;
+            tree.findNearest(query_pos[i], k_req, rmax, exclude, found, m_epsilon);
+            if (found.size() < k_req && search_images)
+                {
+                NeighborCandidates& candidates = thread_candidates.local();
+                findImageNeighbors(box, query_pos[i], exclude, pos, num_points, max(m_rmax, rmax), m_scale,
+                                   m_strict_cut, k_req, candidates, tested);
+                candidates.selectClosest(k_req);
+                num_found = min(k_req, (unsigned int) candidates.rsq.size());
+                for (unsigned int k = 0; k < num_found; k++)
+                    {
+                    unsigned int c = candidates.order[k];
+                    l_neighbors[k] = candidates.idx[c];
+                    if (rsq)
+                        l_rsq[k] = candidates.rsq[c];
+                    if (wvec)
+                        l_wvec[k] = candidates.wvec[c];
+                    }
+                }
+            else
+                {
+                num_found = (unsigned int) found.size();
+                for (unsigned int k = 0; k < num_found; k++)
+                    {
+                    unsigned int j = found[k].second;
+                    l_neighbors[k] = j;
+                    if (rsq)
+                        l_rsq[k] = found[k].first;
+                    if (wvec)
+                        l_wvec[k] = box.wrap(pos[j] - query_pos[i]);
+                    }
+                }
+            std::fill(l_neighbors + num_found, l_neighbors + k_req, UINT_MAX);
+            if (rsq)
+                std::fill(l_rsq + num_found, l_rsq + k_req, -1.0f);
+            if (wvec)
+                std::fill(l_wvec + num_found, l_wvec + k_req, vec3<float>(-1,-1,-1));
+            }
+        });
     }
 
 }; }; // end namespace freud::locality
@@ -2,14 +2,20 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include <memory>
+#include <vector>
 
 #include <algorithm>
 #include "LinkCell.h"
+#include "KDTree.h"
+#include "NeighborList.h"
+#include "PeriodicImages.h"
 // hack to keep VectorMath's swap from polluting the global namespace
 // if this is a problem, we need to solve it
 #include "VectorMath.h"
 #include "box.h"
 #include "Index1D.h"
+#include "Profiler.h"
+#include "ComputeArena.h"
 
 #include "tbb/atomic.h"
 
@@ -84,7 +90,49 @@ class IteratorNeighborList
         unsigned int m_cur_idx;                           //!< Current index
     };
 
+//! \internal
+//! Candidate neighbors of one reference particle, stored as separate arrays so that the selection only moves
+//! indices around and the storage is reused from particle to particle, and by compute() from call to call
+struct NeighborCandidates
+    {
+    std::vector<float> rsq;                 //!< Squared distance of each candidate
+    std::vector<unsigned int> idx;          //!< Point index of each candidate
+    std::vector< vec3<float> > wvec;        //!< Wrapped vector to each candidate
+    std::vector<unsigned int> order;        //!< Candidates ordered by distance after selection
+
+    void clear()
+        {
+        rsq.clear();
+        idx.clear();
+        wvec.clear();
+        }
+
+    //! Order the k closest candidates first, breaking ties by point index
+    void selectClosest(unsigned int k)
+        {
+        order.resize(rsq.size());
+        for (unsigned int c = 0; c < order.size(); c++)
+            order[c] = c;
+        k = std::min(k, (unsigned int) order.size());
+        const float *l_rsq = rsq.data();
+        const unsigned int *l_idx = idx.data();
+        std::partial_sort(order.begin(), order.begin() + k, order.end(),
+            [l_rsq, l_idx] (unsigned int a, unsigned int b)
+            {
+            return (l_rsq[a] < l_rsq[b]) || ((l_rsq[a] == l_rsq[b]) && (l_idx[a] < l_idx[b]));
+            });
+        }
+    };
+
 /*! Find the requested number of nearest neighbors
+
+    Once rmax exceeds half of the box along a periodic direction, where no cell list can be built, the particles
+    still short of neighbors are searched among the explicit periodic images of the points (see PeriodicImages). In
+    small boxes a particle may then have several images of the same point, and images of itself, as neighbors.
+
+    compute() keeps its results, and the cell list, in the object. The const compute() taking a KDTree workspace and
+    query() only read the configuration (and the index of buildIndex()), so one configured object may serve any
+    number of threads at once.
 */
 class NearestNeighbors
     {
@@ -111,13 +159,14 @@ class NearestNeighbors
         void setRMax(float rmax)
             {
             m_rmax = rmax;
-            m_lc->setCellWidth(m_rmax);
+            // a cutoff beyond half the box is searched over the periodic images, see computeImages
+            if (!PeriodicImages::needed(m_lc->getBox(), m_rmax))
+                m_lc->setCellWidth(m_rmax);
             }
 
         void setRMaxPy(float rmax)
             {
-            m_rmax = rmax;
-            m_lc->setCellWidth(m_rmax);
+            setRMax(rmax);
             }
 
         //! Get the simulation box
@@ -208,24 +257,206 @@ class NearestNeighbors
             return m_wvec_array;
             }
 
+        //! Get the neighbors last computed as a NeighborList; padded entries are omitted
+        NeighborList *getNlist()
+            {
+            return &m_nlist;
+            }
+
         void setCutMode(const bool strict_cut);
 
+        //! Find the neighbors with a KDTree instead of a LinkCell
+        /*! The tree finds the nearest neighbors of every particle in a single pass, however inhomogeneous the
+            system, so rmax is not expanded within half of the box: with strict_cut the neighbors are limited to
+            rmax, otherwise to half of the box, beyond which the particles still short of neighbors are searched
+            among the explicit periodic images.
+        */
+        void setUseTree(const bool use_tree)
+            {
+            m_use_tree = use_tree;
+            }
+
+        bool getUseTree() const
+            {
+            return m_use_tree;
+            }
+
+        //! Find approximate neighbors, each at most 1 + epsilon times as far as the exact neighbor of its rank, 0 for
+        //! the exact neighbors (the default)
+        /*! The search is that of the tree (see KDTree::findNearest), whatever setUseTree(), and skips the nodes that
+            could only improve the neighbors by less than the factor 1 + epsilon, which trades accuracy for speed on
+            large clouds of points. compute() then checks the neighbors of getRecallSamples() reference points
+            against an exact search, see getRecall(). query() and the const compute() are approximate as well.
+        */
+        void setApproximate(float epsilon)
+            {
+            m_epsilon = epsilon;
+            }
+
+        float getApproximate() const
+            {
+            return m_epsilon;
+            }
+
+        //! Set the number of reference points, evenly spread, whose approximate neighbors are checked by compute()
+        void setRecallSamples(unsigned int num_samples)
+            {
+            m_recall_samples = num_samples;
+            }
+
+        unsigned int getRecallSamples() const
+            {
+            return m_recall_samples;
+            }
+
+        //! Get the fraction of the exact neighbors found by the last approximate compute, over the samples checked
+        float getRecall() const
+            {
+            return m_recall;
+            }
+
+        //! Get the fraction of the samples checked by the last approximate compute whose neighbors were all exact
+        float getExactFraction() const
+            {
+            return m_exact_fraction;
+            }
+
+        //! Get the largest ratio of the distance of the farthest neighbor found to the exact one over the samples
+        //! checked by the last approximate compute, which is at most 1 + epsilon
+        float getMaxDistanceRatio() const
+            {
+            return m_max_distance_ratio;
+            }
+
+        //! Get the number of samples checked by the last approximate compute
+        unsigned int getNumRecallQueries() const
+            {
+            return m_recall_queries;
+            }
+
+        //! Keep the squared distance of each neighbor, which getRsqList() returns
+        /*! Consumers that only need the neighbor indices or vectors can turn this off to save writing an array of
+            num_ref x num_neighbors floats per call; getRsqList() is then NULL, and the distances of getNlist() are
+            recomputed from the minimum image vectors.
+        */
+        void setStoreDistances(const bool store_rsq)
+            {
+            m_store_rsq = store_rsq;
+            }
+
+        bool getStoreDistances() const
+            {
+            return m_store_rsq;
+            }
+
+        //! Keep the wrapped vector of each neighbor, which getWrappedVectors() returns
+        /*! Off, getWrappedVectors() is NULL and getNlist() has no vectors.
+        */
+        void setStoreVectors(const bool store_vectors)
+            {
+            m_store_vectors = store_vectors;
+            }
+
+        bool getStoreVectors() const
+            {
+            return m_store_vectors;
+            }
+
+        //! Get the wall times of the phases and the counters of the last compute call, which are only recorded when
+        //! freud is built with ENABLE_PROFILING
+        /*! The phases are cell_list, search, build_tree (with the tree), images (beyond half the box), recall (of
+            the approximate search) and nlist;
+            the counters are iterations (the passes of the search, one more for each expansion of rmax), queries (the
+            reference points searched over all the passes), image_queries (the reference points searched among the
+            periodic images), pairs_tested (with the cell list and the images) and bonds.
+        */
+        const util::Profiler& getProfiler() const
+            {
+            return m_profiler;
+            }
+
         //! find the requested nearest neighbors
         void compute(const box::Box& box, const vec3<float> *ref_pos, unsigned int n_ref, const vec3<float> *pos, unsigned int Np);
 
+        //! Build the index of the points that query() searches
+        /*! The points are copied into a KDTree, which serves queries of any radius, so that batches of query points
+            (grid points, insertion trials, ...) can be searched with query() without indexing the points again.
+            The index is independent of compute(), whose results it leaves alone.
+        */
+        void buildIndex(const box::Box& box, const vec3<float> *pos, unsigned int Np);
+
+        //! Get the number of points in the index built by buildIndex()
+        unsigned int getIndexNp() const
+            {
+            return m_index.getNp();
+            }
+
+        //! Find the nearest neighbors of a batch of query points among the points of the index
+        /*! The n_query x num_neighbors results are written to the caller's arrays, of which \a rsq and \a wvec may
+            be NULL when they are not needed, ordered by distance for each query
+            point and padded as the arrays of compute() are (UINT_MAX, -1 and (-1,-1,-1)). A query point is not
+            excluded from its own neighbors, as it is no point of the index. As with the tree in compute(), the
+            neighbors are limited to rmax with strict_cut and otherwise searched over the periodic images as far as
+            needed. query() neither changes rmax nor the results of compute(), so it may be called concurrently.
+        */
+        void query(const vec3<float> *query_pos, unsigned int n_query, unsigned int *neighbors, float *rsq,
+                   vec3<float> *wvec) const;
+
+        //! Find the nearest neighbors of ref_pos among pos without changing the object
+        /*! The results of compute() are written to the caller's arrays instead, as those of query() are, and the
+            points are indexed in the caller's \a workspace, so that a configured NearestNeighbors serves several
+            threads processing different frames concurrently, each with a workspace of its own. As in compute(), a
+            reference point is not its own neighbor (j == i is skipped); the search is that of the tree in compute(),
+            whatever setUseTree(). rmax is not expanded and the profiler is not updated.
+        */
+        void compute(const box::Box& box, const vec3<float> *ref_pos, unsigned int n_ref, const vec3<float> *pos,
+                     unsigned int Np, KDTree& workspace, unsigned int *neighbors, float *rsq,
+                     vec3<float> *wvec) const;
+
     private:
+        //! Find the neighbors with the cell list, expanding rmax until every particle has enough
+        void computeCells(const vec3<float> *ref_pos, unsigned int n_ref, const vec3<float> *pos, unsigned int Np);
+        //! Find the neighbors with the tree in a single pass
+        void computeTree(const vec3<float> *ref_pos, unsigned int n_ref, const vec3<float> *pos, unsigned int Np);
+        //! Find the neighbors of the query points among the points of a tree, writing to the caller's arrays
+        void searchTree(const KDTree& tree, const vec3<float> *pos, const vec3<float> *query_pos,
+                        unsigned int n_query, bool exclude_ii, unsigned int *neighbors, float *rsq,
+                        vec3<float> *wvec) const;
+        //! Check the approximate neighbors of evenly spread reference points against an exact search of the tree
+        void measureRecall(const vec3<float> *ref_pos, unsigned int n_ref, const vec3<float> *pos);
+        //! Find the neighbors of the pending particles among the explicit periodic images, starting from rmax
+        void computeImages(const vec3<float> *ref_pos, unsigned int n_ref, const vec3<float> *pos, unsigned int Np,
+                           const std::vector<unsigned int>& pending, float rmax);
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_rmax;                     //!< Maximum r at which to determine neighbors
         unsigned int m_num_neighbors;            //!< Number of neighbors to calculate
         float m_scale;                    //!< scale by which to increase neighbor search radius
         bool m_strict_cut;                  //!< use a strict r_cut, or allow freud to expand the r_cut as needed
+        bool m_use_tree;                    //!< search with m_tree instead of m_lc
+        bool m_store_rsq;                   //!< keep m_rsq_array
+        bool m_store_vectors;               //!< keep m_wvec_array
+        float m_epsilon;                    //!< Relative error of the approximate search, 0 for the exact one
+        unsigned int m_recall_samples;      //!< Number of reference points checked after an approximate search
+        float m_recall;                     //!< Fraction of the exact neighbors found among the samples
+        float m_exact_fraction;             //!< Fraction of the samples whose neighbors were all exact
+        float m_max_distance_ratio;         //!< Largest ratio of the farthest neighbor found to the exact one
+        unsigned int m_recall_queries;      //!< Number of samples checked
         unsigned int m_num_points;                //!< Number of particles for which nearest neighbors checks
         unsigned int m_num_ref;                //!< Number of particles for which nearest neighbors calcs
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        KDTree m_tree;                      //!< KDTree used instead of m_lc when m_use_tree is set
+        KDTree m_index;                     //!< Points searched by query()
+        std::vector< vec3<float> > m_index_points;  //!< Positions of the points of m_index
         tbb::atomic<unsigned int> m_deficits; //!< Neighbor deficit count from the last compute step
         std::shared_ptr<unsigned int> m_neighbor_array;         //!< array of nearest neighbors computed
         std::shared_ptr<float> m_rsq_array;         //!< array of distances to neighbors
         std::shared_ptr<vec3<float> > m_wvec_array;         //!< array of distances to neighbors
+        NeighborList m_nlist;              //!< Neighbors last computed, in NeighborList form
+        util::Profiler m_profiler;         //!< Timings and counters of the last compute call
+        util::ThreadScratch<NeighborCandidates> m_local_candidates;    //!< Candidates of each thread of compute()
+        //! Neighbors found in m_tree by each thread of compute()
+        util::ThreadScratch< std::vector< std::pair<float, unsigned int> > > m_local_nearest;
         };
 
 }; }; // end namespace freud::locality
@@ -0,0 +1,488 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <string.h>
+#include <tbb/tbb.h>
+
+#include "NeighborList.h"
+#include "ComputeArena.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file NeighborList.cc
+    \brief Store a list of bonds between pairs of points
+*/
+
+namespace freud { namespace locality {
+
+NeighborList::NeighborList()
+    : m_num_bonds(0), m_num_i(0), m_num_j(0), m_sorted_by_distance(false), m_has_weights(false),
+      m_has_orientations(false), m_has_angles(false)
+    {
+    m_segments = std::shared_ptr<size_t>(new size_t[1], std::default_delete<size_t[]>());
+    m_segments.get()[0] = 0;
+    }
+
+NeighborList::NeighborList(size_t num_bonds, unsigned int num_i, unsigned int num_j, bool store_vectors)
+    : m_num_bonds(0), m_num_i(0), m_num_j(0), m_sorted_by_distance(false), m_has_weights(false),
+      m_has_orientations(false), m_has_angles(false)
+    {
+    resize(num_bonds, num_i, num_j, store_vectors);
+    }
+
+void NeighborList::resize(size_t num_bonds, unsigned int num_i, unsigned int num_j, bool store_vectors)
+    {
+    // keep the arrays of the previous list when they are large enough, as the number of bonds changes every frame
+    util::reuseArray(m_index_i, num_bonds);
+    util::reuseArray(m_index_j, num_bonds);
+    util::reuseArray(m_distances, num_bonds);
+    if (store_vectors)
+        util::reuseArray(m_vectors, num_bonds);
+    else
+        m_vectors.reset();
+    util::reuseArray(m_segments, num_i + 1);
+    memset((void*)m_segments.get(), 0, sizeof(size_t)*(num_i + 1));
+    m_num_bonds = num_bonds;
+    m_num_i = num_i;
+    m_num_j = num_j;
+    m_sorted_by_distance = false;
+    m_has_weights = false;
+    m_has_orientations = false;
+    m_has_angles = false;
+    }
+
+float *NeighborList::allocateWeights()
+    {
+    util::reuseArray(m_weights, m_num_bonds);
+    m_has_weights = true;
+    return m_weights.get();
+    }
+
+quat<float> *NeighborList::allocateOrientations()
+    {
+    util::reuseArray(m_orientations, m_num_bonds);
+    m_has_orientations = true;
+    return m_orientations.get();
+    }
+
+float *NeighborList::allocateAngles()
+    {
+    util::reuseArray(m_angles, m_num_bonds);
+    m_has_angles = true;
+    return m_angles.get();
+    }
+
+void NeighborList::updateSegments()
+    {
+    // count the bonds of each reference point, then prefix sum into the bond offsets
+    size_t *segments = m_segments.get();
+    const unsigned int *index_i = m_index_i.get();
+    memset((void*)segments, 0, sizeof(size_t)*(m_num_i + 1));
+    for (size_t bond = 0; bond < m_num_bonds; bond++)
+        {
+        if (index_i[bond] >= m_num_i)
+            {
+            throw invalid_argument("NeighborList reference point index out of range");
+            }
+        if (bond > 0 && index_i[bond] < index_i[bond-1])
+            {
+            throw invalid_argument("NeighborList bonds must be sorted by reference point index");
+            }
+        segments[index_i[bond] + 1]++;
+        }
+    for (unsigned int i = 0; i < m_num_i; i++)
+        {
+        segments[i+1] += segments[i];
+        }
+    }
+
+void NeighborList::validate(unsigned int num_i, unsigned int num_j) const
+    {
+    if ((num_i != m_num_i) || (num_j != m_num_j))
+        {
+        ostringstream msg;
+        msg << "NeighborList was built for " << m_num_i << " reference points and " << m_num_j
+            << " points, but was used with " << num_i << " reference points and " << num_j << " points";
+        throw invalid_argument(msg.str());
+        }
+    }
+
+void NeighborList::sortByDistance()
+    {
+    if (m_sorted_by_distance)
+        return;
+    unsigned int *index_j = m_index_j.get();
+    float *distances = m_distances.get();
+    vec3<float> *vectors = m_vectors.get();
+    float *weights = m_has_weights ? m_weights.get() : NULL;
+    quat<float> *orientations = m_has_orientations ? m_orientations.get() : NULL;
+    float *angles = m_has_angles ? m_angles.get() : NULL;
+    parallel_for(blocked_range<size_t>(0, m_num_i),
+        [=] (const blocked_range<size_t>& r)
+        {
+        vector<size_t> order;
+        vector<unsigned int> sorted_j;
+        vector<float> sorted_distances;
+        vector<float> sorted_weights;
+        vector< vec3<float> > sorted_vectors;
+        vector< quat<float> > sorted_orientations;
+        vector<float> sorted_angles;
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t first = getFirstBond(i);
+            size_t num = getLastBond(i) - first;
+            order.resize(num);
+            for (size_t n = 0; n < num; n++)
+                order[n] = first + n;
+            sort(order.begin(), order.end(),
+                [distances, index_j] (size_t a, size_t b)
+                {
+                return (distances[a] < distances[b]) ||
+                       ((distances[a] == distances[b]) && (index_j[a] < index_j[b]));
+                });
+
+            // gather into scratch storage, then copy back in place
+            sorted_j.resize(num);
+            sorted_distances.resize(num);
+            for (size_t n = 0; n < num; n++)
+                {
+                sorted_j[n] = index_j[order[n]];
+                sorted_distances[n] = distances[order[n]];
+                }
+            copy(sorted_j.begin(), sorted_j.end(), index_j + first);
+            copy(sorted_distances.begin(), sorted_distances.end(), distances + first);
+            if (vectors != NULL)
+                {
+                sorted_vectors.resize(num);
+                for (size_t n = 0; n < num; n++)
+                    sorted_vectors[n] = vectors[order[n]];
+                copy(sorted_vectors.begin(), sorted_vectors.end(), vectors + first);
+                }
+            if (weights != NULL)
+                {
+                sorted_weights.resize(num);
+                for (size_t n = 0; n < num; n++)
+                    sorted_weights[n] = weights[order[n]];
+                copy(sorted_weights.begin(), sorted_weights.end(), weights + first);
+                }
+            if (orientations != NULL)
+                {
+                sorted_orientations.resize(num);
+                for (size_t n = 0; n < num; n++)
+                    sorted_orientations[n] = orientations[order[n]];
+                copy(sorted_orientations.begin(), sorted_orientations.end(), orientations + first);
+                }
+            if (angles != NULL)
+                {
+                sorted_angles.resize(num);
+                for (size_t n = 0; n < num; n++)
+                    sorted_angles[n] = angles[order[n]];
+                copy(sorted_angles.begin(), sorted_angles.end(), angles + first);
+                }
+            }
+        });
+    m_sorted_by_distance = true;
+    }
+
+template<class Keep>
+void NeighborList::copyBondsIf(const NeighborList& source, float rmax, const Keep& keep)
+    {
+    if (&source == this)
+        {
+        throw invalid_argument("NeighborList cannot copy a list into itself");
+        }
+
+    // count the kept bonds of each reference point, then prefix sum into the segments
+    unsigned int num_i = source.getNumI();
+    vector<size_t> counts(num_i + 1, 0);
+    size_t *l_counts = &counts[0];
+    parallel_for(blocked_range<unsigned int>(0, num_i),
+        [=, &source, &keep] (const blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            size_t count = 0;
+            size_t last = source.getLastBondWithin(i, rmax);
+            for (size_t bond = source.getFirstBond(i); bond < last; bond++)
+                count += keep(i, bond);
+            l_counts[i+1] = count;
+            }
+        });
+    for (unsigned int i = 0; i < num_i; i++)
+        counts[i+1] += counts[i];
+
+    resize(counts[num_i], num_i, source.getNumJ(), source.hasVectors());
+    copy(counts.begin(), counts.end(), m_segments.get());
+
+    const unsigned int *source_j = source.getIndexJ().get();
+    const float *source_distances = source.getDistances().get();
+    const vec3<float> *source_vectors = source.getVectors().get();
+    const float *source_weights = source.getWeights().get();
+    const quat<float> *source_orientations = source.getRelativeOrientations().get();
+    const float *source_angles = source.getRelativeAngles().get();
+    unsigned int *index_i = m_index_i.get();
+    unsigned int *index_j = m_index_j.get();
+    float *distances = m_distances.get();
+    vec3<float> *vectors = m_vectors.get();
+    float *weights = (source_weights != NULL) ? allocateWeights() : NULL;
+    quat<float> *orientations = (source_orientations != NULL) ? allocateOrientations() : NULL;
+    float *angles = (source_angles != NULL) ? allocateAngles() : NULL;
+    parallel_for(blocked_range<unsigned int>(0, num_i),
+        [=, &source, &keep] (const blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            size_t out = l_counts[i];
+            size_t last = source.getLastBondWithin(i, rmax);
+            for (size_t bond = source.getFirstBond(i); bond < last; bond++)
+                {
+                if (!keep(i, bond))
+                    continue;
+                index_i[out] = i;
+                index_j[out] = source_j[bond];
+                distances[out] = source_distances[bond];
+                if (vectors != NULL)
+                    vectors[out] = source_vectors[bond];
+                if (weights != NULL)
+                    weights[out] = source_weights[bond];
+                if (orientations != NULL)
+                    orientations[out] = source_orientations[bond];
+                if (angles != NULL)
+                    angles[out] = source_angles[bond];
+                out++;
+                }
+            }
+        });
+    m_sorted_by_distance = source.isSortedByDistance();
+    }
+
+void NeighborList::copyWithin(const NeighborList& source, float rmax)
+    {
+    const float *distances = source.getDistances().get();
+    copyBondsIf(source, rmax,
+        [distances, rmax] (unsigned int i, size_t bond)
+        {
+        return distances[bond] <= rmax;
+        });
+    }
+
+void NeighborList::copyWithinRange(const NeighborList& source, float rmin, float rmax)
+    {
+    const float *distances = source.getDistances().get();
+    copyBondsIf(source, rmax,
+        [distances, rmin, rmax] (unsigned int i, size_t bond)
+        {
+        return distances[bond] > rmin && distances[bond] <= rmax;
+        });
+    }
+
+void NeighborList::copyTypes(const NeighborList& source, const unsigned int *ref_types, const unsigned int *types,
+                             unsigned int type_i, unsigned int type_j)
+    {
+    const unsigned int *source_j = source.getIndexJ().get();
+    copyBondsIf(source, INFINITY,
+        [=] (unsigned int i, size_t bond)
+        {
+        return ref_types[i] == type_i && types[source_j[bond]] == type_j;
+        });
+    }
+
+void NeighborList::copyMasked(const NeighborList& source, const unsigned char *ref_mask, const unsigned char *mask)
+    {
+    const unsigned int *source_j = source.getIndexJ().get();
+    copyBondsIf(source, INFINITY,
+        [=] (unsigned int i, size_t bond)
+        {
+        return (ref_mask == NULL || ref_mask[i]) && (mask == NULL || mask[source_j[bond]]);
+        });
+    }
+
+void NeighborList::copyIf(const NeighborList& source, const unsigned char *keep)
+    {
+    copyBondsIf(source, INFINITY,
+        [keep] (unsigned int i, size_t bond)
+        {
+        return keep[bond] != 0;
+        });
+    }
+
+void NeighborList::copySymmetric(const NeighborList& source)
+    {
+    if (&source == this)
+        {
+        throw invalid_argument("NeighborList cannot copy a list into itself");
+        }
+    unsigned int num_i = source.getNumI();
+    if (source.getNumJ() != num_i)
+        {
+        throw invalid_argument("NeighborList::copySymmetric needs a list between a set of points and itself");
+        }
+    const size_t num_source = source.getNumBonds();
+    const unsigned int *source_i = source.getIndexI().get();
+    const unsigned int *source_j = source.getIndexJ().get();
+    const float *source_distances = source.getDistances().get();
+    const vec3<float> *source_vectors = source.getVectors().get();
+    const float *source_weights = source.getWeights().get();
+    const quat<float> *source_orientations = source.getRelativeOrientations().get();
+    const float *source_angles = source.getRelativeAngles().get();
+
+    // the bonds of source ending at each point, which are the reverse bonds starting from it
+    vector<size_t> reverse_start(num_i + 1, 0);
+    for (size_t bond = 0; bond < num_source; bond++)
+        reverse_start[source_j[bond] + 1]++;
+    for (unsigned int i = 0; i < num_i; i++)
+        reverse_start[i+1] += reverse_start[i];
+    vector<size_t> reverse_bonds(num_source);
+    vector<size_t> fill(reverse_start.begin(), reverse_start.end() - 1);
+    for (size_t bond = 0; bond < num_source; bond++)
+        reverse_bonds[fill[source_j[bond]]++] = bond;
+
+    // each reference point merges its bonds and its reverse bonds by point index; a bond is marked reversed by
+    // its top bit
+    const size_t reversed = size_t(1) << (8*sizeof(size_t) - 1);
+    vector<size_t> segments(num_i + 1, 0);
+    vector<size_t> merged(2*num_source);
+    const size_t *l_reverse_start = &reverse_start[0];
+    const size_t *l_reverse_bonds = num_source ? &reverse_bonds[0] : NULL;
+    size_t *l_counts = &segments[0];
+    size_t *l_merged = num_source ? &merged[0] : NULL;
+    parallel_for(blocked_range<unsigned int>(0, num_i),
+        [=, &source] (const blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            // the bonds and reverse bonds of the reference points before i come first
+            size_t *out = l_merged + source.getFirstBond(i) + l_reverse_start[i];
+            size_t num = 0;
+            for (size_t bond = source.getFirstBond(i); bond < source.getLastBond(i); bond++)
+                out[num++] = bond;
+            for (size_t k = l_reverse_start[i]; k < l_reverse_start[i+1]; k++)
+                out[num++] = l_reverse_bonds[k] | reversed;
+            // the original bond comes first among equal point indices, so that it is the one kept
+            stable_sort(out, out + num,
+                [=] (size_t a, size_t b)
+                {
+                unsigned int j_a = (a & reversed) ? source_i[a & ~reversed] : source_j[a];
+                unsigned int j_b = (b & reversed) ? source_i[b & ~reversed] : source_j[b];
+                return j_a < j_b;
+                });
+            size_t unique = 0;
+            unsigned int last_j = 0;
+            for (size_t n = 0; n < num; n++)
+                {
+                unsigned int j = (out[n] & reversed) ? source_i[out[n] & ~reversed] : source_j[out[n]];
+                if (unique > 0 && j == last_j)
+                    continue;
+                out[unique++] = out[n];
+                last_j = j;
+                }
+            l_counts[i+1] = unique;
+            }
+        });
+    for (unsigned int i = 0; i < num_i; i++)
+        segments[i+1] += segments[i];
+
+    resize(segments[num_i], num_i, num_i, source.hasVectors());
+    copy(segments.begin(), segments.end(), m_segments.get());
+    const size_t *l_segments = m_segments.get();
+    unsigned int *index_i = m_index_i.get();
+    unsigned int *index_j = m_index_j.get();
+    float *distances = m_distances.get();
+    vec3<float> *vectors = m_vectors.get();
+    float *weights = (source_weights != NULL) ? allocateWeights() : NULL;
+    quat<float> *orientations = (source_orientations != NULL) ? allocateOrientations() : NULL;
+    float *angles = (source_angles != NULL) ? allocateAngles() : NULL;
+    parallel_for(blocked_range<unsigned int>(0, num_i),
+        [=, &source] (const blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            const size_t *in = l_merged + source.getFirstBond(i) + l_reverse_start[i];
+            for (size_t n = 0; n < l_segments[i+1] - l_segments[i]; n++)
+                {
+                size_t out = l_segments[i] + n;
+                bool is_reverse = (in[n] & reversed) != 0;
+                size_t bond = in[n] & ~reversed;
+                index_i[out] = i;
+                index_j[out] = is_reverse ? source_i[bond] : source_j[bond];
+                distances[out] = source_distances[bond];
+                if (vectors != NULL)
+                    vectors[out] = is_reverse ? -source_vectors[bond] : source_vectors[bond];
+                if (weights != NULL)
+                    weights[out] = source_weights[bond];
+                // the orientation of i relative to j is the inverse of that of j relative to i
+                if (orientations != NULL)
+                    orientations[out] = is_reverse ? conj(source_orientations[bond]) : source_orientations[bond];
+                if (angles != NULL)
+                    angles[out] = is_reverse ? -source_angles[bond] : source_angles[bond];
+                }
+            }
+        });
+    }
+
+void NeighborList::setWeights(const float *weights)
+    {
+    float *l_weights = allocateWeights();
+    copy(weights, weights + m_num_bonds, l_weights);
+    }
+
+void NeighborList::computeRelativeOrientations(const quat<float> *ref_orientations,
+                                               const quat<float> *orientations)
+    {
+    const unsigned int *index_i = m_index_i.get();
+    const unsigned int *index_j = m_index_j.get();
+    quat<float> *relative = allocateOrientations();
+    parallel_for(blocked_range<size_t>(0, m_num_bonds),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t bond = r.begin(); bond != r.end(); bond++)
+            relative[bond] = conj(ref_orientations[index_i[bond]]) * orientations[index_j[bond]];
+        });
+    }
+
+void NeighborList::computeRelativeAngles(const float *ref_angles, const float *angles)
+    {
+    const unsigned int *index_i = m_index_i.get();
+    const unsigned int *index_j = m_index_j.get();
+    float *relative = allocateAngles();
+    parallel_for(blocked_range<size_t>(0, m_num_bonds),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t bond = r.begin(); bond != r.end(); bond++)
+            {
+            float angle = angles[index_j[bond]] - ref_angles[index_i[bond]];
+            relative[bond] = angle - float(2.0*M_PI)*floorf(angle/float(2.0*M_PI) + 0.5f);
+            }
+        });
+    }
+
+void NeighborList::weightByDistance(WeightKernel kernel, float width)
+    {
+    if (kernel != WEIGHT_UNIFORM && width <= 0.0f)
+        {
+        throw invalid_argument("NeighborList::weightByDistance needs a positive width");
+        }
+    const float *distances = m_distances.get();
+    float *weights = allocateWeights();
+    parallel_for(blocked_range<size_t>(0, m_num_bonds),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t bond = r.begin(); bond != r.end(); bond++)
+            {
+            float r_bond = distances[bond];
+            if (kernel == WEIGHT_GAUSSIAN)
+                weights[bond] = expf(-r_bond*r_bond/(2.0f*width*width));
+            else if (kernel == WEIGHT_LINEAR)
+                weights[bond] = max(1.0f - r_bond/width, 0.0f);
+            else
+                weights[bond] = 1.0f;
+            }
+        });
+    }
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,304 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <memory>
+#include <cstddef>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#ifndef _NEIGHBORLIST_H__
+#define _NEIGHBORLIST_H__
+
+/*! \file NeighborList.h
+    \brief Store a list of bonds between pairs of points
+*/
+
+namespace freud { namespace locality {
+
+//! Functions of the distance of a bond that weightByDistance() turns into its weight
+enum WeightKernel
+    {
+    WEIGHT_UNIFORM,         //!< 1 for every bond
+    WEIGHT_GAUSSIAN,        //!< exp(-r^2 / (2 width^2))
+    WEIGHT_LINEAR           //!< 1 - r / width, and 0 beyond width
+    };
+
+//! Stores the neighbor pairs (bonds) of a set of reference points
+/*! A NeighborList holds, for each reference point i, the indices j of the points it is bonded to, along with the
+    distance of each bond and, optionally, the wrapped bond vector points[j] - ref_points[i]. Bonds are stored in
+    compressed sparse row (CSR) layout: all bonds are sorted by i, and getSegments()[i] is the index of the first
+    bond of reference point i, so that the bonds of i are [getSegments()[i], getSegments()[i+1]).
+
+    A neighbor list is computed once (for example by LinkCell::computeNlist or NearestNeighbors::compute) and may
+    then be handed to any number of analysis methods that take a \a nlist argument, which avoids rebuilding the
+    cell list and re-deriving the same pairs in every module. Consumers still apply their own cutoff to the stored
+    distances, so a list built with a larger cutoff can be reused by a method with a smaller one.
+
+    After sortByDistance(), the bonds of each reference point are ordered by increasing distance, so that the bonds
+    within any smaller cutoff are a prefix of the bonds of each point (see getLastBondWithin()). One list built at
+    the largest cutoff needed on a frame can then serve several analyses with smaller cutoffs without scanning the
+    longer bonds, and copyWithin() extracts the sub-list of a smaller cutoff directly. The bonds of a shell
+    rmin < r <= rmax are then [getFirstBondBeyond(i, rmin), getLastBondWithin(i, rmax)), a view of the list that
+    needs no copy at all.
+
+    The copy operators (copyWithin(), copyWithinRange(), copyTypes(), copyMasked(), copyIf() and copySymmetric())
+    replace the contents of a list with the bonds of another that pass a filter. They count and then write the bonds
+    of the reference points in parallel, keep the order of the bonds of each reference point, and reuse the arrays
+    of the list when they are large enough, so that filtering every frame into the same list allocates nothing once
+    it has grown. A list may also carry a weight per bond, set from an array such as the face areas of
+    voronoi::VoronoiCells with setWeights() or from the distances with weightByDistance(); the copies keep it.
+
+    The orientation of each point relative to its reference point, conj(q_i) q_j for quaternions or theta_j - theta_i
+    for angles in 2D, may be stored per bond as well with computeRelativeOrientations() or computeRelativeAngles(),
+    in one parallel pass over the bonds, so that the anisotropic analyses of a frame sharing the list read it rather
+    than each redoing the quaternion algebra of every pair. The sorts and copies keep them, and the reverse bonds of
+    copySymmetric() get the inverse rotations.
+*/
+class NeighborList
+    {
+    public:
+        //! Null constructor
+        NeighborList();
+
+        //! Allocate storage for num_bonds bonds between num_i reference points and num_j points
+        NeighborList(size_t num_bonds, unsigned int num_i, unsigned int num_j, bool store_vectors);
+
+        //! Reallocate storage for num_bonds bonds; the existing contents are discarded
+        void resize(size_t num_bonds, unsigned int num_i, unsigned int num_j, bool store_vectors);
+
+        //! Rebuild the segment array from the (sorted) i indices
+        void updateSegments();
+
+        //! Throw an exception if this list was not built for num_i reference points and num_j points
+        void validate(unsigned int num_i, unsigned int num_j) const;
+
+        //! Sort the bonds of each reference point by increasing distance (and by point index for equal distances)
+        void sortByDistance();
+
+        //! Test if the bonds of each reference point are sorted by distance
+        bool isSortedByDistance() const
+            {
+            return m_sorted_by_distance;
+            }
+
+        //! Replace the contents of this list with the bonds of source no longer than rmax
+        void copyWithin(const NeighborList& source, float rmax);
+
+        //! Replace the contents of this list with the bonds of source longer than rmin and no longer than rmax
+        void copyWithinRange(const NeighborList& source, float rmin, float rmax);
+
+        //! Replace the contents of this list with the bonds of source from reference points of type type_i to points
+        //! of type type_j
+        void copyTypes(const NeighborList& source, const unsigned int *ref_types, const unsigned int *types,
+                       unsigned int type_i, unsigned int type_j);
+
+        //! Replace the contents of this list with the bonds of source between masked reference points and points
+        /*! A bond is kept if ref_mask[i] and mask[j] are non zero; a NULL mask selects all the points.
+        */
+        void copyMasked(const NeighborList& source, const unsigned char *ref_mask, const unsigned char *mask);
+
+        //! Replace the contents of this list with the bonds b of source for which keep[b] is non zero
+        void copyIf(const NeighborList& source, const unsigned char *keep);
+
+        //! Replace the contents of this list with the bonds of source and their reverses, each bond once
+        /*! The reference points and the points must be the same set. The reverse of a bond has the same distance and
+            weight and the opposite vector. The bonds of each reference point are ordered by point index.
+        */
+        void copySymmetric(const NeighborList& source);
+
+        //! Set the weight of each bond from an array of getNumBonds() values
+        void setWeights(const float *weights);
+
+        //! Set the weight of each bond from its distance
+        void weightByDistance(WeightKernel kernel, float width);
+
+        //! Remove the weights
+        void clearWeights()
+            {
+            m_has_weights = false;
+            }
+
+        //! Set the orientation conj(ref_orientations[i]) * orientations[j] of the point of each bond relative to its
+        //! reference point
+        void computeRelativeOrientations(const quat<float> *ref_orientations, const quat<float> *orientations);
+
+        //! Set the angle angles[j] - ref_angles[i] of the point of each bond relative to its reference point, wrapped
+        //! into [-pi, pi]
+        void computeRelativeAngles(const float *ref_angles, const float *angles);
+
+        //! Remove the relative orientations and angles
+        void clearRelativeOrientations()
+            {
+            m_has_orientations = false;
+            m_has_angles = false;
+            }
+
+        //! Get the number of bonds
+        size_t getNumBonds() const
+            {
+            return m_num_bonds;
+            }
+
+        //! Get the number of reference points
+        unsigned int getNumI() const
+            {
+            return m_num_i;
+            }
+
+        //! Get the number of points
+        unsigned int getNumJ() const
+            {
+            return m_num_j;
+            }
+
+        //! Test if the wrapped bond vectors are stored
+        bool hasVectors() const
+            {
+            return (bool) m_vectors;
+            }
+
+        //! Get the index of the first bond of reference point i
+        size_t getFirstBond(unsigned int i) const
+            {
+            return m_segments.get()[i];
+            }
+
+        //! Get one past the index of the last bond of reference point i
+        size_t getLastBond(unsigned int i) const
+            {
+            return m_segments.get()[i+1];
+            }
+
+        //! Get one past the last bond of reference point i that may be no longer than rmax
+        /*! When the list is sorted by distance this is the end of the prefix of bonds no longer than rmax, found by
+            binary search; otherwise it is getLastBond(i). Consumers still test the distance of each bond.
+        */
+        size_t getLastBondWithin(unsigned int i, float rmax) const
+            {
+            if (!m_sorted_by_distance)
+                return getLastBond(i);
+            const float *distances = m_distances.get();
+            return std::upper_bound(distances + getFirstBond(i), distances + getLastBond(i), rmax) - distances;
+            }
+
+        //! Get the first bond of reference point i that may be longer than rmin
+        /*! When the list is sorted by distance this is the end of the prefix of bonds no longer than rmin, found by
+            binary search; otherwise it is getFirstBond(i).
+        */
+        size_t getFirstBondBeyond(unsigned int i, float rmin) const
+            {
+            if (!m_sorted_by_distance)
+                return getFirstBond(i);
+            const float *distances = m_distances.get();
+            return std::upper_bound(distances + getFirstBond(i), distances + getLastBond(i), rmin) - distances;
+            }
+
+        //! Get the number of bonds of reference point i
+        unsigned int getNumNeighbors(unsigned int i) const
+            {
+            return (unsigned int)(m_segments.get()[i+1] - m_segments.get()[i]);
+            }
+
+        //! Get the reference point index of each bond
+        std::shared_ptr<unsigned int> getIndexI() const
+            {
+            return m_index_i;
+            }
+
+        //! Get the point index of each bond
+        std::shared_ptr<unsigned int> getIndexJ() const
+            {
+            return m_index_j;
+            }
+
+        //! Get the distance of each bond
+        std::shared_ptr<float> getDistances() const
+            {
+            return m_distances;
+            }
+
+        //! Get the wrapped vector points[j] - ref_points[i] of each bond (NULL if not stored)
+        std::shared_ptr< vec3<float> > getVectors() const
+            {
+            return m_vectors;
+            }
+
+        //! Test if the bonds have weights
+        bool hasWeights() const
+            {
+            return m_has_weights;
+            }
+
+        //! Get the weight of each bond (NULL if not set)
+        std::shared_ptr<float> getWeights() const
+            {
+            return m_has_weights ? m_weights : std::shared_ptr<float>();
+            }
+
+        //! Test if the bonds have relative orientations
+        bool hasRelativeOrientations() const
+            {
+            return m_has_orientations;
+            }
+
+        //! Get the orientation of the point of each bond relative to its reference point (NULL if not set)
+        std::shared_ptr< quat<float> > getRelativeOrientations() const
+            {
+            return m_has_orientations ? m_orientations : std::shared_ptr< quat<float> >();
+            }
+
+        //! Test if the bonds have relative angles
+        bool hasRelativeAngles() const
+            {
+            return m_has_angles;
+            }
+
+        //! Get the angle of the point of each bond relative to its reference point (NULL if not set)
+        std::shared_ptr<float> getRelativeAngles() const
+            {
+            return m_has_angles ? m_angles : std::shared_ptr<float>();
+            }
+
+        //! Get the index of the first bond of each reference point (num_i + 1 entries)
+        std::shared_ptr<size_t> getSegments() const
+            {
+            return m_segments;
+            }
+
+    private:
+        //! Replace the contents of this list with the bonds of source no longer than rmax for which keep(i, bond) is
+        //! true
+        template<class Keep>
+        void copyBondsIf(const NeighborList& source, float rmax, const Keep& keep);
+
+        //! Make room for the weights of the bonds, and mark them as set
+        float *allocateWeights();
+
+        //! Make room for the relative orientations of the bonds, and mark them as set
+        quat<float> *allocateOrientations();
+
+        //! Make room for the relative angles of the bonds, and mark them as set
+        float *allocateAngles();
+
+        size_t m_num_bonds;                         //!< Number of bonds
+        unsigned int m_num_i;                       //!< Number of reference points
+        unsigned int m_num_j;                       //!< Number of points
+        bool m_sorted_by_distance;                  //!< True if the bonds of each point are sorted by distance
+        std::shared_ptr<unsigned int> m_index_i;    //!< Reference point index of each bond
+        std::shared_ptr<unsigned int> m_index_j;    //!< Point index of each bond
+        std::shared_ptr<float> m_distances;         //!< Distance of each bond
+        std::shared_ptr< vec3<float> > m_vectors;   //!< Wrapped bond vectors, optional
+        bool m_has_weights;                         //!< True if the bonds have weights
+        std::shared_ptr<float> m_weights;           //!< Weight of each bond, kept for reuse when not set
+        bool m_has_orientations;                    //!< True if the bonds have relative orientations
+        std::shared_ptr< quat<float> > m_orientations;  //!< Relative orientation of each bond, kept for reuse
+        bool m_has_angles;                          //!< True if the bonds have relative angles
+        std::shared_ptr<float> m_angles;            //!< Relative angle of each bond, kept for reuse
+        std::shared_ptr<size_t> m_segments;         //!< First bond of each reference point
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _NEIGHBORLIST_H__
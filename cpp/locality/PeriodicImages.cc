@@ -0,0 +1,125 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <string.h>
+#include <tbb/tbb.h>
+
+#include "PeriodicImages.h"
+#include "Annotation.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file PeriodicImages.cc
+    \brief Neighbor search over explicit periodic images, for cutoffs larger than half the box
+*/
+
+namespace freud { namespace locality {
+
+PeriodicImages::PeriodicImages(const box::Box& box, float rmax)
+    : m_box(box), m_rmax(rmax), m_rmaxsq(rmax*rmax), m_L(box.getL()), m_xy(box.getTiltFactorXY()),
+      m_xz(box.getTiltFactorXZ()), m_yz(box.getTiltFactorYZ()), m_reach_x(0), m_reach_y(0), m_reach_z(0)
+    {
+    if (rmax < 0.0f)
+        throw invalid_argument("rmax must not be negative");
+    uchar3 periodic = m_box.getPeriodic();
+    vec3<float> L = m_box.getNearestPlaneDistance();
+    m_a_x = m_box.getLatticeVector(0);
+    m_a_y = m_box.getLatticeVector(1);
+    m_a_z = m_box.is2D() ? vec3<float>(0, 0, 0) : m_box.getLatticeVector(2);
+    if (periodic.x)
+        m_reach_x = rmax / L.x;
+    if (periodic.y)
+        m_reach_y = rmax / L.y;
+    if (periodic.z && !m_box.is2D())
+        m_reach_z = rmax / L.z;
+    }
+
+/*! The minimum image is the only image of a point within rmax as long as rmax is no larger than half of the nearest
+    plane distance along every periodic direction, the same limit as the cell width of a LinkCell.
+*/
+bool PeriodicImages::needed(const box::Box& box, float rmax)
+    {
+    uchar3 periodic = box.getPeriodic();
+    vec3<float> L = box.getNearestPlaneDistance();
+    bool too_wide = (periodic.x && rmax > L.x/2.0f) || (periodic.y && rmax > L.y/2.0f);
+    if (!box.is2D())
+        too_wide |= periodic.z && rmax > L.z/2.0f;
+    return too_wide;
+    }
+
+bool PeriodicImages::isPeriodic(const box::Box& box)
+    {
+    uchar3 periodic = box.getPeriodic();
+    return periodic.x || periodic.y || (periodic.z && !box.is2D());
+    }
+
+void PeriodicImages::computeNlist(const vec3<float> *ref_points,
+                                  unsigned int n_ref,
+                                  const vec3<float> *points,
+                                  unsigned int Np,
+                                  bool exclude_ii,
+                                  bool store_vectors,
+                                  NeighborList& nlist) const
+    {
+    util::ScopedRange annotation("freud::PeriodicImages::computeNlist");
+
+    // count the bonds of each reference point first so that the list can be filled in parallel and in a
+    // deterministic order: bonds are sorted by i, then by j, then by image
+    std::shared_ptr<size_t> counts = std::shared_ptr<size_t>(new size_t[n_ref + 1], std::default_delete<size_t[]>());
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t num_neighbors = 0;
+            forEachNeighbor(ref_points[i], points, Np,
+                [&] (unsigned int j, const vec3<float>& delta, float rsq, bool zero_image)
+                {
+                if (!(exclude_ii && zero_image && i == j))
+                    num_neighbors++;
+                });
+            counts.get()[i] = num_neighbors;
+            }
+        });
+
+    size_t num_bonds = 0;
+    for (unsigned int i = 0; i < n_ref; i++)
+        {
+        size_t num_neighbors = counts.get()[i];
+        counts.get()[i] = num_bonds;
+        num_bonds += num_neighbors;
+        }
+    counts.get()[n_ref] = num_bonds;
+
+    nlist.resize(num_bonds, n_ref, Np, store_vectors);
+    memcpy((void*)nlist.getSegments().get(), (void*)counts.get(), sizeof(size_t)*(n_ref + 1));
+
+    unsigned int *index_i = nlist.getIndexI().get();
+    unsigned int *index_j = nlist.getIndexJ().get();
+    float *distances = nlist.getDistances().get();
+    vec3<float> *vectors = nlist.getVectors().get();
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t bond = counts.get()[i];
+            forEachNeighbor(ref_points[i], points, Np,
+                [&] (unsigned int j, const vec3<float>& delta, float rsq, bool zero_image)
+                {
+                if (exclude_ii && zero_image && i == j)
+                    return;
+                index_i[bond] = i;
+                index_j[bond] = j;
+                distances[bond] = sqrtf(rsq);
+                if (vectors != NULL)
+                    vectors[bond] = delta;
+                bond++;
+                });
+            }
+        });
+    }
+
+}; }; // end namespace freud::locality
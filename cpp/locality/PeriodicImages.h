@@ -0,0 +1,138 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+#include <memory>
+
+#include "../box/box.h"
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+#include "NeighborList.h"
+
+#ifndef _PERIODICIMAGES_H__
+#define _PERIODICIMAGES_H__
+
+/*! \file PeriodicImages.h
+    \brief Neighbor search over explicit periodic images, for cutoffs larger than half the box
+*/
+
+namespace freud { namespace locality {
+
+//! Finds the neighbors of points among all the periodic images of a set of points
+/*! LinkCell, KDTree and the minimum image convention of box::Box::wrap assume that a point has at most one image
+    within the cutoff, which holds only while the cutoff is no larger than half of the nearest plane distance along
+    every periodic direction. In smaller boxes a point sees several images of the same point, and of itself, within
+    the cutoff. Instead of replicating the points in a larger box, PeriodicImages takes the minimum image vector v of
+    every pair and enumerates the images v + t_0 a_0 + t_1 a_1 + t_2 a_2 for the lattice vectors a_k of the box. The
+    component of a vector along a_k, in units of a_k, is at most its length divided by the nearest plane distance
+    along k, so only the t_k that keep that component within rmax / L_k are visited. Non-periodic directions (see
+    box::Box::setPeriodic), and z in 2D, are never replicated.
+
+    Every pair is tested, so the search costs O(n_ref * Np * images). When a cutoff exceeds half the box, a point has
+    a sizable fraction of all points as neighbors anyway, so this is within a small factor of the size of the output.
+
+    A neighbor list then holds one bond per image, so that a pair (i, j) may appear several times with different
+    vectors and distances. With \a exclude_ii only the bond of a point to itself is dropped, not the bonds to its own
+    images.
+*/
+class PeriodicImages
+    {
+    public:
+        //! Constructor
+        PeriodicImages(const box::Box& box, float rmax);
+
+        //! Test if a cutoff reaches more than one image of a point in a box
+        static bool needed(const box::Box& box, float rmax);
+
+        //! Test if a box is periodic along any of its directions
+        static bool isPeriodic(const box::Box& box);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the cutoff radius
+        float getRMax() const
+            {
+            return m_rmax;
+            }
+
+        //! Visit every image of point p closer than rmax to ref
+        /*! \param visit Callable invoked as visit(delta, rsq, zero_image), where delta is the vector from ref to the
+                   image, rsq its squared length, and zero_image is true for the minimum image
+        */
+        template<typename Visitor>
+        void forEachImage(const vec3<float>& ref, const vec3<float>& p, Visitor visit) const
+            {
+            vec3<float> v = m_box.wrap(p - ref);
+
+            // the components of v along the lattice vectors
+            float f_z = m_reach_z > 0 ? v.z / m_L.z : 0.0f;
+            float f_y = m_reach_y > 0 ? (v.y - m_yz*v.z) / m_L.y : 0.0f;
+            float f_x = m_reach_x > 0 ? (v.x - m_xy*(v.y - m_yz*v.z) - m_xz*v.z) / m_L.x : 0.0f;
+            int t_z_min = m_reach_z > 0 ? int(ceilf(-m_reach_z - f_z)) : 0;
+            int t_z_max = m_reach_z > 0 ? int(floorf(m_reach_z - f_z)) : 0;
+            int t_y_min = m_reach_y > 0 ? int(ceilf(-m_reach_y - f_y)) : 0;
+            int t_y_max = m_reach_y > 0 ? int(floorf(m_reach_y - f_y)) : 0;
+            int t_x_min = m_reach_x > 0 ? int(ceilf(-m_reach_x - f_x)) : 0;
+            int t_x_max = m_reach_x > 0 ? int(floorf(m_reach_x - f_x)) : 0;
+
+            for (int t_z = t_z_min; t_z <= t_z_max; t_z++)
+                {
+                vec3<float> v_z = v + float(t_z)*m_a_z;
+                for (int t_y = t_y_min; t_y <= t_y_max; t_y++)
+                    {
+                    vec3<float> v_y = v_z + float(t_y)*m_a_y;
+                    for (int t_x = t_x_min; t_x <= t_x_max; t_x++)
+                        {
+                        vec3<float> delta = v_y + float(t_x)*m_a_x;
+                        float rsq = dot(delta, delta);
+                        if (rsq < m_rmaxsq)
+                            visit(delta, rsq, t_x == 0 && t_y == 0 && t_z == 0);
+                        }
+                    }
+                }
+            }
+
+        //! Visit every image of every point closer than rmax to ref
+        /*! \param visit Callable invoked as visit(j, delta, rsq, zero_image), see forEachImage()
+        */
+        template<typename Visitor>
+        void forEachNeighbor(const vec3<float>& ref, const vec3<float> *points, unsigned int Np,
+                             Visitor visit) const
+            {
+            for (unsigned int j = 0; j < Np; j++)
+                {
+                forEachImage(ref, points[j],
+                    [&] (const vec3<float>& delta, float rsq, bool zero_image)
+                    {
+                    visit(j, delta, rsq, zero_image);
+                    });
+                }
+            }
+
+        //! Compute the neighbor list of ref_points among the images of points within the cutoff radius
+        void computeNlist(const vec3<float> *ref_points, unsigned int n_ref, const vec3<float> *points,
+                          unsigned int Np, bool exclude_ii, bool store_vectors, NeighborList& nlist) const;
+
+    private:
+        box::Box m_box;             //!< Simulation box
+        float m_rmax;               //!< Cutoff radius
+        float m_rmaxsq;             //!< Squared cutoff radius
+        vec3<float> m_L;            //!< Box lengths
+        float m_xy;                 //!< Tilt factor xy
+        float m_xz;                 //!< Tilt factor xz
+        float m_yz;                 //!< Tilt factor yz
+        vec3<float> m_a_x;          //!< First lattice vector
+        vec3<float> m_a_y;          //!< Second lattice vector
+        vec3<float> m_a_z;          //!< Third lattice vector, zero in 2D
+        float m_reach_x;            //!< rmax over the nearest plane distance along x, 0 when not replicated
+        float m_reach_y;            //!< rmax over the nearest plane distance along y, 0 when not replicated
+        float m_reach_z;            //!< rmax over the nearest plane distance along z, 0 when not replicated
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _PERIODICIMAGES_H__
@@ -0,0 +1,92 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <stdexcept>
+
+#include "LinkCell.h"
+
+#ifndef _SHARED_LINKCELL_H__
+#define _SHARED_LINKCELL_H__
+
+/*! \file SharedLinkCell.h
+    \brief The cell list of an analysis, owned by it or shared with other analyses
+*/
+
+namespace freud { namespace locality {
+
+//! The cell list of an analysis, which may be shared with other analyses of the same points
+/*! An analysis owns a LinkCell of its cutoff by default, and computes it on every frame. share() replaces it with a
+    LinkCell owned by the caller, whose cell width must be at least the cutoff of the analysis; compute() then only
+    computes the cell list when it is not already that of the frame (see LinkCell::isComputedFor), so that several
+    analyses of one set of points, or the caller itself, build it once per frame.
+*/
+class SharedLinkCell
+    {
+    public:
+        //! Null constructor
+        SharedLinkCell() : m_lc(new LinkCell()), m_cell_width(0), m_shared(false)
+            {
+            }
+
+        //! Constructor of an owned LinkCell
+        SharedLinkCell(const box::Box& box, float cell_width)
+            : m_lc(new LinkCell(box, cell_width)), m_cell_width(cell_width), m_shared(false)
+            {
+            }
+
+        //! Use a LinkCell owned by the caller, or an owned one again if \a lc is NULL
+        void share(const std::shared_ptr<LinkCell>& lc)
+            {
+            if (!lc)
+                {
+                if (m_shared)
+                    m_lc = std::make_shared<LinkCell>(box::Box(), m_cell_width);
+                m_shared = false;
+                return;
+                }
+            if (lc->getCellWidth() < m_cell_width)
+                throw std::invalid_argument("The cell width of a shared LinkCell must be at least the cutoff of "
+                                            "the analysis");
+            m_lc = lc;
+            m_shared = true;
+            }
+
+        //! Get whether the LinkCell is shared
+        bool isShared() const
+            {
+            return m_shared;
+            }
+
+        //! Compute the cell list of a frame, unless it is shared and already computed for the frame
+        void compute(box::Box& box, const vec3<float> *points, unsigned int Np, bool sort_points=false)
+            {
+            if (!m_shared || !m_lc->isComputedFor(box, points, Np, sort_points))
+                m_lc->computeCellList(box, points, Np, sort_points);
+            }
+
+        //! Get the LinkCell
+        LinkCell *get() const
+            {
+            return m_lc.get();
+            }
+
+        LinkCell *operator->() const
+            {
+            return m_lc.get();
+            }
+
+        LinkCell& operator*() const
+            {
+            return *m_lc;
+            }
+
+    private:
+        std::shared_ptr<LinkCell> m_lc;     //!< Cell list, owned or shared
+        float m_cell_width;                 //!< Cutoff of the analysis
+        bool m_shared;                      //!< true if m_lc is owned by the caller
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _SHARED_LINKCELL_H__
@@ -0,0 +1,122 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <string.h>
+#include <utility>
+#include <vector>
+
+#include "SpaceFillingCurve.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file SpaceFillingCurve.cc
+    \brief Ordering of particles along a Morton or Hilbert curve through the box
+*/
+
+namespace freud { namespace locality {
+
+//! \internal
+//! Quantize a fractional coordinate, wrapped into [0, 1), to bits bits
+static uint32_t quantize(float f, unsigned int bits)
+    {
+    double w = double(f) - floor(double(f));
+    const double scale = double(uint64_t(1) << bits);
+    const uint64_t q = uint64_t(w*scale);
+    return uint32_t(std::min(q, (uint64_t(1) << bits) - 1));
+    }
+
+//! \internal
+//! Set data[k] to the former data[perm[k]] for all k, following the cycles of the permutation
+static void permute(char *data, size_t element_size, const unsigned int *perm, unsigned int n)
+    {
+    std::vector<bool> done(n, false);
+    std::vector<char> tmp(element_size);
+    for (unsigned int start = 0; start < n; start++)
+        {
+        if (done[start] || perm[start] == start)
+            continue;
+        memcpy(&tmp[0], data + size_t(start)*element_size, element_size);
+        unsigned int k = start;
+        while (true)
+            {
+            done[k] = true;
+            const unsigned int next = perm[k];
+            if (next == start)
+                {
+                memcpy(data + size_t(k)*element_size, &tmp[0], element_size);
+                break;
+                }
+            memcpy(data + size_t(k)*element_size, data + size_t(next)*element_size, element_size);
+            k = next;
+            }
+        }
+    }
+
+SpaceFillingCurve::SpaceFillingCurve(Curve curve)
+    : m_curve(curve), m_Np(0)
+    {
+    }
+
+void SpaceFillingCurve::compute(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    if (Np != m_Np || !m_order)
+        {
+        m_order = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+        m_inverse = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+        m_Np = Np;
+        }
+
+    // keys paired with the indices, so that ties keep the input order
+    std::vector< std::pair<uint64_t, unsigned int> > keys(Np);
+    std::pair<uint64_t, unsigned int> *l_keys = Np ? &keys[0] : NULL;
+    const bool is2D = box.is2D();
+    const bool hilbert = (m_curve == HILBERT);
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=, &box] (const blocked_range<size_t>& r)
+            {
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                const vec3<float> f = box.makeFraction(points[i]);
+                uint64_t key;
+                if (is2D)
+                    {
+                    const uint32_t x = quantize(f.x, 32), y = quantize(f.y, 32);
+                    key = hilbert ? hilbertKey2(x, y) : mortonKey2(x, y);
+                    }
+                else
+                    {
+                    const uint32_t x = quantize(f.x, 21), y = quantize(f.y, 21), z = quantize(f.z, 21);
+                    key = hilbert ? hilbertKey3(x, y, z) : mortonKey3(x, y, z);
+                    }
+                l_keys[i] = std::make_pair(key, (unsigned int) i);
+                }
+            });
+    parallel_sort(keys.begin(), keys.end());
+
+    unsigned int *order = m_order.get();
+    unsigned int *inverse = m_inverse.get();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+            {
+            for (size_t k = r.begin(); k != r.end(); k++)
+                {
+                order[k] = l_keys[k].second;
+                inverse[l_keys[k].second] = k;
+                }
+            });
+    }
+
+/*! The permutation is applied cycle by cycle, with one extra element and a bit per element of storage.
+*/
+void SpaceFillingCurve::reorder(void *data, size_t element_size) const
+    {
+    permute((char*) data, element_size, m_order.get(), m_Np);
+    }
+
+void SpaceFillingCurve::restore(void *data, size_t element_size) const
+    {
+    permute((char*) data, element_size, m_inverse.get(), m_Np);
+    }
+
+}; }; // end namespace freud::locality
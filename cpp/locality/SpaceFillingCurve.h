@@ -0,0 +1,174 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <stdint.h>
+#include <tbb/tbb.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+
+#ifndef _SPACE_FILLING_CURVE_H__
+#define _SPACE_FILLING_CURVE_H__
+
+/*! \file SpaceFillingCurve.h
+    \brief Ordering of particles along a Morton or Hilbert curve through the box
+*/
+
+namespace freud { namespace locality {
+
+//! Spread the 21 low bits of x to every third bit of the result
+inline uint64_t spreadBits3(uint64_t x)
+    {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffULL;
+    x = (x | x << 16) & 0x1f0000ff0000ffULL;
+    x = (x | x << 8) & 0x100f00f00f00f00fULL;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2) & 0x1249249249249249ULL;
+    return x;
+    }
+
+//! Spread the 32 low bits of x to every second bit of the result
+inline uint64_t spreadBits2(uint64_t x)
+    {
+    x &= 0xffffffffULL;
+    x = (x | x << 16) & 0x0000ffff0000ffffULL;
+    x = (x | x << 8) & 0x00ff00ff00ff00ffULL;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | x << 2) & 0x3333333333333333ULL;
+    x = (x | x << 1) & 0x5555555555555555ULL;
+    return x;
+    }
+
+//! Morton key of 3 coordinates of 21 bits, the bits of x being the most significant of each triple
+inline uint64_t mortonKey3(uint32_t x, uint32_t y, uint32_t z)
+    {
+    return (spreadBits3(x) << 2) | (spreadBits3(y) << 1) | spreadBits3(z);
+    }
+
+//! Morton key of 2 coordinates of 32 bits, the bits of x being the most significant of each pair
+inline uint64_t mortonKey2(uint32_t x, uint32_t y)
+    {
+    return (spreadBits2(x) << 1) | spreadBits2(y);
+    }
+
+//! Transform n coordinates of b bits in place to the transpose of their Hilbert index
+/*! The Hilbert index is the Morton key of the transformed coordinates, from J. Skilling, AIP Conf. Proc. 707, 381
+    (2004).
+*/
+inline void hilbertTranspose(uint32_t *X, unsigned int b, unsigned int n)
+    {
+    const uint32_t M = uint32_t(1) << (b - 1);
+    // inverse undo of the rotations and reflections
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+        {
+        const uint32_t P = Q - 1;
+        for (unsigned int i = 0; i < n; i++)
+            {
+            if (X[i] & Q)
+                X[0] ^= P;
+            else
+                {
+                const uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+                }
+            }
+        }
+    // Gray encode
+    for (unsigned int i = 1; i < n; i++)
+        X[i] ^= X[i-1];
+    uint32_t t = 0;
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+        if (X[n-1] & Q)
+            t ^= Q - 1;
+    for (unsigned int i = 0; i < n; i++)
+        X[i] ^= t;
+    }
+
+//! Hilbert key of 3 coordinates of 21 bits
+inline uint64_t hilbertKey3(uint32_t x, uint32_t y, uint32_t z)
+    {
+    uint32_t X[3] = {x, y, z};
+    hilbertTranspose(X, 21, 3);
+    return mortonKey3(X[0], X[1], X[2]);
+    }
+
+//! Hilbert key of 2 coordinates of 32 bits
+inline uint64_t hilbertKey2(uint32_t x, uint32_t y)
+    {
+    uint32_t X[2] = {x, y};
+    hilbertTranspose(X, 32, 2);
+    return mortonKey2(X[0], X[1]);
+    }
+
+//! Order particles along a space filling curve through the box
+/*! The fractional coordinates of each (wrapped) particle are quantized to 21 bits in 3D and 32 bits in 2D, and the
+    particles are sorted by the Morton (Z order) or Hilbert key of their coordinates, ties in input order. Particles
+    close along either curve are close in space, and the Hilbert curve has no long jumps, so analyses fed the
+    reordered arrays find the neighbors of consecutive particles in the same cells, and the same cache lines. The
+    keys and the sort are computed in parallel.
+
+    getOrder()[k] is the particle at position k of the curve and getInverse()[i] the position of particle i. An
+    array of the particles is reordered with reorder(), and a result computed from the reordered particles is mapped
+    back to the input order with restore().
+*/
+class SpaceFillingCurve
+    {
+    public:
+        //! Space filling curves
+        enum Curve
+            {
+            MORTON,     //!< Morton (Z order) curve
+            HILBERT     //!< Hilbert curve
+            };
+
+        //! Constructor
+        SpaceFillingCurve(Curve curve=HILBERT);
+
+        //! Get the curve
+        Curve getCurve() const
+            {
+            return m_curve;
+            }
+
+        //! Order the points along the curve through the box
+        void compute(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Get the number of points of the last compute
+        unsigned int getNp() const
+            {
+            return m_Np;
+            }
+
+        //! Get the point at each position of the curve
+        std::shared_ptr<unsigned int> getOrder()
+            {
+            return m_order;
+            }
+
+        //! Get the position of each point along the curve
+        std::shared_ptr<unsigned int> getInverse()
+            {
+            return m_inverse;
+            }
+
+        //! Reorder an array of Np elements of element_size bytes in place, into the order of the curve
+        void reorder(void *data, size_t element_size) const;
+
+        //! Reorder an array of Np elements in the order of the curve back in place, into the input order
+        void restore(void *data, size_t element_size) const;
+
+    private:
+        Curve m_curve;                          //!< Curve to order the points along
+        unsigned int m_Np;                      //!< Number of points of the last compute
+        std::shared_ptr<unsigned int> m_order;  //!< Point at each position of the curve
+        std::shared_ptr<unsigned int> m_inverse;    //!< Position of each point along the curve
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _SPACE_FILLING_CURVE_H__
@@ -0,0 +1,147 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <algorithm>
+#include <string.h>
+#include <tbb/tbb.h>
+
+#include "VerletList.h"
+#include "Annotation.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file VerletList.cc
+    \brief Neighbor list reused across trajectory frames with a Verlet skin
+*/
+
+namespace freud { namespace locality {
+
+VerletList::VerletList(float rcut, float skin)
+    : m_rcut(rcut), m_skin(skin), m_valid(false), m_exclude_ii(false), m_num_builds(0), m_box(box::Box()),
+      m_lc(box::Box(), rcut + skin)
+    {
+    if (rcut < 0.0f)
+        throw invalid_argument("rcut must not be negative");
+    if (skin < 0.0f)
+        throw invalid_argument("skin must not be negative");
+    }
+
+float VerletList::maxDisplacement(const vector< vec3<float> >& last, const vec3<float> *current,
+                                  unsigned int N) const
+    {
+    const vec3<float> *last_points = last.data();
+    return parallel_reduce(blocked_range<size_t>(0, N), 0.0f,
+        [=] (const blocked_range<size_t>& r, float max_rsq)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            vec3<float> delta = m_box.wrap(current[i] - last_points[i]);
+            max_rsq = max(max_rsq, dot(delta, delta));
+            }
+        return max_rsq;
+        },
+        [] (float a, float b)
+        {
+        return max(a, b);
+        });
+    }
+
+void VerletList::compute(const box::Box& box,
+                         const vec3<float> *ref_points,
+                         unsigned int n_ref,
+                         const vec3<float> *points,
+                         unsigned int Np,
+                         bool exclude_ii,
+                         bool store_vectors)
+    {
+    util::ScopedRange annotation("freud::VerletList::compute");
+    // the candidates can be reused while no pair can have crossed the skin
+    bool rebuild = !m_valid || (box != m_box) || (exclude_ii != m_exclude_ii) ||
+                   (n_ref != m_last_ref_points.size()) || (Np != m_last_points.size());
+    if (!rebuild)
+        {
+        float displacement = sqrtf(maxDisplacement(m_last_points, points, Np));
+        if (ref_points == points && n_ref == Np)
+            displacement *= 2.0f;
+        else
+            displacement += sqrtf(maxDisplacement(m_last_ref_points, ref_points, n_ref));
+        rebuild = displacement >= m_skin;
+        }
+
+    if (rebuild)
+        {
+        m_box = box;
+        m_lc.computeNlist(m_box, ref_points, n_ref, points, Np, exclude_ii, false);
+        m_last_ref_points.assign(ref_points, ref_points + n_ref);
+        m_last_points.assign(points, points + Np);
+        m_exclude_ii = exclude_ii;
+        m_valid = true;
+        m_num_builds++;
+        }
+
+    // filter the candidates with the current positions
+    const NeighborList *candidates = m_lc.getNlist();
+    const unsigned int *candidate_j = candidates->getIndexJ().get();
+    const float rcutsq = m_rcut * m_rcut;
+
+    std::shared_ptr<size_t> counts = std::shared_ptr<size_t>(new size_t[n_ref + 1], std::default_delete<size_t[]>());
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t num_neighbors = 0;
+            for (size_t bond = candidates->getFirstBond(i); bond < candidates->getLastBond(i); bond++)
+                {
+                vec3<float> delta = m_box.wrap(points[candidate_j[bond]] - ref_points[i]);
+                if (dot(delta, delta) < rcutsq)
+                    num_neighbors++;
+                }
+            counts.get()[i] = num_neighbors;
+            }
+        });
+
+    size_t num_bonds = 0;
+    for (unsigned int i = 0; i < n_ref; i++)
+        {
+        size_t num_neighbors = counts.get()[i];
+        counts.get()[i] = num_bonds;
+        num_bonds += num_neighbors;
+        }
+    counts.get()[n_ref] = num_bonds;
+
+    m_nlist.resize(num_bonds, n_ref, Np, store_vectors);
+    memcpy((void*)m_nlist.getSegments().get(), (void*)counts.get(), sizeof(size_t)*(n_ref + 1));
+
+    unsigned int *index_i = m_nlist.getIndexI().get();
+    unsigned int *index_j = m_nlist.getIndexJ().get();
+    float *distances = m_nlist.getDistances().get();
+    vec3<float> *vectors = m_nlist.getVectors().get();
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t out = counts.get()[i];
+            for (size_t bond = candidates->getFirstBond(i); bond < candidates->getLastBond(i); bond++)
+                {
+                unsigned int j = candidate_j[bond];
+                vec3<float> delta = m_box.wrap(points[j] - ref_points[i]);
+                float rsq = dot(delta, delta);
+                if (rsq < rcutsq)
+                    {
+                    index_i[out] = i;
+                    index_j[out] = j;
+                    distances[out] = sqrtf(rsq);
+                    if (vectors != NULL)
+                        vectors[out] = delta;
+                    out++;
+                    }
+                }
+            }
+        });
+    }
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,92 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <vector>
+
+#include "../box/box.h"
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+#include "LinkCell.h"
+#include "NeighborList.h"
+
+#ifndef _VERLETLIST_H__
+#define _VERLETLIST_H__
+
+/*! \file VerletList.h
+    \brief Neighbor list reused across trajectory frames with a Verlet skin
+*/
+
+namespace freud { namespace locality {
+
+//! Computes neighbor lists for consecutive frames of a trajectory, rebuilding the pairs only when needed
+/*! Between consecutive frames of a trajectory the particles barely move, so the pairs within the cutoff hardly
+    change. A VerletList builds a candidate list of all pairs within \a rcut + \a skin with a LinkCell and keeps the
+    positions it was built from. On each compute() it tracks the largest displacement of the reference points and
+    of the points since that build; while the sum of the two is smaller than the skin, no pair can have moved from
+    outside rcut + skin to inside rcut, and the neighbor list is obtained by filtering the candidates with the
+    current positions. Otherwise, or when the box or the number of points changed, the candidates are rebuilt.
+
+    The resulting neighbor list (getNlist()) contains exactly the pairs closer than \a rcut, the same as
+    LinkCell::computeNlist with a cell width of \a rcut, and may be passed to any method that takes a \a nlist.
+*/
+class VerletList
+    {
+    public:
+        //! Constructor
+        VerletList(float rcut, float skin);
+
+        //! Get the cutoff radius
+        float getRCut() const
+            {
+            return m_rcut;
+            }
+
+        //! Get the skin distance
+        float getSkin() const
+            {
+            return m_skin;
+            }
+
+        //! Get the number of times the candidate list has been built
+        unsigned int getNumBuilds() const
+            {
+            return m_num_builds;
+            }
+
+        //! Force the candidate list to be rebuilt on the next compute
+        void reset()
+            {
+            m_valid = false;
+            }
+
+        //! Compute the neighbor list of ref_points among points for the current frame
+        void compute(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                     const vec3<float> *points, unsigned int Np, bool exclude_ii, bool store_vectors);
+
+        //! Get the neighbor list last computed
+        NeighborList *getNlist()
+            {
+            return &m_nlist;
+            }
+
+    private:
+        //! Largest displacement since the last build of a set of positions
+        float maxDisplacement(const std::vector< vec3<float> >& last, const vec3<float> *current,
+                              unsigned int N) const;
+
+        float m_rcut;                                   //!< Cutoff radius of the neighbor list
+        float m_skin;                                   //!< Extra distance included in the candidate list
+        bool m_valid;                                   //!< True when the candidate list may be reused
+        bool m_exclude_ii;                              //!< exclude_ii used for the last build
+        unsigned int m_num_builds;                      //!< Number of candidate list builds
+        box::Box m_box;                                 //!< Box of the last build
+        LinkCell m_lc;                                  //!< Cell list used to build the candidates
+        std::vector< vec3<float> > m_last_ref_points;   //!< Reference points at the last build
+        std::vector< vec3<float> > m_last_points;       //!< Points at the last build
+        NeighborList m_nlist;                           //!< Neighbor list of the current frame
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _VERLETLIST_H__
@@ -0,0 +1,162 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "WorkPartition.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file WorkPartition.cc
+    \brief Splitting of the parallel loops over reference points by their estimated work
+*/
+
+namespace freud { namespace locality {
+
+/*! The reference points are counting sorted by cell, and each costs one plus the number of points in the neighbor
+    cells of its cell.
+*/
+void WorkPartition::splitByCell(const LinkCell& lc, const vec3<float> *ref_points, unsigned int n_ref,
+                                size_t num_chunks)
+    {
+    const unsigned int num_cells = lc.getNumCells();
+    const unsigned int *cell_start = lc.getCellStart().get();
+    sortByCell(lc, ref_points, n_ref);
+
+    m_prefix.resize(size_t(n_ref) + 1);
+    m_prefix[0] = 0;
+    for (unsigned int cell = 0; cell < num_cells; cell++)
+        {
+        unsigned int neighbors = 0;
+        const CellNeighbors& neigh_cells = lc.getCellNeighbors(cell);
+        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+            neighbors += cell_start[neigh_cells[neigh_idx] + 1] - cell_start[neigh_cells[neigh_idx]];
+        for (unsigned int pos = m_cell_start[cell]; pos < m_cell_start[cell + 1]; pos++)
+            m_prefix[pos + 1] = m_prefix[pos] + 1.0 + neighbors;
+        }
+    setBounds(num_chunks);
+    }
+
+/*! Every block costs its number of pairs plus its number of reference points. The pairs of a cell are one block
+    if they are at most the work of a range, the total over num_chunks; otherwise each neighbor cell makes a block,
+    itself cut into about as many pieces as it exceeds that work: first by its reference points, then by its points.
+*/
+void WorkPartition::splitPairBlocks(const LinkCell& lc, const vec3<float> *ref_points, unsigned int n_ref,
+                                    size_t num_chunks)
+    {
+    const unsigned int num_cells = lc.getNumCells();
+    const unsigned int *cell_start = lc.getCellStart().get();
+    sortByCell(lc, ref_points, n_ref);
+
+    // the points in the neighbor cells of each cell, and the pairs of all the cells
+    vector<unsigned int> neighbors(num_cells, 0);
+    double total = 0.0;
+    for (unsigned int cell = 0; cell < num_cells; cell++)
+        {
+        unsigned int num_ref = m_cell_start[cell + 1] - m_cell_start[cell];
+        if (num_ref == 0)
+            continue;
+        const CellNeighbors& neigh_cells = lc.getCellNeighbors(cell);
+        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+            neighbors[cell] += cell_start[neigh_cells[neigh_idx] + 1] - cell_start[neigh_cells[neigh_idx]];
+        total += double(num_ref)*neighbors[cell];
+        }
+    const double max_pairs = std::max(total/std::max(num_chunks, (size_t) 1), PAIR_BLOCK_MIN_PAIRS);
+
+    m_blocks.clear();
+    m_prefix.assign(1, 0.0);
+    for (unsigned int cell = 0; cell < num_cells; cell++)
+        {
+        const unsigned int ref_begin = m_cell_start[cell];
+        const unsigned int num_ref = m_cell_start[cell + 1] - ref_begin;
+        if (num_ref == 0)
+            continue;
+        if (double(num_ref)*neighbors[cell] <= max_pairs)
+            {
+            PairBlock block = {cell, ref_begin, ref_begin + num_ref, ALL_NEIGHBOR_CELLS, 0, 0};
+            m_blocks.push_back(block);
+            m_prefix.push_back(m_prefix.back() + double(num_ref)*(1.0 + neighbors[cell]));
+            continue;
+            }
+
+        const CellNeighbors& neigh_cells = lc.getCellNeighbors(cell);
+        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+            {
+            const unsigned int begin = cell_start[neigh_cells[neigh_idx]];
+            const unsigned int num_points = cell_start[neigh_cells[neigh_idx] + 1] - begin;
+            if (num_points == 0)
+                continue;
+            const double pairs = double(num_ref)*num_points;
+            const unsigned int num_pieces = (unsigned int) std::ceil(pairs/max_pairs);
+            const unsigned int ref_pieces = std::min(num_ref, num_pieces);
+            const unsigned int point_pieces = std::min(num_points, (num_pieces + ref_pieces - 1)/ref_pieces);
+            for (unsigned int a = 0; a < ref_pieces; a++)
+                for (unsigned int b = 0; b < point_pieces; b++)
+                    {
+                    PairBlock block = {cell, ref_begin + (unsigned int) (size_t(num_ref)*a/ref_pieces),
+                                       ref_begin + (unsigned int) (size_t(num_ref)*(a + 1)/ref_pieces), neigh_idx,
+                                       begin + (unsigned int) (size_t(num_points)*b/point_pieces),
+                                       begin + (unsigned int) (size_t(num_points)*(b + 1)/point_pieces)};
+                    m_blocks.push_back(block);
+                    const double block_ref = block.ref_end - block.ref_begin;
+                    m_prefix.push_back(m_prefix.back() + block_ref*(1.0 + block.end - block.begin));
+                    }
+            }
+        }
+    setBounds(num_chunks);
+    }
+
+const unsigned int *WorkPartition::orderByCell(const LinkCell& lc, const vec3<float> *ref_points,
+                                               unsigned int n_ref, const vec3<float> *points, unsigned int n_p)
+    {
+    if (ref_points == points && n_ref == n_p)
+        return lc.getCellParticles().get();
+    sortByCell(lc, ref_points, n_ref);
+    return getOrder();
+    }
+
+void WorkPartition::sortByCell(const LinkCell& lc, const vec3<float> *ref_points, unsigned int n_ref)
+    {
+    const unsigned int num_cells = lc.getNumCells();
+
+    m_cells.resize(n_ref);
+    unsigned int *cells = n_ref ? &m_cells[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=, &lc] (const blocked_range<size_t>& r)
+            {
+            for (size_t i = r.begin(); i != r.end(); i++)
+                cells[i] = lc.getCell(ref_points[i]);
+            });
+
+    m_cell_start.assign(num_cells + 1, 0);
+    for (unsigned int i = 0; i < n_ref; i++)
+        m_cell_start[m_cells[i] + 1]++;
+    for (unsigned int cell = 0; cell < num_cells; cell++)
+        m_cell_start[cell + 1] += m_cell_start[cell];
+
+    m_order.resize(n_ref);
+    vector<unsigned int> next(m_cell_start.begin(), m_cell_start.end() - 1);
+    for (unsigned int i = 0; i < n_ref; i++)
+        m_order[next[m_cells[i]]++] = i;
+    }
+
+void WorkPartition::setBounds(size_t num_chunks)
+    {
+    const size_t n = m_prefix.size() - 1;
+    num_chunks = std::max(std::min(num_chunks, n), (size_t) 1);
+    const double total = m_prefix[n];
+    m_bounds.resize(num_chunks + 1);
+    m_bounds[0] = 0;
+    for (size_t k = 1; k < num_chunks; k++)
+        {
+        // first position the work before which reaches k/num_chunks of the total
+        m_bounds[k] = std::lower_bound(m_prefix.begin() + m_bounds[k-1], m_prefix.end(),
+                                       total*k/num_chunks) - m_prefix.begin();
+        m_bounds[k] = std::min(m_bounds[k], n);
+        }
+    m_bounds[num_chunks] = n;
+    }
+
+}; }; // end namespace freud::locality
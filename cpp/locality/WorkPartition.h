@@ -0,0 +1,263 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <vector>
+#include <tbb/tbb.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "Annotation.h"
+#include "LinkCell.h"
+
+#ifndef _WORK_PARTITION_H__
+#define _WORK_PARTITION_H__
+
+/*! \file WorkPartition.h
+    \brief Splitting of the parallel loops over reference points by their estimated work
+*/
+
+namespace freud { namespace locality {
+
+//! How a parallel loop over reference points is split between the threads
+enum PartitionMode
+    {
+    PARTITION_AUTO,         //!< blocked_range of the reference points and the auto_partitioner
+    PARTITION_COST,         //!< Reference points ordered by cell, split in ranges of equal estimated pair work
+    PARTITION_AFFINITY,     //!< affinity_partitioner kept across frames, so each thread gets the same points again
+    PARTITION_PAIR_BLOCKS   //!< Pairs of each cell with its neighbor cells in blocks, those of dense cells split
+    };
+
+//! Neighbor index of a PairBlock covering all the neighbor cells of its cell
+const unsigned int ALL_NEIGHBOR_CELLS = 0xffffffff;
+
+//! The pairs between a range of the reference points of a cell and the points of its neighbor cells
+/*! A block covers either all the neighbor cells of the cell, or the range [begin, end) of the sorted points of the
+    cell list, in the neighbor cell neigh_idx of the stencil of the cell.
+*/
+struct PairBlock
+    {
+    unsigned int cell;          //!< Cell of the reference points
+    unsigned int ref_begin;     //!< First position of the reference points in the cell order
+    unsigned int ref_end;       //!< Position after the last reference point
+    unsigned int neigh_idx;     //!< Index of the neighbor cell in the stencil of the cell, or ALL_NEIGHBOR_CELLS
+    unsigned int begin;         //!< First sorted point of the neighbor cell in the block
+    unsigned int end;           //!< Sorted point after the last one of the block
+    };
+
+//! Ranges of about equal estimated work of a loop over reference points
+/*! The auto_partitioner splits the reference points in ranges of about equal numbers of points, which leaves
+    threads idle in inhomogeneous systems, where the points of a dense region have many more pairs. A WorkPartition
+    instead estimates the work of each reference point and cuts the loop into getNumChunks() contiguous ranges of
+    about equal total work, several per thread so that the scheduler can still steal.
+
+    With splitByCell(), the reference points are ordered by their cell of a LinkCell and the work of a point is the
+    number of points in the neighbor cells of its cell, which also makes the points of consecutive iterations share
+    their neighbor cells in cache; position k of the loop is then reference point getOrder()[k]. The arrays are
+    kept, and reused by the next split of the same size.
+
+    splitPairBlocks() goes below the granularity of one reference point, for strongly clustered systems where a few
+    cells hold most of the points: the pairs between the reference points of a cell and the points of its neighbor
+    cells make one PairBlock, unless they are more than the work of a range, in which case they are split by
+    neighbor cell, then by reference points and points, so that no block exceeds it. The blocks are then cut into
+    ranges of about equal numbers of pairs as the reference points are, and parallelForPairBlocks() hands the ranges
+    to the work stealing scheduler. The pairs of one reference point may then be found by several threads, so only
+    the loops that add them to per-thread state, as histograms, can be split that way.
+
+    orderByCell() only orders the reference points by cell, for the loops that keep the auto_partitioner, so that
+    the points of one task share their neighbor cells; inputs scrambled by the domain decomposition of an MD engine
+    otherwise have each point of a task in an unrelated part of the box. The cells are in the order of the LinkCell,
+    so consecutive cells are adjacent along x and their stencils overlap.
+*/
+class WorkPartition
+    {
+    public:
+        //! Constructor
+        WorkPartition()
+            {
+            }
+
+        //! Split the loop over n items, item i costing cost(i)
+        template<class Cost>
+        void split(size_t n, const Cost& cost, size_t num_chunks);
+
+        //! Split the loop over the reference points, ordered by their cell of lc
+        void splitByCell(const LinkCell& lc, const vec3<float> *ref_points, unsigned int n_ref, size_t num_chunks);
+
+        //! Split the pairs between the reference points and the points of the cell list lc in pair blocks
+        /*! The ranges of getChunk() are then ranges of the blocks, and parallelFor() must not be used.
+        */
+        void splitPairBlocks(const LinkCell& lc, const vec3<float> *ref_points, unsigned int n_ref,
+                             size_t num_chunks);
+
+        //! Get the number of pair blocks of the last splitPairBlocks()
+        size_t getNumPairBlocks() const
+            {
+            return m_blocks.size();
+            }
+
+        //! Order the reference points by their cell of lc, the cell list of \a points
+        /*! \returns The reference point at each position of the loop; when the reference points are the points, it
+                     is the order of the cell list itself and nothing is computed
+        */
+        const unsigned int *orderByCell(const LinkCell& lc, const vec3<float> *ref_points, unsigned int n_ref,
+                                        const vec3<float> *points, unsigned int n_p);
+
+        //! Get the order of the items, or NULL if it is the identity
+        const unsigned int *getOrder() const
+            {
+            return m_order.empty() ? NULL : &m_order[0];
+            }
+
+        //! Get the number of ranges
+        size_t getNumChunks() const
+            {
+            return m_bounds.size() - 1;
+            }
+
+        //! Get the positions [first, last) of range k in the loop
+        tbb::blocked_range<size_t> getChunk(size_t k) const
+            {
+            return tbb::blocked_range<size_t>(m_bounds[k], m_bounds[k+1]);
+            }
+
+        //! Run body(positions, order) on every range in parallel, order being getOrder()
+        template<class Body>
+        void parallelFor(const Body& body) const;
+
+        //! Run body(first, last, order) on every range of the pair blocks in parallel, order being getOrder()
+        template<class Body>
+        void parallelForPairBlocks(const Body& body) const;
+
+    private:
+        //! Counting sort the reference points by their cell of lc into m_order and m_cell_start
+        void sortByCell(const LinkCell& lc, const vec3<float> *ref_points, unsigned int n_ref);
+
+        //! Cut the prefix sums of the work into num_chunks ranges
+        void setBounds(size_t num_chunks);
+
+        std::vector<unsigned int> m_order;      //!< Item at each position of the loop, empty for the identity
+        std::vector<unsigned int> m_cells;      //!< Cell of each reference point
+        std::vector<unsigned int> m_cell_start; //!< First position of the reference points of each cell
+        std::vector<double> m_prefix;           //!< Work of the positions before each position
+        std::vector<size_t> m_bounds;           //!< First position of each range, then the number of positions
+        std::vector<PairBlock> m_blocks;        //!< Pair blocks of the last splitPairBlocks()
+    };
+
+//! Number of ranges a loop of a WorkPartition is cut into per thread
+const size_t WORK_PARTITION_CHUNKS_PER_THREAD = 8;
+
+//! Number of ranges for a loop of a WorkPartition run by the threads of the current arena
+inline size_t defaultNumChunks()
+    {
+    return WORK_PARTITION_CHUNKS_PER_THREAD*tbb::this_task_arena::max_concurrency();
+    }
+
+//! Smallest number of reference points for which the loops are run in cell order, when it is enabled
+const unsigned int CELL_ORDER_MIN_POINTS = 4096;
+
+//! Number of pairs below which a pair block is never split, as smaller tasks would cost more to schedule
+const double PAIR_BLOCK_MIN_PAIRS = 4096.0;
+
+//! Call visit(i, begin, end) for every reference point i of the pair blocks [first, last) and every range of the
+//! sorted points [begin, end) of its neighbor cells in the block
+/*! This is the traversal every loop over pair blocks shares: the visitor finds the pairs between reference point i
+    and the sorted points, as the loops over reference points do for each of their neighbor cells.
+*/
+template<class Visitor>
+void forEachPairBlockRange(const LinkCell& lc, const PairBlock *first, const PairBlock *last,
+                           const unsigned int *order, Visitor visit)
+    {
+    const unsigned int *cell_start = lc.getCellStart().get();
+    for (const PairBlock *block = first; block != last; ++block)
+        {
+        if (block->neigh_idx != ALL_NEIGHBOR_CELLS)
+            {
+            for (unsigned int pos = block->ref_begin; pos != block->ref_end; pos++)
+                visit(order[pos], block->begin, block->end);
+            continue;
+            }
+        const CellNeighbors& neigh_cells = lc.getCellNeighbors(block->cell);
+        for (unsigned int pos = block->ref_begin; pos != block->ref_end; pos++)
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                visit(order[pos], cell_start[neigh_cells[neigh_idx]], cell_start[neigh_cells[neigh_idx] + 1]);
+        }
+    }
+
+//! Run body(positions, order) over [0, n) in parallel, split as given by the mode
+/*! \param order Item at each position for PARTITION_AUTO and PARTITION_AFFINITY, or NULL for the identity
+    \param partition Partition to split with for PARTITION_COST, already split (and ordered)
+    \param affinity Partitioner kept across frames for PARTITION_AFFINITY
+    \param name Name of the range every task opens around body, for the ITT and NVTX annotations
+
+    PARTITION_PAIR_BLOCKS splits pairs rather than positions: the loops that support it call
+    WorkPartition::parallelForPairBlocks() themselves, and here it falls back to the auto_partitioner.
+*/
+template<class Body>
+void parallelForPartitioned(PartitionMode mode, size_t n, const unsigned int *order, const WorkPartition *partition,
+                            tbb::affinity_partitioner *affinity, const char *name, const Body& body)
+    {
+    auto named_body = [&body, name] (const tbb::blocked_range<size_t>& r, const unsigned int *order)
+        {
+        util::ScopedRange annotation(name);
+        body(r, order);
+        };
+    if (mode == PARTITION_COST)
+        partition->parallelFor(named_body);
+    else if (mode == PARTITION_AFFINITY)
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+            [&named_body, order] (const tbb::blocked_range<size_t>& r) { named_body(r, order); }, *affinity);
+    else
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+            [&named_body, order] (const tbb::blocked_range<size_t>& r) { named_body(r, order); });
+    }
+
+template<class Cost>
+void WorkPartition::split(size_t n, const Cost& cost, size_t num_chunks)
+    {
+    m_order.clear();
+    m_prefix.resize(n + 1);
+    m_prefix[0] = 0;
+    for (size_t i = 0; i < n; i++)
+        m_prefix[i+1] = m_prefix[i] + cost(i);
+    setBounds(num_chunks);
+    }
+
+template<class Body>
+void WorkPartition::parallelFor(const Body& body) const
+    {
+    const unsigned int *order = getOrder();
+    // one range per task: the ranges are already balanced
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, getNumChunks(), 1),
+        [=, &body] (const tbb::blocked_range<size_t>& r)
+            {
+            for (size_t k = r.begin(); k != r.end(); k++)
+                {
+                const tbb::blocked_range<size_t> positions(getChunk(k));
+                if (!positions.empty())
+                    body(positions, order);
+                }
+            }, tbb::simple_partitioner());
+    }
+
+template<class Body>
+void WorkPartition::parallelForPairBlocks(const Body& body) const
+    {
+    const unsigned int *order = getOrder();
+    const PairBlock *blocks = m_blocks.empty() ? NULL : &m_blocks[0];
+    // one range per task: the ranges are already balanced, and the idle threads steal the remaining ones
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, getNumChunks(), 1),
+        [=, &body] (const tbb::blocked_range<size_t>& r)
+            {
+            for (size_t k = r.begin(); k != r.end(); k++)
+                {
+                const tbb::blocked_range<size_t> range(getChunk(k));
+                if (!range.empty())
+                    body(blocks + range.begin(), blocks + range.end(), order);
+                }
+            }, tbb::simple_partitioner());
+    }
+
+}; }; // end namespace freud::locality
+
+#endif // _WORK_PARTITION_H__
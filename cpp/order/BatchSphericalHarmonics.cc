@@ -0,0 +1,144 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "BatchSphericalHarmonics.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+/*! \file BatchSphericalHarmonics.cc
+    \brief Spherical harmonics of blocks of bonds, from their Cartesian components
+*/
+
+namespace freud { namespace order {
+
+const unsigned int BatchSphericalHarmonics::block_size;
+
+BatchSphericalHarmonics::BatchSphericalHarmonics(unsigned int lmax)
+    : m_lmax(lmax), m_n(0), m_a(index(lmax, lmax) + 1, 0), m_b(index(lmax, lmax) + 1, 0), m_pmm(lmax + 1),
+      m_x(block_size), m_y(block_size), m_z(block_size), m_pow_re((lmax + 1)*block_size),
+      m_pow_im((lmax + 1)*block_size), m_re((index(lmax, lmax) + 1)*block_size), m_im((index(lmax, lmax) + 1)*block_size)
+    {
+    // P_m^m = sqrt((2m + 1)/(4 pi (2m)!)) (2m - 1)!!, without the sin^m theta factor
+    double pmm = sqrt(1.0/(4.0*M_PI));
+    m_pmm[0] = pmm;
+    for (unsigned int m = 1; m <= lmax; m++)
+        {
+        pmm *= sqrt((2.0*m + 1.0)/(2.0*m));
+        m_pmm[m] = pmm;
+        }
+    // P_l^m = a (z P_{l-1}^m - b P_{l-2}^m) for l >= m + 2
+    for (unsigned int m = 0; m <= lmax; m++)
+        for (unsigned int l = m + 2; l <= lmax; l++)
+            {
+            double l2 = double(l)*l, m2 = double(m)*m, lm1 = double(l - 1)*(l - 1);
+            m_a[index(l, m)] = sqrt((4.0*l2 - 1.0)/(l2 - m2));
+            m_b[index(l, m)] = sqrt((lm1 - m2)/(4.0*lm1 - 1.0));
+            }
+    }
+
+void BatchSphericalHarmonics::compute(const vec3<float> *bonds, unsigned int n)
+    {
+    if (n > block_size)
+        throw invalid_argument("BatchSphericalHarmonics evaluates at most block_size bonds at once");
+    m_n = n;
+    const unsigned int B = block_size;
+    float *x = &m_x[0];
+    float *y = &m_y[0];
+    float *z = &m_z[0];
+    float *pow_re = &m_pow_re[0];
+    float *pow_im = &m_pow_im[0];
+    float *re = &m_re[0];
+    float *im = &m_im[0];
+
+    // the unit vectors
+    for (unsigned int b = 0; b < n; b++)
+        {
+        vec3<float> v = bonds[b];
+        float inv_r = 1.0f/sqrtf(dot(v, v));
+        x[b] = v.x*inv_r;
+        y[b] = v.y*inv_r;
+        z[b] = v.z*inv_r;
+        }
+
+    // (x + iy)^m = sin^m theta e^{i m phi}
+    for (unsigned int b = 0; b < n; b++)
+        {
+        pow_re[b] = 1.0f;
+        pow_im[b] = 0.0f;
+        }
+    for (unsigned int m = 1; m <= m_lmax; m++)
+        {
+        const float *prev_re = pow_re + (m - 1)*B;
+        const float *prev_im = pow_im + (m - 1)*B;
+        float *cur_re = pow_re + m*B;
+        float *cur_im = pow_im + m*B;
+        for (unsigned int b = 0; b < n; b++)
+            {
+            cur_re[b] = prev_re[b]*x[b] - prev_im[b]*y[b];
+            cur_im[b] = prev_re[b]*y[b] + prev_im[b]*x[b];
+            }
+        }
+
+    // the Legendre functions of each m by increasing l, times (x + iy)^m
+    float p_prev[block_size], p_cur[block_size];
+    for (unsigned int m = 0; m <= m_lmax; m++)
+        {
+        const float *m_pow_re_b = pow_re + m*B;
+        const float *m_pow_im_b = pow_im + m*B;
+        const float pmm = m_pmm[m];
+        float *Y_re = re + index(m, m)*B;
+        float *Y_im = im + index(m, m)*B;
+        for (unsigned int b = 0; b < n; b++)
+            {
+            p_prev[b] = pmm;
+            Y_re[b] = pmm*m_pow_re_b[b];
+            Y_im[b] = pmm*m_pow_im_b[b];
+            }
+        if (m == m_lmax)
+            break;
+        const float c = sqrtf(2.0f*m + 3.0f);
+        Y_re = re + index(m + 1, m)*B;
+        Y_im = im + index(m + 1, m)*B;
+        for (unsigned int b = 0; b < n; b++)
+            {
+            p_cur[b] = c*z[b]*p_prev[b];
+            Y_re[b] = p_cur[b]*m_pow_re_b[b];
+            Y_im[b] = p_cur[b]*m_pow_im_b[b];
+            }
+        for (unsigned int l = m + 2; l <= m_lmax; l++)
+            {
+            const float a = m_a[index(l, m)];
+            const float bb = m_b[index(l, m)];
+            Y_re = re + index(l, m)*B;
+            Y_im = im + index(l, m)*B;
+            for (unsigned int b = 0; b < n; b++)
+                {
+                float p_next = a*(z[b]*p_cur[b] - bb*p_prev[b]);
+                p_prev[b] = p_cur[b];
+                p_cur[b] = p_next;
+                Y_re[b] = p_next*m_pow_re_b[b];
+                Y_im[b] = p_next*m_pow_im_b[b];
+                }
+            }
+        }
+    }
+
+std::complex<float> BatchSphericalHarmonics::sum(unsigned int l, int m) const
+    {
+    unsigned int am = (m < 0) ? -m : m;
+    const float *Y_re = &m_re[index(l, am)*block_size];
+    const float *Y_im = &m_im[index(l, am)*block_size];
+    float sum_re = 0, sum_im = 0;
+    for (unsigned int b = 0; b < m_n; b++)
+        {
+        sum_re += Y_re[b];
+        sum_im += Y_im[b];
+        }
+    if (m >= 0)
+        return std::complex<float>(sum_re, sum_im);
+    return (am % 2) ? std::complex<float>(-sum_re, sum_im) : std::complex<float>(sum_re, -sum_im);
+    }
+
+}; }; // end namespace freud::order
@@ -0,0 +1,96 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <complex>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#ifndef _BATCH_SPHERICAL_HARMONICS_H__
+#define _BATCH_SPHERICAL_HARMONICS_H__
+
+/*! \file BatchSphericalHarmonics.h
+    \brief Spherical harmonics of blocks of bonds, from their Cartesian components
+*/
+
+namespace freud { namespace order {
+
+//! Evaluate the spherical harmonics Y_l^m, 0 <= l <= lmax, of a block of bond vectors at once
+/*! The harmonics are computed from the unit vector (x, y, z) of each bond instead of its angles: with
+    \f$ \cos\theta = z \f$ and \f$ \sin\theta e^{i\phi} = x + iy \f$,
+    \f[ Y_l^m = \bar{P}_l^m(z) (x + iy)^m \f]
+    for m >= 0, where \f$ \bar{P}_l^m \f$ is the normalized associated Legendre function divided by
+    \f$ \sin^m\theta \f$, a polynomial in z found by the usual three term recurrence in l. No acos, atan2, sin or
+    cos is evaluated, only a square root per bond to normalize it.
+
+    The convention is the one of fsph: there is no Condon-Shortley phase, and \f$ Y_l^{-m} = (-1)^m
+    \overline{Y_l^m} \f$. The theta and phi arguments of fsph are the polar and the azimuthal angles of the bond.
+
+    The values are stored by (l, m), then by bond, so every loop runs over the bonds of the block and is vectorized
+    by the compiler. Each thread needs its own BatchSphericalHarmonics; blocks of up to block_size bonds are
+    evaluated at once, and a particle with more bonds is handled in several blocks.
+*/
+class BatchSphericalHarmonics
+    {
+    public:
+        //! Largest number of bonds of one block
+        static const unsigned int block_size = 32;
+
+        //! Constructor
+        /*! \param lmax largest spherical harmonic number
+        */
+        BatchSphericalHarmonics(unsigned int lmax);
+
+        //! Get the largest spherical harmonic number
+        unsigned int getLMax() const
+            {
+            return m_lmax;
+            }
+
+        //! Get the number of bonds of the last block
+        unsigned int getNumBonds() const
+            {
+            return m_n;
+            }
+
+        //! Evaluate the harmonics of n <= block_size bonds, which need not be unit vectors
+        void compute(const vec3<float> *bonds, unsigned int n);
+
+        //! Get Y_l^m of bond b of the last block, for -l <= m <= l
+        std::complex<float> get(unsigned int l, int m, unsigned int b) const
+            {
+            unsigned int am = (m < 0) ? -m : m;
+            const unsigned int k = index(l, am)*block_size + b;
+            if (m >= 0)
+                return std::complex<float>(m_re[k], m_im[k]);
+            return (am % 2) ? std::complex<float>(-m_re[k], m_im[k]) : std::complex<float>(m_re[k], -m_im[k]);
+            }
+
+        //! Get the sum of Y_l^m over the bonds of the last block, for -l <= m <= l
+        std::complex<float> sum(unsigned int l, int m) const;
+
+    private:
+        //! Index of (l, m >= 0)
+        static unsigned int index(unsigned int l, unsigned int m)
+            {
+            return l*(l+1)/2 + m;
+            }
+
+        unsigned int m_lmax;                //!< Largest spherical harmonic number
+        unsigned int m_n;                   //!< Number of bonds of the last block
+        std::vector<float> m_a;             //!< First coefficient of the recurrence of each (l, m)
+        std::vector<float> m_b;             //!< Second coefficient of the recurrence of each (l, m)
+        std::vector<float> m_pmm;           //!< Normalized reduced Legendre function of each (m, m)
+        std::vector<float> m_x;             //!< x of the unit vector of each bond
+        std::vector<float> m_y;             //!< y of the unit vector of each bond
+        std::vector<float> m_z;             //!< z of the unit vector of each bond
+        std::vector<float> m_pow_re;        //!< Real part of (x + iy)^m, by m then bond
+        std::vector<float> m_pow_im;        //!< Imaginary part of (x + iy)^m, by m then bond
+        std::vector<float> m_re;            //!< Real part of Y_l^m, by (l, m) then bond
+        std::vector<float> m_im;            //!< Imaginary part of Y_l^m, by (l, m) then bond
+    };
+
+}; }; // end namespace freud::order
+
+#endif // _BATCH_SPHERICAL_HARMONICS_H__
@@ -0,0 +1,409 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "BondHarmonics.h"
+#include "FixedSphericalHarmonics.h"
+#include "wigner3j.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file BondHarmonics.cc
+    \brief Averages of the spherical harmonics of the bonds of each particle, shared by the Ql and Wl classes
+*/
+
+namespace freud { namespace order {
+
+const unsigned int BondHarmonics::chunk_size;
+
+BondHarmonics::BondHarmonics(unsigned int l, bool full_m)
+    : m_l(l), m_full_m(full_m), m_Np(0), m_local_sph(BatchSphericalHarmonics(l)),
+      m_local_Qlm(std::vector< complex<float> >(2*l+1))
+    {
+    }
+
+void BondHarmonics::evaluate(const BatchSphericalHarmonics& sph, unsigned int b, complex<float> *Y) const
+    {
+    if (m_full_m)
+        {
+        for (unsigned int m = 0; m <= m_l; m++)
+            Y[m] = sph.get(m_l, m, b);
+        for (unsigned int m = 1; m <= m_l; m++)
+            Y[m_l+m] = sph.get(m_l, -int(m), b);
+        }
+    else
+        {
+        for (unsigned int m = 0; m <= m_l; m++)
+            Y[m_l+m] = sph.get(m_l, m, b);
+        for (unsigned int m = 1; m <= m_l; m++)
+            Y[m_l-m] = Y[m_l+m];
+        }
+    }
+
+void BondHarmonics::evaluate(float theta, float phi, complex<float> *Y) const
+    {
+    BatchSphericalHarmonics sph(m_l);
+    vec3<float> bond(sin(theta)*cos(phi), sin(theta)*sin(phi), cos(theta));
+    sph.compute(&bond, 1);
+    evaluate(sph, 0, Y);
+    }
+
+void BondHarmonics::accumulate(const BatchSphericalHarmonics& sph, complex<float> *Qlm) const
+    {
+    if (m_full_m)
+        {
+        for (unsigned int m = 0; m <= m_l; m++)
+            Qlm[m] += sph.sum(m_l, m);
+        for (unsigned int m = 1; m <= m_l; m++)
+            Qlm[m_l+m] += sph.sum(m_l, -int(m));
+        }
+    else
+        {
+        for (unsigned int m = 0; m <= m_l; m++)
+            {
+            complex<float> sum = sph.sum(m_l, m);
+            Qlm[m_l+m] += sum;
+            if (m > 0)
+                Qlm[m_l-m] += sum;
+            }
+        }
+    }
+
+void BondHarmonics::accumulate(BatchSphericalHarmonics& sph, const vec3<float> *bonds, unsigned int n,
+                               complex<float> *Qlm) const
+    {
+    switch (m_l)
+        {
+        case 4:
+            accumulateFixed<4>(bonds, n, Qlm);
+            break;
+        case 6:
+            accumulateFixed<6>(bonds, n, Qlm);
+            break;
+        case 8:
+            accumulateFixed<8>(bonds, n, Qlm);
+            break;
+        case 10:
+            accumulateFixed<10>(bonds, n, Qlm);
+            break;
+        case 12:
+            accumulateFixed<12>(bonds, n, Qlm);
+            break;
+        default:
+            sph.compute(bonds, n);
+            accumulate(sph, Qlm);
+        }
+    }
+
+template<unsigned int L>
+void BondHarmonics::accumulateFixed(const vec3<float> *bonds, unsigned int n, complex<float> *Qlm) const
+    {
+    typename FixedSphericalHarmonics<L>::Sums sum_re, sum_im;
+    FixedSphericalHarmonics<L>::get().sum(bonds, n, sum_re, sum_im);
+    // the orders and the values of negative m of accumulate(sph, Qlm)
+    if (m_full_m)
+        {
+        Qlm[0] += complex<float>(sum_re[0], sum_im[0]);
+        for (unsigned int m = 1; m <= L; m++)
+            {
+            Qlm[m] += complex<float>(sum_re[m], sum_im[m]);
+            Qlm[L+m] += (m % 2) ? complex<float>(-sum_re[m], sum_im[m]) : complex<float>(sum_re[m], -sum_im[m]);
+            }
+        }
+    else
+        {
+        Qlm[L] += complex<float>(sum_re[0], sum_im[0]);
+        for (unsigned int m = 1; m <= L; m++)
+            {
+            complex<float> sum(sum_re[m], sum_im[m]);
+            Qlm[L+m] += sum;
+            Qlm[L-m] += sum;
+            }
+        }
+    }
+
+void BondHarmonics::computeQlm(const box::Box& box, const vec3<float> *points, unsigned int Np,
+                               const locality::NeighborList *nlist, float rminsq, float rmaxsq,
+                               const Outputs& out)
+    {
+    m_Np = Np;
+    const unsigned int num_m = 2*m_l+1;
+    const size_t num_chunks = (size_t(Np) + chunk_size - 1)/chunk_size;
+    std::vector< complex<float> > chunk_Qlm(out.Qlm != NULL ? num_chunks*num_m : 0);
+    complex<float> *l_chunk_Qlm = chunk_Qlm.size() ? &chunk_Qlm[0] : NULL;
+
+    // bonds within the shell, kept as the neighbors of computeAveQlm
+    std::vector<unsigned char> in_shell(nlist->getNumBonds(), 0);
+    unsigned char *l_in_shell = in_shell.size() ? &in_shell[0] : NULL;
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    const vec3<float> *vectors = nlist->getVectors().get();
+
+    parallel_for(blocked_range<size_t>(0, num_chunks),
+        [=, &box] (const blocked_range<size_t>& r)
+        {
+        // the evaluator of the thread, fed blocks of the kept bonds of each particle
+        BatchSphericalHarmonics& sph = m_local_sph.local();
+        vec3<float> block[BatchSphericalHarmonics::block_size];
+        std::vector< complex<float> >& scratch = m_local_Qlm.local();
+
+        // the particles of the chunks of the task
+        for (size_t i = r.begin()*chunk_size; i < std::min(size_t(Np), r.end()*chunk_size); i++)
+            {
+            vec3<float> ref = points[i];
+            unsigned int neighborcount=0;
+            unsigned int n_block = 0;
+            complex<float> *Qlm_i = (out.Qlmi != NULL) ? out.Qlmi + num_m*i : &scratch[0];
+            memset((void*)Qlm_i, 0, sizeof(complex<float>)*num_m);
+
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                {
+                unsigned int j = index_j[bond];
+                if (i == j)
+                    continue;
+                // rij = rj - ri, from i pointing to j.
+                vec3<float> delta = (vectors != NULL) ? vectors[bond] : box.wrap(points[j] - ref);
+                float rsq = dot(delta, delta);
+
+                if (rsq < rmaxsq and rsq > rminsq)
+                    {
+                    block[n_block++] = delta;
+                    if (n_block == BatchSphericalHarmonics::block_size)
+                        {
+                        accumulate(sph, block, n_block, Qlm_i);
+                        n_block = 0;
+                        }
+                    l_in_shell[bond] = 1;
+                    neighborcount++;
+                    }
+                }
+            if (n_block)
+                {
+                accumulate(sph, block, n_block, Qlm_i);
+                }
+            //Normalize!
+            for(unsigned int k = 0; k < num_m; ++k)
+                {
+                Qlm_i[k]/= neighborcount;
+                }
+            deriveParticle(i, Qlm_i, out, l_chunk_Qlm ? l_chunk_Qlm + num_m*(i/chunk_size) : NULL);
+            }
+        });
+    sumChunks(chunk_Qlm, out);
+
+    // keep the neighbors of each particle within the shell
+    m_neighbor_start.resize(Np + 1);
+    size_t num_neighbors = 0;
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        m_neighbor_start[i] = num_neighbors;
+        for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+            num_neighbors += in_shell[bond];
+        }
+    m_neighbor_start[Np] = num_neighbors;
+    m_neighbors.resize(num_neighbors);
+    const size_t *neighbor_start = &m_neighbor_start[0];
+    unsigned int *neighbors = num_neighbors ? &m_neighbors[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t n = neighbor_start[i];
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                if (l_in_shell[bond])
+                    neighbors[n++] = index_j[bond];
+            }
+        });
+    }
+
+void BondHarmonics::beginQlm(unsigned int Np)
+    {
+    m_Np = Np;
+    m_neighbor_start.resize(Np + 1);
+    m_particle_thread.resize(Np);
+    m_particle_offset.resize(Np);
+    for (auto it = m_local_neighbors.begin(); it != m_local_neighbors.end(); ++it)
+        it->clear();
+    }
+
+void BondHarmonics::computeParticleQlm(unsigned int i, const unsigned int *j, const vec3<float> *delta,
+                                       const float *rsq, unsigned int n, float rminsq, float rmaxsq,
+                                       complex<float> *Qlm_i)
+    {
+    const unsigned int num_m = 2*m_l+1;
+    memset((void*)Qlm_i, 0, sizeof(complex<float>)*num_m);
+    BatchSphericalHarmonics& sph = m_local_sph.local();
+    std::vector<unsigned int>& kept = m_local_neighbors.local();
+    m_particle_thread[i] = &kept;
+    m_particle_offset[i] = kept.size();
+
+    vec3<float> block[BatchSphericalHarmonics::block_size];
+    unsigned int neighborcount = 0;
+    unsigned int n_block = 0;
+    for (unsigned int k = 0; k < n; k++)
+        {
+        if (j[k] == i || !(rsq[k] < rmaxsq && rsq[k] > rminsq))
+            continue;
+        block[n_block++] = delta[k];
+        if (n_block == BatchSphericalHarmonics::block_size)
+            {
+            accumulate(sph, block, n_block, Qlm_i);
+            n_block = 0;
+            }
+        kept.push_back(j[k]);
+        neighborcount++;
+        }
+    if (n_block)
+        {
+        accumulate(sph, block, n_block, Qlm_i);
+        }
+    for (unsigned int k = 0; k < num_m; ++k)
+        Qlm_i[k] /= neighborcount;
+    // the number of neighbors until endQlm() turns it into an offset
+    m_neighbor_start[i] = neighborcount;
+    }
+
+void BondHarmonics::endQlm()
+    {
+    size_t num_neighbors = 0;
+    for (unsigned int i = 0; i < m_Np; i++)
+        {
+        size_t count = m_neighbor_start[i];
+        m_neighbor_start[i] = num_neighbors;
+        num_neighbors += count;
+        }
+    m_neighbor_start[m_Np] = num_neighbors;
+    m_neighbors.resize(num_neighbors);
+    const size_t *neighbor_start = &m_neighbor_start[0];
+    const std::vector<unsigned int>* const *particle_thread = m_particle_thread.size() ? &m_particle_thread[0] : NULL;
+    const size_t *particle_offset = m_particle_offset.size() ? &m_particle_offset[0] : NULL;
+    unsigned int *neighbors = num_neighbors ? &m_neighbors[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, m_Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t count = neighbor_start[i+1] - neighbor_start[i];
+            if (count)
+                memcpy(neighbors + neighbor_start[i], &(*particle_thread[i])[particle_offset[i]],
+                       count*sizeof(unsigned int));
+            }
+        });
+    }
+
+
+void BondHarmonics::deriveQlm(unsigned int Np, const complex<float> *Qlmi, const Outputs& out) const
+    {
+    const unsigned int num_m = 2*m_l+1;
+    const size_t num_chunks = (size_t(Np) + chunk_size - 1)/chunk_size;
+    std::vector< complex<float> > chunk_Qlm(out.Qlm != NULL ? num_chunks*num_m : 0);
+    complex<float> *l_chunk_Qlm = chunk_Qlm.size() ? &chunk_Qlm[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, num_chunks),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin()*chunk_size; i < std::min(size_t(Np), r.end()*chunk_size); i++)
+            deriveParticle(i, Qlmi + num_m*i, out, l_chunk_Qlm ? l_chunk_Qlm + num_m*(i/chunk_size) : NULL);
+        });
+    sumChunks(chunk_Qlm, out);
+    }
+
+void BondHarmonics::computeAveQlm(unsigned int Np, const complex<float> *Qlmi, const Outputs& out) const
+    {
+    if (m_neighbor_start.size() != size_t(Np) + 1 || Np != m_Np)
+        throw invalid_argument("compute must be called with the same points before computeAve");
+
+    const unsigned int num_m = 2*m_l+1;
+    const size_t num_chunks = (size_t(Np) + chunk_size - 1)/chunk_size;
+    std::vector< complex<float> > chunk_Qlm(out.Qlm != NULL ? num_chunks*num_m : 0);
+    complex<float> *l_chunk_Qlm = chunk_Qlm.size() ? &chunk_Qlm[0] : NULL;
+
+    // the neighbors n1 of i and the neighbors j of n1 are those computeQlm found within the shell
+    const size_t *neighbor_start = &m_neighbor_start[0];
+    const unsigned int *neighbors = m_neighbors.size() ? &m_neighbors[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, num_chunks),
+        [=] (const blocked_range<size_t>& r)
+        {
+        std::vector< complex<float> > scratch(out.Qlmi == NULL ? num_m : 0);
+
+        // the particles of the chunks of the task
+        for (size_t i = r.begin()*chunk_size; i < std::min(size_t(Np), r.end()*chunk_size); i++)
+            {
+            unsigned int neighborcount=1;
+            complex<float> *AveQlm_i = (out.Qlmi != NULL) ? out.Qlmi + num_m*i : &scratch[0];
+            memset((void*)AveQlm_i, 0, sizeof(complex<float>)*num_m);
+
+            for (size_t n = neighbor_start[i]; n < neighbor_start[i+1]; n++)
+                {
+                unsigned int n1 = neighbors[n];
+                for (size_t n2 = neighbor_start[n1]; n2 < neighbor_start[n1+1]; n2++)
+                    {
+                    unsigned int j = neighbors[n2];
+                    for(unsigned int k = 0; k < num_m; ++k)
+                        {
+                        //adding all the Qlm of the neighbors
+                        AveQlm_i[k] += Qlmi[num_m*j+k];
+                        }
+                    neighborcount++;
+                    }
+                }
+            //Normalize!
+            for (unsigned int k = 0; k < num_m; ++k)
+                {
+                //adding the Qlm of the particle i itself
+                AveQlm_i[k] += Qlmi[num_m*i+k];
+                AveQlm_i[k]/= neighborcount;
+                }
+            deriveParticle(i, AveQlm_i, out, l_chunk_Qlm ? l_chunk_Qlm + num_m*(i/chunk_size) : NULL);
+            }
+        });
+    sumChunks(chunk_Qlm, out);
+    }
+
+float BondHarmonics::computeQl(const complex<float> *Qlm, float normalization) const
+    {
+    float Ql = 0;
+    for (unsigned int k = 0; k < 2*m_l+1; ++k)
+        {
+        Ql+= abs( Qlm[k]*conj(Qlm[k]) ); //Square by multiplying self w/ complex conj, then take real comp
+        }
+    Ql*=normalization;
+    return sqrt(Ql);
+    }
+
+void BondHarmonics::deriveParticle(unsigned int i, const complex<float> *Qlm_i, const Outputs& out,
+                                   complex<float> *chunk_Qlm) const
+    {
+    const unsigned int num_m = 2*m_l+1;
+    if (out.Ql != NULL || (out.Wl != NULL && out.normalize_wl))
+        {
+        float Ql = computeQl(Qlm_i, out.normalization);
+        if (out.Ql != NULL)
+            out.Ql[i] = Ql;
+        if (out.Wl != NULL)
+            {
+            out.Wl[i] = getWigner3jTable(m_l).contract(Qlm_i);
+            if (out.normalize_wl)
+                out.Wl[i] /= (Ql*Ql*Ql);//Normalize
+            }
+        }
+    else if (out.Wl != NULL)
+        out.Wl[i] = getWigner3jTable(m_l).contract(Qlm_i);
+    if (chunk_Qlm != NULL)
+        for (unsigned int k = 0; k < num_m; ++k)
+            chunk_Qlm[k] += Qlm_i[k];
+    }
+
+void BondHarmonics::sumChunks(const std::vector< complex<float> >& chunk_Qlm, const Outputs& out) const
+    {
+    if (out.Qlm == NULL)
+        return;
+    const unsigned int num_m = 2*m_l+1;
+    memset((void*)out.Qlm, 0, sizeof(complex<float>)*num_m);
+    for (size_t k = 0; k < chunk_Qlm.size(); k++)
+        out.Qlm[k % num_m] += chunk_Qlm[k];
+    }
+
+}; }; // end namespace freud::order
@@ -0,0 +1,161 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <complex>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "NeighborList.h"
+#include "box.h"
+#include "BatchSphericalHarmonics.h"
+#include "ComputeArena.h"
+
+#ifndef _BOND_HARMONICS_H__
+#define _BOND_HARMONICS_H__
+
+/*! \file BondHarmonics.h
+    \brief Averages of the spherical harmonics of the bonds of each particle, shared by the Ql and Wl classes
+*/
+
+namespace freud { namespace order {
+
+//! Compute the Qlm of each particle from the bonds of a neighbor list, and the quantities derived from them
+/*! LocalQl, LocalQlNear, LocalWl and LocalWlNear all go through this class, in parallel over particles. The radius
+    and the nearest neighbor classes only differ by the neighbor list they pass and the bonds they keep from it: the
+    bonds between distinct particles with rminsq < r^2 < rmaxsq.
+
+    The harmonics are evaluated block_size bonds of a particle at a time, by FixedSphericalHarmonics for the usual
+    l and by BatchSphericalHarmonics otherwise.
+
+    The bonds kept by computeQlm are remembered, so that computeAveQlm averages over the neighbors of the neighbors
+    without another traversal of the neighbor list.
+
+    beginQlm(), computeParticleQlm() and endQlm() compute the same Qlm from neighbors given one particle at a time, as
+    by a locality::FrameAnalysis, instead of from a neighbor list.
+
+    The Qlm of a particle are stored in one of two orders:
+    - full_m, as the Ql classes have always done: m = 0..l, then m = -1..-l, as fsph yields them.
+    - otherwise, as the Wl classes have always done: m = -l..l, the values of negative m being copies of the values of
+      positive m. The Wigner 3j contraction of computeWl needs this order, with its index u = m + l.
+*/
+class BondHarmonics
+    {
+    public:
+        //! Constructor
+        /*! \param l spherical harmonic number
+            \param full_m true to store the Qlm in the order of fsph, false to store them by m = -l..l
+        */
+        BondHarmonics(unsigned int l, bool full_m);
+
+        //! Get the spherical harmonic number
+        unsigned int getL() const
+            {
+            return m_l;
+            }
+
+        //! Fill the 2l + 1 values Y with the harmonics of bond b of the last block of the calling thread's evaluator
+        void evaluate(const BatchSphericalHarmonics& sph, unsigned int b, std::complex<float> *Y) const;
+
+        //! Fill the 2l + 1 values Y with the harmonics of the direction of polar angle theta and azimuth phi
+        void evaluate(float theta, float phi, std::complex<float> *Y) const;
+
+        //! Add the sums of the harmonics over the last block of the calling thread's evaluator to the 2l + 1 Qlm
+        void accumulate(const BatchSphericalHarmonics& sph, std::complex<float> *Qlm) const;
+
+        //! Add the sums of the harmonics of n <= block_size bonds to the 2l + 1 Qlm
+        /*! The usual l = 4, 6, 8, 10 and 12 are summed by FixedSphericalHarmonics, the other l by \a sph, the
+            evaluator of the calling thread.
+        */
+        void accumulate(BatchSphericalHarmonics& sph, const vec3<float> *bonds, unsigned int n,
+                        std::complex<float> *Qlm) const;
+
+        //! Where the quantities derived from the Qlm of each particle go, NULL for those that are not wanted
+        struct Outputs
+            {
+            Outputs() : Qlmi(NULL), Ql(NULL), normalization(1.0f), Wl(NULL), normalize_wl(false), Qlm(NULL)
+                {
+                }
+
+            std::complex<float> *Qlmi;  //!< (2l + 1) Np values, the Qlm of each particle
+            float *Ql;                  //!< Np values, sqrt(normalization sum_m |Qlm|^2) of each particle
+            float normalization;        //!< Normalization of Ql
+            std::complex<float> *Wl;    //!< Np values, the Qlm of each particle contracted with the Wigner 3j
+                                        //!< coefficients of l, which needs the Qlm by m = -l..l
+            bool normalize_wl;          //!< True to divide each Wl by Ql^3
+            std::complex<float> *Qlm;   //!< 2l + 1 values, the sum of the Qlm of all the particles
+            };
+
+        //! Average the harmonics of the kept bonds of each particle and derive the outputs from them
+        /*! The Qlm of a particle are only stored if out.Qlmi is given, which computeAveQlm needs; otherwise they live
+            in a scratch array of the thread for as long as the outputs take to derive.
+        */
+        void computeQlm(const box::Box& box, const vec3<float> *points, unsigned int Np,
+                        const locality::NeighborList *nlist, float rminsq, float rmaxsq, const Outputs& out);
+
+        //! Start computing the Qlm one particle at a time, with computeParticleQlm()
+        void beginQlm(unsigned int Np);
+
+        //! Average the harmonics of the bonds of particle i within the shell among its n bonds
+        /*! The bonds go to the neighbors j, along the vectors delta of squared lengths rsq; bonds to i itself are
+            skipped as in computeQlm(). Distinct particles may be computed concurrently, each exactly once between
+            beginQlm() and endQlm().
+
+            \param Qlm_i 2l + 1 values, overwritten
+        */
+        void computeParticleQlm(unsigned int i, const unsigned int *j, const vec3<float> *delta, const float *rsq,
+                                unsigned int n, float rminsq, float rmaxsq, std::complex<float> *Qlm_i);
+
+        //! Keep the neighbors found by computeParticleQlm() for computeAveQlm()
+        void endQlm();
+
+        //! Derive the outputs from stored Qlm of each particle; out.Qlmi is not used
+        void deriveQlm(unsigned int Np, const std::complex<float> *Qlmi, const Outputs& out) const;
+
+        //! Average the Qlm of each particle and of the neighbors of its neighbors found by computeQlm
+        /*! The averages are derived into \a out as they are found, and only stored if out.Qlmi is given.
+        */
+        void computeAveQlm(unsigned int Np, const std::complex<float> *Qlmi, const Outputs& out) const;
+
+        //! Compute sqrt(normalization sum_m |Qlm|^2) of one set of Qlm
+        float computeQl(const std::complex<float> *Qlm, float normalization) const;
+
+    private:
+        //! Number of consecutive particles whose Qlm are summed together before the sums of the chunks are added
+        /*! The sum of the Qlm of all the particles is the same whichever the outputs or the threads.
+        */
+        static const unsigned int chunk_size = 64;
+
+        //! Derive the outputs of particle i from its Qlm, adding them to the sum of its chunk if there is one
+        void deriveParticle(unsigned int i, const std::complex<float> *Qlm_i, const Outputs& out,
+                            std::complex<float> *chunk_Qlm) const;
+
+        //! Sum the sums of the chunks into out.Qlm, in the order of the chunks
+        void sumChunks(const std::vector< std::complex<float> >& chunk_Qlm, const Outputs& out) const;
+
+        //! Add the sums of the harmonics of n bonds to the 2l + 1 Qlm, for l = L
+        template<unsigned int L>
+        void accumulateFixed(const vec3<float> *bonds, unsigned int n, std::complex<float> *Qlm) const;
+
+        unsigned int m_l;                           //!< Spherical harmonic number
+        bool m_full_m;                              //!< True to store the Qlm in the order of fsph
+        unsigned int m_Np;                          //!< Number of particles of the last computeQlm
+        std::vector<size_t> m_neighbor_start;       //!< First neighbor of each particle i in m_neighbors, and their number
+        std::vector<unsigned int> m_neighbors;      //!< Neighbors kept by computeQlm, by particle
+
+        tbb::enumerable_thread_specific<BatchSphericalHarmonics> m_local_sph;       //!< Evaluator of each thread
+        util::ThreadScratch< std::vector< std::complex<float> > > m_local_Qlm;   //!< Qlm of each thread of
+                                                                                //!< computeQlm, unless stored
+        tbb::enumerable_thread_specific< std::vector<unsigned int> > m_local_neighbors; //!< Neighbors kept by each
+                                                                                        //!< thread, by particle
+        std::vector<const std::vector<unsigned int>*> m_particle_thread;   //!< Neighbors of the thread that computed
+                                                                           //!< each particle until endQlm()
+        std::vector<size_t> m_particle_offset;      //!< First neighbor of each particle in those of its thread
+    };
+
+}; }; // end namespace freud::order
+
+#endif // _BOND_HARMONICS_H__
@@ -2,14 +2,16 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "BondOrder.h"
+#include "Checkpoint.h"
 #include "ScopedGILRelease.h"
+#include "Annotation.h"
+#include "VectorMathBatch.h"
 
 #include <stdexcept>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
 
-#include <stdexcept>
 #include <complex>
 
 using namespace std;
@@ -21,9 +23,12 @@ using namespace tbb;
 
 namespace freud { namespace order {
 
+//! Number of cells of the table of the phi bins over cos(phi)
+const unsigned int COS_TABLE_SIZE = 4096;
+
 BondOrder::BondOrder(float rmax, float k, unsigned int n, unsigned int nbins_t, unsigned int nbins_p)
     : m_box(box::Box()), m_rmax(rmax), m_k(k), m_nbins_t(nbins_t), m_nbins_p(nbins_p), m_n_p(0), m_n_ref(0),
-      m_frame_counter(0)
+      m_frame_counter(0), m_reduce(true)
     {
     // sanity checks, but this is actually kinda dumb if these values are 1
     if (nbins_t < 1)
@@ -60,6 +65,20 @@ BondOrder::BondOrder(float rmax, float k, unsigned int n, unsigned int nbins_t,
         m_phi_array.get()[i] = ((p + nextp) / 2.0);
         }
 
+    // precompute the cos of the phi bin edges, decreasing from 1 to -1, and the first bin of each cell of cos(phi)
+    m_cos_edges.resize(m_nbins_p+1);
+    for (unsigned int j = 0; j <= m_nbins_p; j++)
+        m_cos_edges[j] = cosf(float(j) * m_dp);
+    m_cos_bin_table.resize(COS_TABLE_SIZE+1);
+    unsigned int bin = 0;
+    for (unsigned int f = 0; f <= COS_TABLE_SIZE; f++)
+        {
+        float c = 1.0f - 2.0f*float(f)/float(COS_TABLE_SIZE);
+        while (bin < m_nbins_p && c <= m_cos_edges[bin+1])
+            bin++;
+        m_cos_bin_table[f] = bin;
+        }
+
     // precompute the surface area array
     m_sa_array = std::shared_ptr<float>(new float[m_nbins_t*m_nbins_p], std::default_delete<float[]>());
     memset((void*)m_sa_array.get(), 0, sizeof(float)*m_nbins_t*m_nbins_p);
@@ -88,20 +107,19 @@ BondOrder::BondOrder(float rmax, float k, unsigned int n, unsigned int nbins_t,
     // otherwise set to n
     // this is super dangerous...
     m_nn = new locality::NearestNeighbors(m_rmax, n==0? (unsigned int) k: n);
+    // only the wrapped vectors are used
+    m_nn->setStoreDistances(false);
     }
 
 BondOrder::~BondOrder()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin();
-            i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
+    util::freeLocalHistograms(m_local_bin_counts);
     delete m_nn;
     }
 
 void BondOrder::reduceBondOrder()
     {
+    util::reduceLocalHistograms(m_local_bin_counts, m_bin_counts.get(), m_nbins_t*m_nbins_p);
     memset((void*)m_bo_array.get(), 0, sizeof(float)*m_nbins_t*m_nbins_p);
     parallel_for(blocked_range<size_t>(0,m_nbins_t),
       [=] (const blocked_range<size_t>& r)
@@ -111,11 +129,6 @@ void BondOrder::reduceBondOrder()
           {
           for (size_t j = 0; j < m_nbins_p; j++)
               {
-              for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                   local_bins != m_local_bin_counts.end(); ++local_bins)
-                  {
-                  m_bin_counts.get()[sa_i((int)i, (int)j)] += (*local_bins)[sa_i((int)i, (int)j)];
-                  }
               m_bo_array.get()[sa_i((int)i, (int)j)] = m_bin_counts.get()[sa_i((int)i, (int)j)] / m_sa_array.get()[sa_i((int)i, (int)j)];
               }
           }
@@ -133,10 +146,80 @@ void BondOrder::reduceBondOrder()
 
 std::shared_ptr<float> BondOrder::getBondOrder()
     {
-    reduceBondOrder();
+    if (m_reduce == true)
+        {
+        reduceBondOrder();
+        }
+    m_reduce = false;
     return m_bo_array;
     }
 
+void BondOrder::saveState(const std::string& filename)
+    {
+    std::vector<unsigned int> counts(m_nbins_t*m_nbins_p);
+    util::reduceLocalHistograms(m_local_bin_counts, counts.data(), counts.size());
+
+    util::CheckpointWriter writer(filename, "BondOrder");
+    writer.write(m_rmax);
+    writer.write(m_k);
+    writer.write(m_nn->getNumNeighbors());
+    writer.write(m_nbins_t);
+    writer.write(m_nbins_p);
+    writer.write(m_frame_counter);
+    writer.write(m_n_ref);
+    writer.write(m_n_p);
+    writer.writeBox(m_box);
+    writer.writeHistogram(counts.data(), counts.size());
+    writer.close();
+    }
+
+void BondOrder::loadState(const std::string& filename, bool merge)
+    {
+    // read the whole file before changing anything
+    util::CheckpointReader reader(filename, "BondOrder");
+    reader.expect(m_rmax, "rmax");
+    reader.expect(m_k, "k");
+    reader.expect(m_nn->getNumNeighbors(), "number of neighbors");
+    reader.expect(m_nbins_t, "number of theta bins");
+    reader.expect(m_nbins_p, "number of phi bins");
+    unsigned int frame_counter = reader.read<unsigned int>();
+    unsigned int n_ref = reader.read<unsigned int>();
+    unsigned int n_p = reader.read<unsigned int>();
+    box::Box box = reader.readBox();
+    std::vector<unsigned int> counts;
+    reader.readHistogram(counts, m_nbins_t*m_nbins_p);
+
+    if (!merge)
+        resetBondOrder();
+    addState(counts.data(), frame_counter, box, n_ref, n_p);
+    }
+
+void BondOrder::merge(const BondOrder& other)
+    {
+    if (other.m_rmax != m_rmax || other.m_k != m_k || other.m_nn->getNumNeighbors() != m_nn->getNumNeighbors() ||
+        other.m_nbins_t != m_nbins_t || other.m_nbins_p != m_nbins_p)
+        throw invalid_argument("Only bond orders of the same parameters can be merged");
+    std::vector<unsigned int> counts(m_nbins_t*m_nbins_p);
+    util::reduceLocalHistograms(other.m_local_bin_counts, counts.data(), counts.size());
+    addState(counts.data(), other.m_frame_counter, other.m_box, other.m_n_ref, other.m_n_p);
+    }
+
+//! \internal
+//! Add the histogram of frame_counter frames, the last of them of the box and numbers of points given
+void BondOrder::addState(const unsigned int *counts, unsigned int frame_counter, const box::Box& box,
+                         unsigned int n_ref, unsigned int n_p)
+    {
+    if (m_frame_counter == 0)
+        {
+        m_box = box;
+        m_n_ref = n_ref;
+        m_n_p = n_p;
+        }
+    util::addToLocalHistogram(m_local_bin_counts, counts, m_nbins_t*m_nbins_p);
+    m_frame_counter += frame_counter;
+    m_reduce = true;
+    }
+
 void BondOrder::resetBondOrder()
     {
     for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
@@ -145,6 +228,7 @@ void BondOrder::resetBondOrder()
         }
     // reset the frame counter
     m_frame_counter = 0;
+    m_reduce = true;
     }
 
 void BondOrder::accumulate(box::Box& box,
@@ -156,6 +240,7 @@ void BondOrder::accumulate(box::Box& box,
                            unsigned int n_p,
                            unsigned int mode)
     {
+    util::ScopedRange annotation("freud::BondOrder::accumulate");
     // transform the mode from an integer to an enumerated type (enumerated in BondOrder.h)
     BondOrderMode b_mode = static_cast<BondOrderMode>(mode);
 
@@ -164,105 +249,176 @@ void BondOrder::accumulate(box::Box& box,
     m_nn->compute(m_box,ref_points,n_ref,points,n_p);
     m_nn->setRMax(m_rmax);
 
+    // the rotations of the orientations, once per particle instead of once per bond
+    if (b_mode != bod)
+        {
+        m_ref_rotations.resize(n_ref);
+        rotmat3<float> *ref_rotations = &m_ref_rotations[0];
+        parallel_for(blocked_range<size_t>(0,n_ref),
+            [=] (const blocked_range<size_t>& r)
+            {
+            for (size_t i = r.begin(); i != r.end(); ++i)
+                ref_rotations[i] = rotmat3<float>(conj(ref_orientations[i]));
+            });
+        }
+    if (b_mode == obcd || b_mode == oocd)
+        {
+        m_rotations.resize(b_mode == obcd ? n_p : 0);
+        m_directors.resize(b_mode == oocd ? n_p : 0);
+        rotmat3<float> *rotations = m_rotations.size() ? &m_rotations[0] : NULL;
+        vec3<float> *directors = m_directors.size() ? &m_directors[0] : NULL;
+        parallel_for(blocked_range<size_t>(0,n_p),
+            [=] (const blocked_range<size_t>& r)
+            {
+            for (size_t j = r.begin(); j != r.end(); ++j)
+                {
+                rotmat3<float> rotation(orientations[j]);
+                if (rotations != NULL)
+                    rotations[j] = rotation;
+                else
+                    // the z axis rotated by the orientation
+                    directors[j] = vec3<float>(rotation.row0.z, rotation.row1.z, rotation.row2.z);
+                }
+            });
+        }
+
+    const unsigned int nbins_t = m_nbins_t;
+    const unsigned int nbins_p = m_nbins_p;
+    const unsigned int num_neighbors = m_nn->getNumNeighbors();
+    const unsigned int *neighbor_list = m_nn->getNeighborList().get();
+    const vec3<float> *wrapped_vectors = m_nn->getWrappedVectors().get();
+    const rotmat3<float> *ref_rotations = m_ref_rotations.size() ? &m_ref_rotations[0] : NULL;
+    const rotmat3<float> *rotations = m_rotations.size() ? &m_rotations[0] : NULL;
+    const vec3<float> *directors = m_directors.size() ? &m_directors[0] : NULL;
+    const float *cos_edges = &m_cos_edges[0];
+    const unsigned int *cos_bin_table = &m_cos_bin_table[0];
+    const float dt_inv = 1.0f / m_dt;
+    tbb::enumerable_thread_specific<unsigned int *>& local_bin_counts = m_local_bin_counts;
+
     // compute the order parameter
     parallel_for(blocked_range<size_t>(0,n_ref),
-        [=] (const blocked_range<size_t>& br)
+        [=, &local_bin_counts] (const blocked_range<size_t>& br)
             {
-            float dt_inv = 1.0f / m_dt;
-            float dp_inv = 1.0f / m_dp;
-            Index2D sa_i = Index2D(m_nbins_t, m_nbins_p);
+            Index2D sa_i = Index2D(nbins_t, nbins_p);
 
             bool exists;
-            m_local_bin_counts.local(exists);
+            local_bin_counts.local(exists);
             if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_nbins_t*m_nbins_p];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_nbins_t*m_nbins_p);
-                }
+                local_bin_counts.local() = util::allocateLocalHistogram<unsigned int>(nbins_t*nbins_p);
+            unsigned int *bin_counts = local_bin_counts.local();
+
+            // the bonds of one reference point and their rotations, by component and padded to whole batches
+            const unsigned int padded = num_neighbors + BATCH_WIDTH;
+            std::vector<float> dx(padded), dy(padded), dz(padded);
+            std::vector<float> vx(padded), vy(padded), vz(padded);
+            std::vector<unsigned int> bond_j(padded);
 
             for(size_t i=br.begin(); i!=br.end(); ++i)
                 {
-                vec3<float> ref_pos = ref_points[i];
-                quat<float> ref_q(ref_orientations[i]);
-
-                //loop over neighbors
-                locality::NearestNeighbors::iteratorneighbor it = m_nn->iterneighbor(i);
-                for (unsigned int j = it.begin(); !it.atEnd(); j = it.next())
+                // gather the bonds, skipping the padding of missing neighbors and the particle itself
+                unsigned int n_bonds = 0;
+                for (unsigned int k = 0; k < num_neighbors; k++)
                     {
-                    //compute r between the two particles
-                    vec3<float> delta = m_box.wrap(points[j] - ref_pos);
+                    unsigned int j = neighbor_list[i*num_neighbors + k];
+                    if (j == UINT_MAX)
+                        continue;
+                    vec3<float> delta = wrapped_vectors[i*num_neighbors + k];
+                    if (dot(delta, delta) > 1e-6)
+                        {
+                        dx[n_bonds] = delta.x;
+                        dy[n_bonds] = delta.y;
+                        dz[n_bonds] = delta.z;
+                        bond_j[n_bonds] = j;
+                        n_bonds++;
+                        }
+                    }
+                // fill the last batch with copies of the first bond, which are rotated but never binned
+                for (unsigned int b = n_bonds; b < padded; b++)
+                    {
+                    dx[b] = n_bonds ? dx[0] : 0.0f;
+                    dy[b] = n_bonds ? dy[0] : 0.0f;
+                    dz[b] = n_bonds ? dz[0] : 0.0f;
+                    bond_j[b] = n_bonds ? bond_j[0] : 0;
+                    }
 
-                    float rsq = dot(delta, delta);
-                    if (rsq > 1e-6)
+                // rotate the bonds BATCH_WIDTH at a time
+                if (b_mode == bod)
+                    {
+                    vx = dx;
+                    vy = dy;
+                    vz = dz;
+                    }
+                else
+                    {
+                    rotmat3_batch ref_rotation = broadcast_batch(ref_rotations[i]);
+                    for (unsigned int b = 0; b < n_bonds; b += BATCH_WIDTH)
                         {
-                        quat<float> q(orientations[j]);
-                        vec3<float> v(delta);
+                        vec3_batch v;
                         if (b_mode == obcd)
                             {
                             // give bond directions of neighboring particles rotated by the matrix that takes the
                             // orientation of particle j to the orientation of particle i.
-                            v = rotate(conj(ref_q), v);
-                            v = rotate(q, v);
+                            v = gather_rotmat3_batch(rotations, &bond_j[b])*
+                                (ref_rotation*load_vec3_batch(&dx[b], &dy[b], &dz[b]));
                             }
                         else if (b_mode == lbod)
                             {
                             // give bond directions of neighboring particles rotated into the local orientation of the
                             // central particle.
-                            v = rotate(conj(ref_q), v);
+                            v = ref_rotation*load_vec3_batch(&dx[b], &dy[b], &dz[b]);
                             }
-                        else if (b_mode == oocd)
+                        else
                             {
                             // give the directors of neighboring particles rotated into the local orientation of the
                             // central particle.
-                            // pick a (random vector)
-                            vec3<float> z(0,0,1);
-                            // rotate that vector by the orientation of the neighboring particle
-                            z = rotate(q, z);
-                            // get the direction of this vector with respect to the orientation of the central particle
-                            v = rotate(conj(ref_q), z);
-                            }
-
-                        // NOTE that angles are defined in the "mathematical" way, rather than how most physics
-                        // textbooks do it.
-                        // get theta (azimuthal angle), phi (polar angle)
-                        float theta = atan2f(v.y, v.x); //-Pi..Pi
-
-                        theta = fmod(theta, 2*M_PI);
-                        if (theta < 0)
-                            {
-                            theta += 2*M_PI;
+                            v = ref_rotation*gather_vec3_batch(directors, &bond_j[b]);
                             }
+                        store_vec3_batch(v, &vx[b], &vy[b], &vz[b]);
+                        }
+                    }
 
-                        // NOTE that the below has replaced the commented out expression for phi.
-                        float phi = acos(v.z / sqrt(v.x*v.x + v.y*v.y + v.z*v.z)); //0..Pi
-
-                        // bin the point
-                        float bint = floorf(theta * dt_inv);
-                        float binp = floorf(phi * dp_inv);
-                        // fast float to int conversion with truncation
-                        #ifdef __SSE2__
-                        unsigned int ibint = _mm_cvtt_ss2si(_mm_load_ss(&bint));
-                        unsigned int ibinp = _mm_cvtt_ss2si(_mm_load_ss(&binp));
-                        #else
-                        unsigned int ibint = (unsigned int)(bint);
-                        unsigned int ibinp = (unsigned int)(binp);
-                        #endif
-
-                        // increment the bin
-                        if ((ibint < m_nbins_t) && (ibinp < m_nbins_p))
+                for (unsigned int b = 0; b < n_bonds; b++)
+                    {
+                    // NOTE that angles are defined in the "mathematical" way, rather than how most physics
+                    // textbooks do it.
+                    // get theta (azimuthal angle), phi (polar angle)
+                    float theta = atan2f(vy[b], vx[b]); //-Pi..Pi
+                    if (theta < 0)
                         {
-                            ++m_local_bin_counts.local()[sa_i(ibint, ibinp)];
+                        theta += 2*M_PI;
+                        }
+                    float bint = floorf(theta * dt_inv);
+                    // fast float to int conversion with truncation
+                    #ifdef __SSE2__
+                    unsigned int ibint = _mm_cvtt_ss2si(_mm_load_ss(&bint));
+                    #else
+                    unsigned int ibint = (unsigned int)(bint);
+                    #endif
+
+                    // the phi bin from cos(phi), decreasing with phi: start from the table, then move to the bin
+                    // whose edges contain cos(phi)
+                    float cos_phi = vz[b] / sqrtf(vx[b]*vx[b] + vy[b]*vy[b] + vz[b]*vz[b]);
+                    float cell = (1.0f - cos_phi) * (0.5f*float(COS_TABLE_SIZE));
+                    unsigned int ibinp = cos_bin_table[(cell > 0.0f) ? std::min((unsigned int) cell, COS_TABLE_SIZE) : 0];
+                    while (ibinp > 0 && cos_phi > cos_edges[ibinp])
+                        ibinp--;
+                    while (ibinp < nbins_p && cos_phi <= cos_edges[ibinp+1])
+                        ibinp++;
+
+                    // increment the bin
+                    if ((ibint < nbins_t) && (ibinp < nbins_p))
+                        {
+                        ++bin_counts[sa_i(ibint, ibinp)];
                         }
                     }
                 }
-            }
             });
 
-
     // save the last computed number of particles
     m_n_ref = n_ref;
     m_n_p = n_p;
     m_frame_counter++;
+    m_reduce = true;
     }
 
 }; }; // end namespace freud::order
@@ -10,6 +10,8 @@
 #define __APPLE__
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
@@ -17,6 +19,7 @@
 #include "NearestNeighbors.h"
 #include "box.h"
 #include "Index1D.h"
+#include "HistogramReduction.h"
 
 #ifndef _BOND_ORDER_H__
 #define _BOND_ORDER_H__
@@ -31,7 +34,11 @@ namespace freud { namespace order {
 typedef enum {bod=0, lbod=1, obcd=2, oocd=3} BondOrderMode;
 
 //! Compute the bond order parameter for a set of points
-/*!
+/*! The bonds, rotated as the mode requires, are binned by azimuthal angle theta and polar angle phi. The rotations
+    of the orientations are precomputed once per accumulate as matrices, one per reference point and, for the modes
+    that need them, one per point, and the bonds of each reference point are rotated together. The phi bin is found
+    from cos(phi) without an acos: a table over cos(phi) gives the bin of each of its cells, and the bin edges
+    correct it exactly.
 */
 class BondOrder
     {
@@ -63,6 +70,18 @@ class BondOrder
 
         void reduceBondOrder();
 
+        //! Save the accumulated histogram, the number of frames and the box and numbers of points of the last frame
+        //! to a checkpoint file
+        void saveState(const std::string& filename);
+
+        //! Restore the state of a checkpoint file, or add it to the accumulated state if merge
+        /*! The parameters of the bond order must be the same.
+        */
+        void loadState(const std::string& filename, bool merge=false);
+
+        //! Add the accumulated state of another bond order of the same parameters
+        void merge(const BondOrder& other);
+
         //! Get a reference to the last computed rdf
         std::shared_ptr<float> getBondOrder();
 
@@ -89,6 +108,10 @@ class BondOrder
             }
 
     private:
+        //! Add the histogram of some frames to the accumulated one
+        void addState(const unsigned int *counts, unsigned int frame_counter, const box::Box& box,
+                      unsigned int n_ref, unsigned int n_p);
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_rmax;                     //!< Maximum r at which to determine neighbors
         float m_k;                        //!< Multiplier in the exponent
@@ -100,12 +123,18 @@ class BondOrder
         unsigned int m_nbins_t;           //!< number of bins for theta
         unsigned int m_nbins_p;           //!< number of bins for phi
         unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true when the arrays need to be reduced
 
         std::shared_ptr<unsigned int> m_bin_counts;         //!< bin counts computed
         std::shared_ptr<float> m_bo_array;         //!< bond order array computed
         std::shared_ptr<float> m_sa_array;         //!< bond order array computed
         std::shared_ptr<float> m_theta_array;         //!< theta array computed
         std::shared_ptr<float> m_phi_array;         //!< phi order array computed
+        std::vector<float> m_cos_edges;             //!< cos of the lower edge of each phi bin, and -1
+        std::vector<unsigned int> m_cos_bin_table;  //!< phi bin of the upper end of each cell of cos(phi)
+        std::vector< rotmat3<float> > m_ref_rotations;  //!< rotation by the conjugate of each reference orientation
+        std::vector< rotmat3<float> > m_rotations;      //!< rotation by each orientation, for obcd
+        std::vector< vec3<float> > m_directors;         //!< z axis of each orientation, for oocd
         tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
     };
 
@@ -0,0 +1,137 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+
+#include "HOOMDMath.h"
+
+#ifndef _BOND_POWERS_H__
+#define _BOND_POWERS_H__
+
+/*! \file BondPowers.h
+    \brief e^{i k phi} of blocks of 2D bonds without trigonometric functions for integer k
+*/
+
+namespace freud { namespace order {
+
+//! (re + i im)^K by squaring, unrolled at compile time
+template<unsigned int K>
+struct ComplexPower
+    {
+    static void apply(float re, float im, float& out_re, float& out_im)
+        {
+        float half_re, half_im;
+        ComplexPower<K/2>::apply(re, im, half_re, half_im);
+        float sq_re = half_re*half_re - half_im*half_im;
+        float sq_im = 2.0f*half_re*half_im;
+        if (K % 2)
+            {
+            out_re = sq_re*re - sq_im*im;
+            out_im = sq_re*im + sq_im*re;
+            }
+        else
+            {
+            out_re = sq_re;
+            out_im = sq_im;
+            }
+        }
+    };
+
+template<>
+struct ComplexPower<1>
+    {
+    static void apply(float re, float im, float& out_re, float& out_im)
+        {
+        out_re = re;
+        out_im = im;
+        }
+    };
+
+//! e^{i k phi}, phi being the angle of a bond (x, y) to the x axis
+/*! For an integer k, e^{i k phi} is the k-th power of the unit complex number (x + iy) / r, computed with a few
+    multiplications per bond instead of atan2f and an exponential. The usual symmetries have their power unrolled at
+    compile time, so that the loop over a block of bonds has no branches and vectorizes; the other integers take the
+    powers by squaring at run time, and the other k the expression HexOrderParameter always evaluated.
+*/
+class BondPowers
+    {
+    public:
+        //! Constructor
+        /*! \param k symmetry of the order parameter
+        */
+        explicit BondPowers(float k) : m_k(k), m_k_int((unsigned int) k)
+            {
+            m_integer = (k >= 1.0f && k < 65536.0f && float(m_k_int) == k);
+            }
+
+        //! Compute e^{i k phi} of n bonds, which need not be unit vectors but must not be zero
+        void compute(const float *x, const float *y, unsigned int n, float *re, float *im) const
+            {
+            switch (m_integer ? m_k_int : 0)
+                {
+                case 1: fixedPowers<1>(x, y, n, re, im); break;
+                case 2: fixedPowers<2>(x, y, n, re, im); break;
+                case 3: fixedPowers<3>(x, y, n, re, im); break;
+                case 4: fixedPowers<4>(x, y, n, re, im); break;
+                case 5: fixedPowers<5>(x, y, n, re, im); break;
+                case 6: fixedPowers<6>(x, y, n, re, im); break;
+                case 8: fixedPowers<8>(x, y, n, re, im); break;
+                case 12: fixedPowers<12>(x, y, n, re, im); break;
+                case 0:
+                    for (unsigned int b = 0; b < n; b++)
+                        {
+                        float phi = m_k*atan2f(y[b], x[b]);
+                        re[b] = cosf(phi);
+                        im[b] = sinf(phi);
+                        }
+                    break;
+                default:
+                    integerPowers(x, y, n, re, im);
+                }
+            }
+
+    private:
+        //! Powers of the unit vectors for a k known at compile time
+        template<unsigned int K>
+        static void fixedPowers(const float *x, const float *y, unsigned int n, float *re, float *im)
+            {
+            for (unsigned int b = 0; b < n; b++)
+                {
+                float inv_r = 1.0f/sqrtf(x[b]*x[b] + y[b]*y[b]);
+                ComplexPower<K>::apply(x[b]*inv_r, y[b]*inv_r, re[b], im[b]);
+                }
+            }
+
+        //! Powers of the unit vectors by squaring, for any integer k
+        void integerPowers(const float *x, const float *y, unsigned int n, float *re, float *im) const
+            {
+            for (unsigned int b = 0; b < n; b++)
+                {
+                float inv_r = 1.0f/sqrtf(x[b]*x[b] + y[b]*y[b]);
+                float base_re = x[b]*inv_r, base_im = y[b]*inv_r;
+                float pow_re = 1.0f, pow_im = 0.0f;
+                for (unsigned int e = m_k_int; e > 0; e >>= 1)
+                    {
+                    if (e & 1)
+                        {
+                        float t = pow_re*base_re - pow_im*base_im;
+                        pow_im = pow_re*base_im + pow_im*base_re;
+                        pow_re = t;
+                        }
+                    float t = base_re*base_re - base_im*base_im;
+                    base_im = 2.0f*base_re*base_im;
+                    base_re = t;
+                    }
+                re[b] = pow_re;
+                im[b] = pow_im;
+                }
+            }
+
+        float m_k;                  //!< Symmetry of the order parameter
+        unsigned int m_k_int;       //!< k as an integer
+        bool m_integer;             //!< true when k is a positive integer
+    };
+
+}; }; // end namespace freud::order
+
+#endif // _BOND_POWERS_H__
@@ -9,7 +9,6 @@
 #include <emmintrin.h>
 #endif
 
-#include <stdexcept>
 #include <complex>
 
 using namespace std;
@@ -21,9 +20,120 @@ using namespace tbb;
 
 namespace freud { namespace order {
 
+//! \internal
+//! 2 sum_k u_k x u_k x u_k x u_k over the axes u_k of the frame rotated by q
+template<class Real>
+static sym_tensor4<Real> axesTensor(const quat<Real>& q)
+    {
+    rotmat3<Real> rot(q);
+    sym_tensor4<Real> tensor(vec3<Real>(rot.row0.x, rot.row1.x, rot.row2.x));
+    tensor += sym_tensor4<Real>(vec3<Real>(rot.row0.y, rot.row1.y, rot.row2.y));
+    tensor += sym_tensor4<Real>(vec3<Real>(rot.row0.z, rot.row1.z, rot.row2.z));
+    tensor *= Real(2);
+    return tensor;
+    }
+
+//! \internal
+/*! \brief Cubatic order parameter of the orientation q
+
+    The order parameter 1 - |M - C|^2/|C|^2, where M = P - G is the global tensor, the mean P of the particle
+    tensors less the general tensor G, and C = T - G is the cubatic tensor of the axes tensor T of q, only depends on
+    |P - T|^2 and |T - G|^2 = |T|^2 - 2 T.G + |G|^2. Since P and T are symmetric, both come from 15 component dot
+    products, given the symmetric part of G and its full norm.
+*/
+template<class Real>
+static Real cubaticOrderParameter(const quat<Real>& q, const sym_tensor4<Real>& mean_tensor,
+                                  const sym_tensor4<Real>& gen_tensor, Real gen_norm_sq, sym_tensor4<Real>& tensor)
+    {
+    tensor = axesTensor(q);
+    sym_tensor4<Real> diff = mean_tensor - tensor;
+    Real cubatic_norm_sq = dot(tensor, tensor) - Real(2)*dot(tensor, gen_tensor) + gen_norm_sq;
+    return Real(1) - dot(diff, diff)/cubatic_norm_sq;
+    }
+
+//! \internal
+//! q rotated by the rotation vector w
+static quat<double> rotateBy(const quat<double>& q, const vec3<double>& w)
+    {
+    double angle = sqrt(dot(w, w));
+    if (angle == 0.0)
+        return q;
+    return quat<double>::fromAxisAngle(w/angle, angle)*q;
+    }
+
+//! \internal
+/*! \brief Newton's method on the cubatic order parameter, from the orientation found by simulated annealing
+
+    The gradient and the Hessian with respect to a small rotation are found by central differences, and each step is
+    halved until it increases the order parameter, so the result is never worse than q.
+*/
+static quat<double> refineCubaticOrientation(quat<double> q, const sym_tensor4<double>& mean_tensor,
+                                             const sym_tensor4<double>& gen_tensor, double gen_norm_sq)
+    {
+    const double h = 1e-4;
+    sym_tensor4<double> tensor;
+    auto f = [&] (const vec3<double>& w)
+        {
+        return cubaticOrderParameter(rotateBy(q, w), mean_tensor, gen_tensor, gen_norm_sq, tensor);
+        };
+    const vec3<double> e[3] = {vec3<double>(h, 0, 0), vec3<double>(0, h, 0), vec3<double>(0, 0, h)};
+    double f0 = f(vec3<double>(0, 0, 0));
+    for (unsigned int it = 0; it < 20; it++)
+        {
+        double g[3], H[3][3];
+        for (unsigned int a = 0; a < 3; a++)
+            {
+            double fp = f(e[a]), fm = f(-e[a]);
+            g[a] = (fp - fm)/(2*h);
+            H[a][a] = (fp - 2*f0 + fm)/(h*h);
+            for (unsigned int b = 0; b < a; b++)
+                {
+                H[a][b] = H[b][a] = (f(e[a] + e[b]) - f(e[a] - e[b]) - f(e[b] - e[a]) + f(-e[a] - e[b]))/(4*h*h);
+                }
+            }
+        // the Newton step solves H step = -g, by Cramer's rule
+        double det = H[0][0]*(H[1][1]*H[2][2] - H[1][2]*H[2][1]) - H[0][1]*(H[1][0]*H[2][2] - H[1][2]*H[2][0])
+                     + H[0][2]*(H[1][0]*H[2][1] - H[1][1]*H[2][0]);
+        if (det == 0.0)
+            break;
+        double step[3];
+        for (unsigned int c = 0; c < 3; c++)
+            {
+            double M[3][3];
+            for (unsigned int a = 0; a < 3; a++)
+                for (unsigned int b = 0; b < 3; b++)
+                    M[a][b] = (b == c) ? -g[a] : H[a][b];
+            step[c] = (M[0][0]*(M[1][1]*M[2][2] - M[1][2]*M[2][1]) - M[0][1]*(M[1][0]*M[2][2] - M[1][2]*M[2][0])
+                       + M[0][2]*(M[1][0]*M[2][1] - M[1][1]*M[2][0]))/det;
+            }
+        vec3<double> w(step[0], step[1], step[2]);
+        // away from a maximum, the Newton step need not go uphill
+        if (w.x*g[0] + w.y*g[1] + w.z*g[2] <= 0.0)
+            break;
+        bool improved = false;
+        for (unsigned int halving = 0; halving < 10 && !improved; halving++)
+            {
+            double f_new = f(w);
+            if (f_new > f0)
+                {
+                q = rotateBy(q, w);
+                q = q*(1.0/sqrt(norm2(q)));
+                f0 = f_new;
+                improved = true;
+                }
+            else
+                w *= 0.5;
+            }
+        if (!improved || dot(w, w) < 1e-18)
+            break;
+        }
+    return q;
+    }
+
 CubaticOrderParameter::CubaticOrderParameter(float t_initial, float t_final, float scale, float *r4_tensor,
     unsigned int n_replicates, unsigned int seed)
-    : m_t_initial(t_initial), m_t_final(t_final), m_scale(scale), m_seed(seed), m_n(0), m_n_replicates(n_replicates)
+    : m_t_initial(t_initial), m_t_final(t_final), m_scale(scale), m_seed(seed), m_n(0), m_n_replicates(n_replicates),
+      m_particle_order_parameter_valid(false), m_particle_tensor_valid(false)
     {
     // sanity checks, should be caught in python
     if (m_t_initial < m_t_final)
@@ -33,16 +143,13 @@ CubaticOrderParameter::CubaticOrderParameter(float t_initial, float t_final, flo
     if ((scale > 1) || (scale < 0))
         throw invalid_argument("scale must be between 0 and 1");
     // create tensor arrays
-    m_particle_tensor = std::shared_ptr<float>(new float[m_n*81], std::default_delete<float[]>());
-    m_particle_order_parameter = std::shared_ptr<float>(new float[m_n], std::default_delete<float[]>());
     memset((void*)&m_global_tensor.data, 0, sizeof(float)*81);
     memset((void*)&m_cubatic_tensor.data, 0, sizeof(float)*81);
-    memset((void*)m_particle_tensor.get(), 0, sizeof(float)*m_n*81);
-    memset((void*)m_particle_order_parameter.get(), 0, sizeof(float)*m_n);
     // required to not have memory overwritten
     memcpy((void*)&m_gen_r4_tensor.data, r4_tensor, sizeof(float)*81);
-    // create random number generator.
-    Saru m_saru(m_seed, 0, 0xffaabb);
+    // only the symmetric part of the general tensor enters its dot product with the symmetric cubatic tensors
+    m_gen_sym_tensor = sym_tensor4<float>(m_gen_r4_tensor);
+    m_gen_norm_sq = dot(m_gen_r4_tensor, m_gen_r4_tensor);
     }
 
 // CubaticOrderParameter::~CubaticOrderParameter()
@@ -91,11 +198,50 @@ float CubaticOrderParameter::getCubaticOrderParameter()
 
 std::shared_ptr<float> CubaticOrderParameter::getParticleCubaticOrderParameter()
     {
+    // the order parameters of the particles are only computed when they are asked for, in the buffer of the
+    // previous frames while the number of particles is the same, which the arrays given out may still point to
+    if (!m_particle_order_parameter)
+        m_particle_order_parameter = std::shared_ptr<float>(new float[m_n], std::default_delete<float[]>());
+    if (!m_particle_order_parameter_valid)
+        {
+        float *particle_order_parameter = m_particle_order_parameter.get();
+        const quat<float> *orientations = m_orientations.data();
+        const sym_tensor4<float> cubatic_tensor = m_cubatic_sym_tensor;
+        const float cubatic_norm_sq = dot(m_cubatic_tensor, m_cubatic_tensor);
+        parallel_for(blocked_range<size_t>(0, m_n),
+            [=] (const blocked_range<size_t>& r)
+                {
+                for (size_t i = r.begin(); i != r.end(); i++)
+                    {
+                    sym_tensor4<float> diff = axesTensor(orientations[i]) - cubatic_tensor;
+                    particle_order_parameter[i] = 1.0 - dot(diff, diff)/cubatic_norm_sq;
+                    }
+                });
+        m_particle_order_parameter_valid = true;
+        }
     return m_particle_order_parameter;
     }
 
 std::shared_ptr<float> CubaticOrderParameter::getParticleTensor()
     {
+    // the full tensors are only built when they are asked for, in the buffer of the previous frames as above
+    if (!m_particle_tensor)
+        m_particle_tensor = std::shared_ptr<float>(new float[m_n*81], std::default_delete<float[]>());
+    if (!m_particle_tensor_valid)
+        {
+        float *particle_tensor = m_particle_tensor.get();
+        const quat<float> *orientations = m_orientations.data();
+        parallel_for(blocked_range<size_t>(0, m_n),
+            [=] (const blocked_range<size_t>& r)
+                {
+                for (size_t i = r.begin(); i != r.end(); i++)
+                    {
+                    tensor4<float> l_tensor = axesTensor(orientations[i]).full();
+                    memcpy((void*)&particle_tensor[i*81], (void*)&l_tensor.data, sizeof(float)*81);
+                    }
+                });
+        m_particle_tensor_valid = true;
+        }
     return m_particle_tensor;
     }
 
@@ -145,112 +291,85 @@ quat<float> CubaticOrderParameter::getCubaticOrientation()
     return m_cubatic_orientation;
     }
 
-quat<float> CubaticOrderParameter::calcRandomQuaternion(Saru &saru, float angle_multiplier=1.0)
+quat<float> CubaticOrderParameter::calcRandomQuaternion(util::RandomStream &rng, float angle_multiplier=1.0)
     {
     // pull from proper distribution
-    float theta = saru.s<float>(0,2.0*M_PI);
-    float phi = acos(2.0*saru.s<float>(0,1)-1.0);
+    float theta = rng.s<float>(0,2.0*M_PI);
+    float phi = acos(2.0*rng.s<float>(0,1)-1.0);
     vec3<float> axis = vec3<float>(cosf(theta)*sinf(phi),sinf(theta)*sinf(phi),cosf(phi));
     float axis_norm = sqrt(dot(axis,axis));
     axis /= axis_norm;
-    float angle = angle_multiplier * saru.s<float>(0,1);
+    float angle = angle_multiplier * rng.s<float>(0,1);
     return quat<float>::fromAxisAngle(axis, angle);
     }
 
+/*! The rank 4 tensors are all symmetric, so they are kept in the 15 component form of sym_tensor4: the annealing
+    evaluates the order parameter of an orientation from three 15 component dot products instead of building and
+    subtracting 81 component tensors. The best orientation of the replicates is then refined by Newton's method in
+    double precision. The per-particle outputs are only computed by their getters, from a copy of the orientations,
+    so a compute stores 16 bytes per particle.
+*/
 void CubaticOrderParameter::compute(quat<float> *orientations,
                                     unsigned int n,
                                     unsigned int n_replicates)
     {
-    // change the size of the particle tensor if the number of particles
-    if (m_n != n)
+    m_n_replicates = n_replicates;
+    // the per-particle outputs are computed from the orientations when they are asked for
+    m_orientations.assign(orientations, orientations + n);
+    if (n != m_n)
         {
-        m_particle_tensor = std::shared_ptr<float>(new float[n*81], std::default_delete<float[]>());
-        m_particle_order_parameter = std::shared_ptr<float>(new float[n], std::default_delete<float[]>());
+        m_particle_tensor.reset();
+        m_particle_order_parameter.reset();
         }
-    // reset the values
-    memset((void*)&m_global_tensor.data, 0, sizeof(float)*81);
-    memset((void*)m_particle_tensor.get(), 0, sizeof(float)*n*81);
-    memset((void*)m_particle_order_parameter.get(), 0, sizeof(float)*n);
-    // calculate per-particle tensor
-    parallel_for(blocked_range<size_t>(0,n),
-        [=] (const blocked_range<size_t>& r)
+    m_particle_tensor_valid = false;
+    m_particle_order_parameter_valid = false;
+    // the mean of the per-particle tensors, 2 sum_k u_k x u_k x u_k x u_k over the rotated axes u_k of each
+    // particle, which are never stored
+    sym_tensor4<double> sum = parallel_reduce(blocked_range<size_t>(0,n), sym_tensor4<double>(),
+        [=] (const blocked_range<size_t>& r, sym_tensor4<double> l_sum)
             {
-            // create index object to access the array
-            Index2D a_i = Index2D(n, 81);
-            // create the local coordinate system
-            vec3<float> v[3];
-            v[0] = vec3<float>(1,0,0);
-            v[1] = vec3<float>(0,1,0);
-            v[2] = vec3<float>(0,0,1);
             for (size_t i = r.begin(); i != r.end(); i++)
                 {
-                // get the orientation for the particle
-                quat<float> l_orientation = orientations[i];
-                tensor4<float> l_mbar = tensor4<float>();
-                for (unsigned int j = 0; j < 3; j++)
-                    {
-                    // rotate local vector
-                    vec3<float> v_r = rotate(l_orientation, v[j]);
-                    tensor4<float> r4_tensor(v_r);
-                    l_mbar += r4_tensor;
-                    }
-                // apply normalization
-                l_mbar *= (float)2.0;
-                // set the values
-                for (unsigned int j = 0; j < 81; j++)
-                    {
-                    m_particle_tensor.get()[a_i(i,j)] = l_mbar.data[j];
-                    }
+                sym_tensor4<float> l_tensor = axesTensor(orientations[i]);
+                for (unsigned int c = 0; c < SYM_TENSOR4_SIZE; c++)
+                    l_sum.data[c] += l_tensor.data[c];
                 }
+            return l_sum;
+            },
+        [] (const sym_tensor4<double>& a, const sym_tensor4<double>& b)
+            {
+            return a + b;
             });
-    // now calculate the global tensor
-    parallel_for(blocked_range<size_t>(0,81),
-        [=] (const blocked_range<size_t>& r)
-           {
-           // create index object to access the array
-           Index2D a_i = Index2D(n, 81);
-           float n_inv = 1.0/(float)n;
-           for (size_t i = r.begin(); i != r.end(); i++)
-               {
-               float tensor_value = 0;
-               for (unsigned int j = 0; j < n; j++)
-                   {
-                   tensor_value += m_particle_tensor.get()[a_i(j,i)];
-                   }
-               tensor_value *= n_inv;
-               m_global_tensor.data[i] = tensor_value;
-               }
-           });
+    sym_tensor4<double> d_mean_tensor = sum*(1.0/(double)n);
+    sym_tensor4<float> mean_tensor(d_mean_tensor);
     // subtract off the general tensor
-    m_global_tensor -= m_gen_r4_tensor;
+    m_global_tensor = mean_tensor.full() - m_gen_r4_tensor;
     // prep for the simulated annealing
-    std::shared_ptr<float> p_cubatic_tensor = std::shared_ptr<float>(new float[m_n_replicates*81], std::default_delete<float[]>());
-    memset((void*)p_cubatic_tensor.get(), 0, sizeof(float)*m_n_replicates*81);
-    std::shared_ptr<float> p_cubatic_order_parameter = std::shared_ptr<float>(new float[m_n_replicates], std::default_delete<float[]>());
-    memset((void*)p_cubatic_order_parameter.get(), 0, sizeof(float)*m_n_replicates);
-    std::shared_ptr< quat<float> > p_cubatic_orientation = std::shared_ptr< quat<float> >(new quat<float>[m_n_replicates], std::default_delete< quat<float>[]>());
-    memset((void*)p_cubatic_orientation.get(), 0, sizeof(quat<float>)*m_n_replicates);
+    std::vector< sym_tensor4<float> > p_cubatic_tensor(m_n_replicates);
+    std::vector<float> p_cubatic_order_parameter(m_n_replicates, 0);
+    std::vector< quat<float> > p_cubatic_orientation(m_n_replicates);
+    sym_tensor4<float> *l_cubatic_tensor = p_cubatic_tensor.data();
+    float *l_cubatic_order_parameter = p_cubatic_order_parameter.data();
+    quat<float> *l_cubatic_orientation = p_cubatic_orientation.data();
+    const sym_tensor4<float> gen_tensor = m_gen_sym_tensor;
+    const float gen_norm_sq = m_gen_norm_sq;
     // parallel for to handle the replicates...
     parallel_for(blocked_range<size_t>(0, m_n_replicates),
-        [=] (const blocked_range<size_t>& r)
+        [=, &mean_tensor] (const blocked_range<size_t>& r)
             {
-            // create thread-specific rng
-            unsigned int thread_start = (unsigned int)r.begin();
-            Saru l_saru(m_seed, thread_start, 0xffaabb);
-            // create Index2D to access shared arrays
-            Index2D a_i = Index2D(m_n_replicates, 81);
             for (size_t i = r.begin(); i != r.end(); i++)
                 {
-                tensor4<float> cubatic_tensor;
-                tensor4<float> new_cubatic_tensor;
+                // each replicate draws from a stream of its own, so that the result does not depend on how the
+                // replicates are split between the threads
+                util::RandomStream l_rng(m_seed, (unsigned int) i, 0xffaabb);
+                sym_tensor4<float> cubatic_tensor;
+                sym_tensor4<float> new_cubatic_tensor;
                 // need to generate random orientation
-                quat<float> cubatic_orientation = calcRandomQuaternion(l_saru);
+                quat<float> cubatic_orientation = calcRandomQuaternion(l_rng);
                 quat<float> current_orientation = cubatic_orientation;
-                float cubatic_order_parameter = 0;
-                // now calculate the cubatic tensor
-                calcCubaticTensor((float*)&cubatic_tensor.data, cubatic_orientation);
-                calcCubaticOrderParameter(cubatic_order_parameter, (float*)&cubatic_tensor.data);
-                float new_order_parameter = cubatic_order_parameter;
+                // now calculate the cubatic tensor and its order parameter
+                float cubatic_order_parameter = cubaticOrderParameter(cubatic_orientation, mean_tensor, gen_tensor,
+                                                                      gen_norm_sq, cubatic_tensor);
                 // set initial temperature and count
                 float t_current = m_t_initial;
                 unsigned int loop_count = 0;
@@ -258,23 +377,22 @@ void CubaticOrderParameter::compute(quat<float> *orientations,
                 while ((t_current > m_t_final) && (loop_count < 10000))
                     {
                     loop_count++;
-                    current_orientation = calcRandomQuaternion(l_saru, 0.1)*(cubatic_orientation);
-                    // now calculate the cubatic tensor
-                    calcCubaticTensor((float*)&new_cubatic_tensor.data, current_orientation);
-                    calcCubaticOrderParameter(new_order_parameter, (float*)&new_cubatic_tensor.data);
+                    current_orientation = calcRandomQuaternion(l_rng, 0.1)*(cubatic_orientation);
+                    float new_order_parameter = cubaticOrderParameter(current_orientation, mean_tensor, gen_tensor,
+                                                                      gen_norm_sq, new_cubatic_tensor);
                     if (new_order_parameter > cubatic_order_parameter)
                         {
-                        memcpy((void*)&cubatic_tensor.data, (void*)&new_cubatic_tensor.data, sizeof(float)*81);
+                        cubatic_tensor = new_cubatic_tensor;
                         cubatic_order_parameter = new_order_parameter;
                         cubatic_orientation = current_orientation;
                         }
                     else
                         {
                         float boltzmann_factor = exp(-(cubatic_order_parameter - new_order_parameter) / t_current);
-                        float test_value = l_saru.s<float>(0,1);
+                        float test_value = l_rng.s<float>(0,1);
                         if (boltzmann_factor >= test_value)
                             {
-                            memcpy((void*)&cubatic_tensor.data, (void*)&new_cubatic_tensor.data, sizeof(float)*81);
+                            cubatic_tensor = new_cubatic_tensor;
                             cubatic_order_parameter = new_order_parameter;
                             cubatic_orientation = current_orientation;
                             }
@@ -286,51 +404,41 @@ void CubaticOrderParameter::compute(quat<float> *orientations,
                     t_current *= m_scale;
                     }
                 // set values
-                float *tensor_ptr = (float*)&(p_cubatic_tensor.get()[a_i(i,0)]);
-                memcpy((void*)tensor_ptr, (void*)&cubatic_tensor, sizeof(float)*81);
-                p_cubatic_orientation.get()[i].s = cubatic_orientation.s;
-                p_cubatic_orientation.get()[i].v = cubatic_orientation.v;
-                p_cubatic_order_parameter.get()[i] = cubatic_order_parameter;
+                l_cubatic_tensor[i] = cubatic_tensor;
+                l_cubatic_orientation[i] = cubatic_orientation;
+                l_cubatic_order_parameter[i] = cubatic_order_parameter;
                 }
             });
     // now, find max and set the values
     unsigned int max_idx = 0;
-    float max_cubatic_order_parameter = p_cubatic_order_parameter.get()[max_idx];
+    float max_cubatic_order_parameter = p_cubatic_order_parameter[max_idx];
     for (unsigned int i = 1; i < m_n_replicates; i++)
         {
-        if (p_cubatic_order_parameter.get()[i] > max_cubatic_order_parameter)
+        if (p_cubatic_order_parameter[i] > max_cubatic_order_parameter)
             {
             max_idx = i;
-            max_cubatic_order_parameter = p_cubatic_order_parameter.get()[i];
+            max_cubatic_order_parameter = p_cubatic_order_parameter[i];
             }
         }
-    // set the values
-    Index2D a_i = Index2D(m_n_replicates, 81);
-    memcpy((void*)&m_cubatic_tensor.data, (void*)&(p_cubatic_tensor.get()[a_i(max_idx,0)]), sizeof(float)*81);
-    m_cubatic_orientation.s = p_cubatic_orientation.get()[max_idx].s;
-    m_cubatic_orientation.v = p_cubatic_orientation.get()[max_idx].v;
-    m_cubatic_order_parameter = p_cubatic_order_parameter.get()[max_idx];
-    // now calculate the per-particle order parameters
-    parallel_for(blocked_range<size_t>(0,n),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index2D a_i = Index2D(n, 81);
-            tensor4<float> l_mbar;
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                tensor4<float> l_particle_tensor = tensor4<float>((float*)&m_particle_tensor.get()[a_i(i,0)]);
-                for (unsigned int j = 0; j < 81; j++)
-                    {
-                    l_mbar = l_particle_tensor - m_gen_r4_tensor;
-                    }
-                tensor4<float> diff;
-                diff = l_mbar - m_cubatic_tensor;
-                m_particle_order_parameter.get()[i] = 1.0 - dot(diff, diff)/dot(m_cubatic_tensor, m_cubatic_tensor);
-                }
-            });
+    // refine the best orientation
+    quat<float> best = p_cubatic_orientation[max_idx];
+    quat<double> refined = refineCubaticOrientation(quat<double>(best.s, vec3<double>(best.v.x, best.v.y, best.v.z)),
+                                                    d_mean_tensor, sym_tensor4<double>(m_gen_sym_tensor), m_gen_norm_sq);
+    m_cubatic_orientation = quat<float>(refined.s, vec3<float>(refined.v.x, refined.v.y, refined.v.z));
+    sym_tensor4<float> cubatic_tensor;
+    m_cubatic_order_parameter = cubaticOrderParameter(m_cubatic_orientation, mean_tensor, gen_tensor, gen_norm_sq,
+                                                      cubatic_tensor);
+    // keep whichever of the annealed and the refined orientations is better in single precision
+    if (m_cubatic_order_parameter < max_cubatic_order_parameter)
+        {
+        m_cubatic_orientation = best;
+        m_cubatic_order_parameter = max_cubatic_order_parameter;
+        cubatic_tensor = p_cubatic_tensor[max_idx];
+        }
+    m_cubatic_sym_tensor = cubatic_tensor;
+    m_cubatic_tensor = cubatic_tensor.full() - m_gen_r4_tensor;
     // save the last computed number of particles
     m_n = n;
-    m_n_replicates = n_replicates;
     }
 
 }; }; // end namespace freud::order
@@ -10,11 +10,12 @@
 #define __APPLE__
 
 #include <memory>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 #include "TensorMath.h"
-#include "saruprng.h"
+#include "RandomStream.h"
 
 #include "NearestNeighbors.h"
 #include "box.h"
@@ -29,7 +30,13 @@
 
 namespace freud { namespace order {
 //! Compute the cubatic order parameter for a set of points
-/*!
+/*! The cubatic orientation is the one whose cubatic tensor best matches the global tensor of the particles, found
+    by simulated annealing from n_replicates random orientations and then refined by Newton's method. All the
+    tensors involved are symmetric, so they are handled as sym_tensor4; the full 81 component tensors are only built
+    for the getters.
+
+    Only the orientations are kept from a compute: the global tensor is a parallel reduction over the particles, and
+    the per-particle tensors and order parameters are computed when first asked for.
 */
 class CubaticOrderParameter
     {
@@ -58,7 +65,7 @@ class CubaticOrderParameter
         //! Get a reference to the last computed rdf
         float getCubaticOrderParameter();
 
-        quat<float> calcRandomQuaternion(Saru &saru, float angle_multiplier);
+        quat<float> calcRandomQuaternion(util::RandomStream &rng, float angle_multiplier);
 
         std::shared_ptr<float> getParticleCubaticOrderParameter();
 
@@ -94,14 +101,18 @@ class CubaticOrderParameter
 
         float m_cubatic_order_parameter;
         quat<float> m_cubatic_orientation;
-        std::shared_ptr<float> m_particle_order_parameter;
+        std::shared_ptr<float> m_particle_order_parameter;          //!< Order parameter of each particle, on demand
         tensor4<float> m_global_tensor;
         tensor4<float> m_cubatic_tensor;
-        std::shared_ptr<float> m_particle_tensor;
-
-        // saru rng
-        Saru m_saru;
-        unsigned int m_seed;
+        std::shared_ptr<float> m_particle_tensor;                   //!< Full particle tensors, built on demand
+        bool m_particle_order_parameter_valid;                      //!< true once the last compute filled them
+        bool m_particle_tensor_valid;                               //!< true once the last compute filled them
+        std::vector< quat<float> > m_orientations;                  //!< Orientations of the last compute
+        sym_tensor4<float> m_cubatic_sym_tensor;                    //!< Axes tensor of the cubatic orientation
+        sym_tensor4<float> m_gen_sym_tensor;                        //!< Symmetric part of the general tensor
+        float m_gen_norm_sq;                                        //!< Squared norm of the general tensor
+
+        unsigned int m_seed;                                        //!< Seed of the random streams of the replicates
     };
 
 }; }; // end namespace freud::order
@@ -0,0 +1,141 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <array>
+#include <cmath>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+#include "BatchSphericalHarmonics.h"
+
+#ifndef _FIXED_SPHERICAL_HARMONICS_H__
+#define _FIXED_SPHERICAL_HARMONICS_H__
+
+/*! \file FixedSphericalHarmonics.h
+    \brief Sums of the spherical harmonics of a single l known at compile time over blocks of bonds
+*/
+
+namespace freud { namespace order {
+
+//! Sum Y_L^m, 0 <= m <= L, over a block of bond vectors, for a spherical harmonic number L fixed at compile time
+/*! The harmonics and their convention are those of BatchSphericalHarmonics, evaluated by the same recurrences in
+    the same order, so the sums are the same to the last bit. Only the values of l = L are kept: the recurrence of
+    each m runs in two arrays of the block, and the sums of the 2 (L + 1) values go to fixed size accumulators the
+    compiler keeps in registers, instead of storing the values of every (l, m) to sum them afterwards.
+
+    The Ql and Wl classes use it for the usual l through BondHarmonics, which falls back to BatchSphericalHarmonics
+    for the other l.
+*/
+template<unsigned int L>
+class FixedSphericalHarmonics
+    {
+    public:
+        //! Sums of the real or imaginary parts of Y_L^m, by m = 0..L
+        typedef std::array<float, L+1> Sums;
+
+        //! Constructor
+        FixedSphericalHarmonics()
+            {
+            // the coefficients of BatchSphericalHarmonics, for l <= L
+            double pmm = sqrt(1.0/(4.0*M_PI));
+            m_pmm[0] = pmm;
+            for (unsigned int m = 1; m <= L; m++)
+                {
+                pmm *= sqrt((2.0*m + 1.0)/(2.0*m));
+                m_pmm[m] = pmm;
+                }
+            for (unsigned int m = 0; m <= L; m++)
+                for (unsigned int l = 0; l <= L; l++)
+                    {
+                    m_a[m][l] = m_b[m][l] = 0;
+                    if (l < m + 2)
+                        continue;
+                    double l2 = double(l)*l, m2 = double(m)*m, lm1 = double(l - 1)*(l - 1);
+                    m_a[m][l] = sqrt((4.0*l2 - 1.0)/(l2 - m2));
+                    m_b[m][l] = sqrt((lm1 - m2)/(4.0*lm1 - 1.0));
+                    }
+            }
+
+        //! The coefficients of L, computed once
+        static const FixedSphericalHarmonics& get()
+            {
+            static const FixedSphericalHarmonics sph;
+            return sph;
+            }
+
+        //! Sum Y_L^m over n <= BatchSphericalHarmonics::block_size bonds, which need not be unit vectors
+        void sum(const vec3<float> *bonds, unsigned int n, Sums& sum_re, Sums& sum_im) const
+            {
+            const unsigned int B = BatchSphericalHarmonics::block_size;
+            float x[B], y[B], z[B], pow_re[B], pow_im[B], p_prev[B], p_cur[B];
+            for (unsigned int b = 0; b < n; b++)
+                {
+                vec3<float> v = bonds[b];
+                float inv_r = 1.0f/sqrtf(dot(v, v));
+                x[b] = v.x*inv_r;
+                y[b] = v.y*inv_r;
+                z[b] = v.z*inv_r;
+                pow_re[b] = 1.0f;
+                pow_im[b] = 0.0f;
+                }
+
+            for (unsigned int m = 0; m <= L; m++)
+                {
+                // (x + iy)^m
+                if (m > 0)
+                    for (unsigned int b = 0; b < n; b++)
+                        {
+                        float re = pow_re[b]*x[b] - pow_im[b]*y[b];
+                        pow_im[b] = pow_re[b]*y[b] + pow_im[b]*x[b];
+                        pow_re[b] = re;
+                        }
+
+                // the Legendre function of (L, m), by increasing l from l = m
+                const float pmm = m_pmm[m];
+                const float *p = p_cur;
+                if (m == L)
+                    {
+                    for (unsigned int b = 0; b < n; b++)
+                        p_cur[b] = pmm;
+                    }
+                else
+                    {
+                    const float c = sqrtf(2.0f*m + 3.0f);
+                    for (unsigned int b = 0; b < n; b++)
+                        {
+                        p_prev[b] = pmm;
+                        p_cur[b] = c*z[b]*p_prev[b];
+                        }
+                    for (unsigned int l = m + 2; l <= L; l++)
+                        {
+                        const float a = m_a[m][l];
+                        const float bb = m_b[m][l];
+                        for (unsigned int b = 0; b < n; b++)
+                            {
+                            float p_next = a*(z[b]*p_cur[b] - bb*p_prev[b]);
+                            p_prev[b] = p_cur[b];
+                            p_cur[b] = p_next;
+                            }
+                        }
+                    }
+
+                float s_re = 0, s_im = 0;
+                for (unsigned int b = 0; b < n; b++)
+                    {
+                    s_re += p[b]*pow_re[b];
+                    s_im += p[b]*pow_im[b];
+                    }
+                sum_re[m] = s_re;
+                sum_im[m] = s_im;
+                }
+            }
+
+    private:
+        std::array<float, L+1> m_pmm;                       //!< Normalized reduced Legendre function of each (m, m)
+        std::array<std::array<float, L+1>, L+1> m_a;        //!< First coefficient of the recurrence, by m then l
+        std::array<std::array<float, L+1>, L+1> m_b;        //!< Second coefficient of the recurrence, by m then l
+    };
+
+}; }; // end namespace freud::order
+
+#endif // _FIXED_SPHERICAL_HARMONICS_H__
@@ -2,10 +2,13 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "HexOrderParameter.h"
+#include "BondPowers.h"
 #include "ScopedGILRelease.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <complex>
+#include <vector>
 
 using namespace std;
 using namespace tbb;
@@ -16,10 +19,15 @@ using namespace tbb;
 
 namespace freud { namespace order {
 
+//! Number of bonds whose e^{i k phi} are computed together
+const unsigned int HEX_BOND_BLOCK = 256;
+
 HexOrderParameter::HexOrderParameter(float rmax, float k, unsigned int n)
     : m_box(box::Box()), m_rmax(rmax), m_k(k), m_Np(0)
     {
     m_nn = new locality::NearestNeighbors(m_rmax, n==0? (unsigned int) k: n);
+    // only the wrapped vectors are used
+    m_nn->setStoreDistances(false);
     }
 
 HexOrderParameter::~HexOrderParameter()
@@ -40,33 +48,49 @@ void HexOrderParameter::compute(box::Box& box, const vec3<float> *points, unsign
         m_psi_array = std::shared_ptr<complex<float> >(new complex<float> [Np], std::default_delete<complex<float>[]>());
         }
 
+    const unsigned int num_neighbors = m_nn->getNumNeighbors();
+    const unsigned int *neighbor_list = m_nn->getNeighborList().get();
+    const vec3<float> *wrapped_vectors = m_nn->getWrappedVectors().get();
+    complex<float> *psi_array = m_psi_array.get();
+    const BondPowers powers(m_k);
+    const complex<float> norm(m_k);
+    // the bonds of whole particles are gathered into blocks, whose e^{i k phi} are computed in one vectorized loop
+    const unsigned int block_particles = std::max(1u, HEX_BOND_BLOCK/num_neighbors);
+
     // compute the order parameter
     parallel_for(blocked_range<size_t>(0,Np),
         [=] (const blocked_range<size_t>& r)
         {
+        const unsigned int block_bonds = block_particles*num_neighbors;
+        std::vector<float> x(block_bonds), y(block_bonds), re(block_bonds), im(block_bonds);
+        std::vector<unsigned char> counted(block_bonds);
 
-        for(size_t i=r.begin(); i!=r.end(); ++i)
+        for (size_t first = r.begin(); first < r.end(); first += block_particles)
             {
-            m_psi_array.get()[i] = 0;
-            vec3<float> ref = points[i];
-
-            //loop over neighbors
-            locality::NearestNeighbors::iteratorneighbor it = m_nn->iterneighbor(i);
-            for (unsigned int j = it.begin(); !it.atEnd(); j = it.next())
+            size_t last = std::min(first + block_particles, r.end());
+            unsigned int n = (last - first)*num_neighbors;
+            const unsigned int *neighbors = neighbor_list + first*num_neighbors;
+            const vec3<float> *vectors = wrapped_vectors + first*num_neighbors;
+            for (unsigned int b = 0; b < n; b++)
                 {
+                // padded neighbors and coincident points are not counted, and stand in as (1, 0)
+                vec3<float> delta = vectors[b];
+                counted[b] = neighbors[b] != UINT_MAX && dot(delta, delta) > 1e-6;
+                x[b] = counted[b] ? delta.x : 1.0f;
+                y[b] = counted[b] ? delta.y : 0.0f;
+                }
+            powers.compute(&x[0], &y[0], n, &re[0], &im[0]);
 
-                //compute r between the two particles
-                vec3<float> delta = m_box.wrap(points[j] - ref);
-
-                float rsq = dot(delta, delta);
-                if (rsq > 1e-6)
+            for (size_t i = first; i < last; i++)
+                {
+                complex<float> psi = 0;
+                for (unsigned int b = (i - first)*num_neighbors; b < (i - first + 1)*num_neighbors; b++)
                     {
-                    //compute psi for neighboring particle(only constructed for 2d)
-                    float psi_ij = atan2f(delta.y, delta.x);
-                    m_psi_array.get()[i] += exp(complex<float>(0,m_k*psi_ij));
+                    if (counted[b])
+                        psi += complex<float>(re[b], im[b]);
                     }
+                psi_array[i] = psi/norm;
                 }
-            m_psi_array.get()[i] /= complex<float>(m_k);
             }
         });
     // save the last computed number of particles
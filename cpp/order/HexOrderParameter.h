@@ -29,7 +29,7 @@
 namespace freud { namespace order {
 
 //! Compute the hexagonal order parameter for a set of points
-/*!
+/*! For an integer k, e^{i k phi} of each bond is a power of its unit vector, computed by BondPowers without atan2.
 */
 class HexOrderParameter
     {
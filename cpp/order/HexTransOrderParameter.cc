@@ -0,0 +1,106 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "HexTransOrderParameter.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file HexTransOrderParameter.cc
+    \brief Compute the k-atic order parameters of several k and the translational order parameter in one pass
+*/
+
+namespace freud { namespace order {
+
+HexTransOrderParameter::HexTransOrderParameter(float rmax, const std::vector<unsigned int>& k_values, unsigned int n)
+    : m_box(box::Box()), m_rmax(rmax), m_k_values(k_values), m_kmax(0), m_n(n), m_Np(0)
+    {
+    if (m_k_values.size() == 0)
+        throw invalid_argument("at least one k value is needed");
+    for (unsigned int ki = 0; ki < m_k_values.size(); ki++)
+        {
+        if (m_k_values[ki] < 1)
+            throw invalid_argument("k must be one or greater!");
+        m_kmax = std::max(m_kmax, m_k_values[ki]);
+        }
+    if (m_n == 0)
+        m_n = m_kmax;
+    m_nn = new locality::NearestNeighbors(m_rmax, m_n);
+    // only the wrapped vectors are used
+    m_nn->setStoreDistances(false);
+    }
+
+HexTransOrderParameter::~HexTransOrderParameter()
+    {
+    delete m_nn;
+    }
+
+void HexTransOrderParameter::compute(box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    // compute the neighbors once for every order parameter
+    m_box = box;
+    m_nn->compute(m_box,points,Np,points,Np);
+    m_nn->setRMax(m_rmax);
+
+    const unsigned int num_k = m_k_values.size();
+    // reallocate the output arrays if they are not the right size
+    if (Np != m_Np)
+        {
+        m_psi_array = std::shared_ptr<complex<float> >(new complex<float> [Np*num_k], std::default_delete<complex<float>[]>());
+        m_dr_array = std::shared_ptr<complex<float> >(new complex<float> [Np], std::default_delete<complex<float>[]>());
+        }
+
+    const unsigned int num_neighbors = m_n;
+    const unsigned int kmax = m_kmax;
+    const unsigned int *k_values = &m_k_values[0];
+    const unsigned int *neighbor_list = m_nn->getNeighborList().get();
+    const vec3<float> *wrapped_vectors = m_nn->getWrappedVectors().get();
+    complex<float> *psi_array = m_psi_array.get();
+    complex<float> *dr_array = m_dr_array.get();
+
+    parallel_for(blocked_range<size_t>(0,Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        // powers of the direction of a bond, from 0 to kmax, reused for every bond
+        std::vector< complex<float> > powers(kmax+1);
+
+        for(size_t i=r.begin(); i!=r.end(); ++i)
+            {
+            complex<float> *psi = psi_array + i*num_k;
+            complex<float> dr = 0;
+            for (unsigned int ki = 0; ki < num_k; ki++)
+                psi[ki] = 0;
+
+            for (unsigned int nn = 0; nn < num_neighbors; nn++)
+                {
+                // padded neighbors have no wrapped vector
+                if (neighbor_list[i*num_neighbors + nn] == UINT_MAX)
+                    continue;
+                const vec3<float> delta = wrapped_vectors[i*num_neighbors + nn];
+                float rsq = dot(delta, delta);
+                if (rsq > 1e-6)
+                    {
+                    dr += complex<float>(delta.x, delta.y);
+
+                    // e^(i k phi) is the k-th power of the unit vector of the bond
+                    const complex<float> direction = complex<float>(delta.x, delta.y)/sqrtf(rsq);
+                    powers[0] = 1;
+                    for (unsigned int k = 1; k <= kmax; k++)
+                        powers[k] = powers[k-1]*direction;
+                    for (unsigned int ki = 0; ki < num_k; ki++)
+                        psi[ki] += powers[k_values[ki]];
+                    }
+                }
+            for (unsigned int ki = 0; ki < num_k; ki++)
+                psi[ki] /= complex<float>(k_values[ki]);
+            dr_array[i] = dr/complex<float>(num_neighbors);
+            }
+        });
+    // save the last computed number of particles
+    m_Np = Np;
+    }
+
+}; }; // end namespace freud::order
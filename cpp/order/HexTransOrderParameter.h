@@ -0,0 +1,110 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <complex>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "NearestNeighbors.h"
+#include "box.h"
+
+#ifndef _HEX_TRANS_ORDER_PARAMETER_H__
+#define _HEX_TRANS_ORDER_PARAMETER_H__
+
+/*! \file HexTransOrderParameter.h
+    \brief Compute the k-atic order parameters of several k and the translational order parameter in one pass
+*/
+
+namespace freud { namespace order {
+
+//! Compute the k-atic order parameters for a list of k values and the translational order parameter at once
+/*! The n nearest neighbors are found once and traversed once for all the order parameters, instead of once by each
+    HexOrderParameter and TransOrderParameter. For each particle i:
+    - \f$ \psi_k(i) = \frac{1}{k} \sum_j e^{i k \phi_{ij}} \f$ for each k, as HexOrderParameter(rmax, k, n) computes,
+    - \f$ d_r(i) = \frac{1}{n} \sum_j (x_{ij} + i y_{ij}) \f$, as TransOrderParameter(rmax, n, n) computes.
+
+    \f$ e^{i k \phi_{ij}} \f$ is the k-th power of the unit complex number \f$ (x_{ij} + i y_{ij}) / r_{ij} \f$, so the
+    powers of each bond up to the largest k are built by successive products instead of an atan2 and an exp per bond
+    and k; this is why k must be an integer here.
+
+    The psi array holds the values of the k of each particle contiguously, in the order k was given.
+*/
+class HexTransOrderParameter
+    {
+    public:
+        //! Constructor
+        /*! \param rmax initial radius of the neighbor search
+            \param k_values symmetries k of the k-atic order parameters, each one or greater
+            \param n number of neighbors, the largest k if 0
+        */
+        HexTransOrderParameter(float rmax, const std::vector<unsigned int>& k_values, unsigned int n=0);
+
+        //! Destructor
+        ~HexTransOrderParameter();
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the number of k values
+        unsigned int getNumK() const
+            {
+            return m_k_values.size();
+            }
+
+        //! Get the k values
+        const std::vector<unsigned int>& getKValues() const
+            {
+            return m_k_values;
+            }
+
+        //! Get the number of neighbors
+        unsigned int getNumNeighbors() const
+            {
+            return m_n;
+            }
+
+        //! Compute the k-atic order parameters of every k and the translational order parameter
+        void compute(box::Box& box,
+                     const vec3<float> *points,
+                     unsigned int Np);
+
+        //! Get a reference to the last computed psi for each particle and k
+        std::shared_ptr< std::complex<float> > getPsi()
+            {
+            return m_psi_array;
+            }
+
+        //! Get a reference to the last computed dr
+        std::shared_ptr< std::complex<float> > getDr()
+            {
+            return m_dr_array;
+            }
+
+        unsigned int getNP()
+            {
+            return m_Np;
+            }
+
+    private:
+        box::Box m_box;                         //!< Simulation box the particles belong in
+        float m_rmax;                           //!< Maximum r at which to determine neighbors
+        std::vector<unsigned int> m_k_values;   //!< Symmetries of the k-atic order parameters
+        unsigned int m_kmax;                    //!< Largest k
+        unsigned int m_n;                       //!< Number of neighbors
+        locality::NearestNeighbors *m_nn;       //!< Nearest Neighbors for the computation
+        unsigned int m_Np;                      //!< Last number of points computed
+
+        std::shared_ptr< std::complex<float> > m_psi_array;     //!< psi of every k for each particle
+        std::shared_ptr< std::complex<float> > m_dr_array;      //!< dr for each particle
+    };
+
+}; }; // end namespace freud::order
+
+#endif // _HEX_TRANS_ORDER_PARAMETER_H__
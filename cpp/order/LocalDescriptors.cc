@@ -9,8 +9,11 @@
 #include <tbb/tbb.h>
 
 #include "LocalDescriptors.h"
+#include "BatchSphericalHarmonics.h"
 #include "ScopedGILRelease.h"
 #include "HOOMDMatrix.h"
+#include "HalfFloat.h"
+#include "SymmetricEigen.h"
 
 using namespace std;
 using namespace tbb;
@@ -23,9 +26,11 @@ using hoomd::matrix::diagonalize;
 namespace freud { namespace order {
 
 LocalDescriptors::LocalDescriptors(
-        unsigned int neighmax, unsigned int lmax, float rmax, bool negative_m):
+        unsigned int neighmax, unsigned int lmax, float rmax, bool negative_m,
+        LocalDescriptorOutput output):
     m_neighmax(neighmax), m_lmax(lmax),
-    m_negative_m(negative_m), m_nn(rmax, neighmax), m_Nref(0), m_nNeigh(0)
+    m_negative_m(negative_m), m_nn(rmax, neighmax), m_Nref(0), m_nNeigh(0),
+    m_output(output), m_per_bond(false), m_num_rows(0), m_local_sph(BatchSphericalHarmonics(lmax))
     {
     }
 
@@ -35,50 +40,237 @@ void LocalDescriptors::computeNList(const box::Box& box, const vec3<float> *r_re
     m_nn.compute(box, r_ref, Nref, r, Np);
     }
 
+//! \internal
+//! Copy the harmonics of bond b of the last block of sph, in the order of fsph
+static void copyBondHarmonics(const BatchSphericalHarmonics& sph, unsigned int b, bool negative_m,
+                              complex<float> *out)
+    {
+    for(unsigned int l(0); l <= sph.getLMax(); ++l)
+        {
+        for(int m(0); m <= int(l); ++m)
+            *out++ = sph.get(l, m, b);
+        if(negative_m)
+            for(int m(1); m <= int(l); ++m)
+                *out++ = sph.get(l, -m, b);
+        }
+    }
+
+//! \internal
+//! Copy the real harmonics of bond b of the last block of sph, in the order of the complex ones
+static void copyBondHarmonics(const BatchSphericalHarmonics& sph, unsigned int b, bool negative_m,
+                              float *out)
+    {
+    const float sqrt2(sqrtf(2.0f));
+    for(unsigned int l(0); l <= sph.getLMax(); ++l)
+        {
+        *out++ = sph.get(l, 0, b).real();
+        for(int m(1); m <= int(l); ++m)
+            *out++ = sqrt2*sph.get(l, m, b).real();
+        if(negative_m)
+            for(int m(1); m <= int(l); ++m)
+                *out++ = sqrt2*sph.get(l, m, b).imag();
+        }
+    }
+
+//! \internal
+//! Rows of the rotation to the principal axes of an inertia tensor, by increasing moment of inertia
+/*! The eigen decomposition is done in closed form, except for near
+    degenerate moments where the Jacobi iterations of diagonalize find a
+    basis of the degenerate space. The sign of each axis is chosen so that
+    its largest component is positive, whichever way it was found.
+*/
+static void principalAxes(const float inertiaTensor[3][3], vec3<float>& rotation_0,
+                          vec3<float>& rotation_1, vec3<float>& rotation_2)
+    {
+    double tensor[3][3];
+    for(size_t ii(0); ii < 3; ++ii)
+        for(size_t jj(0); jj < 3; ++jj)
+            tensor[ii][jj] = inertiaTensor[ii][jj];
+
+    double eigenvalues[3];
+    double eigenvectors[3][3];
+    if(!util::symmetricEigen3(tensor, eigenvalues, eigenvectors))
+        {
+        float jacobi_tensor[3][3];
+        float jacobi_values[3];
+        float jacobi_vectors[3][3];
+        for(size_t ii(0); ii < 3; ++ii)
+            for(size_t jj(0); jj < 3; ++jj)
+                jacobi_tensor[ii][jj] = inertiaTensor[ii][jj];
+        diagonalize(jacobi_tensor, jacobi_values, jacobi_vectors);
+
+        // sort the eigenvalues in ascending order
+        unsigned int order[3] = {0, 1, 2};
+        std::sort(order, order + 3, [&jacobi_values](unsigned int a, unsigned int b)
+                  { return jacobi_values[a] < jacobi_values[b]; });
+        for(size_t k(0); k < 3; ++k)
+            {
+            eigenvalues[k] = jacobi_values[order[k]];
+            for(size_t ii(0); ii < 3; ++ii)
+                eigenvectors[ii][k] = jacobi_vectors[ii][order[k]];
+            }
+        }
+
+    vec3<float> *rows[3] = {&rotation_0, &rotation_1, &rotation_2};
+    for(size_t k(0); k < 3; ++k)
+        {
+        size_t largest(0);
+        for(size_t ii(1); ii < 3; ++ii)
+            if(fabs(eigenvectors[ii][k]) > fabs(eigenvectors[largest][k]))
+                largest = ii;
+        const double sign((eigenvectors[largest][k] < 0) ? -1.0 : 1.0);
+        *rows[k] = vec3<float>(sign*eigenvectors[0][k], sign*eigenvectors[1][k], sign*eigenvectors[2][k]);
+        }
+    }
+
+void LocalDescriptors::storeBlock(const BatchSphericalHarmonics& sph, const size_t *rows, float *scratch)
+    {
+    const unsigned int width(getSphWidth());
+    for(unsigned int b(0); b < sph.getNumBonds(); ++b)
+        {
+        if(m_output == ComplexHarmonics)
+            copyBondHarmonics(sph, b, m_negative_m, m_sphArray.get() + rows[b]*width);
+        else if(m_output == RealHarmonics)
+            copyBondHarmonics(sph, b, m_negative_m, m_realSphArray.get() + rows[b]*width);
+        else
+            {
+            copyBondHarmonics(sph, b, m_negative_m, scratch);
+            uint16_t *out(m_halfSphArray.get() + rows[b]*width);
+            for(unsigned int k(0); k < width; ++k)
+                out[k] = util::floatToHalf(scratch[k]);
+            }
+        }
+    }
+
+void LocalDescriptors::clearRow(size_t row)
+    {
+    const unsigned int width(getSphWidth());
+    if(m_output == ComplexHarmonics)
+        std::fill(m_sphArray.get() + row*width, m_sphArray.get() + (row + 1)*width, 0);
+    else if(m_output == RealHarmonics)
+        std::fill(m_realSphArray.get() + row*width, m_realSphArray.get() + (row + 1)*width, 0);
+    else
+        std::fill(m_halfSphArray.get() + row*width, m_halfSphArray.get() + (row + 1)*width, 0);
+    }
+
+void LocalDescriptors::accumulateBlock(const BatchSphericalHarmonics& sph, complex<float> *Qlm) const
+    {
+    for(unsigned int l(0); l <= m_lmax; ++l)
+        {
+        complex<float> *Q(Qlm + l*l + l);
+        for(int m(-int(l)); m <= int(l); ++m)
+            Q[m] += sph.sum(l, m);
+        }
+    }
+
+void LocalDescriptors::storeInvariants(size_t i, complex<float> *Qlm, size_t num_bonds,
+                                       const std::vector<const Wigner3jTable*>& wigner3j)
+    {
+    const unsigned int num_lm((m_lmax + 1)*(m_lmax + 1));
+    float *out(m_invariantArray.get() + i*(m_lmax + 1));
+    if(num_bonds)
+        for(unsigned int k(0); k < num_lm; ++k)
+            Qlm[k] /= float(num_bonds);
+    for(unsigned int l(0); l <= m_lmax; ++l)
+        {
+        const complex<float> *Q(Qlm + l*l);
+        if(m_output == PowerSpectrum)
+            {
+            float power(0);
+            for(unsigned int k(0); k < 2*l + 1; ++k)
+                power += norm(Q[k]);
+            out[l] = power;
+            }
+        else
+            out[l] = wigner3j[l]->contract(Q).real();
+        }
+    }
+
 void LocalDescriptors::compute(const box::Box& box, unsigned int nNeigh,
                                const vec3<float> *r_ref, unsigned int Nref,
                                const vec3<float> *r, unsigned int Np,
                                const quat<float> *q_ref,
-                               LocalDescriptorOrientation orientation)
+                               LocalDescriptorOrientation orientation,
+                               const locality::NeighborList *nlist)
     {
-    if(m_nn.getNref() != Nref || m_nn.getNp() != Np)
-        throw runtime_error("Must call computeNList() before compute");
+    // the nearest neighbors fill nNeigh padded rows per particle, a
+    // given neighbor list one row per bond
+    const bool per_bond(nlist != NULL);
+    if(per_bond)
+        nlist->validate(Nref, Np);
+    else
+        {
+        if(m_nn.getNref() != Nref || m_nn.getNp() != Np)
+            throw runtime_error("Must call computeNList() before compute");
+        nlist = m_nn.getNlist();
+        }
+    const bool invariant(isInvariant());
+    const size_t num_rows(invariant ? Nref : (per_bond ? nlist->getNumBonds() : size_t(nNeigh)*Nref));
+    const unsigned int width(invariant ? m_lmax + 1 : getSphWidth());
 
     // reallocate the output array if it is not the right size
-    if (Nref != m_Nref || nNeigh != m_nNeigh)
+    if (num_rows != m_num_rows || !(m_sphArray || m_realSphArray || m_halfSphArray || m_invariantArray))
         {
-        m_sphArray = std::shared_ptr<complex<float> >(new complex<float>[nNeigh*Nref*getSphWidth()], std::default_delete<complex<float>[]>());
-        m_nNeigh = nNeigh;
+        if(invariant)
+            m_invariantArray = std::shared_ptr<float>(new float[num_rows*width], std::default_delete<float[]>());
+        else if(m_output == ComplexHarmonics)
+            m_sphArray = std::shared_ptr<complex<float> >(new complex<float>[num_rows*width], std::default_delete<complex<float>[]>());
+        else if(m_output == RealHarmonics)
+            m_realSphArray = std::shared_ptr<float>(new float[num_rows*width], std::default_delete<float[]>());
+        else
+            m_halfSphArray = std::shared_ptr<uint16_t>(new uint16_t[num_rows*width], std::default_delete<uint16_t[]>());
+        m_num_rows = num_rows;
         }
+    m_nNeigh = (per_bond || invariant) ? 0 : nNeigh;
+    m_per_bond = per_bond && !invariant;
+
+    // the bispectrum contracts the Qlm of each l with its Wigner 3j coefficients
+    std::vector<const Wigner3jTable*> wigner3j;
+    if(m_output == Bispectrum)
+        for(unsigned int l(0); l <= m_lmax; ++l)
+            wigner3j.push_back(&getWigner3jTable(l));
 
     parallel_for(blocked_range<size_t>(0,Nref),
         [=] (const blocked_range<size_t>& br)
         {
-        fsph::PointSPHEvaluator<float> sph_eval(m_lmax);
-        Index2D idx_nlist(m_neighmax, 0);
+        // the bonds of each particle are evaluated in blocks, then copied to their rows
+        BatchSphericalHarmonics& sph = m_local_sph.local();
+        vec3<float> block[BatchSphericalHarmonics::block_size];
+        size_t block_rows[BatchSphericalHarmonics::block_size];
+        std::vector<float>& scratch = m_local_scratch.local();
+        scratch.resize(width);
+        std::vector<complex<float> >& Qlm = m_local_Qlm.local();
+        Qlm.resize(invariant ? (m_lmax + 1)*(m_lmax + 1) : 0);
+        const unsigned int *index_j(nlist->getIndexJ().get());
 
         for(size_t i=br.begin(); i!=br.end(); ++i)
             {
             const vec3<float> r_i(r_ref[i]);
+            const size_t first_bond(nlist->getFirstBond(i));
+            size_t num_bonds(nlist->getLastBond(i) - first_bond);
+            if(!per_bond)
+                num_bonds = std::min(num_bonds, size_t(nNeigh));
 
             vec3<float> rotation_0, rotation_1, rotation_2;
 
-            if(orientation == LocalNeighborhood)
+            if(invariant || orientation == Global)
+                {
+                rotation_0 = vec3<float>(1, 0, 0);
+                rotation_1 = vec3<float>(0, 1, 0);
+                rotation_2 = vec3<float>(0, 0, 1);
+                }
+            else if(orientation == LocalNeighborhood)
                 {
                 float inertiaTensor[3][3];
                 for(size_t ii(0); ii < 3; ++ii)
                     for(size_t jj(0); jj < 3; ++jj)
                         inertiaTensor[ii][jj] = 0;
 
-                for(size_t k(0); k < nNeigh; ++k)
+                for(size_t k(0); k < num_bonds; ++k)
                     {
-                    const size_t idx_neigh_j(idx_nlist(k, i));
-                    const size_t idx_j(m_nn.getNeighborList().get()[idx_neigh_j]);
-                    if(idx_j == UINT_MAX)
-                        continue;
-                    const float rsq(m_nn.getRsqList().get()[idx_neigh_j]);
-                    const vec3<float> r_j(r[idx_j]);
+                    const vec3<float> r_j(r[index_j[first_bond + k]]);
                     const vec3<float> rvec(box.wrap(r_j - r_i));
+                    const float rsq(dot(rvec, rvec));
 
                     for(size_t ii(0); ii < 3; ++ii)
                         inertiaTensor[ii][ii] += rsq;
@@ -94,37 +286,7 @@ void LocalDescriptors::compute(const box::Box& box, unsigned int nNeigh,
                     inertiaTensor[2][2] -= rvec.z*rvec.z;
                     }
 
-                float eigenvalues[3];
-                float eigenvectors[3][3];
-
-                diagonalize(inertiaTensor, eigenvalues, eigenvectors);
-
-                // Sort eigenvalues and eigenvectors so that
-                // eigenvalues is in ascending order. This is
-                // a kind of gross way to do it, but it gets
-                // the job done.
-                if(eigenvalues[0] > eigenvalues[1])
-                    {
-                    std::swap(eigenvalues[0], eigenvalues[1]);
-                    for(size_t ii(0); ii < 3; ++ii)
-                        std::swap(eigenvectors[ii][0], eigenvectors[ii][1]);
-                    }
-                if(eigenvalues[1] > eigenvalues[2])
-                    {
-                    std::swap(eigenvalues[1], eigenvalues[2]);
-                    for(size_t ii(0); ii < 3; ++ii)
-                        std::swap(eigenvectors[ii][1], eigenvectors[ii][2]);
-                    }
-                if(eigenvalues[0] > eigenvalues[1])
-                    {
-                    std::swap(eigenvalues[0], eigenvalues[1]);
-                    for(size_t ii(0); ii < 3; ++ii)
-                        std::swap(eigenvectors[ii][0], eigenvectors[ii][1]);
-                    }
-
-                rotation_0 = vec3<float>(eigenvectors[0][0], eigenvectors[1][0], eigenvectors[2][0]);
-                rotation_1 = vec3<float>(eigenvectors[0][1], eigenvectors[1][1], eigenvectors[2][1]);
-                rotation_2 = vec3<float>(eigenvectors[0][2], eigenvectors[1][2], eigenvectors[2][2]);
+                principalAxes(inertiaTensor, rotation_0, rotation_1, rotation_2);
                 }
             else if(orientation == ParticleLocal)
                 {
@@ -133,48 +295,41 @@ void LocalDescriptors::compute(const box::Box& box, unsigned int nNeigh,
                 rotation_1 = rotmat.row1;
                 rotation_2 = rotmat.row2;
                 }
-            else if (orientation == Global)
-                {
-                rotation_0 = vec3<float>(1, 0, 0);
-                rotation_1 = vec3<float>(0, 1, 0);
-                rotation_2 = vec3<float>(0, 0, 1);
-                }
             else
                 {
                 throw std::runtime_error("Uncaught orientation mode in LocalDescriptors::compute");
                 }
 
-            unsigned int sphCount(i*nNeigh*getSphWidth());
+            const size_t first_row(per_bond ? first_bond : i*nNeigh);
+            unsigned int n_block(0);
+            if(invariant)
+                std::fill(Qlm.begin(), Qlm.end(), complex<float>(0));
 
-            for(size_t k(0); k < nNeigh; ++k)
+            for(size_t k(0); k < num_bonds; ++k)
                 {
-                const size_t idx_neigh_j(idx_nlist(k, i));
-                const size_t idx_j(m_nn.getNeighborList().get()[idx_neigh_j]);
-                if(idx_j == UINT_MAX)
-                    {
-                    std::fill(&m_sphArray.get()[sphCount], &m_sphArray.get()[sphCount + getSphWidth()], 0);
-                    }
-                else
+                const vec3<float> r_j(r[index_j[first_bond + k]]);
+                const vec3<float> rij(box.wrap(r_j - r_i));
+                block[n_block] = vec3<float>(dot(rotation_0, rij),
+                                             dot(rotation_1, rij),
+                                             dot(rotation_2, rij));
+                block_rows[n_block++] = first_row + k;
+                if(n_block == BatchSphericalHarmonics::block_size || k + 1 == num_bonds)
                     {
-                    const float rsq(m_nn.getRsqList().get()[idx_neigh_j]);
-                    const vec3<float> r_j(r[idx_j]);
-                    const vec3<float> rij(box.wrap(r_j - r_i));
-                    const vec3<float> bond(dot(rotation_0, rij),
-                                           dot(rotation_1, rij),
-                                           dot(rotation_2, rij));
-
-                    const float magR(sqrt(rsq));
-                    float theta(atan2(bond.y, bond.x)); // theta in [-pi..pi] initially
-                    if(theta < 0)
-                        theta += 2*M_PI; // move theta into [0..2*pi]
-                    const float phi(acos(bond.z/magR)); // phi in [0..pi]
-
-                    sph_eval.compute(phi, theta);
-
-                    std::copy(sph_eval.begin(m_negative_m), sph_eval.end(), &m_sphArray.get()[sphCount]);
+                    sph.compute(block, n_block);
+                    if(invariant)
+                        accumulateBlock(sph, &Qlm[0]);
+                    else
+                        storeBlock(sph, block_rows, &scratch[0]);
+                    n_block = 0;
                     }
-                sphCount += getSphWidth();
                 }
+
+            if(invariant)
+                storeInvariants(i, &Qlm[0], num_bonds, wigner3j);
+            // pad the rows of the missing neighbors
+            else if(!per_bond)
+                for(size_t k(num_bonds); k < nNeigh; ++k)
+                    clearRow(first_row + k);
             }
         });
 
@@ -2,14 +2,20 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include <memory>
+#include <stdint.h>
+#include <vector>
 
 #include "NearestNeighbors.h"
+#include "NeighborList.h"
 // hack to keep VectorMath's swap from polluting the global namespace
 #include "VectorMath.h"
 #include "box.h"
 
 #include "tbb/atomic.h"
 
+#include "BatchSphericalHarmonics.h"
+#include "ComputeArena.h"
+#include "wigner3j.h"
 #include "../../extern/fsph/src/spherical_harmonics.hpp"
 
 #ifndef _LOCAL_DESCRIPTORS_H__
@@ -26,8 +32,37 @@ enum LocalDescriptorOrientation {
     Global,
     ParticleLocal};
 
+//! Storage of the descriptors: complex harmonics, or real harmonics in single or half precision, for each bond; or
+//! rotation invariants of each particle
+enum LocalDescriptorOutput {
+    ComplexHarmonics,
+    RealHarmonics,
+    HalfRealHarmonics,
+    PowerSpectrum,
+    Bispectrum};
+
 /*! Compute a set of descriptors (a numerical "fingerprint") of a
 *  particle's local environment.
+*
+*  The descriptors of each bond are stored in one row of getSphWidth()
+*  values. Bonds come either from the nearest neighbors found by
+*  computeNList(), in nNeigh zero padded rows per particle, or from a
+*  given NeighborList, one row per bond in the order of the list, so
+*  that variable numbers of neighbors need no padding.
+*
+*  Real harmonics hold the same information in half the memory of the
+*  complex ones, in the same layout: Y_l^0, then sqrt(2) Re Y_l^m for
+*  m = 1..l, then (with negative_m) sqrt(2) Im Y_l^m for m = 1..l.
+*  HalfRealHarmonics stores them as IEEE 754 half precision bits, which
+*  numpy reads as float16.
+*
+*  PowerSpectrum and Bispectrum instead reduce the harmonics of the bonds
+*  of each particle to lmax + 1 rotation invariants, without storing the
+*  harmonics: with Q_lm the average of Y_lm over the bonds, the power
+*  spectrum is sum_m |Q_lm|^2 and the bispectrum is the Wigner 3j
+*  contraction of Q_l with itself twice, as in Wl. The bispectrum is only
+*  tabulated for the even l from 2 to 20, and zero for other l. Both are
+*  independent of the orientation mode and of negative_m.
 */
 class LocalDescriptors
     {
@@ -38,8 +73,10 @@ public:
     //! \param lmax Maximum spherical harmonic l to consider
     //! \param rmax Initial guess of the maximum radius to look for n_neigh neighbors
     //! \param negative_m whether to calculate Ylm for negative m
+    //! \param output storage of the descriptors
     LocalDescriptors(unsigned int neighmax,
-                     unsigned int lmax, float rmax, bool negative_m);
+                     unsigned int lmax, float rmax, bool negative_m,
+                     LocalDescriptorOutput output=ComplexHarmonics);
 
     //! Get the maximum number of neighbors
     unsigned int getNeighmax() const
@@ -71,28 +108,75 @@ public:
         return m_Nref;
         }
 
+    //! Get the storage of the descriptors
+    LocalDescriptorOutput getOutput() const
+        {
+        return m_output;
+        }
+
+    //! Test if the descriptors are rotation invariants of each particle
+    bool isInvariant() const
+        {
+        return m_output == PowerSpectrum || m_output == Bispectrum;
+        }
+
+    //! Test if the last compute stored one row per bond of a given neighbor list
+    bool isPerBond() const
+        {
+        return m_per_bond;
+        }
+
+    //! Get the number of rows of descriptors of the last compute
+    size_t getNumRows() const
+        {
+        return m_num_rows;
+        }
+
     //! Compute the nearest neighbors for each particle
     void computeNList(const box::Box& box, const vec3<float> *r_ref,
                       unsigned int Nref, const vec3<float> *r, unsigned int Np);
 
     //! Compute the local neighborhood descriptors given some
     //! positions and the number of particles
+    //!
+    //! Without \a nlist, the first nNeigh neighbors found by
+    //! computeNList() are used; with it, all of its bonds are, and
+    //! nNeigh is ignored.
     void compute(const box::Box& box, unsigned int nNeigh,
                  const vec3<float> *r_ref, unsigned int Nref,
                  const vec3<float> *r, unsigned int Np,
                  const quat<float> *q_ref,
-                 LocalDescriptorOrientation orientation);
+                 LocalDescriptorOrientation orientation,
+                 const locality::NeighborList *nlist=NULL);
 
     // //! Python wrapper for compute
     // void computePy(boost::python::numeric::array r,
     //     boost::python::numeric::array q);
 
-    //! Get a reference to the last computed spherical harmonic array
+    //! Get a reference to the last computed spherical harmonic array, with ComplexHarmonics
     std::shared_ptr<std::complex<float> > getSph()
         {
         return m_sphArray;
         }
 
+    //! Get a reference to the last computed real spherical harmonic array, with RealHarmonics
+    std::shared_ptr<float> getRealSph()
+        {
+        return m_realSphArray;
+        }
+
+    //! Get a reference to the last computed half precision real spherical harmonic array, with HalfRealHarmonics
+    std::shared_ptr<uint16_t> getHalfSph()
+        {
+        return m_halfSphArray;
+        }
+
+    //! Get a reference to the last computed lmax + 1 invariants of each particle, with PowerSpectrum or Bispectrum
+    std::shared_ptr<float> getInvariants()
+        {
+        return m_invariantArray;
+        }
+
     unsigned int getSphWidth() const
         {
         return fsph::sphCount(m_lmax) +
@@ -112,15 +196,40 @@ public:
     //     }
 
 private:
+    //! Store the descriptors of the bonds of the last block of sph in their rows
+    void storeBlock(const BatchSphericalHarmonics& sph, const size_t *rows, float *scratch);
+
+    //! Fill a row with zeros
+    void clearRow(size_t row);
+
+    //! Add the harmonics of the last block of sph, summed over its bonds, to the Qlm of every l, by m = -l..l
+    void accumulateBlock(const BatchSphericalHarmonics& sph, std::complex<float> *Qlm) const;
+
+    //! Reduce the summed Qlm of num_bonds bonds of particle i to its invariants
+    void storeInvariants(size_t i, std::complex<float> *Qlm, size_t num_bonds,
+                         const std::vector<const Wigner3jTable*>& wigner3j);
+
     unsigned int m_neighmax;          //!< Maximum number of neighbors to calculate
     unsigned int m_lmax;              //!< Maximum spherical harmonic l to calculate
     bool m_negative_m;                //!< true if we should compute Ylm for negative m
     locality::NearestNeighbors m_nn;  //!< NearestNeighbors to find neighbors with
     unsigned int m_Nref;              //!< Last number of points computed
     unsigned int m_nNeigh;            //!< Last number of neighbors computed
+    LocalDescriptorOutput m_output;   //!< Storage of the descriptors
+    bool m_per_bond;                  //!< true if the last compute stored one row per bond of a neighbor list
+    size_t m_num_rows;                //!< Number of rows of the last compute
+    util::ThreadScratch<BatchSphericalHarmonics> m_local_sph;         //!< Evaluator of each thread
+    util::ThreadScratch<std::vector<float> > m_local_scratch;         //!< Row of each thread before conversion
+    util::ThreadScratch<std::vector<std::complex<float> > > m_local_Qlm;  //!< Summed Qlm of each thread
 
     //! Spherical harmonics for each neighbor
     std::shared_ptr<std::complex<float> > m_sphArray;
+    //! Real spherical harmonics for each neighbor
+    std::shared_ptr<float> m_realSphArray;
+    //! Half precision real spherical harmonics for each neighbor
+    std::shared_ptr<uint16_t> m_halfSphArray;
+    //! Rotation invariants for each particle
+    std::shared_ptr<float> m_invariantArray;
     };
 
 }; }; // end namespace freud::order
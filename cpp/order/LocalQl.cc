@@ -2,7 +2,10 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "LocalQl.h"
+#include "ComputeArena.h"
+#include "Annotation.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <complex>
 //#include <boost/math/special_functions.hpp>
@@ -17,7 +20,7 @@ using namespace std;
 namespace freud { namespace order {
 
 LocalQl::LocalQl(const box::Box& box, float rmax, unsigned int l, float rmin)
-    :m_box(box), m_rmax(rmax), m_lc(box, rmax), m_l(l), m_rmin(rmin)
+    :m_box(box), m_rmax(rmax), m_lc(box, rmax), m_l(l), m_rmin(rmin), m_harmonics(l, true)
     {
     if (m_rmax < 0.0f or m_rmin < 0.0f)
         throw invalid_argument("rmin and rmax must be positive!");
@@ -47,238 +50,94 @@ LocalQl::LocalQl(const box::Box& box, float rmax, unsigned int l, float rmin)
     }
 */
 
-// Calculating Ylm using fsph module
+// Calculating Ylm using the shared harmonics evaluator
 void LocalQl::Ylm(const float theta, const float phi, std::vector<std::complex<float> > &Y)
     {
-    if(Y.size() != 2*m_l+1)
+    if (Y.size() != 2*m_l+1)
         Y.resize(2*m_l+1);
 
-    fsph::PointSPHEvaluator<float> sph_eval(m_l);
-
-    unsigned int j(0);
-    // old definition in compute (theta: 0...pi, phi: 0...2pi)
-    // in fsph, the definition is flipped
-    sph_eval.compute(theta, phi);
-
-    for(typename fsph::PointSPHEvaluator<float>::iterator iter(sph_eval.begin_l(m_l, 0, true));
-        iter != sph_eval.end(); ++iter)
-        {
-        Y[j] = *iter;
-        ++j;
-        }
+    m_harmonics.evaluate(theta, phi, &Y[0]);
     }
 
-
 // void LocalQl::compute(const float3 *points, unsigned int Np)
-void LocalQl::compute(const vec3<float> *points, unsigned int Np)
+void LocalQl::compute(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist,
+                      bool keep_Qlmi)
     {
+    util::ScopedRange annotation("freud::LocalQl::compute");
 
     //Set local data size
     m_Np = Np;
 
-    //Initialize cell list
-    m_lc.computeCellList(m_box,points,m_Np);
+    // the bonds of the cell list are in the order the cells were visited
+    if (nlist != NULL)
+        nlist->validate(m_Np, m_Np);
+    else
+        {
+        m_lc.computeNlist(m_box, points, m_Np, points, m_Np, true, true);
+        nlist = m_lc.getNlist();
+        }
 
-    float rminsq = m_rmin * m_rmin;
-    float rmaxsq = m_rmax * m_rmax;
-    float normalizationfactor = 4*M_PI/(2*m_l+1);
+    // keep the arrays of the previous call when they are large enough
+    if (keep_Qlmi)
+        util::reuseArray(m_Qlmi, (2*m_l+1)*m_Np);
+    else
+        m_Qlmi.reset();
+    util::reuseArray(m_Qli, m_Np);
+    util::reuseArray(m_Qlm, 2*m_l+1);
+
+    BondHarmonics::Outputs out;
+    out.Qlmi = m_Qlmi.get();
+    out.Ql = m_Qli.get();
+    out.normalization = 4*M_PI/(2*m_l+1);
+    out.Qlm = m_Qlm.get();
+    m_harmonics.computeQlm(m_box, points, m_Np, nlist, m_rmin*m_rmin, m_rmax*m_rmax, out);
+    }
 
+void LocalQl::beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                         const vec3<float> *points, unsigned int n_p)
+    {
+    if (ref_points != points || n_ref != n_p)
+        throw invalid_argument("LocalQl needs the reference points of a FrameAnalysis to be its points");
+    m_box = box;
+    m_Np = n_p;
+    util::reuseArray(m_Qlmi, (2*m_l+1)*m_Np);
+    util::reuseArray(m_Qli, m_Np);
+    util::reuseArray(m_Qlm, 2*m_l+1);
+    m_harmonics.beginQlm(m_Np);
+    }
 
-    //newmanrs:  For efficiency, if Np != m_Np, we could not reallocate these! Maybe.
-    // for safety and debugging laziness, reallocate each time
-    m_Qlmi = std::shared_ptr<complex<float> >(new complex<float> [(2*m_l+1)*m_Np], std::default_delete<complex<float>[]>());
-    m_Qli = std::shared_ptr<float>(new float[m_Np], std::default_delete<float[]>());
-    m_Qlm = std::shared_ptr<complex<float> >(new complex<float>[2*m_l+1], std::default_delete<complex<float>[]>());
-    memset((void*)m_Qlmi.get(), 0, sizeof(complex<float>)*(2*m_l+1)*m_Np);
-    memset((void*)m_Qli.get(), 0, sizeof(float)*m_Np);
-    memset((void*)m_Qlm.get(), 0, sizeof(complex<float>)*(2*m_l+1));
+void LocalQl::processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors)
+    {
+    m_harmonics.computeParticleQlm(i, neighbors.j, neighbors.delta, neighbors.rsq, neighbors.num,
+                                   m_rmin*m_rmin, m_rmax*m_rmax, m_Qlmi.get() + (2*m_l+1)*i);
+    }
 
-    for (unsigned int i = 0; i<m_Np; i++)
-        {
-        //get cell point is in
-        // float3 ref = points[i];
-        vec3<float> ref = points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
-        unsigned int neighborcount=0;
-
-        //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-            {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            //iterate over particles in neighboring cells
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
-                {
-                if (i == j)
-                {
-                    continue;
-                }
-                // rij = rj - ri, from i pointing to j.
-                // float dx = float(points[j].x - ref.x);
-                // float dy = float(points[j].y - ref.y);
-                // float dz = float(points[j].z - ref.z);
-
-                // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                vec3<float> delta = m_box.wrap(points[j] - ref);
-                // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                float rsq = dot(delta, delta);
-
-                if (rsq < rmaxsq and rsq > rminsq)
-                    {
-                    // phi is usually in range 0..2Pi, but
-                    // it only appears in Ylm as exp(im\phi),
-                    // so range -Pi..Pi will give same results.
-                    float phi = atan2(delta.y,delta.x);      //-Pi..Pi
-                    float theta = acos(delta.z / sqrt(rsq)); //0..Pi
-                    // if the points are directly on top of each other for whatever reason,
-                    // theta should be zero instead of nan.
-
-                    if (rsq == float(0))
-                    {
-                        theta = 0;
-                    }
-
-                    std::vector<std::complex<float> > Y;
-                    LocalQl::Ylm(theta, phi,Y);  //Fill up Ylm vector
-
-                    for(unsigned int k = 0; k < (2*m_l+1); ++k)
-                        {
-                        m_Qlmi.get()[(2*m_l+1)*i+k]+=Y[k];
-                        }
-                    neighborcount++;
-                    }
-                }
-            } //End loop going over neighbor cells (and thus all neighboring particles);
-            //Normalize!
-            for(unsigned int k = 0; k < (2*m_l+1); ++k)
-                {
-                m_Qlmi.get()[(2*m_l+1)*i+k]/= neighborcount;
-                m_Qli.get()[i]+= abs( m_Qlmi.get()[(2*m_l+1)*i+k]*conj(m_Qlmi.get()[(2*m_l+1)*i+k]) ); //Square by multiplying self w/ complex conj, then take real comp
-                m_Qlm.get()[k]+= m_Qlmi.get()[(2*m_l+1)*i+k];
-                }
-        m_Qli.get()[i]*=normalizationfactor;
-        m_Qli.get()[i]=sqrt(m_Qli.get()[i]);
-        } //Ends loop over particles i for Qlmi calcs
+void LocalQl::endFrame()
+    {
+    m_harmonics.endQlm();
+    BondHarmonics::Outputs out;
+    out.Ql = m_Qli.get();
+    out.normalization = 4*M_PI/(2*m_l+1);
+    out.Qlm = m_Qlm.get();
+    m_harmonics.deriveQlm(m_Np, m_Qlmi.get(), out);
     }
 
 // void LocalQl::computeAve(const float3 *points, unsigned int Np)
 void LocalQl::computeAve(const vec3<float> *points, unsigned int Np)
     {
-    //Set local data size
-    m_Np = Np;
-
-    //Initialize cell list
-    m_lc.computeCellList(m_box,points,m_Np);
-
-    float rminsq = m_rmin * m_rmin;
-    float rmaxsq = m_rmax * m_rmax;
-    float normalizationfactor = 4*M_PI/(2*m_l+1);
-
-
-    //newmanrs:  For efficiency, if Np != m_Np, we could not reallocate these! Maybe.
-    // for safety and debugging laziness, reallocate each time
-    m_AveQlmi = std::shared_ptr<complex<float> >(new complex<float> [(2*m_l+1)*m_Np], std::default_delete<complex<float>[]>());
-    m_AveQli = std::shared_ptr<float>(new float[m_Np], std::default_delete<float[]>());
-    m_AveQlm = std::shared_ptr<complex<float> >(new complex<float> [(2*m_l+1)], std::default_delete<complex<float>[]>());
-    memset((void*)m_AveQlmi.get(), 0, sizeof(complex<float>)*(2*m_l+1)*m_Np);
-    memset((void*)m_AveQli.get(), 0, sizeof(float)*m_Np);
-    memset((void*)m_AveQlm.get(), 0, sizeof(complex<float>)*(2*m_l+1));
-
-    for (unsigned int i = 0; i<m_Np; i++)
-        {
-        //get cell point is in
-        // float3 ref = points[i];
-        vec3<float> ref = points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
-        unsigned int neighborcount=1;
-
-        //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-            {
-            //get cell points of 1st neighbor
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            //iterate over particles in neighboring cells
-            locality::LinkCell::iteratorcell shell1 = m_lc.itercell(neigh_cell);
-            for (unsigned int n1 = shell1.next(); !shell1.atEnd(); n1 = shell1.next())
-                {
-                // float3 ref1 = points[n1];
-                vec3<float> ref1 = points[n1];
-                unsigned int ref1_cell = m_lc.getCell(ref1);
-                if (n1 == i)
-                    {
-                        continue;
-                    }
-                // rij = rj - ri, from i pointing to j.
-                // float dx = float(points[n1].x - ref.x);
-                // float dy = float(points[n1].y - ref.y);
-                // float dz = float(points[n1].z - ref.z);
-
-                // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                vec3<float> delta = m_box.wrap(ref1 - ref);
-                // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                float rsq = dot(delta, delta);
-
-                if (rsq < rmaxsq and rsq > rminsq)
-                    {
-
-                    //loop over 2nd neighboring cells
-                    const std::vector<unsigned int>& neigh1_cells = m_lc.getCellNeighbors(ref1_cell);
-                    for (unsigned int neigh1_idx = 0; neigh1_idx < neigh1_cells.size(); neigh1_idx++)
-                        {
-                        //get cell points of 2nd neighbor
-                        unsigned int neigh1_cell = neigh1_cells[neigh1_idx];
-
-                        //iterate over particles in neighboring cells
-                        locality::LinkCell::iteratorcell it = m_lc.itercell(neigh1_cell);
-                        for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
-                            {
-                            if (n1 == j)
-                                {
-                                    continue;
-                                }
-                            // rij = rj - ri, from i pointing to j.
-                            // float dx1 = float(points[j].x - ref1.x);
-                            // float dy1 = float(points[j].y - ref1.y);
-                            // float dz1 = float(points[j].z - ref1.z);
-
-                            // float3 delta1 = m_box.wrap(make_float3(dx1, dy1, dz1));
-                            vec3<float> delta1 = m_box.wrap(points[j] - ref1);
-                            // float rsq1 = delta1.x*delta1.x + delta1.y*delta1.y + delta1.z*delta1.z;
-                            float rsq1 = dot(delta1, delta1);
-
-                            if (rsq1 < rmaxsq and rsq1 > rminsq)
-                                {
-                                for(unsigned int k = 0; k < (2*m_l+1); ++k)
-                                    {
-                                    //adding all the Qlm of the neighbors
-                                    // change to Index?
-                                    // Seg fault is here
-                                    // m_Qlmi is not instantiated in this loop method, compute must be called first?
-                                    m_AveQlmi.get()[(2*m_l+1)*i+k] += m_Qlmi.get()[(2*m_l+1)*j+k];
-                                    }
-                                neighborcount++;
-                                }
-                            }
-                        }
-                    }
-                } //End loop going over neighbor cells (and thus all neighboring particles);
-            }
-        //Normalize!
-        for (unsigned int k = 0; k < (2*m_l+1); ++k)
-            {
-                //adding the Qlm of the particle i itself
-                m_AveQlmi.get()[(2*m_l+1)*i+k] += m_Qlmi.get()[(2*m_l+1)*i+k];
-                m_AveQlmi.get()[(2*m_l+1)*i+k]/= neighborcount;
-                m_AveQlm.get()[k]+= m_AveQlmi.get()[(2*m_l+1)*i+k];
-                m_AveQli.get()[i]+= abs( m_AveQlmi.get()[(2*m_l+1)*i+k]*conj(m_AveQlmi.get()[(2*m_l+1)*i+k]) ); //Square by multiplying self w/ complex conj, then take real comp
-            }
-        m_AveQli.get()[i]*=normalizationfactor;
-        m_AveQli.get()[i]=sqrt(m_AveQli.get()[i]);
-        } //Ends loop over particles i for Qlmi calcs
+    if (!m_Qlmi)
+        throw invalid_argument("computeAve needs the Qlm of each particle, which compute must keep");
+
+    // keep the arrays of the previous call when they are large enough
+    util::reuseArray(m_AveQli, Np);
+    util::reuseArray(m_AveQlm, 2*m_l+1);
+
+    // the neighbors of the neighbors are those found by compute
+    BondHarmonics::Outputs out;
+    out.Ql = m_AveQli.get();
+    out.normalization = 4*M_PI/(2*m_l+1);
+    out.Qlm = m_AveQlm.get();
+    m_harmonics.computeAveQlm(Np, m_Qlmi.get(), out);
     }
 
 // void LocalQl::computeNorm(const float3 *points, unsigned int Np)
@@ -289,8 +148,7 @@ void LocalQl::computeNorm(const vec3<float> *points, unsigned int Np)
     m_Np = Np;
     float normalizationfactor = 4*M_PI/(2*m_l+1);
 
-    m_QliNorm = std::shared_ptr<float>(new float[m_Np], std::default_delete<float[]>());
-    memset((void*)m_QliNorm.get(), 0, sizeof(float)*m_Np);
+    util::reuseArray(m_QliNorm, m_Np);
 
     //Average Q_lm over all particles, which was calculated in compute
     for(unsigned int k = 0; k < (2*m_l+1); ++k)
@@ -298,15 +156,9 @@ void LocalQl::computeNorm(const vec3<float> *points, unsigned int Np)
         m_Qlm.get()[k]/= m_Np;
         }
 
-    for(unsigned int i = 0; i < m_Np; ++i)
-        {
-        for(unsigned int k = 0; k < (2*m_l+1); ++k)
-            {
-            m_QliNorm.get()[i]+= abs( m_Qlm.get()[k]*conj(m_Qlm.get()[k]) ); //Square by multiplying self w/ complex conj, then take real comp
-            }
-            m_QliNorm.get()[i]*=normalizationfactor;
-            m_QliNorm.get()[i]=sqrt(m_QliNorm.get()[i]);
-        }
+    // the same value for all the particles
+    float QlNorm = m_harmonics.computeQl(m_Qlm.get(), normalizationfactor);
+    std::fill(m_QliNorm.get(), m_QliNorm.get() + m_Np, QlNorm);
     }
 
 // void LocalQl::computeAveNorm(const float3 *points, unsigned int Np)
@@ -317,8 +169,7 @@ void LocalQl::computeAveNorm(const vec3<float> *points, unsigned int Np)
     m_Np = Np;
     float normalizationfactor = 4*M_PI/(2*m_l+1);
 
-    m_QliAveNorm = std::shared_ptr<float>(new float[m_Np], std::default_delete<float[]>());
-    memset((void*)m_QliAveNorm.get(), 0, sizeof(float)*m_Np);
+    util::reuseArray(m_QliAveNorm, m_Np);
 
     //Average Q_lm over all particles, which was calculated in compute
     for(unsigned int k = 0; k < (2*m_l+1); ++k)
@@ -326,15 +177,9 @@ void LocalQl::computeAveNorm(const vec3<float> *points, unsigned int Np)
         m_AveQlm.get()[k]/= m_Np;
         }
 
-    for(unsigned int i = 0; i < m_Np; ++i)
-        {
-        for(unsigned int k = 0; k < (2*m_l+1); ++k)
-            {
-            m_QliAveNorm.get()[i]+= abs( m_AveQlm.get()[k]*conj(m_AveQlm.get()[k]) ); //Square by multiplying self w/ complex conj, then take real comp
-            }
-            m_QliAveNorm.get()[i]*=normalizationfactor;
-            m_QliAveNorm.get()[i]=sqrt(m_QliAveNorm.get()[i]);
-        }
+    // the same value for all the particles
+    float QlAveNorm = m_harmonics.computeQl(m_AveQlm.get(), normalizationfactor);
+    std::fill(m_QliAveNorm.get(), m_QliAveNorm.get() + m_Np, QlAveNorm);
     }
 
 
@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <tbb/tbb.h>
 #include <memory>
 #include <complex>
 //include <boost/math/special_functions.hpp>
@@ -9,8 +10,9 @@
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "FrameAnalysis.h"
 #include "box.h"
-#include "../../extern/fsph/src/spherical_harmonics.hpp"
+#include "BondHarmonics.h"
 
 #ifndef _LOCAL_QL_H__
 #define _LOCAL_QL_H__
@@ -39,7 +41,7 @@ namespace freud { namespace order {
  *
  * For more details see Wolfgan Lechner (2008) (DOI: 10.1063/Journal of Chemical Physics 129.114707)
 */
-class LocalQl
+class LocalQl : public locality::PairAnalysis
     {
     public:
         //! LocalQl Class Constructor
@@ -72,8 +74,13 @@ class LocalQl
         //! Compute the local rotationally invariant Ql order parameter
         // void compute(const float3 *points,
         //              unsigned int Np);
+        /*! If \a nlist is given, its bonds are used instead of building the internal cell list. The Qlm of each
+            particle, (2l + 1) Np values, are only kept if \a keep_Qlmi is true, which computeAve needs.
+        */
         void compute(const vec3<float> *points,
-                     unsigned int Np);
+                     unsigned int Np,
+                     const locality::NeighborList *nlist=NULL,
+                     bool keep_Qlmi=true);
 
         // //! Python wrapper for computing the order parameter from a Nx3 numpy array of float32.
         // void computePy(boost::python::numeric::array points);
@@ -119,6 +126,22 @@ class LocalQl
         //     return num_util::makeNum(arr, m_Np);
         //     }
 
+        //! Get the cutoff of the neighbors of a FrameAnalysis
+        virtual float getPairRMax() const
+            {
+            return m_rmax;
+            }
+
+        //! Prepare compute() from the neighbors of a FrameAnalysis, whose reference points must be the points
+        virtual void beginFrame(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                                const vec3<float> *points, unsigned int n_p);
+
+        //! Compute the Qlm of particle i from its neighbors found by a FrameAnalysis
+        virtual void processNeighbors(unsigned int i, const locality::NeighborBlock& neighbors);
+
+        //! Finish compute() once a FrameAnalysis has processed every particle
+        virtual void endFrame();
+
         //! Get a reference to the last computed AveQl for each particle.  Returns NaN instead of AveQl for particles with no neighbors.
         std::shared_ptr< float > getAveQl()
             {
@@ -174,14 +197,14 @@ class LocalQl
         locality::LinkCell m_lc;          //!< LinkCell to bin particles for the computation
         unsigned int m_l;                 //!< Spherical harmonic l value.
         unsigned int m_Np;                //!< Last number of points computed
-        std::shared_ptr< std::complex<float> > m_Qlmi;        //!  Qlm for each particle i
+        std::shared_ptr< std::complex<float> > m_Qlmi;        //!  Qlm for each particle i, if compute kept them
         std::shared_ptr<float> m_Qli;         //!< Ql locally invariant order parameter for each particle i;
-        std::shared_ptr< std::complex<float> > m_AveQlmi;     //! AveQlm for each particle i
         std::shared_ptr< float > m_AveQli;     //!< AveQl locally invariant order parameter for each particle i;
         std::shared_ptr< std::complex<float> > m_Qlm;  //! NormQlm for the system
         std::shared_ptr< float > m_QliNorm;   //!< QlNorm order parameter for each particle i
         std::shared_ptr< std::complex<float> > m_AveQlm; //! AveNormQlm for the system
         std::shared_ptr< float > m_QliAveNorm;     //! < QlAveNorm order paramter for each particle i
+        BondHarmonics m_harmonics;                 //!< Qlm of the bonds of each particle, and the neighbors they came from
     };
 
 }; }; // end namespace freud::localql
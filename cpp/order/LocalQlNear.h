@@ -11,7 +11,7 @@
 
 #include "NearestNeighbors.h"
 #include "box.h"
-#include "../../extern/fsph/src/spherical_harmonics.hpp"
+#include "BondHarmonics.h"
 
 #ifndef _LOCAL_QL_NEAR_H__
 #define _LOCAL_QL_NEAR_H__
@@ -74,8 +74,13 @@ class LocalQlNear
         //! Compute the local rotationally invariant Ql order parameter
         // void compute(const float3 *points,
         //              unsigned int Np);
+        /*! If \a nlist is given, its bonds are used instead of building the internal neighbor list. The Qlm of each
+            particle, (2l + 1) Np values, are only kept if \a keep_Qlmi is true, which computeAve needs.
+        */
         void compute(const vec3<float> *points,
-                     unsigned int Np);
+                     unsigned int Np,
+                     const locality::NeighborList *nlist=NULL,
+                     bool keep_Qlmi=true);
 
         // //! Python wrapper for computing the order parameter from a Nx3 numpy array of float32.
         // void computePy(boost::python::numeric::array points);
@@ -176,14 +181,14 @@ class LocalQlNear
         locality::NearestNeighbors *m_nn;          //!< NearestNeighbors to bin particles for the computation
         unsigned int m_l;                 //!< Spherical harmonic l value.
         unsigned int m_Np;                //!< Last number of points computed
-        std::shared_ptr< std::complex<float> > m_Qlmi;        //!  Qlm for each particle i
+        std::shared_ptr< std::complex<float> > m_Qlmi;        //!  Qlm for each particle i, if compute kept them
         std::shared_ptr< float > m_Qli;         //!< Ql locally invariant order parameter for each particle i;
-        std::shared_ptr< std::complex<float> > m_AveQlmi;     //! AveQlm for each particle i
         std::shared_ptr< float > m_AveQli;     //!< AveQl locally invariant order parameter for each particle i;
         std::shared_ptr< std::complex<float> > m_Qlm;  //! NormQlm for the system
         std::shared_ptr< float > m_QliNorm;   //!< QlNorm order parameter for each particle i
         std::shared_ptr< std::complex<float> > m_AveQlm; //! AveNormQlm for the system
         std::shared_ptr< float > m_QliAveNorm;     //! < QlAveNorm order paramter for each particle i
+        BondHarmonics m_harmonics;                 //!< Qlm of the bonds of each particle, and the neighbors they came from
     };
 
 }; }; // end namespace freud::order
@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <tbb/tbb.h>
 #include <memory>
 //#include <boost/math/special_functions/spherical_harmonic.hpp>
 #include <complex>
@@ -11,8 +12,8 @@
 
 #include "LinkCell.h"
 #include "box.h"
+#include "BondHarmonics.h"
 #include "wigner3j.h"
-#include "../../extern/fsph/src/spherical_harmonics.hpp"
 
 #ifndef _LOCAL_WL_H__
 #define _LOCAL_WL_H__
@@ -67,8 +68,13 @@ class LocalWl
         //! Compute the local rotationally invariant Wl order parameter
         // void compute(const float3 *points,
         //              unsigned int Np);
+        /*! If \a nlist is given, its bonds are used instead of building the internal neighbor list. The Qlm of each
+            particle, (2l + 1) Np values, are only kept if \a keep_Qlmi is true, which computeAve needs.
+        */
         void compute(const vec3<float> *points,
-                     unsigned int Np);
+                     unsigned int Np,
+                     const locality::NeighborList *nlist=NULL,
+                     bool keep_Qlmi=true);
 
         //! Compute the Wl order parameter globally (averaging over the system Qlm)
         // void computeNorm(const float3 *points,
@@ -203,8 +209,7 @@ class LocalWl
         bool m_normalizeWl;               //!< Enable/disable normalize by |Qli|^(3/2). Defaults to false when Wl is constructed.
 
         std::shared_ptr< std::complex<float> > m_Qlm;         //!< Normalized Qlm for the whole system
-        std::shared_ptr< std::complex<float> > m_Qlmi;        //!< Qlm for each particle i
-        std::shared_ptr< std::complex<float> > m_AveQlmi;     //!< Averaged Qlm with 2nd neighbor shell for each particle i
+        std::shared_ptr< std::complex<float> > m_Qlmi;        //!< Qlm for each particle i, if compute kept them
         std::shared_ptr< std::complex<float> > m_AveQlm;      //!< Normalized AveQlmi for the whole system
         std::shared_ptr< std::complex<float> > m_Wli;         //!< Wl locally invariant order parameter for each particle i;
         std::shared_ptr< std::complex<float> > m_AveWli;      //!< Averaged Wl with 2nd neighbor shell for each particle i
@@ -212,6 +217,7 @@ class LocalWl
         std::shared_ptr< std::complex<float> > m_WliAveNorm;  //!< Normalized AveWl for the whole system
         std::shared_ptr< float > m_Qli; //!<  Need copy of Qli for normalization
         std::shared_ptr< float > m_wigner3jvalues;  //!<Wigner3j coefficients, in j1=-l to l, j2 = max(-l-j1,-l) to min(l-j1,l), maybe.
+        BondHarmonics m_harmonics;                 //!< Qlm of the bonds of each particle, and the neighbors they came from
     };
 
 }; }; // end namespace
@@ -2,7 +2,9 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include <cstdio>
+#include <tbb/tbb.h>
 #include "MatchEnv.h"
+#include "VectorMathBatch.h"
 
 namespace freud { namespace order {
 
@@ -15,9 +17,9 @@ EnvDisjointSet::EnvDisjointSet(unsigned int Np)
 
 // Merge the two sets that elements a and b belong to.
 // Taken partially from Cluster.cc
-// The vec_map must be a bimap of PROPERLY ORDERED vector indices where those of set a are on the left and those of set b are on the right.
+// The vec_map must be a mapping of PROPERLY ORDERED vector indices where those of set a are on the left and those of set b are on the right.
 // The rotation must take the set of PROPERLY ROTATED vectors b and rotate them to match the set of PROPERLY ROTATED vectors a
-void EnvDisjointSet::merge(const unsigned int a, const unsigned int b, boost::bimap<unsigned int, unsigned int> vec_map, rotmat3<float> rotation)
+void EnvDisjointSet::merge(const unsigned int a, const unsigned int b, const VecMap& vec_map, const rotmat3<float>& rotation)
     {
     assert(a < s.size() && b < s.size());
     assert(s[a].vecs.size() == s[b].vecs.size());
@@ -38,12 +40,11 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b, boost::bi
             std::vector<unsigned int> old_node_vec_ind = s[node].vec_ind;
 
             // Set the vector indices properly.
-            // Take the LEFT MAP view of the proper_a<->proper_b bimap.
+            // Take the LEFT MAP view of the proper_a<->proper_b mapping.
             // Iterate over the values of proper_a_ind IN ORDER, find the value of proper_b_ind that corresponds to each proper_a_ind, and set it properly.
             for (unsigned int proper_a_ind=0; proper_a_ind<vec_map.size(); proper_a_ind++)
                 {
-                boost::bimap<unsigned int, unsigned int>::left_const_iterator it = vec_map.left.find(proper_a_ind);
-                unsigned int proper_b_ind = it->second;
+                unsigned int proper_b_ind = vec_map.getRight(proper_a_ind);
 
                 // old_node_vec_ind[proper_b_ind] is "relative_b_ind"
                 s[node].vec_ind[proper_a_ind] = old_node_vec_ind[proper_b_ind];
@@ -77,12 +78,11 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b, boost::bi
                 std::vector<unsigned int> old_node_vec_ind = s[node].vec_ind;
 
                 // Set the vector indices properly.
-                // Take the LEFT MAP view of the proper_a<->proper_b bimap.
+                // Take the LEFT MAP view of the proper_a<->proper_b mapping.
                 // Iterate over the values of proper_a_ind IN ORDER, find the value of proper_b_ind that corresponds to each proper_a_ind, and set it properly.
                 for (unsigned int proper_a_ind=0; proper_a_ind<vec_map.size(); proper_a_ind++)
                     {
-                    boost::bimap<unsigned int, unsigned int>::left_const_iterator it = vec_map.left.find(proper_a_ind);
-                    unsigned int proper_b_ind = it->second;
+                    unsigned int proper_b_ind = vec_map.getRight(proper_a_ind);
 
                     // old_node_vec_ind[proper_b_ind] is "relative_b_ind"
                     s[node].vec_ind[proper_a_ind] = old_node_vec_ind[proper_b_ind];
@@ -112,12 +112,11 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b, boost::bi
                 std::vector<unsigned int> old_node_vec_ind = s[node].vec_ind;
 
                 // Set the vector indices properly.
-                // Take the RIGHT MAP view of the proper_a<->proper_b bimap.
+                // Take the RIGHT MAP view of the proper_a<->proper_b mapping.
                 // Iterate over the values of proper_b_ind IN ORDER, find the value of proper_a_ind that corresponds to each proper_b_ind, and set it properly.
                 for (unsigned int proper_b_ind=0; proper_b_ind<vec_map.size(); proper_b_ind++)
                     {
-                    boost::bimap<unsigned int, unsigned int>::right_const_iterator it = vec_map.right.find(proper_b_ind);
-                    unsigned int proper_a_ind = it->second;
+                    unsigned int proper_a_ind = vec_map.getLeft(proper_b_ind);
 
                     // old_node_vec_ind[proper_a_ind] is "relative_a_ind"
                     s[node].vec_ind[proper_b_ind] = old_node_vec_ind[proper_a_ind];
@@ -168,6 +167,13 @@ std::vector<unsigned int> EnvDisjointSet::findSet(const unsigned int m)
 
     std::vector<unsigned int> m_set;
 
+    // every merge into a head raises its rank, so a head of rank zero is alone in its set
+    if (m < s.size() && s[m].env_ind == m && rank[m] == 0)
+        {
+        m_set.push_back(m);
+        return m_set;
+        }
+
     // this is wildly inefficient
     for (unsigned int i = 0; i < s.size(); i++)
         {
@@ -195,60 +201,103 @@ std::vector<unsigned int> EnvDisjointSet::findSet(const unsigned int m)
 std::shared_ptr<vec3<float> > EnvDisjointSet::getAvgEnv(const unsigned int m)
     {
     assert(s.size() > 0);
-    bool invalid_ind = true;
 
-    std::shared_ptr<vec3<float> > env(new vec3<float> [m_max_num_neigh], std::default_delete<vec3<float>[]>());
-    for (unsigned int n = 0; n < m_max_num_neigh; n++)
-        {
-        env.get()[n] = vec3<float>(0.0,0.0,0.0);
-        }
-    float N = float(0);
-
-    // loop over all the environments in the set
+    // gather the physical environments of the set m
+    std::vector<unsigned int> members;
     for (unsigned int i = 0; i < s.size(); i++)
         {
-        // if this environment is NOT a ghost (i.e. non-physical):
-        if (s[i].ghost == false)
-            {
-            // get the head environment index
-            unsigned int head_env = find(s[i].env_ind);
-            // if we are part of the environment m, add the vectors to env
-            if (head_env == m)
-                {
-                assert(s[i].vec_ind.size() <= m_max_num_neigh);
-                assert(s[i].vecs.size() <= m_max_num_neigh);
-                assert(s[i].num_vecs == s[m].num_vecs);
-                // loop through the vectors, getting them properly indexed
-                // add them to env
-                for (unsigned int proper_ind = 0; proper_ind < s[i].vecs.size(); proper_ind++)
-                    {
-                    unsigned int relative_ind = s[i].vec_ind[proper_ind];
-                    env.get()[proper_ind] += s[i].proper_rot*s[i].vecs[relative_ind];
-                    }
-                N += float(1);
-                invalid_ind = false;
-                }
-            }
+        if (s[i].ghost == false && find(s[i].env_ind) == m)
+            members.push_back(i);
         }
 
-    if (invalid_ind)
+    if (members.size() == 0)
         {
         fprintf(stderr, "m is %d\n", m);
         throw std::invalid_argument("m must be a head index in the environment set!");
         }
 
-    else
+    return getAvgEnv(&members[0], members.size());
+    }
+
+// Get the vectors averaged over the n environments members, which must all belong to the same set.
+// Only reads the set, so that the sets can be averaged in parallel.
+std::shared_ptr<vec3<float> > EnvDisjointSet::getAvgEnv(const unsigned int *members, unsigned int n) const
+    {
+    assert(n > 0);
+    std::shared_ptr<vec3<float> > env(new vec3<float> [m_max_num_neigh], std::default_delete<vec3<float>[]>());
+    for (unsigned int k = 0; k < m_max_num_neigh; k++)
+        {
+        env.get()[k] = vec3<float>(0.0,0.0,0.0);
+        }
+
+    for (unsigned int member = 0; member < n; member++)
         {
-        // loop through the vectors in env now, dividing by the total number of contributing particle environments to make an average
-        for (unsigned int n = 0; n < m_max_num_neigh; n++)
+        const Environment& e = s[members[member]];
+        assert(e.vec_ind.size() <= m_max_num_neigh);
+        assert(e.vecs.size() <= m_max_num_neigh);
+        assert(e.num_vecs == s[members[0]].num_vecs);
+        // loop through the vectors, getting them properly indexed
+        // add them to env
+        for (unsigned int proper_ind = 0; proper_ind < e.vecs.size(); proper_ind++)
             {
-            vec3<float> normed = env.get()[n]/N;
-            env.get()[n] = normed;
+            unsigned int relative_ind = e.vec_ind[proper_ind];
+            env.get()[proper_ind] += e.proper_rot*e.vecs[relative_ind];
             }
         }
+
+    // loop through the vectors in env now, dividing by the total number of contributing particle environments to make an average
+    float N = float(n);
+    for (unsigned int k = 0; k < m_max_num_neigh; k++)
+        {
+        vec3<float> normed = env.get()[k]/N;
+        env.get()[k] = normed;
+        }
     return env;
     }
 
+// Group the physical environments by their set, in one pass instead of a scan of the whole set per set.
+// The (head, node) pairs are sorted, each run of a head being one set with its nodes in increasing order, and the
+// runs are then put in the order of their first node, which is the order the sets are first met in a scan.
+void EnvDisjointSet::groupSets(std::vector<unsigned int>& members, std::vector<unsigned int>& set_begin,
+                               std::vector<unsigned int>& set_end)
+    {
+    // flatten the trees once, so that the heads can be read in parallel
+    for (unsigned int i = 0; i < s.size(); i++)
+        find(i);
+
+    std::vector<uint64_t> keys;
+    keys.reserve(s.size());
+    for (unsigned int i = 0; i < s.size(); i++)
+        {
+        if (s[i].ghost == false)
+            keys.push_back((uint64_t(s[i].env_ind) << 32) | i);
+        }
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    members.resize(keys.size());
+    std::vector<std::pair<unsigned int, unsigned int> > runs;
+    for (unsigned int k = 0; k < keys.size(); k++)
+        {
+        members[k] = (unsigned int)(keys[k] & 0xffffffff);
+        if (k == 0 || (keys[k] >> 32) != (keys[k-1] >> 32))
+            runs.push_back(std::make_pair(members[k], k));
+        }
+    // order the sets by their first member
+    std::sort(runs.begin(), runs.end());
+
+    set_begin.resize(runs.size());
+    set_end.resize(runs.size());
+    for (unsigned int c = 0; c < runs.size(); c++)
+        {
+        unsigned int begin = runs[c].second;
+        unsigned int end = begin + 1;
+        while (end < keys.size() && (keys[end] >> 32) == (keys[begin] >> 32))
+            end++;
+        set_begin[c] = begin;
+        set_end[c] = end;
+        }
+    }
+
 // Get the vectors corresponding to index m in the dj set
 // If index m doesn't exist in the set, throw an error.
 std::vector<vec3<float> > EnvDisjointSet::getIndividualEnv(const unsigned int m)
@@ -284,6 +333,7 @@ MatchEnv::MatchEnv(const box::Box& box, float rmax, unsigned int k)
     m_Np = 0;
     m_num_clusters = 0;
     m_maxk = 0;
+    m_accelerated_registration = true;
     if (m_rmax < 0.0f)
         throw std::invalid_argument("rmax must be positive!");
     m_rmaxsq = m_rmax * m_rmax;
@@ -328,7 +378,7 @@ Environment MatchEnv::buildEnv(const vec3<float> *points, unsigned int i, unsign
         {
         // loop over everyone who could possibly be within m_rmax of particle i
         unsigned int cell = m_lc->getCell(p);
-        const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(cell);
+        const locality::CellNeighbors& neigh_cells = m_lc->getCellNeighbors(cell);
         // loop over neighboring cells
         for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
             {
@@ -353,21 +403,43 @@ Environment MatchEnv::buildEnv(const vec3<float> *points, unsigned int i, unsign
     return ei;
     }
 
+// Build and return the ghost environment of the motif characterized by refPoints. Label its environment with env_ind.
+Environment MatchEnv::buildMotifEnv(const vec3<float> *refPoints, unsigned int numRef, unsigned int env_ind)
+    {
+    // set the IGNORE flag to true, since this is not an environment we have actually encountered in the simulation.
+    Environment e0 = Environment();
+    e0.env_ind = env_ind;
+    e0.ghost = true;
+
+    // loop through all the vectors in refPoints and add them to the environment.
+    // wrap all the vectors back into the box. I think this is necessary since all the vectors
+    // that will be added to actual particle environments will be wrapped into the box as well.
+    for (unsigned int i = 0; i < numRef; i++)
+        {
+        vec3<float> p = m_box.wrap(refPoints[i]);
+        e0.addVec(p);
+        }
+
+    return e0;
+    }
+
 // Is the (PROPERLY REGISTERED) environment e2 similar to the (PROPERLY REGISTERED) environment e1?
 // If so, return a std::pair of the rotation matrix that takes the vectors of e2 to the vectors of e1 AND the mapping between the properly indexed vectors of the environments that will make them correspond to each other.
 // If not, return a std::pair of the identity matrix AND an empty map.
 // The threshold is a unitless number, which we multiply by the length scale of the MatchEnv instance, rmax.
 // This quantity is the maximum squared magnitude of the vector difference between two vectors, below which you call them matching.
 // The bool registration controls whether we first use brute force registration to orient the second set of vectors such that it minimizes the RMSD between the two sets
-std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > MatchEnv::isSimilar(Environment& e1, Environment& e2, float threshold_sq, bool registration)
+// If given, reg1 is a RegisterBruteForce of the properly registered vectors of e1, used instead of building a new one for the comparison.
+std::pair<rotmat3<float>, VecMap> MatchEnv::isSimilar(Environment& e1, Environment& e2, float threshold_sq, bool registration, registration::RegisterBruteForce *reg1)
     {
-    boost::bimap<unsigned int, unsigned int> vec_map;
-    rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
+    std::pair<rotmat3<float>, VecMap> mapping(rotmat3<float>(), VecMap(e1.vecs.size())); // the rotation initializes to the identity matrix
+    rotmat3<float>& rotation = mapping.first;
+    VecMap& vec_map = mapping.second;
 
     // If the vector sets do not have equal numbers of vectors, just return an empty map since the 1-1 bimapping will be too weird in this case.
     if (e1.vecs.size() != e2.vecs.size())
         {
-        return std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> >(rotation, vec_map);
+        return mapping;
         }
 
     std::vector< vec3<float> > v1(e1.vecs.size());
@@ -384,14 +456,23 @@ std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > MatchEnv::i
     // the Fit operation CHANGES v2.
     if (registration == true)
         {
-        registration::RegisterBruteForce r = registration::RegisterBruteForce(v1);
+        std::unique_ptr<registration::RegisterBruteForce> own_reg;
+        if (reg1 == NULL)
+            {
+            own_reg.reset(new registration::RegisterBruteForce(v1));
+            reg1 = own_reg.get();
+            }
+        registration::RegisterBruteForce& r = *reg1;
+        // no rotation brings vectors whose lengths differ by more than the threshold to match
+        r.setAccelerated(m_accelerated_registration);
+        r.setPruneTol(sqrt(threshold_sq*m_rmaxsq));
         bool good_fit = r.Fit(v2);
         // get the optimal rotation to take v2 to v1
         std::vector<vec3<float> > rot = r.getRotation();
         // this must be a 3x3 matrix. if it isn't, something has gone wrong.
         assert(rot.size() == 3);
         rotation = rotmat3<float>(rot[0], rot[1], rot[2]);
-        boost::bimap<unsigned int, unsigned int> tmp_vec_map = r.getVecMap();
+        const boost::bimap<unsigned int, unsigned int>& tmp_vec_map = r.getVecMap();
 
         for (boost::bimap<unsigned int, unsigned int>::const_iterator it = tmp_vec_map.begin(); it != tmp_vec_map.end(); ++it)
             {
@@ -401,43 +482,49 @@ std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > MatchEnv::i
             float rsq = dot(delta, delta);
             if (rsq < threshold_sq*m_rmaxsq)
                 {
-                vec_map.insert(boost::bimap<unsigned int, unsigned int>::value_type(it->left, it->right));
+                vec_map.insert(it->left, it->right);
                 }
             }
         }
 
-    // if we didn't have to register, compare all combinations of vectors
+    // if we didn't have to register, pair each vector of v1 in order with the first vector of v2 that matches it and
+    // is not paired yet, as inserting all the matching combinations into the map did. A vector of v1 left without a
+    // pair means the environments are not similar, so most comparisons stop early. The distances to the vectors of
+    // v2 are computed BATCH_WIDTH at a time, v2 being padded to a multiple of BATCH_WIDTH.
     else
         {
-        for (unsigned int i = 0; i < e1.vecs.size(); i++)
+        const unsigned int n = e1.vecs.size();
+        const float_batch max_rsq(threshold_sq*m_rmaxsq);
+        v2.resize((n + BATCH_WIDTH - 1)/BATCH_WIDTH*BATCH_WIDTH, vec3<float>(0.0f, 0.0f, 0.0f));
+        for (unsigned int i = 0; i < n; i++)
             {
-            for (unsigned int j = 0; j < e2.vecs.size(); j++)
+            vec3_batch a = broadcast_batch(v1[i]);
+            bool paired = false;
+            for (unsigned int j = 0; j < n && !paired; j += BATCH_WIDTH)
                 {
-                vec3<float> delta = v1[i] - v2[j];
-                float rsq = dot(delta, delta);
-                if (rsq < threshold_sq*m_rmaxsq)
+                vec3_batch delta = a - load_vec3_batch(&v2[j]);
+                int matching = less_mask(dot(delta, delta), max_rsq);
+                for (unsigned int l = 0; l < BATCH_WIDTH && j + l < n && !paired; l++)
                     {
                     // these vectors are deemed "matching"
-                    // since this is a bimap, this (i,j) pair is only inserted if j has not already been assigned an i pairing.
-                    // (ditto with i not being assigned a j pairing)
-                    vec_map.insert(boost::bimap<unsigned int, unsigned int>::value_type(i, j));
+                    if (matching & (1 << l))
+                        paired = vec_map.insert(i, j + l);
                     }
                 }
+            if (!paired)
+                {
+                vec_map.clear();
+                return mapping;
+                }
             }
         }
 
-
-    // if every vector has been paired with every other vector, return this bimap
-    if (vec_map.size() == e1.vecs.size())
-        {
-        return std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> >(rotation, vec_map);
-        }
-    // otherwise, return an empty bimap
-    else
+    // if every vector has not been paired with every other vector, return an empty map
+    if (vec_map.size() != e1.vecs.size())
         {
-        boost::bimap<unsigned int, unsigned int> empty_map;
-        return std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> >(rotation, empty_map);
+        vec_map.clear();
         }
+    return mapping;
     }
 
 // Overload: is the set of vectors refPoints2 similar to the set of vectors refPoints1?
@@ -474,17 +561,16 @@ std::map<unsigned int, unsigned int> MatchEnv::isSimilar(const vec3<float> *refP
         }
 
     // call isSimilar for e0 and e1
-    std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > mapping = isSimilar(e0, e1, threshold_sq, registration);
-    rotmat3<float> rotation = mapping.first;
-    boost::bimap<unsigned int, unsigned int> vec_map = mapping.second;
+    std::pair<rotmat3<float>, VecMap> mapping = isSimilar(e0, e1, threshold_sq, registration);
+    const rotmat3<float>& rotation = mapping.first;
+    const VecMap& vec_map = mapping.second;
 
     // convert to a std::map
-    // the lamest.
-    // from stackoverflow.com/questions/20667187/convert-boostbimap-to-stdmap
     std::map<unsigned int, unsigned int> std_vec_map;
-    for (boost::bimap<unsigned int, unsigned int>::const_iterator it = vec_map.begin(); it != vec_map.end(); ++it)
+    for (unsigned int left = 0; left < vec_map.getNumVecs(); left++)
         {
-        std_vec_map[it->left] = it->right;
+        if (vec_map.getRight(left) != VecMap::unmapped)
+            std_vec_map[left] = vec_map.getRight(left);
         }
 
     // update refPoints2 in case registration has taken place
@@ -504,17 +590,19 @@ std::map<unsigned int, unsigned int> MatchEnv::isSimilar(const vec3<float> *refP
 // NOTE that this does not guarantee an absolutely minimal RMSD. It doesn't figure out the optimal permutation
 // of BOTH sets of vectors to minimize the RMSD. Rather, it just figures out the optimal permutation of the second set, the vector set used in the argument below.
 // To fully solve this, we need to use the Hungarian algorithm or some other way of solving the so-called assignment problem.
-std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > MatchEnv::minimizeRMSD(Environment& e1, Environment& e2, float& min_rmsd, bool registration)
+// If given, reg1 is a RegisterBruteForce of the properly registered vectors of e1, used instead of building a new one for the comparison.
+std::pair<rotmat3<float>, VecMap> MatchEnv::minimizeRMSD(Environment& e1, Environment& e2, float& min_rmsd, bool registration, registration::RegisterBruteForce *reg1)
     {
+    std::pair<rotmat3<float>, VecMap> mapping(rotmat3<float>(), VecMap(e1.vecs.size())); // the rotation initializes to the identity matrix
+    rotmat3<float>& rotation = mapping.first;
     boost::bimap<unsigned int, unsigned int> vec_map;
-    rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
 
     // If the vector sets do not have equal numbers of vectors, force the map to be empty since it can never be 1-1.
     // Return the empty vec_map and the identity matrix, and minRMSD = -1.
     if (e1.vecs.size() != e2.vecs.size())
         {
         min_rmsd = -1.0;
-        return std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> >(rotation, vec_map);
+        return mapping;
         }
 
     std::vector< vec3<float> > v1(e1.vecs.size());
@@ -528,11 +616,19 @@ std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > MatchEnv::m
         }
 
     // call RegisterBruteForce::Fit and update min_rmsd accordingly
-    registration::RegisterBruteForce r = registration::RegisterBruteForce(v1);
+    std::unique_ptr<registration::RegisterBruteForce> own_reg;
+    if (reg1 == NULL)
+        {
+        own_reg.reset(new registration::RegisterBruteForce(v1));
+        reg1 = own_reg.get();
+        }
+    registration::RegisterBruteForce& r = *reg1;
     // if we have to register, first find the rotated set of v2 that best maps to v1
     // the Fit operation CHANGES v2.
     if (registration == true)
         {
+        r.setAccelerated(m_accelerated_registration);
+        r.setPruneTol(-1.0);
         bool good_fit = r.Fit(v2);
         // get the optimal rotation to take v2 to v1
         std::vector<vec3<float> > rot = r.getRotation();
@@ -548,8 +644,12 @@ std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > MatchEnv::m
         min_rmsd = r.AlignedRMSDTree(registration::makeEigenMatrix(v2), vec_map);
         }
 
-    // return the rotation matrix and bimap
-    return std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> >(rotation, vec_map);
+    // copy the bimap of the registration to the flat mapping, and return it with the rotation matrix
+    for (boost::bimap<unsigned int, unsigned int>::const_iterator it = vec_map.begin(); it != vec_map.end(); ++it)
+        {
+        mapping.second.insert(it->left, it->right);
+        }
+    return mapping;
     }
 
 // Overload: Get the somewhat-optimal RMSD between the set of vectors refPoints1 and the set of vectors refPoints2.
@@ -591,17 +691,17 @@ std::map<unsigned int, unsigned int> MatchEnv::minimizeRMSD(const vec3<float> *r
 
     // call minimizeRMSD for e0 and e1
     float tmp_min_rmsd = -1.0;
-    std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > mapping = minimizeRMSD(e0, e1, tmp_min_rmsd, registration);
-    rotmat3<float> rotation = mapping.first;
-    boost::bimap<unsigned int, unsigned int> vec_map = mapping.second;
+    std::pair<rotmat3<float>, VecMap> mapping = minimizeRMSD(e0, e1, tmp_min_rmsd, registration);
+    const rotmat3<float>& rotation = mapping.first;
+    const VecMap& vec_map = mapping.second;
     min_rmsd = tmp_min_rmsd;
 
-    // lamely convert to a std::map
-    // from stackoverflow.com/questions/20667187/convert-boostbimap-to-stdmap
+    // convert to a std::map
     std::map<unsigned int, unsigned int> std_vec_map;
-    for (boost::bimap<unsigned int, unsigned int>::const_iterator it = vec_map.begin(); it != vec_map.end(); ++it)
+    for (unsigned int left = 0; left < vec_map.getNumVecs(); left++)
         {
-        std_vec_map[it->left] = it->right;
+        if (vec_map.getRight(left) != VecMap::unmapped)
+            std_vec_map[left] = vec_map.getRight(left);
         }
 
     // update refPoints2 in case registration has taken place
@@ -616,6 +716,42 @@ std::map<unsigned int, unsigned int> MatchEnv::minimizeRMSD(const vec3<float> *r
 
 // Determine clusters of particles with matching environments
 // This is taken from Cluster.cc and SolLiq.cc and LocalQlNear.cc
+//! \internal
+//! Fill the rotation invariant fingerprint of an environment: the lengths of its vectors, sorted
+static void computeFingerprint(const Environment& e, float *fingerprint)
+    {
+    for (unsigned int m = 0; m < e.num_vecs; m++)
+        fingerprint[m] = sqrt(dot(e.vecs[m], e.vecs[m]));
+    std::sort(fingerprint, fingerprint + e.num_vecs);
+    }
+
+//! \internal
+//! Can two environments with these fingerprints be similar?
+/*! isSimilar pairs every vector of one environment with a vector of the other closer than the threshold, and
+    rotations keep the lengths of the vectors, so the lengths of paired vectors differ by less than the threshold.
+    Pairing sorted lengths in order minimizes the largest of these differences, so two environments can only be
+    similar if their sorted lengths differ by less than the threshold in order.
+*/
+static bool fingerprintsMatch(const float *f1, unsigned int n1, const float *f2, unsigned int n2, float max_delta)
+    {
+    if (n1 != n2)
+        return false;
+    for (unsigned int m = 0; m < n1; m++)
+        {
+        if (fabs(f1[m] - f2[m]) > max_delta)
+            return false;
+        }
+    return true;
+    }
+
+//! Number of particles whose pairs are screened at once in the global mode of cluster()
+static const unsigned int global_block_size = 256;
+
+// Determine clusters of particles with matching environments.
+// The pairs of environments are first screened in parallel by their fingerprints, which rules out most of the
+// pairs that are not similar without registering or pairing their vectors. The remaining pairs are then compared
+// and merged in the same order as they always were, skipping the pairs already in the same cluster, so the
+// clusters do not depend on the number of threads.
 void MatchEnv::cluster(const vec3<float> *points, unsigned int Np, float threshold, bool hard_r, bool registration, bool global)
     {
     assert(points);
@@ -651,54 +787,103 @@ void MatchEnv::cluster(const vec3<float> *points, unsigned int Np, float thresho
     unsigned int array_size = Np*m_maxk;
     m_tot_env = std::shared_ptr<vec3<float> >(new vec3<float>[array_size], std::default_delete<vec3<float>[]>());
 
-    // loop through points
-    for (unsigned int i = 0; i < m_Np; i++)
+    // the fingerprint of every environment. The matching criterion is widened by a small fraction of rmax so that
+    // rounding never rules out a pair isSimilar would accept.
+    const unsigned int maxk = m_maxk;
+    std::vector<float> fingerprints(std::max(array_size, 1u));
+    std::vector<unsigned int> num_vecs(m_Np);
+    const Environment *envs = &dj.s[0];
+    float *l_fingerprints = &fingerprints[0];
+    unsigned int *l_num_vecs = &num_vecs[0];
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_Np),
+        [=] (const tbb::blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            computeFingerprint(envs[i], l_fingerprints + i*maxk);
+            l_num_vecs[i] = envs[i].num_vecs;
+            }
+        });
+    const float max_delta = threshold*m_rmax + 1e-3f*m_rmax;
+
+    // compare the environments of i and j, and merge them if they are similar
+    auto compare = [&] (unsigned int i, unsigned int j)
         {
-        vec3<float> p = points[i];
+        // the environments of particles already in the same cluster need no comparison
+        if (dj.find(i) == dj.find(j))
+            return;
+        std::pair<rotmat3<float>, VecMap> mapping = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
+        const rotmat3<float>& rotation = mapping.first;
+        const VecMap& vec_map = mapping.second;
+        // if the mapping between the vectors of the environments is NOT empty, then the environments
+        // are similar. so merge them.
+        if (!vec_map.empty())
+            dj.merge(i,j,vec_map,rotation);
+        };
 
-        if (global == false)
+    if (global == false)
+        {
+        // screen the pairs of every particle with its neighbors
+        const unsigned int k = m_k;
+        std::vector<unsigned char> candidate(m_Np*k, 0);
+        unsigned char *l_candidate = &candidate[0];
+        locality::NearestNeighbors *nn = m_nn;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_Np),
+            [=] (const tbb::blocked_range<size_t>& r)
             {
-            // loop over the neighbors
-            std::shared_ptr<unsigned int> neighbors = m_nn->getNeighbors(i);
-            for (unsigned int neigh_idx = 0; neigh_idx < m_k; neigh_idx++)
+            for (size_t i = r.begin(); i != r.end(); i++)
                 {
-                unsigned int j = neighbors.get()[neigh_idx];
-                if (i != j)
+                std::shared_ptr<unsigned int> neighbors = nn->getNeighbors(i);
+                for (unsigned int neigh_idx = 0; neigh_idx < k; neigh_idx++)
                     {
-                    std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > mapping = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
-                    rotmat3<float> rotation = mapping.first;
-                    boost::bimap<unsigned int, unsigned int> vec_map = mapping.second;
-                    // if the mapping between the vectors of the environments is NOT empty, then the environments
-                    // are similar. so merge them.
-                    if (!vec_map.empty())
-                        {
-                        // merge the two sets using the disjoint set
-                        unsigned int a = dj.find(i);
-                        unsigned int b = dj.find(j);
-                        if (a != b)
-                            dj.merge(i,j,vec_map,rotation);
-                        }
+                    unsigned int j = neighbors.get()[neigh_idx];
+                    l_candidate[i*k + neigh_idx] = (i != j) &&
+                        fingerprintsMatch(l_fingerprints + i*maxk, l_num_vecs[i], l_fingerprints + j*maxk, l_num_vecs[j], max_delta);
                     }
                 }
+            });
+
+        // loop through points
+        for (unsigned int i = 0; i < m_Np; i++)
+            {
+            // loop over the neighbors
+            std::shared_ptr<unsigned int> neighbors = m_nn->getNeighbors(i);
+            for (unsigned int neigh_idx = 0; neigh_idx < k; neigh_idx++)
+                {
+                if (candidate[i*k + neigh_idx])
+                    compare(i, neighbors.get()[neigh_idx]);
+                }
             }
-        else
+        }
+    else
+        {
+        // screen all the pairs of a block of particles in parallel, then compare the candidates in order
+        std::vector< std::vector<unsigned int> > candidates(global_block_size);
+        for (unsigned int block = 0; block < m_Np; block += global_block_size)
             {
-            // loop over all other particles
-            for (unsigned int j = i+1; j < m_Np; j++)
+            unsigned int block_end = std::min(block + global_block_size, m_Np);
+            std::vector<unsigned int> *l_candidates = &candidates[0];
+            const unsigned int Np_local = m_Np;
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(block, block_end, 1),
+                [=] (const tbb::blocked_range<unsigned int>& r)
                 {
-                std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > mapping = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
-                rotmat3<float> rotation = mapping.first;
-                boost::bimap<unsigned int, unsigned int> vec_map = mapping.second;
-                // if the mapping between the vectors of the environments is NOT empty, then the environments
-                // are similar. so merge them.
-                if (!vec_map.empty())
+                for (unsigned int i = r.begin(); i != r.end(); i++)
                     {
-                    // merge the two sets using the disjoint set
-                    unsigned int a = dj.find(i);
-                    unsigned int b = dj.find(j);
-                    if (a != b)
-                        dj.merge(i,j,vec_map,rotation);
+                    std::vector<unsigned int>& candidates_i = l_candidates[i - block];
+                    candidates_i.clear();
+                    for (unsigned int j = i+1; j < Np_local; j++)
+                        {
+                        if (fingerprintsMatch(l_fingerprints + i*maxk, l_num_vecs[i], l_fingerprints + j*maxk, l_num_vecs[j], max_delta))
+                            candidates_i.push_back(j);
+                        }
                     }
+                });
+
+            for (unsigned int i = block; i < block_end; i++)
+                {
+                const std::vector<unsigned int>& candidates_i = candidates[i - block];
+                for (unsigned int n = 0; n < candidates_i.size(); n++)
+                    compare(i, candidates_i[n]);
                 }
             }
         }
@@ -708,6 +893,10 @@ void MatchEnv::cluster(const vec3<float> *points, unsigned int Np, float thresho
     }
 
 //! Determine whether particles match a given input motif, characterized by refPoints (of which there are numRef)
+//! The environments of the particles are built and compared with the motif in parallel, each thread registering them
+//! with its own copy of the registration of the motif. Every environment that matches is merged into the motif, whose
+//! own vectors never change, so the merges are done afterwards in the order of the particles and the result does not
+//! depend on the number of threads.
 void MatchEnv::matchMotif(const vec3<float> *points, unsigned int Np, const vec3<float> *refPoints, unsigned int numRef, float threshold, bool registration)
     {
     assert(points);
@@ -737,41 +926,50 @@ void MatchEnv::matchMotif(const vec3<float> *points, unsigned int Np, const vec3
     unsigned int array_size = Np*m_maxk;
     m_tot_env = std::shared_ptr<vec3<float> >(new vec3<float>[array_size], std::default_delete<vec3<float>[]>());
 
-    // create the environment characterized by refPoints. Index it as 0.
-    // set the IGNORE flag to true, since this is not an environment we have actually encountered in the simulation.
-    Environment e0 = Environment();
-    e0.env_ind = 0;
-    e0.ghost = true;
-
-    // loop through all the vectors in refPoints and add them to the environment.
-    // wrap all the vectors back into the box. I think this is necessary since all the vectors
-    // that will be added to actual particle environments will be wrapped into the box as well.
-    for (unsigned int i = 0; i < numRef; i++)
+    // create the environment characterized by refPoints. Index it as 0, and add it to the set.
+    // the particle environments follow it: take care, here: set things up s.t. the env_ind of every environment
+    // matches its location in the disjoint set. if you don't do this, things will get screwy.
+    dj.s.resize(m_Np+1);
+    dj.s[0] = buildMotifEnv(refPoints, numRef, 0);
+    Environment *envs = &dj.s[0];
+
+    // the fingerprint and the registration of the motif are only built once
+    std::vector<float> motif_fingerprint(std::max(envs[0].num_vecs, 1u));
+    computeFingerprint(envs[0], &motif_fingerprint[0]);
+    const float *l_motif_fingerprint = &motif_fingerprint[0];
+    const float max_delta = threshold*m_rmax + 1e-3f*m_rmax;
+    tbb::enumerable_thread_specific<registration::RegisterBruteForce> local_reg(registration::RegisterBruteForce(envs[0].vecs));
+
+    // build the environment of every particle and compare it with the motif
+    std::vector< std::pair<rotmat3<float>, VecMap> > mappings(m_Np);
+    std::pair<rotmat3<float>, VecMap> *l_mappings = &mappings[0];
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_Np),
+        [=, &local_reg] (const tbb::blocked_range<size_t>& r)
         {
-        vec3<float> p = m_box.wrap(refPoints[i]);
-        e0.addVec(p);
-        }
-
-    // add this environment to the set
-    dj.s.push_back(e0);
+        registration::RegisterBruteForce& reg = local_reg.local();
+        std::vector<float>& fingerprint = m_local_fingerprint.local();
+        fingerprint.resize(std::max(envs[0].num_vecs, 1u));
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            envs[i+1] = buildEnv(points, i, i+1, false);
+            // the environments that cannot match leave their mapping empty
+            if (envs[i+1].num_vecs != envs[0].num_vecs)
+                continue;
+            computeFingerprint(envs[i+1], &fingerprint[0]);
+            if (fingerprintsMatch(l_motif_fingerprint, envs[0].num_vecs, &fingerprint[0], envs[i+1].num_vecs, max_delta))
+                l_mappings[i] = isSimilar(envs[0], envs[i+1], m_threshold_sq, registration, &reg);
+            }
+        });
 
-    // loop through the particles and add their environments to the set
-    // take care, here: set things up s.t. the env_ind of every environment matches its location in the disjoint set.
-    // if you don't do this, things will get screwy.
+    // if the environment matches e0, merge it into the e0 environment set
     for (unsigned int i = 0; i < m_Np; i++)
         {
-        unsigned int dummy = i+1;
-        Environment ei = buildEnv(points, i, dummy, false);
-        dj.s.push_back(ei);
-
-        // if the environment matches e0, merge it into the e0 environment set
-        std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > mapping = isSimilar(dj.s[0], dj.s[dummy], m_threshold_sq, registration);
-        rotmat3<float> rotation = mapping.first;
-        boost::bimap<unsigned int, unsigned int> vec_map = mapping.second;
+        const rotmat3<float>& rotation = mappings[i].first;
+        const VecMap& vec_map = mappings[i].second;
         // if the mapping between the vectors of the environments is NOT empty, then the environments are similar.
         if (!vec_map.empty())
             {
-            dj.merge(0, dummy, vec_map, rotation);
+            dj.merge(0, i+1, vec_map, rotation);
             }
         }
 
@@ -786,6 +984,7 @@ void MatchEnv::matchMotif(const vec3<float> *points, unsigned int Np, const vec3
 //! NOTE that this does not guarantee an absolutely minimal RMSD. It doesn't figure out the optimal permutation
 //! of BOTH sets of vectors to minimize the RMSD. Rather, it just figures out the optimal permutation of the second set, the vector set used in the argument below.
 //! To fully solve this, we need to use the Hungarian algorithm or some other way of solving the so-called assignment problem.
+//! As in matchMotif, the environments are built and registered in parallel and merged into the motif in order.
 std::vector<float> MatchEnv::minRMSDMotif(const vec3<float> *points, unsigned int Np, const vec3<float> *refPoints, unsigned int numRef, bool registration)
     {
     assert(points);
@@ -814,46 +1013,42 @@ std::vector<float> MatchEnv::minRMSDMotif(const vec3<float> *points, unsigned in
     unsigned int array_size = Np*m_maxk;
     m_tot_env = std::shared_ptr<vec3<float> >(new vec3<float>[array_size], std::default_delete<vec3<float>[]>());
 
-    // create the environment characterized by refPoints. Index it as 0.
-    // set the IGNORE flag to true, since this is not an environment we have actually encountered in the simulation.
-    Environment e0 = Environment();
-    e0.env_ind = 0;
-    e0.ghost = true;
-
-    // loop through all the vectors in refPoints and add them to the environment.
-    // wrap all the vectors back into the box. I think this is necessary since all the vectors
-    // that will be added to actual particle environments will be wrapped into the box as well.
-    for (unsigned int i = 0; i < numRef; i++)
+    // create the environment characterized by refPoints. Index it as 0, and add it to the set, followed by the
+    // environments of the particles.
+    dj.s.resize(m_Np+1);
+    dj.s[0] = buildMotifEnv(refPoints, numRef, 0);
+    Environment *envs = &dj.s[0];
+
+    // the registration of the motif is only built once
+    tbb::enumerable_thread_specific<registration::RegisterBruteForce> local_reg(registration::RegisterBruteForce(envs[0].vecs));
+
+    // build the environment of every particle and minimize its RMSD wrt the motif
+    std::vector< std::pair<rotmat3<float>, VecMap> > mappings(m_Np);
+    std::pair<rotmat3<float>, VecMap> *l_mappings = &mappings[0];
+    float *l_min_rmsd_vec = &min_rmsd_vec[0];
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_Np),
+        [=, &local_reg] (const tbb::blocked_range<size_t>& r)
         {
-        vec3<float> p = m_box.wrap(refPoints[i]);
-        e0.addVec(p);
-        }
-
-    // add this environment to the set
-    dj.s.push_back(e0);
+        registration::RegisterBruteForce& reg = local_reg.local();
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            envs[i+1] = buildEnv(points, i, i+1, false);
+            // populate the min_rmsd vector
+            float min_rmsd = -1.0;
+            l_mappings[i] = minimizeRMSD(envs[0], envs[i+1], min_rmsd, registration, &reg);
+            l_min_rmsd_vec[i] = min_rmsd;
+            }
+        });
 
-    // loop through the particles and add their environments to the set
-    // take care, here: set things up s.t. the env_ind of every environment matches its location in the disjoint set.
-    // if you don't do this, things will get screwy.
     for (unsigned int i = 0; i < m_Np; i++)
         {
-        unsigned int dummy = i+1;
-        Environment ei = buildEnv(points, i, dummy, false);
-        dj.s.push_back(ei);
-
-        // if the environment matches e0, merge it into the e0 environment set
-        float min_rmsd = -1.0;
-        std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > mapping = minimizeRMSD(dj.s[0], dj.s[dummy], min_rmsd, registration);
-        rotmat3<float> rotation = mapping.first;
-        boost::bimap<unsigned int, unsigned int> vec_map = mapping.second;
-        // populate the min_rmsd vector
-        min_rmsd_vec[i] = min_rmsd;
-
+        const rotmat3<float>& rotation = mappings[i].first;
+        const VecMap& vec_map = mappings[i].second;
         // if the mapping between the vectors of the environments is NOT empty, then the environments are similar.
         // minimizeRMSD should always return a non-empty vec_map, except if e0 and e1 have different numbers of vectors.
         if (!vec_map.empty())
             {
-            dj.merge(0, dummy, vec_map, rotation);
+            dj.merge(0, i+1, vec_map, rotation);
             }
         }
 
@@ -864,60 +1059,128 @@ std::vector<float> MatchEnv::minRMSDMotif(const vec3<float> *points, unsigned in
     return min_rmsd_vec;
     }
 
+//! Determine, for each particle, the first of numMotifs motifs (of numRef vectors each, one after the other in refPoints) that its environment matches.
+//! The environments, fingerprints and registrations of the motifs are built once, and every thread gets its own copy
+//! of the registrations. The particles are independent of each other, and are screened in parallel.
+std::vector<unsigned int> MatchEnv::matchMotifs(const vec3<float> *points, unsigned int Np, const vec3<float> *refPoints, unsigned int numMotifs, unsigned int numRef, float threshold, bool registration)
+    {
+    assert(points);
+    assert(refPoints);
+    assert(numRef == m_k);
+    assert(Np > 0);
+    assert(threshold > 0);
+
+    float m_threshold_sq = threshold*threshold;
+    const float max_delta = threshold*m_rmax + 1e-3f*m_rmax;
+
+    // compute the neighbor list
+    m_nn->compute(m_box, points, Np, points, Np);
+
+    // the environments, fingerprints and registrations of the motifs
+    std::vector<Environment> motifs(numMotifs);
+    std::vector<float> motif_fingerprints(std::max(numMotifs*numRef, 1u));
+    std::vector<registration::RegisterBruteForce> motif_regs;
+    for (unsigned int n = 0; n < numMotifs; n++)
+        {
+        motifs[n] = buildMotifEnv(refPoints + n*numRef, numRef, n);
+        computeFingerprint(motifs[n], &motif_fingerprints[n*numRef]);
+        motif_regs.push_back(registration::RegisterBruteForce(motifs[n].vecs));
+        }
+    tbb::enumerable_thread_specific<std::vector<registration::RegisterBruteForce> > local_regs(motif_regs);
+
+    std::vector<unsigned int> motif_index(Np, numMotifs);
+    unsigned int *l_motif_index = &motif_index[0];
+    Environment *l_motifs = numMotifs ? &motifs[0] : NULL;
+    const float *l_motif_fingerprints = &motif_fingerprints[0];
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, Np),
+        [=, &local_regs] (const tbb::blocked_range<size_t>& r)
+        {
+        std::vector<registration::RegisterBruteForce>& regs = local_regs.local();
+        std::vector<float>& fingerprint = m_local_fingerprint.local();
+        fingerprint.resize(std::max(numRef, 1u));
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            Environment ei = buildEnv(points, i, i, false);
+            if (ei.num_vecs != numRef)
+                continue;
+            computeFingerprint(ei, &fingerprint[0]);
+            for (unsigned int n = 0; n < numMotifs; n++)
+                {
+                if (!fingerprintsMatch(l_motif_fingerprints + n*numRef, numRef, &fingerprint[0], ei.num_vecs, max_delta))
+                    continue;
+                if (!isSimilar(l_motifs[n], ei, m_threshold_sq, registration, &regs[n]).second.empty())
+                    {
+                    l_motif_index[i] = n;
+                    break;
+                    }
+                }
+            }
+        });
+
+    return motif_index;
+    }
+
 //! Populate the m_env_index, m_env and m_tot_env arrays.
 //! Renumber the clusters in the disjoint set dj from zero to num_clusters-1, if that is called.
-void MatchEnv::populateEnv(EnvDisjointSet dj, bool reLabel)
+//! The sets are grouped once and then averaged in parallel, the clusters being numbered in the order of their first
+//! physical member as they were by the scan over the particles.
+void MatchEnv::populateEnv(EnvDisjointSet& dj, bool reLabel)
     {
-    std::map<unsigned int, unsigned int> label_map;
+    std::vector<unsigned int> members, set_begin, set_end;
+    dj.groupSets(members, set_begin, set_end);
+    unsigned int num_sets = set_begin.size();
 
-    // loop over all environments
-    unsigned int label_ind;
-    unsigned int cur_set = 0;
+    // index of each node among the physical environments, and its label
+    std::vector<unsigned int> particle_index(dj.s.size());
     unsigned int particle_ind = 0;
     for (unsigned int i = 0; i < dj.s.size(); i++)
         {
-        // only count this if the environment is physical
+        particle_index[i] = particle_ind;
         if (dj.s[i].ghost == false)
-            {
-            // grab the set of vectors that define this individual environment
-            std::vector<vec3<float> > part_vecs = dj.getIndividualEnv(i);
-
-            unsigned int c = dj.find(i);
-            // insert the set into the mapping if we haven't seen it before.
-            // also grab the vectors that define the set and insert them into m_env
-            if (label_map.count(c) == 0)
-                {
-                label_map[c] = cur_set;
-                std::shared_ptr<vec3<float> > vecs = dj.getAvgEnv(c);
-
-                if (reLabel == true) { label_ind = label_map[c]; }
-                else { label_ind = c; }
-
-                m_env[label_ind] = vecs;
+            particle_ind++;
+        }
+    std::vector<unsigned int> node_label(dj.s.size());
 
-                cur_set++;
-                }
+    std::vector<std::shared_ptr<vec3<float> > > set_envs(num_sets);
+    std::vector<unsigned int> set_labels(num_sets);
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, num_sets),
+        [&] (const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int c = r.begin(); c != r.end(); c++)
+            {
+            const unsigned int *set_members = &members[set_begin[c]];
+            unsigned int n = set_end[c] - set_begin[c];
+            unsigned int label_ind = (reLabel == true) ? c : dj.s[set_members[0]].env_ind;
+            set_labels[c] = label_ind;
+            set_envs[c] = dj.getAvgEnv(set_members, n);
+            for (unsigned int member = 0; member < n; member++)
+                node_label[set_members[member]] = label_ind;
+            }
+        });
 
-            if (reLabel == true) { label_ind = label_map[c]; }
-            else { label_ind = c; }
+    for (unsigned int c = 0; c < num_sets; c++)
+        m_env[set_labels[c]] = set_envs[c];
 
-            // label this particle in m_env_index
-            m_env_index.get()[particle_ind] = label_ind;
-            // add the particle environment to m_tot_env
-            // get a pointer to the start of m_tot_env
-            vec3<float> *start = m_tot_env.get();
-            // loop through part_vecs and add them
+    // label each particle in m_env_index and add its environment to m_tot_env
+    vec3<float> *start = m_tot_env.get();
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, dj.s.size()),
+        [&] (const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); i++)
+            {
+            if (dj.s[i].ghost == true)
+                continue;
+            unsigned int p = particle_index[i];
+            m_env_index.get()[p] = node_label[i];
+            // grab the set of vectors that define this individual environment
+            std::vector<vec3<float> > part_vecs = dj.getIndividualEnv(i);
             for (unsigned int m = 0; m < part_vecs.size(); m++)
-                {
-                unsigned int index = particle_ind*m_maxk + m;
-                start[index] = part_vecs[m];
-                }
-            particle_ind++;
+                start[p*m_maxk + m] = part_vecs[m];
             }
-        }
+        });
 
     // specify the number of cluster environments
-    m_num_clusters = cur_set;
+    m_num_clusters = num_sets;
     }
 
 }; }; // end namespace freud::match_env;
@@ -17,6 +17,7 @@
 #include "NearestNeighbors.h"
 #include "brute_force.h"
 #include "box.h"
+#include "ComputeArena.h"
 
 #include <stdexcept>
 #include <complex>
@@ -55,6 +56,96 @@ struct Environment
     rotmat3<float> proper_rot;              //!< The rotation that defines the proper orientation of the environment
     };
 
+//! One to one mapping between the indices of the vectors of two environments
+/*! Used instead of a boost::bimap in the comparisons of environments: the mapping is stored in both directions in flat
+    arrays, inline for environments of up to inline_size vectors, so comparing two environments of the usual 12 or
+    so neighbors allocates nothing. As with a bimap, a pair is only inserted when neither of its indices is mapped yet.
+*/
+class VecMap
+    {
+    public:
+        //! Index of the vectors that are not mapped
+        static const unsigned int unmapped = 0xffffffff;
+        //! Largest number of vectors stored without allocation
+        static const unsigned int inline_size = 32;
+
+        //! Constructor
+        /*! \param n Number of vectors of each environment
+        */
+        VecMap(unsigned int n = 0) : m_n(n), m_size(0)
+            {
+            if (m_n > inline_size)
+                m_heap.resize(2*m_n);
+            std::fill(data(), data() + 2*m_n, unmapped);
+            }
+
+        //! Map \a left to \a right, unless either is already mapped. Returns whether the pair was inserted.
+        bool insert(unsigned int left, unsigned int right)
+            {
+            unsigned int *to_right = data();
+            unsigned int *to_left = data() + m_n;
+            if (to_right[left] != unmapped || to_left[right] != unmapped)
+                return false;
+            to_right[left] = right;
+            to_left[right] = left;
+            m_size++;
+            return true;
+            }
+
+        //! Remove all the pairs
+        void clear()
+            {
+            std::fill(data(), data() + 2*m_n, unmapped);
+            m_size = 0;
+            }
+
+        //! Get the number of pairs
+        unsigned int size() const
+            {
+            return m_size;
+            }
+
+        //! Return whether there are no pairs
+        bool empty() const
+            {
+            return m_size == 0;
+            }
+
+        //! Get the number of vectors of each environment
+        unsigned int getNumVecs() const
+            {
+            return m_n;
+            }
+
+        //! Get the right index mapped to \a left, or unmapped
+        unsigned int getRight(unsigned int left) const
+            {
+            return data()[left];
+            }
+
+        //! Get the left index mapped to \a right, or unmapped
+        unsigned int getLeft(unsigned int right) const
+            {
+            return data()[m_n + right];
+            }
+
+    private:
+        //! The right index of each left index, followed by the left index of each right index
+        unsigned int *data()
+            {
+            return (m_n > inline_size) ? &m_heap[0] : m_inline;
+            }
+        const unsigned int *data() const
+            {
+            return (m_n > inline_size) ? &m_heap[0] : m_inline;
+            }
+
+        unsigned int m_n;                           //!< Number of vectors of each environment
+        unsigned int m_size;                        //!< Number of pairs
+        unsigned int m_inline[2*inline_size];       //!< Storage of the mapping for up to inline_size vectors
+        std::vector<unsigned int> m_heap;           //!< Storage of the mapping for more vectors
+    };
+
 //! General disjoint set class, taken mostly from Cluster.h
 class EnvDisjointSet
     {
@@ -62,13 +153,22 @@ class EnvDisjointSet
         //! Constructor
         EnvDisjointSet(unsigned int Np);
         //! Merge two sets
-        void merge(const unsigned int a, const unsigned int b, boost::bimap<unsigned int, unsigned int> vec_map, rotmat3<float> rotation);
+        void merge(const unsigned int a, const unsigned int b, const VecMap& vec_map, const rotmat3<float>& rotation);
         //! Find the set with a given element
         unsigned int find(const unsigned int c);
         //! Return ALL nodes in the tree that correspond to the head index m
         std::vector<unsigned int> findSet(const unsigned int m);
         //! Get the vectors corresponding to environment head index m. Vectors are averaged over all members of the environment cluster.
         std::shared_ptr<vec3<float> > getAvgEnv(const unsigned int m);
+        //! Get the vectors averaged over the n environments members, all of the same set
+        std::shared_ptr<vec3<float> > getAvgEnv(const unsigned int *members, unsigned int n) const;
+        //! Group the physical environments by their set
+        /*! The sets are ordered by their first physical member, their members being members[set_begin[c]] to
+            members[set_end[c]-1] in increasing order. The trees are flattened, so that the head of each node is
+            s[node].env_ind afterwards.
+        */
+        void groupSets(std::vector<unsigned int>& members, std::vector<unsigned int>& set_begin,
+                       std::vector<unsigned int>& set_end);
         //! Get the vectors corresponding to index m in the dj set
         std::vector<vec3<float> > getIndividualEnv(const unsigned int m);
 
@@ -95,6 +195,9 @@ class MatchEnv
         //! if hard_r is true, add all particles that fall within the threshold of m_rmaxsq to the environment
         Environment buildEnv(const vec3<float> *points, unsigned int i, unsigned int env_ind, bool hard_r);
 
+        //! Construct and return the ghost environment of the motif characterized by refPoints (of which there are numRef). Set the environment index to env_ind.
+        Environment buildMotifEnv(const vec3<float> *refPoints, unsigned int numRef, unsigned int env_ind);
+
         //! Determine clusters of particles with matching environments
         //! The threshold is a unitless number, which we multiply by the length scale of the MatchEnv instance, rmax.
         //! This quantity is the maximum squared magnitude of the vector difference between two vectors, below which you call them matching.
@@ -118,8 +221,13 @@ class MatchEnv
         //! To fully solve this, we need to use the Hungarian algorithm or some other way of solving the so-called assignment problem.
         std::vector<float> minRMSDMotif(const vec3<float> *points, unsigned int Np, const vec3<float> *refPoints, unsigned int numRef, bool registration=false);
 
+        //! Determine which of numMotifs motifs, of numRef vectors each and stored one after the other in refPoints, the environment of each particle matches.
+        //! Returns, for each particle, the index of the first motif it matches, or numMotifs if it matches none of them.
+        //! The threshold and registration are those of matchMotif. The clusters and environments of the last cluster or matchMotif call are left as they are.
+        std::vector<unsigned int> matchMotifs(const vec3<float> *points, unsigned int Np, const vec3<float> *refPoints, unsigned int numMotifs, unsigned int numRef, float threshold, bool registration=false);
+
         //! Renumber the clusters in the disjoint set dj from zero to num_clusters-1
-        void populateEnv(EnvDisjointSet dj, bool reLabel=true);
+        void populateEnv(EnvDisjointSet& dj, bool reLabel=true);
 
         //! Is the (PROPERLY REGISTERED) environment e1 similar to the (PROPERLY REGISTERED) environment e2?
         //! If so, return a std::pair of the rotation matrix that takes the vectors of e2 to the vectors of e1 AND the mapping between the properly indexed vectors of the environments that will make them correspond to each other.
@@ -127,7 +235,8 @@ class MatchEnv
         //! The threshold is a unitless number, which we multiply by the length scale of the MatchEnv instance, rmax.
         //! This quantity is the maximum squared magnitude of the vector difference between two vectors, below which you call them matching.
         //! The bool registration controls whether we first use brute force registration to orient the second set of vectors such that it minimizes the RMSD between the two sets
-        std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > isSimilar(Environment& e1, Environment& e2, float threshold_sq, bool registration);
+        //! If given, reg1 is a RegisterBruteForce of the properly registered vectors of e1, used instead of building a new one for the comparison.
+        std::pair<rotmat3<float>, VecMap> isSimilar(Environment& e1, Environment& e2, float threshold_sq, bool registration, registration::RegisterBruteForce *reg1=NULL);
 
         //! Overload: is the set of vectors refPoints1 similar to the set of vectors refPoints2?
         //! Construct the environments accordingly, and utilize isSimilar() as above.
@@ -143,7 +252,8 @@ class MatchEnv
         // NOTE that this does not guarantee an absolutely minimal RMSD. It doesn't figure out the optimal permutation
         // of BOTH sets of vectors to minimize the RMSD. Rather, it just figures out the optimal permutation of the second set, the vector set used in the argument below.
         // To fully solve this, we need to use the Hungarian algorithm or some other way of solving the so-called assignment problem.
-        std::pair<rotmat3<float>, boost::bimap<unsigned int, unsigned int> > minimizeRMSD(Environment& e1, Environment& e2, float& min_rmsd, bool registration);
+        // If given, reg1 is a RegisterBruteForce of the properly registered vectors of e1, used instead of building a new one for the comparison.
+        std::pair<rotmat3<float>, VecMap> minimizeRMSD(Environment& e1, Environment& e2, float& min_rmsd, bool registration, registration::RegisterBruteForce *reg1=NULL);
 
         // Overload: Get the somewhat-optimal RMSD between the set of vectors refPoints1 and the set of vectors refPoints2.
         // Construct the environments accordingly, and utilize minimizeRMSD() as above.
@@ -204,6 +314,19 @@ class MatchEnv
             return m_maxk;
             }
 
+        //! Set whether the registration matches fixed anchors of the environments (the default), or random triplets
+        //! of their vectors as RegisterBruteForce does without setAccelerated()
+        void setAcceleratedRegistration(bool accelerated)
+            {
+            m_accelerated_registration = accelerated;
+            }
+
+        //! Get whether the registration matches fixed anchors of the environments
+        bool getAcceleratedRegistration() const
+            {
+            return m_accelerated_registration;
+            }
+
     private:
         box::Box m_box;              //!< Simulation box
         float m_rmax;                       //!< Maximum cutoff radius at which to determine local environment
@@ -214,10 +337,12 @@ class MatchEnv
         locality::LinkCell *m_lc;           //!< LinkCell to bin particles for the computation
         unsigned int m_Np;                  //!< Last number of points computed
         unsigned int m_num_clusters;        //!< Last number of local environments computed
+        bool m_accelerated_registration;    //!< true to register with the accelerated RegisterBruteForce
 
         std::shared_ptr<unsigned int> m_env_index;                              //!< Cluster index determined for each particle
         std::map<unsigned int, std::shared_ptr<vec3<float> > > m_env;           //!< Dictionary of (cluster id, vectors) pairs
         std::shared_ptr<vec3<float> > m_tot_env;                                //!< m_NP by m_maxk by 3 matrix of all environments for all particles
+        util::ThreadScratch< std::vector<float> > m_local_fingerprint;          //!< Fingerprint of each thread of the motif matching
     };
 
 }; }; // end namespace freud::match_env
@@ -48,99 +48,77 @@ void Pairing2D::ComputePairing2D(const vec3<float> *points,
                                  const float *orientations,
                                  const float *comp_orientations,
                                  const unsigned int Np,
-                                 const unsigned int No)
+                                 const unsigned int No,
+                                 const locality::NeighborList *nlist)
     {
-    // for each particle
-    Index2D b_i = Index2D(m_No, m_Np);
-    for (unsigned int i = 0; i < m_Np; i++)
-        {
-        // get the position of particle i
-        const vec2<float> r_i(points[i].x, points[i].y);
-        bool is_paired = false;
-        //loop over neighbors
-        locality::NearestNeighbors::iteratorneighbor it = m_nn->iterneighbor(i);
-        for (unsigned int j = it.begin(); !it.atEnd(); j = it.next())
+    // the unit vector of each complementary orientation, rotated by the orientation of its particle into the
+    // frame of the box: the angle between a complementary orientation and a bond is the same in either frame
+    m_comp_x.resize(Np*No);
+    m_comp_y.resize(Np*No);
+    float *comp_x = m_comp_x.data();
+    float *comp_y = m_comp_y.data();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
             {
-            // once a particle is paired we can stop
-            if (m_match_array.get()[i] != 0)
-                {
-                break;
-                }
-            // get the position of particle j
-            const vec2<float> r_j(points[j].x, points[j].y);
-            // find interparticle vectors
-            vec2<float> r_ij(r_j - r_i);
-            vec2<float> r_ji(r_i - r_j);
-            // wrap into box
-            vec3<float> delta = m_box.wrap(vec3<float>(r_ij.x, r_ij.y, 0.0));
-            r_ij = vec2<float>(delta.x, delta.y);
-            delta = m_box.wrap(vec3<float>(r_ji.x, r_ji.y, 0.0));
-            r_ji = vec2<float>(delta.x, delta.y);
-            // find the squared distance for better computational efficiency
-            float rsq(dot(r_ij, r_ij));
-
-            // will skip same particle
-            // shouldn't actually be needed
-            if (rsq > 1e-6)
+            for (size_t i = r.begin(); i != r.end(); i++)
+                for (unsigned int a = 0; a < No; a++)
+                    {
+                    float theta = comp_orientations[i*No + a] + orientations[i];
+                    comp_x[i*No + a] = cosf(theta);
+                    comp_y[i*No + a] = sinf(theta);
+                    }
+            });
+
+    // the angle between two unit vectors is below comp_dot_tol when their dot product is above its cosine
+    float cos_tol = (m_comp_dot_tol > float(M_PI)) ? -2.0f : ((m_comp_dot_tol <= 0.0f) ? 2.0f : cosf(m_comp_dot_tol));
+    float rmaxsq = m_rmax * m_rmax;
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    unsigned int *match = m_match_array.get();
+    unsigned int *pair = m_pair_array.get();
+
+    // each particle only writes its own match and pair
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+            {
+            for (size_t i = r.begin(); i != r.end(); i++)
                 {
-                // check if the particles are paired
-                // particles are paired if they are the nearest neighbors that have the complementary vector
-                // pointing in the same direction as the paired centroid vectorc
-
-                // rotate the unit interparticle vector
-                rotmat2<float> my_mat = rotmat2<float>::fromAngle(-orientations[i]);
-                vec2<float> u_ij(r_ij/sqrt(rsq));
-                u_ij = my_mat * u_ij;
-                u_ij = u_ij / sqrt(dot(u_ij, u_ij));
-                my_mat = rotmat2<float>::fromAngle(-orientations[j]);
-                rsq = dot(r_ji, r_ji);
-                vec2<float> u_ji(r_ji/sqrt(rsq));
-                u_ji = my_mat * u_ji;
-                u_ji = u_ji / sqrt(dot(u_ji, u_ji));
-
-                // for each potential complementary orientation for particle i
-                for (unsigned int a=0; a<m_No; a++)
+                const vec3<float> r_i = points[i];
+                //loop over neighbors
+                for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
                     {
-                    // break once pair is detected
-                    if (is_paired == true)
+                    unsigned int j = index_j[bond];
+                    // find the interparticle vector from i to j
+                    vec3<float> delta = (vectors != NULL) ? vectors[bond] : m_box.wrap(points[j] - r_i);
+                    vec2<float> r_ij(delta.x, delta.y);
+                    float rsq(dot(r_ij, r_ij));
+
+                    // will skip same particle
+                    // as the neighbor list may use a larger rmax than was initialized, it has to check again
+                    if ((rsq <= 1e-6) || (rsq >= rmaxsq))
+                        continue;
+                    vec2<float> u_ij(r_ij / sqrtf(rsq));
+
+                    // particles are paired if a complementary orientation of i points at j and a complementary
+                    // orientation of j points at i
+                    bool i_points = false;
+                    for (unsigned int a = 0; a < No && !i_points; a++)
+                        i_points = (comp_x[i*No + a]*u_ij.x + comp_y[i*No + a]*u_ij.y > cos_tol);
+                    if (!i_points)
+                        continue;
+                    bool j_points = false;
+                    for (unsigned int b = 0; b < No && !j_points; b++)
+                        j_points = (comp_x[j*No + b]*u_ij.x + comp_y[j*No + b]*u_ij.y < -cos_tol);
+                    if (j_points)
                         {
+                        // once a particle is paired we can stop
+                        match[i] = 1;
+                        pair[i] = j;
                         break;
                         }
-                    // generate vectors
-                    float theta_ci = comp_orientations[b_i(a, i)];
-                    vec2<float> c_i(cosf(theta_ci), sinf(theta_ci));
-                    c_i = c_i / sqrt(dot(c_i, c_i));
-
-                    // for each potential complementary orientation for particle j
-                    for (unsigned int b=0; b<m_No; b++)
-                        {
-                        // break once pair is detected
-                        if (is_paired == true)
-                            {
-                            break;
-                            }
-                        // generate vectors
-                        float theta_cj = comp_orientations[b_i(b, j)];
-                        vec2<float> c_j(cosf(theta_cj), sinf(theta_cj));
-                        c_j = c_j / sqrt(dot(c_j, c_j));
-                        // calculate the angle between vectors using cross and dot method
-                        // only use the abs angle (direction is not necessary)
-                        // using method from http://stackoverflow.com/questions/21483999/using-atan2-to-find-angle-between-two-vectors
-                        float d_ij = abs(atan2(((c_i.x*u_ij.y)-(c_i.y*u_ij.x)),dot(c_i, u_ij)));
-                        float d_ji = abs(atan2(((c_j.x*u_ji.y)-(c_j.y*u_ji.x)),dot(c_j, u_ji)));
-                        // As the nearest neighbor list may use a larger rmax than was initialized, it has
-                        // to check again
-                        if ((d_ij < m_comp_dot_tol) && (d_ji < m_comp_dot_tol) && (is_paired==false) && (rsq < (m_rmax * m_rmax)))
-                            {
-                            m_match_array.get()[i] = 1;
-                            m_pair_array.get()[i] = j;
-                            is_paired = true;
-                            } // done pairing particle
-                        } // done checking all orientations of j
-                    } // done checking all orientations of i
-                } // done with not doing if the same particle (which should not happen)
-            } // done looping over neighbors
-        } // done looping over reference points
+                    } // done looping over neighbors
+                } // done looping over reference points
+            });
     }
 
 void Pairing2D::compute(box::Box& box,
@@ -148,11 +126,19 @@ void Pairing2D::compute(box::Box& box,
                         const float* orientations,
                         const float* comp_orientations,
                         const unsigned int Np,
-                        const unsigned int No)
+                        const unsigned int No,
+                        const locality::NeighborList *nlist)
     {
     m_box = box;
-    m_nn->compute(m_box,points,Np,points,Np);
-    m_nn->setRMax(m_rmax);
+    // the k nearest neighbors of each particle, unless the neighbors are given
+    if (nlist != NULL)
+        nlist->validate(Np, Np);
+    else
+        {
+        m_nn->compute(m_box,points,Np,points,Np);
+        m_nn->setRMax(m_rmax);
+        nlist = m_nn->getNlist();
+        }
     // reallocate the output array if it is not the right size
     if (Np != m_Np)
         {
@@ -168,11 +154,12 @@ void Pairing2D::compute(box::Box& box,
         {
         m_pair_array.get()[i] = i;
         }
-     ComputePairing2D(points,
-                      orientations,
-                      comp_orientations,
-                      Np,
-                      No);
+    ComputePairing2D(points,
+                     orientations,
+                     comp_orientations,
+                     Np,
+                     No,
+                     nlist);
     m_Np = Np;
     m_No = No;
     }
@@ -10,8 +10,10 @@
 #define __APPLE__
 
 #include <memory>
+#include <vector>
 
 #include "NearestNeighbors.h"
+#include "NeighborList.h"
 #include "VectorMath.h"
 #include "box.h"
 #include "Index1D.h"
@@ -21,16 +23,18 @@
 
 namespace freud { namespace order {
 
-//! Computes the number of matches for a given set of points
-/*! A given set of reference points is given around which the RDF is computed and averaged in a sea of data points.
-    Computing the RDF results in an rdf array listing the value of the RDF at each given r, listed in the r array.
+//! Computes the pairs of a set of 2D particles with complementary orientations
+/*! Particle i is paired with its first neighbor j, in the order of the neighbor list, closer than rmax such that
+    one of the complementary orientations of i points at j and one of the complementary orientations of j points at
+    i, each within the angle comp_dot_tol. The complementary orientations of each particle are given relative to
+    its orientation.
 
-    The values of r to compute the rdf at are controlled by the rmax and dr parameters to the constructor. rmax
-    determins the maximum r at which to compute g(r) and dr is the step size for each bin.
+    The neighbors are the k nearest neighbors of each particle, unless a neighbor list is passed to compute. The
+    complementary orientations are turned into unit vectors in the frame of the box once per particle, so each
+    candidate pair only costs dot products, and the particles are handled in parallel.
 
     <b>2D:</b><br>
-    RDF properly handles 2D boxes. As with everything else in freud, 2D points must be passed in as
-    3 component vectors x,y,0. Failing to set 0 in the third component will lead to undefined behavior.
+    As with everything else in freud, 2D points must be passed in as 3 component vectors x,y,0.
 */
 class Pairing2D
     {
@@ -76,12 +80,15 @@ class Pairing2D
         //     }
 
         //! Compute the pairing function
+        /*! \param nlist Neighbors of each point to use instead of its k nearest neighbors (optional)
+        */
         void compute(box::Box& box,
                      const vec3<float>* points,
                      const float* orientations,
                      const float* comp_orientations,
                      const unsigned int Np,
-                     const unsigned int No);
+                     const unsigned int No,
+                     const locality::NeighborList *nlist=NULL);
 
         unsigned int getNumParticles()
             {
@@ -93,11 +100,12 @@ class Pairing2D
                               const float *orientations,
                               const float *comp_orientations,
                               const unsigned int Np,
-                              const unsigned int No);
+                              const unsigned int No,
+                              const locality::NeighborList *nlist);
 
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_rmax;                     //!< Maximum r to check for nearest neighbors
-        float m_comp_dot_tol;                     //!< Maximum r at which to compute g(r)
+        float m_comp_dot_tol;                     //!< Largest angle between a complementary orientation and a bond
         locality::NearestNeighbors* m_nn;          //!< Nearest Neighbors for the computation
         std::shared_ptr<unsigned int> m_match_array;         //!< unsigned int array of whether particle i is paired
         std::shared_ptr<unsigned int> m_pair_array;         //!< array of pairs for particle i
@@ -105,6 +113,8 @@ class Pairing2D
         unsigned int m_k;             //!< Number of nearest neighbors to check
         unsigned int m_Np;                //!< Last number of points computed
         unsigned int m_No;                //!< Last number of complementary orientations used
+        std::vector<float> m_comp_x;      //!< x of the unit vector of each complementary orientation, in the box frame
+        std::vector<float> m_comp_y;      //!< y of the unit vector of each complementary orientation, in the box frame
 
     };
 
@@ -4,15 +4,18 @@
 #include "SolLiq.h"
 #include "Cluster.h"
 #include <map>
+#include <cstring>
 //#include <boost/math/special_functions.hpp>
 #include <boost/math/special_functions/spherical_harmonic.hpp>
 
 using namespace std;
+using namespace tbb;
 
 namespace freud { namespace order {
 
 SolLiq::SolLiq(const box::Box& box, float rmax, float Qthreshold, unsigned int Sthreshold, unsigned int l)
-    :m_box(box), m_rmax(rmax), m_rmax_cluster(rmax), m_lc(box, rmax), m_Qthreshold(Qthreshold), m_Sthreshold(Sthreshold), m_l(l)
+    :m_box(box), m_rmax(rmax), m_rmax_cluster(rmax), m_lc(box, rmax), m_Qthreshold(Qthreshold), m_Sthreshold(Sthreshold), m_l(l),
+     m_harmonics(l, true)
     {
     m_Np = 0;
     if (m_rmax < 0.0f)
@@ -25,25 +28,13 @@ SolLiq::SolLiq(const box::Box& box, float rmax, float Qthreshold, unsigned int S
         throw invalid_argument("l shouldbe greater than zero!");
     }
 
-// Calculating Ylm using fsph module
+// Calculating Ylm using the shared harmonics evaluator
 void SolLiq::Ylm(const float theta, const float phi, std::vector<std::complex<float> > &Y)
     {
     if (Y.size() != 2*m_l+1)
         Y.resize(2*m_l+1);
 
-    fsph::PointSPHEvaluator<float> sph_eval(m_l);
-
-    unsigned int j(0);
-    // old definition in compute (theta: 0...pi, phi: 0...2pi)
-    // in fsph, the definition is flipped
-    sph_eval.compute(theta, phi);
-
-    for(typename fsph::PointSPHEvaluator<float>::iterator iter(sph_eval.begin_l(m_l, 0, true));
-        iter != sph_eval.end(); ++iter)
-        {
-        Y[j] = *iter;
-        ++j;
-        }
+    m_harmonics.evaluate(theta, phi, &Y[0]);
     }
 
 /*
@@ -129,17 +120,60 @@ void SolLiq::Y4m(const float theta, const float phi, std::vector<std::complex<fl
 
 */
 
+//! \internal
+//! Gather the values of the bonds i < j that pass keep, in the order of the neighbor list
+/*! Each reference point i writes its own range of \a values, found from the number of kept bonds of the points
+    before it, so the pairs come out in the same order as a serial loop over i and its neighbors would give.
+*/
+template<typename T, typename Keep>
+void gatherPairs(const locality::NeighborList *nlist, unsigned int Np, const T *bond_values, Keep keep,
+                 std::vector<T>& values)
+    {
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    std::vector<size_t> pair_start(Np + 1, 0);
+    size_t *l_pair_start = &pair_start[0];
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t num_pairs = 0;
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                if (i < index_j[bond] && keep(bond))
+                    num_pairs++;
+            l_pair_start[i+1] = num_pairs;
+            }
+        });
+    for (unsigned int i = 0; i < Np; i++)
+        pair_start[i+1] += pair_start[i];
+
+    values.resize(pair_start[Np]);
+    T *l_values = values.size() ? &values[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t n = l_pair_start[i];
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                if (i < index_j[bond] && keep(bond))
+                    l_values[n++] = bond_values[bond];
+            }
+        });
+    }
+
 //Begins calculation of the solid-liq order parameters.
 //Note that the SolLiq container class conatins the threshold cutoffs
 // void SolLiq::compute(const float3 *points, unsigned int Np)
 void SolLiq::compute(const vec3<float> *points, unsigned int Np)
     {
-    m_lc.computeCellList(m_box,points,Np);
+    // the cell list is as wide as the larger of the two radii, so one neighbor list serves every step
+    m_lc.computeNlist(m_box, points, Np, points, Np, true, true);
 
     //Initialize Qlmi
     computeClustersQ(points,Np);
     //Determines number of solid or liquid like bonds
-    computeClustersQdot(points,Np);
+    computeClustersQdot(points,Np,true);
     //Determines if particles are solid or liquid by clustering those with sufficient solid-like bonds
     computeClustersQS(points,Np);
     m_Np = Np;
@@ -150,10 +184,10 @@ void SolLiq::compute(const vec3<float> *points, unsigned int Np)
 // void SolLiq::computeSolLiqVariant(const float3 *points, unsigned int Np)
 void SolLiq::computeSolLiqVariant(const vec3<float> *points, unsigned int Np)
     {
-    m_lc.computeCellList(m_box,points,Np);
+    m_lc.computeNlist(m_box, points, Np, points, Np, true, true);
     //Initialize Qlmi
     computeClustersQ(points,Np);
-    vector< vector<unsigned int> > SolidlikeNeighborlist;
+    SolidLikeNeighbors SolidlikeNeighborlist;
     computeListOfSolidLikeNeighbors(points, Np, SolidlikeNeighborlist);
     computeClustersSharedNeighbors(points, Np, SolidlikeNeighborlist);
     m_Np = Np;
@@ -163,11 +197,11 @@ void SolLiq::computeSolLiqVariant(const vec3<float> *points, unsigned int Np)
 // void SolLiq::computeSolLiqNoNorm(const float3 *points, unsigned int Np)
 void SolLiq::computeSolLiqNoNorm(const vec3<float> *points, unsigned int Np)
     {
-    m_lc.computeCellList(m_box,points,Np);
+    m_lc.computeNlist(m_box, points, Np, points, Np, true, true);
     //Initialize Qlmi
     computeClustersQ(points,Np);
     //Determines number of solid or liquid like bonds
-    computeClustersQdotNoNorm(points,Np);
+    computeClustersQdot(points,Np,false);
     //Determines if particles are solid or liquid by clustering those with sufficient solid-like bonds
     computeClustersQS(points,Np);
     m_Np = Np;
@@ -185,197 +219,145 @@ void SolLiq::computeClustersQ(const vec3<float> *points, unsigned int Np)
     memset((void*)m_Qlmi_array.get(), 0, sizeof(complex<float>)*(2*m_l+1)*Np);
     memset((void*)m_number_of_neighbors.get(), 0, sizeof(unsigned int)*Np);
 
+    const locality::NeighborList *nlist = m_lc.getNlist();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    const unsigned int elements = 2*m_l+1;
+    complex<float> *Qlmi = m_Qlmi_array.get();
+    unsigned int *number_of_neighbors = m_number_of_neighbors.get();
 
-    std::vector<std::complex<float> > Y;  Y.resize(2*m_l+1);
-
-    for (unsigned int i = 0; i<Np; i++)
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
         {
-        //get cell point is in
-        // float3 ref = points[i];
-        vec3<float> ref = points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
-
-        //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-            {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
+        // one evaluator per task, fed blocks of the bonds of each particle within rmax
+        BatchSphericalHarmonics sph(m_l);
+        vec3<float> block[BatchSphericalHarmonics::block_size];
 
-            //iterate over particles in neighboring cells
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            unsigned int n_block = 0;
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
                 {
-                vec3<float> delta = m_box.wrap(points[j] - ref);
-                float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+                vec3<float> delta = vectors[bond];
+                float rsq = dot(delta, delta);
 
-                if (rsq < rmaxsq && i != j)
+                if (rsq < rmaxsq)
                     {
-                    float phi = atan2(delta.y,delta.x);      //0..2Pi
-                    float theta = acos(delta.z / sqrt(rsq)); //0..Pi
-
-                    /*if (m_l == 6)
-                        SolLiq::Y6m(theta,phi,Y);
-                    else if (m_l == 4)
-                        SolLiq::Y4m(theta,phi,Y);
-                    else
-                    */
-                    SolLiq::Ylm(theta,phi,Y);
-
-                    for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                    block[n_block++] = delta;
+                    if (n_block == BatchSphericalHarmonics::block_size)
                         {
-                        m_Qlmi_array.get()[(2*m_l+1)*i+k]+=Y[k];
+                        m_harmonics.accumulate(sph, block, n_block, Qlmi + elements*i);
+                        n_block = 0;
                         }
-                    m_number_of_neighbors.get()[i]++;
+                    number_of_neighbors[i]++;
                     }
-                }//End loop over a particular neighbor cell
-            }  //End loops of neighboring cells
-        //if (m_number_of_neighbors[i] != 0)
-        //    {
-        //    for(unsigned int k = 0; k < (2*m_l+1); ++k)
-        //        {
-        //        m_Qlmi_array[(2*m_l+1)*i+k]/=m_number_of_neighbors[i];
-        //        }
-        //    }
-        } //Ends loop over particles i for Qlmi calcs}
-
+                }
+            if (n_block)
+                {
+                m_harmonics.accumulate(sph, block, n_block, Qlmi + elements*i);
+                }
+            }
+        });
     }
 
-//Initializes Q6lmi, and number of solid-like neighbors per particle.
-// void SolLiq::computeClustersQdot(const float3 *points,
-//                               unsigned int Np)
-void SolLiq::computeClustersQdot(const vec3<float> *points,
-                              unsigned int Np)
+//! \internal
+//! Compute Qlmi dot Qlmj for each bond of the neighbor list within rmax, and optionally normalize it
+void SolLiq::computeBondQdot(unsigned int Np, bool normalize)
     {
-    //clear vector
-    m_qldot_ij.clear();     //Stores all the q dot products between all particles i,j
-
-    // reallocate the cluster_idx array if the size doesn't match the last one
-    if (m_Np != Np)
+    const locality::NeighborList *nlist = m_lc.getNlist();
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    const float rmaxsq = m_rmax * m_rmax;
+    const unsigned int elements = 2*m_l+1;  //m= -l to l elements
+    const complex<float> *Qlmi = m_Qlmi_array.get();
+
+    // the norm of the Qlm of each particle, computed once instead of once per bond
+    std::vector<std::complex<float> > Qlmnorm(normalize ? Np : 0);
+    std::complex<float> *l_Qlmnorm = Qlmnorm.size() ? &Qlmnorm[0] : NULL;
+    if (normalize)
         {
-        m_number_of_connections = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+        parallel_for(blocked_range<size_t>(0, Np),
+            [=] (const blocked_range<size_t>& r)
+            {
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                std::complex<float> norm(0.0,0.0);//qlmi norm sq
+                for (unsigned int k = 0; k < elements; ++k)
+                    norm += Qlmi[elements*i+k]*conj(Qlmi[elements*i+k]);
+                l_Qlmnorm[i] = sqrt(norm);
+                }
+            });
         }
 
-    memset((void*)m_number_of_connections.get(), 0, sizeof(unsigned int)*Np);
-    float rmaxsq = m_rmax * m_rmax;
-    uint elements = 2*m_l+1;  //m= -l to l elements
-    // for each point
-    for (unsigned int i = 0; i < Np; i++)
+    m_bond_qdot.resize(nlist->getNumBonds());
+    std::complex<float> *bond_qdot = m_bond_qdot.size() ? &m_bond_qdot[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
         {
-        // get the cell the point is in
-        // float3 p = points[i];
-        vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
-
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        for (size_t i = r.begin(); i != r.end(); i++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
                 {
-                if (i < j)
+                if (dot(vectors[bond], vectors[bond]) >= rmaxsq)
+                    continue;
+                unsigned int j = index_j[bond];
+                //Calc Q dotproduct.
+                std::complex<float> Qdot(0.0,0.0);
+                for (unsigned int k = 0; k < elements; ++k)  // loop over m
                     {
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-                    float rsq = dot(delta, delta);
-
-                    if (rsq < rmaxsq)  //Check distance for candidate i,j
-                        {
-                        //Calc Q dotproduct.
-                        std::complex<float> Qdot(0.0,0.0);
-                        std::complex<float> Qlminorm(0.0,0.0);//qlmi norm sq
-                        std::complex<float> Qlmjnorm(0.0,0.0);
-                        for (unsigned int k = 0; k < (elements); ++k)  // loop over m
-                            {
-                            Qdot += m_Qlmi_array.get()[(elements)*i+k] * conj(m_Qlmi_array.get()[(elements)*j+k]);
-                            Qlminorm += m_Qlmi_array.get()[(elements)*i+k]*conj(m_Qlmi_array.get()[(elements)*i+k]);
-                            Qlmjnorm += m_Qlmi_array.get()[(elements)*j+k]*conj(m_Qlmi_array.get()[(elements)*j+k]);
-                            }
-                        Qlminorm = sqrt(Qlminorm);
-                        Qlmjnorm = sqrt(Qlmjnorm);
-                        Qdot = Qdot/real((Qlminorm*Qlmjnorm));
-                        m_qldot_ij.push_back(Qdot);  // Only i < j, other pairs not added.
-                        //Check if we're bonded via the threshold criterion
-                        if( real(Qdot) > m_Qthreshold)
-                            {
-                            //Tick up counts of number of connections these particles have
-                            m_number_of_connections.get()[i]++;
-                            m_number_of_connections.get()[j]++;
-                            }
-                        }
+                    Qdot += Qlmi[elements*i+k] * conj(Qlmi[elements*j+k]);
                     }
+                if (normalize)
+                    Qdot = Qdot/real(l_Qlmnorm[i]*l_Qlmnorm[j]);
+                bond_qdot[bond] = Qdot;
                 }
             }
-        }
+        });
     }
 
 //Initializes Q6lmi, and number of solid-like neighbors per particle.
-// void SolLiq::computeClustersQdotNoNorm(const float3 *points,
+// void SolLiq::computeClustersQdot(const float3 *points,
 //                               unsigned int Np)
-void SolLiq::computeClustersQdotNoNorm(const vec3<float> *points,
-                              unsigned int Np)
+void SolLiq::computeClustersQdot(const vec3<float> *points,
+                              unsigned int Np,
+                              bool normalize)
     {
-    m_qldot_ij.clear();
-
     // reallocate the cluster_idx array if the size doesn't match the last one
     if (m_Np != Np)
         {
         m_number_of_connections = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
         }
 
-    memset((void*)m_number_of_connections.get(), 0, sizeof(unsigned int)*Np);
-    float rmaxsq = m_rmax * m_rmax;
-    uint elements = 2*m_l+1;
-    // for each point
-    for (unsigned int i = 0; i < Np; i++)
+    computeBondQdot(Np, normalize);
+
+    const locality::NeighborList *nlist = m_lc.getNlist();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    const float rmaxsq = m_rmax * m_rmax;
+    const float Qthreshold = m_Qthreshold;
+    const std::complex<float> *bond_qdot = m_bond_qdot.size() ? &m_bond_qdot[0] : NULL;
+    unsigned int *number_of_connections = m_number_of_connections.get();
+
+    // the list holds both i-j and j-i, so each particle counts its own solid-like bonds
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
         {
-        // get the cell the point is in
-        // float3 p = points[i];
-        vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
-
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        for (size_t i = r.begin(); i != r.end(); i++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            unsigned int num_connections = 0;
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
                 {
-                if (i < j)
-                    {
-                    // compute r between the two particles
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-                    float rsq = dot(delta, delta);
-
-                    if (rsq < rmaxsq)  //Check distance for candidate i,j
-                        {
-                        //Calc Q dotproduct.
-                        std::complex<float> Qdot(0.0,0.0);
-                        for (unsigned int k = 0; k < (elements); ++k)  // loop over m
-                            {
-                            // Index here?
-                            Qdot += m_Qlmi_array.get()[(elements)*i+k] * conj(m_Qlmi_array.get()[(elements)*j+k]);
-                            }
-                        m_qldot_ij.push_back(Qdot);  // Only i < j, other pairs not added.
-                        //Check if we're bonded via the threshold criterion
-                        if( real(Qdot) > m_Qthreshold)
-                            {
-                            //Tick up counts of number of connections these particles have
-                            m_number_of_connections.get()[i]++;
-                            m_number_of_connections.get()[j]++;
-                            }
-                        }
-                    }
+                //Check if we're bonded via the threshold criterion
+                if (dot(vectors[bond], vectors[bond]) < rmaxsq && real(bond_qdot[bond]) > Qthreshold)
+                    num_connections++;
                 }
+            number_of_connections[i] = num_connections;
             }
-        }
-    }
+        });
 
+    // Only i < j, other pairs not added.
+    gatherPairs(nlist, Np, bond_qdot,
+        [=] (size_t bond) { return dot(vectors[bond], vectors[bond]) < rmaxsq; },
+        m_qldot_ij);
+    }
 
 //Computes the clusters for sol-liq order parameter by using the Sthreshold.
 // void SolLiq::computeClustersQS(const float3 *points, unsigned int Np)
@@ -386,75 +368,35 @@ void SolLiq::computeClustersQS(const vec3<float> *points, unsigned int Np)
         m_cluster_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
         }
 
-    float rmaxcluster_sq = m_rmax_cluster * m_rmax_cluster;
-    freud::cluster::DisjointSet dj(Np);
-
-    // for each point
-    for (unsigned int i = 0; i < Np; i++)
+    const float rmaxcluster_sq = m_rmax_cluster * m_rmax_cluster;
+    const unsigned int Sthreshold = m_Sthreshold;
+    const locality::NeighborList *nlist = m_lc.getNlist();
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    const unsigned int *number_of_connections = m_number_of_connections.get();
+    freud::cluster::ConcurrentDisjointSet dj(Np);
+    freud::cluster::ConcurrentDisjointSet *l_dj = &dj;
+
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
         {
-        // get the cell the point is in
-        // float3 p = points[i];
-        vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
-
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        for (size_t i = r.begin(); i != r.end(); i++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            if (number_of_connections[i] < Sthreshold)
+                continue;
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
                 {
-                if (i != j)
-                    {
-                    // compute r between the two particles
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
-                    if (rsq < rmaxcluster_sq && rsq > 1e-6)  //Check distance for candidate i,j
-                        {
-                        if ( (m_number_of_connections.get()[i] >= m_Sthreshold) && (m_number_of_connections.get()[j] >= m_Sthreshold) )
-                            {
-                            // merge the two sets using the disjoint set
-                            uint32_t a = dj.find(i);
-                            uint32_t b = dj.find(j);
-                            if (a != b)
-                                dj.merge(a,b);
-                            }
-                        }
-                    }
+                // merging is symmetric, so each pair is merged from its smaller index only
+                unsigned int j = index_j[bond];
+                float rsq = dot(vectors[bond], vectors[bond]);
+                if (i < j && rsq < rmaxcluster_sq && rsq > 1e-6 && number_of_connections[j] >= Sthreshold)
+                    l_dj->unite(i, j);
                 }
             }
-        }
+        });
 
-    // done looping over points. All clusters are now determined. Renumber them from zero to num_clusters-1.
-    map<uint32_t, uint32_t> label_map;
-
-    // go over every point
-    uint32_t cur_set = 0;
-    for (uint32_t i = 0; i < Np; i++)
-        {
-        uint32_t s = dj.find(i);
-
-        // insert it into the mapping if we haven't seen this one yet
-        if (label_map.count(s) == 0)
-            {
-            label_map[s] = cur_set;
-            cur_set++;
-            }
-
-        // label this point in cluster_idx
-        m_cluster_idx.get()[i] = label_map[s];
-        }
-
-    // cur_set is now the number of clusters
-    m_num_clusters = cur_set;
+    // All clusters are now determined. Renumber them from zero to num_clusters-1.
+    m_num_clusters = dj.relabel(m_cluster_idx.get());
     }
 
 unsigned int SolLiq::getLargestClusterSize()
@@ -510,190 +452,130 @@ std::vector<unsigned int> SolLiq::getClusterSizes()
 // void SolLiq::computeListOfSolidLikeNeighbors(const float3 *points,
 //                               unsigned int Np, vector< vector<unsigned int> > &SolidlikeNeighborlist)
 void SolLiq::computeListOfSolidLikeNeighbors(const vec3<float> *points,
-                              unsigned int Np, vector< vector<unsigned int> > &SolidlikeNeighborlist)
+                              unsigned int Np, SolidLikeNeighbors &SolidlikeNeighborlist)
     {
-    m_qldot_ij.clear();     //Stores all the q dot products between all particles i,j
-
-    //resize
-    SolidlikeNeighborlist.resize(Np);
-
-    // reallocate the cluster_idx array if the size doesn't match the last one
-
     //These probably don't need allocation each time.
-    m_cluster_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
     m_number_of_connections = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
-    memset((void*)m_number_of_connections.get(), 0, sizeof(unsigned int)*Np);
 
-    float rmaxsq = m_rmax * m_rmax;
+    computeBondQdot(Np, true);
 
-    // for each point
-    for (unsigned int i = 0; i < Np; i++)
-        {
-        // get the cell the point is in
-        // float3 p = points[i];
-        vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
+    const locality::NeighborList *nlist = m_lc.getNlist();
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    const float rmaxsq = m_rmax * m_rmax;
+    const float Qthreshold = m_Qthreshold;
+    const std::complex<float> *bond_qdot = m_bond_qdot.size() ? &m_bond_qdot[0] : NULL;
+    unsigned int *number_of_connections = m_number_of_connections.get();
 
-        //Empty list
-        SolidlikeNeighborlist[i].resize(0);
+    auto in_shell = [=] (size_t bond)
+        {
+        float rsq = dot(vectors[bond], vectors[bond]);
+        return rsq < rmaxsq && rsq > 1e-6;
+        };
+    //Check if we're bonded via the threshold criterion
+    auto is_solid_like = [=] (size_t bond)
+        {
+        return in_shell(bond) && real(bond_qdot[bond]) > Qthreshold;
+        };
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+    // the neighbors are counted, then each particle fills and sorts its range of one array, so that
+    // computeClustersSharedNeighbors can intersect them
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
-                {
-                if (i != j)
-                    {
-                    // compute r between the two particles
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
-
-                    if (rsq < rmaxsq && rsq > 1e-6)  //Check distance for candidate i,j
-                        {
-                        //Calc Q dotproduct.
-                        std::complex<float> Qdot(0.0,0.0);
-                        std::complex<float> Qlminorm(0.0,0.0);//qlmi norm sq
-                        std::complex<float> Qlmjnorm(0.0,0.0);
-                        for (unsigned int k = 0; k < (2*m_l+1); ++k)  // loop over m
-                            {
-                            //Symmmetry - Could compute Qdot *twice* as fast! (I.e. m=-l and m=+l equivalent so some of these calcs redundant)
-                            //std::complex<float> temp =  m_Qlmi_array[(2*m_l+1)*i+k] * conj(m_Qlmi_array[(2*m_l+1)*j+k]);
-                            //printf("For component k=%d, real=%f, imag=%f\n",k,real(temp),imag(temp));
-                            Qdot += m_Qlmi_array.get()[(2*m_l+1)*i+k] * conj(m_Qlmi_array.get()[(2*m_l+1)*j+k]);
-                            Qlminorm += m_Qlmi_array.get()[(2*m_l+1)*i+k]*conj(m_Qlmi_array.get()[(2*m_l+1)*i+k]);
-                            Qlmjnorm += m_Qlmi_array.get()[(2*m_l+1)*j+k]*conj(m_Qlmi_array.get()[(2*m_l+1)*j+k]);
-                            }
-                        Qlminorm = sqrt(Qlminorm);
-                        Qlmjnorm = sqrt(Qlmjnorm);
-                        Qdot = Qdot/(Qlminorm*Qlmjnorm);
-
-                        if(i < j)
-                            {
-                            m_qldot_ij.push_back(Qdot);
-                            }
-                        //Check if we're bonded via the threshold criterion
-                        if( real(Qdot) > m_Qthreshold)
-                            {
-                            m_number_of_connections.get()[i]++;
-                            SolidlikeNeighborlist[i].push_back(j);
-                            }
-                        }
-                    }
-                }
+            unsigned int count = 0;
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                count += is_solid_like(bond);
+            number_of_connections[i] = count;
             }
-        }
+        });
+    SolidLikeNeighbors& neighbors = SolidlikeNeighborlist;
+    neighbors.start.resize(Np + 1);
+    neighbors.start[0] = 0;
+    for (unsigned int i = 0; i < Np; i++)
+        neighbors.start[i+1] = neighbors.start[i] + number_of_connections[i];
+    neighbors.index.resize(neighbors.start[Np]);
+    neighbors.base.resize(Np);
+    neighbors.mask.resize(Np);
+    const size_t *start = neighbors.start.data();
+    unsigned int *index = neighbors.index.data();
+    unsigned int *base = neighbors.base.data();
+    uint64_t *mask = neighbors.mask.data();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            unsigned int *first = index + start[i];
+            unsigned int *last = first;
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                if (is_solid_like(bond))
+                    *last++ = index_j[bond];
+            std::sort(first, last);
+
+            // the bitset of the neighbors, when they fit in 64 indices
+            base[i] = (first != last) ? *first : 0;
+            mask[i] = 0;
+            if (first != last && last[-1] - *first < 64)
+                for (const unsigned int *k = first; k != last; k++)
+                    mask[i] |= uint64_t(1) << (*k - *first);
+            }
+        });
+
+    gatherPairs(nlist, Np, bond_qdot, in_shell, m_qldot_ij);
     }
 
 // void SolLiq::computeClustersSharedNeighbors(const float3 *points,
 //     unsigned int Np, const vector< vector<unsigned int> > &SolidlikeNeighborlist)
 void SolLiq::computeClustersSharedNeighbors(const vec3<float> *points,
-    unsigned int Np, const vector< vector<unsigned int> > &SolidlikeNeighborlist)
+    unsigned int Np, const SolidLikeNeighbors &SolidlikeNeighborlist)
     {
-
     m_cluster_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
-    m_number_of_shared_connections.clear();  //Reset.
 
-    float rmaxcluster_sq = m_rmax_cluster * m_rmax_cluster;
-    freud::cluster::DisjointSet dj(Np);
+    const float rmaxcluster_sq = m_rmax_cluster * m_rmax_cluster;
+    const unsigned int Sthreshold = m_Sthreshold;
+    const locality::NeighborList *nlist = m_lc.getNlist();
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    const SolidLikeNeighbors *l_neighborlist = &SolidlikeNeighborlist;
+    freud::cluster::ConcurrentDisjointSet dj(Np);
+    freud::cluster::ConcurrentDisjointSet *l_dj = &dj;
 
-    // for each point
-    for (unsigned int i = 0; i < Np; i++)
+    auto in_shell = [=] (size_t bond)
         {
-        // get the cell the point is in
-        // float3 p = points[i];
-        vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
-
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        float rsq = dot(vectors[bond], vectors[bond]);
+        return rsq < rmaxcluster_sq && rsq > 1e-6;
+        };
+
+    // number of solid-like neighbors shared by the two particles of each bond i < j
+    std::vector<unsigned int> bond_shared(nlist->getNumBonds(), 0);
+    unsigned int *l_bond_shared = bond_shared.size() ? &bond_shared[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
                 {
-                if (i < j)
-                    {
-                    // compute r between the two particles
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
-                    if (rsq < rmaxcluster_sq && rsq > 1e-6)  //Check distance for candidate i,j
-                        {
-                        unsigned int num_shared = 0;
-                        map<unsigned int, unsigned int> sharedneighbors;
-                        for(unsigned int k = 0; k < SolidlikeNeighborlist[i].size(); k++)
-                            {
-                            sharedneighbors[SolidlikeNeighborlist[i][k]]++;
-                            }
-                        for(unsigned int k = 0; k < SolidlikeNeighborlist[j].size(); k++)
-                            {
-                            sharedneighbors[SolidlikeNeighborlist[j][k]]++;
-                            }
-                        //Scan through counting number of shared neighbors in the map
-                        std::map<unsigned int, unsigned int>::const_iterator it;
-                        for(it = sharedneighbors.begin(); it != sharedneighbors.end(); ++it)
-                            {
-                            if((*it).second>=2)
-                                {
-                                num_shared++;
-                                }
-                            }
-                        m_number_of_shared_connections.push_back(num_shared);
-                        if(num_shared > m_Sthreshold)
-                            {
-                            // merge the two sets using the disjoint set
-                            uint32_t a = dj.find(i);
-                            uint32_t b = dj.find(j);
-                            if (a != b)
-                                dj.merge(a,b);
-                            }
-                        }
-                    }
+                unsigned int j = index_j[bond];
+                if (!(i < j && in_shell(bond)))
+                    continue;
+
+                // by popcount of the bitsets when both have one, or by a merge of the sorted lists
+                unsigned int num_shared = l_neighborlist->countShared(i, j);
+                l_bond_shared[bond] = num_shared;
+                if (num_shared > Sthreshold)
+                    l_dj->unite(i, j);
                 }
             }
-        }
-
-    // done looping over points. All clusters are now determined. Renumber them from zero to num_clusters-1.
-    map<uint32_t, uint32_t> label_map;
-
-    // go over every point
-    uint32_t cur_set = 0;
-    for (uint32_t i = 0; i < Np; i++)
-        {
-        uint32_t s = dj.find(i);
-
-        // insert it into the mapping if we haven't seen this one yet
-        if (label_map.count(s) == 0)
-            {
-            label_map[s] = cur_set;
-            cur_set++;
-            }
+        });
 
-        // label this point in cluster_idx
-        m_cluster_idx.get()[i] = label_map[s];
-        }
+    gatherPairs(nlist, Np, l_bond_shared, in_shell, m_number_of_shared_connections);
 
-    // cur_set is now the number of clusters
-    m_num_clusters = cur_set;
+    // All clusters are now determined. Renumber them from zero to num_clusters-1.
+    m_num_clusters = dj.relabel(m_cluster_idx.get());
     }
 
 // void SolLiq::computePy(boost::python::numeric::array points)
@@ -4,6 +4,7 @@
 #ifndef _SOL_LIQ_H__
 #define _SOL_LIQ_H__
 
+#include <tbb/tbb.h>
 #include <memory>
 //#include <boost/math/special_functions/spherical_harmonic.hpp>
 
@@ -12,10 +13,11 @@
 
 #include <vector>
 #include <set>
+#include <stdint.h>
 
 #include "Cluster.h"
 #include "LinkCell.h"
-#include "../../extern/fsph/src/spherical_harmonics.hpp"
+#include "BondHarmonics.h"
 
 #include "box.h"
 #include <stdexcept>
@@ -27,6 +29,51 @@
 
 namespace freud { namespace order {
 
+//! The solid-like neighbors of every particle, as sorted ranges of one array
+/*! The neighbors of particle i are index[start[i], start[i+1]). When they span fewer than 64 indices, which is the
+    common case once the particles are ordered spatially (see locality::SpaceFillingCurve), they are also a bitset
+    mask[i] of the indices from base[i], and the neighbors two such particles share are counted with a shift, an and
+    and a popcount instead of a merge.
+*/
+struct SolidLikeNeighbors
+    {
+    std::vector<size_t> start;          //!< First neighbor of each particle in index
+    std::vector<unsigned int> index;    //!< Sorted neighbors of each particle
+    std::vector<unsigned int> base;     //!< Smallest neighbor of each particle
+    std::vector<uint64_t> mask;         //!< Bit k set if base + k is a neighbor, 0 when they span 64 or more indices
+
+    //! Count the neighbors shared by particles i and j
+    unsigned int countShared(unsigned int i, unsigned int j) const
+        {
+        if (mask[i] != 0 && mask[j] != 0)
+            {
+            // the bitsets are aligned on the larger base; the neighbors of the other are all below its base + 64
+            unsigned int lo = i, hi = j;
+            if (base[hi] < base[lo])
+                std::swap(lo, hi);
+            unsigned int shift = base[hi] - base[lo];
+            if (shift >= 64)
+                return 0;
+            return __builtin_popcountll((mask[lo] >> shift) & mask[hi]);
+            }
+
+        // both ranges are sorted: a branchless merge advances past the smaller element, or past both when equal
+        const unsigned int *a = index.data() + start[i];
+        const unsigned int *a_end = index.data() + start[i+1];
+        const unsigned int *b = index.data() + start[j];
+        const unsigned int *b_end = index.data() + start[j+1];
+        unsigned int num_shared = 0;
+        while (a != a_end && b != b_end)
+            {
+            unsigned int va = *a, vb = *b;
+            num_shared += (va == vb);
+            a += (va <= vb);
+            b += (vb <= va);
+            }
+        return num_shared;
+        }
+    };
+
 //! Computes dot products of qlm between particles and uses these for clustering
 /*!
 */
@@ -267,7 +314,11 @@ class SolLiq
         // void computeClustersQdot(const float3 *points,
         //                       unsigned int Np);
         void computeClustersQdot(const vec3<float> *points,
-                              unsigned int Np);
+                              unsigned int Np,
+                              bool normalize);
+
+        //! Computes the dot product of the Qlm of each bond within rmax, normalized or not
+        void computeBondQdot(unsigned int Np, bool normalize);
 
         //!Clusters particles based on values of Q_l dot product and solid-like neighbor thresholds
         // void computeClustersQS(const float3 *points,
@@ -279,18 +330,13 @@ class SolLiq
         // void computeListOfSolidLikeNeighbors(const float3 *points,
         //                       unsigned int Np, std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
         void computeListOfSolidLikeNeighbors(const vec3<float> *points,
-                              unsigned int Np, std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
+                              unsigned int Np, SolidLikeNeighbors &SolidlikeNeighborlist);
 
         //Alternate clustering method requiring same shared neighbors
         // void computeClustersSharedNeighbors(const float3 *points,
         //                       unsigned int Np, const std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
         void computeClustersSharedNeighbors(const vec3<float> *points,
-                              unsigned int Np, const std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
-
-        // void computeClustersQdotNoNorm(const float3 *points,
-        //                       unsigned int Np);
-        void computeClustersQdotNoNorm(const vec3<float> *points,
-                              unsigned int Np);
+                              unsigned int Np, const SolidLikeNeighbors &SolidlikeNeighborlist);
 
         box::Box m_box;      //!< Simulation box the particles belong in
         float m_rmax;               //!< Maximum cutoff radius at which to determine local environment
@@ -313,6 +359,8 @@ class SolLiq
         std::shared_ptr<unsigned int> m_number_of_connections;  //!< Number of connections for each particle with dot product above Qthreshold
         std::shared_ptr<unsigned int> m_number_of_neighbors;    //!< Number of neighbors for each particle (used for normalizing spherical harmonics);
         std::vector<unsigned int> m_number_of_shared_connections;  //!Stores number of shared neighbors for all ij pairs considered
+        std::vector< std::complex<float> > m_bond_qdot;     //!< Qlmi dot Qlmj of each bond of the neighbor list within rmax
+        BondHarmonics m_harmonics;                          //!< Spherical harmonics of the bonds, in the order of fsph
     };
 
 }; }; // end namespace freud::sol_liq
@@ -12,7 +12,8 @@ using namespace std;
 namespace freud { namespace order {
 
 SolLiqNear::SolLiqNear(const box::Box& box, float rmax, float Qthreshold, unsigned int Sthreshold, unsigned int l, unsigned int kn)
-    :m_box(box), m_rmax(rmax), m_rmax_cluster(rmax), m_Qthreshold(Qthreshold), m_Sthreshold(Sthreshold), m_l(l), m_k(kn)
+    :m_box(box), m_rmax(rmax), m_rmax_cluster(rmax), m_Qthreshold(Qthreshold), m_Sthreshold(Sthreshold), m_l(l), m_k(kn),
+     m_harmonics(l, true)
     {
     m_Np = 0;
     if (m_rmax < 0.0f)
@@ -33,25 +34,13 @@ SolLiqNear::~SolLiqNear()
     delete m_nn;
     }
 
-// Calculating Ylm using fsph module
+// Calculating Ylm using the shared harmonics evaluator
 void SolLiqNear::Ylm(const float theta, const float phi, std::vector<std::complex<float> > &Y)
     {
     if (Y.size() != 2*m_l+1)
         Y.resize(2*m_l+1);
 
-    fsph::PointSPHEvaluator<float> sph_eval(m_l);
-
-    unsigned int j(0);
-    // old definition in compute (theta: 0...pi, phi: 0...2pi)
-    // in fsph, the definition is flipped
-    sph_eval.compute(theta, phi);
-
-    for(typename fsph::PointSPHEvaluator<float>::iterator iter(sph_eval.begin_l(m_l, 0, true));
-        iter != sph_eval.end(); ++iter)
-        {
-        Y[j] = *iter;
-        ++j;
-        }
+    m_harmonics.evaluate(theta, phi, &Y[0]);
     }
 
 /*
@@ -193,18 +182,18 @@ void SolLiqNear::computeClustersQ(const vec3<float> *points, unsigned int Np)
     memset((void*)m_number_of_neighbors.get(), 0, sizeof(unsigned int)*Np);
 
 
-    std::vector<std::complex<float> > Y;  Y.resize(2*m_l+1);
+    // the bonds of each particle within rmax, evaluated in blocks
+    BatchSphericalHarmonics sph(m_l);
+    vec3<float> block[BatchSphericalHarmonics::block_size];
+    const unsigned int elements = 2*m_l+1;
 
     for (unsigned int i = 0; i<Np; i++)
         {
-        //get cell point is in
-        // float3 ref = points[i];
         vec3<float> ref = points[i];
         std::shared_ptr<unsigned int> neighbors = m_nn->getNeighbors(i);
-        //unsigned int ref_cell = m_lc.getCell(ref);
+        complex<float> *Qlm_i = m_Qlmi_array.get() + elements*i;
+        unsigned int n_block = 0;
 
-        //loop over neighboring cells
-        //const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
         for (unsigned int neigh_idx = 0; neigh_idx < m_k; neigh_idx++)
             {
             unsigned int j = neighbors.get()[neigh_idx];
@@ -214,31 +203,20 @@ void SolLiqNear::computeClustersQ(const vec3<float> *points, unsigned int Np)
 
             if (rsq < rmaxsq && i != j)
                 {
-                float phi = atan2(delta.y,delta.x);      //0..2Pi
-                float theta = acos(delta.z / sqrt(rsq)); //0..Pi
-
-                /*if (m_l == 6)
-                    SolLiqNear::Y6m(theta,phi,Y);
-                else if (m_l == 4)
-                    SolLiqNear::Y4m(theta,phi,Y);
-                else
-                */
-                SolLiqNear::Ylm(theta,phi,Y);
-
-                for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                block[n_block++] = delta;
+                if (n_block == BatchSphericalHarmonics::block_size)
                     {
-                    m_Qlmi_array.get()[(2*m_l+1)*i+k]+=Y[k];
-                    m_number_of_neighbors.get()[i]++;
+                    m_harmonics.accumulate(sph, block, n_block, Qlm_i);
+                    n_block = 0;
                     }
-                }//End loop over a particular neighbor cell
-            }  //End loops of neighboring cells
-        //if (m_number_of_neighbors[i] != 0)
-        //    {
-        //    for(unsigned int k = 0; k < (2*m_l+1); ++k)
-        //        {
-        //        m_Qlmi_array[(2*m_l+1)*i+k]/=m_number_of_neighbors[i];
-        //        }
-        //    }
+                // counted once per m, as it always has been
+                m_number_of_neighbors.get()[i] += elements;
+                }
+            }
+        if (n_block)
+            {
+            m_harmonics.accumulate(sph, block, n_block, Qlm_i);
+            }
         } //Ends loop over particles i for Qlmi calcs}
 
     }
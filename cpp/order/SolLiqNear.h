@@ -17,7 +17,7 @@
 
 #include "Cluster.h"
 #include "NearestNeighbors.h"
-#include "../../extern/fsph/src/spherical_harmonics.hpp"
+#include "BondHarmonics.h"
 
 #include "box.h"
 #include <stdexcept>
@@ -310,6 +310,7 @@ class SolLiqNear
         std::shared_ptr<unsigned int> m_number_of_connections;  //!< Number of connections for each particle with dot product above Qthreshold
         std::shared_ptr<unsigned int> m_number_of_neighbors;    //!< Number of neighbors for each particle (used for normalizing spherical harmonics);
         std::vector<unsigned int> m_number_of_shared_connections;  //!Stores number of shared neighbors for all ij pairs considered
+        BondHarmonics m_harmonics;                          //!< Spherical harmonics of the bonds, in the order of fsph
     };
 
 }; }; // end namespace freud::sol_liq_near
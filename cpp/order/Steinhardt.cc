@@ -0,0 +1,215 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "Steinhardt.h"
+#include "Annotation.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file Steinhardt.cc
+    \brief Compute the Ql, averaged Ql and Wl of several l per particle in one pass
+*/
+
+namespace freud { namespace order {
+
+Steinhardt::Steinhardt(const box::Box& box, float rmax, const std::vector<unsigned int>& l_values, float rmin)
+    : m_box(box), m_rmax(rmax), m_rmin(rmin), m_lc(box, rmax), m_l_values(l_values), m_lmax(0), m_num_lm(0),
+      m_normalizeWl(false), m_Np(0)
+    {
+    if (m_rmax < 0.0f or m_rmin < 0.0f)
+        throw invalid_argument("rmin and rmax must be positive!");
+    if (m_rmin >= m_rmax)
+        throw invalid_argument("rmin should be smaller than rmax!");
+    if (m_l_values.size() == 0)
+        throw invalid_argument("at least one l value is needed");
+
+    for (unsigned int li = 0; li < m_l_values.size(); li++)
+        {
+        unsigned int l = m_l_values[li];
+        if (l < 2)
+            throw invalid_argument("l must be two or greater!");
+        m_lmax = std::max(m_lmax, l);
+        m_lm_start.push_back(m_num_lm);
+        m_num_lm += 2*l + 1;
+        // the coefficients are tabulated for the even l from 2 to 20
+        m_wigner3j.push_back(&getWigner3jTable(l));
+        }
+    }
+
+//! \internal
+//! Compute Ql and Wl of every l from the Qlm of a particle
+void Steinhardt::reduceQlm(const complex<float> *Qlm, float *Ql, complex<float> *Wl) const
+    {
+    for (unsigned int li = 0; li < m_l_values.size(); li++)
+        {
+        const unsigned int l = m_l_values[li];
+        const complex<float> *Q = Qlm + m_lm_start[li];
+        float sumsq = 0;
+        for (unsigned int k = 0; k < 2*l+1; ++k)
+            sumsq += norm(Q[k]);
+        Ql[li] = sqrt(sumsq*float(4*M_PI/(2*l+1)));
+
+        // sum over m1 + m2 + m3 = 0
+        complex<float> W = m_wigner3j[li]->contract(Q);
+        if (m_normalizeWl && m_wigner3j[li]->size())
+            W /= sumsq*sqrt(sumsq);
+        Wl[li] = W;
+        }
+    }
+
+//! \internal
+//! Add the harmonics of every l, summed over a block of bonds, to the Qlm of a particle
+void Steinhardt::accumulateBlock(BatchSphericalHarmonics& sph, const vec3<float> *bonds, unsigned int n,
+                                 complex<float> *Qlm) const
+    {
+    sph.compute(bonds, n);
+    for (unsigned int li = 0; li < m_l_values.size(); li++)
+        {
+        const int l = m_l_values[li];
+        complex<float> *Q = Qlm + m_lm_start[li] + l;
+        for (int m = -l; m <= l; m++)
+            Q[m] += sph.sum(l, m);
+        }
+    }
+
+void Steinhardt::compute(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
+    {
+    util::ScopedRange annotation("freud::Steinhardt::compute");
+    m_Np = Np;
+
+    if (nlist != NULL)
+        nlist->validate(m_Np, m_Np);
+    else
+        {
+        m_lc.computeNlist(m_box, points, m_Np, points, m_Np, true, true);
+        nlist = m_lc.getNlist();
+        }
+
+    const unsigned int num_l = m_l_values.size();
+    const unsigned int num_lm = m_num_lm;
+    m_Qlmi = std::shared_ptr<complex<float> >(new complex<float>[num_lm*m_Np], std::default_delete<complex<float>[]>());
+    m_AveQlmi = std::shared_ptr<complex<float> >(new complex<float>[num_lm*m_Np], std::default_delete<complex<float>[]>());
+    m_Qli = std::shared_ptr<float>(new float[num_l*m_Np], std::default_delete<float[]>());
+    m_AveQli = std::shared_ptr<float>(new float[num_l*m_Np], std::default_delete<float[]>());
+    m_Wli = std::shared_ptr<complex<float> >(new complex<float>[num_l*m_Np], std::default_delete<complex<float>[]>());
+    m_AveWli = std::shared_ptr<complex<float> >(new complex<float>[num_l*m_Np], std::default_delete<complex<float>[]>());
+    memset((void*)m_Qlmi.get(), 0, sizeof(complex<float>)*num_lm*m_Np);
+    memset((void*)m_AveQlmi.get(), 0, sizeof(complex<float>)*num_lm*m_Np);
+
+    float rminsq = m_rmin * m_rmin;
+    float rmaxsq = m_rmax * m_rmax;
+    std::vector<unsigned char> in_shell(nlist->getNumBonds(), 0);
+    unsigned char *l_in_shell = in_shell.size() ? &in_shell[0] : NULL;
+    std::vector<unsigned int> num_neighbors(m_Np);
+    unsigned int *l_num_neighbors = m_Np ? &num_neighbors[0] : NULL;
+    const unsigned int *index_j = nlist->getIndexJ().get();
+    const vec3<float> *vectors = nlist->getVectors().get();
+    complex<float> *Qlmi = m_Qlmi.get();
+    float *Qli = m_Qli.get();
+    complex<float> *Wli = m_Wli.get();
+
+    // sum the harmonics of every l over the neighbors within the shell
+    parallel_for(blocked_range<size_t>(0, m_Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        // all the l up to lmax in one evaluation of each block of bonds
+        BatchSphericalHarmonics sph(m_lmax);
+        vec3<float> block[BatchSphericalHarmonics::block_size];
+
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            complex<float> *Qlm_i = Qlmi + num_lm*i;
+            unsigned int neighborcount = 0;
+            unsigned int n_block = 0;
+
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                {
+                unsigned int j = index_j[bond];
+                if (i == j)
+                    continue;
+                // rij = rj - ri, from i pointing to j.
+                vec3<float> delta = (vectors != NULL) ? vectors[bond] : m_box.wrap(points[j] - points[i]);
+                float rsq = dot(delta, delta);
+
+                if (rsq < rmaxsq and rsq > rminsq)
+                    {
+                    block[n_block++] = delta;
+                    if (n_block == BatchSphericalHarmonics::block_size)
+                        {
+                        accumulateBlock(sph, block, n_block, Qlm_i);
+                        n_block = 0;
+                        }
+                    l_in_shell[bond] = 1;
+                    neighborcount++;
+                    }
+                }
+            if (n_block)
+                accumulateBlock(sph, block, n_block, Qlm_i);
+
+            for (unsigned int k = 0; k < num_lm; ++k)
+                Qlm_i[k] /= neighborcount;
+            l_num_neighbors[i] = neighborcount;
+            reduceQlm(Qlm_i, Qli + num_l*i, Wli + num_l*i);
+            }
+        });
+
+    // gather the neighbors within the shell of each particle
+    std::vector<size_t> neighbor_start(m_Np + 1, 0);
+    for (unsigned int i = 0; i < m_Np; i++)
+        neighbor_start[i+1] = neighbor_start[i] + num_neighbors[i];
+    std::vector<unsigned int> neighbors(neighbor_start[m_Np]);
+    const size_t *l_neighbor_start = &neighbor_start[0];
+    unsigned int *l_neighbors = neighbors.size() ? &neighbors[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, m_Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            size_t n = l_neighbor_start[i];
+            for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                if (l_in_shell[bond])
+                    l_neighbors[n++] = index_j[bond];
+            }
+        });
+
+    // average the Qlm of i and of the neighbors of its neighbors
+    complex<float> *AveQlmi = m_AveQlmi.get();
+    float *AveQli = m_AveQli.get();
+    complex<float> *AveWli = m_AveWli.get();
+    parallel_for(blocked_range<size_t>(0, m_Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            complex<float> *AveQlm_i = AveQlmi + num_lm*i;
+            unsigned int neighborcount = 1;
+
+            for (size_t n = l_neighbor_start[i]; n < l_neighbor_start[i+1]; n++)
+                {
+                unsigned int n1 = l_neighbors[n];
+                for (size_t n2 = l_neighbor_start[n1]; n2 < l_neighbor_start[n1+1]; n2++)
+                    {
+                    const complex<float> *Qlm_j = Qlmi + num_lm*l_neighbors[n2];
+                    for (unsigned int k = 0; k < num_lm; ++k)
+                        AveQlm_i[k] += Qlm_j[k];
+                    neighborcount++;
+                    }
+                }
+
+            const complex<float> *Qlm_i = Qlmi + num_lm*i;
+            for (unsigned int k = 0; k < num_lm; ++k)
+                {
+                AveQlm_i[k] += Qlm_i[k];
+                AveQlm_i[k] /= neighborcount;
+                }
+            reduceQlm(AveQlm_i, AveQli + num_l*i, AveWli + num_l*i);
+            }
+        });
+    }
+
+}; }; // end namespace freud::order
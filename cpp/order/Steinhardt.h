@@ -0,0 +1,157 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <complex>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "LinkCell.h"
+#include "NeighborList.h"
+#include "box.h"
+#include "wigner3j.h"
+#include "BatchSphericalHarmonics.h"
+
+#ifndef _STEINHARDT_H__
+#define _STEINHARDT_H__
+
+/*! \file Steinhardt.h
+    \brief Compute the Ql, averaged Ql and Wl of several l per particle in one pass
+*/
+
+namespace freud { namespace order {
+
+//! Compute the Steinhardt Ql and Wl order parameters for a list of l values at once
+/*! The spherical harmonics of each bond are evaluated once up to the largest l, and the Qlm of every requested l
+    are summed from them, so N values of l cost one traversal of the neighbors instead of N.
+
+    For each l and particle i this gives the same quantities as LocalQl and LocalWl:
+    - \f$ Q_l(i) = \sqrt{\frac{4\pi}{2l+1} \sum_{m=-l}^{l} |\overline{Q}_{lm}(i)|^2} \f$ from the neighbors within
+      rmin < r < rmax,
+    - the averaged \f$ \overline{Q}_l(i) \f$ from the Qlm of i and of the neighbors of its neighbors (Lechner 2008),
+    - \f$ W_l(i) = \sum_{m_1+m_2+m_3=0} \begin{pmatrix} l & l & l \\ m_1 & m_2 & m_3 \end{pmatrix}
+      \overline{Q}_{lm_1}(i) \overline{Q}_{lm_2}(i) \overline{Q}_{lm_3}(i) \f$, and the same of the averaged Qlm.
+
+    Negative m use their own harmonics rather than copies of the positive m, so Wl is rotationally invariant. The Wigner 3j coefficients are tabulated for the even l from 2 to 20; Wl is zero for other l.
+
+    The arrays of the results hold the values of the l of each particle contiguously, in the order l was given.
+    They are NaN for particles with no neighbors.
+*/
+class Steinhardt
+    {
+    public:
+        //! Constructor
+        /*! \param box simulation box
+            \param rmax cutoff radius of the neighbors
+            \param l_values spherical harmonic numbers l, each two or greater
+            \param rmin neighbors closer than rmin are ignored
+        */
+        Steinhardt(const box::Box& box, float rmax, const std::vector<unsigned int>& l_values, float rmin=0);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the simulation box size
+        void setBox(const box::Box newbox)
+            {
+            m_box = newbox;
+            m_lc = locality::LinkCell(m_box, m_rmax);
+            }
+
+        //! Get the number of l values
+        unsigned int getNumL() const
+            {
+            return m_l_values.size();
+            }
+
+        //! Get the l values
+        const std::vector<unsigned int>& getLValues() const
+            {
+            return m_l_values;
+            }
+
+        //! Compute Ql, the averaged Ql and Wl of every l
+        /*! If \a nlist is given, its bonds are used instead of building the internal cell list
+        */
+        void compute(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist=NULL);
+
+        //! Get Ql for each particle and l
+        std::shared_ptr<float> getQl()
+            {
+            return m_Qli;
+            }
+
+        //! Get the Ql averaged over the second shell for each particle and l
+        std::shared_ptr<float> getAveQl()
+            {
+            return m_AveQli;
+            }
+
+        //! Get Wl for each particle and l
+        std::shared_ptr< std::complex<float> > getWl()
+            {
+            return m_Wli;
+            }
+
+        //! Get the Wl of the averaged Qlm for each particle and l
+        std::shared_ptr< std::complex<float> > getAveWl()
+            {
+            return m_AveWli;
+            }
+
+        //! Divide Wl by (sum_m |Qlm|^2)^(3/2)
+        void enableNormalization()
+            {
+            m_normalizeWl = true;
+            }
+
+        //! Report Wl without normalization
+        void disableNormalization()
+            {
+            m_normalizeWl = false;
+            }
+
+        unsigned int getNP()
+            {
+            return m_Np;
+            }
+
+    private:
+        //! \internal
+        //! Compute Ql and Wl of every l from the Qlm of a particle
+        void reduceQlm(const std::complex<float> *Qlm, float *Ql, std::complex<float> *Wl) const;
+
+        //! \internal
+        //! Add the harmonics of every l, summed over a block of bonds, to the Qlm of a particle
+        void accumulateBlock(BatchSphericalHarmonics& sph, const vec3<float> *bonds, unsigned int n,
+                             std::complex<float> *Qlm) const;
+
+        box::Box m_box;                         //!< Simulation box the particles belong in
+        float m_rmax;                           //!< Maximum r at which to determine neighbors
+        float m_rmin;                           //!< Minimum r at which to determine neighbors
+        locality::LinkCell m_lc;                //!< LinkCell to bin particles for the computation
+        std::vector<unsigned int> m_l_values;   //!< Spherical harmonic l values
+        unsigned int m_lmax;                    //!< Largest l value
+        std::vector<unsigned int> m_lm_start;   //!< First Qlm of each l in the Qlm of a particle
+        unsigned int m_num_lm;                  //!< Number of Qlm of a particle, the sum of 2l + 1
+        std::vector<const Wigner3jTable*> m_wigner3j;   //!< Wigner 3j coefficients of each l, empty when not tabulated
+        bool m_normalizeWl;                     //!< Enable/disable normalization of Wl
+        unsigned int m_Np;                      //!< Last number of points computed
+
+        std::shared_ptr< std::complex<float> > m_Qlmi;      //!< Qlm of every l for each particle i
+        std::shared_ptr< std::complex<float> > m_AveQlmi;   //!< Qlm averaged over the second shell for each particle i
+        std::shared_ptr<float> m_Qli;                       //!< Ql of every l for each particle i
+        std::shared_ptr<float> m_AveQli;                    //!< Averaged Ql of every l for each particle i
+        std::shared_ptr< std::complex<float> > m_Wli;       //!< Wl of every l for each particle i
+        std::shared_ptr< std::complex<float> > m_AveWli;    //!< Averaged Wl of every l for each particle i
+    };
+
+}; }; // end namespace freud::order
+
+#endif // _STEINHARDT_H__
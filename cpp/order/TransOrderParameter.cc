@@ -20,6 +20,9 @@ TransOrderParameter::TransOrderParameter(float rmax, float k, unsigned int n)
     : m_box(box::Box()), m_rmax(rmax), m_k(k), m_Np(0)
     {
     m_nn = new locality::NearestNeighbors(m_rmax, n==0? (unsigned int) k: n);
+    // only the neighbor indices are used
+    m_nn->setStoreDistances(false);
+    m_nn->setStoreVectors(false);
     }
 
 TransOrderParameter::~TransOrderParameter()
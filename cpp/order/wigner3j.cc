@@ -4,6 +4,7 @@
 #include <iostream>
 #include "wigner3j.h"
 #include <vector>
+#include <algorithm>
 
 using namespace std;
 
@@ -88,3 +89,36 @@ vector<float> getWigner3j(unsigned int l)
     return vector<float> ();
 }
 
+Wigner3jTable::Wigner3jTable(unsigned int l)
+    {
+    if (l < 2 || l > 20 || l % 2 == 1)
+        return;
+    m_values = getWigner3j(l);
+    for (unsigned int u1 = 0; u1 < (2*l+1); ++u1)
+        {
+        for (unsigned int u2 = max(0, int(l)-int(u1)); u2 < (min(3*l+1-u1, 2*l+1)); ++u2)
+            {
+            m_u1.push_back(u1);
+            m_u2.push_back(u2);
+            m_u3.push_back(3*l-u1-u2);
+            }
+        }
+    }
+
+//! \internal
+//! Build the tables of l = 0..20
+static vector<Wigner3jTable> makeWigner3jTables()
+    {
+    vector<Wigner3jTable> tables;
+    for (unsigned int l = 0; l <= 20; l++)
+        tables.push_back(Wigner3jTable(l));
+    return tables;
+    }
+
+const Wigner3jTable& getWigner3jTable(unsigned int l)
+    {
+    // built on the first call, thread safe since C++11
+    static const vector<Wigner3jTable> tables = makeWigner3jTables();
+    static const Wigner3jTable empty(0);
+    return (l < tables.size()) ? tables[l] : empty;
+    }
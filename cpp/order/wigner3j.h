@@ -9,9 +9,45 @@
 #ifndef _WIGNER3J_H
 #define _WIGNER3J_H
 #include <vector>
+#include <complex>
 
 using namespace std;
 
 vector<float> getWigner3j(unsigned int l);
 
+//! Wigner 3j coefficients of one l with the (m1, m2, m3) of each, stored as u = m + l
+/*! The triples are those with m1 + m2 + m3 = 0, in the order of getWigner3j. The table is empty for the l that are
+    not tabulated.
+*/
+class Wigner3jTable
+    {
+    public:
+        //! Build the table of l
+        Wigner3jTable(unsigned int l);
+
+        //! Get the number of coefficients
+        unsigned int size() const
+            {
+            return m_values.size();
+            }
+
+        //! Sum the coefficients times Q[u1] Q[u2] Q[u3], for the 2l + 1 values Q of m = -l..l
+        std::complex<float> contract(const std::complex<float> *Q) const
+            {
+            std::complex<float> W(0);
+            for (unsigned int n = 0; n < m_values.size(); n++)
+                W += m_values[n]*Q[m_u1[n]]*Q[m_u2[n]]*Q[m_u3[n]];
+            return W;
+            }
+
+    private:
+        vector<float> m_values;         //!< Coefficients
+        vector<unsigned int> m_u1;      //!< m1 + l of each coefficient
+        vector<unsigned int> m_u2;      //!< m2 + l of each coefficient
+        vector<unsigned int> m_u3;      //!< m3 + l of each coefficient
+    };
+
+//! Get the table of l, built once for all the even l from 2 to 20 on the first call
+const Wigner3jTable& getWigner3jTable(unsigned int l);
+
 #endif
@@ -0,0 +1,145 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "FramePipeline.h"
+#include "tbb_config.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file FramePipeline.cc
+    \brief Stream the frames of a trajectory file through analyses, reading the next frames while they compute
+*/
+
+namespace freud { namespace parallel {
+
+#ifdef FREUD_ONETBB
+static const filter_mode FILTER_SERIAL = filter_mode::serial_in_order;
+static const filter_mode FILTER_PARALLEL = filter_mode::parallel;
+#else
+static const filter::mode FILTER_SERIAL = filter::serial_in_order;
+static const filter::mode FILTER_PARALLEL = filter::parallel;
+#endif
+
+//! \internal
+//! A frame going through the pipeline
+struct PipelineFrame
+    {
+    unsigned int index;     //!< Index of the frame in the file
+    vec3<float> *points;    //!< Buffer of the points
+    };
+
+FramePipeline::FramePipeline(const std::string& filename, unsigned int Np, size_t offset, unsigned int max_in_flight)
+    : m_Np(Np), m_offset(offset), m_max_in_flight(max_in_flight), m_num_frames(0), m_map(NULL), m_map_size(0),
+      m_stop(false)
+    {
+    if (Np == 0)
+        throw invalid_argument("FramePipeline needs at least one point per frame");
+    if (max_in_flight == 0)
+        throw invalid_argument("FramePipeline needs at least one frame in flight");
+
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw invalid_argument("Cannot open the trajectory file " + filename);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0)
+        {
+        close(fd);
+        throw invalid_argument("Cannot read the size of the trajectory file " + filename);
+        }
+    m_map_size = file_stat.st_size;
+    if (m_map_size < offset)
+        {
+        close(fd);
+        throw invalid_argument("The offset is past the end of the trajectory file " + filename);
+        }
+    m_num_frames = (unsigned int) ((m_map_size - offset)/(size_t(Np)*sizeof(vec3<float>)));
+
+    if (m_map_size > 0)
+        {
+        m_map = mmap(NULL, m_map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m_map == MAP_FAILED)
+            {
+            m_map = NULL;
+            close(fd);
+            throw invalid_argument("Cannot map the trajectory file " + filename);
+            }
+        // the frames are read in order: let the kernel read ahead
+        madvise(m_map, m_map_size, MADV_SEQUENTIAL);
+        }
+    close(fd);
+    }
+
+FramePipeline::~FramePipeline()
+    {
+    if (m_map != NULL)
+        munmap(m_map, m_map_size);
+    }
+
+void FramePipeline::addAnalysis(FrameAnalysis analysis, void *data)
+    {
+    m_analyses.push_back(std::make_pair(analysis, data));
+    }
+
+unsigned int FramePipeline::run(const box::Box& box, unsigned int start, unsigned int stop, unsigned int step)
+    {
+    if (step == 0)
+        throw invalid_argument("FramePipeline::run needs a positive step");
+    stop = std::min(stop, m_num_frames);
+    m_stop = false;
+
+    // frame k of the run goes to buffer k % max_in_flight: the first stage only reads a frame when one of the
+    // max_in_flight tokens is free, so the frame that used the buffer before has been through the last stage
+    const size_t frame_size = size_t(m_Np)*sizeof(vec3<float>);
+    vector< vec3<float> > buffers(size_t(m_max_in_flight)*m_Np);
+    const char *frames = static_cast<const char*>(m_map) + m_offset;
+    unsigned int next = start;
+    unsigned int num_read = 0;
+    unsigned int num_run = 0;
+
+    parallel_pipeline(m_max_in_flight,
+        make_filter<void, PipelineFrame>(FILTER_SERIAL,
+            [&] (flow_control& fc) -> PipelineFrame
+            {
+            PipelineFrame frame;
+            frame.index = next;
+            frame.points = NULL;
+            if (next >= stop || m_stop)
+                {
+                fc.stop();
+                return frame;
+                }
+            frame.points = &buffers[size_t(num_read % m_max_in_flight)*m_Np];
+            memcpy((void*) frame.points, frames + size_t(next)*frame_size, frame_size);
+            num_read++;
+            // the last frames may be fewer than step apart from stop
+            next = (stop - next > step) ? next + step : stop;
+            return frame;
+            }) &
+        make_filter<PipelineFrame, PipelineFrame>(FILTER_PARALLEL,
+            [&] (PipelineFrame frame) -> PipelineFrame
+            {
+            box.wrap(frame.points, m_Np);
+            return frame;
+            }) &
+        make_filter<PipelineFrame, void>(FILTER_SERIAL,
+            [&] (PipelineFrame frame)
+            {
+            if (m_stop)
+                return;
+            for (size_t i = 0; i < m_analyses.size(); i++)
+                m_analyses[i].first(m_analyses[i].second, box, frame.points, m_Np, frame.index);
+            num_run++;
+            }));
+    return num_run;
+    }
+
+}; }; // end namespace freud::parallel
@@ -0,0 +1,109 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <atomic>
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+
+#ifndef _FRAME_PIPELINE_H__
+#define _FRAME_PIPELINE_H__
+
+/*! \file FramePipeline.h
+    \brief Stream the frames of a trajectory file through analyses, reading the next frames while they compute
+*/
+
+namespace freud { namespace parallel {
+
+//! Function a FramePipeline gives each frame to
+/*! \param data Pointer given to FramePipeline::addAnalysis()
+    \param box Box of the frame
+    \param points Points of the frame, wrapped into the box; only valid during the call
+    \param Np Number of points
+    \param frame Index of the frame in the file
+*/
+typedef void (*FrameAnalysis)(void *data, const box::Box& box, const vec3<float> *points, unsigned int Np,
+                              unsigned int frame);
+
+//! Stream the frames of a binary trajectory file through a list of analyses
+/*! The file holds frames of Np points as consecutive float32 x, y, z triples, from a byte offset on, which is the
+    layout of a numpy array of shape (N_frames, Np, 3) saved to a .npy file; it is mapped in memory. run() passes
+    the frames through a tbb::parallel_pipeline of three stages: each frame is copied out of the mapping, which reads
+    it from disk, then wrapped into the box in parallel, then given to each analysis in turn, in the order of the
+    frames. Up to max_in_flight frames are in the pipeline at once, each in its own buffer, so the next frames are
+    read and prepared while the analyses compute, and the memory used is bounded.
+*/
+class FramePipeline
+    {
+    public:
+        //! Constructor
+        /*! \param filename Trajectory file
+            \param Np Number of points of each frame
+            \param offset Number of bytes before the first frame, such as the header of a .npy file
+            \param max_in_flight Largest number of frames in the pipeline at once
+        */
+        FramePipeline(const std::string& filename, unsigned int Np, size_t offset=0, unsigned int max_in_flight=4);
+
+        //! Destructor
+        ~FramePipeline();
+
+        //! Get the number of frames of the file
+        unsigned int getNumFrames() const
+            {
+            return m_num_frames;
+            }
+
+        //! Get the number of points of each frame
+        unsigned int getNP() const
+            {
+            return m_Np;
+            }
+
+        //! Get the largest number of frames in the pipeline at once
+        unsigned int getMaxInFlight() const
+            {
+            return m_max_in_flight;
+            }
+
+        //! Add an analysis, called as analysis(data, box, points, Np, frame) with each frame after the previous ones
+        void addAnalysis(FrameAnalysis analysis, void *data);
+
+        //! Remove all the analyses
+        void clearAnalyses()
+            {
+            m_analyses.clear();
+            }
+
+        //! Give the frames start, start + step, ... before stop to the analyses
+        /*! \returns Number of frames given to the analyses
+        */
+        unsigned int run(const box::Box& box, unsigned int start=0, unsigned int stop=UINT_MAX, unsigned int step=1);
+
+        //! Make run() give no more frames to the analyses, such as when called from an analysis
+        void stop()
+            {
+            m_stop = true;
+            }
+
+    private:
+        FramePipeline(const FramePipeline&);
+        FramePipeline& operator=(const FramePipeline&);
+
+        unsigned int m_Np;                  //!< Number of points of each frame
+        size_t m_offset;                    //!< Number of bytes before the first frame
+        unsigned int m_max_in_flight;       //!< Largest number of frames in the pipeline at once
+        unsigned int m_num_frames;          //!< Number of frames of the file
+        void *m_map;                        //!< Mapping of the file
+        size_t m_map_size;                  //!< Size of the file
+        std::atomic<bool> m_stop;           //!< true to stop the current run
+        std::vector< std::pair<FrameAnalysis, void*> > m_analyses;  //!< Analyses and their data
+    };
+
+}; }; // end namespace freud::parallel
+
+#endif // _FRAME_PIPELINE_H__
@@ -1,8 +1,12 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "tbb_config.h"
 
+using namespace std;
 using namespace tbb;
 
 /*! \file tbb_config.cc
@@ -11,17 +15,30 @@ using namespace tbb;
 
 namespace freud { namespace parallel {
 
+#ifdef FREUD_ONETBB
+global_control *gc = NULL;
+#else
 task_scheduler_init *ts = NULL;
+#endif
 
 /*! \param N Number of threads to use for TBB computations
 
     You do not need to call setTBBNumThreads. The default is to use the number of threads in the system. Use \a N=0 to
     set back to the default.
 
+    This limits every computation of the process; use a ThreadArena to confine only some of them.
+
     \note setTBBNumThreads should only be called from the main thread.
 */
 void setNumThreads(unsigned int N)
     {
+#ifdef FREUD_ONETBB
+    delete gc;
+    gc = NULL;
+
+    if (N != 0)
+        gc = new global_control(global_control::max_allowed_parallelism, N);
+#else
     task_scheduler_init *old_ts(ts);
 
     if (N == 0)
@@ -31,6 +48,56 @@ void setNumThreads(unsigned int N)
 
     // then recreate it
     ts = new task_scheduler_init(N);
+#endif
+    }
+
+std::vector<int> getNumaNodes()
+    {
+#ifdef FREUD_ONETBB
+    return info::numa_nodes();
+#else
+    return std::vector<int>(1, -1);
+#endif
+    }
+
+//! \internal
+//! Arena of N threads (0 for automatic) on numa_node (-1 for any)
+#ifdef FREUD_ONETBB
+static task_arena::constraints arenaConstraints(unsigned int N, int numa_node)
+    {
+    if (numa_node != -1)
+        {
+        const std::vector<int> nodes(info::numa_nodes());
+        if (std::find(nodes.begin(), nodes.end(), numa_node) == nodes.end())
+            throw invalid_argument("numa_node is not a NUMA node of the system");
+        }
+    task_arena::constraints constraints(numa_node);
+    if (N != 0)
+        constraints.set_max_concurrency(N);
+    return constraints;
+    }
+#else
+static int arenaConcurrency(unsigned int N, int numa_node)
+    {
+    if (numa_node != -1)
+        throw invalid_argument("NUMA nodes need oneTBB");
+    return (N == 0) ? int(task_arena::automatic) : int(N);
+    }
+#endif
+
+ThreadArena::ThreadArena(unsigned int N, int numa_node)
+#ifdef FREUD_ONETBB
+    : m_arena(arenaConstraints(N, numa_node)), m_numa_node(numa_node)
+#else
+    : m_arena(arenaConcurrency(N, numa_node)), m_numa_node(numa_node)
+#endif
+    {
+    m_arena.initialize();
+    }
+
+void ThreadArena::execute(void (*func)(void*), void *data)
+    {
+    m_arena.execute([=] () { func(data); });
     }
 
 }; }; // end namespace freud::parallel
@@ -3,6 +3,7 @@
 
 #include <tbb/tbb.h>
 #include <ostream>
+#include <vector>
 
 // work around nasty issue where python #defines isalpha, toupper, etc....
 #undef __APPLE__
@@ -12,6 +13,12 @@
 #ifndef _TBB_CONFIG_H__
 #define _TBB_CONFIG_H__
 
+// oneTBB replaces task_scheduler_init with global_control, can place arenas on NUMA nodes, and renames the filter
+// modes of parallel_pipeline
+#if TBB_INTERFACE_VERSION >= 12010
+#define FREUD_ONETBB
+#endif
+
 /*! \file tbb_config.h
     \brief Helper functions to configure tbb
 */
@@ -21,6 +28,51 @@ namespace freud { namespace parallel {
 //! Set the number of TBB threads
 void setNumThreads(unsigned int N);
 
+//! Get the ids of the NUMA nodes of the system, or just -1 when they are not known
+std::vector<int> getNumaNodes();
+
+//! A set of threads that computations can be confined to
+/*! Every parallel loop of the analyses run in execute() is run by the threads of this arena only, up to its number
+    of threads and on the cores of its NUMA node, if any, so that analyses run concurrently from several threads each
+    keep to their own cores and setNumThreads() does not need to change the limit of the whole process. The calling
+    thread takes part in the work of the arena.
+*/
+class ThreadArena
+    {
+    public:
+        //! Constructor
+        /*! \param N Number of threads of the arena, 0 for as many as the cores (of the NUMA node)
+            \param numa_node NUMA node to run on, as given by getNumaNodes(), or -1 for any
+        */
+        ThreadArena(unsigned int N=0, int numa_node=-1);
+
+        //! Get the number of threads of the arena
+        unsigned int getNumThreads()
+            {
+            return m_arena.max_concurrency();
+            }
+
+        //! Get the NUMA node of the arena, -1 for any
+        int getNumaNode() const
+            {
+            return m_numa_node;
+            }
+
+        //! Run f() in the arena, and wait for it to complete
+        template<class Func>
+        void execute(const Func& f)
+            {
+            m_arena.execute(f);
+            }
+
+        //! Run func(data) in the arena, and wait for it to complete
+        void execute(void (*func)(void*), void *data);
+
+    private:
+        tbb::task_arena m_arena;    //!< Arena of the threads
+        int m_numa_node;            //!< NUMA node of the arena, -1 for any
+    };
+
 } } // end namespace freud::parallel
 
 #endif
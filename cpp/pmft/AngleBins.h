@@ -0,0 +1,121 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+#include "HOOMDMath.h"
+#include "PMFTEngine.h"
+
+#ifndef _ANGLE_BINS_H__
+#define _ANGLE_BINS_H__
+
+/*! \file AngleBins.h
+    \brief Binning of the relative angles of the 2D PMFTs without atan2
+*/
+
+namespace freud { namespace pmft {
+
+//! Largest difference between fastAtan2 and atan2f, with a margin
+const float FAST_ATAN2_MAX_ERROR = 2e-6f;
+
+//! a if c, else b, by masking the bits of both so that the compilers do not branch on the data
+inline float selectFloat(bool c, float a, float b)
+    {
+    uint32_t mask = -uint32_t(c);
+    uint32_t ia, ib;
+    memcpy(&ia, &a, sizeof(float));
+    memcpy(&ib, &b, sizeof(float));
+    uint32_t ir = (ia & mask) | (ib & ~mask);
+    float r;
+    memcpy(&r, &ir, sizeof(float));
+    return r;
+    }
+
+//! atan2(y, x) with a polynomial, without branches so that it vectorizes
+/*! The ratio of the smaller to the larger of |x| and |y| is reduced to [-tan(pi/8), tan(pi/8)] with
+    atan(a) = pi/4 + atan((a - 1) / (a + 1)), which only takes one division, and atan is the polynomial of the Cephes
+    atanf on that interval. The octant is then restored from the signs and order of x and y.
+*/
+inline float fastAtan2(float y, float x)
+    {
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    bool swap = ay > ax;
+    float mx = selectFloat(swap, ay, ax);
+    float mn = selectFloat(swap, ax, ay);
+    bool reduce = mn > 0.41421356f*mx;
+    float num = selectFloat(reduce, mn - mx, mn);
+    float den = selectFloat(reduce, mn + mx, mx);
+    float a = num / selectFloat(den > 0.0f, den, 1.0f);
+    float z = a*a;
+    float r = (((8.05374449538e-2f*z - 1.38776856032e-1f)*z + 1.99777106478e-1f)*z - 3.33329491539e-1f)*z*a + a;
+    r += selectFloat(reduce, float(M_PI/4.0), 0.0f);
+    r = selectFloat(swap, float(M_PI/2.0) - r, r);
+    r = selectFloat(x < 0.0f, float(M_PI) - r, r);
+    return copysignf(r, y);
+    }
+
+//! Bins the angle orientation - atan2(y, x), wrapped into [0, 2 pi), into bins of width dt
+/*! bin() returns the bin exact() does, which is the one of the expression the PMFTs always evaluated, with atan2
+    and a double precision fmod. The angle is computed with fastAtan2 and wrapped with a floor instead, and the
+    exact expression is only evaluated when the result is closer to the edge of a bin than the error of the
+    approximation, rounding included: a fraction of about 1e-5 / dt of the pairs.
+*/
+class AngleBins
+    {
+    public:
+        //! Constructor
+        /*! \param dt width of the bins
+        */
+        explicit AngleBins(float dt) : m_dt_inv(1.0f / dt)
+            {
+            }
+
+        //! The bin of the angle, by the expression of the PMFTs
+        unsigned int exact(float orientation, float y, float x) const
+            {
+            float t = orientation - std::atan2(y, x);
+            // make sure that t is bounded between 0 and 2PI
+            t = std::fmod(t, 2*M_PI);
+            if (t < 0)
+                {
+                t += 2*M_PI;
+                }
+            return binIndex(floorf(t * m_dt_inv));
+            }
+
+        //! The bin of the angle, equal to exact()
+        unsigned int bin(float orientation, float y, float x) const
+            {
+            // orientations of more than about 1e5 turns would overflow the integer floors
+            if (!(fabsf(orientation) < 1e6f))
+                return exact(orientation, y, x);
+            const float two_pi = float(2.0*M_PI);
+            float t = orientation - fastAtan2(y, x);
+            t -= two_pi*float(floorToInt(t*float(0.5/M_PI)));
+            float u = t * m_dt_inv;
+            int bin = floorToInt(u);
+            float frac = u - float(bin);
+            // a few ulps of the angles add to the error of fastAtan2, in either expression
+            float margin = (FAST_ATAN2_MAX_ERROR + 1e-6f*(fabsf(orientation) + 8.0f)) * m_dt_inv;
+            if (frac <= margin || frac >= 1.0f - margin)
+                return exact(orientation, y, x);
+            return (unsigned int)bin;
+            }
+
+    private:
+        //! floorf(v) as an integer, without the library call floorf takes without SSE4.1
+        static int floorToInt(float v)
+            {
+            int i = int(v);
+            return i - (v < float(i));
+            }
+
+        float m_dt_inv;     //!< Inverse of the width of the bins
+    };
+
+}; }; // end namespace freud::pmft
+
+#endif // _ANGLE_BINS_H__
@@ -0,0 +1,354 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "PMFTEngine.h"
+#include "Checkpoint.h"
+#include "AlignedArray.h"
+
+#include <string.h>
+
+/*! \file PMFTEngine.cc
+    \brief Pair traversal and histograms shared by the PMFT classes
+*/
+
+namespace freud { namespace pmft {
+
+PMFTEngine::PMFTEngine(float r_cut, size_t n_bins)
+    : m_box(box::Box()), m_r_cut(r_cut), m_n_bins(n_bins), m_use_atomic(false), m_memory_limit(0),
+      m_frame_counter(0), m_n_ref(0), m_n_p(0), m_reduce(true), m_weighted(false),
+      m_partition_mode(locality::PARTITION_AUTO), m_cell_order(true)
+    {
+    // the bins of a large grid are mostly empty in every thread's histogram
+    m_storage = (n_bins >= util::SPARSE_HISTOGRAM_MIN_BINS) ? STORAGE_SPARSE : STORAGE_DENSE;
+
+    // the grids of the PMFTs can be large: zero them in parallel on aligned, huge page backed memory
+    m_pcf_array = util::makeLargeArray<float>(m_n_bins);
+    m_pmft_array = util::makeLargeArray<float>(m_n_bins);
+    m_bin_counts = util::makeLargeArray<util::BinCount>(m_n_bins);
+
+    m_lc = locality::SharedLinkCell(m_box, m_r_cut);
+    }
+
+PMFTEngine::~PMFTEngine()
+    {
+    util::freeLocalHistograms(m_local_bin_counts);
+    util::freeLocalHistograms(m_local_weighted_counts);
+    }
+
+void PMFTEngine::setUseGPU(bool use_gpu)
+    {
+    if (!use_gpu)
+        m_gpu.reset();
+    else if (!m_gpu)
+        m_gpu = std::shared_ptr<gpu::PairBinnerGPU>(new gpu::PairBinnerGPU());
+    }
+
+void PMFTEngine::reset()
+    {
+    for (tbb::enumerable_thread_specific<util::BinCount *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(util::BinCount)*m_n_bins);
+        }
+    for (tbb::enumerable_thread_specific<util::SparseHistogram<util::BinCount> >::iterator i = m_local_sparse_bin_counts.begin(); i != m_local_sparse_bin_counts.end(); ++i)
+        {
+        i->clear();
+        }
+    for (tbb::enumerable_thread_specific<double *>::iterator i = m_local_weighted_counts.begin(); i != m_local_weighted_counts.end(); ++i)
+        {
+        memset((void*)(*i), 0, sizeof(double)*m_n_bins);
+        }
+    for (tbb::enumerable_thread_specific<util::SparseHistogram<double> >::iterator i = m_local_sparse_weighted_counts.begin(); i != m_local_sparse_weighted_counts.end(); ++i)
+        {
+        i->clear();
+        }
+    if (m_atomic_bin_counts.isAllocated())
+        m_atomic_bin_counts.clear();
+    if (m_atomic_weighted_counts.isAllocated())
+        m_atomic_weighted_counts.clear();
+    m_weighted = false;
+    if (m_weighted_pcf_array)
+        memset((void*)m_weighted_pcf_array.get(), 0, sizeof(float)*m_n_bins);
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void PMFTEngine::saveState(const std::string& filename, const std::string& kind,
+                           const std::vector<float>& parameters)
+    {
+    if (m_weighted)
+        throw std::invalid_argument("The weighted counts of a PMFT are not saved to checkpoints");
+    std::vector<util::BinCount> counts(m_n_bins);
+    collectCounts(counts.data(), NULL);
+
+    util::CheckpointWriter writer(filename, kind);
+    writer.writeArray(parameters.data(), parameters.size());
+    writer.write(m_frame_counter);
+    writer.write(m_n_ref);
+    writer.write(m_n_p);
+    writer.writeBox(m_box);
+    writer.writeHistogram(counts.data(), m_n_bins);
+    writer.close();
+    }
+
+void PMFTEngine::loadState(const std::string& filename, const std::string& kind,
+                           const std::vector<float>& parameters, bool merge)
+    {
+    // read the whole file before changing anything
+    util::CheckpointReader reader(filename, kind);
+    reader.expectArray(parameters, "bins");
+    unsigned int frame_counter = reader.read<unsigned int>();
+    unsigned int n_ref = reader.read<unsigned int>();
+    unsigned int n_p = reader.read<unsigned int>();
+    box::Box box = reader.readBox();
+    std::vector<util::BinCount> counts;
+    reader.readHistogram(counts, m_n_bins);
+
+    if (!merge)
+        reset();
+    addState(counts.data(), frame_counter, box, n_ref, n_p);
+    }
+
+void PMFTEngine::merge(const PMFTEngine& other)
+    {
+    if (other.m_n_bins != m_n_bins)
+        throw std::invalid_argument("Only PMFTs of the same bins can be merged");
+    std::vector<util::BinCount> counts(m_n_bins);
+    if (other.m_weighted)
+        {
+        std::vector<double> weighted_counts(m_n_bins);
+        other.collectCounts(counts.data(), weighted_counts.data());
+        addCounts(NULL, weighted_counts.data());
+        m_weighted = true;
+        }
+    else
+        {
+        other.collectCounts(counts.data(), NULL);
+        }
+    addState(counts.data(), other.m_frame_counter, other.m_box, other.m_n_ref, other.m_n_p);
+    }
+
+std::shared_ptr<float> PMFTEngine::getWeightedPCF()
+    {
+    if (!m_weighted_pcf_array)
+        {
+        m_weighted_pcf_array = util::makeLargeArray<float>(m_n_bins);
+        m_weighted_counts = util::makeLargeArray<double>(m_n_bins);
+        }
+    return m_weighted_pcf_array;
+    }
+
+//! \internal
+//! The shared histogram when it is requested, else sparse histograms per thread for large grids and for dense ones
+//! over the memory limit
+PMFTEngine::Storage PMFTEngine::selectStorage(size_t bytes, unsigned int num_threads) const
+    {
+    if (m_use_atomic)
+        return STORAGE_ATOMIC;
+    if (m_n_bins >= util::SPARSE_HISTOGRAM_MIN_BINS ||
+        util::exceedsMemoryLimit(bytes, num_threads, m_memory_limit))
+        return STORAGE_SPARSE;
+    return STORAGE_DENSE;
+    }
+
+//! \internal
+/*! The counts are moved through the shared arrays of the reduced counts, which reduce() overwrites with the same
+    sums, so that the switch takes no more memory than one histogram of each kind per thread.
+*/
+void PMFTEngine::chooseStorage(bool weighted)
+    {
+    size_t bytes = m_n_bins*(sizeof(util::BinCount) + (weighted ? sizeof(double) : 0));
+    Storage storage = selectStorage(bytes, tbb::this_task_arena::max_concurrency());
+    if (storage == STORAGE_ATOMIC)
+        {
+        // allocated here rather than by the threads, as the histogram is shared
+        m_atomic_bin_counts.allocate(m_n_bins);
+        if (weighted)
+            m_atomic_weighted_counts.allocate(m_n_bins);
+        }
+    if (storage == m_storage)
+        return;
+    util::ScopedRange annotation("freud::PMFTEngine::chooseStorage");
+
+    util::BinCount *counts = m_bin_counts.get();
+    double *weighted_counts = NULL;
+    if (m_weighted)
+        {
+        getWeightedPCF();
+        weighted_counts = m_weighted_counts.get();
+        }
+    collectCounts(counts, weighted_counts);
+    if (m_storage == STORAGE_SPARSE)
+        {
+        m_local_sparse_bin_counts.clear();
+        m_local_sparse_weighted_counts.clear();
+        }
+    else if (m_storage == STORAGE_ATOMIC)
+        {
+        m_atomic_bin_counts.release();
+        m_atomic_weighted_counts.release();
+        }
+    else
+        {
+        util::freeLocalHistograms(m_local_bin_counts);
+        util::freeLocalHistograms(m_local_weighted_counts);
+        }
+
+    m_storage = storage;
+    if (m_frame_counter == 0)
+        return;
+    addCounts(counts, weighted_counts);
+    }
+
+PMFTBins PMFTEngine::localBins(bool weighted, util::AtomicHistogramBuffer<util::BinCount>& atomic_bins,
+                               util::AtomicHistogramBuffer<double>& atomic_weighted)
+    {
+    util::BinCount *dense_bins = NULL;
+    util::SparseHistogram<util::BinCount> *sparse_bins = NULL;
+    if (m_storage == STORAGE_SPARSE)
+        {
+        sparse_bins = &m_local_sparse_bin_counts.local();
+        }
+    else if (m_storage == STORAGE_DENSE)
+        {
+        bool exists;
+        m_local_bin_counts.local(exists);
+        if (! exists)
+            {
+            m_local_bin_counts.local() = util::allocateLocalHistogram<util::BinCount>(m_n_bins);
+            }
+        dense_bins = m_local_bin_counts.local();
+        }
+    double *dense_weighted = NULL;
+    util::SparseHistogram<double> *sparse_weighted = NULL;
+    if (weighted && m_storage == STORAGE_SPARSE)
+        {
+        sparse_weighted = &m_local_sparse_weighted_counts.local();
+        }
+    else if (weighted && m_storage == STORAGE_DENSE)
+        {
+        bool exists;
+        m_local_weighted_counts.local(exists);
+        if (! exists)
+            {
+            m_local_weighted_counts.local() = util::allocateLocalHistogram<double>(m_n_bins);
+            }
+        dense_weighted = m_local_weighted_counts.local();
+        }
+    const bool atomic = (m_storage == STORAGE_ATOMIC);
+    return PMFTBins(dense_bins, sparse_bins, dense_weighted, sparse_weighted, atomic ? &atomic_bins : NULL,
+                    (atomic && weighted) ? &atomic_weighted : NULL);
+    }
+
+void PMFTEngine::collectCounts(util::BinCount *counts, double *weighted_counts) const
+    {
+    if (m_storage == STORAGE_SPARSE)
+        {
+        util::reduceLocalHistograms(m_local_sparse_bin_counts, counts, m_n_bins);
+        if (weighted_counts != NULL)
+            util::reduceLocalHistograms(m_local_sparse_weighted_counts, weighted_counts, m_n_bins);
+        }
+    else if (m_storage == STORAGE_ATOMIC)
+        {
+        m_atomic_bin_counts.copyTo(counts, m_n_bins);
+        if (weighted_counts != NULL)
+            m_atomic_weighted_counts.copyTo(weighted_counts, m_n_bins);
+        }
+    else
+        {
+        util::reduceLocalHistograms(m_local_bin_counts, counts, m_n_bins);
+        if (weighted_counts != NULL)
+            util::reduceLocalHistograms(m_local_weighted_counts, weighted_counts, m_n_bins);
+        }
+    }
+
+void PMFTEngine::addCounts(const util::BinCount *counts, const double *weighted_counts)
+    {
+    if (m_storage == STORAGE_SPARSE)
+        {
+        if (counts != NULL)
+            util::addToLocalHistogram(m_local_sparse_bin_counts, counts, m_n_bins);
+        if (weighted_counts != NULL)
+            util::addToLocalHistogram(m_local_sparse_weighted_counts, weighted_counts, m_n_bins);
+        }
+    else if (m_storage == STORAGE_ATOMIC)
+        {
+        if (counts != NULL)
+            {
+            m_atomic_bin_counts.allocate(m_n_bins);
+            m_atomic_bin_counts.addFrom(counts);
+            }
+        if (weighted_counts != NULL)
+            {
+            m_atomic_weighted_counts.allocate(m_n_bins);
+            m_atomic_weighted_counts.addFrom(weighted_counts);
+            }
+        }
+    else
+        {
+        if (counts != NULL)
+            util::addToLocalHistogram(m_local_bin_counts, counts, m_n_bins);
+        if (weighted_counts != NULL)
+            util::addToLocalHistogram(m_local_weighted_counts, weighted_counts, m_n_bins);
+        }
+    }
+
+util::MemoryUsage PMFTEngine::getMemoryUsage() const
+    {
+    util::MemoryUsage usage;
+    usage.add("histogram", m_n_bins*(sizeof(util::BinCount) + 2*sizeof(float)) +
+                           (m_weighted_counts ? m_n_bins*(sizeof(double) + sizeof(float)) : 0) +
+                           m_atomic_bin_counts.getMemoryBytes() + m_atomic_weighted_counts.getMemoryBytes());
+    usage.add("local_histograms", util::localHistogramBytes(m_local_bin_counts, m_n_bins) +
+                                  util::localHistogramBytes(m_local_weighted_counts, m_n_bins) +
+                                  util::localHistogramBytes(m_local_sparse_bin_counts) +
+                                  util::localHistogramBytes(m_local_sparse_weighted_counts));
+    usage.add("cell_list", m_lc.isShared() ? 0 : m_lc->getMemoryBytes());
+    return usage;
+    }
+
+util::MemoryUsage PMFTEngine::estimateMemory(unsigned int N, unsigned int num_threads) const
+    {
+    util::MemoryUsage usage;
+    if (num_threads == 0)
+        num_threads = tbb::this_task_arena::max_concurrency();
+    size_t bytes = m_n_bins*(sizeof(util::BinCount) + (m_weighted ? sizeof(double) : 0));
+    Storage storage = selectStorage(bytes, num_threads);
+    usage.add("histogram", m_n_bins*(sizeof(util::BinCount) + 2*sizeof(float)) +
+                           (m_weighted ? m_n_bins*(sizeof(double) + sizeof(float)) : 0) +
+                           (storage == STORAGE_ATOMIC ? bytes : 0));
+    if (storage == STORAGE_ATOMIC)
+        {
+        usage.add("local_histograms", 0);
+        }
+    else if (storage == STORAGE_DENSE)
+        {
+        usage.add("local_histograms", size_t(num_threads)*bytes);
+        }
+    else
+        {
+        size_t sparse_bytes = util::localHistogramBytes(m_local_sparse_bin_counts) +
+                              util::localHistogramBytes(m_local_sparse_weighted_counts);
+        size_t num_histograms = m_local_sparse_bin_counts.size();
+        usage.add("local_histograms", num_histograms ? sparse_bytes / num_histograms * num_threads : 0);
+        }
+    usage.add("cell_list", m_lc.isShared() ? 0 : locality::LinkCell::estimateMemoryBytes(N, true));
+    return usage;
+    }
+
+//! \internal
+//! Add the histogram of frame_counter frames, the last of them of the box and numbers of points given
+void PMFTEngine::addState(const util::BinCount *counts, unsigned int frame_counter, const box::Box& box,
+                          unsigned int n_ref, unsigned int n_p)
+    {
+    if (m_frame_counter == 0)
+        {
+        m_box = box;
+        m_n_ref = n_ref;
+        m_n_p = n_p;
+        }
+    addCounts(counts, NULL);
+    m_frame_counter += frame_counter;
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::pmft
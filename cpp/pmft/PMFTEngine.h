@@ -0,0 +1,681 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "LinkCell.h"
+#include "SharedLinkCell.h"
+#include "WorkPartition.h"
+#include "box.h"
+#include "BinCount.h"
+#include "HistogramReduction.h"
+#include "SparseHistogram.h"
+#include "AtomicHistogram.h"
+#include "MemoryUsage.h"
+#include "Annotation.h"
+#include "PairBinnerGPU.h"
+
+#ifndef _PMFT_ENGINE_H__
+#define _PMFT_ENGINE_H__
+
+/*! \file PMFTEngine.h
+    \brief Pair traversal and histograms shared by the PMFT classes
+*/
+
+namespace freud { namespace pmft {
+
+//! Convert a floored bin coordinate to an index, negative coordinates becoming indices past the last bin
+inline unsigned int binIndex(float bin)
+    {
+    // fast float to int conversion with truncation
+    #ifdef __SSE2__
+    return _mm_cvtt_ss2si(_mm_load_ss(&bin));
+    #else
+    return (unsigned int)(int)(bin);
+    #endif
+    }
+
+//! Increment the bins of the histogram of the calling thread, dense or sparse, or of the shared histogram, and add
+//! the weight of the pair to its weighted counts when the frame is weighted
+class PMFTBins
+    {
+    public:
+        //! Constructor
+        /*! \param dense Dense histogram of the thread, or NULL
+            \param sparse Sparse histogram of the thread, used when dense is NULL
+            \param dense_weighted Dense weighted counts of the thread, or NULL
+            \param sparse_weighted Sparse weighted counts of the thread, or NULL
+            \param atomic Buffer of the task to the shared histogram, used when dense and sparse are NULL
+            \param atomic_weighted Buffer of the task to the shared weighted counts, or NULL
+        */
+        PMFTBins(util::BinCount *dense, util::SparseHistogram<util::BinCount> *sparse,
+                 double *dense_weighted=NULL, util::SparseHistogram<double> *sparse_weighted=NULL,
+                 util::AtomicHistogramBuffer<util::BinCount> *atomic=NULL,
+                 util::AtomicHistogramBuffer<double> *atomic_weighted=NULL)
+            : m_dense(dense), m_sparse(sparse), m_dense_weighted(dense_weighted), m_sparse_weighted(sparse_weighted),
+              m_atomic(atomic), m_atomic_weighted(atomic_weighted), m_weight(0.0)
+            {
+            }
+
+        //! Set the weight of the pair binned next
+        void setWeight(double weight)
+            {
+            m_weight = weight;
+            }
+
+        //! Add one to a bin
+        void operator()(size_t bin) const
+            {
+            if (m_dense != NULL)
+                ++m_dense[bin];
+            else if (m_sparse != NULL)
+                m_sparse->increment(bin);
+            else
+                m_atomic->add(bin, 1);
+            if (m_dense_weighted != NULL)
+                m_dense_weighted[bin] += m_weight;
+            else if (m_sparse_weighted != NULL)
+                m_sparse_weighted->add(bin, m_weight);
+            else if (m_atomic_weighted != NULL)
+                m_atomic_weighted->add(bin, m_weight);
+            }
+
+    private:
+        util::BinCount *m_dense;                            //!< Dense histogram of the thread
+        util::SparseHistogram<util::BinCount> *m_sparse;    //!< Sparse histogram of the thread
+        double *m_dense_weighted;                           //!< Dense weighted counts of the thread
+        util::SparseHistogram<double> *m_sparse_weighted;   //!< Sparse weighted counts of the thread
+        util::AtomicHistogramBuffer<util::BinCount> *m_atomic;      //!< Buffer to the shared histogram
+        util::AtomicHistogramBuffer<double> *m_atomic_weighted;     //!< Buffer to the shared weighted counts
+        double m_weight;                                    //!< Weight of the current pair
+    };
+
+//! Accumulate the histogram of the pairs of reference points and points over frames
+/*! The PMFT classes only differ by how a pair is mapped to its bins, so the traversal of the pairs (by a neighbor list
+    or the cell list), the per-thread histograms, their reduction and the normalization are done here once.
+
+    The histograms of the threads are dense, or sparse for grids of at least util::SPARSE_HISTOGRAM_MIN_BINS bins,
+    most of which no thread reaches, and for grids whose dense copies per thread would exceed the memory limit. On
+    request, the threads count the pairs in a single histogram with atomic increments instead (see
+    setAtomicHistogram()).
+
+    The mapping given to accumulate() is a copyable class with the methods
+     - void setReference(size_t i), called before the pairs of reference point i
+     - void binPair(unsigned int j, const vec3<float>& delta, const PMFTBins& bins), which increments the bins of
+       the pair of i and point j, \a delta being the wrapped vector from i to j
+    Each task of the parallel loop over the reference points works on its own copy of the mapping, which may thus
+    keep per-reference state and scratch space. With PARTITION_PAIR_BLOCKS, the pairs of a reference point may be
+    split between several tasks, each of which calls setReference() before its pairs.
+*/
+class PMFTEngine
+    {
+    public:
+        //! Constructor
+        /*! \param r_cut Largest distance of the pairs that can fall in a bin
+            \param n_bins Number of bins of the histogram
+        */
+        PMFTEngine(float r_cut, size_t n_bins);
+
+        //! Destructor
+        ~PMFTEngine();
+
+        //! Get the box of the last frame
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the cutoff of the cell list
+        float getRCut() const
+            {
+            return m_r_cut;
+            }
+
+        //! Get the number of bins
+        size_t getNBins() const
+            {
+            return m_n_bins;
+            }
+
+        //! Whether the per-thread histograms are sparse
+        bool getSparse() const
+            {
+            return m_storage == STORAGE_SPARSE;
+            }
+
+        //! Set whether the threads count the pairs in one histogram shared by all of them, with atomic increments
+        /*! The histogram then takes the memory of one grid whatever the number of threads, and needs no reduction.
+            Each task combines the increments of the same bins in a small buffer before adding them atomically (see
+            util::AtomicHistogramBuffer), which is cheap when the pairs of a reference point fall in few bins, but
+            slower than the per-thread histograms when many threads hit the same bins. It takes precedence over the
+            memory limit. The counts accumulated so far are moved to histograms of the new kind by the next frame.
+        */
+        void setAtomicHistogram(bool atomic)
+            {
+            m_use_atomic = atomic;
+            }
+
+        //! Get whether the threads count the pairs in one shared histogram
+        bool getAtomicHistogram() const
+            {
+            return m_use_atomic;
+            }
+
+        //! Set the most bytes the dense per-thread histograms may take together, 0 for no limit (the default)
+        /*! When a dense copy of the grid per thread would exceed the limit, with the number of threads of the
+            frame, the histograms of the threads are sparse instead, taking memory for the bins they reach only.
+            The counts accumulated so far are moved to histograms of the new kind by the next frame.
+        */
+        void setMemoryLimit(size_t bytes)
+            {
+            m_memory_limit = bytes;
+            }
+
+        //! Get the most bytes the dense per-thread histograms may take together
+        size_t getMemoryLimit() const
+            {
+            return m_memory_limit;
+            }
+
+        //! Get the bytes allocated by each component: histogram (the arrays shared by the threads, the atomic
+        //! histogram included), local_histograms (those of the threads) and cell_list (unless it is shared)
+        util::MemoryUsage getMemoryUsage() const;
+
+        //! Estimate the bytes of each component after accumulate() of N reference points and N points on
+        //! num_threads threads, 0 for those of the current task arena
+        /*! The size of sparse histograms depends on the bins the pairs reach, so it is extrapolated from the
+            histograms of the threads so far, and is 0 before the first frame.
+        */
+        util::MemoryUsage estimateMemory(unsigned int N, unsigned int num_threads) const;
+
+        //! Set how the loop over the reference points of accumulate() is split between the threads
+        /*! PARTITION_PAIR_BLOCKS also splits the pairs of the densest cells, for strongly clustered systems, and
+            falls back to PARTITION_COST with a neighbor list. The frames of accumulateFrames() are always split
+            with the auto_partitioner, as they are binned concurrently.
+        */
+        void setPartitionMode(locality::PartitionMode mode)
+            {
+            m_partition_mode = mode;
+            }
+
+        //! Get how the loop of accumulate() is split between the threads
+        locality::PartitionMode getPartitionMode() const
+            {
+            return m_partition_mode;
+            }
+
+        //! Set whether the reference points are visited in the order of their cells, when there are at least
+        //! locality::CELL_ORDER_MIN_POINTS of them (the default) or never
+        void setCellOrder(bool cell_order)
+            {
+            m_cell_order = cell_order;
+            }
+
+        //! Get whether the reference points are visited in the order of their cells
+        bool getCellOrder() const
+            {
+            return m_cell_order;
+            }
+
+        //! Share a LinkCell with other analyses of the same points, or use an own one again if \a lc is NULL
+        /*! The cell width of \a lc must be at least the cutoff; its cell list is only computed when it is not
+            already that of the frame (see locality::SharedLinkCell).
+        */
+        void setLinkCell(std::shared_ptr<locality::LinkCell> lc)
+            {
+            m_lc.share(lc);
+            }
+
+        //! Set whether the PMFT classes bin the pairs of accumulate() on a CUDA GPU when no neighbor list is given
+        /*! Throws std::runtime_error when freud was built without CUDA or no device is found.
+        */
+        void setUseGPU(bool use_gpu);
+
+        //! Get whether the pairs are binned on the GPU
+        bool getUseGPU() const
+            {
+            return bool(m_gpu);
+            }
+
+        //! Forget the accumulated frames
+        void reset();
+
+        //! Add the pairs of a frame to the histogram
+        /*! The pairs are those of the neighbor list when it is given, or those closer than the cutoff of the cell
+            list otherwise, and each is binned by the mapping. When \a ref_weights and \a weights are given, the
+            bins of a pair also add the product of the weights of its points to the weighted counts of the thread.
+        */
+        template<class Mapping>
+        void accumulate(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                        const vec3<float> *points, unsigned int n_p, const locality::NeighborList *nlist,
+                        const Mapping& mapping, const float *ref_weights=NULL, const float *weights=NULL);
+
+        //! Add the pairs of a frame binned on the GPU to the histogram, as accumulate() would
+        /*! bin_frame(binner, counts) fills the histogram of the frame, of getNBins() bins, with the
+            gpu::PairBinnerGPU; setUseGPU(true) must have been called.
+        */
+        template<class BinOnGPU>
+        void accumulateGPU(const box::Box& box, unsigned int n_ref, unsigned int n_p, const BinOnGPU& bin_frame);
+
+        //! Add the pairs of a stack of frames to the histogram, as many calls to accumulate() would
+        /*! Frame f is made of boxes[f], ref_points[f*n_ref, (f+1)*n_ref) and points[f*n_p, (f+1)*n_p), and its
+            pairs are binned by make_mapping(f). The frames are processed in parallel, and the reference points of
+            each frame further split, so that many frames of few points keep every thread busy; each task reuses the
+            storage of one cell list across its frames.
+        */
+        template<class MappingFactory>
+        void accumulateFrames(const box::Box *boxes, const vec3<float> *ref_points, unsigned int n_ref,
+                              const vec3<float> *points, unsigned int n_p, unsigned int n_frames,
+                              const MappingFactory& make_mapping);
+
+        //! Reduce the per-thread histograms to the bin counts, the PCF and the PMFT, if a frame was added since the
+        //! last call
+        /*! The PCF of bin b is its count times norm_factor inv_jacobian(b) V / (N_frames N_ref N_p), V being the
+            volume of the last box and N_ref and N_p the numbers of points of the last frame, and the PMFT is
+            -log(PCF). Both are computed by the tasks that sum each tile of the histograms, in the same pass, and
+            the weighted PCF from the weighted counts likewise.
+        */
+        template<class InvJacobian>
+        void reduce(float norm_factor, const InvJacobian& inv_jacobian);
+
+        //! Save the histogram, the number of frames and the box and numbers of points of the last frame to a
+        //! checkpoint file
+        /*! \param kind Name of the PMFT class
+            \param parameters Parameters of the bins of the class, checked by loadState()
+        */
+        /*! The weighted counts are not saved.
+        */
+        void saveState(const std::string& filename, const std::string& kind, const std::vector<float>& parameters);
+
+        //! Restore the state of a checkpoint file saved by saveState() with the same kind and parameters, or add it
+        //! to the accumulated state if merge
+        /*! When merging, the box and numbers of points that normalize the PCF stay those of this object, unless it
+            has no frame yet.
+        */
+        void loadState(const std::string& filename, const std::string& kind, const std::vector<float>& parameters,
+                       bool merge);
+
+        //! Add the accumulated state of another engine of the same number of bins
+        /*! The PMFT classes check that the bins are the same.
+        */
+        void merge(const PMFTEngine& other);
+
+        //! Get the bin counts of the last reduce
+        std::shared_ptr<util::BinCount> getBinCounts()
+            {
+            return m_bin_counts;
+            }
+
+        //! Get the PCF of the last reduce
+        std::shared_ptr<float> getPCF()
+            {
+            return m_pcf_array;
+            }
+
+        //! Get the PMFT of the last reduce
+        std::shared_ptr<float> getPMFT()
+            {
+            return m_pmft_array;
+            }
+
+        //! Get the PCF of the weighted counts of the last reduce, normalized as the PCF, zero when no weighted frame
+        //! was accumulated
+        std::shared_ptr<float> getWeightedPCF();
+
+        //! Get whether a weighted frame was accumulated since the last reset
+        bool getWeighted() const
+            {
+            return m_weighted;
+            }
+
+    private:
+        //! Kind of histograms the pairs are counted in
+        enum Storage
+            {
+            STORAGE_DENSE,      //!< Dense histogram per thread
+            STORAGE_SPARSE,     //!< Sparse histogram per thread
+            STORAGE_ATOMIC      //!< Histogram shared by the threads
+            };
+
+        //! Kind of histograms for the bins, the memory limit and the histogram of each thread taking bytes
+        Storage selectStorage(size_t bytes, unsigned int num_threads) const;
+
+        //! Make the histograms those selected for the frame, moving their counts
+        /*! \param weighted Whether the frame has weighted counts, which take another histogram
+        */
+        void chooseStorage(bool weighted);
+
+        //! Get the bins of the calling thread in the storage of the frame, or those of the task buffers to the
+        //! shared histograms
+        /*! \param weighted Whether the frame is weighted
+        */
+        PMFTBins localBins(bool weighted, util::AtomicHistogramBuffer<util::BinCount>& atomic_bins,
+                           util::AtomicHistogramBuffer<double>& atomic_weighted);
+
+        //! Sum the histograms into counts, and the weighted ones into weighted_counts unless it is NULL
+        void collectCounts(util::BinCount *counts, double *weighted_counts) const;
+
+        //! Add counts to the histograms, and weighted_counts to the weighted ones unless it is NULL
+        void addCounts(const util::BinCount *counts, const double *weighted_counts);
+
+        //! Add the histogram of some frames to the accumulated one
+        void addState(const util::BinCount *counts, unsigned int frame_counter, const box::Box& box,
+                      unsigned int n_ref, unsigned int n_p);
+
+        //! Bin the pairs of one frame in parallel over its reference points
+        /*! \param lc Cell list of \a points computed with sorted points, unused when \a nlist is given
+            \param mode How the loop is split; PARTITION_AFFINITY uses the partitioner of this object, so binFrame
+                         must then not be called concurrently
+            \param partition Storage of the cell order and of the ranges of PARTITION_COST, one per concurrent call
+        */
+        template<class Mapping>
+        void binFrame(const box::Box& box, const locality::LinkCell *lc, const vec3<float> *ref_points,
+                      unsigned int n_ref, const vec3<float> *points, unsigned int n_p, const float *ref_weights,
+                      const float *weights, const locality::NeighborList *nlist, const Mapping& mapping,
+                      locality::PartitionMode mode, locality::WorkPartition *partition);
+
+        box::Box m_box;                                 //!< Box of the last frame
+        locality::SharedLinkCell m_lc;                  //!< LinkCell to find the pairs without a neighbor list
+        float m_r_cut;                                  //!< Cutoff of the cell list
+        size_t m_n_bins;                                //!< Number of bins
+        Storage m_storage;                              //!< Kind of histograms the pairs are counted in
+        bool m_use_atomic;                              //!< true to count the pairs in the shared histogram
+        size_t m_memory_limit;                          //!< Most bytes of the dense per-thread histograms, or 0
+        unsigned int m_frame_counter;                   //!< Number of frames accumulated
+        unsigned int m_n_ref;                           //!< Number of reference points of the last frame
+        unsigned int m_n_p;                             //!< Number of points of the last frame
+        bool m_reduce;                                  //!< true if a frame was added since the last reduce
+
+        std::shared_ptr<float> m_pcf_array;             //!< PCF of each bin
+        std::shared_ptr<float> m_pmft_array;            //!< PMFT of each bin
+        std::shared_ptr<util::BinCount> m_bin_counts;   //!< Count of each bin
+        tbb::enumerable_thread_specific<util::BinCount *> m_local_bin_counts;
+        tbb::enumerable_thread_specific<util::SparseHistogram<util::BinCount> > m_local_sparse_bin_counts;
+        bool m_weighted;                                //!< true if a weighted frame was accumulated
+        std::shared_ptr<float> m_weighted_pcf_array;    //!< PCF of the weighted counts, allocated on first use
+        std::shared_ptr<double> m_weighted_counts;      //!< Weighted counts of each bin, allocated on first use
+        tbb::enumerable_thread_specific<double *> m_local_weighted_counts;
+        tbb::enumerable_thread_specific<util::SparseHistogram<double> > m_local_sparse_weighted_counts;
+        util::AtomicHistogram<util::BinCount> m_atomic_bin_counts;  //!< Histogram shared by the threads
+        util::AtomicHistogram<double> m_atomic_weighted_counts;     //!< Weighted counts shared by the threads
+        locality::PartitionMode m_partition_mode;       //!< How the loop of accumulate() is split
+        bool m_cell_order;                              //!< true to visit the reference points in cell order
+        locality::WorkPartition m_work_partition;       //!< Cell order and ranges of equal work of accumulate()
+        tbb::affinity_partitioner m_affinity;           //!< Partitioner kept across frames for PARTITION_AFFINITY
+        std::shared_ptr<gpu::PairBinnerGPU> m_gpu;      //!< Binner of the pairs on the GPU, when it is used
+        std::vector<util::BinCount> m_gpu_counts;       //!< Histogram of the frame binned on the GPU
+    };
+
+template<class Mapping>
+void PMFTEngine::accumulate(const box::Box& box, const vec3<float> *ref_points, unsigned int n_ref,
+                            const vec3<float> *points, unsigned int n_p, const locality::NeighborList *nlist,
+                            const Mapping& mapping, const float *ref_weights, const float *weights)
+    {
+    util::ScopedRange annotation("freud::PMFTEngine::accumulate");
+    if ((ref_weights == NULL) != (weights == NULL))
+        throw std::invalid_argument("The weights of the reference points and of the points must be given together");
+    m_box = box;
+    chooseStorage(weights != NULL || m_weighted);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc.compute(m_box, points, n_p, true);
+
+    binFrame(m_box, m_lc.get(), ref_points, n_ref, points, n_p, ref_weights, weights, nlist, mapping, m_partition_mode,
+             &m_work_partition);
+    if (weights != NULL)
+        m_weighted = true;
+    m_frame_counter++;
+    m_n_ref = n_ref;
+    m_n_p = n_p;
+    // flag to reduce
+    m_reduce = true;
+    }
+
+template<class BinOnGPU>
+void PMFTEngine::accumulateGPU(const box::Box& box, unsigned int n_ref, unsigned int n_p, const BinOnGPU& bin_frame)
+    {
+    util::ScopedRange annotation("freud::PMFTEngine::accumulateGPU");
+    m_gpu_counts.resize(m_n_bins);
+    bin_frame(*m_gpu, m_gpu_counts.data());
+    m_box = box;
+    chooseStorage(m_weighted);
+    addCounts(m_gpu_counts.data(), NULL);
+    m_frame_counter++;
+    m_n_ref = n_ref;
+    m_n_p = n_p;
+    m_reduce = true;
+    }
+
+template<class MappingFactory>
+void PMFTEngine::accumulateFrames(const box::Box *boxes, const vec3<float> *ref_points, unsigned int n_ref,
+                                  const vec3<float> *points, unsigned int n_p, unsigned int n_frames,
+                                  const MappingFactory& make_mapping)
+    {
+    util::ScopedRange annotation("freud::PMFTEngine::accumulateFrames");
+    if (n_frames == 0)
+        return;
+    chooseStorage(m_weighted);
+
+    const float r_cut = m_r_cut;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n_frames),
+        [=, &make_mapping] (const tbb::blocked_range<size_t>& r)
+            {
+            util::ScopedRange task_annotation("freud::PMFTEngine::accumulateFrames::frames");
+            // one cell list per task, whose arrays are reused by the frames that have as many points
+            box::Box box = boxes[r.begin()];
+            locality::LinkCell lc(box, r_cut);
+            locality::WorkPartition partition;
+            for (size_t f = r.begin(); f != r.end(); f++)
+                {
+                box = boxes[f];
+                const vec3<float> *frame_points = points + f*n_p;
+                lc.computeCellList(box, frame_points, n_p, true);
+                binFrame(box, &lc, ref_points + f*n_ref, n_ref, frame_points, n_p, NULL, NULL, NULL, make_mapping(f),
+                         locality::PARTITION_AUTO, &partition);
+                }
+            });
+
+    m_box = boxes[n_frames-1];
+    m_frame_counter += n_frames;
+    m_n_ref = n_ref;
+    m_n_p = n_p;
+    // flag to reduce
+    m_reduce = true;
+    }
+
+template<class Mapping>
+void PMFTEngine::binFrame(const box::Box& box, const locality::LinkCell *lc, const vec3<float> *ref_points,
+                          unsigned int n_ref, const vec3<float> *points, unsigned int n_p,
+                          const float *ref_weights, const float *weights, const locality::NeighborList *nlist,
+                          const Mapping& mapping, locality::PartitionMode mode, locality::WorkPartition *partition)
+    {
+    // the points sorted by cell, so that the distances to a cell are computed from contiguous memory
+    const vec3<float> *sorted_points = lc->getSortedPoints().get();
+    const unsigned int *cell_start = lc->getCellStart().get();
+    const unsigned int *cell_particles = lc->getCellParticles().get();
+    const unsigned int *order = NULL;
+    if (mode == locality::PARTITION_PAIR_BLOCKS && nlist != NULL)
+        mode = locality::PARTITION_COST;
+    if (mode == locality::PARTITION_PAIR_BLOCKS)
+        {
+        // the pairs of the dense cells of clustered systems are split between several tasks, which the idle
+        // threads steal
+        partition->splitPairBlocks(*lc, ref_points, n_ref, locality::defaultNumChunks());
+        partition->parallelForPairBlocks(
+            [=, &box, &mapping] (const locality::PairBlock *first, const locality::PairBlock *last,
+                                 const unsigned int *order)
+                {
+                util::ScopedRange annotation("freud::PMFTEngine::binFrame::pairBlocks");
+                util::AtomicHistogramBuffer<util::BinCount> atomic_bins(&m_atomic_bin_counts);
+                util::AtomicHistogramBuffer<double> atomic_weighted(&m_atomic_weighted_counts);
+                PMFTBins bins(localBins(weights != NULL, atomic_bins, atomic_weighted));
+
+                Mapping task_mapping(mapping);
+                locality::DistanceKernel kernel(box);
+                size_t ref_i = n_ref;
+                double ref_weight = 0.0;
+
+                locality::forEachPairBlockRange(*lc, first, last, order,
+                    [&] (unsigned int i, unsigned int begin, unsigned int end)
+                    {
+                    if (i != ref_i)
+                        {
+                        ref_i = i;
+                        ref_weight = (ref_weights != NULL) ? ref_weights[i] : 0.0;
+                        task_mapping.setReference(i);
+                        }
+                    kernel.forEach(ref_points[i], sorted_points + begin, end - begin,
+                        [&] (unsigned int k, const vec3<float>& delta, float rsq)
+                        {
+                        unsigned int j = cell_particles[begin + k];
+                        if (weights != NULL)
+                            bins.setWeight(ref_weight * weights[j]);
+                        task_mapping.binPair(j, delta, bins);
+                        });
+                    });
+                });
+        return;
+        }
+    if (mode == locality::PARTITION_COST)
+        {
+        // by the number of bonds with a neighbor list, or by cell
+        if (nlist != NULL)
+            partition->split(n_ref,
+                [=] (size_t i) { return 1.0 + nlist->getLastBond(i) - nlist->getFirstBond(i); },
+                locality::defaultNumChunks());
+        else
+            partition->splitByCell(*lc, ref_points, n_ref, locality::defaultNumChunks());
+        }
+    else if (nlist == NULL && m_cell_order && n_ref >= locality::CELL_ORDER_MIN_POINTS)
+        {
+        // consecutive reference points of a task share their neighbor cells
+        order = partition->orderByCell(*lc, ref_points, n_ref, points, n_p);
+        }
+    locality::parallelForPartitioned(mode, n_ref, order, partition, &m_affinity, "freud::PMFTEngine::binFrame",
+        [=, &box, &mapping] (const tbb::blocked_range<size_t>& r, const unsigned int *order)
+            {
+            assert(ref_points);
+            assert(points);
+            assert(n_ref > 0);
+            assert(n_p > 0);
+
+            // the buffers of the task to the shared histograms, flushed when the task ends
+            util::AtomicHistogramBuffer<util::BinCount> atomic_bins(&m_atomic_bin_counts);
+            util::AtomicHistogramBuffer<double> atomic_weighted(&m_atomic_weighted_counts);
+            PMFTBins bins(localBins(weights != NULL, atomic_bins, atomic_weighted));
+
+            Mapping task_mapping(mapping);
+            locality::DistanceKernel kernel(box);
+
+            // for each reference point
+            for (size_t pos = r.begin(); pos != r.end(); pos++)
+                {
+                size_t i = (order != NULL) ? order[pos] : pos;
+                vec3<float> ref = ref_points[i];
+                double ref_weight = (ref_weights != NULL) ? ref_weights[i] : 0.0;
+                task_mapping.setReference(i);
+
+                if (nlist != NULL)
+                    {
+                    const unsigned int *index_j = nlist->getIndexJ().get();
+                    const vec3<float> *vectors = nlist->getVectors().get();
+                    for (size_t bond = nlist->getFirstBond(i); bond < nlist->getLastBond(i); bond++)
+                        {
+                        unsigned int j = index_j[bond];
+                        if (weights != NULL)
+                            bins.setWeight(ref_weight * weights[j]);
+                        task_mapping.binPair(j, (vectors != NULL) ? vectors[bond] : box.wrap(points[j] - ref), bins);
+                        }
+                    continue;
+                    }
+
+                // get the cell the point is in
+                unsigned int ref_cell = lc->getCell(ref);
+
+                // loop over all neighboring cells
+                const locality::CellNeighbors& neigh_cells = lc->getCellNeighbors(ref_cell);
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                    {
+                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                    // iterate over the particles in that cell
+                    unsigned int begin = cell_start[neigh_cell];
+                    kernel.forEach(ref, sorted_points + begin, cell_start[neigh_cell+1] - begin,
+                        [&] (unsigned int k, const vec3<float>& delta, float rsq)
+                        {
+                        unsigned int j = cell_particles[begin + k];
+                        if (weights != NULL)
+                            bins.setWeight(ref_weight * weights[j]);
+                        task_mapping.binPair(j, delta, bins);
+                        });
+                    }
+                } // done looping over reference points
+            });
+    }
+
+template<class InvJacobian>
+void PMFTEngine::reduce(float norm_factor, const InvJacobian& inv_jacobian)
+    {
+    util::ScopedRange annotation("freud::PMFTEngine::reduce");
+    if (!m_reduce)
+        return;
+    m_reduce = false;
+
+    float inv_num_dens = m_box.getVolume() / (float)m_n_p;
+    float frame_norm = norm_factor / ((float) m_frame_counter * (float) m_n_ref);
+    float *pcf = m_pcf_array.get();
+    float *pmft = m_pmft_array.get();
+    const util::BinCount *counts = m_bin_counts.get();
+    // normalize each tile as soon as it is reduced
+    auto normalize = [=, &inv_jacobian] (size_t begin, size_t end)
+        {
+        for (size_t i = begin; i != end; i++)
+            {
+            pcf[i] = (float)counts[i] * frame_norm * inv_jacobian(i) * inv_num_dens;
+            }
+        for (size_t i = begin; i != end; i++)
+            {
+            pmft[i] = -logf(pcf[i]);
+            }
+        };
+    if (m_storage == STORAGE_SPARSE)
+        util::reduceLocalHistograms(m_local_sparse_bin_counts, m_bin_counts.get(), m_n_bins, normalize);
+    else if (m_storage == STORAGE_ATOMIC)
+        m_atomic_bin_counts.copyTo(m_bin_counts.get(), m_n_bins, normalize);
+    else
+        util::reduceLocalHistograms(m_local_bin_counts, m_bin_counts.get(), m_n_bins, normalize);
+
+    if (!m_weighted)
+        return;
+    float *weighted_pcf = getWeightedPCF().get();
+    const double *weighted_counts = m_weighted_counts.get();
+    auto normalize_weighted = [=, &inv_jacobian] (size_t begin, size_t end)
+        {
+        for (size_t i = begin; i != end; i++)
+            {
+            weighted_pcf[i] = (float)weighted_counts[i] * frame_norm * inv_jacobian(i) * inv_num_dens;
+            }
+        };
+    if (m_storage == STORAGE_SPARSE)
+        util::reduceLocalHistograms(m_local_sparse_weighted_counts, m_weighted_counts.get(), m_n_bins,
+                                    normalize_weighted);
+    else if (m_storage == STORAGE_ATOMIC)
+        m_atomic_weighted_counts.copyTo(m_weighted_counts.get(), m_n_bins, normalize_weighted);
+    else
+        util::reduceLocalHistograms(m_local_weighted_counts, m_weighted_counts.get(), m_n_bins, normalize_weighted);
+    }
+
+}; }; // end namespace freud::pmft
+
+#endif // _PMFT_ENGINE_H__
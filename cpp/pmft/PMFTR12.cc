@@ -3,11 +3,10 @@
 
 #include "PMFTR12.h"
 #include "ScopedGILRelease.h"
+#include "AlignedArray.h"
+#include "AngleBins.h"
 
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
 
 #include "VectorMath.h"
 
@@ -22,10 +21,61 @@ using namespace tbb;
 
 namespace freud { namespace pmft {
 
+//! \internal
+//! Bin each pair by its distance and the angles of its vector relative to the orientations of both particles
+class R12Mapping
+    {
+    public:
+        R12Mapping(float max_r, float dr, float dt1, float dt2, unsigned int nbins_r, unsigned int nbins_t1,
+                   unsigned int nbins_t2, const float *ref_orientations, const float *orientations)
+            : m_maxrsq(max_r*max_r), m_dr_inv(1.0f / dr), m_t1_bins(dt1), m_t2_bins(dt2),
+              m_nbins_r(nbins_r), m_nbins_t1(nbins_t1), m_nbins_t2(nbins_t2), m_b_i(nbins_t1, nbins_t2, nbins_r),
+              m_ref_orientations(ref_orientations), m_orientations(orientations), m_ref_orientation(0)
+            {
+            }
+
+        void setReference(size_t i)
+            {
+            m_ref_orientation = m_ref_orientations[i];
+            }
+
+        void binPair(unsigned int j, const vec3<float>& delta, const PMFTBins& bins) const
+            {
+            float rsq = dot(delta, delta);
+            if (rsq < 1e-6)
+                {
+                return;
+                }
+            if (rsq < m_maxrsq)
+                {
+                float r = sqrtf(rsq);
+                // bin that point, the angles being bounded between 0 and 2PI without atan2
+                unsigned int ibin_r = binIndex(r * m_dr_inv);
+                unsigned int ibin_t1 = m_t1_bins.bin(m_ref_orientation, delta.y, delta.x);
+                unsigned int ibin_t2 = m_t2_bins.bin(m_orientations[j], -delta.y, -delta.x);
+
+                if ((ibin_r < m_nbins_r) && (ibin_t1 < m_nbins_t1) && (ibin_t2 < m_nbins_t2))
+                    {
+                    bins(m_b_i(ibin_t1, ibin_t2, ibin_r));
+                    }
+                }
+            }
+
+    private:
+        float m_maxrsq;
+        float m_dr_inv;
+        AngleBins m_t1_bins, m_t2_bins;     //!< Bins of the angles of the reference and of the other particle
+        unsigned int m_nbins_r, m_nbins_t1, m_nbins_t2;
+        Index3D m_b_i;
+        const float *m_ref_orientations;
+        const float *m_orientations;
+        float m_ref_orientation;            //!< Orientation of the current reference
+    };
+
 PMFTR12::PMFTR12(float max_r, unsigned int nbins_r, unsigned int nbins_t1, unsigned int nbins_t2)
-    : m_box(box::Box()), m_max_r(max_r), m_max_t1(2.0*M_PI), m_max_t2(2.0*M_PI),
-      m_nbins_r(nbins_r), m_nbins_t1(nbins_t1), m_nbins_t2(nbins_t2), m_frame_counter(0),
-      m_n_ref(0), m_n_p(0), m_reduce(true)
+    : m_max_r(max_r), m_max_t1(2.0*M_PI), m_max_t2(2.0*M_PI),
+      m_nbins_r(nbins_r), m_nbins_t1(nbins_t1), m_nbins_t2(nbins_t2),
+      m_engine(max_r, size_t(nbins_r)*nbins_t1*nbins_t2)
     {
     if (nbins_r < 1)
         throw invalid_argument("must be at least 1 bin in r");
@@ -57,7 +107,7 @@ PMFTR12::PMFTR12(float max_r, unsigned int nbins_r, unsigned int nbins_t1, unsig
         }
 
     // calculate the jacobian array; calc'd as the inv for faster use later
-    m_inv_jacobian_array = std::shared_ptr<float>(new float[m_nbins_r*m_nbins_t1*m_nbins_t2], std::default_delete<float[]>());
+    m_inv_jacobian_array = util::makeLargeArray<float>(m_nbins_r*m_nbins_t1*m_nbins_t2);
     Index3D b_i = Index3D(m_nbins_t1, m_nbins_t2, m_nbins_r);
     for (unsigned int i = 0; i < m_nbins_t1; i++)
         {
@@ -88,96 +138,48 @@ PMFTR12::PMFTR12(float max_r, unsigned int nbins_r, unsigned int nbins_t1, unsig
         float nextT2 = float(i+1) * m_dt2;
         m_t2_array.get()[i] = ((T2 + nextT2) / 2.0);
         }
-
-    // create and populate the pcf_array
-    m_pcf_array = std::shared_ptr<float>(new float[m_nbins_r*m_nbins_t1*m_nbins_t2], std::default_delete<float[]>());
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_nbins_r*m_nbins_t1*m_nbins_t2], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-
-    m_r_cut = m_max_r;
-
-    m_lc = new locality::LinkCell(m_box, m_max_r);
-    }
-
-PMFTR12::~PMFTR12()
-    {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
-    delete m_lc;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTR12::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-    parallel_for(blocked_range<size_t>(0,m_nbins_t1),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index3D b_i = Index3D(m_nbins_t1, m_nbins_t2, m_nbins_r);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_nbins_t2; j++)
-                    {
-                    for (size_t k = 0; k < m_nbins_r; k++)
-                        {
-                        for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                             local_bins != m_local_bin_counts.end(); ++local_bins)
-                            {
-                            m_bin_counts.get()[b_i((int)i, (int)j, (int)k)] += (*local_bins)[b_i((int)i, (int)j, (int)k)];
-                            }
-                        }
-                    }
-                }
-            });
-    float inv_num_dens = m_box.getVolume() / (float)m_n_p;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref);
-    // normalize pcf_array
-    // avoid need to unravel b/c arrays are in the same index order
-    parallel_for(blocked_range<size_t>(0,m_nbins_r*m_nbins_t1*m_nbins_t2),
-        [=] (const blocked_range<size_t>& r)
-            {
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * m_inv_jacobian_array.get()[i] * inv_num_dens;
-                }
-            });
+    // the bins of the jacobian are in the same order as the bin counts
+    const float *inv_jacobian = m_inv_jacobian_array.get();
+    m_engine.reduce(1.0f, [=] (size_t b) { return inv_jacobian[b]; });
     }
 
 //! Get a reference to the PCF array
-std::shared_ptr<unsigned int> PMFTR12::getBinCounts()
+std::shared_ptr<util::BinCount> PMFTR12::getBinCounts()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_bin_counts;
+    reducePCF();
+    return m_engine.getBinCounts();
     }
 
 //! Get a reference to the PCF array
 std::shared_ptr<float> PMFTR12::getPCF()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_pcf_array;
+    reducePCF();
+    return m_engine.getPCF();
+    }
+
+//! Get a reference to the PMFT array
+std::shared_ptr<float> PMFTR12::getPMFT()
+    {
+    reducePCF();
+    return m_engine.getPMFT();
+    }
+
+//! Get a reference to the PCF of the weighted counts
+std::shared_ptr<float> PMFTR12::getWeightedPCF()
+    {
+    reducePCF();
+    return m_engine.getWeightedPCF();
     }
 
 void PMFTR12::resetPCF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-        }
-    m_frame_counter = 0;
-    m_reduce = true;
+    m_engine.reset();
     }
 
 void PMFTR12::accumulate(box::Box& box,
@@ -186,105 +188,39 @@ void PMFTR12::accumulate(box::Box& box,
                          unsigned int n_ref,
                          vec3<float> *points,
                          float *orientations,
-                         unsigned int n_p)
+                         unsigned int n_p,
+                         const locality::NeighborList *nlist,
+                         const float *ref_weights,
+                         const float *weights)
     {
-    m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
-    parallel_for(blocked_range<size_t>(0, n_ref),
-        [=] (const blocked_range<size_t>& br)
-            {
-            assert(ref_points);
-            assert(points);
-            assert(n_ref > 0);
-            assert(n_p > 0);
-
-            float dr_inv = 1.0f / m_dr;
-            float maxrsq = m_max_r * m_max_r;
-            float dt1_inv = 1.0f / m_dt1;
-            float dt2_inv = 1.0f / m_dt2;
-
-            Index3D b_i = Index3D(m_nbins_t1, m_nbins_t2, m_nbins_r);
-
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_nbins_r*m_nbins_t1*m_nbins_t2];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-                }
-
-            // for each reference point
-            for (size_t i = br.begin(); i != br.end(); i++)
-                {
-                // get the cell the point is in
-                vec3<float> ref = ref_points[i];
-                unsigned int ref_cell = m_lc->getCell(ref);
-
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-                    {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
-                        {
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
-
-                        float rsq = dot(delta, delta);
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
-                        if (rsq < maxrsq)
-                            {
-                            float r = sqrtf(rsq);
-                            // calculate angles
-                            float d_theta1 = atan2(delta.y, delta.x);
-                            float d_theta2 = atan2(-delta.y, -delta.x);
-                            float t1 = ref_orientations[i] - d_theta1;
-                            float t2 = orientations[j] - d_theta2;
-                            // make sure that t1, t2 are bounded between 0 and 2PI
-                            t1 = fmod(t1, 2*M_PI);
-                            if (t1 < 0)
-                                {
-                                t1 += 2*M_PI;
-                                }
-                            t2 = fmod(t2, 2*M_PI);
-                            if (t2 < 0)
-                                {
-                                t2 += 2*M_PI;
-                                }
-                            // bin that point
-                            float bin_r = r * dr_inv;
-                            float bin_t1 = floorf(t1 * dt1_inv);
-                            float bin_t2 = floorf(t2 * dt2_inv);
-                            // fast float to int conversion with truncation
-                            #ifdef __SSE2__
-                            unsigned int ibin_r = _mm_cvtt_ss2si(_mm_load_ss(&bin_r));
-                            unsigned int ibin_t1 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t1));
-                            unsigned int ibin_t2 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t2));
-                            #else
-                            unsigned int ibin_r = (unsigned int)(bin_r);
-                            unsigned int ibin_t1 = (unsigned int)(bin_t1);
-                            unsigned int ibin_t2 = (unsigned int)(bin_t2);
-                            #endif
+    R12Mapping mapping(m_max_r, m_dr, m_dt1, m_dt2, m_nbins_r, m_nbins_t1, m_nbins_t2, ref_orientations,
+                       orientations);
+    m_engine.accumulate(box, ref_points, n_ref, points, n_p, nlist, mapping, ref_weights, weights);
+    }
 
-                            if ((ibin_r < m_nbins_r) && (ibin_t1 < m_nbins_t1) && (ibin_t2 < m_nbins_t2))
-                                {
-                                ++m_local_bin_counts.local()[b_i(ibin_t1, ibin_t2, ibin_r)];
-                                }
-                            }
-                        }
-                    }
-                } // done looping over reference points
+void PMFTR12::accumulateFrames(const box::Box *boxes,
+                               vec3<float> *ref_points,
+                               float *ref_orientations,
+                               unsigned int n_ref,
+                               vec3<float> *points,
+                               float *orientations,
+                               unsigned int n_p,
+                               unsigned int n_frames)
+    {
+    const float max_r = m_max_r, dr = m_dr, dt1 = m_dt1, dt2 = m_dt2;
+    const unsigned int nbins_r = m_nbins_r, nbins_t1 = m_nbins_t1, nbins_t2 = m_nbins_t2;
+    m_engine.accumulateFrames(boxes, ref_points, n_ref, points, n_p, n_frames,
+        [=] (size_t f)
+            {
+            return R12Mapping(max_r, dr, dt1, dt2, nbins_r, nbins_t1, nbins_t2, ref_orientations + f*n_ref,
+                              orientations + f*n_p);
             });
-    m_frame_counter++;
-    m_n_ref = n_ref;
-    m_n_p = n_p;
-    // flag to reduce
-    m_reduce = true;
+    }
+
+std::vector<float> PMFTR12::getParameters() const
+    {
+    const float parameters[] = {m_max_r, float(m_nbins_r), float(m_nbins_t1), float(m_nbins_t2)};
+    return std::vector<float>(parameters, parameters + 4);
     }
 
 }; }; // end namespace freud::pmft
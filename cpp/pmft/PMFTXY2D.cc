@@ -5,9 +5,6 @@
 #include "ScopedGILRelease.h"
 
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
 
 #include "VectorMath.h"
 
@@ -22,9 +19,64 @@ using namespace tbb;
 
 namespace freud { namespace pmft {
 
+//! \internal
+//! Bin each pair by its vector in the frame of the reference particle
+class XY2DMapping
+    {
+    public:
+        XY2DMapping(float max_x, float max_y, float dx, float dy, unsigned int n_bins_x, unsigned int n_bins_y,
+                    const float *ref_orientations)
+            : m_max_x(max_x), m_max_y(max_y), m_dx_inv(1.0f / dx), m_dy_inv(1.0f / dy),
+              m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_b_i(n_bins_x, n_bins_y),
+              m_ref_orientations(ref_orientations)
+            {
+            }
+
+        void setReference(size_t i)
+            {
+            m_ref_rot = rotmat2<float>::fromAngle(-m_ref_orientations[i]);
+            }
+
+        void binPair(unsigned int j, const vec3<float>& delta, const PMFTBins& bins)
+            {
+            float rsq = dot(delta, delta);
+
+            // check that the particle is not checking itself
+            // 1e-6 is an arbitrary value that could be set differently if needed
+            if (rsq < 1e-6)
+                {
+                return;
+                }
+
+            // rotate interparticle vector
+            vec2<float> myVec(delta.x, delta.y);
+            vec2<float> rotVec = m_ref_rot * myVec;
+            float x = rotVec.x + m_max_x;
+            float y = rotVec.y + m_max_y;
+
+            // find the bin to increment
+            unsigned int ibinx = binIndex(floorf(x * m_dx_inv));
+            unsigned int ibiny = binIndex(floorf(y * m_dy_inv));
+
+            // increment the bin
+            if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y))
+                {
+                bins(m_b_i(ibinx, ibiny));
+                }
+            }
+
+    private:
+        float m_max_x, m_max_y;
+        float m_dx_inv, m_dy_inv;
+        unsigned int m_n_bins_x, m_n_bins_y;
+        Index2D m_b_i;
+        const float *m_ref_orientations;
+        rotmat2<float> m_ref_rot;           //!< Rotation by minus the orientation of the current reference
+    };
+
 PMFTXY2D::PMFTXY2D(float max_x, float max_y, unsigned int n_bins_x, unsigned int n_bins_y)
-    : m_box(box::Box()), m_max_x(max_x), m_max_y(max_y), m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y),
-      m_frame_counter(0), m_n_ref(0), m_n_p(0), m_reduce(true)
+    : m_max_x(max_x), m_max_y(max_y), m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y),
+      m_engine(sqrtf(max_x*max_x + max_y*max_y), size_t(n_bins_x)*n_bins_y)
     {
     if (n_bins_x < 1)
         throw invalid_argument("must be at least 1 bin in x");
@@ -62,196 +114,98 @@ PMFTXY2D::PMFTXY2D(float max_x, float max_y, unsigned int n_bins_x, unsigned int
         float nexty = float(i+1) * m_dy;
         m_y_array.get()[i] = -m_max_y + ((y + nexty) / 2.0);
         }
-
-    // create and populate the pcf_array
-    m_pcf_array = std::shared_ptr<float>(new float[m_n_bins_x * m_n_bins_y], std::default_delete<float[]>());
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_n_bins_x * m_n_bins_y], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
-
-
-    m_r_cut = sqrtf(m_max_x*m_max_x + m_max_y*m_max_y);
-
-    m_lc = new locality::LinkCell(m_box, m_r_cut);
-    }
-
-PMFTXY2D::~PMFTXY2D()
-    {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
-    delete m_lc;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTXY2D::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y);
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index2D b_i = Index2D(m_n_bins_x, m_n_bins_y);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_n_bins_y; j++)
-                    {
-                    for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                         local_bins != m_local_bin_counts.end(); ++local_bins)
-                        {
-                        m_bin_counts.get()[b_i((int)i, (int)j)] += (*local_bins)[b_i((int)i, (int)j)];
-                        }
-                    }
-                }
-            });
-    float inv_num_dens = m_box.getVolume() / (float)m_n_p;
     float inv_jacobian = (float) 1.0 / m_jacobian;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref);
-    // normalize pcf_array
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x*m_n_bins_y),
-        [=] (const blocked_range<size_t>& r)
-            {
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * inv_jacobian * inv_num_dens;
-                }
-            });
+    m_engine.reduce(1.0f, [=] (size_t) { return inv_jacobian; });
+    }
+
+//! Get a reference to the PCF array
+std::shared_ptr<util::BinCount> PMFTXY2D::getBinCounts()
+    {
+    reducePCF();
+    return m_engine.getBinCounts();
     }
 
 //! Get a reference to the PCF array
 std::shared_ptr<float> PMFTXY2D::getPCF()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_pcf_array;
+    reducePCF();
+    return m_engine.getPCF();
     }
 
-//! Get a reference to the bin counts array
-std::shared_ptr<unsigned int> PMFTXY2D::getBinCounts()
+//! Get a reference to the PMFT array
+std::shared_ptr<float> PMFTXY2D::getPMFT()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_bin_counts;
+    reducePCF();
+    return m_engine.getPMFT();
     }
 
-//! \internal
-/*! \brief Function to reset the pcf array if needed e.g. calculating between new particle types
-*/
+//! Get a reference to the PCF of the weighted counts
+std::shared_ptr<float> PMFTXY2D::getWeightedPCF()
+    {
+    reducePCF();
+    return m_engine.getWeightedPCF();
+    }
 
 void PMFTXY2D::resetPCF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
-        }
-    m_frame_counter = 0;
-    m_reduce = true;
+    m_engine.reset();
     }
 
-//! \internal
-/*! \brief Helper functionto direct the calculation to the correct helper class
-*/
-
 void PMFTXY2D::accumulate(box::Box& box,
-                         vec3<float> *ref_points,
-                         float *ref_orientations,
-                         unsigned int n_ref,
-                         vec3<float> *points,
-                         float *orientations,
-                         unsigned int n_p)
+                          vec3<float> *ref_points,
+                          float *ref_orientations,
+                          unsigned int n_ref,
+                          vec3<float> *points,
+                          float *orientations,
+                          unsigned int n_p,
+                          const locality::NeighborList *nlist,
+                          const float *ref_weights,
+                          const float *weights)
     {
-    m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
-    parallel_for(blocked_range<size_t>(0,n_ref),
-        [=] (const blocked_range<size_t>& r)
+    if (nlist == NULL && weights == NULL && m_engine.getUseGPU())
+        {
+        const float r_cut = m_engine.getRCut(), max_x = m_max_x, max_y = m_max_y, dx = m_dx, dy = m_dy;
+        const unsigned int n_bins_x = m_n_bins_x, n_bins_y = m_n_bins_y;
+        m_engine.accumulateGPU(box, n_ref, n_p,
+            [=, &box] (gpu::PairBinnerGPU& binner, util::BinCount *counts)
             {
-            assert(ref_points);
-            assert(points);
-            assert(n_ref > 0);
-            assert(n_p > 0);
-
-            // precalc some values for faster computation within the loop
-            float dx_inv = 1.0f / m_dx;
-            float dy_inv = 1.0f / m_dy;
-
-            Index2D b_i = Index2D(m_n_bins_x, m_n_bins_y);
-
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_n_bins_x*m_n_bins_y];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
-                }
-
-            // for each reference point
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                vec3<float> ref = ref_points[i];
-                // get the cell the point is in
-                unsigned int ref_cell = m_lc->getCell(ref);
-
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-                    {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
-                        {
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
-                        float rsq = dot(delta, delta);
-
-                        // check that the particle is not checking itself
-                        // 1e-6 is an arbitrary value that could be set differently if needed
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
-
-                        // rotate interparticle vector
-                        vec2<float> myVec(delta.x, delta.y);
-                        rotmat2<float> myMat = rotmat2<float>::fromAngle(-ref_orientations[i]);
-                        vec2<float> rotVec = myMat * myVec;
-                        float x = rotVec.x + m_max_x;
-                        float y = rotVec.y + m_max_y;
-
-                        // find the bin to increment
-                        float binx = floorf(x * dx_inv);
-                        float biny = floorf(y * dy_inv);
-                        // fast float to int conversion with truncation
-                        #ifdef __SSE2__
-                        unsigned int ibinx = _mm_cvtt_ss2si(_mm_load_ss(&binx));
-                        unsigned int ibiny = _mm_cvtt_ss2si(_mm_load_ss(&biny));
-                        #else
-                        unsigned int ibinx = (unsigned int)(binx);
-                        unsigned int ibiny = (unsigned int)(biny);
-                        #endif
+            binner.binPMFTXY2D(box, ref_points, ref_orientations, n_ref, points, n_p, r_cut, max_x, max_y, dx, dy,
+                               n_bins_x, n_bins_y, counts);
+            });
+        return;
+        }
+    XY2DMapping mapping(m_max_x, m_max_y, m_dx, m_dy, m_n_bins_x, m_n_bins_y, ref_orientations);
+    m_engine.accumulate(box, ref_points, n_ref, points, n_p, nlist, mapping, ref_weights, weights);
+    }
 
-                        // increment the bin
-                        if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y))
-                            {
-                            ++m_local_bin_counts.local()[b_i(ibinx, ibiny)];
-                            }
-                        }
-                    }
-                } // done looping over reference points
+void PMFTXY2D::accumulateFrames(const box::Box *boxes,
+                                vec3<float> *ref_points,
+                                float *ref_orientations,
+                                unsigned int n_ref,
+                                vec3<float> *points,
+                                float *orientations,
+                                unsigned int n_p,
+                                unsigned int n_frames)
+    {
+    const float max_x = m_max_x, max_y = m_max_y, dx = m_dx, dy = m_dy;
+    const unsigned int n_bins_x = m_n_bins_x, n_bins_y = m_n_bins_y;
+    m_engine.accumulateFrames(boxes, ref_points, n_ref, points, n_p, n_frames,
+        [=] (size_t f)
+            {
+            return XY2DMapping(max_x, max_y, dx, dy, n_bins_x, n_bins_y, ref_orientations + f*n_ref);
             });
-    m_frame_counter++;
-    m_n_ref = n_ref;
-    m_n_p = n_p;
-    // flag to reduce
-    m_reduce = true;
+    }
+
+std::vector<float> PMFTXY2D::getParameters() const
+    {
+    const float parameters[] = {m_max_x, m_max_y, float(m_n_bins_x), float(m_n_bins_y)};
+    return std::vector<float>(parameters, parameters + 4);
     }
 
 }; }; // end namespace freud::pmft
@@ -16,6 +16,8 @@
 
 #include "LinkCell.h"
 #include "box.h"
+#include "BinCount.h"
+#include "PMFTEngine.h"
 #include "Index1D.h"
 
 #ifndef _PMFTXY2D_H__
@@ -46,13 +48,10 @@ class PMFTXY2D
         //! Constructor
         PMFTXY2D(float max_x, float max_y, unsigned int n_bins_x, unsigned int n_bins_y);
 
-        //! Destructor
-        ~PMFTXY2D();
-
         //! Get the simulation box
         const box::Box& getBox() const
             {
-            return m_box;
+            return m_engine.getBox();
             }
 
         //! Reset the PCF array to all zeros
@@ -65,7 +64,8 @@ class PMFTXY2D
             }
 
         /*! Compute the PCF for the passed in set of points. The function will be added to previous values
-            of the pcf
+            of the pcf. When \a ref_weights and \a weights are given, each pair also adds the product of the weights
+            of its points to the weighted counts of getWeightedPCF(), and the GPU is not used.
         */
         void accumulate(box::Box& box,
                         vec3<float> *ref_points,
@@ -73,17 +73,62 @@ class PMFTXY2D
                         unsigned int n_ref,
                         vec3<float> *points,
                         float *orientations,
-                        unsigned int n_p);
+                        unsigned int n_p,
+                        const locality::NeighborList *nlist=NULL,
+                        const float *ref_weights=NULL,
+                        const float *weights=NULL);
+
+        //! Accumulate the PCF of a stack of frames, as calling accumulate() for each frame would
+        /*! Frame f is made of boxes[f], the n_ref reference points and orientations from f*n_ref and the n_p points
+            and orientations from f*n_p. The frames are processed in parallel, each task reusing one cell list.
+        */
+        void accumulateFrames(const box::Box *boxes,
+                              vec3<float> *ref_points,
+                              float *ref_orientations,
+                              unsigned int n_ref,
+                              vec3<float> *points,
+                              float *orientations,
+                              unsigned int n_p,
+                              unsigned int n_frames);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
         void reducePCF();
 
+        //! Save the accumulated histogram, the number of frames and the box and numbers of points of the last frame
+        //! to a checkpoint file
+        void saveState(const std::string& filename)
+            {
+            m_engine.saveState(filename, "PMFTXY2D", getParameters());
+            }
+
+        //! Restore the state of a checkpoint file, or add it to the accumulated state if merge
+        /*! The bins must be the same.
+        */
+        void loadState(const std::string& filename, bool merge=false)
+            {
+            m_engine.loadState(filename, "PMFTXY2D", getParameters(), merge);
+            }
+
+        //! Add the accumulated state of another PMFTXY2D of the same bins, such as one of another chunk of a trajectory
+        void merge(const PMFTXY2D& other)
+            {
+            if (other.getParameters() != getParameters())
+                throw std::invalid_argument("Only PMFTXY2Ds of the same bins can be merged");
+            m_engine.merge(other.m_engine);
+            }
+
         //! Get a reference to the PCF array
         std::shared_ptr<float> getPCF();
 
+        //! Get a reference to the PMFT array, -log(PCF), computed with the PCF
+        std::shared_ptr<float> getPMFT();
+
+        //! Get a reference to the PCF of the weighted counts, normalized as the PCF
+        std::shared_ptr<float> getWeightedPCF();
+
         //! Get a reference to the bin counts array
-        std::shared_ptr<unsigned int> getBinCounts();
+        std::shared_ptr<util::BinCount> getBinCounts();
 
         //! Get a reference to the x array
         std::shared_ptr<float> getX()
@@ -104,7 +149,96 @@ class PMFTXY2D
 
         float getRCut()
             {
-            return m_r_cut;
+            return m_engine.getRCut();
+            }
+
+        //! Whether the per-thread histograms are sparse, as they are for grids of at least
+        //! util::SPARSE_HISTOGRAM_MIN_BINS bins or beyond the memory limit
+        bool getSparse()
+            {
+            return m_engine.getSparse();
+            }
+
+        //! Set whether the threads count the pairs in one shared histogram (see PMFTEngine::setAtomicHistogram)
+        void setAtomicHistogram(bool atomic)
+            {
+            m_engine.setAtomicHistogram(atomic);
+            }
+
+        //! Get whether the threads count the pairs in one shared histogram
+        bool getAtomicHistogram() const
+            {
+            return m_engine.getAtomicHistogram();
+            }
+
+        //! Set the most bytes the dense per-thread histograms may take together, 0 for no limit (see
+        //! PMFTEngine::setMemoryLimit)
+        void setMemoryLimit(size_t bytes)
+            {
+            m_engine.setMemoryLimit(bytes);
+            }
+
+        //! Get the most bytes the dense per-thread histograms may take together
+        size_t getMemoryLimit() const
+            {
+            return m_engine.getMemoryLimit();
+            }
+
+        //! Get the bytes allocated by each component
+        util::MemoryUsage getMemoryUsage() const
+            {
+            return m_engine.getMemoryUsage();
+            }
+
+        //! Estimate the bytes of each component after accumulate() of N reference points and N points on
+        //! num_threads threads, 0 for those of the current task arena
+        util::MemoryUsage estimateMemory(unsigned int N, unsigned int num_threads) const
+            {
+            return m_engine.estimateMemory(N, num_threads);
+            }
+
+        //! Set how the loop over the reference points of accumulate() is split between the threads
+        void setPartitionMode(locality::PartitionMode mode)
+            {
+            m_engine.setPartitionMode(mode);
+            }
+
+        //! Get how the loop of accumulate() is split between the threads
+        locality::PartitionMode getPartitionMode() const
+            {
+            return m_engine.getPartitionMode();
+            }
+
+        //! Set whether the reference points are visited in the order of their cells, for large numbers of them
+        void setCellOrder(bool cell_order)
+            {
+            m_engine.setCellOrder(cell_order);
+            }
+
+        //! Get whether the reference points are visited in the order of their cells
+        bool getCellOrder() const
+            {
+            return m_engine.getCellOrder();
+            }
+
+        //! Share a LinkCell with other analyses of the same points, or use an own one again if \a lc is NULL
+        void setLinkCell(std::shared_ptr<locality::LinkCell> lc)
+            {
+            m_engine.setLinkCell(lc);
+            }
+
+        //! Set whether accumulate() bins the pairs on a CUDA GPU when no neighbor list is given
+        /*! Throws std::runtime_error when freud was built without CUDA or no device is found.
+        */
+        void setUseGPU(bool use_gpu)
+            {
+            m_engine.setUseGPU(use_gpu);
+            }
+
+        //! Get whether accumulate() bins the pairs on the GPU
+        bool getUseGPU() const
+            {
+            return m_engine.getUseGPU();
             }
 
         // //! Python wrapper for getPCF() (returns a copy)
@@ -121,26 +255,20 @@ class PMFTXY2D
             }
 
     private:
-        box::Box m_box;            //!< Simulation box the particles belong in
+        //! Parameters of the bins, which the checkpoints are checked against
+        std::vector<float> getParameters() const;
+
         float m_max_x;                     //!< Maximum x at which to compute pcf
         float m_max_y;                     //!< Maximum y at which to compute pcf
         float m_dx;                       //!< Step size for x in the computation
         float m_dy;                       //!< Step size for y in the computation
-        locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
         unsigned int m_n_bins_x;             //!< Number of x bins to compute pcf over
         unsigned int m_n_bins_y;             //!< Number of y bins to compute pcf over
-        float m_r_cut;                      //!< r_cut used in cell list construction
-        unsigned int m_frame_counter;       //!< number of frames calc'd
-        unsigned int m_n_ref;
-        unsigned int m_n_p;
         float m_jacobian;
-        bool m_reduce;
 
-        std::shared_ptr<float> m_pcf_array;         //!< array of pcf computed
-        std::shared_ptr<unsigned int> m_bin_counts;         //!< array of pcf computed
         std::shared_ptr<float> m_x_array;           //!< array of x values that the pcf is computed at
         std::shared_ptr<float> m_y_array;           //!< array of y values that the pcf is computed at
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
+        PMFTEngine m_engine;                        //!< Pair traversal and histograms
     };
 
 }; }; // end namespace freud::pmft
@@ -3,11 +3,9 @@
 
 #include "PMFTXYT.h"
 #include "ScopedGILRelease.h"
+#include "AngleBins.h"
 
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
 
 #include "VectorMath.h"
 
@@ -22,10 +20,65 @@ using namespace tbb;
 
 namespace freud { namespace pmft {
 
+//! \internal
+//! Bin each pair by its vector in the frame of the reference particle and the orientation of the other particle
+class XYTMapping
+    {
+    public:
+        XYTMapping(float max_x, float max_y, float dx, float dy, float dt, unsigned int n_bins_x,
+                   unsigned int n_bins_y, unsigned int n_bins_t, const float *ref_orientations,
+                   const float *orientations)
+            : m_max_x(max_x), m_max_y(max_y), m_dx_inv(1.0f / dx), m_dy_inv(1.0f / dy), m_t_bins(dt),
+              m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_t(n_bins_t),
+              m_b_i(n_bins_x, n_bins_y, n_bins_t), m_ref_orientations(ref_orientations),
+              m_orientations(orientations)
+            {
+            }
+
+        void setReference(size_t i)
+            {
+            m_ref_rot = rotmat2<float>::fromAngle(-m_ref_orientations[i]);
+            }
+
+        void binPair(unsigned int j, const vec3<float>& delta, const PMFTBins& bins) const
+            {
+            float rsq = dot(delta, delta);
+            if (rsq < 1e-6)
+                {
+                return;
+                }
+            // rotate interparticle vector
+            vec2<float> myVec(delta.x, delta.y);
+            vec2<float> rotVec = m_ref_rot * myVec;
+            float x = rotVec.x + m_max_x;
+            float y = rotVec.y + m_max_y;
+            // bin that point
+            unsigned int ibin_x = binIndex(floorf(x * m_dx_inv));
+            unsigned int ibin_y = binIndex(floorf(y * m_dy_inv));
+            // bin the angle, bounded between 0 and 2PI, without atan2
+            unsigned int ibin_t = m_t_bins.bin(m_orientations[j], -delta.y, -delta.x);
+
+            if ((ibin_x < m_n_bins_x) && (ibin_y < m_n_bins_y) && (ibin_t < m_n_bins_t))
+                {
+                bins(m_b_i(ibin_x, ibin_y, ibin_t));
+                }
+            }
+
+    private:
+        float m_max_x, m_max_y;
+        float m_dx_inv, m_dy_inv;
+        AngleBins m_t_bins;                 //!< Bins of the angle of the other particle
+        unsigned int m_n_bins_x, m_n_bins_y, m_n_bins_t;
+        Index3D m_b_i;
+        const float *m_ref_orientations;
+        const float *m_orientations;
+        rotmat2<float> m_ref_rot;           //!< Rotation by minus the orientation of the current reference
+    };
+
 PMFTXYT::PMFTXYT(float max_x, float max_y, unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_t)
-    : m_box(box::Box()), m_max_x(max_x), m_max_y(max_y), m_max_t(2.0*M_PI),
-      m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_t(n_bins_t), m_frame_counter(0),
-      m_n_ref(0), m_n_p(0), m_reduce(true)
+    : m_max_x(max_x), m_max_y(max_y), m_max_t(2.0*M_PI),
+      m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_t(n_bins_t),
+      m_engine(sqrtf(max_x*max_x + max_y*max_y), size_t(n_bins_x)*n_bins_y*n_bins_t)
     {
     if (n_bins_x < 1)
         throw invalid_argument("must be at least 1 bin in x");
@@ -77,96 +130,47 @@ PMFTXYT::PMFTXYT(float max_x, float max_y, unsigned int n_bins_x, unsigned int n
         float next_t = float(i+1) * m_dt;
         m_t_array.get()[i] = ((t + next_t) / 2.0);
         }
-
-    // create and populate the pcf_array
-    m_pcf_array = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y*m_n_bins_t], std::default_delete<float[]>());
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_n_bins_x*m_n_bins_y*m_n_bins_t], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-
-    m_r_cut = sqrtf(m_max_x*m_max_x + m_max_y*m_max_y);
-
-    m_lc = new locality::LinkCell(m_box, m_r_cut);
-    }
-
-PMFTXYT::~PMFTXYT()
-    {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
-    delete m_lc;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTXYT::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_t);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_n_bins_y; j++)
-                    {
-                    for (size_t k = 0; k < m_n_bins_t; k++)
-                        {
-                        for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                             local_bins != m_local_bin_counts.end(); ++local_bins)
-                            {
-                            m_bin_counts.get()[b_i((int)i, (int)j, (int)k)] += (*local_bins)[b_i((int)i, (int)j, (int)k)];
-                            }
-                        }
-                    }
-                }
-            });
-    float inv_num_dens = m_box.getVolume() / (float)m_n_p;
     float inv_jacobian = (float) 1.0 / m_jacobian;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref);
-    // normalize pcf_array
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x*m_n_bins_y*m_n_bins_t),
-        [=] (const blocked_range<size_t>& r)
-            {
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * inv_jacobian * inv_num_dens;
-                }
-            });
+    m_engine.reduce(1.0f, [=] (size_t) { return inv_jacobian; });
     }
 
 //! Get a reference to the PCF array
-std::shared_ptr<unsigned int> PMFTXYT::getBinCounts()
+std::shared_ptr<util::BinCount> PMFTXYT::getBinCounts()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_bin_counts;
+    reducePCF();
+    return m_engine.getBinCounts();
     }
 
 //! Get a reference to the PCF array
 std::shared_ptr<float> PMFTXYT::getPCF()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_pcf_array;
+    reducePCF();
+    return m_engine.getPCF();
+    }
+
+//! Get a reference to the PMFT array
+std::shared_ptr<float> PMFTXYT::getPMFT()
+    {
+    reducePCF();
+    return m_engine.getPMFT();
+    }
+
+//! Get a reference to the PCF of the weighted counts
+std::shared_ptr<float> PMFTXYT::getWeightedPCF()
+    {
+    reducePCF();
+    return m_engine.getWeightedPCF();
     }
 
 void PMFTXYT::resetPCF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-        }
-    m_frame_counter = 0;
-    m_reduce = true;
+    m_engine.reset();
     }
 
 void PMFTXYT::accumulate(box::Box& box,
@@ -175,100 +179,39 @@ void PMFTXYT::accumulate(box::Box& box,
                          unsigned int n_ref,
                          vec3<float> *points,
                          float *orientations,
-                         unsigned int n_p)
+                         unsigned int n_p,
+                         const locality::NeighborList *nlist,
+                         const float *ref_weights,
+                         const float *weights)
     {
-    m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
-    parallel_for(blocked_range<size_t>(0, n_ref),
-        [=] (const blocked_range<size_t>& r)
-            {
-            assert(ref_points);
-            assert(points);
-            assert(n_ref > 0);
-            assert(n_p > 0);
-
-            // precalc some values for faster computation within the loop
-            float dx_inv = 1.0f / m_dx;
-            float dy_inv = 1.0f / m_dy;
-            float dt_inv = 1.0f / m_dt;
-
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_t);
-
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_n_bins_x*m_n_bins_y*m_n_bins_t];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-                }
-
-            // for each reference point
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                // get the cell the point is in
-                vec3<float> ref = ref_points[i];
-                unsigned int ref_cell = m_lc->getCell(ref);
-
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-                    {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
-                        {
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
-
-                        float rsq = dot(delta, delta);
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
-                        // rotate interparticle vector
-                        vec2<float> myVec(delta.x, delta.y);
-                        rotmat2<float> myMat = rotmat2<float>::fromAngle(-ref_orientations[i]);
-                        vec2<float> rotVec = myMat * myVec;
-                        float x = rotVec.x + m_max_x;
-                        float y = rotVec.y + m_max_y;
-                        // calculate angle
-                        float d_theta = atan2(-delta.y, -delta.x);
-                        float t = orientations[j] - d_theta;
-                        // make sure that t is bounded between 0 and 2PI
-                        t = fmod(t, 2*M_PI);
-                        if (t < 0)
-                            {
-                            t += 2*M_PI;
-                            }
-                        // bin that point
-                        float bin_x = floorf(x * dx_inv);
-                        float bin_y = floorf(y * dy_inv);
-                        float bin_t = floorf(t * dt_inv);
-                        // fast float to int conversion with truncation
-                        #ifdef __SSE2__
-                        unsigned int ibin_x = _mm_cvtt_ss2si(_mm_load_ss(&bin_x));
-                        unsigned int ibin_y = _mm_cvtt_ss2si(_mm_load_ss(&bin_y));
-                        unsigned int ibin_t = _mm_cvtt_ss2si(_mm_load_ss(&bin_t));
-                        #else
-                        unsigned int ibin_x = (unsigned int)(bin_x);
-                        unsigned int ibin_y = (unsigned int)(bin_y);
-                        unsigned int ibin_t = (unsigned int)(bin_t);
-                        #endif
+    XYTMapping mapping(m_max_x, m_max_y, m_dx, m_dy, m_dt, m_n_bins_x, m_n_bins_y, m_n_bins_t, ref_orientations,
+                       orientations);
+    m_engine.accumulate(box, ref_points, n_ref, points, n_p, nlist, mapping, ref_weights, weights);
+    }
 
-                        if ((ibin_x < m_n_bins_x) && (ibin_y < m_n_bins_y) && (ibin_t < m_n_bins_t))
-                            {
-                            ++m_local_bin_counts.local()[b_i(ibin_x, ibin_y, ibin_t)];
-                            }
-                        }
-                    }
-                } // done looping over reference points
+void PMFTXYT::accumulateFrames(const box::Box *boxes,
+                               vec3<float> *ref_points,
+                               float *ref_orientations,
+                               unsigned int n_ref,
+                               vec3<float> *points,
+                               float *orientations,
+                               unsigned int n_p,
+                               unsigned int n_frames)
+    {
+    const float max_x = m_max_x, max_y = m_max_y, dx = m_dx, dy = m_dy, dt = m_dt;
+    const unsigned int n_bins_x = m_n_bins_x, n_bins_y = m_n_bins_y, n_bins_t = m_n_bins_t;
+    m_engine.accumulateFrames(boxes, ref_points, n_ref, points, n_p, n_frames,
+        [=] (size_t f)
+            {
+            return XYTMapping(max_x, max_y, dx, dy, dt, n_bins_x, n_bins_y, n_bins_t, ref_orientations + f*n_ref,
+                              orientations + f*n_p);
             });
-    m_frame_counter++;
-    m_n_ref = n_ref;
-    m_n_p = n_p;
-    // flag to reduce
-    m_reduce = true;
+    }
+
+std::vector<float> PMFTXYT::getParameters() const
+    {
+    const float parameters[] = {m_max_x, m_max_y, float(m_n_bins_x), float(m_n_bins_y), float(m_n_bins_t)};
+    return std::vector<float>(parameters, parameters + 5);
     }
 
 }; }; // end namespace freud::pmft
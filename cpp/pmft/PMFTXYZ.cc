@@ -5,9 +5,7 @@
 #include "ScopedGILRelease.h"
 
 #include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
+#include <vector>
 
 #include "VectorMath.h"
 
@@ -22,10 +20,157 @@ using namespace tbb;
 
 namespace freud { namespace pmft {
 
-PMFTXYZ::PMFTXYZ(float max_x, float max_y, float max_z, unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_z, vec3<float> shiftvec)
-    : m_box(box::Box()), m_max_x(max_x), m_max_y(max_y), m_max_z(max_z),
-      m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_z(n_bins_z), m_frame_counter(0),
-      m_n_ref(0), m_n_p(0), m_n_faces(0), m_reduce(true), m_shiftvec(shiftvec)
+//! \internal
+//! Bin each pair by the coordinates of its vector in the frame of each face of the reference particle
+/*! Rotating by conj(ref_q), then by the face orientation qe, is rotating by Rqe transpose(Rref): these matrices are
+    computed once per reference particle, and stored by component so that the loops over the faces vectorize. The
+    face orientations of reference i start at i*face_stride: a stride of zero shares one set of faces between all the
+    reference particles, whose rotation matrices Rqe are then computed once instead of once per reference.
+
+    When folding, only the image of the largest 2x + y is binned, the rest of the images of the pair being its
+    copies under the symmetry operations. The score of each face is the dot product of the pair vector with a
+    direction computed once per reference particle, so that only the chosen image is rotated.
+*/
+class XYZMapping
+    {
+    public:
+        XYZMapping(float max_x, float max_y, float max_z, float dx, float dy, float dz, unsigned int n_bins_x,
+                   unsigned int n_bins_y, unsigned int n_bins_z, vec3<float> shiftvec,
+                   const quat<float> *ref_orientations, const quat<float> *face_orientations, unsigned int n_faces,
+                   unsigned int face_stride, bool fold)
+            : m_max_x(max_x), m_max_y(max_y), m_max_z(max_z), m_dx_inv(1.0f / dx), m_dy_inv(1.0f / dy),
+              m_dz_inv(1.0f / dz), m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_z(n_bins_z),
+              m_b_i(n_bins_x, n_bins_y, n_bins_z), m_face_stride(face_stride), m_shiftvec(shiftvec),
+              m_ref_orientations(ref_orientations), m_face_orientations(face_orientations), m_n_faces(n_faces),
+              m_fold(fold), m_face_rot(9*n_faces), m_face_score(3*n_faces), m_face_bins(3*n_faces)
+            {
+            if (m_face_stride == 0)
+                {
+                for (unsigned int k = 0; k < m_n_faces; k++)
+                    m_shared_face_rot.push_back(rotmat3<float>(m_face_orientations[k]));
+                }
+            }
+
+        void setReference(size_t i)
+            {
+            rotmat3<float> ref_rot(m_ref_orientations[i]);
+            const vec3<float> *ref_row = &ref_rot.row0;
+            float *rot = &m_face_rot[0];
+            for (unsigned int k = 0; k < m_n_faces; k++)
+                {
+                rotmat3<float> face_rot = (m_face_stride == 0) ? m_shared_face_rot[k] :
+                                          rotmat3<float>(m_face_orientations[i*m_face_stride + k]);
+                const vec3<float> *face_row = &face_rot.row0;
+                for (unsigned int a = 0; a < 3; a++)
+                    for (unsigned int b = 0; b < 3; b++)
+                        rot[(3*a+b)*m_n_faces + k] = dot(face_row[a], ref_row[b]);
+                }
+            if (m_fold)
+                {
+                // 2x + y of an image is the dot product of the pair vector with 2 row0 + row1 of its rotation
+                float *score = &m_face_score[0];
+                for (unsigned int b = 0; b < 3; b++)
+                    for (unsigned int k = 0; k < m_n_faces; k++)
+                        score[b*m_n_faces + k] = 2.0f*rot[b*m_n_faces + k] + rot[(3 + b)*m_n_faces + k];
+                }
+            }
+
+        void binPair(unsigned int j, const vec3<float>& delta, const PMFTBins& bins)
+            {
+            float rsq = dot(delta+m_shiftvec, delta+m_shiftvec);
+
+            // check that the particle is not checking itself
+            // 1e-6 is an arbitrary value that could be set differently if needed
+            if (rsq < 1e-6)
+                {
+                return;
+                }
+            if (m_fold)
+                {
+                binFolded(delta, bins);
+                return;
+                }
+            const unsigned int n_faces = m_n_faces;
+            const float *rot = &m_face_rot[0];
+            float *binx = &m_face_bins[0];
+            float *biny = binx + n_faces;
+            float *binz = biny + n_faces;
+            for (unsigned int k = 0; k < n_faces; k++)
+                {
+                // rotate the vector into the frame of the face
+                float x = rot[k]*delta.x + rot[n_faces + k]*delta.y + rot[2*n_faces + k]*delta.z + m_max_x;
+                float y = rot[3*n_faces + k]*delta.x + rot[4*n_faces + k]*delta.y + rot[5*n_faces + k]*delta.z + m_max_y;
+                float z = rot[6*n_faces + k]*delta.x + rot[7*n_faces + k]*delta.y + rot[8*n_faces + k]*delta.z + m_max_z;
+
+                // bin that point
+                binx[k] = floorf(x * m_dx_inv);
+                biny[k] = floorf(y * m_dy_inv);
+                binz[k] = floorf(z * m_dz_inv);
+                }
+            for (unsigned int k = 0; k < n_faces; k++)
+                {
+                unsigned int ibinx = binIndex(binx[k]);
+                unsigned int ibiny = binIndex(biny[k]);
+                unsigned int ibinz = binIndex(binz[k]);
+
+                // increment the bin
+                if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y) && (ibinz < m_n_bins_z))
+                    {
+                    bins(m_b_i(ibinx, ibiny, ibinz));
+                    }
+                }
+            }
+
+    private:
+        //! Bin only the image of the pair in the asymmetric unit
+        void binFolded(const vec3<float>& delta, const PMFTBins& bins)
+            {
+            const unsigned int n_faces = m_n_faces;
+            const float *score_dir = &m_face_score[0];
+            float *score = &m_face_bins[0];
+            for (unsigned int k = 0; k < n_faces; k++)
+                score[k] = score_dir[k]*delta.x + score_dir[n_faces + k]*delta.y + score_dir[2*n_faces + k]*delta.z;
+
+            // the first face of the largest score, ties being on the boundary of the asymmetric unit
+            unsigned int face = 0;
+            for (unsigned int k = 1; k < n_faces; k++)
+                if (score[k] > score[face])
+                    face = k;
+
+            const float *rot = &m_face_rot[0];
+            float x = rot[face]*delta.x + rot[n_faces + face]*delta.y + rot[2*n_faces + face]*delta.z + m_max_x;
+            float y = rot[3*n_faces + face]*delta.x + rot[4*n_faces + face]*delta.y + rot[5*n_faces + face]*delta.z + m_max_y;
+            float z = rot[6*n_faces + face]*delta.x + rot[7*n_faces + face]*delta.y + rot[8*n_faces + face]*delta.z + m_max_z;
+            unsigned int ibinx = binIndex(floorf(x * m_dx_inv));
+            unsigned int ibiny = binIndex(floorf(y * m_dy_inv));
+            unsigned int ibinz = binIndex(floorf(z * m_dz_inv));
+            if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y) && (ibinz < m_n_bins_z))
+                {
+                bins(m_b_i(ibinx, ibiny, ibinz));
+                }
+            }
+
+    private:
+        float m_max_x, m_max_y, m_max_z;
+        float m_dx_inv, m_dy_inv, m_dz_inv;
+        unsigned int m_n_bins_x, m_n_bins_y, m_n_bins_z;
+        Index3D m_b_i;
+        unsigned int m_face_stride;         //!< Number of face orientations between two reference particles
+        vec3<float> m_shiftvec;
+        const quat<float> *m_ref_orientations;
+        const quat<float> *m_face_orientations;
+        unsigned int m_n_faces;
+        bool m_fold;                        //!< True to bin only the image of the pair in the asymmetric unit
+        std::vector<float> m_face_rot;      //!< Rotations of the faces of the current reference, by component
+        std::vector<float> m_face_score;    //!< Directions of the 2x + y of the faces when folding, by component
+        std::vector<float> m_face_bins;     //!< Floored bins of the current pair, or its scores when folding, by face
+        std::vector< rotmat3<float> > m_shared_face_rot;  //!< Rotations of the faces shared by all the references
+    };
+
+PMFTXYZ::PMFTXYZ(float max_x, float max_y, float max_z, unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_z, vec3<float> shiftvec, bool fold)
+    : m_max_x(max_x), m_max_y(max_y), m_max_z(max_z),
+      m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_z(n_bins_z), m_n_faces(0), m_fold(fold), m_shiftvec(shiftvec),
+      m_engine(sqrtf(max_x*max_x + max_y*max_y + max_z*max_z), size_t(n_bins_x)*n_bins_y*n_bins_z)
     {
     if (n_bins_x < 1)
         throw invalid_argument("must be at least 1 bin in x");
@@ -80,87 +225,42 @@ PMFTXYZ::PMFTXYZ(float max_x, float max_y, float max_z, unsigned int n_bins_x, u
         float nextz = float(i+1) * m_dz;
         m_z_array.get()[i] = -m_max_z + ((z + nextz) / 2.0);
         }
-
-    m_lc = new locality::LinkCell(m_box, sqrtf(m_max_x*m_max_x + m_max_y*m_max_y + m_max_z*m_max_z));
-    // create and populate the pcf_array
-    m_pcf_array = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y*m_n_bins_z], std::default_delete<float[]>());
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_n_bins_x*m_n_bins_y*m_n_bins_z], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-
-    m_r_cut = sqrtf(m_max_x*m_max_x + m_max_y*m_max_y + m_max_z*m_max_z);
-
-    m_lc = new locality::LinkCell(m_box, m_r_cut);
-    }
-
-PMFTXYZ::~PMFTXYZ()
-    {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
-    delete m_lc;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTXYZ::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-    memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_z);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_n_bins_y; j++)
-                    {
-                    for (size_t k = 0; k < m_n_bins_z; k++)
-                        {
-                        for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                             local_bins != m_local_bin_counts.end(); ++local_bins)
-                            {
-                            m_bin_counts.get()[b_i((int)i, (int)j, (int)k)] += (*local_bins)[b_i((int)i, (int)j, (int)k)];
-                            }
-                        }
-                    }
-                }
-            });
-    float inv_num_dens = m_box.getVolume() / (float)m_n_p;
     float inv_jacobian = (float) 1.0 / (float) m_jacobian;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref * (float) m_n_faces);
-    // normalize pcf_array
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x*m_n_bins_y*m_n_bins_z),
-        [=] (const blocked_range<size_t>& r)
-            {
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * inv_jacobian * inv_num_dens;
-                }
-            });
+    m_engine.reduce((float) 1.0 / (float) m_n_faces, [=] (size_t) { return inv_jacobian; });
     }
 
 //! Get a reference to the PCF array
-std::shared_ptr<unsigned int> PMFTXYZ::getBinCounts()
+std::shared_ptr<util::BinCount> PMFTXYZ::getBinCounts()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_bin_counts;
+    reducePCF();
+    return m_engine.getBinCounts();
     }
 
 //! Get a reference to the PCF array
 std::shared_ptr<float> PMFTXYZ::getPCF()
     {
-    if (m_reduce == true)
-        {
-        reducePCF();
-        }
-    m_reduce = false;
-    return m_pcf_array;
+    reducePCF();
+    return m_engine.getPCF();
+    }
+
+//! Get a reference to the PMFT array
+std::shared_ptr<float> PMFTXYZ::getPMFT()
+    {
+    reducePCF();
+    return m_engine.getPMFT();
+    }
+
+//! Get a reference to the PCF of the weighted counts
+std::shared_ptr<float> PMFTXYZ::getWeightedPCF()
+    {
+    reducePCF();
+    return m_engine.getWeightedPCF();
     }
 
 //! \internal
@@ -168,12 +268,7 @@ std::shared_ptr<float> PMFTXYZ::getPCF()
 */
 void PMFTXYZ::resetPCF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-        }
-    m_frame_counter = 0;
-    m_reduce = true;
+    m_engine.reset();
     }
 
 //! \internal
@@ -187,112 +282,101 @@ void PMFTXYZ::accumulate(box::Box& box,
                         quat<float> *orientations,
                         unsigned int n_p,
                         quat<float> *face_orientations,
-                        unsigned int n_faces)
+                        unsigned int n_faces,
+                        const locality::NeighborList *nlist,
+                        const float *ref_weights,
+                        const float *weights)
+    {
+    accumulateFaces(box, ref_points, ref_orientations, n_ref, points, n_p, face_orientations, n_faces, n_faces,
+                    nlist, ref_weights, weights);
+    }
+
+void PMFTXYZ::accumulateSharedFaces(box::Box& box,
+                                    vec3<float> *ref_points,
+                                    quat<float> *ref_orientations,
+                                    unsigned int n_ref,
+                                    vec3<float> *points,
+                                    quat<float> *orientations,
+                                    unsigned int n_p,
+                                    quat<float> *face_orientations,
+                                    unsigned int n_faces,
+                                    const locality::NeighborList *nlist,
+                                    const float *ref_weights,
+                                    const float *weights)
     {
-    m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
-    parallel_for(blocked_range<size_t>(0,n_ref),
-        [=] (const blocked_range<size_t>& r)
+    accumulateFaces(box, ref_points, ref_orientations, n_ref, points, n_p, face_orientations, n_faces, 0, nlist,
+                    ref_weights, weights);
+    }
+
+//! \internal
+/*! \brief Accumulate a frame whose face orientations of reference i start at i*face_stride
+*/
+void PMFTXYZ::accumulateFaces(box::Box& box,
+                              const vec3<float> *ref_points,
+                              const quat<float> *ref_orientations,
+                              unsigned int n_ref,
+                              const vec3<float> *points,
+                              unsigned int n_p,
+                              const quat<float> *face_orientations,
+                              unsigned int n_faces,
+                              unsigned int face_stride,
+                              const locality::NeighborList *nlist,
+                              const float *ref_weights,
+                              const float *weights)
+    {
+    assert(n_faces > 0);
+    if (nlist == NULL && weights == NULL && m_engine.getUseGPU() && !m_fold)
+        {
+        const float r_cut = m_engine.getRCut(), max_x = m_max_x, max_y = m_max_y, max_z = m_max_z;
+        const float dx = m_dx, dy = m_dy, dz = m_dz;
+        const unsigned int n_bins_x = m_n_bins_x, n_bins_y = m_n_bins_y, n_bins_z = m_n_bins_z;
+        const vec3<float> shiftvec = m_shiftvec;
+        m_engine.accumulateGPU(box, n_ref, n_p,
+            [=, &box] (gpu::PairBinnerGPU& binner, util::BinCount *counts)
             {
-            assert(ref_points);
-            assert(points);
-            assert(n_ref > 0);
-            assert(n_p > 0);
-            assert(n_faces > 0);
-
-            // precalc some values for faster computation within the loop
-            float dx_inv = 1.0f / m_dx;
-            float dy_inv = 1.0f / m_dy;
-            float dz_inv = 1.0f / m_dz;
-
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_z);
-            Index2D q_i = Index2D(n_faces, n_p);
-
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_n_bins_x*m_n_bins_y*m_n_bins_z];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-                }
+            binner.binPMFTXYZ(box, ref_points, ref_orientations, n_ref, points, n_p, face_orientations, n_faces,
+                              face_stride, shiftvec, r_cut, max_x, max_y, max_z, dx, dy, dz, n_bins_x, n_bins_y,
+                              n_bins_z, counts);
+            });
+        m_n_faces = n_faces;
+        return;
+        }
+    XYZMapping mapping(m_max_x, m_max_y, m_max_z, m_dx, m_dy, m_dz, m_n_bins_x, m_n_bins_y, m_n_bins_z, m_shiftvec,
+                       ref_orientations, face_orientations, n_faces, face_stride, m_fold);
+    m_engine.accumulate(box, ref_points, n_ref, points, n_p, nlist, mapping, ref_weights, weights);
+    m_n_faces = n_faces;
+    }
 
-            // for each reference point
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                // get the cell the point is in
-                vec3<float> ref = ref_points[i];
-                // create the reference point quaternion
-                quat<float> ref_q(ref_orientations[i]);
-                unsigned int ref_cell = m_lc->getCell(ref);
-
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-                    {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
-                        {
-                        // make sure that the particles are wrapped into the box
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
-                        float rsq = dot(delta+m_shiftvec, delta+m_shiftvec);
-
-                        // check that the particle is not checking itself
-                        // 1e-6 is an arbitrary value that could be set differently if needed
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
-                        for (unsigned int k=0; k<n_faces; k++)
-                            {
-                            // create tmp vector
-                            vec3<float> my_vector(delta);
-                            // rotate vector
-                            // create the extra quaternion
-                            quat<float> qe(face_orientations[q_i(k, i)]);
-                            // create point vector
-                            vec3<float> v(delta);
-                            // rotate the vector
-                            v = rotate(conj(ref_q), v);
-                            v = rotate(qe, v);
-
-                            float x = v.x + m_max_x;
-                            float y = v.y + m_max_y;
-                            float z = v.z + m_max_z;
-
-                            // bin that point
-                            float binx = floorf(x * dx_inv);
-                            float biny = floorf(y * dy_inv);
-                            float binz = floorf(z * dz_inv);
-                            // fast float to int conversion with truncation
-                            #ifdef __SSE2__
-                            unsigned int ibinx = _mm_cvtt_ss2si(_mm_load_ss(&binx));
-                            unsigned int ibiny = _mm_cvtt_ss2si(_mm_load_ss(&biny));
-                            unsigned int ibinz = _mm_cvtt_ss2si(_mm_load_ss(&binz));
-                            #else
-                            unsigned int ibinx = (unsigned int)(binx);
-                            unsigned int ibiny = (unsigned int)(biny);
-                            unsigned int ibinz = (unsigned int)(binz);
-                            #endif
-
-                            // increment the bin
-                            if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y) && (ibinz < m_n_bins_z))
-                                {
-                                ++m_local_bin_counts.local()[b_i(ibinx, ibiny, ibinz)];
-                                }
-                            }
-                        }
-                    }
-                } // done looping over reference points
+void PMFTXYZ::accumulateFrames(const box::Box *boxes,
+                               vec3<float> *ref_points,
+                               quat<float> *ref_orientations,
+                               unsigned int n_ref,
+                               vec3<float> *points,
+                               quat<float> *orientations,
+                               unsigned int n_p,
+                               quat<float> *face_orientations,
+                               unsigned int n_faces,
+                               unsigned int n_frames)
+    {
+    assert(n_faces > 0);
+    const float max_x = m_max_x, max_y = m_max_y, max_z = m_max_z, dx = m_dx, dy = m_dy, dz = m_dz;
+    const unsigned int n_bins_x = m_n_bins_x, n_bins_y = m_n_bins_y, n_bins_z = m_n_bins_z;
+    const vec3<float> shiftvec = m_shiftvec;
+    const bool fold = m_fold;
+    m_engine.accumulateFrames(boxes, ref_points, n_ref, points, n_p, n_frames,
+        [=] (size_t f)
+            {
+            return XYZMapping(max_x, max_y, max_z, dx, dy, dz, n_bins_x, n_bins_y, n_bins_z, shiftvec,
+                              ref_orientations + f*n_ref, face_orientations, n_faces, n_faces, fold);
             });
-    m_frame_counter++;
-    m_n_ref = n_ref;
-    m_n_p = n_p;
     m_n_faces = n_faces;
-    // flag to reduce
-    m_reduce = true;
+    }
+
+std::vector<float> PMFTXYZ::getParameters() const
+    {
+    const float parameters[] = {m_max_x, m_max_y, m_max_z, float(m_n_bins_x), float(m_n_bins_y), float(m_n_bins_z),
+                                m_shiftvec.x, m_shiftvec.y, m_shiftvec.z, float(m_fold)};
+    return std::vector<float>(parameters, parameters + 10);
     }
 
 }; }; // end namespace freud::pmft
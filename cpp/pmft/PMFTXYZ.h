@@ -16,7 +16,9 @@
 
 #include "LinkCell.h"
 #include "box.h"
+#include "BinCount.h"
 #include "Index1D.h"
+#include "PMFTEngine.h"
 
 #ifndef _PMFTXYZ_H__
 #define _PMFTXYZ_H__
@@ -35,6 +37,14 @@ namespace freud { namespace pmft {
     The values of x, y, z to compute the pcf at are controlled by the xmax, ymax, zmax and n_bins_x, n_bins_y, n_bins_z parameters to the constructor.
     xmax, ymax, zmax determines the minimum/maximum x, y, z at which to compute the pcf and n_bins_x, n_bins_y, n_bins_z is the number of bins in x, y, z.
 
+    <b>Symmetry:</b><br>
+    The face orientations of a reference particle, typically the operations of its point group, give each pair one
+    image per face, all of which are binned. With \a fold, only the image in the asymmetric unit is binned: the image
+    of the largest 2x + y, which is the cone x >= y >= |z| for the 24 rotations of a cube. Each pair then costs one
+    increment instead of one per face and only the bins of the asymmetric unit are ever touched, so that the sparse
+    histograms of large grids shrink by the order of the group. Within the asymmetric unit, the bin counts and the PCF
+    are those of the unfolded PMFT, up to the bins that cross its boundary; the bins outside it stay empty.
+
     <b>2D:</b><br>
     This PCF works for 3D boxes (while it will work for 2D boxes, you should use the 2D version).
 */
@@ -42,22 +52,21 @@ class PMFTXYZ
     {
     public:
         //! Constructor
-        PMFTXYZ(float max_x, float max_y, float max_z, unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_z, vec3<float> shiftvec);
-
-        //! Destructor
-        ~PMFTXYZ();
+        PMFTXYZ(float max_x, float max_y, float max_z, unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_z, vec3<float> shiftvec,
+                bool fold=false);
 
         //! Get the simulation box
         const box::Box& getBox() const
             {
-            return m_box;
+            return m_engine.getBox();
             }
 
         //! Reset the PCF array to all zeros
         void resetPCF();
 
         /*! Compute the PCF for the passed in set of points. The function will be added to previous values
-            of the pcf
+            of the pcf. When \a ref_weights and \a weights are given, each pair also adds the product of the weights
+            of its points to the weighted counts of getWeightedPCF(), and the GPU is not used.
         */
         void accumulate(box::Box& box,
                         vec3<float> *ref_points,
@@ -67,17 +76,81 @@ class PMFTXYZ
                         quat<float> *orientations,
                         unsigned int n_p,
                         quat<float> *face_orientations,
-                        unsigned int n_faces);
+                        unsigned int n_faces,
+                        const locality::NeighborList *nlist=NULL,
+                        const float *ref_weights=NULL,
+                        const float *weights=NULL);
+
+        //! Compute the PCF as accumulate(), with one set of n_faces face orientations shared by all the reference points
+        /*! This saves building the n_ref x n_faces array of face orientations of accumulate() when all the particles
+            have the same faces, and the rotation matrices of the faces are computed once for all the references.
+        */
+        void accumulateSharedFaces(box::Box& box,
+                                   vec3<float> *ref_points,
+                                   quat<float> *ref_orientations,
+                                   unsigned int n_ref,
+                                   vec3<float> *points,
+                                   quat<float> *orientations,
+                                   unsigned int n_p,
+                                   quat<float> *face_orientations,
+                                   unsigned int n_faces,
+                                   const locality::NeighborList *nlist=NULL,
+                                   const float *ref_weights=NULL,
+                                   const float *weights=NULL);
+
+        //! Accumulate the PCF of a stack of frames, as calling accumulate() for each frame would
+        /*! Frame f is made of boxes[f], the n_ref reference points and orientations from f*n_ref and the n_p points
+            and orientations from f*n_p, with the same face orientations in every frame. The frames are processed in parallel, each task reusing one cell list.
+        */
+        void accumulateFrames(const box::Box *boxes,
+                              vec3<float> *ref_points,
+                              quat<float> *ref_orientations,
+                              unsigned int n_ref,
+                              vec3<float> *points,
+                              quat<float> *orientations,
+                              unsigned int n_p,
+                              quat<float> *face_orientations,
+                              unsigned int n_faces,
+                              unsigned int n_frames);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
         void reducePCF();
 
+        //! Save the accumulated histogram, the number of frames and the box and numbers of points of the last frame
+        //! to a checkpoint file
+        void saveState(const std::string& filename)
+            {
+            m_engine.saveState(filename, "PMFTXYZ", getParameters());
+            }
+
+        //! Restore the state of a checkpoint file, or add it to the accumulated state if merge
+        /*! The bins must be the same.
+        */
+        void loadState(const std::string& filename, bool merge=false)
+            {
+            m_engine.loadState(filename, "PMFTXYZ", getParameters(), merge);
+            }
+
+        //! Add the accumulated state of another PMFTXYZ of the same bins, such as one of another chunk of a trajectory
+        void merge(const PMFTXYZ& other)
+            {
+            if (other.getParameters() != getParameters())
+                throw std::invalid_argument("Only PMFTXYZs of the same bins can be merged");
+            m_engine.merge(other.m_engine);
+            }
+
         //! Get a reference to the PCF array
         std::shared_ptr<float> getPCF();
 
+        //! Get a reference to the PMFT array, -log(PCF), computed with the PCF
+        std::shared_ptr<float> getPMFT();
+
+        //! Get a reference to the PCF of the weighted counts, normalized as the PCF
+        std::shared_ptr<float> getWeightedPCF();
+
         //! Get a reference to the bin counts array
-        std::shared_ptr<unsigned int> getBinCounts();
+        std::shared_ptr<util::BinCount> getBinCounts();
 
         //! Get a reference to the x array
         std::shared_ptr<float> getX()
@@ -104,7 +177,103 @@ class PMFTXYZ
 
         float getRCut()
             {
-            return m_r_cut;
+            return m_engine.getRCut();
+            }
+
+        //! Whether the per-thread histograms are sparse, as they are for grids of at least
+        //! util::SPARSE_HISTOGRAM_MIN_BINS bins or beyond the memory limit
+        bool getSparse()
+            {
+            return m_engine.getSparse();
+            }
+
+        //! Set whether the threads count the pairs in one shared histogram (see PMFTEngine::setAtomicHistogram)
+        void setAtomicHistogram(bool atomic)
+            {
+            m_engine.setAtomicHistogram(atomic);
+            }
+
+        //! Get whether the threads count the pairs in one shared histogram
+        bool getAtomicHistogram() const
+            {
+            return m_engine.getAtomicHistogram();
+            }
+
+        //! Set the most bytes the dense per-thread histograms may take together, 0 for no limit (see
+        //! PMFTEngine::setMemoryLimit)
+        void setMemoryLimit(size_t bytes)
+            {
+            m_engine.setMemoryLimit(bytes);
+            }
+
+        //! Get the most bytes the dense per-thread histograms may take together
+        size_t getMemoryLimit() const
+            {
+            return m_engine.getMemoryLimit();
+            }
+
+        //! Get the bytes allocated by each component
+        util::MemoryUsage getMemoryUsage() const
+            {
+            return m_engine.getMemoryUsage();
+            }
+
+        //! Estimate the bytes of each component after accumulate() of N reference points and N points on
+        //! num_threads threads, 0 for those of the current task arena
+        util::MemoryUsage estimateMemory(unsigned int N, unsigned int num_threads) const
+            {
+            return m_engine.estimateMemory(N, num_threads);
+            }
+
+        //! Set how the loop over the reference points of accumulate() is split between the threads
+        void setPartitionMode(locality::PartitionMode mode)
+            {
+            m_engine.setPartitionMode(mode);
+            }
+
+        //! Get how the loop of accumulate() is split between the threads
+        locality::PartitionMode getPartitionMode() const
+            {
+            return m_engine.getPartitionMode();
+            }
+
+        //! Set whether the reference points are visited in the order of their cells, for large numbers of them
+        void setCellOrder(bool cell_order)
+            {
+            m_engine.setCellOrder(cell_order);
+            }
+
+        //! Get whether the reference points are visited in the order of their cells
+        bool getCellOrder() const
+            {
+            return m_engine.getCellOrder();
+            }
+
+        //! Share a LinkCell with other analyses of the same points, or use an own one again if \a lc is NULL
+        void setLinkCell(std::shared_ptr<locality::LinkCell> lc)
+            {
+            m_engine.setLinkCell(lc);
+            }
+
+        //! Set whether accumulate() bins the pairs on a CUDA GPU when no neighbor list is given
+        /*! Throws std::runtime_error when freud was built without CUDA or no device is found. When folding, the pairs are
+            always binned on the CPU.
+        */
+        void setUseGPU(bool use_gpu)
+            {
+            m_engine.setUseGPU(use_gpu);
+            }
+
+        //! Get whether accumulate() bins the pairs on the GPU
+        bool getUseGPU() const
+            {
+            return m_engine.getUseGPU();
+            }
+
+        //! Whether each pair is only binned in the asymmetric unit of the face orientations
+        bool getFold()
+            {
+            return m_fold;
             }
 
         unsigned int getNBinsX()
@@ -123,32 +292,41 @@ class PMFTXYZ
             }
 
     private:
-        box::Box m_box;            //!< Simulation box the particles belong in
+        //! Parameters of the bins, which the checkpoints are checked against
+        std::vector<float> getParameters() const;
+
+        //! Accumulate a frame whose face orientations of reference i start at i*face_stride
+        void accumulateFaces(box::Box& box,
+                             const vec3<float> *ref_points,
+                             const quat<float> *ref_orientations,
+                             unsigned int n_ref,
+                             const vec3<float> *points,
+                             unsigned int n_p,
+                             const quat<float> *face_orientations,
+                             unsigned int n_faces,
+                             unsigned int face_stride,
+                             const locality::NeighborList *nlist,
+                             const float *ref_weights,
+                             const float *weights);
+
         float m_max_x;                     //!< Maximum x at which to compute pcf
         float m_max_y;                     //!< Maximum y at which to compute pcf
         float m_max_z;                     //!< Maximum z at which to compute pcf
         float m_dx;                       //!< Step size for x in the computation
         float m_dy;                       //!< Step size for y in the computation
         float m_dz;                       //!< Step size for z in the computation
-        locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
         unsigned int m_n_bins_x;             //!< Number of x bins to compute pcf over
         unsigned int m_n_bins_y;             //!< Number of y bins to compute pcf over
         unsigned int m_n_bins_z;             //!< Number of z bins to compute pcf over
-        float m_r_cut;                      //!< r_cut used in cell list construction
-        unsigned int m_frame_counter;       //!< number of frames calc'd
-        unsigned int m_n_ref;
-        unsigned int m_n_p;
         unsigned int m_n_faces;
+        bool m_fold;                       //!< True to bin each pair in the asymmetric unit only
         float m_jacobian;
-        bool m_reduce;
         vec3<float> m_shiftvec;            //!< vector that points from [0,0,0] to the origin of the pmft
 
-        std::shared_ptr<float> m_pcf_array;         //!< array of pcf computed
-        std::shared_ptr<unsigned int> m_bin_counts;         //!< array of pcf computed
         std::shared_ptr<float> m_x_array;           //!< array of x values that the pcf is computed at
         std::shared_ptr<float> m_y_array;           //!< array of y values that the pcf is computed at
         std::shared_ptr<float> m_z_array;           //!< array of z values that the pcf is computed at
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
+        PMFTEngine m_engine;                        //!< Pair traversal and histograms
     };
 
 }; }; // end namespace freud::pmft
@@ -0,0 +1,50 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "BatchKabsch.h"
+#include "KabschKernel.h"
+
+#include <stdexcept>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file BatchKabsch.cc
+    \brief Alignment of many sets of points with known correspondences at once
+*/
+
+namespace freud { namespace registration {
+
+void alignBatchCPU(const float *points, const float *ref_points, unsigned int num_sets, unsigned int num_points,
+                   unsigned int ref_stride, float *rotations, float *rmsds)
+    {
+    const size_t stride = 3*size_t(num_points);
+    parallel_for(blocked_range<size_t>(0, num_sets),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t s = r.begin(); s != r.end(); s++)
+            kabschAlign(points + stride*s, ref_points + ref_stride*s, num_points, rotations + 9*s, rmsds + s);
+        });
+    }
+
+BatchKabsch::BatchKabsch()
+    : m_num_sets(0), m_num_points(0)
+    {
+    }
+
+void BatchKabsch::compute(const vec3<float> *points, const vec3<float> *ref_points, unsigned int num_sets,
+                          unsigned int num_points, bool shared_ref)
+    {
+    if (num_points == 0)
+        throw invalid_argument("Each set must have at least one point");
+
+    m_rotations = std::shared_ptr<float>(new float[9*num_sets], std::default_delete<float[]>());
+    m_rmsds = std::shared_ptr<float>(new float[num_sets], std::default_delete<float[]>());
+    m_num_sets = num_sets;
+    m_num_points = num_points;
+
+    alignBatchCPU((const float*) points, (const float*) ref_points, num_sets, num_points,
+                  shared_ref ? 0 : 3*num_points, m_rotations.get(), m_rmsds.get());
+    }
+
+}; }; // end namespace freud::registration
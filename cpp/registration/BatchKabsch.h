@@ -0,0 +1,89 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#ifndef _BATCH_KABSCH_H__
+#define _BATCH_KABSCH_H__
+
+/*! \file BatchKabsch.h
+    \brief Alignment of many sets of points with known correspondences at once
+*/
+
+namespace freud { namespace registration {
+
+//! Align each of num_sets sets of points on the CPU, in parallel over the sets
+/*! \param points num_sets sets of 3 \a num_points coordinates
+    \param ref_points Reference sets of 3 \a num_points coordinates, \a ref_stride floats apart
+    \param num_sets Number of sets
+    \param num_points Number of points of each set
+    \param ref_stride 0 to align every set with the same reference set, 3 \a num_points otherwise
+    \param rotations Output: 9 num_sets floats, the rotation of each set by rows
+    \param rmsds Output: num_sets floats, the RMSD of each set after its rotation
+
+    Each set is aligned independently by kabschAlign from KabschKernel.h. A device backend implements the same
+    signature on device arrays, with one thread per set calling the same kabschAlign.
+*/
+void alignBatchCPU(const float *points, const float *ref_points, unsigned int num_sets, unsigned int num_points,
+                   unsigned int ref_stride, float *rotations, float *rmsds);
+
+//! Find the rotations that best align a batch of sets of points with their reference sets
+/*! Point i of a set goes to point i of its reference set, as in KabschAlgorithm of brute_force.h, and the points are
+    not translated. Each rotation R minimizes sum_i |R p_i - q_i|^2, from the closed form of quaternionRotation, so
+    that many small sets (such as the environments of the particles of a system) are aligned without an SVD or any
+    allocation per set.
+*/
+class BatchKabsch
+    {
+    public:
+        //! Constructor
+        BatchKabsch();
+
+        //! Align each set of points with its reference set
+        /*! \param points num_sets num_points points
+            \param ref_points num_points points if \a shared_ref, num_sets num_points points otherwise
+            \param num_sets Number of sets
+            \param num_points Number of points of each set
+            \param shared_ref true to align every set with the same reference set
+        */
+        void compute(const vec3<float> *points, const vec3<float> *ref_points, unsigned int num_sets,
+                     unsigned int num_points, bool shared_ref);
+
+        //! Get the number of sets of the last compute
+        unsigned int getNumSets()
+            {
+            return m_num_sets;
+            }
+
+        //! Get the number of points of each set of the last compute
+        unsigned int getNumPoints()
+            {
+            return m_num_points;
+            }
+
+        //! Get the 3x3 rotation of each set, by rows
+        std::shared_ptr<float> getRotations()
+            {
+            return m_rotations;
+            }
+
+        //! Get the RMSD of each set after its rotation
+        std::shared_ptr<float> getRMSDs()
+            {
+            return m_rmsds;
+            }
+
+    private:
+        unsigned int m_num_sets;                //!< Number of sets of the last compute
+        unsigned int m_num_points;              //!< Number of points of each set
+        std::shared_ptr<float> m_rotations;     //!< Rotation of each set, by rows
+        std::shared_ptr<float> m_rmsds;         //!< RMSD of each set
+    };
+
+}; }; // end namespace freud::registration
+
+#endif // _BATCH_KABSCH_H__
@@ -0,0 +1,252 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <math.h>
+
+#include "HOOMDMath.h"
+
+#ifndef _KABSCH_KERNEL_H__
+#define _KABSCH_KERNEL_H__
+
+/*! \file KabschKernel.h
+    \brief Alignment of one set of points with known correspondences, for the host and the device
+*/
+
+namespace freud { namespace registration {
+
+//! \internal
+//! Determinant of the 3x3 matrix of rows (a0 a1 a2), (b0 b1 b2), (c0 c1 c2)
+HOSTDEVICE inline double det3(double a0, double a1, double a2, double b0, double b1, double b2,
+                              double c0, double c1, double c2)
+    {
+    return a0*(b1*c2 - b2*c1) - a1*(b0*c2 - b2*c0) + a2*(b0*c1 - b1*c0);
+    }
+
+//! \internal
+//! Eigenvector of the largest eigenvalue of the symmetric 4x4 matrix K, by cyclic Jacobi rotations
+/*! Only used when the largest eigenvalue is degenerate, where any vector of its eigenspace will do.
+*/
+HOSTDEVICE inline void jacobiLargestEigenvector4(const double K[4][4], double quat[4])
+    {
+    double A[4][4], V[4][4];
+    for (unsigned int i = 0; i < 4; i++)
+        for (unsigned int j = 0; j < 4; j++)
+            {
+            A[i][j] = K[i][j];
+            V[i][j] = (i == j) ? 1.0 : 0.0;
+            }
+
+    for (unsigned int sweep = 0; sweep < 32; sweep++)
+        {
+        double off = 0.0;
+        for (unsigned int i = 0; i < 4; i++)
+            for (unsigned int j = i+1; j < 4; j++)
+                off += A[i][j]*A[i][j];
+        if (off < 1e-30)
+            break;
+
+        for (unsigned int p = 0; p < 4; p++)
+            for (unsigned int q = p+1; q < 4; q++)
+                {
+                if (A[p][q] == 0.0)
+                    continue;
+                double theta = 0.5*(A[q][q] - A[p][p])/A[p][q];
+                double t = ((theta >= 0.0) ? 1.0 : -1.0)/(fabs(theta) + sqrt(theta*theta + 1.0));
+                double c = 1.0/sqrt(t*t + 1.0);
+                double s = t*c;
+                for (unsigned int k = 0; k < 4; k++)
+                    {
+                    double akp = A[k][p], akq = A[k][q];
+                    A[k][p] = c*akp - s*akq;
+                    A[k][q] = s*akp + c*akq;
+                    }
+                for (unsigned int k = 0; k < 4; k++)
+                    {
+                    double apk = A[p][k], aqk = A[q][k];
+                    A[p][k] = c*apk - s*aqk;
+                    A[q][k] = s*apk + c*aqk;
+                    }
+                for (unsigned int k = 0; k < 4; k++)
+                    {
+                    double vkp = V[k][p], vkq = V[k][q];
+                    V[k][p] = c*vkp - s*vkq;
+                    V[k][q] = s*vkp + c*vkq;
+                    }
+                }
+        }
+
+    unsigned int largest = 0;
+    for (unsigned int i = 1; i < 4; i++)
+        if (A[i][i] > A[largest][largest])
+            largest = i;
+    for (unsigned int k = 0; k < 4; k++)
+        quat[k] = V[k][largest];
+    }
+
+//! Find the rotation R, by rows, that minimizes sum_i |R p_i - q_i|^2 from the correlation matrix S = sum_i p_i q_i^T
+/*! \param S Correlation matrix of the points p_i and the reference points q_i
+    \param norms sum_i |p_i|^2 + |q_i|^2, from which Newton's method starts
+    \param R Output: the rotation by rows
+
+    This is the closed form of KabschAlgorithm in brute_force.h, from the unit quaternion of the rotation
+    (B. K. P. Horn, J. Opt. Soc. Am. A 4, 629 (1987); D. L. Theobald, Acta Cryst. A61, 478 (2005)): the quaternion is
+    the eigenvector of the largest eigenvalue of a symmetric, traceless 4x4 matrix built from S. The eigenvalue is
+    found by Newton's method on the characteristic polynomial and the eigenvector from the adjugate, on plain arrays
+    with no allocation, library call or shared state, so that it runs unchanged in a CUDA thread.
+*/
+HOSTDEVICE inline void quaternionRotation(const double S[3][3], double norms, double R[9])
+    {
+    const double Sxx = S[0][0], Sxy = S[0][1], Sxz = S[0][2];
+    const double Syx = S[1][0], Syy = S[1][1], Syz = S[1][2];
+    const double Szx = S[2][0], Szy = S[2][1], Szz = S[2][2];
+    const double K[4][4] = {
+        {Sxx+Syy+Szz, Syz-Szy, Szx-Sxz, Sxy-Syx},
+        {Syz-Szy, Sxx-Syy-Szz, Sxy+Syx, Szx+Sxz},
+        {Szx-Sxz, Sxy+Syx, -Sxx+Syy-Szz, Syz+Szy},
+        {Sxy-Syx, Szx+Sxz, Syz+Szy, -Sxx-Syy+Szz}};
+
+    // K is traceless, so its characteristic polynomial is x^4 + c2 x^2 + c1 x + c0
+    double K2[4][4];
+    double trK2 = 0.0, trK3 = 0.0;
+    for (unsigned int i = 0; i < 4; i++)
+        for (unsigned int j = 0; j < 4; j++)
+            {
+            double sum = 0.0;
+            for (unsigned int k = 0; k < 4; k++)
+                sum += K[i][k]*K[k][j];
+            K2[i][j] = sum;
+            }
+    for (unsigned int i = 0; i < 4; i++)
+        {
+        trK2 += K2[i][i];
+        for (unsigned int k = 0; k < 4; k++)
+            trK3 += K2[i][k]*K[k][i];
+        }
+    double detK = 0.0;
+    for (unsigned int c = 0; c < 4; c++)
+        {
+        unsigned int k0 = (c == 0) ? 1 : 0;
+        unsigned int k1 = (c <= 1) ? 2 : 1;
+        unsigned int k2 = (c <= 2) ? 3 : 2;
+        double minor = det3(K[1][k0], K[1][k1], K[1][k2], K[2][k0], K[2][k1], K[2][k2],
+                            K[3][k0], K[3][k1], K[3][k2]);
+        detK += ((c % 2) ? -1.0 : 1.0)*K[0][c]*minor;
+        }
+    const double c2 = -0.5*trK2;
+    const double c1 = -trK3/3.0;
+    const double c0 = detK;
+
+    // Newton's method, from (|P|^2 + |Q|^2)/2, decreases monotonically to the largest eigenvalue
+    double lambda = 0.5*norms;
+    for (unsigned int it = 0; it < 50; it++)
+        {
+        double x2 = lambda*lambda;
+        double f = (x2 + c2)*x2 + c1*lambda + c0;
+        double df = 4.0*x2*lambda + 2.0*c2*lambda + c1;
+        if (df == 0.0)
+            break;
+        double delta = f/df;
+        lambda -= delta;
+        if (fabs(delta) <= 1e-11*fabs(lambda))
+            break;
+        }
+
+    // the quaternion is the column of the adjugate of K - lambda with the largest norm
+    double M[4][4];
+    for (unsigned int i = 0; i < 4; i++)
+        for (unsigned int j = 0; j < 4; j++)
+            M[i][j] = K[i][j] - ((i == j) ? lambda : 0.0);
+    double quat[4] = {1.0, 0.0, 0.0, 0.0};
+    double quat_normsq = 0.0;
+    for (unsigned int k = 0; k < 4; k++)
+        {
+        unsigned int r0 = (k == 0) ? 1 : 0;
+        unsigned int r1 = (k <= 1) ? 2 : 1;
+        unsigned int r2 = (k <= 2) ? 3 : 2;
+        double col[4];
+        double normsq = 0.0;
+        for (unsigned int c = 0; c < 4; c++)
+            {
+            unsigned int cc0 = (c == 0) ? 1 : 0;
+            unsigned int cc1 = (c <= 1) ? 2 : 1;
+            unsigned int cc2 = (c <= 2) ? 3 : 2;
+            col[c] = ((c % 2) ? -1.0 : 1.0)*det3(M[r0][cc0], M[r0][cc1], M[r0][cc2], M[r1][cc0], M[r1][cc1],
+                                                 M[r1][cc2], M[r2][cc0], M[r2][cc1], M[r2][cc2]);
+            normsq += col[c]*col[c];
+            }
+        if (normsq > quat_normsq)
+            {
+            for (unsigned int c = 0; c < 4; c++)
+                quat[c] = col[c];
+            quat_normsq = normsq;
+            }
+        }
+
+    // when the largest eigenvalue is degenerate, the adjugate vanishes
+    double scale = lambda*lambda*lambda;
+    if (quat_normsq <= 1e-16*scale*scale)
+        jacobiLargestEigenvector4(K, quat);
+    else
+        {
+        double inv_norm = 1.0/sqrt(quat_normsq);
+        for (unsigned int c = 0; c < 4; c++)
+            quat[c] *= inv_norm;
+        }
+
+    const double w = quat[0], x = quat[1], y = quat[2], z = quat[3];
+    R[0] = w*w+x*x-y*y-z*z; R[1] = 2.0*(x*y-w*z); R[2] = 2.0*(x*z+w*y);
+    R[3] = 2.0*(x*y+w*z); R[4] = w*w-x*x+y*y-z*z; R[5] = 2.0*(y*z-w*x);
+    R[6] = 2.0*(x*z-w*y); R[7] = 2.0*(y*z+w*x); R[8] = w*w-x*x-y*y+z*z;
+    }
+
+//! Find the rotation that best aligns a set of points with a reference set, point i going to reference point i
+/*! \param points 3 \a N coordinates of the points
+    \param ref_points 3 \a N coordinates of the reference points
+    \param N Number of points
+    \param rotation Output: the 3x3 rotation R, by rows, that minimizes sum_i |R p_i - q_i|^2
+    \param rmsd Output: sqrt(sum_i |R p_i - q_i|^2 / N)
+
+    The points are not translated: they are typically the vectors of a local environment, which are already relative
+    to its center.
+*/
+HOSTDEVICE inline void kabschAlign(const float *points, const float *ref_points, unsigned int N, float *rotation,
+                                   float *rmsd)
+    {
+    // the correlation matrix of the points and the reference points, and their squared norms
+    double S[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+    double norms = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        const float *p = points + 3*i;
+        const float *q = ref_points + 3*i;
+        for (unsigned int a = 0; a < 3; a++)
+            {
+            for (unsigned int b = 0; b < 3; b++)
+                S[a][b] += double(p[a])*double(q[b]);
+            norms += double(p[a])*double(p[a]) + double(q[a])*double(q[a]);
+            }
+        }
+
+    double R[9];
+    quaternionRotation(S, norms, R);
+    for (unsigned int k = 0; k < 9; k++)
+        rotation[k] = float(R[k]);
+
+    // the RMSD from the rotated points, which keeps its precision for well aligned sets
+    double msd = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        const float *p = points + 3*i;
+        const float *q = ref_points + 3*i;
+        for (unsigned int a = 0; a < 3; a++)
+            {
+            double d = R[3*a]*p[0] + R[3*a+1]*p[1] + R[3*a+2]*p[2] - q[a];
+            msd += d*d;
+            }
+        }
+    *rmsd = (N > 0) ? float(sqrt(msd/double(N))) : 0.0f;
+    }
+
+}; }; // end namespace freud::registration
+
+#endif // _KABSCH_KERNEL_H__
@@ -4,8 +4,7 @@
 // stdlib include
 #include <iostream>
 #include <vector>
-#include <random>
-#include <chrono>
+#include <algorithm>
 // boost include
 #include <boost/python.hpp>
 #include <boost/shared_ptr.hpp>
@@ -19,6 +18,9 @@
 #include "Eigen/Dense"
 #include "Eigen/Sparse"
 
+#include "KabschKernel.h"
+#include "RandomStream.h"
+
 #ifndef BRUTE_FORCE_H
 #define BRUTE_FORCE_H
 
@@ -26,6 +28,12 @@ namespace freud { namespace registration {
 
 typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> matrix;
 
+// Largest number of points registered with matrices of fixed maximal size, which live on the stack
+const int max_small_points = 32;
+typedef Eigen::Matrix<double, Eigen::Dynamic, 3, 0, max_small_points, 3> small_matrix;
+// Up to three points, as the anchors of the accelerated registration
+typedef Eigen::Matrix<double, Eigen::Dynamic, 3, 0, 3, 3> anchor_matrix;
+
 inline matrix makeEigenMatrix(const std::vector<vec3<float> >& vecs)
 {
     // build the Eigen matrix
@@ -133,6 +141,20 @@ inline void KabschAlgorithm(const matrix& P, const matrix& Q, matrix& Rotation)
     Rotation= V*U.transpose();
 }
 
+// The closed form of the KabschAlgorithm for points in 3D, from the unit quaternion of the rotation: see
+// quaternionRotation in KabschKernel.h. It finds the rotation without a general SVD.
+template<class MatrixP, class MatrixQ>
+inline void KabschQuaternion(const Eigen::MatrixBase<MatrixP>& P, const Eigen::MatrixBase<MatrixQ>& Q, Eigen::Matrix3d& Rotation)
+{
+    Eigen::Matrix3d A = P.transpose()*Q;
+    double S[3][3], R[9];
+    for (unsigned int a = 0; a < 3; a++)
+        for (unsigned int b = 0; b < 3; b++)
+            S[a][b] = A(a, b);
+    quaternionRotation(S, P.squaredNorm() + Q.squaredNorm(), R);
+    Rotation = Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor> >(R);
+}
+
 inline void AlignVectorSets(matrix& P,matrix& Q, matrix* pRotation = NULL)
 {
     // Aligns p with q.
@@ -161,7 +183,8 @@ class RegisterBruteForce  // : public Register
     using value = std::pair<point, unsigned int>;
 
     public:
-        RegisterBruteForce(std::vector<vec3<float> > vecs) : m_rmsd(0.0), m_tol(1e-6), m_shuffles(1)
+        RegisterBruteForce(std::vector<vec3<float> > vecs) : m_rmsd(0.0), m_tol(1e-6), m_shuffles(1),
+            m_accelerated(false), m_prune_tol(-1.0), m_seed(0)
         {
             // make the Eigen matrix from vecs
             m_data = makeEigenMatrix(vecs);
@@ -171,6 +194,7 @@ class RegisterBruteForce  // : public Register
                 m_rtree.insert(std::make_pair(make_point<matrix>(m_data.row(r)), r));
             // m_data = Translate(-CenterOfMass(m_data), m_data);
 
+            FindAnchors();
         }
         ~RegisterBruteForce(){}
 
@@ -192,18 +216,32 @@ class RegisterBruteForce  // : public Register
                 fprintf(stderr, "Number of vecs we are trying to match is %d\n", N);
                 throw std::invalid_argument("Brute force matching requires the same number of points!");
             }
-            RandomNumber<std::mt19937_64> rng;
+            if (m_accelerated)
+            {
+                // small sets of points are registered without any allocation in the loop over the correspondences
+                if (N <= (unsigned int) max_small_points)
+                    FitAnchors(small_matrix(points));
+                else
+                    FitAnchors(points);
+                // The rotation that we've found from the KabschAlgorithm actually acts on P^T.
+                matrix ptsT = Rotate(m_rotation, points.transpose());
+                pts = makeVec3Matrix(ptsT.transpose());
+                return true;
+            }
+            // the triplets of reference vectors tried are drawn from a stream that only depends on the seed, so that
+            // a fit gives the same result on every call and from any thread, without seeding a generator per call
+            util::RandomStream rng(m_seed, 0, 0);
             double rmsd_min = -1.0;
             for (size_t shuffles = 0; shuffles < m_shuffles; shuffles++)
             {
                 int p0 = 0, p1 = 0, p2 = 0;
                 while ( p0 == p1 || p0 == p2 || p1 == p2)
                 {
-                    p0 = rng.random_int(0,N-1);
+                    p0 = rng.randomInt(0,N-1);
                     if (N == int(1)) { p1 = int(-2); }
-                    else { p1 = rng.random_int(0,N-1); }
+                    else { p1 = rng.randomInt(0,N-1); }
                     if (N == int(2) || N == int(1)) { p2 = int(-1); }
-                    else { p2 = rng.random_int(0,N-1); }
+                    else { p2 = rng.randomInt(0,N-1); }
                 }
 
                 size_t comb[3] = {0, 1, 2};
@@ -299,6 +337,20 @@ class RegisterBruteForce  // : public Register
 
         void setTol(double tol) { m_tol = tol; }
 
+        // Seed of the random choice of the reference vectors matched by each shuffle of the unaccelerated fit
+        void setSeed(unsigned int seed) { m_seed = seed; }
+
+        // The accelerated registration only matches the anchors of the reference vectors, chosen once from their
+        // geometry, to the points, instead of three random vectors. The correspondences are tried from the most to
+        // the least consistent with the lengths of the anchors and the distances between them, and each rotation is
+        // found by KabschQuaternion instead of an SVD.
+        void setAccelerated(bool accelerated) { m_accelerated = accelerated; }
+
+        // With the accelerated registration, skip the correspondences whose lengths differ from those of the anchors
+        // by more than tol, or whose distances differ from those between the anchors by more than 2 tol: no rotation
+        // of such points brings them within tol of the anchors. A negative tol tries all the correspondences.
+        void setPruneTol(double tol) { m_prune_tol = tol; }
+
         // This uses an R-tree to efficiently determine pairs of points that are closest, next closest, etc to each other.
         // NOTE that this does not guarantee an absolutely minimal RMSD. It doesn't figure out the optimal permutation
         // of BOTH sets of vectors to minimize the RMSD. Rather, it just figures out the optimal permutation of the second
@@ -306,6 +358,78 @@ class RegisterBruteForce  // : public Register
         // To fully solve this, we need to use the Hungarian algorithm or some other way of solving the
         // so-called assignment problem.
         double AlignedRMSDTree(const matrix& points, boost::bimap<unsigned int, unsigned int>& m)
+        {
+            std::vector<unsigned int> ref_of_point(points.rows());
+            double rmsd = AlignedRMSDMap(points, ref_of_point.size() ? &ref_of_point[0] : NULL);
+
+            // a mapping between the vectors of m_data and the vectors of points
+            boost::bimap<unsigned int, unsigned int> vec_map;
+            for (unsigned int r = 0; r < ref_of_point.size(); r++)
+                vec_map.insert(boost::bimap<unsigned int, unsigned int>::value_type(ref_of_point[r], r));
+            m = vec_map;
+            return rmsd;
+        }
+
+    private:
+
+        // Choose the anchors of the accelerated registration: the two reference vectors spanning the largest area,
+        // then the one farthest out of their plane. They depend on the geometry of the vectors only, not on their
+        // orientation, and make rotations found from three correspondences as well conditioned as they can be.
+        void FindAnchors()
+        {
+            unsigned int N = m_data.rows();
+            m_anchors.clear();
+            if (N == 0)
+                return;
+            if (N < 3)
+            {
+                for (unsigned int i = 0; i < N; i++)
+                    m_anchors.push_back(i);
+            }
+            else
+            {
+                unsigned int a0 = 0, a1 = 1, a2 = 2;
+                double max_area = -1.0;
+                for (unsigned int i = 0; i < N; i++)
+                    for (unsigned int j = i+1; j < N; j++)
+                    {
+                        Eigen::Vector3d vi = m_data.row(i).transpose();
+                        Eigen::Vector3d vj = m_data.row(j).transpose();
+                        double area = vi.cross(vj).squaredNorm();
+                        if (area > max_area)
+                        {
+                            max_area = area;
+                            a0 = i;
+                            a1 = j;
+                        }
+                    }
+                Eigen::Vector3d v0 = m_data.row(a0).transpose();
+                Eigen::Vector3d normal = v0.cross(Eigen::Vector3d(m_data.row(a1).transpose()));
+                double max_volume = -1.0;
+                for (unsigned int k = 0; k < N; k++)
+                {
+                    if (k == a0 || k == a1)
+                        continue;
+                    double volume = fabs(normal.dot(m_data.row(k).transpose()));
+                    if (volume > max_volume)
+                    {
+                        max_volume = volume;
+                        a2 = k;
+                    }
+                }
+                m_anchors.push_back(a0);
+                m_anchors.push_back(a1);
+                m_anchors.push_back(a2);
+            }
+
+            m_anchor_points.resize(m_anchors.size(), 3);
+            for (unsigned int a = 0; a < m_anchors.size(); a++)
+                m_anchor_points.row(a) = m_data.row(m_anchors[a]);
+        }
+
+        // Match each of the points, in order, to its nearest vector of m_data that is not matched yet, store the
+        // index of that vector for each point, and return the RMSD of the pairs. This uses the R-tree.
+        double AlignedRMSDMap(const matrix& points, unsigned int *ref_of_point) const
         {
             // Also brute force.
             assert(points.rows() == m_data.rows());
@@ -314,8 +438,6 @@ class RegisterBruteForce  // : public Register
             // keeps track of whether points in m_rtree have been matched to any point in points
             // guarantees 1-1 mapping
             std::vector<bool> found(m_data.rows(), false);
-            // a mapping between the vectors of m_data and the vectors of points
-            boost::bimap<unsigned int, unsigned int> vec_map;
             // loop through all the points
             for(int r = 0; r < points.rows(); r++)
             {
@@ -333,7 +455,7 @@ class RegisterBruteForce  // : public Register
                         dist = bg::distance(query, it->first);
                         found[it->second] = true;
                         // add this pairing to the mapping between vectors
-                        vec_map.insert(boost::bimap<unsigned int, unsigned int>::value_type(it->second, r));
+                        ref_of_point[r] = it->second;
                         break;
                     }
                 }
@@ -345,14 +467,160 @@ class RegisterBruteForce  // : public Register
                 rmsd += dist*dist;
             }
 
-            m = vec_map;
             return sqrt(rmsd/double(points.rows()));
         }
 
-    private:
+        // Overload for up to max_small_points points: the same matching, by a scan of m_data instead of the R-tree
+        // queries, which allocate.
+        double AlignedRMSDMap(const small_matrix& points, unsigned int *ref_of_point) const
+        {
+            assert(points.rows() == m_data.rows());
+            const unsigned int N = points.rows();
+            double rmsd = 0.0;
+
+            bool found[max_small_points];
+            std::fill(found, found + N, false);
+            for (unsigned int r = 0; r < N; r++)
+            {
+                double min_distsq = -1.0;
+                unsigned int nearest = 0;
+                for (unsigned int k = 0; k < N; k++)
+                {
+                    if (found[k])
+                        continue;
+                    double dx = m_data(k, 0) - points(r, 0);
+                    double dy = m_data(k, 1) - points(r, 1);
+                    double dz = m_data(k, 2) - points(r, 2);
+                    double distsq = dx*dx + dy*dy + dz*dz;
+                    if (distsq < min_distsq || min_distsq < 0.0)
+                    {
+                        min_distsq = distsq;
+                        nearest = k;
+                    }
+                }
+                found[nearest] = true;
+                ref_of_point[r] = nearest;
+                rmsd += min_distsq;
+            }
+
+            return sqrt(rmsd/double(N));
+        }
+
+        // Find the rotation of points with the smallest RMSD among those taking num_anchors points to the anchors.
+        // PointsMatrix is small_matrix for up to max_small_points points, so that the loop over the correspondences
+        // only works on the stack, and matrix otherwise.
+        template<class PointsMatrix>
+        void FitAnchors(const PointsMatrix& points)
+        {
+            unsigned int N = points.rows();
+            unsigned int num_anchors = m_anchors.size();
+            const double prune_tol = m_prune_tol;
+            const anchor_matrix& anchor_points = m_anchor_points;
+
+            m_rotation = matrix::Identity(3, 3);
+            m_vec_map.clear();
+            if (N == 0)
+            {
+                m_rmsd = 0.0;
+                return;
+            }
+
+            // the deviation of a correspondence is the largest difference of the lengths, or half the largest
+            // difference of the distances, between the points and the anchors
+            std::vector<double> lengths(N);
+            for (unsigned int i = 0; i < N; i++)
+                lengths[i] = points.row(i).norm();
+            double anchor_lengths[3], anchor_dists[3][3];
+            for (unsigned int a = 0; a < num_anchors; a++)
+            {
+                anchor_lengths[a] = anchor_points.row(a).norm();
+                for (unsigned int b = 0; b < num_anchors; b++)
+                    anchor_dists[a][b] = (anchor_points.row(a) - anchor_points.row(b)).norm();
+            }
+
+            // the correspondences (i0, i1, i2) of the anchors that survive the pruning, with their deviation
+            std::vector<std::pair<double, unsigned int> > candidates;
+            for (unsigned int i0 = 0; i0 < N; i0++)
+            {
+                double dev0 = fabs(lengths[i0] - anchor_lengths[0]);
+                if (prune_tol >= 0.0 && dev0 > prune_tol)
+                    continue;
+                if (num_anchors == 1)
+                {
+                    candidates.push_back(std::make_pair(dev0, i0));
+                    continue;
+                }
+                for (unsigned int i1 = 0; i1 < N; i1++)
+                {
+                    if (i1 == i0)
+                        continue;
+                    double dev1 = std::max(dev0, std::max(fabs(lengths[i1] - anchor_lengths[1]),
+                        0.5*fabs((points.row(i0) - points.row(i1)).norm() - anchor_dists[0][1])));
+                    if (prune_tol >= 0.0 && dev1 > prune_tol)
+                        continue;
+                    if (num_anchors == 2)
+                    {
+                        candidates.push_back(std::make_pair(dev1, i0*N + i1));
+                        continue;
+                    }
+                    for (unsigned int i2 = 0; i2 < N; i2++)
+                    {
+                        if (i2 == i0 || i2 == i1)
+                            continue;
+                        double dev2 = std::max(dev1, std::max(fabs(lengths[i2] - anchor_lengths[2]),
+                            0.5*std::max(fabs((points.row(i0) - points.row(i2)).norm() - anchor_dists[0][2]),
+                                         fabs((points.row(i1) - points.row(i2)).norm() - anchor_dists[1][2]))));
+                        if (prune_tol >= 0.0 && dev2 > prune_tol)
+                            continue;
+                        candidates.push_back(std::make_pair(dev2, (i0*N + i1)*N + i2));
+                    }
+                }
+            }
+            // the most consistent correspondences are the likeliest to be right, and to end the search early
+            std::stable_sort(candidates.begin(), candidates.end(),
+                [] (const std::pair<double, unsigned int>& a, const std::pair<double, unsigned int>& b)
+                { return a.first < b.first; });
+
+            anchor_matrix q(num_anchors, 3);
+            Eigen::Matrix3d r;
+            PointsMatrix rot_points(N, 3);
+            std::vector<unsigned int> ref_of_point(N), best_ref_of_point(N);
+            double rmsd_min = -1.0;
+            for (unsigned int c = 0; c < candidates.size(); c++)
+            {
+                unsigned int code = candidates[c].second;
+                for (int a = num_anchors-1; a >= 0; a--)
+                {
+                    q.row(a) = points.row(code % N);
+                    code /= N;
+                }
+
+                // finds the optimal rotation of the anchors' correspondences such that they match the anchors
+                KabschQuaternion(q, anchor_points, r);
+                // the rows of points are rotated by r, as the columns of its transpose would be
+                rot_points.noalias() = points*r.transpose();
+                double rmsd = AlignedRMSDMap(rot_points, &ref_of_point[0]);
+                if (rmsd < rmsd_min || rmsd_min < 0.0)
+                {
+                    m_rmsd = rmsd;
+                    m_rotation = r;
+                    best_ref_of_point.swap(ref_of_point);
+                    rmsd_min = m_rmsd;
+                    if (rmsd_min < m_tol)
+                        break;
+                }
+            }
+
+            // if no correspondence survives, leave the points as they are
+            if (rmsd_min < 0.0)
+                m_rmsd = AlignedRMSDMap(points, &best_ref_of_point[0]);
+
+            for (unsigned int p = 0; p < N; p++)
+                m_vec_map.insert(boost::bimap<unsigned int, unsigned int>::value_type(best_ref_of_point[p], p));
+        }
 
         template<class MatrixType>
-        point make_point(const Eigen::VectorXd& row) {
+        point make_point(const Eigen::VectorXd& row) const {
             if(row.rows() == 2)
                 return point(row[0], row[1], 0.0);
             else if(row.rows() == 3)
@@ -384,35 +652,6 @@ class RegisterBruteForce  // : public Register
             return bRetVal;
         }
 
-        template<class RNG>
-        class RandomNumber
-        {
-        public:
-            RandomNumber() { seed_generator(); }
-            int random_int(int a, int b)
-            {
-                std::uniform_int_distribution<int> distribution(a,b);
-                return distribution(m_generator);
-            }
-        private:
-            inline void seed_generator(const size_t& n = 100)
-            {
-                std::vector<size_t> seeds;
-                try {
-                    std::random_device rd;
-                    for(size_t i = 0; i < n; i++)
-                        seeds.push_back(rd());
-                } catch (...) {
-                    std::cout << "random_device is not available..." << std::endl;
-                    seeds.push_back(size_t(std::chrono::system_clock::now().time_since_epoch().count()));
-                    seeds.push_back(size_t(getpid()));
-                }
-                std::seed_seq seq(seeds.begin(), seeds.end());
-                m_generator.seed(seq);
-            }
-            RNG m_generator;
-        };
-
     private:
         matrix m_data;
         matrix m_rotation;
@@ -420,6 +659,11 @@ class RegisterBruteForce  // : public Register
         double m_rmsd;
         double m_tol;
         size_t m_shuffles;
+        bool m_accelerated;
+        double m_prune_tol;
+        unsigned int m_seed;
+        std::vector<unsigned int> m_anchors;
+        anchor_matrix m_anchor_points;
         boost::bimap<unsigned int, unsigned int> m_vec_map;
         // R-tree. It stores (point, index) pairs and is initialized via the R*-tree algorithm.
         // The maximum number of elements in each node is set to 16.
@@ -2,19 +2,12 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include "shapesplit.h"
-#include "ScopedGILRelease.h"
-
-#include <stdexcept>
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
 
 using namespace std;
-
 using namespace tbb;
 
-/*! \file ShapeSplit.cc
-    \brief Routines for computing radial density functions
+/*! \file shapesplit.cc
+    \brief Splits anisotropic shapes into sets of points in the frame of the box
 */
 
 namespace freud { namespace shapesplit {
@@ -24,58 +17,51 @@ ShapeSplit::ShapeSplit()
     {
     }
 
-void ShapeSplit::updateBox(box::Box& box)
+ShapeSplit::ShapeSplit(const box::Box& box)
+    : m_box(box), m_Np(0), m_Nsplit(0)
     {
-    // see if it is different than the current box
-    if (m_box != box)
-        {
-        m_box = box;
-        }
     }
 
-void ShapeSplit::compute(const vec3<float> *points,
-                    unsigned int Np,
-                    const quat<float> *orientations,
-                    const vec3<float> *split_points,
-                    unsigned int Nsplit)
+void ShapeSplit::compute(const vec3<float> *points, unsigned int Np, const quat<float> *orientations,
+                         const vec3<float> *split_points, unsigned int Nsplit)
     {
-    // reallocate the output array if it is not the right size
-    if (Np != m_Np || Nsplit != m_Nsplit)
+    // only reallocate when the sizes change
+    if (Np != m_Np || Nsplit != m_Nsplit || !m_split_array)
         {
-        m_split_array = std::shared_ptr<float>(new float[Np*Nsplit*3], std::default_delete<float[]>());
-        m_orientation_array = std::shared_ptr<float>(new float[Np*Nsplit*4], std::default_delete<float[]>());
+        const size_t num_split = size_t(Np)*Nsplit;
+        m_split_array = std::shared_ptr<float>(new float[3*num_split], std::default_delete<float[]>());
+        m_orientation_array = std::shared_ptr<float>(new float[4*num_split], std::default_delete<float[]>());
+        m_Np = Np;
+        m_Nsplit = Nsplit;
         }
-    parallel_for(blocked_range<size_t>(0,Np),
-      [=] (const blocked_range<size_t>& r)
-      {
-      // create Index
-      Index3D b_i = Index3D(3, Nsplit, Np);
-      Index3D q_i = Index3D(4, Nsplit, Np);
-      // for each point
-      for (size_t i = r.begin(); i != r.end(); i++)
-          {
-          vec3<float> point = points[i];
-          for (unsigned int j = 0; j < m_Nsplit; j++)
-              {
-              vec3<float> split_point = point + rotate(orientations[i], split_points[j]);
-
-              split_point = m_box.wrap(split_point);
 
-              m_split_array.get()[b_i(0, j, i)] = split_point.x;
-              m_split_array.get()[b_i(1, j, i)] = split_point.y;
-              m_split_array.get()[b_i(2, j, i)] = split_point.z;
-
-              m_orientation_array.get()[q_i(0, j, i)] = orientations[i].s;
-              m_orientation_array.get()[q_i(1, j, i)] = orientations[i].v.x;
-              m_orientation_array.get()[q_i(2, j, i)] = orientations[i].v.z;
-              m_orientation_array.get()[q_i(3, j, i)] = orientations[i].v.z;
-
-              }
-          } // done looping over reference points
-      });
+    computeInto(points, Np, orientations, split_points, Nsplit, (vec3<float>*) m_split_array.get(),
+                (quat<float>*) m_orientation_array.get());
+    }
 
-    m_Np = Np;
-    m_Nsplit = Nsplit;
+void ShapeSplit::computeInto(const vec3<float> *points, unsigned int Np, const quat<float> *orientations,
+                             const vec3<float> *split_points, unsigned int Nsplit, vec3<float> *split_array,
+                             quat<float> *orientation_array) const
+    {
+    const box::Box box(m_box);
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+            {
+            for (size_t i = r.begin(); i != r.end(); ++i)
+                {
+                const vec3<float> point = points[i];
+                const quat<float> orientation = orientations[i];
+                vec3<float> *split_out = split_array + i*Nsplit;
+                for (unsigned int j = 0; j < Nsplit; j++)
+                    split_out[j] = splitPoint(box, point, orientation, split_points[j]);
+                if (orientation_array != NULL)
+                    {
+                    quat<float> *orientation_out = orientation_array + i*Nsplit;
+                    for (unsigned int j = 0; j < Nsplit; j++)
+                        orientation_out[j] = orientation;
+                    }
+                }
+            });
     }
 
 }; }; // end namespace freud::shapesplit
@@ -1,40 +1,52 @@
 // Copyright (c) 2010-2016 The Regents of the University of Michigan
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
-#include <tbb/tbb.h>
-#include <ostream>
-
-// work around nasty issue where python #defines isalpha, toupper, etc....
-#undef __APPLE__
-#include <Python.h>
-#define __APPLE__
-
 #include <memory>
+#include <tbb/tbb.h>
 
+#include "HOOMDMath.h"
 #include "VectorMath.h"
+
 #include "box.h"
-#include "Index1D.h"
 
 #ifndef _SHAPESPLIT_H__
 #define _SHAPESPLIT_H__
 
-/*! \file ShapeSplit.h
-    \brief Routines for computing radial density functions
+/*! \file shapesplit.h
+    \brief Splits anisotropic shapes into sets of points in the frame of the box
 */
 
 namespace freud { namespace shapesplit {
 
-//! Split a given set of points into more points off a set of local vectors
-/*! A given set of points is given and split into Np*Nsplit points.
+//! Position of split point j of a shape, wrapped into the box
+/*! \param box Simulation box
+    \param point Center of the shape
+    \param orientation Orientation of the shape
+    \param split_point Split point in the frame of the shape
+
+    This is all a split point is, so a consumer that only reads each split point once can build it where it is
+    needed instead of reading it from an Np Nsplit array.
+*/
+inline vec3<float> splitPoint(const box::Box& box, const vec3<float>& point, const quat<float>& orientation,
+                              const vec3<float>& split_point)
+    {
+    return box.wrap(point + rotate(orientation, split_point));
+    }
+
+//! Split each shape into Nsplit points
+/*! Split point j of shape i is at points[i] + rotate(orientations[i], split_points[j]), wrapped into the box, and
+    has the orientation of the shape. compute() keeps its arrays for as long as the numbers of shapes and split points
+    are unchanged, so trajectories are split without allocating per frame; computeInto() writes into arrays of the
+    caller instead, and allocates nothing.
 */
 class ShapeSplit
     {
     public:
-        //! Constructor
+        //! Constructor, with the default box until updateBox()
         ShapeSplit();
 
-        //! Update the simulation box
-        void updateBox(box::Box& box);
+        //! Constructor
+        ShapeSplit(const box::Box& box);
 
         //! Get the simulation box
         const box::Box& getBox() const
@@ -42,60 +54,54 @@ class ShapeSplit
             return m_box;
             }
 
-        //! Compute the RDF
-        void compute(const vec3<float> *points,
-                     unsigned int Np,
-                     const quat<float> *orientations,
-                     const vec3<float> *split_points,
-                     unsigned int Nsplit);
+        //! Update the simulation box
+        void updateBox(const box::Box& box)
+            {
+            m_box = box;
+            }
 
-        // //! Python wrapper for compute
-        // void computePy(box::Box& box,
-        //                boost::python::numeric::array points,
-        //                boost::python::numeric::array orientations,
-        //                boost::python::numeric::array split_points);
+        //! Split the shapes into the arrays of this object
+        void compute(const vec3<float> *points, unsigned int Np, const quat<float> *orientations,
+                     const vec3<float> *split_points, unsigned int Nsplit);
 
-        //! Get a reference to the last computed split shape
+        //! Split the shapes into arrays of the caller
+        /*! \param split_array Output: Np Nsplit positions, by shape then split point
+            \param orientation_array Output: Np Nsplit orientations, or NULL to only find the positions
+        */
+        void computeInto(const vec3<float> *points, unsigned int Np, const quat<float> *orientations,
+                         const vec3<float> *split_points, unsigned int Nsplit, vec3<float> *split_array,
+                         quat<float> *orientation_array) const;
+
+        //! Get the positions of the split points of the last compute
         std::shared_ptr<float> getShapeSplit()
             {
             return m_split_array;
             }
 
-        // //! Python wrapper for getShapeSplit() (returns a copy)
-        // boost::python::numeric::array getShapeSplitPy()
-        //     {
-        //     float *arr = m_split_array.get();
-        //     std::vector<intp> dims(3);
-        //     dims[0] = m_Np;
-        //     dims[1] = m_Nsplit;
-        //     dims[2] = 3;
-        //     return num_util::makeNum(arr, dims);
-        //     }
-
-        //! Get a reference to the last computed split orientations
+        //! Get the orientations of the split points of the last compute
         std::shared_ptr<float> getShapeOrientations()
             {
             return m_orientation_array;
             }
 
-        // //! Python wrapper for getShapeOrientations() (returns a copy)
-        // boost::python::numeric::array getShapeOrientationsPy()
-        //     {
-        //     float *arr = m_orientation_array.get();
-        //     std::vector<intp> dims(3);
-        //     dims[0] = m_Np;
-        //     dims[1] = m_Nsplit;
-        //     dims[2] = 4;
-        //     return num_util::makeNum(arr, dims);
-        //     }
+        //! Get the number of shapes of the last compute
+        unsigned int getNpoints() const
+            {
+            return m_Np;
+            }
+
+        //! Get the number of split points of each shape of the last compute
+        unsigned int getNsplit() const
+            {
+            return m_Nsplit;
+            }
 
     private:
-        box::Box m_box;            //!< Simulation box the particles belong in
-        unsigned int m_Np;
-        unsigned int m_Nsplit;
-
-        std::shared_ptr<float> m_split_array;
-        std::shared_ptr<float> m_orientation_array;
+        box::Box m_box;                             //!< Simulation box the shapes belong in
+        unsigned int m_Np;                          //!< Number of shapes of the last compute
+        unsigned int m_Nsplit;                      //!< Number of split points of each shape
+        std::shared_ptr<float> m_split_array;       //!< 3 Np Nsplit coordinates of the split points
+        std::shared_ptr<float> m_orientation_array; //!< 4 Np Nsplit components of their orientations
     };
 
 }; }; // end namespace freud::shapesplit
@@ -0,0 +1,173 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdexcept>
+
+#include "DCDReader.h"
+#include "SoAPoints.h"
+
+using namespace std;
+
+/*! \file DCDReader.cc
+    \brief Read the frames of a DCD trajectory file in place
+*/
+
+namespace freud { namespace trajectory {
+
+//! \internal
+//! Read the int32 at offset of the mapping, checking that it is within size
+static int32_t readInt(const char *map, size_t size, size_t offset)
+    {
+    if (offset + sizeof(int32_t) > size)
+        throw invalid_argument("The DCD file is truncated");
+    int32_t value;
+    memcpy(&value, map + offset, sizeof(value));
+    return value;
+    }
+
+//! \internal
+//! Cosine of an angle of a unit cell, stored as the cosine itself when within [-1, 1] and else in degrees, as VMD reads it
+static double cellCosine(double angle, bool cosines)
+    {
+    return cosines ? angle : cos(angle*M_PI/180.0);
+    }
+
+DCDReader::DCDReader(const std::string& filename)
+    : m_Np(0), m_num_frames(0), m_has_unit_cell(false), m_first_frame(0), m_frame_size(0), m_map(NULL),
+      m_map_size(0)
+    {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw invalid_argument("Cannot open the DCD file " + filename);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+        {
+        close(fd);
+        throw invalid_argument("Cannot read the DCD file " + filename);
+        }
+    m_map_size = file_stat.st_size;
+    void *map = mmap(NULL, m_map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        throw invalid_argument("Cannot map the DCD file " + filename);
+    m_map = static_cast<const char*>(map);
+
+    try
+        {
+        // the header record: "CORD" and 20 control integers
+        const int32_t header_size = readInt(m_map, m_map_size, 0);
+        if (header_size != 84)
+            {
+            const uint32_t u = uint32_t(header_size);
+            const uint32_t swapped = (u >> 24) | ((u >> 8) & 0xff00) | ((u << 8) & 0xff0000) | (u << 24);
+            if (swapped == 84)
+                throw invalid_argument("DCD files of the other byte order are not supported");
+            throw invalid_argument(filename + " is not a DCD file");
+            }
+        if (m_map_size < 92 || memcmp(m_map + 4, "CORD", 4) != 0 || readInt(m_map, m_map_size, 88) != 84)
+            throw invalid_argument(filename + " is not a DCD file of coordinates");
+        int32_t control[20];
+        for (unsigned int i = 0; i < 20; i++)
+            control[i] = readInt(m_map, m_map_size, 8 + 4*i);
+        if (control[8] != 0)
+            throw invalid_argument("DCD files with fixed atoms are not supported");
+        // the unit cell and the fourth dimension are CHARMM extensions, flagged by its version
+        const bool charmm = control[19] != 0;
+        m_has_unit_cell = charmm && control[10] != 0;
+        const bool four_dims = charmm && control[11] != 0;
+
+        // the title record, then the number of atoms
+        size_t offset = 92;
+        const int32_t title_size = readInt(m_map, m_map_size, offset);
+        if (title_size < 4 || readInt(m_map, m_map_size, offset + 4 + title_size) != title_size)
+            throw invalid_argument("The title of the DCD file is corrupted");
+        offset += 8 + title_size;
+        if (readInt(m_map, m_map_size, offset) != 4 || readInt(m_map, m_map_size, offset + 8) != 4)
+            throw invalid_argument("The number of atoms of the DCD file is corrupted");
+        const int32_t num_atoms = readInt(m_map, m_map_size, offset + 4);
+        if (num_atoms <= 0)
+            throw invalid_argument("The DCD file has no atoms");
+        m_Np = (unsigned int) num_atoms;
+        m_first_frame = offset + 12;
+
+        // each frame: the unit cell of 6 doubles, then one record of floats per dimension
+        const size_t coordinates_size = sizeof(int32_t) + m_Np*sizeof(float) + sizeof(int32_t);
+        m_frame_size = (m_has_unit_cell ? 8 + 6*sizeof(double) : 0) + (four_dims ? 4 : 3)*coordinates_size;
+        m_num_frames = (unsigned int) ((m_map_size - m_first_frame)/m_frame_size);
+        if (m_num_frames > 0)
+            {
+            // the records of the first frame must be those of its size
+            size_t frame_offset = m_first_frame;
+            if (m_has_unit_cell)
+                {
+                if (readInt(m_map, m_map_size, frame_offset) != 48)
+                    throw invalid_argument("The unit cell of the DCD file is corrupted");
+                frame_offset += 8 + 6*sizeof(double);
+                }
+            if (readInt(m_map, m_map_size, frame_offset) != int32_t(m_Np*sizeof(float)))
+                throw invalid_argument("The coordinates of the DCD file are corrupted");
+            }
+        }
+    catch (...)
+        {
+        munmap(map, m_map_size);
+        throw;
+        }
+
+    // the frames are read in order: let the kernel read ahead
+    madvise(map, m_map_size, MADV_SEQUENTIAL);
+    }
+
+DCDReader::~DCDReader()
+    {
+    munmap((void*) m_map, m_map_size);
+    }
+
+const float *DCDReader::getCoordinates(unsigned int frame, unsigned int dim) const
+    {
+    if (frame >= m_num_frames)
+        throw invalid_argument("The frame is past the end of the DCD file");
+    const size_t coordinates_size = sizeof(int32_t) + m_Np*sizeof(float) + sizeof(int32_t);
+    const size_t offset = m_first_frame + size_t(frame)*m_frame_size + (m_has_unit_cell ? 8 + 6*sizeof(double) : 0) +
+        dim*coordinates_size + sizeof(int32_t);
+    return reinterpret_cast<const float*>(m_map + offset);
+    }
+
+/*! The unit cell holds the lengths a, b and c of the lattice vectors and the angles alpha, beta and gamma between
+    them, as a, gamma, b, beta, alpha, c; the first lattice vector is put along x and the second in the xy plane.
+*/
+box::Box DCDReader::getBox(unsigned int frame) const
+    {
+    if (!m_has_unit_cell)
+        throw invalid_argument("The DCD file has no unit cell");
+    if (frame >= m_num_frames)
+        throw invalid_argument("The frame is past the end of the DCD file");
+    double cell[6];
+    memcpy(cell, m_map + m_first_frame + size_t(frame)*m_frame_size + 4, sizeof(cell));
+    const double a = cell[0], b = cell[2], c = cell[5];
+    const bool cosines = fabs(cell[1]) <= 1.0 && fabs(cell[3]) <= 1.0 && fabs(cell[4]) <= 1.0;
+    const double cos_gamma = cellCosine(cell[1], cosines);
+    const double cos_beta = cellCosine(cell[3], cosines);
+    const double cos_alpha = cellCosine(cell[4], cosines);
+
+    const double lx = a;
+    const double xy = b*cos_gamma;
+    const double xz = c*cos_beta;
+    const double ly = sqrt(b*b - xy*xy);
+    const double yz = (b*c*cos_alpha - xy*xz)/ly;
+    const double lz = sqrt(c*c - xz*xz - yz*yz);
+    return box::Box(float(lx), float(ly), float(lz), float(xy/ly), float(xz/lz), float(yz/lz), false);
+    }
+
+void DCDReader::getPositions(unsigned int frame, vec3<float> *positions) const
+    {
+    util::interleavePoints(util::SoAPoints(getX(frame), getY(frame), getZ(frame)), m_Np, positions);
+    }
+
+}; }; // end namespace freud::trajectory
@@ -0,0 +1,102 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <string>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+
+#ifndef _DCD_READER_H__
+#define _DCD_READER_H__
+
+/*! \file DCDReader.h
+    \brief Read the frames of a DCD trajectory file in place
+*/
+
+namespace freud { namespace trajectory {
+
+//! Read the frames of a DCD trajectory file, mapped in memory
+/*! A DCD file is a CHARMM/X-PLOR header followed by frames of fixed size, each one an optional unit cell and the
+    x, y and z coordinates of all the particles as three float32 arrays, so the file is mapped in memory and the
+    coordinates are read where they are: getX(), getY() and getZ() point into the mapping, and nothing is read from
+    disk until they are used. getPositions() interleaves them into an array of vec3<float>, in parallel and one
+    frame at a time, for the analyses.
+
+    The number of frames is found from the size of the file, so the frames of a file still being written can be
+    read. Files of the byte order of the machine are supported, with or without unit cells and with the fourth
+    dimension of CHARMM skipped; files with fixed atoms are not.
+*/
+class DCDReader
+    {
+    public:
+        //! Constructor
+        /*! \param filename DCD file
+        */
+        DCDReader(const std::string& filename);
+
+        //! Destructor
+        ~DCDReader();
+
+        //! Get the number of frames of the file
+        unsigned int getNumFrames() const
+            {
+            return m_num_frames;
+            }
+
+        //! Get the number of particles of each frame
+        unsigned int getNP() const
+            {
+            return m_Np;
+            }
+
+        //! Get whether the frames have a unit cell
+        bool hasUnitCell() const
+            {
+            return m_has_unit_cell;
+            }
+
+        //! Get the x coordinates of the particles of a frame, in the mapping of the file
+        const float *getX(unsigned int frame) const
+            {
+            return getCoordinates(frame, 0);
+            }
+
+        //! Get the y coordinates of the particles of a frame, in the mapping of the file
+        const float *getY(unsigned int frame) const
+            {
+            return getCoordinates(frame, 1);
+            }
+
+        //! Get the z coordinates of the particles of a frame, in the mapping of the file
+        const float *getZ(unsigned int frame) const
+            {
+            return getCoordinates(frame, 2);
+            }
+
+        //! Get the box of a frame, from its unit cell
+        box::Box getBox(unsigned int frame) const;
+
+        //! Interleave the coordinates of a frame into positions, of getNP() elements
+        void getPositions(unsigned int frame, vec3<float> *positions) const;
+
+    private:
+        DCDReader(const DCDReader&);
+        DCDReader& operator=(const DCDReader&);
+
+        //! Get the first coordinate of dimension dim of a frame
+        const float *getCoordinates(unsigned int frame, unsigned int dim) const;
+
+        unsigned int m_Np;              //!< Number of particles of each frame
+        unsigned int m_num_frames;      //!< Number of frames of the file
+        bool m_has_unit_cell;           //!< true if the frames have a unit cell
+        size_t m_first_frame;           //!< Offset of the first frame in the file
+        size_t m_frame_size;            //!< Size of a frame in the file
+        const char *m_map;              //!< Mapping of the file
+        size_t m_map_size;              //!< Size of the file
+    };
+
+}; }; // end namespace freud::trajectory
+
+#endif // _DCD_READER_H__
@@ -0,0 +1,103 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#ifndef _ALIGNED_ARRAY_H__
+#define _ALIGNED_ARRAY_H__
+
+/*! \file AlignedArray.h
+    \brief Aligned, huge page backed and parallel first touched storage for large histograms, grids and cell lists
+*/
+
+namespace freud { namespace util {
+
+//! Alignment in bytes of every aligned array, a cache line and the width of the widest SIMD registers
+const size_t ARRAY_ALIGNMENT = 64;
+
+//! Size in bytes of a huge page of x86-64 and aarch64 Linux
+const size_t HUGE_PAGE_SIZE = 2*1024*1024;
+
+//! Arrays of at least this many bytes are aligned to, and backed by, huge pages
+const size_t HUGE_PAGE_MIN_BYTES = 4*HUGE_PAGE_SIZE;
+
+//! Bytes zeroed by one task of the parallel first touch of makeLargeArray
+const size_t FIRST_TOUCH_GRAIN = 64*1024;
+
+//! Allocate uninitialized memory aligned to ARRAY_ALIGNMENT
+/*! Allocations of at least HUGE_PAGE_MIN_BYTES are aligned to HUGE_PAGE_SIZE and advised to the kernel as
+    candidates for transparent huge pages, so that a grid of several GB costs a few thousand TLB entries instead of a
+    million. Explicit MAP_HUGETLB pages need a pool reserved by the administrator, so they are not used.
+
+    \note Free the memory with freeAligned()
+*/
+inline void *allocateAligned(size_t bytes)
+    {
+    bytes = std::max(bytes, (size_t) 1);
+    const bool huge = bytes >= HUGE_PAGE_MIN_BYTES;
+    void *p = NULL;
+    if (posix_memalign(&p, huge ? HUGE_PAGE_SIZE : ARRAY_ALIGNMENT, bytes) != 0)
+        throw std::bad_alloc();
+    #ifdef MADV_HUGEPAGE
+    if (huge)
+        // only advice: the memory is usable whether or not the kernel has transparent huge pages
+        madvise(p, (bytes/HUGE_PAGE_SIZE)*HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+    #endif
+    return p;
+    }
+
+//! Free memory allocated with allocateAligned()
+inline void freeAligned(void *p)
+    {
+    free(p);
+    }
+
+//! Deleter of the arrays of makeLargeArray()
+struct AlignedDeleter
+    {
+    void operator()(void *p) const
+        {
+        freeAligned(p);
+        }
+    };
+
+//! Zero n elements in parallel, each page by one of the worker threads
+/*! The kernel places a page on the NUMA node of the thread that first writes it. Zeroing a new array in the same
+    parallel pattern as the loops that later fill it spreads its pages over the nodes of the threads, where a serial
+    memset would put all of them on the node of the calling thread.
+*/
+template<typename T>
+void firstTouch(T *data, size_t n)
+    {
+    const size_t grain = std::max(FIRST_TOUCH_GRAIN/sizeof(T), (size_t) 1);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n, grain),
+        [=] (const tbb::blocked_range<size_t>& r)
+        {
+        memset((void*) (data + r.begin()), 0, r.size()*sizeof(T));
+        });
+    }
+
+//! Allocate a zeroed array of n elements with allocateAligned(), first touched in parallel
+/*! T is a type of which all zero bytes are a valid value, such as the numbers, vec3 and BinCount of the histograms
+    and grids; no constructor or destructor is run.
+*/
+template<typename T>
+std::shared_ptr<T> makeLargeArray(size_t n)
+    {
+    T *data = (T*) allocateAligned(n*sizeof(T));
+    firstTouch(data, n);
+    return std::shared_ptr<T>(data, AlignedDeleter());
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _ALIGNED_ARRAY_H__
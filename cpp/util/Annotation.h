@@ -0,0 +1,98 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#ifdef FREUD_ITT
+#include <ittnotify.h>
+#endif
+#ifdef FREUD_NVTX
+#include <nvToolsExt.h>
+#endif
+
+#ifndef _ANNOTATION_H__
+#define _ANNOTATION_H__
+
+/*! \file Annotation.h
+    \brief Optional named ranges of the phases of the analyses for VTune (ITT) and Nsight (NVTX)
+
+    The ENABLE_ITT option of CMake defines FREUD_ITT and ENABLE_NVTX defines FREUD_NVTX. Without either, ScopedRange
+    is an empty inline class and the annotations left in the analyses compile to nothing.
+*/
+
+namespace freud { namespace util {
+
+//! Whether the library was built with ITT or NVTX annotations
+inline bool isAnnotationEnabled()
+    {
+#if defined(FREUD_ITT) || defined(FREUD_NVTX)
+    return true;
+#else
+    return false;
+#endif
+    }
+
+#ifdef FREUD_ITT
+//! Domain of the ITT tasks of freud
+inline __itt_domain *ittDomain()
+    {
+    static __itt_domain *domain = __itt_domain_create("freud");
+    return domain;
+    }
+#endif
+
+//! Name the scope of the calling thread in the timeline of the profiler
+/*! The ranges nest, and are per thread: a range opened on the calling thread of a parallel loop does not cover the
+    work of the other threads, so the bodies of the shared loops (locality::parallelForPartitioned and the reduction
+    of util/HistogramReduction.h) open a range of their own in every task. \a name must outlive the range; string
+    literals are used throughout.
+*/
+class ScopedRange
+    {
+    public:
+        explicit ScopedRange(const char *name)
+#if defined(FREUD_ITT) || defined(FREUD_NVTX)
+            : m_open(true)
+#endif
+            {
+#ifdef FREUD_ITT
+            // ITT interns the names, so that every range of the same name shares one handle
+            __itt_task_begin(ittDomain(), __itt_null, __itt_null, __itt_string_handle_create(name));
+#endif
+#ifdef FREUD_NVTX
+            nvtxRangePushA(name);
+#endif
+            (void) name;
+            }
+
+        ~ScopedRange()
+            {
+            end();
+            }
+
+        //! Close the range before the end of the scope, the destructor then leaving it alone
+        void end()
+            {
+#if defined(FREUD_ITT) || defined(FREUD_NVTX)
+            if (!m_open)
+                return;
+            m_open = false;
+#endif
+#ifdef FREUD_NVTX
+            nvtxRangePop();
+#endif
+#ifdef FREUD_ITT
+            __itt_task_end(ittDomain());
+#endif
+            }
+
+    private:
+        ScopedRange(const ScopedRange&);
+        ScopedRange& operator=(const ScopedRange&);
+
+#if defined(FREUD_ITT) || defined(FREUD_NVTX)
+        bool m_open;            //!< true until the range is closed
+#endif
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _ANNOTATION_H__
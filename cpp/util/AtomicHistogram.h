@@ -0,0 +1,220 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <stddef.h>
+#include <string.h>
+
+#include "HistogramReduction.h"
+#include "Annotation.h"
+
+#ifndef _ATOMIC_HISTOGRAM_H__
+#define _ATOMIC_HISTOGRAM_H__
+
+/*! \file AtomicHistogram.h
+    \brief Histogram shared by the threads, incremented atomically through per-task write-combining buffers
+*/
+
+namespace freud { namespace util {
+
+//! Number of slots of an AtomicHistogramBuffer
+const unsigned int ATOMIC_BUFFER_SLOTS = 64;
+
+//! Histogram of n bins shared by all the threads, incremented with atomic operations
+/*! Per-thread histograms take the memory of the grid once per thread, and their reduction reads all of them. This
+    histogram takes it once whatever the number of threads, and needs no reduction, for the cost of an atomic
+    operation per increment, which AtomicHistogramBuffer mostly saves by combining the increments of the same bins.
+    Integer bins are added with fetch_add, floating point bins with a compare and swap loop.
+*/
+template<typename T>
+class AtomicHistogram
+    {
+    public:
+        //! Constructor
+        AtomicHistogram()
+            : m_n(0)
+            {
+            }
+
+        //! Allocate n zeroed bins, unless they are already allocated
+        void allocate(size_t n)
+            {
+            if (m_bins && m_n == n)
+                return;
+            m_bins.reset(new std::atomic<T>[n]);
+            m_n = n;
+            clear();
+            }
+
+        //! Free the bins
+        void release()
+            {
+            m_bins.reset();
+            m_n = 0;
+            }
+
+        //! Whether the bins are allocated
+        bool isAllocated() const
+            {
+            return bool(m_bins);
+            }
+
+        //! Zero the bins
+        void clear()
+            {
+            std::atomic<T> *bins = m_bins.get();
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_n, REDUCTION_TILE_SIZE),
+                [=] (const tbb::blocked_range<size_t>& r)
+                {
+                for (size_t i = r.begin(); i != r.end(); i++)
+                    bins[i].store(T(0), std::memory_order_relaxed);
+                });
+            }
+
+        //! Add count to a bin
+        void add(size_t bin, T count)
+            {
+            addAtomic(m_bins[bin], count, std::is_integral<T>());
+            }
+
+        //! Get the number of bins
+        size_t size() const
+            {
+            return m_n;
+            }
+
+        //! Get the bytes of the bins
+        size_t getMemoryBytes() const
+            {
+            return m_bins ? m_n*sizeof(std::atomic<T>) : 0;
+            }
+
+        //! Copy the bins to a result of n bins, zero where the histogram has none, then apply finish to each tile
+        //! of it, as reduceLocalHistograms() does
+        /*! Call it once the parallel loops that add to the histogram are done.
+        */
+        template<class TileOp>
+        void copyTo(T *result, size_t n, const TileOp& finish) const
+            {
+            ScopedRange annotation("freud::AtomicHistogram::copyTo");
+            const std::atomic<T> *bins = m_bins.get();
+            const size_t num_bins = m_n;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, n, REDUCTION_TILE_SIZE),
+                [=, &finish] (const tbb::blocked_range<size_t>& r)
+                {
+                for (size_t i = r.begin(); i != r.end(); i++)
+                    result[i] = (i < num_bins) ? bins[i].load(std::memory_order_relaxed) : T(0);
+                finish(r.begin(), r.end());
+                });
+            }
+
+        //! Copy the bins to a result of n bins
+        void copyTo(T *result, size_t n) const
+            {
+            copyTo(result, n, [] (size_t, size_t) {});
+            }
+
+        //! Add the counts of a histogram of as many bins
+        void addFrom(const T *counts)
+            {
+            std::atomic<T> *bins = m_bins.get();
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_n, REDUCTION_TILE_SIZE),
+                [=] (const tbb::blocked_range<size_t>& r)
+                {
+                for (size_t i = r.begin(); i != r.end(); i++)
+                    if (counts[i] != T(0))
+                        addAtomic(bins[i], counts[i], std::is_integral<T>());
+                });
+            }
+
+    private:
+        static void addAtomic(std::atomic<T>& bin, T count, std::true_type)
+            {
+            bin.fetch_add(count, std::memory_order_relaxed);
+            }
+
+        static void addAtomic(std::atomic<T>& bin, T count, std::false_type)
+            {
+            T old = bin.load(std::memory_order_relaxed);
+            while (!bin.compare_exchange_weak(old, old + count, std::memory_order_relaxed))
+                {
+                }
+            }
+
+        std::unique_ptr<std::atomic<T>[]> m_bins;   //!< Bins
+        size_t m_n;                                 //!< Number of bins
+    };
+
+//! Write-combining buffer of the increments of one task to an AtomicHistogram
+/*! The buffer keeps ATOMIC_BUFFER_SLOTS bins, each in the slot given by its lowest bits, with the count added to it
+    since it entered the slot. A bin taking the slot of another flushes that one to the histogram, so the pairs that
+    fall in the same few bins in a row, as those of a reference point do, cost one atomic operation per bin instead
+    of one per pair. The buffer is flushed by its destructor, at the end of the task.
+*/
+template<typename T>
+class AtomicHistogramBuffer
+    {
+    public:
+        //! Constructor
+        explicit AtomicHistogramBuffer(AtomicHistogram<T> *histogram)
+            : m_histogram(histogram)
+            {
+            for (unsigned int s = 0; s < ATOMIC_BUFFER_SLOTS; s++)
+                {
+                m_bins[s] = empty;
+                m_counts[s] = T(0);
+                }
+            }
+
+        //! Destructor, flushing the buffer
+        ~AtomicHistogramBuffer()
+            {
+            flush();
+            }
+
+        AtomicHistogramBuffer(const AtomicHistogramBuffer&) = delete;
+        AtomicHistogramBuffer& operator=(const AtomicHistogramBuffer&) = delete;
+
+        //! Add count to a bin
+        void add(size_t bin, T count)
+            {
+            unsigned int slot = bin & (ATOMIC_BUFFER_SLOTS - 1);
+            if (m_bins[slot] != bin)
+                {
+                if (m_bins[slot] != empty)
+                    m_histogram->add(m_bins[slot], m_counts[slot]);
+                m_bins[slot] = bin;
+                m_counts[slot] = T(0);
+                }
+            m_counts[slot] += count;
+            }
+
+        //! Add the buffered counts to the histogram and empty the buffer
+        void flush()
+            {
+            for (unsigned int s = 0; s < ATOMIC_BUFFER_SLOTS; s++)
+                if (m_bins[s] != empty)
+                    {
+                    m_histogram->add(m_bins[s], m_counts[s]);
+                    m_bins[s] = empty;
+                    m_counts[s] = T(0);
+                    }
+            }
+
+    private:
+        static const size_t empty = ~size_t(0);     //!< Bin of the unused slots
+
+        AtomicHistogram<T> *m_histogram;            //!< Histogram the counts are flushed to
+        size_t m_bins[ATOMIC_BUFFER_SLOTS];         //!< Bin of each slot, or empty
+        T m_counts[ATOMIC_BUFFER_SLOTS];            //!< Count added to the bin of each slot since it entered it
+    };
+
+template<typename T>
+const size_t AtomicHistogramBuffer<T>::empty;
+
+}; }; // end namespace freud::util
+
+#endif // _ATOMIC_HISTOGRAM_H__
@@ -0,0 +1,26 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdint.h>
+
+#ifndef _BIN_COUNT_H__
+#define _BIN_COUNT_H__
+
+/*! \file BinCount.h
+    \brief Integer type of accumulated histogram bins
+*/
+
+namespace freud { namespace util {
+
+// Handle both 32 and 64 bit histogram bins through a define
+#ifdef FREUD_BIN_COUNT_64
+//! Integer type of the bins that histograms accumulate over many frames (64 bit)
+typedef uint64_t BinCount;
+#else
+//! Integer type of the bins that histograms accumulate over many frames (32 bit)
+typedef unsigned int BinCount;
+#endif
+
+}; }; // end namespace freud::util
+
+#endif // _BIN_COUNT_H__
@@ -0,0 +1,134 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _BIN_EDGES_H__
+#define _BIN_EDGES_H__
+
+/*! \file BinEdges.h
+    \brief Edges of the bins of a histogram over distances, uniform or not
+*/
+
+namespace freud { namespace util {
+
+//! Edges of the bins of a 1D histogram, with a constant time lookup of the bin of a value
+/*! Bin i covers [getEdges()[i], getEdges()[i+1]). Uniform bins of width dr are found by a truncated division, as
+    before. For arbitrary increasing edges a lookup table over a regular grid as fine as the narrowest bin (up to
+    MAX_LOOKUP_SIZE entries) stores the bin at the start of each grid cell, so getBin() reads the table and steps over
+    at most one edge in the common case, instead of a binary search. Narrow bins where the resolution matters thus
+    cost no more per lookup than a uniform histogram with the same number of bins.
+*/
+class BinEdges
+    {
+    public:
+        //! Largest number of entries of the lookup table of non-uniform edges
+        static const unsigned int MAX_LOOKUP_SIZE = 1 << 16;
+
+        //! Default constructor, no bins
+        BinEdges() : m_nbins(0), m_uniform(true), m_inv_width(0.0f), m_lookup_inv_width(0.0f)
+            {
+            }
+
+        //! floor(rmax/dr) uniform bins of width dr starting at 0
+        BinEdges(float rmax, float dr) : m_uniform(true), m_lookup_inv_width(0.0f)
+            {
+            if (dr <= 0.0f)
+                throw std::invalid_argument("dr must be positive");
+            m_nbins = int(floorf(rmax / dr));
+            m_inv_width = 1.0f / dr;
+            m_edges.resize(m_nbins + 1);
+            for (unsigned int i = 0; i <= m_nbins; i++)
+                m_edges[i] = float(i) * dr;
+            }
+
+        //! Bins between consecutive values of the strictly increasing edges
+        explicit BinEdges(const std::vector<float>& edges)
+            : m_edges(edges), m_uniform(false), m_inv_width(0.0f)
+            {
+            if (edges.size() < 2)
+                throw std::invalid_argument("at least two bin edges are needed");
+            if (edges[0] < 0.0f)
+                throw std::invalid_argument("bin edges must not be negative");
+            float min_width = edges[1] - edges[0];
+            for (unsigned int i = 1; i < edges.size(); i++)
+                {
+                if (!(edges[i] > edges[i-1]))
+                    throw std::invalid_argument("bin edges must be strictly increasing");
+                min_width = std::min(min_width, edges[i] - edges[i-1]);
+                }
+            m_nbins = edges.size() - 1;
+
+            // grid cells no wider than the narrowest bin contain at most one edge each
+            float range = edges.back() - edges.front();
+            unsigned int lookup_size = (unsigned int) std::min(ceilf(range / min_width), float(MAX_LOOKUP_SIZE));
+            lookup_size = std::max(lookup_size, 1u);
+            m_lookup_inv_width = float(lookup_size) / range;
+            m_lookup.resize(lookup_size);
+            unsigned int bin = 0;
+            for (unsigned int g = 0; g < lookup_size; g++)
+                {
+                float start = edges.front() + float(g) / m_lookup_inv_width;
+                while (bin + 1 < m_nbins && start >= edges[bin+1])
+                    bin++;
+                m_lookup[g] = bin;
+                }
+            }
+
+        //! Get the number of bins
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Get the nbins + 1 edges
+        const std::vector<float>& getEdges() const
+            {
+            return m_edges;
+            }
+
+        //! Get the upper edge of the last bin
+        float getMax() const
+            {
+            return m_edges.back();
+            }
+
+        //! True when the bins were constructed uniform from rmax and dr
+        bool isUniform() const
+            {
+            return m_uniform;
+            }
+
+        //! Get the bin of a non-negative value r, getNBins() or more when r is outside of the bins
+        unsigned int getBin(float r) const
+            {
+            if (m_uniform)
+                return (unsigned int)(r * m_inv_width);
+
+            if (r < m_edges.front() || r >= m_edges.back())
+                return m_nbins;
+            unsigned int g = (unsigned int)((r - m_edges.front()) * m_lookup_inv_width);
+            unsigned int bin = m_lookup[std::min(g, (unsigned int) m_lookup.size() - 1)];
+            // the grid cell may start in the previous bin or, after rounding, just past r
+            while (bin + 1 < m_nbins && r >= m_edges[bin+1])
+                bin++;
+            while (bin > 0 && r < m_edges[bin])
+                bin--;
+            return bin;
+            }
+
+    private:
+        std::vector<float> m_edges;             //!< Edges of the bins
+        unsigned int m_nbins;                   //!< Number of bins
+        bool m_uniform;                         //!< True for uniform bins starting at 0
+        float m_inv_width;                      //!< Inverse width of uniform bins
+        float m_lookup_inv_width;               //!< Inverse width of the cells of the lookup grid
+        std::vector<unsigned int> m_lookup;     //!< Bin at the start of each cell of the lookup grid
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _BIN_EDGES_H__
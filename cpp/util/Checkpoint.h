@@ -0,0 +1,259 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "box.h"
+
+#ifndef _CHECKPOINT_H__
+#define _CHECKPOINT_H__
+
+/*! \file Checkpoint.h
+    \brief Binary checkpoints of the accumulated state of the analyses
+*/
+
+namespace freud { namespace util {
+
+//! Version of the checkpoint format
+const uint32_t CHECKPOINT_VERSION = 1;
+
+//! Write the accumulated state of an analysis to a binary checkpoint file
+/*! A checkpoint is the magic "FREUDCKP", the version of the format and the name of the class, then the fields the
+    class writes, in order and as their raw bytes in the byte order of the machine. An array is its number of elements
+    and the size of one element followed by the elements, so a histogram is written in one go; a histogram with few
+    non-empty bins is written as the bins and counts of those only.
+
+    The file is written next to its destination and renamed over it by close(), so a job stopped while saving leaves
+    the previous checkpoint in place.
+*/
+class CheckpointWriter
+    {
+    public:
+        //! Constructor
+        /*! \param filename Checkpoint file
+            \param kind Name of the class whose state is written
+        */
+        CheckpointWriter(const std::string& filename, const std::string& kind)
+            : m_filename(filename), m_tmp_filename(filename + ".tmp")
+            {
+            m_out.open(m_tmp_filename.c_str(), std::ios::binary | std::ios::trunc);
+            if (!m_out)
+                throw std::runtime_error("Cannot write the checkpoint file " + m_tmp_filename);
+            m_out.write("FREUDCKP", 8);
+            write(CHECKPOINT_VERSION);
+            writeString(kind);
+            }
+
+        //! Destructor, removing the file if close() was not called
+        ~CheckpointWriter()
+            {
+            if (m_out.is_open())
+                {
+                m_out.close();
+                remove(m_tmp_filename.c_str());
+                }
+            }
+
+        //! Write a value
+        template<typename T>
+        void write(const T& value)
+            {
+            m_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+        //! Write an array of n values
+        template<typename T>
+        void writeArray(const T *values, size_t n)
+            {
+            write(uint64_t(n));
+            write(uint32_t(sizeof(T)));
+            m_out.write(reinterpret_cast<const char*>(values), n*sizeof(T));
+            }
+
+        //! Write a histogram of n bins, as the non-empty bins only if that is smaller
+        template<typename T>
+        void writeHistogram(const T *counts, size_t n)
+            {
+            std::vector<uint64_t> bins;
+            for (size_t i = 0; i < n && (bins.size() + 1)*(sizeof(uint64_t) + sizeof(T)) < n*sizeof(T); i++)
+                if (counts[i] != T(0))
+                    bins.push_back(i);
+            bool sparse = (bins.size() + 1)*(sizeof(uint64_t) + sizeof(T)) < n*sizeof(T);
+            write(uint8_t(sparse));
+            if (!sparse)
+                {
+                writeArray(counts, n);
+                return;
+                }
+            std::vector<T> values(bins.size());
+            for (size_t k = 0; k < bins.size(); k++)
+                values[k] = counts[bins[k]];
+            write(uint64_t(n));
+            writeArray(bins.data(), bins.size());
+            writeArray(values.data(), values.size());
+            }
+
+        //! Write a string
+        void writeString(const std::string& value)
+            {
+            writeArray(value.data(), value.size());
+            }
+
+        //! Write a box
+        void writeBox(const box::Box& box)
+            {
+            const float values[6] = {box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+                                     box.getTiltFactorXZ(), box.getTiltFactorYZ()};
+            writeArray(values, 6);
+            write(uint8_t(box.is2D()));
+            }
+
+        //! Finish the file and move it to its destination
+        void close()
+            {
+            m_out.close();
+            if (m_out.fail() || rename(m_tmp_filename.c_str(), m_filename.c_str()) != 0)
+                {
+                remove(m_tmp_filename.c_str());
+                throw std::runtime_error("Cannot write the checkpoint file " + m_filename);
+                }
+            }
+
+    private:
+        std::string m_filename;         //!< Destination of the checkpoint
+        std::string m_tmp_filename;     //!< File being written
+        std::ofstream m_out;            //!< Stream of the file being written
+    };
+
+//! Read a checkpoint written by CheckpointWriter
+/*! The fields are read in the order they were written. A file that is not a checkpoint of the class, of another
+    version or truncated throws std::invalid_argument, as do arrays whose size is not that expected.
+*/
+class CheckpointReader
+    {
+    public:
+        //! Constructor
+        /*! \param filename Checkpoint file
+            \param kind Name of the class whose state is read
+        */
+        CheckpointReader(const std::string& filename, const std::string& kind)
+            : m_in(filename.c_str(), std::ios::binary)
+            {
+            if (!m_in)
+                throw std::invalid_argument("Cannot open the checkpoint file " + filename);
+            char magic[8];
+            m_in.read(magic, 8);
+            if (!m_in || std::string(magic, 8) != "FREUDCKP")
+                throw std::invalid_argument(filename + " is not a checkpoint file");
+            if (read<uint32_t>() != CHECKPOINT_VERSION)
+                throw std::invalid_argument("The checkpoint file " + filename + " is of another version");
+            std::string saved_kind = readString();
+            if (saved_kind != kind)
+                throw std::invalid_argument("The checkpoint file " + filename + " holds the state of a " + saved_kind +
+                                            ", not of a " + kind);
+            }
+
+        //! Read a value
+        template<typename T>
+        T read()
+            {
+            T value;
+            m_in.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if (!m_in)
+                throw std::invalid_argument("The checkpoint file is truncated");
+            return value;
+            }
+
+        //! Read an array of any number of values
+        template<typename T>
+        void readArray(std::vector<T>& values)
+            {
+            const uint64_t n = read<uint64_t>();
+            if (read<uint32_t>() != sizeof(T))
+                throw std::invalid_argument("The checkpoint file has values of another size");
+            values.resize(n);
+            m_in.read(reinterpret_cast<char*>(values.data()), n*sizeof(T));
+            if (!m_in)
+                throw std::invalid_argument("The checkpoint file is truncated");
+            }
+
+        //! Read a histogram of n bins written by CheckpointWriter::writeHistogram()
+        template<typename T>
+        void readHistogram(std::vector<T>& counts, size_t n)
+            {
+            const bool sparse = read<uint8_t>() != 0;
+            if (!sparse)
+                {
+                readArray(counts);
+                if (counts.size() != n)
+                    throw std::invalid_argument("The checkpoint file has a histogram of another number of bins");
+                return;
+                }
+            if (read<uint64_t>() != n)
+                throw std::invalid_argument("The checkpoint file has a histogram of another number of bins");
+            std::vector<uint64_t> bins;
+            std::vector<T> values;
+            readArray(bins);
+            readArray(values);
+            if (values.size() != bins.size())
+                throw std::invalid_argument("The checkpoint file is corrupted");
+            counts.assign(n, T(0));
+            for (size_t k = 0; k < bins.size(); k++)
+                {
+                if (bins[k] >= n)
+                    throw std::invalid_argument("The checkpoint file is corrupted");
+                counts[bins[k]] = values[k];
+                }
+            }
+
+        //! Read a string
+        std::string readString()
+            {
+            std::vector<char> chars;
+            readArray(chars);
+            return std::string(chars.begin(), chars.end());
+            }
+
+        //! Read a box
+        box::Box readBox()
+            {
+            std::vector<float> values;
+            readArray(values);
+            if (values.size() != 6)
+                throw std::invalid_argument("The checkpoint file is corrupted");
+            const bool is2D = read<uint8_t>() != 0;
+            return box::Box(values[0], values[1], values[2], values[3], values[4], values[5], is2D);
+            }
+
+        //! Read a value and check that it is the one of this object
+        /*! \param what Name of the value in the error message
+        */
+        template<typename T>
+        void expect(const T& value, const std::string& what)
+            {
+            if (read<T>() != value)
+                throw std::invalid_argument("The checkpoint file does not match the " + what + " of this object");
+            }
+
+        //! Read an array and check that it is the one of this object
+        template<typename T>
+        void expectArray(const std::vector<T>& values, const std::string& what)
+            {
+            std::vector<T> saved;
+            readArray(saved);
+            if (saved != values)
+                throw std::invalid_argument("The checkpoint file does not match the " + what + " of this object");
+            }
+
+    private:
+        std::ifstream m_in;     //!< Stream of the file
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _CHECKPOINT_H__
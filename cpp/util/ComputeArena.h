@@ -0,0 +1,226 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+#ifndef _COMPUTE_ARENA_H__
+#define _COMPUTE_ARENA_H__
+
+/*! \file ComputeArena.h
+    \brief Reuse of the output and scratch arrays of repeated compute calls
+
+    Analyses are typically called once per frame with the same number of points. reuseArray() keeps an output array
+    whose capacity suffices instead of allocating a new one, and a ScratchArena hands out the temporary arrays of a
+    call from blocks it keeps between calls, so that the calls after the first allocate nothing on the heap.
+    ThreadScratch does the same for the temporaries of the threads, used inside the parallel loops.
+*/
+
+namespace freud { namespace util {
+
+//! Deleter of the arrays of reuseArray(), recording how many elements they hold
+template<class T>
+struct ArrayDeleter
+    {
+    explicit ArrayDeleter(size_t n) : capacity(n)
+        {
+        }
+
+    void operator()(T *p) const
+        {
+        delete[] p;
+        }
+
+    size_t capacity;        //!< Number of elements of the array
+    };
+
+//! Make \a array hold at least \a n elements, keeping it when it is large enough already
+/*! The capacity is kept in the deleter of the shared_ptr, so that arrays allocated elsewhere, of unknown capacity, are
+    always replaced. The elements of a kept array are left as they were: callers overwrite or zero them. An array
+    that is replaced stays valid for whoever still holds a reference to it.
+*/
+template<class T>
+void reuseArray(std::shared_ptr<T>& array, size_t n)
+    {
+    const ArrayDeleter<T> *deleter = std::get_deleter< ArrayDeleter<T> >(array);
+    if (array && deleter != NULL && deleter->capacity >= n)
+        return;
+    array = std::shared_ptr<T>(new T[n], ArrayDeleter<T>(n));
+    }
+
+//! Bump allocator of the temporary arrays of the compute calls of an analysis
+/*! Arrays are allocated within a Frame, which releases all of them when it goes out of scope, at the end of the call.
+    Requests that do not fit in the block get blocks of their own; when the last frame closes those are merged into
+    one block as large as all of them, so that a sequence of calls with the same sizes allocates only in the first.
+
+    The arena is not thread safe: allocate the arrays on the calling thread, before the parallel loops that use them.
+    The arrays are raw storage for trivially constructible types and are not initialized.
+*/
+class ScratchArena
+    {
+    public:
+        ScratchArena() : m_offset(0), m_used(0), m_depth(0)
+            {
+            }
+
+        //! Copies get an arena of their own
+        ScratchArena(const ScratchArena&) : m_offset(0), m_used(0), m_depth(0)
+            {
+            }
+
+        ScratchArena& operator=(const ScratchArena&)
+            {
+            return *this;
+            }
+
+        //! Scope of the temporary arrays of a call
+        class Frame
+            {
+            public:
+                explicit Frame(ScratchArena& arena)
+                    : m_arena(arena), m_offset(arena.m_offset), m_num_overflow(arena.m_overflow.size())
+                    {
+                    m_arena.m_depth++;
+                    }
+
+                ~Frame()
+                    {
+                    m_arena.m_offset = m_offset;
+                    m_arena.m_overflow.resize(m_num_overflow);
+                    if (--m_arena.m_depth == 0)
+                        m_arena.merge();
+                    }
+
+                //! Allocate an uninitialized array of \a n elements, valid until the frame closes
+                template<class T>
+                T *allocate(size_t n)
+                    {
+                    return static_cast<T*>(m_arena.allocateBytes(n*sizeof(T)));
+                    }
+
+            private:
+                Frame(const Frame&);
+                Frame& operator=(const Frame&);
+
+                ScratchArena& m_arena;          //!< Arena the arrays come from
+                size_t m_offset;                //!< Offset in the block when the frame opened
+                size_t m_num_overflow;          //!< Number of overflow blocks when the frame opened
+            };
+
+        //! Get the number of bytes of the block
+        size_t getCapacity() const
+            {
+            return m_block.size()*sizeof(Chunk);
+            }
+
+    private:
+        //! Unit of storage, aligned for any of the types of the analyses
+        union Chunk
+            {
+            double d;
+            long double ld;
+            long long ll;
+            void *p;
+            char simd[16];
+            };
+
+        void *allocateBytes(size_t bytes)
+            {
+            size_t chunks = (bytes + sizeof(Chunk) - 1)/sizeof(Chunk);
+            m_used += chunks;
+            if (m_offset + chunks <= m_block.size())
+                {
+                void *p = &m_block[m_offset];
+                m_offset += chunks;
+                return p;
+                }
+            m_overflow.push_back(std::unique_ptr<Chunk[]>(new Chunk[chunks > 0 ? chunks : 1]));
+            return m_overflow.back().get();
+            }
+
+        //! Grow the block to the largest use seen, once no array is in use
+        void merge()
+            {
+            if (m_used > m_block.size())
+                {
+                std::vector<Chunk>().swap(m_block);
+                m_block.resize(m_used);
+                }
+            m_overflow.clear();
+            m_offset = 0;
+            m_used = 0;
+            }
+
+        std::vector<Chunk> m_block;                             //!< Storage of the arrays
+        std::vector< std::unique_ptr<Chunk[]> > m_overflow;     //!< Arrays that did not fit in the block
+        size_t m_offset;                                        //!< Chunks of the block in use
+        size_t m_used;                                          //!< Chunks requested since the last merge
+        size_t m_depth;                                         //!< Number of open frames
+    };
+
+//! Scratch object of each thread, kept by an analysis across its compute calls
+/*! Temporaries allocated within the tasks of a parallel loop, such as the candidate vectors of a neighbor search,
+    are allocated again by every task of every call. Kept in a ThreadScratch member, the object of each thread, and
+    the capacity its vectors grew to, are reused by all the tasks the thread runs in the following calls: callers
+    clear or overwrite the contents, not the capacity.
+
+    The objects of new threads are copies of the exemplar given to the constructor. Copies of a ThreadScratch get
+    objects of their own. Only use it in non const methods: const methods may be called concurrently on the same
+    object, and would share the scratch of a thread.
+*/
+template<class T>
+class ThreadScratch
+    {
+    public:
+        ThreadScratch() : m_exemplar(), m_local(m_exemplar)
+            {
+            }
+
+        explicit ThreadScratch(const T& exemplar) : m_exemplar(exemplar), m_local(exemplar)
+            {
+            }
+
+        //! Copies get objects of their own
+        ThreadScratch(const ThreadScratch& other) : m_exemplar(other.m_exemplar), m_local(other.m_exemplar)
+            {
+            }
+
+        ThreadScratch& operator=(const ThreadScratch& other)
+            {
+            if (this != &other)
+                {
+                m_exemplar = other.m_exemplar;
+                m_local = tbb::enumerable_thread_specific<T>(m_exemplar);
+                }
+            return *this;
+            }
+
+        //! Get the object of the calling thread
+        T& local()
+            {
+            return m_local.local();
+            }
+
+        //! Free the objects of all the threads
+        void clear()
+            {
+            m_local.clear();
+            }
+
+        //! Get the number of threads that have an object
+        size_t size() const
+            {
+            return m_local.size();
+            }
+
+    private:
+        T m_exemplar;                                   //!< Object the objects of new threads are copied from
+        tbb::enumerable_thread_specific<T> m_local;     //!< Object of each thread
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _COMPUTE_ARENA_H__
@@ -0,0 +1,103 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _FFT_H__
+#define _FFT_H__
+
+/*! \file FFT.h
+    \brief Fast Fourier transforms of periodic grids with power of two widths
+*/
+
+namespace freud { namespace util {
+
+//! True when n is a power of two
+inline bool isPowerOfTwo(unsigned int n)
+    {
+    return n > 0 && (n & (n - 1)) == 0;
+    }
+
+//! In place iterative radix-2 transform of n complex values, n a power of two
+/*! \param data values to transform
+    \param n number of values
+    \param inverse true for the inverse transform, which is not divided by n
+*/
+inline void fft1D(std::complex<double> *data, unsigned int n, bool inverse)
+    {
+    // bit reversal permutation
+    for (unsigned int i = 1, j = 0; i < n; i++)
+        {
+        unsigned int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(data[i], data[j]);
+        }
+
+    for (unsigned int len = 2; len <= n; len <<= 1)
+        {
+        double angle = 2.0 * M_PI / double(len) * (inverse ? 1.0 : -1.0);
+        std::complex<double> w_len(cos(angle), sin(angle));
+        for (unsigned int i = 0; i < n; i += len)
+            {
+            std::complex<double> w(1.0, 0.0);
+            for (unsigned int j = 0; j < len / 2; j++)
+                {
+                std::complex<double> u = data[i + j];
+                std::complex<double> v = data[i + j + len / 2] * w;
+                data[i + j] = u + v;
+                data[i + j + len / 2] = u - v;
+                w *= w_len;
+                }
+            }
+        }
+    }
+
+//! In place transform of a periodic w x h x d grid indexed like Index3D
+/*! Each axis is transformed in turn, the lines along it in parallel. The lines are copied to a contiguous buffer of
+    the task so that the strided axes are transformed without cache misses in the butterflies.
+
+    \param data w*h*d values to transform
+    \param inverse true for the inverse transform, which is not divided by w*h*d
+*/
+inline void fft3D(std::complex<double> *data, unsigned int w, unsigned int h, unsigned int d, bool inverse)
+    {
+    if (!isPowerOfTwo(w) || !isPowerOfTwo(h) || !isPowerOfTwo(d))
+        throw std::invalid_argument("grid widths must be powers of two");
+
+    const unsigned int widths[3] = {w, h, d};
+    const unsigned int strides[3] = {1, w, w * h};
+    for (unsigned int axis = 0; axis < 3; axis++)
+        {
+        const unsigned int n = widths[axis];
+        if (n == 1)
+            continue;
+        const unsigned int stride = strides[axis];
+        const unsigned int num_lines = (w * h * d) / n;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_lines),
+            [=] (const tbb::blocked_range<size_t>& r)
+            {
+            std::vector<std::complex<double> > line(n);
+            for (size_t l = r.begin(); l != r.end(); l++)
+                {
+                // the first element of line l, counting the lines over the other two axes
+                size_t start = (l % stride) + (l / stride) * stride * n;
+                for (unsigned int i = 0; i < n; i++)
+                    line[i] = data[start + i * stride];
+                fft1D(&line[0], n, inverse);
+                for (unsigned int i = 0; i < n; i++)
+                    data[start + i * stride] = line[i];
+                }
+            });
+        }
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _FFT_H__
@@ -0,0 +1,86 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef _HALF_FLOAT_H__
+#define _HALF_FLOAT_H__
+
+/*! \file HalfFloat.h
+    \brief Conversion of floats to and from IEEE 754 half precision, for compact outputs and storage
+*/
+
+namespace freud { namespace util {
+
+//! Bits of the IEEE 754 binary16 (numpy float16) value nearest to f, rounding ties to even
+/*! Values beyond the largest half (65504) become infinities, and NaNs stay NaNs.
+*/
+inline uint16_t floatToHalf(float f)
+    {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    const uint16_t sign = (x >> 16) & 0x8000;
+    x &= 0x7fffffff;
+
+    // infinities and NaNs
+    if (x >= 0x7f800000)
+        return sign | 0x7c00 | ((x > 0x7f800000) ? 0x0200 : 0);
+    // too large: rounds to infinity
+    if (x >= 0x47800000)
+        return sign | 0x7c00;
+    // normal halves: rebias the exponent and round the mantissa, a carry moving to the next exponent
+    if (x >= 0x38800000)
+        {
+        uint32_t h = (x - 0x38000000) >> 13;
+        const uint32_t rem = x & 0x1fff;
+        if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+            h++;
+        return sign | uint16_t(h);
+        }
+    // too small: rounds to zero
+    if (x <= 0x33000000)
+        return sign;
+    // subnormal halves, in units of 2^-24
+    const uint32_t mantissa = (x & 0x7fffff) | 0x800000;
+    const unsigned int shift = 126 - (x >> 23);
+    uint32_t h = mantissa >> shift;
+    const uint32_t rem = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (rem > halfway || (rem == halfway && (h & 1)))
+        h++;
+    return sign | uint16_t(h);
+    }
+
+//! The float of the IEEE 754 binary16 value with bits h, which is exact
+inline float halfToFloat(uint16_t h)
+    {
+    const uint32_t sign = uint32_t(h & 0x8000) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t x;
+    if (exponent == 0x1f)
+        x = sign | 0x7f800000 | (mantissa << 13);
+    else if (exponent != 0)
+        x = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    else if (mantissa == 0)
+        x = sign;
+    else
+        {
+        // subnormal halves are normal floats: shift the leading bit of the mantissa into the implicit one
+        uint32_t e = 113;
+        while (!(mantissa & 0x400))
+            {
+            mantissa <<= 1;
+            e--;
+            }
+        x = sign | (e << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _HALF_FLOAT_H__
@@ -0,0 +1,120 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AlignedArray.h"
+#include "Annotation.h"
+
+#ifndef _HISTOGRAM_REDUCTION_H__
+#define _HISTOGRAM_REDUCTION_H__
+
+/*! \file HistogramReduction.h
+    \brief Allocation and reduction of the per-thread histograms of accumulating analyses
+*/
+
+namespace freud { namespace util {
+
+//! Number of bins reduced by one task of reduceLocalHistograms
+const size_t REDUCTION_TILE_SIZE = 4096;
+
+//! Allocate a zeroed per-thread histogram of n bins aligned to a cache line
+/*! Call this from the thread that fills the histogram (the first call to local() of the enumerable_thread_specific
+    inside the parallel loop), so that the pages are zeroed, and thus placed, by the thread that uses them. The
+    alignment keeps the histograms of different threads off each other's cache lines, and large histograms are backed
+    by huge pages (see allocateAligned()).
+
+    \note Free the histogram with freeLocalHistogram()
+*/
+template<typename T>
+T *allocateLocalHistogram(size_t n)
+    {
+    void *bins = allocateAligned(n*sizeof(T));
+    memset(bins, 0, n*sizeof(T));
+    return (T*) bins;
+    }
+
+//! Free a histogram allocated with allocateLocalHistogram()
+template<typename T>
+void freeLocalHistogram(T *bins)
+    {
+    freeAligned((void*) bins);
+    }
+
+//! Free all the per-thread histograms of an enumerable_thread_specific
+template<typename T>
+void freeLocalHistograms(tbb::enumerable_thread_specific<T *>& local_bins)
+    {
+    for (typename tbb::enumerable_thread_specific<T *>::iterator i = local_bins.begin(); i != local_bins.end(); ++i)
+        freeLocalHistogram(*i);
+    local_bins.clear();
+    }
+
+//! Sum the per-thread histograms of n bins into result, then apply finish to each tile while it is in cache
+/*! result is overwritten, or zeroed when no thread has accumulated anything. The bins are split in tiles of at most
+    REDUCTION_TILE_SIZE that are reduced in parallel; each task streams through the same tile of every thread's
+    histogram in turn, so that it reads contiguous memory and keeps its partial sums in cache, instead of gathering
+    one bin from every thread's histogram at a time. The threads are summed in the order of local_bins, for every
+    bin, so the result is independent of the tiling.
+
+    finish(begin, end) is called by the same task on each reduced tile [begin, end), so that an elementwise
+    normalization of the result costs no further pass over memory.
+*/
+template<typename T, class TileOp>
+void reduceLocalHistograms(const tbb::enumerable_thread_specific<T *>& local_bins, T *result, size_t n,
+                           const TileOp& finish)
+    {
+    ScopedRange annotation("freud::reduceLocalHistograms");
+    std::vector<const T*> histograms(local_bins.begin(), local_bins.end());
+    const T * const *local = histograms.empty() ? NULL : &histograms[0];
+    const size_t num_histograms = histograms.size();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n, REDUCTION_TILE_SIZE),
+        [=, &finish] (const tbb::blocked_range<size_t>& r)
+        {
+        ScopedRange task_annotation("freud::reduceLocalHistograms::tile");
+        if (num_histograms == 0)
+            memset((void*) (result + r.begin()), 0, r.size()*sizeof(T));
+        else
+            memcpy((void*) (result + r.begin()), (const void*) (local[0] + r.begin()), r.size()*sizeof(T));
+        for (size_t h = 1; h < num_histograms; h++)
+            {
+            const T *bins = local[h];
+            for (size_t i = r.begin(); i != r.end(); i++)
+                result[i] += bins[i];
+            }
+        finish(r.begin(), r.end());
+        });
+    }
+
+//! Sum the per-thread histograms of n bins into result
+template<typename T>
+void reduceLocalHistograms(const tbb::enumerable_thread_specific<T *>& local_bins, T *result, size_t n)
+    {
+    reduceLocalHistograms(local_bins, result, n, [] (size_t, size_t) {});
+    }
+
+//! Add n bins to the per-thread histogram of the calling thread, allocating it if the thread has none
+/*! This is how a restored checkpoint joins the accumulation: the bins are summed with the others by the next
+    reduction.
+*/
+template<typename T>
+void addToLocalHistogram(tbb::enumerable_thread_specific<T *>& local_bins, const T *counts, size_t n)
+    {
+    ScopedRange annotation("freud::addToLocalHistogram");
+    bool exists;
+    local_bins.local(exists);
+    if (! exists)
+        local_bins.local() = allocateLocalHistogram<T>(n);
+    T *bins = local_bins.local();
+    for (size_t i = 0; i < n; i++)
+        bins[i] += counts[i];
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _HISTOGRAM_REDUCTION_H__
@@ -157,6 +157,9 @@ class Index2DUpperTriangular
 
 //! Index a 3D array
 /*! Row major mapping of 3D onto 1D
+
+    When the width and the height are powers of two, indexPow2() and unravelPow2() compute the same mapping with
+    shifts and masks instead of multiplications, divisions and modulos.
     \ingroup utils
 */
 class Index3D
@@ -165,14 +168,20 @@ class Index3D
         //! Contstructor
         /*! \param w Width of the cubic 3D array
         */
-        HOSTDEVICE inline Index3D(unsigned int w=0) : m_w(w), m_h(w), m_d(w) {}
+        HOSTDEVICE inline Index3D(unsigned int w=0) : m_w(w), m_h(w), m_d(w)
+            {
+            setShifts();
+            }
 
         //! Contstructor
         /*! \param w Width of the 3D array
             \param h Height of the 3D array
             \param d Depth of the 3D array
         */
-        HOSTDEVICE inline Index3D(unsigned int w, unsigned int h, unsigned int d) : m_w(w), m_h(h), m_d(d) {}
+        HOSTDEVICE inline Index3D(unsigned int w, unsigned int h, unsigned int d) : m_w(w), m_h(h), m_d(d)
+            {
+            setShifts();
+            }
 
         //! Calculate an index
         /*! \param i index along the width
@@ -224,10 +233,47 @@ class Index3D
             return m_d;
             }
 
+        //! Test if the width and the height are powers of two, so that indexPow2() and unravelPow2() may be used
+        HOSTDEVICE inline bool isPowerOfTwo() const
+            {
+            return m_pow2;
+            }
+
+        //! Calculate an index with shifts, when isPowerOfTwo()
+        HOSTDEVICE inline unsigned int indexPow2(unsigned int i, unsigned int j, unsigned int k) const
+            {
+            return (k << m_shift_wh) | (j << m_shift_w) | i;
+            }
+
+        //! Unravel an index with shifts and masks, when isPowerOfTwo()
+        vec3<unsigned int> unravelPow2(unsigned int i) const
+            {
+            vec3<unsigned int> l_idx;
+            l_idx.x = i & (m_w - 1);
+            l_idx.y = (i >> m_shift_w) & (m_h - 1);
+            l_idx.z = i >> m_shift_wh;
+            return l_idx;
+            }
+
     private:
+        //! Find whether the width and the height are powers of two, and their base 2 logarithms
+        HOSTDEVICE inline void setShifts()
+            {
+            m_pow2 = m_w > 0 && m_h > 0 && (m_w & (m_w - 1)) == 0 && (m_h & (m_h - 1)) == 0;
+            m_shift_w = 0;
+            while (m_pow2 && (1u << m_shift_w) < m_w)
+                m_shift_w++;
+            m_shift_wh = m_shift_w;
+            while (m_pow2 && (1u << (m_shift_wh - m_shift_w)) < m_h)
+                m_shift_wh++;
+            }
+
         unsigned int m_w;   //!< Width of the 3D array
         unsigned int m_h;   //!< Height of the 3D array
         unsigned int m_d;   //!< Depth of the 3D array
+        bool m_pow2;        //!< True if the width and the height are powers of two
+        unsigned int m_shift_w;     //!< Base 2 logarithm of the width, when a power of two
+        unsigned int m_shift_wh;    //!< Base 2 logarithm of the width times the height, when powers of two
     };
 
 #endif
@@ -0,0 +1,72 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <map>
+#include <string>
+#include <stddef.h>
+
+#ifndef _MEMORY_USAGE_H__
+#define _MEMORY_USAGE_H__
+
+/*! \file MemoryUsage.h
+    \brief Accounting of the memory of the analyses, by component
+*/
+
+namespace freud { namespace util {
+
+//! Bytes allocated, or that would be allocated, by each component of an analysis
+/*! The components are named by what they hold, such as histogram (the accumulated arrays shared by the threads),
+    local_histograms (the copies of the threads) or cell_list, so that the memory that grows with the number of
+    threads, or with the number of points, can be told apart from the rest.
+*/
+class MemoryUsage
+    {
+    public:
+        //! Add bytes to a component
+        void add(const std::string& component, size_t bytes)
+            {
+            m_bytes[component] += bytes;
+            }
+
+        //! Get the bytes of each component
+        const std::map<std::string, size_t>& getComponents() const
+            {
+            return m_bytes;
+            }
+
+        //! Get the bytes of all the components
+        size_t getTotal() const
+            {
+            size_t total = 0;
+            for (std::map<std::string, size_t>::const_iterator i = m_bytes.begin(); i != m_bytes.end(); ++i)
+                total += i->second;
+            return total;
+            }
+
+    private:
+        std::map<std::string, size_t> m_bytes;  //!< Bytes of each component
+    };
+
+//! Bytes of the per-thread histograms of n bins allocated so far in an enumerable_thread_specific
+template<typename T>
+size_t localHistogramBytes(const tbb::enumerable_thread_specific<T *>& local_bins, size_t n)
+    {
+    return local_bins.size()*n*sizeof(T);
+    }
+
+//! Whether one copy of bytes per thread would exceed a memory limit in bytes, 0 for no limit
+inline bool exceedsMemoryLimit(size_t bytes, unsigned int num_threads, size_t limit)
+    {
+    return limit != 0 && double(bytes)*num_threads > double(limit);
+    }
+
+//! Whether one copy of bytes per thread of the current task arena would exceed a memory limit in bytes
+inline bool exceedsMemoryLimit(size_t bytes, size_t limit)
+    {
+    return exceedsMemoryLimit(bytes, tbb::this_task_arena::max_concurrency(), limit);
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _MEMORY_USAGE_H__
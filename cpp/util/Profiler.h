@@ -0,0 +1,179 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <tbb/spin_mutex.h>
+
+#ifndef _PROFILER_H__
+#define _PROFILER_H__
+
+/*! \file Profiler.h
+    \brief Optional wall times of the phases and counters of the compute calls of the analyses
+
+    The instrumentation is compiled in with the ENABLE_PROFILING option of CMake, which defines FREUD_PROFILING.
+    Without it, every member of Profiler, ProfilePhase and ProfileCount is an empty inline function, so the calls
+    left in the analyses compile to nothing and the timings and counters stay empty.
+*/
+
+namespace freud { namespace util {
+
+//! Whether the library was built with the instrumentation
+inline bool isProfilingEnabled()
+    {
+#ifdef FREUD_PROFILING
+    return true;
+#else
+    return false;
+#endif
+    }
+
+//! Wall times of the phases and counters of the last compute call of an analysis
+/*! The analysis resets its profiler at the start of each compute call; the counters may be added to from the threads
+    of a parallel loop, once per task with ProfileCount.
+*/
+class Profiler
+    {
+    public:
+        Profiler()
+            {
+            }
+
+        Profiler(const Profiler& other)
+            : m_timings(other.m_timings), m_stats(other.m_stats)
+            {
+            }
+
+        Profiler& operator=(const Profiler& other)
+            {
+            m_timings = other.m_timings;
+            m_stats = other.m_stats;
+            return *this;
+            }
+
+        //! Forget the timings and counters of the previous call
+        void reset()
+            {
+#ifdef FREUD_PROFILING
+            tbb::spin_mutex::scoped_lock lock(m_mutex);
+            m_timings.clear();
+            m_stats.clear();
+#endif
+            }
+
+        //! Add seconds to the wall time of a phase
+        void addTime(const char *phase, double seconds)
+            {
+#ifdef FREUD_PROFILING
+            tbb::spin_mutex::scoped_lock lock(m_mutex);
+            m_timings[phase] += seconds;
+#else
+            (void) phase;
+            (void) seconds;
+#endif
+            }
+
+        //! Add n to a counter, from any thread
+        void addCount(const char *name, unsigned long long n)
+            {
+#ifdef FREUD_PROFILING
+            tbb::spin_mutex::scoped_lock lock(m_mutex);
+            m_stats[name] += n;
+#else
+            (void) name;
+            (void) n;
+#endif
+            }
+
+        //! Get the wall time in seconds of each phase of the last call
+        const std::map<std::string, double>& getTimings() const
+            {
+            return m_timings;
+            }
+
+        //! Get the counters of the last call
+        const std::map<std::string, unsigned long long>& getStats() const
+            {
+            return m_stats;
+            }
+
+    private:
+        tbb::spin_mutex m_mutex;                                //!< Serializes the updates of the threads
+        std::map<std::string, double> m_timings;                //!< Seconds spent in each phase
+        std::map<std::string, unsigned long long> m_stats;      //!< Counters
+    };
+
+//! Add the wall time of a scope to a phase of a profiler
+class ProfilePhase
+    {
+    public:
+        ProfilePhase(Profiler& profiler, const char *phase)
+#ifdef FREUD_PROFILING
+            : m_profiler(profiler), m_phase(phase), m_start(clock::now())
+#endif
+            {
+#ifndef FREUD_PROFILING
+            (void) profiler;
+            (void) phase;
+#endif
+            }
+
+        ~ProfilePhase()
+            {
+            stop();
+            }
+
+        //! Add the time so far to the phase, which the destructor then leaves alone
+        void stop()
+            {
+#ifdef FREUD_PROFILING
+            if (m_phase != NULL)
+                m_profiler.addTime(m_phase, std::chrono::duration<double>(clock::now() - m_start).count());
+            m_phase = NULL;
+#endif
+            }
+
+    private:
+        ProfilePhase(const ProfilePhase&);
+        ProfilePhase& operator=(const ProfilePhase&);
+
+#ifdef FREUD_PROFILING
+        typedef std::chrono::steady_clock clock;
+
+        Profiler& m_profiler;               //!< Profiler the time is added to
+        const char *m_phase;                //!< Name of the phase
+        clock::time_point m_start;          //!< Start of the scope
+#endif
+    };
+
+//! Counter of one task of a parallel loop, added to a profiler once the task is done
+class ProfileCount
+    {
+    public:
+        ProfileCount() : m_count(0)
+            {
+            }
+
+        void add(unsigned long long n)
+            {
+#ifdef FREUD_PROFILING
+            m_count += n;
+#else
+            (void) n;
+#endif
+            }
+
+        //! Add the count to a counter of a profiler
+        void addTo(Profiler& profiler, const char *name) const
+            {
+            profiler.addCount(name, m_count);
+            }
+
+    private:
+        unsigned long long m_count;         //!< Count of the task
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _PROFILER_H__
@@ -0,0 +1,82 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdint.h>
+
+#include "saruprng.h"
+
+#ifndef _RANDOM_STREAM_H__
+#define _RANDOM_STREAM_H__
+
+/*! \file RandomStream.h
+    \brief Counter-based random number streams for reproducible parallel analyses
+*/
+
+namespace freud { namespace util {
+
+//! Random numbers that are a function of a seed, an index and a step only
+/*! A stochastic analysis that seeds one generator per thread, or per range of a parallel loop, draws different numbers
+    for the same item depending on how the loop was split, so its results change with the number of threads. A
+    RandomStream is instead identified by (seed, index, step): the index is that of the item the numbers are drawn
+    for (a particle, a replicate, a trial) and the step tells apart the successive uses of the same item, such as the
+    frames of a trajectory or the analyses sharing a seed. Any thread constructs the stream of an item where it needs
+    it, with no shared state, and gets the same numbers.
+
+    The stream is a Saru generator whose state is hashed from the three integers, so constructing it costs a few
+    integer operations and it is 8 bytes large; it is meant to be a local variable of the body of a parallel loop.
+*/
+class RandomStream
+    {
+    public:
+        //! Open the stream of an item
+        RandomStream(unsigned int seed, unsigned int index, unsigned int step)
+            : m_saru(seed, index, step)
+            {
+            }
+
+        //! Draw a uniform 32 bit integer
+        unsigned int u32()
+            {
+            return m_saru.u32();
+            }
+
+        //! Draw a uniform float in [0, 1)
+        float f()
+            {
+            return m_saru.f();
+            }
+
+        //! Draw a uniform double in [0, 1)
+        double d()
+            {
+            return m_saru.d();
+            }
+
+        //! Draw a uniform real in [low, high)
+        template<class Real>
+        Real s(Real low, Real high)
+            {
+            return m_saru.s<Real>(low, high);
+            }
+
+        //! Draw a uniform integer in [a, b]
+        int randomInt(int a, int b)
+            {
+            // scale the 32 bits to the range instead of taking a modulo, which favors the small values
+            uint64_t range = (uint64_t)((int64_t) b - (int64_t) a + 1);
+            return a + (int)(((uint64_t) m_saru.u32() * range) >> 32);
+            }
+
+        //! Get the underlying generator
+        Saru& saru()
+            {
+            return m_saru;
+            }
+
+    private:
+        Saru m_saru;        //!< Generator of the stream
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _RANDOM_STREAM_H__
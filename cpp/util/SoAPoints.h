@@ -0,0 +1,60 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#ifndef _SOA_POINTS_H__
+#define _SOA_POINTS_H__
+
+/*! \file SoAPoints.h
+    \brief Points stored as three arrays of coordinates
+*/
+
+namespace freud { namespace util {
+
+//! Read-only view of points stored as separate x, y and z arrays (a structure of arrays)
+/*! Trajectory formats such as DCD store the coordinates so; points[i] gives point i as a vec3<float>, like an array
+    of vec3<float> does, so code templated on the points takes either.
+*/
+struct SoAPoints
+    {
+    //! Constructor
+    SoAPoints(const float *x_, const float *y_, const float *z_)
+        : x(x_), y(y_), z(z_)
+        {
+        }
+
+    //! Get point i
+    vec3<float> operator[](size_t i) const
+        {
+        return vec3<float>(x[i], y[i], z[i]);
+        }
+
+    //! Test whether both views are of the same arrays
+    bool operator==(const SoAPoints& other) const
+        {
+        return x == other.x && y == other.y && z == other.z;
+        }
+
+    const float *x;     //!< x coordinates
+    const float *y;     //!< y coordinates
+    const float *z;     //!< z coordinates
+    };
+
+//! Interleave the coordinates of Np points into an array of vec3<float>, in parallel
+inline void interleavePoints(const SoAPoints& points, unsigned int Np, vec3<float> *out)
+    {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, Np),
+        [=] (const tbb::blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            out[i] = points[i];
+        });
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _SOA_POINTS_H__
@@ -0,0 +1,194 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+#include "HistogramReduction.h"
+
+#ifndef _SPARSE_HISTOGRAM_H__
+#define _SPARSE_HISTOGRAM_H__
+
+/*! \file SparseHistogram.h
+    \brief Per-thread histograms that only store their non-empty bins
+*/
+
+namespace freud { namespace util {
+
+//! Number of bins from which the per-thread histograms of a large grid are sparse
+/*! A dense histogram of this many 32 bit bins takes 16 MB per thread.
+*/
+const size_t SPARSE_HISTOGRAM_MIN_BINS = size_t(1) << 22;
+
+//! Histogram that stores its non-empty bins in an open-addressing hash table
+/*! The per-thread histograms of a fine 3D grid are mostly empty: the pairs of a frame only reach the bins near the
+    shells of the neighbors. This histogram takes memory for the bins it has incremented only, in a table with linear
+    probing that doubles when it is half full. Its contents are added to a dense histogram by
+    reduceLocalHistograms().
+*/
+template<typename T>
+class SparseHistogram
+    {
+    public:
+        //! Constructor
+        SparseHistogram()
+            {
+            clear();
+            }
+
+        //! Add one to a bin
+        void increment(size_t bin)
+            {
+            add(bin, T(1));
+            }
+
+        //! Add count to a bin
+        void add(size_t bin, T count)
+            {
+            size_t slot = find(bin);
+            if (m_keys[slot] == empty)
+                {
+                m_keys[slot] = bin;
+                if (++m_size > m_keys.size()/2)
+                    {
+                    grow();
+                    slot = find(bin);
+                    }
+                }
+            m_values[slot] += count;
+            }
+
+        //! Remove all the bins
+        void clear()
+            {
+            m_keys.assign(64, empty);
+            m_values.assign(64, T(0));
+            m_size = 0;
+            }
+
+        //! Number of non-empty bins
+        size_t size() const
+            {
+            return m_size;
+            }
+
+        //! Bytes of the table
+        size_t getMemoryBytes() const
+            {
+            return m_keys.capacity()*sizeof(size_t) + m_values.capacity()*sizeof(T);
+            }
+
+        //! Add the bins to a dense histogram
+        /*! The keys of the table are distinct, so the slots are added in parallel.
+        */
+        void addTo(T *result) const
+            {
+            const size_t *keys = &m_keys[0];
+            const T *values = &m_values[0];
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_keys.size(), REDUCTION_TILE_SIZE),
+                [=] (const tbb::blocked_range<size_t>& r)
+                {
+                for (size_t i = r.begin(); i != r.end(); i++)
+                    if (keys[i] != empty)
+                        result[keys[i]] += values[i];
+                });
+            }
+
+    private:
+        static const size_t empty = ~size_t(0);     //!< Key of the unused slots
+
+        //! Slot of a bin, or the empty slot where it goes
+        size_t find(size_t bin) const
+            {
+            const size_t mask = m_keys.size() - 1;
+            size_t slot = (uint64_t(bin)*0x9E3779B97F4A7C15ull >> 32) & mask;
+            while (m_keys[slot] != empty && m_keys[slot] != bin)
+                slot = (slot + 1) & mask;
+            return slot;
+            }
+
+        //! Double the number of slots
+        void grow()
+            {
+            std::vector<size_t> keys(2*m_keys.size(), empty);
+            std::vector<T> values(2*m_keys.size(), T(0));
+            keys.swap(m_keys);
+            values.swap(m_values);
+            for (size_t i = 0; i < keys.size(); i++)
+                if (keys[i] != empty)
+                    {
+                    size_t slot = find(keys[i]);
+                    m_keys[slot] = keys[i];
+                    m_values[slot] = values[i];
+                    }
+            }
+
+        std::vector<size_t> m_keys;     //!< Bin of each slot, or empty
+        std::vector<T> m_values;        //!< Count of each slot
+        size_t m_size;                  //!< Number of non-empty bins
+    };
+
+template<typename T>
+const size_t SparseHistogram<T>::empty;
+
+//! Sum the per-thread sparse histograms into a dense result of n bins
+/*! result is overwritten. The histograms are added in the order of local_bins, so the result does not depend on
+    how the bins were distributed between the threads.
+*/
+template<typename T>
+void reduceLocalHistograms(const tbb::enumerable_thread_specific<SparseHistogram<T> >& local_bins, T *result,
+                           size_t n)
+    {
+    ScopedRange annotation("freud::reduceLocalHistograms::sparse");
+    memset((void*) result, 0, n*sizeof(T));
+    for (typename tbb::enumerable_thread_specific<SparseHistogram<T> >::const_iterator i = local_bins.begin();
+         i != local_bins.end(); ++i)
+        i->addTo(result);
+    }
+
+//! Sum the per-thread sparse histograms into a dense result of n bins, then apply finish to it by tiles
+/*! finish(begin, end) is called in parallel on tiles [begin, end) of at most REDUCTION_TILE_SIZE bins, as the dense
+    reduceLocalHistograms() does.
+*/
+template<typename T, class TileOp>
+void reduceLocalHistograms(const tbb::enumerable_thread_specific<SparseHistogram<T> >& local_bins, T *result,
+                           size_t n, const TileOp& finish)
+    {
+    reduceLocalHistograms(local_bins, result, n);
+    ScopedRange annotation("freud::reduceLocalHistograms::finish");
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n, REDUCTION_TILE_SIZE),
+        [&finish] (const tbb::blocked_range<size_t>& r)
+        {
+        ScopedRange task_annotation("freud::reduceLocalHistograms::tile");
+        finish(r.begin(), r.end());
+        });
+    }
+
+//! Bytes of the per-thread sparse histograms allocated so far
+template<typename T>
+size_t localHistogramBytes(const tbb::enumerable_thread_specific<SparseHistogram<T> >& local_bins)
+    {
+    size_t bytes = 0;
+    for (typename tbb::enumerable_thread_specific<SparseHistogram<T> >::const_iterator i = local_bins.begin();
+         i != local_bins.end(); ++i)
+        bytes += i->getMemoryBytes();
+    return bytes;
+    }
+
+//! Add the non-empty bins of n to the sparse histogram of the calling thread
+template<typename T>
+void addToLocalHistogram(tbb::enumerable_thread_specific<SparseHistogram<T> >& local_bins, const T *counts,
+                         size_t n)
+    {
+    ScopedRange annotation("freud::addToLocalHistogram");
+    SparseHistogram<T>& bins = local_bins.local();
+    for (size_t i = 0; i < n; i++)
+        if (counts[i] != T(0))
+            bins.add(i, counts[i]);
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _SPARSE_HISTOGRAM_H__
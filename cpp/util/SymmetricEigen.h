@@ -0,0 +1,105 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <math.h>
+
+#ifndef _SYMMETRIC_EIGEN_H__
+#define _SYMMETRIC_EIGEN_H__
+
+/*! \file SymmetricEigen.h
+    \brief Closed form eigen decomposition of 3x3 real symmetric matrices
+*/
+
+namespace freud { namespace util {
+
+//! \internal
+//! Unit eigenvector of the symmetric A for its simple eigenvalue lambda, from the rows of A - lambda
+/*! The cross product of two rows of A - lambda is along the eigenvector; the largest of the three is the most
+    accurate. Returns false when all three vanish, which means lambda is degenerate.
+*/
+inline bool symmetricEigenvector3(const double A[3][3], double lambda, double scale, double v[3])
+    {
+    const double r0[3] = {A[0][0] - lambda, A[0][1], A[0][2]};
+    const double r1[3] = {A[1][0], A[1][1] - lambda, A[1][2]};
+    const double r2[3] = {A[2][0], A[2][1], A[2][2] - lambda};
+    const double c[3][3] = {
+        {r0[1]*r1[2] - r0[2]*r1[1], r0[2]*r1[0] - r0[0]*r1[2], r0[0]*r1[1] - r0[1]*r1[0]},
+        {r0[1]*r2[2] - r0[2]*r2[1], r0[2]*r2[0] - r0[0]*r2[2], r0[0]*r2[1] - r0[1]*r2[0]},
+        {r1[1]*r2[2] - r1[2]*r2[1], r1[2]*r2[0] - r1[0]*r2[2], r1[0]*r2[1] - r1[1]*r2[0]}};
+    double normsq[3];
+    for (unsigned int k = 0; k < 3; k++)
+        normsq[k] = c[k][0]*c[k][0] + c[k][1]*c[k][1] + c[k][2]*c[k][2];
+    const unsigned int best = (normsq[0] >= normsq[1]) ? ((normsq[0] >= normsq[2]) ? 0 : 2)
+                                                        : ((normsq[1] >= normsq[2]) ? 1 : 2);
+    if (!(normsq[best] > 1e-20*scale*scale*scale*scale))
+        return false;
+    const double inv_norm = 1.0/sqrt(normsq[best]);
+    for (unsigned int k = 0; k < 3; k++)
+        v[k] = c[best][k]*inv_norm;
+    return true;
+    }
+
+//! Eigenvalues and eigenvectors of the 3x3 real symmetric matrix A
+/*! \param A Symmetric matrix
+    \param evalues Output: eigenvalues, in ascending order
+    \param evectors Output: unit eigenvectors in columns, in the order of the eigenvalues
+    \returns false if the eigenvalues are too close for the eigenvectors to be found in closed form; the eigenvalues
+             are still given, and the caller should fall back to an iterative method for the eigenvectors
+
+    The eigenvalues are the roots of the characteristic polynomial, in the trigonometric form of O. K. Smith,
+    Commun. ACM 4, 168 (1961); the eigenvectors of the smallest and the largest follow from cross products of the
+    rows of A - lambda, and the middle one is their cross product. There is no iteration and no data dependent loop,
+    and the work is done in double precision.
+*/
+inline bool symmetricEigen3(const double A[3][3], double evalues[3], double evectors[3][3])
+    {
+    const double q = (A[0][0] + A[1][1] + A[2][2])/3.0;
+    const double p1 = A[0][1]*A[0][1] + A[0][2]*A[0][2] + A[1][2]*A[1][2];
+    const double d0 = A[0][0] - q, d1 = A[1][1] - q, d2 = A[2][2] - q;
+    const double p = sqrt((d0*d0 + d1*d1 + d2*d2 + 2.0*p1)/6.0);
+    if (!(p > 0.0))
+        {
+        // a multiple of the identity
+        for (unsigned int k = 0; k < 3; k++)
+            {
+            evalues[k] = q;
+            for (unsigned int j = 0; j < 3; j++)
+                evectors[k][j] = (k == j) ? 1.0 : 0.0;
+            }
+        return true;
+        }
+
+    // det((A - q)/p)/2 = cos(3 phi)
+    const double inv_p = 1.0/p;
+    const double b00 = d0*inv_p, b11 = d1*inv_p, b22 = d2*inv_p;
+    const double b01 = A[0][1]*inv_p, b02 = A[0][2]*inv_p, b12 = A[1][2]*inv_p;
+    double r = 0.5*(b00*(b11*b22 - b12*b12) - b01*(b01*b22 - b12*b02) + b02*(b01*b12 - b11*b02));
+    r = (r < -1.0) ? -1.0 : ((r > 1.0) ? 1.0 : r);
+    const double phi = acos(r)/3.0;
+    evalues[2] = q + 2.0*p*cos(phi);
+    evalues[0] = q + 2.0*p*cos(phi + 2.0*M_PI/3.0);
+    evalues[1] = 3.0*q - evalues[0] - evalues[2];
+
+    // the eigenvectors are only well conditioned for separated eigenvalues
+    const double scale = fabs(q) + p;
+    if (evalues[1] - evalues[0] < 1e-3*p || evalues[2] - evalues[1] < 1e-3*p)
+        return false;
+    double v0[3], v2[3];
+    if (!symmetricEigenvector3(A, evalues[0], scale, v0) || !symmetricEigenvector3(A, evalues[2], scale, v2))
+        return false;
+    double v1[3] = {v2[1]*v0[2] - v2[2]*v0[1], v2[2]*v0[0] - v2[0]*v0[2], v2[0]*v0[1] - v2[1]*v0[0]};
+    const double inv_norm1 = 1.0/sqrt(v1[0]*v1[0] + v1[1]*v1[1] + v1[2]*v1[2]);
+    for (unsigned int k = 0; k < 3; k++)
+        v1[k] *= inv_norm1;
+    for (unsigned int k = 0; k < 3; k++)
+        {
+        evectors[k][0] = v0[k];
+        evectors[k][1] = v1[k];
+        evectors[k][2] = v2[k];
+        }
+    return true;
+    }
+
+}; }; // end namespace freud::util
+
+#endif // _SYMMETRIC_EIGEN_H__
@@ -188,4 +188,149 @@ tensor4<Real> operator/=(tensor4<Real>& a, const Real& b)
     return a;
     }
 
+//! Number of independent components of a fully symmetric rank 4 tensor in 3 dimensions
+const unsigned int SYM_TENSOR4_SIZE = 15;
+
+//! Index in a sym_tensor4 of the component i j k l (in any order)
+inline unsigned int symTensor4Index(unsigned int i, unsigned int j, unsigned int k, unsigned int l)
+    {
+    // the component only depends on the number of indices equal to 1 and to 2, ny and nz
+    unsigned int ny = (i == 1) + (j == 1) + (k == 1) + (l == 1);
+    unsigned int nz = (i == 2) + (j == 2) + (k == 2) + (l == 2);
+    // components by increasing ny + nz, then by increasing nz: xxxx xxxy xxxz xxyy xxyz xxzz xyyy ...
+    unsigned int m = ny + nz;
+    return m*(m+1)/2 + nz;
+    }
+
+//! Number of the 81 components of a rank 4 tensor that are equal to component c of a sym_tensor4
+inline unsigned int symTensor4Multiplicity(unsigned int c)
+    {
+    static const unsigned int multiplicity[SYM_TENSOR4_SIZE] = {1, 4, 4, 6, 12, 6, 4, 12, 12, 4, 1, 4, 6, 4, 1};
+    return multiplicity[c];
+    }
+
+//! Fully symmetric rank 4 tensor, stored as its 15 independent components
+/*! The tensors of the cubatic order parameter are sums of v x v x v x v, which are symmetric: the symmetric
+    representation holds the same information in 15 components instead of 81, and its dot product weights each
+    component by the number of times it appears in the full tensor, so it equals the dot product of the full tensors.
+*/
+template < class Real >
+struct sym_tensor4
+    {
+    sym_tensor4()
+        {
+        for (unsigned int c = 0; c < SYM_TENSOR4_SIZE; c++)
+            data[c] = 0;
+        }
+    //! v x v x v x v
+    explicit sym_tensor4(const vec3<Real>& v)
+        {
+        Real xx = v.x*v.x, yy = v.y*v.y, zz = v.z*v.z;
+        Real xy = v.x*v.y, xz = v.x*v.z, yz = v.y*v.z;
+        data[0] = xx*xx; data[1] = xx*xy; data[2] = xx*xz;
+        data[3] = xx*yy; data[4] = xx*yz; data[5] = xx*zz;
+        data[6] = xy*yy; data[7] = xy*yz; data[8] = xy*zz; data[9] = xz*zz;
+        data[10] = yy*yy; data[11] = yy*yz; data[12] = yy*zz; data[13] = yz*zz; data[14] = zz*zz;
+        }
+    //! Conversion from another precision
+    template < class Other >
+    explicit sym_tensor4(const sym_tensor4<Other>& t)
+        {
+        for (unsigned int c = 0; c < SYM_TENSOR4_SIZE; c++)
+            data[c] = Real(t.data[c]);
+        }
+    //! Symmetric part of the full tensor t, which has the same dot product as t with any symmetric tensor
+    explicit sym_tensor4(const tensor4<Real>& t)
+        {
+        for (unsigned int c = 0; c < SYM_TENSOR4_SIZE; c++)
+            data[c] = 0;
+        unsigned int cnt = 0;
+        for (unsigned int i = 0; i < 3; i++)
+            for (unsigned int j = 0; j < 3; j++)
+                for (unsigned int k = 0; k < 3; k++)
+                    for (unsigned int l = 0; l < 3; l++)
+                        data[symTensor4Index(i, j, k, l)] += t.data[cnt++];
+        for (unsigned int c = 0; c < SYM_TENSOR4_SIZE; c++)
+            data[c] /= Real(symTensor4Multiplicity(c));
+        }
+    //! The full 81 component tensor
+    tensor4<Real> full() const
+        {
+        tensor4<Real> t;
+        unsigned int cnt = 0;
+        for (unsigned int i = 0; i < 3; i++)
+            for (unsigned int j = 0; j < 3; j++)
+                for (unsigned int k = 0; k < 3; k++)
+                    for (unsigned int l = 0; l < 3; l++)
+                        t.data[cnt++] = data[symTensor4Index(i, j, k, l)];
+        return t;
+        }
+    Real data[SYM_TENSOR4_SIZE];
+    };
+
+template < class Real >
+sym_tensor4<Real> operator+(const sym_tensor4<Real>& a, const sym_tensor4<Real>& b)
+    {
+    sym_tensor4<Real> c;
+    for (unsigned int i = 0; i < SYM_TENSOR4_SIZE; i++)
+        {
+        c.data[i] = a.data[i] + b.data[i];
+        }
+    return c;
+    }
+
+template < class Real >
+sym_tensor4<Real> operator+=(sym_tensor4<Real>& a, const sym_tensor4<Real>& b)
+    {
+    for (unsigned int i = 0; i < SYM_TENSOR4_SIZE; i++)
+        {
+        a.data[i] += b.data[i];
+        }
+    return a;
+    }
+
+template < class Real >
+sym_tensor4<Real> operator-(const sym_tensor4<Real>& a, const sym_tensor4<Real>& b)
+    {
+    sym_tensor4<Real> c;
+    for (unsigned int i = 0; i < SYM_TENSOR4_SIZE; i++)
+        {
+        c.data[i] = a.data[i] - b.data[i];
+        }
+    return c;
+    }
+
+template < class Real >
+sym_tensor4<Real> operator*(const sym_tensor4<Real>& a, const Real& b)
+    {
+    sym_tensor4<Real> c;
+    for (unsigned int i = 0; i < SYM_TENSOR4_SIZE; i++)
+        {
+        c.data[i] = a.data[i] * b;
+        }
+    return c;
+    }
+
+template < class Real >
+sym_tensor4<Real> operator*=(sym_tensor4<Real>& a, const Real& b)
+    {
+    for (unsigned int i = 0; i < SYM_TENSOR4_SIZE; i++)
+        {
+        a.data[i] *= b;
+        }
+    return a;
+    }
+
+//! Dot product of the full tensors
+template < class Real >
+Real dot(const sym_tensor4<Real>& a, const sym_tensor4<Real>& b)
+    {
+    Real c = 0;
+    for (unsigned int i = 0; i < SYM_TENSOR4_SIZE; i++)
+        {
+        c += Real(symTensor4Multiplicity(i)) * a.data[i] * b.data[i];
+        }
+    return c;
+    }
+
 #endif //__TENSOR_MATH_H__
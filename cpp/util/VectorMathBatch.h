@@ -0,0 +1,346 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <math.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifndef _VECTOR_MATH_BATCH_H__
+#define _VECTOR_MATH_BATCH_H__
+
+/*! \file VectorMathBatch.h
+    \brief Batches of vec3, quat and rotmat3 evaluated a SIMD register at a time
+
+    float_batch holds BATCH_WIDTH floats, in an SSE2 register when the compiler targets SSE2 and in a plain array
+    otherwise, and defines the arithmetic of a float on all of its lanes at once. The templates of VectorMath.h only
+    use that arithmetic, so that vec3<float_batch>, quat<float_batch> and rotmat3<float_batch> (vec3_batch,
+    quat_batch and rotmat3_batch) have the whole operator set of the scalar types: a kernel written with vec3<float>
+    rotates BATCH_WIDTH vectors at once by changing the type of its variables, and the load, gather, broadcast and
+    store functions below move the data between the batches and the usual arrays of vec3<float>, quat<float> and
+    rotmat3<float>.
+
+    The lanes are evaluated with the same operations in the same order as the scalar code, so the results match the
+    scalar types exactly. These types are for the host compiler only; VectorMath.h itself is shared with nvcc.
+
+    Usage:
+    \code
+    rotmat3_batch rot = broadcast_batch(rotmat3<float>(conj(ref_q)));
+    for (unsigned int k = 0; k + BATCH_WIDTH <= n; k += BATCH_WIDTH)
+        store_vec3_batch(rot*load_vec3_batch(vectors + k), x + k, y + k, z + k);
+    \endcode
+*/
+
+//! Number of lanes of a float_batch
+const unsigned int BATCH_WIDTH = 4;
+
+//! BATCH_WIDTH floats operated on at once
+struct float_batch
+    {
+    //! Default construct zeros
+    float_batch()
+        {
+        #ifdef __SSE2__
+        v = _mm_setzero_ps();
+        #else
+        for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+            v[l] = 0.0f;
+        #endif
+        }
+
+    //! Broadcast a float to every lane; implicit, so that the constants of the VectorMath templates convert
+    float_batch(float a)
+        {
+        #ifdef __SSE2__
+        v = _mm_set1_ps(a);
+        #else
+        for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+            v[l] = a;
+        #endif
+        }
+
+    #ifdef __SSE2__
+    //! Wrap an SSE2 register
+    explicit float_batch(__m128 a) : v(a)
+        {
+        }
+    #endif
+
+    //! Load BATCH_WIDTH consecutive floats, without alignment requirement
+    static float_batch load(const float *p)
+        {
+        float_batch result;
+        #ifdef __SSE2__
+        result.v = _mm_loadu_ps(p);
+        #else
+        for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+            result.v[l] = p[l];
+        #endif
+        return result;
+        }
+
+    //! Store the lanes to BATCH_WIDTH consecutive floats, without alignment requirement
+    void store(float *p) const
+        {
+        #ifdef __SSE2__
+        _mm_storeu_ps(p, v);
+        #else
+        for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+            p[l] = v[l];
+        #endif
+        }
+
+    //! Get the value of one lane
+    float lane(unsigned int l) const
+        {
+        float values[BATCH_WIDTH];
+        store(values);
+        return values[l];
+        }
+
+    #ifdef __SSE2__
+    __m128 v;                   //!< Lanes of the batch
+    #else
+    float v[BATCH_WIDTH];       //!< Lanes of the batch
+    #endif
+    };
+
+#ifdef __SSE2__
+#define FLOAT_BATCH_BINARY(op, intrinsic) \
+inline float_batch operator op(const float_batch& a, const float_batch& b) \
+    { \
+    return float_batch(intrinsic(a.v, b.v)); \
+    }
+#else
+#define FLOAT_BATCH_BINARY(op, intrinsic) \
+inline float_batch operator op(const float_batch& a, const float_batch& b) \
+    { \
+    float_batch result; \
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++) \
+        result.v[l] = a.v[l] op b.v[l]; \
+    return result; \
+    }
+#endif
+
+//! Lane-wise addition
+FLOAT_BATCH_BINARY(+, _mm_add_ps)
+//! Lane-wise subtraction
+FLOAT_BATCH_BINARY(-, _mm_sub_ps)
+//! Lane-wise multiplication
+FLOAT_BATCH_BINARY(*, _mm_mul_ps)
+//! Lane-wise division
+FLOAT_BATCH_BINARY(/, _mm_div_ps)
+
+#undef FLOAT_BATCH_BINARY
+
+//! Lane-wise negation
+inline float_batch operator-(const float_batch& a)
+    {
+    return float_batch(0.0f) - a;
+    }
+
+//! Lane-wise addition in place
+inline float_batch& operator+=(float_batch& a, const float_batch& b)
+    {
+    a = a + b;
+    return a;
+    }
+
+//! Lane-wise subtraction in place
+inline float_batch& operator-=(float_batch& a, const float_batch& b)
+    {
+    a = a - b;
+    return a;
+    }
+
+//! Lane-wise multiplication in place
+inline float_batch& operator*=(float_batch& a, const float_batch& b)
+    {
+    a = a * b;
+    return a;
+    }
+
+//! Lane-wise division in place
+inline float_batch& operator/=(float_batch& a, const float_batch& b)
+    {
+    a = a / b;
+    return a;
+    }
+
+//! Lane-wise square root
+inline float_batch sqrt(const float_batch& a)
+    {
+    #ifdef __SSE2__
+    return float_batch(_mm_sqrt_ps(a.v));
+    #else
+    float_batch result;
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        result.v[l] = sqrtf(a.v[l]);
+    return result;
+    #endif
+    }
+
+//! Lane-wise minimum
+inline float_batch min(const float_batch& a, const float_batch& b)
+    {
+    #ifdef __SSE2__
+    return float_batch(_mm_min_ps(a.v, b.v));
+    #else
+    float_batch result;
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        result.v[l] = (b.v[l] < a.v[l]) ? b.v[l] : a.v[l];
+    return result;
+    #endif
+    }
+
+//! Lane-wise maximum
+inline float_batch max(const float_batch& a, const float_batch& b)
+    {
+    #ifdef __SSE2__
+    return float_batch(_mm_max_ps(a.v, b.v));
+    #else
+    float_batch result;
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        result.v[l] = (a.v[l] < b.v[l]) ? b.v[l] : a.v[l];
+    return result;
+    #endif
+    }
+
+//! Bit l of the result is set when lane l of a is smaller than lane l of b
+inline int less_mask(const float_batch& a, const float_batch& b)
+    {
+    #ifdef __SSE2__
+    return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v));
+    #else
+    int mask = 0;
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        mask |= (a.v[l] < b.v[l]) ? (1 << l) : 0;
+    return mask;
+    #endif
+    }
+
+//! BATCH_WIDTH vec3, component by component
+typedef vec3<float_batch> vec3_batch;
+//! BATCH_WIDTH quaternions, component by component
+typedef quat<float_batch> quat_batch;
+//! BATCH_WIDTH rotation matrices, component by component
+typedef rotmat3<float_batch> rotmat3_batch;
+
+//! The same vector in every lane
+inline vec3_batch broadcast_batch(const vec3<float>& a)
+    {
+    return vec3_batch(float_batch(a.x), float_batch(a.y), float_batch(a.z));
+    }
+
+//! The same quaternion in every lane
+inline quat_batch broadcast_batch(const quat<float>& a)
+    {
+    return quat_batch(float_batch(a.s), broadcast_batch(a.v));
+    }
+
+//! The same matrix in every lane
+inline rotmat3_batch broadcast_batch(const rotmat3<float>& a)
+    {
+    return rotmat3_batch(broadcast_batch(a.row0), broadcast_batch(a.row1), broadcast_batch(a.row2));
+    }
+
+//! Load BATCH_WIDTH consecutive vec3<float>, lane l holding p[l]
+inline vec3_batch load_vec3_batch(const vec3<float> *p)
+    {
+    #ifdef __SSE2__
+    // load the 12 floats and transpose them to x, y, z lanes
+    const float *block = (const float *) p;
+    __m128 a = _mm_loadu_ps(block);
+    __m128 b = _mm_loadu_ps(block + 4);
+    __m128 c = _mm_loadu_ps(block + 8);
+    __m128 x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3,0,3,0)),
+                              _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,1,0));
+    __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)),
+                              _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+    __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)),
+                              _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,3,0,0)), _MM_SHUFFLE(2,0,2,0));
+    return vec3_batch(float_batch(x), float_batch(y), float_batch(z));
+    #else
+    vec3_batch result;
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        {
+        result.x.v[l] = p[l].x;
+        result.y.v[l] = p[l].y;
+        result.z.v[l] = p[l].z;
+        }
+    return result;
+    #endif
+    }
+
+//! Load BATCH_WIDTH vectors stored by component
+inline vec3_batch load_vec3_batch(const float *x, const float *y, const float *z)
+    {
+    return vec3_batch(float_batch::load(x), float_batch::load(y), float_batch::load(z));
+    }
+
+//! Store the lanes of a batch by component
+inline void store_vec3_batch(const vec3_batch& a, float *x, float *y, float *z)
+    {
+    a.x.store(x);
+    a.y.store(y);
+    a.z.store(z);
+    }
+
+//! Store the lanes of a batch to BATCH_WIDTH consecutive vec3<float>
+inline void store_vec3_batch(const vec3_batch& a, vec3<float> *p)
+    {
+    float x[BATCH_WIDTH], y[BATCH_WIDTH], z[BATCH_WIDTH];
+    store_vec3_batch(a, x, y, z);
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        p[l] = vec3<float>(x[l], y[l], z[l]);
+    }
+
+//! Gather the vectors base[idx[l]] into the lanes l of a batch
+inline vec3_batch gather_vec3_batch(const vec3<float> *base, const unsigned int *idx)
+    {
+    float x[BATCH_WIDTH], y[BATCH_WIDTH], z[BATCH_WIDTH];
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        {
+        const vec3<float>& a = base[idx[l]];
+        x[l] = a.x;
+        y[l] = a.y;
+        z[l] = a.z;
+        }
+    return load_vec3_batch(x, y, z);
+    }
+
+//! Gather the quaternions base[idx[l]] into the lanes l of a batch
+inline quat_batch gather_quat_batch(const quat<float> *base, const unsigned int *idx)
+    {
+    float s[BATCH_WIDTH], x[BATCH_WIDTH], y[BATCH_WIDTH], z[BATCH_WIDTH];
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        {
+        const quat<float>& a = base[idx[l]];
+        s[l] = a.s;
+        x[l] = a.v.x;
+        y[l] = a.v.y;
+        z[l] = a.v.z;
+        }
+    return quat_batch(float_batch::load(s), load_vec3_batch(x, y, z));
+    }
+
+//! Gather the matrices base[idx[l]] into the lanes l of a batch
+inline rotmat3_batch gather_rotmat3_batch(const rotmat3<float> *base, const unsigned int *idx)
+    {
+    float m[9][BATCH_WIDTH];
+    for (unsigned int l = 0; l < BATCH_WIDTH; l++)
+        {
+        const rotmat3<float>& a = base[idx[l]];
+        m[0][l] = a.row0.x; m[1][l] = a.row0.y; m[2][l] = a.row0.z;
+        m[3][l] = a.row1.x; m[4][l] = a.row1.y; m[5][l] = a.row1.z;
+        m[6][l] = a.row2.x; m[7][l] = a.row2.y; m[8][l] = a.row2.z;
+        }
+    return rotmat3_batch(load_vec3_batch(m[0], m[1], m[2]), load_vec3_batch(m[3], m[4], m[5]),
+                         load_vec3_batch(m[6], m[7], m[8]));
+    }
+
+#endif // _VECTOR_MATH_BATCH_H__
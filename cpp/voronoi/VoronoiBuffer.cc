@@ -4,83 +4,129 @@
 #include "VoronoiBuffer.h"
 #include "ScopedGILRelease.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 #include <memory>
 
 using namespace std;
+using namespace tbb;
 
-/*! \file GaussianDensity.cc
-    \brief Routines for computing Gaussian smeared densities from points
+/*! \file VoronoiBuffer.cc
+    \brief Periodic images of the particles near the faces of the box
 */
 
 namespace freud { namespace voronoi {
 
+//! \internal
+//! Range [first, last] of the image shifts n along one axis that put fractional coordinate f within buff of the box
+static void imageRange(float f, float buff, int& first, int& last)
+    {
+    // -buff < f + n < 1 + buff
+    first = int(floorf(-buff - f)) + 1;
+    last = int(ceilf(1.0f + buff - f)) - 1;
+    }
+
+//! \internal
+//! Ranges of the image shifts along each lattice vector that put p within the buffer of the box
+static void imageRanges(const box::Box& box, const vec3<float>& p, const vec3<float>& frac_buff,
+                        int first[3], int last[3])
+    {
+    const vec3<float> f = box.makeFraction(p);
+    imageRange(f.x, frac_buff.x, first[0], last[0]);
+    imageRange(f.y, frac_buff.y, first[1], last[1]);
+    if (box.is2D())
+        first[2] = last[2] = 0;
+    else
+        imageRange(f.z, frac_buff.z, first[2], last[2]);
+    }
+
 void VoronoiBuffer::compute(const float3 *points,
                             const unsigned int Np,
                             const float buff)
     {
+    // float3 and vec3<float> are both three packed floats, so the points are read in place instead of copied
+    static_assert(sizeof(float3) == sizeof(vec3<float>), "float3 and vec3<float> must have the same layout");
+    compute(reinterpret_cast<const vec3<float>*>(points), Np, buff);
+    }
+
+void VoronoiBuffer::compute(const vec3<float> *points,
+                            const unsigned int Np,
+                            const float buff)
+    {
     assert(points);
 
-    m_buffer_particles = std::shared_ptr<std::vector<float3> >(new std::vector<float3>());
-    std::vector<float3>& buffer_parts = *m_buffer_particles;
-    //get the box dimensions
-    float lx = m_box.getLx();
-    float ly = m_box.getLy();
-    float lz = m_box.getLz();
-    float lx_2 = 0.5*lx;
-    float ly_2 = 0.5*ly;
-    float lz_2 = 0.5*lz;
-    float lx_2_buff = 0.5*lx + buff;
-    float ly_2_buff = 0.5*ly + buff;
-    float lz_2_buff = 0.5*lz + buff;
-
-    float3 img;
-    buffer_parts.clear();
-    // for each particle
+    m_buff = buff;
+    const bool is2D = m_box.is2D();
+
+    // the buffer in fractional coordinates of each axis, from the distance between the faces of the box
+    const vec3<float> L = m_box.getNearestPlaneDistance();
+    const vec3<float> frac_buff(buff/L.x, buff/L.y, is2D ? 0.0f : buff/L.z);
+    const vec3<float> a0 = m_box.getLatticeVector(0);
+    const vec3<float> a1 = m_box.getLatticeVector(1);
+    const vec3<float> a2 = is2D ? vec3<float>(0, 0, 0) : m_box.getLatticeVector(2);
+
+    // count the images of each particle first, so that they can be written in parallel in the order of the
+    // particles; the particles farther than buff from every face, most of them, have none
+    std::shared_ptr<size_t> counts = std::shared_ptr<size_t>(new size_t[Np + 1], std::default_delete<size_t[]>());
+    size_t *counts_ptr = counts.get();
+    const box::Box box = m_box;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t particle = r.begin(); particle != r.end(); particle++)
+            {
+            const vec3<float> p(points[particle].x, points[particle].y, is2D ? 0.0f : points[particle].z);
+            int first[3], last[3];
+            imageRanges(box, p, frac_buff, first, last);
+            // the particle itself is one of the images when it is in the box
+            const bool inside = first[0] <= 0 && last[0] >= 0 && first[1] <= 0 && last[1] >= 0 &&
+                                first[2] <= 0 && last[2] >= 0;
+            size_t count = size_t(std::max(last[0] - first[0] + 1, 0))*size_t(std::max(last[1] - first[1] + 1, 0))*
+                           size_t(std::max(last[2] - first[2] + 1, 0));
+            counts_ptr[particle] = count - (inside ? 1 : 0);
+            }
+        });
+
+    size_t num_images = 0;
     for (unsigned int particle = 0; particle < Np; particle++)
-      {
-      // in 2D, only loop over the 0 z plane
-      if (m_box.is2D())
         {
-        for (int i=-1; i<=1; i++)
-          for (int j=-1; j<=1; j++)
-                if(i != 0 || j != 0)
-                  {
-                  img.x = points[particle].x + i*lx;
-                  img.y = points[particle].y + j*ly;
-                  img.z = 0.0;
-                  //check to see if this image in within a
-                  if(img.x < lx_2_buff && img.x > -lx_2_buff && img.y < ly_2_buff && img.y > -ly_2_buff)
-                      {
-                      buffer_parts.push_back(img);
-                      }
-                  }
+        size_t count = counts_ptr[particle];
+        counts_ptr[particle] = num_images;
+        num_images += count;
         }
-      else
+    counts_ptr[Np] = num_images;
+
+    // the vector keeps its capacity from frame to frame; a new one is made only while getBufferParticles() of the
+    // last frame is still held
+    if (!m_buffer_particles.unique())
+        m_buffer_particles = std::shared_ptr<std::vector<float3> >(new std::vector<float3>());
+    m_buffer_particles->resize(num_images);
+    float3 *buffer_parts = num_images ? &(*m_buffer_particles)[0] : NULL;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
         {
-        //loop over potential images
-        for (int i=-1; i<=1; i++)
-          for (int j=-1; j<=1; j++)
-              for (int k=-1; k<=1; k++)
-                if(!(i==0 && j==0 && k==0))
-                  {
-                  img.x = points[particle].x + i*lx;
-                  img.y = points[particle].y + j*ly;
-                  img.z = points[particle].z + k*lz;
-                  //check to see if this image in within a
-                  if(img.x < lx_2_buff && img.x > -lx_2_buff &&
-                     img.y < ly_2_buff && img.y > -ly_2_buff &&
-                     img.z < lz_2_buff && img.z > -lz_2_buff)
-                      {
-                      img.x -= lx_2;
-                      img.y -= ly_2;
-                      img.z -= lz_2;
-                      buffer_parts.push_back(img);
-                      }
-                  }
-        }
-      }
+        for (size_t particle = r.begin(); particle != r.end(); particle++)
+            {
+            size_t image = counts_ptr[particle];
+            if (image == counts_ptr[particle + 1])
+                continue;
+            const vec3<float> p(points[particle].x, points[particle].y, is2D ? 0.0f : points[particle].z);
+            int first[3], last[3];
+            imageRanges(box, p, frac_buff, first, last);
+            for (int i = first[0]; i <= last[0]; i++)
+                for (int j = first[1]; j <= last[1]; j++)
+                    for (int k = first[2]; k <= last[2]; k++)
+                        if (i != 0 || j != 0 || k != 0)
+                            {
+                            const vec3<float> img = p + float(i)*a0 + float(j)*a1 + float(k)*a2;
+                            buffer_parts[image].x = img.x;
+                            buffer_parts[image].y = img.y;
+                            buffer_parts[image].z = img.z;
+                            image++;
+                            }
+            }
+        });
     }
 
 // void VoronoiBuffer::computePy(boost::python::numeric::array points, const float buff)
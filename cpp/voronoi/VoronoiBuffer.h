@@ -3,27 +3,34 @@
 
 #include <memory>
 #include <vector>
+#include <tbb/tbb.h>
 
 #include "box.h"
 #include "Index1D.h"
+#include "VectorMath.h"
 
 #ifndef _VoronoiBuffer_H__
 #define _VoronoiBuffer_H__
 
 /*! \file VoronoiBuffer.h
-    \brief Routines for computing Gaussian smeared densities from points
+    \brief Periodic images of the particles near the faces of the box
 */
 
 namespace freud { namespace voronoi {
 
 //! Locates the particles near the border of the box and computes their nearest images to pass to qhull
-/*!
+/*! The images are the copies of the particles shifted by lattice vectors that fall within buff of the box, the
+    distance being measured normal to its faces, so triclinic boxes are handled. Each particle is classified by its
+    fractional coordinates, and only the shifts along the lattice vectors of the faces it is near are generated.
 */
 class VoronoiBuffer
     {
     public:
         //! Constructor
-        VoronoiBuffer(const box::Box& box):m_box(box){}
+        VoronoiBuffer(const box::Box& box)
+            : m_box(box), m_buff(0), m_buffer_particles(new std::vector<float3>())
+            {
+            }
 
         //! Get the simulation box
         const box::Box& getBox() const
@@ -32,15 +39,34 @@ class VoronoiBuffer
                 }
 
         //! Compute the particle images
+        void compute(const vec3<float> *points,
+                     const unsigned int Np,
+                     const float buff);
+
+        //! Compute the particle images (float3 interface)
         void compute(const float3 *points,
                      const unsigned int Np,
                      const float buff);
 
+        //! Get the images, as float3
         std::shared_ptr< std::vector<float3> > getBufferParticles()
             {
             return m_buffer_particles;
             }
 
+        //! Get the images, as vec3<float>, without a copy
+        const vec3<float> *getBufferPoints() const
+            {
+            return m_buffer_particles->empty() ? NULL
+                : reinterpret_cast<const vec3<float>*>(&(*m_buffer_particles)[0]);
+            }
+
+        //! Get the number of images
+        unsigned int getNumBufferParticles() const
+            {
+            return m_buffer_particles->size();
+            }
+
         // //!Python wrapper for compute
         // void computePy(boost::python::numeric::array points,
         //                const float buff);
@@ -0,0 +1,1066 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "VoronoiCells.h"
+#include "LinkCell.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace tbb;
+
+/*! \file VoronoiCells.cc
+    \brief Periodic Voronoi tessellation, computed cell by cell
+*/
+
+namespace freud { namespace voronoi {
+
+//! \internal
+//! Face of a convex cell: a planar polygon and the neighbor across it
+struct CellFace
+    {
+    std::vector< vec3<double> > vertices;   //!< Vertices, in order around the face
+    int neighbor;                           //!< Index of the neighbor, -1 for a face of the initial box
+    vec3<double> delta;                     //!< Vector from the particle to the image of the neighbor
+    };
+
+//! \internal
+//! Candidate neighbor of a cell
+struct CellCandidate
+    {
+    double rsq;                             //!< Squared distance
+    vec3<double> delta;                     //!< Vector from the particle to this image of the candidate
+    unsigned int j;                         //!< Index of the candidate
+    int image[3];                           //!< Image of the box of the candidate, along each lattice vector
+
+    bool operator<(const CellCandidate& other) const
+        {
+        return rsq < other.rsq;
+        }
+    };
+
+//! \internal
+//! Area vector of a planar polygon, normal to it with the length of its area
+static vec3<double> areaVector(const std::vector< vec3<double> >& vertices)
+    {
+    vec3<double> area(0, 0, 0);
+    for (unsigned int k = 0; k < vertices.size(); k++)
+        area += cross(vertices[k], vertices[(k + 1) % vertices.size()]);
+    return 0.5*area;
+    }
+
+//! \internal
+//! Convex cell of a particle at the origin, as a list of faces, cut down by bisecting planes
+/*! The vertices are stored once by each face they belong to. A cut clips every face against the plane and closes
+    the cell with a new face through the points where the edges crossed it; those points are interpolated from the
+    inside vertex of each edge, so the two faces of an edge find the very same point.
+*/
+class ConvexCell
+    {
+    public:
+        //! Constructor
+        ConvexCell()
+            : m_num_faces(0), m_sorted_valid(false)
+            {
+            }
+
+        //! Start from the box [-half.x, half.x] x [-half.y, half.y] x [-half.z, half.z]
+        void reset(const vec3<double>& half)
+            {
+            static const int corners[6][4][3] = {
+                {{1, -1, -1}, {1, 1, -1}, {1, 1, 1}, {1, -1, 1}},
+                {{-1, -1, -1}, {-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1}},
+                {{-1, 1, -1}, {-1, 1, 1}, {1, 1, 1}, {1, 1, -1}},
+                {{-1, -1, -1}, {1, -1, -1}, {1, -1, 1}, {-1, -1, 1}},
+                {{-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}},
+                {{-1, -1, -1}, {-1, 1, -1}, {1, 1, -1}, {1, -1, -1}}};
+            if (m_faces.size() < 6)
+                m_faces.resize(6);
+            m_num_faces = 6;
+            m_sorted_valid = false;
+            for (unsigned int f = 0; f < 6; f++)
+                {
+                m_faces[f].vertices.resize(4);
+                for (unsigned int k = 0; k < 4; k++)
+                    m_faces[f].vertices[k] = vec3<double>(corners[f][k][0]*half.x, corners[f][k][1]*half.y,
+                                                          corners[f][k][2]*half.z);
+                m_faces[f].neighbor = -1;
+                m_faces[f].delta = vec3<double>(0, 0, 0);
+                }
+            }
+
+        //! Get the number of faces
+        unsigned int getNumFaces() const
+            {
+            return m_num_faces;
+            }
+
+        //! Get face f
+        const CellFace& getFace(unsigned int f) const
+            {
+            return m_faces[f];
+            }
+
+        //! Largest squared distance from the particle to a vertex
+        double maxRadiusSq() const
+            {
+            double rsq = 0;
+            for (unsigned int f = 0; f < m_num_faces; f++)
+                for (unsigned int k = 0; k < m_faces[f].vertices.size(); k++)
+                    rsq = std::max(rsq, dot(m_faces[f].vertices[k], m_faces[f].vertices[k]));
+            return rsq;
+            }
+
+        //! Test whether the bisecting plane of the particle and delta would cut the cell, without cutting it
+        /*! The vertices are kept by decreasing distance from the particle between cuts, so that only those farther
+            than the plane could be are tested; this is much faster than cut() for the many planes that miss a cell
+            that is nearly done.
+        */
+        bool isCutBy(const vec3<double>& delta)
+            {
+            if (!m_sorted_valid)
+                {
+                m_sorted.resize(0);
+                for (unsigned int f = 0; f < m_num_faces; f++)
+                    for (unsigned int k = 0; k < m_faces[f].vertices.size(); k++)
+                        m_sorted.push_back(std::make_pair(dot(m_faces[f].vertices[k], m_faces[f].vertices[k]),
+                                                          m_faces[f].vertices[k]));
+                std::sort(m_sorted.begin(), m_sorted.end(), [] (const std::pair<double, vec3<double> >& a,
+                                                                 const std::pair<double, vec3<double> >& b)
+                    {
+                    return a.first > b.first;
+                    });
+                m_sorted_valid = true;
+                }
+            // a vertex is beyond the plane only if it is farther than half of delta
+            const double d = 0.5*dot(delta, delta);
+            const double eps = 1e-12*d;
+            for (unsigned int k = 0; k < m_sorted.size() && 2.0*m_sorted[k].first > d; k++)
+                if (dot(delta, m_sorted[k].second) - d > eps)
+                    return true;
+            return false;
+            }
+
+        //! Keep the side of the bisecting plane of the particle and delta closest to the particle
+        /*! \returns true if the plane cut the cell
+        */
+        bool cut(const vec3<double>& delta, int neighbor)
+            {
+            // the points x of the plane have dot(delta, x) = d
+            const double d = 0.5*dot(delta, delta);
+            const double eps = 1e-12*d;
+            bool outside = false;
+            for (unsigned int f = 0; f < m_num_faces && !outside; f++)
+                for (unsigned int k = 0; k < m_faces[f].vertices.size() && !outside; k++)
+                    outside = dot(delta, m_faces[f].vertices[k]) - d > eps;
+            if (!outside)
+                return false;
+
+            // the faces are clipped into the storage of the previous cut, which is reused along with the vertex arrays
+            unsigned int num_clipped = 0;
+            m_cap.resize(0);
+            for (unsigned int f = 0; f < m_num_faces; f++)
+                {
+                const std::vector< vec3<double> >& vertices = m_faces[f].vertices;
+                m_polygon.resize(0);
+                for (unsigned int k = 0; k < vertices.size(); k++)
+                    {
+                    const vec3<double>& a = vertices[k];
+                    const vec3<double>& b = vertices[(k + 1) % vertices.size()];
+                    const double s_a = dot(delta, a) - d;
+                    const double s_b = dot(delta, b) - d;
+                    if (s_a <= eps)
+                        m_polygon.push_back(a);
+                    if ((s_a <= eps) != (s_b <= eps))
+                        {
+                        const bool a_inside = s_a <= eps;
+                        const vec3<double>& in = a_inside ? a : b;
+                        const vec3<double>& out = a_inside ? b : a;
+                        const double s_in = a_inside ? s_a : s_b;
+                        const double s_out = a_inside ? s_b : s_a;
+                        const vec3<double> p = in + (s_in/(s_in - s_out))*(out - in);
+                        m_polygon.push_back(p);
+                        m_cap.push_back(p);
+                        }
+                    }
+                if (m_polygon.size() >= 3)
+                    addClipped(num_clipped++, m_faces[f].neighbor, m_faces[f].delta);
+                }
+
+            // the new face, through the crossing points sorted by angle around their center
+            if (m_cap.size() >= 3)
+                {
+                vec3<double> center(0, 0, 0);
+                for (unsigned int k = 0; k < m_cap.size(); k++)
+                    center += m_cap[k];
+                center /= double(m_cap.size());
+                const double ax = fabs(delta.x), ay = fabs(delta.y), az = fabs(delta.z);
+                const vec3<double> axis = (ax <= ay && ax <= az) ? vec3<double>(1, 0, 0) :
+                    ((ay <= az) ? vec3<double>(0, 1, 0) : vec3<double>(0, 0, 1));
+                vec3<double> u = cross(delta, axis);
+                u /= sqrt(dot(u, u));
+                vec3<double> w = cross(delta, u);
+                w /= sqrt(dot(w, w));
+                m_angles.resize(m_cap.size());
+                for (unsigned int k = 0; k < m_cap.size(); k++)
+                    {
+                    const vec3<double> r = m_cap[k] - center;
+                    m_angles[k] = std::make_pair(atan2(dot(r, w), dot(r, u)), k);
+                    }
+                std::sort(m_angles.begin(), m_angles.end());
+
+                // each crossing point is found by the two faces of its edge
+                const double tolsq = 1e-20*d;
+                m_polygon.resize(0);
+                for (unsigned int k = 0; k < m_angles.size(); k++)
+                    {
+                    const vec3<double>& p = m_cap[m_angles[k].second];
+                    if (m_polygon.size() && dot(p - m_polygon.back(), p - m_polygon.back()) <= tolsq)
+                        continue;
+                    m_polygon.push_back(p);
+                    }
+                if (m_polygon.size() > 1 && dot(m_polygon.front() - m_polygon.back(),
+                                                m_polygon.front() - m_polygon.back()) <= tolsq)
+                    m_polygon.pop_back();
+                if (m_polygon.size() >= 3)
+                    addClipped(num_clipped++, neighbor, delta);
+                }
+            m_faces.swap(m_clipped);
+            m_num_faces = num_clipped;
+            m_sorted_valid = false;
+            return true;
+            }
+
+    private:
+        //! Store m_polygon as clipped face f, swapping the vertex arrays so that none is allocated
+        void addClipped(unsigned int f, int neighbor, const vec3<double>& delta)
+            {
+            if (m_clipped.size() <= f)
+                m_clipped.resize(f + 1);
+            m_clipped[f].vertices.swap(m_polygon);
+            m_clipped[f].neighbor = neighbor;
+            m_clipped[f].delta = delta;
+            }
+
+
+        std::vector<CellFace> m_faces;                          //!< Faces of the cell, the first m_num_faces in use
+        unsigned int m_num_faces;                               //!< Number of faces of the cell
+        std::vector<CellFace> m_clipped;                        //!< Faces of the cell being cut
+        std::vector< vec3<double> > m_polygon;                  //!< Polygon being clipped
+        std::vector< vec3<double> > m_cap;                      //!< Crossing points of the cut
+        std::vector< std::pair<double, unsigned int> > m_angles;    //!< Angle of each crossing point
+        std::vector< std::pair<double, vec3<double> > > m_sorted;   //!< Squared distance and position of each vertex
+        bool m_sorted_valid;                                    //!< True if m_sorted holds the vertices of the cell
+    };
+
+//! \internal
+//! Faces of the cell of one particle
+struct CellResult
+    {
+    std::vector<unsigned int> neighbors;    //!< Neighbor across each face
+    std::vector< vec3<float> > deltas;      //!< Vector to the image of the neighbor across each face
+    std::vector<float> areas;               //!< Area of each face
+    float radius;                           //!< Largest distance from the particle to a vertex
+    std::vector<unsigned int> candidates;   //!< Particles that may become neighbors, with a skin
+    std::vector<char3> images;              //!< Image of the box of each candidate
+    unsigned int num_face_candidates;       //!< Number of leading candidates that were neighbors across a face
+    std::vector<uchar3> vertex_planes;      //!< Three faces through each vertex, by slot
+    std::vector<unsigned char> face_slots;  //!< Slot of each face
+    std::vector<unsigned short> face_sizes;     //!< Number of vertices of each face
+    std::vector<unsigned short> face_vertices;  //!< Vertices of each face, in order around it
+    };
+
+//! \internal
+//! Surface area of each cell, the sum of the areas of its faces, in parallel
+static std::shared_ptr<float> surfaceAreas(const std::vector<CellResult>& results)
+    {
+    std::shared_ptr<float> surface_areas = std::shared_ptr<float>(new float[results.size()],
+                                                                  std::default_delete<float[]>());
+    float *surface_areas_ptr = surface_areas.get();
+    const CellResult *results_ptr = &results[0];
+    parallel_for(blocked_range<size_t>(0, results.size()),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            double area = 0;
+            for (unsigned int k = 0; k < results_ptr[i].areas.size(); k++)
+                area += results_ptr[i].areas[k];
+            surface_areas_ptr[i] = area;
+            }
+        });
+    return surface_areas;
+    }
+
+//! \internal
+//! Slots of the faces of a cell: the leading candidates, then the faces of the initial box in z of a 2D cell
+static const unsigned int max_face_slots = 254;
+static const unsigned char slot_bottom = 254;
+static const unsigned char slot_top = 255;
+
+//! \internal
+//! Plane dot(normal, x) = offset of the face of slot s, given the vectors to the leading candidates
+static inline void slotPlane(unsigned char s, const vec3<double> *deltas, double half_z,
+                             vec3<double>& normal, double& offset)
+    {
+    if (s == slot_bottom || s == slot_top)
+        {
+        normal = vec3<double>(0, 0, (s == slot_top) ? 1.0 : -1.0);
+        offset = half_z;
+        return;
+        }
+    normal = deltas[s];
+    offset = 0.5*dot(deltas[s], deltas[s]);
+    }
+
+//! \internal
+//! Store in result the faces of cell and the faces through each vertex, by their slot among the candidates
+/*! The faces of an edge share the very same vertices, which identifies them. Returns false, leaving no topology,
+    for a degenerate cell or one with a face beyond the first max_face_slots candidates; such a cell is cut again
+    from its candidates on updates.
+*/
+static bool storeTopology(const ConvexCell& cell, const unsigned int *candidates, const vec3<double> *deltas,
+                          unsigned int num_candidates, bool is2D, double half_z, CellResult& result)
+    {
+    result.vertex_planes.resize(0);
+    result.face_slots.resize(0);
+    result.face_sizes.resize(0);
+    result.face_vertices.resize(0);
+    const unsigned int num_slots = std::min(num_candidates, max_face_slots);
+
+    // the slot of each face
+    std::vector<unsigned char> slots(cell.getNumFaces());
+    for (unsigned int f = 0; f < cell.getNumFaces(); f++)
+        {
+        const CellFace& face = cell.getFace(f);
+        if (face.neighbor < 0)
+            {
+            if (!is2D)
+                return false;
+            slots[f] = (face.vertices[0].z > 0) ? slot_top : slot_bottom;
+            continue;
+            }
+        unsigned int k = 0;
+        while (k < num_slots && (candidates[k] != (unsigned int) face.neighbor || !(deltas[k] == face.delta)))
+            k++;
+        if (k == num_slots)
+            return false;
+        slots[f] = k;
+        }
+
+    // the distinct vertices, in order of position, and the faces through each
+    std::vector< std::pair<unsigned int, unsigned int> > corners;
+    for (unsigned int f = 0; f < cell.getNumFaces(); f++)
+        for (unsigned int k = 0; k < cell.getFace(f).vertices.size(); k++)
+            corners.push_back(std::make_pair(f, k));
+    const auto position = [&cell] (const std::pair<unsigned int, unsigned int>& corner) -> const vec3<double>&
+        {
+        return cell.getFace(corner.first).vertices[corner.second];
+        };
+    std::sort(corners.begin(), corners.end(), [&position] (const std::pair<unsigned int, unsigned int>& a,
+                                                           const std::pair<unsigned int, unsigned int>& b)
+        {
+        const vec3<double>& u = position(a);
+        const vec3<double>& v = position(b);
+        return (u.x != v.x) ? u.x < v.x : ((u.y != v.y) ? u.y < v.y : u.z < v.z);
+        });
+    std::vector< std::vector<unsigned short> > face_vertices(cell.getNumFaces());
+    for (unsigned int f = 0; f < cell.getNumFaces(); f++)
+        face_vertices[f].resize(cell.getFace(f).vertices.size());
+    std::vector<unsigned char> through;
+    for (unsigned int begin = 0, end = 0; begin < corners.size(); begin = end)
+        {
+        through.resize(0);
+        for (end = begin; end < corners.size() && position(corners[end]) == position(corners[begin]); end++)
+            {
+            face_vertices[corners[end].first][corners[end].second] = result.vertex_planes.size();
+            if (std::find(through.begin(), through.end(), slots[corners[end].first]) == through.end())
+                through.push_back(slots[corners[end].first]);
+            }
+        if (through.size() < 3 || result.vertex_planes.size() >= USHRT_MAX)
+            return false;
+
+        // of the faces through a degenerate vertex, the three with the most independent planes locate it
+        double best = 0;
+        uchar3 planes = make_uchar3(0, 0, 0);
+        for (unsigned int a = 0; a < through.size(); a++)
+            for (unsigned int b = a + 1; b < through.size(); b++)
+                for (unsigned int c = b + 1; c < through.size(); c++)
+                    {
+                    vec3<double> n[3];
+                    double offset;
+                    slotPlane(through[a], deltas, half_z, n[0], offset);
+                    slotPlane(through[b], deltas, half_z, n[1], offset);
+                    slotPlane(through[c], deltas, half_z, n[2], offset);
+                    const double det = fabs(dot(n[0], cross(n[1], n[2])))/
+                                       sqrt(dot(n[0], n[0])*dot(n[1], n[1])*dot(n[2], n[2]));
+                    if (det > best)
+                        {
+                        best = det;
+                        planes = make_uchar3(through[a], through[b], through[c]);
+                        }
+                    }
+        if (best < 1e-6)
+            return false;
+        result.vertex_planes.push_back(planes);
+        }
+
+    for (unsigned int f = 0; f < cell.getNumFaces(); f++)
+        {
+        result.face_slots.push_back(slots[f]);
+        result.face_sizes.push_back(face_vertices[f].size());
+        result.face_vertices.insert(result.face_vertices.end(), face_vertices[f].begin(), face_vertices[f].end());
+        }
+    return true;
+    }
+
+//! \internal
+//! Store the faces of cell, and return its volume
+static double storeCell(const ConvexCell& cell, CellResult& result)
+    {
+    // the volume is the sum of the pyramids from the particle to each face
+    double volume = 0;
+    for (unsigned int f = 0; f < cell.getNumFaces(); f++)
+        {
+        const CellFace& face = cell.getFace(f);
+        const vec3<double> area = areaVector(face.vertices);
+        volume += fabs(dot(area, face.vertices[0]))/3.0;
+        if (face.neighbor < 0)
+            continue;
+        result.neighbors.push_back((unsigned int) face.neighbor);
+        result.deltas.push_back(vec3<float>(face.delta.x, face.delta.y, face.delta.z));
+        result.areas.push_back(sqrt(dot(area, area)));
+        }
+    result.radius = sqrt(cell.maxRadiusSq());
+    return volume;
+    }
+
+//! \internal
+//! Move the vertices of a cell onto the planes of their faces at new positions of the leading candidates
+/*! \returns false if a vertex got beyond the plane of another face, which means the faces of the cell changed
+*/
+static bool moveVertices(const uchar3 *vertex_planes, unsigned int num_vertices, const unsigned char *face_slots,
+                         unsigned int num_faces, const vec3<double> *deltas, double half_z,
+                         std::vector< vec3<double> >& vertices)
+    {
+    vertices.resize(num_vertices);
+    for (unsigned int v = 0; v < num_vertices; v++)
+        {
+        vec3<double> n[3];
+        double c[3];
+        slotPlane(vertex_planes[v].x, deltas, half_z, n[0], c[0]);
+        slotPlane(vertex_planes[v].y, deltas, half_z, n[1], c[1]);
+        slotPlane(vertex_planes[v].z, deltas, half_z, n[2], c[2]);
+        const vec3<double> n12 = cross(n[1], n[2]);
+        const double det = dot(n[0], n12);
+        if (!(fabs(det) > 1e-9*sqrt(dot(n[0], n[0])*dot(n[1], n[1])*dot(n[2], n[2]))))
+            return false;
+        vertices[v] = (c[0]*n12 + c[1]*cross(n[2], n[0]) + c[2]*cross(n[0], n[1]))/det;
+        }
+    for (unsigned int f = 0; f < num_faces; f++)
+        {
+        vec3<double> normal;
+        double offset;
+        slotPlane(face_slots[f], deltas, half_z, normal, offset);
+        const double tolerance = 1e-9*offset;
+        for (unsigned int v = 0; v < num_vertices; v++)
+            if (dot(normal, vertices[v]) - offset > tolerance)
+                return false;
+        }
+    return true;
+    }
+
+//! \internal
+//! Integer division rounding towards minus infinity
+static int floorDiv(int a, int b)
+    {
+    return (a >= 0) ? a/b : -((-a + b - 1)/b);
+    }
+
+//! \internal
+//! Fill nlist with the bonds of each particle in results, and return the areas of the faces if there are any
+static std::shared_ptr<float> fillNlist(locality::NeighborList& nlist, const std::vector<CellResult>& results,
+                                        bool with_areas)
+    {
+    const unsigned int Np = results.size();
+    std::shared_ptr<size_t> segments = std::shared_ptr<size_t>(new size_t[Np + 1], std::default_delete<size_t[]>());
+    size_t num_bonds = 0;
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        segments.get()[i] = num_bonds;
+        num_bonds += results[i].neighbors.size();
+        }
+    segments.get()[Np] = num_bonds;
+
+    nlist.resize(num_bonds, Np, Np, true);
+    memcpy((void*)nlist.getSegments().get(), (void*)segments.get(), sizeof(size_t)*(Np + 1));
+    std::shared_ptr<float> areas;
+    if (with_areas)
+        areas = std::shared_ptr<float>(new float[num_bonds], std::default_delete<float[]>());
+
+    unsigned int *index_i = nlist.getIndexI().get();
+    unsigned int *index_j = nlist.getIndexJ().get();
+    float *distances = nlist.getDistances().get();
+    vec3<float> *vectors = nlist.getVectors().get();
+    float *face_areas = areas.get();
+    const size_t *segments_ptr = segments.get();
+    const CellResult *results_ptr = &results[0];
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            const CellResult& result = results_ptr[i];
+            size_t bond = segments_ptr[i];
+            for (unsigned int k = 0; k < result.neighbors.size(); k++, bond++)
+                {
+                index_i[bond] = i;
+                index_j[bond] = result.neighbors[k];
+                distances[bond] = sqrtf(dot(result.deltas[k], result.deltas[k]));
+                vectors[bond] = result.deltas[k];
+                if (face_areas != NULL)
+                    face_areas[bond] = result.areas[k];
+                }
+            }
+        });
+    return areas;
+    }
+
+//! \internal
+//! Half extents of a box around a particle that holds its cell, which is within the planes bisecting the particle
+//! and its own images
+static vec3<double> initialHalf(const box::Box& box)
+    {
+    double extent = 0;
+    for (unsigned int k = 0; k < (box.is2D() ? 2 : 3); k++)
+        {
+        const vec3<float> a = box.getLatticeVector(k);
+        extent += sqrt(double(dot(a, a)));
+        }
+    return vec3<double>(extent, extent, box.is2D() ? 0.5 : extent);
+    }
+
+//! \internal
+//! Width of the cells of the cell list: a few particles per cell, with at least two cells across the box
+static float cellWidth(const box::Box& box, unsigned int Np)
+    {
+    const vec3<float> L = box.getNearestPlaneDistance();
+    float Lmin = std::min(L.x, L.y);
+    if (!box.is2D())
+        Lmin = std::min(Lmin, L.z);
+    const float cell_width = box.is2D() ? sqrtf(3.0f*box.getVolume()/Np) : cbrtf(3.0f*box.getVolume()/Np);
+    return std::min(cell_width, 0.5f*Lmin);
+    }
+
+//! \internal
+//! Candidate neighbors of the particles, from a cell list visited in shells that step into the periodic images
+class CellSearch
+    {
+    public:
+        //! Build the cell list of the points
+        CellSearch(const box::Box& box, const vec3<float> *points, unsigned int Np)
+            : m_box(box), m_is2D(box.is2D()), m_lc(box, cellWidth(box, Np)), m_coords(Np), m_positions(Np)
+            {
+            std::vector< vec3<float> > wrapped(Np);
+            for (unsigned int i = 0; i < Np; i++)
+                wrapped[i] = m_box.wrap(points[i]);
+            m_lc.computeCellList(m_box, &wrapped[0], Np);
+
+            const Index3D& cell_index = m_lc.getCellIndexer();
+            m_n_cells[0] = cell_index.getW();
+            m_n_cells[1] = cell_index.getH();
+            m_n_cells[2] = cell_index.getD();
+            for (unsigned int k = 0; k < 3; k++)
+                {
+                vec3<float> a = (k < 2 || !m_is2D) ? m_box.getLatticeVector(k) : vec3<float>(0, 0, 0);
+                m_lattice[k] = vec3<double>(a.x, a.y, a.z);
+                }
+            // every point of a cell s shells away from the cell of a particle is at least (s - 1) w_min from it
+            const vec3<float> L = m_box.getNearestPlaneDistance();
+            m_w_min = std::min(L.x/m_n_cells[0], L.y/m_n_cells[1]);
+            if (!m_is2D)
+                m_w_min = std::min(m_w_min, double(L.z/m_n_cells[2]));
+
+            // the cell of each point, and its position in the image of the box that cell belongs to: a point
+            // rounded up to a fraction of 1 of the box is in the first cell
+            for (unsigned int i = 0; i < Np; i++)
+                {
+                m_coords[i] = m_lc.getCellCoord(wrapped[i]);
+                const vec3<float> alpha = m_box.makeFraction(wrapped[i]);
+                m_positions[i] = vec3<double>(wrapped[i].x, wrapped[i].y, wrapped[i].z);
+                if (int(floorf(alpha.x*float(m_n_cells[0]))) >= m_n_cells[0])
+                    m_positions[i] -= m_lattice[0];
+                if (int(floorf(alpha.y*float(m_n_cells[1]))) >= m_n_cells[1])
+                    m_positions[i] -= m_lattice[1];
+                if (!m_is2D && int(floorf(alpha.z*float(m_n_cells[2]))) >= m_n_cells[2])
+                    m_positions[i] -= m_lattice[2];
+                }
+            }
+
+        //! Get the positions of the particles, each in the image of the box its cell belongs to
+        const std::vector< vec3<double> >& getPositions() const
+            {
+            return m_positions;
+            }
+
+        //! Cut cell, which should be reset, down to the cell of particle i
+        void build(unsigned int i, ConvexCell& cell, std::vector<CellCandidate>& candidates) const
+            {
+            double rmaxsq = cell.maxRadiusSq();
+            for (int s = 0; ; s++)
+                {
+                // no particle of this shell or beyond is close enough to cut the cell
+                if (s > 1 && (s - 1)*m_w_min*(s - 1)*m_w_min > 4.0*rmaxsq)
+                    break;
+
+                candidates.resize(0);
+                visitShell(i, s, 4.0*rmaxsq, candidates);
+
+                // the nearest candidates cut the most, which leaves fewer vertices to test the others against
+                std::sort(candidates.begin(), candidates.end());
+                for (unsigned int k = 0; k < candidates.size(); k++)
+                    if (candidates[k].rsq < 4.0*rmaxsq && cell.cut(candidates[k].delta, int(candidates[k].j)))
+                        rmaxsq = cell.maxRadiusSq();
+                }
+            }
+
+        //! Find the images of the particles closer than sqrt(rmaxsq) to particle i, nearest first
+        void gather(unsigned int i, double rmaxsq, std::vector<CellCandidate>& candidates) const
+            {
+            candidates.resize(0);
+            for (int s = 0; s <= 1 || (s - 1)*m_w_min*(s - 1)*m_w_min <= rmaxsq; s++)
+                visitShell(i, s, rmaxsq, candidates);
+            std::sort(candidates.begin(), candidates.end());
+            }
+
+    private:
+        //! Add the images of the particles of the cells s shells away from the cell of i, if closer than sqrt(rmaxsq)
+        void visitShell(unsigned int i, int s, double rmaxsq, std::vector<CellCandidate>& candidates) const
+            {
+            const vec3<unsigned int> c = m_coords[i];
+            const vec3<double> p_i = m_positions[i];
+            const int s_z = m_is2D ? 0 : s;
+            for (int dz = -s_z; dz <= s_z; dz++)
+                for (int dy = -s; dy <= s; dy++)
+                    for (int dx = -s; dx <= s; dx++)
+                        {
+                        if (std::max(std::abs(dx), std::max(std::abs(dy), std::abs(dz))) != s)
+                            continue;
+                        // the cell at this offset, in the image of the box it falls in
+                        const int offset[3] = {int(c.x) + dx, int(c.y) + dy, int(c.z) + dz};
+                        int image[3], wrapped_cell[3];
+                        for (unsigned int k = 0; k < 3; k++)
+                            {
+                            image[k] = floorDiv(offset[k], m_n_cells[k]);
+                            wrapped_cell[k] = offset[k] - image[k]*m_n_cells[k];
+                            }
+                        const vec3<double> shift = double(image[0])*m_lattice[0] + double(image[1])*m_lattice[1] +
+                                                   double(image[2])*m_lattice[2];
+                        const bool home = !image[0] && !image[1] && !image[2];
+                        locality::LinkCell::iteratorcell it = m_lc.itercell(
+                            m_lc.getCellIndex(wrapped_cell[0], wrapped_cell[1], wrapped_cell[2]));
+                        for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
+                            {
+                            if (j == i && home)
+                                continue;
+                            CellCandidate candidate;
+                            candidate.delta = m_positions[j] + shift - p_i;
+                            candidate.rsq = dot(candidate.delta, candidate.delta);
+                            if (candidate.rsq >= rmaxsq)
+                                continue;
+                            candidate.j = j;
+                            for (unsigned int k = 0; k < 3; k++)
+                                candidate.image[k] = image[k];
+                            candidates.push_back(candidate);
+                            }
+                        }
+            }
+
+        box::Box m_box;                                 //!< Simulation box
+        bool m_is2D;                                    //!< True for a 2D box
+        locality::LinkCell m_lc;                        //!< Cell list of the points
+        int m_n_cells[3];                               //!< Number of cells along each lattice vector
+        vec3<double> m_lattice[3];                      //!< Lattice vectors, the third zero in 2D
+        double m_w_min;                                 //!< Smallest width of a cell
+        std::vector< vec3<unsigned int> > m_coords;     //!< Cell of each point
+        std::vector< vec3<double> > m_positions;        //!< Position of each point
+    };
+
+//! \internal
+//! Concatenate one array of each result into values, with the first value of each result in segments
+template<typename T>
+static void concatenate(const std::vector<CellResult>& results, std::vector<T> CellResult::*member,
+                        std::vector<size_t>& segments, std::vector<T>& values)
+    {
+    segments.resize(results.size() ? results.size() + 1 : 0);
+    size_t num_values = 0;
+    for (unsigned int i = 0; i < results.size(); i++)
+        {
+        segments[i] = num_values;
+        num_values += (results[i].*member).size();
+        }
+    if (results.size())
+        segments[results.size()] = num_values;
+    values.resize(num_values);
+    for (unsigned int i = 0; i < results.size(); i++)
+        std::copy((results[i].*member).begin(), (results[i].*member).end(), values.begin() + segments[i]);
+    }
+
+VoronoiCells::VoronoiCells(float skin)
+    : m_box(box::Box()), m_Np(0), m_skin(skin), m_num_recomputed(0)
+    {
+    if (skin < 0)
+        throw invalid_argument("VoronoiCells needs a positive skin");
+    }
+
+void VoronoiCells::compute(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    if (Np == 0)
+        throw invalid_argument("VoronoiCells needs at least one point");
+    m_box = box;
+    const CellSearch search(m_box, points, Np);
+    const CellSearch *search_ptr = &search;
+    const vec3<double> half = initialHalf(m_box);
+    const bool is2D = m_box.is2D();
+    const double skin = m_skin;
+
+    std::vector<CellResult> results(Np);
+    CellResult *results_ptr = &results[0];
+    m_volumes = std::shared_ptr<float>(new float[Np], std::default_delete<float[]>());
+    float *volumes = m_volumes.get();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        ConvexCell cell;
+        std::vector<CellCandidate> candidates;
+        std::vector< vec3<double> > deltas;
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            cell.reset(half);
+            search_ptr->build(i, cell, candidates);
+            CellResult& result = results_ptr[i];
+            volumes[i] = storeCell(cell, result);
+            if (skin == 0)
+                continue;
+
+            // every particle that can cut the cell until the particles have moved by more than the skin
+            const double rmax = 2.0*(result.radius + skin);
+            search_ptr->gather(i, rmax*rmax, candidates);
+            // the neighbors across the faces go first, so the cell is nearly done before the others are tested
+            result.num_face_candidates = std::stable_partition(candidates.begin(), candidates.end(),
+                [&result] (const CellCandidate& candidate)
+                {
+                const vec3<float> delta(candidate.delta.x, candidate.delta.y, candidate.delta.z);
+                for (unsigned int k = 0; k < result.neighbors.size(); k++)
+                    if (result.neighbors[k] == candidate.j && result.deltas[k] == delta)
+                        return true;
+                return false;
+                }) - candidates.begin();
+            result.candidates.resize(candidates.size());
+            result.images.resize(candidates.size());
+            deltas.resize(candidates.size());
+            for (unsigned int k = 0; k < candidates.size(); k++)
+                {
+                if (std::abs(candidates[k].image[0]) > 127 || std::abs(candidates[k].image[1]) > 127 ||
+                    std::abs(candidates[k].image[2]) > 127)
+                    throw runtime_error("VoronoiCells skin spans too many images of the box");
+                result.candidates[k] = candidates[k].j;
+                result.images[k] = make_char3(candidates[k].image[0], candidates[k].image[1],
+                                              candidates[k].image[2]);
+                deltas[k] = candidates[k].delta;
+                }
+            if (candidates.size())
+                storeTopology(cell, &result.candidates[0], &deltas[0], candidates.size(), is2D, half.z, result);
+            }
+        });
+
+    // one bond per face, in the order of the faces of each cell
+    m_face_areas = fillNlist(m_nlist, results, true);
+    m_nlist.setWeights(m_face_areas.get());
+    m_surface_areas = surfaceAreas(results);
+    m_Np = Np;
+    m_num_recomputed = Np;
+
+    // the references of the next updates
+    m_ref_points.resize(0);
+    m_ref_positions.resize(0);
+    m_radii.resize(0);
+    m_num_face_candidates.resize(0);
+    if (m_skin == 0)
+        results.resize(0);
+    else
+        {
+        m_ref_points.assign(points, points + Np);
+        m_ref_positions = search.getPositions();
+        m_radii.resize(Np);
+        m_num_face_candidates.resize(Np);
+        for (unsigned int i = 0; i < Np; i++)
+            {
+            m_radii[i] = results[i].radius;
+            m_num_face_candidates[i] = results[i].num_face_candidates;
+            }
+        }
+    concatenate(results, &CellResult::candidates, m_candidate_segments, m_candidates);
+    concatenate(results, &CellResult::images, m_candidate_segments, m_candidate_images);
+    concatenate(results, &CellResult::vertex_planes, m_vertex_segments, m_vertex_planes);
+    concatenate(results, &CellResult::face_slots, m_face_segments, m_face_slots);
+    concatenate(results, &CellResult::face_sizes, m_face_segments, m_face_sizes);
+    concatenate(results, &CellResult::face_vertices, m_face_vertex_segments, m_face_vertices);
+    }
+
+void VoronoiCells::update(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    if (m_skin == 0 || Np != m_Np || box != m_box)
+        {
+        compute(box, points, Np);
+        return;
+        }
+
+    // the displacement of each particle since the last compute
+    std::vector< vec3<double> > displacements(Np);
+    double max_displacement = 0;
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        const vec3<float> d = m_box.wrap(points[i] - m_ref_points[i]);
+        displacements[i] = vec3<double>(d.x, d.y, d.z);
+        max_displacement = std::max(max_displacement, sqrt(dot(displacements[i], displacements[i])));
+        }
+    // past half the skin most cells would be searched again anyway
+    if (max_displacement > 0.5*m_skin)
+        {
+        compute(box, points, Np);
+        return;
+        }
+
+    vec3<double> lattice[3];
+    for (unsigned int k = 0; k < 3; k++)
+        {
+        vec3<float> a = (k < 2 || !m_box.is2D()) ? m_box.getLatticeVector(k) : vec3<float>(0, 0, 0);
+        lattice[k] = vec3<double>(a.x, a.y, a.z);
+        }
+    const vec3<double> half = initialHalf(m_box);
+    const bool is2D = m_box.is2D();
+    const double skin = m_skin;
+    const vec3<double> *positions = &m_ref_positions[0];
+    const vec3<double> *displacements_ptr = &displacements[0];
+    const float *radii = &m_radii[0];
+    const unsigned int *num_face_candidates = &m_num_face_candidates[0];
+    const size_t *segments = &m_candidate_segments[0];
+    const unsigned int *candidates = m_candidates.size() ? &m_candidates[0] : NULL;
+    const char3 *images = m_candidate_images.size() ? &m_candidate_images[0] : NULL;
+    const size_t *vertex_segments = &m_vertex_segments[0];
+    const uchar3 *vertex_planes = m_vertex_planes.size() ? &m_vertex_planes[0] : NULL;
+    const size_t *face_segments = &m_face_segments[0];
+    const unsigned char *face_slots = m_face_slots.size() ? &m_face_slots[0] : NULL;
+    const unsigned short *face_sizes = m_face_sizes.size() ? &m_face_sizes[0] : NULL;
+    const size_t *face_vertex_segments = &m_face_vertex_segments[0];
+    const unsigned short *face_vertices = m_face_vertices.size() ? &m_face_vertices[0] : NULL;
+
+    // each cell keeps its faces if its vertices, moved onto the planes of those faces, are still within all of them
+    // and beyond the planes of the other candidates; otherwise it is cut by its old neighbors at their new
+    // positions, then by the few other candidates that still reach it, and its new faces are kept for the next
+    // update. Every particle closer than twice the radius of the cell is among the candidates as long as that
+    // radius grew by less than the skin minus the displacements.
+    std::vector<CellResult> results(Np);
+    CellResult *results_ptr = &results[0];
+    std::vector<char> valid(Np);
+    char *valid_ptr = &valid[0];
+    m_volumes = std::shared_ptr<float>(new float[Np], std::default_delete<float[]>());
+    float *volumes = m_volumes.get();
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        ConvexCell cell;
+        std::vector< vec3<double> > deltas, vertices, polygon;
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            CellResult& result = results_ptr[i];
+            const vec3<double> p_i = positions[i] + displacements_ptr[i];
+            const unsigned int num_candidates = segments[i + 1] - segments[i];
+            const unsigned int *cell_candidates = candidates + segments[i];
+            deltas.resize(num_candidates);
+            for (unsigned int k = 0; k < num_candidates; k++)
+                {
+                const unsigned int j = cell_candidates[k];
+                const char3 image = images[segments[i] + k];
+                deltas[k] = positions[j] + displacements_ptr[j] + double(image.x)*lattice[0] +
+                            double(image.y)*lattice[1] + double(image.z)*lattice[2] - p_i;
+                }
+
+            const unsigned int num_vertices = vertex_segments[i + 1] - vertex_segments[i];
+            const unsigned int num_faces = face_segments[i + 1] - face_segments[i];
+            if (num_vertices && moveVertices(vertex_planes + vertex_segments[i], num_vertices,
+                                             face_slots + face_segments[i], num_faces, &deltas[0], half.z, vertices))
+                {
+                double rmaxsq = 0;
+                for (unsigned int v = 0; v < num_vertices; v++)
+                    rmaxsq = std::max(rmaxsq, dot(vertices[v], vertices[v]));
+                // the vertices of a face are on the plane of its candidate, and within the tolerance
+                bool cut = false;
+                for (unsigned int k = 0; k < num_candidates && !cut; k++)
+                    {
+                    const double d = 0.5*dot(deltas[k], deltas[k]);
+                    if (2.0*d >= 4.0*rmaxsq)
+                        continue;
+                    for (unsigned int v = 0; v < num_vertices && !cut; v++)
+                        cut = dot(deltas[k], vertices[v]) - d > 1e-9*d;
+                    }
+                if (!cut)
+                    {
+                    valid_ptr[i] = sqrt(rmaxsq) + max_displacement <= radii[i] + skin;
+                    if (!valid_ptr[i])
+                        continue;
+                    double volume = 0;
+                    const unsigned short *face_vertex = face_vertices + face_vertex_segments[i];
+                    for (unsigned int f = 0; f < num_faces; f++)
+                        {
+                        const unsigned int size = face_sizes[face_segments[i] + f];
+                        polygon.resize(size);
+                        for (unsigned int k = 0; k < size; k++)
+                            polygon[k] = vertices[face_vertex[k]];
+                        face_vertex += size;
+                        const vec3<double> area = areaVector(polygon);
+                        volume += fabs(dot(area, polygon[0]))/3.0;
+                        const unsigned char slot = face_slots[face_segments[i] + f];
+                        if (slot >= max_face_slots)
+                            continue;
+                        result.neighbors.push_back(cell_candidates[slot]);
+                        result.deltas.push_back(vec3<float>(deltas[slot].x, deltas[slot].y, deltas[slot].z));
+                        result.areas.push_back(sqrt(dot(area, area)));
+                        }
+                    result.radius = sqrt(rmaxsq);
+                    volumes[i] = volume;
+
+                    // the faces are still those of the last update
+                    result.vertex_planes.assign(vertex_planes + vertex_segments[i],
+                                                vertex_planes + vertex_segments[i + 1]);
+                    result.face_slots.assign(face_slots + face_segments[i], face_slots + face_segments[i + 1]);
+                    result.face_sizes.assign(face_sizes + face_segments[i], face_sizes + face_segments[i + 1]);
+                    result.face_vertices.assign(face_vertices + face_vertex_segments[i],
+                                                face_vertices + face_vertex_segments[i + 1]);
+                    continue;
+                    }
+                }
+
+            cell.reset(half);
+            double rmaxsq = 0;
+            for (unsigned int k = 0; k < num_candidates; k++)
+                {
+                if (k < num_face_candidates[i])
+                    {
+                    cell.cut(deltas[k], int(cell_candidates[k]));
+                    continue;
+                    }
+                if (k == num_face_candidates[i])
+                    rmaxsq = cell.maxRadiusSq();
+                if (dot(deltas[k], deltas[k]) < 4.0*rmaxsq && cell.isCutBy(deltas[k]) &&
+                    cell.cut(deltas[k], int(cell_candidates[k])))
+                    rmaxsq = cell.maxRadiusSq();
+                }
+            if (num_face_candidates[i] == num_candidates)
+                rmaxsq = cell.maxRadiusSq();
+            valid_ptr[i] = sqrt(rmaxsq) + max_displacement <= radii[i] + skin;
+            if (!valid_ptr[i])
+                continue;
+            volumes[i] = storeCell(cell, result);
+            storeTopology(cell, cell_candidates, &deltas[0], num_candidates, is2D, half.z, result);
+            }
+        });
+
+    // search the cells that may have new neighbors again; they are cut from their candidates until the next compute
+    std::vector<unsigned int> invalid;
+    for (unsigned int i = 0; i < Np; i++)
+        if (!valid[i])
+            invalid.push_back(i);
+    if (invalid.size())
+        {
+        const CellSearch search(m_box, points, Np);
+        const CellSearch *search_ptr = &search;
+        const unsigned int *invalid_ptr = &invalid[0];
+        parallel_for(blocked_range<size_t>(0, invalid.size()),
+            [=] (const blocked_range<size_t>& r)
+            {
+            ConvexCell cell;
+            std::vector<CellCandidate> cell_candidates;
+            for (size_t k = r.begin(); k != r.end(); k++)
+                {
+                const unsigned int i = invalid_ptr[k];
+                cell.reset(half);
+                search_ptr->build(i, cell, cell_candidates);
+                volumes[i] = storeCell(cell, results_ptr[i]);
+                }
+            });
+        }
+
+    m_face_areas = fillNlist(m_nlist, results, true);
+    m_nlist.setWeights(m_face_areas.get());
+    m_surface_areas = surfaceAreas(results);
+    m_num_recomputed = invalid.size();
+    concatenate(results, &CellResult::vertex_planes, m_vertex_segments, m_vertex_planes);
+    concatenate(results, &CellResult::face_slots, m_face_segments, m_face_slots);
+    concatenate(results, &CellResult::face_sizes, m_face_segments, m_face_sizes);
+    concatenate(results, &CellResult::face_vertices, m_face_vertex_segments, m_face_vertices);
+    }
+
+void VoronoiCells::computeShells(unsigned int num_shells)
+    {
+    if (num_shells == 0)
+        throw invalid_argument("VoronoiCells needs at least one shell of neighbors");
+    if (m_Np == 0)
+        throw runtime_error("VoronoiCells must be computed before its shells of neighbors");
+    const unsigned int Np = m_Np;
+    const size_t *segments = m_nlist.getSegments().get();
+    const unsigned int *index_j = m_nlist.getIndexJ().get();
+    const vec3<float> *vectors = m_nlist.getVectors().get();
+
+    // breadth first search of the neighbors of each particle through the faces, each visit of a particle marking
+    // it with the index of the particle searched from so that the marks never need to be cleared
+    std::vector<CellResult> results(Np);
+    CellResult *results_ptr = &results[0];
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > local_marks;
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > *local_marks_ptr = &local_marks;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int>& marks = local_marks_ptr->local();
+        if (marks.size() != Np)
+            marks.assign(Np, UINT_MAX);
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            CellResult& result = results_ptr[i];
+            marks[i] = i;
+            // the particles found in the previous shell, from which the next one is searched
+            size_t sources_begin = 0, sources_end = 0;
+            for (unsigned int shell = 0; shell < num_shells; shell++)
+                {
+                // the first shell is searched from the particle itself
+                const size_t num_sources = shell ? sources_end - sources_begin : 1;
+                for (size_t source = 0; source < num_sources; source++)
+                    {
+                    const unsigned int u = shell ? result.neighbors[sources_begin + source] : i;
+                    const vec3<float> to_u = shell ? result.deltas[sources_begin + source] : vec3<float>(0, 0, 0);
+                    for (size_t bond = segments[u]; bond < segments[u + 1]; bond++)
+                        {
+                        const unsigned int j = index_j[bond];
+                        if (marks[j] == i)
+                            continue;
+                        marks[j] = i;
+                        result.neighbors.push_back(j);
+                        result.deltas.push_back(to_u + vectors[bond]);
+                        }
+                    }
+                sources_begin = sources_end;
+                sources_end = result.neighbors.size();
+                }
+            }
+        });
+
+    fillNlist(m_shell_nlist, results, false);
+    }
+
+}; }; // end namespace freud::voronoi
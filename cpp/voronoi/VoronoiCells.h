@@ -0,0 +1,153 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <vector>
+#include <tbb/tbb.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "NeighborList.h"
+
+#ifndef _VORONOI_CELLS_H__
+#define _VORONOI_CELLS_H__
+
+/*! \file VoronoiCells.h
+    \brief Periodic Voronoi tessellation, computed cell by cell
+*/
+
+namespace freud { namespace voronoi {
+
+//! Compute the Voronoi cell of every particle of a periodic system
+/*! Each cell is built on its own by cutting a polyhedron that contains it with the bisecting plane of every
+    candidate neighbor, nearest candidates first, so the particles are computed in parallel and the whole
+    tessellation is never stored. The candidates are found by visiting the cells of a LinkCell in shells of
+    increasing distance, stepping into periodic images of the box as needed; the search stops when the next shell is
+    farther than twice the largest distance from the particle to a vertex of its cell, since no farther particle can
+    cut it. All periodic images are taken into account, so small boxes are handled as well; each face of a cell is
+    shared with one image of its neighbor.
+
+    The results are the volume and the surface area of each cell and a NeighborList with one bond per face, from the
+    particle to the image of the neighbor across that face (the wrapped vector is stored), along with the area of
+    each face, which is also the weight of its bond. In a 2D box the cells are polygons: the volumes are their areas, the surface areas their perimeters
+    and the face areas the lengths of their edges.
+
+    computeShells() then finds the particles up to a number of faces away from each particle, by breadth first
+    search through the faces, as a second NeighborList: each particle appears once, ordered by shell and the
+    particle itself excluded, and the stored vector is the sum of the face vectors along the path it was found by.
+    Either list can be handed to the analyses that take a neighbor list, such as LocalQl, whose cutoffs still apply.
+
+    With a positive skin, compute() also keeps for each cell the particles within twice its radius plus twice the
+    skin, and the faces through each of its vertices, and update() rebuilds the cells of new positions of the same
+    particles from those candidates alone. When the faces of a cell are unchanged, its vertices are only moved to
+    the intersections of the planes of their faces at the new positions; a vertex beyond the plane of another
+    face or of another candidate means the faces changed, and the cell is cut from its candidates again, its new
+    faces kept for the next update. The candidates of a cell are enough as long as its new radius plus the largest
+    displacement since compute() stays within its old radius plus the skin, so that no other particle can cut it;
+    the other cells are searched again from a new cell list. When any particle has moved by more than half the
+    skin, or the box or the number of particles changed, update() starts over with compute(). The results are the
+    same as those of compute(), although the faces of a cell may come in a different order.
+*/
+class VoronoiCells
+    {
+    public:
+        //! Constructor
+        /*! \param skin Distance the particles may move before update() starts over, 0 to only compute()
+        */
+        VoronoiCells(float skin=0);
+
+        //! Get the skin
+        float getSkin() const
+            {
+            return m_skin;
+            }
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the number of particles of the last compute
+        unsigned int getNP() const
+            {
+            return m_Np;
+            }
+
+        //! Compute the Voronoi cells of the points
+        void compute(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Compute the Voronoi cells of the points, reusing the candidates of the last compute where it is safe
+        void update(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Get the number of cells of the last compute or update that were searched from a cell list
+        unsigned int getNumRecomputed() const
+            {
+            return m_num_recomputed;
+            }
+
+        //! Get the volume (area in 2D) of the cell of each particle
+        std::shared_ptr<float> getVolumes()
+            {
+            return m_volumes;
+            }
+
+        //! Get the surface area (perimeter in 2D) of the cell of each particle
+        std::shared_ptr<float> getSurfaceAreas()
+            {
+            return m_surface_areas;
+            }
+
+        //! Get the area (length in 2D) of the face of each bond of the neighbor list
+        std::shared_ptr<float> getFaceAreas()
+            {
+            return m_face_areas;
+            }
+
+        //! Get the neighbor list of the faces of each cell
+        locality::NeighborList *getNlist()
+            {
+            return &m_nlist;
+            }
+
+        //! Find the neighbors of each particle up to num_shells faces away, from the last compute
+        void computeShells(unsigned int num_shells);
+
+        //! Get the neighbor list of the last computeShells
+        locality::NeighborList *getShellNlist()
+            {
+            return &m_shell_nlist;
+            }
+
+    private:
+        box::Box m_box;                         //!< Simulation box the particles belong in
+        unsigned int m_Np;                      //!< Number of particles of the last compute
+        locality::NeighborList m_nlist;         //!< One bond per face of each cell
+        locality::NeighborList m_shell_nlist;   //!< One bond per particle within the shells of each particle
+        std::shared_ptr<float> m_volumes;       //!< Volume of each cell
+        std::shared_ptr<float> m_face_areas;    //!< Area of each face, by bond of m_nlist
+        std::shared_ptr<float> m_surface_areas; //!< Surface area of each cell
+        float m_skin;                           //!< Distance the particles may move between updates
+        unsigned int m_num_recomputed;          //!< Number of cells searched by the last compute or update
+
+        std::vector< vec3<float> > m_ref_points;        //!< Points of the last compute
+        std::vector< vec3<double> > m_ref_positions;    //!< Points of the last compute, in the images of their cells
+        std::vector<float> m_radii;                     //!< Radius of each cell of the last compute
+        std::vector<unsigned int> m_num_face_candidates;    //!< Number of leading candidates of each cell across a face
+        std::vector<size_t> m_candidate_segments;       //!< First candidate of each cell
+        std::vector<unsigned int> m_candidates;         //!< Candidates of all the cells
+        std::vector<char3> m_candidate_images;          //!< Image of the box of each candidate
+        std::vector<size_t> m_vertex_segments;          //!< First vertex of each cell
+        std::vector<uchar3> m_vertex_planes;            //!< Faces through each vertex, by candidate of the cell
+        std::vector<size_t> m_face_segments;            //!< First face of each cell
+        std::vector<unsigned char> m_face_slots;        //!< Candidate of the cell across each face
+        std::vector<unsigned short> m_face_sizes;       //!< Number of vertices of each face
+        std::vector<size_t> m_face_vertex_segments;     //!< First vertex of the faces of each cell
+        std::vector<unsigned short> m_face_vertices;    //!< Vertices of each face, by vertex of the cell
+    };
+
+}; }; // end namespace freud::voronoi
+
+#endif // _VORONOI_CELLS_H__
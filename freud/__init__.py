@@ -7,6 +7,7 @@ from . import box
 from . import bond
 from . import cluster
 from . import density
+from . import dynamics
 from . import kspace
 from . import locality
 from . import order
@@ -14,6 +15,9 @@ from . import interface
 # from . import shape
 from . import voronoi
 from . import pmft
+from . import registration
+from . import split
+from . import trajectory
 from . import index
 from . import common
 
@@ -9,6 +9,7 @@ from libcpp.complex cimport complex
 from libcpp.vector cimport vector
 from libcpp.map cimport map
 cimport freud._box as box
+cimport freud._locality as locality
 
 cdef extern from "BondingAnalysis.h" namespace "freud::bond":
     cdef cppclass BondingAnalysis:
@@ -16,9 +17,12 @@ cdef extern from "BondingAnalysis.h" namespace "freud::bond":
         void reduceArrays()
         void initialize(unsigned int*) nogil
         void compute(unsigned int*, unsigned int*) nogil
+        void update(unsigned int*) nogil
         vector[vector[uint]] getBondLifetimes()
-        # vector[vector[uint]] getOverallLifetimes()
         vector[uint] getOverallLifetimes()
+        shared_ptr[uint] getBondLifetimeHistogram()
+        shared_ptr[uint] getOverallLifetimeHistogram()
+        unsigned int getNumLifetimes()
         shared_ptr[uint] getTransitionMatrix()
         unsigned int getNumFrames()
         unsigned int getNumParticles()
@@ -34,8 +38,12 @@ cdef extern from "BondingR12.h" namespace "freud::bond":
                      unsigned int,
                      vec3[float]*,
                      float*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
         shared_ptr[ uint ] getBonds()
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
         unsigned int getNumParticles()
         unsigned int getNumBonds()
         map[ uint, uint] getListMap()
@@ -51,8 +59,12 @@ cdef extern from "BondingXY2D.h" namespace "freud::bond":
                      unsigned int,
                      vec3[float]*,
                      float*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
         shared_ptr[ uint ] getBonds()
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
         unsigned int getNumParticles()
         unsigned int getNumBonds()
         map[ uint, uint] getListMap()
@@ -68,8 +80,12 @@ cdef extern from "BondingXYT.h" namespace "freud::bond":
                      unsigned int,
                      vec3[float]*,
                      float*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
         shared_ptr[ uint ] getBonds()
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
         unsigned int getNumParticles()
         unsigned int getNumBonds()
         map[ uint, uint] getListMap()
@@ -86,8 +102,12 @@ cdef extern from "BondingXYZ.h" namespace "freud::bond":
                      unsigned int,
                      vec3[float]*,
                      quat[float]*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
         shared_ptr[ uint ] getBonds()
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
         unsigned int getNumParticles()
         unsigned int getNumBonds()
         map[ uint, uint] getListMap()
@@ -5,6 +5,7 @@ from libcpp cimport bool
 from freud.util._VectorMath cimport vec3
 from libcpp.string cimport string
 from freud.util._Boost cimport shared_array
+from freud.util._cudaTypes cimport uchar3
 
 cdef extern from "box.h" namespace "freud::box":
     cdef cppclass Box:
@@ -19,6 +20,9 @@ cdef extern from "box.h" namespace "freud::box":
         void set2D(bool)
         bool is2D() const
 
+        uchar3 getPeriodic() const
+        void setPeriodic(uchar3)
+
         float getLx() const
         float getLy() const
         float getLz() const
@@ -37,4 +41,9 @@ cdef extern from "box.h" namespace "freud::box":
         vec3[float] wrap(vec3[float]&)
         vec3[float] wrapMultiple(vec3[float]& v) const
         vec3[float] unwrap(vec3[float]&, vec3[int]&)
+        void wrap(vec3[float]*, unsigned int) nogil
+        void wrap(vec3[float]*, vec3[int]*, unsigned int) nogil
+        void unwrap(vec3[float]*, const vec3[int]*, unsigned int) nogil
+        void makeFraction(vec3[float]*, unsigned int) nogil
+        void makeCoordinates(vec3[float]*, unsigned int) nogil
 
@@ -5,19 +5,28 @@ from libcpp cimport bool
 from freud.util._VectorMath cimport vec3
 from freud.util._Boost cimport shared_array
 cimport freud._box as box
+cimport freud._locality as locality
 from libcpp.vector cimport vector
 from libc.stdint cimport uint32_t
 
 cdef extern from "Cluster.h" namespace "freud::cluster":
-    cdef cppclass Cluster:
+    cdef cppclass Cluster(locality.PairAnalysis):
         Cluster(const box.Box&, float)
         const box.Box &getBox() const
-        void computeClusters(const vec3[float]*, unsigned int) nogil except +
+        void computeClusters(const vec3[float]*, unsigned int, const locality.NeighborList*, bool) nogil except +
+        void computeClustersFromBonds(unsigned int, const unsigned int*, const unsigned int*, size_t) nogil except +
+        void computeClustersFromNeighborList(unsigned int, const locality.NeighborList*) nogil except +
         void computeClusterMembership(const unsigned int*) nogil except +
         unsigned int getNumClusters()
         unsigned int getNumParticles()
         shared_array[unsigned int] getClusterIdx()
-        const vector[unsigned int] getClusterKeys()
+        shared_array[unsigned int] getClusterKeys()
+        shared_array[unsigned int] getClusterKeyOffsets()
+        unsigned int getNumClusterKeys()
+        bool getTrackImages()
+        shared_array[vec3[int]] getClusterImages()
+        shared_array[unsigned int] getClusterPercolationDim()
+        shared_array[unsigned int] getClusterPercolationAxes()
 
 cdef extern from "ClusterProperties.h" namespace "freud::cluster":
     cdef cppclass ClusterProperties:
@@ -28,3 +37,34 @@ cdef extern from "ClusterProperties.h" namespace "freud::cluster":
         shared_array[vec3[float]] getClusterCOM()
         shared_array[float] getClusterG()
         shared_array[unsigned int] getClusterSize()
+        shared_array[float] getClusterRg()
+        shared_array[float] getClusterAsphericity()
+
+cdef extern from "ClusterReduction.h" namespace "freud::cluster":
+    cdef cppclass ClusterReduction:
+        ClusterReduction()
+        void compute(const unsigned int*, unsigned int, const float*, unsigned int, unsigned int, bool) nogil except +
+        unsigned int getNumClusters()
+        unsigned int getNumValues()
+        shared_array[unsigned int] getClusterSize()
+        shared_array[float] getSum()
+        shared_array[float] getMean()
+        shared_array[float] getMin()
+        shared_array[float] getMax()
+        shared_array[float] getCovariance()
+
+cdef extern from "ClusterTracker.h" namespace "freud::cluster":
+    cdef cppclass ClusterTracker:
+        ClusterTracker(unsigned int)
+        void reset()
+        void update(const unsigned int*, unsigned int) nogil except +
+        unsigned int getNumFrames()
+        unsigned int getNumClusters()
+        shared_array[unsigned int] getClusterSize()
+        shared_array[unsigned int] getClusterIds()
+        unsigned int getNumOverlaps()
+        shared_array[unsigned int] getOverlapPrev()
+        shared_array[unsigned int] getOverlapNext()
+        shared_array[unsigned int] getOverlapCount()
+        unsigned int getNumEvents()
+        shared_array[unsigned int] getEvents()
@@ -1,57 +1,244 @@
 # Copyright (c) 2010-2016 The Regents of the University of Michigan
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
-from freud.util._VectorMath cimport vec3
+from freud.util._VectorMath cimport vec3, quat
+from freud.util._BinCount cimport BinCount
 from freud.util._Boost cimport shared_array
+from freud.util._Profiler cimport Profiler
+from freud.util._MemoryUsage cimport MemoryUsage
+from libcpp.memory cimport shared_ptr
+from libcpp cimport bool
+from libcpp.string cimport string
+from libcpp.vector cimport vector
 cimport freud._box as box
+cimport freud._locality as locality
 
 cdef extern from "CorrelationFunction.h" namespace "freud::density":
     cdef cppclass CorrelationFunction[T]:
-        CorrelationFunction(float, float)
+        CorrelationFunction(float, float) except +
+        CorrelationFunction(const vector[float]&) except +
         const box.Box &getBox() const
         void resetCorrelationFunction()
         void accumulate(const box.Box &, const vec3[float]*, const T*,
-            unsigned int, const vec3[float]*, const T*, unsigned int) nogil except +
-        void reduceCorrelationFunction()
+            unsigned int, const vec3[float]*, const T*, unsigned int,
+            const locality.NeighborList*) nogil except +
+        void reduceCorrelationFunction() nogil
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const CorrelationFunction[T]&) except +
         shared_array[T] getRDF()
         shared_array[unsigned int] getCounts()
         shared_array[float] getR()
         unsigned int getNBins() const
+        const vector[float]& getBinEdges() const
 
 cdef extern from "GaussianDensity.h" namespace "freud::density":
+    cdef enum SpreadMode:
+        SPREAD_AUTO
+        SPREAD_SCATTER
+        SPREAD_GATHER
+
     cdef cppclass GaussianDensity:
         GaussianDensity(unsigned int, float, float)
         GaussianDensity(unsigned int, unsigned int, unsigned int, float, float)
         const box.Box &getBox() const
         void resetDensity()
         void reduceDensity()
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
         void compute(const box.Box &, const vec3[float]*, unsigned int) nogil except +
-        shared_array[float] getDensity()
+        void computeFFT(const box.Box &, const vec3[float]*, unsigned int) nogil except +
+        void computeProjection(const box.Box &, const vec3[float]*, unsigned int, float, float) nogil except +
+        shared_array[float] getProjection()
+        void setUseGPU(bool) except +
+        bool getUseGPU() const
+        void setSpreadMode(SpreadMode)
+        SpreadMode getSpreadMode() const
+        bool getGathered() const
+        void setMemoryLimit(size_t)
+        size_t getMemoryLimit() const
+        MemoryUsage getMemoryUsage() const
+        MemoryUsage estimateMemory(unsigned int, unsigned int) const
+        shared_array[float] getDensity() except +
+        shared_array[float] getCoarseDensity(unsigned int) nogil except +
         unsigned int getWidthX()
         unsigned int getWidthY()
         unsigned int getWidthZ()
 
 cdef extern from "LocalDensity.h" namespace "freud::density":
-    cdef cppclass LocalDensity:
+    cdef cppclass LocalDensity(locality.PairAnalysis):
         LocalDensity(float, float, float)
+        LocalDensity(const vector[float]&, float, float) except +
         const box.Box &getBox() const
-        void compute(const box.Box &, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int) nogil except +
+        void compute(const box.Box &, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                     const locality.NeighborList*) nogil except +
         unsigned int getNRef()
+        unsigned int getNumRCuts() const
+        const vector[float]& getRCuts() const
         shared_array[float] getDensity()
         shared_array[float] getNumNeighbors()
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
 
 cdef extern from "RDF.h" namespace "freud::density":
-    cdef cppclass RDF:
-        RDF(float, float)
+    cdef cppclass RDF(locality.PairAnalysis):
+        RDF(float, float) except +
+        RDF(const vector[float]&) except +
         const box.Box& getBox() const
         void resetRDF()
         void accumulate(box.Box&,
                         const vec3[float]*,
                         unsigned int,
                         const vec3[float]*,
-                        unsigned int) nogil except +
-        void reduceRDF()
+                        unsigned int,
+                        const locality.NeighborList*,
+                        const float*,
+                        const float*) nogil except +
+        void accumulate(box.Box&,
+                        const float*,
+                        const float*,
+                        const float*,
+                        unsigned int,
+                        const float*,
+                        const float*,
+                        const float*,
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
+        void accumulateFrames(const box.Box*,
+                              const vec3[float]*,
+                              unsigned int,
+                              const vec3[float]*,
+                              unsigned int,
+                              unsigned int) nogil except +
+        void accumulateDomain(box.Box&,
+                              const vec3[float]*,
+                              unsigned int,
+                              unsigned int,
+                              const box.Box&,
+                              unsigned int,
+                              bool) nogil except +
+        void reduceRDF() nogil
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const RDF&) except +
         shared_array[float] getRDF()
+        shared_array[float] getWeightedRDF()
+        bool getWeighted() const
         shared_array[float] getR()
         shared_array[float] getNr()
         unsigned int getNBins()
+        const vector[float]& getBinEdges() const
+        void setPartitionMode(locality.PartitionMode)
+        locality.PartitionMode getPartitionMode() const
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
+        void setUseGPU(bool) except +
+        bool getUseGPU() const
+        void setKernelWidth(float) except +
+        float getKernelWidth() const
+        void setPointHistograms(bool, bool)
+        bool getPointHistograms() const
+        bool getPointHistogramsCompact() const
+        unsigned int getNumPointHistograms() const
+        shared_array[unsigned int] getPointCounts()
+        shared_array[unsigned short] getPointCountsCompact()
+        const Profiler& getProfiler() const
+        MemoryUsage getMemoryUsage() const
+        MemoryUsage estimateMemory(unsigned int, unsigned int) const
+
+cdef extern from "PartialRDF.h" namespace "freud::density":
+    cdef cppclass PartialRDF:
+        PartialRDF(float, float, unsigned int) except +
+        const box.Box& getBox() const
+        void resetPartialRDF()
+        void accumulate(box.Box&,
+                        const vec3[float]*,
+                        const unsigned int*,
+                        unsigned int) nogil except +
+        void reducePartialRDF() nogil
+        shared_ptr[float] getRDF()
+        shared_ptr[float] getR()
+        shared_ptr[float] getNr()
+        unsigned int getNBins() const
+        unsigned int getNTypes() const
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const PartialRDF&) except +
+
+cdef extern from "GroupedRDF.h" namespace "freud::density":
+    cdef cppclass GroupedRDF:
+        GroupedRDF(float, float, unsigned int) except +
+        const box.Box& getBox() const
+        void resetGroupedRDF()
+        void accumulate(box.Box&,
+                        const vec3[float]*,
+                        const unsigned int*,
+                        unsigned int,
+                        const vec3[float]*,
+                        unsigned int) nogil except +
+        void reduceGroupedRDF() nogil
+        shared_ptr[float] getRDF()
+        shared_ptr[float] getR()
+        shared_ptr[float] getNr()
+        const vector[double]& getGroupCounts() const
+        unsigned int getNBins() const
+        unsigned int getNGroups() const
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+
+cdef extern from "AngularRDF.h" namespace "freud::density":
+    cdef cppclass AngularRDF:
+        AngularRDF(float, float, unsigned int, const vec3[float]&) except +
+        const box.Box& getBox() const
+        void resetAngularRDF()
+        void accumulate(box.Box&,
+                        const vec3[float]*,
+                        const quat[float]*,
+                        unsigned int,
+                        const vec3[float]*,
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
+        void reduceAngularRDF() nogil
+        shared_ptr[float] getRDF()
+        shared_ptr[BinCount] getBinCounts()
+        shared_ptr[float] getR()
+        shared_ptr[float] getCosTheta()
+        unsigned int getNBinsR() const
+        unsigned int getNBinsCosTheta() const
+
+cdef extern from "DensityProfile.h" namespace "freud::density":
+    cdef cppclass DensityProfile:
+        DensityProfile(unsigned int, unsigned int, unsigned int, float, bool) except +
+        const box.Box& getBox() const
+        void resetProfile()
+        void accumulate(const box.Box&,
+                        const vec3[float]*,
+                        const unsigned int*,
+                        unsigned int) nogil except +
+        void reduceProfile() nogil
+        shared_ptr[float] getDensity()
+        shared_ptr[float] getPositions()
+        unsigned int getNBins() const
+        unsigned int getNTypes() const
+        unsigned int getFrameCounter() const
+
+cdef extern from "FFTRDF.h" namespace "freud::density":
+    cdef cppclass FFTRDF:
+        FFTRDF(float, float, unsigned int) except +
+        const box.Box& getBox() const
+        void resetRDF()
+        void accumulate(box.Box&,
+                        const vec3[float]*,
+                        unsigned int,
+                        const vec3[float]*,
+                        unsigned int) nogil except +
+        void reduceRDF() nogil
+        shared_ptr[float] getRDF()
+        shared_ptr[float] getR()
+        shared_ptr[float] getNr()
+        unsigned int getNBins() const
+        unsigned int getWidth() const
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const FFTRDF&) except +
@@ -0,0 +1,40 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from freud.util._Boost cimport shared_array
+from libcpp.memory cimport shared_ptr
+from freud.util._VectorMath cimport vec3
+cimport freud._box as box
+
+cdef extern from "MultipleTau.h" namespace "freud::dynamics":
+    cdef cppclass MultipleTau:
+        MultipleTau(unsigned int, unsigned int, unsigned int, unsigned int) except +
+        void reset()
+        void accumulate(const float*, unsigned int) nogil except +
+        unsigned int getNumValues() const
+        unsigned int getDimensions() const
+        unsigned int getFrameCounter() const
+        unsigned int getNumLags()
+        shared_array[unsigned int] getLags()
+        shared_array[double] getCorrelation()
+        shared_array[unsigned int] getCounts()
+
+cdef extern from "MSD.h" namespace "freud::dynamics":
+    cdef cppclass MSD:
+        MSD()
+        void compute(const box.Box&, const vec3[float]*, const vec3[int]*, unsigned int, unsigned int) nogil except +
+        shared_array[double] getMSD()
+        unsigned int getNumFrames() const
+        unsigned int getNP() const
+
+cdef extern from "Displacement.h" namespace "freud::dynamics":
+    cdef cppclass Displacement:
+        Displacement()
+        void reset()
+        void update(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        const box.Box& getBox() const
+        shared_ptr[vec3[float]] getDisplacements()
+        shared_ptr[vec3[int]] getImages()
+        float getMaxDisplacement() const
+        unsigned int getFrameCounter() const
+        unsigned int getNP() const
@@ -4,11 +4,13 @@
 # distutils: language = c++
 # cython: embedsignature=True
 
+include "array.pxi"
 include "box.pxi"
+include "locality.pxi"
 include "bond.pxi"
 include "interface.pxi"
-include "locality.pxi"
 include "density.pxi"
+include "dynamics.pxi"
 include "pmft.pxi"
 include "order.pxi"
 include "index.pxi"
@@ -16,3 +18,6 @@ include "voronoi.pxi"
 include "parallel.pxi"
 include "kspace.pxi"
 include "cluster.pxi"
+include "registration.pxi"
+include "split.pxi"
+include "trajectory.pxi"
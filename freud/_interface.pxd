@@ -2,11 +2,22 @@
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
 from libcpp cimport bool
-from freud.util._VectorMath cimport vec3
+from freud.util._VectorMath cimport vec3, quat
 from freud.util._Boost cimport shared_array
 cimport freud._box as box
+cimport freud._locality as locality
 
 cdef extern from "InterfaceMeasure.h" namespace "freud::interface":
     cdef cppclass InterfaceMeasure:
         InterfaceMeasure(const box.Box&, float)
-        unsigned int compute(const vec3[float]*, unsigned int, const vec3[float]*, unsigned int)
+        unsigned int compute(const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                             const locality.NeighborList*) nogil except +
+        unsigned int getNRef() const
+        shared_array[bool] getInterfaceMask()
+        unsigned int computeShapes(const vec3[float]*, const quat[float]*, unsigned int, const vec3[float]*,
+                                   const quat[float]*, unsigned int, const vec3[float]*, unsigned int) nogil except +
+        void computeTypes(const vec3[float]*, const unsigned int*, unsigned int, unsigned int) nogil except +
+        unsigned int getNP() const
+        unsigned int getNumTypes() const
+        shared_array[bool] getTypeMask()
+        shared_array[unsigned int] getTypeCounts()
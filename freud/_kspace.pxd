@@ -4,6 +4,11 @@
 from freud.util._Boost cimport shared_array
 from freud.util._VectorMath cimport vec3, quat
 from libcpp.complex cimport complex
+from libcpp cimport bool
+from libcpp.vector cimport vector
+cimport freud._box as box
+cimport freud._locality as locality
+cimport freud._density as density
 
 cdef extern from "kspace.h" namespace "freud::kspace":
     cdef cppclass FTdelta:
@@ -11,6 +16,10 @@ cdef extern from "kspace.h" namespace "freud::kspace":
         void set_K(vec3[float]*, unsigned int)
         void set_rq(unsigned int, vec3[float]*, quat[float]*)
         void set_density(float complex)
+        void setUseGPU(bool) except +
+        bool getUseGPU() const
+        void setNUFFTTolerance(float) except +
+        float getNUFFTTolerance() const
         void compute() nogil except +
         shared_array[float complex] getFT()
 
@@ -19,6 +28,10 @@ cdef extern from "kspace.h" namespace "freud::kspace":
         void set_K(vec3[float]*, unsigned int)
         void set_rq(unsigned int, vec3[float]*, quat[float]*)
         void set_density(float complex)
+        void setUseGPU(bool) except +
+        bool getUseGPU() const
+        void setNUFFTTolerance(float) except +
+        float getNUFFTTolerance() const
         void compute() nogil except +
         shared_array[float complex] getFT()
         void set_radius(const float)
@@ -30,5 +43,71 @@ cdef extern from "kspace.h" namespace "freud::kspace":
         void set_density(float complex)
         void set_params(unsigned int, vec3[float]*, unsigned int, unsigned int *, unsigned int *, \
             vec3[float]* norm, float *d, float *area, float volume)
+        void set_orientation_tolerance(float)
+        unsigned int getNumOrientations() const
+        unsigned int getNumCachedOrientations() const
         void compute() nogil except +
         shared_array[float complex] getFT()
+
+    cdef cppclass FTcomposite:
+        FTcomposite()
+        void clear()
+        void add(FTdelta*, float)
+        unsigned int getNumTypes() const
+        unsigned int getNK() const
+        void compute() nogil except +
+        shared_array[float complex] getFT()
+
+cdef extern from "IntermediateScattering.h" namespace "freud::kspace":
+    cdef cppclass IntermediateScattering:
+        IntermediateScattering(const box.Box&, float, float, unsigned int, unsigned int) except +
+        const box.Box& getBox() const
+        void reset()
+        void accumulate(const vec3[float]*, unsigned int) nogil except +
+        unsigned int getNumShells() const
+        unsigned int getNumLags() const
+        unsigned int getFrameCounter() const
+        unsigned int getNumVectors() const
+        const vector[vec3[float]]& getVectors() const
+        shared_array[unsigned int] getShellCounts()
+        shared_array[float] getQ()
+        shared_array[float] getF()
+        shared_array[unsigned int] getCounts()
+
+cdef extern from "KPointStructureFactor.h" namespace "freud::kspace":
+    cdef cppclass KPointStructureFactor:
+        KPointStructureFactor(const vec3[float]*, unsigned int)
+        void reset()
+        void accumulate(const vec3[float]*, unsigned int) nogil except +
+        void setNUFFTTolerance(float) except +
+        float getNUFFTTolerance() const
+        unsigned int getNK() const
+        const vector[vec3[float]]& getK() const
+        unsigned int getFrameCounter() const
+        shared_array[float] getS()
+
+cdef extern from "StructureFactor.h" namespace "freud::kspace":
+    cdef cppclass StructureFactor:
+        StructureFactor(unsigned int)
+        unsigned int getG() const
+        unsigned int getGridWidth() const
+        void computeDirect(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        void computeFFT(const box.Box&, const vec3[float]*, unsigned int, unsigned int) nogil except +
+        shared_array[float complex] getSComplex()
+        shared_array[float] getS()
+
+    void shellAverage(const float*, unsigned int, double*, unsigned int*)
+
+cdef extern from "DebyeStructureFactor.h" namespace "freud::kspace":
+    cdef cppclass DebyeStructureFactor:
+        DebyeStructureFactor(float, float, float, float, unsigned int, bool) except +
+        const box.Box& getBox() const
+        void reset()
+        void accumulate(box.Box&, const vec3[float]*, unsigned int, const locality.NeighborList*) nogil except +
+        unsigned int getNumQ() const
+        shared_array[float] getQ()
+        shared_array[float] getS()
+        density.RDF& getRDF()
+
+    unsigned int transformRDFNumQ(unsigned int, unsigned int)
+    void transformRDF(const float*, unsigned int, float, float, float, bool, unsigned int, float*, float*) nogil except +
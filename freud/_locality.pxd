@@ -2,27 +2,105 @@
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
 from libcpp cimport bool
-from freud.util._VectorMath cimport vec3
+from freud.util._VectorMath cimport vec3, quat
 from freud.util._Index1D cimport Index3D
 from freud.util._Boost cimport shared_array
+from freud.util._Profiler cimport Profiler
 cimport freud._box as box
 from libcpp.vector cimport vector
 
+cdef extern from "NeighborList.h" namespace "freud::locality":
+    cdef enum WeightKernel:
+        WEIGHT_UNIFORM
+        WEIGHT_GAUSSIAN
+        WEIGHT_LINEAR
+
+    cdef cppclass NeighborList:
+        NeighborList()
+        NeighborList(size_t, unsigned int, unsigned int, bool)
+
+        void resize(size_t, unsigned int, unsigned int, bool)
+        void updateSegments() nogil except +
+        void validate(unsigned int, unsigned int) except +
+        void sortByDistance() nogil
+        bool isSortedByDistance() const
+        void copyWithin(const NeighborList&, float) nogil except +
+        void copyWithinRange(const NeighborList&, float, float) nogil except +
+        void copyTypes(const NeighborList&, const unsigned int*, const unsigned int*, unsigned int,
+                       unsigned int) nogil except +
+        void copyMasked(const NeighborList&, const unsigned char*, const unsigned char*) nogil except +
+        void copyIf(const NeighborList&, const unsigned char*) nogil except +
+        void copySymmetric(const NeighborList&) nogil except +
+        void setWeights(const float*) nogil
+        void weightByDistance(WeightKernel, float) nogil except +
+        void clearWeights()
+        bool hasWeights() const
+        shared_array[float] getWeights() const
+        void computeRelativeOrientations(const quat[float]*, const quat[float]*) nogil
+        void computeRelativeAngles(const float*, const float*) nogil
+        void clearRelativeOrientations()
+        bool hasRelativeOrientations() const
+        shared_array[quat[float]] getRelativeOrientations() const
+        bool hasRelativeAngles() const
+        shared_array[float] getRelativeAngles() const
+        size_t getNumBonds() const
+        unsigned int getNumI() const
+        unsigned int getNumJ() const
+        bool hasVectors() const
+        shared_array[unsigned int] getIndexI() const
+        shared_array[unsigned int] getIndexJ() const
+        shared_array[float] getDistances() const
+        shared_array[vec3[float]] getVectors() const
+        shared_array[size_t] getSegments() const
+
+cdef extern from "CompressedNeighborList.h" namespace "freud::locality":
+    cdef cppclass CompressedNeighborList:
+        CompressedNeighborList()
+        void compress(const NeighborList&, bool) nogil
+        void decompress(NeighborList&) nogil const
+        unsigned int decodeBonds(unsigned int, unsigned int*, float*) nogil const
+        size_t getNumBonds() const
+        unsigned int getNumI() const
+        unsigned int getNumJ() const
+        unsigned int getMaxNeighbors() const
+        unsigned int getNumNeighbors(unsigned int) const
+        bool hasHalfDistances() const
+        size_t getMemoryUsage() const
+
 cdef extern from "LinkCell.h" namespace "freud::locality":
     cdef cppclass IteratorLinkCell:
         IteratorLinkCell()
-        IteratorLinkCell(const shared_array[unsigned int] &, unsigned int, unsigned int, unsigned int)
+        IteratorLinkCell(const shared_array[unsigned int] &, const shared_array[unsigned int] &, unsigned int, unsigned int)
         void copy(const IteratorLinkCell&);
         bool atEnd()
         unsigned int next()
         unsigned int begin()
 
+    cdef cppclass CellNeighbors:
+        CellNeighbors()
+        unsigned int size() const
+        unsigned int operator[](unsigned int) const
+
     cdef cppclass LinkCell:
         LinkCell(const box.Box&, float)
         LinkCell()
 
         setCellWidth(float)
         updateBox(const box.Box&)
+        void setSubdivision(unsigned int) except +
+        unsigned int getSubdivision() const
+        void setLazyStencils(bool)
+        bool getLazyStencils() const
+        void setPowerOfTwoCells(bool)
+        bool getPowerOfTwoCells() const
+        void setMortonCells(bool)
+        bool getMortonCells() const
+        void setFitOpenBoundaries(bool)
+        bool getFitOpenBoundaries() const
+        void setAutoSubdivision(bool)
+        bool getAutoSubdivision() const
+        unsigned int chooseSubdivision(const box.Box&, unsigned int) const
+        unsigned int tuneSubdivision(const box.Box&, const vec3[float]*, unsigned int) nogil except +
         const vec3[unsigned int] computeDimensions(const box.Box&, float) const
         const box.Box &getBox() const
         const Index3D &getCellIndexer() const
@@ -30,8 +108,39 @@ cdef extern from "LinkCell.h" namespace "freud::locality":
         float getCellWidth() const
         unsigned int getCell(const vec3[float]&) const
         IteratorLinkCell itercell(unsigned int) const
-        vector[unsigned int] getCellNeighbors(unsigned int) const
+        CellNeighbors getCellNeighbors(unsigned int) const
         void computeCellList(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        void computeNlist(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                          bool, bool) nogil except +
+        void countNeighbors(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                            bool, unsigned int*) nogil except +
+        unsigned int findAnyNeighbor(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*,
+                                     unsigned int, bool, bool*) nogil except +
+        NeighborList *getNlist()
+        const Profiler& getProfiler() const
+
+cdef extern from "KDTree.h" namespace "freud::locality":
+    cdef cppclass KDTree:
+        KDTree()
+
+        void build(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        const box.Box &getBox() const
+        unsigned int getNp() const
+        float getMaxRadius() const
+        void computeNlist(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                          float, bool, bool) nogil except +
+        NeighborList *getNlist()
+
+cdef extern from "PeriodicImages.h" namespace "freud::locality":
+    cdef cppclass PeriodicImages:
+        PeriodicImages(const box.Box&, float) except +
+
+        @staticmethod
+        bool needed(const box.Box&, float)
+        const box.Box &getBox() const
+        float getRMax() const
+        void computeNlist(const vec3[float]*, unsigned int, const vec3[float]*, unsigned int, bool, bool,
+                          NeighborList&) nogil except +
 
 cdef extern from "NearestNeighbors.h" namespace "freud::locality":
     cdef cppclass NearestNeighbors:
@@ -49,5 +158,92 @@ cdef extern from "NearestNeighbors.h" namespace "freud::locality":
         # shared_array[float] getRsq(unsigned int) const
         shared_array[float] getRsqList() const
         shared_array[vec3[float]] getWrappedVectors() const
+        NeighborList *getNlist()
         void setCutMode(const bool)
+        void setUseTree(const bool)
+        bool getUseTree() const
+        void setApproximate(float)
+        float getApproximate() const
+        void setRecallSamples(unsigned int)
+        unsigned int getRecallSamples() const
+        float getRecall() const
+        float getExactFraction() const
+        float getMaxDistanceRatio() const
+        unsigned int getNumRecallQueries() const
+        void setStoreDistances(const bool)
+        bool getStoreDistances() const
+        void setStoreVectors(const bool)
+        bool getStoreVectors() const
+        const Profiler& getProfiler() const
         void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int) nogil except +
+        void buildIndex(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        unsigned int getIndexNp() const
+        void query(const vec3[float]*, unsigned int, unsigned int*, float*, vec3[float]*) nogil except +
+        void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int, KDTree&,
+                     unsigned int*, float*, vec3[float]*) nogil except +
+
+cdef extern from "VerletList.h" namespace "freud::locality":
+    cdef cppclass VerletList:
+        VerletList(float, float) except +
+
+        float getRCut() const
+        float getSkin() const
+        unsigned int getNumBuilds() const
+        void reset()
+        void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                     bool, bool) nogil except +
+        NeighborList *getNlist()
+
+cdef extern from "WorkPartition.h" namespace "freud::locality":
+    cdef enum PartitionMode:
+        PARTITION_AUTO
+        PARTITION_COST
+        PARTITION_AFFINITY
+        PARTITION_PAIR_BLOCKS
+
+cdef extern from "SpaceFillingCurve.h" namespace "freud::locality::SpaceFillingCurve":
+    cdef enum Curve:
+        MORTON
+        HILBERT
+
+cdef extern from "SpaceFillingCurve.h" namespace "freud::locality":
+    cdef cppclass SpaceFillingCurve:
+        SpaceFillingCurve(Curve)
+        Curve getCurve() const
+        void compute(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        unsigned int getNp() const
+        shared_array[unsigned int] getOrder()
+        shared_array[unsigned int] getInverse()
+        void reorder(void*, size_t) nogil
+        void restore(void*, size_t) nogil
+
+cdef extern from "DomainDecomposition.h" namespace "freud::locality":
+    cdef cppclass DomainDecomposition:
+        DomainDecomposition(const box.Box&, unsigned int, unsigned int, unsigned int, float) except +
+        const box.Box& getBox() const
+        const Index3D& getDomainIndexer() const
+        unsigned int getNumDomains() const
+        float getGhostWidth() const
+        unsigned int getDomain(const vec3[float]&) const
+        box.Box getDomainBox(unsigned int) except +
+        void compute(const vec3[float]*, unsigned int) nogil except +
+        unsigned int getNp() const
+        shared_array[unsigned int] getDomains()
+        size_t getNumEntries() const
+        shared_array[size_t] getOffsets()
+        shared_array[unsigned int] getIndices()
+        shared_array[vec3[float]] getPositions()
+
+cdef extern from "FrameAnalysis.h" namespace "freud::locality":
+    cdef cppclass PairAnalysis:
+        float getPairRMax() const
+
+    cdef cppclass FrameAnalysis:
+        FrameAnalysis()
+        void addAnalysis(PairAnalysis*) except +
+        void clearAnalyses()
+        unsigned int getNumAnalyses() const
+        float getRMax() const
+        void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                     const NeighborList*) nogil except +
+        const Profiler& getProfiler() const
@@ -2,6 +2,7 @@
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
 from libcpp cimport bool
+from libcpp.string cimport string
 from freud.util._VectorMath cimport vec3
 from freud.util._VectorMath cimport quat
 from freud.util._Boost cimport shared_array
@@ -10,6 +11,7 @@ from libcpp.complex cimport complex
 from libcpp.vector cimport vector
 from libcpp.map cimport map
 cimport freud._box as box
+cimport freud._locality as locality
 
 cdef extern from "BondOrder.h" namespace "freud::order":
     cdef cppclass BondOrder:
@@ -24,7 +26,10 @@ cdef extern from "BondOrder.h" namespace "freud::order":
                         quat[float]*,
                         unsigned int,
                         unsigned int) nogil
-        void reduceBondOrder()
+        void reduceBondOrder() nogil
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const BondOrder&) except +
         shared_ptr[float] getBondOrder()
         shared_ptr[float] getTheta()
         shared_ptr[float] getPhi()
@@ -69,22 +74,38 @@ cdef extern from "LocalDescriptors.h" namespace "freud::order":
         Global
         ParticleLocal
 
+    ctypedef enum LocalDescriptorOutput:
+        ComplexHarmonics
+        RealHarmonics
+        HalfRealHarmonics
+        PowerSpectrum
+        Bispectrum
+
     cdef cppclass LocalDescriptors:
         LocalDescriptors(unsigned int,
                          unsigned int,
                          float,
-                         bool)
+                         bool,
+                         LocalDescriptorOutput)
         unsigned int getNNeigh() const
         unsigned int getLMax() const
         unsigned int getSphWidth() const
         float getRMax() const
         unsigned int getNP()
+        LocalDescriptorOutput getOutput() const
+        bool isInvariant() const
+        bool isPerBond() const
+        size_t getNumRows() const
         void computeNList(const box.Box&, const vec3[float]*, unsigned int,
                           const vec3[float]*, unsigned int) nogil except +
         void compute(const box.Box&, unsigned int, const vec3[float]*,
                      unsigned int, const vec3[float]*, unsigned int,
-                     const quat[float]*, LocalDescriptorOrientation) nogil except +
+                     const quat[float]*, LocalDescriptorOrientation,
+                     const locality.NeighborList*) nogil except +
         shared_array[float complex] getSph()
+        shared_array[float] getRealSph()
+        shared_array[unsigned short] getHalfSph()
+        shared_array[float] getInvariants()
 
 cdef extern from "TransOrderParameter.h" namespace "freud::order":
     cdef cppclass TransOrderParameter:
@@ -96,13 +117,29 @@ cdef extern from "TransOrderParameter.h" namespace "freud::order":
         shared_array[float complex] getDr()
         unsigned int getNP()
 
+cdef extern from "HexTransOrderParameter.h" namespace "freud::order":
+    cdef cppclass HexTransOrderParameter:
+        HexTransOrderParameter(float, const vector[unsigned int]&, unsigned int) except +
+        const box.Box &getBox() const
+        unsigned int getNumK() const
+        const vector[unsigned int]& getKValues() const
+        unsigned int getNumNeighbors() const
+        void compute(box.Box &,
+                     const vec3[float]*,
+                     unsigned int) nogil except +
+        shared_ptr[float complex] getPsi()
+        shared_ptr[float complex] getDr()
+        unsigned int getNP()
+
 cdef extern from "LocalQl.h" namespace "freud::order":
-    cdef cppclass LocalQl:
+    cdef cppclass LocalQl(locality.PairAnalysis):
         LocalQl(const box.Box&, float, unsigned int, float)
         const box.Box& getBox() const
         void setBox(const box.Box)
         void compute(const vec3[float]*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*,
+                     bool) nogil except +
         void computeAve(const vec3[float]*,
                         unsigned int) nogil except +
         void computeNorm(const vec3[float]*,
@@ -122,7 +159,9 @@ cdef extern from "LocalQlNear.h" namespace "freud::order":
         const box.Box& getBox() const
         void setBox(const box.Box)
         void compute(const vec3[float]*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*,
+                     bool) nogil except +
         void computeAve(const vec3[float]*,
                         unsigned int) nogil except +
         void computeNorm(const vec3[float]*,
@@ -141,7 +180,9 @@ cdef extern from "LocalWl.h" namespace "freud::order":
         const box.Box& getBox() const
         void setBox(const box.Box)
         void compute(const vec3[float]*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*,
+                     bool) nogil except +
         void computeAve(const vec3[float]*,
                         unsigned int) nogil except +
         void computeNorm(const vec3[float]*,
@@ -163,7 +204,9 @@ cdef extern from "LocalWlNear.h" namespace "freud::order":
         const box.Box& getBox() const
         void setBox(const box.Box)
         void compute(const vec3[float]*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*,
+                     bool) nogil except +
         void computeAve(const vec3[float]*,
                         unsigned int) nogil except +
         void computeNorm(const vec3[float]*,
@@ -179,6 +222,24 @@ cdef extern from "LocalWlNear.h" namespace "freud::order":
         void disableNormalization()
         unsigned int getNP()
 
+cdef extern from "Steinhardt.h" namespace "freud::order":
+    cdef cppclass Steinhardt:
+        Steinhardt(const box.Box&, float, const vector[unsigned int]&, float) except +
+        const box.Box& getBox() const
+        void setBox(const box.Box)
+        unsigned int getNumL() const
+        const vector[unsigned int]& getLValues() const
+        void compute(const vec3[float]*,
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
+        shared_ptr[float] getQl()
+        shared_ptr[float] getAveQl()
+        shared_ptr[float complex] getWl()
+        shared_ptr[float complex] getAveWl()
+        void enableNormalization()
+        void disableNormalization()
+        unsigned int getNP()
+
 cdef extern from "SolLiq.h" namespace "freud::order":
     cdef cppclass SolLiq:
         SolLiq(const box.Box&, float, float, unsigned int, unsigned int)
@@ -221,6 +282,13 @@ cdef extern from "MatchEnv.h" namespace "freud::order":
                         const vec3[float]*,
                         unsigned int,
                         bool) nogil except +
+        vector[unsigned int] matchMotifs(const vec3[float]*,
+                        unsigned int,
+                        const vec3[float]*,
+                        unsigned int,
+                        unsigned int,
+                        float,
+                        bool) nogil except +
         map[unsigned int, unsigned int] isSimilar(const vec3[float]*,
                                         vec3[float]*,
                                         unsigned int,
@@ -238,6 +306,8 @@ cdef extern from "MatchEnv.h" namespace "freud::order":
         unsigned int getNumClusters()
         unsigned int getNumNeighbors()
         unsigned int getMaxNumNeighbors()
+        void setAcceleratedRegistration(bool)
+        bool getAcceleratedRegistration() const
 
 cdef extern from "SolLiqNear.h" namespace "freud::order":
     cdef cppclass SolLiqNear:
@@ -270,7 +340,8 @@ cdef extern from "Pairing2D.h" namespace "freud::order":
                      float*,
                      float*,
                      unsigned int,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
         shared_array[unsigned int] getMatch()
         shared_array[unsigned int] getPair()
         unsigned int getNumParticles()
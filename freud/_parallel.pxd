@@ -1,5 +1,30 @@
 # Copyright (c) 2010-2016 The Regents of the University of Michigan
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from freud.util._VectorMath cimport vec3
+cimport freud._box as box
+
 cdef extern from "tbb_config.h" namespace "freud::parallel":
     void setNumThreads(unsigned int)
+    vector[int] getNumaNodes()
+
+    cdef cppclass ThreadArena:
+        ThreadArena(unsigned int, int) except +
+        unsigned int getNumThreads()
+        int getNumaNode() const
+        void execute(void (*)(void*), void*) nogil
+
+cdef extern from "FramePipeline.h" namespace "freud::parallel":
+    ctypedef void (*FrameAnalysis)(void*, const box.Box&, const vec3[float]*, unsigned int, unsigned int)
+
+    cdef cppclass FramePipeline:
+        FramePipeline(const string&, unsigned int, size_t, unsigned int) except +
+        unsigned int getNumFrames() const
+        unsigned int getNP() const
+        unsigned int getMaxInFlight() const
+        void addAnalysis(FrameAnalysis, void*)
+        void clearAnalyses()
+        unsigned int run(const box.Box&, unsigned int, unsigned int, unsigned int) nogil except +
+        void stop()
@@ -3,8 +3,13 @@
 
 from freud.util._VectorMath cimport vec3
 from freud.util._VectorMath cimport quat
+from freud.util._BinCount cimport BinCount
+from freud.util._MemoryUsage cimport MemoryUsage
 from libcpp.memory cimport shared_ptr
+from libcpp cimport bool
+from libcpp.string cimport string
 cimport freud._box as box
+cimport freud._locality as locality
 
 cdef extern from "PMFTR12.h" namespace "freud::pmft":
     cdef cppclass PMFTR12:
@@ -18,10 +23,26 @@ cdef extern from "PMFTR12.h" namespace "freud::pmft":
                         unsigned int,
                         vec3[float]*,
                         float*,
-                        unsigned int) nogil
-        void reducePCF()
-        shared_ptr[unsigned int] getBinCounts()
+                        unsigned int,
+                        const locality.NeighborList*,
+                        const float*,
+                        const float*) nogil except +
+        void accumulateFrames(const box.Box*,
+                              vec3[float]*,
+                              float*,
+                              unsigned int,
+                              vec3[float]*,
+                              float*,
+                              unsigned int,
+                              unsigned int) nogil except +
+        void reducePCF() nogil
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const PMFTR12&) except +
+        shared_ptr[BinCount] getBinCounts()
         shared_ptr[float] getPCF()
+        shared_ptr[float] getPMFT()
+        shared_ptr[float] getWeightedPCF()
         shared_ptr[float] getR()
         shared_ptr[float] getT1()
         shared_ptr[float] getT2()
@@ -30,6 +51,18 @@ cdef extern from "PMFTR12.h" namespace "freud::pmft":
         unsigned int getNBinsT1()
         unsigned int getNBinsT2()
         float getRCut()
+        void setPartitionMode(locality.PartitionMode)
+        locality.PartitionMode getPartitionMode() const
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
+        void setAtomicHistogram(bool)
+        bool getAtomicHistogram() const
+        bool getSparse()
+        void setMemoryLimit(size_t)
+        size_t getMemoryLimit() const
+        MemoryUsage getMemoryUsage() const
+        MemoryUsage estimateMemory(unsigned int, unsigned int) const
 
 cdef extern from "PMFTXYT.h" namespace "freud::pmft":
     cdef cppclass PMFTXYT:
@@ -43,10 +76,26 @@ cdef extern from "PMFTXYT.h" namespace "freud::pmft":
                         unsigned int,
                         vec3[float]*,
                         float*,
-                        unsigned int) nogil
-        void reducePCF()
-        shared_ptr[unsigned int] getBinCounts()
+                        unsigned int,
+                        const locality.NeighborList*,
+                        const float*,
+                        const float*) nogil except +
+        void accumulateFrames(const box.Box*,
+                              vec3[float]*,
+                              float*,
+                              unsigned int,
+                              vec3[float]*,
+                              float*,
+                              unsigned int,
+                              unsigned int) nogil except +
+        void reducePCF() nogil
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const PMFTXYT&) except +
+        shared_ptr[BinCount] getBinCounts()
         shared_ptr[float] getPCF()
+        shared_ptr[float] getPMFT()
+        shared_ptr[float] getWeightedPCF()
         shared_ptr[float] getX()
         shared_ptr[float] getY()
         shared_ptr[float] getT()
@@ -55,6 +104,18 @@ cdef extern from "PMFTXYT.h" namespace "freud::pmft":
         unsigned int getNBinsY()
         unsigned int getNBinsT()
         float getRCut()
+        void setPartitionMode(locality.PartitionMode)
+        locality.PartitionMode getPartitionMode() const
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
+        void setAtomicHistogram(bool)
+        bool getAtomicHistogram() const
+        bool getSparse()
+        void setMemoryLimit(size_t)
+        size_t getMemoryLimit() const
+        MemoryUsage getMemoryUsage() const
+        MemoryUsage estimateMemory(unsigned int, unsigned int) const
 
 cdef extern from "PMFTXY2D.h" namespace "freud::pmft":
     cdef cppclass PMFTXY2D:
@@ -68,20 +129,50 @@ cdef extern from "PMFTXY2D.h" namespace "freud::pmft":
                         unsigned int,
                         vec3[float]*,
                         float*,
-                        unsigned int) nogil
-        void reducePCF()
-        shared_ptr[unsigned int] getBinCounts()
+                        unsigned int,
+                        const locality.NeighborList*,
+                        const float*,
+                        const float*) nogil except +
+        void accumulateFrames(const box.Box*,
+                              vec3[float]*,
+                              float*,
+                              unsigned int,
+                              vec3[float]*,
+                              float*,
+                              unsigned int,
+                              unsigned int) nogil except +
+        void reducePCF() nogil
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const PMFTXY2D&) except +
+        shared_ptr[BinCount] getBinCounts()
         shared_ptr[float] getPCF()
+        shared_ptr[float] getPMFT()
+        shared_ptr[float] getWeightedPCF()
         shared_ptr[float] getX()
         shared_ptr[float] getY()
         float getJacobian()
         unsigned int getNBinsX()
         unsigned int getNBinsY()
         float getRCut()
+        void setPartitionMode(locality.PartitionMode)
+        locality.PartitionMode getPartitionMode() const
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
+        void setAtomicHistogram(bool)
+        bool getAtomicHistogram() const
+        bool getSparse()
+        void setMemoryLimit(size_t)
+        size_t getMemoryLimit() const
+        MemoryUsage getMemoryUsage() const
+        MemoryUsage estimateMemory(unsigned int, unsigned int) const
+        void setUseGPU(bool) except +
+        bool getUseGPU() const
 
 cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
     cdef cppclass PMFTXYZ:
-        PMFTXYZ(float, float, float, unsigned int, unsigned int, unsigned int, vec3[float])
+        PMFTXYZ(float, float, float, unsigned int, unsigned int, unsigned int, vec3[float], bool)
 
         const box.Box& getBox() const
         void resetPCF()
@@ -93,10 +184,40 @@ cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
                         quat[float]*,
                         unsigned int,
                         quat[float]*,
-                        unsigned int) nogil
-        void reducePCF()
+                        unsigned int,
+                        const locality.NeighborList*,
+                        const float*,
+                        const float*) nogil except +
+        void accumulateSharedFaces(box.Box&,
+                                   vec3[float]*,
+                                   quat[float]*,
+                                   unsigned int,
+                                   vec3[float]*,
+                                   quat[float]*,
+                                   unsigned int,
+                                   quat[float]*,
+                                   unsigned int,
+                                   const locality.NeighborList*,
+                                   const float*,
+                                   const float*) nogil except +
+        void accumulateFrames(const box.Box*,
+                              vec3[float]*,
+                              quat[float]*,
+                              unsigned int,
+                              vec3[float]*,
+                              quat[float]*,
+                              unsigned int,
+                              quat[float]*,
+                              unsigned int,
+                              unsigned int) nogil except +
+        void reducePCF() nogil
+        void saveState(const string&) nogil except +
+        void loadState(const string&, bool) nogil except +
+        void merge(const PMFTXYZ&) except +
         shared_ptr[float] getPCF()
-        shared_ptr[unsigned int] getBinCounts()
+        shared_ptr[float] getPMFT()
+        shared_ptr[float] getWeightedPCF()
+        shared_ptr[BinCount] getBinCounts()
         shared_ptr[float] getX()
         shared_ptr[float] getY()
         shared_ptr[float] getZ()
@@ -105,3 +226,18 @@ cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
         unsigned int getNBinsY()
         unsigned int getNBinsZ()
         float getRCut()
+        void setPartitionMode(locality.PartitionMode)
+        locality.PartitionMode getPartitionMode() const
+        void setCellOrder(bool)
+        void setLinkCell(shared_ptr[locality.LinkCell]) except +
+        bool getCellOrder() const
+        void setAtomicHistogram(bool)
+        bool getAtomicHistogram() const
+        bool getSparse()
+        void setMemoryLimit(size_t)
+        size_t getMemoryLimit() const
+        MemoryUsage getMemoryUsage() const
+        MemoryUsage estimateMemory(unsigned int, unsigned int) const
+        void setUseGPU(bool) except +
+        bool getUseGPU() const
+        bool getFold()
@@ -0,0 +1,15 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from libcpp cimport bool
+from freud.util._VectorMath cimport vec3
+from freud.util._Boost cimport shared_array
+
+cdef extern from "BatchKabsch.h" namespace "freud::registration":
+    cdef cppclass BatchKabsch:
+        BatchKabsch()
+        void compute(const vec3[float]*, const vec3[float]*, unsigned int, unsigned int, bool) nogil except +
+        unsigned int getNumSets()
+        unsigned int getNumPoints()
+        shared_array[float] getRotations()
+        shared_array[float] getRMSDs()
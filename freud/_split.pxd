@@ -0,0 +1,20 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from freud.util._VectorMath cimport vec3, quat
+from freud.util._Boost cimport shared_array
+cimport freud._box as box
+
+cdef extern from "shapesplit.h" namespace "freud::shapesplit":
+    cdef cppclass ShapeSplit:
+        ShapeSplit(const box.Box&)
+        const box.Box& getBox() const
+        void updateBox(const box.Box&)
+        void compute(const vec3[float]*, unsigned int, const quat[float]*, const vec3[float]*,
+                     unsigned int) nogil except +
+        void computeInto(const vec3[float]*, unsigned int, const quat[float]*, const vec3[float]*, unsigned int,
+                         vec3[float]*, quat[float]*) nogil except +
+        shared_array[float] getShapeSplit()
+        shared_array[float] getShapeOrientations()
+        unsigned int getNpoints() const
+        unsigned int getNsplit() const
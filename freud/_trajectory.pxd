@@ -0,0 +1,19 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from libcpp cimport bool
+from libcpp.string cimport string
+from freud.util._VectorMath cimport vec3
+cimport freud._box as box
+
+cdef extern from "DCDReader.h" namespace "freud::trajectory":
+    cdef cppclass DCDReader:
+        DCDReader(const string&) except +
+        unsigned int getNumFrames() const
+        unsigned int getNP() const
+        bool hasUnitCell() const
+        const float *getX(unsigned int) except +
+        const float *getY(unsigned int) except +
+        const float *getZ(unsigned int) except +
+        box.Box getBox(unsigned int) except +
+        void getPositions(unsigned int, vec3[float]*) nogil except +
@@ -2,13 +2,35 @@
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
 from freud.util._Boost cimport shared_ptr
+from freud.util._Boost cimport shared_array
+from freud.util._VectorMath cimport vec3
 from freud.util._cudaTypes cimport float3
 cimport freud._box as box
+cimport freud._locality as locality
 from libcpp.vector cimport vector
 
 cdef extern from "VoronoiBuffer.h" namespace "freud::voronoi":
     cdef cppclass VoronoiBuffer:
         VoronoiBuffer(const box.Box&)
         const box.Box &getBox() const
+        void compute(const vec3[float]*, const unsigned int, const float) nogil except +
         void compute(const float3*, const unsigned int, const float) nogil except +
         shared_ptr[vector[float3]] getBufferParticles()
+        const vec3[float] *getBufferPoints() const
+        unsigned int getNumBufferParticles() const
+
+cdef extern from "VoronoiCells.h" namespace "freud::voronoi":
+    cdef cppclass VoronoiCells:
+        VoronoiCells(float) except +
+        float getSkin() const
+        const box.Box &getBox() const
+        unsigned int getNP() const
+        void compute(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        void update(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        unsigned int getNumRecomputed() const
+        shared_array[float] getVolumes()
+        shared_array[float] getSurfaceAreas()
+        shared_array[float] getFaceAreas()
+        locality.NeighborList *getNlist()
+        void computeShells(unsigned int) nogil except +
+        locality.NeighborList *getShellNlist()
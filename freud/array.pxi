@@ -0,0 +1,59 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from libc.string cimport memcpy
+import numpy as np
+cimport numpy as np
+# Numpy must be initialized. When using numpy from C or Cython you must
+# _always_ do that, or you will have segfaults
+np.import_array()
+
+cdef object result_array(owner, int nd, np.npy_intp *dims, int typenum, void *data, out=None):
+    """Return the C++ array at data, copied into out, or else as a numpy view that keeps owner alive
+
+    The view shares the memory of the C++ object, so it shows the results of the next reduce as well; it stays valid
+    after the Python object is deleted, as long as the array itself is not replaced. The histogram classes allocate
+    their arrays once, in their constructors. out must be a writeable C-contiguous array of the shape and dtype of the
+    result, which is copied into it so that it can be reused from frame to frame; out is returned.
+    """
+    cdef np.ndarray view = np.PyArray_SimpleNewFromData(nd, dims, typenum, data)
+    if out is None:
+        np.set_array_base(view, owner)
+        return view
+    if (not isinstance(out, np.ndarray) or out.dtype != view.dtype or out.shape != view.shape or
+            not out.flags.c_contiguous or not out.flags.writeable):
+        raise ValueError('out must be a writeable C-contiguous array of shape {} and dtype {}'.format(
+            view.shape, view.dtype))
+    cdef np.ndarray l_out = out
+    memcpy(l_out.data, data, view.nbytes)
+    return out
+
+cdef object pair_weights(ref_weights, weights, unsigned int n_ref, unsigned int n_p):
+    """Convert the weights of the reference points and of the points of a weighted accumulate to float32 arrays, or
+    return (None, None) when neither is given
+
+    Both must be given together. The same object given twice is converted once, so that the C++ code sees that the
+    weights are those of a set of points with itself.
+    """
+    if (ref_weights is None) != (weights is None):
+        raise ValueError("ref_weights and weights must be given together")
+    if weights is None:
+        return None, None
+    same_weights = weights is ref_weights
+    ref_weights = freud.common.convert_array(ref_weights, 1, dtype=np.float32, contiguous=True,
+        dim_message="ref_weights must be a 1 dimensional array")
+    if same_weights:
+        weights = ref_weights
+    else:
+        weights = freud.common.convert_array(weights, 1, dtype=np.float32, contiguous=True,
+            dim_message="weights must be a 1 dimensional array")
+    if ref_weights.shape[0] != n_ref or weights.shape[0] != n_p:
+        raise ValueError("there must be one weight per reference point and per point")
+    return ref_weights, weights
+
+cdef const float *weights_data(weights):
+    """Return the data of an array of pair_weights(), or NULL for None"""
+    if weights is None:
+        return NULL
+    cdef np.ndarray l_weights = weights
+    return <const float*>l_weights.data
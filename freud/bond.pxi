@@ -4,8 +4,10 @@
 from freud.util._VectorMath cimport vec3
 from freud.util._VectorMath cimport quat
 cimport freud._box as _box
+cimport freud._locality as locality
 cimport freud._bond as bond
 from libcpp.map cimport map
+from libcpp.memory cimport shared_ptr
 import numpy as np
 cimport numpy as np
 
@@ -73,32 +75,87 @@ cdef class BondingAnalysis:
         with nogil:
             self.thisptr.compute(<unsigned int*> l_frame_0.data, <unsigned int*> l_frame_1.data)
 
+    def update(self, frame_1):
+        """
+        Calculates the changes in bonding states from the last frame to the next, without passing the last frame again.
+
+        The last frame is the frame_1 of the previous :py:meth:`update` or :py:meth:`compute`, or the frame_0 of
+        :py:meth:`initialize`; it is kept sorted, so only frame_1 is read and sorted.
+
+        :param frame_1: next/current bonding frame (as output from :py:class:`.BondingR12` modules)
+        :type frame_1: :class:`numpy.ndarray` shape=(:math:`N_{particles}`, :math:`N_{bonds}`), dtype= :class:`numpy.uint32`
+        """
+        frame_1 = freud.common.convert_array(frame_1, 2, dtype=np.uint32, contiguous=True,
+            dim_message="frame_1 must be a 2 dimensional array")
+        if (frame_1.shape[0] != self.num_particles):
+            raise ValueError("the 1st dimension must match num_particles: {}".format(self.num_particles))
+        if (frame_1.shape[1] != self.num_bonds):
+            raise ValueError("the 2nd dimension must match num_bonds: {}".format(self.num_bonds))
+        cdef np.ndarray[uint, ndim=2] l_frame_1 = frame_1
+        with nogil:
+            self.thisptr.update(<unsigned int*> l_frame_1.data)
+
     def getBondLifetimes(self):
         """
-        :return: lifetime of bonds
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, varying), dtype= :class:`numpy.uint32`
+        :return: lifetime of the broken bonds of each bond index, in increasing order
+        :rtype: list of :math:`N_{bonds}` lists
         """
         bonds = self.thisptr.getBondLifetimes()
         return bonds
 
     def getOverallLifetimes(self):
         """
-        :return: lifetime of bonds
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, varying), dtype= :class:`numpy.uint32`
+        :return: lifetime of the broken bonds, whatever their bond index, in increasing order
+        :rtype: :class:`numpy.ndarray`, shape=(varying), dtype= :class:`numpy.uint32`
         """
         bonds = self.thisptr.getOverallLifetimes()
         ret_bonds = np.copy(np.asarray(bonds, dtype=np.uint32))
         return ret_bonds
 
+    def getBondLifetimeHistogram(self):
+        """
+        Get the number of broken bonds of each bond index by lifetime, in frames
+
+        :return: histogram of the bond lifetimes
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bonds}`, :math:`N_{frames}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int num_lifetimes = self.thisptr.getNumLifetimes()
+        # the histogram is built by the call, hold it until it is copied
+        cdef shared_ptr[unsigned int] hist_ptr = self.thisptr.getBondLifetimeHistogram()
+        cdef unsigned int *hist = hist_ptr.get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.num_bonds
+        nbins[1] = <np.npy_intp>num_lifetimes
+        cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32,<void*>hist)
+        return np.copy(result)
+
+    def getOverallLifetimeHistogram(self):
+        """
+        Get the number of broken bonds by lifetime, in frames
+
+        :return: histogram of the overall lifetimes
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int num_lifetimes = self.thisptr.getNumLifetimes()
+        # the histogram is built by the call, hold it until it is copied
+        cdef shared_ptr[unsigned int] hist_ptr = self.thisptr.getOverallLifetimeHistogram()
+        cdef unsigned int *hist = hist_ptr.get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>num_lifetimes
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32,<void*>hist)
+        return np.copy(result)
+
     def getTransitionMatrix(self):
         """
+        Get the number of transitions of each (bond in frame_1, bond in frame_0); index :math:`N_{bonds}` means unbound
+
         :return: transition matrix
-        :rtype: :class:`numpy.ndarray`
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bonds}+1`, :math:`N_{bonds}+1`), dtype= :class:`numpy.uint32`
         """
         cdef unsigned int *trans_matrix = self.thisptr.getTransitionMatrix().get()
         cdef np.npy_intp nbins[2]
-        nbins[0] = <np.npy_intp>self.num_bonds
-        nbins[1] = <np.npy_intp>self.num_bonds
+        nbins[0] = <np.npy_intp>self.num_bonds + 1
+        nbins[1] = <np.npy_intp>self.num_bonds + 1
         cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32,<void*>trans_matrix)
         return result
 
@@ -159,7 +216,7 @@ cdef class BondingR12:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -168,11 +225,13 @@ cdef class BondingR12:
         :param ref_orientations: orientations as angles to use in computation
         :param points: points to calculate the bonding
         :param orientations: orientations as angles to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:meth:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -196,11 +255,11 @@ cdef class BondingR12:
         cdef np.ndarray[float, ndim=1] l_orientations = orientations
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
         with nogil:
             self.thisptr.compute(l_box, <vec3[float]*> l_ref_points.data, <float*> l_ref_orientations.data, n_ref,
-                <vec3[float]*> l_points.data, <float*> l_orientations.data, n_p)
+                <vec3[float]*> l_points.data, <float*> l_orientations.data, n_p, cNlist)
 
     def getBonds(self):
         """
@@ -214,6 +273,37 @@ cdef class BondingR12:
         cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32,<void*>bonds)
         return result
 
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
     def getBox(self):
         """
         Get the box used in the calculation
@@ -278,7 +368,7 @@ cdef class BondingXY2D:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -287,11 +377,13 @@ cdef class BondingXY2D:
         :param ref_orientations: orientations as angles to use in computation
         :param points: points to calculate the bonding
         :param orientations: orientations as angles to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:meth:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -315,11 +407,11 @@ cdef class BondingXY2D:
         cdef np.ndarray[float, ndim=1] l_orientations = orientations
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
         with nogil:
             self.thisptr.compute(l_box, <vec3[float]*> l_ref_points.data, <float*> l_ref_orientations.data, n_ref,
-                <vec3[float]*> l_points.data, <float*> l_orientations.data, n_p)
+                <vec3[float]*> l_points.data, <float*> l_orientations.data, n_p, cNlist)
 
     def getBonds(self):
         """
@@ -333,6 +425,37 @@ cdef class BondingXY2D:
         cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32,<void*>bonds)
         return result
 
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
     def getBox(self):
         """
         Get the box used in the calculation
@@ -398,7 +521,7 @@ cdef class BondingXYT:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -407,11 +530,13 @@ cdef class BondingXYT:
         :param ref_orientations: orientations as angles to use in computation
         :param points: points to calculate the bonding
         :param orientations: orientations as angles to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:meth:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -435,11 +560,11 @@ cdef class BondingXYT:
         cdef np.ndarray[float, ndim=1] l_orientations = orientations
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
         with nogil:
             self.thisptr.compute(l_box, <vec3[float]*> l_ref_points.data, <float*> l_ref_orientations.data, n_ref,
-                <vec3[float]*> l_points.data, <float*> l_orientations.data, n_p)
+                <vec3[float]*> l_points.data, <float*> l_orientations.data, n_p, cNlist)
 
     def getBonds(self):
         """
@@ -453,6 +578,37 @@ cdef class BondingXYT:
         cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32,<void*>bonds)
         return result
 
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
     def getBox(self):
         """
         Get the box used in the calculation
@@ -520,7 +676,7 @@ cdef class BondingXYZ:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -529,11 +685,13 @@ cdef class BondingXYZ:
         :param ref_orientations: orientations as quaternions to use in computation
         :param points: points to calculate the bonding
         :param orientations: orientations as quaternions to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:meth:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 4), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 4), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -561,11 +719,11 @@ cdef class BondingXYZ:
         cdef np.ndarray[float, ndim=2] l_orientations = orientations
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
         with nogil:
             self.thisptr.compute(l_box, <vec3[float]*> l_ref_points.data, <quat[float]*> l_ref_orientations.data, n_ref,
-                <vec3[float]*> l_points.data, <quat[float]*> l_orientations.data, n_p)
+                <vec3[float]*> l_points.data, <quat[float]*> l_orientations.data, n_p, cNlist)
 
     def getBonds(self):
         """
@@ -579,6 +737,37 @@ cdef class BondingXYZ:
         cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32,<void*>bonds)
         return result
 
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
     def getBox(self):
         """
         Get the box used in the calculation
@@ -3,11 +3,13 @@
 
 import warnings
 from freud.util._VectorMath cimport vec3
+from freud.util._cudaTypes cimport uchar3
 cimport freud._box as box
 import numpy as np
 cimport numpy as np
 from libcpp.string cimport string
 from libc.string cimport memcpy
+from cython.operator cimport dereference
 # Numpy must be initialized. When using numpy from C or Cython you must
 # _always_ do that, or you will have segfaults
 np.import_array()
@@ -136,6 +138,32 @@ cdef class Box:
         """
         return self.thisptr.is2D()
 
+    def setPeriodic(self, x, y, z):
+        """
+        Set whether the box is periodic along each direction. The minimum image convention and the cell lists of
+        :py:class:`freud.locality.LinkCell` only wrap around the periodic directions.
+
+        :param x: True if periodic along the first lattice vector
+        :param y: True if periodic along the second lattice vector
+        :param z: True if periodic along the third lattice vector
+        :type x: bool
+        :type y: bool
+        :type z: bool
+        """
+        cdef uchar3 periodic
+        periodic.x = bool(x)
+        periodic.y = bool(y)
+        periodic.z = bool(z)
+        self.thisptr.setPeriodic(periodic)
+
+    def getPeriodic(self):
+        """
+        :return: whether the box is periodic along each direction
+        :rtype: list of bool
+        """
+        cdef uchar3 periodic = self.thisptr.getPeriodic()
+        return [bool(periodic.x), bool(periodic.y), bool(periodic.z)]
+
     def getLx(self):
         """
         return the length of the x-dimension of the box
@@ -235,12 +263,15 @@ cdef class Box:
         cdef float[3] result = [resultVec.x, resultVec.y, resultVec.z]
         return result
 
-    def wrap(self, vecs):
+    def wrap(self, vecs, imgs=None):
         """
         Wrap a given array of vectors back into the box from python
 
         :param vecs: numpy array of vectors (Nx3) (or just 3 elements) to wrap
-        :note: vecs returned in place (nothing returned)
+        :param imgs: numpy array of images (Nx3) of the vectors, updated with the lattice vectors removed from them
+        :type vecs: :class:`numpy.ndarray`, shape=(:math:`N_{vecs}`, 3), dtype= :class:`numpy.float32`
+        :type imgs: :class:`numpy.ndarray`, shape=(:math:`N_{vecs}`, 3), dtype= :class:`numpy.int32`
+        :note: vecs (and imgs) returned in place (nothing returned)
         """
         if vecs.dtype != np.float32:
             raise ValueError("vecs must be a numpy float32 array")
@@ -251,8 +282,7 @@ cdef class Box:
             # check to make sure the second dim is x, y, z
             if vecs.shape[1] != 3:
                 raise ValueError("the 2nd dimension must have 3 values: x, y, z")
-            for i, vec in enumerate(vecs):
-                vecs[i] = self._wrap(vec)
+            self._wrapArray(vecs, imgs)
         else:
             raise ValueError("Invalid dimensions given to box wrap. Wrap requires a 3 element array (3,), or (N,3) array as input");
 
@@ -261,6 +291,26 @@ cdef class Box:
         cdef vec3[float] result = self.thisptr.wrapMultiple(<vec3[float]&>l_vec[0])
         return (result.x, result.y, result.z)
 
+    def _wrapArray(self, vecs, imgs):
+        cdef np.ndarray[float, ndim=2] l_vecs = np.ascontiguousarray(vecs)
+        cdef np.ndarray[int, ndim=2] l_imgs
+        cdef unsigned int Np = l_vecs.shape[0]
+        if imgs is None:
+            with nogil:
+                self.thisptr.wrap(<vec3[float]*>l_vecs.data, Np)
+        else:
+            if imgs.dtype != np.int32:
+                raise ValueError("imgs must be a numpy int32 array")
+            if imgs.shape != vecs.shape:
+                raise ValueError("imgs must have the same shape as vecs")
+            l_imgs = np.ascontiguousarray(imgs)
+            with nogil:
+                self.thisptr.wrap(<vec3[float]*>l_vecs.data, <vec3[int]*>l_imgs.data, Np)
+            if l_imgs is not imgs:
+                imgs[:] = l_imgs
+        if l_vecs is not vecs:
+            vecs[:] = l_vecs
+
     def unwrap(self, vecs, imgs):
         """
         Wrap a given array of vectors back into the box from python
@@ -284,9 +334,8 @@ cdef class Box:
             # check to make sure the second dim is x, y, z
             if vecs.shape[1] != 3:
                 raise ValueError("the 2nd dimension must have 3 values: x, y, z")
-            if len(imgs.shape) == 2:
-                for i, (vec, img) in enumerate(zip(vecs, imgs)):
-                    vecs[i] = self._unwrap(vec, img)
+            if imgs.shape == vecs.shape:
+                self._unwrapArray(vecs, imgs)
             else:
                 raise RuntimeError("imgs do not match vectors")
 
@@ -296,28 +345,61 @@ cdef class Box:
         cdef vec3[float] result = self.thisptr.unwrap(<vec3[float]&>l_vec[0], <vec3[int]&>l_img[0])
         return [result.x, result.y, result.z]
 
+    def _unwrapArray(self, vecs, imgs):
+        cdef np.ndarray[float, ndim=2] l_vecs = np.ascontiguousarray(vecs)
+        cdef np.ndarray[int, ndim=2] l_imgs = np.ascontiguousarray(imgs)
+        cdef unsigned int Np = l_vecs.shape[0]
+        with nogil:
+            self.thisptr.unwrap(<vec3[float]*>l_vecs.data, <vec3[int]*>l_imgs.data, Np)
+        if l_vecs is not vecs:
+            vecs[:] = l_vecs
+
     def makeCoordinates(self, f):
         """
         Convert fractional coordinates into real coordinates
 
-        :param f: Fractional coordinates between 0 and 1 within parallelpipedal box
+        :param f: Fractional coordinates between 0 and 1 within parallelpipedal box, a single vector or an (Nx3) array
         :type f: numpy.ndarray([x, y, z], dtype=numpy.float32)
-        :return: A vector inside the box corresponding to f
-        """
-        cdef np.ndarray[float,ndim=1] l_vec = np.ascontiguousarray(f.flatten())
-        cdef vec3[float] result = self.thisptr.makeCoordinates(<const vec3[float]&>l_vec[0])
+        :return: A vector inside the box corresponding to f, or an (Nx3) array for an array of vectors
+        """
+        cdef np.ndarray[float, ndim=2] l_vecs
+        cdef np.ndarray[float, ndim=1] l_vec
+        cdef vec3[float] result
+        cdef unsigned int Np
+        if len(np.shape(f)) == 2:
+            l_vecs = np.array(f, dtype=np.float32, order='C')
+            if l_vecs.shape[1] != 3:
+                raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+            Np = l_vecs.shape[0]
+            with nogil:
+                self.thisptr.makeCoordinates(<vec3[float]*>l_vecs.data, Np)
+            return l_vecs
+        l_vec = np.ascontiguousarray(f.flatten())
+        result = self.thisptr.makeCoordinates(<const vec3[float]&>l_vec[0])
         return [result.x, result.y, result.z]
 
     def makeFraction(self, vec):
         """
-        Convert fractional coordinates into real coordinates
+        Convert real coordinates into fractional coordinates
 
-        :param vec: Coordinates within parallelpipedal box
+        :param vec: Coordinates within parallelpipedal box, a single vector or an (Nx3) array
         :type vec: numpy.ndarray([x, y, z], dtype=numpy.float32)
-        :return: Fractional vector inside the box corresponding to f
-        """
-        cdef np.ndarray[float,ndim=1] l_vec = np.ascontiguousarray(vec.flatten())
-        cdef vec3[float] result = self.thisptr.makeFraction(<const vec3[float]&>l_vec[0])
+        :return: Fractional vector inside the box corresponding to vec, or an (Nx3) array for an array of vectors
+        """
+        cdef np.ndarray[float, ndim=2] l_vecs
+        cdef np.ndarray[float, ndim=1] l_vec
+        cdef vec3[float] result
+        cdef unsigned int Np
+        if len(np.shape(vec)) == 2:
+            l_vecs = np.array(vec, dtype=np.float32, order='C')
+            if l_vecs.shape[1] != 3:
+                raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+            Np = l_vecs.shape[0]
+            with nogil:
+                self.thisptr.makeFraction(<vec3[float]*>l_vecs.data, Np)
+            return l_vecs
+        l_vec = np.ascontiguousarray(vec.flatten())
+        result = self.thisptr.makeFraction(<const vec3[float]&>l_vec[0])
         return [result.x, result.y, result.z]
 
     def getLatticeVector(self, i):
@@ -340,6 +422,28 @@ cdef class Box:
         return (self.getLx(), self.getLy(), self.getLz(), self.is2D())
 
 cdef BoxFromCPP(const box.Box& cppbox):
+    """Return a Box holding a copy of a C++ box, periodicity included
+
+    The C++ box is copied as a whole, instead of read through seven getters and built again from them.
     """
+    cdef Box result = Box()
+    result.thisptr[0] = cppbox
+    return result
+
+cdef box.Box cpp_box(b) except *:
+    """Return the C++ box of a Box, read from its getters for other box-like objects
+
+    A :py:class:`freud.box.Box` already holds its C++ box, so the wrappers copy it instead of rebuilding one from
+    seven Python calls on every compute.
     """
-    return Box(cppbox.getLx(), cppbox.getLy(), cppbox.getLz(), cppbox.getTiltFactorXY(), cppbox.getTiltFactorXZ(), cppbox.getTiltFactorYZ(), cppbox.is2D())
+    if isinstance(b, Box):
+        return dereference((<Box> b).thisptr)
+    return box.Box(b.getLx(), b.getLy(), b.getLz(), b.getTiltFactorXY(), b.getTiltFactorXZ(), b.getTiltFactorYZ(),
+                   b.is2D())
+
+cdef tuple box_key(b):
+    """Return a hashable key of the parameters and periodicity of a box, read from its C++ box"""
+    cdef box.Box cBox = cpp_box(b)
+    cdef uchar3 periodic = cBox.getPeriodic()
+    return (cBox.getLx(), cBox.getLy(), cBox.getLz(), cBox.getTiltFactorXY(), cBox.getTiltFactorXZ(),
+            cBox.getTiltFactorYZ(), cBox.is2D(), bool(periodic.x), bool(periodic.y), bool(periodic.z))
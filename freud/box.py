@@ -124,23 +124,47 @@ class Box(_Box):
         For more information and the source for this code,
         see: http://hoomd-blue.readthedocs.io/en/stable/box.html
         """
-        boxMatrix = np.asarray(boxMatrix, dtype=np.float32)
-        v0 = boxMatrix[:, 0]
-        v1 = boxMatrix[:, 1]
-        v2 = boxMatrix[:, 2]
-        Lx = np.sqrt(np.dot(v0, v0))
-        a2x = np.dot(v0, v1) / Lx
-        Ly = np.sqrt(np.dot(v1, v1) - a2x * a2x)
+        return cls.from_matrices(np.asarray(boxMatrix)[np.newaxis], dimensions)[0]
+
+    @classmethod
+    def from_matrices(cls, boxMatrices, dimensions=None):
+        """Initialize one box instance per frame from an array of box matrices, such as the boxes of a trajectory.
+
+        The parameters of all the boxes are derived at once with array operations, as :py:meth:`from_matrix()`
+        derives those of one box.
+
+        :param boxMatrices: box matrices, the lattice vectors of each box being its columns
+        :type boxMatrices: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`, 3, 3)
+        :param dimensions: dimensions of all the boxes, by default 2 for the boxes with Lz = 0 and 3 otherwise
+        :type dimensions: int
+        :return: list of boxes
+        """
+        boxMatrices = np.asarray(boxMatrices, dtype=np.float32)
+        if boxMatrices.ndim != 3 or boxMatrices.shape[1:] != (3, 3):
+            raise ValueError("boxMatrices must have shape (N, 3, 3)")
+        v0 = boxMatrices[:, :, 0]
+        v1 = boxMatrices[:, :, 1]
+        v2 = boxMatrices[:, :, 2]
+        Lx = np.sqrt(np.sum(v0 * v0, axis=1))
+        a2x = np.sum(v0 * v1, axis=1) / Lx
+        Ly = np.sqrt(np.sum(v1 * v1, axis=1) - a2x * a2x)
         xy = a2x / Ly
         v0xv1 = np.cross(v0, v1)
-        v0xv1mag = np.sqrt(np.dot(v0xv1, v0xv1))
-        Lz = np.dot(v2, v0xv1) / v0xv1mag
-        a3x = np.dot(v0, v2) / Lx
-        xz = a3x / Lz
-        yz = (np.dot(v1, v2) - a2x * a3x) / (Ly * Lz)
+        v0xv1mag = np.sqrt(np.sum(v0xv1 * v0xv1, axis=1))
+        Lz = np.sum(v2 * v0xv1, axis=1) / v0xv1mag
+        a3x = np.sum(v0 * v2, axis=1) / Lx
+        # the tilts along z of 2D boxes are 0/0
+        with np.errstate(divide='ignore', invalid='ignore'):
+            xz = np.where(Lz != 0, a3x / Lz, 0)
+            yz = np.where(Lz != 0, (np.sum(v1 * v2, axis=1) - a2x * a3x) / (Ly * Lz), 0)
         if dimensions is None:
-            dimensions = 2 if Lz == 0 else 3
-        return cls(Lx=Lx, Ly=Ly, Lz=Lz, xy=xy, xz=xz, yz=yz, is2D=dimensions == 2)
+            is2D = (Lz == 0).tolist()
+        else:
+            is2D = [dimensions == 2] * len(boxMatrices)
+        return [cls(Lx=params[0], Ly=params[1], Lz=params[2], xy=params[3], xz=params[4], yz=params[5],
+                    is2D=params[6])
+                for params in zip(Lx.tolist(), Ly.tolist(), Lz.tolist(), xy.tolist(), xz.tolist(), yz.tolist(),
+                                  is2D)]
 
     @classmethod
     def cube(cls, L):
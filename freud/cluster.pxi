@@ -4,6 +4,7 @@
 from freud.util._VectorMath cimport vec3
 cimport freud._cluster as cluster
 cimport freud._box as _box
+cimport freud._locality as locality
 import numpy as np
 cimport numpy as np
 import freud.common
@@ -44,8 +45,7 @@ cdef class Cluster:
     cdef cluster.Cluster *thisptr
 
     def __cinit__(self, box, float rcut):
-        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(),
-            box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box cBox = cpp_box(box)
         self.thisptr = new cluster.Cluster(cBox, rcut)
 
     def __dealloc__(self):
@@ -59,27 +59,74 @@ cdef class Cluster:
         """
         return BoxFromCPP(self.thisptr.getBox())
 
-    def computeClusters(self, points):
+    def computeClusters(self, points, nlist=None, track_images=False):
         """Compute the clusters for the given set of points
 
+        With track_images, the image of each particle relative to its cluster and the percolation of each cluster
+        are found during the same merge, and can be accessed with :meth:`~.getClusterImages()`,
+        :meth:`~.getClusterPercolationDim()` and :meth:`~.getClusterPercolationAxes()`. The merge is then serial.
+
         :param points: particle coordinates
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param track_images: whether to find the periodic images and percolation of the clusters
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type track_images: bool
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True)
         if points.shape[1] != 3:
             raise RuntimeError('Need a list of 3D points for computeClusters()')
         cdef np.ndarray cPoints = points
         cdef unsigned int Np = points.shape[0]
+        nlist = cached_nlist(nlist, BoxFromCPP(self.thisptr.getBox()), points, points, self.thisptr.getPairRMax())
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.computeClusters(<vec3[float]*> cPoints.data, Np, cNlist, track_images)
+
+    def computeClustersFromBonds(self, num_points, bonds):
+        """Compute the clusters of the graph of num_points points whose edges are the given bonds, whatever
+        criterion chose them: the bonds of a :py:class:`freud.bond.BondingXYZ`, the faces of a Voronoi
+        tessellation, a threshold on a dot product of Ql... The bonds are merged in parallel by the same disjoint set
+        as :py:meth:`computeClusters()`, and may be given in either direction and repeat. All the bonds of a
+        neighbor list are merged, whatever their distances. The images of the particles are not tracked.
+
+        :param num_points: number of points
+        :param bonds: bonds (i, j) between the points
+        :type num_points: unsigned int
+        :type bonds: :class:`numpy.ndarray`, shape=(:math:`N_{bonds}`, 2), dtype= :class:`numpy.uint32`, or :py:class:`freud.locality.NeighborList`
+        """
+        cdef unsigned int Np = num_points
+        cdef locality.NeighborList *cNlist
+        if isinstance(bonds, NeighborList):
+            cNlist = nlist_ptr(bonds)
+            with nogil:
+                self.thisptr.computeClustersFromNeighborList(Np, cNlist)
+            return
+        bonds = freud.common.convert_array(bonds, 2, dtype=np.uint32, contiguous=False,
+            dim_message="bonds must be a 2 dimensional array")
+        if bonds.shape[1] != 2:
+            raise ValueError("the 2nd dimension of bonds must have 2 values: i, j")
+        cdef np.ndarray[np.uint32_t, ndim=1] l_bond_i = np.ascontiguousarray(bonds[:, 0])
+        cdef np.ndarray[np.uint32_t, ndim=1] l_bond_j = np.ascontiguousarray(bonds[:, 1])
+        cdef size_t n_bonds = bonds.shape[0]
         with nogil:
-            self.thisptr.computeClusters(<vec3[float]*> cPoints.data, Np)
+            self.thisptr.computeClustersFromBonds(Np, <unsigned int*>l_bond_i.data, <unsigned int*>l_bond_j.data,
+                                                  n_bonds)
+
+    def computeClustersAsync(self, *args, **kwargs):
+        """Start :py:meth:`computeClusters()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the clusters are found
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.computeClusters, *args, **kwargs)
 
     def computeClusterMembership(self, keys):
         """Compute the clusters with key membership
 
-        Loops overa all particles and adds them to a list of sets.
-        Each set contains all the keys that are part of that cluster.
+        Finds the keys present in each cluster, sorted and without duplicates.
 
-        Get the computed list with getClusterKeys().
+        Get the computed keys with getClusterKeys() and getClusterKeyOffsets().
 
         :param keys: Membership keys, one for each particle
         :type keys: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
@@ -121,16 +168,81 @@ cdef class Cluster:
         return result
 
     def getClusterKeys(self):
-        """Returns the keys containted in each cluster
+        """Returns the keys contained in each cluster, one cluster after the other
+
+        The keys of cluster c are ``keys[offsets[c]:offsets[c+1]]``, with ``offsets`` from
+        :py:meth:`getClusterKeyOffsets`.
+
+        :return: sorted unique keys of each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{keys}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *cluster_keys_raw = self.thisptr.getClusterKeys().get()
+        cdef np.npy_intp nKeys[1]
+        nKeys[0] = <np.npy_intp>self.thisptr.getNumClusterKeys()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nKeys, np.NPY_UINT32, <void*>cluster_keys_raw)
+        return result
+
+    def getClusterKeyOffsets(self):
+        """Returns the index of the first key of each cluster in :py:meth:`getClusterKeys`
 
-        :return: list of lists of each key containted in clusters
-        :rtype: list
+        :return: offsets of the keys of each cluster, followed by the total number of keys
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}+1`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *offsets_raw = self.thisptr.getClusterKeyOffsets().get()
+        cdef np.npy_intp nOffsets[1]
+        nOffsets[0] = <np.npy_intp>self.thisptr.getNumClusters() + 1
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nOffsets, np.NPY_UINT32, <void*>offsets_raw)
+        return result
+
+    def getClusterImages(self):
+        """Returns the periodic image of each particle relative to the first particle of its cluster
 
-        .. todo: Determine correct way to export. As-is, I do not particularly like how it was previously handled.
+        Unwrapping the particles with these images (see :py:meth:`freud.box.Box.unwrap()`) makes every cluster
+        that does not percolate whole.
+
+        :return: numpy array of images
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.int32`
         """
-        pass
-        # cdef vector[unsigned int] cluster_keys = self.thisptr.getClusterKeys()
-        # return cluster_keys;
+        if not self.thisptr.getTrackImages():
+            raise RuntimeError('computeClusters() must be called with track_images=True')
+        cdef vec3[int] *images_raw = self.thisptr.getClusterImages().get()
+        cdef np.npy_intp nP[2]
+        nP[0] = <np.npy_intp>self.thisptr.getNumParticles()
+        nP[1] = 3
+        cdef np.ndarray[np.int32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nP, np.NPY_INT32, <void*>images_raw)
+        return result
+
+    def getClusterPercolationDim(self):
+        """Returns the number of independent directions along which each cluster wraps around the periodic box
+
+        0 for a finite cluster, 1 for a rod, 2 for a sheet and 3 for a network spanning the whole box.
+
+        :return: numpy array of the percolation dimension of each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`), dtype= :class:`numpy.uint32`
+        """
+        if not self.thisptr.getTrackImages():
+            raise RuntimeError('computeClusters() must be called with track_images=True')
+        cdef unsigned int *dim_raw = self.thisptr.getClusterPercolationDim().get()
+        cdef np.npy_intp nClusters[1]
+        nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_UINT32, <void*>dim_raw)
+        return result
+
+    def getClusterPercolationAxes(self):
+        """Returns the box axes along which each cluster wraps around the periodic box
+
+        Bit 1 is set for x, 2 for y and 4 for z.
+
+        :return: numpy array of the percolation axes of each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`), dtype= :class:`numpy.uint32`
+        """
+        if not self.thisptr.getTrackImages():
+            raise RuntimeError('computeClusters() must be called with track_images=True')
+        cdef unsigned int *axes_raw = self.thisptr.getClusterPercolationAxes().get()
+        cdef np.npy_intp nClusters[1]
+        nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_UINT32, <void*>axes_raw)
+        return result
 
 
 cdef class ClusterProperties:
@@ -141,6 +253,7 @@ cdef class ClusterProperties:
 
      - Center of mass
      - Gyration radius tensor
+     - Size, radius of gyration and asphericity
 
     m_cluster_com stores the computed center of mass for each cluster (properly handling periodic boundary conditions,
     of course) as a :class:`numpy.ndarray`, shape= :math:`\\left(N_{clusters}, 3 \\right)`.
@@ -157,8 +270,7 @@ cdef class ClusterProperties:
     cdef cluster.ClusterProperties *thisptr
 
     def __cinit__(self, box):
-        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(),
-            box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box cBox = cpp_box(box)
         self.thisptr = new cluster.ClusterProperties(cBox)
 
 
@@ -244,3 +356,325 @@ cdef class ClusterProperties:
         nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
         cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_UINT32, <void*>cluster_sizes_raw)
         return result
+
+    def getClusterRg(self):
+        """Returns the cluster radii of gyration computed by the last call to computeProperties
+
+        :return: numpy array of the square root of the trace of the G tensor of each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *cluster_Rg_raw = self.thisptr.getClusterRg().get()
+        cdef np.npy_intp nClusters[1]
+        nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_FLOAT32, <void*>cluster_Rg_raw)
+        return result
+
+    def getClusterAsphericity(self):
+        """Returns the cluster asphericities computed by the last call to computeProperties
+
+        The asphericity is :math:`\\lambda_3 - \\left(\\lambda_1 + \\lambda_2\\right)/2` from the eigenvalues
+        :math:`\\lambda_1 \\le \\lambda_2 \\le \\lambda_3` of the G tensor.
+
+        :return: numpy array of the asphericity of each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *cluster_asphericity_raw = self.thisptr.getClusterAsphericity().get()
+        cdef np.npy_intp nClusters[1]
+        nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_FLOAT32, <void*>cluster_asphericity_raw)
+        return result
+
+cdef class ClusterReduction:
+    """Reduce per particle values over the particles of each cluster
+
+    Given cluster_idx (from :class:`~.Cluster`, or another source) and one or more values per particle (an order
+    parameter, a position, ...), ClusterReduction computes the sum, mean, minimum and maximum of each value over each
+    cluster, and optionally the covariance of the values, in one parallel pass instead of a group by of the particle
+    arrays in Python. :class:`~.ClusterProperties` sorts the particles by cluster the same way.
+
+    The mean, minimum, maximum and covariance of a cluster without particles are NaN.
+
+    :param cluster_idx: Index of which cluster each particle belongs to
+    """
+    cdef cluster.ClusterReduction *thisptr
+    cdef unsigned int values_ndim
+
+    def __cinit__(self):
+        self.thisptr = new cluster.ClusterReduction()
+        self.values_ndim = 1
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, cluster_idx, values, num_clusters=None, covariance=False):
+        """Reduce the values of the particles over each cluster
+
+        :param cluster_idx: Index of which cluster each particle belongs to
+        :param values: Values of each particle
+        :param num_clusters: Number of clusters; the largest index in cluster_idx plus one if None
+        :param covariance: True to compute the covariances of the values of each cluster
+        :type cluster_idx: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`) or \
+                      (:math:`N_{particles}`, :math:`N_{values}`), dtype= :class:`numpy.float32`
+        :type num_clusters: unsigned int
+        :type covariance: bool
+        """
+        cluster_idx = freud.common.convert_array(cluster_idx, 1, dtype=np.uint32, contiguous=True)
+        values = np.asarray(values)
+        self.values_ndim = values.ndim
+        if values.ndim == 1:
+            values = values[:, np.newaxis]
+        values = freud.common.convert_array(values, 2, dtype=np.float32, contiguous=True)
+        if values.shape[0] != cluster_idx.shape[0]:
+            raise RuntimeError('values must have one row per particle of cluster_idx')
+        cdef np.ndarray cCluster_idx = cluster_idx
+        cdef np.ndarray cValues = values
+        cdef unsigned int Np = values.shape[0]
+        cdef unsigned int nValues = values.shape[1]
+        cdef unsigned int nClusters = 0 if num_clusters is None else num_clusters
+        cdef int cCovariance = 1 if covariance else 0
+        with nogil:
+            self.thisptr.compute(<unsigned int*> cCluster_idx.data, Np, <float*> cValues.data, nValues, nClusters,
+                                 cCovariance)
+        return self
+
+    def getNumClusters(self):
+        """
+        :return: number of clusters of the last call to :meth:`~.compute()`
+        :rtype: int
+        """
+        return self.thisptr.getNumClusters()
+
+    def getClusterSizes(self):
+        """
+        :return: number of particles of each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *cluster_sizes_raw = self.thisptr.getClusterSize().get()
+        cdef np.npy_intp nClusters[1]
+        nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_UINT32, <void*>cluster_sizes_raw)
+        return result
+
+    cdef _values(self, float *raw):
+        cdef np.npy_intp shape[2]
+        shape[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        shape[1] = <np.npy_intp>self.thisptr.getNumValues()
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, shape, np.NPY_FLOAT32, <void*>raw)
+        if self.values_ndim == 1:
+            return result[:, 0]
+        return result
+
+    def getSum(self):
+        """
+        :return: sum of each value over each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`) or (:math:`N_{clusters}`, :math:`N_{values}`), \
+                dtype= :class:`numpy.float32`
+        """
+        return self._values(self.thisptr.getSum().get())
+
+    def getMean(self):
+        """
+        :return: mean of each value over each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`) or (:math:`N_{clusters}`, :math:`N_{values}`), \
+                dtype= :class:`numpy.float32`
+        """
+        return self._values(self.thisptr.getMean().get())
+
+    def getMin(self):
+        """
+        :return: minimum of each value over each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`) or (:math:`N_{clusters}`, :math:`N_{values}`), \
+                dtype= :class:`numpy.float32`
+        """
+        return self._values(self.thisptr.getMin().get())
+
+    def getMax(self):
+        """
+        :return: maximum of each value over each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`) or (:math:`N_{clusters}`, :math:`N_{values}`), \
+                dtype= :class:`numpy.float32`
+        """
+        return self._values(self.thisptr.getMax().get())
+
+    def getCovariance(self):
+        """The covariance of the values of each cluster, normalized by the size of the cluster. Only computed when
+        :meth:`~.compute()` is called with covariance=True.
+
+        :return: covariance of the values over each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`, :math:`N_{values}`, :math:`N_{values}`), \
+                dtype= :class:`numpy.float32`
+        """
+        cdef float *covariance_raw = self.thisptr.getCovariance().get()
+        if covariance_raw == NULL:
+            raise RuntimeError('compute with covariance=True to get the covariances')
+        cdef np.npy_intp shape[3]
+        shape[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        shape[1] = <np.npy_intp>self.thisptr.getNumValues()
+        shape[2] = <np.npy_intp>self.thisptr.getNumValues()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, shape, np.NPY_FLOAT32, <void*>covariance_raw)
+        return result
+
+cdef class ClusterTracker:
+    """Follow clusters from frame to frame
+
+    Given the cluster_idx of successive frames (from :class:`~.Cluster`, or another source) for the same particles in
+    the same order, ClusterTracker finds how the clusters of each frame overlap those of the previous frame, and the
+    events between them:
+
+     - :attr:`SPLIT`: a previous cluster overlaps two or more current clusters, one event per current cluster
+     - :attr:`MERGE`: a current cluster overlaps two or more previous clusters, one event per previous cluster
+     - :attr:`DEATH`: a previous cluster overlaps no current cluster
+     - :attr:`BIRTH`: a current cluster overlaps no previous cluster (every cluster of the first frame is born)
+
+    Clusters with fewer than min_size particles are not tracked and count as free particles. Each tracked cluster
+    carries an id that persists over frames: a cluster keeps the id of a previous cluster when each is the other's
+    largest overlap, ties going to the smaller cluster index, and gets a new id otherwise. Untracked clusters have
+    the id :attr:`UNTRACKED`.
+
+    The overlaps are kept sparse, so an update costs about as much as sorting the particles, however many clusters
+    there are.
+
+    :param min_size: smallest number of particles of a tracked cluster
+    :type min_size: unsigned int
+    """
+    cdef cluster.ClusterTracker *thisptr
+
+    BIRTH = 0
+    DEATH = 1
+    MERGE = 2
+    SPLIT = 3
+    UNTRACKED = 0xffffffff
+
+    def __cinit__(self, unsigned int min_size=1):
+        self.thisptr = new cluster.ClusterTracker(min_size)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def reset(self):
+        """Forget the previous frames
+        """
+        self.thisptr.reset()
+
+    def update(self, cluster_idx):
+        """Compare the clusters of a new frame with those of the previous frame
+
+        :param cluster_idx: Index of the cluster of each particle
+        :type cluster_idx: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        """
+        cluster_idx = freud.common.convert_array(cluster_idx, 1, dtype=np.uint32, contiguous=True)
+        cdef np.ndarray cCluster_idx = cluster_idx
+        cdef unsigned int Np = cluster_idx.shape[0]
+        with nogil:
+            self.thisptr.update(<unsigned int *> cCluster_idx.data, Np)
+
+    def getNumFrames(self):
+        """Count the frames given to :meth:`~.update()` since the last :meth:`~.reset()`
+
+        :return: number of frames
+        :rtype: int
+        """
+        return self.thisptr.getNumFrames()
+
+    def getNumClusters(self):
+        """Count the clusters of the last frame
+
+        :return: number of clusters
+        :rtype: int
+        """
+        return self.thisptr.getNumClusters()
+
+    def getClusterSizes(self):
+        """Returns the number of particles of each cluster of the last frame
+
+        :return: numpy array of sizes of each cluster
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *cluster_sizes_raw = self.thisptr.getClusterSize().get()
+        cdef np.npy_intp nClusters[1]
+        nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_UINT32, <void*>cluster_sizes_raw)
+        return result
+
+    def getClusterIds(self):
+        """Returns the persistent id of each cluster of the last frame
+
+        :return: numpy array of ids, :attr:`UNTRACKED` for the clusters that are not tracked
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{clusters}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *cluster_ids_raw = self.thisptr.getClusterIds().get()
+        cdef np.npy_intp nClusters[1]
+        nClusters[0] = <np.npy_intp>self.thisptr.getNumClusters()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nClusters, np.NPY_UINT32, <void*>cluster_ids_raw)
+        return result
+
+    def getNumOverlaps(self):
+        """Count the non-zero overlaps between the last two frames
+
+        :return: number of overlaps
+        :rtype: int
+        """
+        return self.thisptr.getNumOverlaps()
+
+    def getOverlapPrev(self):
+        """Returns the previous cluster of each overlap, sorted with :meth:`~.getOverlapNext()` by previous then
+        current cluster
+
+        :return: numpy array of cluster indices in the previous frame
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{overlaps}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *overlap_prev_raw = self.thisptr.getOverlapPrev().get()
+        cdef np.npy_intp nOverlaps[1]
+        nOverlaps[0] = <np.npy_intp>self.thisptr.getNumOverlaps()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nOverlaps, np.NPY_UINT32, <void*>overlap_prev_raw)
+        return result
+
+    def getOverlapNext(self):
+        """Returns the current cluster of each overlap
+
+        :return: numpy array of cluster indices in the current frame
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{overlaps}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *overlap_next_raw = self.thisptr.getOverlapNext().get()
+        cdef np.npy_intp nOverlaps[1]
+        nOverlaps[0] = <np.npy_intp>self.thisptr.getNumOverlaps()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nOverlaps, np.NPY_UINT32, <void*>overlap_next_raw)
+        return result
+
+    def getOverlapCount(self):
+        """Returns the number of particles shared by the two clusters of each overlap
+
+        :return: numpy array of particle counts
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{overlaps}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *overlap_count_raw = self.thisptr.getOverlapCount().get()
+        cdef np.npy_intp nOverlaps[1]
+        nOverlaps[0] = <np.npy_intp>self.thisptr.getNumOverlaps()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nOverlaps, np.NPY_UINT32, <void*>overlap_count_raw)
+        return result
+
+    def getNumEvents(self):
+        """Count the events between the last two frames
+
+        :return: number of events
+        :rtype: int
+        """
+        return self.thisptr.getNumEvents()
+
+    def getEvents(self):
+        """Returns the events between the last two frames
+
+        Each row is (type, previous cluster, current cluster), the missing cluster of births and deaths being
+        :attr:`UNTRACKED`. Splits and merges come first, in the order of the overlaps, then deaths by previous
+        cluster, then births by current cluster.
+
+        :return: numpy array of events
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{events}`, 3), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *events_raw = self.thisptr.getEvents().get()
+        cdef np.npy_intp nEvents[2]
+        nEvents[0] = <np.npy_intp>self.thisptr.getNumEvents()
+        nEvents[1] = 3
+        cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nEvents, np.NPY_UINT32, <void*>events_raw)
+        return result
@@ -9,3 +9,5 @@
 # bring related c++ classes into the cluster module
 from ._freud import Cluster
 from ._freud import ClusterProperties
+from ._freud import ClusterReduction
+from ._freud import ClusterTracker
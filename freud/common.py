@@ -8,7 +8,9 @@ import numpy as np
 def convert_array(array, dimensions, dtype=None, contiguous=True, dim_message=None):
     """
     Function which takes a given array, checks the dimensions, and converts to a supplied dtype and/or makes the array
-    contiguous as required by the user.
+    contiguous as required by the user. An array that already has the dtype and layout is returned as it is; any
+    other is converted by a single copy, which also makes strided views (such as the first three columns of an Nx4
+    array) contiguous.
 
     .. moduleauthor:: Eric Harper <harperic@umich.edu>
 
@@ -29,6 +31,9 @@ def convert_array(array, dimensions, dtype=None, contiguous=True, dim_message=No
         if dim_message is not None:
             logger.warning(dim_message)
         raise TypeError("array.ndim = {}; expected ndim = {}".format(array.ndim, dimensions))
+    # arrays that already match are passed through as they are, without a copy
+    if (dtype is None or array.dtype == dtype) and (not contiguous or array.flags.c_contiguous):
+        return array
     requirements = None
     if contiguous == True:
         if array.flags.contiguous == False:
@@ -39,3 +44,27 @@ def convert_array(array, dimensions, dtype=None, contiguous=True, dim_message=No
         msg = 'converting supplied array dtype {} to dtype {}'.format(array.dtype, dtype)
         logger.warning(msg)
     return np.require(array, dtype=dtype, requirements=requirements)
+
+def convert_soa_array(points, dtype=np.float32, dim_message=None):
+    """
+    Function which takes points stored as separate x, y and z coordinates, either as an array of shape (3, N) or as
+    a sequence of three 1 dimensional arrays of N values (such as those of
+    :py:meth:`freud.trajectory.DCDReader.getX()`), and converts each of them with :py:func:`convert_array()`.
+
+    :param points: Points to check and convert
+    :param dtype: dtype to convert the coordinates to
+    :param dim_message: passed message to log if the dimensions do not match; allows for easier debugging
+    :type points: :py:class:`numpy.ndarray` or sequence of :py:class:`numpy.ndarray`
+    :type dtype: :py:class:`numpy.dtype`
+    :type dim_message: str
+    :return: x, y and z coordinates
+    :rtype: tuple of :py:class:`numpy.ndarray`
+    """
+    if len(points) != 3:
+        if dim_message is not None:
+            logger.warning(dim_message)
+        raise TypeError("len(points) = {}; expected 3 arrays of coordinates".format(len(points)))
+    x, y, z = (convert_array(np.asarray(c), 1, dtype=dtype, contiguous=True, dim_message=dim_message) for c in points)
+    if not (x.shape[0] == y.shape[0] == z.shape[0]):
+        raise ValueError("the x, y and z arrays must have the same length")
+    return x, y, z
@@ -1,11 +1,17 @@
 # Copyright (c) 2010-2016 The Regents of the University of Michigan
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
-from freud.util._VectorMath cimport vec3
+from freud.util._VectorMath cimport vec3, quat
+from freud.util._BinCount cimport BinCount
 from freud.util._Boost cimport shared_array
 cimport freud._box as _box
+cimport freud._locality as locality
 cimport freud._density as density
 from libc.string cimport memcpy
+from libcpp.string cimport string
+from cython.operator cimport dereference
+from libcpp.vector cimport vector
+from libcpp.memory cimport shared_ptr
 import numpy as np
 cimport numpy as np
 
@@ -41,20 +47,28 @@ cdef class FloatCF:
 
     :param r_max: distance over which to calculate
     :param dr: bin size
+    :param bin_edges: increasing edges of arbitrary bins, used instead of r_max and dr when given (optional)
     :type r_max: float
     :type dr: float
+    :type bin_edges: :class:`numpy.ndarray`, shape=(:math:`N_{bins}+1`), dtype= :class:`numpy.float32`
     """
     cdef density.CorrelationFunction[double] *thisptr
 
-    def __cinit__(self, float rmax, float dr):
-        if dr <= 0.0:
-            raise ValueError("dr must be > 0")
-        self.thisptr = new density.CorrelationFunction[double](rmax, dr)
+    def __cinit__(self, rmax=None, dr=None, bin_edges=None):
+        cdef vector[float] l_bin_edges
+        if bin_edges is not None:
+            for edge in np.asarray(bin_edges, dtype=np.float32):
+                l_bin_edges.push_back(edge)
+            self.thisptr = new density.CorrelationFunction[double](l_bin_edges)
+        else:
+            if dr is None or dr <= 0.0:
+                raise ValueError("dr must be > 0")
+            self.thisptr = new density.CorrelationFunction[double](rmax, dr)
 
     def __dealloc__(self):
         del self.thisptr
 
-    def accumulate(self, box, ref_points, refValues, points, values):
+    def accumulate(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -63,11 +77,13 @@ cdef class FloatCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -91,22 +107,23 @@ cdef class FloatCF:
             l_values = values
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
         with nogil:
             self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <double*>l_refValues.data, n_ref,
-                <vec3[float]*>l_points.data, <double*>l_values.data, n_p)
+                <vec3[float]*>l_points.data, <double*>l_values.data, n_p, cNlist)
 
-    def getRDF(self):
+    def getRDF(self, out=None):
         """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: expected (average) product of all values at a given radial distance
         :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float64`
         """
         cdef double *rdf = self.thisptr.getRDF().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.float64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT64, <void*>rdf)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT64, <void*>rdf, out)
 
     def getBox(self):
         """
@@ -123,7 +140,7 @@ cdef class FloatCF:
         """
         self.thisptr.resetCorrelationFunction()
 
-    def compute(self, box, ref_points, refValues, points, values):
+    def compute(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function for the given points. Will overwrite the current histogram.
 
@@ -132,32 +149,83 @@ cdef class FloatCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         self.thisptr.resetCorrelationFunction()
-        self.accumulate(box, ref_points, refValues, points, values)
+        self.accumulate(box, ref_points, refValues, points, values, nlist=nlist)
 
     def reduceCorrelationFunction(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
         :py:meth:`freud.density.FloatCF.getRDF()`, :py:meth:`freud.density.FloatCF.getCounts()`.
         """
-        self.thisptr.reduceCorrelationFunction()
+        with nogil:
+            self.thisptr.reduceCorrelationFunction()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, FloatCF other):
+        """Add the accumulated state of another :py:class:`freud.density.FloatCF` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.density.FloatCF`
+        """
+        self.thisptr.merge(dereference(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
 
-    def getCounts(self):
+    def getCounts(self, out=None):
         """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: counts of each histogram bin
         :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.int32`
         """
         cdef unsigned int *counts = self.thisptr.getCounts().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>counts)
-        return result
+        return result_array(self, 1, nbins, np.NPY_UINT32, <void*>counts, out)
+
+    def getBinEdges(self):
+        """
+        :return: edges of the histogram bins
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}+1`), dtype= :class:`numpy.float32`
+        """
+        return np.array(self.thisptr.getBinEdges(), dtype=np.float32)
 
     def getR(self):
         """
@@ -167,8 +235,7 @@ cdef class FloatCF:
         cdef float *r = self.thisptr.getR().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
 
 cdef class ComplexCF:
     """Computes the pairwise correlation function :math:`\\left< p*q \\right> \\left( r \\right)` \
@@ -198,20 +265,28 @@ cdef class ComplexCF:
 
     :param r_max: distance over which to calculate
     :param dr: bin size
+    :param bin_edges: increasing edges of arbitrary bins, used instead of r_max and dr when given (optional)
     :type r_max: float
     :type dr: float
+    :type bin_edges: :class:`numpy.ndarray`, shape=(:math:`N_{bins}+1`), dtype= :class:`numpy.float32`
     """
     cdef density.CorrelationFunction[np.complex128_t] *thisptr
 
-    def __cinit__(self, float rmax, float dr):
-        if dr <= 0.0:
-            raise ValueError("dr must be > 0")
-        self.thisptr = new density.CorrelationFunction[np.complex128_t](rmax, dr)
+    def __cinit__(self, rmax=None, dr=None, bin_edges=None):
+        cdef vector[float] l_bin_edges
+        if bin_edges is not None:
+            for edge in np.asarray(bin_edges, dtype=np.float32):
+                l_bin_edges.push_back(edge)
+            self.thisptr = new density.CorrelationFunction[np.complex128_t](l_bin_edges)
+        else:
+            if dr is None or dr <= 0.0:
+                raise ValueError("dr must be > 0")
+            self.thisptr = new density.CorrelationFunction[np.complex128_t](rmax, dr)
 
     def __dealloc__(self):
         del self.thisptr
 
-    def accumulate(self, box, ref_points, refValues, points, values):
+    def accumulate(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -220,11 +295,13 @@ cdef class ComplexCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -248,22 +325,23 @@ cdef class ComplexCF:
             l_values = values
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
         with nogil:
             self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <np.complex128_t*>l_refValues.data, n_ref,
-                <vec3[float]*>l_points.data, <np.complex128_t*>l_values.data, n_p)
+                <vec3[float]*>l_points.data, <np.complex128_t*>l_values.data, n_p, cNlist)
 
-    def getRDF(self):
+    def getRDF(self, out=None):
         """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: expected (average) product of all values at a given radial distance
         :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.complex128`
         """
         cdef np.complex128_t *rdf = self.thisptr.getRDF().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.complex128_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_COMPLEX128, <void*>rdf)
-        return result
+        return result_array(self, 1, nbins, np.NPY_COMPLEX128, <void*>rdf, out)
 
     def getBox(self):
         """
@@ -278,7 +356,7 @@ cdef class ComplexCF:
         """
         self.thisptr.resetCorrelationFunction()
 
-    def compute(self, box, ref_points, refValues, points, values):
+    def compute(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function for the given points. Will overwrite the current histogram.
 
@@ -287,32 +365,83 @@ cdef class ComplexCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         self.thisptr.resetCorrelationFunction()
-        self.accumulate(box, ref_points, refValues, points, values)
+        self.accumulate(box, ref_points, refValues, points, values, nlist=nlist)
 
     def reduceCorrelationFunction(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
         :py:meth:`freud.density.ComplexCF.getRDF()`, :py:meth:`freud.density.ComplexCF.getCounts()`.
         """
-        self.thisptr.reduceCorrelationFunction()
+        with nogil:
+            self.thisptr.reduceCorrelationFunction()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, ComplexCF other):
+        """Add the accumulated state of another :py:class:`freud.density.ComplexCF` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.density.ComplexCF`
+        """
+        self.thisptr.merge(dereference(other.thisptr))
 
-    def getCounts(self):
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
+
+    def getCounts(self, out=None):
         """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: counts of each histogram bin
         :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.int32`
         """
         cdef unsigned int *counts = self.thisptr.getCounts().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>counts)
-        return result
+        return result_array(self, 1, nbins, np.NPY_UINT32, <void*>counts, out)
+
+    def getBinEdges(self):
+        """
+        :return: edges of the histogram bins
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}+1`), dtype= :class:`numpy.float32`
+        """
+        return np.array(self.thisptr.getBinEdges(), dtype=np.float32)
 
     def getR(self):
         """
@@ -322,8 +451,7 @@ cdef class ComplexCF:
         cdef float *r = self.thisptr.getR().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
 
 cdef class GaussianDensity:
     """Computes the density of a system on a grid.
@@ -390,11 +518,85 @@ cdef class GaussianDensity:
             raise ValueError("the 2nd dimension must have 3 values: x, y, z")
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int n_p = points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         with nogil:
             self.thisptr.compute(l_box, <vec3[float]*>l_points.data, n_p)
 
+    def computeFFT(self, box, points):
+        """
+        Calculates the gaussian blur for the specified points by depositing them on the grid and convolving it with \
+        the Gaussian using fast Fourier transforms. The cost does not depend on r_cut and sigma, which makes large \
+        grids, wide Gaussians and many points affordable. The Gaussian is not cut off at r_cut. Does not accumulate \
+        (will overwrite current image).
+
+        .. note::
+            The widths must be powers of two and the box must not be tilted.
+
+        :param box: simulation box
+        :param points: points to calculate the local density
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        with nogil:
+            self.thisptr.computeFFT(l_box, <vec3[float]*>l_points.data, n_p)
+
+    def computeProjection(self, box, points, z_range=None):
+        """
+        Calculates the gaussian blur of the specified points integrated along z, over the whole box or over a slab, \
+        straight on a :math:`w_x \\times w_y` image: the Gaussians are integrated analytically along z, so the 3D \
+        image is never built and the cost and memory are those of a 2D image. Each pixel is the integral of the \
+        density along the z line through its center, which the sum of the planes of :py:meth:`compute()` times their \
+        spacing approaches for fine planes. The Gaussians are cut off at r_cut as in :py:meth:`compute()`. Does not \
+        change the image of :py:meth:`compute()`.
+
+        .. note::
+            The box must be 3D and not tilted.
+
+        :param box: simulation box
+        :param points: points to calculate the local density
+        :param z_range: (z_min, z_max) of the slab, the whole box if None; the periodic images of the points \
+                        along z are integrated over the slab
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type z_range: tuple of float
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        cdef float z_min
+        cdef float z_max
+        if z_range is None:
+            z_min = -l_box.getLz()/2.0
+            z_max = l_box.getLz()/2.0
+        else:
+            z_min, z_max = z_range
+        with nogil:
+            self.thisptr.computeProjection(l_box, <vec3[float]*>l_points.data, n_p, z_min, z_max)
+
+    def getProjectedDensity(self):
+        """
+        :return: Image (grid) of the last projection computed by :py:meth:`computeProjection()`
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`w_y`, :math:`w_x`), dtype= :class:`numpy.float32`
+        """
+        cdef float *projection = self.thisptr.getProjection().get()
+        if projection == NULL:
+            raise RuntimeError("There is no projection before the first computeProjection")
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>(self.thisptr.getWidthY() * self.thisptr.getWidthX())
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>projection)
+        return np.reshape(np.ascontiguousarray(result), (self.thisptr.getWidthY(), self.thisptr.getWidthX()))
+
     def getGaussianDensity(self):
         """
         :return: Image (grid) with values of gaussian
@@ -415,12 +617,158 @@ cdef class GaussianDensity:
         pyResult = np.reshape(np.ascontiguousarray(result), arrayShape)
         return pyResult
 
+    def getCoarseGaussianDensity(self, factor):
+        """Get the last computed density averaged over blocks of factor pixels along each axis, to render it at
+        several resolutions without computing it again. Each coarse image is derived once per density from the
+        coarsest one already derived whose factor divides factor, so asking for the factors 2, 4, 8... in turn
+        builds a pyramid.
+
+        :param factor: number of pixels of the image along each axis for one pixel of the coarse image, which must
+                       divide the widths
+        :type factor: unsigned int
+        :return: Coarse image (grid), a copy
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`w_x / factor`, :math:`w_y / factor`, :math:`w_z / factor`), \
+                dtype= :class:`numpy.float32`
+        """
+        cdef unsigned int l_factor = factor
+        cdef float *density
+        with nogil:
+            density = self.thisptr.getCoarseDensity(l_factor).get()
+        cdef _box.Box l_box = self.thisptr.getBox()
+        if l_box.is2D():
+            arrayShape = (self.thisptr.getWidthY() // l_factor, self.thisptr.getWidthX() // l_factor)
+        else:
+            arrayShape = (self.thisptr.getWidthZ() // l_factor, self.thisptr.getWidthY() // l_factor,
+                          self.thisptr.getWidthX() // l_factor)
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>np.prod(arrayShape)
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>density)
+        return np.reshape(np.copy(result), arrayShape)
+
+    def saveState(self, filename):
+        """Save the last computed density and its box to a checkpoint file, from which :py:meth:`loadState()`
+        restores it
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the density of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the current density, such as to sum those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :param merge: whether to add the density to the current one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
     def resetDensity(self):
         """
         resets the values of GaussianDensity in memory
         """
         self.thisptr.resetDensity()
 
+    def setUseGPU(self, use_gpu):
+        """Set whether :py:meth:`compute()` spreads the Gaussians on a CUDA GPU. The density is copied back in the
+        background and :py:meth:`getGaussianDensity()` waits for it, so the next frame can be read while the GPU
+        works. The density only differs from the CPU within rounding. :py:meth:`computeFFT()` always runs on the
+        CPU. Raises RuntimeError when freud was built without CUDA, see the ENABLE_CUDA option of CMake, or no
+        device is found.
+
+        :param use_gpu: whether to compute on the GPU
+        :type use_gpu: bool
+        """
+        self.thisptr.setUseGPU(use_gpu)
+
+    def getUseGPU(self):
+        """Get whether :py:meth:`compute()` spreads the Gaussians on the GPU
+
+        :return: use_gpu
+        :rtype: bool
+        """
+        cdef bint use_gpu = self.thisptr.getUseGPU()
+        return use_gpu
+
+    def setSpreadMode(self, mode):
+        """Set how :py:meth:`compute()` evaluates the Gaussians on the grid. 'scatter' spreads the Gaussian of each
+        point onto the grid; 'gather' has each row of the grid gather the points whose Gaussians reach it from a cell
+        list, and writes it once, which suits sparse points on grids otherwise copied per thread; 'auto' gathers
+        those. Gathering needs a periodic orthorhombic box of at least 2 r_cut along each axis and a grid wider than
+        the cells reached by a Gaussian, and :py:meth:`compute()` raises ValueError otherwise in 'gather' mode.
+
+        :param mode: 'auto', 'scatter' or 'gather'
+        :type mode: str
+        """
+        if mode not in _spread_modes:
+            raise RuntimeError('Unknown spread mode {}, expected one of {}'.format(mode, sorted(_spread_modes)))
+        self.thisptr.setSpreadMode(_spread_modes[mode])
+
+    def getSpreadMode(self):
+        """
+        :return: spread mode
+        :rtype: str
+        """
+        cdef density.SpreadMode mode = self.thisptr.getSpreadMode()
+        for name in _spread_modes:
+            if _spread_modes[name] == mode:
+                return name
+
+    def getGathered(self):
+        """
+        :return: whether the last :py:meth:`compute()` gathered the points
+        :rtype: bool
+        """
+        return self.thisptr.getGathered()
+
+    def setMemoryLimit(self, num_bytes):
+        """Set the most bytes the per-thread copies of the grid of :py:meth:`compute()` may take together, 0 for no
+        limit (the default). A grid whose copies would exceed it is spread onto tiles of planes straight in the
+        density array instead, as the largest grids are.
+
+        :param num_bytes: memory limit in bytes
+        :type num_bytes: unsigned long
+        """
+        self.thisptr.setMemoryLimit(num_bytes)
+
+    def getMemoryLimit(self):
+        """
+        :return: most bytes of the per-thread copies of the grid, 0 for no limit
+        :rtype: unsigned long
+        """
+        return self.thisptr.getMemoryLimit()
+
+    def getMemoryUsage(self):
+        """Get the bytes allocated by each component: density, the density, its coarse grids and the projection,
+        local_grids, the copies of the threads, and cell_list, of the gathered points
+
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.getMemoryUsage())
+
+    def estimateMemory(self, N, num_threads=0):
+        """Estimate the bytes of each component after :py:meth:`compute()` of N points of a 3D box. The cell list is
+        counted when the spread mode is 'gather'.
+
+        :param N: number of points
+        :param num_threads: number of threads, 0 for those freud runs on
+        :type N: unsigned int
+        :type num_threads: unsigned int
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.estimateMemory(N, num_threads))
+
+_spread_modes = {'auto': density.SPREAD_AUTO, 'scatter': density.SPREAD_SCATTER, 'gather': density.SPREAD_GATHER}
+
 cdef class LocalDensity:
     """ Computes the local density around a particle
 
@@ -431,7 +779,8 @@ cdef class LocalDensity:
 
     The values to compute the local density are set in the constructor. r_cut sets the maximum distance at which to
     calculate the local density. volume is the volume of a single particle. diameter is the diameter of the circumsphere
-    of an individual particle.
+    of an individual particle. When r_cut is a list of cutoffs, the densities at all of them are computed from a
+    single traversal of the neighbors, and the arrays have one column per cutoff.
 
     2D:
     RDF properly handles 2D boxes. Requires the points to be passed in [x, y, 0]. Failing to z=0 will lead to undefined
@@ -439,17 +788,25 @@ cdef class LocalDensity:
 
     .. moduleauthor:: Joshua Anderson <joaander@umich.edu>
 
-    :param r_cut: maximum distance over which to calculate the density
+    :param r_cut: maximum distance over which to calculate the density, or list of such distances
     :param volume: volume of a single particle
     :param diameter: diameter of particle circumsphere
-    :type r_cut: float
+    :type r_cut: float or list of float
     :type volume: float
     :type diameter: float
     """
     cdef density.LocalDensity *thisptr
-
-    def __cinit__(self, float r_cut, float volume, float diameter):
-        self.thisptr = new density.LocalDensity(r_cut, volume, diameter)
+    cdef bint multiple_r_cuts
+
+    def __cinit__(self, r_cut, float volume, float diameter):
+        cdef vector[float] l_r_cuts
+        self.multiple_r_cuts = isinstance(r_cut, (list, tuple, np.ndarray))
+        if self.multiple_r_cuts:
+            for cut in r_cut:
+                l_r_cuts.push_back(cut)
+            self.thisptr = new density.LocalDensity(l_r_cuts, volume, diameter)
+        else:
+            self.thisptr = new density.LocalDensity(<float>r_cut, volume, diameter)
 
     def getBox(self):
         """
@@ -458,16 +815,18 @@ cdef class LocalDensity:
         """
         return BoxFromCPP(self.thisptr.getBox())
 
-    def compute(self, box, ref_points, points=None):
+    def compute(self, box, ref_points, points=None, nlist=None):
         """
         Calculates the local density for the specified points. Does not accumulate (will overwrite current data).
 
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param points: (optional) points to calculate the local density
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         if points is None:
             points = ref_points
@@ -481,32 +840,77 @@ cdef class LocalDensity:
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        nlist = cached_nlist(nlist, box, ref_points, points, self.thisptr.getPairRMax())
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
         with nogil:
-            self.thisptr.compute(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p)
+            self.thisptr.compute(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p, cNlist)
+
+    def getRCuts(self):
+        """
+        :return: cutoffs of the columns of the arrays
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{cuts}`), dtype= :class:`numpy.float32`
+        """
+        return np.array(self.thisptr.getRCuts(), dtype=np.float32)
 
     def getDensity(self):
         """
-        :return: Density array for each particle
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
+        :return: Density array for each particle, with one column per cutoff when r_cut is a list
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`) or (:math:`N_{particles}`, :math:`N_{cuts}`), dtype= :class:`numpy.float32`
         """
         cdef float *density = self.thisptr.getDensity().get()
-        cdef np.npy_intp nref[1]
+        cdef np.npy_intp nref[2]
         nref[0] = <np.npy_intp>self.thisptr.getNRef()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nref, np.NPY_FLOAT32, <void*>density)
-        return result
+        nref[1] = <np.npy_intp>self.thisptr.getNumRCuts()
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nref, np.NPY_FLOAT32, <void*>density)
+        if self.multiple_r_cuts:
+            return result
+        return result[:, 0]
 
     def getNumNeighbors(self):
         """
-        :return: Number of neighbors for each particle
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
+        :return: Number of neighbors for each particle, with one column per cutoff when r_cut is a list
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`) or (:math:`N_{particles}`, :math:`N_{cuts}`), dtype= :class:`numpy.float32`
         """
         cdef float *neighbors = self.thisptr.getNumNeighbors().get()
-        cdef np.npy_intp nref[1]
+        cdef np.npy_intp nref[2]
         nref[0] = <np.npy_intp>self.thisptr.getNRef()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nref, np.NPY_FLOAT32, <void*>neighbors)
-        return result
+        nref[1] = <np.npy_intp>self.thisptr.getNumRCuts()
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nref, np.NPY_FLOAT32, <void*>neighbors)
+        if self.multiple_r_cuts:
+            return result
+        return result[:, 0]
+
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
 
 cdef class RDF:
     """ Computes RDF for supplied data
@@ -526,15 +930,23 @@ cdef class RDF:
 
     :param rmax: maximum distance to calculate
     :param dr: distance between histogram bins
+    :param bin_edges: increasing edges of arbitrary bins, used instead of rmax and dr when given (optional)
     :type rmax: float
     :type dr: float
+    :type bin_edges: :class:`numpy.ndarray`, shape=(:math:`N_{bins}+1`), dtype= :class:`numpy.float32`
     """
     cdef density.RDF *thisptr
 
-    def __cinit__(self, float rmax, float dr):
-        if dr <= 0.0:
-            raise ValueError("dr must be > 0")
-        self.thisptr = new density.RDF(rmax, dr)
+    def __cinit__(self, rmax=None, dr=None, bin_edges=None):
+        cdef vector[float] l_bin_edges
+        if bin_edges is not None:
+            for edge in np.asarray(bin_edges, dtype=np.float32):
+                l_bin_edges.push_back(edge)
+            self.thisptr = new density.RDF(l_bin_edges)
+        else:
+            if dr is None or dr <= 0.0:
+                raise ValueError("dr must be > 0")
+            self.thisptr = new density.RDF(rmax, dr)
 
     def __dealloc__(self):
         del self.thisptr
@@ -546,45 +958,205 @@ cdef class RDF:
         """
         return BoxFromCPP(self.thisptr.getBox())
 
-    def accumulate(self, box, ref_points, points):
+    def accumulate(self, box, ref_points, points, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the rdf and adds to the current rdf histogram.
 
+        With weights, each pair also adds the product of the weights of its two points to weighted counts, in the
+        same pass over the pairs, which :py:meth:`getWeightedRDF()` normalizes as the rdf: with charges as weights
+        it is the charge-charge correlation. Weighted frames are binned on the CPU and cannot be saved to
+        checkpoints.
+
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param points: points to calculate the local density
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`), dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
         """
+        # keep a single array for the rdf of a set of points with itself so that the symmetric pair loop is used
+        same_points = points is ref_points
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
-        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
-            dim_message="points must be a 2 dimensional array")
+        if same_points:
+            points = ref_points
+        else:
+            points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+                dim_message="points must be a 2 dimensional array")
         if ref_points.shape[1] != 3 or points.shape[1] != 3:
             raise ValueError("the 2nd dimension must have 3 values: x, y, z")
         cdef np.ndarray[float, ndim=2] l_ref_points = ref_points
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        nlist = cached_nlist(nlist, box, ref_points, points, self.thisptr.getPairRMax())
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        ref_weights, weights = pair_weights(ref_weights, weights, n_ref, n_p)
+        cdef const float *l_ref_weights = weights_data(ref_weights)
+        cdef const float *l_weights = weights_data(weights)
         with nogil:
-            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p)
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p, cNlist,
+                                    l_ref_weights, l_weights)
+
+    def accumulateDomain(self, box, points, num_owned, frame_box, frame_num_points, count_frame):
+        """
+        Calculates the rdf of the points of one domain of a frame split by a
+        :py:class:`freud.locality.DomainDecomposition` and adds it to the current rdf histogram. The reference points
+        are the num_owned first points, those the domain owns, and the points are those and the ghosts of the domain,
+        in the coordinates of its box. The rdf is normalized by the box and the number of points of the whole frame,
+        and only one domain counts the frame, so that merging the rdfs of all the domains, such as with
+        :py:func:`freud.parallel.reduceAcrossRanks`, gives the rdf of the frames.
+
+        :param box: box of the domain
+        :param points: owned points, then ghosts of the domain
+        :param num_owned: number of points the domain owns
+        :param frame_box: box of the frame
+        :param frame_num_points: number of points of the frame
+        :param count_frame: whether this domain counts the frame, True for one domain of each frame
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type num_owned: int
+        :type frame_box: :py:class:`freud.box.Box`
+        :type frame_num_points: int
+        :type count_frame: bool
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_owned = num_owned
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef unsigned int n_frame = frame_num_points
+        cdef bint l_count_frame = count_frame
+        cdef _box.Box l_box = cpp_box(box)
+        cdef _box.Box l_frame_box = cpp_box(frame_box)
+        with nogil:
+            self.thisptr.accumulateDomain(l_box, <vec3[float]*>l_points.data, n_owned, n_p, l_frame_box, n_frame,
+                                          l_count_frame)
 
-    def compute(self, box, ref_points, points):
+    def accumulateSoA(self, box, ref_points, points, nlist=None):
+        """
+        Calculates the rdf of points stored as separate x, y and z coordinates and adds to the current rdf histogram,
+        the same as :py:meth:`freud.density.RDF.accumulate()` with the interleaved points. The coordinates are read
+        where they are, such as from the frames of a :py:class:`freud.trajectory.DCDReader`, without first building
+        an :math:`N_{particles}` by 3 array of the points.
+
+        :param box: simulation box
+        :param ref_points: x, y and z coordinates of the reference points
+        :param points: x, y and z coordinates of the points
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(3, :math:`N_{particles}`), dtype= :class:`numpy.float32`, or sequence of 3 such 1D arrays
+        :type points: :class:`numpy.ndarray`, shape=(3, :math:`N_{particles}`), dtype= :class:`numpy.float32`, or sequence of 3 such 1D arrays
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        same_points = points is ref_points
+        rx, ry, rz = freud.common.convert_soa_array(ref_points,
+            dim_message="ref_points must be 3 arrays of coordinates")
+        if same_points:
+            x, y, z = rx, ry, rz
+        else:
+            x, y, z = freud.common.convert_soa_array(points, dim_message="points must be 3 arrays of coordinates")
+        cdef np.ndarray[float, ndim=1] l_ref_x = rx
+        cdef np.ndarray[float, ndim=1] l_ref_y = ry
+        cdef np.ndarray[float, ndim=1] l_ref_z = rz
+        cdef np.ndarray[float, ndim=1] l_x = x
+        cdef np.ndarray[float, ndim=1] l_y = y
+        cdef np.ndarray[float, ndim=1] l_z = z
+        cdef unsigned int n_ref = <unsigned int> rx.shape[0]
+        cdef unsigned int n_p = <unsigned int> x.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.accumulate(l_box, <float*>l_ref_x.data, <float*>l_ref_y.data, <float*>l_ref_z.data, n_ref,
+                                    <float*>l_x.data, <float*>l_y.data, <float*>l_z.data, n_p, cNlist)
+
+    def computeSoA(self, box, ref_points, points, nlist=None):
+        """
+        Calculates the rdf of points stored as separate x, y and z coordinates, see
+        :py:meth:`freud.density.RDF.accumulateSoA()`. Will overwrite the current histogram.
+
+        :param box: simulation box
+        :param ref_points: x, y and z coordinates of the reference points
+        :param points: x, y and z coordinates of the points
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(3, :math:`N_{particles}`), dtype= :class:`numpy.float32`, or sequence of 3 such 1D arrays
+        :type points: :class:`numpy.ndarray`, shape=(3, :math:`N_{particles}`), dtype= :class:`numpy.float32`, or sequence of 3 such 1D arrays
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        self.thisptr.resetRDF()
+        self.accumulateSoA(box, ref_points, points, nlist=nlist)
+
+    def accumulateFrames(self, boxes, ref_points, points):
+        """
+        Calculates the rdf of a stack of frames and adds it to the current rdf histogram, the same as calling
+        :py:meth:`freud.density.RDF.accumulate()` for each frame but in a single parallel computation.
+
+        :param boxes: simulation box of each frame, or a single box shared by all the frames
+        :param ref_points: reference points of each frame
+        :param points: points of each frame
+        :type boxes: list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`, :math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`, :math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        same_points = points is ref_points
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        if same_points:
+            points = ref_points
+        else:
+            points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+                dim_message="points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3 or points.shape[2] != 3:
+            raise ValueError("the 3rd dimension must have 3 values: x, y, z")
+        if ref_points.shape[0] != points.shape[0]:
+            raise ValueError("ref_points and points must have the same number of frames")
+        cdef unsigned int n_frames = <unsigned int> points.shape[0]
+        if not isinstance(boxes, (list, tuple)):
+            boxes = [boxes]*n_frames
+        if len(boxes) != n_frames:
+            raise ValueError("there must be one box per frame")
+        cdef vector[_box.Box] l_boxes
+        for box in boxes:
+            l_boxes.push_back(cpp_box(box))
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef unsigned int n_ref = <unsigned int> ref_points.shape[1]
+        cdef unsigned int n_p = <unsigned int> points.shape[1]
+        if n_frames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateFrames(&l_boxes[0], <vec3[float]*>l_ref_points.data, n_ref,
+                                          <vec3[float]*>l_points.data, n_p, n_frames)
+
+    def compute(self, box, ref_points, points, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the rdf for the specified points. Will overwrite the current histogram.
 
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param points: points to calculate the local density
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:meth:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`), dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
         """
         self.thisptr.resetRDF()
-        self.accumulate(box, ref_points, points)
+        self.accumulate(box, ref_points, points, nlist=nlist, ref_weights=ref_weights, weights=weights)
 
     def resetRDF(self):
         """
@@ -592,23 +1164,101 @@ cdef class RDF:
         """
         self.thisptr.resetRDF()
 
+    def accumulateAsync(self, *args, **kwargs):
+        """Start :py:meth:`accumulate()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the frame is added to the histogram
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.accumulate, *args, **kwargs)
+
+    def computeAsync(self, *args, **kwargs):
+        """Start :py:meth:`compute()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the histogram is computed
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.compute, *args, **kwargs)
+
     def reduceRDF(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
         :py:meth:`freud.density.RDF.getRDF()`, :py:meth:`freud.density.RDF.getNr()`.
         """
-        self.thisptr.reduceRDF()
+        with nogil:
+            self.thisptr.reduceRDF()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, RDF other):
+        """Add the accumulated state of another :py:class:`freud.density.RDF` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.density.RDF`
+        """
+        self.thisptr.merge(dereference(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
 
-    def getRDF(self):
+    def getRDF(self, out=None):
         """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: histogram of rdf values
         :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`, 3), dtype= :class:`numpy.float32`
         """
         cdef float *rdf = self.thisptr.getRDF().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>rdf)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>rdf, out)
+
+    def getWeightedRDF(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: rdf of the weighted counts, normalized as the rdf so that weights of 1 give it, zero when no frame
+                 was weighted; its first bin is zero when it starts at r = 0
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf = self.thisptr.getWeightedRDF().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>rdf, out)
+
+    def getBinEdges(self):
+        """
+        :return: edges of the histogram bins
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}+1`), dtype= :class:`numpy.float32`
+        """
+        return np.array(self.thisptr.getBinEdges(), dtype=np.float32)
 
     def getR(self):
         """
@@ -618,16 +1268,1004 @@ cdef class RDF:
         cdef float *r = self.thisptr.getR().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
 
-    def getNr(self):
+    def getNr(self, out=None):
         """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: histogram of cumulative rdf values
         :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`, 3), dtype= :class:`numpy.float32`
         """
         cdef float *Nr = self.thisptr.getNr().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>Nr)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>Nr, out)
+
+    def setPartitionMode(self, mode):
+        """Set how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        'auto' (the default) splits them in ranges of equal numbers of points. 'cost' orders them by cell and splits
+        them in ranges of equal estimated numbers of pairs, which balances inhomogeneous systems. 'affinity' gives
+        each thread the same points again from one frame to the next. 'pair_blocks' splits the pairs of each cell
+        with its neighbor cells in blocks, those of the densest cells in several, for strongly clustered systems;
+        the pairs of a set of points with itself are then all visited twice, and it is 'cost' with a neighbor list
+        or the histograms of the points. The frames of :py:meth:`accumulateFrames()` are always split as with
+        'auto'.
+
+        :param mode: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :type mode: str
+        """
+        self.thisptr.setPartitionMode(partition_mode(mode))
+
+    def getPartitionMode(self):
+        """Get how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        :return: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :rtype: str
+        """
+        return partition_mode_name(self.thisptr.getPartitionMode())
+
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
+    def setUseGPU(self, use_gpu):
+        """Set whether :py:meth:`accumulate()` bins the pairs on a CUDA GPU when no neighbor list is given. The
+        histogram of each frame is added to the accumulated one as on the CPU, so the counts are the same but for
+        pairs within rounding of a bin edge. :py:meth:`accumulateFrames()` always runs on the CPU. Raises RuntimeError when freud was built without CUDA, see the
+        ENABLE_CUDA option of CMake, or no device is found.
+
+        :param use_gpu: whether to bin on the GPU
+        :type use_gpu: bool
+        """
+        self.thisptr.setUseGPU(use_gpu)
+
+    def getUseGPU(self):
+        """Get whether :py:meth:`accumulate()` bins the pairs on the GPU
+
+        :return: use_gpu
+        :rtype: bool
+        """
+        cdef bint use_gpu = self.thisptr.getUseGPU()
+        return use_gpu
+
+    def setKernelWidth(self, sigma):
+        """Set the width of the Gaussian kernel that smooths the distance of each pair over the bins, or 0 to bin the
+        pairs. :py:meth:`getRDF()` is then the kernel density estimate of :math:`g \\left( r \\right)`, smoother and
+        converged in fewer frames than the histogram at the cost of a resolution of sigma. Each pair adds a tabulated
+        kernel to the bins within 4 sigma of it; those within 4 sigma of rmax are biased low, as the pairs beyond rmax
+        are not found. The bins must be of equal widths, and setting the width resets the smoothed counts.
+        Checkpoints are not supported while smoothing.
+
+        :param sigma: standard deviation of the kernel
+        :type sigma: float
+        """
+        self.thisptr.setKernelWidth(sigma)
+
+    def getKernelWidth(self):
+        """Get the width of the Gaussian kernel, 0 when the pairs are binned
+
+        :return: sigma
+        :rtype: float
+        """
+        return self.thisptr.getKernelWidth()
+
+    def setPointHistograms(self, enable, compact=False):
+        """Set whether :py:meth:`accumulate()` also fills the histogram of the pairs of each reference point, for
+        local analyses of :math:`g \\left( r \\right)` around each particle. The histograms are filled in the same
+        traversal as the rdf, each by the thread that visits its reference point, and are those of the last frame.
+        With compact, the counts are 16 bit integers and saturate at 65535. While they are kept, the GPU is not used
+        and :py:meth:`accumulateFrames()` raises ValueError.
+
+        :param enable: whether to fill the histograms of the reference points
+        :param compact: whether to count in 16 bits instead of 32
+        :type enable: bool
+        :type compact: bool
+        """
+        self.thisptr.setPointHistograms(enable, compact)
+
+    def getPointHistograms(self):
+        """Get whether :py:meth:`accumulate()` fills the histograms of the reference points
+
+        :return: enable
+        :rtype: bool
+        """
+        cdef bint enable = self.thisptr.getPointHistograms()
+        return enable
+
+    def getPointCounts(self, out=None):
+        """Get the histograms of the pairs of each reference point of the last frame, see
+        :py:meth:`setPointHistograms()`. Summing the rows of a group of points gives the histogram of the group.
+
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: number of points in each bin around each reference point
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`, :math:`N_{bins}`), dtype= :class:`numpy.uint32`, or :class:`numpy.uint16` when compact
+        """
+        if not self.thisptr.getPointHistograms():
+            raise ValueError("setPointHistograms() must be enabled before accumulate()")
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumPointHistograms()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBins()
+        if nbins[0] == 0:
+            raise ValueError("no frame was accumulated with the histograms of the reference points")
+        if self.thisptr.getPointHistogramsCompact():
+            return result_array(self, 2, nbins, np.NPY_UINT16, <void*>self.thisptr.getPointCountsCompact().get(),
+                                out)
+        return result_array(self, 2, nbins, np.NPY_UINT32, <void*>self.thisptr.getPointCounts().get(), out)
+
+    def getTimings(self):
+        """Get the wall time in seconds of each phase of the last :py:meth:`accumulate()`, recorded only when freud is
+        built with ENABLE_PROFILING (see :py:func:`freud.parallel.isProfilingEnabled`)
+
+        The phases are cell_list, pairs (the binning on the CPU), gpu and reduce, the normalization done by
+        :py:meth:`getRDF()` after it.
+
+        :return: seconds by phase
+        :rtype: dict
+        """
+        return _profileTimings(self.thisptr.getProfiler())
+
+    def getStats(self):
+        """Get the counters of the last :py:meth:`accumulate()`, recorded only when freud is built with ENABLE_PROFILING
+
+        The counters are pairs_tested, the distances computed, pairs_accepted, those within rmax, bonds, those of
+        a neighbor list binned instead, and cells.
+
+        :return: counts by name
+        :rtype: dict
+        """
+        return _profileStats(self.thisptr.getProfiler())
+
+    def getMemoryUsage(self):
+        """Get the bytes allocated by each component: histogram, the arrays shared by the threads, local_histograms,
+        the copies of the threads, point_histograms, cell_list, unless it is shared, and points, the buffers of the
+        interleaved points
+
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.getMemoryUsage())
+
+    def estimateMemory(self, N, num_threads=0):
+        """Estimate the bytes of each component after :py:meth:`accumulate()` of N reference points and N points,
+        with the current options
+
+        :param N: number of points
+        :param num_threads: number of threads, 0 for those freud runs on
+        :type N: unsigned int
+        :type num_threads: unsigned int
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.estimateMemory(N, num_threads))
+
+cdef class PartialRDF:
+    """ Computes the partial RDFs of a mixture
+
+    Every point has a type in [0, n_types). All the partial RDFs :math:`g_{ab} \\left( r \\right)` are filled by a
+    single pass over the pairs of the system, instead of one :py:class:`freud.density.RDF` computation per pair of
+    types. :math:`g_{ab}` is normalized like the rdf of the points of type a as reference points among the points of
+    type b, so that :math:`g_{ab} = g_{ba}`; only the cumulative counts differ, as
+    :math:`N_{ab} \\left( r \\right) = N_{ba} \\left( r \\right) N_b / N_a`.
+
+    .. note::
+        2D: PartialRDF properly handles 2D boxes. Requires the points to be passed in [x, y, 0]. Failing to z=0 will \
+        lead to undefined behavior.
+
+    :param rmax: maximum distance to calculate
+    :param dr: distance between histogram bins
+    :param n_types: number of types
+    :type rmax: float
+    :type dr: float
+    :type n_types: unsigned int
+    """
+    cdef density.PartialRDF *thisptr
+
+    def __cinit__(self, float rmax, float dr, unsigned int n_types):
+        if dr <= 0.0:
+            raise ValueError("dr must be > 0")
+        self.thisptr = new density.PartialRDF(rmax, dr, n_types)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def accumulate(self, box, points, types):
+        """
+        Calculates the partial rdfs and adds them to the current histograms.
+
+        :param box: simulation box
+        :param points: points of all types
+        :param types: type of each point
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type types: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        types = freud.common.convert_array(types, 1, dtype=np.uint32, contiguous=True,
+            dim_message="types must be a 1 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        if types.shape[0] != points.shape[0]:
+            raise ValueError("there must be one type per point")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef np.ndarray[np.uint32_t, ndim=1] l_types = types
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_points.data, <unsigned int*>l_types.data, n_p)
+
+    def compute(self, box, points, types):
+        """
+        Calculates the partial rdfs for the specified points. Will overwrite the current histograms.
+
+        :param box: simulation box
+        :param points: points of all types
+        :param types: type of each point
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type types: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        """
+        self.thisptr.resetPartialRDF()
+        self.accumulate(box, points, types)
+
+    def resetPartialRDF(self):
+        """
+        resets the values of the partial rdfs in memory
+        """
+        self.thisptr.resetPartialRDF()
+
+    def reducePartialRDF(self):
+        """
+        Reduces the histograms in the values over N processors to single histograms. This is called automatically
+        by :py:meth:`freud.density.PartialRDF.getRDF()`, :py:meth:`freud.density.PartialRDF.getNr()`.
+        """
+        with nogil:
+            self.thisptr.reducePartialRDF()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points of each type that normalize
+        the result stay those of this object, unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, PartialRDF other):
+        """Add the accumulated state of another :py:class:`freud.density.PartialRDF` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.density.PartialRDF`
+        """
+        self.thisptr.merge(dereference(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
+
+    def getRDF(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: partial rdfs, indexed as [a, b, bin]
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf = self.thisptr.getRDF().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNTypes()
+        nbins[1] = <np.npy_intp>self.thisptr.getNTypes()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>rdf, out)
+
+    def getR(self):
+        """
+        :return: values of the histogram bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
+
+    def getNr(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: cumulative partial counts, indexed as [a, b, bin]
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *Nr = self.thisptr.getNr().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNTypes()
+        nbins[1] = <np.npy_intp>self.thisptr.getNTypes()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>Nr, out)
+
+cdef class GroupedRDF:
+    """ Computes one RDF per group of reference points among the same points
+
+    Every reference point has a group in [0, n_groups), such as its cluster, layer or type. The rdfs of all the groups
+    are filled by a single pass over the cell list of the points, instead of one :py:class:`freud.density.RDF`
+    computation per group. The rdf of group g is normalized like the rdf of the reference points of group g among
+    the points; the groups may change from frame to frame, each frame weighing by the number of reference points of
+    each group.
+
+    .. note::
+        2D: GroupedRDF properly handles 2D boxes. Requires the points to be passed in [x, y, 0]. Failing to z=0 will \
+        lead to undefined behavior.
+
+    :param rmax: maximum distance to calculate
+    :param dr: distance between histogram bins
+    :param n_groups: number of groups
+    :type rmax: float
+    :type dr: float
+    :type n_groups: unsigned int
+    """
+    cdef density.GroupedRDF *thisptr
+
+    def __cinit__(self, float rmax, float dr, unsigned int n_groups):
+        if dr <= 0.0:
+            raise ValueError("dr must be > 0")
+        self.thisptr = new density.GroupedRDF(rmax, dr, n_groups)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def accumulate(self, box, ref_points, ref_groups, points):
+        """
+        Calculates the rdfs of the groups and adds them to the current histograms.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the local density
+        :param ref_groups: group of each reference point
+        :param points: points to calculate the local density
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type ref_groups: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        ref_groups = freud.common.convert_array(ref_groups, 1, dtype=np.uint32, contiguous=True,
+            dim_message="ref_groups must be a 1 dimensional array")
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3 or points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        if ref_groups.shape[0] != ref_points.shape[0]:
+            raise ValueError("there must be one group per reference point")
+        cdef np.ndarray[float, ndim=2] l_ref_points = ref_points
+        cdef np.ndarray[np.uint32_t, ndim=1] l_ref_groups = ref_groups
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <unsigned int*>l_ref_groups.data, n_ref,
+                                    <vec3[float]*>l_points.data, n_p)
+
+    def compute(self, box, ref_points, ref_groups, points):
+        """
+        Calculates the rdfs of the groups for the specified points. Will overwrite the current histograms.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the local density
+        :param ref_groups: group of each reference point
+        :param points: points to calculate the local density
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type ref_groups: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        self.thisptr.resetGroupedRDF()
+        self.accumulate(box, ref_points, ref_groups, points)
+
+    def resetGroupedRDF(self):
+        """
+        resets the values of the rdfs in memory
+        """
+        self.thisptr.resetGroupedRDF()
+
+    def reduceGroupedRDF(self):
+        """
+        Reduces the histograms in the values over N processors to single histograms. This is called automatically
+        by :py:meth:`freud.density.GroupedRDF.getRDF()`, :py:meth:`freud.density.GroupedRDF.getNr()`.
+        """
+        with nogil:
+            self.thisptr.reduceGroupedRDF()
+
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def getRDF(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: rdfs, indexed as [group, bin]
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{groups}`, :math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf = self.thisptr.getRDF().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNGroups()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 2, nbins, np.NPY_FLOAT32, <void*>rdf, out)
+
+    def getR(self):
+        """
+        :return: values of the histogram bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
+
+    def getNr(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: cumulative counts, indexed as [group, bin]
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{groups}`, :math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *Nr = self.thisptr.getNr().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNGroups()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 2, nbins, np.NPY_FLOAT32, <void*>Nr, out)
+
+    def getGroupCounts(self):
+        """
+        :return: number of reference points of each group, summed over the accumulated frames
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{groups}`), dtype= :class:`numpy.float64`
+        """
+        return np.array(self.thisptr.getGroupCounts(), dtype=np.float64)
+
+    def getNBins(self):
+        """
+        :return: the number of bins
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNBins()
+
+    def getNGroups(self):
+        """
+        :return: the number of groups
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNGroups()
+
+cdef class AngularRDF:
+    """ Computes the RDF resolved by the angle to the orientation of the reference points
+
+    :math:`g \\left( r, \\cos \\theta \\right)`, :math:`\\theta` being the angle between the vector from a
+    reference point to a point and the axis of the reference point, is binned directly from the pairs found as by
+    :py:class:`freud.density.RDF`, instead of marginalizing the histograms of
+    :py:class:`freud.pmft.PMFTR12` or :py:class:`freud.bond.BondOrder`. The axis of a reference point is the given
+    axis of its body frame rotated by its orientation. The pair of a point with itself is not counted.
+
+    g is normalized by the volume of each bin so that it is 1 for uncorrelated points. The bins are uniform in
+    :math:`\\cos \\theta`, which in 2D, where the angles are uniform instead, makes those near
+    :math:`\\cos \\theta = \\pm 1` larger.
+
+    .. note::
+        2D: AngularRDF properly handles 2D boxes. Requires the points to be passed in [x, y, 0] and the orientations
+        to be rotations about z. Failing to z=0 will lead to undefined behavior.
+
+    :param rmax: maximum distance to calculate
+    :param dr: distance between histogram bins
+    :param n_cos_bins: number of bins of :math:`\\cos \\theta` between -1 and 1
+    :param axis: axis of the reference points in their body frame
+    :type rmax: float
+    :type dr: float
+    :type n_cos_bins: unsigned int
+    :type axis: :class:`numpy.ndarray`, shape=(3), dtype= :class:`numpy.float32`
+    """
+    cdef density.AngularRDF *thisptr
+
+    def __cinit__(self, float rmax, float dr, unsigned int n_cos_bins, axis=(1, 0, 0)):
+        if dr <= 0.0:
+            raise ValueError("dr must be > 0")
+        axis = np.asarray(axis, dtype=np.float32)
+        if axis.shape != (3,):
+            raise ValueError("axis must have 3 values: x, y, z")
+        self.thisptr = new density.AngularRDF(rmax, dr, n_cos_bins, vec3[float](axis[0], axis[1], axis[2]))
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def accumulate(self, box, ref_points, ref_orientations, points, nlist=None):
+        """
+        Calculates the angular rdf and adds to the current histogram.
+
+        :param box: simulation box
+        :param ref_points: reference points
+        :param ref_orientations: orientations of the reference points as quaternions
+        :param points: points
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`, 3), dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`, 4), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+        if ref_points.shape[1] != 3 or points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        if ref_orientations.shape[1] != 4:
+            raise ValueError("the 2nd dimension must have 4 values: q0, q1, q2, q3")
+        if ref_orientations.shape[0] != ref_points.shape[0]:
+            raise ValueError("there must be one orientation per reference point")
+        cdef np.ndarray[float, ndim=2] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <quat[float]*>l_ref_orientations.data,
+                                    n_ref, <vec3[float]*>l_points.data, n_p, cNlist)
+
+    def compute(self, box, ref_points, ref_orientations, points, nlist=None):
+        """
+        Calculates the angular rdf for the specified points. Will overwrite the current histogram.
+
+        :param box: simulation box
+        :param ref_points: reference points
+        :param ref_orientations: orientations of the reference points as quaternions
+        :param points: points
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`, 3), dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`, 4), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        self.thisptr.resetAngularRDF()
+        self.accumulate(box, ref_points, ref_orientations, points, nlist=nlist)
+
+    def resetAngularRDF(self):
+        """
+        resets the values of the angular rdf in memory
+        """
+        self.thisptr.resetAngularRDF()
+
+    def reduceAngularRDF(self):
+        """
+        Reduces the histogram in the values over N processors to a single histogram. This is called automatically
+        by :py:meth:`freud.density.AngularRDF.getRDF()`, :py:meth:`freud.density.AngularRDF.getBinCounts()`.
+        """
+        with nogil:
+            self.thisptr.reduceAngularRDF()
+
+    def getRDF(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: angular rdf, indexed as [r bin, cos theta bin]
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{r}`, :math:`N_{\\cos \\theta}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf = self.thisptr.getRDF().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsCosTheta()
+        return result_array(self, 2, nbins, np.NPY_FLOAT32, <void*>rdf, out)
+
+    def getBinCounts(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: number of pairs in each bin, indexed as [r bin, cos theta bin]
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{r}`, :math:`N_{\\cos \\theta}`), dtype= :class:`numpy.uint32`
+        """
+        cdef BinCount *bin_counts = self.thisptr.getBinCounts().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsCosTheta()
+        return result_array(self, 2, nbins, np.NPY_UINT64 if sizeof(BinCount) == 8 else np.NPY_UINT32,
+                            <void*>bin_counts, out)
+
+    def getR(self):
+        """
+        :return: values of the r bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{r}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
+
+    def getCosTheta(self):
+        """
+        :return: values of the cos theta bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{\\cos \\theta}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *cos_theta = self.thisptr.getCosTheta().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsCosTheta()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>cos_theta)
+
+cdef class DensityProfile:
+    """ Computes the number density profiles of the types of points along an axis of the box
+
+    The box is cut into nbins slabs of equal thickness across the axis, in fractional coordinates so that frames of
+    fluctuating boxes add up bin by bin, and the profile of each type is its number density in each slab, averaged
+    over the frames accumulated. The points are binned in parallel into per-thread histograms, as by
+    :py:class:`freud.density.RDF`.
+
+    With a positive sigma, each point is smeared by a Gaussian of that width along the axis, integrated over each slab
+    within 4 sigma. With recenter, the points of each frame are taken relative to their center of mass along the axis,
+    the circular mean of their periodic coordinate, which then sits at the center of the profile, so that a drifting
+    interface or slab does not blur the average.
+
+    .. note::
+        2D: DensityProfile properly handles 2D boxes, along x or y. Requires the points to be passed in [x, y, 0].
+
+    :param axis: 0, 1 or 2 for the profile along x, y or z
+    :param nbins: number of slabs across the box
+    :param n_types: number of types
+    :param sigma: width of the Gaussian smearing along the axis, 0 to bin the points
+    :param recenter: whether to put the center of mass of each frame at the center of the profile
+    :type axis: unsigned int
+    :type nbins: unsigned int
+    :type n_types: unsigned int
+    :type sigma: float
+    :type recenter: bool
+    """
+    cdef density.DensityProfile *thisptr
+
+    def __cinit__(self, unsigned int axis, unsigned int nbins, unsigned int n_types=1, float sigma=0.0,
+                  recenter=False):
+        self.thisptr = new density.DensityProfile(axis, nbins, n_types, sigma, recenter)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def accumulate(self, box, points, types=None):
+        """
+        Calculates the profiles of a frame and adds them to the current ones.
+
+        :param box: simulation box
+        :param points: points of all types
+        :param types: type of each point, all of type 0 if None
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type types: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef np.ndarray[np.uint32_t, ndim=1] l_types
+        cdef unsigned int *types_ptr = NULL
+        if types is not None:
+            types = freud.common.convert_array(types, 1, dtype=np.uint32, contiguous=True,
+                dim_message="types must be a 1 dimensional array")
+            if types.shape[0] != points.shape[0]:
+                raise ValueError("there must be one type per point")
+            l_types = types
+            types_ptr = <unsigned int*>l_types.data
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_points.data, types_ptr, n_p)
+
+    def compute(self, box, points, types=None):
+        """
+        Calculates the profiles of the specified points. Will overwrite the current profiles.
+
+        :param box: simulation box
+        :param points: points of all types
+        :param types: type of each point, all of type 0 if None
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type types: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        """
+        self.thisptr.resetProfile()
+        self.accumulate(box, points, types)
+
+    def resetProfile(self):
+        """
+        resets the values of the profiles in memory
+        """
+        self.thisptr.resetProfile()
+
+    def reduceProfile(self):
+        """
+        Reduces the histograms in the values over N processors to single profiles. This is called automatically
+        by :py:meth:`freud.density.DensityProfile.getDensity()`, :py:meth:`freud.density.DensityProfile.getPositions()`.
+        """
+        with nogil:
+            self.thisptr.reduceProfile()
+
+    def getDensity(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: number density of each type in each slab, indexed as [type, bin]
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{types}`, :math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *density = self.thisptr.getDensity().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNTypes()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 2, nbins, np.NPY_FLOAT32, <void*>density, out)
+
+    def getPositions(self):
+        """
+        :return: positions of the centers of the slabs along the axis in the box of the last frame, relative to its \
+                 center, or to the center of mass with recenter
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *positions = self.thisptr.getPositions().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>positions)
+
+    def getFrameCounter(self):
+        """
+        :return: number of frames accumulated
+        :rtype: unsigned int
+        """
+        return self.thisptr.getFrameCounter()
+
+cdef class FFTRDF:
+    """ Computes RDF for supplied data from the correlation of density grids
+
+    Gives the same :math:`g \\left( r \\right)` as :py:class:`freud.density.RDF`, to within about the size of a grid \
+    cell, but bins the points on a periodic grid of width cells along each side of the box and counts the pairs at \
+    every displacement of the grid with fast Fourier transforms. The cost does not grow with rmax, so this is much \
+    faster than :py:class:`freud.density.RDF` when rmax is a large fraction of the box, where a cell list visits all \
+    the pairs. The grid cells should be a fraction of dr.
+
+    .. note::
+        2D: FFTRDF properly handles 2D boxes. Requires the points to be passed in [x, y, 0]. Failing to z=0 will lead \
+        to undefined behavior.
+
+    :param rmax: maximum distance to calculate
+    :param dr: distance between histogram bins
+    :param width: number of grid cells along each side of the box, a power of two
+    :type rmax: float
+    :type dr: float
+    :type width: unsigned int
+    """
+    cdef density.FFTRDF *thisptr
+
+    def __cinit__(self, float rmax, float dr, unsigned int width):
+        if dr <= 0.0:
+            raise ValueError("dr must be > 0")
+        self.thisptr = new density.FFTRDF(rmax, dr, width)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def accumulate(self, box, ref_points, points):
+        """
+        Calculates the rdf and adds to the current rdf histogram.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the local density
+        :param points: points to calculate the local density
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        # keep a single array for the rdf of a set of points with itself so that the self pairs are left out
+        same_points = points is ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if same_points:
+            points = ref_points
+        else:
+            points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+                dim_message="points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3 or points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p)
+
+    def compute(self, box, ref_points, points):
+        """
+        Calculates the rdf for the specified points. Will overwrite the current histogram.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the local density
+        :param points: points to calculate the local density
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        self.thisptr.resetRDF()
+        self.accumulate(box, ref_points, points)
+
+    def resetRDF(self):
+        """
+        resets the values of RDF in memory
+        """
+        self.thisptr.resetRDF()
+
+    def reduceRDF(self):
+        """
+        Averages the accumulated frames. This is called automatically by :py:meth:`freud.density.FFTRDF.getRDF()`, \
+        :py:meth:`freud.density.FFTRDF.getNr()`.
+        """
+        with nogil:
+            self.thisptr.reduceRDF()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box that normalizes the result stays that of this object,
+        unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, FFTRDF other):
+        """Add the accumulated state of another :py:class:`freud.density.FFTRDF` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.density.FFTRDF`
+        """
+        self.thisptr.merge(dereference(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
+
+    def getRDF(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: histogram of rdf values
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf = self.thisptr.getRDF().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>rdf, out)
+
+    def getR(self):
+        """
+        :return: values of the histogram bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
+
+    def getNr(self, out=None):
+        """
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: histogram of cumulative rdf values
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *Nr = self.thisptr.getNr().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>Nr, out)
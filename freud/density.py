@@ -11,6 +11,11 @@ __all__ = ['RDF']
 from ._freud import GaussianDensity;
 from ._freud import LocalDensity;
 from ._freud import RDF;
+from ._freud import PartialRDF;
+from ._freud import GroupedRDF;
+from ._freud import AngularRDF;
+from ._freud import DensityProfile;
+from ._freud import FFTRDF;
 from ._freud import ComplexCF;
 from ._freud import FloatCF;
 
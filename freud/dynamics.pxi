@@ -0,0 +1,265 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from freud.util._Boost cimport shared_array
+from freud.util._VectorMath cimport vec3
+cimport freud._box as _box
+cimport freud._dynamics as dynamics
+import numpy as np
+cimport numpy as np
+
+# Numpy must be initialized. When using numpy from C or Cython you must
+# _always_ do that, or you will have segfaults
+np.import_array()
+
+cdef class MultipleTau:
+    """Computes the time autocorrelation :math:`\\left< A(t) \\cdot A(t + \\tau) \\right>` of per-particle values \
+    fed one frame at a time.
+
+    Instead of keeping the whole trajectory in memory, the multiple-tau correlator keeps the last block_size frames
+    of a hierarchy of levels, each level seeing the trajectory coarsened by averaging consecutive frames. The
+    correlation is thus computed at lags spaced logarithmically over the whole trajectory, with a memory that only
+    grows with the logarithm of the number of frames. The lags up to block_size - 1 frames are exact; longer lags
+    are computed from averaged frames.
+
+    The product of two values is the dot product of their components. The real part of the correlation of complex
+    values :math:`\\left< a(t) b^*(t + \\tau) \\right>` is found by feeding their real and imaginary parts as two
+    components. The correlation is averaged over the particles and over all time origins of each lag.
+
+    :param num_values: number of values (particles) of each frame
+    :param dimensions: number of components of each value
+    :param block_size: number of lags correlated by each level
+    :param averaging: number of frames of a level averaged into one frame of the next level
+    :type num_values: unsigned int
+    :type dimensions: unsigned int
+    :type block_size: unsigned int
+    :type averaging: unsigned int
+    """
+    cdef dynamics.MultipleTau *thisptr
+
+    def __cinit__(self, unsigned int num_values, unsigned int dimensions=1, unsigned int block_size=16,
+                  unsigned int averaging=2):
+        self.thisptr = new dynamics.MultipleTau(num_values, dimensions, block_size, averaging)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def accumulate(self, values):
+        """
+        Adds a frame to the correlation.
+
+        :param values: values of the frame
+        :type values: :class:`numpy.ndarray`, shape=(:math:`N_{values}`) or (:math:`N_{values}`, \
+            :math:`N_{dimensions}`), dtype= :class:`numpy.float32`
+        """
+        values = np.ascontiguousarray(values, dtype=np.float32)
+        cdef unsigned int dimensions = self.thisptr.getDimensions()
+        if values.ndim == 1 and dimensions == 1:
+            values = values.reshape((-1, 1))
+        if values.ndim != 2 or values.shape[1] != dimensions:
+            raise ValueError("values must have shape (num_values, {})".format(dimensions))
+        cdef np.ndarray[float, ndim=2] l_values = values
+        cdef unsigned int num_values = <unsigned int> values.shape[0]
+        with nogil:
+            self.thisptr.accumulate(<float*>l_values.data, num_values)
+
+    def reset(self):
+        """
+        Forgets all the frames that were added.
+        """
+        self.thisptr.reset()
+
+    def getFrameCounter(self):
+        """
+        :return: number of frames that were added
+        :rtype: unsigned int
+        """
+        return self.thisptr.getFrameCounter()
+
+    def getLags(self):
+        """
+        :return: lags at which the correlation was computed, in frames
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{lags}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *lags = self.thisptr.getLags().get()
+        cdef np.npy_intp nlags[1]
+        nlags[0] = <np.npy_intp>self.thisptr.getNumLags()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nlags, np.NPY_UINT32, <void*>lags)
+        # the arrays are reallocated when frames are added, so the result does not share their memory
+        return np.copy(result)
+
+    def getCorrelation(self):
+        """
+        :return: correlation at each lag
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{lags}`), dtype= :class:`numpy.float64`
+        """
+        cdef double *correlation = self.thisptr.getCorrelation().get()
+        cdef np.npy_intp nlags[1]
+        nlags[0] = <np.npy_intp>self.thisptr.getNumLags()
+        cdef np.ndarray[np.float64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nlags, np.NPY_FLOAT64,
+            <void*>correlation)
+        return np.copy(result)
+
+    def getCounts(self):
+        """
+        :return: number of time origins averaged at each lag
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{lags}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *counts = self.thisptr.getCounts().get()
+        cdef np.npy_intp nlags[1]
+        nlags[0] = <np.npy_intp>self.thisptr.getNumLags()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nlags, np.NPY_UINT32, <void*>counts)
+        return np.copy(result)
+
+cdef class MSD:
+    """Computes the mean squared displacement :math:`\\left< \\left| \\vec{r}(t + m) - \\vec{r}(t) \\right|^2 \\right>` \
+    of a trajectory, averaged over the particles and over all time origins of each lag :math:`m`.
+
+    The sum over the time origins is computed from the autocorrelation of the positions with fast Fourier
+    transforms, which costs :math:`O(T \\log T)` per particle for :math:`T` frames instead of :math:`O(T^2)`.
+
+    The positions are either unwrapped or given along with the image flags of the box, as in
+    :py:meth:`freud.box.Box.unwrap()`.
+    """
+    cdef dynamics.MSD *thisptr
+
+    def __cinit__(self):
+        self.thisptr = new dynamics.MSD()
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, box, positions, images=None):
+        """
+        Calculates the MSD of a trajectory.
+
+        :param box: simulation box the image flags refer to
+        :param positions: positions of each particle in each frame
+        :param images: image flags of each position (optional, the positions are unwrapped when not given)
+        :type box: :py:class:`freud.box.Box`
+        :type positions: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`, :math:`N_{particles}`, 3), \
+            dtype= :class:`numpy.float32`
+        :type images: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`, :math:`N_{particles}`, 3), \
+            dtype= :class:`numpy.int32`
+        """
+        positions = freud.common.convert_array(positions, 3, dtype=np.float32, contiguous=True,
+            dim_message="positions must be a 3 dimensional array")
+        if positions.shape[2] != 3:
+            raise ValueError("the 3rd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=3] l_positions = positions
+        cdef np.ndarray[int, ndim=3] l_images
+        cdef vec3[int] *images_ptr = NULL
+        if images is not None:
+            images = freud.common.convert_array(images, 3, dtype=np.int32, contiguous=True,
+                dim_message="images must be a 3 dimensional array")
+            if images.shape != positions.shape:
+                raise ValueError("images must have the same shape as positions")
+            l_images = images
+            images_ptr = <vec3[int]*>l_images.data
+        cdef unsigned int num_frames = <unsigned int> positions.shape[0]
+        cdef unsigned int n_p = <unsigned int> positions.shape[1]
+        cdef _box.Box l_box = cpp_box(box)
+        with nogil:
+            self.thisptr.compute(l_box, <vec3[float]*>l_positions.data, images_ptr, num_frames, n_p)
+
+    def getMSD(self):
+        """
+        :return: MSD at each lag of 0 to :math:`N_{frames} - 1` frames
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`), dtype= :class:`numpy.float64`
+        """
+        cdef double *msd = self.thisptr.getMSD().get()
+        cdef np.npy_intp nframes[1]
+        nframes[0] = <np.npy_intp>self.thisptr.getNumFrames()
+        cdef np.ndarray[np.float64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nframes, np.NPY_FLOAT64, <void*>msd)
+        return result
+
+cdef class Displacement:
+    """Follows the particles of a stream of frames of wrapped positions.
+
+    Each frame passed to :py:meth:`update()` is compared with the previous one in a single parallel pass over the
+    particles, which computes the minimum image displacement of each particle, updates its image flags and finds the
+    largest displacement, instead of subtracting the frames and wrapping the differences in numpy. The image flags
+    count from the first frame, so that the positions unwrapped with them by :py:meth:`freud.box.Box.unwrap()` are
+    continuous, and they can be passed to :py:class:`freud.dynamics.MSD` along with the positions.
+
+    .. note::
+        The particles must move by less than half the box between two frames, and the box should stay the same.
+    """
+    cdef dynamics.Displacement *thisptr
+
+    def __cinit__(self):
+        self.thisptr = new dynamics.Displacement()
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box of the last frame
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def update(self, box, points):
+        """
+        Compares a frame with the previous one. The first frame, and any frame of a different number of particles, \
+        starts the stream again with zero displacements and image flags.
+
+        :param box: simulation box
+        :param points: wrapped positions of the particles
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        with nogil:
+            self.thisptr.update(l_box, <vec3[float]*>l_points.data, n_p)
+
+    def reset(self):
+        """
+        Forgets the previous frame and the image flags
+        """
+        self.thisptr.reset()
+
+    def getDisplacements(self):
+        """
+        :return: minimum image displacement of each particle since the previous frame
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        cdef vec3[float] *displacements = self.thisptr.getDisplacements().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = 3
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>displacements)
+        return result
+
+    def getImages(self):
+        """
+        :return: image flags of each particle since the first frame
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.int32`
+        """
+        cdef vec3[int] *images = self.thisptr.getImages().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = 3
+        cdef np.ndarray[np.int32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_INT32, <void*>images)
+        return result
+
+    def getMaxDisplacement(self):
+        """
+        :return: largest displacement since the previous frame
+        :rtype: float
+        """
+        return self.thisptr.getMaxDisplacement()
+
+    def getFrameCounter(self):
+        """
+        :return: number of frames since the stream started
+        :rtype: unsigned int
+        """
+        return self.thisptr.getFrameCounter()
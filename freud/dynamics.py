@@ -0,0 +1,11 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+## \package freud.dynamics
+#
+# Methods to compute time correlations of particle trajectories
+#
+
+from ._freud import MultipleTau
+from ._freud import MSD
+from ._freud import Displacement
@@ -1,9 +1,10 @@
 # Copyright (c) 2010-2016 The Regents of the University of Michigan
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
-from freud.util._VectorMath cimport vec3
+from freud.util._VectorMath cimport vec3, quat
 cimport freud._interface as interface
 cimport freud._box as _box;
+cimport freud._locality as locality
 from cython.operator cimport dereference
 import numpy as np
 cimport numpy as np
@@ -21,20 +22,22 @@ cdef class InterfaceMeasure:
     cdef interface.InterfaceMeasure *thisptr
 
     def __cinit__(self, box, float r_cut):
-        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box cBox = cpp_box(box)
         self.thisptr = new interface.InterfaceMeasure(cBox, r_cut)
 
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, ref_points, points):
+    def compute(self, ref_points, points, nlist=None):
         """Compute and return the number of particles at the interface between
         the two given sets of points.
 
         :param ref_points: one set of particle positions
         :param points: other set of particle positions
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -46,4 +49,125 @@ cdef class InterfaceMeasure:
         cdef unsigned int n_ref = ref_points.shape[0]
         cdef np.ndarray cPoints = points
         cdef unsigned int Np = points.shape[0]
-        return self.thisptr.compute(<vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        cdef unsigned int count
+        with nogil:
+            count = self.thisptr.compute(<vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np, cNlist)
+        return count
+
+    def getInterfaceMask(self):
+        """Get whether each reference point of the last :py:meth:`compute()` is within r_cut of any point
+
+        :return: interface mask
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.bool`
+        """
+        cdef void *mask = <void*> self.thisptr.getInterfaceMask().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNRef()
+        cdef np.ndarray result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_BOOL, mask)
+        return result
+
+    def computeShapes(self, ref_points, ref_orientations, points, orientations, split_points):
+        """Compute and return the number of split points of the reference shapes within r_cut of any split point
+        of the shapes, as :py:meth:`compute()` would on the split points of :py:class:`freud.split.ShapeSplit`,
+        without building them
+
+        The interface mask of :py:meth:`getInterfaceMask()` then has one entry per split point of each reference
+        shape. The box must be at least twice as large as r_cut plus the diameter of the split points.
+
+        :param ref_points: centers of the reference shapes
+        :param ref_orientations: orientations of the reference shapes as quaternions
+        :param points: centers of the other shapes
+        :param orientations: orientations of the other shapes as quaternions
+        :param split_points: split points in the frame of a shape, shared by both sets of shapes
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`, 3), dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{ref}`, 4), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 4), dtype= :class:`numpy.float32`
+        :type split_points: :class:`numpy.ndarray`, shape=(:math:`N_{split}`, 3), dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+        split_points = freud.common.convert_array(split_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="split_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3 or points.shape[1] != 3 or split_points.shape[1] != 3:
+            raise RuntimeError('Need to provide array with x, y, z positions')
+        if ref_orientations.shape[1] != 4 or orientations.shape[1] != 4:
+            raise RuntimeError('Need to provide array with quaternion orientations')
+        if ref_orientations.shape[0] != ref_points.shape[0] or orientations.shape[0] != points.shape[0]:
+            raise RuntimeError('Need one orientation per point')
+        cdef np.ndarray cRef_points = ref_points
+        cdef np.ndarray cRef_orientations = ref_orientations
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef np.ndarray cOrientations = orientations
+        cdef unsigned int Np = points.shape[0]
+        cdef np.ndarray cSplit_points = split_points
+        cdef unsigned int Nsplit = split_points.shape[0]
+        cdef unsigned int count
+        with nogil:
+            count = self.thisptr.computeShapes(<vec3[float]*> cRef_points.data, <quat[float]*> cRef_orientations.data,
+                                               n_ref, <vec3[float]*> cPoints.data, <quat[float]*> cOrientations.data,
+                                               Np, <vec3[float]*> cSplit_points.data, Nsplit)
+        return count
+
+    def computeTypes(self, points, types, num_types=None):
+        """Compute the interfaces between every pair of types of one set of typed points at once, with a single
+        cell list over all of them
+
+        :param points: particle positions of all the types
+        :param types: type of each particle
+        :param num_types: number of types, by default one more than the largest type
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type types: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        :type num_types: unsigned int
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        types = freud.common.convert_array(types, 1, dtype=np.uint32, contiguous=True,
+            dim_message="types must be a 1 dimensional array")
+        if points.shape[1] != 3:
+            raise RuntimeError('Need to provide array with x, y, z positions')
+        if types.shape[0] != points.shape[0]:
+            raise RuntimeError('Need one type per point')
+        if num_types is None:
+            num_types = int(np.max(types)) + 1 if len(types) else 1
+        cdef np.ndarray cPoints = points
+        cdef np.ndarray cTypes = types
+        cdef unsigned int Np = points.shape[0]
+        cdef unsigned int cNum_types = num_types
+        with nogil:
+            self.thisptr.computeTypes(<vec3[float]*> cPoints.data, <unsigned int*> cTypes.data, Np, cNum_types)
+
+    def getTypeMask(self):
+        """Get whether each point of the last :py:meth:`computeTypes()` is within r_cut of a point of each type,
+        not counting itself
+
+        :return: type mask
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_{types}\\right)`, dtype= :class:`numpy.bool`
+        """
+        cdef void *mask = <void*> self.thisptr.getTypeMask().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumTypes()
+        cdef np.ndarray result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_BOOL, mask)
+        return result
+
+    def getTypeCounts(self):
+        """Get the number of points of each type a within r_cut of a point of each type b, the interface of a with b
+
+        :return: interface sizes, indexed by [a, b]
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{types}, N_{types}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *counts = self.thisptr.getTypeCounts().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumTypes()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumTypes()
+        cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32, <void*>counts)
+        return result
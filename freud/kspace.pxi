@@ -4,6 +4,10 @@
 from freud.util._Boost cimport shared_array
 from freud.util._VectorMath cimport vec3, quat
 from libcpp.complex cimport complex
+cimport freud._box as _box
+cimport freud._locality as locality
+from libc.string cimport memcpy
+from libcpp.vector cimport vector
 import numpy as np
 cimport numpy as np
 cimport freud._kspace as kspace
@@ -29,7 +33,8 @@ cdef class FTdelta:
 
     def compute(self):
         """Perform transform and store result internally"""
-        self.thisptr.compute()
+        with nogil:
+            self.thisptr.compute()
 
     def getFT(self):
         """Return the FT values"""
@@ -90,6 +95,47 @@ cdef class FTdelta:
         """
         self.thisptr.set_density(density)
 
+    def setUseGPU(self, use_gpu):
+        """Set whether :py:meth:`compute()` sums the phases of the particles on a CUDA GPU, the form factor being
+        applied on the CPU. The K points are copied to the GPU when they are set. The transform only differs from
+        the CPU within rounding. Raises RuntimeError when freud was built without CUDA, see the ENABLE_CUDA option
+        of CMake, or no device is found.
+
+        :param use_gpu: whether to compute on the GPU
+        :type use_gpu: bool
+        """
+        self.thisptr.setUseGPU(use_gpu)
+
+    def getUseGPU(self):
+        """Get whether :py:meth:`compute()` sums the phases on the GPU
+
+        :return: use_gpu
+        :rtype: bool
+        """
+        cdef bint use_gpu = self.thisptr.getUseGPU()
+        return use_gpu
+
+    def setNUFFTTolerance(self, tolerance):
+        """Set the tolerance of the non uniform FFT that :py:meth:`compute()` sums the phases of the particles with,
+        or 0 to sum them directly. The particles are spread with a Gaussian on a grid, whose transform is
+        interpolated at the K points, which costs :math:`O(N_{particles} + M \\log M + N_{K})` instead of
+        :math:`O(N_{particles} N_{K})`, the size M of the grid growing with the extent of the particles times that
+        of the K points. The error of the sums is below the tolerance times the number of particles. It is used
+        instead of the GPU, when both are set.
+
+        :param tolerance: relative error, 0 or between 1e-12 and 0.1
+        :type tolerance: float
+        """
+        self.thisptr.setNUFFTTolerance(tolerance)
+
+    def getNUFFTTolerance(self):
+        """Get the tolerance of the non uniform FFT, 0 when :py:meth:`compute()` sums the phases directly
+
+        :return: tolerance
+        :rtype: float
+        """
+        return self.thisptr.getNUFFTTolerance()
+
 cdef class FTsphere:
     """
     .. moduleauthor:: Jens Glaser <jsglaser@umich.edu>
@@ -107,7 +153,8 @@ cdef class FTsphere:
 
     def compute(self):
         """Perform transform and store result internally"""
-        self.thisptr.compute()
+        with nogil:
+            self.thisptr.compute()
 
     def getFT(self):
         """Return the FT values"""
@@ -167,6 +214,47 @@ cdef class FTsphere:
         """Set particle volume according to radius"""
         self.thisptr.set_radius(radius)
 
+    def setUseGPU(self, use_gpu):
+        """Set whether :py:meth:`compute()` sums the phases of the particles on a CUDA GPU, the form factor being
+        applied on the CPU. The K points are copied to the GPU when they are set. The transform only differs from
+        the CPU within rounding. Raises RuntimeError when freud was built without CUDA, see the ENABLE_CUDA option
+        of CMake, or no device is found.
+
+        :param use_gpu: whether to compute on the GPU
+        :type use_gpu: bool
+        """
+        self.thisptr.setUseGPU(use_gpu)
+
+    def getUseGPU(self):
+        """Get whether :py:meth:`compute()` sums the phases on the GPU
+
+        :return: use_gpu
+        :rtype: bool
+        """
+        cdef bint use_gpu = self.thisptr.getUseGPU()
+        return use_gpu
+
+    def setNUFFTTolerance(self, tolerance):
+        """Set the tolerance of the non uniform FFT that :py:meth:`compute()` sums the phases of the particles with,
+        or 0 to sum them directly. The particles are spread with a Gaussian on a grid, whose transform is
+        interpolated at the K points, which costs :math:`O(N_{particles} + M \\log M + N_{K})` instead of
+        :math:`O(N_{particles} N_{K})`, the size M of the grid growing with the extent of the particles times that
+        of the K points. The error of the sums is below the tolerance times the number of particles. It is used
+        instead of the GPU, when both are set.
+
+        :param tolerance: relative error, 0 or between 1e-12 and 0.1
+        :type tolerance: float
+        """
+        self.thisptr.setNUFFTTolerance(tolerance)
+
+    def getNUFFTTolerance(self):
+        """Get the tolerance of the non uniform FFT, 0 when :py:meth:`compute()` sums the phases directly
+
+        :return: tolerance
+        :rtype: float
+        """
+        return self.thisptr.getNUFFTTolerance()
+
 cdef class FTpolyhedron:
     """
     .. moduleauthor:: Jens Glaser <jsglaser@umich.edu>
@@ -184,7 +272,36 @@ cdef class FTpolyhedron:
 
     def compute(self):
         """Perform transform and store result internally"""
-        self.thisptr.compute()
+        with nogil:
+            self.thisptr.compute()
+
+    def set_orientation_tolerance(self, float tolerance):
+        """Set the tolerance below which orientations share their form factor
+
+        The form factor is computed once per K point and distinct orientation. With a positive tolerance, the
+        orientations whose quaternion components round to the same multiple of it are merged as well.
+
+        :param tolerance: tolerance of the quaternion components, 0 to only merge identical rotations
+        :type tolerance: float
+        """
+        self.thisptr.set_orientation_tolerance(tolerance)
+
+    def getNumOrientations(self):
+        """Get the number of distinct orientations of the last computation
+
+        :return: number of orientations
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumOrientations()
+
+    def getNumCachedOrientations(self):
+        """Get the number of orientations whose form factors at the K points are kept for the next computations,
+        until the K points, the parameters or the orientation tolerance change
+
+        :return: number of orientations
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumCachedOrientations()
 
     def getFT(self):
         """Return the FT values"""
@@ -299,3 +416,547 @@ cdef class FTpolyhedron:
         :type density: float complex
         """
         self.thisptr.set_density(density)
+
+cdef class FTcomposite:
+    """Sum of the Fourier transforms of several particle types at the same K points.
+
+    Each type is an :py:class:`~.FTdelta`, :py:class:`~.FTsphere` or :py:class:`~.FTpolyhedron` holding its own
+    particles, parameters and K points, which must number the same for all the types. The K points are traversed once
+    in parallel and every type adds its weighted transform to each block of them, instead of computing the types one
+    after the other and summing the results.
+    """
+    cdef kspace.FTcomposite *thisptr
+    # the types, kept alive as long as the sum refers to them
+    cdef list types
+
+    def __cinit__(self):
+        self.thisptr = new kspace.FTcomposite()
+        self.types = []
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def add(self, ft, float weight=1.0):
+        """Add a type to the sum
+
+        :param ft: calculator of the type
+        :param weight: factor of the transform of the type in the sum
+        :type ft: :py:class:`~.FTdelta`, :py:class:`~.FTsphere` or :py:class:`~.FTpolyhedron`
+        :type weight: float
+        """
+        cdef kspace.FTdelta *ptr
+        if isinstance(ft, FTdelta):
+            ptr = (<FTdelta>ft).thisptr
+        elif isinstance(ft, FTsphere):
+            ptr = <kspace.FTdelta*>(<FTsphere>ft).thisptr
+        elif isinstance(ft, FTpolyhedron):
+            ptr = <kspace.FTdelta*>(<FTpolyhedron>ft).thisptr
+        else:
+            raise TypeError("ft must be an FTdelta, FTsphere or FTpolyhedron")
+        self.types.append(ft)
+        self.thisptr.add(ptr, weight)
+
+    def clear(self):
+        """Remove all the types"""
+        self.thisptr.clear()
+        self.types = []
+
+    def getNumTypes(self):
+        """
+        :return: number of types
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumTypes()
+
+    def compute(self):
+        """Compute the sum of the transforms of the types"""
+        with nogil:
+            self.thisptr.compute()
+
+    def getFT(self):
+        """
+        :return: sum of the transforms at each K point
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.complex64`
+        """
+        cdef unsigned int NK = self.thisptr.getNK()
+        result = np.zeros([NK], dtype=np.complex64)
+        if not NK:
+            return result
+        cdef (float complex)* ft_points = self.thisptr.getFT().get()
+        cdef float complex[:] flatBuffer = <float complex[:NK]> ft_points
+        result.flat[:] = flatBuffer
+        return result
+
+cdef class IntermediateScattering:
+    """Accumulates the coherent intermediate scattering function \
+    :math:`F(q, t) = \\left< \\rho(\\vec{q}, t_0 + t) \\rho(-\\vec{q}, t_0) \\right> / N` of a trajectory fed one \
+    frame at a time, averaged over shells of wave vectors and over time origins.
+
+    The wave vectors are the reciprocal lattice vectors of the box with lengths up to q_max, in shells of width dq,
+    with at most max_vectors of them in each shell. Each frame computes the density modes
+    :math:`\\rho(\\vec{q}) = \\sum_j e^{i \\vec{q} \\cdot \\vec{r}_j}` in one pass over the points and correlates
+    them with the modes of the last num_lags frames, which are kept in memory.
+
+    :param box: simulation box of the trajectory
+    :param q_max: upper bound of the lengths of the wave vectors
+    :param dq: width of the shells of wave vectors
+    :param num_lags: number of lags, of 0 to num_lags - 1 frames
+    :param max_vectors: largest number of wave vectors of each shell
+    :type box: :py:class:`freud.box.Box`
+    :type q_max: float
+    :type dq: float
+    :type num_lags: unsigned int
+    :type max_vectors: unsigned int
+    """
+    cdef kspace.IntermediateScattering *thisptr
+
+    def __cinit__(self, box, float q_max, float dq, unsigned int num_lags, unsigned int max_vectors=32):
+        cdef _box.Box cBox = cpp_box(box)
+        self.thisptr = new kspace.IntermediateScattering(cBox, q_max, dq, num_lags, max_vectors)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def accumulate(self, points):
+        """Adds a frame to F(q, t).
+
+        :param points: points of the frame, the same number in every frame
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        with nogil:
+            self.thisptr.accumulate(<vec3[float]*>l_points.data, n_p)
+
+    def reset(self):
+        """Forgets all the frames that were added."""
+        self.thisptr.reset()
+
+    def getFrameCounter(self):
+        """
+        :return: number of frames that were added
+        :rtype: unsigned int
+        """
+        return self.thisptr.getFrameCounter()
+
+    def getVectors(self):
+        """
+        :return: wave vectors
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{vectors}`, 3), dtype= :class:`numpy.float32`
+        """
+        cdef unsigned int num_vectors = self.thisptr.getNumVectors()
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.zeros((num_vectors, 3), dtype=np.float32)
+        if num_vectors:
+            memcpy(result.data, &self.thisptr.getVectors()[0], num_vectors*sizeof(vec3[float]))
+        return result
+
+    def getQ(self):
+        """
+        :return: mean length of the wave vectors of each shell
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{shells}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *q = self.thisptr.getQ().get()
+        cdef np.npy_intp nshells[1]
+        nshells[0] = <np.npy_intp>self.thisptr.getNumShells()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nshells, np.NPY_FLOAT32, <void*>q)
+        return result
+
+    def getShellCounts(self):
+        """
+        :return: number of wave vectors of each shell
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{shells}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *counts = self.thisptr.getShellCounts().get()
+        cdef np.npy_intp nshells[1]
+        nshells[0] = <np.npy_intp>self.thisptr.getNumShells()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nshells, np.NPY_UINT32,
+            <void*>counts)
+        return result
+
+    def getF(self):
+        """
+        :return: F(q, t) at each lag and shell
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{lags}`, :math:`N_{shells}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *F = self.thisptr.getF().get()
+        cdef np.npy_intp dims[2]
+        dims[0] = <np.npy_intp>self.thisptr.getNumLags()
+        dims[1] = <np.npy_intp>self.thisptr.getNumShells()
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, dims, np.NPY_FLOAT32, <void*>F)
+        return result
+
+    def getCounts(self):
+        """
+        :return: number of time origins of each lag
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{lags}`), dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *counts = self.thisptr.getCounts().get()
+        cdef np.npy_intp nlags[1]
+        nlags[0] = <np.npy_intp>self.thisptr.getNumLags()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nlags, np.NPY_UINT32, <void*>counts)
+        return result
+
+cdef class StructureFactor:
+    """Computes the static structure factor \
+    :math:`S(\\vec{q}) = \\left| \\sum_j e^{i \\vec{q} \\cdot \\vec{r}_j} \\right|^2 / N^2` of a set of points on the
+    grid of wave vectors :math:`\\vec{q} = (h \\frac{2\\pi}{L_x}, k \\frac{2\\pi}{L_y}, l \\frac{2\\pi}{L_z})` for
+    integer :math:`h, k, l` in :math:`[-g, g]`.
+
+    :py:meth:`~.StructureFactor.computeDirect()` evaluates the sums exactly, in parallel over the points.
+    :py:meth:`~.StructureFactor.computeFFT()` deposits the points on a periodic mesh with cloud in cell weights and
+    takes its Fourier transform instead, which is much faster for many points and large grids. Its error comes from
+    the wave vectors beyond the mesh folded onto the grid and shrinks as the square of the mesh spacing.
+
+    The arrays are indexed like those of :py:class:`freud.kspace.SFactor3DPoints`: S[c, b, a] is the value at
+    :math:`h = a - g, k = b - g, l = c - g`.
+
+    :param g: largest index of the wave vectors along each axis
+    :type g: unsigned int
+    """
+    cdef kspace.StructureFactor *thisptr
+
+    def __cinit__(self, unsigned int g):
+        self.thisptr = new kspace.StructureFactor(g)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def computeDirect(self, box, points):
+        """Computes the sums at each wave vector exactly.
+
+        :param box: simulation box, which sets the wave vectors
+        :param points: points to compute the structure factor of
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box cBox = cpp_box(box)
+        with nogil:
+            self.thisptr.computeDirect(cBox, <vec3[float]*>l_points.data, n_p)
+
+    def computeFFT(self, box, points, unsigned int width):
+        """Computes the sums at each wave vector from the Fourier transform of the points deposited on a mesh.
+
+        :param box: simulation box without tilt, which sets the wave vectors
+        :param points: points to compute the structure factor of
+        :param width: number of nodes of the mesh along each axis, a power of two greater than 2g
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type width: unsigned int
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box cBox = cpp_box(box)
+        with nogil:
+            self.thisptr.computeFFT(cBox, <vec3[float]*>l_points.data, n_p, width)
+
+    def getS(self):
+        """
+        :return: static structure factor at each wave vector
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`2g+1`, :math:`2g+1`, :math:`2g+1`), \
+        dtype= :class:`numpy.float32`
+        """
+        cdef float *S = self.thisptr.getS().get()
+        cdef np.npy_intp dims[3]
+        dims[0] = dims[1] = dims[2] = <np.npy_intp>self.thisptr.getGridWidth()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, dims, np.NPY_FLOAT32, <void*>S)
+        return result
+
+    def getSComplex(self):
+        """
+        :return: sums at each wave vector divided by the number of points, before taking their magnitude squared
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`2g+1`, :math:`2g+1`, :math:`2g+1`), \
+        dtype= :class:`numpy.complex64`
+        """
+        cdef (float complex)* S = self.thisptr.getSComplex().get()
+        cdef np.npy_intp dims[3]
+        dims[0] = dims[1] = dims[2] = <np.npy_intp>self.thisptr.getGridWidth()
+        result = np.PyArray_SimpleNewFromData(3, dims, np.NPY_COMPLEX64, S)
+        return result
+
+def shellAverage(S):
+    """Averages a structure factor laid out like the one of :py:class:`~.StructureFactor` over the shells of equal
+    :math:`h^2 + k^2 + l^2`.
+
+    :param S: structure factor on a :math:`(2g+1)^3` grid
+    :type S: :class:`numpy.ndarray`, shape=(:math:`2g+1`, :math:`2g+1`, :math:`2g+1`), dtype= :class:`numpy.float32`
+    :return: the values of :math:`h^2 + k^2 + l^2` that occur on the grid and the mean of S over each of them
+    :rtype: (:class:`numpy.ndarray`, :class:`numpy.ndarray`)
+    """
+    S = freud.common.convert_array(S, 3, dtype=np.float32, contiguous=True,
+        dim_message="S must be a 3 dimensional array")
+    if S.shape[0] != S.shape[1] or S.shape[0] != S.shape[2] or S.shape[0] % 2 != 1:
+        raise ValueError("S must be a cube of odd width 2g+1")
+    cdef unsigned int g = S.shape[0] // 2
+    cdef np.ndarray[float, ndim=3] l_S = S
+    cdef np.ndarray[np.float64_t, ndim=1] sums = np.zeros(3*g*g + 1, dtype=np.float64)
+    cdef np.ndarray[np.uint32_t, ndim=1] counts = np.zeros(3*g*g + 1, dtype=np.uint32)
+    kspace.shellAverage(<float*>l_S.data, g, <double*>sums.data, <unsigned int*>counts.data)
+    qsq = np.nonzero(counts)[0]
+    return qsq, (sums[qsq]/counts[qsq]).astype(np.float32)
+
+def structureFactorFromRDF(rdf, rmax, density, rmin=0.0, window=True, oversample=4):
+    """Transforms a radial distribution function, such as the one of :py:class:`freud.density.RDF`, into the
+    isotropic structure factor :math:`S(q) = 1 + 4 \\pi \\rho \\int_{r_{min}}^{r_{max}} r^2 \\left( g(r) - 1 \\right)
+    \\frac{\\sin(q r)}{q r} W(r) dr` without another pass over the particles.
+
+    The sum over the bins is that of :py:class:`~.DebyeStructureFactor`, computed at all the q values at once by a
+    fast sine transform of :math:`O(M \\log M)`. The bins are zero padded to a transform of length M, the power of two
+    at least 2 x oversample times their number, which gives q values spaced by :math:`2 \\pi / (M dr)` up to
+    :math:`\\pi / dr`. The Lorch window :math:`W(r) = \\sin(\\pi r / r_{max}) / (\\pi r / r_{max})` damps the ripples
+    of the cut at rmax at the cost of broader peaks; without the window :math:`W(r) = 1`.
+
+    :param rdf: g(r) on evenly spaced bins from rmin to rmax
+    :param rmax: largest distance of the bins
+    :param density: number density of the points
+    :param rmin: smallest distance of the bins
+    :param window: True to apply the Lorch window
+    :param oversample: factor of the length of the transform over twice the number of bins
+    :type rdf: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+    :type rmax: float
+    :type density: float
+    :type rmin: float
+    :type window: bool
+    :type oversample: unsigned int
+    :return: the q values and S at each of them
+    :rtype: (:class:`numpy.ndarray`, :class:`numpy.ndarray`)
+    """
+    rdf = freud.common.convert_array(rdf, 1, dtype=np.float32, contiguous=True,
+        dim_message="rdf must be a 1 dimensional array")
+    cdef np.ndarray[float, ndim=1] l_rdf = rdf
+    cdef unsigned int nbins = rdf.shape[0]
+    cdef unsigned int l_oversample = oversample
+    cdef float l_rmin = rmin
+    cdef float l_rmax = rmax
+    cdef float l_density = density
+    cdef int l_window = 1 if window else 0
+    cdef unsigned int num_q = kspace.transformRDFNumQ(nbins, l_oversample)
+    cdef np.ndarray[np.float32_t, ndim=1] q = np.zeros(num_q, dtype=np.float32)
+    cdef np.ndarray[np.float32_t, ndim=1] S = np.zeros(num_q, dtype=np.float32)
+    with nogil:
+        kspace.transformRDF(<float*>l_rdf.data, nbins, l_rmin, l_rmax, l_density, l_window, l_oversample,
+                            <float*>q.data, <float*>S.data)
+    return q, S
+
+cdef class KPointStructureFactor:
+    """Accumulates the static structure factor :math:`S(\\vec{K}) = \\left< |\\rho(\\vec{K})|^2 / N \\right>` at
+    arbitrary K points, such as those of a detector, averaged over the frames of a trajectory fed one at a time,
+    with :math:`\\rho(\\vec{K}) = \\sum_j e^{i \\vec{K} \\cdot \\vec{r}_j}`.
+
+    The sums over the frames are kept in buffers allocated with the K points, so that each frame only adds to them.
+    The phases are summed directly in parallel over the K points, or with a non uniform FFT when a tolerance is set.
+
+    :param K: K points
+    :type K: :class:`numpy.ndarray`, shape=(:math:`N_{K}`, 3), dtype= :class:`numpy.float32`
+    """
+    cdef kspace.KPointStructureFactor *thisptr
+
+    def __cinit__(self, K):
+        K = freud.common.convert_array(K, 2, dtype=np.float32, contiguous=True,
+            dim_message="K must be a 2 dimensional array")
+        if K.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_K = K
+        self.thisptr = new kspace.KPointStructureFactor(<vec3[float]*>l_K.data, <unsigned int> K.shape[0])
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def accumulate(self, points):
+        """Adds a frame to S(K).
+
+        :param points: points of the frame
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        with nogil:
+            self.thisptr.accumulate(<vec3[float]*>l_points.data, n_p)
+
+    def reset(self):
+        """Forgets all the frames that were added."""
+        self.thisptr.reset()
+
+    def setNUFFTTolerance(self, tolerance):
+        """Set the tolerance of the non uniform FFT that the phases of the particles are summed with, or 0 to sum
+        them directly. The error of the sums is below the tolerance times the number of particles.
+
+        :param tolerance: relative error, 0 or between 1e-12 and 0.1
+        :type tolerance: float
+        """
+        self.thisptr.setNUFFTTolerance(tolerance)
+
+    def getNUFFTTolerance(self):
+        """
+        :return: tolerance of the non uniform FFT, 0 when the phases are summed directly
+        :rtype: float
+        """
+        return self.thisptr.getNUFFTTolerance()
+
+    def getFrameCounter(self):
+        """
+        :return: number of frames that were added
+        :rtype: unsigned int
+        """
+        return self.thisptr.getFrameCounter()
+
+    def getK(self):
+        """
+        :return: K points
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{K}`, 3), dtype= :class:`numpy.float32`
+        """
+        cdef unsigned int NK = self.thisptr.getNK()
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.zeros((NK, 3), dtype=np.float32)
+        if NK:
+            memcpy(result.data, &self.thisptr.getK()[0], NK*sizeof(vec3[float]))
+        return result
+
+    def getS(self):
+        """
+        :return: S at each K point, averaged over the frames
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *S = self.thisptr.getS().get()
+        cdef np.npy_intp NK[1]
+        NK[0] = <np.npy_intp>self.thisptr.getNK()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, NK, np.NPY_FLOAT32, <void*>S)
+        return result
+
+cdef class DebyeStructureFactor:
+    """Computes the spherically averaged static structure factor of a set of points with itself from the histogram \
+    of its pair distances, :math:`S(q) = 1 + 4 \\pi \\rho \\int_0^{r_{max}} r^2 \\left( g(r) - 1 \\right) \
+    \\frac{\\sin(q r)}{q r} W(r) dr`.
+
+    The pairs within rmax are binned like in :py:class:`freud.density.RDF`, which is much cheaper than computing S on
+    a 3D grid of wave vectors and averaging it over shells when many q values are needed. Cutting the integral at
+    rmax adds ripples to S, which the Lorch window :math:`W(r) = \\sin(\\pi r / r_{max}) / (\\pi r / r_{max})`
+    damps at the cost of broader peaks. Without the window :math:`W(r) = 1`.
+
+    :param rmax: largest pair distance, at most half the box
+    :param dr: width of the bins of the pair distances
+    :param q_max: largest q
+    :param num_q: number of q values, evenly spaced from q_min to q_max
+    :param q_min: smallest q
+    :param window: True to apply the Lorch window
+    :type rmax: float
+    :type dr: float
+    :type q_max: float
+    :type num_q: unsigned int
+    :type q_min: float
+    :type window: bool
+    """
+    cdef kspace.DebyeStructureFactor *thisptr
+
+    def __cinit__(self, float rmax, float dr, float q_max, unsigned int num_q, float q_min=0.0, window=True):
+        self.thisptr = new kspace.DebyeStructureFactor(rmax, dr, q_min, q_max, num_q, window)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box of the last frame
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def accumulate(self, box, points, nlist=None):
+        """Adds the pairs of a frame to the histogram.
+
+        :param box: simulation box
+        :param points: points of the frame
+        :param nlist: precomputed neighbor list of the points with themselves to use instead of building a cell list
+                      (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_points.data, n_p, cNlist)
+
+    def compute(self, box, points, nlist=None):
+        """Computes S for a single frame, forgetting the frames that were added before.
+
+        :param box: simulation box
+        :param points: points of the frame
+        :param nlist: precomputed neighbor list of the points with themselves to use instead of building a cell list
+                      (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        self.thisptr.reset()
+        self.accumulate(box, points, nlist)
+
+    def reset(self):
+        """Forgets all the frames that were added."""
+        self.thisptr.reset()
+
+    def getQ(self):
+        """
+        :return: q values
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_q`), dtype= :class:`numpy.float32`
+        """
+        cdef float *q = self.thisptr.getQ().get()
+        cdef np.npy_intp nq[1]
+        nq[0] = <np.npy_intp>self.thisptr.getNumQ()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nq, np.NPY_FLOAT32, <void*>q)
+        return result
+
+    def getS(self):
+        """
+        :return: S at each q value
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_q`), dtype= :class:`numpy.float32`
+        """
+        cdef float *S = self.thisptr.getS().get()
+        cdef np.npy_intp nq[1]
+        nq[0] = <np.npy_intp>self.thisptr.getNumQ()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nq, np.NPY_FLOAT32, <void*>S)
+        return result
+
+    def getR(self):
+        """
+        :return: centers of the bins of the pair distances
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getRDF().getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getRDF().getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
+        return result
+
+    def getRDF(self):
+        """
+        :return: radial distribution function S is computed from
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf = self.thisptr.getRDF().getRDF().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getRDF().getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>rdf)
+        return result
@@ -8,6 +8,13 @@ from math import *
 from ._freud import FTdelta as _FTdelta
 from ._freud import FTsphere as _FTsphere
 from ._freud import FTpolyhedron as _FTpolyhedron
+from ._freud import FTcomposite as _FTcomposite
+from ._freud import IntermediateScattering
+from ._freud import StructureFactor
+from ._freud import shellAverage
+from ._freud import DebyeStructureFactor
+from ._freud import structureFactorFromRDF
+from ._freud import KPointStructureFactor
 
 ## \package freud.kspace
 #
@@ -72,37 +79,42 @@ class SFactor3DPoints:
         if box.is2D():
             raise ValueError("SFactor3DPoints does not support 2D boxes")
 
+        self.box = box;
         self.grid = 2*g + 1;
         self.qx = numpy.linspace(-g * 2 * math.pi / box.getLx(), g * 2 * math.pi / box.getLx(), num=self.grid)
         self.qy = numpy.linspace(-g * 2 * math.pi / box.getLy(), g * 2 * math.pi / box.getLy(), num=self.grid)
         self.qz = numpy.linspace(-g * 2 * math.pi / box.getLz(), g * 2 * math.pi / box.getLz(), num=self.grid)
 
-        # make meshgrid versions of qx,qy,qz for easy computation later
-        self.qx_grid, self.qy_grid, self.qz_grid = meshgrid2(self.qx, self.qy, self.qz);
+        self.sfactor = StructureFactor(g);
 
-        # initialize a 0 S
-        self.s_complex = numpy.zeros(shape=(self.grid,self.grid,self.grid), dtype=numpy.complex64);
-
-    def compute(self, points):
+    def compute(self, points, method='direct', width=None):
         """Compute the static structure factor of a given set of points
 
         After calling :py:meth:`~.SFactor3DPoints.compute()`, you can access the results with :py:meth:`~.SFactor3DPoints.getS()`,
         :py:meth:`~.SFactor3DPoints.getSComplex()`, and the grid with :py:meth:`~.SFactor3DPoints.getQ()`.
 
+        The direct method sums the phases of the points exactly at every q. The fft method deposits the points on a
+        periodic mesh and takes its Fourier transform, which is much faster for many points and large g, at the cost
+        of an error that shrinks as the square of the mesh spacing. It needs a box without tilt.
+
         :param points: points used to compute the static structure factor
+        :param method: 'direct' or 'fft'
+        :param width: number of mesh nodes along each axis of the fft method, a power of two greater than 2g
+                      (defaults to the smallest one of at least 4g)
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
-        """
-        # clear s_complex to zero
-        self.s_complex[:,:,:] = 0;
-
-        # add the contribution of each point
-        for p in points:
-            self.s_complex += numpy.exp(1j * (self.qx_grid * p[0] + self.qy_grid * p[1] + self.qz_grid * p[2]));
-
-        # normalize
-        mid = self.grid // 2;
-        cinv = numpy.absolute(self.s_complex[mid,mid,mid]);
-        self.s_complex /= cinv;
+        :type method: str
+        :type width: int
+        """
+        if method == 'direct':
+            self.sfactor.computeDirect(self.box, points);
+        elif method == 'fft':
+            if width is None:
+                width = 2
+                while width < 4 * (self.grid // 2):
+                    width *= 2
+            self.sfactor.computeFFT(self.box, points, width);
+        else:
+            raise ValueError("method must be 'direct' or 'fft'")
 
     def getS(self):
         """Get the computed static structure factor
@@ -110,7 +122,7 @@ class SFactor3DPoints:
         :return: The computed static structure factor as a copy
         :rtype: :class:`numpy.ndarray`, shape=(X,Y), dtype= :class:`numpy.float32`
         """
-        return (self.s_complex * numpy.conj(self.s_complex)).astype(numpy.float32);
+        return numpy.copy(self.sfactor.getS());
 
     def getSComplex(self):
         """Get the computed complex structure factor (if you need the phase information)
@@ -118,7 +130,7 @@ class SFactor3DPoints:
         :return: The computed static structure factor, as a copy, without taking the magnitude squared
         :rtype: :class:`numpy.ndarray`, shape=(X,Y), dtype= :class:`numpy.complex64`
         """
-        return copy.cpy(self.s_complex)
+        return numpy.copy(self.sfactor.getSComplex());
 
     def getQ(self):
         """Get the q values at each point
@@ -158,7 +170,7 @@ class AnalyzeSFactor3D:
         """
         self.S = S;
         self.grid = S.shape[0];
-        self.g = self.grid/2;
+        self.g = self.grid // 2;
 
     def getPeakList(self, cut):
         """Get a list of peaks in the structure factor
@@ -196,20 +208,21 @@ class AnalyzeSFactor3D:
 
         return retval;
 
-    def getSvsQ(self):
+    def getSvsQ(self, average=False):
         """Get a list of all :math:`S\\left(\\left|q\\right|\\right)` values vs :math:`q^2`
 
+        :param average: when True, average S over each shell of equal :math:`q^2` and return one value per shell
+        :type average: bool
         :return: S, qsquared
         :rtype: :class:`numpy.ndarray`
         """
-        hx = range(-self.g, self.g+1);
+        if average:
+            qsq, S = shellAverage(self.S);
+            return (S, qsq)
 
-        qsq_list = [];
-        # create an list of q^2 in the proper order
-        for i in range(0,self.grid):
-            for j in range(0,self.grid):
-                for k in range(0,self.grid):
-                    qsq_list.append(hx[i]*hx[i] + hx[j] * hx[j] + hx[k] * hx[k]);
+        # q^2 in the order of the flattened S, indexed [c,b,a]
+        hx = numpy.arange(-self.g, self.g+1);
+        qsq_list = (hx[:,None,None]**2 + hx[None,:,None]**2 + hx[None,None,:]**2).flatten();
 
         return (self.S.flatten(), qsq_list)
 
@@ -557,10 +570,18 @@ class SingleCell3D:
         self.FT_valid = True
         shape = (len(self.Kpoints),)
         self.FT = numpy.zeros(shape, dtype=numpy.complex64)
+        # the native calculators are summed in a single sweep over the K points
+        composite = _FTcomposite()
         for i in self.active_types:
             calculator = self.ptype_ff[i]
-            calculator.compute()
-            self.FT += calculator.getFT()
+            if isinstance(getattr(calculator, 'FTobj', None), (_FTdelta, _FTsphere, _FTpolyhedron)):
+                composite.add(calculator.FTobj, calculator.scale**3)
+            else:
+                calculator.compute()
+                self.FT += calculator.getFT()
+        if composite.getNumTypes():
+            composite.compute()
+            self.FT += composite.getFT()
         return self.FT
 
 class FTfactory:
@@ -792,6 +813,14 @@ class FTdelta(FTbase):
         FTbase.set_rq(self, r, q)
         self.FTobj.set_rq(self.position, self.orientation)
 
+    def set_nufft_tolerance(self, tolerance):
+        """Set the tolerance of the non uniform FFT that sums the phases of the particles, 0 for the direct sum
+
+        :param tolerance: error of the sums relative to the number of particles, 0 or between 1e-12 and 0.1
+        :type tolerance: float
+        """
+        self.FTobj.setNUFFTTolerance(tolerance)
+
     def compute(self, *args, **kwargs):
         """Compute FT
 
@@ -895,6 +924,14 @@ class FTpolyhedron(FTbase):
             facet_offs[i+1] = facet_offs[i] + len(f)
         self.FTobj.set_params(verts, facet_offs, numpy.array([vi for f in facets for vi in f],dtype=numpy.uint32), norms, d, areas, volume)
 
+    def set_orientation_tolerance(self, tolerance):
+        """Set the tolerance below which orientations share their form factor
+
+        :param tolerance: tolerance of the quaternion components, 0 to only merge identical rotations
+        :type tolerance: float
+        """
+        self.FTobj.set_orientation_tolerance(tolerance)
+
     def set_radius(self, radius):
         """Set radius of in-sphere
 
@@ -2,12 +2,17 @@
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
 import sys
+import zlib
 from freud.util._VectorMath cimport vec3
+from freud.util._Index1D cimport Index3D
 cimport freud._locality as locality
 cimport freud._box as _box;
 from cython.operator cimport dereference
+from libcpp cimport bool as cbool
+from libcpp.memory cimport shared_ptr
 import numpy as np
 cimport numpy as np
+from libc.string cimport memcpy
 
 cdef class IteratorLinkCell:
     """Iterates over the particles in a cell.
@@ -48,6 +53,550 @@ cdef class IteratorLinkCell:
     def __iter__(self):
         return self
 
+cdef class NeighborList:
+    """Stores the bonds between a set of reference points and a set of points.
+
+    Bonds are sorted by the reference point index i; the bonds of reference point i are
+    ``getSegments()[i]`` to ``getSegments()[i+1]``. A NeighborList computed once by
+    :py:meth:`freud.locality.LinkCell.computeNlist` or :py:meth:`freud.locality.NearestNeighbors.compute`
+    can be passed as the ``nlist`` argument of other freud methods to reuse the same bonds instead of
+    rebuilding a cell list in every module.
+
+    .. moduleauthor:: Joshua Anderson <joaander@umich.edu>
+
+    Example::
+
+       lc = LinkCell(box, 1.5)
+       lc.computeNlist(box, positions)
+       nlist = lc.getNlist()
+       rdf.accumulate(box, positions, positions, nlist=nlist)
+    """
+    cdef locality.NeighborList *thisptr
+    cdef char _managed
+    cdef _base
+
+    def __cinit__(self):
+        self._managed = True
+        self.thisptr = new locality.NeighborList()
+
+    def __dealloc__(self):
+        if self._managed:
+            del self.thisptr
+
+    cdef refer_to(self, locality.NeighborList *other, base):
+        """Make this object a view of a C++ NeighborList owned by base"""
+        if self._managed:
+            del self.thisptr
+        self._managed = False
+        self.thisptr = other
+        self._base = base
+
+    @classmethod
+    def from_arrays(cls, num_i, num_j, index_i, index_j, distances):
+        """Create a NeighborList from a set of bond arrays.
+
+        :param num_i: number of reference points
+        :param num_j: number of points
+        :param index_i: reference point index of each bond, sorted in ascending order
+        :param index_j: point index of each bond
+        :param distances: distance of each bond
+        :type num_i: unsigned int
+        :type num_j: unsigned int
+        :type index_i: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.uint32`
+        :type index_j: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.uint32`
+        :type distances: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        index_i = freud.common.convert_array(index_i, 1, dtype=np.uint32, contiguous=True,
+            dim_message="index_i must be a 1 dimensional array")
+        index_j = freud.common.convert_array(index_j, 1, dtype=np.uint32, contiguous=True,
+            dim_message="index_j must be a 1 dimensional array")
+        distances = freud.common.convert_array(distances, 1, dtype=np.float32, contiguous=True,
+            dim_message="distances must be a 1 dimensional array")
+        if not (index_i.shape[0] == index_j.shape[0] == distances.shape[0]):
+            raise TypeError('index_i, index_j, and distances should have the same length')
+        if len(index_j) and np.max(index_j) >= num_j:
+            raise ValueError('index_j contains a point index out of range')
+
+        cdef NeighborList result = cls()
+        cdef size_t num_bonds = index_i.shape[0]
+        result.thisptr.resize(num_bonds, num_i, num_j, False)
+        cdef np.ndarray[np.uint32_t, ndim=1] cIndex_i = index_i
+        cdef np.ndarray[np.uint32_t, ndim=1] cIndex_j = index_j
+        cdef np.ndarray[np.float32_t, ndim=1] cDistances = distances
+        if num_bonds:
+            memcpy(result.thisptr.getIndexI().get(), cIndex_i.data, num_bonds*sizeof(unsigned int))
+            memcpy(result.thisptr.getIndexJ().get(), cIndex_j.data, num_bonds*sizeof(unsigned int))
+            memcpy(result.thisptr.getDistances().get(), cDistances.data, num_bonds*sizeof(float))
+        result.thisptr.updateSegments()
+        return result
+
+    def getNumBonds(self):
+        """
+        :return: the number of bonds in this list
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumBonds()
+
+    def getNumI(self):
+        """
+        :return: the number of reference points
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumI()
+
+    def getNumJ(self):
+        """
+        :return: the number of points
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumJ()
+
+    def getIndexI(self):
+        """
+        :return: reference point index of each bond
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *index_i = self.thisptr.getIndexI().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>index_i)
+        return result
+
+    def getIndexJ(self):
+        """
+        :return: point index of each bond
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *index_j = self.thisptr.getIndexJ().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>index_j)
+        return result
+
+    def getDistances(self):
+        """
+        :return: distance of each bond
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float *distances = self.thisptr.getDistances().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>distances)
+        return result
+
+    def getVectors(self):
+        """
+        :return: wrapped vector from reference point i to point j of each bond, or None if not stored
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}, 3\\right)`, dtype= :class:`numpy.float32`
+        """
+        if not self.thisptr.hasVectors():
+            return None
+        cdef vec3[float] *vectors = self.thisptr.getVectors().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        nbins[1] = 3
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>vectors)
+        return result
+
+    def getSegments(self):
+        """
+        :return: index of the first bond of each reference point, followed by the total number of bonds
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}+1\\right)`, dtype= :class:`numpy.uint64`
+        """
+        cdef size_t *segments = self.thisptr.getSegments().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumI() + 1
+        cdef np.ndarray[np.uint64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT64, <void*>segments)
+        return result
+
+    def sortByDistance(self):
+        """Sort the bonds of each reference point by increasing distance.
+
+        The bonds within any smaller cutoff are then a prefix of the bonds of each reference point, so methods
+        given this list with a smaller cutoff than it was built with skip the longer bonds, and
+        :py:meth:`copyWithin` extracts the sub-list of a smaller cutoff without scanning them.
+        """
+        with nogil:
+            self.thisptr.sortByDistance()
+
+    def isSortedByDistance(self):
+        """
+        :return: whether the bonds of each reference point are sorted by distance
+        :rtype: bool
+        """
+        return self.thisptr.isSortedByDistance()
+
+    def copyWithin(self, float rmax):
+        """Return a new NeighborList holding the bonds of this list no longer than rmax
+
+        :param rmax: cutoff radius
+        :type rmax: float
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        with nogil:
+            result.thisptr.copyWithin(dereference(self.thisptr), rmax)
+        return result
+
+    def copyWithinRange(self, float rmin, float rmax):
+        """Return a new NeighborList holding the bonds of this list longer than rmin and no longer than rmax, such as
+        the shell of :py:class:`freud.order.LocalQl`
+
+        :param rmin: inner cutoff radius
+        :param rmax: outer cutoff radius
+        :type rmin: float
+        :type rmax: float
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        with nogil:
+            result.thisptr.copyWithinRange(dereference(self.thisptr), rmin, rmax)
+        return result
+
+    def copyTypes(self, ref_types, types, unsigned int type_i, unsigned int type_j):
+        """Return a new NeighborList holding the bonds of this list from reference points of type type_i to points of
+        type type_j
+
+        :param ref_types: type of each reference point
+        :param types: type of each point
+        :param type_i: type of the reference points kept
+        :param type_j: type of the points kept
+        :type ref_types: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.uint32`
+        :type types: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}\\right)`, dtype= :class:`numpy.uint32`
+        :type type_i: unsigned int
+        :type type_j: unsigned int
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        ref_types = freud.common.convert_array(ref_types, 1, dtype=np.uint32, contiguous=True,
+            dim_message="ref_types must be a 1 dimensional array")
+        types = freud.common.convert_array(types, 1, dtype=np.uint32, contiguous=True,
+            dim_message="types must be a 1 dimensional array")
+        if ref_types.shape[0] != self.thisptr.getNumI() or types.shape[0] != self.thisptr.getNumJ():
+            raise ValueError('ref_types and types need one value per reference point and per point')
+        cdef np.ndarray[np.uint32_t, ndim=1] cRef_types = ref_types
+        cdef np.ndarray[np.uint32_t, ndim=1] cTypes = types
+        cdef NeighborList result = NeighborList()
+        with nogil:
+            result.thisptr.copyTypes(dereference(self.thisptr), <unsigned int*> cRef_types.data,
+                                     <unsigned int*> cTypes.data, type_i, type_j)
+        return result
+
+    def copyMasked(self, ref_mask=None, mask=None):
+        """Return a new NeighborList holding the bonds of this list between the selected reference points and points
+
+        :param ref_mask: whether each reference point is kept; None keeps all of them
+        :param mask: whether each point is kept; None keeps all of them
+        :type ref_mask: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.bool`
+        :type mask: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}\\right)`, dtype= :class:`numpy.bool`
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef np.ndarray[np.uint8_t, ndim=1] cRef_mask
+        cdef np.ndarray[np.uint8_t, ndim=1] cMask
+        cdef unsigned char *l_ref_mask = NULL
+        cdef unsigned char *l_mask = NULL
+        if ref_mask is not None:
+            cRef_mask = np.ascontiguousarray(ref_mask, dtype=np.uint8)
+            if cRef_mask.shape[0] != self.thisptr.getNumI():
+                raise ValueError('ref_mask needs one value per reference point')
+            l_ref_mask = <unsigned char*> cRef_mask.data
+        if mask is not None:
+            cMask = np.ascontiguousarray(mask, dtype=np.uint8)
+            if cMask.shape[0] != self.thisptr.getNumJ():
+                raise ValueError('mask needs one value per point')
+            l_mask = <unsigned char*> cMask.data
+        cdef NeighborList result = NeighborList()
+        with nogil:
+            result.thisptr.copyMasked(dereference(self.thisptr), l_ref_mask, l_mask)
+        return result
+
+    def copyIf(self, keep):
+        """Return a new NeighborList holding the bonds of this list selected by keep
+
+        :param keep: whether each bond is kept
+        :type keep: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.bool`
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef np.ndarray[np.uint8_t, ndim=1] cKeep = np.ascontiguousarray(keep, dtype=np.uint8)
+        if cKeep.shape[0] != self.thisptr.getNumBonds():
+            raise ValueError('keep needs one value per bond')
+        cdef NeighborList result = NeighborList()
+        with nogil:
+            result.thisptr.copyIf(dereference(self.thisptr), <unsigned char*> cKeep.data)
+        return result
+
+    def copySymmetric(self):
+        """Return a new NeighborList holding the bonds of this list and their reverses, each bond once
+
+        The reference points and the points must be the same set. The bonds of each reference point are ordered by
+        point index.
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        with nogil:
+            result.thisptr.copySymmetric(dereference(self.thisptr))
+        return result
+
+    def setWeights(self, weights):
+        """Set the weight of each bond, such as the face areas of :py:class:`freud.voronoi.VoronoiCells`
+
+        :param weights: weight of each bond
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        """
+        weights = freud.common.convert_array(weights, 1, dtype=np.float32, contiguous=True,
+            dim_message="weights must be a 1 dimensional array")
+        if weights.shape[0] != self.thisptr.getNumBonds():
+            raise ValueError('weights needs one value per bond')
+        cdef np.ndarray[np.float32_t, ndim=1] cWeights = weights
+        with nogil:
+            self.thisptr.setWeights(<float*> cWeights.data)
+
+    def weightByDistance(self, kernel, float width=1.0):
+        """Set the weight of each bond from its distance r
+
+        The kernels are 'uniform' (1), 'gaussian' (:math:`e^{-r^2 / 2 w^2}`) and 'linear' (:math:`1 - r / w`, and 0
+        beyond w), w being the width.
+
+        :param kernel: name of the kernel
+        :param width: width of the kernel
+        :type kernel: str
+        :type width: float
+        """
+        if kernel not in _weight_kernels:
+            raise ValueError('Unknown weight kernel {}, expected one of {}'.format(kernel, sorted(_weight_kernels)))
+        cdef locality.WeightKernel l_kernel = _weight_kernels[kernel]
+        with nogil:
+            self.thisptr.weightByDistance(l_kernel, width)
+
+    def clearWeights(self):
+        """Remove the weights of the bonds
+        """
+        self.thisptr.clearWeights()
+
+    def getWeights(self):
+        """
+        :return: weight of each bond, or None if not set
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        """
+        if not self.thisptr.hasWeights():
+            return None
+        cdef float *weights = self.thisptr.getWeights().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>weights)
+        return result
+
+    def computeRelativeOrientations(self, ref_orientations, orientations):
+        """Store the orientation :math:`q_i^* q_j` of the point of each bond relative to its reference point, so
+        that the analyses sharing the list do not recompute it
+
+        :param ref_orientations: orientations of the reference points
+        :param orientations: orientations of the points
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 4\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+        if ref_orientations.shape[1] != 4 or orientations.shape[1] != 4:
+            raise ValueError('the 2nd dimension of the orientations must have 4 values: s, x, y, z')
+        if ref_orientations.shape[0] != self.thisptr.getNumI() or orientations.shape[0] != self.thisptr.getNumJ():
+            raise ValueError('the orientations need one row per reference point and per point of the list')
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_orientations = orientations
+        with nogil:
+            self.thisptr.computeRelativeOrientations(<quat[float]*> l_ref_orientations.data,
+                                                     <quat[float]*> l_orientations.data)
+
+    def computeRelativeAngles(self, ref_angles, angles):
+        """Store the angle :math:`\\theta_j - \\theta_i` of the point of each bond relative to its reference
+        point in 2D, wrapped into :math:`\\left[-\\pi, \\pi\\right]`
+
+        :param ref_angles: orientation angles of the reference points
+        :param angles: orientation angles of the points
+        :type ref_angles: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.float32`
+        :type angles: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_angles = freud.common.convert_array(ref_angles, 1, dtype=np.float32, contiguous=True,
+            dim_message="ref_angles must be a 1 dimensional array")
+        angles = freud.common.convert_array(angles, 1, dtype=np.float32, contiguous=True,
+            dim_message="angles must be a 1 dimensional array")
+        if ref_angles.shape[0] != self.thisptr.getNumI() or angles.shape[0] != self.thisptr.getNumJ():
+            raise ValueError('the angles need one value per reference point and per point of the list')
+        cdef np.ndarray[float, ndim=1] l_ref_angles = ref_angles
+        cdef np.ndarray[float, ndim=1] l_angles = angles
+        with nogil:
+            self.thisptr.computeRelativeAngles(<float*> l_ref_angles.data, <float*> l_angles.data)
+
+    def clearRelativeOrientations(self):
+        """Remove the relative orientations and angles of the bonds
+        """
+        self.thisptr.clearRelativeOrientations()
+
+    def getRelativeOrientations(self):
+        """
+        :return: orientation of the point of each bond relative to its reference point, or None if not set
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}, 4\\right)`, dtype= :class:`numpy.float32`
+        """
+        if not self.thisptr.hasRelativeOrientations():
+            return None
+        cdef quat[float] *orientations = self.thisptr.getRelativeOrientations().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        nbins[1] = 4
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>orientations)
+        return result
+
+    def getRelativeAngles(self):
+        """
+        :return: angle of the point of each bond relative to its reference point, or None if not set
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        """
+        if not self.thisptr.hasRelativeAngles():
+            return None
+        cdef float *angles = self.thisptr.getRelativeAngles().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>angles)
+        return result
+
+    def getNeighborCounts(self):
+        """
+        :return: number of bonds of each reference point
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        return np.diff(self.getSegments()).astype(np.uint32)
+
+_weight_kernels = {'uniform': locality.WEIGHT_UNIFORM, 'gaussian': locality.WEIGHT_GAUSSIAN,
+                   'linear': locality.WEIGHT_LINEAR}
+
+cdef locality.NeighborList *nlist_ptr(NeighborList nlist):
+    """Return the C++ pointer of an optional NeighborList argument (NULL for None)"""
+    if nlist is None:
+        return NULL
+    return nlist.thisptr
+
+cdef class CompressedNeighborList:
+    """Stores the bonds of a :py:class:`freud.locality.NeighborList` in a fraction of its memory.
+
+    The point indices of the bonds of each reference point are sorted and stored as variable length deltas, which
+    mostly take one byte once the points are ordered spatially, and the distances as floats or, optionally, half
+    floats. The bonds of each reference point are decoded by increasing point index; bond vectors and weights are
+    not kept.
+
+    Example::
+
+       cnlist = CompressedNeighborList()
+       cnlist.compress(nlist, half_distances=True)
+       nlist = cnlist.decompress()
+    """
+    cdef locality.CompressedNeighborList *thisptr
+
+    def __cinit__(self):
+        self.thisptr = new locality.CompressedNeighborList()
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compress(self, NeighborList nlist not None, half_distances=False):
+        """Replace the contents of this list with the bonds of nlist
+
+        :param nlist: neighbor list to compress
+        :param half_distances: store the distances as half floats, with a relative error below :math:`2^{-11}`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type half_distances: bool
+        """
+        cdef cbool cHalf = half_distances
+        with nogil:
+            self.thisptr.compress(dereference(nlist.thisptr), cHalf)
+        return self
+
+    def decompress(self):
+        """
+        :return: the bonds, by increasing point index for each reference point
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        with nogil:
+            self.thisptr.decompress(dereference(result.thisptr))
+        return result
+
+    def getBonds(self, unsigned int i):
+        """Decode the bonds of reference point i
+
+        :param i: reference point index
+        :type i: unsigned int
+        :return: the point index and the distance of each bond of i, by increasing point index
+        :rtype: (:class:`numpy.ndarray`, :class:`numpy.ndarray`), dtype= (:class:`numpy.uint32`, :class:`numpy.float32`)
+        """
+        if i >= self.thisptr.getNumI():
+            raise IndexError('reference point index out of range')
+        cdef unsigned int num = self.thisptr.getNumNeighbors(i)
+        cdef np.ndarray[np.uint32_t, ndim=1] index_j = np.empty(num, dtype=np.uint32)
+        cdef np.ndarray[np.float32_t, ndim=1] distances = np.empty(num, dtype=np.float32)
+        if num:
+            self.thisptr.decodeBonds(i, <unsigned int*> index_j.data, <float*> distances.data)
+        return index_j, distances
+
+    def getNumBonds(self):
+        """
+        :return: number of bonds
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumBonds()
+
+    def getNumI(self):
+        """
+        :return: number of reference points
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumI()
+
+    def getNumJ(self):
+        """
+        :return: number of points
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumJ()
+
+    def hasHalfDistances(self):
+        """
+        :return: whether the distances are stored as half floats
+        :rtype: bool
+        """
+        return self.thisptr.hasHalfDistances()
+
+    def getMemoryUsage(self):
+        """
+        :return: number of bytes taken by the bonds
+        :rtype: unsigned int
+        """
+        return self.thisptr.getMemoryUsage()
+
+_partition_modes = {'auto': locality.PARTITION_AUTO, 'cost': locality.PARTITION_COST,
+                    'affinity': locality.PARTITION_AFFINITY, 'pair_blocks': locality.PARTITION_PAIR_BLOCKS}
+
+cdef locality.PartitionMode partition_mode(mode) except *:
+    """Return the C++ PartitionMode of a partition mode name"""
+    if mode not in _partition_modes:
+        raise RuntimeError('Unknown partition mode {}, expected one of {}'.format(mode, sorted(_partition_modes)))
+    return _partition_modes[mode]
+
+cdef partition_mode_name(locality.PartitionMode mode):
+    """Return the name of a C++ PartitionMode"""
+    for name in _partition_modes:
+        if _partition_modes[name] == mode:
+            return name
+
 cdef class LinkCell:
     """Supports efficiently finding all points in a set within a certain
     distance from a given point.
@@ -80,13 +629,150 @@ cdef class LinkCell:
                    pass # do something with neighbor index
     """
     cdef locality.LinkCell *thisptr
+    cdef shared_ptr[locality.LinkCell] shared
 
     def __cinit__(self, box, cell_width):
-        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
-        self.thisptr = new locality.LinkCell(cBox, float(cell_width))
+        cdef _box.Box cBox = cpp_box(box)
+        # shared with the analyses given it by setLinkCell
+        self.shared = shared_ptr[locality.LinkCell](new locality.LinkCell(cBox, float(cell_width)))
+        self.thisptr = self.shared.get()
+
+    def setSubdivision(self, n):
+        """Split each cell width into n cells along each dimension, so that the neighbor cells extend n cells each
+        way and hold fewer candidate pairs, about 0.58 (n=2) or 0.47 (n=3) as many as with n=1, at the cost of
+        visiting more cells; worthwhile when a cell of the cell width holds many points
+
+        :param n: number of cells per cell width, from 1 to 3
+        :type n: unsigned int
+        """
+        self.thisptr.setSubdivision(int(n))
 
-    def __dealloc__(self):
-        del self.thisptr
+    def getSubdivision(self):
+        """
+        :return: number of cells per cell width
+        :rtype: unsigned int
+        """
+        return self.thisptr.getSubdivision()
+
+    def setLazyStencils(self, lazy):
+        """Set whether the neighbor cells of each cell are generated from its coordinates whenever they are needed
+        instead of stored for all the cells, which keeps the memory proportional to the numbers of points and cells on
+        fine cells of huge boxes. Stencils that would hold more than :math:`2^{26}` entries are always generated.
+
+        :param lazy: True to generate the neighbor cells
+        :type lazy: bool
+        """
+        self.thisptr.setLazyStencils(bool(lazy))
+
+    def getLazyStencils(self):
+        """
+        :return: whether the neighbor cells are generated rather than stored
+        :rtype: bool
+        """
+        return self.thisptr.getLazyStencils()
+
+    def setPowerOfTwoCells(self, pow2):
+        """Set whether the number of cells along each dimension is rounded down to a power of two, so that the cell of
+        a point and the neighbor cells of generated stencils are found with shifts and masks instead of divisions. The
+        cells are up to twice as wide along each dimension, which adds candidate pairs; this pays off on huge grids.
+
+        :param pow2: True to round the numbers of cells to powers of two
+        :type pow2: bool
+        """
+        self.thisptr.setPowerOfTwoCells(bool(pow2))
+
+    def getPowerOfTwoCells(self):
+        """
+        :return: whether the numbers of cells are rounded down to powers of two
+        :rtype: bool
+        """
+        return self.thisptr.getPowerOfTwoCells()
+
+    def setMortonCells(self, morton):
+        """Set whether the cells are numbered in Morton (Z) order instead of row major order, so that neighboring
+        cells, and the points sorted into them, are close in memory along every dimension. The cell indices, and so
+        the order of the points of each cell, change; the neighbors found do not.
+
+        :param morton: True to number the cells in Morton order
+        :type morton: bool
+        """
+        self.thisptr.setMortonCells(bool(morton))
+
+    def getMortonCells(self):
+        """
+        :return: whether the cells are numbered in Morton order
+        :rtype: bool
+        """
+        return self.thisptr.getMortonCells()
+
+    def setFitOpenBoundaries(self, fit):
+        """Set whether the cells along the directions the box is not periodic in span the extent of the points of
+        each computation instead of the box. The neighbor cells never wrap around those directions, and the cell width
+        need not be smaller than half the box along them.
+
+        :param fit: True to fit the cells to the points
+        :type fit: bool
+        """
+        self.thisptr.setFitOpenBoundaries(bool(fit))
+
+    def getFitOpenBoundaries(self):
+        """
+        :return: whether the cells along the non periodic directions span the points
+        :rtype: bool
+        """
+        return self.thisptr.getFitOpenBoundaries()
+
+    def setAutoSubdivision(self, auto_subdivision):
+        """Set whether :py:meth:`computeCellList()` picks the subdivision of each frame from the number of points
+        and the density (see :py:meth:`chooseSubdivision()`)
+
+        :param auto_subdivision: True to choose the subdivision of every frame
+        :type auto_subdivision: bool
+        """
+        self.thisptr.setAutoSubdivision(bool(auto_subdivision))
+
+    def getAutoSubdivision(self):
+        """
+        :return: whether the subdivision of each frame is chosen automatically
+        :rtype: bool
+        """
+        return self.thisptr.getAutoSubdivision()
+
+    def chooseSubdivision(self, box, num_points):
+        """Estimate the fastest subdivision for a number of points in a box, without changing the cell list
+
+        :param box: simulation box
+        :param num_points: number of points
+        :type box: :py:class:`freud.box.Box`
+        :type num_points: unsigned int
+        :return: number of cells per cell width
+        :rtype: unsigned int
+        """
+        cdef _box.Box cBox = cpp_box(box)
+        return self.thisptr.chooseSubdivision(cBox, int(num_points))
+
+    def tuneSubdivision(self, box, points):
+        """Time the cell list and a sweep of its pairs for every subdivision and keep the fastest, turning the
+        automatic subdivision off; the cell list of points is left computed
+
+        :param box: simulation box
+        :param points: point coordinates
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :return: number of cells per cell width
+        :rtype: unsigned int
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef unsigned int n
+        with nogil:
+            n = self.thisptr.tuneSubdivision(cBox, <vec3[float]*> cPoints.data, Np)
+        return n
 
     def getBox(self):
         """
@@ -141,7 +827,7 @@ cdef class LinkCell:
         :return: array of cell neighbors
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{neighbors}\\right)`, dtype= :class:`numpy.uint32`
         """
-        neighbors = self.thisptr.getCellNeighbors(int(cell))
+        cdef locality.CellNeighbors neighbors = self.thisptr.getCellNeighbors(int(cell))
         result = np.zeros(neighbors.size(), dtype=np.uint32)
         for i in range(neighbors.size()):
             result[i] = neighbors[i]
@@ -159,40 +845,386 @@ cdef class LinkCell:
             dim_message="points must be a 2 dimensional array")
         if points.shape[1] != 3:
             raise TypeError('points should be an Nx3 array')
-        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box cBox = cpp_box(box)
         cdef np.ndarray cPoints = points
         cdef unsigned int Np = points.shape[0]
         with nogil:
             self.thisptr.computeCellList(cBox, <vec3[float]*> cPoints.data, Np)
 
-cdef class NearestNeighbors:
-    """Supports efficiently finding the N nearest neighbors of each point
-    in a set for some fixed integer N.
+    def computeNlist(self, box, ref_points, points=None, exclude_ii=None, store_vectors=False):
+        """Compute the neighbor list of ref_points among points, using the cell width as the cutoff
 
-    - strict_cut = True: rmax will be strictly obeyed, and any particle which has fewer than N neighbors will have \
-        values of UINT_MAX assigned
-    - strict_cut = False: rmax will be expanded to find requested number of neighbors. If rmax increases to the \
-        point that a cell list cannot be constructed, a warning will be raised and neighbors found will be returned
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param exclude_ii: exclude bonds with i == j; defaults to True if points is None, False otherwise
+        :param store_vectors: also store the wrapped vector of each bond
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :type store_vectors: bool
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        cdef bint c_store_vectors = store_vectors
+        with nogil:
+            self.thisptr.computeNlist(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                                      c_exclude_ii, c_store_vectors)
 
-    .. moduleauthor:: Eric Harper <harperic@umich.edu>
+    def countNeighbors(self, box, ref_points, points=None, exclude_ii=None):
+        """Count the points within the cell width of each reference point, without building a neighbor list
 
-    :param rmax: Initial guess of a distance to search within to find N neighbors
-    :param n_neigh: Number of neighbors to find for each point
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param exclude_ii: do not count point i for reference point i; defaults to True if points is None, False
+                           otherwise
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :return: number of neighbors of each reference point
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        cdef np.ndarray[np.uint32_t, ndim=1] counts = np.zeros(n_ref, dtype=np.uint32)
+        with nogil:
+            self.thisptr.countNeighbors(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data,
+                                        Np, c_exclude_ii, <unsigned int*> counts.data)
+        return counts
+
+    def findAnyNeighbor(self, box, ref_points, points=None, exclude_ii=None):
+        """Find which reference points have at least one point within the cell width, stopping the search of each
+        reference point at the first one
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param exclude_ii: ignore point i for reference point i; defaults to True if points is None, False otherwise
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :return: whether each reference point has a neighbor
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.bool`
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        cdef np.ndarray[np.uint8_t, ndim=1] mask = np.zeros(n_ref, dtype=np.uint8)
+        with nogil:
+            self.thisptr.findAnyNeighbor(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data,
+                                         Np, c_exclude_ii, <cbool*> mask.data)
+        return mask.astype(np.bool_)
+
+    def getNlist(self):
+        """Return the neighbor list last computed by :py:meth:`computeNlist`
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNlist(), self)
+        return result
+
+    def getTimings(self):
+        """Get the wall time in seconds of each phase of the last :py:meth:`computeCellList()` or
+        :py:meth:`computeNlist()`, recorded only when freud is built with ENABLE_PROFILING (see
+        :py:func:`freud.parallel.isProfilingEnabled`)
+
+        The phases are find_cells, sort, nlist and count.
+
+        :return: seconds by phase
+        :rtype: dict
+        """
+        return _profileTimings(self.thisptr.getProfiler())
+
+    def getStats(self):
+        """Get the counters of the last :py:meth:`computeCellList()` or :py:meth:`computeNlist()`, recorded only when
+        freud is built with ENABLE_PROFILING
+
+        The counters are points, cells, pairs_tested and bonds.
+
+        :return: counts by name
+        :rtype: dict
+        """
+        return _profileStats(self.thisptr.getProfiler())
+
+cdef class KDTree:
+    """Supports efficiently finding all points in a set within a certain distance from a given point, for systems
+    where a uniform cell list is inefficient: clustered systems, droplets in vacuum, or boxes that are nearly empty
+    along one direction.
+
+    The points are stored in a k-d tree which is periodic-aware. With a cutoff larger than half of the box along a
+    periodic direction, :py:meth:`computeNlist` searches the explicit periodic images of the points instead (see
+    :py:class:`freud.locality.PeriodicImages`).
+
+    Example::
+
+       tree = KDTree()
+       tree.computeNlist(box, positions, rmax=2.0)
+       rdf.compute(box, positions, positions, nlist=tree.getNlist())
+    """
+    cdef locality.KDTree *thisptr
+
+    def __cinit__(self):
+        self.thisptr = new locality.KDTree()
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def getMaxRadius(self):
+        """
+        :return: the largest cutoff radius supported in the box the tree was last built in
+        :rtype: float
+        """
+        return self.thisptr.getMaxRadius()
+
+    def computeNlist(self, box, ref_points, points=None, rmax=1.0, exclude_ii=None, store_vectors=False):
+        """Build the tree over points and compute the neighbor list of ref_points among points within rmax
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param rmax: cutoff radius
+        :param exclude_ii: exclude bonds with i == j; defaults to True if points is None, False otherwise
+        :param store_vectors: also store the wrapped vector of each bond
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type rmax: float
+        :type exclude_ii: bool
+        :type store_vectors: bool
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef float c_rmax = rmax
+        cdef bint c_exclude_ii = exclude_ii
+        cdef bint c_store_vectors = store_vectors
+        with nogil:
+            self.thisptr.computeNlist(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                                      c_rmax, c_exclude_ii, c_store_vectors)
+
+    def getNlist(self):
+        """Return the neighbor list last computed by :py:meth:`computeNlist`
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNlist(), self)
+        return result
+
+cdef class PeriodicImages:
+    """Finds the neighbors of points among all the periodic images of a set of points, for cutoffs larger than half
+    of the box, where a :py:class:`freud.locality.LinkCell` cannot be built.
+
+    Every pair is tested against each of its images within rmax, without replicating the points. A pair may then have
+    several bonds, one per image within the cutoff, with different vectors and distances; a point is bonded to its
+    own images as well. :py:meth:`freud.locality.KDTree.computeNlist`,
+    :py:class:`freud.locality.NearestNeighbors` and :py:class:`freud.density.RDF` use this search automatically
+    when the cutoff exceeds half of the box.
+
+    :param box: simulation box
+    :param rmax: cutoff radius
+    :type box: :py:class:`freud.box.Box`
+    :type rmax: float
+
+    Example::
+
+       images = PeriodicImages(box, rmax=0.8*box.getLx())
+       images.computeNlist(positions)
+       nlist = images.getNlist()
+    """
+    cdef locality.PeriodicImages *thisptr
+    cdef NeighborList _nlist
+
+    def __cinit__(self, box, float rmax):
+        cdef _box.Box cBox = cpp_box(box)
+        self.thisptr = new locality.PeriodicImages(cBox, rmax)
+        self._nlist = NeighborList()
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    @staticmethod
+    def needed(box, float rmax):
+        """Test if a cutoff reaches more than one image of a point in a box
+
+        :param box: simulation box
+        :param rmax: cutoff radius
+        :type box: :py:class:`freud.box.Box`
+        :type rmax: float
+        :return: True when rmax exceeds half of the box along one of its periodic directions
+        :rtype: bool
+        """
+        cdef _box.Box cBox = cpp_box(box)
+        return locality.PeriodicImages.needed(cBox, rmax)
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def getRMax(self):
+        """
+        :return: the cutoff radius
+        :rtype: float
+        """
+        return self.thisptr.getRMax()
+
+    def computeNlist(self, ref_points, points=None, exclude_ii=None, store_vectors=False):
+        """Compute the neighbor list of ref_points among the periodic images of points within rmax
+
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param exclude_ii: exclude the bond of a point with itself (not with its images); defaults to True if points \
+            is None, False otherwise
+        :param store_vectors: also store the vector of each bond, from the reference point to the image
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\left(N_{ref}, 3\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\left(N_{points}, 3\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :type store_vectors: bool
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        cdef bint c_store_vectors = store_vectors
+        cdef locality.NeighborList *c_nlist = self._nlist.thisptr
+        with nogil:
+            self.thisptr.computeNlist(<vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                                      c_exclude_ii, c_store_vectors, dereference(c_nlist))
+
+    def getNlist(self):
+        """Return the neighbor list last computed by :py:meth:`computeNlist`
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self._nlist.thisptr, self)
+        return result
+
+cdef class NearestNeighbors:
+    """Supports efficiently finding the N nearest neighbors of each point
+    in a set for some fixed integer N.
+
+    - strict_cut = True: rmax will be strictly obeyed, and any particle which has fewer than N neighbors will have \
+        values of UINT_MAX assigned
+    - strict_cut = False: rmax will be expanded to find requested number of neighbors. If rmax increases to the \
+        point that a cell list cannot be constructed, the explicit periodic images of the points are searched (see \
+        :py:class:`freud.locality.PeriodicImages`); in a box without periodic directions a warning is printed and \
+        the neighbors found are returned
+
+    .. moduleauthor:: Eric Harper <harperic@umich.edu>
+
+    :param rmax: Initial guess of a distance to search within to find N neighbors
+    :param n_neigh: Number of neighbors to find for each point
     :param scale: multiplier by which to automatically increase rmax value by if requested number of neighbors is not \
         found. Only utilized if strict_cut is False. Scale must be greater than 1
     :param strict_cut: whether to use a strict rmax or allow for automatic expansion
+    :param use_tree: find the neighbors with a :py:class:`freud.locality.KDTree` in a single pass instead of a cell \
+        list; rmax is then not expanded within half of the box, beyond which the periodic images are searched
     :type rmax: float
     :type n_neigh: unsigned int
     :type scale: float
     :type strict_cut: bool
+    :type use_tree: bool
     """
     cdef locality.NearestNeighbors *thisptr
 
-    def __cinit__(self, float rmax, unsigned int n_neigh, float scale=1.1, strict_cut=False):
+    def __cinit__(self, float rmax, unsigned int n_neigh, float scale=1.1, strict_cut=False, use_tree=False):
         if scale < 1:
             raise RuntimeError("scale must be greater than 1")
         self.thisptr = new locality.NearestNeighbors(float(rmax), int(n_neigh), float(scale), bool(strict_cut))
+        self.thisptr.setUseTree(bool(use_tree))
 
     def __dealloc__(self):
         del self.thisptr
@@ -239,13 +1271,117 @@ cdef class NearestNeighbors:
         - strict_cut = True: rmax will be strictly obeyed, and any particle which has fewer than N neighbors will have \
             values of UINT_MAX assigned
         - strict_cut = False: rmax will be expanded to find requested number of neighbors. If rmax increases to the \
-            point that a cell list cannot be constructed, a warning will be raised and neighbors found will be returned
+            point that a cell list cannot be constructed, the explicit periodic images of the points are searched (see \
+        :py:class:`freud.locality.PeriodicImages`); in a box without periodic directions a warning is printed and \
+        the neighbors found are returned
 
         :param strict_cut: whether to use a strict rmax or allow for automatic expansion
         :type strict_cut: bool
         """
         self.thisptr.setCutMode(strict_cut)
 
+    def setUseTree(self, use_tree):
+        """Choose between the cell list and the :py:class:`freud.locality.KDTree` search
+
+        :param use_tree: whether to find the neighbors with a k-d tree
+        :type use_tree: bool
+        """
+        self.thisptr.setUseTree(use_tree)
+
+    def getUseTree(self):
+        """
+        :return: whether the neighbors are found with a k-d tree
+        :rtype: bool
+        """
+        return self.thisptr.getUseTree()
+
+    def setApproximate(self, float epsilon):
+        """Find approximate neighbors for speed, each at most 1 + epsilon times as far as the exact neighbor of its
+        rank, or the exact neighbors with 0 (the default)
+
+        The approximate search is that of the :py:class:`freud.locality.KDTree`, whatever :py:meth:`setUseTree()`.
+        After it, :py:meth:`compute()` checks the neighbors of a sample of the reference points against an exact
+        search, see :py:meth:`getRecallStatistics()`.
+
+        :param epsilon: largest relative error of the distance of each neighbor
+        :type epsilon: float
+        """
+        if epsilon < 0:
+            raise ValueError("epsilon must not be negative")
+        self.thisptr.setApproximate(epsilon)
+
+    def getApproximate(self):
+        """
+        :return: largest relative error of the approximate neighbors, 0 for the exact neighbors
+        :rtype: float
+        """
+        return self.thisptr.getApproximate()
+
+    def setRecallSamples(self, unsigned int num_samples):
+        """Set the number of reference points, evenly spread, whose approximate neighbors are checked (1000 by
+        default)
+
+        :param num_samples: number of reference points checked
+        :type num_samples: unsigned int
+        """
+        self.thisptr.setRecallSamples(num_samples)
+
+    def getRecallSamples(self):
+        """
+        :return: number of reference points whose approximate neighbors are checked
+        :rtype: unsigned int
+        """
+        return self.thisptr.getRecallSamples()
+
+    def getRecallStatistics(self):
+        """Get the accuracy of the last approximate :py:meth:`compute()` over the reference points checked: recall
+        (the fraction of the exact neighbors found), exact_fraction (the fraction of the points whose neighbors were
+        all exact), max_distance_ratio (the largest ratio of the distance of the farthest neighbor found to the
+        exact one) and num_queries (the number of points checked)
+
+        :return: accuracy statistics
+        :rtype: dict
+        """
+        return dict(recall=self.thisptr.getRecall(), exact_fraction=self.thisptr.getExactFraction(),
+                    max_distance_ratio=self.thisptr.getMaxDistanceRatio(),
+                    num_queries=self.thisptr.getNumRecallQueries())
+
+    def setStoreDistances(self, store_rsq):
+        """Choose whether :py:meth:`compute()` keeps the squared distance of each neighbor
+
+        Analyses that only need the neighbor indices or vectors can turn this off to save writing the distance
+        array; :py:meth:`getRsqList()` then raises an error, and the distances of :py:meth:`getNlist()` are those of
+        the minimum image vectors.
+
+        :param store_rsq: whether to keep the squared distances
+        :type store_rsq: bool
+        """
+        self.thisptr.setStoreDistances(store_rsq)
+
+    def getStoreDistances(self):
+        """
+        :return: whether the squared distances are kept
+        :rtype: bool
+        """
+        return self.thisptr.getStoreDistances()
+
+    def setStoreVectors(self, store_vectors):
+        """Choose whether :py:meth:`compute()` keeps the wrapped vector of each neighbor
+
+        Turned off, :py:meth:`getWrappedVectors()` raises an error and :py:meth:`getNlist()` has no vectors.
+
+        :param store_vectors: whether to keep the wrapped vectors
+        :type store_vectors: bool
+        """
+        self.thisptr.setStoreVectors(store_vectors)
+
+    def getStoreVectors(self):
+        """
+        :return: whether the wrapped vectors are kept
+        :rtype: bool
+        """
+        return self.thisptr.getStoreVectors()
+
     def getRMax(self):
         """Return the current neighbor search distance guess
         :return: nearest neighbors search radius
@@ -282,6 +1418,38 @@ cdef class NearestNeighbors:
 
         return result
 
+    def getNlist(self):
+        """Return the neighbors last computed as a :py:class:`freud.locality.NeighborList`; padded entries are omitted
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNlist(), self)
+        return result
+
+    def getTimings(self):
+        """Get the wall time in seconds of each phase of the last :py:meth:`compute()`, recorded only when freud is
+        built with ENABLE_PROFILING (see :py:func:`freud.parallel.isProfilingEnabled`)
+
+        The phases are cell_list, search, build_tree (with the k-d tree) and nlist.
+
+        :return: seconds by phase
+        :rtype: dict
+        """
+        return _profileTimings(self.thisptr.getProfiler())
+
+    def getStats(self):
+        """Get the counters of the last :py:meth:`compute()`, recorded only when freud is built with ENABLE_PROFILING
+
+        The counters are iterations, the passes of the search, one more each time rmax is expanded, queries, the
+        reference points searched over all the passes, pairs_tested (with the cell list) and bonds.
+
+        :return: counts by name
+        :rtype: dict
+        """
+        return _profileStats(self.thisptr.getProfiler())
+
     def getRsq(self, unsigned int i):
         """
         Return the Rsq values for the N nearest neighbors of the reference point with index i
@@ -296,6 +1464,8 @@ cdef class NearestNeighbors:
         result = np.zeros(nNeigh, dtype=np.float32)
         cdef unsigned int start_idx = i*nNeigh
         cdef float *neighbors = self.thisptr.getRsqList().get()
+        if neighbors == NULL:
+            raise RuntimeError("the squared distances are not kept, see setStoreDistances")
         for j in range(nNeigh):
             result[j] = neighbors[start_idx + j]
 
@@ -310,6 +1480,8 @@ cdef class NearestNeighbors:
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         cdef vec3[float] *wvec = self.thisptr.getWrappedVectors().get()
+        if wvec == NULL:
+            raise RuntimeError("the wrapped vectors are not kept, see setStoreVectors")
         cdef np.npy_intp nbins[2]
         nbins[0] = <np.npy_intp>self.thisptr.getNref()
         nbins[1] = 3
@@ -325,6 +1497,8 @@ cdef class NearestNeighbors:
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_{neighbors}\\right)`, dtype= :class:`numpy.float32`
         """
         cdef float *rsq = self.thisptr.getRsqList().get()
+        if rsq == NULL:
+            raise RuntimeError("the squared distances are not kept, see setStoreDistances")
         cdef np.npy_intp nbins[2]
         nbins[0] = <np.npy_intp>self.thisptr.getNref()
         nbins[1] = <np.npy_intp>self.thisptr.getNumNeighbors()
@@ -352,10 +1526,737 @@ cdef class NearestNeighbors:
         if points.shape[1] != 3:
             raise TypeError('points should be an Nx3 array')
 
-        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box cBox = cpp_box(box)
         cdef np.ndarray cRef_points = ref_points
         cdef unsigned int n_ref = ref_points.shape[0]
         cdef np.ndarray cPoints = points
         cdef unsigned int Np = points.shape[0]
         with nogil:
             self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np)
+
+    def buildIndex(self, box, points):
+        """Index the points searched by :py:meth:`query()`, once for any number of batches of query points
+
+        The points are copied into a :py:class:`freud.locality.KDTree`; the results of :py:meth:`compute()` are left
+        alone.
+
+        :param box: simulation box
+        :param points: coordinates of points
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        with nogil:
+            self.thisptr.buildIndex(cBox, <vec3[float]*> cPoints.data, Np)
+
+    def query(self, query_points, neighbors=None, rsq=None, wvec=None):
+        """Find the N nearest neighbors of each query point among the points of :py:meth:`buildIndex()`
+
+        The results are padded and ordered as those of :py:meth:`compute()`; a query point is not excluded from its
+        own neighbors. The arrays of a previous call may be passed in to be filled instead of allocating new ones, so
+        that many small batches (grid points, insertion trials, ...) are searched without allocations.
+
+        :param query_points: coordinates of the query points
+        :param neighbors: array to fill with the neighbor indices, or None
+        :param rsq: array to fill with the squared distances, or None
+        :param wvec: array to fill with the wrapped vectors, or None
+        :type query_points: :class:`numpy.ndarray`, shape=(:math:`N_{query}`, 3), dtype= :class:`numpy.float32`
+        :type neighbors: :class:`numpy.ndarray`, shape= :math:`\\left(N_{query}, N_{neighbors}\\right)`, dtype= :class:`numpy.uint32`
+        :type rsq: :class:`numpy.ndarray`, shape= :math:`\\left(N_{query}, N_{neighbors}\\right)`, dtype= :class:`numpy.float32`
+        :type wvec: :class:`numpy.ndarray`, shape= :math:`\\left(N_{query}, N_{neighbors}, 3\\right)`, dtype= :class:`numpy.float32`
+        :return: neighbor indices, squared distances and wrapped vectors
+        :rtype: tuple of :class:`numpy.ndarray`
+        """
+        query_points = freud.common.convert_array(query_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="query_points must be a 2 dimensional array")
+        if query_points.shape[1] != 3:
+            raise TypeError('query_points should be an Nx3 array')
+
+        cdef unsigned int n_query = query_points.shape[0]
+        neighbors, rsq, wvec = _nearest_neighbor_arrays(n_query, self.thisptr.getNumNeighbors(), neighbors, rsq, wvec)
+
+        cdef np.ndarray cQuery_points = query_points
+        cdef np.ndarray cNeighbors = neighbors
+        cdef np.ndarray cRsq = rsq
+        cdef np.ndarray cWvec = wvec
+        with nogil:
+            self.thisptr.query(<vec3[float]*> cQuery_points.data, n_query, <unsigned int*> cNeighbors.data,
+                               <float*> cRsq.data, <vec3[float]*> cWvec.data)
+        return neighbors, rsq, wvec
+
+    def computeArrays(self, box, ref_points, points, neighbors=None, rsq=None, wvec=None):
+        """Find the N nearest neighbors of each reference point among the points, returning the arrays of
+        :py:meth:`compute()` instead of keeping them
+
+        The object is left unchanged: the points are indexed in a :py:class:`freud.locality.KDTree` of the call,
+        whatever :py:meth:`setUseTree()`, and rmax is not expanded. Threads may therefore call this method of one
+        object for different frames at once. As with :py:meth:`query()`, the arrays of a previous call may be passed
+        in to be filled.
+
+        :param box: simulation box
+        :param ref_points: coordinates of reference points
+        :param points: coordinates of points
+        :param neighbors: array to fill with the neighbor indices, or None
+        :param rsq: array to fill with the squared distances, or None
+        :param wvec: array to fill with the wrapped vectors, or None
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :return: neighbor indices, squared distances and wrapped vectors
+        :rtype: tuple of :class:`numpy.ndarray`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+
+        cdef unsigned int n_ref = ref_points.shape[0]
+        neighbors, rsq, wvec = _nearest_neighbor_arrays(n_ref, self.thisptr.getNumNeighbors(), neighbors, rsq, wvec)
+
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cRef_points = ref_points
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef np.ndarray cNeighbors = neighbors
+        cdef np.ndarray cRsq = rsq
+        cdef np.ndarray cWvec = wvec
+        cdef locality.KDTree workspace
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                                 workspace, <unsigned int*> cNeighbors.data, <float*> cRsq.data,
+                                 <vec3[float]*> cWvec.data)
+        return neighbors, rsq, wvec
+
+def _nearest_neighbor_arrays(unsigned int n, unsigned int nNeigh, neighbors, rsq, wvec):
+    """Allocate the output arrays of :py:meth:`NearestNeighbors.query()` that are None, and check the others"""
+    if neighbors is None:
+        neighbors = np.empty((n, nNeigh), dtype=np.uint32)
+    if rsq is None:
+        rsq = np.empty((n, nNeigh), dtype=np.float32)
+    if wvec is None:
+        wvec = np.empty((n, nNeigh, 3), dtype=np.float32)
+    for (array, dtype, shape) in ((neighbors, np.uint32, (n, nNeigh)), (rsq, np.float32, (n, nNeigh)),
+                                  (wvec, np.float32, (n, nNeigh, 3))):
+        if not isinstance(array, np.ndarray) or array.dtype != dtype or tuple(array.shape) != shape or \
+                not array.flags.c_contiguous or not array.flags.writeable:
+            raise ValueError('output arrays must be writeable contiguous arrays of shape {} and dtype {}'.format(
+                shape, np.dtype(dtype).name))
+    return neighbors, rsq, wvec
+
+cdef class VerletList:
+    """Computes the neighbor list of consecutive trajectory frames, only rebuilding the pairs when the particles have
+    moved further than the skin distance since the last build.
+
+    The pairs within rcut + skin are found with a :py:class:`freud.locality.LinkCell` and kept along with the
+    positions they were found for. Later frames filter this candidate list with the current positions as long as
+    the largest displacements of the reference points and the points add up to less than the skin, so the result
+    always holds exactly the pairs closer than rcut.
+
+    :param rcut: cutoff radius of the neighbor list
+    :param skin: extra distance included in the candidate list
+    :type rcut: float
+    :type skin: float
+
+    Example::
+
+       vlist = VerletList(2.0, 0.3)
+       for positions in trajectory:
+           vlist.compute(box, positions)
+           rdf.accumulate(box, positions, positions, nlist=vlist.getNlist())
+    """
+    cdef locality.VerletList *thisptr
+
+    def __cinit__(self, float rcut, float skin):
+        self.thisptr = new locality.VerletList(rcut, skin)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getRCut(self):
+        """
+        :return: cutoff radius of the neighbor list
+        :rtype: float
+        """
+        return self.thisptr.getRCut()
+
+    def getSkin(self):
+        """
+        :return: skin distance
+        :rtype: float
+        """
+        return self.thisptr.getSkin()
+
+    def getNumBuilds(self):
+        """
+        :return: number of times the candidate list has been built
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumBuilds()
+
+    def reset(self):
+        """Force the candidate list to be rebuilt on the next call to :py:meth:`compute`
+        """
+        self.thisptr.reset()
+
+    def compute(self, box, ref_points, points=None, exclude_ii=None, store_vectors=False):
+        """Compute the neighbor list of ref_points among points for the current frame
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param exclude_ii: exclude bonds with i == j; defaults to True if points is None, False otherwise
+        :param store_vectors: also store the wrapped vector of each bond
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :type store_vectors: bool
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        cdef bint c_store_vectors = store_vectors
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                                 c_exclude_ii, c_store_vectors)
+
+    def getNlist(self):
+        """Return the neighbor list last computed by :py:meth:`compute`
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNlist(), self)
+        return result
+
+cdef class NeighborListCache:
+    """Keeps the neighbor lists of the last frames, so that the analyses of a frame share one list
+
+    A list is identified by the box, the contents of the reference points and points, and whether bonds between a
+    point and itself are excluded. A request on the same frame with a cutoff no larger than that of a kept list
+    returns that list, whose bonds are sorted by distance so that the analyses skip those beyond their own cutoff;
+    otherwise a new list is built with a :py:class:`freud.locality.LinkCell` at the larger of the cutoff and
+    min_rmax, and the oldest list is dropped once more than max_entries are kept.
+
+    Set as the active cache with :py:func:`freud.locality.setNlistCache`, the cache is used by the methods of
+    :py:class:`freud.density.RDF`, :py:class:`freud.density.LocalDensity`, :py:class:`freud.order.LocalQl` and
+    :py:class:`freud.cluster.Cluster` that are not given an nlist, so that an existing script shares the lists of
+    its analyses without threading them through.
+
+    :param min_rmax: smallest cutoff to build lists with, typically the largest cutoff of the analyses of a frame
+    :param max_entries: number of lists kept
+    :type min_rmax: float
+    :type max_entries: unsigned int
+
+    Example::
+
+       freud.locality.setNlistCache(freud.locality.NeighborListCache(min_rmax=2.5))
+       for positions in trajectory:
+           rdf.accumulate(box, positions, positions)
+           ld.compute(box, positions, positions)
+    """
+    cdef float min_rmax
+    cdef unsigned int max_entries
+    cdef entries
+    cdef unsigned int num_hits
+    cdef unsigned int num_misses
+
+    def __cinit__(self, float min_rmax=0, unsigned int max_entries=4):
+        self.min_rmax = min_rmax
+        self.max_entries = max(max_entries, 1)
+        self.entries = []
+        self.num_hits = 0
+        self.num_misses = 0
+
+    def get(self, box, ref_points, points=None, float rmax=0, exclude_ii=False):
+        """Get a neighbor list of ref_points among points with a cutoff of at least rmax
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param rmax: cutoff radius
+        :param exclude_ii: exclude bonds with i == j
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type rmax: float
+        :type exclude_ii: bool
+        :return: neighbor list, sorted by distance
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        same_points = points is None or points is ref_points
+        if not same_points:
+            points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+                dim_message="points must be a 2 dimensional array")
+        key = (box_key(box), bool(exclude_ii), _frame_key(ref_points), None if same_points else _frame_key(points))
+        for entry in self.entries:
+            if entry[0] == key and entry[1] >= rmax:
+                self.num_hits += 1
+                return entry[2]
+
+        self.num_misses += 1
+        cdef float l_rmax = max(rmax, self.min_rmax)
+        lc = LinkCell(box, l_rmax)
+        lc.computeNlist(box, ref_points, ref_points if same_points else points, exclude_ii=bool(exclude_ii))
+        nlist = lc.getNlist()
+        nlist.sortByDistance()
+        self.entries = [entry for entry in self.entries if entry[0] != key]
+        self.entries.append((key, l_rmax, nlist))
+        if len(self.entries) > self.max_entries:
+            self.entries.pop(0)
+        return nlist
+
+    def clear(self):
+        """Drop all the kept lists
+        """
+        self.entries = []
+
+    def getNumEntries(self):
+        """
+        :return: number of lists kept
+        :rtype: unsigned int
+        """
+        return len(self.entries)
+
+    def getNumHits(self):
+        """
+        :return: number of requests answered with a kept list
+        :rtype: unsigned int
+        """
+        return self.num_hits
+
+    def getNumMisses(self):
+        """
+        :return: number of requests that built a new list
+        :rtype: unsigned int
+        """
+        return self.num_misses
+
+def _frame_key(np.ndarray points):
+    """Identify the contents of a contiguous array of points"""
+    return (points.shape[0], zlib.crc32(memoryview(points).cast('B')))
+
+_nlist_cache = None
+
+def setNlistCache(cache):
+    """Set the cache the analyses take their neighbor list from when they are not given one
+
+    :param cache: cache to use, or None to build the lists in every analysis again
+    :type cache: :py:class:`freud.locality.NeighborListCache`
+    """
+    global _nlist_cache
+    if cache is not None and not isinstance(cache, NeighborListCache):
+        raise TypeError('cache must be a NeighborListCache or None')
+    _nlist_cache = cache
+
+def getNlistCache():
+    """
+    :return: the cache the analyses take their neighbor list from, or None
+    :rtype: :py:class:`freud.locality.NeighborListCache`
+    """
+    return _nlist_cache
+
+cdef cached_nlist(nlist, box, ref_points, points, float rmax):
+    """Return nlist, or when it is None the list of the frame from the active cache, or None without one
+
+    The list includes the bonds between a point and itself, as the cell lists of the analyses do. A cutoff the cell
+    list cannot take, such as one beyond half the box, leaves the analysis to its own search.
+    """
+    if nlist is not None or _nlist_cache is None:
+        return nlist
+    try:
+        return _nlist_cache.get(box, ref_points, points, rmax, exclude_ii=False)
+    except (RuntimeError, ValueError):
+        return None
+
+_curves = {'morton': locality.MORTON, 'hilbert': locality.HILBERT}
+
+cdef class SpaceFillingCurve:
+    """Order particles along a Morton (Z order) or Hilbert curve through the box, in 3D or 2D
+
+    Particles close along the curve are close in space, so every analysis is faster when fed positions reordered
+    along it: the neighbors of consecutive particles are in the same cells and cache lines. The Hilbert curve, which
+    has no long jumps, is the better order; Morton keys are cheaper to compute.
+
+    :py:meth:`reorder()` puts any array of the particles in the order of the curve in place, and
+    :py:meth:`restore()` maps an array of results for the reordered particles back to the input order.
+
+    Example::
+
+       curve = SpaceFillingCurve()
+       curve.compute(box, positions)
+       curve.reorder(positions)
+       ld.compute(box, positions)
+       density = np.copy(ld.getDensity())
+       curve.restore(density)
+
+    :param curve: 'hilbert' or 'morton'
+    :type curve: str
+    """
+    cdef locality.SpaceFillingCurve *thisptr
+
+    def __cinit__(self, curve='hilbert'):
+        if curve not in _curves:
+            raise RuntimeError('Unknown curve {}, expected one of {}'.format(curve, sorted(_curves)))
+        self.thisptr = new locality.SpaceFillingCurve(_curves[curve])
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, box, points):
+        """Order the points along the curve
+
+        :param box: simulation box
+        :param points: particle positions
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cPoints.data, Np)
+
+    def getOrder(self):
+        """
+        :return: index of the particle at each position of the curve
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *order = self.thisptr.getOrder().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNp()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>order)
+        return result
+
+    def getInverse(self):
+        """
+        :return: position of each particle along the curve
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *inverse = self.thisptr.getInverse().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNp()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>inverse)
+        return result
+
+    def _checkArray(self, array):
+        if not isinstance(array, np.ndarray) or not array.flags.c_contiguous or not array.flags.writeable:
+            raise TypeError('array must be a writeable C contiguous numpy array')
+        if array.ndim == 0 or array.shape[0] != self.thisptr.getNp():
+            raise ValueError('array must have one row per particle of the last compute()')
+
+    def reorder(self, array):
+        """Reorder an array of the particles of the last :py:meth:`compute()` in place, into the order of the curve
+
+        :param array: array with one row per particle, of any dtype
+        :type array: :class:`numpy.ndarray`, C contiguous
+        """
+        self._checkArray(array)
+        cdef np.ndarray cArray = array
+        cdef size_t element_size = array.nbytes // array.shape[0] if array.shape[0] else 0
+        with nogil:
+            self.thisptr.reorder(<void*> cArray.data, element_size)
+
+    def restore(self, array):
+        """Reorder an array of the particles in the order of the curve back in place, into the input order
+
+        :param array: array with one row per particle, of any dtype
+        :type array: :class:`numpy.ndarray`, C contiguous
+        """
+        self._checkArray(array)
+        cdef np.ndarray cArray = array
+        cdef size_t element_size = array.nbytes // array.shape[0] if array.shape[0] else 0
+        with nogil:
+            self.thisptr.restore(<void*> cArray.data, element_size)
+
+cdef class DomainDecomposition:
+    """Split the box into a grid of domains, each with the points it owns and the ghosts within a width of it, to
+    analyze a frame too large for one process across several
+
+    Each point is owned by the domain its wrapped fractional coordinates fall in. The ghosts of a domain are the
+    periodic images of the other points within ghost_width of it, so that an analysis of cutoff up to ghost_width
+    of the owned points and ghosts of a domain finds all the neighbors the owned points have in the frame. Each
+    domain has its own box, :py:meth:`getDomainBox()`, in whose coordinates the points of the domain are given and
+    which only spans the domain and its ghost layers; along axes of one domain it is the periodic box itself.
+
+    :py:meth:`compute()` sorts the points of a process into the domains; :py:func:`freud.parallel.exchangeDomains`
+    sends them to the process of each domain over MPI.
+
+    :param box: simulation box
+    :param shape: number of domains along each lattice vector, 1 along the third in 2D
+    :param ghost_width: width of the ghost layers, at least the cutoff of the analyses
+    :type box: :py:class:`freud.box.Box`
+    :type shape: tuple of 3 int
+    :type ghost_width: float
+    """
+    cdef locality.DomainDecomposition *thisptr
+
+    def __cinit__(self, box, shape, float ghost_width):
+        if len(shape) != 3:
+            raise TypeError('shape should be the number of domains along each of the 3 lattice vectors')
+        cdef _box.Box cBox = cpp_box(box)
+        self.thisptr = new locality.DomainDecomposition(cBox, shape[0], shape[1], shape[2], ghost_width)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def getShape(self):
+        """
+        :return: number of domains along each lattice vector
+        :rtype: tuple of 3 int
+        """
+        cdef const Index3D *indexer = &self.thisptr.getDomainIndexer()
+        return (indexer.getW(), indexer.getH(), indexer.getD())
+
+    def getNumDomains(self):
+        """
+        :return: number of domains
+        :rtype: int
+        """
+        return self.thisptr.getNumDomains()
+
+    def getGhostWidth(self):
+        """
+        :return: width of the ghost layers
+        :rtype: float
+        """
+        return self.thisptr.getGhostWidth()
+
+    def getDomainBox(self, unsigned int domain):
+        """
+        :param domain: index of the domain
+        :type domain: int
+        :return: box of the domain, whose coordinates its points are in
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getDomainBox(domain))
+
+    def compute(self, points):
+        """Sort points into the domains
+
+        :param points: particle positions
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        with nogil:
+            self.thisptr.compute(<vec3[float]*> cPoints.data, Np)
+
+    def getDomains(self):
+        """
+        :return: domain of each point of the last :py:meth:`compute()`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *domains = self.thisptr.getDomains().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNp()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>domains)
+        return result
+
+    def getOffsets(self):
+        """The owned points of domain d are the entries [offsets[2d], offsets[2d+1]) of :py:meth:`getIndices()` and
+        :py:meth:`getPositions()`, and its ghosts the entries [offsets[2d+1], offsets[2d+2])
+
+        :return: beginnings of the owned points and of the ghosts of each domain
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(2 N_{domains} + 1\\right)`, dtype= :class:`numpy.uint64`
+        """
+        cdef size_t *offsets = self.thisptr.getOffsets().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>(2*self.thisptr.getNumDomains() + 1)
+        cdef np.ndarray[np.uint64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT64, <void*>offsets)
+        return result
+
+    def getIndices(self):
+        """
+        :return: point of each owned point and ghost, grouped by domain
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{entries}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef unsigned int *indices = self.thisptr.getIndices().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumEntries()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>indices)
+        return result
+
+    def getPositions(self):
+        """
+        :return: position of each owned point and ghost, in the coordinates of the box of its domain
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{entries}, 3\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef vec3[float] *positions = self.thisptr.getPositions().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumEntries()
+        nbins[1] = 3
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>positions)
+        return result
+
+cdef class FrameAnalysis:
+    """Computes several analyses of a frame from a single traversal of the neighbors
+
+    Running :py:class:`freud.density.RDF`, :py:class:`freud.density.LocalDensity`, :py:class:`freud.order.LocalQl`
+    and :py:class:`freud.cluster.Cluster` one after the other builds a cell list and computes the distance of every
+    candidate pair once per analysis. A FrameAnalysis builds one cell list at the largest cutoff of its analyses and
+    hands the neighbors of each reference point to all of them, each keeping those within its own cutoff. After
+    :py:meth:`compute`, the results are read from the analyses as if they had been computed alone: the rdf is
+    accumulated as by :py:meth:`freud.density.RDF.accumulate`, and the other analyses are computed as by their
+    compute methods without a neighbor list. LocalQl and Cluster need the reference points to be the points.
+
+    Example::
+
+       frame = FrameAnalysis()
+       frame.add(rdf)
+       frame.add(ld)
+       frame.add(ql)
+       for positions in trajectory:
+           frame.compute(box, positions)
+           densities.append(ld.getDensity())
+    """
+    cdef locality.FrameAnalysis *thisptr
+    cdef analyses
+
+    def __cinit__(self):
+        self.thisptr = new locality.FrameAnalysis()
+        self.analyses = []
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def add(self, analysis):
+        """Add an analysis to compute on every frame
+
+        :param analysis: analysis to compute
+        :type analysis: :py:class:`freud.density.RDF`, :py:class:`freud.density.LocalDensity`,
+                        :py:class:`freud.order.LocalQl` or :py:class:`freud.cluster.Cluster`
+        """
+        cdef locality.PairAnalysis *pair_analysis
+        if isinstance(analysis, RDF):
+            pair_analysis = (<RDF> analysis).thisptr
+        elif isinstance(analysis, LocalDensity):
+            pair_analysis = (<LocalDensity> analysis).thisptr
+        elif isinstance(analysis, LocalQl):
+            pair_analysis = (<LocalQl> analysis).thisptr
+        elif isinstance(analysis, Cluster):
+            pair_analysis = (<Cluster> analysis).thisptr
+        else:
+            raise TypeError("FrameAnalysis computes RDF, LocalDensity, LocalQl and Cluster analyses")
+        self.thisptr.addAnalysis(pair_analysis)
+        # the analyses must outlive their use
+        self.analyses.append(analysis)
+
+    def clear(self):
+        """Remove all the analyses
+        """
+        self.thisptr.clearAnalyses()
+        self.analyses = []
+
+    def getNumAnalyses(self):
+        """
+        :return: number of analyses
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumAnalyses()
+
+    def getRMax(self):
+        """
+        :return: largest cutoff of the analyses, the width of the cell list
+        :rtype: float
+        """
+        return self.thisptr.getRMax()
+
+    def compute(self, box, ref_points, points=None, nlist=None):
+        """Compute all the analyses of a frame
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates; if None, ref_points is used
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        if points is None:
+            points = ref_points
+        else:
+            points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+                dim_message="points must be a 2 dimensional array")
+            if points.shape[1] != 3:
+                raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                                 cNlist)
+
+    def getTimings(self):
+        """Get the wall time in seconds of each phase of the last :py:meth:`compute`, recorded only when freud is
+        built with ENABLE_PROFILING (see :py:func:`freud.parallel.isProfilingEnabled`)
+
+        The phases are cell_list, pairs and images.
+
+        :return: seconds by phase
+        :rtype: dict
+        """
+        return _profileTimings(self.thisptr.getProfiler())
+
+    def getStats(self):
+        """Get the counters of the last :py:meth:`compute`, recorded only when freud is built with ENABLE_PROFILING
+
+        The counters are pairs_tested and pairs_accepted.
+
+        :return: counts by name
+        :rtype: dict
+        """
+        return _profileStats(self.thisptr.getProfiler())
@@ -10,3 +10,14 @@
 from ._freud import LinkCell
 from ._freud import IteratorLinkCell
 from ._freud import NearestNeighbors
+from ._freud import NeighborList
+from ._freud import CompressedNeighborList
+from ._freud import KDTree
+from ._freud import PeriodicImages
+from ._freud import VerletList
+from ._freud import SpaceFillingCurve
+from ._freud import DomainDecomposition
+from ._freud import FrameAnalysis
+from ._freud import NeighborListCache
+from ._freud import setNlistCache
+from ._freud import getNlistCache
@@ -4,9 +4,14 @@
 from freud.util._VectorMath cimport vec3
 from freud.util._VectorMath cimport quat
 from freud.util._Boost cimport shared_array
+from freud.util._SymmetricEigen cimport symmetricEigen3
 cimport freud._box as _box
+cimport freud._locality as locality
 cimport freud._order as order
+from libcpp cimport bool as cbool
 from libcpp.complex cimport complex
+from libcpp.string cimport string
+from cython.operator cimport dereference
 from libcpp.vector cimport vector
 from libcpp.map cimport map
 from libcpp.pair cimport pair
@@ -117,8 +122,7 @@ cdef class BondOrder:
         cdef np.ndarray[float, ndim=2] l_orientations = orientations
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         with nogil:
             self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <quat[float]*>l_ref_orientations.data,
                 n_ref, <vec3[float]*>l_points.data, <quat[float]*>l_orientations.data, n_p, index)
@@ -175,7 +179,48 @@ cdef class BondOrder:
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
         :py:meth:`freud.order.BondOrder.getBondOrder()`.
         """
-        self.thisptr.reduceBondOrder()
+        with nogil:
+            self.thisptr.reduceBondOrder()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, BondOrder other):
+        """Add the accumulated state of another :py:class:`freud.order.BondOrder` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.order.BondOrder`
+        """
+        self.thisptr.merge(dereference(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
 
     def getTheta(self):
         """
@@ -220,8 +265,8 @@ cdef class BondOrder:
         return np
 
 cdef class CubaticOrderParameter:
-    """Compute the Cubatic Order Parameter [Cit1]_ for a system of particles using simulated annealing instead of \
-    Newton-Raphson root finding.
+    """Compute the Cubatic Order Parameter [Cit1]_ for a system of particles using simulated annealing, refined by \
+    Newton's method.
 
     .. moduleauthor:: Eric Harper <harperic@umich.edu>
 
@@ -238,6 +283,7 @@ cdef class CubaticOrderParameter:
 
     """
     cdef order.CubaticOrderParameter *thisptr
+    cdef unsigned int n_replicates
 
     def __cinit__(self, t_initial, t_final, scale, n_replicates=1, seed=None):
         # run checks
@@ -263,6 +309,7 @@ cdef class CubaticOrderParameter:
         cdef np.ndarray[float, ndim=4] r4 = dijkl+dikjl+diljk
         r4 *= (2.0/5.0)
         self.thisptr = new order.CubaticOrderParameter(t_initial, t_final, scale, <float*>r4.data, n_replicates, seed)
+        self.n_replicates = n_replicates
 
     def compute(self, orientations):
         """
@@ -280,9 +327,10 @@ cdef class CubaticOrderParameter:
 
         cdef np.ndarray[float, ndim=2] l_orientations = orientations
         cdef unsigned int num_particles = <unsigned int> orientations.shape[0]
+        cdef unsigned int n_replicates = self.n_replicates
 
         with nogil:
-            self.thisptr.compute(<quat[float]*>l_orientations.data, num_particles, 1)
+            self.thisptr.compute(<quat[float]*>l_orientations.data, num_particles, n_replicates)
 
     def get_t_initial(self):
         """
@@ -443,7 +491,7 @@ cdef class HexOrderParameter:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         with nogil:
             self.thisptr.compute(l_box, <vec3[float]*>l_points.data, nP)
 
@@ -490,6 +538,26 @@ cdef class HexOrderParameter:
         cdef float k = self.thisptr.getK()
         return k
 
+def _symmetric_eigen3(A):
+    """Closed form eigen decomposition of a 3x3 real symmetric matrix, as used by
+    :py:class:`freud.order.LocalDescriptors` for the principal axes
+
+    :return: (eigenvalues in ascending order, unit eigenvectors in columns, whether the eigenvectors were found in
+             closed form)
+    """
+    cdef np.ndarray[double, ndim=2] cA = np.ascontiguousarray(A, dtype=np.float64).reshape((3, 3))
+    cdef double cMat[3][3]
+    cdef double cValues[3]
+    cdef double cVectors[3][3]
+    cdef unsigned int i, j
+    for i in range(3):
+        for j in range(3):
+            cMat[i][j] = cA[i, j]
+    cdef cbool ok = symmetricEigen3(cMat, cValues, cVectors)
+    evalues = np.array([cValues[i] for i in range(3)], dtype=np.float64)
+    evectors = np.array([[cVectors[i][j] for j in range(3)] for i in range(3)], dtype=np.float64)
+    return evalues, evectors, ok
+
 cdef class LocalDescriptors:
     """Compute a set of descriptors (a numerical "fingerprint") of a particle's local environment.
 
@@ -499,10 +567,24 @@ cdef class LocalDescriptors:
     :param lmax: Maximum spherical harmonic :math:`l` to consider
     :param rmax: Initial guess of the maximum radius to looks for neighbors
     :param negative_m: True if we should also calculate :math:`Y_{lm}` for negative :math:`m`
+    :param output: Storage of the descriptors: 'complex' for the complex :math:`Y_{lm}`, 'real' for real spherical
+        harmonics (the same information in half the memory), or 'real_half' for real spherical harmonics in half
+        precision (:class:`numpy.float16`); or 'power_spectrum' or 'bispectrum' for :math:`l_{max} + 1` rotation
+        invariants of each particle, given by :py:meth:`getInvariants()` instead of the harmonics
     :type box: :py:class:`freud.box.Box`
     :type num_neighbors: unsigned int
     :type l: unsigned int
     :type rmax: float
+    :type output: str
+
+    The real spherical harmonics of each :math:`l` are :math:`Y_{l0}`, then :math:`\\sqrt{2} \\Re Y_{lm}` for
+    :math:`m = 1..l`, then, with negative_m, :math:`\\sqrt{2} \\Im Y_{lm}` for :math:`m = 1..l`.
+
+    With :math:`Q_{lm}` the average of :math:`Y_{lm}` over the bonds of a particle, the power spectrum is
+    :math:`\\sum_m \\left| Q_{lm} \\right|^2` and the bispectrum is
+    :math:`\\sum_{m_1 + m_2 + m_3 = 0} \\left( \\begin{array}{ccc} l & l & l \\\\ m_1 & m_2 & m_3 \\end{array} \\right)
+    Q_{lm_1} Q_{lm_2} Q_{lm_3}`, as in :py:class:`LocalWl`. The bispectrum is only tabulated for the even :math:`l`
+    from 2 to 20, and zero for other :math:`l`. Neither depends on the orientation mode or on negative_m.
 
     """
     cdef order.LocalDescriptors *thisptr
@@ -511,8 +593,16 @@ cdef class LocalDescriptors:
                    'global': order.Global,
                    'particle_local': order.ParticleLocal}
 
-    def __cinit__(self, num_neighbors, lmax, rmax, negative_m=True):
-        self.thisptr = new order.LocalDescriptors(num_neighbors, lmax, rmax, negative_m)
+    known_outputs = {'complex': order.ComplexHarmonics,
+                     'real': order.RealHarmonics,
+                     'real_half': order.HalfRealHarmonics,
+                     'power_spectrum': order.PowerSpectrum,
+                     'bispectrum': order.Bispectrum}
+
+    def __cinit__(self, num_neighbors, lmax, rmax, negative_m=True, output='complex'):
+        if output not in self.known_outputs:
+            raise RuntimeError('Unknown LocalDescriptors output: {}'.format(output))
+        self.thisptr = new order.LocalDescriptors(num_neighbors, lmax, rmax, negative_m, self.known_outputs[output])
 
     def __dealloc__(self):
         del self.thisptr
@@ -528,7 +618,7 @@ cdef class LocalDescriptors:
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
 
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         points_ref = freud.common.convert_array(points_ref, 2, dtype=np.float32, contiguous=True,
             dim_message="points_ref must be a 2 dimensional array")
         if points_ref.shape[1] != 3:
@@ -551,22 +641,30 @@ cdef class LocalDescriptors:
                                       nRef, <vec3[float]*>l_points.data, nP)
 
     def compute(self, box, unsigned int num_neighbors, points_ref, points=None,
-        orientations=None, mode='neighborhood'):
+        orientations=None, mode='neighborhood', nlist=None):
         """Calculates the local descriptors of bonds from a set of source
         points to a set of destination points.
 
+        Without nlist, the first num_neighbors neighbors found by
+        :py:meth:`computeNList()` are used, padded with zeros for particles
+        with fewer neighbors. With nlist, the descriptors of every bond of
+        the list are computed, one row per bond in the order of the list,
+        and num_neighbors is ignored.
+
         :param num_neighbors: Number of neighbors to compute with
         :param points_ref: source points to calculate the order parameter
         :param points: destination points to calculate the order parameter
         :param orientations: Orientation of each reference point
         :param mode: Orientation mode to use for environments, either 'neighborhood' to use the orientation of the local neighborhood, 'particle_local' to use the given particle orientations, or 'global' to not rotate environments
+        :param nlist: precomputed neighbor list of the bonds to compute descriptors for (optional)
         :type points_ref: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4 \\right)`, dtype= :class:`numpy.float32` or None
         :type mode: str
+        :type nlist: :py:class:`freud.locality.NeighborList`
 
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         if mode not in self.known_modes:
            raise RuntimeError('Unknown LocalDescriptors orientation mode: {}'.format(mode))
 
@@ -605,26 +703,64 @@ cdef class LocalDescriptors:
         cdef order.LocalDescriptorOrientation l_mode
 
         l_mode = self.known_modes[mode]
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
 
         with nogil:
             self.thisptr.compute(l_box, num_neighbors, <vec3[float]*>l_points_ref.data,
                                  nRef, <vec3[float]*>l_points.data, nP,
-                                 <quat[float]*>l_orientations.data, l_mode)
+                                 <quat[float]*>l_orientations.data, l_mode, cNlist)
 
     def getSph(self):
         """
         Get a reference to the last computed spherical harmonic array
 
-        :return: order parameter
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_{neighbors}, \\text{SphWidth} \\right)`, \
-            dtype= :class:`numpy.complex64`
-        """
-        cdef float complex *sph = self.thisptr.getSph().get()
+        :return: order parameter, of one row per bond when computed from a neighbor list
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_{neighbors}, \\text{SphWidth} \\right)` \
+            or :math:`\\left(N_{bonds}, \\text{SphWidth} \\right)`, dtype= :class:`numpy.complex64`, \
+            :class:`numpy.float32` or :class:`numpy.float16` by the output given to the constructor
+        """
+        if self.thisptr.isInvariant():
+            raise RuntimeError('LocalDescriptors computes invariants, not harmonics, with this output; use getInvariants()')
+        cdef void *sph
+        cdef int typenum
+        cdef order.LocalDescriptorOutput output = self.thisptr.getOutput()
+        if output == order.ComplexHarmonics:
+            sph = <void*>self.thisptr.getSph().get()
+            typenum = np.NPY_COMPLEX64
+        elif output == order.RealHarmonics:
+            sph = <void*>self.thisptr.getRealSph().get()
+            typenum = np.NPY_FLOAT32
+        else:
+            sph = <void*>self.thisptr.getHalfSph().get()
+            typenum = np.NPY_FLOAT16
         cdef np.npy_intp nbins[3]
+        cdef int ndim
+        if self.thisptr.isPerBond():
+            ndim = 2
+            nbins[0] = <np.npy_intp>self.thisptr.getNumRows()
+            nbins[1] = <np.npy_intp>self.thisptr.getSphWidth()
+        else:
+            ndim = 3
+            nbins[0] = <np.npy_intp>self.thisptr.getNP()
+            nbins[1] = <np.npy_intp>self.thisptr.getNNeigh()
+            nbins[2] = <np.npy_intp>self.thisptr.getSphWidth()
+        cdef np.ndarray result = np.PyArray_SimpleNewFromData(ndim, nbins, typenum, sph)
+        return result
+
+    def getInvariants(self):
+        """
+        Get a reference to the last computed rotation invariants, with the 'power_spectrum' or 'bispectrum' output
+
+        :return: invariants of each :math:`l` from 0 to :math:`l_{max}`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, l_{max} + 1 \\right)`, dtype= :class:`numpy.float32`
+        """
+        if not self.thisptr.isInvariant():
+            raise RuntimeError('LocalDescriptors computes harmonics, not invariants, with this output; use getSph()')
+        cdef float *invariants = self.thisptr.getInvariants().get()
+        cdef np.npy_intp nbins[2]
         nbins[0] = <np.npy_intp>self.thisptr.getNP()
-        nbins[1] = <np.npy_intp>self.thisptr.getNNeigh()
-        nbins[2] = <np.npy_intp>self.thisptr.getSphWidth()
-        cdef np.ndarray[np.complex64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_COMPLEX64, <void*>sph)
+        nbins[1] = <np.npy_intp>(self.thisptr.getLMax() + 1)
+        cdef np.ndarray[float, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>invariants)
         return result
 
     def getNP(self):
@@ -705,7 +841,7 @@ cdef class TransOrderParameter:
         if points.shape[1] != 3:
             raise TypeError('points should be an Nx3 array')
 
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
         with nogil:
@@ -743,6 +879,123 @@ cdef class TransOrderParameter:
         cdef unsigned int np = self.thisptr.getNP()
         return np
 
+cdef class HexTransOrderParameter:
+    """Compute the x-atic order parameters of a list of :math:`k` values and the translational order parameter \
+    for each particle from one nearest neighbor query.
+
+    The :math:`n` nearest neighbors are found and traversed once, instead of once by each \
+    :py:class:`HexOrderParameter` and :py:class:`TransOrderParameter`. For each :math:`k`, :math:`\\psi_k` is the \
+    value of :py:class:`HexOrderParameter` (rmax, k, n); :math:`d_r` is the value of \
+    :py:class:`TransOrderParameter` (rmax, n, n).
+
+    :math:`e^{k i \\phi_{ij}}` is computed as the :math:`k`-th power of the unit vector of the bond rather than from \
+    its angle, which requires integer values of :math:`k`.
+
+    .. note:: 2D: This calculation is defined for 2D systems only. However particle positions are still required to be \
+    (x, y, 0)
+
+    :param rmax: +/- r distance to search for neighbors
+    :param k: symmetries of the order parameters, e.g. [4, 6]
+    :param n: number of neighbors (the largest :math:`k` if :math:`n` not specified)
+    :type rmax: float
+    :type k: list of unsigned int
+    :type n: unsigned int
+    """
+    cdef order.HexTransOrderParameter *thisptr
+
+    def __cinit__(self, rmax, k=[4, 6], n=0):
+        cdef vector[unsigned int] k_values
+        for value in k:
+            k_values.push_back(value)
+        self.thisptr = new order.HexTransOrderParameter(rmax, k_values, n)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, box, points):
+        """
+        Calculates the order parameters of every :math:`k` and the translational order parameter.
+
+        :param box: simulation box
+        :param points: points to calculate the order parameters
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+
+        cdef _box.Box l_box = cpp_box(box)
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int nP = <unsigned int> points.shape[0]
+        with nogil:
+            self.thisptr.compute(l_box, <vec3[float]*>l_points.data, nP)
+
+    def getPsi(self):
+        """
+        Get a reference to the last computed :math:`\\psi_k` for each particle and :math:`k`
+
+        :return: order parameters
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_k\\right)`, dtype= :class:`numpy.complex64`
+        """
+        cdef float complex *psi = self.thisptr.getPsi().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumK()
+        cdef np.ndarray[np.complex64_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_COMPLEX64, <void*>psi)
+        return result
+
+    def getDr(self):
+        """
+        Get a reference to the last computed translational order parameter
+
+        :return: order parameter
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.complex64`
+        """
+        cdef float complex *dr = self.thisptr.getDr().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        cdef np.ndarray[np.complex64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_COMPLEX64, <void*>dr)
+        return result
+
+    def getBox(self):
+        """
+        Get the box used in the calculation
+
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(<box.Box> self.thisptr.getBox())
+
+    def getK(self):
+        """
+        Get the :math:`k` values, in the order of the columns of :py:meth:`getPsi`
+
+        :return: :math:`k` values
+        :rtype: list of unsigned int
+        """
+        return list(self.thisptr.getKValues())
+
+    def getNumNeighbors(self):
+        """
+        Get the number of neighbors
+
+        :return: :math:`n`
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumNeighbors()
+
+    def getNP(self):
+        """
+        Get the number of particles
+
+        :return: :math:`N_{particles}`
+        :rtype: unsigned int
+        """
+        cdef unsigned int np = self.thisptr.getNP()
+        return np
+
 cdef class LocalQl:
     """Compute the local Steinhardt rotationally invariant Ql [Cit4]_ order parameter for a set of points.
 
@@ -779,17 +1032,19 @@ cdef class LocalQl:
     cdef order.LocalQl *thisptr
 
     def __cinit__(self, box, rmax, l, rmin=0):
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr = new order.LocalQl(l_box, rmax, l, rmin)
 
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, points):
+    def compute(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -798,13 +1053,18 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        nlist = cached_nlist(nlist, BoxFromCPP(self.thisptr.getBox()), points, points, self.thisptr.getPairRMax())
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
 
-    def computeAve(self, points):
+    def computeAve(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -813,14 +1073,19 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+        nlist = cached_nlist(nlist, BoxFromCPP(self.thisptr.getBox()), points, points, self.thisptr.getPairRMax())
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
 
-    def computeNorm(self, points):
+    def computeNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -829,14 +1094,19 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
+        nlist = cached_nlist(nlist, BoxFromCPP(self.thisptr.getBox()), points, points, self.thisptr.getPairRMax())
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
+            self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
 
-    def computeAveNorm(self, points):
+    def computeAveNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -845,9 +1115,12 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
+        nlist = cached_nlist(nlist, BoxFromCPP(self.thisptr.getBox()), points, points, self.thisptr.getPairRMax())
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+            self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
 
     def getBox(self):
         """
@@ -865,7 +1138,7 @@ cdef class LocalQl:
         :param box: simulation box
         :type box: :py:class:`freud.box.Box`
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr.setBox(l_box)
 
     def getQl(self):
@@ -968,17 +1241,19 @@ cdef class LocalQlNear:
     cdef order.LocalQlNear *thisptr
 
     def __cinit__(self, box, rmax, l, kn=12):
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr = new order.LocalQlNear(l_box, rmax, l, kn)
 
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, points):
+    def compute(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -987,13 +1262,17 @@ cdef class LocalQlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
 
-    def computeAve(self, points):
+    def computeAve(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1002,14 +1281,18 @@ cdef class LocalQlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
 
-    def computeNorm(self, points):
+    def computeNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1018,14 +1301,18 @@ cdef class LocalQlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
+            self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
 
-    def computeAveNorm(self, points):
+    def computeAveNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1034,9 +1321,11 @@ cdef class LocalQlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+            self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
 
     def getBox(self):
         """
@@ -1054,7 +1343,7 @@ cdef class LocalQlNear:
         :param box: simulation box
         :type box: :py:class:`freud.box.Box`
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr.setBox(l_box)
 
     def getQl(self):
@@ -1151,17 +1440,19 @@ cdef class LocalWl:
     cdef order.LocalWl *thisptr
 
     def __cinit__(self, box, rmax, l):
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr = new order.LocalWl(l_box, rmax, l)
 
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, points):
+    def compute(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1170,13 +1461,17 @@ cdef class LocalWl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
 
-    def computeAve(self, points):
+    def computeAve(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1185,14 +1480,18 @@ cdef class LocalWl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
 
-    def computeNorm(self, points):
+    def computeNorm(self, points, nlist=None):
         """Compute the local rotationally invariant :math:`Q_l` order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1201,14 +1500,18 @@ cdef class LocalWl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
+            self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
 
-    def computeAveNorm(self, points):
+    def computeAveNorm(self, points, nlist=None):
         """Compute the local rotationally invariant :math:`Q_l` order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
         :type points: :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1217,9 +1520,11 @@ cdef class LocalWl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+            self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
 
     def getBox(self):
         """
@@ -1237,7 +1542,7 @@ cdef class LocalWl:
         :param box: simulation box
         :type box: :py:class:`freud.box.Box`
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr.setBox(l_box)
 
     def getQl(self):
@@ -1350,17 +1655,19 @@ cdef class LocalWlNear:
     cdef order.LocalWlNear *thisptr
 
     def __cinit__(self, box, rmax, l, kn=12):
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr = new order.LocalWlNear(l_box, rmax, l, kn)
 
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, points):
+    def compute(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1369,13 +1676,17 @@ cdef class LocalWlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
 
-    def computeAve(self, points):
+    def computeAve(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1384,14 +1695,18 @@ cdef class LocalWlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
 
-    def computeNorm(self, points):
+    def computeNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1400,14 +1715,18 @@ cdef class LocalWlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, False)
+            self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
 
-    def computeAveNorm(self, points):
+    def computeAveNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of finding the nearest neighbors (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1416,9 +1735,11 @@ cdef class LocalWlNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist, True)
+            self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+            self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
 
     def getBox(self):
         """
@@ -1436,7 +1757,7 @@ cdef class LocalWlNear:
         :param box: simulation box
         :type box: :py:class:`freud.box.Box`
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr.setBox(l_box)
 
     def getQl(self):
@@ -1514,6 +1835,169 @@ cdef class LocalWlNear:
         cdef unsigned int np = self.thisptr.getNP()
         return np
 
+cdef class Steinhardt:
+    """Compute the Steinhardt :math:`Q_l`, averaged :math:`Q_l` and :math:`W_l` order parameters [Cit4]_ for a list \
+    of :math:`l` values in a single pass over the neighbors.
+
+    The spherical harmonics of each bond are evaluated once up to the largest :math:`l`, so that e.g. :math:`Q_4`, \
+    :math:`Q_6`, :math:`Q_8`, :math:`W_4` and :math:`W_6` cost one traversal of the neighbors instead of one per \
+    :py:class:`LocalQl` or :py:class:`LocalWl`. For each :math:`l` the values are those of :py:meth:`LocalQl.compute`, \
+    :py:meth:`LocalQl.computeAve` and :py:meth:`LocalWl.compute`, except that :math:`W_l` uses the harmonics of \
+    negative :math:`m` rather than copies of the positive ones.
+
+    :math:`W_l` is computed for the even :math:`l` from 2 to 20, for which the Wigner 3j coefficients are \
+    tabulated, and is zero for other :math:`l`.
+
+    :param box: simulation box
+    :param rmax: Cutoff radius for the local order parameter. Values near first minima of the rdf are recommended
+    :param l: Spherical harmonic quantum numbers l, each two or greater
+    :param rmin: can look at only the second shell or some arbitrary rdf region
+    :type box: :py:meth:`freud.box.Box`
+    :type rmax: float
+    :type l: list of unsigned int
+    :type rmin: float
+    """
+    cdef order.Steinhardt *thisptr
+
+    def __cinit__(self, box, rmax, l, rmin=0):
+        cdef _box.Box l_box = cpp_box(box)
+        cdef vector[unsigned int] l_values
+        for value in l:
+            l_values.push_back(value)
+        self.thisptr = new order.Steinhardt(l_box, rmax, l_values, rmin)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, points, nlist=None):
+        """Compute :math:`Q_l`, the averaged :math:`Q_l` and :math:`W_l` for every :math:`l`.
+
+        :param points: points to calculate the order parameter
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int nP = <unsigned int> points.shape[0]
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP, cNlist)
+
+    def getBox(self):
+        """
+        Get the box used in the calculation
+
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(<box.Box> self.thisptr.getBox())
+
+    def setBox(self, box):
+        """
+        Reset the simulation box
+
+        :param box: simulation box
+        :type box: :py:class:`freud.box.Box`
+        """
+        cdef _box.Box l_box = cpp_box(box)
+        self.thisptr.setBox(l_box)
+
+    def getL(self):
+        """
+        Get the :math:`l` values, in the order of the columns of the results
+
+        :return: :math:`l` values
+        :rtype: list of unsigned int
+        """
+        return list(self.thisptr.getLValues())
+
+    def getQl(self):
+        """
+        Get a reference to the last computed :math:`Q_l` for each particle and :math:`l`.  Returns NaN instead of \
+        :math:`Q_l` for particles with no neighbors.
+
+        :return: order parameter
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_l\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float *Ql = self.thisptr.getQl().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumL()
+        cdef np.ndarray[float, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>Ql)
+        return result
+
+    def getAveQl(self):
+        """
+        Get a reference to the last computed :math:`Q_l` averaged over the second shell for each particle and \
+        :math:`l`.  Returns NaN instead of :math:`Q_l` for particles with no neighbors.
+
+        :return: order parameter
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_l\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float *Ql = self.thisptr.getAveQl().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumL()
+        cdef np.ndarray[float, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>Ql)
+        return result
+
+    def getWl(self):
+        """
+        Get a reference to the last computed :math:`W_l` for each particle and :math:`l`.  Returns NaN instead of \
+        :math:`W_l` for particles with no neighbors.
+
+        :return: order parameter
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_l\\right)`, dtype= :class:`numpy.complex64`
+        """
+        cdef float complex *Wl = self.thisptr.getWl().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumL()
+        cdef np.ndarray[np.complex64_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_COMPLEX64, <void*>Wl)
+        return result
+
+    def getAveWl(self):
+        """
+        Get a reference to the last computed :math:`W_l` of the averaged :math:`Q_{lm}` for each particle and \
+        :math:`l`.  Returns NaN instead of :math:`W_l` for particles with no neighbors.
+
+        :return: order parameter
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_l\\right)`, dtype= :class:`numpy.complex64`
+        """
+        cdef float complex *Wl = self.thisptr.getAveWl().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumL()
+        cdef np.ndarray[np.complex64_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_COMPLEX64, <void*>Wl)
+        return result
+
+    def enableNormalization(self):
+        """
+        Divide :math:`W_l` by :math:`\\left(\\sum_m |Q_{lm}|^2\\right)^{3/2}` in the following computes
+        """
+        self.thisptr.enableNormalization()
+
+    def disableNormalization(self):
+        """
+        Report :math:`W_l` without normalization in the following computes
+        """
+        self.thisptr.disableNormalization()
+
+    def getNP(self):
+        """
+        Get the number of particles
+
+        :return: :math:`N_{particles}`
+        :rtype: unsigned int
+        """
+        cdef unsigned int np = self.thisptr.getNP()
+        return np
+
 cdef class SolLiq:
     """Computes dot products of :math:`Q_{lm}` between particles and uses these for clustering.
 
@@ -1537,7 +2021,7 @@ cdef class SolLiq:
     cdef order.SolLiq *thisptr
 
     def __cinit__(self, box, rmax, Qthreshold, Sthreshold, l):
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr = new order.SolLiq(l_box, rmax, Qthreshold, Sthreshold, l)
 
     def __dealloc__(self):
@@ -1556,7 +2040,8 @@ cdef class SolLiq:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP)
 
     def computeSolLiqVariant(self, points):
         """Compute the local rotationally invariant Ql order parameter.
@@ -1571,7 +2056,8 @@ cdef class SolLiq:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.computeSolLiqVariant(<vec3[float]*>l_points.data, nP)
+        with nogil:
+            self.thisptr.computeSolLiqVariant(<vec3[float]*>l_points.data, nP)
 
     def computeSolLiqNoNorm(self, points):
         """Compute the local rotationally invariant Ql order parameter.
@@ -1586,7 +2072,8 @@ cdef class SolLiq:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.computeSolLiqNoNorm(<vec3[float]*>l_points.data, nP)
+        with nogil:
+            self.thisptr.computeSolLiqNoNorm(<vec3[float]*>l_points.data, nP)
 
     def getBox(self):
         """
@@ -1613,8 +2100,7 @@ cdef class SolLiq:
         :param box: simulation box
         :type box: :py:class:`freud.box.Box`
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr.setBox(l_box)
 
     def getLargestClusterSize(self):
@@ -1733,7 +2219,7 @@ cdef class SolLiqNear:
     cdef order.SolLiqNear *thisptr
 
     def __cinit__(self, box, rmax, Qthreshold, Sthreshold, l, kn=12):
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr = new order.SolLiqNear(l_box, rmax, Qthreshold, Sthreshold, l, kn)
 
     def __dealloc__(self):
@@ -1752,7 +2238,8 @@ cdef class SolLiqNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*>l_points.data, nP)
 
     def computeSolLiqVariant(self, points):
         """Compute the local rotationally invariant :math:`Q_l` order parameter.
@@ -1767,7 +2254,8 @@ cdef class SolLiqNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.computeSolLiqVariant(<vec3[float]*>l_points.data, nP)
+        with nogil:
+            self.thisptr.computeSolLiqVariant(<vec3[float]*>l_points.data, nP)
 
     def computeSolLiqNoNorm(self, points):
         """Compute the local rotationally invariant :math:`Q_l` order parameter.
@@ -1782,7 +2270,8 @@ cdef class SolLiqNear:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.computeSolLiqNoNorm(<vec3[float]*>l_points.data, nP)
+        with nogil:
+            self.thisptr.computeSolLiqNoNorm(<vec3[float]*>l_points.data, nP)
 
     def getBox(self):
         """
@@ -1809,7 +2298,7 @@ cdef class SolLiqNear:
         :param box: simulation box
         :type box: :py:class:`freud.box.Box`
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr.setBox(l_box)
 
     def getLargestClusterSize(self):
@@ -1919,8 +2408,7 @@ cdef class MatchEnv:
     cdef order.MatchEnv *thisptr
 
     def __cinit__(self, box, rmax, k):
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr = new order.MatchEnv(l_box, rmax, k)
 
     def __dealloc__(self):
@@ -1933,10 +2421,28 @@ cdef class MatchEnv:
         :param box: simulation box
         :type box: :py:class:`freud.box.Box`
         """
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
-            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
         self.thisptr.setBox(l_box)
 
+    def setAcceleratedRegistration(self, accelerated):
+        """Set whether the registration matches the points to anchors chosen once from the geometry of each
+        environment, trying every correspondence from the most consistent one (the default), or to random triplets of
+        its vectors, as before the accelerated registration. Both find the same rotation and mapping of environments
+        that match.
+
+        :param accelerated: whether to use the accelerated registration
+        :type accelerated: bool
+        """
+        self.thisptr.setAcceleratedRegistration(accelerated)
+
+    def getAcceleratedRegistration(self):
+        """
+        :return: whether the registration is accelerated
+        :rtype: bool
+        """
+        cdef bint accelerated = self.thisptr.getAcceleratedRegistration()
+        return accelerated
+
     def cluster(self, points, threshold, hard_r=False, registration=False, global_search=False):
         """Determine clusters of particles with matching environments.
 
@@ -1956,11 +2462,18 @@ cdef class MatchEnv:
             raise TypeError('points should be an Nx3 array')
 
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef np.ndarray[float, ndim=1] l_points = np.ascontiguousarray(points.flatten())
+        cdef np.ndarray[float, ndim=1] l_points = points.ravel()
         cdef unsigned int nP = <unsigned int> points.shape[0]
 
+        cdef vec3[float] *l_points_ptr = <vec3[float]*>&l_points[0]
+        cdef float l_threshold = threshold
+        cdef bint l_hard_r = hard_r
+        cdef bint l_registration = registration
+        cdef bint l_global_search = global_search
+
         # keeping the below syntax seems to be crucial for passing unit tests
-        self.thisptr.cluster(<vec3[float]*>&l_points[0], nP, threshold, hard_r, registration, global_search)
+        with nogil:
+            self.thisptr.cluster(l_points_ptr, nP, l_threshold, l_hard_r, l_registration, l_global_search)
 
     def matchMotif(self, points, refPoints, threshold, registration=False):
         """Determine clusters of particles that match the motif provided by refPoints.
@@ -1985,13 +2498,19 @@ cdef class MatchEnv:
             raise TypeError('refPoints should be an Nx3 array')
 
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef np.ndarray[float, ndim=1] l_points = np.ascontiguousarray(points.flatten())
-        cdef np.ndarray[float, ndim=1] l_refPoints = np.ascontiguousarray(refPoints.flatten())
+        cdef np.ndarray[float, ndim=1] l_points = points.ravel()
+        cdef np.ndarray[float, ndim=1] l_refPoints = refPoints.ravel()
         cdef unsigned int nP = <unsigned int> points.shape[0]
         cdef unsigned int nRef = <unsigned int> refPoints.shape[0]
 
+        cdef vec3[float] *l_points_ptr = <vec3[float]*>&l_points[0]
+        cdef vec3[float] *l_refPoints_ptr = <vec3[float]*>&l_refPoints[0]
+        cdef float l_threshold = threshold
+        cdef bint l_registration = registration
+
         # keeping the below syntax seems to be crucial for passing unit tests
-        self.thisptr.matchMotif(<vec3[float]*>&l_points[0], nP, <vec3[float]*>&l_refPoints[0], nRef, threshold, registration)
+        with nogil:
+            self.thisptr.matchMotif(l_points_ptr, nP, l_refPoints_ptr, nRef, l_threshold, l_registration)
 
     def minRMSDMotif(self, points, refPoints, registration=False):
         """Rotate (if registration=True) and permute the environments of all particles to minimize their RMSD wrt the motif provided by refPoints.
@@ -2018,16 +2537,64 @@ cdef class MatchEnv:
             raise TypeError('refPoints should be an Nx3 array')
 
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef np.ndarray[float, ndim=1] l_points = np.ascontiguousarray(points.flatten())
-        cdef np.ndarray[float, ndim=1] l_refPoints = np.ascontiguousarray(refPoints.flatten())
+        cdef np.ndarray[float, ndim=1] l_points = points.ravel()
+        cdef np.ndarray[float, ndim=1] l_refPoints = refPoints.ravel()
         cdef unsigned int nP = <unsigned int> points.shape[0]
         cdef unsigned int nRef = <unsigned int> refPoints.shape[0]
 
+        cdef vec3[float] *l_points_ptr = <vec3[float]*>&l_points[0]
+        cdef vec3[float] *l_refPoints_ptr = <vec3[float]*>&l_refPoints[0]
+        cdef bint l_registration = registration
+        cdef vector[float] min_rmsd_vec
+
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef vector[float] min_rmsd_vec = self.thisptr.minRMSDMotif(<vec3[float]*>&l_points[0], nP, <vec3[float]*>&l_refPoints[0], nRef, registration)
+        with nogil:
+            min_rmsd_vec = self.thisptr.minRMSDMotif(l_points_ptr, nP, l_refPoints_ptr, nRef, l_registration)
 
         return min_rmsd_vec
 
+    def matchMotifs(self, points, refPoints, threshold, registration=False):
+        """Determine which of several motifs the environment of each particle matches. The clusters of the last call to :py:meth:`cluster` or :py:meth:`matchMotif` are left as they are.
+
+        :param points: particle positions
+        :param refPoints: vectors that make up each of the motifs against which we are matching
+        :param threshold: maximum magnitude of the vector difference between two vectors, below which you call them matching
+        :param registration: if true, first use brute force registration to orient one set of environment vectors with respect to the other set such that it minimizes the RMSD between the two sets
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type refPoints: :class:`numpy.ndarray`, shape= :math:`\\left(N_{motifs}, N_{neighbors}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type threshold: float
+        :type registration: bool
+        :return: index of the first motif matched by each particle, :math:`N_{motifs}` for the particles that match none of them
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+
+        refPoints = freud.common.convert_array(refPoints, 3, dtype=np.float32, contiguous=True,
+            dim_message="refPoints must be a 3 dimensional array")
+        if refPoints.shape[2] != 3:
+            raise TypeError('refPoints should be an MxNx3 array')
+
+        # keeping the below syntax seems to be crucial for passing unit tests
+        cdef np.ndarray[float, ndim=1] l_points = points.ravel()
+        cdef np.ndarray[float, ndim=1] l_refPoints = refPoints.ravel()
+        cdef unsigned int nP = <unsigned int> points.shape[0]
+        cdef unsigned int nMotifs = <unsigned int> refPoints.shape[0]
+        cdef unsigned int nRef = <unsigned int> refPoints.shape[1]
+
+        cdef vec3[float] *l_points_ptr = <vec3[float]*>&l_points[0]
+        cdef vec3[float] *l_refPoints_ptr = <vec3[float]*>&l_refPoints[0]
+        cdef float l_threshold = threshold
+        cdef bint l_registration = registration
+        cdef vector[unsigned int] motif_index
+
+        with nogil:
+            motif_index = self.thisptr.matchMotifs(l_points_ptr, nP, l_refPoints_ptr, nMotifs, nRef, l_threshold, l_registration)
+
+        return np.array(motif_index, dtype=np.uint32)
+
     def isSimilar(self, refPoints1, refPoints2, threshold, registration=False):
         """Test if the motif provided by refPoints1 is similar to the motif provided by refPoints2.
 
@@ -2053,8 +2620,8 @@ cdef class MatchEnv:
             raise TypeError('refPoints2 should be an Nx3 array')
 
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef np.ndarray[float, ndim=1] l_refPoints1 = np.copy(np.ascontiguousarray(refPoints1.flatten()))
-        cdef np.ndarray[float, ndim=1] l_refPoints2 = np.copy(np.ascontiguousarray(refPoints2.flatten()))
+        cdef np.ndarray[float, ndim=1] l_refPoints1 = refPoints1.ravel()
+        cdef np.ndarray[float, ndim=1] l_refPoints2 = refPoints2.flatten()
         cdef unsigned int nRef1 = <unsigned int> refPoints1.shape[0]
         cdef unsigned int nRef2 = <unsigned int> refPoints2.shape[0]
         cdef float threshold_sq = threshold*threshold
@@ -2062,8 +2629,14 @@ cdef class MatchEnv:
         if nRef1 != nRef2:
             raise ValueError("the number of vectors in refPoints1 must MATCH the number of vectors in refPoints2")
 
+        cdef vec3[float] *l_refPoints1_ptr = <vec3[float]*>&l_refPoints1[0]
+        cdef vec3[float] *l_refPoints2_ptr = <vec3[float]*>&l_refPoints2[0]
+        cdef bint l_registration = registration
+        cdef map[unsigned int, unsigned int] vec_map
+
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef map[unsigned int, unsigned int] vec_map = self.thisptr.isSimilar(<vec3[float]*>&l_refPoints1[0], <vec3[float]*>&l_refPoints2[0], nRef1, threshold_sq, registration)
+        with nogil:
+            vec_map = self.thisptr.isSimilar(l_refPoints1_ptr, l_refPoints2_ptr, nRef1, threshold_sq, l_registration)
         cdef np.ndarray[float, ndim=2] rot_refPoints2 = np.reshape(l_refPoints2, (nRef2, 3))
         return [rot_refPoints2, vec_map]
 
@@ -2090,8 +2663,8 @@ cdef class MatchEnv:
             raise TypeError('refPoints2 should be an Nx3 array')
 
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef np.ndarray[float, ndim=1] l_refPoints1 = np.copy(np.ascontiguousarray(refPoints1.flatten()))
-        cdef np.ndarray[float, ndim=1] l_refPoints2 = np.copy(np.ascontiguousarray(refPoints2.flatten()))
+        cdef np.ndarray[float, ndim=1] l_refPoints1 = refPoints1.ravel()
+        cdef np.ndarray[float, ndim=1] l_refPoints2 = refPoints2.flatten()
         cdef unsigned int nRef1 = <unsigned int> refPoints1.shape[0]
         cdef unsigned int nRef2 = <unsigned int> refPoints2.shape[0]
 
@@ -2099,8 +2672,14 @@ cdef class MatchEnv:
             raise ValueError("the number of vectors in refPoints1 must MATCH the number of vectors in refPoints2")
 
         cdef float min_rmsd = -1
+        cdef vec3[float] *l_refPoints1_ptr = <vec3[float]*>&l_refPoints1[0]
+        cdef vec3[float] *l_refPoints2_ptr = <vec3[float]*>&l_refPoints2[0]
+        cdef bint l_registration = registration
+        cdef map[unsigned int, unsigned int] results_map
+
         # keeping the below syntax seems to be crucial for passing unit tests
-        cdef map[unsigned int, unsigned int] results_map = self.thisptr.minimizeRMSD(<vec3[float]*>&l_refPoints1[0], <vec3[float]*>&l_refPoints2[0], nRef1, min_rmsd, registration)
+        with nogil:
+            results_map = self.thisptr.minimizeRMSD(l_refPoints1_ptr, l_refPoints2_ptr, nRef1, min_rmsd, l_registration)
         cdef np.ndarray[float, ndim=2] rot_refPoints2 = np.reshape(l_refPoints2, (nRef2, 3))
         return [min_rmsd, rot_refPoints2, results_map]
 
@@ -2190,18 +2769,20 @@ cdef class Pairing2D:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, box, points, orientations, compOrientations):
+    def compute(self, box, points, orientations, compOrientations, nlist=None):
         """
-        Calculates the correlation function and adds to the current histogram.
+        Finds the pair of each particle, if any.
 
         :param box: simulation box
         :param points: reference points to calculate the local density
         :param orientations: orientations to use in computation
         :param compOrientations: possible orientations to check for bonds
+        :param nlist: precomputed neighbor list to use instead of the k nearest neighbors (optional)
         :type box: :py:class:`freud.box.Box`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
-        :type compOrientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type compOrientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, N_{orientations}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -2219,8 +2800,10 @@ cdef class Pairing2D:
         cdef np.ndarray[float, ndim=1] l_orientations = orientations
         cdef unsigned int nP = <unsigned int> points.shape[0]
         cdef unsigned int nO = <unsigned int> compOrientations.shape[1]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
-        self.thisptr.compute(l_box, <vec3[float]*>l_points.data, <float*>l_orientations.data, <float*>l_compOrientations.data, nP, nO)
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.compute(l_box, <vec3[float]*>l_points.data, <float*>l_orientations.data, <float*>l_compOrientations.data, nP, nO, cNlist)
 
     def getMatch(self):
         """
@@ -2230,7 +2813,7 @@ cdef class Pairing2D:
         cdef unsigned int *match = self.thisptr.getMatch().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNumParticles()
-        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32, <void*>match)
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>match)
         return result
 
     def getPair(self):
@@ -2241,7 +2824,7 @@ cdef class Pairing2D:
         cdef unsigned int *pair = self.thisptr.getPair().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNumParticles()
-        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32, <void*>pair)
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>pair)
         return result
 
     def getBox(self):
@@ -21,6 +21,7 @@ from ._freud import LocalQl
 from ._freud import LocalQlNear
 from ._freud import LocalWl
 from ._freud import LocalWlNear
+from ._freud import Steinhardt
 from ._freud import MatchEnv
 from ._freud import SolLiq
 from ._freud import SolLiqNear
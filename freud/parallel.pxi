@@ -2,6 +2,15 @@
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
 cimport freud._parallel as parallel
+cimport freud._box as _box
+cimport freud.util._Profiler as _profiler
+cimport freud.util._MemoryUsage as _memory
+cimport freud.util._Annotation as _annotation
+from freud.util._VectorMath cimport vec3
+import numpy as np
+cimport numpy as np
+import concurrent.futures
+import threading
 
 # override TBB's default autoselection. This is necessary because once the automatic selection runs, the user cannot
 # change it
@@ -26,3 +35,266 @@ def setNumThreads(nthreads=None):
 
     cdef unsigned int cNthreads = nthreads;
     parallel.setNumThreads(cNthreads)
+
+_compute_executor = None
+_compute_executor_lock = threading.Lock()
+
+def submit(func, *args, **kwargs):
+    """Start func(\\*args, \\*\\*kwargs) on the compute thread of freud, such as
+    `future = submit(rdf.accumulate, box, points, points)`
+
+    The calls submitted are run one after the other, in the order they were submitted, by a single thread, while the
+    calling thread goes on, reading the next frame from disk for instance. The computations release the GIL and
+    each still runs its loops in parallel. Since the calls are run in order, the results of a computation can be
+    read once the future of its last call is done; the arrays passed must not be changed until then.
+
+    :return: future of the return value of func, which raises its exception if any
+    :rtype: :py:class:`concurrent.futures.Future`
+    """
+    global _compute_executor
+    with _compute_executor_lock:
+        if _compute_executor is None:
+            _compute_executor = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+    return _compute_executor.submit(func, *args, **kwargs)
+
+def isProfilingEnabled():
+    """Get whether freud was built with the ENABLE_PROFILING option of CMake, without which the getTimings and
+    getStats methods of the analyses return empty dictionaries
+
+    :rtype: bool
+    """
+    cdef bint enabled = _profiler.isProfilingEnabled()
+    return enabled
+
+def isAnnotationEnabled():
+    """Get whether freud was built with the ENABLE_ITT or ENABLE_NVTX option of CMake, with which the phases of the
+    analyses and the tasks of their parallel loops appear as named ranges in VTune or Nsight
+
+    :rtype: bool
+    """
+    cdef bint enabled = _annotation.isAnnotationEnabled()
+    return enabled
+
+cdef dict _profileTimings(const _profiler.Profiler& profiler):
+    # the wall time of each phase of a profiler, by name
+    cdef dict timings = profiler.getTimings()
+    result = {}
+    for name, seconds in timings.items():
+        result[name.decode('utf-8')] = seconds
+    return result
+
+cdef dict _profileStats(const _profiler.Profiler& profiler):
+    # the counters of a profiler, by name
+    cdef dict stats = profiler.getStats()
+    result = {}
+    for name, count in stats.items():
+        result[name.decode('utf-8')] = count
+    return result
+
+cdef dict _memoryUsage(const _memory.MemoryUsage& usage):
+    # the bytes of each component of a memory usage, by name
+    cdef dict components = usage.getComponents()
+    result = {}
+    for name, num_bytes in components.items():
+        result[name.decode('utf-8')] = num_bytes
+    return result
+
+def getNumaNodes():
+    """Get the NUMA nodes a :py:class:`ThreadArena` can be placed on
+
+    :return: ids of the NUMA nodes; just -1 when they are not known
+    :rtype: list of int
+    """
+    return parallel.getNumaNodes()
+
+cdef void _arenaCall(void *data) with gil:
+    # runs the call of ThreadArena.execute in the arena, keeping any exception for execute to raise
+    call = <object> data
+    try:
+        call[3] = call[0](*call[1], **call[2])
+    except BaseException as e:
+        call[4] = e
+
+cdef class ThreadArena:
+    """A set of threads that computations can be confined to
+
+    The parallel loops of all the freud computations run through :py:meth:`execute()` are run by the threads of
+    this arena only, up to its number of threads and on the cores of its NUMA node, if any. Unlike
+    :py:func:`setNumThreads()`, this does not change the threads of the other computations of the process, so that
+    analyses run concurrently from several Python threads can each be given their own arena.
+
+    :param nthreads: number of threads of the arena. If None (default), as many as the cores (of the NUMA node)
+    :param numa_node: NUMA node to run on, one of :py:func:`getNumaNodes()`. If None (default), any
+    :type nthreads: int or None
+    :type numa_node: int or None
+    """
+    cdef parallel.ThreadArena *thisptr
+
+    def __cinit__(self, nthreads=None, numa_node=None):
+        cdef unsigned int cNthreads = 0 if nthreads is None or nthreads < 0 else nthreads
+        cdef int cNuma_node = -1 if numa_node is None else numa_node
+        self.thisptr = new parallel.ThreadArena(cNthreads, cNuma_node)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getNumThreads(self):
+        """Get the number of threads of the arena
+
+        :return: number of threads
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumThreads()
+
+    def getNumaNode(self):
+        """Get the NUMA node of the arena
+
+        :return: NUMA node, or None for any
+        :rtype: int or None
+        """
+        cdef int numa_node = self.thisptr.getNumaNode()
+        return None if numa_node == -1 else numa_node
+
+    def execute(self, func, *args, **kwargs):
+        """Call func(\\*args, \\*\\*kwargs) with its computations run in the arena, such as
+        `arena.execute(rdf.compute, box, points, points)`
+
+        :return: the return value of func
+        """
+        call = [func, args, kwargs, None, None]
+        with nogil:
+            self.thisptr.execute(_arenaCall, <void*> call)
+        if call[4] is not None:
+            raise call[4]
+        return call[3]
+
+cdef void _pipelineCall(void *data, const _box.Box& cbox, const vec3[float] *points, unsigned int Np,
+                        unsigned int frame) with gil:
+    # gives a frame of FramePipeline.run to one analysis, keeping the first exception for run to raise
+    call = <object> data
+    if call[3]:
+        return
+    cdef np.npy_intp shape[2]
+    shape[0] = Np
+    shape[1] = 3
+    frame_points = np.PyArray_SimpleNewFromData(2, shape, np.NPY_FLOAT32, <void*> points)
+    try:
+        call[0](call[2], frame_points, frame)
+    except BaseException as e:
+        call[3].append(e)
+        (<FramePipeline> call[1]).thisptr.stop()
+
+cdef class FramePipeline:
+    """Stream the frames of a trajectory file through a list of analyses, reading the next frames while they compute
+
+    The file holds frames of n_points points as float32 x, y, z triples, one frame after the other from offset
+    bytes on, such as an array of shape (N_frames, n_points, 3) saved with :py:func:`numpy.save`, whose header is
+    read when n_points is None. The file is mapped in memory, and :py:meth:`run()` reads each frame from it and wraps
+    its points into the box on the threads of TBB, up to max_in_flight frames ahead of the one given to the analyses,
+    so that reading and computing overlap.
+
+    :param filename: trajectory file
+    :param n_points: number of points of each frame. If None (default), filename is a .npy file
+    :param offset: number of bytes before the first frame
+    :param max_in_flight: largest number of frames read ahead at once
+    :type filename: str
+    :type n_points: unsigned int or None
+    :type offset: unsigned int
+    :type max_in_flight: unsigned int
+    """
+    cdef parallel.FramePipeline *thisptr
+    cdef object analyses
+
+    def __cinit__(self, filename, n_points=None, offset=0, max_in_flight=4):
+        if n_points is None:
+            with open(filename, 'rb') as f:
+                version = np.lib.format.read_magic(f)
+                if version == (1, 0):
+                    shape, fortran_order, dtype = np.lib.format.read_array_header_1_0(f)
+                else:
+                    shape, fortran_order, dtype = np.lib.format.read_array_header_2_0(f)
+                if len(shape) != 3 or shape[2] != 3 or fortran_order or dtype != np.float32:
+                    raise TypeError('{} should hold a C ordered float32 array of shape (N_frames, N_points, 3)'.format(
+                        filename))
+                n_points = shape[1]
+                offset = f.tell()
+        cdef string cFilename = filename.encode('utf-8')
+        self.thisptr = new parallel.FramePipeline(cFilename, n_points, offset, max_in_flight)
+        self.analyses = []
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getNumFrames(self):
+        """Get the number of frames of the file
+
+        :return: number of frames
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumFrames()
+
+    def getNP(self):
+        """Get the number of points of each frame
+
+        :return: number of points
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNP()
+
+    def getMaxInFlight(self):
+        """Get the largest number of frames read ahead at once
+
+        :return: number of frames
+        :rtype: unsigned int
+        """
+        return self.thisptr.getMaxInFlight()
+
+    def add(self, analysis):
+        """Add an analysis, called as analysis(box, points, frame) with each frame by :py:meth:`run()`, such as
+        `pipeline.add(lambda box, points, frame: rdf.accumulate(box, points, points))`
+
+        The frames are given in order, after the previous analyses. points is only valid during the call: it is the
+        buffer the next frames are read into, so copy it to keep it.
+
+        :param analysis: function of the box, the :class:`numpy.ndarray` of the points and the index of the frame
+        """
+        self.analyses.append(analysis)
+
+    def clear(self):
+        """Remove all the analyses"""
+        self.analyses = []
+
+    def run(self, box, start=0, stop=None, step=1):
+        """Give the frames start, start + step, ... before stop (default: the end of the file) to the analyses
+
+        The first exception raised by an analysis stops the run and is raised again.
+
+        :param box: simulation box of the frames
+        :type box: :py:class:`freud.box.Box`
+        :return: number of frames given to the analyses
+        :rtype: unsigned int
+        """
+        cdef _box.Box l_box = cpp_box(box)
+        cdef unsigned int cStart = start
+        cdef unsigned int cStop = self.thisptr.getNumFrames() if stop is None else stop
+        cdef unsigned int cStep = step
+        # the calls share their list of errors, so that an error skips the other analyses of the frame as well
+        errors = []
+        calls = [[analysis, self, box, errors] for analysis in self.analyses]
+        self.thisptr.clearAnalyses()
+        for call in calls:
+            self.thisptr.addAnalysis(_pipelineCall, <void*> call)
+        cdef unsigned int num_run
+        try:
+            with nogil:
+                num_run = self.thisptr.run(l_box, cStart, cStop, cStep)
+        finally:
+            self.thisptr.clearAnalyses()
+        if errors:
+            raise errors[0]
+        return num_run
+
+    def stop(self):
+        """Make :py:meth:`run()` give no more frames to the analyses, such as when called from an analysis"""
+        self.thisptr.stop()
+
@@ -5,11 +5,21 @@
 #
 # Methods to control parallel execution
 #
+import collections
 import multiprocessing
+import numpy as np
+import os
 import platform
 import re
+import tempfile
 from . import _freud
 from ._freud import setNumThreads
+from ._freud import getNumaNodes
+from ._freud import isProfilingEnabled
+from ._freud import isAnnotationEnabled
+from ._freud import ThreadArena
+from ._freud import submit
+from ._freud import FramePipeline
 
 if (re.match("flux.", platform.node()) is not None) or (re.match("nyx.", platform.node()) is not None):
     _freud.setNumThreads(1);
@@ -24,3 +34,177 @@ class NumThreads:
 
     def __exit__(self, *args):
         _freud.setNumThreads(self.restore_N)
+
+def reduceAcrossRanks(analysis, comm, root=0):
+    """Add the accumulated states of an analysis on all the processes of an MPI communicator into that on root
+
+    Each process accumulates the frames of its part of a trajectory, then all call reduceAcrossRanks; the state of
+    each one is sent to root as a checkpoint (see :py:meth:`saveState() <freud.density.RDF.saveState>`) and merged
+    into the analysis there, which then holds the result of the whole trajectory. The analyses of the other processes
+    are left as they are. Any analysis with saveState and loadState can be reduced.
+
+    :param analysis: analysis to reduce, with the same parameters on all the processes
+    :param comm: communicator, such as :py:data:`mpi4py.MPI.COMM_WORLD`
+    :param root: rank of the process the states are reduced to
+    :type comm: :py:class:`mpi4py.MPI.Comm`
+    :type root: int
+    :return: the analysis
+    """
+    handle, filename = tempfile.mkstemp(suffix='.ckp')
+    os.close(handle)
+    try:
+        analysis.saveState(filename)
+        with open(filename, 'rb') as f:
+            state = f.read()
+        states = comm.gather(state, root=root)
+        if comm.Get_rank() == root:
+            for rank, state in enumerate(states):
+                if rank == root:
+                    continue
+                with open(filename, 'wb') as f:
+                    f.write(state)
+                analysis.loadState(filename, merge=True)
+    finally:
+        os.remove(filename)
+    return analysis
+
+DomainPoints = collections.namedtuple('DomainPoints', ['box', 'points', 'tags', 'num_owned', 'ghost_owners',
+                                                       'frame_box', 'frame_num_points'])
+DomainPoints.__doc__ = """Points of the domain of a process, from :py:func:`exchangeDomains`
+
+The points are the owned points then the ghosts of the domain, in the coordinates of box, each with the tag it has in
+the frame; ghost_owners is the rank of the process that owns each ghost. frame_box and frame_num_points are those of
+the whole frame, to normalize the analyses by."""
+
+def exchangeDomains(decomposition, points, comm, tags=None):
+    """Distribute the points of all the processes of an MPI communicator to the domains of a decomposition, one per
+    process
+
+    Each process gives the points it holds, such as those of its domain of the simulation, and gets the points its
+    domain of decomposition owns and the ghosts within the width of the decomposition of it, in the coordinates of the
+    box of the domain. Only the points of the domain and its ghosts are sent to each process, with one all-to-all
+    exchange, so the frame never has to fit on one node. A per-particle analysis of cutoff up to the ghost width
+    computed on the points of the domain, such as :py:class:`freud.density.LocalDensity` with the owned points as
+    reference points or :py:class:`freud.order.LocalQl`, is exact for the owned points; see
+    :py:meth:`freud.density.RDF.accumulateDomain` and :py:func:`mergeClustersAcrossRanks` for the rdf and clusters.
+
+    Example::
+
+       decomposition = freud.locality.DomainDecomposition(box, (2, 2, 2), rmax)
+       domain = freud.parallel.exchangeDomains(decomposition, my_points, comm)
+       rdf.accumulateDomain(domain.box, domain.points, domain.num_owned, domain.frame_box,
+                            domain.frame_num_points, comm.Get_rank() == 0)
+       freud.parallel.reduceAcrossRanks(rdf, comm)
+
+    :param decomposition: decomposition of the box, of one domain per process
+    :param points: points held by this process
+    :param comm: communicator, such as :py:data:`mpi4py.MPI.COMM_WORLD`
+    :param tags: ids of the points in the frame; by default the points are numbered in the order of the ranks
+    :type decomposition: :py:class:`freud.locality.DomainDecomposition`
+    :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+    :type comm: :py:class:`mpi4py.MPI.Comm`
+    :type tags: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.int64`
+    :rtype: :py:class:`DomainPoints`
+    """
+    num_ranks = comm.Get_size()
+    rank = comm.Get_rank()
+    if decomposition.getNumDomains() != num_ranks:
+        raise ValueError('The decomposition must have one domain per process')
+    points = np.ascontiguousarray(points, dtype=np.float32)
+    if tags is None:
+        first = comm.exscan(len(points))
+        tags = np.arange(len(points), dtype=np.int64) + (first if rank > 0 else 0)
+    tags = np.asarray(tags, dtype=np.int64)
+    if len(tags) != len(points):
+        raise ValueError('There must be one tag per point')
+
+    decomposition.compute(points)
+    offsets = decomposition.getOffsets()
+    indices = decomposition.getIndices()
+    positions = decomposition.getPositions()
+    domains = decomposition.getDomains()
+    sends = []
+    for domain in range(num_ranks):
+        owned = slice(offsets[2*domain], offsets[2*domain + 1])
+        ghosts = slice(offsets[2*domain + 1], offsets[2*domain + 2])
+        sends.append((np.copy(positions[owned]), tags[indices[owned]], np.copy(positions[ghosts]),
+                      tags[indices[ghosts]], domains[indices[ghosts]].astype(np.int32)))
+    received = comm.alltoall(sends)
+    num_owned = sum(len(r[0]) for r in received)
+    domain_points = np.concatenate([r[0] for r in received] + [r[2] for r in received]).reshape(-1, 3)
+    domain_tags = np.concatenate([r[1] for r in received] + [r[3] for r in received])
+    ghost_owners = np.concatenate([r[4] for r in received])
+    return DomainPoints(decomposition.getDomainBox(rank), domain_points, domain_tags, num_owned, ghost_owners,
+                        decomposition.getBox(), comm.allreduce(len(points)))
+
+def mergeClustersAcrossRanks(cluster_idx, num_clusters, domain, comm, root=0):
+    """Join the clusters found in the domains of all the processes of an MPI communicator into those of the frame
+
+    Each process finds the clusters of the points of its domain from :py:func:`exchangeDomains`, such as with
+    :py:class:`freud.cluster.Cluster` of the box of the domain and a cutoff up to the ghost width. A cluster of a
+    domain that holds a ghost is the same cluster as that of the point of the ghost in the domain that owns it: the
+    clusters of the ghosts are asked from their owners, and these links, which are only those of the ghost layers, are
+    joined with a union-find on root.
+
+    :param cluster_idx: cluster of each point of the domain, owned points and ghosts
+    :param num_clusters: number of clusters of the domain
+    :param domain: points of the domain
+    :param comm: communicator, such as :py:data:`mpi4py.MPI.COMM_WORLD`
+    :param root: rank of the process the links are joined on
+    :type cluster_idx: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+    :type num_clusters: int
+    :type domain: :py:class:`DomainPoints`
+    :type comm: :py:class:`mpi4py.MPI.Comm`
+    :type root: int
+    :return: cluster of each owned point in the frame, numbered from 0 across all the processes, and the number of
+             clusters of the frame
+    :rtype: (:class:`numpy.ndarray`, int)
+    """
+    num_ranks = comm.Get_size()
+    rank = comm.Get_rank()
+    cluster_idx = np.asarray(cluster_idx, dtype=np.int64)
+    owned_tags = domain.tags[:domain.num_owned]
+    ghost_tags = domain.tags[domain.num_owned:]
+    ghost_clusters = cluster_idx[domain.num_owned:]
+
+    # ask the owner of each ghost for the cluster of its point
+    requests = [ghost_tags[domain.ghost_owners == owner] for owner in range(num_ranks)]
+    asked = comm.alltoall(requests)
+    by_tag = np.argsort(owned_tags)
+    sorted_tags = owned_tags[by_tag]
+    answers = [cluster_idx[:domain.num_owned][by_tag[np.searchsorted(sorted_tags, t)]] for t in asked]
+    answered = comm.alltoall(answers)
+    links = [(ghost_clusters[domain.ghost_owners == owner], np.full(len(answered[owner]), owner), answered[owner])
+             for owner in range(num_ranks)]
+    links = (np.concatenate([l[0] for l in links]), np.concatenate([l[1] for l in links]),
+             np.concatenate([l[2] for l in links]))
+
+    all_links = comm.gather(links, root=root)
+    all_num_clusters = comm.gather(num_clusters, root=root)
+    labels = None
+    if rank == root:
+        first = np.concatenate([[0], np.cumsum(all_num_clusters)]).astype(np.int64)
+        parent = np.arange(first[-1])
+
+        def find(c):
+            while parent[c] != c:
+                parent[c] = parent[parent[c]]
+                c = parent[c]
+            return c
+
+        for r, (mine, owners, theirs) in enumerate(all_links):
+            for a, o, b in zip(first[r] + mine, owners, theirs):
+                ra, rb = find(a), find(first[o] + b)
+                if ra != rb:
+                    parent[max(ra, rb)] = min(ra, rb)
+        # point every cluster at its root
+        while True:
+            grandparent = parent[parent]
+            if np.array_equal(grandparent, parent):
+                break
+            parent = grandparent
+        _, frame_clusters = np.unique(parent, return_inverse=True)
+        total = int(frame_clusters.max()) + 1 if len(frame_clusters) else 0
+        labels = [(frame_clusters[first[r]:first[r + 1]], total) for r in range(num_ranks)]
+    local_labels, total = comm.scatter(labels, root=root)
+    return local_labels[cluster_idx[:domain.num_owned]], total
@@ -3,9 +3,14 @@
 
 from freud.util._VectorMath cimport vec3
 from freud.util._VectorMath cimport quat
+from freud.util._BinCount cimport BinCount
 cimport freud._box as _box
+cimport freud._locality as locality
 cimport freud._pmft as pmft
 from libc.string cimport memcpy
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+from libcpp.memory cimport shared_ptr
 from cython.operator cimport dereference as deref
 import numpy as np
 cimport numpy as np
@@ -62,20 +67,30 @@ cdef class PMFTR12:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations):
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
+        With weights, each pair also adds the product of the weights of its two points to weighted counts, in the
+        same pass over the pairs, which :py:meth:`getWeightedPCF()` normalizes as the PCF. Weighted frames are binned
+        on the CPU and cannot be saved to checkpoints.
+
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -99,7 +114,11 @@ cdef class PMFTR12:
         cdef np.ndarray[float, ndim=1] l_orientations = orientations
         cdef unsigned int nRef = <unsigned int> ref_points.shape[0]
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        ref_weights, weights = pair_weights(ref_weights, weights, nRef, nP)
+        cdef const float *l_ref_weights = weights_data(ref_weights)
+        cdef const float *l_weights = weights_data(weights)
         with nogil:
             self.thisptr.accumulate(l_box,
                                     <vec3[float]*>l_ref_points.data,
@@ -107,9 +126,75 @@ cdef class PMFTR12:
                                     nRef,
                                     <vec3[float]*>l_points.data,
                                     <float*>l_orientations.data,
-                                    nP)
+                                    nP,
+                                    cNlist,
+                                    l_ref_weights,
+                                    l_weights)
+
+    def accumulateFrames(self, boxes, ref_points, ref_orientations, points, orientations):
+        """
+        Calculates the positional correlation function of a stack of frames and adds it to the current histogram, the
+        same as calling :py:meth:`freud.pmft.PMFTR12.accumulate()` for each frame but in a single parallel computation.
+
+        :param boxes: simulation box of each frame, or a single box shared by all the frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: angles of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: angles of the points of each frame
+        :type boxes: list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3:
+            raise TypeError('ref_points should be an FxNx3 array')
+
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if points.shape[2] != 3:
+            raise TypeError('points should be an FxNx3 array')
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+
+        cdef unsigned int n_frames = <unsigned int> points.shape[0]
+        if ref_points.shape[0] != n_frames or ref_orientations.shape[0] != n_frames or orientations.shape[0] != n_frames:
+            raise ValueError("all the arrays must have the same number of frames")
+        if ref_orientations.shape[1] != ref_points.shape[1] or orientations.shape[1] != points.shape[1]:
+            raise ValueError("there must be one orientation per point")
+        if not isinstance(boxes, (list, tuple)):
+            boxes = [boxes]*n_frames
+        if len(boxes) != n_frames:
+            raise ValueError("there must be one box per frame")
+        cdef vector[_box.Box] l_boxes
+        for box in boxes:
+            l_boxes.push_back(cpp_box(box))
+
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_orientations = orientations
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
+        if n_frames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateFrames(&l_boxes[0],
+                                          <vec3[float]*>l_ref_points.data,
+                                          <float*>l_ref_orientations.data,
+                                          nRef,
+                                          <vec3[float]*>l_points.data,
+                                          <float*>l_orientations.data,
+                                          nP,
+                                          n_frames)
+
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -118,41 +203,107 @@ cdef class PMFTR12:
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, nlist=nlist, ref_weights=ref_weights, weights=weights)
+
+    def accumulateAsync(self, *args, **kwargs):
+        """Start :py:meth:`accumulate()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the frame is added to the histogram
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.accumulate, *args, **kwargs)
+
+    def computeAsync(self, *args, **kwargs):
+        """Start :py:meth:`compute()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the histogram is computed
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.compute, *args, **kwargs)
 
     def reducePCF(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
         :py:meth:`freud.pmft.PMFTR12.getPCF()`.
         """
-        self.thisptr.reducePCF()
+        with nogil:
+            self.thisptr.reducePCF()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
 
-    def getBinCounts(self):
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, PMFTR12 other):
+        """Add the accumulated state of another :py:class:`freud.pmft.PMFTR12` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.pmft.PMFTR12`
+        """
+        self.thisptr.merge(deref(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
+
+    def getBinCounts(self, out=None):
         """
         Get the raw bin counts.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.uint32` (:class:`numpy.uint64` when built with ENABLE_BIN_COUNT_64)
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef BinCount* bin_counts = self.thisptr.getBinCounts().get()
         cdef np.npy_intp nbins[3]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
-        cdef np.ndarray[np.uint32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT32, <void*>bin_counts)
-        return result
+        return result_array(self, 3, nbins, np.NPY_UINT64 if sizeof(BinCount) == 8 else np.NPY_UINT32, <void*>bin_counts, out)
 
-    def getPCF(self):
+    def getPCF(self, out=None):
         """
         Get the positional correlation function.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PCF
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.float32`
         """
@@ -161,17 +312,40 @@ cdef class PMFTR12:
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
-        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>pcf)
-        return result
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pcf, out)
 
-    def getPMFT(self):
+    def getPMFT(self, out=None):
         """
         Get the Potential of Mean Force and Torque.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PMFT
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.float32`
         """
-        return -np.log(np.copy(self.getPCF()))
+        cdef float* pmft_array = self.thisptr.getPMFT().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pmft_array, out)
+
+    def getWeightedPCF(self, out=None):
+        """
+        Get the positional correlation function of the weighted counts, normalized as the PCF, so that
+        weights of 1 give it; zero when no frame was weighted.
+
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: weighted PCF
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* pcf = self.thisptr.getWeightedPCF().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pcf, out)
 
     def getR(self):
         """
@@ -183,8 +357,7 @@ cdef class PMFTR12:
         cdef float* r = self.thisptr.getR().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>r)
 
     def getT1(self):
         """
@@ -196,8 +369,7 @@ cdef class PMFTR12:
         cdef float* T1 = self.thisptr.getT1().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsT1()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>T1)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>T1)
 
     def getT2(self):
         """
@@ -209,8 +381,7 @@ cdef class PMFTR12:
         cdef float* T2 = self.thisptr.getT2().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsT2()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>T2)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>T2)
 
     def getInverseJacobian(self):
         """
@@ -224,8 +395,7 @@ cdef class PMFTR12:
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
-        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>inv_jac)
-        return result
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>inv_jac)
 
     def getNBinsR(self):
         """
@@ -267,6 +437,126 @@ cdef class PMFTR12:
         cdef float r_cut = self.thisptr.getRCut()
         return r_cut
 
+    def setPartitionMode(self, mode):
+        """Set how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        'auto' (the default) splits them in ranges of equal numbers of points. 'cost' orders them by cell and splits
+        them in ranges of equal estimated numbers of pairs, which balances inhomogeneous systems. 'affinity' gives
+        each thread the same points again from one frame to the next. 'pair_blocks' splits the pairs of each cell
+        with its neighbor cells in blocks, those of the densest cells in several, for strongly clustered systems,
+        and is 'cost' with a neighbor list. The frames of :py:meth:`accumulateFrames()` are always split as with
+        'auto'.
+
+        :param mode: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :type mode: str
+        """
+        self.thisptr.setPartitionMode(partition_mode(mode))
+
+    def getPartitionMode(self):
+        """Get how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        :return: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :rtype: str
+        """
+        return partition_mode_name(self.thisptr.getPartitionMode())
+
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
+    def setAtomicHistogram(self, atomic):
+        """Set whether the threads count the pairs in one histogram shared by all of them, with atomic increments,
+        rather than in a histogram each (the default). The shared histogram takes the memory of one grid whatever the
+        number of threads and needs no reduction, but is slower when many threads hit the same bins. It takes
+        precedence over the memory limit, and the counts accumulated so far are moved to it by the next frame.
+
+        :param atomic: whether to use the shared histogram
+        :type atomic: bool
+        """
+        self.thisptr.setAtomicHistogram(atomic)
+
+    def getAtomicHistogram(self):
+        """
+        :return: whether the threads count the pairs in one shared histogram
+        :rtype: bool
+        """
+        cdef bint atomic = self.thisptr.getAtomicHistogram()
+        return atomic
+
+    def getSparse(self):
+        """
+        :return: whether the histograms of the threads are sparse, as they are for large grids and over the memory limit
+        :rtype: bool
+        """
+        cdef bint sparse = self.thisptr.getSparse()
+        return sparse
+
+    def setMemoryLimit(self, num_bytes):
+        """Set the most bytes the dense per-thread histograms may take together, 0 for no limit (the default). When a
+        dense copy of the grid per thread would exceed it, the histograms of the threads are sparse instead, and the
+        counts accumulated so far are moved to them by the next frame.
+
+        :param num_bytes: memory limit in bytes
+        :type num_bytes: unsigned long
+        """
+        self.thisptr.setMemoryLimit(num_bytes)
+
+    def getMemoryLimit(self):
+        """
+        :return: most bytes of the dense per-thread histograms, 0 for no limit
+        :rtype: unsigned long
+        """
+        return self.thisptr.getMemoryLimit()
+
+    def getMemoryUsage(self):
+        """Get the bytes allocated by each component: histogram, the arrays shared by the threads,
+        local_histograms, those of the threads, and cell_list, unless it is shared
+
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.getMemoryUsage())
+
+    def estimateMemory(self, N, num_threads=0):
+        """Estimate the bytes of each component after :py:meth:`accumulate()` of N reference points and N points.
+        Sparse histograms are extrapolated from those of the frames so far.
+
+        :param N: number of points
+        :param num_threads: number of threads, 0 for those freud runs on
+        :type N: unsigned int
+        :type num_threads: unsigned int
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.estimateMemory(N, num_threads))
+
 cdef class PMFTXYT:
     """Computes the PMFT [Cit2]_ for a given set of points.
 
@@ -319,20 +609,30 @@ cdef class PMFTXYT:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations):
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
+        With weights, each pair also adds the product of the weights of its two points to weighted counts, in the
+        same pass over the pairs, which :py:meth:`getWeightedPCF()` normalizes as the PCF. Weighted frames are binned
+        on the CPU and cannot be saved to checkpoints.
+
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -356,7 +656,11 @@ cdef class PMFTXYT:
         cdef np.ndarray[float, ndim=1] l_orientations = orientations
         cdef unsigned int nRef = <unsigned int> ref_points.shape[0]
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        ref_weights, weights = pair_weights(ref_weights, weights, nRef, nP)
+        cdef const float *l_ref_weights = weights_data(ref_weights)
+        cdef const float *l_weights = weights_data(weights)
         with nogil:
             self.thisptr.accumulate(l_box,
                                     <vec3[float]*>l_ref_points.data,
@@ -364,9 +668,75 @@ cdef class PMFTXYT:
                                     nRef,
                                     <vec3[float]*>l_points.data,
                                     <float*>l_orientations.data,
-                                    nP)
+                                    nP,
+                                    cNlist,
+                                    l_ref_weights,
+                                    l_weights)
+
+    def accumulateFrames(self, boxes, ref_points, ref_orientations, points, orientations):
+        """
+        Calculates the positional correlation function of a stack of frames and adds it to the current histogram, the
+        same as calling :py:meth:`freud.pmft.PMFTXYT.accumulate()` for each frame but in a single parallel computation.
+
+        :param boxes: simulation box of each frame, or a single box shared by all the frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: angles of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: angles of the points of each frame
+        :type boxes: list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3:
+            raise TypeError('ref_points should be an FxNx3 array')
+
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if points.shape[2] != 3:
+            raise TypeError('points should be an FxNx3 array')
+
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+
+        cdef unsigned int n_frames = <unsigned int> points.shape[0]
+        if ref_points.shape[0] != n_frames or ref_orientations.shape[0] != n_frames or orientations.shape[0] != n_frames:
+            raise ValueError("all the arrays must have the same number of frames")
+        if ref_orientations.shape[1] != ref_points.shape[1] or orientations.shape[1] != points.shape[1]:
+            raise ValueError("there must be one orientation per point")
+        if not isinstance(boxes, (list, tuple)):
+            boxes = [boxes]*n_frames
+        if len(boxes) != n_frames:
+            raise ValueError("there must be one box per frame")
+        cdef vector[_box.Box] l_boxes
+        for box in boxes:
+            l_boxes.push_back(cpp_box(box))
+
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_orientations = orientations
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
+        if n_frames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateFrames(&l_boxes[0],
+                                          <vec3[float]*>l_ref_points.data,
+                                          <float*>l_ref_orientations.data,
+                                          nRef,
+                                          <vec3[float]*>l_points.data,
+                                          <float*>l_orientations.data,
+                                          nP,
+                                          n_frames)
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -375,41 +745,107 @@ cdef class PMFTXYT:
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, nlist=nlist, ref_weights=ref_weights, weights=weights)
+
+    def accumulateAsync(self, *args, **kwargs):
+        """Start :py:meth:`accumulate()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the frame is added to the histogram
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.accumulate, *args, **kwargs)
+
+    def computeAsync(self, *args, **kwargs):
+        """Start :py:meth:`compute()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the histogram is computed
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.compute, *args, **kwargs)
 
     def reducePCF(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
         :py:meth:`freud.pmft.PMFTXYT.getPCF()`.
         """
-        self.thisptr.reducePCF()
+        with nogil:
+            self.thisptr.reducePCF()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
 
-    def getBinCounts(self):
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, PMFTXYT other):
+        """Add the accumulated state of another :py:class:`freud.pmft.PMFTXYT` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.pmft.PMFTXYT`
+        """
+        self.thisptr.merge(deref(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
+
+    def getBinCounts(self, out=None):
         """
         Get the raw bin counts.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32` (:class:`numpy.uint64` when built with ENABLE_BIN_COUNT_64)
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef BinCount* bin_counts = self.thisptr.getBinCounts().get()
         cdef np.npy_intp nbins[3]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.uint32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT32, <void*>bin_counts)
-        return result
+        return result_array(self, 3, nbins, np.NPY_UINT64 if sizeof(BinCount) == 8 else np.NPY_UINT32, <void*>bin_counts, out)
 
-    def getPCF(self):
+    def getPCF(self, out=None):
         """
         Get the positional correlation function.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PCF
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
         """
@@ -418,17 +854,40 @@ cdef class PMFTXYT:
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>pcf)
-        return result
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pcf, out)
 
-    def getPMFT(self):
+    def getPMFT(self, out=None):
         """
         Get the Potential of Mean Force and Torque.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PMFT
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
         """
-        return -np.log(np.copy(self.getPCF()))
+        cdef float* pmft_array = self.thisptr.getPMFT().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pmft_array, out)
+
+    def getWeightedPCF(self, out=None):
+        """
+        Get the positional correlation function of the weighted counts, normalized as the PCF, so that
+        weights of 1 give it; zero when no frame was weighted.
+
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: weighted PCF
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* pcf = self.thisptr.getWeightedPCF().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pcf, out)
 
     def getX(self):
         """
@@ -440,8 +899,7 @@ cdef class PMFTXYT:
         cdef float* x = self.thisptr.getX().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>x)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>x)
 
     def getY(self):
         """
@@ -453,8 +911,7 @@ cdef class PMFTXYT:
         cdef float* y = self.thisptr.getY().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>y)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>y)
 
     def getT(self):
         """
@@ -466,8 +923,7 @@ cdef class PMFTXYT:
         cdef float* t = self.thisptr.getT().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>t)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>t)
 
     def getJacobian(self):
         """
@@ -519,6 +975,126 @@ cdef class PMFTXYT:
         cdef float r_cut = self.thisptr.getRCut()
         return r_cut
 
+    def setPartitionMode(self, mode):
+        """Set how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        'auto' (the default) splits them in ranges of equal numbers of points. 'cost' orders them by cell and splits
+        them in ranges of equal estimated numbers of pairs, which balances inhomogeneous systems. 'affinity' gives
+        each thread the same points again from one frame to the next. 'pair_blocks' splits the pairs of each cell
+        with its neighbor cells in blocks, those of the densest cells in several, for strongly clustered systems,
+        and is 'cost' with a neighbor list. The frames of :py:meth:`accumulateFrames()` are always split as with
+        'auto'.
+
+        :param mode: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :type mode: str
+        """
+        self.thisptr.setPartitionMode(partition_mode(mode))
+
+    def getPartitionMode(self):
+        """Get how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        :return: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :rtype: str
+        """
+        return partition_mode_name(self.thisptr.getPartitionMode())
+
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
+    def setAtomicHistogram(self, atomic):
+        """Set whether the threads count the pairs in one histogram shared by all of them, with atomic increments,
+        rather than in a histogram each (the default). The shared histogram takes the memory of one grid whatever the
+        number of threads and needs no reduction, but is slower when many threads hit the same bins. It takes
+        precedence over the memory limit, and the counts accumulated so far are moved to it by the next frame.
+
+        :param atomic: whether to use the shared histogram
+        :type atomic: bool
+        """
+        self.thisptr.setAtomicHistogram(atomic)
+
+    def getAtomicHistogram(self):
+        """
+        :return: whether the threads count the pairs in one shared histogram
+        :rtype: bool
+        """
+        cdef bint atomic = self.thisptr.getAtomicHistogram()
+        return atomic
+
+    def getSparse(self):
+        """
+        :return: whether the histograms of the threads are sparse, as they are for large grids and over the memory limit
+        :rtype: bool
+        """
+        cdef bint sparse = self.thisptr.getSparse()
+        return sparse
+
+    def setMemoryLimit(self, num_bytes):
+        """Set the most bytes the dense per-thread histograms may take together, 0 for no limit (the default). When a
+        dense copy of the grid per thread would exceed it, the histograms of the threads are sparse instead, and the
+        counts accumulated so far are moved to them by the next frame.
+
+        :param num_bytes: memory limit in bytes
+        :type num_bytes: unsigned long
+        """
+        self.thisptr.setMemoryLimit(num_bytes)
+
+    def getMemoryLimit(self):
+        """
+        :return: most bytes of the dense per-thread histograms, 0 for no limit
+        :rtype: unsigned long
+        """
+        return self.thisptr.getMemoryLimit()
+
+    def getMemoryUsage(self):
+        """Get the bytes allocated by each component: histogram, the arrays shared by the threads,
+        local_histograms, those of the threads, and cell_list, unless it is shared
+
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.getMemoryUsage())
+
+    def estimateMemory(self, N, num_threads=0):
+        """Estimate the bytes of each component after :py:meth:`accumulate()` of N reference points and N points.
+        Sparse histograms are extrapolated from those of the frames so far.
+
+        :param N: number of points
+        :param num_threads: number of threads, 0 for those freud runs on
+        :type N: unsigned int
+        :type num_threads: unsigned int
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.estimateMemory(N, num_threads))
+
 cdef class PMFTXY2D:
     """Computes the PMFT [Cit2]_ for a given set of points.
 
@@ -566,20 +1142,30 @@ cdef class PMFTXY2D:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations):
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
+        With weights, each pair also adds the product of the weights of its two points to weighted counts, in the
+        same pass over the pairs, which :py:meth:`getWeightedPCF()` normalizes as the PCF. Weighted frames are binned
+        on the CPU and cannot be saved to checkpoints.
+
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param ref_orientations: orientations of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: orientations of particles to use in calculation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -603,7 +1189,11 @@ cdef class PMFTXY2D:
         cdef np.ndarray[float, ndim=1] l_orientations = orientations
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        ref_weights, weights = pair_weights(ref_weights, weights, nRef, nP)
+        cdef const float *l_ref_weights = weights_data(ref_weights)
+        cdef const float *l_weights = weights_data(weights)
         with nogil:
             self.thisptr.accumulate(l_box,
                                     <vec3[float]*>l_ref_points.data,
@@ -611,9 +1201,75 @@ cdef class PMFTXY2D:
                                     n_ref,
                                     <vec3[float]*>l_points.data,
                                     <float*>l_orientations.data,
-                                    n_p)
+                                    n_p,
+                                    cNlist,
+                                    l_ref_weights,
+                                    l_weights)
+
+    def accumulateFrames(self, boxes, ref_points, ref_orientations, points, orientations):
+        """
+        Calculates the positional correlation function of a stack of frames and adds it to the current histogram, the
+        same as calling :py:meth:`freud.pmft.PMFTXY2D.accumulate()` for each frame but in a single parallel computation.
+
+        :param boxes: simulation box of each frame, or a single box shared by all the frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: angles of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: angles of the points of each frame
+        :type boxes: list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3:
+            raise TypeError('ref_points should be an FxNx3 array')
+
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if points.shape[2] != 3:
+            raise TypeError('points should be an FxNx3 array')
+
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+
+        cdef unsigned int n_frames = <unsigned int> points.shape[0]
+        if ref_points.shape[0] != n_frames or ref_orientations.shape[0] != n_frames or orientations.shape[0] != n_frames:
+            raise ValueError("all the arrays must have the same number of frames")
+        if ref_orientations.shape[1] != ref_points.shape[1] or orientations.shape[1] != points.shape[1]:
+            raise ValueError("there must be one orientation per point")
+        if not isinstance(boxes, (list, tuple)):
+            boxes = [boxes]*n_frames
+        if len(boxes) != n_frames:
+            raise ValueError("there must be one box per frame")
+        cdef vector[_box.Box] l_boxes
+        for box in boxes:
+            l_boxes.push_back(cpp_box(box))
+
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_orientations = orientations
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
+        if n_frames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateFrames(&l_boxes[0],
+                                          <vec3[float]*>l_ref_points.data,
+                                          <float*>l_ref_orientations.data,
+                                          nRef,
+                                          <vec3[float]*>l_points.data,
+                                          <float*>l_orientations.data,
+                                          nP,
+                                          n_frames)
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -622,26 +1278,91 @@ cdef class PMFTXY2D:
         :param ref_orientations: orientations of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: orientations of particles to use in calculation
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, nlist=nlist, ref_weights=ref_weights, weights=weights)
+
+    def accumulateAsync(self, *args, **kwargs):
+        """Start :py:meth:`accumulate()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the frame is added to the histogram
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.accumulate, *args, **kwargs)
+
+    def computeAsync(self, *args, **kwargs):
+        """Start :py:meth:`compute()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the histogram is computed
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.compute, *args, **kwargs)
 
     def reducePCF(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
         :py:meth:`freud.pmft.PMFTXY2D.getPCF()`.
         """
-        self.thisptr.reducePCF()
+        with nogil:
+            self.thisptr.reducePCF()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
+
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
 
-    def getPCF(self):
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, PMFTXY2D other):
+        """Add the accumulated state of another :py:class:`freud.pmft.PMFTXY2D` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.pmft.PMFTXY2D`
+        """
+        self.thisptr.merge(deref(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
+
+    def getPCF(self, out=None):
         """
         Get the positional correlation function.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PCF
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{y}\\right)`, dtype= :class:`numpy.float32`
         """
@@ -649,31 +1370,53 @@ cdef class PMFTXY2D:
         cdef np.npy_intp nbins[2]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>pcf)
-        return result
+        return result_array(self, 2, nbins, np.NPY_FLOAT32, <void*>pcf, out)
 
-    def getPMFT(self):
+    def getPMFT(self, out=None):
         """
         Get the Potential of Mean Force and Torque.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PMFT
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
         """
-        return -np.log(np.copy(self.getPCF()))
+        cdef float* pmft_array = self.thisptr.getPMFT().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
+        return result_array(self, 2, nbins, np.NPY_FLOAT32, <void*>pmft_array, out)
 
-    def getBinCounts(self):
+    def getWeightedPCF(self, out=None):
+        """
+        Get the positional correlation function of the weighted counts, normalized as the PCF, so that
+        weights of 1 give it; zero when no frame was weighted.
+
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: weighted PCF
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{y}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* pcf = self.thisptr.getWeightedPCF().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
+        return result_array(self, 2, nbins, np.NPY_FLOAT32, <void*>pcf, out)
+
+    def getBinCounts(self, out=None):
         """
         Get the raw bin counts (non-normalized).
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32` (:class:`numpy.uint64` when built with ENABLE_BIN_COUNT_64)
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef BinCount* bin_counts = self.thisptr.getBinCounts().get()
         cdef np.npy_intp nbins[2]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32, <void*>bin_counts)
-        return result
+        return result_array(self, 2, nbins, np.NPY_UINT64 if sizeof(BinCount) == 8 else np.NPY_UINT32, <void*>bin_counts, out)
 
     def getX(self):
         """
@@ -685,8 +1428,7 @@ cdef class PMFTXY2D:
         cdef float* x = self.thisptr.getX().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>x)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>x)
 
     def getY(self):
         """
@@ -699,8 +1441,7 @@ cdef class PMFTXY2D:
         cdef float* y = self.thisptr.getY().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
-        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>y)
-        return result
+        return result_array(self, 1, nbins, np.NPY_FLOAT32, <void*>y)
 
     def getNBinsX(self):
         """
@@ -742,6 +1483,146 @@ cdef class PMFTXY2D:
         cdef float r_cut = self.thisptr.getRCut()
         return r_cut
 
+    def setPartitionMode(self, mode):
+        """Set how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        'auto' (the default) splits them in ranges of equal numbers of points. 'cost' orders them by cell and splits
+        them in ranges of equal estimated numbers of pairs, which balances inhomogeneous systems. 'affinity' gives
+        each thread the same points again from one frame to the next. 'pair_blocks' splits the pairs of each cell
+        with its neighbor cells in blocks, those of the densest cells in several, for strongly clustered systems,
+        and is 'cost' with a neighbor list. The frames of :py:meth:`accumulateFrames()` are always split as with
+        'auto'.
+
+        :param mode: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :type mode: str
+        """
+        self.thisptr.setPartitionMode(partition_mode(mode))
+
+    def getPartitionMode(self):
+        """Get how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        :return: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :rtype: str
+        """
+        return partition_mode_name(self.thisptr.getPartitionMode())
+
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
+    def setAtomicHistogram(self, atomic):
+        """Set whether the threads count the pairs in one histogram shared by all of them, with atomic increments,
+        rather than in a histogram each (the default). The shared histogram takes the memory of one grid whatever the
+        number of threads and needs no reduction, but is slower when many threads hit the same bins. It takes
+        precedence over the memory limit, and the counts accumulated so far are moved to it by the next frame.
+
+        :param atomic: whether to use the shared histogram
+        :type atomic: bool
+        """
+        self.thisptr.setAtomicHistogram(atomic)
+
+    def getAtomicHistogram(self):
+        """
+        :return: whether the threads count the pairs in one shared histogram
+        :rtype: bool
+        """
+        cdef bint atomic = self.thisptr.getAtomicHistogram()
+        return atomic
+
+    def getSparse(self):
+        """
+        :return: whether the histograms of the threads are sparse, as they are for large grids and over the memory limit
+        :rtype: bool
+        """
+        cdef bint sparse = self.thisptr.getSparse()
+        return sparse
+
+    def setMemoryLimit(self, num_bytes):
+        """Set the most bytes the dense per-thread histograms may take together, 0 for no limit (the default). When a
+        dense copy of the grid per thread would exceed it, the histograms of the threads are sparse instead, and the
+        counts accumulated so far are moved to them by the next frame.
+
+        :param num_bytes: memory limit in bytes
+        :type num_bytes: unsigned long
+        """
+        self.thisptr.setMemoryLimit(num_bytes)
+
+    def getMemoryLimit(self):
+        """
+        :return: most bytes of the dense per-thread histograms, 0 for no limit
+        :rtype: unsigned long
+        """
+        return self.thisptr.getMemoryLimit()
+
+    def getMemoryUsage(self):
+        """Get the bytes allocated by each component: histogram, the arrays shared by the threads,
+        local_histograms, those of the threads, and cell_list, unless it is shared
+
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.getMemoryUsage())
+
+    def estimateMemory(self, N, num_threads=0):
+        """Estimate the bytes of each component after :py:meth:`accumulate()` of N reference points and N points.
+        Sparse histograms are extrapolated from those of the frames so far.
+
+        :param N: number of points
+        :param num_threads: number of threads, 0 for those freud runs on
+        :type N: unsigned int
+        :type num_threads: unsigned int
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.estimateMemory(N, num_threads))
+
+    def setUseGPU(self, use_gpu):
+        """Set whether :py:meth:`accumulate()` bins the pairs on a CUDA GPU when no neighbor list is given. The
+        histogram of each frame is added to the accumulated one as on the CPU, so the counts are the same but for
+        pairs within rounding of a bin edge. Raises RuntimeError when freud was built without CUDA, see the
+        ENABLE_CUDA option of CMake, or no device is found.
+
+        :param use_gpu: whether to bin on the GPU
+        :type use_gpu: bool
+        """
+        self.thisptr.setUseGPU(use_gpu)
+
+    def getUseGPU(self):
+        """Get whether :py:meth:`accumulate()` bins the pairs on the GPU
+
+        :return: use_gpu
+        :rtype: bool
+        """
+        cdef bint use_gpu = self.thisptr.getUseGPU()
+        return use_gpu
+
 cdef class PMFTXYZ:
     """Computes the PMFT [Cit2]_ for a given set of points.
 
@@ -764,6 +1645,7 @@ cdef class PMFTXYZ:
     :param n_y: number of bins in y
     :param n_z: number of bins in z
     :param shiftvec: vector pointing from [0,0,0] to the center of the pmft
+    :param fold: bin each bond only once, in the asymmetric unit of the face orientations (optional)
     :type x_max: float
     :type y_max: float
     :type z_max: float
@@ -771,13 +1653,20 @@ cdef class PMFTXYZ:
     :type n_y: unsigned int
     :type n_z: unsigned int
     :type shiftvec: list
+    :type fold: bool
+
+    When the face orientations are the symmetry operations of the particles, every bond is binned once per operation
+    and the PMFT is symmetric. With fold=True, only the image of each bond with the largest :math:`2x + y` is binned,
+    which is the asymmetric unit :math:`x \\geq y \\geq \\left| z \\right|` for the 24 rotations of a cube. This
+    costs one histogram update per bond instead of one per face; the PMFT within the asymmetric unit is unchanged, up
+    to the bins crossing its boundary, and the bins outside of it are left empty.
     """
     cdef pmft.PMFTXYZ *thisptr
     cdef shiftvec
 
-    def __cinit__(self, x_max, y_max, z_max, n_x, n_y, n_z, shiftvec=[0,0,0]):
+    def __cinit__(self, x_max, y_max, z_max, n_x, n_y, n_z, shiftvec=[0,0,0], fold=False):
         cdef vec3[float] c_shiftvec = vec3[float](shiftvec[0],shiftvec[1],shiftvec[2])
-        self.thisptr = new pmft.PMFTXYZ(x_max, y_max, z_max, n_x, n_y, n_z, c_shiftvec)
+        self.thisptr = new pmft.PMFTXYZ(x_max, y_max, z_max, n_x, n_y, n_z, c_shiftvec, fold)
         self.shiftvec = np.array(shiftvec, dtype=np.float32)
 
     def __dealloc__(self):
@@ -798,26 +1687,36 @@ cdef class PMFTXYZ:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations, face_orientations=None):
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, face_orientations=None, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
+        With weights, each pair also adds the product of the weights of its two points to weighted counts, in the
+        same pass over the pairs, which :py:meth:`getWeightedPCF()` normalizes as the PCF. Weighted frames are binned
+        on the CPU and cannot be saved to checkpoints.
+
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param ref_orientations: orientations of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: orientations of particles to use in calculation
         :param face_orientations: Optional - orientations of particle faces to account for particle symmetry.
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
             * If not supplied by user, unit quaternions will be supplied.
             * If a 2D array of shape (:math:`N_f`, :math:`4`) or a 3D array of shape (1, :math:`N_f`, :math:`4`) \
-                is supplied, the supplied quaternions will be broadcast for all particles
+                is supplied, the supplied quaternions are shared by all particles, without being copied for each of them
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
         :type face_orientations: :class:`numpy.ndarray`, shape= :math:`\\left( \\left(N_{particles}, \\right), N_{faces}, 4\\right)`, \
+        :type nlist: :py:class:`freud.locality.NeighborList`
             dtype= :class:`numpy.float32`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -840,11 +1739,12 @@ cdef class PMFTXYZ:
         if orientations.shape[1] != 4:
             raise ValueError("the 2nd dimension must have 4 values: q0, q1, q2, q3")
 
-        # handle multiple ways to input
+        # handle multiple ways to input; faces shared by all the reference points are passed once
+        cdef bint shared_faces = True
         if face_orientations is None:
             # set to unit quaternion q = [1,0,0,0]
-            face_orientations = np.zeros(shape=(ref_points.shape[0], 1, 4), dtype=np.float32)
-            face_orientations[:,:,0] = 1.0
+            face_orientations = np.zeros(shape=(1, 4), dtype=np.float32)
+            face_orientations[:,0] = 1.0
         else:
             if (len(face_orientations.shape) < 2) or (len(face_orientations.shape) > 3):
                 raise ValueError("points must be a 2 or 3 dimensional array")
@@ -853,40 +1753,156 @@ cdef class PMFTXYZ:
             if face_orientations.ndim == 2:
                 if face_orientations.shape[1] != 4:
                     raise ValueError("2nd dimension for orientations must have 4 values: s, x, y, z")
-                # need to broadcast into new array
-                tmp_face_orientations = np.zeros(shape=(ref_points.shape[0], face_orientations.shape[0], face_orientations.shape[1]), dtype=np.float32)
-                tmp_face_orientations[:] = face_orientations
-                face_orientations = tmp_face_orientations
             else:
-				# Make sure that the first dimensions is actually the number of particles
+                # Make sure that the first dimensions is actually the number of particles
                 if face_orientations.shape[2] != 4:
                     raise ValueError("2nd dimension for orientations must have 4 values: s, x, y, z")
                 elif face_orientations.shape[0] not in (1, ref_points.shape[0]):
                     raise ValueError("If provided as a 3D array, the first dimension of the face_orientations array must be either of size 1 or N_particles")
                 elif face_orientations.shape[0] == 1:
-                    face_orientations = np.repeat(face_orientations, ref_points.shape[0], axis = 0)
+                    face_orientations = face_orientations[0]
+                else:
+                    shared_faces = False
 
+        cdef unsigned int nFaces = <unsigned int> face_orientations.shape[-2]
+        face_orientations = face_orientations.reshape(-1, 4)
         cdef np.ndarray[float, ndim=2] l_ref_points = ref_points
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
         cdef np.ndarray[float, ndim=2] l_orientations = orientations
-        cdef np.ndarray[float, ndim=3] l_face_orientations = face_orientations
+        cdef np.ndarray[float, ndim=2] l_face_orientations = face_orientations
         cdef unsigned int nRef = <unsigned int> ref_points.shape[0]
         cdef unsigned int nP = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = cpp_box(box)
+        cdef locality.NeighborList *cNlist = nlist_ptr(nlist)
+        ref_weights, weights = pair_weights(ref_weights, weights, nRef, nP)
+        cdef const float *l_ref_weights = weights_data(ref_weights)
+        cdef const float *l_weights = weights_data(weights)
+        with nogil:
+            if shared_faces:
+                self.thisptr.accumulateSharedFaces(l_box,
+                                                   <vec3[float]*>l_ref_points.data,
+                                                   <quat[float]*>l_ref_orientations.data,
+                                                   nRef,
+                                                   <vec3[float]*>l_points.data,
+                                                   <quat[float]*>l_orientations.data,
+                                                   nP,
+                                                   <quat[float]*>l_face_orientations.data,
+                                                   nFaces,
+                                                   cNlist,
+                                                   l_ref_weights,
+                                                   l_weights)
+            else:
+                self.thisptr.accumulate(l_box,
+                                        <vec3[float]*>l_ref_points.data,
+                                        <quat[float]*>l_ref_orientations.data,
+                                        nRef,
+                                        <vec3[float]*>l_points.data,
+                                        <quat[float]*>l_orientations.data,
+                                        nP,
+                                        <quat[float]*>l_face_orientations.data,
+                                        nFaces,
+                                        cNlist,
+                                        l_ref_weights,
+                                        l_weights)
+
+    def accumulateFrames(self, boxes, ref_points, ref_orientations, points, orientations, face_orientations=None):
+        """
+        Calculates the positional correlation function of a stack of frames and adds it to the current histogram, the
+        same as calling :py:meth:`freud.pmft.PMFTXYZ.accumulate()` for each frame but in a single parallel computation.
+
+        :param boxes: simulation box of each frame, or a single box shared by all the frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: orientations of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: orientations of the points of each frame
+        :param face_orientations: Optional - orientations of particle faces, shared by all the frames, as in \
+            :py:meth:`freud.pmft.PMFTXYZ.accumulate()`
+        :type boxes: list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
+        :type face_orientations: :class:`numpy.ndarray`, shape= :math:`\\left( \\left(N_{particles}, \\right), N_{faces}, 4\\right)`, \
+            dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3:
+            raise TypeError('ref_points should be an FxNx3 array')
+
+        ref_orientations = freud.common.convert_array(ref_orientations, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 3 dimensional array")
+        if ref_orientations.shape[2] != 4:
+            raise ValueError("the 3rd dimension must have 4 values: q0, q1, q2, q3")
+
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if points.shape[2] != 3:
+            raise TypeError('points should be an FxNx3 array')
+        points = points - self.shiftvec.reshape(1,1,3)
+
+        orientations = freud.common.convert_array(orientations, 3, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 3 dimensional array")
+        if orientations.shape[2] != 4:
+            raise ValueError("the 3rd dimension must have 4 values: q0, q1, q2, q3")
+
+        cdef unsigned int n_frames = <unsigned int> points.shape[0]
+        if ref_points.shape[0] != n_frames or ref_orientations.shape[0] != n_frames or orientations.shape[0] != n_frames:
+            raise ValueError("all the arrays must have the same number of frames")
+        if ref_orientations.shape[1] != ref_points.shape[1] or orientations.shape[1] != points.shape[1]:
+            raise ValueError("there must be one orientation per point")
+
+        # the same inputs as accumulate, for the reference particles of one frame
+        if face_orientations is None:
+            face_orientations = np.zeros(shape=(ref_points.shape[1], 1, 4), dtype=np.float32)
+            face_orientations[:,:,0] = 1.0
+        else:
+            if (len(face_orientations.shape) < 2) or (len(face_orientations.shape) > 3):
+                raise ValueError("face_orientations must be a 2 or 3 dimensional array")
+            face_orientations = freud.common.convert_array(face_orientations, face_orientations.ndim, dtype=np.float32, contiguous=True,
+                dim_message="face_orientations must be a {} dimensional array".format(face_orientations.ndim))
+            if face_orientations.shape[-1] != 4:
+                raise ValueError("the last dimension of face_orientations must have 4 values: s, x, y, z")
+            if face_orientations.ndim == 2:
+                face_orientations = np.ascontiguousarray(np.broadcast_to(face_orientations,
+                    (ref_points.shape[1], face_orientations.shape[0], 4)))
+            elif face_orientations.shape[0] not in (1, ref_points.shape[1]):
+                raise ValueError("If provided as a 3D array, the first dimension of the face_orientations array must be either of size 1 or N_particles")
+            elif face_orientations.shape[0] == 1:
+                face_orientations = np.repeat(face_orientations, ref_points.shape[1], axis = 0)
+
+        if not isinstance(boxes, (list, tuple)):
+            boxes = [boxes]*n_frames
+        if len(boxes) != n_frames:
+            raise ValueError("there must be one box per frame")
+        cdef vector[_box.Box] l_boxes
+        for box in boxes:
+            l_boxes.push_back(cpp_box(box))
+
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=3] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=3] l_orientations = orientations
+        cdef np.ndarray[float, ndim=3] l_face_orientations = face_orientations
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
         cdef unsigned int nFaces = <unsigned int> face_orientations.shape[1]
-        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        if n_frames == 0:
+            return
         with nogil:
-            self.thisptr.accumulate(l_box,
-                                    <vec3[float]*>l_ref_points.data,
-                                    <quat[float]*>l_ref_orientations.data,
-                                    nRef,
-                                    <vec3[float]*>l_points.data,
-                                    <quat[float]*>l_orientations.data,
-                                    nP,
-                                    <quat[float]*>l_face_orientations.data,
-                                    nFaces)
-
-    def compute(self, box, ref_points, ref_orientations, points, orientations, face_orientations):
+            self.thisptr.accumulateFrames(&l_boxes[0],
+                                          <vec3[float]*>l_ref_points.data,
+                                          <quat[float]*>l_ref_orientations.data,
+                                          nRef,
+                                          <vec3[float]*>l_points.data,
+                                          <quat[float]*>l_orientations.data,
+                                          nP,
+                                          <quat[float]*>l_face_orientations.data,
+                                          nFaces,
+                                          n_frames)
+
+    def compute(self, box, ref_points, ref_orientations, points, orientations, face_orientations, nlist=None, ref_weights=None, weights=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -896,43 +1912,109 @@ cdef class PMFTXYZ:
         :param points: points to calculate the local density
         :param orientations: orientations of particles to use in calculation
         :param face_orientations: orientations of particle faces to account for particle symmetry
+        :param nlist: precomputed neighbor list to use instead of building a cell list (optional)
+        :param ref_weights: weight of each reference point, given with weights (optional)
+        :param weights: weight of each point, given with ref_weights (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
         :type face_orientations: :class:`numpy.ndarray`, shape= :math:`\\left( \\left(N_{particles}, \\right), N_{faces}, 4\\right)`, \
+        :type nlist: :py:class:`freud.locality.NeighborList`
             dtype= :class:`numpy.float32`
+        :type ref_weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations, face_orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, face_orientations, nlist=nlist, ref_weights=ref_weights, weights=weights)
+
+    def accumulateAsync(self, *args, **kwargs):
+        """Start :py:meth:`accumulate()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the frame is added to the histogram
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.accumulate, *args, **kwargs)
+
+    def computeAsync(self, *args, **kwargs):
+        """Start :py:meth:`compute()` on the compute thread, returning at once; see :py:func:`freud.parallel.submit()`
+
+        :return: future that is done once the histogram is computed
+        :rtype: :py:class:`concurrent.futures.Future`
+        """
+        return submit(self.compute, *args, **kwargs)
 
     def reducePCF(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by \
         :py:meth:`freud.pmft.PMFTXYZ.getPCF()`.
         """
-        self.thisptr.reducePCF()
+        with nogil:
+            self.thisptr.reducePCF()
+
+    def saveState(self, filename):
+        """Save the accumulated state to a checkpoint file, from which :py:meth:`loadState()` restores it, to resume
+        a long accumulation or to merge those of the chunks of a trajectory
 
-    def getBinCounts(self):
+        :param filename: checkpoint file
+        :type filename: str
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        with nogil:
+            self.thisptr.saveState(l_filename)
+
+    def loadState(self, filename, merge=False):
+        """Restore the state of a checkpoint file written by :py:meth:`saveState()` with the same parameters, or
+        add it to the accumulated state. When merging, the box and the numbers of points that normalize the result
+        stay those of this object, unless it has accumulated nothing yet.
+
+        :param filename: checkpoint file
+        :param merge: whether to add the state to the accumulated one instead of replacing it
+        :type filename: str
+        :type merge: bool
+        """
+        cdef string l_filename = filename.encode('utf-8')
+        cdef bint l_merge = merge
+        with nogil:
+            self.thisptr.loadState(l_filename, l_merge)
+
+    def merge(self, PMFTXYZ other):
+        """Add the accumulated state of another :py:class:`freud.pmft.PMFTXYZ` of the same parameters, such as
+        that of another chunk of a trajectory; ``a += b`` is the same as ``a.merge(b)``. What normalizes the result
+        stays that of this object, unless it has accumulated nothing yet.
+
+        :param other: object to add the state of
+        :type other: :py:class:`freud.pmft.PMFTXYZ`
+        """
+        self.thisptr.merge(deref(other.thisptr))
+
+    def __iadd__(self, other):
+        self.merge(other)
+        return self
+
+    def getBinCounts(self, out=None):
         """
         Get the raw bin counts.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32` (:class:`numpy.uint64` when built with ENABLE_BIN_COUNT_64)
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef BinCount* bin_counts = self.thisptr.getBinCounts().get()
         cdef np.npy_intp nbins[3]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.uint32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT32, <void*>bin_counts)
-        return result
+        return result_array(self, 3, nbins, np.NPY_UINT64 if sizeof(BinCount) == 8 else np.NPY_UINT32, <void*>bin_counts, out)
 
-    def getPCF(self):
+    def getPCF(self, out=None):
         """
         Get the positional correlation function.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PCF
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
         """
@@ -941,17 +2023,40 @@ cdef class PMFTXYZ:
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>pcf)
-        return result
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pcf, out)
 
-    def getPMFT(self):
+    def getPMFT(self, out=None):
         """
         Get the Potential of Mean Force and Torque.
 
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
         :return: PMFT
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
         """
-        return -np.log(np.copy(self.getPCF()))
+        cdef float* pmft_array = self.thisptr.getPMFT().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pmft_array, out)
+
+    def getWeightedPCF(self, out=None):
+        """
+        Get the positional correlation function of the weighted counts, normalized as the PCF, so that
+        weights of 1 give it; zero when no frame was weighted.
+
+        :param out: array to copy the result into, reused instead of a view of the internal array (optional)
+        :type out: :class:`numpy.ndarray`
+        :return: weighted PCF
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* pcf = self.thisptr.getWeightedPCF().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        return result_array(self, 3, nbins, np.NPY_FLOAT32, <void*>pcf, out)
 
     def getX(self):
         """
@@ -1031,3 +2136,153 @@ cdef class PMFTXYZ:
         """
         cdef float j = self.thisptr.getJacobian()
         return j
+
+    def getFold(self):
+        """
+        Get whether each bond is only binned in the asymmetric unit of the face orientations
+
+        :return: fold
+        :rtype: bool
+        """
+        cdef bint fold = self.thisptr.getFold()
+        return fold
+
+    def setPartitionMode(self, mode):
+        """Set how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        'auto' (the default) splits them in ranges of equal numbers of points. 'cost' orders them by cell and splits
+        them in ranges of equal estimated numbers of pairs, which balances inhomogeneous systems. 'affinity' gives
+        each thread the same points again from one frame to the next. 'pair_blocks' splits the pairs of each cell
+        with its neighbor cells in blocks, those of the densest cells in several, for strongly clustered systems,
+        and is 'cost' with a neighbor list. The frames of :py:meth:`accumulateFrames()` are always split as with
+        'auto'.
+
+        :param mode: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :type mode: str
+        """
+        self.thisptr.setPartitionMode(partition_mode(mode))
+
+    def getPartitionMode(self):
+        """Get how the reference points of :py:meth:`accumulate()` are split between the threads
+
+        :return: 'auto', 'cost', 'affinity' or 'pair_blocks'
+        :rtype: str
+        """
+        return partition_mode_name(self.thisptr.getPartitionMode())
+
+    def setLinkCell(self, LinkCell lc):
+        """Share the cell list of a :py:class:`freud.locality.LinkCell` with other analyses of the same points, which
+        then only compute it once per frame; None gives the analysis a cell list of its own again
+
+        :param lc: cell list whose cell width is at least the cutoff of the analysis, or None
+        :type lc: :py:class:`freud.locality.LinkCell`
+        """
+        if lc is None:
+            self.thisptr.setLinkCell(shared_ptr[locality.LinkCell]())
+        else:
+            self.thisptr.setLinkCell(lc.shared)
+
+    def setCellOrder(self, cell_order):
+        """Set whether the reference points are visited in the order of their cells of the cell list, which keeps the
+        neighbor cells of the points of one thread in cache when the points are scrambled, as after the domain
+        decomposition of an MD engine. It is done for at least 4096 reference points, and on by default.
+
+        :param cell_order: whether to visit the reference points in cell order
+        :type cell_order: bool
+        """
+        self.thisptr.setCellOrder(cell_order)
+
+    def getCellOrder(self):
+        """Get whether the reference points are visited in the order of their cells
+
+        :return: cell_order
+        :rtype: bool
+        """
+        cdef bint cell_order = self.thisptr.getCellOrder()
+        return cell_order
+
+    def setAtomicHistogram(self, atomic):
+        """Set whether the threads count the pairs in one histogram shared by all of them, with atomic increments,
+        rather than in a histogram each (the default). The shared histogram takes the memory of one grid whatever the
+        number of threads and needs no reduction, but is slower when many threads hit the same bins. It takes
+        precedence over the memory limit, and the counts accumulated so far are moved to it by the next frame.
+
+        :param atomic: whether to use the shared histogram
+        :type atomic: bool
+        """
+        self.thisptr.setAtomicHistogram(atomic)
+
+    def getAtomicHistogram(self):
+        """
+        :return: whether the threads count the pairs in one shared histogram
+        :rtype: bool
+        """
+        cdef bint atomic = self.thisptr.getAtomicHistogram()
+        return atomic
+
+    def getSparse(self):
+        """
+        :return: whether the histograms of the threads are sparse, as they are for large grids and over the memory limit
+        :rtype: bool
+        """
+        cdef bint sparse = self.thisptr.getSparse()
+        return sparse
+
+    def setMemoryLimit(self, num_bytes):
+        """Set the most bytes the dense per-thread histograms may take together, 0 for no limit (the default). When a
+        dense copy of the grid per thread would exceed it, the histograms of the threads are sparse instead, and the
+        counts accumulated so far are moved to them by the next frame.
+
+        :param num_bytes: memory limit in bytes
+        :type num_bytes: unsigned long
+        """
+        self.thisptr.setMemoryLimit(num_bytes)
+
+    def getMemoryLimit(self):
+        """
+        :return: most bytes of the dense per-thread histograms, 0 for no limit
+        :rtype: unsigned long
+        """
+        return self.thisptr.getMemoryLimit()
+
+    def getMemoryUsage(self):
+        """Get the bytes allocated by each component: histogram, the arrays shared by the threads,
+        local_histograms, those of the threads, and cell_list, unless it is shared
+
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.getMemoryUsage())
+
+    def estimateMemory(self, N, num_threads=0):
+        """Estimate the bytes of each component after :py:meth:`accumulate()` of N reference points and N points.
+        Sparse histograms are extrapolated from those of the frames so far.
+
+        :param N: number of points
+        :param num_threads: number of threads, 0 for those freud runs on
+        :type N: unsigned int
+        :type num_threads: unsigned int
+        :return: bytes by component
+        :rtype: dict
+        """
+        return _memoryUsage(self.thisptr.estimateMemory(N, num_threads))
+
+    def setUseGPU(self, use_gpu):
+        """Set whether :py:meth:`accumulate()` bins the pairs on a CUDA GPU when no neighbor list is given. The
+        histogram of each frame is added to the accumulated one as on the CPU, so the counts are the same but for
+        pairs within rounding of a bin edge. Folded PMFTs are always binned on the CPU. Raises RuntimeError when freud was built without CUDA, see the
+        ENABLE_CUDA option of CMake, or no device is found.
+
+        :param use_gpu: whether to bin on the GPU
+        :type use_gpu: bool
+        """
+        self.thisptr.setUseGPU(use_gpu)
+
+    def getUseGPU(self):
+        """Get whether :py:meth:`accumulate()` bins the pairs on the GPU
+
+        :return: use_gpu
+        :rtype: bool
+        """
+        cdef bint use_gpu = self.thisptr.getUseGPU()
+        return use_gpu
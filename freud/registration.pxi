@@ -0,0 +1,88 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from freud.util._VectorMath cimport vec3
+cimport freud._registration as registration
+import numpy as np
+cimport numpy as np
+import freud.common
+
+# Numpy must be initialized. When using numpy from C or Cython you must
+# _always_ do that, or you will have segfaults
+np.import_array()
+
+cdef class BatchKabsch:
+    """Align a batch of sets of points with their reference sets
+
+    Point i of each set goes to point i of its reference set, and the points are not translated, as for the vectors
+    of local environments. The rotation :math:`R` of each set minimizes :math:`\\sum_i |R p_i - q_i|^2`; it is found
+    in closed form from the unit quaternion of the rotation, in parallel over the sets.
+    """
+    cdef registration.BatchKabsch *thisptr
+
+    def __cinit__(self):
+        self.thisptr = new registration.BatchKabsch()
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, points, ref_points):
+        """Align each set of points with its reference set
+
+        :param points: sets of points to rotate
+        :param ref_points: reference set shared by all the sets, or one reference set per set
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{sets}`, :math:`N_{points}`, 3), dtype= :class:`numpy.float32`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{points}`, 3) or (:math:`N_{sets}`, :math:`N_{points}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True)
+        if points.shape[2] != 3:
+            raise ValueError('Need sets of 3D points for compute()')
+        ref_points = np.ascontiguousarray(ref_points, dtype=np.float32)
+        cdef bint shared_ref = ref_points.ndim == 2
+        if shared_ref:
+            if ref_points.shape[0] != points.shape[1] or ref_points.shape[1] != 3:
+                raise ValueError('ref_points must have shape (N_points, 3) or (N_sets, N_points, 3)')
+        elif ref_points.ndim != 3 or ref_points.shape[0] != points.shape[0] or \
+                ref_points.shape[1] != points.shape[1] or ref_points.shape[2] != 3:
+            raise ValueError('ref_points must have shape (N_points, 3) or (N_sets, N_points, 3)')
+        cdef np.ndarray cPoints = points
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int num_sets = points.shape[0]
+        cdef unsigned int num_points = points.shape[1]
+        with nogil:
+            self.thisptr.compute(<vec3[float]*> cPoints.data, <vec3[float]*> cRef_points.data, num_sets, num_points,
+                                 shared_ref)
+
+    def getNumSets(self):
+        """Count the sets of the last :meth:`~.compute()`
+
+        :return: number of sets
+        :rtype: int
+        """
+        return self.thisptr.getNumSets()
+
+    def getRotations(self):
+        """Returns the rotation of each set
+
+        :return: numpy array of the rotation matrices, which act on the points as column vectors
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{sets}`, 3, 3), dtype= :class:`numpy.float32`
+        """
+        cdef float *rotations_raw = self.thisptr.getRotations().get()
+        cdef np.npy_intp nRotations[3]
+        nRotations[0] = <np.npy_intp>self.thisptr.getNumSets()
+        nRotations[1] = 3
+        nRotations[2] = 3
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nRotations, np.NPY_FLOAT32, <void*>rotations_raw)
+        return result
+
+    def getRMSDs(self):
+        """Returns the root mean square deviation of each set from its reference set after its rotation
+
+        :return: numpy array of RMSDs
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{sets}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rmsds_raw = self.thisptr.getRMSDs().get()
+        cdef np.npy_intp nSets[1]
+        nSets[0] = <np.npy_intp>self.thisptr.getNumSets()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nSets, np.NPY_FLOAT32, <void*>rmsds_raw)
+        return result
@@ -0,0 +1,10 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+## \package freud.registration
+#
+# Methods to align sets of points.
+#
+
+# bring related c++ classes into the registration module
+from ._freud import BatchKabsch
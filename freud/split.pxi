@@ -0,0 +1,135 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from freud.util._VectorMath cimport vec3, quat
+cimport freud._split as split
+cimport freud._box as _box
+import numpy as np
+cimport numpy as np
+
+cdef class ShapeSplit:
+    """Split a set of anisotropic shapes into points
+
+    Split point :math:`j` of shape :math:`i` is at :math:`\\vec{r}_i + q_i \\vec{s}_j q_i^*`, wrapped into the box,
+    and has the orientation :math:`q_i` of its shape. The arrays of :py:meth:`compute()` are reused for as long as
+    the numbers of shapes and split points are unchanged; with `out`, the split points are written into arrays of
+    the caller instead, so that large systems are split frame after frame without any allocation.
+
+    :param box: simulation box
+    :type box: :py:class:`freud.box.Box`
+    """
+    cdef split.ShapeSplit *thisptr
+
+    def __cinit__(self, box):
+        cdef _box.Box cBox = cpp_box(box)
+        self.thisptr = new split.ShapeSplit(cBox)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """Get the box used in the calculation
+
+        :return: freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def updateBox(self, box):
+        """Update the box used in the calculation
+
+        :param box: simulation box
+        :type box: :py:class:`freud.box.Box`
+        """
+        cdef _box.Box cBox = cpp_box(box)
+        self.thisptr.updateBox(cBox)
+
+    def compute(self, points, orientations, split_points, out=None, out_orientations=None):
+        """Split the shapes into points
+
+        With `out`, the positions are written into `out` (and the orientations into `out_orientations`, if given)
+        and nothing is kept by this object.
+
+        :param points: centers of the shapes
+        :param orientations: orientations of the shapes as quaternions
+        :param split_points: split points in the frame of a shape
+        :param out: array to write the positions into (optional)
+        :param out_orientations: array to write the orientations into, along with `out` (optional)
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 4), dtype= :class:`numpy.float32`
+        :type split_points: :class:`numpy.ndarray`, shape=(:math:`N_{split}`, 3), dtype= :class:`numpy.float32`
+        :type out: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{split}`, 3), dtype= :class:`numpy.float32`
+        :type out_orientations: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{split}`, 4), dtype= :class:`numpy.float32`
+        :return: `out`, if given
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+        split_points = freud.common.convert_array(split_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="split_points must be a 2 dimensional array")
+        if points.shape[1] != 3 or split_points.shape[1] != 3:
+            raise RuntimeError('Need to provide array with x, y, z positions')
+        if orientations.shape[1] != 4:
+            raise RuntimeError('Need to provide array with quaternion orientations')
+        if orientations.shape[0] != points.shape[0]:
+            raise RuntimeError('Need one orientation per point')
+        cdef np.ndarray[float, ndim=2] cPoints = points
+        cdef np.ndarray[float, ndim=2] cOrientations = orientations
+        cdef np.ndarray[float, ndim=2] cSplit_points = split_points
+        cdef unsigned int Np = points.shape[0]
+        cdef unsigned int Nsplit = split_points.shape[0]
+        cdef np.ndarray cOut
+        cdef np.ndarray cOut_orientations
+        cdef quat[float] *out_orientations_ptr = NULL
+        if out is None:
+            if out_orientations is not None:
+                raise RuntimeError('out_orientations needs out')
+            with nogil:
+                self.thisptr.compute(<vec3[float]*> cPoints.data, Np, <quat[float]*> cOrientations.data,
+                                     <vec3[float]*> cSplit_points.data, Nsplit)
+            return None
+
+        if not (isinstance(out, np.ndarray) and out.dtype == np.float32 and out.flags.c_contiguous and
+                out.shape == (Np, Nsplit, 3)):
+            raise RuntimeError('out must be a contiguous float32 array of shape (N_particles, N_split, 3)')
+        cOut = out
+        if out_orientations is not None:
+            if not (isinstance(out_orientations, np.ndarray) and out_orientations.dtype == np.float32 and
+                    out_orientations.flags.c_contiguous and out_orientations.shape == (Np, Nsplit, 4)):
+                raise RuntimeError('out_orientations must be a contiguous float32 array of shape (N_particles, N_split, 4)')
+            cOut_orientations = out_orientations
+            out_orientations_ptr = <quat[float]*> cOut_orientations.data
+        with nogil:
+            self.thisptr.computeInto(<vec3[float]*> cPoints.data, Np, <quat[float]*> cOrientations.data,
+                                     <vec3[float]*> cSplit_points.data, Nsplit, <vec3[float]*> cOut.data,
+                                     out_orientations_ptr)
+        return out
+
+    def getShapeSplit(self):
+        """Get the positions of the split points of the last :py:meth:`compute()` without `out`
+
+        :return: split points
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{split}`, 3), dtype= :class:`numpy.float32`
+        """
+        cdef float *split_points = self.thisptr.getShapeSplit().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNpoints()
+        nbins[1] = <np.npy_intp>self.thisptr.getNsplit()
+        nbins[2] = 3
+        cdef np.ndarray[float, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>split_points)
+        return result
+
+    def getShapeOrientations(self):
+        """Get the orientations of the split points of the last :py:meth:`compute()` without `out`
+
+        :return: split point orientations
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{split}`, 4), dtype= :class:`numpy.float32`
+        """
+        cdef float *split_orientations = self.thisptr.getShapeOrientations().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNpoints()
+        nbins[1] = <np.npy_intp>self.thisptr.getNsplit()
+        nbins[2] = 4
+        cdef np.ndarray[float, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>split_orientations)
+        return result
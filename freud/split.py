@@ -1,9 +1,10 @@
 # Copyright (c) 2010-2016 The Regents of the University of Michigan
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
-import numpy
-import re
-from _freud import ShapeSplit
-
 ## \package freud.split
 #
+# Methods to split anisotropic shapes into points.
+#
+
+# bring related c++ classes into the split module
+from ._freud import ShapeSplit
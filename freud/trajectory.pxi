@@ -0,0 +1,122 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from freud.util._VectorMath cimport vec3
+cimport freud._box as _box
+cimport freud._trajectory as trajectory
+from libcpp.string cimport string
+import numpy as np
+cimport numpy as np
+
+cdef class DCDReader:
+    """Reads the frames of a DCD trajectory file in place
+
+    The file is mapped in memory rather than read: :py:meth:`getX()`, :py:meth:`getY()` and :py:meth:`getZ()` are
+    views of the coordinates of a frame in the file, and :py:meth:`getPositions()` interleaves them into an array of
+    points, which can be given the same array back on every frame, so that nothing is read before it is used and no
+    frame is copied through Python. The number of frames is found from the size of the file.
+
+    :param filename: DCD file, in the byte order of the machine and without fixed atoms
+    :type filename: str
+    """
+    cdef trajectory.DCDReader *thisptr
+
+    def __cinit__(self, filename):
+        cdef string cFilename = filename.encode('utf-8')
+        self.thisptr = new trajectory.DCDReader(cFilename)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getNumFrames(self):
+        """Get the number of frames of the file
+
+        :return: number of frames
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumFrames()
+
+    def getNP(self):
+        """Get the number of particles of each frame
+
+        :return: number of particles
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNP()
+
+    def hasUnitCell(self):
+        """Get whether the frames have a unit cell, for :py:meth:`getBox()`
+
+        :rtype: bool
+        """
+        return self.thisptr.hasUnitCell()
+
+    def getBox(self, frame):
+        """Get the box of a frame, from its unit cell
+
+        :param frame: index of the frame
+        :type frame: unsigned int
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox(frame))
+
+    cdef _coordinates(self, const float *data):
+        # read-only view of coordinates in the mapping of the file, which keeps the file mapped
+        cdef np.npy_intp nP[1]
+        nP[0] = <np.npy_intp>self.thisptr.getNP()
+        result = result_array(self, 1, nP, np.NPY_FLOAT32, <void*> data)
+        result.setflags(write=False)
+        return result
+
+    def getX(self, frame):
+        """Get the x coordinates of the particles of a frame, as a read-only view of the file
+
+        :param frame: index of the frame
+        :type frame: unsigned int
+        :return: x coordinates
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles} \\right)`, dtype= :class:`numpy.float32`
+        """
+        return self._coordinates(self.thisptr.getX(frame))
+
+    def getY(self, frame):
+        """Get the y coordinates of the particles of a frame, as a read-only view of the file
+
+        :param frame: index of the frame
+        :type frame: unsigned int
+        :return: y coordinates
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles} \\right)`, dtype= :class:`numpy.float32`
+        """
+        return self._coordinates(self.thisptr.getY(frame))
+
+    def getZ(self, frame):
+        """Get the z coordinates of the particles of a frame, as a read-only view of the file
+
+        :param frame: index of the frame
+        :type frame: unsigned int
+        :return: z coordinates
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles} \\right)`, dtype= :class:`numpy.float32`
+        """
+        return self._coordinates(self.thisptr.getZ(frame))
+
+    def getPositions(self, frame, out=None):
+        """Get the positions of the particles of a frame
+
+        :param frame: index of the frame
+        :param out: array to write the positions into, reused instead of a new array (optional)
+        :type frame: unsigned int
+        :type out: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :return: positions, which are out when it is given
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef unsigned int cFrame = frame
+        if out is None:
+            out = np.empty((self.thisptr.getNP(), 3), dtype=np.float32)
+        elif (not isinstance(out, np.ndarray) or out.dtype != np.float32 or
+                out.shape != (self.thisptr.getNP(), 3) or not out.flags.c_contiguous or not out.flags.writeable):
+            raise ValueError('out must be a writeable C-contiguous float32 array of shape ({}, 3)'.format(
+                self.thisptr.getNP()))
+        cdef np.ndarray[float, ndim=2] l_out = out
+        with nogil:
+            self.thisptr.getPositions(cFrame, <vec3[float]*> l_out.data)
+        return out
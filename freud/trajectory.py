@@ -0,0 +1,10 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+## \package freud.trajectory
+#
+# Methods to read trajectory files.
+#
+
+# bring related c++ classes into the trajectory module
+from ._freud import DCDReader
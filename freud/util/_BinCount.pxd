@@ -0,0 +1,5 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+cdef extern from "BinCount.h" namespace "freud::util":
+    ctypedef unsigned int BinCount
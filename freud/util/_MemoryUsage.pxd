@@ -0,0 +1,10 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from libcpp.map cimport map
+from libcpp.string cimport string
+
+cdef extern from "MemoryUsage.h" namespace "freud::util":
+    cdef cppclass MemoryUsage:
+        const map[string, size_t]& getComponents() const
+        size_t getTotal() const
@@ -0,0 +1,13 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from libcpp cimport bool
+from libcpp.map cimport map
+from libcpp.string cimport string
+
+cdef extern from "Profiler.h" namespace "freud::util":
+    bool isProfilingEnabled()
+
+    cdef cppclass Profiler:
+        const map[string, double]& getTimings() const
+        const map[string, unsigned long long]& getStats() const
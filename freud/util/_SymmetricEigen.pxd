@@ -0,0 +1,7 @@
+# Copyright (c) 2010-2016 The Regents of the University of Michigan
+# This file is part of the Freud project, released under the BSD 3-Clause License.
+
+from libcpp cimport bool
+
+cdef extern from "SymmetricEigen.h" namespace "freud::util":
+    bool symmetricEigen3(const double[3][3], double[3], double[3][3])
@@ -6,3 +6,8 @@ cdef extern from "cudacpu_vector_types.h":
         float x
         float y
         float z
+
+    cdef struct uchar3:
+        unsigned char x
+        unsigned char y
+        unsigned char z
@@ -4,8 +4,10 @@
 from cython.view cimport array as cvarray
 from libcpp.vector cimport vector
 from freud.util._cudaTypes cimport float3
+from freud.util._VectorMath cimport vec3
 cimport freud._voronoi as voronoi
 cimport freud._box as _box
+cimport freud._locality as locality
 from cython.operator cimport dereference
 import numpy as np
 cimport numpy as np
@@ -17,7 +19,7 @@ cdef class VoronoiBuffer:
     cdef voronoi.VoronoiBuffer *thisptr
 
     def __cinit__(self, box):
-        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef _box.Box cBox = cpp_box(box)
         self.thisptr = new voronoi.VoronoiBuffer(cBox)
 
     def compute(self, points, float buffer):
@@ -27,14 +29,18 @@ cdef class VoronoiBuffer:
         dimensions = 2 if self.thisptr.getBox().is2D() else 3
         if points.shape[1] != dimensions:
             raise RuntimeError('Need a list of {}D points for VoronoiBuffer.compute()'.format(dimensions))
+        if dimensions == 2:
+            # the C++ side reads 3 component points
+            points = np.ascontiguousarray(np.hstack([points, np.zeros((points.shape[0], 1), dtype=np.float32)]))
         cdef np.ndarray cPoints = points
         cdef unsigned int Np = points.shape[0]
-        self.thisptr.compute(<float3*> cPoints.data, Np, buffer)
+        with nogil:
+            self.thisptr.compute(<vec3[float]*> cPoints.data, Np, buffer)
 
     def getBufferParticles(self):
         cdef _box.Box cBox = self.thisptr.getBox()
-        cdef unsigned int buffer_size = dereference(self.thisptr.getBufferParticles().get()).size()
-        cdef float3* buffer_points = &dereference(self.thisptr.getBufferParticles().get())[0]
+        cdef unsigned int buffer_size = self.thisptr.getNumBufferParticles()
+        cdef const vec3[float]* buffer_points = self.thisptr.getBufferPoints()
         if not buffer_size:
             return np.array([[]], dtype=np.float32)
         shape = [buffer_size, 3]
@@ -45,3 +51,165 @@ cdef class VoronoiBuffer:
             return result[:, :2]
         else:
             return result
+
+cdef class VoronoiCells:
+    """Compute the Voronoi cell of every particle of a periodic system natively, in parallel over the particles.
+
+    Each cell is cut out of a box around its particle by the bisecting planes of its candidate neighbors, the
+    nearest first, which are found with a cell list. All periodic images are taken into account, so neither qhull
+    nor buffer particles are needed. In 2D boxes the cells are polygons.
+
+    Example::
+
+       cells = VoronoiCells()
+       cells.compute(box, positions)
+       volumes = cells.getVolumes()
+       surface_areas = cells.getSurfaceAreas()
+       nlist = cells.getNlist()
+       areas = cells.getFaceAreas()
+       # the neighbors of the neighbors as well, for example for LocalQl
+       cells.computeShells(2)
+       ql.compute(positions, nlist=cells.getShellNlist())
+
+    With a positive skin, :py:meth:`update()` computes the cells of later frames from the candidate neighbors found
+    by the last :py:meth:`compute()`: a cell whose faces are unchanged is only moved, and only the cells that may
+    have new neighbors are searched again. The results are those of :py:meth:`compute()`, which update() falls back
+    to once a particle has moved by more than half the skin::
+
+       cells = VoronoiCells(skin=0.3)
+       cells.compute(box, positions)
+       for positions in frames:
+           cells.update(box, positions)
+
+    :param skin: distance the particles may move before :py:meth:`update()` starts over, 0 to only compute
+    :type skin: float
+    """
+    cdef voronoi.VoronoiCells *thisptr
+
+    def __cinit__(self, float skin=0):
+        self.thisptr = new voronoi.VoronoiCells(skin)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, box, points):
+        """Compute the Voronoi cells of the points
+
+        :param box: simulation box
+        :param points: point coordinates, with z = 0 in 2D boxes
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cPoints.data, Np)
+
+    def update(self, box, points):
+        """Compute the Voronoi cells of new positions of the same points, reusing the candidate neighbors of the last
+        :py:meth:`compute()` where it is safe
+
+        :param box: simulation box
+        :param points: point coordinates, with z = 0 in 2D boxes
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = cpp_box(box)
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        with nogil:
+            self.thisptr.update(cBox, <vec3[float]*> cPoints.data, Np)
+
+    def getSkin(self):
+        """Get the skin
+
+        :return: skin
+        :rtype: float
+        """
+        return self.thisptr.getSkin()
+
+    def getNumRecomputed(self):
+        """Get the number of cells of the last :py:meth:`compute()` or :py:meth:`update()` that were searched from a
+        cell list, all of them for compute()
+
+        :return: number of cells searched
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumRecomputed()
+
+    def getVolumes(self):
+        """Get the volume of the cell of each particle, its area in 2D
+
+        :return: cell volumes
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float *volumes = self.thisptr.getVolumes().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>volumes)
+        return result
+
+    def getSurfaceAreas(self):
+        """Get the surface area of the cell of each particle, the sum of the areas of its faces; its perimeter in 2D
+
+        :return: cell surface areas
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float *areas = self.thisptr.getSurfaceAreas().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNP()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>areas)
+        return result
+
+    def getNlist(self):
+        """Get the faces of the cells as a neighbor list, with one bond from each particle to the image of the
+        neighbor across each face of its cell; the bond vectors are stored
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNlist(), self)
+        return result
+
+    def computeShells(self, unsigned int num_shells):
+        """Find the particles up to num_shells faces away from each particle, from the last :py:meth:`compute()`
+
+        :param num_shells: number of shells of neighbors, 1 for the neighbors across the faces of each cell
+        :type num_shells: unsigned int
+        """
+        with nogil:
+            self.thisptr.computeShells(num_shells)
+
+    def getShellNlist(self):
+        """Get the neighbors found by :py:meth:`computeShells()` as a neighbor list. The bonds of each particle are
+        ordered by shell, each neighbor appears once, and the bond vectors are the sums of the face vectors along
+        the shortest path through the faces
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getShellNlist(), self)
+        return result
+
+    def getFaceAreas(self):
+        """Get the area of each face, in the order of the bonds of :py:meth:`getNlist()`; its length in 2D
+
+        :return: face areas
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float *areas = self.thisptr.getFaceAreas().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNlist().getNumBonds()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>areas)
+        return result
@@ -13,10 +13,13 @@ except ImportError:
     logger.warning(msg)
     #raise ImportWarning(msg)
 from ._freud import VoronoiBuffer
+from ._freud import VoronoiCells
 
 ## Compute the Voronoi tesselation of a 2D or 3D system using qhull
 # This essentially just wraps scipy.spatial.Voronoi, but accounts for
-# periodic boundary conditions
+# periodic boundary conditions within the buffer width. VoronoiCells
+# computes the cell volumes, face areas and neighbors of fully periodic
+# systems natively and in parallel, without scipy.
 class Voronoi:
     ##Initialize Voronoi
     # \param box The simulation box
@@ -67,6 +70,32 @@ class Voronoi:
     def getVoronoiPolytopes(self):
         return self.poly_verts
 
+    ##Compute the volume and surface area of the Voronoi cell of each particle natively
+    # The cells of the fully periodic system are computed in parallel by VoronoiCells, so neither
+    # qhull nor convex hulls of the polytopes are needed. In 2D the volumes are the areas of the
+    # cells and the surface areas their perimeters.
+    # \param positions The particle positions, Nx2 or Nx3
+    # \param box The simulation box, default the box of this object
+    def computeVolumes(self,positions,box=None):
+        if box is None:
+            box=self.box
+        positions = np.asarray(positions, dtype=np.float32)
+        if positions.shape[1] == 2:
+            positions = np.hstack((positions, np.zeros((len(positions), 1), dtype=np.float32)))
+        cells = VoronoiCells()
+        cells.compute(box, positions)
+        # the arrays of VoronoiCells only live as long as it does
+        self.volumes = np.copy(cells.getVolumes())
+        self.surface_areas = np.copy(cells.getSurfaceAreas())
+
+    #return the volume of the voronoi cell of each particle, its area in 2D
+    def getVolumes(self):
+        return self.volumes
+
+    #return the surface area of the voronoi cell of each particle, its perimeter in 2D
+    def getSurfaceAreas(self):
+        return self.surface_areas
+
     """Compute the neighbors of each particle based on the voronoi tessalation.
     One can include neighbors from multiple voronoi shells by specifying 'numShells' variable.
     An example code to compute neighbors upto two voronoi shells for a 2D mesh
@@ -0,0 +1,51 @@
+import numpy
+import numpy as np
+import numpy.testing as npt
+from freud import bond
+import unittest
+
+class TestBondingAnalysis(unittest.TestCase):
+    def setUp(self):
+        # 3 particles, 2 bonds
+        # particle 0 keeps particle 1 in bond 0 for a frame, then loses it
+        # particle 1 moves particle 0 from bond 0 to bond 1, then loses it
+        # particle 2 gains particle 0 in bond 0 in the last frame
+        u = np.iinfo(np.uint32).max
+        self.frames = [np.array([[1, u], [0, u], [u, u]], dtype=np.uint32),
+                       np.array([[1, u], [u, 0], [u, u]], dtype=np.uint32),
+                       np.array([[u, u], [u, u], [0, u]], dtype=np.uint32)]
+        self.analysis = bond.BondingAnalysis(3, 2)
+        self.analysis.initialize(self.frames[0])
+        for frame_0, frame_1 in zip(self.frames[:-1], self.frames[1:]):
+            self.analysis.compute(frame_0, frame_1)
+
+    def test_lifetimes(self):
+        self.assertEqual(self.analysis.getNumFrames(), 2)
+        self.assertEqual(self.analysis.getNumBonds(), 2)
+        # lifetimes of 0 frames in a bond are not counted
+        bond_lifetimes = self.analysis.getBondLifetimes()
+        npt.assert_equal(bond_lifetimes[0], [1])
+        npt.assert_equal(bond_lifetimes[1], [])
+        npt.assert_equal(self.analysis.getOverallLifetimes(), [1, 1])
+
+    def test_lifetime_histograms(self):
+        npt.assert_equal(self.analysis.getBondLifetimeHistogram(), [[0, 1], [0, 0]])
+        npt.assert_equal(self.analysis.getOverallLifetimeHistogram(), [0, 2])
+
+    def test_transition_matrix(self):
+        # by (bond in frame_1, bond in frame_0), the last index meaning unbound
+        npt.assert_equal(self.analysis.getTransitionMatrix(), [[1, 0, 1], [1, 0, 0], [1, 1, 0]])
+
+    def test_update(self):
+        # update compares with the last frame without being given it again
+        analysis = bond.BondingAnalysis(3, 2)
+        analysis.initialize(self.frames[0])
+        for frame_1 in self.frames[1:]:
+            analysis.update(frame_1)
+        self.assertEqual(analysis.getNumFrames(), 2)
+        npt.assert_equal(analysis.getTransitionMatrix(), self.analysis.getTransitionMatrix())
+        npt.assert_equal(analysis.getBondLifetimeHistogram(), self.analysis.getBondLifetimeHistogram())
+        npt.assert_equal(analysis.getOverallLifetimeHistogram(), self.analysis.getOverallLifetimeHistogram())
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,4 +1,5 @@
 from freud import box as bx;
+from freud import locality
 import numpy as np
 import numpy.testing as npt
 import warnings
@@ -67,6 +68,29 @@ class TestBox(unittest.TestCase):
 
         npt.assert_almost_equal(testpoints[0,0], 2, decimal=2, err_msg="WrapFail")
 
+    def test_wrap_images(self):
+        box = bx.Box(2, 2, 2, 1, 0, 0)
+        testpoints = np.array([[10, -5, -5],
+                               [0, 0.5, 0]], dtype=np.float32)
+        original = testpoints.copy()
+        imgs = np.zeros(testpoints.shape, dtype=np.int32)
+        box.wrap(testpoints, imgs)
+
+        npt.assert_equal(imgs, [[8, -2, -2], [0, 0, 0]], err_msg="ImageFail")
+        box.unwrap(testpoints, imgs)
+        npt.assert_almost_equal(testpoints, original, decimal=4, err_msg="UnwrapFail")
+
+    def test_fraction_array(self):
+        box = bx.Box(2, 3, 4, 1, 0.5, 0.1)
+        np.random.seed(0)
+        points = np.random.uniform(-1, 1, size=(100, 3)).astype(np.float32)
+
+        fractions = box.makeFraction(points)
+        self.assertEqual(fractions.shape, points.shape)
+        for point, fraction in zip(points, fractions):
+            npt.assert_almost_equal(fraction, box.makeFraction(point), decimal=5, err_msg="FractionFail")
+        npt.assert_almost_equal(box.makeCoordinates(fractions), points, decimal=5, err_msg="CoordinatesFail")
+
     def test_equal(self):
         box = bx.Box(2, 2, 2, 1, 0.5, 0.1)
         box2 = bx.Box(2, 2, 2, 1, 0, 0)
@@ -102,6 +126,27 @@ class TestBox(unittest.TestCase):
         box2 = box.from_matrix(box.to_matrix())
         self.assertTrue(np.isclose(box.to_matrix(), box2.to_matrix()).all())
 
+    def test_matrices(self):
+        boxes = [bx.Box(2, 2, 2, 1, 0.5, 0.1), bx.Box(3, 4, 5), bx.Box.square(2)]
+        matrices = np.array([box.to_matrix() for box in boxes])
+        boxes2 = bx.Box.from_matrices(matrices)
+        self.assertEqual(len(boxes2), 3)
+        for box, box2 in zip(boxes, boxes2):
+            self.assertTrue(np.isclose(box.to_matrix(), box2.to_matrix()).all())
+            self.assertEqual(box.dimensions, box2.dimensions)
+        with self.assertRaises(ValueError):
+            bx.Box.from_matrices(matrices[0])
+
+    def test_cpp_copy(self):
+        # boxes returned by the analyses are copies of their C++ box, periodicity included
+        box = bx.Box(4, 5, 6, 0.1, 0.2, 0.3)
+        box.setPeriodic(True, False, True)
+        box2 = locality.LinkCell(box, 1.0).getBox()
+        npt.assert_allclose(box2.getL(), box.getL())
+        npt.assert_allclose([box2.getTiltFactorXY(), box2.getTiltFactorXZ(), box2.getTiltFactorYZ()], [0.1, 0.2, 0.3],
+                            rtol=1e-6)
+        self.assertEqual(box2.getPeriodic(), [True, False, True])
+
     def test_2_dimensional(self):
         box = bx.Box.square(L=1)
         box.Lz = 1.0
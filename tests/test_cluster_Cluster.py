@@ -0,0 +1,84 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, cluster, locality
+import unittest
+
+class TestCluster(unittest.TestCase):
+    def test_labels(self):
+        # three chains of particles, listed out of order
+        points = np.array([[0, 0, 0], [3, 0, 0], [0.5, 0, 0], [-3, 0, 0], [3.5, 0, 0], [1, 0, 0]], dtype=np.float32)
+        fbox = box.Box.cube(10.0)
+        clust = cluster.Cluster(fbox, 0.6)
+        clust.computeClusters(points)
+        self.assertEqual(clust.getNumClusters(), 3)
+        # clusters are numbered in the order of their first particle
+        npt.assert_equal(clust.getClusterIdx(), [0, 1, 0, 2, 1, 0])
+
+    def test_membership(self):
+        points = np.array([[0, 0, 0], [3, 0, 0], [0.5, 0, 0], [-3, 0, 0], [3.5, 0, 0], [1, 0, 0]], dtype=np.float32)
+        keys = np.array([7, 2, 5, 4, 2, 7], dtype=np.uint32)
+        fbox = box.Box.cube(10.0)
+        clust = cluster.Cluster(fbox, 0.6)
+        clust.computeClusters(points)
+        clust.computeClusterMembership(keys)
+        # sorted unique keys of each cluster, one cluster after the other
+        npt.assert_equal(clust.getClusterKeyOffsets(), [0, 2, 3, 4])
+        npt.assert_equal(clust.getClusterKeys(), [5, 7, 2, 4])
+
+    def test_nlist(self):
+        np.random.seed(0)
+        fbox = box.Box.cube(10.0)
+        points = (np.random.random_sample((2000, 3))*10 - 5).astype(np.float32)
+        clust = cluster.Cluster(fbox, 0.8)
+        clust.computeClusters(points)
+        idx = np.copy(clust.getClusterIdx())
+        num_clusters = clust.getNumClusters()
+
+        lc = locality.LinkCell(fbox, 1.0)
+        lc.computeNlist(fbox, points)
+        clust.computeClusters(points, lc.getNlist())
+        self.assertEqual(clust.getNumClusters(), num_clusters)
+        npt.assert_equal(clust.getClusterIdx(), idx)
+
+    def test_bonds(self):
+        # two chains and an isolated point, with bonds in both directions and repeated
+        bonds = np.array([[0, 1], [2, 1], [1, 2], [3, 4], [5, 4]], dtype=np.uint32)
+        clust = cluster.Cluster(box.Box.cube(10.0), 1.0)
+        clust.computeClustersFromBonds(7, bonds)
+        self.assertEqual(clust.getNumClusters(), 3)
+        npt.assert_equal(clust.getClusterIdx(), [0, 0, 0, 1, 1, 1, 2])
+        with self.assertRaises(ValueError):
+            clust.computeClustersFromBonds(4, bonds)
+
+        # the bonds of a neighbor list are merged whatever their distances
+        np.random.seed(0)
+        fbox = box.Box.cube(10.0)
+        points = (np.random.random_sample((2000, 3))*10 - 5).astype(np.float32)
+        clust = cluster.Cluster(fbox, 0.8)
+        clust.computeClusters(points)
+        lc = locality.LinkCell(fbox, 0.8)
+        lc.computeNlist(fbox, points)
+        nlist = lc.getNlist()
+        by_distance = np.copy(clust.getClusterIdx())
+        clust.computeClustersFromBonds(len(points), nlist)
+        npt.assert_equal(clust.getClusterIdx(), by_distance)
+        clust.computeClustersFromBonds(len(points), np.stack([nlist.getIndexI(), nlist.getIndexJ()], axis=1))
+        npt.assert_equal(clust.getClusterIdx(), by_distance)
+
+    def test_percolation(self):
+        fbox = box.Box.cube(10.0)
+        # a rod wrapping around x, a sheet wrapping around x and y, and a pair across the boundary along x
+        rod = [[-4.5 + i, 0, 0] for i in range(10)]
+        sheet = [[-4.5 + i, -4.5 + j, 3] for i in range(10) for j in range(10)]
+        pair = [[4.7, -2, -2], [-4.7, -2, -2]]
+        points = np.array(rod + sheet + pair, dtype=np.float32)
+        clust = cluster.Cluster(fbox, 1.1)
+        clust.computeClusters(points, track_images=True)
+        self.assertEqual(clust.getNumClusters(), 3)
+        npt.assert_equal(clust.getClusterPercolationDim(), [1, 2, 0])
+        npt.assert_equal(clust.getClusterPercolationAxes(), [1, 3, 0])
+        # the pair is made whole by unwrapping its second particle
+        npt.assert_equal(clust.getClusterImages()[-2:], [[0, 0, 0], [1, 0, 0]])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,28 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, cluster
+import unittest
+
+class TestClusterProperties(unittest.TestCase):
+    def test_rod(self):
+        # a rod of 5 points along x, and a pair across the periodic boundary along y
+        points = np.array([[-2, 0, 0], [-1, 0, 0], [0, 0, 0], [1, 0, 0], [2, 0, 0],
+                           [0, 4.5, 2], [0, -4.5, 2]], dtype=np.float32)
+        cluster_idx = np.array([0, 0, 0, 0, 0, 1, 1], dtype=np.uint32)
+        props = cluster.ClusterProperties(box.Box.cube(10.0))
+        props.computeProperties(points, cluster_idx)
+
+        self.assertEqual(props.getNumClusters(), 2)
+        npt.assert_equal(props.getClusterSizes(), [5, 2])
+        com = props.getClusterCOM()
+        npt.assert_allclose(com[0], [0, 0, 0], atol=1e-6)
+        npt.assert_allclose(np.abs(com[1]), [0, 5, 2], atol=1e-5)
+
+        G = props.getClusterG()
+        npt.assert_allclose(G[0], np.diag([2, 0, 0]), atol=1e-6)
+        npt.assert_allclose(G[1], np.diag([0, 0.25, 0]), atol=1e-5)
+        npt.assert_allclose(props.getClusterRg(), [np.sqrt(2), 0.5], rtol=1e-5)
+        npt.assert_allclose(props.getClusterAsphericity(), [2, 0.25], rtol=1e-5)
+
+if __name__ == '__main__':
+    unittest.main()
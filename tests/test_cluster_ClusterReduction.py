@@ -0,0 +1,39 @@
+import numpy as np
+import numpy.testing as npt
+from freud import cluster
+import unittest
+
+class TestClusterReduction(unittest.TestCase):
+    def test_compare_groupby(self):
+        np.random.seed(0)
+        N = 1000
+        cluster_idx = np.random.randint(0, 20, N).astype(np.uint32)
+        values = np.random.normal(size=(N, 3)).astype(np.float32)
+        values[:, 1] += cluster_idx
+
+        # one cluster past the largest index has no particles
+        red = cluster.ClusterReduction()
+        red.compute(cluster_idx, values, num_clusters=21, covariance=True)
+        self.assertEqual(red.getNumClusters(), 21)
+        for c in range(20):
+            members = values[cluster_idx == c]
+            self.assertEqual(red.getClusterSizes()[c], len(members))
+            npt.assert_allclose(red.getSum()[c], members.sum(axis=0), rtol=1e-5, atol=1e-4)
+            npt.assert_allclose(red.getMean()[c], members.mean(axis=0), rtol=1e-5, atol=1e-5)
+            npt.assert_equal(red.getMin()[c], members.min(axis=0))
+            npt.assert_equal(red.getMax()[c], members.max(axis=0))
+            npt.assert_allclose(red.getCovariance()[c], np.cov(members.T, bias=True), rtol=1e-4, atol=1e-5)
+        self.assertEqual(red.getClusterSizes()[20], 0)
+        self.assertTrue(np.all(np.isnan(red.getMean()[20])))
+
+    def test_1d_values(self):
+        cluster_idx = np.array([1, 0, 1, 1], dtype=np.uint32)
+        red = cluster.ClusterReduction()
+        red.compute(cluster_idx, [4, 2, 6, 8])
+        npt.assert_equal(red.getMean(), [2, 6])
+        npt.assert_equal(red.getMax(), [2, 8])
+        with self.assertRaises(RuntimeError):
+            red.getCovariance()
+
+if __name__ == '__main__':
+    unittest.main()
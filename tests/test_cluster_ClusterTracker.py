@@ -0,0 +1,48 @@
+import numpy as np
+import numpy.testing as npt
+from freud import cluster
+import unittest
+
+class TestClusterTracker(unittest.TestCase):
+    def test_events(self):
+        # clusters of a single particle are not tracked
+        tracker = cluster.ClusterTracker(2)
+        tracker.update(np.array([0, 0, 0, 1, 1, 1, 2, 3, 3], dtype=np.uint32))
+        npt.assert_equal(tracker.getClusterIds(), [0, 1, cluster.ClusterTracker.UNTRACKED, 2])
+        npt.assert_equal(tracker.getEvents()[:, 0], [cluster.ClusterTracker.BIRTH]*3)
+
+        # cluster 0 loses a particle, cluster 1 gains one
+        tracker.update(np.array([0, 0, 1, 2, 2, 2, 3, 4, 4], dtype=np.uint32))
+        self.assertEqual(tracker.getNumEvents(), 0)
+        npt.assert_equal(tracker.getOverlapPrev(), [0, 0, 1, 2, 3])
+        npt.assert_equal(tracker.getOverlapNext(), [0, 1, 2, 3, 4])
+        npt.assert_equal(tracker.getOverlapCount(), [2, 1, 3, 1, 2])
+        npt.assert_equal(tracker.getClusterIds(), [0, cluster.ClusterTracker.UNTRACKED, 1,
+                                                   cluster.ClusterTracker.UNTRACKED, 2])
+
+        # clusters 0 and 2 merge, keeping the id of the larger, and cluster 4 breaks up
+        tracker.update(np.array([0, 0, 0, 0, 0, 0, 1, 2, 3], dtype=np.uint32))
+        npt.assert_equal(tracker.getEvents(), [[cluster.ClusterTracker.MERGE, 0, 0],
+                                               [cluster.ClusterTracker.MERGE, 2, 0],
+                                               [cluster.ClusterTracker.DEATH, 4, cluster.ClusterTracker.UNTRACKED]])
+        self.assertEqual(tracker.getClusterIds()[0], 1)
+        self.assertEqual(tracker.getNumFrames(), 3)
+
+    def test_split(self):
+        tracker = cluster.ClusterTracker()
+        tracker.update(np.zeros(6, dtype=np.uint32))
+        tracker.update(np.array([0, 0, 1, 1, 1, 1], dtype=np.uint32))
+        npt.assert_equal(tracker.getEvents(), [[cluster.ClusterTracker.SPLIT, 0, 0],
+                                               [cluster.ClusterTracker.SPLIT, 0, 1]])
+        # the larger part keeps the id
+        npt.assert_equal(tracker.getClusterIds(), [1, 0])
+
+        with self.assertRaises(ValueError):
+            tracker.update(np.zeros(5, dtype=np.uint32))
+
+        tracker.reset()
+        tracker.update(np.zeros(5, dtype=np.uint32))
+        npt.assert_equal(tracker.getClusterIds(), [0])
+
+if __name__ == '__main__':
+    unittest.main()
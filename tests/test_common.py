@@ -27,5 +27,17 @@ class TestCommon(unittest.TestCase):
         except TypeError as e:
             npt.assert_equal(True, True)
 
+    def test_convert_array_no_copy(self):
+        # matching arrays come back as they are
+        x = np.zeros((10, 3), dtype=np.float32)
+        self.assertIs(common.convert_array(x, 2, dtype=np.float32), x)
+        # strided views are copied once into a contiguous array
+        y = np.arange(40, dtype=np.float32).reshape(10, 4)[:, :3]
+        z = common.convert_array(y, 2, dtype=np.float32)
+        npt.assert_equal(z.flags.c_contiguous, True)
+        npt.assert_equal(z, y)
+        # non-contiguous arrays are fine when contiguity is not required
+        self.assertIs(common.convert_array(y, 2, dtype=np.float32, contiguous=False), y)
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,57 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density
+import unittest
+
+def random_rotations_z(n):
+    angles = np.random.uniform(0, 2*np.pi, n)
+    return np.stack([np.cos(angles/2), np.zeros(n), np.zeros(n), np.sin(angles/2)], axis=1).astype(np.float32)
+
+class TestAngularRDF(unittest.TestCase):
+    def test_matches_brute_force(self):
+        rmax = 2.0
+        dr = 0.5
+        num_cos = 4
+        box_size = 8.0
+        np.random.seed(0)
+        points = np.random.uniform(-box_size/2, box_size/2, (300, 3)).astype(np.float32)
+        orientations = random_rotations_z(len(points))
+        fbox = box.Box.cube(box_size)
+
+        angular = density.AngularRDF(rmax, dr, num_cos)
+        angular.compute(fbox, points, orientations, points)
+        counts = angular.getBinCounts()
+        self.assertEqual(counts.shape, (int(rmax/dr), num_cos))
+
+        # the axis of each point is x rotated about z
+        angles = 2*np.arctan2(orientations[:, 3], orientations[:, 0])
+        axes = np.stack([np.cos(angles), np.sin(angles), np.zeros(len(points))], axis=1)
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta -= box_size*np.round(delta/box_size)
+        r = np.linalg.norm(delta, axis=2)
+        mask = (r > 0) & (r < rmax)
+        cos_theta = np.einsum('ik,ijk->ij', axes, delta)[mask]/r[mask]
+        expected = np.histogram2d(r[mask], cos_theta, bins=(int(rmax/dr), num_cos),
+                                  range=((0, rmax), (-1, 1)))[0]
+        npt.assert_allclose(counts, expected, atol=2)
+        # summed over the angles, the pairs are those of the rdf
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        npt.assert_allclose(angular.getRDF().mean(axis=1)[1:], rdf.getRDF()[1:], rtol=1e-4)
+
+    def test_ideal_gas(self):
+        np.random.seed(1)
+        for fbox, dim in ((box.Box.cube(20), 3), (box.Box.square(40), 2)):
+            points = np.random.uniform(-fbox.getLx()/2, fbox.getLx()/2, (20000, 3)).astype(np.float32)
+            if dim == 2:
+                points[:, 2] = 0
+            angular = density.AngularRDF(3.0, 0.5, 8)
+            angular.compute(fbox, points, random_rotations_z(len(points)), points)
+            npt.assert_allclose(angular.getRDF()[2:], 1, atol=0.05)
+
+    def test_invalid_axis(self):
+        with self.assertRaises(ValueError):
+            density.AngularRDF(2.0, 0.1, 4, axis=(0, 0, 0))
+
+if __name__ == '__main__':
+    unittest.main()
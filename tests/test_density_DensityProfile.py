@@ -0,0 +1,57 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density
+import unittest
+
+class TestDensityProfile(unittest.TestCase):
+    def test_matches_histogram(self):
+        nbins = 20
+        num_types = 2
+        fbox = box.Box(10, 10, 20)
+        np.random.seed(0)
+        points = np.random.uniform(-5, 5, (2000, 3)).astype(np.float32)
+        points[:, 2] *= 2
+        types = np.random.randint(num_types, size=len(points)).astype(np.uint32)
+
+        profile = density.DensityProfile(2, nbins, num_types)
+        profile.accumulate(fbox, points, types)
+        profile.accumulate(fbox, points, types)
+        self.assertEqual(profile.getFrameCounter(), 2)
+        result = profile.getDensity()
+        self.assertEqual(result.shape, (num_types, nbins))
+        slab_volume = fbox.getVolume()/nbins
+        for t in range(num_types):
+            expected = np.histogram(points[types == t, 2], bins=nbins, range=(-10, 10))[0]/slab_volume
+            npt.assert_allclose(result[t], expected, rtol=1e-5)
+        npt.assert_allclose(profile.getPositions(), np.linspace(-10, 10, nbins + 1)[:-1] + 0.5, atol=1e-5)
+
+    def test_smearing_and_recentering(self):
+        nbins = 40
+        fbox = box.Box(10, 10, 20)
+        np.random.seed(1)
+        # a slab of width 4 across the boundary of the box along z
+        points = np.random.uniform(-5, 5, (10000, 3)).astype(np.float32)
+        points[:, 2] = np.random.uniform(-2, 2, len(points)) + 10
+        points[:, 2] -= 20*np.round(points[:, 2]/20)
+
+        profile = density.DensityProfile(2, nbins, sigma=0.5)
+        profile.compute(fbox, points)
+        # the smearing keeps the number of points
+        self.assertAlmostEqual(profile.getDensity().sum()*fbox.getVolume()/nbins, len(points), delta=1)
+
+        profile = density.DensityProfile(2, nbins, recenter=True)
+        profile.compute(fbox, points)
+        result = profile.getDensity()[0]
+        inside = np.abs(profile.getPositions()) < 1.5
+        npt.assert_allclose(result[inside], len(points)/(10*10*4), rtol=0.2)
+        npt.assert_array_equal(result[np.abs(profile.getPositions()) > 2.5], 0)
+
+    def test_type_out_of_range(self):
+        points = np.zeros((2, 3), dtype=np.float32)
+        types = np.array([0, 2], dtype=np.uint32)
+        profile = density.DensityProfile(2, 10, 2)
+        with self.assertRaises(ValueError):
+            profile.compute(box.Box.cube(5.0), points, types)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,45 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density
+import unittest
+
+class TestFFTRDF(unittest.TestCase):
+    def test_generateR(self):
+        rmax = 51.23
+        dr = 0.1
+        nbins = int(rmax / dr);
+
+        # make sure the radius for each bin is generated correctly
+        r_list = np.zeros(nbins, dtype=np.float32)
+        for i in range(nbins):
+            r1 = i * dr
+            r2 = r1 + dr
+            r_list[i] = 2.0/3.0 * (r2**3.0 - r1**3.0) / (r2**2.0 - r1**2.0)
+
+        rdf = density.FFTRDF(rmax, dr, 8)
+
+        npt.assert_almost_equal(rdf.getR(), r_list, decimal=3)
+
+    def test_invalid_width(self):
+        with self.assertRaises(ValueError):
+            density.FFTRDF(5.0, 0.5, 100)
+
+    def test_matches_rdf(self):
+        rmax = 4.5
+        dr = 0.5
+        num_points = 2000
+        box_size = 10.0
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        fft_rdf = density.FFTRDF(rmax, dr, 64)
+        fft_rdf.compute(fbox, points, points)
+
+        # the pair distances are resolved to about a grid cell
+        npt.assert_allclose(fft_rdf.getRDF(), rdf.getRDF(), atol=0.05)
+        npt.assert_allclose(fft_rdf.getNr(), rdf.getNr(), rtol=0.05, atol=0.05)
+
+if __name__ == '__main__':
+    unittest.main()
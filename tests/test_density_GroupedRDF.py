@@ -0,0 +1,39 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density
+import unittest
+
+class TestGroupedRDF(unittest.TestCase):
+    def test_matches_rdf(self):
+        rmax = 2.0
+        dr = 0.1
+        num_points = 1000
+        num_groups = 3
+        box_size = rmax*4.5
+        np.random.seed(0)
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        ref_points = points[:600]
+        groups = np.random.randint(num_groups, size=600).astype(np.uint32)
+        fbox = box.Box.cube(box_size)
+
+        grouped = density.GroupedRDF(rmax, dr, num_groups)
+        grouped.compute(fbox, ref_points, groups, points)
+        self.assertEqual(grouped.getRDF().shape, (num_groups, int(rmax/dr)))
+        npt.assert_equal(grouped.getGroupCounts(), np.bincount(groups, minlength=num_groups))
+
+        # the rdf of each group is that of its reference points among all the points
+        rdf = density.RDF(rmax, dr)
+        for g in range(num_groups):
+            rdf.compute(fbox, ref_points[groups == g], points)
+            npt.assert_allclose(grouped.getRDF()[g], rdf.getRDF(), rtol=1e-5, atol=1e-6)
+            npt.assert_allclose(grouped.getNr()[g], rdf.getNr(), rtol=1e-5, atol=1e-6)
+
+    def test_group_out_of_range(self):
+        points = np.zeros((2,3), dtype=np.float32)
+        groups = np.array([0, 2], dtype=np.uint32)
+        grouped = density.GroupedRDF(1.0, 0.1, 2)
+        with self.assertRaises(ValueError):
+            grouped.compute(box.Box.cube(5.0), points, groups, points)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,40 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density
+import unittest
+
+class TestPartialRDF(unittest.TestCase):
+    def test_matches_rdf(self):
+        rmax = 2.0
+        dr = 0.1
+        num_points = 1000
+        num_types = 3
+        box_size = rmax*4.5
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        types = np.random.randint(num_types, size=num_points).astype(np.uint32)
+        fbox = box.Box.cube(box_size)
+
+        partial = density.PartialRDF(rmax, dr, num_types)
+        partial.compute(fbox, points, types)
+        self.assertEqual(partial.getRDF().shape, (num_types, num_types, int(rmax/dr)))
+
+        # each partial rdf is the rdf of the points of one type among those of another
+        rdf = density.RDF(rmax, dr)
+        for a in range(num_types):
+            for b in range(num_types):
+                if a == b:
+                    rdf.compute(fbox, points[types == a], points[types == a])
+                else:
+                    rdf.compute(fbox, points[types == a], points[types == b])
+                npt.assert_allclose(partial.getRDF()[a, b], rdf.getRDF(), rtol=1e-5, atol=1e-6)
+                npt.assert_allclose(partial.getNr()[a, b], rdf.getNr(), rtol=1e-5, atol=1e-6)
+
+    def test_type_out_of_range(self):
+        points = np.zeros((2,3), dtype=np.float32)
+        types = np.array([0, 2], dtype=np.uint32)
+        partial = density.PartialRDF(1.0, 0.1, 2)
+        with self.assertRaises(ValueError):
+            partial.compute(box.Box.cube(5.0), points, types)
+
+if __name__ == '__main__':
+    unittest.main()
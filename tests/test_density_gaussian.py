@@ -25,5 +25,131 @@ class TestDensity(unittest.TestCase):
         myDiff = fftshift(myDiff)[:,:]
         npt.assert_equal(np.where(myDiff==np.max(myDiff)), (np.array([50]), np.array([50])))
 
+    def test_fft_matches_direct(self):
+        width = 32
+        sigma = 0.8
+        rcut = 5*sigma
+        num_points = 2000
+        box_size = 10.0
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        testBox = box.Box.cube(box_size)
+
+        direct = density.GaussianDensity(width, rcut, sigma)
+        direct.compute(testBox, points)
+        mesh = density.GaussianDensity(width, rcut, sigma)
+        mesh.computeFFT(testBox, points)
+        expected = direct.getGaussianDensity()
+        npt.assert_allclose(mesh.getGaussianDensity(), expected, atol=0.01*np.max(expected))
+
+    def test_gpu(self):
+        width = 32
+        sigma = 0.8
+        rcut = 3*sigma
+        box_size = 10.0
+        np.random.seed(0)
+        points = np.random.random_sample((2000,3)).astype(np.float32)*box_size - box_size/2
+        testBox = box.Box.cube(box_size)
+
+        gpu = density.GaussianDensity(width, rcut, sigma)
+        try:
+            gpu.setUseGPU(True)
+        except RuntimeError:
+            self.skipTest("freud was built without CUDA or no device is available")
+        self.assertTrue(gpu.getUseGPU())
+        cpu = density.GaussianDensity(width, rcut, sigma)
+        cpu.compute(testBox, points)
+        gpu.compute(testBox, points)
+        expected = cpu.getGaussianDensity()
+        npt.assert_allclose(gpu.getGaussianDensity(), expected, rtol=1e-4, atol=1e-5*np.max(expected))
+        gpu.setUseGPU(False)
+        self.assertFalse(gpu.getUseGPU())
+
+    def test_fft_invalid_width(self):
+        diff = density.GaussianDensity(30, 2.0, 0.5)
+        points = np.zeros((1, 3), dtype=np.float32)
+        with self.assertRaises(ValueError):
+            diff.computeFFT(box.Box.cube(10.0), points)
+
+    def test_coarse_density(self):
+        width = 32
+        sigma = 0.5
+        points = np.random.random_sample((500, 3)).astype(np.float32)*10 - 5
+        diff = density.GaussianDensity(width, 4*sigma, sigma)
+        diff.compute(box.Box.cube(10.0), points)
+        fine = diff.getGaussianDensity()
+        # the pyramid of factors 2, 4 and 8 gives the block averages of the density
+        for factor in (2, 4, 8):
+            n = width//factor
+            expected = fine.reshape(n, factor, n, factor, n, factor).mean(axis=(1, 3, 5))
+            npt.assert_allclose(diff.getCoarseGaussianDensity(factor), expected, rtol=1e-5, atol=1e-6)
+        with self.assertRaises(ValueError):
+            diff.getCoarseGaussianDensity(3)
+
+    def test_projection(self):
+        width = 32
+        width_z = 250
+        sigma = 0.5
+        points = np.random.random_sample((200, 3)).astype(np.float32)*10 - 5
+        fbox = box.Box.cube(10.0)
+        diff = density.GaussianDensity(width, width, width_z, 5*sigma, sigma)
+        diff.compute(fbox, points)
+        planes = diff.getGaussianDensity()
+        dz = 10.0/width_z
+        z = -5 + dz*(np.arange(width_z) + 0.5)
+        # the projection is the integral along z that the sum of fine planes approaches
+        diff.computeProjection(fbox, points)
+        npt.assert_allclose(diff.getProjectedDensity(), planes.sum(axis=0)*dz, rtol=1e-3, atol=1e-3)
+        # a slab across the boundary of the box, on edges of the planes, integrates the images of the points
+        diff.computeProjection(fbox, points, (2.0, 7.0))
+        slab = (z >= 2.0) | (z < -3.0)
+        npt.assert_allclose(diff.getProjectedDensity(), planes[slab].sum(axis=0)*dz, rtol=1e-3, atol=1e-3)
+        # the 3D image is left as it is
+        npt.assert_array_equal(diff.getGaussianDensity(), planes)
+
+    def test_gather_matches_scatter(self):
+        sigma = 0.5
+        rcut = 3*sigma
+        for testBox, width in ((box.Box.cube(20.0), 48), (box.Box.square(20.0), 80)):
+            points = np.random.random_sample((40,3)).astype(np.float32)*20.0 - 10.0
+            if testBox.is2D():
+                points[:,2] = 0
+            scatter = density.GaussianDensity(width, rcut, sigma)
+            scatter.setSpreadMode('scatter')
+            scatter.compute(testBox, points)
+            self.assertFalse(scatter.getGathered())
+            gather = density.GaussianDensity(width, rcut, sigma)
+            gather.setSpreadMode('gather')
+            self.assertEqual(gather.getSpreadMode(), 'gather')
+            gather.compute(testBox, points)
+            self.assertTrue(gather.getGathered())
+            npt.assert_allclose(gather.getGaussianDensity(), scatter.getGaussianDensity(), rtol=1e-5, atol=1e-6)
+
+        # a tilted box cannot be gathered
+        gather = density.GaussianDensity(48, rcut, sigma)
+        gather.setSpreadMode('gather')
+        with self.assertRaises(ValueError):
+            gather.compute(box.Box(20.0, 20.0, 20.0, 0.2, 0, 0), points)
+        with self.assertRaises(RuntimeError):
+            gather.setSpreadMode('sideways')
+
+    def test_memory_limit(self):
+        points = np.random.random_sample((100,3)).astype(np.float32)*20.0 - 10.0
+        copied = density.GaussianDensity(32, 1.5, 0.5)
+        copied.setSpreadMode('scatter')
+        copied.compute(box.Box.cube(20.0), points)
+        self.assertEqual(copied.getMemoryUsage()['density'], 32**3*4)
+        self.assertGreaterEqual(copied.getMemoryUsage()['local_grids'], 32**3*4)
+        self.assertEqual(copied.estimateMemory(100, 8)['local_grids'], 8*32**3*4)
+
+        # a grid whose copies exceed the limit is spread onto tiles instead
+        tiled = density.GaussianDensity(32, 1.5, 0.5)
+        tiled.setSpreadMode('scatter')
+        tiled.setMemoryLimit(1000)
+        self.assertEqual(tiled.getMemoryLimit(), 1000)
+        tiled.compute(box.Box.cube(20.0), points)
+        self.assertEqual(tiled.getMemoryUsage()['local_grids'], 0)
+        self.assertEqual(tiled.estimateMemory(100, 8)['local_grids'], 0)
+        npt.assert_allclose(tiled.getGaussianDensity(), copied.getGaussianDensity(), rtol=1e-5, atol=1e-6)
+
 if __name__ == '__main__':
     unittest.main()
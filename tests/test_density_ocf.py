@@ -1,7 +1,7 @@
 import numpy
 import numpy as np
 import numpy.testing as npt
-from freud import box, density, parallel
+from freud import box, density, locality, parallel
 import unittest
 
 class TestR(unittest.TestCase):
@@ -89,6 +89,27 @@ class TestOCF(unittest.TestCase):
         npt.assert_allclose(ocf.getRDF(), correct, atol=absolute_tolerance)
 
 
+    def test_nlist(self):
+        rmax = 3.0
+        dr = 0.5
+        num_points = 2000
+        box_size = rmax*4
+        fbox = box.Box.cube(box_size)
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        ang = np.random.random_sample((num_points)).astype(np.float64)*np.pi*2.0
+        comp = np.cos(ang) + 1j * np.sin(ang)
+        conj = np.cos(ang) - 1j * np.sin(ang)
+        ocf = density.ComplexCF(rmax, dr)
+        ocf.compute(fbox, points, comp, points, conj)
+        counts = np.copy(ocf.getCounts())
+        rdf = np.copy(ocf.getRDF())
+
+        lc = locality.LinkCell(fbox, rmax)
+        lc.computeNlist(fbox, points, points)
+        ocf.compute(fbox, points, comp, points, conj, nlist=lc.getNlist())
+        npt.assert_equal(ocf.getCounts(), counts)
+        npt.assert_allclose(ocf.getRDF(), rdf, atol=1e-6)
+
 def test_summation():
     # Cause the correlation function to add lots of small numbers together
     # This leads to vastly different results with different numbers of threads if the summation is not done
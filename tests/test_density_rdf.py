@@ -1,6 +1,9 @@
+import itertools
 import numpy as np
 import numpy.testing as npt
-from freud import box, density
+import os
+import tempfile
+from freud import box, density, locality, parallel
 import unittest
 
 class TestR(unittest.TestCase):
@@ -35,5 +38,412 @@ class TestRDF(unittest.TestCase):
         absolute_tolerance = 0.1
         npt.assert_allclose(rdf.getRDF(), correct, atol=absolute_tolerance)
 
+    def test_self_matches_copy(self):
+        rmax = 3.0
+        dr = 0.25
+        num_points = 1000
+        box_size = rmax*2.5
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        # the same array takes the symmetric half stencil path, a copy takes the full one
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        half = np.copy(rdf.getRDF())
+        rdf.compute(fbox, points, np.copy(points))
+        npt.assert_allclose(half, rdf.getRDF(), rtol=1e-6)
+
+    def test_partition_modes(self):
+        rmax = 3.0
+        dr = 0.25
+        box_size = rmax*4
+        # a dense cluster in a dilute gas
+        points = np.random.random_sample((2000,3)).astype(np.float32)*box_size - box_size/2
+        points[:1000] *= 0.2
+        fbox = box.Box.cube(box_size)
+
+        results = []
+        for mode in ['auto', 'cost', 'affinity', 'pair_blocks']:
+            rdf = density.RDF(rmax, dr)
+            rdf.setPartitionMode(mode)
+            self.assertEqual(rdf.getPartitionMode(), mode)
+            for ref_points in [points, np.copy(points[::2])]:
+                rdf.accumulate(fbox, ref_points, points)
+                rdf.accumulate(fbox, ref_points, points)
+            results.append(np.copy(rdf.getRDF()))
+        npt.assert_allclose(results[1], results[0], rtol=1e-6)
+        npt.assert_allclose(results[2], results[0], rtol=1e-6)
+        npt.assert_allclose(results[3], results[0], rtol=1e-6)
+
+        with self.assertRaises(RuntimeError):
+            rdf.setPartitionMode('guided')
+
+    def test_frames_match_accumulate(self):
+        rmax = 3.0
+        dr = 0.25
+        num_frames = 5
+        num_points = 500
+        box_size = rmax*2.5
+        frames = np.random.random_sample((num_frames,num_points,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        rdf = density.RDF(rmax, dr)
+        for points in frames:
+            rdf.accumulate(fbox, points, points)
+        batched = density.RDF(rmax, dr)
+        batched.accumulateFrames([fbox]*num_frames, frames, frames)
+        npt.assert_allclose(batched.getRDF(), rdf.getRDF(), rtol=1e-6)
+        npt.assert_allclose(batched.getNr(), rdf.getNr(), rtol=1e-6)
+
+    def test_bin_edges(self):
+        rmax = 3.0
+        dr = 0.25
+        num_points = 1000
+        box_size = rmax*2.5
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        fine_counts = np.diff(np.concatenate([[0.0], rdf.getNr()]))
+
+        # coarse edges made of unions of the uniform bins count the sum of their pairs
+        edges = np.array([0.0, 0.25, 0.5, 1.0, 2.0, 3.0], dtype=np.float32)
+        coarse = density.RDF(bin_edges=edges)
+        coarse.compute(fbox, points, points)
+        npt.assert_allclose(coarse.getBinEdges(), edges)
+        npt.assert_equal(coarse.getRDF().shape[0], len(edges) - 1)
+        coarse_counts = np.diff(np.concatenate([[0.0], coarse.getNr()]))
+        bounds = np.rint(edges/dr).astype(np.int32)
+        for i in range(len(edges) - 1):
+            npt.assert_allclose(coarse_counts[i], np.sum(fine_counts[bounds[i]:bounds[i+1]]), rtol=1e-4, atol=1e-4)
+
+    def test_bin_edges_invalid(self):
+        with self.assertRaises(ValueError):
+            density.RDF(bin_edges=[0.0, 1.0, 0.5])
+
+    def test_out_arrays(self):
+        rmax = 3.0
+        dr = 0.25
+        box_size = rmax*2.5
+        points = np.random.random_sample((500,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        expected = np.copy(rdf.getRDF())
+        out = np.empty_like(expected)
+        self.assertIs(rdf.getRDF(out=out), out)
+        npt.assert_equal(out, expected)
+        with self.assertRaises(ValueError):
+            rdf.getRDF(out=np.empty(expected.shape[0] + 1, dtype=np.float32))
+        with self.assertRaises(ValueError):
+            rdf.getNr(out=np.empty(expected.shape, dtype=np.float64))
+
+        # views stay valid after the computation is gone
+        view = rdf.getRDF()
+        del rdf
+        npt.assert_equal(view, expected)
+
+    def test_soa_matches_accumulate(self):
+        rmax = 3.0
+        dr = 0.25
+        box_size = rmax*2.5
+        ref_points = np.random.random_sample((400,3)).astype(np.float32)*box_size - box_size/2
+        points = np.random.random_sample((1000,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+        soa = np.ascontiguousarray(points.T)
+
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        expected = np.copy(rdf.getRDF())
+        rdf.computeSoA(fbox, soa, soa)
+        npt.assert_allclose(rdf.getRDF(), expected, rtol=1e-6)
+
+        # separate coordinate arrays, such as those of a DCD file
+        rdf.compute(fbox, ref_points, points)
+        expected = np.copy(rdf.getRDF())
+        rdf.computeSoA(fbox, list(ref_points.T), (soa[0], soa[1], soa[2]))
+        npt.assert_allclose(rdf.getRDF(), expected, rtol=1e-6)
+        with self.assertRaises(TypeError):
+            rdf.computeSoA(fbox, points, points)
+
+    def test_checkpoint_resume(self):
+        rmax = 3.0
+        dr = 0.25
+        box_size = rmax*2.5
+        frames = np.random.random_sample((3,500,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        rdf = density.RDF(rmax, dr)
+        for points in frames:
+            rdf.accumulate(fbox, points, points)
+        expected = np.copy(rdf.getRDF())
+
+        # stop after the first frame, then resume from the checkpoint in a new computation
+        handle, filename = tempfile.mkstemp(suffix='.ckp')
+        os.close(handle)
+        try:
+            first = density.RDF(rmax, dr)
+            first.accumulate(fbox, frames[0], frames[0])
+            first.saveState(filename)
+            resumed = density.RDF(rmax, dr)
+            resumed.loadState(filename)
+            for points in frames[1:]:
+                resumed.accumulate(fbox, points, points)
+            npt.assert_allclose(resumed.getRDF(), expected, rtol=1e-6)
+            with self.assertRaises(ValueError):
+                density.RDF(rmax, 2*dr).loadState(filename)
+        finally:
+            os.remove(filename)
+
+    def test_merge(self):
+        rmax = 3.0
+        dr = 0.25
+        box_size = rmax*2.5
+        frames = np.random.random_sample((4,500,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        whole = density.RDF(rmax, dr)
+        for points in frames:
+            whole.accumulate(fbox, points, points)
+
+        # each half of the frames in its own computation, then added
+        halves = [density.RDF(rmax, dr), density.RDF(rmax, dr)]
+        for i, points in enumerate(frames):
+            halves[i//2].accumulate(fbox, points, points)
+        merged = density.RDF(rmax, dr)
+        merged += halves[0]
+        merged.merge(halves[1])
+        npt.assert_allclose(merged.getRDF(), whole.getRDF(), rtol=1e-6)
+        npt.assert_allclose(merged.getNr(), whole.getNr(), rtol=1e-6)
+        with self.assertRaises(ValueError):
+            merged.merge(density.RDF(rmax, 2*dr))
+        with self.assertRaises(TypeError):
+            merged.merge(density.FFTRDF(rmax, dr, 32))
+
+    def test_gpu(self):
+        rmax = 3.0
+        dr = 0.1
+        box_size = rmax*3.1
+        np.random.seed(0)
+        points = np.random.random_sample((2000,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+
+        gpu = density.RDF(rmax, dr)
+        try:
+            gpu.setUseGPU(True)
+        except RuntimeError:
+            self.skipTest("freud was built without CUDA or no device is available")
+        self.assertTrue(gpu.getUseGPU())
+        cpu = density.RDF(rmax, dr)
+        cpu.accumulate(fbox, points, points)
+        gpu.accumulate(fbox, points, points)
+        # counts may only move between bins for pairs within rounding of an edge
+        npt.assert_allclose(gpu.getNr(), cpu.getNr(), atol=1e-2)
+        gpu.setUseGPU(False)
+        self.assertFalse(gpu.getUseGPU())
+
+    def test_profiling(self):
+        rmax = 2.0
+        box_size = rmax*3.1
+        np.random.seed(0)
+        points = np.random.random_sample((500,3)).astype(np.float32)*box_size - box_size/2
+        fbox = box.Box.cube(box_size)
+        rdf = density.RDF(rmax, 0.1)
+        rdf.accumulate(fbox, points[:100], points)
+        rdf.getRDF()
+        if not parallel.isProfilingEnabled():
+            self.assertEqual(rdf.getTimings(), {})
+            self.assertEqual(rdf.getStats(), {})
+            return
+        timings = rdf.getTimings()
+        for phase in ['cell_list', 'pairs', 'reduce']:
+            self.assertGreaterEqual(timings[phase], 0)
+        stats = rdf.getStats()
+        delta = points[np.newaxis, :, :] - points[:100, np.newaxis, :]
+        delta -= box_size*np.round(delta/box_size)
+        self.assertEqual(stats['pairs_accepted'], np.sum(np.sum(delta**2, axis=2) < rmax**2))
+        self.assertGreaterEqual(stats['pairs_tested'], stats['pairs_accepted'])
+
+    def test_rmax_larger_than_half_box(self):
+        rmax = 3.0
+        dr = 0.25
+        num_points = 50
+        box_size = rmax*1.2
+        np.random.seed(0)
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        rdf = density.RDF(rmax, dr)
+        rdf.accumulate(box.Box.cube(box_size), points, points)
+
+        # the same pairs found with the points tiled in a box three times larger
+        shifts = np.array(list(itertools.product([-1, 0, 1], repeat=3)), dtype=np.float32)*box_size
+        tiled = (points[np.newaxis, :, :] + shifts[:, np.newaxis, :]).reshape(-1, 3)
+        tiled_rdf = density.RDF(rmax, dr)
+        tiled_rdf.accumulate(box.Box.cube(3*box_size), points, tiled)
+        npt.assert_allclose(rdf.getRDF(), tiled_rdf.getRDF(), rtol=1e-5)
+
+        batched = density.RDF(rmax, dr)
+        batched.accumulateFrames([box.Box.cube(box_size)], points[np.newaxis], points[np.newaxis])
+        npt.assert_allclose(batched.getRDF(), rdf.getRDF(), rtol=1e-6)
+
+    def test_point_histograms(self):
+        rmax = 2.0
+        dr = 0.25
+        box_size = 10.0
+        np.random.seed(0)
+        points = np.random.uniform(-box_size/2, box_size/2, (500, 3)).astype(np.float32)
+        ref_points = points[:100].copy()
+        fbox = box.Box.cube(box_size)
+        nbins = int(rmax/dr)
+
+        def brute_force(refs):
+            delta = points[np.newaxis, :, :] - refs[:, np.newaxis, :]
+            delta -= box_size*np.round(delta/box_size)
+            r = np.linalg.norm(delta, axis=2)
+            counts = np.zeros((len(refs), nbins), dtype=np.uint32)
+            for i in range(len(refs)):
+                counts[i] = np.histogram(r[i][r[i] < rmax], bins=nbins, range=(0, rmax))[0]
+            return counts
+
+        rdf = density.RDF(rmax, dr)
+        with self.assertRaises(ValueError):
+            rdf.getPointCounts()
+        rdf.setPointHistograms(True)
+        self.assertTrue(rdf.getPointHistograms())
+        rdf.compute(fbox, points, points)
+        counts = rdf.getPointCounts()
+        self.assertEqual(counts.shape, (len(points), nbins))
+        self.assertEqual(counts.dtype, np.uint32)
+        npt.assert_allclose(counts, brute_force(points), atol=1)
+        # the rdf is the same as without the histograms of the points
+        expected = density.RDF(rmax, dr)
+        expected.compute(fbox, points, points)
+        npt.assert_allclose(rdf.getRDF(), expected.getRDF(), rtol=1e-6)
+
+        rdf.setPointHistograms(True, compact=True)
+        rdf.compute(fbox, ref_points, points)
+        counts = rdf.getPointCounts()
+        self.assertEqual(counts.dtype, np.uint16)
+        npt.assert_allclose(counts, brute_force(ref_points), atol=1)
+
+        with self.assertRaises(ValueError):
+            rdf.accumulateFrames(fbox, points[np.newaxis], points[np.newaxis])
+
+    def test_kernel_smoothing(self):
+        rmax = 3.0
+        dr = 0.05
+        box_size = 12.0
+        np.random.seed(0)
+        points = np.random.uniform(-box_size/2, box_size/2, (4000, 3)).astype(np.float32)
+        fbox = box.Box.cube(box_size)
+
+        binned = density.RDF(rmax, dr)
+        binned.compute(fbox, points, points)
+        smooth = density.RDF(rmax, dr)
+        smooth.setKernelWidth(0.1)
+        self.assertAlmostEqual(smooth.getKernelWidth(), 0.1, places=6)
+        smooth.compute(fbox, points, points)
+        # away from r = 0 and rmax, the smoothed rdf of an ideal gas is as close to 1 with less noise
+        interior = slice(20, -10)
+        npt.assert_allclose(np.mean(smooth.getRDF()[interior]), 1, atol=0.01)
+        self.assertLess(np.std(smooth.getRDF()[interior]), np.std(binned.getRDF()[interior]))
+        npt.assert_allclose(smooth.getNr()[interior], binned.getNr()[interior], rtol=0.01)
+
+        with self.assertRaises(ValueError):
+            smooth.setKernelWidth(-1)
+        with self.assertRaises(ValueError):
+            density.RDF(bin_edges=[0, 0.5, 2]).setKernelWidth(0.1)
+
+    def test_weights(self):
+        rmax = 3.0
+        dr = 0.1
+        box_size = 12.0
+        np.random.seed(0)
+        points = np.random.uniform(-box_size/2, box_size/2, (2000, 3)).astype(np.float32)
+        ref_points = points[:500].copy()
+        fbox = box.Box.cube(box_size)
+
+        # weights of 1 give the rdf, for the symmetric pair loop and the full one
+        ones = np.ones(len(points), dtype=np.float32)
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points, ref_weights=ones, weights=ones)
+        npt.assert_allclose(rdf.getWeightedRDF(), rdf.getRDF(), rtol=1e-5, atol=1e-6)
+        rdf.compute(fbox, ref_points, points, ref_weights=ones[:500], weights=ones)
+        npt.assert_allclose(rdf.getWeightedRDF(), rdf.getRDF(), rtol=1e-5, atol=1e-6)
+
+        # charges: the sum of the products of the charges of the pairs of each bin
+        charges = np.where(np.arange(len(points)) % 2 == 0, 1, -1).astype(np.float32)
+        rdf.compute(fbox, points, points, ref_weights=charges, weights=charges)
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta -= box_size * np.round(delta / box_size)
+        r = np.linalg.norm(delta, axis=-1)
+        products = charges[:, np.newaxis] * charges[np.newaxis, :]
+        within = r < rmax
+        sums = np.histogram(r[within], bins=rdf.getBinEdges(), weights=products[within])[0]
+        volumes = 4.0 / 3.0 * np.pi * np.diff(rdf.getBinEdges().astype(np.float64)**3)
+        expected = sums / len(points) / volumes / (len(points) / fbox.getVolume())
+        npt.assert_allclose(rdf.getWeightedRDF()[1:], expected[1:], atol=1e-4)
+
+        # unweighted frames add nothing, a reset forgets the weights and checkpoints do not keep them
+        rdf.accumulate(fbox, points, points)
+        npt.assert_allclose(rdf.getWeightedRDF()[1:], expected[1:] / 2, atol=1e-4)
+        with self.assertRaises(ValueError):
+            rdf.saveState(os.path.join(tempfile.mkdtemp(), 'rdf.chk'))
+        rdf.compute(fbox, points, points)
+        npt.assert_equal(rdf.getWeightedRDF(), 0)
+        with self.assertRaises(ValueError):
+            rdf.compute(fbox, points, points, weights=ones)
+        with self.assertRaises(ValueError):
+            rdf.compute(fbox, points, points, ref_weights=ones[:10], weights=ones)
+
+    def test_shared_link_cell(self):
+        rmax = 3.0
+        dr = 0.25
+        num_points = 1000
+        box_size = rmax*3.5
+        fbox = box.Box.cube(box_size)
+        lc = locality.LinkCell(fbox, rmax)
+        rdf = density.RDF(rmax, dr)
+        shared_rdf = density.RDF(rmax, dr)
+        shared_rdf.setLinkCell(lc)
+        ld = density.LocalDensity(rmax - 1.0, 1.0, 1.0)
+        shared_ld = density.LocalDensity(rmax - 1.0, 1.0, 1.0)
+        shared_ld.setLinkCell(lc)
+
+        # a new frame is detected even when it has the same number of points
+        for frame in range(3):
+            points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+            rdf.compute(fbox, points, points)
+            shared_rdf.compute(fbox, points, points)
+            npt.assert_allclose(shared_rdf.getRDF(), rdf.getRDF(), rtol=1e-6)
+            ld.compute(fbox, points, points)
+            shared_ld.compute(fbox, points, points)
+            npt.assert_allclose(shared_ld.getDensity(), ld.getDensity(), rtol=1e-5)
+
+        shared_rdf.setLinkCell(None)
+        shared_rdf.compute(fbox, points, points)
+        npt.assert_allclose(shared_rdf.getRDF(), rdf.getRDF(), rtol=1e-6)
+        with self.assertRaises(ValueError):
+            shared_rdf.setLinkCell(locality.LinkCell(fbox, rmax/2))
+
+    def test_memory_usage(self):
+        rmax = 3.0
+        dr = 0.1
+        fbox = box.Box.cube(20.0)
+        points = np.random.random_sample((1000,3)).astype(np.float32)*20.0 - 10.0
+        rdf = density.RDF(rmax, dr)
+        nbins = int(rmax/dr)
+        estimate = rdf.estimateMemory(1000, 4)
+        self.assertEqual(estimate['local_histograms'], 4*nbins*4)
+        self.assertEqual(estimate['cell_list'], 1000*(8 + 12))
+        rdf.accumulate(fbox, points, points)
+        usage = rdf.getMemoryUsage()
+        self.assertEqual(set(usage), set(['histogram', 'local_histograms', 'point_histograms', 'cell_list',
+                                          'points']))
+        self.assertGreater(usage['local_histograms'], 0)
+        self.assertGreaterEqual(usage['cell_list'], estimate['cell_list'])
+        self.assertEqual(usage['point_histograms'], 0)
+
 if __name__ == '__main__':
     unittest.main()
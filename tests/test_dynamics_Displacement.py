@@ -0,0 +1,45 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, dynamics
+import unittest
+
+class TestDisplacement(unittest.TestCase):
+    def test_unwrap(self):
+        L = 4.0
+        fbox = box.Box.cube(L)
+        num_frames = 50
+        np.random.seed(0)
+        steps = np.random.normal(scale=0.3, size=(num_frames, 20, 3))
+        unwrapped = np.cumsum(steps, axis=0).astype(np.float32)
+        wrapped = (unwrapped - L*np.floor(unwrapped/L + 0.5)).astype(np.float32)
+
+        displacement = dynamics.Displacement()
+        for frame in range(num_frames):
+            displacement.update(fbox, wrapped[frame])
+            if frame == 0:
+                npt.assert_array_equal(displacement.getImages(), 0)
+                continue
+            delta = unwrapped[frame].astype(np.float64) - unwrapped[frame - 1]
+            npt.assert_allclose(displacement.getDisplacements(), delta, atol=1e-4)
+            self.assertAlmostEqual(displacement.getMaxDisplacement(), np.max(np.linalg.norm(delta, axis=1)),
+                                   places=4)
+        self.assertEqual(displacement.getFrameCounter(), num_frames)
+        # the image flags unwrap the last frame continuously from the first one
+        positions = np.copy(wrapped[-1])
+        fbox.unwrap(positions, displacement.getImages().astype(np.int32))
+        npt.assert_allclose(positions - wrapped[0], unwrapped[-1] - unwrapped[0], atol=1e-4)
+
+    def test_restart(self):
+        fbox = box.Box.cube(5.0)
+        displacement = dynamics.Displacement()
+        displacement.update(fbox, np.zeros((3, 3), dtype=np.float32))
+        displacement.update(fbox, np.full((3, 3), 2.4, dtype=np.float32))
+        self.assertEqual(displacement.getFrameCounter(), 2)
+        # a frame of another number of particles starts the stream again
+        displacement.update(fbox, np.zeros((4, 3), dtype=np.float32))
+        self.assertEqual(displacement.getFrameCounter(), 1)
+        self.assertEqual(displacement.getMaxDisplacement(), 0)
+        npt.assert_array_equal(displacement.getDisplacements(), np.zeros((4, 3)))
+
+if __name__ == '__main__':
+    unittest.main()
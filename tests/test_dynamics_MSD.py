@@ -0,0 +1,40 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, dynamics
+import unittest
+
+class TestMSD(unittest.TestCase):
+    def test_random_walk(self):
+        num_frames = 100
+        num_particles = 10
+        steps = np.random.normal(scale=0.5, size=(num_frames, num_particles, 3))
+        positions = np.cumsum(steps, axis=0).astype(np.float32)
+
+        msd = dynamics.MSD()
+        msd.compute(box.Box.cube(1000), positions)
+        result = msd.getMSD()
+        self.assertEqual(len(result), num_frames)
+
+        expected = np.zeros(num_frames)
+        for lag in range(1, num_frames):
+            delta = positions[lag:].astype(np.float64) - positions[:-lag]
+            expected[lag] = np.mean(np.sum(delta**2, axis=2))
+        npt.assert_allclose(result, expected, rtol=1e-5, atol=1e-5)
+
+    def test_images(self):
+        L = 4.0
+        fbox = box.Box.cube(L)
+        num_frames = 50
+        steps = np.random.normal(scale=0.5, size=(num_frames, 5, 3))
+        unwrapped = np.cumsum(steps, axis=0).astype(np.float32)
+        images = np.floor(unwrapped / L + 0.5).astype(np.int32)
+        wrapped = (unwrapped - L*images).astype(np.float32)
+
+        msd = dynamics.MSD()
+        msd.compute(fbox, unwrapped)
+        expected = np.copy(msd.getMSD())
+        msd.compute(fbox, wrapped, images)
+        npt.assert_allclose(msd.getMSD(), expected, rtol=1e-4, atol=1e-4)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,48 @@
+import numpy as np
+import numpy.testing as npt
+from freud import dynamics
+import unittest
+
+class TestMultipleTau(unittest.TestCase):
+    def test_short_lags(self):
+        num_frames = 200
+        num_values = 10
+        traj = np.random.random_sample((num_frames, num_values, 3)).astype(np.float32)
+        corr = dynamics.MultipleTau(num_values, 3, block_size=8, averaging=2)
+        for frame in traj:
+            corr.accumulate(frame)
+        self.assertEqual(corr.getFrameCounter(), num_frames)
+
+        lags = corr.getLags()
+        npt.assert_equal(lags[:8], np.arange(8))
+        npt.assert_equal(np.diff(lags.astype(np.int64)) > 0, True)
+        # the lags of the first level are correlated exactly, over all time origins
+        for i in range(8):
+            lag = lags[i]
+            expected = np.mean(np.sum(traj[:num_frames-lag]*traj[lag:], axis=2))
+            npt.assert_allclose(corr.getCorrelation()[i], expected, rtol=1e-5)
+            self.assertEqual(corr.getCounts()[i], num_frames - lag)
+
+    def test_constant(self):
+        corr = dynamics.MultipleTau(4)
+        values = np.array([1, 2, 3, 4], dtype=np.float32)
+        for i in range(1000):
+            corr.accumulate(values)
+        self.assertTrue(corr.getLags()[-1] > 500)
+        npt.assert_allclose(corr.getCorrelation(), np.mean(values**2), rtol=1e-5)
+
+        corr.reset()
+        self.assertEqual(corr.getFrameCounter(), 0)
+        self.assertEqual(len(corr.getLags()), 0)
+
+    def test_invalid(self):
+        with self.assertRaises(ValueError):
+            dynamics.MultipleTau(4, block_size=15, averaging=2)
+        corr = dynamics.MultipleTau(4, 3)
+        with self.assertRaises(ValueError):
+            corr.accumulate(np.zeros((5, 3), dtype=np.float32))
+        with self.assertRaises(ValueError):
+            corr.accumulate(np.zeros((4, 2), dtype=np.float32))
+
+if __name__ == '__main__':
+    unittest.main()
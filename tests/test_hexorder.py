@@ -72,5 +72,73 @@ class TestHexOrderParameter(unittest.TestCase):
         hop.compute(box, points)
         npt.assert_almost_equal(hop.getPsi()[0], 1. + 0.j, decimal=1)
 
+    def test_compute_k(self):
+        boxlen = 10
+        rmax = 3
+
+        box = freud.box.Box.square(boxlen)
+
+        # a hexagon rotated away from the x axis
+        angles = np.arange(6) * 2.0 * np.pi / 6.0 + 0.3
+        points = [[0.0, 0.0, 0.0]]
+        for angle in angles:
+            points.append([np.cos(angle), np.sin(angle), 0.0])
+        points = np.asarray(points, dtype=np.float32)
+
+        # integer k take the powers of the bonds, the others atan2
+        for k in [3, 4, 12, 7, 2.5]:
+            hop = freud.order.HexOrderParameter(rmax, k, 6)
+            hop.compute(box, points)
+            expected = np.sum(np.exp(1j * k * angles)) / k
+            npt.assert_allclose(hop.getPsi()[0], expected, atol=1e-5)
+
+class TestHexTransOrderParameter(unittest.TestCase):
+    def test_getK(self):
+        hop = freud.order.HexTransOrderParameter(3, [4, 6])
+        self.assertEqual(hop.getK(), [4, 6])
+        self.assertEqual(hop.getNumNeighbors(), 6)
+
+    def test_compute_hexagon(self):
+        boxlen = 10
+        rmax = 3
+
+        box = freud.box.Box.square(boxlen)
+
+        points = [[0.0, 0.0, 0.0]]
+
+        for i in range(6):
+            points.append([np.cos(float(i) * 2.0 * np.pi / 6.0),
+                           np.sin(float(i) * 2.0 * np.pi / 6.0),
+                           0.0])
+
+        points = np.asarray(points, dtype=np.float32)
+        hop = freud.order.HexTransOrderParameter(rmax, [4, 6], 6)
+        hop.compute(box, points)
+        npt.assert_equal(hop.getPsi().shape, (7, 2))
+        npt.assert_almost_equal(hop.getPsi()[0, 1], 1. + 0.j, decimal=5)
+        npt.assert_almost_equal(hop.getPsi()[0, 0], 0. + 0.j, decimal=5)
+        npt.assert_almost_equal(hop.getDr()[0], 0. + 0.j, decimal=5)
+
+    def test_compare_separate(self):
+        boxlen = 10
+        N = 500
+        rmax = 3
+
+        box = freud.box.Box.square(boxlen)
+
+        np.random.seed(0)
+        points = np.asarray(np.random.uniform(-boxlen/2, boxlen/2, (N, 3)),
+                            dtype=np.float32)
+        points[:,2] = 0.0
+        hop = freud.order.HexTransOrderParameter(rmax, [4, 6], 6)
+        hop.compute(box, points)
+        for (col, k) in enumerate([4, 6]):
+            single = freud.order.HexOrderParameter(rmax, k, 6)
+            single.compute(box, points)
+            npt.assert_allclose(hop.getPsi()[:, col], single.getPsi(), atol=1e-5)
+        trans = freud.order.TransOrderParameter(rmax, 6, 6)
+        trans.compute(box, points)
+        npt.assert_allclose(hop.getDr(), trans.getDr(), atol=1e-5)
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,62 @@
+from freud import box, interface, split
+import numpy as np
+import numpy.testing as npt
+import unittest
+
+class TestInterfaceMeasure(unittest.TestCase):
+    def test_mask(self):
+        fbox = box.Box.cube(10)
+        ref_points = np.array([[0, 0, 0], [2, 0, 0], [4, 0, 0]], dtype=np.float32)
+        points = np.array([[0.5, 0, 0], [-4, -4, -4]], dtype=np.float32)
+        im = interface.InterfaceMeasure(fbox, 1.0)
+        self.assertEqual(im.compute(ref_points, points), 1)
+        npt.assert_equal(im.getInterfaceMask(), [True, False, False])
+
+        # across the periodic boundary
+        points = np.array([[-4.8, 0, 0]], dtype=np.float32)
+        self.assertEqual(im.compute(ref_points, points), 1)
+        npt.assert_equal(im.getInterfaceMask(), [False, False, True])
+
+    def test_types(self):
+        fbox = box.Box.cube(10)
+        np.random.seed(0)
+        points = np.random.uniform(-5, 5, size=(200, 3)).astype(np.float32)
+        types = np.random.randint(0, 3, size=200).astype(np.uint32)
+        im = interface.InterfaceMeasure(fbox, 1.0)
+        im.computeTypes(points, types)
+        mask = np.copy(im.getTypeMask())
+        counts = np.copy(im.getTypeCounts())
+
+        # the same as measuring each pair of types on its own
+        for a in range(3):
+            for b in range(3):
+                if a == b:
+                    continue
+                self.assertEqual(im.compute(points[types == a], points[types == b]), counts[a, b])
+                npt.assert_equal(im.getInterfaceMask(), mask[types == a, b])
+
+    def test_shapes(self):
+        fbox = box.Box.cube(20)
+        np.random.seed(1)
+        ref_points = np.random.uniform(-10, 10, size=(100, 3)).astype(np.float32)
+        points = np.random.uniform(-10, 10, size=(150, 3)).astype(np.float32)
+        def random_orientations(n):
+            q = np.random.normal(size=(n, 4))
+            return (q/np.linalg.norm(q, axis=1)[:, np.newaxis]).astype(np.float32)
+        ref_orientations = random_orientations(100)
+        orientations = random_orientations(150)
+        split_points = np.array([[0.5, 0, 0], [-0.5, 0, 0], [0, 0.3, 0.2]], dtype=np.float32)
+        im = interface.InterfaceMeasure(fbox, 1.0)
+        count = im.computeShapes(ref_points, ref_orientations, points, orientations, split_points)
+        mask = np.copy(im.getInterfaceMask())
+        self.assertEqual(mask.shape, (300,))
+
+        # the same as measuring the interface of the split points
+        ss = split.ShapeSplit(fbox)
+        ref_split = ss.compute(ref_points, ref_orientations, split_points, out=np.empty((100, 3, 3), dtype=np.float32))
+        other_split = ss.compute(points, orientations, split_points, out=np.empty((150, 3, 3), dtype=np.float32))
+        self.assertEqual(im.compute(ref_split.reshape(-1, 3), other_split.reshape(-1, 3)), count)
+        npt.assert_equal(im.getInterfaceMask(), mask)
+
+if __name__ == '__main__':
+    unittest.main()
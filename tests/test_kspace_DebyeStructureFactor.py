@@ -0,0 +1,62 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, kspace, locality
+import unittest
+
+class TestDebyeStructureFactor(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+        self.box = box.Box.cube(12.0)
+        grid = np.arange(12) - 6.0
+        lattice = np.array(np.meshgrid(grid, grid, grid)).reshape(3, -1).T
+        points = lattice + np.random.normal(scale=0.2, size=lattice.shape)
+        self.points = (points - 12.0*np.round(points/12.0)).astype(np.float32)
+
+    def test_grid_average(self):
+        debye = kspace.DebyeStructureFactor(5.9, 0.01, 5.0, 9, q_min=1.0)
+        debye.compute(self.box, self.points)
+        q = debye.getQ()
+        npt.assert_allclose(q, np.linspace(1.0, 5.0, 9), rtol=1e-6)
+
+        # compare with the 3D structure factor averaged over the lattice vectors within half a shell of each q
+        g = 12
+        sf = kspace.StructureFactor(g)
+        sf.computeDirect(self.box, self.points)
+        S_grid = sf.getS()*len(self.points)
+        h = np.arange(-g, g+1)
+        q_grid = 2*np.pi/12.0*np.sqrt(h[:,None,None]**2 + h[None,:,None]**2 + h[None,None,:]**2)
+        for qi, Si in zip(q, debye.getS()):
+            shell = np.abs(q_grid - qi) < 0.5*2*np.pi/12.0
+            self.assertAlmostEqual(Si, np.mean(S_grid[shell]), delta=0.06)
+
+    def test_accumulate(self):
+        debye = kspace.DebyeStructureFactor(5.0, 0.05, 8.0, 20)
+        debye.accumulate(self.box, self.points)
+        debye.accumulate(self.box, self.points)
+        accumulated = np.copy(debye.getS())
+        debye.compute(self.box, self.points)
+        npt.assert_allclose(debye.getS(), accumulated, rtol=1e-4, atol=1e-4)
+
+        lc = locality.LinkCell(self.box, 5.0)
+        lc.computeNlist(self.box, self.points, self.points)
+        nlist_debye = kspace.DebyeStructureFactor(5.0, 0.05, 8.0, 20)
+        nlist_debye.compute(self.box, self.points, nlist=lc.getNlist())
+        npt.assert_allclose(nlist_debye.getS(), accumulated, rtol=1e-4, atol=1e-4)
+
+    def test_from_rdf(self):
+        # the fast transform of the RDF gives the sums of DebyeStructureFactor on its own q grid
+        q, S = kspace.structureFactorFromRDF(np.ones(100), 5.0, 1.0)
+        self.assertEqual(len(q), 129)
+        npt.assert_allclose(S, 1.0, atol=1e-6)
+
+        debye = kspace.DebyeStructureFactor(5.0, 0.05, 8.0, 20)
+        debye.compute(self.box, self.points)
+        density = len(self.points)/self.box.getVolume()
+        q, S = kspace.structureFactorFromRDF(debye.getRDF(), 5.0, density)
+        npt.assert_allclose(q[1], 2*np.pi/(256*0.05), rtol=1e-5)
+        grid_debye = kspace.DebyeStructureFactor(5.0, 0.05, q[40], 41)
+        grid_debye.compute(self.box, self.points)
+        npt.assert_allclose(S[:41], grid_debye.getS(), rtol=1e-4, atol=1e-4)
+
+if __name__ == '__main__':
+    unittest.main()
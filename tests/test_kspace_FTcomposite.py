@@ -0,0 +1,80 @@
+import numpy as np
+import numpy.testing as npt
+from freud import kspace
+import unittest
+
+def make_cube():
+    verts = np.array([[(i & 1) - 0.5, ((i >> 1) & 1) - 0.5, ((i >> 2) & 1) - 0.5] for i in range(8)],
+                     dtype=np.float32)
+    facets = np.array([0, 2, 3, 1, 4, 5, 7, 6, 0, 1, 5, 4, 2, 6, 7, 3, 0, 4, 6, 2, 1, 3, 7, 5], dtype=np.uint32)
+    facet_offs = np.arange(0, 25, 4, dtype=np.uint32)
+    norms = np.array([[0, 0, -1], [0, 0, 1], [0, -1, 0], [0, 1, 0], [-1, 0, 0], [1, 0, 0]], dtype=np.float32)
+    d = np.full(6, 0.5, dtype=np.float32)
+    area = np.ones(6, dtype=np.float32)
+    ft = kspace._FTpolyhedron()
+    ft.set_params(verts, facet_offs, facets, norms, d, area, 1.0)
+    return ft
+
+class TestFTcomposite(unittest.TestCase):
+    def test_sum(self):
+        np.random.seed(0)
+        K = (np.random.random_sample((100, 3))*6 - 3).astype(np.float32)
+        types = [kspace._FTdelta(), kspace._FTsphere(), make_cube()]
+        types[1].set_radius(0.4)
+        types[2].set_density(0.5 - 0.2j)
+        weights = [1.0, 2.0, 0.5]
+        expected = np.zeros(len(K), dtype=np.complex128)
+        composite = kspace._FTcomposite()
+        for ft, weight in zip(types, weights):
+            num_points = np.random.randint(10, 50)
+            positions = (np.random.random_sample((num_points, 3))*10 - 5).astype(np.float32)
+            angles = np.random.random_sample(num_points)*np.pi
+            orientations = np.zeros((num_points, 4), dtype=np.float32)
+            orientations[:, 0] = np.cos(angles)
+            orientations[:, 3] = np.sin(angles)
+            ft.set_K(K)
+            ft.set_rq(positions, orientations)
+            ft.compute()
+            expected += weight*ft.getFT()
+            composite.add(ft, weight)
+        self.assertEqual(composite.getNumTypes(), 3)
+        composite.compute()
+        npt.assert_allclose(composite.getFT(), expected, rtol=1e-4, atol=1e-3)
+
+    def test_num_K(self):
+        a = kspace._FTdelta()
+        a.set_K(np.zeros((3, 3), dtype=np.float32))
+        b = kspace._FTdelta()
+        b.set_K(np.zeros((4, 3), dtype=np.float32))
+        composite = kspace._FTcomposite()
+        composite.add(a)
+        composite.add(b)
+        self.assertRaises(ValueError, composite.compute)
+
+    def test_gpu(self):
+        np.random.seed(0)
+        K = (np.random.random_sample((500, 3))*6 - 3).astype(np.float32)
+        positions = (np.random.random_sample((1000, 3))*10 - 5).astype(np.float32)
+        orientations = np.zeros((1000, 4), dtype=np.float32)
+        orientations[:, 0] = 1
+        fts = []
+        for use_gpu in [False, True]:
+            ft = kspace._FTsphere()
+            if use_gpu:
+                try:
+                    ft.setUseGPU(True)
+                except RuntimeError:
+                    self.skipTest("freud was built without CUDA or no device is available")
+                self.assertTrue(ft.getUseGPU())
+            ft.set_radius(0.4)
+            ft.set_K(K)
+            ft.set_rq(positions, orientations)
+            ft.compute()
+            fts.append(ft)
+        # the phases are summed in a different order
+        npt.assert_allclose(fts[1].getFT(), fts[0].getFT(), rtol=1e-4, atol=1e-2)
+        fts[1].setUseGPU(False)
+        self.assertFalse(fts[1].getUseGPU())
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,50 @@
+import numpy as np
+import numpy.testing as npt
+from freud import kspace
+import unittest
+
+class TestFTdelta(unittest.TestCase):
+    def test_nufft(self):
+        np.random.seed(0)
+        K = (np.random.random_sample((300, 3))*8 - 2).astype(np.float32)
+        positions = (np.random.random_sample((2000, 3))*10 - 5).astype(np.float32)
+        orientations = np.zeros((2000, 4), dtype=np.float32)
+        orientations[:, 0] = 1
+        for ft in (kspace._FTdelta(), kspace._FTsphere()):
+            ft.set_K(K)
+            ft.set_rq(positions, orientations)
+            ft.compute()
+            direct = ft.getFT().copy()
+            self.assertEqual(ft.getNUFFTTolerance(), 0)
+            ft.setNUFFTTolerance(1e-5)
+            self.assertAlmostEqual(ft.getNUFFTTolerance(), 1e-5)
+            ft.compute()
+            # the form factor of the spheres is below 1
+            npt.assert_allclose(ft.getFT(), direct, atol=1e-5*len(positions))
+
+    def test_nufft_2d(self):
+        np.random.seed(1)
+        K = (np.random.random_sample((200, 3))*6 - 3).astype(np.float32)
+        positions = (np.random.random_sample((500, 3))*10 - 5).astype(np.float32)
+        positions[:, 2] = 0
+        orientations = np.zeros((500, 4), dtype=np.float32)
+        orientations[:, 0] = 1
+        ft = kspace._FTdelta()
+        ft.set_K(K)
+        ft.set_rq(positions, orientations)
+        ft.compute()
+        direct = ft.getFT().copy()
+        ft.setNUFFTTolerance(1e-4)
+        ft.compute()
+        npt.assert_allclose(ft.getFT(), direct, atol=1e-4*len(positions))
+
+    def test_nufft_tolerance(self):
+        ft = kspace._FTdelta()
+        with self.assertRaises(ValueError):
+            ft.setNUFFTTolerance(0.5)
+        ft.setNUFFTTolerance(1e-3)
+        ft.setNUFFTTolerance(0)
+        self.assertEqual(ft.getNUFFTTolerance(), 0)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,94 @@
+import numpy as np
+import numpy.testing as npt
+from freud import kspace
+import unittest
+
+def make_cube():
+    verts = np.array([[(i & 1) - 0.5, ((i >> 1) & 1) - 0.5, ((i >> 2) & 1) - 0.5] for i in range(8)],
+                     dtype=np.float32)
+    facets = np.array([0, 2, 3, 1, 4, 5, 7, 6, 0, 1, 5, 4, 2, 6, 7, 3, 0, 4, 6, 2, 1, 3, 7, 5], dtype=np.uint32)
+    facet_offs = np.arange(0, 25, 4, dtype=np.uint32)
+    norms = np.array([[0, 0, -1], [0, 0, 1], [0, -1, 0], [0, 1, 0], [-1, 0, 0], [1, 0, 0]], dtype=np.float32)
+    d = np.full(6, 0.5, dtype=np.float32)
+    area = np.ones(6, dtype=np.float32)
+    ft = kspace._FTpolyhedron()
+    ft.set_params(verts, facet_offs, facets, norms, d, area, 1.0)
+    return ft
+
+class TestFTpolyhedron(unittest.TestCase):
+    def test_orientation_groups(self):
+        num_points = 40
+        K = (np.random.random_sample((50, 3))*6 - 3).astype(np.float32)
+        positions = (np.random.random_sample((num_points, 3))*10 - 5).astype(np.float32)
+        q = np.array([np.cos(0.3), np.sin(0.3), 0, 0], dtype=np.float32)
+        orientations = np.tile(q, (num_points, 1))
+        # -q is the same rotation as q
+        orientations[::2] *= -1
+
+        ft = make_cube()
+        ft.set_K(K)
+        ft.set_rq(positions, orientations)
+        ft.compute()
+        self.assertEqual(ft.getNumOrientations(), 1)
+        grouped = np.copy(ft.getFT())
+
+        # the transform is the sum of the transforms of each particle
+        expected = np.zeros(len(K), dtype=np.complex128)
+        for i in range(num_points):
+            single = make_cube()
+            single.set_K(K)
+            single.set_rq(positions[i:i+1], orientations[i:i+1])
+            single.compute()
+            expected += single.getFT()
+        npt.assert_allclose(grouped, expected, rtol=1e-3, atol=1e-3)
+
+    def test_orientation_tolerance(self):
+        K = (np.random.random_sample((20, 3))*2 - 1).astype(np.float32)
+        positions = np.zeros((3, 3), dtype=np.float32)
+        orientations = np.array([[1, 0, 0, 0], [np.cos(1e-4), np.sin(1e-4), 0, 0], [np.cos(0.5), np.sin(0.5), 0, 0]],
+                                dtype=np.float32)
+        ft = make_cube()
+        ft.set_K(K)
+        ft.set_rq(positions, orientations)
+        ft.compute()
+        self.assertEqual(ft.getNumOrientations(), 3)
+        exact = np.copy(ft.getFT())
+
+        ft.set_orientation_tolerance(0.01)
+        ft.compute()
+        self.assertEqual(ft.getNumOrientations(), 2)
+        npt.assert_allclose(ft.getFT(), exact, rtol=1e-3, atol=1e-3)
+
+    def test_form_factor_cache(self):
+        np.random.seed(1)
+        K = (np.random.random_sample((50, 3))*4 - 2).astype(np.float32)
+        positions = (np.random.random_sample((30, 3))*10 - 5).astype(np.float32)
+        angles = np.repeat([0.0, 0.3, 0.6], 10)
+        orientations = np.zeros((30, 4), dtype=np.float32)
+        orientations[:, 0] = np.cos(angles)
+        orientations[:, 3] = np.sin(angles)
+        ft = make_cube()
+        ft.set_K(K)
+        ft.set_rq(positions, orientations)
+        ft.compute()
+        self.assertEqual(ft.getNumCachedOrientations(), 3)
+
+        # a new frame with the same orientations reuses the form factors
+        positions += 0.1
+        ft.set_rq(positions, orientations)
+        ft.compute()
+        fresh = make_cube()
+        fresh.set_K(K)
+        fresh.set_rq(positions, orientations)
+        fresh.compute()
+        npt.assert_allclose(ft.getFT(), fresh.getFT(), rtol=1e-5, atol=1e-5)
+
+        # new K points discard them
+        ft.set_K(K[:20])
+        fresh.set_K(K[:20])
+        ft.compute()
+        fresh.compute()
+        npt.assert_allclose(ft.getFT(), fresh.getFT(), rtol=1e-5, atol=1e-5)
+
+if __name__ == '__main__':
+    unittest.main()
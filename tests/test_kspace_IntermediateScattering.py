@@ -0,0 +1,37 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, kspace
+import unittest
+
+class TestIntermediateScattering(unittest.TestCase):
+    def test_brute_force(self):
+        L = 8.0
+        fbox = box.Box.cube(L)
+        num_frames = 12
+        num_lags = 4
+        points = np.random.random_sample((50, 3)).astype(np.float32)*L - L/2
+        traj = [points]
+        for t in range(1, num_frames):
+            traj.append((traj[-1] + np.random.normal(scale=0.05, size=points.shape)).astype(np.float32))
+
+        isf = kspace.IntermediateScattering(fbox, 3.0, 0.5, num_lags, 8)
+        for frame in traj:
+            isf.accumulate(frame)
+        self.assertEqual(isf.getFrameCounter(), num_frames)
+        npt.assert_equal(isf.getCounts(), num_frames - np.arange(num_lags))
+
+        q = isf.getVectors()
+        self.assertEqual(len(q), np.sum(isf.getShellCounts()))
+        # the wave vectors are reciprocal lattice vectors
+        npt.assert_allclose(q*L/(2*np.pi), np.round(q*L/(2*np.pi)), atol=1e-4)
+
+        rho = np.array([np.sum(np.exp(1j*np.dot(frame, q.T)), axis=0) for frame in traj])
+        shells = (np.linalg.norm(q, axis=1)/0.5).astype(np.int32)
+        F = isf.getF()
+        for lag in range(num_lags):
+            corr = np.mean(np.real(rho[lag:]*np.conj(rho[:num_frames-lag])), axis=0)/len(points)
+            for shell in np.unique(shells):
+                npt.assert_allclose(F[lag, shell], np.mean(corr[shells == shell]), rtol=1e-3, atol=1e-4)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,39 @@
+import numpy as np
+import numpy.testing as npt
+from freud import kspace
+import unittest
+
+class TestKPointStructureFactor(unittest.TestCase):
+    def test_brute_force(self):
+        np.random.seed(0)
+        K = (np.random.random_sample((40, 3))*6 - 3).astype(np.float32)
+        traj = [(np.random.random_sample((200, 3))*10 - 5).astype(np.float32) for t in range(5)]
+
+        sf = kspace.KPointStructureFactor(K)
+        for frame in traj:
+            sf.accumulate(frame)
+        self.assertEqual(sf.getFrameCounter(), len(traj))
+        npt.assert_equal(sf.getK(), K)
+
+        rho = np.array([np.sum(np.exp(1j*np.dot(frame, K.T)), axis=0) for frame in traj])
+        expected = np.mean(np.abs(rho)**2, axis=0)/200
+        npt.assert_allclose(sf.getS(), expected, rtol=1e-3, atol=1e-3)
+
+        sf.reset()
+        self.assertEqual(sf.getFrameCounter(), 0)
+        npt.assert_equal(sf.getS(), 0)
+
+    def test_nufft(self):
+        np.random.seed(1)
+        K = (np.random.random_sample((100, 3))*6 - 3).astype(np.float32)
+        points = (np.random.random_sample((1000, 3))*10 - 5).astype(np.float32)
+        direct = kspace.KPointStructureFactor(K)
+        direct.accumulate(points)
+        nufft = kspace.KPointStructureFactor(K)
+        nufft.setNUFFTTolerance(1e-5)
+        self.assertAlmostEqual(nufft.getNUFFTTolerance(), 1e-5)
+        nufft.accumulate(points)
+        npt.assert_allclose(nufft.getS(), direct.getS(), rtol=1e-3, atol=1e-2)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,58 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, kspace
+import unittest
+
+class TestStructureFactor(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+        self.box = box.Box(10.0, 12.0, 9.0)
+        self.points = ((np.random.random_sample((200, 3)) - 0.5)*[10.0, 12.0, 9.0]).astype(np.float32)
+
+    def brute_force(self, g):
+        h = np.arange(-g, g+1)
+        qx = h*2*np.pi/self.box.getLx()
+        qy = h*2*np.pi/self.box.getLy()
+        qz = h*2*np.pi/self.box.getLz()
+        s = np.zeros((2*g+1, 2*g+1, 2*g+1), dtype=np.complex128)
+        for p in self.points.astype(np.float64):
+            s += np.exp(1j*(qz[:,None,None]*p[2] + qy[None,:,None]*p[1] + qx[None,None,:]*p[0]))
+        return s/len(self.points)
+
+    def test_direct(self):
+        sf = kspace.SFactor3DPoints(self.box, 4)
+        sf.compute(self.points)
+        expected = self.brute_force(4)
+        npt.assert_allclose(sf.getSComplex(), expected, atol=1e-5)
+        npt.assert_allclose(sf.getS(), np.abs(expected)**2, atol=1e-5)
+        self.assertAlmostEqual(sf.getS()[4,4,4], 1.0, places=5)
+
+    def test_fft(self):
+        direct = kspace.StructureFactor(4)
+        direct.computeDirect(self.box, self.points)
+        errors = []
+        for width in [16, 64]:
+            sf = kspace.StructureFactor(4)
+            sf.computeFFT(self.box, self.points, width)
+            errors.append(np.max(np.abs(sf.getSComplex() - direct.getSComplex())))
+        self.assertLess(errors[1], 0.01)
+        self.assertLess(errors[1], errors[0])
+
+    def test_fft_width(self):
+        sf = kspace.StructureFactor(4)
+        self.assertRaises(ValueError, sf.computeFFT, self.box, self.points, 8)
+        self.assertRaises(ValueError, sf.computeFFT, self.box, self.points, 24)
+
+    def test_shell_average(self):
+        sf = kspace.SFactor3DPoints(self.box, 3)
+        sf.compute(self.points)
+        S = sf.getS()
+        analyze = kspace.AnalyzeSFactor3D(S)
+        S_all, qsq_all = analyze.getSvsQ()
+        S_mean, qsq = analyze.getSvsQ(average=True)
+        npt.assert_equal(qsq, np.unique(qsq_all))
+        for q, s in zip(qsq, S_mean):
+            self.assertAlmostEqual(s, np.mean(S_all[qsq_all == q]), places=5)
+
+if __name__ == '__main__':
+    unittest.main()
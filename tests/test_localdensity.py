@@ -48,3 +48,32 @@ class TestLD:
         neighbors = self.ld.getNumNeighbors();
         for i in range(0,len(neighbors)):
             assert_less(math.fabs(neighbors[i]-1130.973355292), 200);
+
+    def test_multiple_r_cuts(self):
+        """Test that the densities at several cutoffs match those computed one cutoff at a time"""
+
+        r_cuts = [3, 1.5, 2]
+        ld = density.LocalDensity(r_cuts, 1, 1);
+        ld.compute(self.box, self.pos, self.pos);
+        densities = ld.getDensity();
+        neighbors = ld.getNumNeighbors();
+        assert_equal(densities.shape, (len(self.pos), len(r_cuts)));
+
+        for c in range(len(r_cuts)):
+            single = density.LocalDensity(r_cuts[c], 1, 1);
+            single.compute(self.box, self.pos, self.pos);
+            numpy.testing.assert_allclose(densities[:, c], single.getDensity(), rtol=1e-5);
+            numpy.testing.assert_allclose(neighbors[:, c], single.getNumNeighbors(), rtol=1e-5);
+
+    def test_cell_order(self):
+        """Test that visiting the reference points in cell order does not change the result"""
+
+        ref_points = self.pos[:6000]
+        assert self.ld.getCellOrder()
+        for ref in [ref_points, self.pos]:
+            self.ld.compute(self.box, ref, self.pos);
+            ordered = numpy.copy(self.ld.getDensity());
+            self.ld.setCellOrder(False);
+            self.ld.compute(self.box, ref, self.pos);
+            numpy.testing.assert_allclose(self.ld.getDensity(), ordered, rtol=1e-6);
+            self.ld.setCellOrder(True);
@@ -0,0 +1,64 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density, locality
+import unittest
+
+class TestDomainDecomposition(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+        self.box = box.Box(10, 12, 9, 0.3, -0.2, 0.1)
+        fractions = np.random.random_sample((3000, 3))
+        lattice = np.array([self.box.getLatticeVector(i) for i in range(3)])
+        self.points = ((fractions - 0.5).dot(lattice)).astype(np.float32)
+
+    def test_owned_once(self):
+        decomposition = locality.DomainDecomposition(self.box, (3, 2, 2), 1.5)
+        self.assertEqual(decomposition.getNumDomains(), 12)
+        self.assertEqual(decomposition.getShape(), (3, 2, 2))
+        decomposition.compute(self.points)
+        offsets = decomposition.getOffsets()
+        indices = decomposition.getIndices()
+        domains = decomposition.getDomains()
+        owned = np.concatenate([indices[offsets[2*d]:offsets[2*d+1]] for d in range(12)])
+        npt.assert_equal(np.sort(owned), np.arange(len(self.points)))
+        for d in range(12):
+            npt.assert_equal(domains[indices[offsets[2*d]:offsets[2*d+1]]], d)
+
+    def test_rdf(self):
+        rmax = 2.0
+        whole = density.RDF(rmax, 0.1)
+        whole.accumulate(self.box, self.points, self.points)
+        decomposition = locality.DomainDecomposition(self.box, (2, 2, 2), rmax)
+        decomposition.compute(self.points)
+        offsets = decomposition.getOffsets()
+        positions = decomposition.getPositions()
+        merged = density.RDF(rmax, 0.1)
+        for d in range(decomposition.getNumDomains()):
+            rdf = density.RDF(rmax, 0.1)
+            rdf.accumulateDomain(decomposition.getDomainBox(d), positions[offsets[2*d]:offsets[2*d+2]],
+                                 offsets[2*d+1] - offsets[2*d], self.box, len(self.points), d == 0)
+            merged += rdf
+        npt.assert_allclose(merged.getRDF(), whole.getRDF(), rtol=1e-4, atol=1e-6)
+
+    def test_local_density(self):
+        ld = density.LocalDensity(1.5, 1, 1)
+        ld.compute(self.box, self.points, self.points)
+        expected = np.copy(ld.getDensity())
+        decomposition = locality.DomainDecomposition(self.box, (2, 3, 1), 1.5)
+        decomposition.compute(self.points)
+        offsets = decomposition.getOffsets()
+        indices = decomposition.getIndices()
+        positions = decomposition.getPositions()
+        for d in range(decomposition.getNumDomains()):
+            owned = positions[offsets[2*d]:offsets[2*d+1]]
+            ld.compute(decomposition.getDomainBox(d), owned, positions[offsets[2*d]:offsets[2*d+2]])
+            npt.assert_allclose(ld.getDensity(), expected[indices[offsets[2*d]:offsets[2*d+1]]], rtol=1e-5)
+
+    def test_errors(self):
+        with self.assertRaises(ValueError):
+            locality.DomainDecomposition(self.box, (2, 2, 2), 5.0)
+        with self.assertRaises(ValueError):
+            locality.DomainDecomposition(box.Box.square(10), (2, 2, 2), 1.0)
+
+if __name__ == '__main__':
+    unittest.main()
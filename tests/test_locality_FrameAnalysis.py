@@ -0,0 +1,59 @@
+import numpy as np
+import numpy.testing as npt
+from freud import locality, box, density, order, cluster
+import unittest
+
+class TestFrameAnalysis(unittest.TestCase):
+    def test_matches_separate(self):
+        L = 10
+        N = 1000
+        fbox = box.Box.cube(L)
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        rdf = density.RDF(2.5, 0.1)
+        ld = density.LocalDensity(1.5, 1, 1)
+        ql = order.LocalQl(fbox, 1.4, 6)
+        clust = cluster.Cluster(fbox, 0.8)
+        frame = locality.FrameAnalysis()
+        for analysis in (rdf, ld, ql, clust):
+            frame.add(analysis)
+        self.assertEqual(frame.getNumAnalyses(), 4)
+        self.assertAlmostEqual(frame.getRMax(), 2.5, places=5)
+        frame.compute(fbox, points)
+
+        rdf_alone = density.RDF(2.5, 0.1)
+        rdf_alone.accumulate(fbox, points, points)
+        npt.assert_allclose(rdf.getRDF(), rdf_alone.getRDF(), rtol=1e-5)
+
+        ld_alone = density.LocalDensity(1.5, 1, 1)
+        ld_alone.compute(fbox, points, points)
+        npt.assert_allclose(ld.getDensity(), ld_alone.getDensity(), rtol=1e-5)
+        npt.assert_allclose(ld.getNumNeighbors(), ld_alone.getNumNeighbors(), rtol=1e-5)
+
+        ql_alone = order.LocalQl(fbox, 1.4, 6)
+        ql_alone.compute(points)
+        npt.assert_allclose(ql.getQl(), ql_alone.getQl(), rtol=1e-4, atol=1e-6)
+
+        clust_alone = cluster.Cluster(fbox, 0.8)
+        clust_alone.computeClusters(points)
+        self.assertEqual(clust.getNumClusters(), clust_alone.getNumClusters())
+        npt.assert_equal(clust.getClusterIdx(), clust_alone.getClusterIdx())
+
+    def test_self_analyses_need_same_points(self):
+        fbox = box.Box.cube(10)
+        points = np.random.uniform(-5, 5, (100, 3)).astype(np.float32)
+        frame = locality.FrameAnalysis()
+        frame.add(cluster.Cluster(fbox, 1.0))
+        with self.assertRaises(ValueError):
+            frame.compute(fbox, points[:50], points)
+
+    def test_unsupported_analysis(self):
+        frame = locality.FrameAnalysis()
+        with self.assertRaises(TypeError):
+            frame.add(locality.VerletList(1.0, 0.1))
+        with self.assertRaises(ValueError):
+            frame.compute(box.Box.cube(10), np.zeros((1, 3), dtype=np.float32))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,63 @@
+import numpy as np
+import numpy.testing as npt
+from freud import locality, box
+import unittest
+
+class TestKDTree(unittest.TestCase):
+    def test_matches_linkcell(self):
+        L = 10 #Box Dimensions
+        rcut = 2 #Cutoff radius
+        N = 500 # number of particles
+
+        fbox = box.Box.cube(L)
+        # a dense droplet in a mostly empty box
+        points = np.random.uniform(-L/8, L/8, (N, 3)).astype(np.float32)
+        points[:50] = np.random.uniform(-L/2, L/2, (50, 3))
+
+        lc = locality.LinkCell(fbox, rcut)
+        lc.computeNlist(fbox, points)
+        expected = set(zip(lc.getNlist().getIndexI().tolist(), lc.getNlist().getIndexJ().tolist()))
+
+        tree = locality.KDTree()
+        tree.computeNlist(fbox, points, rmax=rcut, store_vectors=True)
+        nlist = tree.getNlist()
+        found = set(zip(nlist.getIndexI().tolist(), nlist.getIndexJ().tolist()))
+        self.assertEqual(found, expected)
+        self.assertTrue(np.all(np.diff(nlist.getIndexI().astype(np.int64)) >= 0))
+
+        # the stored vectors are minimum image vectors
+        delta = points[nlist.getIndexJ()] - points[nlist.getIndexI()]
+        delta -= L*np.round(delta/L)
+        npt.assert_allclose(nlist.getVectors(), delta, atol=1e-5)
+
+    def test_rmax_larger_than_half_box(self):
+        L = 10
+        N = 10
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        tree = locality.KDTree()
+        tree.computeNlist(fbox, points, rmax=0.6*L)
+        nlist = tree.getNlist()
+
+        # every point also sees some of the images of the others, and of itself
+        self.assertTrue(np.all(nlist.getDistances() < 0.6*L))
+        self.assertGreater(nlist.getNumBonds(), N*(N - 1)//2)
+
+    def test_nearest_neighbors_tree(self):
+        L = 10
+        N = 200
+        num_neighbors = 8
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        nn = locality.NearestNeighbors(0.5, num_neighbors)
+        nn.compute(fbox, points, points)
+        expected = np.copy(nn.getNeighborList())
+
+        nn_tree = locality.NearestNeighbors(0.5, num_neighbors, use_tree=True)
+        self.assertTrue(nn_tree.getUseTree())
+        nn_tree.compute(fbox, points, points)
+        npt.assert_equal(nn_tree.getNeighborList(), expected)
+
+if __name__ == '__main__':
+    unittest.main()
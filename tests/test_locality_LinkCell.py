@@ -68,5 +68,191 @@ class TestLinkCell(unittest.TestCase):
             # if i is a neighbor of j, then j should be a neighbor of i
             self.assertEqual(neighbors_ij, neighbors_ji)
 
+    def test_cell_contents(self):
+        current_version = sys.version_info
+        if current_version.major < 3:
+            self.assertEqual(1, 1)
+        else:
+            L = 10; #Box Dimensions
+            rcut = 2; #Cutoff radius
+            N = 100; # number of particles
+
+            points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+            fbox = box.Box.cube(L);#Initialize Box
+            cl = locality.LinkCell(fbox,rcut);#Initialize cell list
+            cl.computeCellList(fbox, points);#Compute cell list
+
+            # every particle appears exactly once, in its own cell, in ascending order
+            seen = []
+            for cell in range(cl.getNumCells()):
+                members = list(cl.itercell(cell))
+                self.assertEqual(members, sorted(members))
+                for j in members:
+                    self.assertEqual(cl.getCell(points[j]), cell)
+                seen.extend(members)
+            self.assertEqual(sorted(seen), list(range(N)))
+
+    def test_subdivision(self):
+        L = 10
+        rcut = 2
+        N = 200
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        fbox = box.Box.cube(L)
+
+        expected = locality.LinkCell(fbox, rcut)
+        expected.computeNlist(fbox, points)
+        expected_bonds = set(zip(expected.getNlist().getIndexI(), expected.getNlist().getIndexJ()))
+
+        for n in (1, 2, 3):
+            cl = locality.LinkCell(fbox, rcut)
+            cl.setSubdivision(n)
+            self.assertEqual(cl.getSubdivision(), n)
+            cl.computeCellList(fbox, points)
+            self.assertGreaterEqual(cl.getNumCells(), (5*n - 1)**3)
+            self.assertEqual(len(np.unique(cl.getCellNeighbors(0))), (2*n + 1)**3)
+            cl.computeNlist(fbox, points)
+            bonds = set(zip(cl.getNlist().getIndexI(), cl.getNlist().getIndexJ()))
+            self.assertEqual(bonds, expected_bonds)
+
+        with self.assertRaises(ValueError):
+            expected.setSubdivision(4)
+
+    def test_lazy_stencils(self):
+        L = 10
+        rcut = 2
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (200, 3)).astype(np.float32)
+        fbox = box.Box.cube(L)
+
+        for n in (1, 2):
+            stored = locality.LinkCell(fbox, rcut)
+            stored.setSubdivision(n)
+            lazy = locality.LinkCell(fbox, rcut)
+            lazy.setSubdivision(n)
+            lazy.setLazyStencils(True)
+            self.assertFalse(stored.getLazyStencils())
+            self.assertTrue(lazy.getLazyStencils())
+            # the generated neighbor cells are those stored, in the same order
+            for cell in range(stored.getNumCells()):
+                npt.assert_array_equal(lazy.getCellNeighbors(cell), stored.getCellNeighbors(cell))
+            stored.computeNlist(fbox, points)
+            lazy.computeNlist(fbox, points)
+            npt.assert_array_equal(lazy.getNlist().getIndexI(), stored.getNlist().getIndexI())
+            npt.assert_array_equal(lazy.getNlist().getIndexJ(), stored.getNlist().getIndexJ())
+
+    def test_power_of_two_cells(self):
+        L = 13.7
+        rcut = 1.3
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (500, 3)).astype(np.float32)
+        fbox = box.Box.cube(L)
+
+        lc = locality.LinkCell(fbox, rcut)
+        lc.computeNlist(fbox, points)
+        expected = set(zip(lc.getNlist().getIndexI().tolist(), lc.getNlist().getIndexJ().tolist()))
+        for lazy in (False, True):
+            pow2 = locality.LinkCell(fbox, rcut)
+            pow2.setPowerOfTwoCells(True)
+            pow2.setLazyStencils(lazy)
+            self.assertTrue(pow2.getPowerOfTwoCells())
+            # 10 cells of the cutoff fit along each side, rounded down to 8
+            self.assertEqual(pow2.getNumCells(), 8**3)
+            pow2.computeNlist(fbox, points)
+            found = set(zip(pow2.getNlist().getIndexI().tolist(), pow2.getNlist().getIndexJ().tolist()))
+            self.assertEqual(found, expected)
+
+    def test_morton_cells(self):
+        L = 10
+        rcut = 1.0
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (500, 3)).astype(np.float32)
+        fbox = box.Box.cube(L)
+
+        lc = locality.LinkCell(fbox, rcut)
+        lc.computeNlist(fbox, points)
+        expected = set(zip(lc.getNlist().getIndexI().tolist(), lc.getNlist().getIndexJ().tolist()))
+        point = np.array([-4.5, -4.5, -3.5], dtype=np.float32)
+        self.assertEqual(lc.getCell(point), 100)
+        for lazy in (False, True):
+            morton = locality.LinkCell(fbox, rcut)
+            morton.setMortonCells(True)
+            morton.setLazyStencils(lazy)
+            self.assertTrue(morton.getMortonCells())
+            self.assertEqual(morton.getNumCells(), 10**3)
+            # the cell one step along z follows the first cell
+            self.assertEqual(morton.getCell(point), 1)
+            morton.computeNlist(fbox, points)
+            found = set(zip(morton.getNlist().getIndexI().tolist(), morton.getNlist().getIndexJ().tolist()))
+            self.assertEqual(found, expected)
+
+    def test_open_boundaries(self):
+        # a slab thinner than twice the cutoff, periodic in x and y only
+        fbox = box.Box(10, 10, 3)
+        fbox.setPeriodic(True, True, False)
+        self.assertEqual(fbox.getPeriodic(), [True, True, False])
+        rcut = 1.5
+        np.random.seed(0)
+        points = np.random.uniform(-5, 5, (300, 3)).astype(np.float32)
+        points[:, 2] = np.random.uniform(-2.5, 2.5, 300)
+
+        # brute force, with the minimum image along x and y only
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta[:, :, :2] -= 10*np.round(delta[:, :, :2]/10)
+        rsq = np.sum(delta**2, axis=-1)
+        expected = set(zip(*np.nonzero((rsq < rcut**2) & ~np.eye(300, dtype=bool))))
+
+        for fit in (False, True):
+            for n in (1, 2):
+                cl = locality.LinkCell(fbox, rcut)
+                cl.setSubdivision(n)
+                cl.setFitOpenBoundaries(fit)
+                self.assertEqual(cl.getFitOpenBoundaries(), fit)
+                cl.computeNlist(fbox, points)
+                nlist = cl.getNlist()
+                self.assertEqual(set(zip(nlist.getIndexI(), nlist.getIndexJ())), expected)
+                # the cells at the two walls are not neighbors
+                self.assertLess(len(cl.getCellNeighbors(0)), (2*n + 1)**3)
+
+    def test_auto_subdivision(self):
+        fbox = box.Box.cube(20)
+        cl = locality.LinkCell(fbox, 5)
+        # few points per cell: the cells of the cutoff; many: finer cells
+        self.assertEqual(cl.chooseSubdivision(fbox, 100), 1)
+        self.assertGreater(cl.chooseSubdivision(fbox, 64000), 1)
+
+        np.random.seed(0)
+        points = np.random.uniform(-10, 10, (1000, 3)).astype(np.float32)
+        cl.setAutoSubdivision(True)
+        cl.computeCellList(fbox, points)
+        self.assertEqual(cl.getSubdivision(), cl.chooseSubdivision(fbox, len(points)))
+
+        n = cl.tuneSubdivision(fbox, points)
+        self.assertIn(n, (1, 2, 3))
+        self.assertEqual(cl.getSubdivision(), n)
+        self.assertFalse(cl.getAutoSubdivision())
+
+    def test_count_neighbors(self):
+        fbox = box.Box.cube(10)
+        np.random.seed(0)
+        points = np.random.uniform(-5, 5, (500, 3)).astype(np.float32)
+        ref_points = np.random.uniform(-5, 5, (100, 3)).astype(np.float32)
+        cl = locality.LinkCell(fbox, 1.0)
+
+        cl.computeNlist(fbox, points)
+        counts = cl.countNeighbors(fbox, points)
+        npt.assert_equal(counts, np.bincount(cl.getNlist().getIndexI(), minlength=len(points)))
+        npt.assert_equal(cl.findAnyNeighbor(fbox, points), counts > 0)
+
+        cl.computeNlist(fbox, ref_points, points)
+        counts = cl.countNeighbors(fbox, ref_points, points)
+        npt.assert_equal(counts, np.bincount(cl.getNlist().getIndexI(), minlength=len(ref_points)))
+        npt.assert_equal(cl.findAnyNeighbor(fbox, ref_points, points), counts > 0)
+
+        # each point is its own neighbor unless excluded
+        npt.assert_equal(cl.countNeighbors(fbox, points, points, exclude_ii=False),
+                         cl.countNeighbors(fbox, points) + 1)
+        self.assertTrue(np.all(cl.findAnyNeighbor(fbox, points, points, exclude_ii=False)))
+
 if __name__ == '__main__':
     unittest.main()
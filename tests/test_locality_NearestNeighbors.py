@@ -1,6 +1,8 @@
-from freud import locality, box
+from freud import locality, box, parallel
 import numpy as np
+import itertools
 import numpy.testing as npt
+import threading
 import unittest
 
 class TestNearestNeighbors(unittest.TestCase):
@@ -100,5 +102,168 @@ class TestNearestNeighbors(unittest.TestCase):
         npt.assert_equal(rsq_list[0,0], 1.0)
         npt.assert_equal(rsq_list[0,1], -1.0)
 
+    def test_rmax_larger_than_half_box(self):
+        L = 3
+        N = 5
+        num_neighbors = 40
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        # with 5 points in the box, 40 neighbors lie among the periodic images
+        for use_tree in [False, True]:
+            cl = locality.NearestNeighbors(1.0, num_neighbors, use_tree=use_tree)
+            cl.compute(fbox, points, points)
+            rsq_list = cl.getRsqList()
+            self.assertTrue(np.all(rsq_list > 0))
+
+            shifts = np.array(list(itertools.product(range(-3, 4), repeat=3)), dtype=np.float32)*L
+            for i in range(N):
+                delta = points[np.newaxis, :, :] - points[i] + shifts[:, np.newaxis, :]
+                rsq = np.sort(np.sum(delta**2, axis=2).flatten())
+                # skip the particle itself
+                npt.assert_allclose(rsq_list[i], rsq[1:num_neighbors+1], rtol=1e-4)
+
+    def test_profiling(self):
+        L = 10
+        N = 40
+        fbox = box.Box.cube(L)
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        # a cutoff much too small for 8 neighbors, so that it is expanded
+        cl = locality.NearestNeighbors(0.5, 8)
+        cl.compute(fbox, points, points)
+        if not parallel.isProfilingEnabled():
+            self.assertEqual(cl.getStats(), {})
+            return
+        stats = cl.getStats()
+        self.assertGreater(stats['iterations'], 1)
+        self.assertGreater(stats['queries'], N)
+        self.assertLessEqual(stats['bonds'], N*8)
+        self.assertIn('search', cl.getTimings())
+
+    def test_query(self):
+        L = 10
+        N = 100
+        num_neighbors = 6
+        fbox = box.Box.cube(L)
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        cl = locality.NearestNeighbors(1.0, num_neighbors)
+        cl.buildIndex(fbox, points)
+
+        neighbors = np.empty((20, num_neighbors), dtype=np.uint32)
+        rsq = np.empty((20, num_neighbors), dtype=np.float32)
+        wvec = np.empty((20, num_neighbors, 3), dtype=np.float32)
+        for batch in range(3):
+            query_points = np.random.uniform(-L/2, L/2, (20, 3)).astype(np.float32)
+            result = cl.query(query_points, neighbors, rsq, wvec)
+            # the caller's arrays are filled
+            self.assertIs(result[0], neighbors)
+            for i in range(len(query_points)):
+                delta = points - query_points[i]
+                delta -= L*np.round(delta/L)
+                dist = np.sum(delta**2, axis=1)
+                npt.assert_allclose(rsq[i], np.sort(dist)[:num_neighbors], rtol=1e-4)
+                npt.assert_allclose(dist[neighbors[i]], rsq[i], rtol=1e-4)
+                npt.assert_allclose(wvec[i], delta[neighbors[i]], atol=1e-4)
+
+        # a query point on top of a point finds it
+        neighbors, rsq, wvec = cl.query(points[:1])
+        self.assertEqual(neighbors[0, 0], 0)
+        self.assertEqual(rsq[0, 0], 0)
+
+        with self.assertRaises(ValueError):
+            cl.query(points[:2], neighbors=np.empty((3, num_neighbors), dtype=np.uint32))
+
+    def test_query_strict_cut(self):
+        fbox = box.Box.cube(10)
+        points = np.array([[0, 0, 0], [1, 0, 0], [3, 0, 0]], dtype=np.float32)
+        cl = locality.NearestNeighbors(2.0, 3, strict_cut=True)
+        cl.buildIndex(fbox, points)
+        neighbors, rsq, wvec = cl.query(np.array([[0.5, 0, 0]], dtype=np.float32))
+        npt.assert_equal(neighbors[0, 2], cl.getUINTMAX())
+        npt.assert_allclose(rsq[0], [0.25, 0.25, -1])
+        npt.assert_allclose(wvec[0, 2], [-1, -1, -1])
+
+    def test_store_outputs(self):
+        L = 10
+        N = 100
+        fbox = box.Box.cube(L)
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        full = locality.NearestNeighbors(1.0, 6)
+        full.compute(fbox, points, points)
+        for (store_rsq, store_vectors) in [(False, False), (False, True), (True, False)]:
+            cl = locality.NearestNeighbors(1.0, 6)
+            cl.setStoreDistances(store_rsq)
+            cl.setStoreVectors(store_vectors)
+            self.assertEqual(cl.getStoreDistances(), store_rsq)
+            self.assertEqual(cl.getStoreVectors(), store_vectors)
+            cl.compute(fbox, points, points)
+            npt.assert_equal(cl.getNeighborList(), full.getNeighborList())
+            npt.assert_allclose(cl.getNlist().getDistances(), full.getNlist().getDistances(), rtol=1e-5)
+            if store_rsq:
+                npt.assert_equal(cl.getRsqList(), full.getRsqList())
+            else:
+                with self.assertRaises(RuntimeError):
+                    cl.getRsqList()
+            if not store_vectors:
+                with self.assertRaises(RuntimeError):
+                    cl.getWrappedVectors()
+
+    def test_compute_arrays(self):
+        L = 10
+        N = 100
+        num_neighbors = 6
+        fbox = box.Box.cube(L)
+        np.random.seed(0)
+        frames = [np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32) for _ in range(4)]
+        cl = locality.NearestNeighbors(1.0, num_neighbors)
+
+        results = [None]*len(frames)
+        def work(f):
+            results[f] = cl.computeArrays(fbox, frames[f], frames[f])
+        threads = [threading.Thread(target=work, args=(f,)) for f in range(len(frames))]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        # the object itself was not used
+        self.assertEqual(cl.getNRef(), 0)
+
+        for (points, (neighbors, rsq, wvec)) in zip(frames, results):
+            ref = locality.NearestNeighbors(1.0, num_neighbors)
+            ref.compute(fbox, points, points)
+            npt.assert_equal(neighbors, ref.getNeighborList())
+            npt.assert_allclose(rsq, ref.getRsqList(), rtol=1e-5)
+
+    def test_approximate(self):
+        L = 20
+        N = 4000
+        k = 12
+        epsilon = 0.5
+        np.random.seed(0)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        fbox = box.Box.cube(L)
+        exact = locality.NearestNeighbors(1.5, k, use_tree=True)
+        exact.compute(fbox, points, points)
+        nn = locality.NearestNeighbors(1.5, k)
+        self.assertEqual(nn.getApproximate(), 0)
+        nn.setApproximate(epsilon)
+        nn.setRecallSamples(500)
+        nn.compute(fbox, points, points)
+
+        # each neighbor is at most 1 + epsilon times as far as the exact one of its rank
+        ratios = np.sqrt(nn.getRsqList() / exact.getRsqList())
+        self.assertLessEqual(ratios.max(), 1 + epsilon + 1e-5)
+        found = [len(set(a) & set(e)) for a, e in zip(nn.getNeighborList(), exact.getNeighborList())]
+        stats = nn.getRecallStatistics()
+        self.assertEqual(stats['num_queries'], 500)
+        self.assertLessEqual(stats['max_distance_ratio'], 1 + epsilon + 1e-5)
+        self.assertAlmostEqual(stats['recall'], np.sum(found) / float(N*k), delta=0.05)
+        self.assertLessEqual(stats['exact_fraction'], 1.0)
+        with self.assertRaises(ValueError):
+            nn.setApproximate(-1)
+
 if __name__ == '__main__':
     unittest.main()
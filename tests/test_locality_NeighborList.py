@@ -0,0 +1,255 @@
+import numpy as np
+import numpy.testing as npt
+from freud import locality, box, density, cluster, bond
+import unittest
+
+class TestNeighborList(unittest.TestCase):
+    def test_brute_force(self):
+        L = 10 #Box Dimensions
+        rcut = 2 #Cutoff radius
+        N = 100 # number of particles
+
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        lc = locality.LinkCell(fbox, rcut)
+        lc.computeNlist(fbox, points, store_vectors=True)
+        nlist = lc.getNlist()
+
+        # compare against all pairs within the cutoff
+        expected = set()
+        for i in range(N):
+            for j in range(N):
+                delta = points[j] - points[i]
+                delta -= L*np.round(delta/L)
+                if i != j and np.dot(delta, delta) < rcut*rcut:
+                    expected.add((i, j))
+
+        self.assertEqual(nlist.getNumBonds(), len(expected))
+        found = set(zip(nlist.getIndexI().tolist(), nlist.getIndexJ().tolist()))
+        self.assertEqual(found, expected)
+
+        # bonds are sorted by i and the segments delimit each i
+        index_i = nlist.getIndexI()
+        self.assertTrue(np.all(np.diff(index_i.astype(np.int64)) >= 0))
+        npt.assert_equal(nlist.getNeighborCounts(), np.bincount(index_i, minlength=N))
+
+        # distances agree with the stored vectors
+        vectors = nlist.getVectors()
+        npt.assert_allclose(np.sqrt(np.sum(vectors**2, axis=1)), nlist.getDistances(), rtol=1e-5)
+
+    def test_rdf_nlist(self):
+        rmax = 3.0
+        dr = 0.5
+        L = 10
+        N = 500
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        expected = np.copy(rdf.getRDF())
+
+        lc = locality.LinkCell(fbox, rmax)
+        lc.computeNlist(fbox, points, points)
+        rdf.compute(fbox, points, points, nlist=lc.getNlist())
+        npt.assert_allclose(rdf.getRDF(), expected, rtol=1e-5)
+
+    def test_bonding_nlist(self):
+        # one neighbor list shared by two bonding analyses of the same pairs
+        xmax = 3.0
+        ymax = 3.0
+        fbox = box.Box.square(20)
+        points = np.array([[0, 0, 0], [1, 1, 0], [-1, 2, 0]], dtype=np.float32)
+        angles = np.zeros(3, dtype=np.float32)
+        bond_list = np.arange(4, dtype=np.uint32)
+        xy2d_map = np.arange(60*60, dtype=np.uint32).reshape(60, 60) % 4
+        xyt_map = np.arange(10*60*60, dtype=np.uint32).reshape(10, 60, 60) % 4
+        bonding_xy2d = bond.BondingXY2D(xmax, ymax, xy2d_map, bond_list)
+        bonding_xyt = bond.BondingXYT(xmax, ymax, xyt_map, bond_list)
+
+        expected = []
+        for bonding in [bonding_xy2d, bonding_xyt]:
+            bonding.compute(fbox, points, angles, points, angles)
+            expected.append(np.copy(bonding.getBonds()))
+
+        lc = locality.LinkCell(fbox, np.sqrt(xmax**2 + ymax**2))
+        lc.computeNlist(fbox, points, points)
+        for bonding, bonds in zip([bonding_xy2d, bonding_xyt], expected):
+            bonding.compute(fbox, points, angles, points, angles, nlist=lc.getNlist())
+            npt.assert_equal(bonding.getBonds(), bonds)
+
+    def test_cluster_nlist(self):
+        L = 10
+        rcut = 1.5
+        N = 200
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        clust = cluster.Cluster(fbox, rcut)
+        clust.computeClusters(points)
+        expected = np.copy(clust.getClusterIdx())
+
+        lc = locality.LinkCell(fbox, rcut)
+        lc.computeNlist(fbox, points)
+        clust.computeClusters(points, nlist=lc.getNlist())
+        npt.assert_equal(clust.getClusterIdx(), expected)
+
+    def test_nearest_neighbors_nlist(self):
+        L = 10
+        N = 100
+        num_neighbors = 6
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        nn = locality.NearestNeighbors(1.5, num_neighbors)
+        nn.compute(fbox, points, points)
+        nlist = nn.getNlist()
+        self.assertEqual(nlist.getNumBonds(), N*num_neighbors)
+        npt.assert_equal(nlist.getIndexJ().reshape((N, num_neighbors)), nn.getNeighborList())
+
+    def test_multiple_cutoffs(self):
+        L = 10
+        N = 500
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        # one list at the largest cutoff serves the smaller ones
+        lc = locality.LinkCell(fbox, 3.0)
+        lc.computeNlist(fbox, points)
+        nlist = lc.getNlist()
+        nlist.sortByDistance()
+        self.assertTrue(nlist.isSortedByDistance())
+        segments = nlist.getSegments()
+        distances = nlist.getDistances()
+        for i in range(N):
+            self.assertTrue(np.all(np.diff(distances[segments[i]:segments[i+1]]) >= 0))
+
+        small = nlist.copyWithin(1.5)
+        lc_small = locality.LinkCell(fbox, 1.5)
+        lc_small.computeNlist(fbox, points)
+        expected = set(zip(lc_small.getNlist().getIndexI().tolist(), lc_small.getNlist().getIndexJ().tolist()))
+        found = set(zip(small.getIndexI().tolist(), small.getIndexJ().tolist()))
+        self.assertEqual(found, expected)
+
+        clust = cluster.Cluster(fbox, 1.5)
+        clust.computeClusters(points)
+        expected_idx = np.copy(clust.getClusterIdx())
+        clust.computeClusters(points, nlist=nlist)
+        npt.assert_equal(clust.getClusterIdx(), expected_idx)
+
+    def test_from_arrays(self):
+        nlist = locality.NeighborList.from_arrays(3, 4, [0, 0, 2], [1, 3, 2], [1.0, 2.0, 0.5])
+        self.assertEqual(nlist.getNumBonds(), 3)
+        npt.assert_equal(nlist.getSegments(), [0, 2, 2, 3])
+        self.assertTrue(nlist.getVectors() is None)
+
+        # bonds must be sorted by i
+        with self.assertRaises(ValueError):
+            locality.NeighborList.from_arrays(3, 4, [2, 0], [1, 3], [1.0, 2.0])
+
+    def test_size_mismatch(self):
+        L = 10
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (10, 3)).astype(np.float32)
+        lc = locality.LinkCell(fbox, 2.0)
+        lc.computeNlist(fbox, points)
+        rdf = density.RDF(2.0, 0.5)
+        with self.assertRaises(ValueError):
+            rdf.accumulate(fbox, points[:5], points[:5], nlist=lc.getNlist())
+
+    def test_filters(self):
+        nlist = locality.NeighborList.from_arrays(3, 3, [0, 0, 1, 2], [1, 2, 2, 0], [1.0, 2.0, 0.5, 2.0])
+        shell = nlist.copyWithinRange(0.5, 1.5)
+        npt.assert_equal(shell.getIndexI(), [0])
+        npt.assert_equal(shell.getIndexJ(), [1])
+
+        types = np.array([0, 1, 1], dtype=np.uint32)
+        pairs = nlist.copyTypes(types, types, 0, 1)
+        npt.assert_equal(pairs.getIndexJ(), [1, 2])
+        npt.assert_equal(pairs.getSegments(), [0, 2, 2, 2])
+
+        masked = nlist.copyMasked(mask=np.array([True, False, True]))
+        npt.assert_equal(masked.getIndexI(), [0, 1, 2])
+        npt.assert_equal(masked.getIndexJ(), [2, 2, 0])
+
+        kept = nlist.copyIf([False, True, True, False])
+        npt.assert_equal(kept.getIndexJ(), [2, 2])
+
+        # 0-2 and 2-0 are the same bond, so the symmetric list has one bond per direction of 0-1, 0-2 and 1-2
+        symmetric = nlist.copySymmetric()
+        found = set(zip(symmetric.getIndexI().tolist(), symmetric.getIndexJ().tolist()))
+        self.assertEqual(found, {(0, 1), (1, 0), (0, 2), (2, 0), (1, 2), (2, 1)})
+        self.assertEqual(symmetric.getNumBonds(), 6)
+
+    def test_weights(self):
+        nlist = locality.NeighborList.from_arrays(2, 2, [0, 1], [1, 0], [1.0, 3.0])
+        self.assertTrue(nlist.getWeights() is None)
+        nlist.weightByDistance('linear', 2.0)
+        npt.assert_allclose(nlist.getWeights(), [0.5, 0.0])
+        nlist.weightByDistance('gaussian', 1.0)
+        npt.assert_allclose(nlist.getWeights(), np.exp(-0.5*np.array([1.0, 9.0])), rtol=1e-6)
+        nlist.setWeights([2.0, 4.0])
+        npt.assert_allclose(nlist.copyWithin(2.0).getWeights(), [2.0])
+        nlist.clearWeights()
+        self.assertTrue(nlist.getWeights() is None)
+        with self.assertRaises(ValueError):
+            nlist.weightByDistance('cubic', 1.0)
+
+    def test_relative_orientations(self):
+        nlist = locality.NeighborList.from_arrays(2, 2, [0, 1], [1, 0], [1.0, 3.0])
+        self.assertTrue(nlist.getRelativeOrientations() is None)
+        half = np.sqrt(0.5)
+        orientations = np.array([[1, 0, 0, 0], [half, 0, 0, half]], dtype=np.float32)
+        nlist.computeRelativeOrientations(orientations, orientations)
+        npt.assert_allclose(nlist.getRelativeOrientations(), [[half, 0, 0, half], [half, 0, 0, -half]], atol=1e-6)
+        nlist.computeRelativeAngles([0.5, 3.0], [0.5, 3.0])
+        npt.assert_allclose(nlist.getRelativeAngles(), [2.5, -2.5], rtol=1e-6)
+        # the copies keep them
+        npt.assert_allclose(nlist.copyWithin(2.0).getRelativeAngles(), [2.5], rtol=1e-6)
+
+        # the reverse bonds of a symmetric copy get the inverse rotations
+        single = locality.NeighborList.from_arrays(2, 2, [0], [1], [1.0])
+        single.computeRelativeOrientations(orientations, orientations)
+        single.computeRelativeAngles([0.0, 3.5], [0.0, 3.5])
+        npt.assert_allclose(single.getRelativeAngles(), [3.5 - 2*np.pi], rtol=1e-6)
+        symmetric = single.copySymmetric()
+        npt.assert_allclose(symmetric.getRelativeOrientations(), nlist.getRelativeOrientations(), atol=1e-6)
+        npt.assert_allclose(symmetric.getRelativeAngles(), [3.5 - 2*np.pi, 2*np.pi - 3.5], rtol=1e-6)
+        nlist.clearRelativeOrientations()
+        self.assertTrue(nlist.getRelativeOrientations() is None)
+        self.assertTrue(nlist.getRelativeAngles() is None)
+        with self.assertRaises(ValueError):
+            nlist.computeRelativeAngles([0.0], [0.0, 1.0])
+
+    def test_compressed(self):
+        L = 10
+        rcut = 2
+        N = 500
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        lc = locality.LinkCell(fbox, rcut)
+        lc.computeNlist(fbox, points)
+        nlist = lc.getNlist()
+        bonds = list(zip(nlist.getIndexI().tolist(), nlist.getIndexJ().tolist()))
+        expected = dict(zip(bonds, nlist.getDistances()))
+
+        for half in (False, True):
+            cnlist = locality.CompressedNeighborList().compress(nlist, half_distances=half)
+            self.assertEqual(cnlist.getNumBonds(), nlist.getNumBonds())
+            self.assertEqual(cnlist.hasHalfDistances(), half)
+            self.assertLess(cnlist.getMemoryUsage(), 12*nlist.getNumBonds())
+
+            # the bonds of each reference point come out by point index, with their distances
+            out = cnlist.decompress()
+            npt.assert_equal(out.getSegments(), nlist.getSegments())
+            out_bonds = list(zip(out.getIndexI().tolist(), out.getIndexJ().tolist()))
+            self.assertEqual(out_bonds, sorted(bonds))
+            npt.assert_allclose(out.getDistances(), [expected[b] for b in out_bonds], rtol=(1e-3 if half else 0))
+
+            index_j, distances = cnlist.getBonds(3)
+            segments = out.getSegments()
+            npt.assert_equal(index_j, out.getIndexJ()[segments[3]:segments[4]])
+            npt.assert_equal(distances, out.getDistances()[segments[3]:segments[4]])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,67 @@
+import numpy as np
+import numpy.testing as npt
+from freud import locality, box, density, cluster
+import unittest
+
+class TestNeighborListCache(unittest.TestCase):
+    def tearDown(self):
+        locality.setNlistCache(None)
+
+    def test_reuse(self):
+        L = 10
+        N = 500
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        cache = locality.NeighborListCache(min_rmax=2.0)
+
+        nlist = cache.get(fbox, points, rmax=1.5)
+        self.assertTrue(nlist.isSortedByDistance())
+        self.assertTrue(cache.get(fbox, points, rmax=2.0) is nlist)
+        self.assertEqual(cache.getNumMisses(), 1)
+        self.assertEqual(cache.getNumHits(), 1)
+
+        # a larger cutoff, another box or other positions need another list
+        cache.get(fbox, points, rmax=3.0)
+        cache.get(box.Box.cube(11), points, rmax=1.0)
+        moved = points + np.float32(0.1)
+        cache.get(fbox, moved, rmax=1.0)
+        self.assertEqual(cache.getNumMisses(), 4)
+
+        # the same positions in another array are the same frame
+        self.assertTrue(cache.get(fbox, moved.copy(), rmax=1.0) is not None)
+        self.assertEqual(cache.getNumMisses(), 4)
+
+        cache.clear()
+        self.assertEqual(cache.getNumEntries(), 0)
+
+    def test_analyses(self):
+        L = 10
+        N = 500
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        rdf = density.RDF(2.0, 0.1)
+        rdf.accumulate(fbox, points, points)
+        ld = density.LocalDensity(1.5, 1, 1)
+        ld.compute(fbox, points, points)
+        clust = cluster.Cluster(fbox, 1.0)
+        clust.computeClusters(points)
+        expected_rdf = np.copy(rdf.getRDF())
+        expected_density = np.copy(ld.getDensity())
+        expected_idx = np.copy(clust.getClusterIdx())
+
+        cache = locality.NeighborListCache(min_rmax=2.0)
+        locality.setNlistCache(cache)
+        self.assertTrue(locality.getNlistCache() is cache)
+        rdf = density.RDF(2.0, 0.1)
+        rdf.accumulate(fbox, points, points)
+        ld.compute(fbox, points, points)
+        clust.computeClusters(points)
+        self.assertEqual(cache.getNumMisses(), 1)
+        self.assertEqual(cache.getNumHits(), 2)
+        npt.assert_allclose(rdf.getRDF(), expected_rdf, rtol=1e-5)
+        npt.assert_allclose(ld.getDensity(), expected_density, rtol=1e-5)
+        npt.assert_equal(clust.getClusterIdx(), expected_idx)
+
+if __name__ == '__main__':
+    unittest.main()
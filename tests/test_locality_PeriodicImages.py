@@ -0,0 +1,91 @@
+import numpy as np
+import numpy.testing as npt
+import itertools
+from freud import locality, box
+import unittest
+
+def brute_force_bonds(L, points, rmax, dim=3, exclude_ii=True):
+    """Distances of every bond to the images in a cubic or square box, grouped by pair"""
+    reach = int(np.ceil(rmax/L)) + 1
+    shifts = itertools.product(range(-reach, reach+1), repeat=dim)
+    shifts = np.array([list(s) + [0]*(3 - dim) for s in shifts], dtype=np.float64)*L
+    bonds = {}
+    for i, p in enumerate(points):
+        for j, q in enumerate(points):
+            delta = q - p + shifts
+            r = np.linalg.norm(delta, axis=1)
+            for shift, d in zip(shifts, r):
+                if d >= rmax or (exclude_ii and i == j and not np.any(shift)):
+                    continue
+                bonds.setdefault((i, j), []).append(d)
+    return {pair: sorted(d) for pair, d in bonds.items()}
+
+def nlist_bonds(nlist):
+    bonds = {}
+    for i, j, d in zip(nlist.getIndexI(), nlist.getIndexJ(), nlist.getDistances()):
+        bonds.setdefault((int(i), int(j)), []).append(float(d))
+    return {pair: sorted(d) for pair, d in bonds.items()}
+
+class TestPeriodicImages(unittest.TestCase):
+    def test_needed(self):
+        L = 10
+        self.assertFalse(locality.PeriodicImages.needed(box.Box.cube(L), 0.4*L))
+        self.assertTrue(locality.PeriodicImages.needed(box.Box.cube(L), 0.6*L))
+        self.assertTrue(locality.PeriodicImages.needed(box.Box.square(L), 0.6*L))
+
+    def test_matches_brute_force(self):
+        L = 4
+        rmax = 1.3*L
+        N = 12
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        images = locality.PeriodicImages(fbox, rmax)
+        images.computeNlist(points, store_vectors=True)
+        nlist = images.getNlist()
+        self.assertTrue(np.all(np.diff(nlist.getIndexI().astype(np.int64)) >= 0))
+
+        expected = brute_force_bonds(L, points.astype(np.float64), rmax)
+        found = nlist_bonds(nlist)
+        self.assertEqual(set(found), set(expected))
+        for pair in expected:
+            npt.assert_allclose(found[pair], expected[pair], rtol=1e-4)
+
+        # every vector leads from the reference point to an image of the point
+        vectors = nlist.getVectors()
+        npt.assert_allclose(np.linalg.norm(vectors, axis=1), nlist.getDistances(), rtol=1e-4)
+        delta = points[nlist.getIndexJ()] - points[nlist.getIndexI()] - vectors
+        npt.assert_allclose(delta/L, np.round(delta/L), atol=1e-4)
+
+    def test_2d(self):
+        L = 3
+        rmax = 2.2*L
+        N = 10
+        fbox = box.Box.square(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        points[:, 2] = 0
+
+        images = locality.PeriodicImages(fbox, rmax)
+        images.computeNlist(points)
+        expected = brute_force_bonds(L, points.astype(np.float64), rmax, dim=2)
+        found = nlist_bonds(images.getNlist())
+        self.assertEqual(set(found), set(expected))
+        for pair in expected:
+            npt.assert_allclose(found[pair], expected[pair], rtol=1e-4)
+
+    def test_kdtree_fallback(self):
+        L = 5
+        N = 20
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+
+        tree = locality.KDTree()
+        tree.computeNlist(fbox, points, rmax=0.8*L)
+        images = locality.PeriodicImages(fbox, 0.8*L)
+        images.computeNlist(points)
+        npt.assert_equal(tree.getNlist().getIndexI(), images.getNlist().getIndexI())
+        npt.assert_equal(tree.getNlist().getIndexJ(), images.getNlist().getIndexJ())
+        npt.assert_allclose(tree.getNlist().getDistances(), images.getNlist().getDistances())
+
+if __name__ == '__main__':
+    unittest.main()
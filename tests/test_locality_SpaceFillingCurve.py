@@ -0,0 +1,40 @@
+import numpy as np
+import numpy.testing as npt
+from freud import locality, box
+import unittest
+
+class TestSpaceFillingCurve(unittest.TestCase):
+    def test_hilbert_grid(self):
+        # consecutive points of a 2^k grid along the Hilbert curve are neighbors on the grid
+        for is2D in [False, True]:
+            fbox = box.Box.square(8) if is2D else box.Box.cube(8)
+            grid = np.arange(8, dtype=np.float32) + 0.5 - 4
+            zs = [0] if is2D else grid
+            points = np.array([[x, y, z] for x in grid for y in grid for z in zs], dtype=np.float32)
+            np.random.shuffle(points)
+            curve = locality.SpaceFillingCurve('hilbert')
+            curve.compute(fbox, points)
+            steps = np.linalg.norm(np.diff(points[curve.getOrder()], axis=0), axis=1)
+            npt.assert_allclose(steps, 1, rtol=1e-5)
+
+    def test_reorder_restore(self):
+        fbox = box.Box.cube(10)
+        points = np.random.uniform(-5, 5, size=(1000, 3)).astype(np.float32)
+        for name in ['hilbert', 'morton']:
+            curve = locality.SpaceFillingCurve(name)
+            curve.compute(fbox, points)
+            order = curve.getOrder()
+            npt.assert_equal(np.sort(order), np.arange(len(points)))
+            npt.assert_equal(curve.getInverse()[order], np.arange(len(points)))
+
+            reordered = np.copy(points)
+            curve.reorder(reordered)
+            npt.assert_equal(reordered, points[order])
+            curve.restore(reordered)
+            npt.assert_equal(reordered, points)
+
+            with self.assertRaises(ValueError):
+                curve.reorder(np.zeros(10))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,46 @@
+import numpy as np
+import numpy.testing as npt
+from freud import locality, box
+import unittest
+
+class TestVerletList(unittest.TestCase):
+    def test_matches_linkcell(self):
+        L = 10 #Box Dimensions
+        rcut = 1.5 #Cutoff radius
+        N = 500 # number of particles
+
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        vlist = locality.VerletList(rcut, 0.8)
+
+        for frame in range(10):
+            points += np.random.uniform(-0.02, 0.02, (N, 3)).astype(np.float32)
+            points -= L*np.round(points/L)
+            vlist.compute(fbox, points)
+            lc = locality.LinkCell(fbox, rcut)
+            lc.computeNlist(fbox, points)
+            expected = set(zip(lc.getNlist().getIndexI().tolist(), lc.getNlist().getIndexJ().tolist()))
+            nlist = vlist.getNlist()
+            found = set(zip(nlist.getIndexI().tolist(), nlist.getIndexJ().tolist()))
+            self.assertEqual(found, expected)
+
+        # each particle moved at most 0.35, so no pair distance changed by more than the skin and the first
+        # candidate list was reused for every frame
+        self.assertEqual(vlist.getNumBuilds(), 1)
+
+    def test_rebuild(self):
+        L = 10
+        N = 100
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        vlist = locality.VerletList(1.5, 0.2)
+        vlist.compute(fbox, points)
+        points[0] += 0.5
+        vlist.compute(fbox, points)
+        self.assertEqual(vlist.getNumBuilds(), 2)
+        vlist.reset()
+        vlist.compute(fbox, points)
+        self.assertEqual(vlist.getNumBuilds(), 3)
+
+if __name__ == '__main__':
+    unittest.main()
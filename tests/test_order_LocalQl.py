@@ -0,0 +1,46 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, locality, order
+import unittest
+
+class TestLocalQl(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+        self.box = box.Box.cube(10.0)
+        self.points = (np.random.random_sample((500, 3))*10 - 5).astype(np.float32)
+
+    def test_fcc_shell(self):
+        # every particle of an fcc crystal has the same 12 neighbors
+        grid = np.arange(4)
+        cells = np.array(np.meshgrid(grid, grid, grid)).reshape(3, -1).T
+        basis = np.array([[0, 0, 0], [0.5, 0.5, 0], [0.5, 0, 0.5], [0, 0.5, 0.5]])
+        points = (cells[:, None, :] + basis[None, :, :]).reshape(-1, 3)*2.0
+        points = (points - 4.0).astype(np.float32)
+        fbox = box.Box.cube(8.0)
+
+        ql = order.LocalQl(fbox, 1.6, 6)
+        ql.compute(points)
+        npt.assert_allclose(ql.getQl(), 0.57452416, rtol=1e-4)
+        ql.computeAve(points)
+        npt.assert_allclose(ql.getAveQl(), 0.57452416, rtol=1e-4)
+        ql.computeNorm(points)
+        npt.assert_allclose(ql.getQlNorm(), 0.57452416, rtol=1e-4)
+
+    def test_nlist(self):
+        rmax = 1.5
+        ql = order.LocalQl(self.box, rmax, 6)
+        ql.compute(self.points)
+        Ql = np.copy(ql.getQl())
+        ql.computeAve(self.points)
+        AveQl = np.copy(ql.getAveQl())
+
+        lc = locality.LinkCell(self.box, 2*rmax)
+        lc.computeNlist(self.box, self.points)
+        nlist = lc.getNlist()
+        ql.compute(self.points, nlist)
+        npt.assert_allclose(ql.getQl(), Ql, rtol=1e-5, atol=1e-6)
+        ql.computeAve(self.points, nlist)
+        npt.assert_allclose(ql.getAveQl(), AveQl, rtol=1e-5, atol=1e-6)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,43 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, locality, order
+import unittest
+
+class TestLocalQlNear(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+        self.box = box.Box.cube(10.0)
+        self.points = (np.random.random_sample((500, 3))*10 - 5).astype(np.float32)
+
+    def test_nlist(self):
+        rmax = 1.5
+        kn = 12
+        ql = order.LocalQlNear(self.box, rmax, 6, kn)
+        ql.compute(self.points)
+        Ql = np.copy(ql.getQl())
+        ql.computeAve(self.points)
+        AveQl = np.copy(ql.getAveQl())
+
+        nn = locality.NearestNeighbors(rmax, kn)
+        nn.compute(self.box, self.points, self.points)
+        nlist = nn.getNlist()
+        ql.compute(self.points, nlist)
+        npt.assert_allclose(ql.getQl(), Ql, rtol=1e-5, atol=1e-6)
+        ql.computeAve(self.points, nlist)
+        npt.assert_allclose(ql.getAveQl(), AveQl, rtol=1e-5, atol=1e-6)
+
+    def test_wl_nlist(self):
+        # the nearest neighbors given to LocalWl give the Wl of LocalWlNear
+        rmax = 1.5
+        kn = 12
+        wl_near = order.LocalWlNear(self.box, rmax, 6, kn)
+        wl_near.compute(self.points)
+
+        nn = locality.NearestNeighbors(rmax, kn)
+        nn.compute(self.box, self.points, self.points)
+        wl = order.LocalWl(self.box, 4.0, 6)
+        wl.compute(self.points, nn.getNlist())
+        npt.assert_allclose(wl.getWl(), wl_near.getWl(), rtol=1e-4, atol=1e-6)
+
+if __name__ == '__main__':
+    unittest.main()
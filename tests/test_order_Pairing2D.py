@@ -0,0 +1,40 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, locality, order
+import unittest
+
+class TestPairing2D(unittest.TestCase):
+    def setUp(self):
+        # particles 0 and 1 point at each other from 1 apart
+        # particles 2 and 3 point at each other from 1.5 apart
+        self.fbox = box.Box.square(20)
+        self.points = np.array([[0, 0, 0], [1, 0, 0], [5, 5, 0], [5, 6.5, 0]], dtype=np.float32)
+        self.orientations = np.array([0, np.pi/2, 0, 0], dtype=np.float32)
+        # complementary orientations are relative to the orientation of each particle
+        self.comp = np.array([[0, np.pi/2], [np.pi/2, 0], [np.pi/2, np.pi/2], [-np.pi/2, -np.pi/2]],
+                             dtype=np.float32)
+
+    def test_pairs(self):
+        pairing = order.Pairing2D(1.2, 3, 0.1)
+        pairing.compute(self.fbox, self.points, self.orientations, self.comp)
+        npt.assert_equal(pairing.getMatch(), [1, 1, 0, 0])
+        npt.assert_equal(pairing.getPair(), [1, 0, 2, 3])
+
+    def test_tolerance(self):
+        # turning particle 1 away by more than the tolerance breaks its pair
+        self.orientations[1] += 0.2
+        pairing = order.Pairing2D(1.2, 3, 0.1)
+        pairing.compute(self.fbox, self.points, self.orientations, self.comp)
+        npt.assert_equal(pairing.getMatch(), [0, 0, 0, 0])
+        npt.assert_equal(pairing.getPair(), [0, 1, 2, 3])
+
+    def test_nlist(self):
+        pairing = order.Pairing2D(2.0, 3, 0.1)
+        lc = locality.LinkCell(self.fbox, 2.0)
+        lc.computeNlist(self.fbox, self.points, self.points)
+        pairing.compute(self.fbox, self.points, self.orientations, self.comp, nlist=lc.getNlist())
+        npt.assert_equal(pairing.getMatch(), [1, 1, 1, 1])
+        npt.assert_equal(pairing.getPair(), [1, 0, 3, 2])
+
+if __name__ == '__main__':
+    unittest.main()
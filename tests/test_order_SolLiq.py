@@ -0,0 +1,43 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, order
+import unittest
+
+class TestSolLiq(unittest.TestCase):
+    def setUp(self):
+        # every particle of an fcc crystal has 12 neighbors with the same environment
+        grid = np.arange(4)
+        cells = np.array(np.meshgrid(grid, grid, grid)).reshape(3, -1).T
+        basis = np.array([[0, 0, 0], [0.5, 0.5, 0], [0.5, 0, 0.5], [0, 0.5, 0.5]])
+        points = (cells[:, None, :] + basis[None, :, :]).reshape(-1, 3)*2.0
+        self.points = (points - 4.0).astype(np.float32)
+        self.box = box.Box.cube(8.0)
+
+    def test_fcc(self):
+        sl = order.SolLiq(self.box, 1.6, 0.7, 6, 6)
+        sl.compute(self.points)
+        npt.assert_equal(sl.getNumberOfConnections(), 12)
+        npt.assert_equal(sl.getClusters(), 0)
+        self.assertEqual(sl.getLargestClusterSize(), len(self.points))
+
+    def test_fcc_variant(self):
+        # two nearest neighbors in fcc share 4 neighbors
+        sl = order.SolLiq(self.box, 1.6, 0.7, 3, 6)
+        sl.computeSolLiqVariant(self.points)
+        self.assertEqual(sl.getLargestClusterSize(), len(self.points))
+        sl = order.SolLiq(self.box, 1.6, 0.7, 4, 6)
+        sl.computeSolLiqVariant(self.points)
+        npt.assert_equal(sl.getClusters(), np.arange(len(self.points)))
+
+    def test_liquid(self):
+        np.random.seed(0)
+        points = (np.random.random_sample((1000, 3))*8 - 4).astype(np.float32)
+        sl = order.SolLiq(self.box, 1.2, 0.7, 6, 6)
+        sl.compute(points)
+        clusters = sl.getClusters()
+        # clusters are numbered from 0 in the order of their first particle
+        first = [np.argmax(clusters == c) for c in range(sl.getNumClusters())]
+        self.assertEqual(first, sorted(first))
+
+if __name__ == '__main__':
+    unittest.main()
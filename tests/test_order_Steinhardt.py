@@ -0,0 +1,43 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, order
+import unittest
+
+def make_fcc(nx, a):
+    grid = np.arange(nx)
+    cells = np.array(np.meshgrid(grid, grid, grid)).reshape(3, -1).T
+    basis = np.array([[0, 0, 0], [0.5, 0.5, 0], [0.5, 0, 0.5], [0, 0.5, 0.5]])
+    points = (cells[:, None, :] + basis[None, :, :]).reshape(-1, 3)*a
+    return (points - nx*a/2).astype(np.float32)
+
+class TestSteinhardt(unittest.TestCase):
+    def test_fcc(self):
+        points = make_fcc(4, 2.0)
+        fbox = box.Box.cube(8.0)
+        st = order.Steinhardt(fbox, 1.6, [4, 6])
+        st.enableNormalization()
+        st.compute(points)
+        self.assertEqual(st.getL(), [4, 6])
+        self.assertEqual(st.getQl().shape, (len(points), 2))
+        npt.assert_allclose(st.getQl()[:, 0], 0.19094065, rtol=1e-4)
+        npt.assert_allclose(st.getQl()[:, 1], 0.57452416, rtol=1e-4)
+        npt.assert_allclose(st.getAveQl(), st.getQl(), rtol=1e-4)
+        npt.assert_allclose(st.getWl().real[:, 0], -0.15931737, rtol=1e-3)
+        npt.assert_allclose(st.getWl().real[:, 1], -0.01316134, rtol=1e-3)
+        npt.assert_allclose(st.getWl().imag, 0, atol=1e-5)
+
+    def test_same_as_LocalQl(self):
+        np.random.seed(0)
+        rbox = box.Box.cube(10.0)
+        points = (np.random.random_sample((500, 3))*10 - 5).astype(np.float32)
+        l_values = [4, 6, 8]
+        st = order.Steinhardt(rbox, 1.5, l_values)
+        st.compute(points)
+        for i, l in enumerate(l_values):
+            ql = order.LocalQl(rbox, 1.5, l)
+            ql.computeAve(points)
+            npt.assert_allclose(st.getQl()[:, i], ql.getQl(), rtol=1e-4, atol=1e-6)
+            npt.assert_allclose(st.getAveQl()[:, i], ql.getAveQl(), rtol=1e-4, atol=1e-6)
+
+if __name__ == '__main__':
+    unittest.main()
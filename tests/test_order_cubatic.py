@@ -1,7 +1,7 @@
 import numpy as np
 import numpy.testing as npt
 from freud.order import CubaticOrderParameter as cop
-from freud import box
+from freud import box, parallel
 import unittest
 
 def gen_quaternions(n, axes, angles):
@@ -59,6 +59,59 @@ class TestCluster(unittest.TestCase):
 
         npt.assert_array_less(op, 0.3, err_msg="Cubatic Order is > 0.3")
 
+    def test_particle_tensor(self):
+        N = 10
+        axes = np.zeros(shape=(N, 3), dtype=np.float32)
+        axes[:,0] = 1.0
+        angles = np.linspace(0, np.pi/4, N)
+        orientations = gen_quaternions(N, axes, angles)
+
+        cubaticOP = cop(5.0, 0.001, 0.95, 4, seed=20)
+        cubaticOP.compute(orientations)
+
+        # 2 sum_k u_k x u_k x u_k x u_k over the rotated axes u_k of each particle
+        tensors = cubaticOP.get_particle_tensor()
+        for i in range(N):
+            c, s = np.cos(angles[i]), np.sin(angles[i])
+            rot = np.array([[1, 0, 0], [0, c, -s], [0, s, c]])
+            expected = 2*sum(np.einsum("i,j,k,l->ijkl", u, u, u, u) for u in rot.T)
+            npt.assert_allclose(tensors[i], expected, atol=1e-5)
+
+        # the cubatic tensor is the one of the cubatic orientation
+        q = cubaticOP.get_orientation().astype(np.float64)
+        q /= np.linalg.norm(q)
+        w, x, y, z = q
+        rot = np.array([[w*w+x*x-y*y-z*z, 2*(x*y-w*z), 2*(x*z+w*y)],
+                        [2*(x*y+w*z), w*w-x*x+y*y-z*z, 2*(y*z-w*x)],
+                        [2*(x*z-w*y), 2*(y*z+w*x), w*w-x*x-y*y+z*z]])
+        expected = 2*sum(np.einsum("i,j,k,l->ijkl", u, u, u, u) for u in rot.T) - cubaticOP.get_gen_r4_tensor()
+        npt.assert_allclose(cubaticOP.get_cubatic_tensor(), expected, atol=1e-4)
+
+        # the order parameter of each particle compares its tensor with the cubatic tensor
+        cubatic = cubaticOP.get_cubatic_tensor()
+        diff = tensors - cubaticOP.get_gen_r4_tensor() - cubatic
+        expected_op = 1 - np.sum(diff*diff, axis=(1, 2, 3, 4))/np.sum(cubatic*cubatic)
+        npt.assert_allclose(cubaticOP.get_particle_op(), expected_op, atol=1e-4)
+
+
+    def test_thread_count_independent(self):
+        N = 200
+        np.random.seed(0)
+        axes = np.random.normal(size=(N, 3))
+        axes /= np.linalg.norm(axes, axis=1)[:, np.newaxis]
+        angles = np.random.uniform(0, np.pi/8, N)
+        orientations = gen_quaternions(N, axes, angles)
+
+        # every replicate has a random stream of its own, whichever thread anneals it
+        results = []
+        for nthreads in [1, 4]:
+            parallel.setNumThreads(nthreads)
+            cubaticOP = cop(5.0, 0.001, 0.95, 8, seed=20)
+            cubaticOP.compute(orientations)
+            results.append((cubaticOP.get_cubatic_order_parameter(), cubaticOP.get_orientation()))
+        parallel.setNumThreads()
+        npt.assert_equal(results[0][0], results[1][0])
+        npt.assert_equal(results[0][1], results[1][1])
 
 if __name__ == '__main__':
     unittest.main()
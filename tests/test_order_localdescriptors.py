@@ -2,6 +2,8 @@ import numpy as np
 import numpy.testing as npt
 import freud
 from freud.order import LocalDescriptors
+from freud._freud import _symmetric_eigen3
+from scipy.special import sph_harm
 import unittest
 
 class TestLocalDescriptors(unittest.TestCase):
@@ -107,5 +109,216 @@ class TestLocalDescriptors(unittest.TestCase):
         with self.assertRaises(RuntimeError):
             comp.compute(box, Nneigh, positions)
 
+    def test_real_output(self):
+        N = 100
+        Nneigh = 4
+        lmax = 8
+
+        box = freud.box.Box.cube(10)
+        positions = np.random.uniform(-box.getLx()/2, box.getLx()/2, size=(N, 3)).astype(np.float32)
+
+        comp = LocalDescriptors(Nneigh, lmax, .5, True)
+        comp.computeNList(box, positions)
+        comp.compute(box, Nneigh, positions, mode='global')
+        sphs = np.copy(comp.getSph())
+
+        real = LocalDescriptors(Nneigh, lmax, .5, True, output='real')
+        real.computeNList(box, positions)
+        real.compute(box, Nneigh, positions, mode='global')
+        real_sphs = real.getSph()
+        self.assertEqual(real_sphs.dtype, np.float32)
+        self.assertEqual(real_sphs.shape, sphs.shape)
+
+        # Y_l0, sqrt(2) Re Y_lm, then sqrt(2) Im Y_lm of each l
+        expected = []
+        start = 0
+        for l in range(lmax + 1):
+            positive = sphs[..., start:start + l + 1]
+            expected.extend([positive[..., :1].real, np.sqrt(2)*positive[..., 1:].real, np.sqrt(2)*positive[..., 1:].imag])
+            start += 2*l + 1
+        npt.assert_allclose(real_sphs, np.concatenate(expected, axis=-1), atol=1e-5)
+
+        half = LocalDescriptors(Nneigh, lmax, .5, True, output='real_half')
+        half.computeNList(box, positions)
+        half.compute(box, Nneigh, positions, mode='global')
+        half_sphs = half.getSph()
+        self.assertEqual(half_sphs.dtype, np.float16)
+        npt.assert_equal(half_sphs, real_sphs.astype(np.float16))
+
+        with self.assertRaises(RuntimeError):
+            LocalDescriptors(Nneigh, lmax, .5, True, output='double')
+
+    def test_nlist(self):
+        N = 100
+        Nneigh = 4
+        lmax = 8
+
+        box = freud.box.Box.cube(10)
+        positions = np.random.uniform(-box.getLx()/2, box.getLx()/2, size=(N, 3)).astype(np.float32)
+
+        comp = LocalDescriptors(Nneigh, lmax, .5, True)
+        comp.computeNList(box, positions)
+        comp.compute(box, Nneigh, positions)
+        sphs = np.copy(comp.getSph())
+
+        # one row per bond of the list, no computeNList needed
+        nn = freud.locality.NearestNeighbors(.5, Nneigh)
+        nn.compute(box, positions, positions)
+        nlist = nn.getNlist()
+        bond_comp = LocalDescriptors(Nneigh, lmax, .5, True)
+        bond_comp.compute(box, 0, positions, nlist=nlist)
+        bond_sphs = bond_comp.getSph()
+        self.assertEqual(bond_sphs.shape, (nlist.getNumBonds(), comp.getSph().shape[2]))
+
+        segments = nlist.getSegments()
+        for i in range(N):
+            num_bonds = segments[i+1] - segments[i]
+            npt.assert_allclose(bond_sphs[segments[i]:segments[i+1]], sphs[i, :num_bonds], atol=1e-5)
+
+    def test_power_spectrum(self):
+        N = 100
+        Nneigh = 8
+        lmax = 8
+
+        box = freud.box.Box.cube(10)
+        positions = np.random.uniform(-box.getLx()/2, box.getLx()/2, size=(N, 3)).astype(np.float32)
+
+        comp = LocalDescriptors(Nneigh, lmax, .5, True)
+        comp.computeNList(box, positions)
+        comp.compute(box, Nneigh, positions, mode='global')
+        Qlm = np.mean(comp.getSph(), axis=1)
+
+        power = LocalDescriptors(Nneigh, lmax, .5, True, output='power_spectrum')
+        power.computeNList(box, positions)
+        power.compute(box, Nneigh, positions)
+        spectrum = np.copy(power.getInvariants())
+        self.assertEqual(spectrum.shape, (N, lmax + 1))
+
+        expected = []
+        start = 0
+        for l in range(lmax + 1):
+            expected.append(np.sum(np.abs(Qlm[:, start:start + 2*l + 1])**2, axis=-1))
+            start += 2*l + 1
+        npt.assert_allclose(spectrum, np.array(expected).T, atol=1e-5)
+
+        with self.assertRaises(RuntimeError):
+            power.getSph()
+
+        # the same for the bonds rotated about z by 90 degrees
+        rotated = np.array(positions[:, [1, 0, 2]])
+        rotated[:, 0] *= -1
+        power.computeNList(box, rotated)
+        power.compute(box, Nneigh, rotated)
+        npt.assert_allclose(power.getInvariants(), spectrum, atol=1e-5)
+
+    def test_sph_values(self):
+        lmax = 8
+        # bond counts below, at and above the 32 bond blocks of the kernel, the last block of the third particle
+        # being partial
+        num_bonds = [1, 32, 45]
+        np.random.seed(0)
+        box = freud.box.Box.cube(100)
+        points_ref = np.zeros((len(num_bonds), 3), dtype=np.float32)
+        points_ref[:, 0] = 10*np.arange(len(num_bonds))
+        index_i = np.repeat(np.arange(len(num_bonds)), num_bonds)
+        bonds = np.random.normal(size=(len(index_i), 3)).astype(np.float32)
+        points = points_ref[index_i] + bonds
+        nlist = freud.locality.NeighborList.from_arrays(len(num_bonds), len(points), index_i,
+                                                        np.arange(len(points)), np.linalg.norm(bonds, axis=-1))
+
+        comp = LocalDescriptors(0, lmax, .5, True)
+        comp.compute(box, 0, points_ref, points, mode='global', nlist=nlist)
+        sphs = comp.getSph()
+        self.assertEqual(sphs.shape[0], len(points))
+
+        # scipy includes the Condon-Shortley phase, which fsph does not
+        bonds = points - points_ref[index_i]
+        polar = np.arccos(bonds[:, 2]/np.linalg.norm(bonds, axis=-1))
+        azimuthal = np.arctan2(bonds[:, 1], bonds[:, 0])
+        expected = []
+        for l in range(lmax + 1):
+            for m in list(range(l + 1)) + list(range(-1, -l - 1, -1)):
+                expected.append((-1)**abs(m)*sph_harm(m, l, azimuthal, polar))
+        npt.assert_allclose(sphs, np.array(expected).T, atol=1e-5)
+
+    def test_degenerate_neighborhood(self):
+        # a square of bonds has a repeated moment of inertia, so the principal axes come from the iterative fallback
+        lmax = 4
+        box = freud.box.Box.cube(100)
+        points_ref = np.zeros((1, 3), dtype=np.float32)
+        points = np.array([[1, 0, 0], [0, 1, 0], [-1, 0, 0], [0, -1, 0]], dtype=np.float32)
+        nlist = freud.locality.NeighborList.from_arrays(1, len(points), np.zeros(len(points), dtype=np.uint32),
+                                                        np.arange(len(points)), np.ones(len(points)))
+
+        comp = LocalDescriptors(0, lmax, .5, True)
+        comp.compute(box, 0, points_ref, points, mode='global', nlist=nlist)
+        global_sphs = np.copy(comp.getSph())
+        comp.compute(box, 0, points_ref, points, mode='neighborhood', nlist=nlist)
+        sphs = comp.getSph()
+        self.assertTrue(np.all(np.isfinite(sphs)))
+
+        # the rotation into the principal axes leaves the power spectrum unchanged
+        start = 0
+        for l in range(lmax + 1):
+            block = slice(start, start + 2*l + 1)
+            npt.assert_allclose(np.sum(np.abs(np.mean(sphs[:, block], axis=0))**2),
+                                np.sum(np.abs(np.mean(global_sphs[:, block], axis=0))**2), atol=1e-5)
+            start += 2*l + 1
+
+class TestSymmetricEigen(unittest.TestCase):
+    def check_decomposition(self, A, evalues, evectors):
+        npt.assert_allclose(np.dot(A, evectors), evectors*evalues[np.newaxis, :], atol=1e-10)
+        npt.assert_allclose(np.dot(evectors.T, evectors), np.eye(3), atol=1e-10)
+        self.assertTrue(np.all(np.diff(evalues) >= 0))
+
+    def random_rotation(self):
+        Q, R = np.linalg.qr(np.random.normal(size=(3, 3)))
+        return Q*np.sign(np.diag(R))[np.newaxis, :]
+
+    def test_random(self):
+        np.random.seed(0)
+        for _ in range(100):
+            A = np.random.uniform(-1, 1, size=(3, 3))
+            A = A + A.T
+            evalues, evectors, ok = _symmetric_eigen3(A)
+            self.assertTrue(ok)
+            npt.assert_allclose(evalues, np.linalg.eigvalsh(A), atol=1e-9)
+            self.check_decomposition(A, evalues, evectors)
+
+    def test_diagonal(self):
+        A = np.diag([3., 1., 2.])
+        evalues, evectors, ok = _symmetric_eigen3(A)
+        self.assertTrue(ok)
+        npt.assert_allclose(evalues, [1, 2, 3], atol=1e-12)
+        self.check_decomposition(A, evalues, evectors)
+        npt.assert_allclose(np.abs(evectors), np.eye(3)[:, [1, 2, 0]], atol=1e-12)
+
+    def test_repeated(self):
+        # the eigenvectors of a repeated eigenvalue are left to the iterative fallback, but the eigenvalues are
+        # still given
+        np.random.seed(1)
+        for diagonal in ([1., 1., 2.], [-1., 3., 3.], [0., 0., 5.]):
+            R = self.random_rotation()
+            A = np.dot(R*np.array(diagonal)[np.newaxis, :], R.T)
+            A = 0.5*(A + A.T)
+            evalues, evectors, ok = _symmetric_eigen3(A)
+            self.assertFalse(ok)
+            npt.assert_allclose(evalues, sorted(diagonal), rtol=1e-6, atol=1e-6)
+
+        # nearly repeated eigenvalues also fall back
+        A = np.diag([1., 1. + 1e-6, 2.])
+        evalues, evectors, ok = _symmetric_eigen3(A)
+        self.assertFalse(ok)
+        npt.assert_allclose(evalues, [1, 1 + 1e-6, 2], atol=1e-6)
+
+    def test_triple(self):
+        for scale in (0., 1., -2.5):
+            A = scale*np.eye(3)
+            evalues, evectors, ok = _symmetric_eigen3(A)
+            self.assertTrue(ok)
+            npt.assert_allclose(evalues, [scale]*3)
+            npt.assert_allclose(evectors, np.eye(3))
+            self.check_decomposition(A, evalues, evectors)
+
 if __name__ == '__main__':
     unittest.main()
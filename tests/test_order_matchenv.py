@@ -256,5 +256,58 @@ class TestCluster(unittest.TestCase):
         npt.assert_almost_equal(e0, refPoints2[np.asarray(list(isSim_vec_map.values()))])
 
 
+    #test that the accelerated and the random triplet registrations find the same mapping and RMSD
+    def test_accelerated_registration(self):
+        np.random.seed(0)
+        e0 = np.random.normal(size=(8, 3)).astype(np.float32)
+        # a rotated and re-indexed copy of the motif
+        theta = 0.7
+        c = np.cos(theta)
+        s = np.sin(theta)
+        rotation = np.array([[c, -s, 0], [s, c, 0], [0, 0, 1]])
+        e1 = np.dot(e0, rotation.T).astype(np.float32)
+        np.random.shuffle(e1)
+
+        match = MatchEnv(box.Box.cube(10), 2, len(e0))
+        self.assertTrue(match.getAcceleratedRegistration())
+        results = []
+        for accelerated in [True, False]:
+            match.setAcceleratedRegistration(accelerated)
+            self.assertEqual(match.getAcceleratedRegistration(), accelerated)
+            [min_rmsd, refPoints2, vec_map] = match.minimizeRMSD(e0, e1, registration=True)
+            [sim_points, sim_map] = match.isSimilar(e0, e1, 0.01, registration=True)
+            results.append((min_rmsd, refPoints2, dict(vec_map), dict(sim_map)))
+        npt.assert_almost_equal(results[0][0], 0., decimal=5)
+        npt.assert_almost_equal(results[1][0], results[0][0], decimal=5)
+        npt.assert_allclose(results[1][1], results[0][1], atol=1e-5)
+        self.assertEqual(results[1][2], results[0][2])
+        self.assertEqual(len(results[0][3]), len(e0))
+        self.assertEqual(results[1][3], results[0][3])
+
+    #test MatchEnv.matchMotifs against MatchEnv.matchMotif, with a motif that matches nothing ahead of the BCC motif
+    def test_match_motifs(self):
+        xyz = np.load("bcc.npy")
+        xyz = np.array(xyz, dtype=np.float32)
+        L = np.max(xyz)*2
+        fbox = box.Box.cube(L)
+
+        rcut = 3.1
+        kn = 14
+        threshold = 0.1
+
+        bcc_env = np.array(np.load("bcc_env.npy"), dtype=np.float32)
+        motifs = np.array([1.5*bcc_env, bcc_env], dtype=np.float32)
+
+        match = MatchEnv(fbox, rcut, kn)
+        match.matchMotif(xyz, bcc_env, threshold)
+        clusters = np.copy(match.getClusters())
+        motif_index = match.matchMotifs(xyz, motifs, threshold)
+
+        npt.assert_equal(motif_index.shape, (len(xyz),))
+        npt.assert_equal(np.any(clusters == 0), True, err_msg="BCC motif match fail")
+        npt.assert_equal(motif_index, np.where(clusters == 0, 1, 2), err_msg="BCC motifs match fail")
+        # the clusters of matchMotif are left as they are
+        npt.assert_equal(match.getClusters(), clusters)
+
 if __name__ == '__main__':
     unittest.main()
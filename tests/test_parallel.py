@@ -0,0 +1,207 @@
+from freud import box, cluster, density, locality, parallel
+import numpy as np
+import numpy.testing as npt
+import os
+import tempfile
+import threading
+import unittest
+
+class TestThreadArena(unittest.TestCase):
+    def test_execute(self):
+        arena = parallel.ThreadArena(1)
+        self.assertEqual(arena.getNumThreads(), 1)
+        self.assertIsNone(arena.getNumaNode())
+        self.assertEqual(arena.execute(lambda a, b=0: a + b, 1, b=2), 3)
+        with self.assertRaises(ValueError):
+            arena.execute(int, 'x')
+
+    def test_concurrent(self):
+        fbox = box.Box.cube(10)
+        np.random.seed(0)
+        points = np.random.uniform(-5, 5, size=(1000, 3)).astype(np.float32)
+        expected = density.RDF(4, 0.1)
+        expected.compute(fbox, points, points)
+
+        results = [None]*2
+        def run(i):
+            rdf = density.RDF(4, 0.1)
+            parallel.ThreadArena(1).execute(rdf.compute, fbox, points, points)
+            results[i] = np.copy(rdf.getRDF())
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(2)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        for result in results:
+            npt.assert_allclose(result, expected.getRDF(), rtol=1e-5)
+
+class TestAnnotation(unittest.TestCase):
+    def test_annotated_rdf(self):
+        # the annotations must not change the results, whether they are compiled in or not
+        self.assertIn(parallel.isAnnotationEnabled(), (True, False))
+        fbox = box.Box.cube(10)
+        np.random.seed(0)
+        points = np.random.uniform(-5, 5, size=(1000, 3)).astype(np.float32)
+        rdf = density.RDF(4, 0.1)
+        rdf.compute(fbox, points, points)
+        serial = density.RDF(4, 0.1)
+        parallel.ThreadArena(1).execute(serial.compute, fbox, points, points)
+        npt.assert_allclose(rdf.getRDF(), serial.getRDF(), rtol=1e-5)
+
+class TestSubmit(unittest.TestCase):
+    def test_submit(self):
+        self.assertEqual(parallel.submit(lambda a, b=0: a + b, 1, b=2).result(), 3)
+        with self.assertRaises(ValueError):
+            parallel.submit(int, 'x').result()
+
+    def test_accumulate_async(self):
+        fbox = box.Box.cube(10)
+        np.random.seed(0)
+        frames = np.random.uniform(-5, 5, size=(3, 1000, 3)).astype(np.float32)
+        expected = density.RDF(4, 0.1)
+        for points in frames:
+            expected.accumulate(fbox, points, points)
+
+        rdf = density.RDF(4, 0.1)
+        futures = [rdf.accumulateAsync(fbox, points, points) for points in frames]
+        # the calls run in order, so the last one done means they all are
+        futures[-1].result()
+        self.assertTrue(all(f.done() for f in futures))
+        npt.assert_allclose(rdf.getRDF(), expected.getRDF(), rtol=1e-5)
+
+class TestFramePipeline(unittest.TestCase):
+    def test_run(self):
+        fbox = box.Box.cube(10)
+        np.random.seed(0)
+        frames = np.random.uniform(-5, 5, size=(6, 500, 3)).astype(np.float32)
+        expected = density.RDF(4, 0.1)
+        for points in frames[1::2]:
+            expected.accumulate(fbox, points, points)
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            filename = os.path.join(tmpdir, 'traj.npy')
+            np.save(filename, frames)
+            pipeline = parallel.FramePipeline(filename, max_in_flight=2)
+            self.assertEqual(pipeline.getNumFrames(), 6)
+            self.assertEqual(pipeline.getNP(), 500)
+
+            rdf = density.RDF(4, 0.1)
+            seen = []
+            pipeline.add(lambda b, points, frame: rdf.accumulate(b, points, points))
+            pipeline.add(lambda b, points, frame: seen.append(frame))
+            self.assertEqual(pipeline.run(fbox, start=1, step=2), 3)
+            self.assertEqual(seen, [1, 3, 5])
+            npt.assert_allclose(rdf.getRDF(), expected.getRDF(), rtol=1e-5)
+
+            # the first error stops the run
+            def fail(b, points, frame):
+                if frame == 2:
+                    raise ValueError('frame 2')
+            pipeline.clear()
+            seen = []
+            pipeline.add(fail)
+            pipeline.add(lambda b, points, frame: seen.append(frame))
+            with self.assertRaises(ValueError):
+                pipeline.run(fbox)
+            self.assertEqual(seen, [0, 1])
+            del pipeline
+
+class _ThreadComm(object):
+    """Collectives of mpi4py between the threads of a test, one per rank"""
+    def __init__(self, rank, shared):
+        self.rank = rank
+        self.shared = shared
+
+    def Get_rank(self):
+        return self.rank
+
+    def Get_size(self):
+        return self.shared['size']
+
+    def _share(self, value):
+        # every rank puts its value and gets those of all the ranks
+        self.shared['barrier'].wait()
+        self.shared['values'][self.rank] = value
+        self.shared['barrier'].wait()
+        values = list(self.shared['values'])
+        self.shared['barrier'].wait()
+        return values
+
+    def alltoall(self, values):
+        return [v[self.rank] for v in self._share(values)]
+
+    def gather(self, value, root=0):
+        values = self._share(value)
+        return values if self.rank == root else None
+
+    def scatter(self, values, root=0):
+        return self._share(values)[root][self.rank]
+
+    def allreduce(self, value):
+        return sum(self._share(value))
+
+    def exscan(self, value):
+        values = self._share(value)
+        return sum(values[:self.rank]) if self.rank > 0 else None
+
+def _runRanks(num_ranks, func):
+    shared = {'size': num_ranks, 'barrier': threading.Barrier(num_ranks), 'values': [None]*num_ranks}
+    results = [None]*num_ranks
+    def run(rank):
+        results[rank] = func(_ThreadComm(rank, shared))
+    threads = [threading.Thread(target=run, args=(rank,)) for rank in range(num_ranks)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return results
+
+class TestDomains(unittest.TestCase):
+    def test_rdf(self):
+        fbox = box.Box.cube(10)
+        np.random.seed(0)
+        points = np.random.uniform(-5, 5, size=(2000, 3)).astype(np.float32)
+        whole = density.RDF(2.0, 0.1)
+        whole.accumulate(fbox, points, points)
+
+        def analyze(comm):
+            # each rank starts with a slice of the points
+            decomposition = locality.DomainDecomposition(fbox, (2, 2, 1), 2.0)
+            mine = points[comm.Get_rank()::comm.Get_size()]
+            domain = parallel.exchangeDomains(decomposition, mine, comm)
+            rdf = density.RDF(2.0, 0.1)
+            rdf.accumulateDomain(domain.box, domain.points, domain.num_owned, domain.frame_box,
+                                 domain.frame_num_points, comm.Get_rank() == 0)
+            parallel.reduceAcrossRanks(rdf, comm)
+            return np.copy(rdf.getRDF()) if comm.Get_rank() == 0 else None
+        npt.assert_allclose(_runRanks(4, analyze)[0], whole.getRDF(), rtol=1e-4, atol=1e-6)
+
+    def test_clusters(self):
+        fbox = box.Box.cube(10)
+        np.random.seed(1)
+        points = np.random.uniform(-5, 5, size=(600, 3)).astype(np.float32)
+        whole = cluster.Cluster(fbox, 0.8)
+        whole.computeClusters(points)
+        expected = whole.getClusterIdx()
+
+        def analyze(comm):
+            decomposition = locality.DomainDecomposition(fbox, (2, 2, 2), 0.8)
+            mine = points[comm.Get_rank()::comm.Get_size()]
+            tags = np.arange(len(points))[comm.Get_rank()::comm.Get_size()]
+            domain = parallel.exchangeDomains(decomposition, mine, comm, tags)
+            clusters = cluster.Cluster(domain.box, 0.8)
+            clusters.computeClusters(domain.points)
+            idx, num_clusters = parallel.mergeClustersAcrossRanks(clusters.getClusterIdx(),
+                                                                  clusters.getNumClusters(), domain, comm)
+            return domain.tags[:domain.num_owned], idx, num_clusters
+        results = _runRanks(8, analyze)
+        self.assertEqual(results[0][2], whole.getNumClusters())
+        found = np.zeros(len(points), dtype=np.int64)
+        for tags, idx, num_clusters in results:
+            found[tags] = idx
+        # the same partition of the points, whatever the numbering
+        pairs = set(zip(found, expected))
+        self.assertEqual(len(pairs), whole.getNumClusters())
+
+if __name__ == '__main__':
+    unittest.main()
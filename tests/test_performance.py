@@ -0,0 +1,131 @@
+"""Performance regression tests of the kernels, run with the C++ benchmark harness
+
+These tests are opt-in: they are skipped unless FREUD_PERF_TESTS=1, and need the freud_benchmarks executable built
+with BUILD_BENCHMARKS=ON, found from FREUD_BENCHMARKS or in cpp/ of the source and build trees. Each test times one
+kernel on a fixed synthetic system and fails when its throughput dropped by more than FREUD_PERF_TOLERANCE (default
+0.2) from the baseline of the machine class in tests/perf_baselines/<class>.json.
+
+The machine class is FREUD_PERF_MACHINE, or the architecture and number of cores by default, so that timings are only
+compared with timings of similar machines. A missing baseline skips the tests; running them with FREUD_PERF_UPDATE=1
+records the throughputs of the machine class as its new baseline, e.g. after an intended slowdown::
+
+    FREUD_PERF_TESTS=1 FREUD_PERF_UPDATE=1 nosetests tests/test_performance.py
+"""
+
+import csv
+import io
+import json
+import multiprocessing
+import os
+import platform
+import subprocess
+import unittest
+
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+BASELINE_DIR = os.path.join(TESTS_DIR, 'perf_baselines')
+
+## Runs of the benchmark harness timed by the tests, fixed so that the baselines stay comparable
+RUNS = {
+    'linkcell': 'LinkCellBuild/N:100000/density_x100:100/threads:1$',
+    'nearest_neighbors': 'NearestNeighborsCompute/N:10000/density_x100:100/threads:1$',
+    'rdf': 'RDFAccumulate/N:10000/density_x100:100/threads:1$',
+    'pmftxyz': 'PMFTXYZAccumulate/N:10000/density_x100:100/threads:1$',
+    'localql': 'LocalQlCompute/N:10000/density_x100:100/threads:1$',
+    'cluster': 'ClusterCompute/N:10000/density_x100:50/threads:1$',
+    'gaussian_density': 'GaussianDensityCompute/N:10000/density_x100:100/threads:1$',
+    'ftdelta': 'FTdeltaCompute/N:1000/NK:10000/threads:1$',
+}
+
+def enabled():
+    return os.environ.get('FREUD_PERF_TESTS', '0') not in ('', '0')
+
+def machine_class():
+    return os.environ.get('FREUD_PERF_MACHINE',
+                          '{0}-{1}cores'.format(platform.machine(), multiprocessing.cpu_count()))
+
+def find_benchmarks():
+    candidates = [os.environ.get('FREUD_BENCHMARKS'),
+                  os.path.join(TESTS_DIR, '..', 'cpp', 'freud_benchmarks'),
+                  os.path.join(TESTS_DIR, '..', 'build', 'cpp', 'freud_benchmarks')]
+    for path in candidates:
+        if path and os.path.isfile(path) and os.access(path, os.X_OK):
+            return path
+    return None
+
+## Run the benchmark harness on the runs matching the regular expression
+#
+# \returns a dictionary of the throughputs in items per second, by run name
+#
+def run_benchmarks(executable, regex, min_time):
+    output = subprocess.check_output([executable, '--filter=' + regex, '--threads=1',
+                                      '--min_time={0}'.format(min_time), '--format=csv'])
+    reader = csv.DictReader(io.StringIO(output.decode('utf-8')))
+    return dict((row['name'], float(row['items_per_second'])) for row in reader)
+
+@unittest.skipUnless(enabled(), 'performance tests are enabled with FREUD_PERF_TESTS=1')
+class TestPerformance(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.executable = find_benchmarks()
+        if cls.executable is None:
+            raise unittest.SkipTest('freud_benchmarks not found, build with BUILD_BENCHMARKS=ON or set FREUD_BENCHMARKS')
+        cls.tolerance = float(os.environ.get('FREUD_PERF_TOLERANCE', '0.2'))
+        cls.update = os.environ.get('FREUD_PERF_UPDATE', '0') not in ('', '0')
+        cls.baseline_file = os.path.join(BASELINE_DIR, machine_class() + '.json')
+        cls.baseline = {}
+        if os.path.exists(cls.baseline_file):
+            with open(cls.baseline_file) as f:
+                cls.baseline = json.load(f)['throughputs']
+        # all the runs at once, so that the harness is started a single time
+        cls.throughputs = run_benchmarks(cls.executable, '|'.join('^' + r for r in RUNS.values()),
+                                         float(os.environ.get('FREUD_PERF_MIN_TIME', '1.0')))
+
+    @classmethod
+    def tearDownClass(cls):
+        if cls.update and cls.throughputs:
+            if not os.path.isdir(BASELINE_DIR):
+                os.makedirs(BASELINE_DIR)
+            with open(cls.baseline_file, 'w') as f:
+                json.dump(dict(machine_class=machine_class(), throughputs=cls.throughputs), f, indent=2,
+                          sort_keys=True)
+
+    def check(self, kernel):
+        name = RUNS[kernel].rstrip('$')
+        self.assertIn(name, self.throughputs, 'the benchmark harness did not run ' + name)
+        throughput = self.throughputs[name]
+        self.assertGreater(throughput, 0.0)
+        if self.update:
+            return
+        if name not in self.baseline:
+            self.skipTest('no baseline of {0} for machine class {1}'.format(name, machine_class()))
+        ratio = throughput / self.baseline[name]
+        self.assertGreaterEqual(ratio, 1.0 - self.tolerance,
+            '{0}: {1:.4g} items/s is {2:.2f}x the baseline of {3:.4g} items/s'.format(
+                name, throughput, ratio, self.baseline[name]))
+
+    def test_linkcell(self):
+        self.check('linkcell')
+
+    def test_nearest_neighbors(self):
+        self.check('nearest_neighbors')
+
+    def test_rdf(self):
+        self.check('rdf')
+
+    def test_pmftxyz(self):
+        self.check('pmftxyz')
+
+    def test_localql(self):
+        self.check('localql')
+
+    def test_cluster(self):
+        self.check('cluster')
+
+    def test_gaussian_density(self):
+        self.check('gaussian_density')
+
+    def test_ftdelta(self):
+        self.check('ftdelta')
+
+if __name__ == '__main__':
+    unittest.main()
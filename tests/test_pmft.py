@@ -1,5 +1,8 @@
 import numpy
 import numpy.testing as npt
+import os
+import shutil
+import tempfile
 from freud import box, pmft
 import unittest
 
@@ -256,6 +259,314 @@ class TestPMFTXYZShift(unittest.TestCase):
         assert(infcheck_noshift==0)
         assert(infcheck_shift==1)
 
+class TestPMFTAccumulateFrames(unittest.TestCase):
+    def test_same_as_accumulate(self):
+        num_frames = 4
+        num_points = 100
+        fbox = box.Box.square(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(num_frames, num_points, 3)).astype(numpy.float32)
+        points[:,:,2] = 0
+        angles = numpy.random.uniform(0, 2*numpy.pi, size=(num_frames, num_points)).astype(numpy.float32)
+
+        for make_pmft in [lambda: pmft.PMFTXY2D(3.0, 3.0, 20, 20),
+                          lambda: pmft.PMFTXYT(3.0, 3.0, 20, 20, 10),
+                          lambda: pmft.PMFTR12(3.0, 10, 10, 10)]:
+            framewise = make_pmft()
+            for f in range(num_frames):
+                framewise.accumulate(fbox, points[f], angles[f], points[f], angles[f])
+            batched = make_pmft()
+            batched.accumulateFrames([fbox]*num_frames, points, angles, points, angles)
+            npt.assert_equal(batched.getBinCounts(), framewise.getBinCounts())
+            npt.assert_allclose(batched.getPCF(), framewise.getPCF(), rtol=1e-6)
+
+    def test_same_as_accumulate_xyz(self):
+        num_frames = 3
+        num_points = 100
+        fbox = box.Box.cube(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(num_frames, num_points, 3)).astype(numpy.float32)
+        orientations = numpy.zeros((num_frames, num_points, 4), dtype=numpy.float32)
+        orientations[:,:,0] = 1
+
+        framewise = pmft.PMFTXYZ(2.0, 2.0, 2.0, 10, 10, 10)
+        for f in range(num_frames):
+            framewise.accumulate(fbox, points[f], orientations[f], points[f], orientations[f])
+        batched = pmft.PMFTXYZ(2.0, 2.0, 2.0, 10, 10, 10)
+        batched.accumulateFrames(fbox, points, orientations, points, orientations)
+        npt.assert_equal(batched.getBinCounts(), framewise.getBinCounts())
+        npt.assert_allclose(batched.getPCF(), framewise.getPCF(), rtol=1e-6)
+
+class TestPMFTXYZFold(unittest.TestCase):
+    def test_fold_cube_rotations(self):
+        # the 24 rotations of a cube, as quaternions
+        h = 0.5
+        s = numpy.sqrt(0.5)
+        ops = [[1, 0, 0, 0]]
+        for e in numpy.eye(3):
+            ops += [[0] + list(e), [s] + list(s*e), [s] + list(-s*e)]
+        for sx in [-h, h]:
+            for sy in [-h, h]:
+                for sz in [-h, h]:
+                    ops.append([h, sx, sy, sz])
+        for a in range(3):
+            for sign in [-1, 1]:
+                axis = numpy.zeros(3)
+                axis[(a + 1) % 3] = s
+                axis[(a + 2) % 3] = sign*s
+                ops.append([0] + list(axis))
+        face_orientations = numpy.array(ops, dtype=numpy.float32)
+
+        num_points = 200
+        fbox = box.Box.cube(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(num_points, 3)).astype(numpy.float32)
+        orientations = numpy.random.normal(size=(num_points, 4)).astype(numpy.float32)
+        orientations /= numpy.linalg.norm(orientations, axis=1)[:, numpy.newaxis]
+
+        full = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        folded = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20, fold=True)
+        self.assertTrue(folded.getFold())
+        for pm in [full, folded]:
+            pm.compute(fbox, points, orientations, points, orientations, face_orientations)
+        full_counts = full.getBinCounts()
+        folded_counts = folded.getBinCounts()
+
+        # each bond in range is binned once instead of once per face
+        npt.assert_equal(numpy.sum(full_counts), len(ops)*numpy.sum(folded_counts))
+
+        # only the bins of x >= y >= |z| are filled, with the counts of the full pmft away from its boundary
+        z, y, x = numpy.meshgrid(folded.getZ(), folded.getY(), folded.getX(), indexing='ij')
+        dx = folded.getX()[1] - folded.getX()[0]
+        outside = (x < y - dx) | (y < numpy.abs(z) - dx)
+        inside = (x > y + dx) & (y > numpy.abs(z) + dx)
+        npt.assert_equal(folded_counts[outside], 0)
+        npt.assert_equal(folded_counts[inside], full_counts[inside])
+        npt.assert_allclose(folded.getPCF()[inside], full.getPCF()[inside], rtol=1e-6)
+
+class TestPMFTXYZSharedFaces(unittest.TestCase):
+    def test_shared_same_as_per_particle(self):
+        num_points = 200
+        fbox = box.Box.cube(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(num_points, 3)).astype(numpy.float32)
+        orientations = numpy.random.normal(size=(num_points, 4)).astype(numpy.float32)
+        orientations /= numpy.linalg.norm(orientations, axis=1)[:, numpy.newaxis]
+        face_orientations = numpy.random.normal(size=(3, 4)).astype(numpy.float32)
+        face_orientations /= numpy.linalg.norm(face_orientations, axis=1)[:, numpy.newaxis]
+
+        # the 2D and (1, N_f, 4) arrays are shared by all the particles, the (N, N_f, 4) array is not
+        per_particle = numpy.ascontiguousarray(numpy.broadcast_to(face_orientations, (num_points, 3, 4)))
+        counts = []
+        for faces in [face_orientations, face_orientations[numpy.newaxis], per_particle]:
+            pm = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+            pm.compute(fbox, points, orientations, points, orientations, faces)
+            counts.append(pm.getBinCounts())
+        npt.assert_equal(counts[0], counts[2])
+        npt.assert_equal(counts[1], counts[2])
+
+class TestPMFTGetPMFT(unittest.TestCase):
+    def test_pmft_is_log_of_pcf(self):
+        fbox = box.Box.square(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(200, 3)).astype(numpy.float32)
+        points[:,2] = 0
+        angles = numpy.random.uniform(0, 2*numpy.pi, size=200).astype(numpy.float32)
+        myPMFT = pmft.PMFTXYT(3.0, 3.0, 20, 20, 10)
+        myPMFT.compute(fbox, points, angles, points, angles)
+        with numpy.errstate(divide='ignore'):
+            npt.assert_allclose(myPMFT.getPMFT(), -numpy.log(myPMFT.getPCF()), rtol=1e-6)
+
+        # the cached pmft follows further accumulation
+        myPMFT.accumulate(fbox, points[::-1], angles[::-1], points, angles)
+        with numpy.errstate(divide='ignore'):
+            npt.assert_allclose(myPMFT.getPMFT(), -numpy.log(myPMFT.getPCF()), rtol=1e-6)
+
+class TestPMFTWeights(unittest.TestCase):
+    def test_weighted_pcf(self):
+        fbox = box.Box.square(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(300, 3)).astype(numpy.float32)
+        points[:,2] = 0
+        angles = numpy.random.uniform(0, 2*numpy.pi, size=300).astype(numpy.float32)
+        ones = numpy.ones(300, dtype=numpy.float32)
+        for make_pmft in [lambda: pmft.PMFTXY2D(3.0, 3.0, 20, 20),
+                          lambda: pmft.PMFTXYT(3.0, 3.0, 20, 20, 10),
+                          lambda: pmft.PMFTR12(3.0, 10, 10, 10)]:
+            myPMFT = make_pmft()
+            myPMFT.compute(fbox, points, angles, points, angles, ref_weights=ones, weights=ones)
+            npt.assert_allclose(myPMFT.getWeightedPCF(), myPMFT.getPCF(), rtol=1e-6)
+            # each pair adds the product of the weights of its points
+            myPMFT.compute(fbox, points, angles, points, angles, ref_weights=2*ones, weights=-3*ones)
+            npt.assert_allclose(myPMFT.getWeightedPCF(), -6*myPMFT.getPCF(), rtol=1e-6)
+            # unweighted frames add nothing, and a reset forgets the weights
+            myPMFT.accumulate(fbox, points, angles, points, angles)
+            npt.assert_allclose(myPMFT.getWeightedPCF(), -3*myPMFT.getPCF(), rtol=1e-6)
+            myPMFT.compute(fbox, points, angles, points, angles)
+            npt.assert_equal(myPMFT.getWeightedPCF(), 0)
+            with self.assertRaises(ValueError):
+                myPMFT.compute(fbox, points, angles, points, angles, weights=ones)
+
+        points3D = numpy.random.uniform(-5, 5, size=(300, 3)).astype(numpy.float32)
+        orientations = numpy.zeros((300, 4), dtype=numpy.float32)
+        orientations[:,0] = 1
+        myPMFT = pmft.PMFTXYZ(2.0, 2.0, 2.0, 10, 10, 10)
+        myPMFT.compute(box.Box.cube(10), points3D, orientations, points3D, orientations, None, ref_weights=ones,
+                       weights=ones)
+        npt.assert_allclose(myPMFT.getWeightedPCF(), myPMFT.getPCF(), rtol=1e-6)
+
+class TestPMFTCheckpoint(unittest.TestCase):
+    def test_merge_chunks(self):
+        num_frames = 4
+        num_points = 100
+        fbox = box.Box.square(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(num_frames, num_points, 3)).astype(numpy.float32)
+        points[:,:,2] = 0
+        angles = numpy.random.uniform(0, 2*numpy.pi, size=(num_frames, num_points)).astype(numpy.float32)
+        tmpdir = tempfile.mkdtemp()
+        try:
+            whole = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+            whole.accumulateFrames(fbox, points, angles, points, angles)
+
+            # each half of the trajectory in its own computation, then merged
+            filenames = [os.path.join(tmpdir, 'chunk{}.ckp'.format(c)) for c in range(2)]
+            for c, filename in enumerate(filenames):
+                chunk = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+                chunk.accumulateFrames(fbox, points[2*c:2*c+2], angles[2*c:2*c+2], points[2*c:2*c+2],
+                                       angles[2*c:2*c+2])
+                chunk.saveState(filename)
+            merged = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+            merged.loadState(filenames[0])
+            merged.loadState(filenames[1], merge=True)
+            npt.assert_equal(merged.getBinCounts(), whole.getBinCounts())
+            npt.assert_allclose(merged.getPCF(), whole.getPCF(), rtol=1e-6)
+
+            # other bins or another class
+            with self.assertRaises(ValueError):
+                pmft.PMFTXY2D(3.0, 3.0, 10, 10).loadState(filenames[0])
+            with self.assertRaises(ValueError):
+                pmft.PMFTXYT(3.0, 3.0, 20, 20, 10).loadState(filenames[0])
+        finally:
+            shutil.rmtree(tmpdir)
+
+    def test_iadd(self):
+        num_frames = 4
+        num_points = 100
+        fbox = box.Box.square(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(num_frames, num_points, 3)).astype(numpy.float32)
+        points[:,:,2] = 0
+        angles = numpy.random.uniform(0, 2*numpy.pi, size=(num_frames, num_points)).astype(numpy.float32)
+        whole = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+        whole.accumulateFrames(fbox, points, angles, points, angles)
+
+        merged = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+        for c in range(2):
+            chunk = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+            chunk.accumulateFrames(fbox, points[2*c:2*c+2], angles[2*c:2*c+2], points[2*c:2*c+2],
+                                   angles[2*c:2*c+2])
+            merged += chunk
+        npt.assert_equal(merged.getBinCounts(), whole.getBinCounts())
+        npt.assert_allclose(merged.getPCF(), whole.getPCF(), rtol=1e-6)
+        with self.assertRaises(ValueError):
+            merged += pmft.PMFTXY2D(3.0, 3.0, 10, 10)
+
+    def test_gpu(self):
+        fbox = box.Box.square(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(500, 3)).astype(numpy.float32)
+        points[:,2] = 0
+        angles = numpy.random.uniform(0, 2*numpy.pi, size=500).astype(numpy.float32)
+        gpu = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+        try:
+            gpu.setUseGPU(True)
+        except RuntimeError:
+            self.skipTest("freud was built without CUDA or no device is available")
+        cpu = pmft.PMFTXY2D(3.0, 3.0, 20, 20)
+        cpu.accumulate(fbox, points, angles, points, angles)
+        gpu.accumulate(fbox, points, angles, points, angles)
+        # only pairs within rounding of a bin edge may be binned differently
+        self.assertLessEqual(numpy.abs(gpu.getBinCounts().astype(numpy.int64) -
+                                       cpu.getBinCounts().astype(numpy.int64)).sum(), 2)
+        self.assertEqual(gpu.getBinCounts().sum(), cpu.getBinCounts().sum())
+
+class TestPMFTMemory(unittest.TestCase):
+    def test_memory_limit(self):
+        fbox = box.Box.cube(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(500, 3)).astype(numpy.float32)
+        orientations = numpy.zeros((500, 4), dtype=numpy.float32)
+        orientations[:,0] = 1
+
+        dense = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        limited = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        self.assertEqual(limited.getMemoryLimit(), 0)
+        for f in range(3):
+            # the histograms become sparse after the first frame, and dense again for the last one
+            limited.setMemoryLimit(1000 if f == 1 else 0)
+            dense.accumulate(fbox, points, orientations, points, orientations)
+            limited.accumulate(fbox, points, orientations, points, orientations)
+        npt.assert_equal(limited.getBinCounts(), dense.getBinCounts())
+
+        usage = dense.getMemoryUsage()
+        self.assertEqual(set(usage), set(['histogram', 'local_histograms', 'cell_list']))
+        self.assertGreaterEqual(usage['local_histograms'], 20**3*4)
+        estimate = dense.estimateMemory(500, 4)
+        self.assertEqual(estimate['local_histograms'], 4*20**3*4)
+
+    def test_sparse_histograms(self):
+        fbox = box.Box.cube(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(500, 3)).astype(numpy.float32)
+        orientations = numpy.zeros((500, 4), dtype=numpy.float32)
+        orientations[:,0] = 1
+
+        dense = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        sparse = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        # any dense copy of the grid exceeds a limit of one byte
+        sparse.setMemoryLimit(1)
+        for f in range(2):
+            dense.accumulate(fbox, points, orientations, points, orientations)
+            sparse.accumulate(fbox, points, orientations, points, orientations)
+        self.assertFalse(dense.getSparse())
+        self.assertTrue(sparse.getSparse())
+        npt.assert_equal(sparse.getBinCounts(), dense.getBinCounts())
+        npt.assert_allclose(sparse.getPCF(), dense.getPCF())
+
+        # more frames after the reduction, then a new accumulation after the reset
+        dense.accumulate(fbox, points[:300], orientations[:300], points, orientations)
+        sparse.accumulate(fbox, points[:300], orientations[:300], points, orientations)
+        npt.assert_equal(sparse.getBinCounts(), dense.getBinCounts())
+        dense.resetPCF()
+        sparse.resetPCF()
+        npt.assert_equal(sparse.getBinCounts(), 0)
+        dense.accumulate(fbox, points[200:], orientations[200:], points, orientations)
+        sparse.accumulate(fbox, points[200:], orientations[200:], points, orientations)
+        self.assertTrue(sparse.getSparse())
+        npt.assert_equal(sparse.getBinCounts(), dense.getBinCounts())
+
+    def test_atomic_histogram(self):
+        fbox = box.Box.cube(10)
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-5, 5, size=(500, 3)).astype(numpy.float32)
+        orientations = numpy.zeros((500, 4), dtype=numpy.float32)
+        orientations[:,0] = 1
+
+        default = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        atomic = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        self.assertFalse(atomic.getAtomicHistogram())
+        for f in range(3):
+            # the shared histogram is used from the second frame, with the counts of the first
+            atomic.setAtomicHistogram(f > 0)
+            default.accumulate(fbox, points, orientations, points, orientations)
+            atomic.accumulate(fbox, points, orientations, points, orientations)
+        self.assertTrue(atomic.getAtomicHistogram())
+        npt.assert_equal(atomic.getBinCounts(), default.getBinCounts())
+        npt.assert_allclose(atomic.getPCF(), default.getPCF())
+        self.assertEqual(atomic.getMemoryUsage()['local_histograms'], 0)
+        self.assertEqual(atomic.estimateMemory(500, 4)['local_histograms'], 0)
+
 if __name__ == '__main__':
     print("testing pmft")
     unittest.main()
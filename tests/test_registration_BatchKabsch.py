@@ -0,0 +1,51 @@
+import numpy as np
+import numpy.testing as npt
+from freud import registration
+import unittest
+
+def random_rotations(num, rng):
+    q = rng.normal(size=(num, 4))
+    q /= np.linalg.norm(q, axis=1)[:, np.newaxis]
+    w, x, y, z = q.T
+    return np.array([[w*w+x*x-y*y-z*z, 2*(x*y-w*z), 2*(x*z+w*y)],
+                     [2*(x*y+w*z), w*w-x*x+y*y-z*z, 2*(y*z-w*x)],
+                     [2*(x*z-w*y), 2*(y*z+w*x), w*w-x*x-y*y+z*z]]).transpose(2, 0, 1)
+
+class TestBatchKabsch(unittest.TestCase):
+    def test_shared_ref(self):
+        rng = np.random.RandomState(0)
+        ref_points = rng.normal(size=(12, 3)).astype(np.float32)
+        rotations = random_rotations(50, rng)
+        # R p = q for p = R^T q
+        points = np.einsum('bji,nj->bni', rotations, ref_points).astype(np.float32)
+
+        kabsch = registration.BatchKabsch()
+        kabsch.compute(points, ref_points)
+        self.assertEqual(kabsch.getNumSets(), 50)
+        npt.assert_allclose(kabsch.getRotations(), rotations, atol=1e-5)
+        npt.assert_allclose(kabsch.getRMSDs(), 0, atol=1e-5)
+
+    def test_per_set_ref(self):
+        rng = np.random.RandomState(1)
+        ref_points = rng.normal(size=(20, 8, 3)).astype(np.float32)
+        rotations = random_rotations(20, rng)
+        points = np.einsum('bji,bnj->bni', rotations, ref_points).astype(np.float32)
+        # noise in the last set only
+        points[-1] += 0.1*rng.normal(size=(8, 3))
+
+        kabsch = registration.BatchKabsch()
+        kabsch.compute(points, ref_points)
+        npt.assert_allclose(kabsch.getRotations()[:-1], rotations[:-1], atol=1e-5)
+        npt.assert_allclose(kabsch.getRMSDs()[:-1], 0, atol=1e-5)
+        self.assertGreater(kabsch.getRMSDs()[-1], 0.01)
+
+        # the rotation of each set is the one of its reference set
+        shared = registration.BatchKabsch()
+        shared.compute(points[:1], ref_points[0])
+        npt.assert_allclose(shared.getRotations()[0], kabsch.getRotations()[0], atol=1e-6)
+
+        with self.assertRaises(ValueError):
+            kabsch.compute(points, ref_points[:-1])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,32 @@
+from freud import box, split
+import numpy as np
+import numpy.testing as npt
+import unittest
+
+class TestShapeSplit(unittest.TestCase):
+    def test_split(self):
+        fbox = box.Box.cube(10)
+        points = np.array([[4.9, 0, 0], [0, 0, 0]], dtype=np.float32)
+        # a quarter turn about z, and the identity
+        orientations = np.array([[np.cos(np.pi/4), 0, 0, np.sin(np.pi/4)], [1, 0, 0, 0]], dtype=np.float32)
+        split_points = np.array([[1, 0, 0], [0, 1, 0]], dtype=np.float32)
+        ss = split.ShapeSplit(fbox)
+        ss.compute(points, orientations, split_points)
+        expected = np.array([[[4.9, 1, 0], [3.9, 0, 0]], [[1, 0, 0], [0, 1, 0]]], dtype=np.float32)
+        npt.assert_allclose(ss.getShapeSplit(), expected, atol=1e-5)
+        npt.assert_allclose(ss.getShapeOrientations(), np.repeat(orientations[:, np.newaxis], 2, axis=1))
+
+        # into arrays of the caller, wrapped into the box
+        points[0, 0] = -4.5
+        out = np.empty((2, 2, 3), dtype=np.float32)
+        out_orientations = np.empty((2, 2, 4), dtype=np.float32)
+        self.assertIs(ss.compute(points, orientations, split_points, out=out, out_orientations=out_orientations), out)
+        expected[0] = [[-4.5, 1, 0], [4.5, 0, 0]]
+        npt.assert_allclose(out, expected, atol=1e-5)
+        npt.assert_allclose(out_orientations, np.repeat(orientations[:, np.newaxis], 2, axis=1))
+
+        with self.assertRaises(RuntimeError):
+            ss.compute(points, orientations, split_points, out=np.empty((2, 3, 3), dtype=np.float32))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,51 @@
+import numpy as np
+import numpy.testing as npt
+from freud import trajectory
+import os
+import unittest
+
+class TestDCDReader(unittest.TestCase):
+    def setUp(self):
+        self.reader = trajectory.DCDReader(os.path.join(os.path.dirname(__file__), 'triclinic.dcd'))
+
+    def test_header(self):
+        self.assertEqual(self.reader.getNumFrames(), 10)
+        self.assertEqual(self.reader.getNP(), 64)
+        self.assertTrue(self.reader.hasUnitCell())
+
+    def test_box(self):
+        # the xy tilt of the box grows from frame to frame
+        for frame, xy in [(0, 0), (3, 0.0299), (9, 0.0899)]:
+            fbox = self.reader.getBox(frame)
+            npt.assert_allclose(fbox.getLx(), 6.945863, rtol=1e-5)
+            npt.assert_allclose(fbox.getLy(), 6.945863, rtol=1e-5)
+            npt.assert_allclose(fbox.getLz(), 6.945863, rtol=1e-5)
+            npt.assert_allclose(fbox.getTiltFactorXY(), xy, atol=1e-6)
+            npt.assert_allclose(fbox.getTiltFactorXZ(), 0, atol=1e-6)
+
+    def test_positions(self):
+        out = np.empty((64, 3), dtype=np.float32)
+        for frame in range(self.reader.getNumFrames()):
+            positions = self.reader.getPositions(frame, out=out)
+            self.assertIs(positions, out)
+            npt.assert_equal(positions[:, 0], self.reader.getX(frame))
+            npt.assert_equal(positions[:, 1], self.reader.getY(frame))
+            npt.assert_equal(positions[:, 2], self.reader.getZ(frame))
+        npt.assert_allclose(self.reader.getPositions(0)[0], [-0.5763538, 3.4533772, 1.530344], rtol=1e-6)
+
+        # the coordinates are views of the file
+        x = self.reader.getX(0)
+        self.assertFalse(x.flags.writeable)
+        del self.reader
+        npt.assert_allclose(x[0], -0.5763538, rtol=1e-6)
+
+    def test_errors(self):
+        with self.assertRaises(ValueError):
+            self.reader.getX(10)
+        with self.assertRaises(ValueError):
+            self.reader.getPositions(0, out=np.empty((64, 3), dtype=np.float64))
+        with self.assertRaises(ValueError):
+            trajectory.DCDReader(os.path.join(os.path.dirname(__file__), 'sc.npy'))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -29,5 +29,106 @@ class TestVoronoi(unittest.TestCase):
         npt.assert_equal(vor.getNeighbors(1), [[1, 3], [0, 2, 4], [5, 1], [0, 6, 4], [3, 5, 1, 7], [8, 2, 4], [3, 7], [6, 8, 4], [5, 7]])
         npt.assert_equal(vor.getNeighbors(2), [[1, 2, 3, 4, 6], [0, 2, 3, 4, 5, 7], [0, 1, 4, 5, 8], [0, 1, 4, 5, 6, 7], [0, 1, 2, 3, 5, 6, 7, 8], [1, 2, 3, 4, 7, 8], [0, 3, 4, 7, 8], [1, 3, 4, 5, 6, 8], [2, 4, 5, 6, 7]])
 
+    def test_voronoi_volumes(self):
+        L = 4
+        vor = voronoi.Voronoi(box.Box.square(L))
+        grid = np.arange(L, dtype=np.float32) - (L - 1)/2
+        pos = np.array([[x, y] for x in grid for y in grid], dtype=np.float32)
+        vor.computeVolumes(pos)
+        npt.assert_allclose(vor.getVolumes(), 1, atol=1e-5)
+        npt.assert_allclose(vor.getSurfaceAreas(), 4, atol=1e-5)
+
+    def test_cells_cubic(self):
+        L = 4
+        fbox = box.Box.cube(L)
+        grid = np.arange(L, dtype=np.float32) - (L - 1)/2
+        pos = np.array([[x, y, z] for x in grid for y in grid for z in grid], dtype=np.float32)
+        cells = voronoi.VoronoiCells()
+        cells.compute(fbox, pos)
+
+        npt.assert_allclose(cells.getVolumes(), 1, atol=1e-5)
+        nlist = cells.getNlist()
+        npt.assert_equal(np.diff(nlist.getSegments()), 6)
+        npt.assert_allclose(cells.getFaceAreas(), 1, atol=1e-5)
+        npt.assert_allclose(cells.getSurfaceAreas(), 6, atol=1e-5)
+        npt.assert_allclose(nlist.getDistances(), 1, atol=1e-5)
+
+    def test_cells_shells(self):
+        L = 6
+        fbox = box.Box.square(L)
+        grid = np.arange(L, dtype=np.float32) - (L - 1)/2
+        pos = np.array([[x, y, 0] for x in grid for y in grid], dtype=np.float32)
+        cells = voronoi.VoronoiCells()
+        cells.compute(fbox, pos)
+
+        # 4 neighbors across the edges, 8 more two edges away, then 10 three edges away as (3, 0) and (-3, 0)
+        # are the same particle
+        for (num_shells, num_neighbors) in [(1, 4), (2, 12), (3, 22)]:
+            cells.computeShells(num_shells)
+            nlist = cells.getShellNlist()
+            npt.assert_equal(np.diff(nlist.getSegments()), num_neighbors)
+            for i in range(len(pos)):
+                neighbors = nlist.getIndexJ()[nlist.getSegments()[i]:nlist.getSegments()[i+1]]
+                self.assertEqual(len(set(neighbors)), num_neighbors)
+                self.assertNotIn(i, neighbors)
+
+    def test_cells_random(self):
+        L = 10
+        N = 1000
+        for fbox in [box.Box.cube(L), box.Box(L, L + 1, L + 2, 0.2, -0.1, 0.3), box.Box.square(L)]:
+            pos = fbox.makeCoordinates(np.random.uniform(0, 1, size=(N, 3)).astype(np.float32))
+            if fbox.is2D():
+                pos[:, 2] = 0
+            cells = voronoi.VoronoiCells()
+            cells.compute(fbox, pos)
+
+            # the cells tile the box, and each face is seen from both sides
+            npt.assert_allclose(np.sum(cells.getVolumes()), fbox.getVolume(), rtol=1e-4)
+            nlist = cells.getNlist()
+            vectors = nlist.getVectors()
+            areas = cells.getFaceAreas()
+            faces = {}
+            for (bond, (i, j)) in enumerate(zip(nlist.getIndexI(), nlist.getIndexJ())):
+                faces.setdefault((i, j), []).append(bond)
+            for ((i, j), bonds) in faces.items():
+                for bond in bonds:
+                    mirror = min(faces[(j, i)], key=lambda other: np.sum((vectors[bond] + vectors[other])**2))
+                    npt.assert_allclose(vectors[mirror], -vectors[bond], atol=1e-4)
+                    npt.assert_allclose(areas[mirror], areas[bond], rtol=1e-3, atol=1e-5)
+
+    def test_cells_update(self):
+        L = 10
+        N = 1000
+        for fbox in [box.Box.cube(L), box.Box.square(L)]:
+            pos = fbox.makeCoordinates(np.random.uniform(0, 1, size=(N, 3)).astype(np.float32))
+            if fbox.is2D():
+                pos[:, 2] = 0
+            cells = voronoi.VoronoiCells(skin=0.2)
+            cells.compute(fbox, pos)
+            reference = voronoi.VoronoiCells()
+            for frame in range(3):
+                pos += np.random.uniform(-0.01, 0.01, size=pos.shape).astype(np.float32)
+                if fbox.is2D():
+                    pos[:, 2] = 0
+                cells.update(fbox, pos)
+                reference.compute(fbox, pos)
+
+                # the same faces as a new compute, although maybe in another order
+                npt.assert_allclose(cells.getVolumes(), reference.getVolumes(), rtol=1e-4, atol=1e-6)
+                nlist = cells.getNlist()
+                ref_nlist = reference.getNlist()
+                npt.assert_equal(nlist.getSegments(), ref_nlist.getSegments())
+                for i in range(N):
+                    bonds = slice(nlist.getSegments()[i], nlist.getSegments()[i+1])
+                    npt.assert_equal(np.sort(nlist.getIndexJ()[bonds]), np.sort(ref_nlist.getIndexJ()[bonds]))
+                    npt.assert_allclose(np.sort(cells.getFaceAreas()[bonds]),
+                                        np.sort(reference.getFaceAreas()[bonds]), rtol=1e-3, atol=1e-5)
+            self.assertLess(cells.getNumRecomputed(), N)
+
+            # beyond half the skin the cells are computed again
+            pos[:, :2] += 0.15
+            cells.update(fbox, pos)
+            self.assertEqual(cells.getNumRecomputed(), N)
+
 if __name__ == '__main__':
     unittest.main()